@@ -0,0 +1,195 @@
+#include <ATen/BatchedCopy.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/grad_mode.h>
+#include <c10/core/DeviceGuard.h>
+#include <c10/core/StreamGuard.h>
+#include <c10/core/impl/VirtualGuardImpl.h>
+
+#include <cstring>
+
+namespace at {
+
+namespace {
+
+// Offset alignment of the tensors in the buffers of a batch
+constexpr int64_t kBatchAlignment = 64;
+// Below this many bytes, the tensors are packed by the calling thread alone
+constexpr int64_t kParallelPackBytes = 1 << 20;
+
+// Owns the buffers of a copied batch and is shared by its results. The device
+// buffer was allocated on `stream`, but is written (H2D) or read (D2H) on the
+// copy stream: `stream` is made to wait for the copy before the buffer goes
+// back to the caching allocator, which would otherwise hand it out again for
+// work on `stream` that may run before the copy completes.
+struct BatchBuffers {
+  BatchBuffers(
+      Tensor result,
+      Tensor device_staging,
+      std::shared_ptr<c10::Event> event,
+      c10::Stream stream)
+      : result(std::move(result)),
+        device_staging(std::move(device_staging)),
+        event(std::move(event)),
+        stream(stream) {}
+
+  ~BatchBuffers() {
+    if (!result.device().is_cpu() || device_staging.defined()) {
+      event->block(stream);
+    }
+  }
+
+  Tensor result;
+  Tensor device_staging;
+  std::shared_ptr<c10::Event> event;
+  c10::Stream stream;
+};
+
+void check_batch(TensorList tensors, Device device) {
+  const Device src = tensors[0].device();
+  TORCH_CHECK(
+      src.is_cpu() != device.is_cpu(),
+      "copy_batch: expected a copy between the CPU and a device, got a copy from ",
+      src, " to ", device);
+  const Device accelerator = src.is_cpu() ? device : src;
+  TORCH_CHECK(
+      accelerator.is_cuda(),
+      "copy_batch: only copies between the CPU and CUDA devices are supported, got ",
+      accelerator);
+  for (size_t i = 0; i < tensors.size(); i++) {
+    TORCH_CHECK(
+        tensors[i].layout() == kStrided,
+        "copy_batch: expected dense tensors, but tensor ", i, " has layout ",
+        tensors[i].layout());
+    TORCH_CHECK(
+        tensors[i].device() == src,
+        "copy_batch: expected all tensors on ", src, ", but tensor ", i,
+        " is on ", tensors[i].device());
+  }
+}
+
+// Copies `t` to `dst`, a buffer of `t.nbytes()` bytes on `options`' device
+void pack(const Tensor& t, void* dst, const TensorOptions& options) {
+  if (t.device().is_cpu() && t.is_contiguous()) {
+    std::memcpy(dst, t.data_ptr(), t.nbytes());
+  } else {
+    at::from_blob(dst, t.sizes(), options.dtype(t.scalar_type())).copy_(t);
+  }
+}
+
+} // namespace
+
+BatchedCopy copy_batch(TensorList tensors, Device device) {
+  BatchedCopy copy;
+  if (tensors.empty()) {
+    return copy;
+  }
+  check_batch(tensors, device);
+  at::NoGradGuard no_grad;
+
+  const bool to_device = tensors[0].device().is_cpu();
+  c10::impl::VirtualGuardImpl impl(to_device ? device.type() : tensors[0].device().type());
+  Device accelerator = to_device ? device : tensors[0].device();
+  if (!accelerator.has_index()) {
+    accelerator = Device(accelerator.type(), impl.getDevice().index());
+  }
+  if (to_device) {
+    device = accelerator;
+  }
+  c10::DeviceGuard device_guard(accelerator);
+  const c10::Stream stream = impl.getStream(accelerator);
+  const c10::Stream copy_stream = impl.getStreamFromGlobalPool(accelerator);
+
+  std::vector<int64_t> offsets;
+  offsets.reserve(tensors.size());
+  int64_t total = 0;
+  for (const auto& t : tensors) {
+    offsets.push_back(total);
+    const int64_t nbytes = t.nbytes();
+    total += (nbytes + kBatchAlignment - 1) / kBatchAlignment * kBatchAlignment;
+  }
+
+  const auto host_options = TensorOptions(kByte).pinned_memory(true);
+  const auto device_options = TensorOptions(kByte).device(accelerator);
+  // The buffer the batch is packed in, on the side of the inputs, and the one
+  // it is copied to with a single transfer.
+  Tensor staging = at::empty({total}, to_device ? host_options : device_options);
+  Tensor result = at::empty({total}, to_device ? device_options : host_options);
+
+  uint8_t* staging_ptr = staging.data_ptr<uint8_t>();
+  const auto staging_options = to_device ? TensorOptions(kCPU) : TensorOptions(accelerator);
+  auto pack_range = [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      if (tensors[i].numel() > 0) {
+        pack(tensors[i], staging_ptr + offsets[i], staging_options);
+      }
+    }
+  };
+  const int64_t n = tensors.size();
+  if (to_device && total >= kParallelPackBytes) {
+    at::parallel_for(0, n, 1, pack_range);
+  } else {
+    pack_range(0, n);
+  }
+
+  // The copy waits for the work queued on the current stream, which includes
+  // the packing of a device batch.
+  c10::Event ready(accelerator.type());
+  ready.record(stream);
+  ready.block(copy_stream);
+
+  copy.event = std::make_shared<c10::Event>(accelerator.type());
+  {
+    c10::StreamGuard stream_guard(copy_stream);
+    result.copy_(staging, /*non_blocking=*/true);
+    copy.event->record(copy_stream);
+  }
+
+  auto buffers = std::make_shared<BatchBuffers>(
+      result,
+      to_device ? Tensor() : staging,
+      copy.event,
+      stream);
+  uint8_t* result_ptr = result.data_ptr<uint8_t>();
+  const auto result_options = to_device ? TensorOptions(device) : TensorOptions(kCPU);
+  copy.tensors.reserve(tensors.size());
+  for (size_t i = 0; i < tensors.size(); i++) {
+    const auto options = result_options.dtype(tensors[i].scalar_type());
+    if (tensors[i].numel() == 0) {
+      copy.tensors.push_back(at::empty(tensors[i].sizes(), options));
+    } else {
+      copy.tensors.push_back(at::from_blob(
+          result_ptr + offsets[i],
+          tensors[i].sizes(),
+          [buffers](void*) {},
+          options));
+    }
+  }
+  return copy;
+}
+
+void BatchedCopy::wait(const c10::Stream& stream) const {
+  if (event) {
+    event->block(stream);
+  }
+}
+
+void BatchedCopy::wait() const {
+  if (event) {
+    c10::impl::VirtualGuardImpl impl(event->device_type());
+    event->block(impl.getStream(Device(event->device_type(), event->device_index())));
+  }
+}
+
+void BatchedCopy::synchronize() const {
+  if (event) {
+    event->synchronize();
+  }
+}
+
+bool BatchedCopy::query() const {
+  return !event || event->query();
+}
+
+} // namespace at
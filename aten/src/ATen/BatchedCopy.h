@@ -0,0 +1,50 @@
+#pragma once
+
+#include <ATen/Tensor.h>
+#include <c10/core/Event.h>
+#include <c10/core/Stream.h>
+
+#include <memory>
+#include <vector>
+
+namespace at {
+
+// Copies of a batch of tensors between the CPU and an accelerator (CUDA),
+// with a single transfer for the whole batch.
+//
+// For a copy to the device, the CPU tensors are packed in a pinned staging
+// buffer, which is moved to the device with one asynchronous copy on a copy
+// stream taken from the device's stream pool, so that the transfer overlaps
+// the work of the current stream. The copy waits for the work already queued
+// on the current stream of the device.
+//
+// For a copy to the CPU, the device tensors are packed in a device buffer on
+// the current stream, then moved to pinned memory with one asynchronous copy
+// on a copy stream.
+//
+// The results are views of the buffer the batch was copied to, and must not
+// be used before the copy is done: call wait() to make a stream wait for it
+// before using device results, or synchronize() before reading host results.
+// The results do not require grad.
+struct TORCH_API BatchedCopy {
+  std::vector<Tensor> tensors;
+
+  // Makes `stream` wait for the copy
+  void wait(const c10::Stream& stream) const;
+  // Makes the current stream of the device wait for the copy
+  void wait() const;
+  // Waits for the copy in the calling thread
+  void synchronize() const;
+  // Whether the copy is done
+  bool query() const;
+
+  // The event recorded after the copy, null for an empty batch
+  std::shared_ptr<c10::Event> event;
+};
+
+// Copies `tensors` to `device`, see BatchedCopy. All the tensors must be
+// dense and either all on the CPU, with `device` a CUDA device, or all on a
+// CUDA device, with `device` the CPU.
+TORCH_API BatchedCopy copy_batch(TensorList tensors, Device device);
+
+} // namespace at
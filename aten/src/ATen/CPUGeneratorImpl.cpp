@@ -53,6 +53,7 @@ void CPUGeneratorImpl::set_current_seed(uint64_t seed) {
   next_float_normal_sample_.reset();
   next_double_normal_sample_.reset();
   engine_ = mt19937(seed);
+  philox_offset_ = 0;
 }
 
 /**
@@ -151,6 +152,62 @@ void CPUGeneratorImpl::set_engine(at::mt19937 engine) {
   engine_ = engine;
 }
 
+/**
+ * Enables or disables the Philox mode of the CPUGeneratorImpl.
+ *
+ * In Philox mode, the kernels that support it (currently uniform_ and
+ * normal_) read their randoms from the counter-based Philox stream given
+ * by the current seed and the philox offset, instead of from the mt19937
+ * engine, so that they can fill tensors in parallel and still produce the
+ * same values regardless of the number of threads.
+ * See Note [Counter-based CPU random fills]
+ *
+ * Note that the philox offset is not part of the state returned by
+ * get_state(), which only holds the mt19937 engine. Reseeding resets
+ * the offset to 0.
+ */
+void CPUGeneratorImpl::set_philox_enabled(bool enabled) {
+  philox_enabled_ = enabled;
+}
+
+/**
+ * Whether the CPUGeneratorImpl is in Philox mode.
+ */
+bool CPUGeneratorImpl::philox_enabled() const {
+  return philox_enabled_;
+}
+
+/**
+ * Sets the philox offset, in 128 bit numbers, of the Philox stream.
+ *
+ * See Note [Acquire lock when using random generators]
+ */
+void CPUGeneratorImpl::set_philox_offset(uint64_t offset) {
+  philox_offset_ = offset;
+}
+
+/**
+ * Gets the current philox offset of the CPUGeneratorImpl.
+ */
+uint64_t CPUGeneratorImpl::philox_offset() const {
+  return philox_offset_;
+}
+
+/**
+ * Gets the seed and philox offset to be used by at::Philox4_32_10 and
+ * advances the offset by `increment` 128 bit numbers. Like
+ * CUDAGeneratorImpl::philox_engine_inputs, a kernel must pass an increment
+ * that is not smaller than the number of 128 bit numbers it reads, so that
+ * the next kernel doesn't reuse them.
+ *
+ * See Note [Acquire lock when using random generators]
+ */
+std::pair<uint64_t, uint64_t> CPUGeneratorImpl::philox_engine_inputs(uint64_t increment) {
+  uint64_t offset = philox_offset_;
+  philox_offset_ += increment;
+  return std::make_pair(this->current_seed(), offset);
+}
+
 /**
  * Public clone method implementation
  *
@@ -170,6 +227,8 @@ CPUGeneratorImpl* CPUGeneratorImpl::clone_impl() const {
   gen->set_engine(engine_);
   gen->set_next_float_normal_sample(next_float_normal_sample_);
   gen->set_next_double_normal_sample(next_double_normal_sample_);
+  gen->set_philox_enabled(philox_enabled_);
+  gen->set_philox_offset(philox_offset_);
   return gen;
 }
 
@@ -4,6 +4,7 @@
 #include <ATen/core/MT19937RNGEngine.h>
 #include <c10/util/Optional.h>
 #include <c10/core/GeneratorImpl.h>
+#include <utility>
 
 namespace at {
 
@@ -27,11 +28,21 @@ struct CAFFE2_API CPUGeneratorImpl : public c10::GeneratorImpl {
   at::mt19937 engine();
   void set_engine(at::mt19937 engine);
 
+  // Philox mode
+  // See Note [Counter-based CPU random fills]
+  void set_philox_enabled(bool enabled);
+  bool philox_enabled() const;
+  void set_philox_offset(uint64_t offset);
+  uint64_t philox_offset() const;
+  std::pair<uint64_t, uint64_t> philox_engine_inputs(uint64_t increment);
+
 private:
   CPUGeneratorImpl* clone_impl() const override;
   at::mt19937 engine_;
   c10::optional<float> next_float_normal_sample_;
   c10::optional<double> next_double_normal_sample_;
+  bool philox_enabled_ = false;
+  uint64_t philox_offset_ = 0;
 };
 
 namespace detail {
@@ -7,6 +7,45 @@
 
 namespace at {
 
+/**
+ * Seed and Philox offset of the random numbers of one kernel launch.
+ *
+ * Outside of a CUDA graph capture they are plain values. During a capture
+ * the values the kernels use must change from replay to replay, so they are
+ * read by the kernels at run time: the seed and the base offset live in
+ * device tensors that CUDAGraph::replay() fills in before each launch of the
+ * graph, and the offset of the kernel within the graph is added to the base
+ * offset. Kernels get the values with at::cuda::philox::unpack() (see
+ * ATen/cuda/CUDAGraphsUtils.cuh).
+ */
+struct PhiloxCudaState {
+  PhiloxCudaState() = default;
+  // Called if the launch is not being captured.
+  PhiloxCudaState(uint64_t seed, uint64_t offset) {
+    seed_.val = seed;
+    offset_.val = offset;
+  }
+  // Called if the launch is being captured.
+  PhiloxCudaState(int64_t* seed,
+                  int64_t* offset_extragraph,
+                  uint32_t offset_intragraph) {
+    seed_.ptr = seed;
+    offset_.ptr = offset_extragraph;
+    offset_intragraph_ = offset_intragraph;
+    captured_ = true;
+  }
+
+  union Payload {
+    uint64_t val;
+    int64_t* ptr;
+  };
+
+  Payload seed_;
+  Payload offset_;
+  uint32_t offset_intragraph_ = 0;
+  bool captured_ = false;
+};
+
 struct TORCH_CUDA_API CUDAGeneratorImpl : public c10::GeneratorImpl {
   // Constructors
   CUDAGeneratorImpl(DeviceIndex device_index = -1);
@@ -19,13 +58,22 @@ struct TORCH_CUDA_API CUDAGeneratorImpl : public c10::GeneratorImpl {
   uint64_t seed() override;
   void set_philox_offset_per_thread(uint64_t offset);
   uint64_t philox_offset_per_thread();
+  PhiloxCudaState philox_cuda_state(uint64_t increment);
+  // Legacy interface, not usable during a CUDA graph capture.
   std::pair<uint64_t, uint64_t> philox_engine_inputs(uint64_t increment);
+  void capture_prologue(int64_t* seed_extragraph, int64_t* offset_extragraph);
+  uint64_t capture_epilogue();
   static DeviceType device_type();
 
 private:
   CUDAGeneratorImpl* clone_impl() const override;
   uint64_t seed_ = default_rng_seed_val;
   uint64_t philox_offset_per_thread_ = 0;
+  // state of the CUDA graph capture using this generator, if any
+  int64_t* seed_extragraph_ = nullptr;
+  int64_t* offset_extragraph_ = nullptr;
+  uint32_t offset_intragraph_ = 0;
+  bool graph_expects_this_gen_ = false;
 };
 
 namespace cuda {
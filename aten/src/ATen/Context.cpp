@@ -59,6 +59,22 @@ void Context::setDeterministicCuDNN(bool b) {
   deterministic_cudnn = b;
 }
 
+bool Context::deterministic() const {
+  return deterministic_;
+}
+
+void Context::setDeterministic(bool b) {
+  deterministic_ = b;
+}
+
+bool Context::copyOnWrite() const {
+  return copy_on_write_;
+}
+
+void Context::setCopyOnWrite(bool b) {
+  copy_on_write_ = b;
+}
+
 bool Context::benchmarkCuDNN() const {
   return benchmark_cudnn;
 }
@@ -67,6 +83,30 @@ void Context::setBenchmarkCuDNN(bool b) {
   benchmark_cudnn = b;
 }
 
+bool Context::benchmarkCPUConv() const {
+  return benchmark_cpu_conv;
+}
+
+void Context::setBenchmarkCPUConv(bool b) {
+  benchmark_cpu_conv = b;
+}
+
+bool Context::allowFloatAccumulationCPU() const {
+  return allow_float_accumulation_cpu;
+}
+
+void Context::setAllowFloatAccumulationCPU(bool b) {
+  allow_float_accumulation_cpu = b;
+}
+
+bool Context::benchmarkCuBLAS() const {
+  return benchmark_cublas;
+}
+
+void Context::setBenchmarkCuBLAS(bool b) {
+  benchmark_cublas = b;
+}
+
 bool Context::hasMKL() const {
 #if AT_MKL_ENABLED()
   return true;
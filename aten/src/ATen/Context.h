@@ -104,8 +104,28 @@ class CAFFE2_API Context {
   void setUserEnabledMkldnn(bool e);
   bool benchmarkCuDNN() const;
   void setBenchmarkCuDNN(bool);
+  // Whether CPU convolutions time the available backends on the first call
+  // with a given shape and use the fastest one from then on.
+  bool benchmarkCPUConv() const;
+  void setBenchmarkCPUConv(bool);
+  // Whether CPU reductions that accumulate float tensors in double, like std
+  // and var, may accumulate them in float instead, trading precision for speed.
+  bool allowFloatAccumulationCPU() const;
+  void setAllowFloatAccumulationCPU(bool);
+  // Whether cuBLASLt GEMMs time the algorithms suggested by its heuristic on
+  // the first call with a given shape and use the fastest one from then on.
+  bool benchmarkCuBLAS() const;
+  void setBenchmarkCuBLAS(bool);
   bool deterministicCuDNN() const;
   void setDeterministicCuDNN(bool);
+  // Whether kernels that have both a nondeterministic fast path (e.g. with
+  // atomic adds) and a deterministic one should use the deterministic one.
+  bool deterministic() const;
+  void setDeterministic(bool);
+  // Whether clone() and copying to() calls on CPU tensors share the data of
+  // the source copy-on-write instead of copying it, see c10/core/impl/COW.h.
+  bool copyOnWrite() const;
+  void setCopyOnWrite(bool);
   at::QEngine qEngine() const;
   void setQEngine(at::QEngine e);
   const std::vector<at::QEngine>& supportedQEngines() const;
@@ -126,7 +146,12 @@ class CAFFE2_API Context {
   std::once_flag thh_init;
   bool enabled_cudnn = true;
   bool deterministic_cudnn = false;
+  bool deterministic_ = false;
+  bool copy_on_write_ = false;
   bool benchmark_cudnn = false;
+  bool benchmark_cpu_conv = false;
+  bool allow_float_accumulation_cpu = false;
+  bool benchmark_cublas = false;
   bool enabled_mkldnn = true;
   c10::optional<at::QEngine> quantized_engine = c10::nullopt;
   std::unique_ptr<THCState, void(*)(THCState*)> thc_state;
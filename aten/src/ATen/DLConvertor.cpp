@@ -1,5 +1,7 @@
 #include <ATen/DLConvertor.h>
 #include <ATen/Functions.h>
+#include <c10/core/Event.h>
+#include <c10/core/impl/VirtualGuardImpl.h>
 
 #include <iostream>
 #include <sstream>
@@ -82,6 +84,7 @@ DLContext getDLContext(const Tensor& tensor, const int64_t& device_id) {
 static Device getATenDevice(const DLContext& ctx) {
   switch (ctx.device_type) {
     case DLDeviceType::kDLCPU:
+    case DLDeviceType::kDLCPUPinned:
       return at::Device(DeviceType::CPU);
     case DLDeviceType::kDLGPU:
       return at::Device(DeviceType::CUDA, ctx.device_id);
@@ -203,4 +206,39 @@ Tensor fromDLPack(const DLManagedTensor* src) {
       deleter,
       at::device(device).dtype(stype));
 }
+
+// Makes `waiting` wait for the work queued so far on `stream`
+static void waitForStream(const Stream& stream, const Stream& waiting) {
+  if (stream == waiting) {
+    return;
+  }
+  c10::Event event(stream.device_type());
+  event.record(stream);
+  event.block(waiting);
+}
+
+DLManagedTensor* toDLPack(const Tensor& src, Stream consumer_stream) {
+  if (src.device().type() != DeviceType::CPU) {
+    TORCH_CHECK(
+        consumer_stream.device() == src.device(),
+        "toDLPack: expected a consumer stream on ", src.device(),
+        ", but got one on ", consumer_stream.device());
+    c10::impl::VirtualGuardImpl impl(src.device().type());
+    waitForStream(impl.getStream(src.device()), consumer_stream);
+  }
+  return toDLPack(src);
+}
+
+Tensor fromDLPack(const DLManagedTensor* src, Stream producer_stream) {
+  Tensor tensor = fromDLPack(src);
+  if (tensor.device().type() != DeviceType::CPU) {
+    TORCH_CHECK(
+        producer_stream.device() == tensor.device(),
+        "fromDLPack: expected a producer stream on ", tensor.device(),
+        ", but got one on ", producer_stream.device());
+    c10::impl::VirtualGuardImpl impl(tensor.device().type());
+    waitForStream(producer_stream, impl.getStream(tensor.device()));
+  }
+  return tensor;
+}
 } // namespace at
@@ -13,6 +13,12 @@ namespace at {
 CAFFE2_API ScalarType toScalarType(const DLDataType& dtype);
 CAFFE2_API DLManagedTensor* toDLPack(const Tensor& src);
 CAFFE2_API Tensor fromDLPack(const DLManagedTensor* src);
+// Hand the tensor over between streams instead of synchronizing the device:
+// the consumer stream waits for the work queued so far on the current stream
+// of the device of the tensor, and the current stream waits for the work
+// queued on the producer stream, respectively. CPU tensors ignore the stream.
+CAFFE2_API DLManagedTensor* toDLPack(const Tensor& src, Stream consumer_stream);
+CAFFE2_API Tensor fromDLPack(const DLManagedTensor* src, Stream producer_stream);
 CAFFE2_API DLDataType getDLDataType(const Tensor& t);
 CAFFE2_API DLContext getDLContext(const Tensor& tensor, const int64_t& device_id);
 
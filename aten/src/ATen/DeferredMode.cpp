@@ -0,0 +1,562 @@
+#include <ATen/ATen.h>
+#include <ATen/DeferredMode.h>
+#include <ATen/Dispatch.h>
+#include <ATen/ExpandUtils.h>
+#include <ATen/native/TensorIterator.h>
+#include <torch/library.h>
+
+#include <c10/core/impl/LocalDispatchKeySet.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace at {
+namespace deferred {
+
+namespace {
+
+enum class OpKind : uint8_t {
+  Add, // a + alpha * b, also used for sub
+  Mul,
+  Div,
+  Neg,
+  Exp,
+  Tanh,
+  Sigmoid,
+};
+
+// An argument of a deferred op: the output of an earlier deferred op, a
+// tensor that is not deferred, or a wrapped number
+struct Operand {
+  enum class Kind : uint8_t { Op, Input, Constant };
+  Kind kind = Kind::Constant;
+  size_t index = 0;
+  double value = 0;
+};
+
+struct DeferredOp {
+  OpKind kind;
+  Operand args[2];
+  size_t num_args;
+  double alpha;
+  Tensor output;
+};
+
+struct PendingOps {
+  std::vector<Tensor> inputs;
+  std::vector<DeferredOp> ops;
+};
+
+// Bounds the memory held by outputs that are not computed yet
+constexpr size_t kMaxDeferredOps = 16;
+// The evaluation keeps this many elements of every op in a buffer
+constexpr int64_t kChunkSize = 64;
+constexpr size_t kMaxRows = 3 * kMaxDeferredOps;
+
+// Deferral is tied to the thread that enabled the mode: the dispatch key is
+// propagated to other threads (e.g. autograd or inter-op threads) with the
+// rest of the thread local state, and their ops must not stay pending on a
+// thread nobody flushes.
+thread_local bool deferring = false;
+thread_local PendingOps pending;
+
+bool isWrappedScalar(const Tensor& t) {
+  if (!t.unsafeGetTensorImpl()->is_wrapped_number()) {
+    return false;
+  }
+  const auto dtype = t.scalar_type();
+  return dtype == kDouble || dtype == kLong || dtype == kBool;
+}
+
+double wrappedScalarValue(const Tensor& t) {
+  switch (t.scalar_type()) {
+    case kDouble:
+      return *t.data_ptr<double>();
+    case kLong:
+      return static_cast<double>(*t.data_ptr<int64_t>());
+    default:
+      return *t.data_ptr<bool>() ? 1 : 0;
+  }
+}
+
+bool canDefer(const Tensor& t) {
+  return t.device().is_cpu() && t.layout() == kStrided &&
+      (t.scalar_type() == kFloat || t.scalar_type() == kDouble) &&
+      t.is_contiguous() && !t.requires_grad() && !t.has_names();
+}
+
+c10::optional<size_t> findPendingOp(const Tensor& t) {
+  for (size_t i = 0; i < pending.ops.size(); ++i) {
+    if (pending.ops[i].output.unsafeGetTensorImpl() ==
+        t.unsafeGetTensorImpl()) {
+      return i;
+    }
+  }
+  return c10::nullopt;
+}
+
+// Whether `t` is a view of a pending output, whose data is not known yet
+bool aliasesPendingOp(const Tensor& t) {
+  for (const auto& op : pending.ops) {
+    if (op.output.storage().unsafeGetStorageImpl() ==
+        t.storage().unsafeGetStorageImpl()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns the output of the op if it could be deferred
+c10::optional<Tensor> tryDefer(
+    OpKind kind,
+    const Tensor& a,
+    const Tensor* b,
+    double alpha = 1) {
+  if (!deferring) {
+    return c10::nullopt;
+  }
+  const Tensor* args[2] = {&a, b};
+  const size_t num_args = b ? 2 : 1;
+  const Tensor* like = nullptr;
+  for (size_t i = 0; i < num_args; ++i) {
+    const Tensor& t = *args[i];
+    if (!t.defined()) {
+      return c10::nullopt;
+    }
+    if (isWrappedScalar(t)) {
+      continue;
+    }
+    if (!canDefer(t) || (like && like->scalar_type() != t.scalar_type())) {
+      return c10::nullopt;
+    }
+    like = &t;
+  }
+  if (!like) {
+    return c10::nullopt;
+  }
+  const auto sizes =
+      num_args == 2 ? infer_size(a.sizes(), b->sizes()) : a.sizes().vec();
+
+  if (pending.ops.size() >= kMaxDeferredOps) {
+    flush();
+  }
+  for (size_t i = 0; i < num_args; ++i) {
+    const Tensor& t = *args[i];
+    if (!isWrappedScalar(t) && !findPendingOp(t) && aliasesPendingOp(t)) {
+      flush();
+      break;
+    }
+  }
+
+  DeferredOp op;
+  op.kind = kind;
+  op.num_args = num_args;
+  op.alpha = alpha;
+  for (size_t i = 0; i < num_args; ++i) {
+    const Tensor& t = *args[i];
+    Operand& operand = op.args[i];
+    if (isWrappedScalar(t)) {
+      operand.kind = Operand::Kind::Constant;
+      operand.value = wrappedScalarValue(t);
+    } else if (auto index = findPendingOp(t)) {
+      operand.kind = Operand::Kind::Op;
+      operand.index = *index;
+    } else {
+      operand.kind = Operand::Kind::Input;
+      auto it = std::find_if(
+          pending.inputs.begin(), pending.inputs.end(), [&](const Tensor& in) {
+            return in.unsafeGetTensorImpl() == t.unsafeGetTensorImpl();
+          });
+      operand.index = it - pending.inputs.begin();
+      if (it == pending.inputs.end()) {
+        pending.inputs.push_back(t);
+      }
+    }
+  }
+  {
+    c10::impl::ExcludeDispatchKeyGuard guard(DispatchKey::Deferred);
+    op.output = at::empty(sizes, like->options());
+  }
+  pending.ops.push_back(op);
+  return pending.ops.back().output;
+}
+
+// A row of the evaluation buffer, or a constant
+template <typename scalar_t>
+struct Arg {
+  size_t row;
+  bool is_constant;
+  scalar_t value;
+};
+
+template <typename scalar_t>
+struct Step {
+  OpKind kind;
+  Arg<scalar_t> a;
+  Arg<scalar_t> b;
+  scalar_t alpha;
+  int output; // operand of the iterator to write the result to, or -1
+};
+
+// Runs the steps of a group chunk by chunk: the inputs are loaded into the
+// first rows of the buffer, and every step computes the next row.
+template <typename scalar_t>
+void evaluateSteps(
+    TensorIterator& iter,
+    const std::vector<Step<scalar_t>>& steps,
+    size_t num_inputs) {
+  const int num_outputs = iter.noutputs();
+  iter.for_each([&](char** data, const int64_t* strides, int64_t n) {
+    scalar_t buffer[kMaxRows][kChunkSize];
+    for (int64_t begin = 0; begin < n; begin += kChunkSize) {
+      const int64_t m = std::min(kChunkSize, n - begin);
+      for (size_t k = 0; k < num_inputs; ++k) {
+        const int64_t stride = strides[num_outputs + k];
+        const char* src = data[num_outputs + k] + begin * stride;
+        for (int64_t i = 0; i < m; ++i) {
+          buffer[k][i] = *reinterpret_cast<const scalar_t*>(src + i * stride);
+        }
+      }
+      for (size_t s = 0; s < steps.size(); ++s) {
+        const auto& step = steps[s];
+        scalar_t* out = buffer[num_inputs + s];
+        const scalar_t* a =
+            step.a.is_constant ? &step.a.value : buffer[step.a.row];
+        const scalar_t* b =
+            step.b.is_constant ? &step.b.value : buffer[step.b.row];
+        const int64_t sa = step.a.is_constant ? 0 : 1;
+        const int64_t sb = step.b.is_constant ? 0 : 1;
+        switch (step.kind) {
+          case OpKind::Add:
+            for (int64_t i = 0; i < m; ++i) {
+              out[i] = a[i * sa] + step.alpha * b[i * sb];
+            }
+            break;
+          case OpKind::Mul:
+            for (int64_t i = 0; i < m; ++i) {
+              out[i] = a[i * sa] * b[i * sb];
+            }
+            break;
+          case OpKind::Div:
+            for (int64_t i = 0; i < m; ++i) {
+              out[i] = a[i * sa] / b[i * sb];
+            }
+            break;
+          case OpKind::Neg:
+            for (int64_t i = 0; i < m; ++i) {
+              out[i] = -a[i * sa];
+            }
+            break;
+          case OpKind::Exp:
+            for (int64_t i = 0; i < m; ++i) {
+              out[i] = std::exp(a[i * sa]);
+            }
+            break;
+          case OpKind::Tanh:
+            for (int64_t i = 0; i < m; ++i) {
+              out[i] = std::tanh(a[i * sa]);
+            }
+            break;
+          case OpKind::Sigmoid:
+            for (int64_t i = 0; i < m; ++i) {
+              out[i] = static_cast<scalar_t>(1) /
+                  (static_cast<scalar_t>(1) + std::exp(-a[i * sa]));
+            }
+            break;
+        }
+        if (step.output >= 0) {
+          const int64_t stride = strides[step.output];
+          char* dst = data[step.output] + begin * stride;
+          for (int64_t i = 0; i < m; ++i) {
+            *reinterpret_cast<scalar_t*>(dst + i * stride) = out[i];
+          }
+        }
+      }
+    }
+  });
+}
+
+// Evaluates the ops of one size in a single loop. Only the outputs in
+// `materialize` are written; inputs of the group are tensors that were not
+// deferred and outputs of other groups, which are evaluated before.
+void evaluateGroup(
+    const PendingOps& state,
+    const std::vector<size_t>& ops,
+    const std::vector<bool>& materialize) {
+  TensorIterator iter;
+  std::vector<int> output_of(state.ops.size(), -1);
+  for (size_t i : ops) {
+    if (materialize[i]) {
+      output_of[i] = iter.noutputs();
+      iter.add_output(state.ops[i].output);
+    }
+  }
+  if (iter.noutputs() == 0) {
+    return;
+  }
+  const int num_outputs = iter.noutputs();
+
+  // The inputs are loaded into the first rows of the buffer, followed by
+  // a row for every op of the group
+  std::vector<int> row_of_op(state.ops.size(), -1);
+  for (size_t s = 0; s < ops.size(); ++s) {
+    row_of_op[ops[s]] = s;
+  }
+  // (is an input, index) of the tensor loaded into each input row
+  std::vector<std::pair<bool, size_t>> input_rows;
+  auto inputKey = [](const Operand& operand) {
+    return std::make_pair(operand.kind == Operand::Kind::Input, operand.index);
+  };
+  for (size_t i : ops) {
+    const auto& op = state.ops[i];
+    for (size_t k = 0; k < op.num_args; ++k) {
+      const auto& operand = op.args[k];
+      const bool external = operand.kind == Operand::Kind::Input ||
+          (operand.kind == Operand::Kind::Op && row_of_op[operand.index] < 0);
+      if (external &&
+          std::find(input_rows.begin(), input_rows.end(), inputKey(operand)) ==
+              input_rows.end()) {
+        input_rows.push_back(inputKey(operand));
+        iter.add_input(
+            operand.kind == Operand::Kind::Input
+                ? state.inputs[operand.index]
+                : state.ops[operand.index].output);
+      }
+    }
+  }
+  const size_t num_inputs = input_rows.size();
+
+  iter.dont_resize_outputs();
+  iter.build();
+  AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "deferred_flush", [&] {
+    std::vector<Step<scalar_t>> steps;
+    auto toArg = [&](const Operand& operand) {
+      Arg<scalar_t> arg{0, false, 0};
+      if (operand.kind == Operand::Kind::Constant) {
+        arg.is_constant = true;
+        arg.value = static_cast<scalar_t>(operand.value);
+      } else if (
+          operand.kind == Operand::Kind::Op && row_of_op[operand.index] >= 0) {
+        arg.row = num_inputs + row_of_op[operand.index];
+      } else {
+        arg.row = std::find(
+                      input_rows.begin(), input_rows.end(), inputKey(operand)) -
+            input_rows.begin();
+      }
+      return arg;
+    };
+    for (size_t i : ops) {
+      const auto& op = state.ops[i];
+      Step<scalar_t> step;
+      step.kind = op.kind;
+      step.a = toArg(op.args[0]);
+      step.b = op.num_args == 2 ? toArg(op.args[1]) : step.a;
+      step.alpha = static_cast<scalar_t>(op.alpha);
+      step.output = output_of[i];
+      steps.push_back(step);
+    }
+    TORCH_INTERNAL_ASSERT(
+        iter.ntensors() == num_outputs + static_cast<int>(num_inputs));
+    evaluateSteps<scalar_t>(iter, steps, num_inputs);
+  });
+}
+
+void evaluate(const PendingOps& state) {
+  const size_t n = state.ops.size();
+  // only the ops whose output is held outside, and the ops they depend on,
+  // are computed
+  std::vector<bool> needed(n, false);
+  for (size_t i = n; i-- > 0;) {
+    const auto& op = state.ops[i];
+    needed[i] = needed[i] || op.output.use_count() > 1;
+    if (!needed[i]) {
+      continue;
+    }
+    for (size_t k = 0; k < op.num_args; ++k) {
+      if (op.args[k].kind == Operand::Kind::Op) {
+        needed[op.args[k].index] = true;
+      }
+    }
+  }
+
+  // group the needed ops by size
+  std::vector<std::vector<size_t>> groups;
+  std::vector<size_t> group_of(n, 0);
+  for (size_t i = 0; i < n; ++i) {
+    if (!needed[i]) {
+      continue;
+    }
+    auto it = std::find_if(
+        groups.begin(), groups.end(), [&](const std::vector<size_t>& group) {
+          return state.ops[group[0]].output.sizes() ==
+              state.ops[i].output.sizes();
+        });
+    group_of[i] = it - groups.begin();
+    if (it == groups.end()) {
+      groups.emplace_back();
+    }
+    groups[group_of[i]].push_back(i);
+  }
+
+  // an output is written if it is held outside or read by another group
+  std::vector<bool> materialize(n, false);
+  std::vector<std::vector<size_t>> group_deps(groups.size());
+  for (size_t i = 0; i < n; ++i) {
+    if (!needed[i]) {
+      continue;
+    }
+    const auto& op = state.ops[i];
+    materialize[i] = materialize[i] || op.output.use_count() > 1;
+    for (size_t k = 0; k < op.num_args; ++k) {
+      const auto& operand = op.args[k];
+      if (operand.kind == Operand::Kind::Op &&
+          group_of[operand.index] != group_of[i]) {
+        materialize[operand.index] = true;
+        group_deps[group_of[i]].push_back(group_of[operand.index]);
+      }
+    }
+  }
+
+  // Broadcasting only grows sizes, so the groups have no cyclic dependencies
+  std::vector<bool> done(groups.size(), false);
+  size_t num_done = 0;
+  while (num_done < groups.size()) {
+    const size_t num_done_before = num_done;
+    for (size_t g = 0; g < groups.size(); ++g) {
+      if (done[g] ||
+          !std::all_of(
+              group_deps[g].begin(), group_deps[g].end(), [&](size_t dep) {
+                return done[dep];
+              })) {
+        continue;
+      }
+      evaluateGroup(state, groups[g], materialize);
+      done[g] = true;
+      num_done++;
+    }
+    TORCH_INTERNAL_ASSERT(num_done > num_done_before);
+  }
+}
+
+Tensor addDeferred(const Tensor& self, const Tensor& other, Scalar alpha) {
+  if (!alpha.isComplex()) {
+    if (auto result = tryDefer(OpKind::Add, self, &other, alpha.to<double>())) {
+      return *result;
+    }
+  }
+  flush();
+  c10::impl::ExcludeDispatchKeyGuard guard(DispatchKey::Deferred);
+  return at::add(self, other, alpha);
+}
+
+Tensor subDeferred(const Tensor& self, const Tensor& other, Scalar alpha) {
+  if (!alpha.isComplex()) {
+    if (auto result =
+            tryDefer(OpKind::Add, self, &other, -alpha.to<double>())) {
+      return *result;
+    }
+  }
+  flush();
+  c10::impl::ExcludeDispatchKeyGuard guard(DispatchKey::Deferred);
+  return at::sub(self, other, alpha);
+}
+
+Tensor mulDeferred(const Tensor& self, const Tensor& other) {
+  if (auto result = tryDefer(OpKind::Mul, self, &other)) {
+    return *result;
+  }
+  flush();
+  c10::impl::ExcludeDispatchKeyGuard guard(DispatchKey::Deferred);
+  return at::mul(self, other);
+}
+
+Tensor divDeferred(const Tensor& self, const Tensor& other) {
+  if (auto result = tryDefer(OpKind::Div, self, &other)) {
+    return *result;
+  }
+  flush();
+  c10::impl::ExcludeDispatchKeyGuard guard(DispatchKey::Deferred);
+  return at::div(self, other);
+}
+
+Tensor negDeferred(const Tensor& self) {
+  if (auto result = tryDefer(OpKind::Neg, self, nullptr)) {
+    return *result;
+  }
+  flush();
+  c10::impl::ExcludeDispatchKeyGuard guard(DispatchKey::Deferred);
+  return at::neg(self);
+}
+
+Tensor expDeferred(const Tensor& self) {
+  if (auto result = tryDefer(OpKind::Exp, self, nullptr)) {
+    return *result;
+  }
+  flush();
+  c10::impl::ExcludeDispatchKeyGuard guard(DispatchKey::Deferred);
+  return at::exp(self);
+}
+
+Tensor tanhDeferred(const Tensor& self) {
+  if (auto result = tryDefer(OpKind::Tanh, self, nullptr)) {
+    return *result;
+  }
+  flush();
+  c10::impl::ExcludeDispatchKeyGuard guard(DispatchKey::Deferred);
+  return at::tanh(self);
+}
+
+Tensor sigmoidDeferred(const Tensor& self) {
+  if (auto result = tryDefer(OpKind::Sigmoid, self, nullptr)) {
+    return *result;
+  }
+  flush();
+  c10::impl::ExcludeDispatchKeyGuard guard(DispatchKey::Deferred);
+  return at::sigmoid(self);
+}
+
+} // namespace
+
+bool is_enabled() {
+  return c10::impl::tls_is_dispatch_key_included(DispatchKey::Deferred);
+}
+
+void set_enabled(bool enabled) {
+  if (!enabled) {
+    flush();
+  }
+  deferring = enabled;
+  c10::impl::tls_set_dispatch_key_included(DispatchKey::Deferred, enabled);
+}
+
+void flush() {
+  if (pending.ops.empty()) {
+    return;
+  }
+  PendingOps state = std::move(pending);
+  pending.inputs.clear();
+  pending.ops.clear();
+  c10::impl::ExcludeDispatchKeyGuard guard(DispatchKey::Deferred);
+  evaluate(state);
+}
+
+// All the other ops flush the pending ops before running, see DeferredType
+// in torch/csrc/autograd/generated; ops without a kernel of their own, which
+// are implemented with other ops, fall through.
+TORCH_LIBRARY_IMPL(_, Deferred, m) {
+  m.fallback(torch::CppFunction::makeFallthrough());
+}
+
+TORCH_LIBRARY_IMPL(aten, Deferred, m) {
+  m.impl("add.Tensor", addDeferred);
+  m.impl("sub.Tensor", subDeferred);
+  m.impl("mul.Tensor", mulDeferred);
+  m.impl("div.Tensor", divDeferred);
+  m.impl("neg", negDeferred);
+  m.impl("exp", expDeferred);
+  m.impl("tanh", tanhDeferred);
+  m.impl("sigmoid", sigmoidDeferred);
+}
+
+} // namespace deferred
+} // namespace at
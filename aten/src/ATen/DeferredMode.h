@@ -0,0 +1,29 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+namespace at {
+namespace deferred {
+
+// Deferred mode fuses chains of pointwise ops written in eager code, such as
+// `a * b + c`, into a single pass over memory.
+//
+// While it is enabled on a thread, add, sub, mul, div, neg, exp, tanh and
+// sigmoid of contiguous float or double CPU tensors that do not require grad
+// return their (allocated) output right away and only record the computation.
+// The recorded ops are evaluated together, tensors of the same size in one
+// TensorIterator loop that keeps intermediates in a small buffer and skips
+// the ones nobody holds anymore, when any other op is called, when the mode is
+// disabled, or on flush(). Other ops, and ops whose inputs do not qualify, run
+// eagerly.
+//
+// Reading the data of a deferred output without calling an op, e.g. through
+// data_ptr(), must be preceded by flush().
+TORCH_API bool is_enabled();
+TORCH_API void set_enabled(bool enabled);
+
+// Evaluates the ops deferred on this thread
+TORCH_API void flush();
+
+} // namespace deferred
+} // namespace at
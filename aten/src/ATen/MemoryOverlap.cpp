@@ -48,10 +48,15 @@ MemOverlapStatus get_overlap_status(TensorImpl* a, TensorImpl* b) {
   if (!a->is_contiguous() || !b->is_contiguous()) {
     return MemOverlapStatus::TOO_HARD;
   }
-  if (a->storage().data() == b->storage().data()) {
-    const auto a_begin = static_cast<char*>(a->data());
+  const auto& a_storage = a->storage();
+  if (a_storage.const_data() == b->storage().const_data()) {
+    // Storages sharing copy-on-write data get their own copies before a write
+    if (a_storage.is_cow() && !a_storage.is_alias_of(b->storage())) {
+      return MemOverlapStatus::NO;
+    }
+    const auto a_begin = static_cast<const char*>(a->const_data());
     const auto a_end = a_begin + a->numel() * a->itemsize();
-    const auto b_begin = static_cast<char*>(b->data());
+    const auto b_begin = static_cast<const char*>(b->const_data());
     const auto b_end = b_begin + b->numel() * b->itemsize();
 
     if (a_begin == b_begin && a_end == b_end) {
@@ -0,0 +1,83 @@
+#include <ATen/ATen.h>
+#include <ATen/NestedTensorImpl.h>
+#include <ATen/InitialTensorOptions.h>
+
+namespace at {
+
+namespace {
+  DeviceType nestedTensorSetToDeviceType(DispatchKeySet key_set) {
+    if (key_set.has(DispatchKey::NestedCPU)) {
+      return kCPU;
+    } else {
+      AT_ERROR("Cannot construct NestedTensor with non-nested tensor type ID ", key_set);
+    }
+  }
+}
+
+// An empty nested tensor has no entries, so its offsets hold the single
+// element 0 and its buffer is empty.
+NestedTensorImpl::NestedTensorImpl(at::DispatchKeySet key_set, const caffe2::TypeMeta& data_type)
+  :   NestedTensorImpl(key_set, data_type
+      , at::empty({0}, at::initialTensorOptions().device(nestedTensorSetToDeviceType(key_set)).dtype(data_type))
+      , at::zeros({1}, at::initialTensorOptions().device(nestedTensorSetToDeviceType(key_set)).dtype(ScalarType::Long))) {}
+
+NestedTensorImpl::NestedTensorImpl(
+    at::DispatchKeySet key_set,
+    const caffe2::TypeMeta& data_type,
+    at::Tensor buffer,
+    at::Tensor offsets)
+    : TensorImpl(key_set, data_type, buffer.device())
+    , buffer_(std::move(buffer))
+    , offsets_(std::move(offsets)) {
+  sizes_ = {0, 0};
+  refresh_numel();
+}
+
+IntArrayRef NestedTensorImpl::strides() const {
+  AT_ERROR("nested tensors do not have strides");
+}
+bool NestedTensorImpl::is_contiguous(at::MemoryFormat memory_format) const {
+  AT_ERROR("nested tensors do not have is_contiguous");
+}
+int64_t NestedTensorImpl::stride(int64_t d) const {
+  AT_ERROR("nested tensors do not have strides");
+}
+void NestedTensorImpl::set_size(int64_t dim, int64_t new_size) {
+  AT_ERROR("nested tensors do not have set_size");
+}
+void NestedTensorImpl::set_stride(int64_t dim, int64_t new_stride) {
+  AT_ERROR("nested tensors do not have set_stride");
+}
+void NestedTensorImpl::set_storage_offset(int64_t storage_offset) {
+  AT_ERROR("nested tensors do not have set_storage_offset");
+}
+
+bool NestedTensorImpl::has_storage() const {
+  return false;
+}
+const Storage& NestedTensorImpl::storage() const {
+  AT_ERROR("nested tensors do not have storage");
+}
+int64_t NestedTensorImpl::storage_offset() const {
+  AT_ERROR("nested tensors do not have storage");
+}
+
+void NestedTensorImpl::set_member_tensors_unsafe(const Tensor& buffer, const Tensor& offsets) {
+  TORCH_CHECK(allow_tensor_metadata_change(), "set_member_tensors_unsafe ", err_msg_tensor_metadata_change_not_allowed);
+  TORCH_CHECK(buffer.device().type() == device().type(), "device type of buffer (", buffer.device().type(), ") must match device type of the nested tensor (", device().type(), ")");
+  TORCH_CHECK(buffer.scalar_type() == typeMetaToScalarType(dtype()), "dtype of buffer (", buffer.scalar_type(), ") must match dtype of nested tensor (", typeMetaToScalarType(dtype()), ")");
+  TORCH_CHECK(buffer.dim() >= 1, "the buffer of a nested tensor must have at least one dim");
+
+  buffer_ = buffer;
+  offsets_ = offsets;
+  const int64_t* offsets_ptr = offsets_.data_ptr<int64_t>();
+  int64_t max_length = 0;
+  for (int64_t i = 0; i < num_entries(); i++) {
+    max_length = std::max(max_length, offsets_ptr[i + 1] - offsets_ptr[i]);
+  }
+  sizes_ = {num_entries(), max_length};
+  sizes_.insert(sizes_.end(), buffer_.sizes().begin() + 1, buffer_.sizes().end());
+  refresh_numel();
+}
+
+} // namespace at
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <ATen/Tensor.h>
+#include <c10/core/TensorImpl.h>
+#include <c10/util/Exception.h>
+
+namespace at {
+
+// A batch of B tensors that have the same dims except the first, which is
+// ragged: entry i has size [length_i, *inner], e.g. the hidden states of
+// sentences of different lengths. The entries are packed one after the other,
+// without padding:
+//
+//   buffer_:  a contiguous tensor of size [sum_i length_i, *inner].
+//   offsets_: a LongTensor of size [B + 1]. Entry i is the rows
+//             [offsets_[i], offsets_[i + 1]) of buffer_, so offsets_[0] == 0
+//             and offsets_[B] == buffer_.size(0).
+//
+// The sizes of a nested tensor are those of its padded form,
+// [B, max_i length_i, *inner]; it has no strides or storage of its own.
+struct CAFFE2_API NestedTensorImpl : public TensorImpl {
+  Tensor buffer_;
+  Tensor offsets_;
+
+ public:
+  explicit NestedTensorImpl(at::DispatchKeySet, const caffe2::TypeMeta&);
+
+  int64_t num_entries() const { return offsets_.numel() - 1; }
+  Tensor buffer() const { return buffer_; }
+  Tensor offsets() const { return offsets_; }
+
+  IntArrayRef strides() const override;
+  bool is_contiguous(at::MemoryFormat memory_format=at::MemoryFormat::Contiguous) const override;
+  int64_t stride(int64_t d) const override;
+  void set_size(int64_t dim, int64_t new_size) override;
+  void set_stride(int64_t dim, int64_t new_stride) override;
+  void set_storage_offset(int64_t storage_offset) override;
+
+  bool has_storage() const override;
+  const Storage& storage() const override;
+  int64_t storage_offset() const override;
+
+  // Takes the member tensors as they are; the caller is responsible for
+  // checking that buffer is contiguous and that offsets are valid for it.
+  void set_member_tensors_unsafe(const Tensor& buffer, const Tensor& offsets);
+
+  /**
+   * Return a TensorImpl that is a shallow-copy of this TensorImpl.
+   *
+   * For usage of `version_counter` and `allow_tensor_metadata_change`,
+   * see NOTE [ TensorImpl Shallow-Copying ].
+   */
+  c10::intrusive_ptr<TensorImpl> shallow_copy_and_detach(
+      const c10::VariableVersion& version_counter,
+      bool allow_tensor_metadata_change) const override {
+    auto impl = c10::make_intrusive<NestedTensorImpl>(key_set(), dtype());
+    copy_tensor_metadata(
+      /*src_impl=*/this,
+      /*dest_impl=*/impl.get(),
+      /*version_counter=*/version_counter,
+      /*allow_tensor_metadata_change=*/allow_tensor_metadata_change);
+    impl->refresh_numel();
+    return impl;
+  }
+
+  /**
+   * Shallow-copies data from another TensorImpl into this TensorImpl.
+   *
+   * For why this function doesn't check this TensorImpl's `allow_tensor_metadata_change_`,
+   * see NOTE [ TensorImpl Shallow-Copying ].
+   */
+  void shallow_copy_from(const c10::intrusive_ptr<TensorImpl>& impl) override {
+    AT_ASSERT(has_compatible_shallow_copy_type(impl->key_set()));
+    auto nested_impl = static_cast<const NestedTensorImpl*>(impl.get());
+    copy_tensor_metadata(
+      /*src_impl=*/nested_impl,
+      /*dest_impl=*/this,
+      /*version_counter=*/version_counter(),
+      /*allow_tensor_metadata_change=*/allow_tensor_metadata_change());
+    refresh_numel();
+  }
+
+ private:
+  explicit NestedTensorImpl(
+      at::DispatchKeySet,
+      const caffe2::TypeMeta&,
+      at::Tensor buffer,
+      at::Tensor offsets);
+
+  /**
+   * Copy the tensor metadata fields (e.g. sizes / strides / storage pointer / storage_offset)
+   * from one TensorImpl to another TensorImpl.
+   *
+   * For usage of `version_counter` and `allow_tensor_metadata_change`, see NOTE [ TensorImpl Shallow-Copying ].
+   */
+  static void copy_tensor_metadata(
+      const NestedTensorImpl* src_nested_impl,
+      NestedTensorImpl* dest_nested_impl,
+      const c10::VariableVersion& version_counter,
+      bool allow_tensor_metadata_change) {
+    TensorImpl::copy_tensor_metadata(src_nested_impl, dest_nested_impl, version_counter, allow_tensor_metadata_change);
+
+    dest_nested_impl->buffer_ = src_nested_impl->buffer();
+    dest_nested_impl->offsets_ = src_nested_impl->offsets();
+  }
+};
+
+} // namespace at
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/NestedTensorImpl.h>
+
+namespace at { namespace nested {
+
+// Just for documentary purposes
+using NestedTensor = Tensor;
+
+// The nested counterpart of at::sparse::get_sparse_impl; only use this for
+// writing low level accessors of NestedTensorImpl fields.
+inline NestedTensorImpl* get_nested_impl(const NestedTensor& self) {
+  AT_ASSERTM(self.is_nested(), "_internal_get_NestedTensorImpl: not a nested tensor");
+  return static_cast<NestedTensorImpl*>(self.unsafeGetTensorImpl());
+}
+
+// Wraps a contiguous buffer and valid offsets for it into a new nested
+// tensor. Like the sparse constructors, the member tensors are
+// shallow-copied so that they don't carry AutogradMeta; the nested tensor is
+// not differentiable.
+inline NestedTensor new_nested_with_tensors(const Tensor& buffer, const Tensor& offsets) {
+  auto shallow_copy = [](const Tensor& t) {
+    return Tensor(t.unsafeGetTensorImpl()->shallow_copy_and_detach(
+        /*version_counter=*/t.unsafeGetTensorImpl()->version_counter(),
+        /*allow_tensor_metadata_change=*/true));
+  };
+  NestedTensor self = detail::make_tensor<NestedTensorImpl>(
+      DispatchKeySet(DispatchKey::NestedCPU), buffer.dtype());
+  get_nested_impl(self)->set_member_tensors_unsafe(shallow_copy(buffer), shallow_copy(offsets));
+  return self;
+}
+
+// A nested tensor with the entries of `self` whose buffer is `buffer`, which
+// must have as many rows as the buffer of `self`; its inner dims may differ.
+inline NestedTensor nested_like(const NestedTensor& self, const Tensor& buffer) {
+  return new_nested_with_tensors(buffer.contiguous(), get_nested_impl(self)->offsets());
+}
+
+}} // namespace at::nested
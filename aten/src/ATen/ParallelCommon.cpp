@@ -74,6 +74,8 @@ std::string get_parallel_info() {
   ss << "ATen parallel backend: ";
   #if AT_PARALLEL_OPENMP
   ss << "OpenMP";
+  #elif AT_PARALLEL_NATIVE && AT_PARALLEL_NATIVE_WORK_STEALING
+  ss << "native thread pool with work stealing";
   #elif AT_PARALLEL_NATIVE
   ss << "native thread pool";
   #elif AT_PARALLEL_NATIVE_TBB
@@ -10,6 +10,8 @@
 #endif // C10_MOBILE
 
 #include <atomic>
+#include <memory>
+#include <vector>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -65,13 +67,94 @@ int _num_pool_threads(int nthreads) {
   return nthreads - 1;
 }
 
+// NUMA-partitioned intra-op pool: one group of workers per NUMA node, each
+// bound to its node. Used instead of the flat pool when NUMA is enabled
+// (--caffe2_cpu_numa_enabled) and the host has more than one node.
+class NUMAThreadPool : public TaskThreadPoolBase {
+ public:
+  NUMAThreadPool(int pool_size, int num_nodes) {
+    for (int node = 0; node < num_nodes; ++node) {
+      int node_size = pool_size / num_nodes + (node < pool_size % num_nodes);
+      node_pools_.emplace_back(std::make_unique<PTThreadPool>(node_size, node));
+    }
+  }
+
+  size_t numNodes() const {
+    return node_pools_.size();
+  }
+
+  // Runs `func` on a worker bound to `node`, or on any worker if that node
+  // has no workers.
+  void runOnNode(size_t node, std::function<void()> func) {
+    auto& pool = node_pools_[node];
+    if (pool->size() == 0) {
+      run(std::move(func));
+      return;
+    }
+    pool->run(std::move(func));
+  }
+
+  void run(std::function<void()> func) override {
+    auto num_nodes = node_pools_.size();
+    auto start = next_node_++;
+    for (size_t i = 0; i < num_nodes; ++i) {
+      auto& pool = node_pools_[(start + i) % num_nodes];
+      if (pool->size() > 0) {
+        pool->run(std::move(func));
+        return;
+      }
+    }
+    throw std::runtime_error("No threads to run a task");
+  }
+
+  size_t size() const override {
+    size_t total = 0;
+    for (auto& pool : node_pools_) {
+      total += pool->size();
+    }
+    return total;
+  }
+
+  size_t numAvailable() const override {
+    size_t total = 0;
+    for (auto& pool : node_pools_) {
+      total += pool->numAvailable();
+    }
+    return total;
+  }
+
+  bool inThreadPool() const override {
+    for (auto& pool : node_pools_) {
+      if (pool->inThreadPool()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  std::vector<std::unique_ptr<PTThreadPool>> node_pools_;
+  std::atomic<size_t> next_node_{0};
+};
+
+// Set when the intra-op pool is NUMA-partitioned, nullptr otherwise.
+NUMAThreadPool* numa_intraop_pool_ = nullptr;
+
 TaskThreadPoolBase& _get_intraop_pool() {
-  static std::shared_ptr<TaskThreadPoolBase> pool =
-      ThreadPoolRegistry()->Create(
-          "C10",
-          /* device_id */ 0,
-          /* pool_size */ _num_pool_threads(num_intraop_threads.exchange(CONSUMED)),
-          /* create_new */ true); // create a separate thread pool for intra-op
+  static std::shared_ptr<TaskThreadPoolBase> pool = []() {
+    int pool_size = _num_pool_threads(num_intraop_threads.exchange(CONSUMED));
+    int num_nodes = c10::GetNumNUMANodes();
+    if (c10::IsNUMAEnabled() && num_nodes > 1) {
+      auto numa_pool = std::make_shared<NUMAThreadPool>(pool_size, num_nodes);
+      numa_intraop_pool_ = numa_pool.get();
+      return std::shared_ptr<TaskThreadPoolBase>(std::move(numa_pool));
+    }
+    return ThreadPoolRegistry()->Create(
+        "C10",
+        /* device_id */ 0,
+        /* pool_size */ pool_size,
+        /* create_new */ true); // create a separate thread pool for intra-op
+  }();
   return *pool;
 }
 
@@ -81,8 +164,24 @@ TaskThreadPoolBase& _get_intraop_pool() {
 // `fn` will be called with params: (thread_pool_task_id, task_id).
 void _run_with_pool(const std::function<void(int, size_t)>& fn, size_t range) {
 #ifndef C10_MOBILE
-  for (size_t i = 1; i < range; ++i) {
-    _get_intraop_pool().run([fn, i]() { fn((int)i, i); });
+  auto& pool = _get_intraop_pool();
+  if (numa_intraop_pool_) {
+    // Give each node a contiguous block of task ids, so that a given slice
+    // of the range is always processed on the same node and keeps reusing
+    // the pages it first touched there.
+    size_t num_nodes = numa_intraop_pool_->numNodes();
+    for (size_t i = 1; i < range; ++i) {
+      numa_intraop_pool_->runOnNode(
+          i * num_nodes / range, [fn, i]() { fn((int)i, i); });
+    }
+  } else {
+    // Submitted at once, so that the pool wakes the workers it needs together
+    std::vector<std::function<void()>> tasks;
+    tasks.reserve(range > 0 ? range - 1 : 0);
+    for (size_t i = 1; i < range; ++i) {
+      tasks.emplace_back([fn, i]() { fn((int)i, i); });
+    }
+    pool.runBulk(std::move(tasks));
   }
   // Run the first task on the current thread directly.
   fn(0, 0);
@@ -169,6 +268,147 @@ void _parallel_run(
   }
 }
 
+namespace {
+
+// Number of chunks each task's share of the range is split into for
+// work stealing. Balanced loops pay one CAS per chunk.
+constexpr int64_t kChunksPerTask = 8;
+
+// A task's remaining chunks [front, back), packed into one word so that the
+// owner (taking from the front) and thieves (taking from the back) can claim
+// chunks with a single CAS.
+struct alignas(64) ChunkRange {
+  std::atomic<uint64_t> bounds;
+
+  static uint64_t pack(uint32_t front, uint32_t back) {
+    return (static_cast<uint64_t>(back) << 32) | front;
+  }
+
+  void init(uint32_t front, uint32_t back) {
+    bounds.store(pack(front, back), std::memory_order_relaxed);
+  }
+
+  // Claims the chunk at the front (owner side); returns false if empty.
+  bool pop_front(uint32_t& chunk) {
+    uint64_t cur = bounds.load(std::memory_order_relaxed);
+    while (true) {
+      uint32_t front = static_cast<uint32_t>(cur);
+      uint32_t back = static_cast<uint32_t>(cur >> 32);
+      if (front >= back) {
+        return false;
+      }
+      if (bounds.compare_exchange_weak(cur, pack(front + 1, back))) {
+        chunk = front;
+        return true;
+      }
+    }
+  }
+
+  // Claims the chunk at the back (thief side); returns false if empty.
+  bool pop_back(uint32_t& chunk) {
+    uint64_t cur = bounds.load(std::memory_order_relaxed);
+    while (true) {
+      uint32_t front = static_cast<uint32_t>(cur);
+      uint32_t back = static_cast<uint32_t>(cur >> 32);
+      if (front >= back) {
+        return false;
+      }
+      if (bounds.compare_exchange_weak(cur, pack(front, back - 1))) {
+        chunk = back - 1;
+        return true;
+      }
+    }
+  }
+};
+
+} // namespace
+
+void _parallel_run_work_stealing(
+  const int64_t begin,
+  const int64_t end,
+  const int64_t grain_size,
+  const std::function<void(int64_t, int64_t)>& f) {
+  size_t num_tasks, task_size;
+  std::tie(num_tasks, task_size) =
+      internal::calc_num_tasks_and_chunk_size(begin, end, grain_size);
+  if (num_tasks == 1) {
+    ParallelRegionGuard guard(0);
+    f(begin, end);
+    return;
+  }
+
+  const int64_t chunk_size = std::max(
+      std::max(grain_size, (int64_t)1),
+      divup((int64_t)task_size, kChunksPerTask));
+  const int64_t num_chunks = divup(end - begin, chunk_size);
+  std::vector<ChunkRange> ranges(num_tasks);
+  for (size_t task_id = 0; task_id < num_tasks; ++task_id) {
+    int64_t first = std::min(
+        num_chunks, (int64_t)(task_id * task_size) / chunk_size);
+    int64_t last = task_id + 1 == num_tasks
+        ? num_chunks
+        : std::min(num_chunks, (int64_t)((task_id + 1) * task_size) / chunk_size);
+    ranges[task_id].init(first, last);
+  }
+
+  struct {
+    std::atomic_flag err_flag = ATOMIC_FLAG_INIT;
+    std::exception_ptr eptr;
+    std::mutex mutex;
+    volatile size_t remaining;
+    std::condition_variable cv;
+  } state;
+
+  auto task = [&f, &state, &ranges, begin, end, chunk_size, num_tasks]
+      (int /* unused */, size_t task_id) {
+    auto run_chunk = [&](uint32_t chunk) {
+      int64_t local_start = begin + chunk * chunk_size;
+      int64_t local_end = std::min(end, local_start + chunk_size);
+      try {
+        f(local_start, local_end);
+      } catch (...) {
+        if (!state.err_flag.test_and_set()) {
+          state.eptr = std::current_exception();
+        }
+      }
+    };
+    {
+      ParallelRegionGuard guard(task_id);
+      uint32_t chunk;
+      while (ranges[task_id].pop_front(chunk)) {
+        run_chunk(chunk);
+      }
+      // Own chunks are done, steal from the back of the other tasks. Ranges
+      // only ever shrink, so one pass over the victims is enough.
+      for (size_t i = 1; i < num_tasks; ++i) {
+        auto& victim = ranges[(task_id + i) % num_tasks];
+        while (victim.pop_back(chunk)) {
+          run_chunk(chunk);
+        }
+      }
+    }
+    {
+      std::unique_lock<std::mutex> lk(state.mutex);
+      if (--state.remaining == 0) {
+        state.cv.notify_one();
+      }
+    }
+  };
+  state.remaining = num_tasks;
+  _run_with_pool(task, num_tasks);
+
+  // Wait for all tasks to finish.
+  {
+    std::unique_lock<std::mutex> lk(state.mutex);
+    if (state.remaining != 0) {
+      state.cv.wait(lk);
+    }
+  }
+  if (state.eptr) {
+    std::rethrow_exception(state.eptr);
+  }
+}
+
 } // namespace internal
 
 void init_num_threads() {
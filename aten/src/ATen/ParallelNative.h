@@ -28,6 +28,15 @@ CAFFE2_API void _parallel_run(
   const int64_t grain_size,
   const std::function<void(int64_t, int64_t, size_t)>& f);
 
+// Like _parallel_run, but splits each task's share of the range into smaller
+// chunks that idle tasks may steal. `f` may be called several times per task,
+// so it does not receive a task id.
+CAFFE2_API void _parallel_run_work_stealing(
+  const int64_t begin,
+  const int64_t end,
+  const int64_t grain_size,
+  const std::function<void(int64_t, int64_t)>& f);
+
 } // namespace internal
 
 template <class F>
@@ -44,6 +53,9 @@ inline void parallel_for(
     f(begin, end);
     return;
   }
+#if AT_PARALLEL_NATIVE_WORK_STEALING
+  internal::_parallel_run_work_stealing(begin, end, grain_size, f);
+#else
   internal::_parallel_run(
       begin,
       end,
@@ -52,6 +64,7 @@ inline void parallel_for(
         f(start, end);
       }
   );
+#endif
 }
 
 template <class scalar_t, class F, class SF>
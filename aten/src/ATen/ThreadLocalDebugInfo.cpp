@@ -9,12 +9,13 @@ thread_local std::shared_ptr<ThreadLocalDebugInfo> debug_info = nullptr;
 /* static */
 std::shared_ptr<DebugInfoBase> ThreadLocalDebugInfo::get(
     DebugInfoKind kind) {
-  auto cur = debug_info;
+  // walk the chain without refcounting, the current info keeps it alive
+  ThreadLocalDebugInfo* cur = debug_info.get();
   while (cur) {
     if (cur->kind_ == kind) {
       return cur->debug_info_;
     }
-    cur = cur->parent_info_;
+    cur = cur->parent_info_.get();
   }
   return nullptr;
 }
@@ -30,6 +31,12 @@ void ThreadLocalDebugInfo::_forceCurrentDebugInfo(
   debug_info = info;
 }
 
+/* static */
+bool ThreadLocalDebugInfo::_isCurrent(
+    const std::shared_ptr<ThreadLocalDebugInfo>& info) {
+  return debug_info == info;
+}
+
 DebugInfoGuard::DebugInfoGuard(
     DebugInfoKind kind, std::shared_ptr<DebugInfoBase> info) {
   if (!info) {
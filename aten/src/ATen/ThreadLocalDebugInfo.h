@@ -42,6 +42,10 @@ class CAFFE2_API ThreadLocalDebugInfo {
   static void _forceCurrentDebugInfo(
       const std::shared_ptr<ThreadLocalDebugInfo>& info);
 
+  // Internal, whether info is the current debug info; used by
+  // ThreadLocalStateGuard to skip setting an already current state
+  static bool _isCurrent(const std::shared_ptr<ThreadLocalDebugInfo>& info);
+
  private:
   std::shared_ptr<DebugInfoBase> debug_info_;
   DebugInfoKind kind_;
@@ -31,4 +31,20 @@ void ThreadLocalState::setThreadLocalState(
   c10::impl::_force_tls_local_dispatch_key_set(state.dispatch_key_);
 }
 
+/* static */
+bool ThreadLocalState::isCurrentThreadLocalState(
+    const ThreadLocalState& state) {
+#if !defined(CAFFE2_IS_XPLAT_BUILD) && !defined(C10_MOBILE)
+  if (state.keep_grad_mode_ &&
+      GradMode::is_enabled() != state.grad_mode_enabled_) {
+    return false;
+  }
+#endif
+
+  const auto dispatch_key = c10::impl::tls_local_dispatch_key_set();
+  return dispatch_key.included_ == state.dispatch_key_.included_ &&
+      dispatch_key.excluded_ == state.dispatch_key_.excluded_ &&
+      ThreadLocalDebugInfo::_isCurrent(state.debug_info_);
+}
+
 } // namespace at
@@ -2,6 +2,7 @@
 
 #include <c10/core/impl/LocalDispatchKeySet.h>
 #include <c10/util/Exception.h>
+#include <c10/util/Optional.h>
 
 #include <ATen/ThreadLocalDebugInfo.h>
 
@@ -22,6 +23,10 @@ class TORCH_API ThreadLocalState {
   // according to the thread boundary specified
   static void setThreadLocalState(const ThreadLocalState& state);
 
+  // Whether the thread local variables of the current thread already have
+  // the values saved in state
+  static bool isCurrentThreadLocalState(const ThreadLocalState& state);
+
  private:
   c10::impl::LocalDispatchKeySet dispatch_key_;
 
@@ -38,21 +43,31 @@ class TORCH_API ThreadLocalState {
 };
 
 // Guard to set and reset the thread local state
+//
+// Tasks often run on a thread which already has their state, e.g. the
+// autograd engine running the backward pass on the thread which called it,
+// or an inlined at::launch task; the guard then neither saves, sets nor
+// restores anything.
 class TORCH_API ThreadLocalStateGuard {
  public:
-  explicit ThreadLocalStateGuard(const ThreadLocalState& state)
-      : prev_state_(ThreadLocalState()) {
+  explicit ThreadLocalStateGuard(const ThreadLocalState& state) {
+    if (ThreadLocalState::isCurrentThreadLocalState(state)) {
+      return;
+    }
+    prev_state_ = ThreadLocalState();
     // set the given state across the thread boundary
     ThreadLocalState::setThreadLocalState(state);
   }
 
   ~ThreadLocalStateGuard() {
-    // restore previously set variables
-    ThreadLocalState::setThreadLocalState(prev_state_);
+    if (prev_state_) {
+      // restore previously set variables
+      ThreadLocalState::setThreadLocalState(*prev_state_);
+    }
   }
 
  private:
-  const ThreadLocalState prev_state_;
+  c10::optional<ThreadLocalState> prev_state_;
 };
 
 } // namespace at
@@ -91,6 +91,7 @@ UPTOc( Tensor, multilabel_margin_loss          , (const Tensor &A, const Tensor
 UPTOc( Tensor, soft_margin_loss                , (const Tensor &A, const Tensor &B, int64_t       C) )
 UPTOh( Tensor, triplet_margin_loss             , (const Tensor &A, const Tensor &B, const Tensor &C, double                 D, double        E, double  F, bool G, int64_t H) )
 UPTOf( Tensor, multi_margin_loss               , (const Tensor &A, const Tensor &B, Scalar        C, Scalar                 D, const Tensor &E, int64_t F) )
+UPTOd( Tensor, binary_cross_entropy            , (const Tensor &A, const Tensor &B, const Tensor &C, int64_t                D) )
 UPTOe( Tensor, binary_cross_entropy_with_logits, (const Tensor &A, const Tensor &B, const Tensor &C, const Tensor &         D, int64_t       E) )
 UPTOc( Tensor, dist                            , (const Tensor &A, const Tensor &B, Scalar        C) )
 UPTOb( Tensor, pdist                           , (const Tensor &A, double        B) )
@@ -132,6 +133,7 @@ UPTOd( Tensor, bilinear , (const Tensor &A, const Tensor &B, const Tensor &
 UPTOd( Tensor, tensordot, (const Tensor &A, const Tensor &B, IntArrayRef            C, IntArrayRef   D) )
 UPTOb( Tensor, dot      , (const Tensor &A, const Tensor &B) )
 UPTOb( bool  , equal    , (const Tensor &A, const Tensor &B) )
+UPTOd( Tensor, index_copy, (const Tensor &A, int64_t       B, const Tensor &         C, const Tensor &D) )
 UPTOb( Tensor, cat      , (TensorList    A, int64_t       B) )
 UPTOb( Tensor, cat      , (TensorList    A, Dimname       B) )
 UPTOb( Tensor, _cat     , (TensorList    A, int64_t       B) )
@@ -5,6 +5,10 @@ namespace autocast {
 
 TORCH_API bool is_enabled();
 TORCH_API void set_enabled(bool enabled);
+// Autocasting of CPU tensors, to bfloat16. Independent of the CUDA state above;
+// the cast cache and the nesting count are shared.
+TORCH_API bool is_cpu_enabled();
+TORCH_API void set_cpu_enabled(bool enabled);
 TORCH_API void clear_cache();
 TORCH_API int increment_nesting();
 TORCH_API int decrement_nesting();
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <c10/macros/Macros.h>
+#include <c10/core/impl/ImplObjectCache.h>
 #include <c10/util/TypeTraits.h>
 #include <c10/util/TypeList.h>
 #include <c10/util/intrusive_ptr.h>
@@ -51,6 +52,15 @@ struct DictImpl final : public c10::intrusive_ptr_target {
   DictElementTypes elementTypes;
 
   intrusive_ptr<DictImpl> copy() const;
+
+  // recycled with the impl object cache, see ImplObjectCache.h
+
+  static void* operator new(size_t size) {
+    return c10::impl::allocate_impl_object(size);
+  }
+  static void operator delete(void* ptr, size_t size) {
+    c10::impl::free_impl_object(ptr, size);
+  }
   friend TORCH_API bool operator==(const DictImpl& lhs, const DictImpl& rhs);
 };
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <c10/macros/Macros.h>
+#include <c10/core/impl/ImplObjectCache.h>
 #include <c10/util/TypeTraits.h>
 #include <c10/util/TypeList.h>
 #include <c10/util/intrusive_ptr.h>
@@ -34,6 +35,15 @@ struct ListImpl final : public c10::intrusive_ptr_target {
   intrusive_ptr<ListImpl> copy() const {
     return make_intrusive<ListImpl>(list, elementType);
   }
+
+  // recycled with the impl object cache, see ImplObjectCache.h
+
+  static void* operator new(size_t size) {
+    return c10::impl::allocate_impl_object(size);
+  }
+  static void operator delete(void* ptr, size_t size) {
+    c10::impl::free_impl_object(ptr, size);
+  }
   friend TORCH_API bool operator==(const ListImpl& lhs, const ListImpl& rhs);
 };
 }
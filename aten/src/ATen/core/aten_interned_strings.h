@@ -81,6 +81,7 @@ _(aten, _fft_with_size) \
 _(aten, _fill) \
 _(aten, _floor) \
 _(aten, _fused_dropout) \
+_(aten, _fused_dropout_packed) \
 _(aten, _ger) \
 _(aten, _indexCopy) \
 _(aten, _indices) \
@@ -91,9 +92,11 @@ _(aten, _log) \
 _(aten, _log10) \
 _(aten, _log1p) \
 _(aten, _log2) \
+_(aten, _logcumsumexp) \
 _(aten, _logspace) \
 _(aten, _lu_with_info) \
 _(aten, _masked_scale) \
+_(aten, _masked_scale_packed) \
 _(aten, _mm) \
 _(aten, _mv) \
 _(aten, _nnz) \
@@ -420,6 +423,7 @@ _(aten, log_sigmoid_forward) \
 _(aten, log_softmax) \
 _(aten, _log_softmax) \
 _(aten, _log_softmax_backward_data) \
+_(aten, logcumsumexp) \
 _(aten, logdet) \
 _(aten, logspace) \
 _(aten, logsumexp) \
@@ -10,6 +10,12 @@ void DispatchKeyExtractor::setOperatorHasKernelForBackend(DispatchKey k, bool ha
   } else {
     operatorHasKernelForBackend_ = operatorHasKernelForBackend_.remove(k);
   }
+  updateNonFallthroughKeys_();
+}
+
+void DispatchKeyExtractor::setBackendsWithoutFallthrough(DispatchKeySet backendsWithoutFallthrough) {
+  backendsWithoutFallthrough_ = backendsWithoutFallthrough;
+  updateNonFallthroughKeys_();
 }
 
 std::string DispatchKeyExtractor::dumpState() const {
@@ -27,6 +33,7 @@ std::string DispatchKeyExtractor::dumpState() const {
 
 void DispatchKeyExtractor::checkInvariants(const FunctionSchema& schema) const {
   TORCH_INTERNAL_ASSERT(makeBitsetForDispatchArgs(schema) == dispatch_arg_indices_reverse_);
+  TORCH_INTERNAL_ASSERT(nonFallthroughKeys_ == (backendsWithoutFallthrough_ | operatorHasKernelForBackend_));
 }
 
 } // namespace c10
@@ -119,7 +119,7 @@ public:
     dispatch_arg_indices_reverse_ = c10::utils::bitset();
   }
 
-  DispatchKey getDispatchKeyBoxed(DispatchKeySet backendsWithoutFallthrough, const torch::jit::Stack* stack) const {
+  DispatchKey getDispatchKeyBoxed(const torch::jit::Stack* stack) const {
     DispatchKeySet ks;
     dispatch_arg_indices_reverse_.for_each_set_bit([&] (size_t reverse_arg_index) {
       const auto& ivalue = torch::jit::peek(*stack, 0, reverse_arg_index + 1);
@@ -133,19 +133,30 @@ public:
         }
       }
     });
-    return dispatchKeySetToDispatchKey_(backendsWithoutFallthrough, DispatchKeySet::FULL, ks);
+    return dispatchKeySetToDispatchKey_(DispatchKeySet::FULL, ks);
   }
 
   template<class... Args>
-  DispatchKey getDispatchKeyUnboxed(DispatchKeySet backendsWithoutFallthrough, DispatchKeySet eligibleKeys, const Args&... args) const {
+  DispatchKey getDispatchKeyUnboxed(DispatchKeySet eligibleKeys, const Args&... args) const {
     auto ks = detail::multi_dispatch_key_set(args...);
-    return dispatchKeySetToDispatchKey_(backendsWithoutFallthrough, eligibleKeys, ks);
+    return dispatchKeySetToDispatchKey_(eligibleKeys, ks);
+  }
+
+  // The key for a call whose keys are already known (see
+  // Dispatcher::callUnboxedWithKeySet): neither the arguments nor the TLS
+  // are looked at, only the fallthrough keys of the operator are removed.
+  DispatchKey getDispatchKeyFromKeySet(DispatchKeySet ks) const {
+    return (ks & nonFallthroughKeys_).highestPriorityTypeId();
   }
 
   // Used by DispatchTable to maintain the fallthrough invariant, see
   // docs on operatorHasKernelForBackend_
   void setOperatorHasKernelForBackend(DispatchKey k, bool has_kernel);
 
+  // Used by the Dispatcher to keep the backends without fallthrough kernel
+  // (which change when fallbacks are registered) up to date in every operator
+  void setBackendsWithoutFallthrough(DispatchKeySet backendsWithoutFallthrough);
+
   std::string dumpState() const;
   void checkInvariants(const FunctionSchema& schema) const;
 
@@ -165,34 +176,41 @@ private:
 
   // NB: If there is no valid dispatch key, this will return Undefined
   DispatchKey dispatchKeySetToDispatchKey_(
-      DispatchKeySet backendsWithoutFallthrough,
       // This is often known statically to be all ones; IN OPTIMIZER WE TRUST
       DispatchKeySet eligibleKeys,
       DispatchKeySet ks
   ) const {
     return impl::dispatchTypeId(ks,
-      // We must NOT respect the passed in backendsWithoutFallthrough if an operator has
-      // specifically overridden the backend, since that means we've opted to
-      // not fallthrough and instead apply some specific behavior (which we
-      // must dispatch to).  For now, we assume that operators NEVER override
-      // a backend with a fallthrough kernel (see
-      // https://github.com/pytorch/pytorch/issues/32454) which means we can just
-      // unconditionally fill in the mask when the operator tells us to, via
-      // operatorHasKernelForBackend_.
-      //
-      // This scheme doesn't work if you want to also apply fallthrough on a
-      // per-op basis, but while we could directly fix this by maintaining a
-      // second DispatchKeySet, it doesn't seem that there is any actual use case,
-      // so we are deferring it for #32454.
-        (backendsWithoutFallthrough | operatorHasKernelForBackend_)
+      // The backends without fallthrough and with a kernel of this operator,
+      // see nonFallthroughKeys_
+        nonFallthroughKeys_
       // Regardless of fallthrough behavior, only accept keys which are eligible
       // for dispatch, as requested by the user
       & eligibleKeys);
   }
 
+  void updateNonFallthroughKeys_() {
+    // We must NOT respect backendsWithoutFallthrough_ if an operator has
+    // specifically overridden the backend, since that means we've opted to
+    // not fallthrough and instead apply some specific behavior (which we
+    // must dispatch to).  For now, we assume that operators NEVER override
+    // a backend with a fallthrough kernel (see
+    // https://github.com/pytorch/pytorch/issues/32454) which means we can just
+    // unconditionally fill in the mask when the operator tells us to, via
+    // operatorHasKernelForBackend_.
+    //
+    // This scheme doesn't work if you want to also apply fallthrough on a
+    // per-op basis, but while we could directly fix this by maintaining a
+    // second DispatchKeySet, it doesn't seem that there is any actual use case,
+    // so we are deferring it for #32454.
+    nonFallthroughKeys_ = backendsWithoutFallthrough_ | operatorHasKernelForBackend_;
+  }
+
   explicit DispatchKeyExtractor(c10::utils::bitset dispatch_arg_indices_reverse)
   : dispatch_arg_indices_reverse_(dispatch_arg_indices_reverse)
-  , operatorHasKernelForBackend_() {}
+  , operatorHasKernelForBackend_()
+  , backendsWithoutFallthrough_(DispatchKeySet::FULL)
+  , nonFallthroughKeys_(DispatchKeySet::FULL) {}
 
   // this is a bitset that has ones for each argument index which has to be
   // considered for dispatch. This avoids having to iterate over the stack
@@ -206,6 +224,14 @@ private:
 
   // Set of backends for which the operator has explicitly registered a kernel.
   DispatchKeySet operatorHasKernelForBackend_;
+
+  // Set of backends which have no fallthrough fallback, a copy of the
+  // Dispatcher's.
+  DispatchKeySet backendsWithoutFallthrough_;
+
+  // backendsWithoutFallthrough_ | operatorHasKernelForBackend_, the keys
+  // considered for dispatch, cached so that a call only has to mask with it.
+  DispatchKeySet nonFallthroughKeys_;
 };
 
 }
@@ -84,7 +84,8 @@ class DispatchTable final {
   : kernels_()
   , catchallKernel_()
   , dispatchKeyExtractor_(DispatchKeyExtractor::make(schema))
-  , operatorName_(schema.operator_name()) {}
+  , operatorName_(schema.operator_name())
+  , resolvedKernels_() {}
 
   // a dispatch table may be default constructed with only an
   // operator name.  Such a dispatch table is not callable until
@@ -93,7 +94,12 @@ class DispatchTable final {
   : kernels_()
   , catchallKernel_()
   , dispatchKeyExtractor_(DispatchKeyExtractor::makeUninitialized())
-  , operatorName_(std::move(op_name)) {}
+  , operatorName_(std::move(op_name))
+  , resolvedKernels_() {}
+
+  // resolvedKernels_ points into the table itself
+  DispatchTable(const DispatchTable&) = delete;
+  DispatchTable& operator=(const DispatchTable&) = delete;
 
   /**
    * Register a kernel in the table at some dispatch key.
@@ -106,6 +112,7 @@ class DispatchTable final {
     }
     kernels_.setKernel(dispatchKey, std::move(kernel));
     dispatchKeyExtractor_.setOperatorHasKernelForBackend(dispatchKey, true);
+    updateResolvedKernels_();
   }
 
   /**
@@ -116,6 +123,7 @@ class DispatchTable final {
   void removeKernelIfExists(DispatchKey dispatchKey) {
     kernels_.removeKernelIfExists(dispatchKey);
     dispatchKeyExtractor_.setOperatorHasKernelForBackend(dispatchKey, false);
+    updateResolvedKernels_();
   }
 
   /**
@@ -129,6 +137,7 @@ class DispatchTable final {
       kernel.setManuallyBoxedKernel_(*manuallyBoxedKernel_);
     }
     catchallKernel_ = std::move(kernel);
+    updateResolvedKernels_();
   }
 
   /**
@@ -136,6 +145,20 @@ class DispatchTable final {
    */
   void removeCatchallKernel() {
     catchallKernel_ = {};
+    updateResolvedKernels_();
+  }
+
+  /**
+   * Set the backend fallback kernels of the Dispatcher, and its backends
+   * without fallthrough, which are looked up when the operator has no kernel
+   * for a dispatch key. Called again whenever they change.
+   */
+  void setBackendFallbacks(
+      const impl::KernelFunctionTable* backendFallbackKernels,
+      DispatchKeySet backendsWithoutFallthrough) {
+    backendFallbackKernels_ = backendFallbackKernels;
+    dispatchKeyExtractor_.setBackendsWithoutFallthrough(backendsWithoutFallthrough);
+    updateResolvedKernels_();
   }
 
   bool isEmpty() const {
@@ -178,6 +201,17 @@ class DispatchTable final {
     }
   }
 
+  /**
+   * The kernel to call for a dispatch key: the kernel of the operator for
+   * the key if it has one, else the backend fallback kernel of the key if
+   * there is one, else the catch-all kernel of the operator, or nullptr if
+   * none of them exists. This is a single load, the resolution being done
+   * when kernels are registered.
+   */
+  const KernelFunction* lookupResolved(DispatchKey dispatchKey) const {
+    return resolvedKernels_[static_cast<uint8_t>(dispatchKey)];
+  }
+
   const KernelFunction* lookupCatchallKernel() const {
     // TODO: this condition shouldn't be necessary
     if (!catchallKernel_.isValid()) {
@@ -228,11 +262,31 @@ class DispatchTable final {
 
 private:
 
+  void updateResolvedKernels_() {
+    for (uint8_t iter = 0; iter != static_cast<uint8_t>(DispatchKey::NumDispatchKeys); ++iter) {
+      const auto dispatchKey = static_cast<DispatchKey>(iter);
+      const KernelFunction* kernel = lookup(dispatchKey);
+      if (kernel == nullptr && backendFallbackKernels_ != nullptr &&
+          (*backendFallbackKernels_)[dispatchKey].isValid()) {
+        kernel = &(*backendFallbackKernels_)[dispatchKey];
+      }
+      if (kernel == nullptr) {
+        kernel = lookupCatchallKernel();
+      }
+      resolvedKernels_[iter] = kernel;
+    }
+  }
+
   impl::KernelFunctionTable kernels_;
   KernelFunction catchallKernel_;
   DispatchKeyExtractor dispatchKeyExtractor_;
   OperatorName operatorName_;
 
+  // The Dispatcher's backend fallback kernels
+  const impl::KernelFunctionTable* backendFallbackKernels_ = nullptr;
+  // The kernel of every dispatch key, see lookupResolved
+  std::array<const KernelFunction*, static_cast<uint8_t>(DispatchKey::NumDispatchKeys)> resolvedKernels_;
+
   // This manuallyBoxedKernel_ member is a temporary hack that allows generated_unboxing_wrappers.cpp to register its codegen'ed
   // unboxing wrapper for aten operators. We still need those for some operators because not all work
   // with the templated unboxing logic yet.
@@ -97,6 +97,7 @@ OperatorHandle Dispatcher::findOrRegisterName_(const OperatorName& op_name) {
   }
 
   operators_.emplace_back(OperatorName(op_name));
+  operators_.back().op.setBackendFallbacks_(&backendFallbackKernels_, backendsWithoutFallthrough_);
   OperatorHandle handle(--operators_.end());
   operatorLookupTable_.write([&] (ska::flat_hash_map<OperatorName, OperatorHandle>& operatorLookupTable) {
     operatorLookupTable.emplace(op_name, handle);
@@ -244,10 +245,12 @@ RegistrationHandleRAII Dispatcher::registerFallback(DispatchKey dispatchKey, Ker
 
   // TODO: fallbacks clobber each other completely unsafely, unlike regular
   // kernels
+  const bool isFallthrough = kernel.isFallthrough();
   backendFallbackKernels_.setKernel(dispatchKey, std::move(kernel));
-  if (kernel.isFallthrough()) {
+  if (isFallthrough) {
     backendsWithoutFallthrough_ = backendsWithoutFallthrough_.remove(dispatchKey);
   }
+  updateBackendFallbacks_();
 
   return RegistrationHandleRAII([this, dispatchKey] {
     deregisterFallback_(dispatchKey);
@@ -259,6 +262,13 @@ void Dispatcher::deregisterFallback_(DispatchKey dispatchKey) {
 
   backendFallbackKernels_.removeKernelIfExists(dispatchKey);
   backendsWithoutFallthrough_ = backendsWithoutFallthrough_.add(dispatchKey);
+  updateBackendFallbacks_();
+}
+
+void Dispatcher::updateBackendFallbacks_() {
+  for (auto& op : operators_) {
+    op.op.setBackendFallbacks_(&backendFallbackKernels_, backendsWithoutFallthrough_);
+  }
 }
 
 
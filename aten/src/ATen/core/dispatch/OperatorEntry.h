@@ -101,6 +101,13 @@ public:
     dispatchTable_.setManuallyBoxedKernel_(func);
   }
 
+  // See DispatchTable::setBackendFallbacks
+  void setBackendFallbacks_(
+      const impl::KernelFunctionTable* backendFallbackKernels,
+      DispatchKeySet backendsWithoutFallthrough) {
+    dispatchTable_.setBackendFallbacks(backendFallbackKernels, backendsWithoutFallthrough);
+  }
+
 private:
 
   OperatorName name_;
@@ -1,5 +1,7 @@
 #include <ATen/core/grad_mode.h>
 
+#include <c10/core/impl/LocalDispatchKeySet.h>
+
 #include <stdexcept>
 
 namespace at {
@@ -32,4 +34,25 @@ void GradMode::set_enabled(bool enabled) {
 
 #endif
 
+InferenceMode::InferenceMode(bool enabled)
+    : prev_grad_mode_(GradMode::is_enabled()), prev_mode_(is_enabled()) {
+  if (enabled) {
+    GradMode::set_enabled(false);
+  }
+  set_enabled(enabled);
+}
+
+InferenceMode::~InferenceMode() {
+  set_enabled(prev_mode_);
+  GradMode::set_enabled(prev_grad_mode_);
+}
+
+bool InferenceMode::is_enabled() {
+  return c10::impl::tls_is_dispatch_key_excluded(DispatchKey::Autograd);
+}
+
+void InferenceMode::set_enabled(bool enabled) {
+  c10::impl::tls_set_dispatch_key_excluded(DispatchKey::Autograd, enabled);
+}
+
 } // namespace at
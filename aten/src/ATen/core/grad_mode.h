@@ -27,4 +27,22 @@ struct CAFFE2_API NoGradGuard : public AutoGradMode {
   NoGradGuard() : AutoGradMode(/*enabled=*/false) {}
 };
 
+// A RAII, thread local (!) guard for code that only runs inference.  Besides
+// disabling grad mode, it skips the autograd kernels of all operators, which
+// then go straight to their backend kernels: no graph is built, no version
+// counter is bumped and views are not tracked.  Tensors created or modified
+// in inference mode must not be saved for backward outside of it.
+struct CAFFE2_API InferenceMode {
+  InferenceMode(bool enabled = true);
+  ~InferenceMode();
+
+  // Whether the autograd kernels are skipped on this thread
+  static bool is_enabled();
+  static void set_enabled(bool enabled);
+
+ private:
+  bool prev_grad_mode_;
+  bool prev_mode_;
+};
+
 }
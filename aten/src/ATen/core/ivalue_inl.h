@@ -7,6 +7,7 @@
 #include <ATen/core/interned_strings.h>
 #include <c10/core/Scalar.h>
 #include <c10/core/TensorImpl.h>
+#include <c10/core/impl/ImplObjectCache.h>
 #include <c10/core/UndefinedTensorImpl.h>
 #include <ATen/core/Dict.h>
 #include <ATen/core/List.h>
@@ -150,6 +151,15 @@ struct CAFFE2_API ConstantString final : c10::intrusive_ptr_target {
  public:
   ConstantString(std::string str)
   : str_(std::move(str)) {}
+  // strings and tuples are built by many prim ops, so their objects are
+  // recycled with the impl object cache, see ImplObjectCache.h
+
+  static void* operator new(size_t size) {
+    return c10::impl::allocate_impl_object(size);
+  }
+  static void operator delete(void* ptr, size_t size) {
+    c10::impl::free_impl_object(ptr, size);
+  }
   static c10::intrusive_ptr<ConstantString> create(std::string str_);
   const std::string & string() const {
     return str_;
@@ -207,6 +217,13 @@ struct CAFFE2_API Tuple : c10::intrusive_ptr_target {
 
   friend bool operator==(const ivalue::Tuple& lhs, const ivalue::Tuple& rhs);
 
+  static void* operator new(size_t size) {
+    return c10::impl::allocate_impl_object(size);
+  }
+  static void operator delete(void* ptr, size_t size) {
+    c10::impl::free_impl_object(ptr, size);
+  }
+
  private:
   Tuple(std::vector<IValue> elements, std::shared_ptr<TupleType> type = nullptr)
     : elements_(std::move(elements)), type_(std::move(type)) {}
@@ -384,6 +384,10 @@ inline c10::optional<Stride> merge_primitive(
   return r;
 }
 
+// A dimension of a TensorType: either a static size, or a symbol standing for
+// a size that isn't known until runtime.  Dimensions with the same symbol have
+// the same size, e.g. the batch size of all the tensors of a graph computed
+// from its inputs; see the symbolic rules of shape_analysis.cpp.
 struct CAFFE2_API ShapeSymbol {
   // needed for use in `std::map`
   ShapeSymbol() : value_(-1) {}
@@ -658,7 +662,8 @@ struct CAFFE2_API TensorType : public Type {
   // in the type-hierarchy. Excluding require_grad and undefined allows
   // this to match the old behavior.
   bool isComplete() const {
-    return scalar_type_ && device_ && sizes_.isComplete() && strides_.isComplete();
+    return scalar_type_ && device_ && sizes().isComplete() &&
+        strides_.isComplete();
   }
 
   // this property is used by GuardElimination
@@ -1513,6 +1513,32 @@ TEST(NewOperatorRegistrationTest, dispatch) {
   }
 }
 
+TEST(NewOperatorRegistrationTest, callWithKeySet) {
+  bool cpu_called = false;
+  bool cuda_called = false;
+  bool catchall_called = false;
+  auto m = MAKE_TORCH_LIBRARY(test);
+  m.def("fn(Tensor self) -> Tensor");
+  m.impl("fn", c10::DispatchKey::CPU, [&](const Tensor& x) { cpu_called = true; return x; });
+  m.impl("fn", c10::kCUDA, [&](const Tensor& x) { cuda_called = true; return x; });
+  m.def("fn_catchall(Tensor self) -> Tensor", [&](const Tensor& x) { catchall_called = true; return x; });
+
+  auto op = Dispatcher::singleton().findSchema({"test::fn", ""});
+  ASSERT_TRUE(op.has_value());
+  // The given keys win over the keys of the arguments and the TLS
+  auto x = dummyTensor(c10::DispatchKey::CPU);
+  op->callUnboxedWithKeySet<Tensor, const Tensor&>(c10::DispatchKeySet(c10::DispatchKey::CUDA), x);
+  ASSERT_TRUE(cuda_called);
+  ASSERT_FALSE(cpu_called);
+  op->callUnboxedWithKeySet<Tensor, const Tensor&>(c10::DispatchKeySet(c10::DispatchKey::CPU), x);
+  ASSERT_TRUE(cpu_called);
+
+  auto catchall_op = Dispatcher::singleton().findSchema({"test::fn_catchall", ""});
+  ASSERT_TRUE(catchall_op.has_value());
+  catchall_op->callUnboxedWithKeySet<Tensor, const Tensor&>(c10::DispatchKeySet(c10::DispatchKey::CPU), x);
+  ASSERT_TRUE(catchall_called);
+}
+
 TEST(NewOperatorRegistrationTest, dispatchMultiple) {
   bool cpu_called = false;
   bool cuda_called = false;
@@ -28,8 +28,12 @@ std::ostream& operator<<(std::ostream & out, const Type & t) {
         if (i > 0) {
           out << ", ";
         }
-        if (auto s = value->sizes()[i]) {
-          out << *s;
+        if (auto s = value->symbolic_sizes()[i]) {
+          if (s->is_static()) {
+            out << s->static_size();
+          } else {
+            out << *s;
+          }
         } else {
           out << "*";
         }
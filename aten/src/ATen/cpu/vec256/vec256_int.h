@@ -326,6 +326,133 @@ inline void convert(const int32_t *src, double *dst, int64_t n) {
   }
 }
 
+// The narrowing conversions below keep the low bits, like static_cast: they
+// wrap around instead of saturating.
+template <>
+inline void convert(const int64_t *src, int32_t *dst, int64_t n) {
+  int64_t i;
+  const __m256i low_halves = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (i = 0; i <= (n - Vec256<int64_t>::size()); i += Vec256<int64_t>::size()) {
+    auto input_vec = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    auto output_vec = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(input_vec, low_halves));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), output_vec);
+  }
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (; i < n; i++) {
+    dst[i] = static_cast<int32_t>(src[i]);
+  }
+}
+
+template <>
+inline void convert(const int32_t *src, int64_t *dst, int64_t n) {
+  int64_t i;
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (i = 0; i <= (n - Vec256<int64_t>::size()); i += Vec256<int64_t>::size()) {
+    auto input_128_vec = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    auto output_vec = _mm256_cvtepi32_epi64(input_128_vec);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), output_vec);
+  }
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (; i < n; i++) {
+    dst[i] = static_cast<int64_t>(src[i]);
+  }
+}
+
+// The low bytes of the truncated values of 32 floats, in order. Masking them
+// first keeps the saturating packs exact.
+static inline __m256i cvtfp32_low_bytes(const float* src) {
+  const __m256i low_byte = _mm256_set1_epi32(0xff);
+  auto a = _mm256_and_si256(_mm256_cvttps_epi32(_mm256_loadu_ps(src)), low_byte);
+  auto b = _mm256_and_si256(_mm256_cvttps_epi32(_mm256_loadu_ps(src + 8)), low_byte);
+  auto c = _mm256_and_si256(_mm256_cvttps_epi32(_mm256_loadu_ps(src + 16)), low_byte);
+  auto d = _mm256_and_si256(_mm256_cvttps_epi32(_mm256_loadu_ps(src + 24)), low_byte);
+  // The packs work within 128 bit lanes, leaving the groups of 4 bytes in the
+  // order a0 b0 c0 d0 a1 b1 c1 d1
+  auto bytes = _mm256_packus_epi16(_mm256_packus_epi32(a, b), _mm256_packus_epi32(c, d));
+  return _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+}
+
+template <>
+inline void convert(const float *src, int8_t *dst, int64_t n) {
+  int64_t i;
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (i = 0; i <= (n - 32); i += 32) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), cvtfp32_low_bytes(src + i));
+  }
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (; i < n; i++) {
+    dst[i] = static_cast<int8_t>(src[i]);
+  }
+}
+
+template <>
+inline void convert(const float *src, uint8_t *dst, int64_t n) {
+  int64_t i;
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (i = 0; i <= (n - 32); i += 32) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), cvtfp32_low_bytes(src + i));
+  }
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (; i < n; i++) {
+    dst[i] = static_cast<uint8_t>(src[i]);
+  }
+}
+
+template <>
+inline void convert(const int8_t *src, float *dst, int64_t n) {
+  int64_t i;
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (i = 0; i <= (n - Vec256<float>::size()); i += Vec256<float>::size()) {
+    auto input_64_vec = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i));
+    auto output_vec = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(input_64_vec));
+    _mm256_storeu_ps(dst + i, output_vec);
+  }
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (; i < n; i++) {
+    dst[i] = static_cast<float>(src[i]);
+  }
+}
+
+template <>
+inline void convert(const uint8_t *src, float *dst, int64_t n) {
+  int64_t i;
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (i = 0; i <= (n - Vec256<float>::size()); i += Vec256<float>::size()) {
+    auto input_64_vec = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i));
+    auto output_vec = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(input_64_vec));
+    _mm256_storeu_ps(dst + i, output_vec);
+  }
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (; i < n; i++) {
+    dst[i] = static_cast<float>(src[i]);
+  }
+}
+
 template <>
 class Vec256<int16_t> : public Vec256i {
 private:
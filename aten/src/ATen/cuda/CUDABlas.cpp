@@ -5,6 +5,16 @@
 #include <ATen/cuda/CUDABlas.h>
 #include <ATen/cuda/Exceptions.h>
 
+#ifdef AT_CUDA_CUBLASLT_ENABLED
+#include <ATen/native/utils/ParamsHash.h>
+#include <c10/cuda/CUDACachingAllocator.h>
+
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+#endif
+
 #define CUDABLAS_POSINT_CHECK(FD, X)         \
   TORCH_CHECK(                               \
       (X > 0 && X <= INT_MAX),               \
@@ -131,6 +141,329 @@ const char* _cublasGetErrorEnum(cublasStatus_t error) {
   return "<unknown>";
 }
 
+#ifdef AT_CUDA_CUBLASLT_ENABLED
+/* cuBLASLt GEMMS */
+
+// The GEMMs go through cuBLASLt when it has an algorithm for them, and through
+// the classic cuBLAS functions otherwise. cuBLASLt also runs GEMMs with a bias
+// added in their epilogue (see gemm_and_bias), and takes the algorithm to use
+// as an argument: the one picked for a problem (the first suggested by the
+// heuristic, or the fastest of the suggested ones in benchmark mode, see
+// Context::benchmarkCuBLAS) is cached, keyed by the problem.
+
+namespace {
+
+template <typename T, cublasStatus_t (*destructor)(T)>
+struct CuBlasLtDescriptor {
+  CuBlasLtDescriptor() = default;
+  CuBlasLtDescriptor(const CuBlasLtDescriptor&) = delete;
+  CuBlasLtDescriptor& operator=(const CuBlasLtDescriptor&) = delete;
+  ~CuBlasLtDescriptor() {
+    if (descriptor) {
+      destructor(descriptor);
+    }
+  }
+  T descriptor = nullptr;
+};
+
+using CuBlasLtMatmulDescriptor =
+    CuBlasLtDescriptor<cublasLtMatmulDesc_t, &cublasLtMatmulDescDestroy>;
+using CuBlasLtMatrixLayout =
+    CuBlasLtDescriptor<cublasLtMatrixLayout_t, &cublasLtMatrixLayoutDestroy>;
+using CuBlasLtMatmulPreference =
+    CuBlasLtDescriptor<cublasLtMatmulPreference_t, &cublasLtMatmulPreferenceDestroy>;
+
+template <typename Dtype>
+struct CuBlasLtTypes {};
+
+template <>
+struct CuBlasLtTypes<double> {
+  using scale_t = double;
+  using c_t = double;
+  static constexpr cudaDataType_t data_type = CUDA_R_64F;
+  static constexpr cudaDataType_t c_type = CUDA_R_64F;
+  static constexpr cublasComputeType_t compute_type = CUBLAS_COMPUTE_64F;
+  static constexpr cudaDataType_t scale_type = CUDA_R_64F;
+};
+
+template <>
+struct CuBlasLtTypes<float> {
+  using scale_t = float;
+  using c_t = float;
+  static constexpr cudaDataType_t data_type = CUDA_R_32F;
+  static constexpr cudaDataType_t c_type = CUDA_R_32F;
+  static constexpr cublasComputeType_t compute_type = CUBLAS_COMPUTE_32F;
+  static constexpr cudaDataType_t scale_type = CUDA_R_32F;
+};
+
+// Like the cublasGemmEx call of gemm<at::Half>: accumulation in float
+template <>
+struct CuBlasLtTypes<at::Half> {
+  using scale_t = float;
+  using c_t = at::Half;
+  static constexpr cudaDataType_t data_type = CUDA_R_16F;
+  static constexpr cudaDataType_t c_type = CUDA_R_16F;
+  static constexpr cublasComputeType_t compute_type = CUBLAS_COMPUTE_32F;
+  static constexpr cudaDataType_t scale_type = CUDA_R_32F;
+};
+
+// int8 inputs and int32 outputs, which run on the integer tensor cores (IMMA)
+// of Turing and later GPUs
+template <>
+struct CuBlasLtTypes<int8_t> {
+  using scale_t = int32_t;
+  using c_t = int32_t;
+  static constexpr cudaDataType_t data_type = CUDA_R_8I;
+  static constexpr cudaDataType_t c_type = CUDA_R_32I;
+  static constexpr cublasComputeType_t compute_type = CUBLAS_COMPUTE_32I;
+  static constexpr cudaDataType_t scale_type = CUDA_R_32I;
+};
+
+// The alignment cuBLASLt may assume for a pointer: the heuristic returns
+// faster algorithms for more aligned pointers, which those for less aligned
+// ones cannot run.
+uint32_t _cublasLtAlignment(const void* ptr) {
+  uint32_t alignment = 256;
+  while (alignment > 1 && reinterpret_cast<uintptr_t>(ptr) % alignment != 0) {
+    alignment /= 2;
+  }
+  return alignment;
+}
+
+// The problem of a GEMM, a POD for ParamsHash (memset to 0 before filling it,
+// so that the padding bytes compare equal)
+struct CuBlasLtGemmKey {
+  int device;
+  cudaDataType_t data_type;
+  cublasOperation_t opa;
+  cublasOperation_t opb;
+  int64_t m;
+  int64_t n;
+  int64_t k;
+  int64_t lda;
+  int64_t ldb;
+  int64_t ldc;
+  uint32_t alignment_a;
+  uint32_t alignment_b;
+  uint32_t alignment_c;
+  bool bias;
+  bool benchmark;
+};
+
+struct CuBlasLtGemmAlgo {
+  // False if cuBLASLt has no algorithm for the problem
+  bool found;
+  cublasLtMatmulAlgo_t algo;
+  size_t workspace_size;
+};
+
+struct CuBlasLtAlgoCache {
+  std::mutex mutex;
+  std::unordered_map<
+      CuBlasLtGemmKey,
+      CuBlasLtGemmAlgo,
+      at::native::ParamsHash<CuBlasLtGemmKey>,
+      at::native::ParamsEqual<CuBlasLtGemmKey>>
+      algos;
+};
+
+CuBlasLtAlgoCache& _cublasLtAlgoCache() {
+  static CuBlasLtAlgoCache cache;
+  return cache;
+}
+
+// The number of algorithms timed in benchmark mode, and of runs timed for each
+constexpr int kCuBlasLtBenchmarkAlgos = 8;
+constexpr int kCuBlasLtBenchmarkRuns = 3;
+
+// Times one run of `run` with each of `results`, and returns the index of the
+// fastest result. Runs that fail are skipped.
+template <typename Run>
+int _cublasLtFastestAlgo(
+    const cublasLtMatmulHeuristicResult_t* results,
+    int count,
+    cudaStream_t stream,
+    const Run& run) {
+  cudaEvent_t start, stop;
+  AT_CUDA_CHECK(cudaEventCreate(&start));
+  AT_CUDA_CHECK(cudaEventCreate(&stop));
+  int best = 0;
+  float best_time = std::numeric_limits<float>::infinity();
+  for (int i = 0; i < count; i++) {
+    // warm up, and check that the algorithm runs
+    if (run(results[i]) != CUBLAS_STATUS_SUCCESS) {
+      continue;
+    }
+    AT_CUDA_CHECK(cudaEventRecord(start, stream));
+    for (int r = 0; r < kCuBlasLtBenchmarkRuns; r++) {
+      run(results[i]);
+    }
+    AT_CUDA_CHECK(cudaEventRecord(stop, stream));
+    AT_CUDA_CHECK(cudaEventSynchronize(stop));
+    float time;
+    AT_CUDA_CHECK(cudaEventElapsedTime(&time, start, stop));
+    if (time < best_time) {
+      best_time = time;
+      best = i;
+    }
+  }
+  AT_CUDA_CHECK(cudaEventDestroy(start));
+  AT_CUDA_CHECK(cudaEventDestroy(stop));
+  return best;
+}
+
+// Computes c = alpha * op(a) * op(b) + beta * c (+ bias, a vector of m
+// elements added to every column, if not null) with cuBLASLt. Returns false
+// when cuBLASLt has no algorithm for the problem, and c is then untouched.
+// The arguments are the adjusted and checked ones of gemm.
+template <typename Dtype>
+bool _cublasLtGemm(
+    cublasOperation_t opa,
+    cublasOperation_t opb,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    typename CuBlasLtTypes<Dtype>::scale_t alpha,
+    const Dtype* a,
+    int64_t lda,
+    const Dtype* b,
+    int64_t ldb,
+    typename CuBlasLtTypes<Dtype>::scale_t beta,
+    typename CuBlasLtTypes<Dtype>::c_t* c,
+    int64_t ldc,
+    const typename CuBlasLtTypes<Dtype>::c_t* bias) {
+  using Types = CuBlasLtTypes<Dtype>;
+  if (m == 0 || n == 0 || k == 0) {
+    return false;
+  }
+
+  CuBlasLtMatmulDescriptor desc;
+  TORCH_CUDABLAS_CHECK(cublasLtMatmulDescCreate(
+      &desc.descriptor, Types::compute_type, Types::scale_type));
+  TORCH_CUDABLAS_CHECK(cublasLtMatmulDescSetAttribute(
+      desc.descriptor, CUBLASLT_MATMUL_DESC_TRANSA, &opa, sizeof(opa)));
+  TORCH_CUDABLAS_CHECK(cublasLtMatmulDescSetAttribute(
+      desc.descriptor, CUBLASLT_MATMUL_DESC_TRANSB, &opb, sizeof(opb)));
+  if (bias) {
+    cublasLtEpilogue_t epilogue = CUBLASLT_EPILOGUE_BIAS;
+    TORCH_CUDABLAS_CHECK(cublasLtMatmulDescSetAttribute(
+        desc.descriptor, CUBLASLT_MATMUL_DESC_EPILOGUE, &epilogue, sizeof(epilogue)));
+    TORCH_CUDABLAS_CHECK(cublasLtMatmulDescSetAttribute(
+        desc.descriptor, CUBLASLT_MATMUL_DESC_BIAS_POINTER, &bias, sizeof(bias)));
+  }
+
+  // Column-major layouts of op's arguments, i.e. before the transpositions
+  CuBlasLtMatrixLayout layout_a, layout_b, layout_c;
+  const bool transa = opa != CUBLAS_OP_N;
+  const bool transb = opb != CUBLAS_OP_N;
+  TORCH_CUDABLAS_CHECK(cublasLtMatrixLayoutCreate(
+      &layout_a.descriptor, Types::data_type, transa ? k : m, transa ? m : k, lda));
+  TORCH_CUDABLAS_CHECK(cublasLtMatrixLayoutCreate(
+      &layout_b.descriptor, Types::data_type, transb ? n : k, transb ? k : n, ldb));
+  TORCH_CUDABLAS_CHECK(cublasLtMatrixLayoutCreate(
+      &layout_c.descriptor, Types::c_type, m, n, ldc));
+
+  cublasLtHandle_t handle = at::cuda::getCurrentCUDABlasLtHandle();
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+  const size_t max_workspace_size = at::cuda::getCUDABlasLtWorkspaceSize();
+
+  CuBlasLtGemmKey key;
+  memset(&key, 0, sizeof(key));
+  key.device = at::cuda::current_device();
+  key.data_type = Types::data_type;
+  key.opa = opa;
+  key.opb = opb;
+  key.m = m;
+  key.n = n;
+  key.k = k;
+  key.lda = lda;
+  key.ldb = ldb;
+  key.ldc = ldc;
+  key.alignment_a = _cublasLtAlignment(a);
+  key.alignment_b = _cublasLtAlignment(b);
+  key.alignment_c = _cublasLtAlignment(c);
+  key.bias = bias != nullptr;
+  key.benchmark = at::globalContext().benchmarkCuBLAS();
+
+  auto& cache = _cublasLtAlgoCache();
+  CuBlasLtGemmAlgo algo;
+  bool cached;
+  {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto it = cache.algos.find(key);
+    cached = it != cache.algos.end();
+    if (cached) {
+      algo = it->second;
+    }
+  }
+
+  if (!cached) {
+    CuBlasLtMatmulPreference preference;
+    TORCH_CUDABLAS_CHECK(cublasLtMatmulPreferenceCreate(&preference.descriptor));
+    uint64_t workspace_size = max_workspace_size;
+    TORCH_CUDABLAS_CHECK(cublasLtMatmulPreferenceSetAttribute(
+        preference.descriptor, CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES,
+        &workspace_size, sizeof(workspace_size)));
+    TORCH_CUDABLAS_CHECK(cublasLtMatmulPreferenceSetAttribute(
+        preference.descriptor, CUBLASLT_MATMUL_PREF_MIN_ALIGNMENT_A_BYTES,
+        &key.alignment_a, sizeof(key.alignment_a)));
+    TORCH_CUDABLAS_CHECK(cublasLtMatmulPreferenceSetAttribute(
+        preference.descriptor, CUBLASLT_MATMUL_PREF_MIN_ALIGNMENT_B_BYTES,
+        &key.alignment_b, sizeof(key.alignment_b)));
+    TORCH_CUDABLAS_CHECK(cublasLtMatmulPreferenceSetAttribute(
+        preference.descriptor, CUBLASLT_MATMUL_PREF_MIN_ALIGNMENT_C_BYTES,
+        &key.alignment_c, sizeof(key.alignment_c)));
+    TORCH_CUDABLAS_CHECK(cublasLtMatmulPreferenceSetAttribute(
+        preference.descriptor, CUBLASLT_MATMUL_PREF_MIN_ALIGNMENT_D_BYTES,
+        &key.alignment_c, sizeof(key.alignment_c)));
+
+    const bool benchmark = key.benchmark;
+    cublasLtMatmulHeuristicResult_t results[kCuBlasLtBenchmarkAlgos];
+    int count = 0;
+    cublasStatus_t status = cublasLtMatmulAlgoGetHeuristic(
+        handle, desc.descriptor, layout_a.descriptor, layout_b.descriptor,
+        layout_c.descriptor, layout_c.descriptor, preference.descriptor,
+        benchmark ? kCuBlasLtBenchmarkAlgos : 1, results, &count);
+    algo.found = status == CUBLAS_STATUS_SUCCESS && count > 0;
+    if (algo.found) {
+      int best = 0;
+      if (benchmark && count > 1) {
+        // Time the algorithms on a scratch output so that c is untouched
+        const size_t c_bytes = (ldc * (n - 1) + m) * sizeof(typename Types::c_t);
+        auto scratch = c10::cuda::CUDACachingAllocator::get()->allocate(c_bytes);
+        auto* scratch_c = static_cast<typename Types::c_t*>(scratch.get());
+        void* workspace = at::cuda::getCurrentCUDABlasLtWorkspace();
+        best = _cublasLtFastestAlgo(
+            results, count, stream,
+            [&](const cublasLtMatmulHeuristicResult_t& result) {
+              return cublasLtMatmul(
+                  handle, desc.descriptor, &alpha, a, layout_a.descriptor, b,
+                  layout_b.descriptor, &beta, scratch_c, layout_c.descriptor,
+                  scratch_c, layout_c.descriptor, &result.algo, workspace,
+                  result.workspaceSize, stream);
+            });
+      }
+      algo.algo = results[best].algo;
+      algo.workspace_size = results[best].workspaceSize;
+    }
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.algos.emplace(key, algo);
+  }
+
+  if (!algo.found) {
+    return false;
+  }
+  void* workspace = algo.workspace_size > 0 ? at::cuda::getCurrentCUDABlasLtWorkspace() : nullptr;
+  TORCH_CUDABLAS_CHECK(cublasLtMatmul(
+      handle, desc.descriptor, &alpha, a, layout_a.descriptor, b,
+      layout_b.descriptor, &beta, c, layout_c.descriptor, c,
+      layout_c.descriptor, &algo.algo, workspace, algo.workspace_size, stream));
+  return true;
+}
+
+} // anonymous namespace
+#endif
+
 /* LEVEL 3 BLAS FUNCTIONS */
 
 #define GEMM_CHECK_ARGVALUES(Dtype)           \
@@ -150,6 +483,12 @@ void gemm<double>(CUDABLAS_GEMM_ARGTYPES(double)) {
   cublasOperation_t opb = _cublasOpFromChar(transb);
   _cublasAdjustLdLevel3(transa, transb, m, n, k, &lda, &ldb, &ldc);
   GEMM_CHECK_ARGVALUES(double);
+#ifdef AT_CUDA_CUBLASLT_ENABLED
+  if (_cublasLtGemm<double>(
+          opa, opb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc, nullptr)) {
+    return;
+  }
+#endif
   TORCH_CUDABLAS_CHECK(cublasDgemm(
       handle, opa, opb, m, n, k, &alpha, a, lda, b, ldb, &beta, c, ldc));
 }
@@ -161,6 +500,12 @@ void gemm<float>(CUDABLAS_GEMM_ARGTYPES(float)) {
   cublasOperation_t opb = _cublasOpFromChar(transb);
   _cublasAdjustLdLevel3(transa, transb, m, n, k, &lda, &ldb, &ldc);
   GEMM_CHECK_ARGVALUES(float);
+#ifdef AT_CUDA_CUBLASLT_ENABLED
+  if (_cublasLtGemm<float>(
+          opa, opb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc, nullptr)) {
+    return;
+  }
+#endif
   TORCH_CUDABLAS_CHECK(cublasSgemm(
       handle, opa, opb, m, n, k, &alpha, a, lda, b, ldb, &beta, c, ldc));
 }
@@ -203,6 +548,12 @@ void gemm<at::Half>(CUDABLAS_GEMM_ARGTYPES(at::Half)) {
 #else
   cudaDeviceProp* prop = at::cuda::getCurrentDeviceProperties();
   if (prop->major >= 5) {
+#ifdef AT_CUDA_CUBLASLT_ENABLED
+    if (_cublasLtGemm<at::Half>(
+            opa, opb, m, n, k, falpha, a, lda, b, ldb, fbeta, c, ldc, nullptr)) {
+      return;
+    }
+#endif
     TORCH_CUDABLAS_CHECK(cublasSetMathMode(handle, CUBLAS_TENSOR_OP_MATH));
     TORCH_CUDABLAS_CHECK(cublasGemmEx(
         handle,
@@ -248,6 +599,96 @@ void gemm<at::Half>(CUDABLAS_GEMM_ARGTYPES(at::Half)) {
 #endif
 }
 
+#ifdef AT_CUDA_CUBLASLT_ENABLED
+template <typename Dtype>
+bool _gemmAndBias(CUDABLAS_GEMM_AND_BIAS_ARGTYPES(Dtype)) {
+  cublasOperation_t opa = _cublasOpFromChar(transa);
+  cublasOperation_t opb = _cublasOpFromChar(transb);
+  _cublasAdjustLdLevel3(transa, transb, m, n, k, &lda, &ldb, &ldc);
+  GEMM_CHECK_ARGVALUES(Dtype);
+  return _cublasLtGemm<Dtype>(
+      opa, opb, m, n, k, alpha, a, lda, b, ldb, 0, c, ldc, bias);
+}
+
+template <>
+bool gemm_and_bias<double>(CUDABLAS_GEMM_AND_BIAS_ARGTYPES(double)) {
+  return _gemmAndBias<double>(
+      transa, transb, m, n, k, alpha, a, lda, b, ldb, bias, c, ldc);
+}
+
+template <>
+bool gemm_and_bias<float>(CUDABLAS_GEMM_AND_BIAS_ARGTYPES(float)) {
+  return _gemmAndBias<float>(
+      transa, transb, m, n, k, alpha, a, lda, b, ldb, bias, c, ldc);
+}
+
+template <>
+bool gemm_and_bias<at::Half>(CUDABLAS_GEMM_AND_BIAS_ARGTYPES(at::Half)) {
+  return _gemmAndBias<at::Half>(
+      transa, transb, m, n, k, alpha, a, lda, b, ldb, bias, c, ldc);
+}
+#endif
+
+#ifndef __HIP_PLATFORM_HCC__
+void int8_gemm(
+    char transa,
+    char transb,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    const int8_t* a,
+    int64_t lda,
+    const int8_t* b,
+    int64_t ldb,
+    int32_t* c,
+    int64_t ldc) {
+  cublasHandle_t handle = at::cuda::getCurrentCUDABlasHandle();
+  cublasOperation_t opa = _cublasOpFromChar(transa);
+  cublasOperation_t opb = _cublasOpFromChar(transb);
+  _cublasAdjustLdLevel3(transa, transb, m, n, k, &lda, &ldb, &ldc);
+  CUDABLAS_NONNEGINT_CHECK(int8_gemm, m);
+  CUDABLAS_NONNEGINT_CHECK(int8_gemm, n);
+  CUDABLAS_NONNEGINT_CHECK(int8_gemm, k);
+  CUDABLAS_POSINT_CHECK(int8_gemm, lda);
+  CUDABLAS_POSINT_CHECK(int8_gemm, ldb);
+  CUDABLAS_POSINT_CHECK(int8_gemm, ldc);
+  TORCH_CHECK(
+      lda % 4 == 0 && ldb % 4 == 0,
+      "at::cuda::blas::int8_gemm: lda and ldb must be multiples of 4 but got ",
+      lda,
+      " and ",
+      ldb);
+  const int32_t alpha = 1;
+  const int32_t beta = 0;
+#ifdef AT_CUDA_CUBLASLT_ENABLED
+  if (_cublasLtGemm<int8_t>(
+          opa, opb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc, nullptr)) {
+    return;
+  }
+#endif
+  TORCH_CUDABLAS_CHECK(cublasGemmEx(
+      handle,
+      opa,
+      opb,
+      m,
+      n,
+      k,
+      &alpha,
+      a,
+      CUDA_R_8I,
+      lda,
+      b,
+      CUDA_R_8I,
+      ldb,
+      &beta,
+      c,
+      CUDA_R_32I,
+      ldc,
+      CUDA_R_32I,
+      CUBLAS_GEMM_DFALT_TENSOR_OP));
+}
+#endif
+
 #ifdef __HIP_PLATFORM_HCC__
 template <>
 void gemm<at::BFloat16>(CUDABLAS_GEMM_ARGTYPES(at::BFloat16)) {
@@ -344,6 +785,73 @@ void gemv<at::BFloat16>(CUDABLAS_GEMV_ARGTYPES(at::BFloat16)) {
 }
 #endif
 
+#ifndef __HIP_PLATFORM_HCC__
+/* BATCHED LAPACK-LIKE FUNCTIONS */
+
+#define BATCHED_CHECK_ARGVALUES(FD)           \
+  do {                                        \
+    CUDABLAS_NONNEGINT_CHECK(FD, n);          \
+    CUDABLAS_POSINT_CHECK(FD, lda);           \
+    CUDABLAS_NONNEGINT_CHECK(FD, batch_size); \
+  } while (0)
+
+template <>
+void getrfBatched<double>(CUDABLAS_GETRF_BATCHED_ARGTYPES(double)) {
+  cublasHandle_t handle = at::cuda::getCurrentCUDABlasHandle();
+  BATCHED_CHECK_ARGVALUES(getrfBatched<double>);
+  TORCH_CUDABLAS_CHECK(cublasDgetrfBatched(
+      handle, n, a_array, lda, ipiv_array, info_array, batch_size));
+}
+
+template <>
+void getrfBatched<float>(CUDABLAS_GETRF_BATCHED_ARGTYPES(float)) {
+  cublasHandle_t handle = at::cuda::getCurrentCUDABlasHandle();
+  BATCHED_CHECK_ARGVALUES(getrfBatched<float>);
+  TORCH_CUDABLAS_CHECK(cublasSgetrfBatched(
+      handle, n, a_array, lda, ipiv_array, info_array, batch_size));
+}
+
+template <>
+void getriBatched<double>(CUDABLAS_GETRI_BATCHED_ARGTYPES(double)) {
+  cublasHandle_t handle = at::cuda::getCurrentCUDABlasHandle();
+  BATCHED_CHECK_ARGVALUES(getriBatched<double>);
+  CUDABLAS_POSINT_CHECK(getriBatched<double>, ldc);
+  TORCH_CUDABLAS_CHECK(cublasDgetriBatched(
+      handle, n, a_array, lda, ipiv_array, c_array, ldc, info_array, batch_size));
+}
+
+template <>
+void getriBatched<float>(CUDABLAS_GETRI_BATCHED_ARGTYPES(float)) {
+  cublasHandle_t handle = at::cuda::getCurrentCUDABlasHandle();
+  BATCHED_CHECK_ARGVALUES(getriBatched<float>);
+  CUDABLAS_POSINT_CHECK(getriBatched<float>, ldc);
+  TORCH_CUDABLAS_CHECK(cublasSgetriBatched(
+      handle, n, a_array, lda, ipiv_array, c_array, ldc, info_array, batch_size));
+}
+
+template <>
+void getrsBatched<double>(CUDABLAS_GETRS_BATCHED_ARGTYPES(double)) {
+  cublasHandle_t handle = at::cuda::getCurrentCUDABlasHandle();
+  cublasOperation_t op = _cublasOpFromChar(trans);
+  BATCHED_CHECK_ARGVALUES(getrsBatched<double>);
+  CUDABLAS_NONNEGINT_CHECK(getrsBatched<double>, nrhs);
+  CUDABLAS_POSINT_CHECK(getrsBatched<double>, ldb);
+  TORCH_CUDABLAS_CHECK(cublasDgetrsBatched(
+      handle, op, n, nrhs, a_array, lda, ipiv_array, b_array, ldb, info, batch_size));
+}
+
+template <>
+void getrsBatched<float>(CUDABLAS_GETRS_BATCHED_ARGTYPES(float)) {
+  cublasHandle_t handle = at::cuda::getCurrentCUDABlasHandle();
+  cublasOperation_t op = _cublasOpFromChar(trans);
+  BATCHED_CHECK_ARGVALUES(getrsBatched<float>);
+  CUDABLAS_NONNEGINT_CHECK(getrsBatched<float>, nrhs);
+  CUDABLAS_POSINT_CHECK(getrsBatched<float>, ldb);
+  TORCH_CUDABLAS_CHECK(cublasSgetrsBatched(
+      handle, op, n, nrhs, a_array, lda, ipiv_array, b_array, ldb, info, batch_size));
+}
+#endif
+
 } // namespace blas
 } // namespace cuda
 } // namespace at
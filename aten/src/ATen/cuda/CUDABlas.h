@@ -7,8 +7,28 @@
 
     gemv<Dtype>(transa, m, n, alpha, a, lda, x, incx, beta, y, incy)
 
-  where Dtype is double, float, at::Half or at::BFloat16(ROCm). The functions are
-  available in at::cuda::blas namespace.
+  and, with cuBLASLt (CUDA 11 and later, see AT_CUDA_CUBLASLT_ENABLED),
+
+    gemm_and_bias<Dtype>(transa, transb, m, n, k, alpha, a, lda, b, ldb, bias,
+  c, ldc)
+
+  where Dtype is double, float, at::Half or at::BFloat16(ROCm), as well as
+
+    int8_gemm(transa, transb, m, n, k, a, lda, b, ldb, c, ldc)
+
+  (not on ROCm), and the batched LU factorization, inverse and solve of many
+  small matrices
+
+    getrfBatched<Dtype>(n, a_array, lda, ipiv_array, info_array, batch_size)
+
+    getriBatched<Dtype>(n, a_array, lda, ipiv_array, c_array, ldc, info_array,
+  batch_size)
+
+    getrsBatched<Dtype>(trans, n, nrhs, a_array, lda, ipiv_array, b_array,
+  ldb, info, batch_size)
+
+  where Dtype is double or float (not on ROCm). The functions are available in
+  at::cuda::blas namespace.
  */
 
 #include <ATen/cuda/CUDAContext.h>
@@ -40,6 +60,45 @@ template <>
 void gemm<at::BFloat16>(CUDABLAS_GEMM_ARGTYPES(at::BFloat16));
 #endif
 
+#ifdef AT_CUDA_CUBLASLT_ENABLED
+#define CUDABLAS_GEMM_AND_BIAS_ARGTYPES(Dtype)                              \
+      char transa, char transb, int64_t m, int64_t n, int64_t k,           \
+      Dtype alpha, const Dtype *a, int64_t lda, const Dtype *b,            \
+      int64_t ldb, const Dtype *bias, Dtype *c, int64_t ldc
+
+// c = alpha * op(a) * op(b) + bias, with `bias` a vector of m elements added
+// to every column of c in the epilogue of the GEMM. Returns false, leaving c
+// untouched, if cuBLASLt has no algorithm for the problem.
+template <typename Dtype>
+inline bool gemm_and_bias(CUDABLAS_GEMM_AND_BIAS_ARGTYPES(Dtype)) {
+  return false;
+}
+
+template <>
+bool gemm_and_bias<double>(CUDABLAS_GEMM_AND_BIAS_ARGTYPES(double));
+template <>
+bool gemm_and_bias<float>(CUDABLAS_GEMM_AND_BIAS_ARGTYPES(float));
+template <>
+bool gemm_and_bias<at::Half>(CUDABLAS_GEMM_AND_BIAS_ARGTYPES(at::Half));
+#endif
+
+#ifndef __HIP_PLATFORM_HCC__
+// c = op(a) * op(b) with int8 a and b, and int32 c, on the integer tensor
+// cores where there are. lda and ldb must be multiples of 4.
+void int8_gemm(
+    char transa,
+    char transb,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    const int8_t* a,
+    int64_t lda,
+    const int8_t* b,
+    int64_t ldb,
+    int32_t* c,
+    int64_t ldc);
+#endif
+
 /* LEVEL 2 BLAS FUNCTIONS */
 
 #define CUDABLAS_GEMV_ARGTYPES(Dtype)                                        \
@@ -63,6 +122,58 @@ template <>
 void gemv<at::BFloat16>(CUDABLAS_GEMV_ARGTYPES(at::BFloat16));
 #endif
 
+#ifndef __HIP_PLATFORM_HCC__
+/* BATCHED LAPACK-LIKE FUNCTIONS */
+
+// These work on arrays of device pointers to column major matrices, and are
+// meant for many small ones. With a null ipiv_array, getrfBatched factorizes
+// without pivoting. The info of every matrix is written to the device, but
+// for getrsBatched, whose single info is on the host.
+
+#define CUDABLAS_GETRF_BATCHED_ARGTYPES(Dtype)                       \
+      int64_t n, Dtype **a_array, int64_t lda, int *ipiv_array,      \
+      int *info_array, int64_t batch_size
+
+template <typename Dtype>
+inline void getrfBatched(CUDABLAS_GETRF_BATCHED_ARGTYPES(Dtype)) {
+  AT_ERROR("at::cuda::blas::getrfBatched: not implemented for ", typeid(Dtype).name());
+}
+
+template <>
+void getrfBatched<double>(CUDABLAS_GETRF_BATCHED_ARGTYPES(double));
+template <>
+void getrfBatched<float>(CUDABLAS_GETRF_BATCHED_ARGTYPES(float));
+
+#define CUDABLAS_GETRI_BATCHED_ARGTYPES(Dtype)                       \
+      int64_t n, Dtype **a_array, int64_t lda, int *ipiv_array,      \
+      Dtype **c_array, int64_t ldc, int *info_array, int64_t batch_size
+
+template <typename Dtype>
+inline void getriBatched(CUDABLAS_GETRI_BATCHED_ARGTYPES(Dtype)) {
+  AT_ERROR("at::cuda::blas::getriBatched: not implemented for ", typeid(Dtype).name());
+}
+
+template <>
+void getriBatched<double>(CUDABLAS_GETRI_BATCHED_ARGTYPES(double));
+template <>
+void getriBatched<float>(CUDABLAS_GETRI_BATCHED_ARGTYPES(float));
+
+#define CUDABLAS_GETRS_BATCHED_ARGTYPES(Dtype)                       \
+      char trans, int64_t n, int64_t nrhs, Dtype **a_array,          \
+      int64_t lda, int *ipiv_array, Dtype **b_array, int64_t ldb,    \
+      int *info, int64_t batch_size
+
+template <typename Dtype>
+inline void getrsBatched(CUDABLAS_GETRS_BATCHED_ARGTYPES(Dtype)) {
+  AT_ERROR("at::cuda::blas::getrsBatched: not implemented for ", typeid(Dtype).name());
+}
+
+template <>
+void getrsBatched<double>(CUDABLAS_GETRS_BATCHED_ARGTYPES(double));
+template <>
+void getrsBatched<float>(CUDABLAS_GETRS_BATCHED_ARGTYPES(float));
+#endif
+
 } // namespace blas
 } // namespace cuda
 } // namespace at
@@ -6,6 +6,12 @@
 #include <cusparse.h>
 #include <cublas_v2.h>
 
+// cuBLASLt runs the GEMMs it has an algorithm for, see CUDABlas.cpp.
+#if !defined(__HIP_PLATFORM_HCC__) && defined(CUDART_VERSION) && CUDART_VERSION >= 11000
+#define AT_CUDA_CUBLASLT_ENABLED
+#include <cublasLt.h>
+#endif
+
 #include <ATen/core/ATenGeneral.h>
 #include <ATen/Context.h>
 #include <c10/cuda/CUDAStream.h>
@@ -63,6 +69,14 @@ TORCH_CUDA_API Allocator* getCUDADeviceAllocator();
 /* Handles */
 TORCH_CUDA_API cusparseHandle_t getCurrentCUDASparseHandle();
 TORCH_CUDA_API cublasHandle_t getCurrentCUDABlasHandle();
+#ifdef AT_CUDA_CUBLASLT_ENABLED
+TORCH_CUDA_API cublasLtHandle_t getCurrentCUDABlasLtHandle();
+// The workspace of cuBLASLt calls on the current stream. There is one per
+// stream, which the calls on it use in turn, of getCUDABlasLtWorkspaceSize()
+// bytes (given in KiB by TORCH_CUBLASLT_WORKSPACE_SIZE, 4 MiB by default).
+TORCH_CUDA_API void* getCurrentCUDABlasLtWorkspace();
+TORCH_CUDA_API size_t getCUDABlasLtWorkspaceSize();
+#endif
 
 
 } // namespace cuda
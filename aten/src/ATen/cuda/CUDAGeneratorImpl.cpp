@@ -1,7 +1,10 @@
 #include <ATen/CUDAGeneratorImpl.h>
+#include <ATen/cuda/CUDAGraph.h>
 #include <c10/cuda/CUDAFunctions.h>
 #include <ATen/Utils.h>
 
+#include <limits>
+
 namespace at {
 
 namespace cuda { namespace detail {
@@ -143,12 +146,64 @@ uint64_t CUDAGeneratorImpl::philox_offset_per_thread() {
  * 
  * See Note [Acquire lock when using random generators]
  */
+PhiloxCudaState CUDAGeneratorImpl::philox_cuda_state(uint64_t increment) {
+  if (graph_expects_this_gen_) {
+    TORCH_INTERNAL_ASSERT(
+        increment <= std::numeric_limits<uint32_t>::max() - offset_intragraph_,
+        "the random numbers of a captured CUDA graph exceed the Philox offset range");
+    uint32_t offset = this->offset_intragraph_;
+    this->offset_intragraph_ += increment;
+    return PhiloxCudaState(this->seed_extragraph_, this->offset_extragraph_, offset);
+  }
+  TORCH_CHECK(!at::cuda::currentStreamIsCapturing(),
+      "Only the default CUDA generator of the capturing device can be used "
+      "during a CUDA graph capture");
+  uint64_t offset = this->philox_offset_per_thread_;
+  this->philox_offset_per_thread_ += increment;
+  return PhiloxCudaState(this->seed_, offset);
+}
+
+/**
+ * Same as philox_cuda_state, with the values returned directly. Kernels
+ * using it cannot be captured in a CUDA graph.
+ *
+ * See Note [Acquire lock when using random generators]
+ */
 std::pair<uint64_t, uint64_t> CUDAGeneratorImpl::philox_engine_inputs(uint64_t increment) {
+  TORCH_CHECK(!graph_expects_this_gen_ && !at::cuda::currentStreamIsCapturing(),
+      "This random operation does not support CUDA graph capture");
   uint64_t offset = this->philox_offset_per_thread_;
   this->philox_offset_per_thread_ += increment;
   return std::make_pair(this->seed_, offset);
 }
 
+/**
+ * Called by CUDAGraph::capture_begin: until capture_epilogue, the kernels
+ * read the seed and the base Philox offset from the given device memory, and
+ * the offsets they are given are relative to the start of the graph.
+ *
+ * See Note [Acquire lock when using random generators]
+ */
+void CUDAGeneratorImpl::capture_prologue(int64_t* seed_extragraph, int64_t* offset_extragraph) {
+  TORCH_CHECK(!graph_expects_this_gen_,
+      "The CUDA generator is already used by a graph capture");
+  seed_extragraph_ = seed_extragraph;
+  offset_extragraph_ = offset_extragraph;
+  offset_intragraph_ = 0;
+  graph_expects_this_gen_ = true;
+}
+
+/**
+ * Called by CUDAGraph::capture_end. Returns the Philox offset consumed by
+ * the whole graph, by which each replay advances the generator.
+ *
+ * See Note [Acquire lock when using random generators]
+ */
+uint64_t CUDAGeneratorImpl::capture_epilogue() {
+  graph_expects_this_gen_ = false;
+  return offset_intragraph_;
+}
+
 /*
  * Gets the DeviceType of CUDAGeneratorImpl.
  * Used for type checking during run time.
@@ -0,0 +1,144 @@
+#include <ATen/cuda/CUDAGraph.h>
+
+#include <ATen/ATen.h>
+#include <ATen/CUDAGeneratorImpl.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/Exceptions.h>
+#include <c10/cuda/CUDAGuard.h>
+
+namespace at {
+namespace cuda {
+
+bool currentStreamIsCapturing() {
+#ifdef AT_CUDA_GRAPHS_ENABLED
+  cudaStreamCaptureStatus status;
+  AT_CUDA_CHECK(cudaStreamIsCapturing(getCurrentCUDAStream(), &status));
+  return status != cudaStreamCaptureStatusNone;
+#else
+  return false;
+#endif
+}
+
+CUDAGraph::CUDAGraph() {
+#ifndef AT_CUDA_GRAPHS_ENABLED
+  TORCH_CHECK(false, "CUDA graphs may only be used in PyTorch built with CUDA >= 11.0");
+#endif
+}
+
+void CUDAGraph::capture_begin() {
+#ifdef AT_CUDA_GRAPHS_ENABLED
+  TORCH_CHECK(!has_graph_exec_ && !capture_stream_,
+      "This CUDAGraph instance already owns a captured graph. "
+      "To capture a new graph, create a new instance or call reset() first.");
+
+  auto stream = getCurrentCUDAStream();
+  TORCH_CHECK(stream != getDefaultCUDAStream(),
+      "CUDA graphs must be captured on a non-default stream. "
+      "(However, after capture, it's ok to replay them on the default stream.)");
+
+  auto* gen = get_generator_or_default<CUDAGeneratorImpl>(
+      c10::nullopt, detail::getDefaultCUDAGenerator(stream.device_index()));
+  auto options = TensorOptions().dtype(at::kLong).device(stream.device());
+  seed_extragraph_ = at::empty({1}, options);
+  offset_extragraph_ = at::empty({1}, options);
+  {
+    // See Note [Acquire lock when using random generators]
+    std::lock_guard<std::mutex> lock(gen->mutex_);
+    gen->capture_prologue(seed_extragraph_.data_ptr<int64_t>(),
+                          offset_extragraph_.data_ptr<int64_t>());
+  }
+
+  mempool_id_ = c10::cuda::CUDACachingAllocator::createPool();
+  c10::cuda::CUDACachingAllocator::notifyCaptureBegin(stream, mempool_id_);
+  capture_stream_ = stream;
+
+  // Global mode makes any thread error out on calls that are unsafe during
+  // a capture, such as cudaMalloc/cudaFree outside of the allocator's control.
+  cudaError_t err = cudaStreamBeginCapture(stream, cudaStreamCaptureModeGlobal);
+  if (err != cudaSuccess) {
+    c10::cuda::CUDACachingAllocator::notifyCaptureEnd(stream);
+    capture_stream_ = c10::nullopt;
+    std::lock_guard<std::mutex> lock(gen->mutex_);
+    gen->capture_epilogue();
+  }
+  AT_CUDA_CHECK(err);
+#endif
+}
+
+void CUDAGraph::capture_end() {
+#ifdef AT_CUDA_GRAPHS_ENABLED
+  auto stream = getCurrentCUDAStream();
+  TORCH_CHECK(capture_stream_ && stream == *capture_stream_,
+      "Capture must end on the same stream it began on.");
+
+  cudaError_t err = cudaStreamEndCapture(stream, &graph_);
+  c10::cuda::CUDACachingAllocator::notifyCaptureEnd(stream);
+  capture_stream_ = c10::nullopt;
+  auto* gen = get_generator_or_default<CUDAGeneratorImpl>(
+      c10::nullopt, detail::getDefaultCUDAGenerator(stream.device_index()));
+  {
+    // See Note [Acquire lock when using random generators]
+    std::lock_guard<std::mutex> lock(gen->mutex_);
+    wholegraph_increment_ = gen->capture_epilogue();
+  }
+  // cudaErrorStreamCaptureInvalidated means that an illegal call was made
+  // while capturing.
+  AT_CUDA_CHECK(err);
+  has_graph_ = true;
+
+  AT_CUDA_CHECK(cudaGraphInstantiate(&graph_exec_, graph_, nullptr, nullptr, 0));
+  has_graph_exec_ = true;
+
+  // Replays only need the executable graph.
+  AT_CUDA_CHECK(cudaGraphDestroy(graph_));
+  has_graph_ = false;
+#endif
+}
+
+void CUDAGraph::replay() {
+#ifdef AT_CUDA_GRAPHS_ENABLED
+  TORCH_CHECK(has_graph_exec_,
+      "Called CUDAGraph::replay without a preceding successful capture.");
+
+  c10::cuda::CUDAGuard device_guard(seed_extragraph_.device());
+  if (wholegraph_increment_ > 0) {
+    auto* gen = get_generator_or_default<CUDAGeneratorImpl>(
+        c10::nullopt, detail::getDefaultCUDAGenerator(seed_extragraph_.device().index()));
+    // See Note [Acquire lock when using random generators]
+    std::lock_guard<std::mutex> lock(gen->mutex_);
+    const uint64_t offset = gen->philox_offset_per_thread();
+    seed_extragraph_.fill_(static_cast<int64_t>(gen->current_seed()));
+    offset_extragraph_.fill_(static_cast<int64_t>(offset));
+    gen->set_philox_offset_per_thread(offset + wholegraph_increment_);
+  }
+
+  AT_CUDA_CHECK(cudaGraphLaunch(graph_exec_, getCurrentCUDAStream()));
+#endif
+}
+
+void CUDAGraph::reset() {
+#ifdef AT_CUDA_GRAPHS_ENABLED
+  // Also called by the destructor, so errors only warn.
+  if (has_graph_) {
+    C10_CUDA_CHECK_WARN(cudaGraphDestroy(graph_));
+    has_graph_ = false;
+  }
+  if (has_graph_exec_) {
+    C10_CUDA_CHECK_WARN(cudaGraphExecDestroy(graph_exec_));
+    has_graph_exec_ = false;
+  }
+  // Memory still held by tensors created during the capture is released as
+  // they are freed.
+  if (mempool_id_ != 0 && !capture_stream_) {
+    c10::cuda::CUDACachingAllocator::releasePool(mempool_id_);
+    mempool_id_ = 0;
+  }
+#endif
+}
+
+CUDAGraph::~CUDAGraph() {
+  reset();
+}
+
+} // namespace cuda
+} // namespace at
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <ATen/Tensor.h>
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/cuda/CUDAStream.h>
+#include <c10/util/Optional.h>
+
+#include <cuda.h>
+#include <cuda_runtime_api.h>
+
+namespace at {
+namespace cuda {
+
+// CUDA graphs need cudaStreamBeginCapture with an explicit capture mode and
+// the graph update/launch API of CUDA 11.
+#if !defined(__HIP_PLATFORM_HCC__) && defined(CUDA_VERSION) && CUDA_VERSION >= 11000
+#define AT_CUDA_GRAPHS_ENABLED
+#endif
+
+// Whether the current stream is capturing a CUDA graph. Always false in
+// builds without CUDA graph support.
+TORCH_CUDA_API bool currentStreamIsCapturing();
+
+/*
+ * Captures the work queued on the current stream between capture_begin()
+ * and capture_end() in a CUDA graph, which replay() launches again as a
+ * whole with a single call.
+ *
+ * - The capture must happen on a side stream: the legacy default stream
+ *   cannot be captured.
+ * - Replays read and write the same memory as the captured work. The
+ *   allocations made during the capture come from a private memory pool
+ *   (see CUDACachingAllocator.h) which is kept until reset(), so the
+ *   captured inputs, outputs and temporaries stay valid for every replay.
+ *   Refill the captured input tensors in place before replaying.
+ * - Random ops get fresh random numbers on every replay: during the capture
+ *   the default generator of the device hands out offsets relative to the
+ *   graph (see PhiloxCudaState), and replay() advances the generator by the
+ *   offset the graph consumes.
+ * - Anything that syncs with the host, and ops whose kernels are not graph
+ *   safe, raise an error or invalidate the capture.
+ */
+struct TORCH_CUDA_API CUDAGraph {
+  CUDAGraph();
+  ~CUDAGraph();
+
+  void capture_begin();
+  void capture_end();
+  void replay();
+  void reset();
+
+ protected:
+#ifdef AT_CUDA_GRAPHS_ENABLED
+  cudaGraph_t graph_ = nullptr;
+  cudaGraphExec_t graph_exec_ = nullptr;
+#endif
+
+  // Set when the graph, and the executable graph instantiated from it, exist.
+  bool has_graph_ = false;
+  bool has_graph_exec_ = false;
+
+  // Private pool of the allocations made during the capture. 0 if none.
+  c10::cuda::CUDACachingAllocator::MempoolId mempool_id_ = 0;
+
+  // Stream the capture began on.
+  c10::optional<c10::cuda::CUDAStream> capture_stream_;
+
+  // Device tensors the kernels of the graph read their seed and base Philox
+  // offset from, filled in by replay().
+  at::Tensor seed_extragraph_;
+  at::Tensor offset_extragraph_;
+
+  // Philox offset consumed by the random ops of a replay.
+  uint64_t wholegraph_increment_ = 0;
+};
+
+} // namespace cuda
+} // namespace at
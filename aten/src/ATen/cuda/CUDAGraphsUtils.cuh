@@ -0,0 +1,29 @@
+#pragma once
+
+#include <ATen/CUDAGeneratorImpl.h>
+
+#include <cstdint>
+#include <tuple>
+
+namespace at {
+namespace cuda {
+namespace philox {
+
+// Seed and Philox offset of a kernel launch, as handed out by
+// CUDAGeneratorImpl::philox_cuda_state(). Must be called in the kernel:
+// during a CUDA graph capture the values are read from device memory, which
+// is only filled in when the graph is replayed.
+__device__ __forceinline__ std::tuple<uint64_t, uint64_t>
+unpack(at::PhiloxCudaState arg) {
+  if (arg.captured_) {
+    return std::make_tuple(
+        static_cast<uint64_t>(*arg.seed_.ptr),
+        static_cast<uint64_t>(*(arg.offset_.ptr) + arg.offset_intragraph_));
+  } else {
+    return std::make_tuple(arg.seed_.val, arg.offset_.val);
+  }
+}
+
+} // namespace philox
+} // namespace cuda
+} // namespace at
@@ -1,5 +1,10 @@
 #include <ATen/cuda/CUDAContext.h>
 #include <ATen/cuda/detail/DeviceThreadHandles.h>
+#include <c10/cuda/CUDACachingAllocator.h>
+
+#include <cstdlib>
+#include <mutex>
+#include <map>
 
 namespace at { namespace cuda {
 namespace {
@@ -30,6 +35,35 @@ auto pool = std::make_shared<DeviceThreadHandlePool<cublasHandle_t, createCublas
 // releasing its reserved handles back to the pool.
 thread_local std::unique_ptr<decltype(pool)::element_type::PoolWindow> myPoolWindow;
 
+#ifdef AT_CUDA_CUBLASLT_ENABLED
+void createCublasLtHandle(cublasLtHandle_t *handle) {
+  TORCH_CUDABLAS_CHECK(cublasLtCreate(handle));
+}
+
+void destroyCublasLtHandle(cublasLtHandle_t handle) {
+// See destroyCublasHandle
+#ifdef NO_CUDNN_DESTROY_HANDLE
+#else
+    cublasLtDestroy(handle);
+#endif
+}
+
+auto lt_pool = std::make_shared<DeviceThreadHandlePool<cublasLtHandle_t, createCublasLtHandle, destroyCublasLtHandle>>();
+
+thread_local std::unique_ptr<decltype(lt_pool)::element_type::PoolWindow> myLtPoolWindow;
+
+size_t parseCublasLtWorkspaceSize() {
+  const char* env = std::getenv("TORCH_CUBLASLT_WORKSPACE_SIZE");
+  if (env) {
+    const long kib = std::strtol(env, nullptr, 10);
+    if (kib >= 0) {
+      return static_cast<size_t>(kib) * 1024;
+    }
+  }
+  return 4 * 1024 * 1024;
+}
+#endif
+
 } // namespace
 
 cublasHandle_t getCurrentCUDABlasHandle() {
@@ -44,4 +78,44 @@ cublasHandle_t getCurrentCUDABlasHandle() {
   return handle;
 }
 
+#ifdef AT_CUDA_CUBLASLT_ENABLED
+cublasLtHandle_t getCurrentCUDABlasLtHandle() {
+  int device;
+  AT_CUDA_CHECK(cudaGetDevice(&device));
+
+  if (!myLtPoolWindow)
+    myLtPoolWindow.reset(lt_pool->newPoolWindow());
+  return myLtPoolWindow->reserve(device);
+}
+
+size_t getCUDABlasLtWorkspaceSize() {
+  static const size_t size = parseCublasLtWorkspaceSize();
+  return size;
+}
+
+void* getCurrentCUDABlasLtWorkspace() {
+  const size_t size = getCUDABlasLtWorkspaceSize();
+  if (size == 0) {
+    return nullptr;
+  }
+  // The kernels on a stream run one after the other, so that all the calls on
+  // a stream can share a workspace. It is allocated on that stream, and like
+  // the handles, kept until the end of the process (the map is leaked so that
+  // the memory is not returned to an allocator already destroyed at exit).
+  // The default streams of all the devices have the same handle, hence the
+  // device in the key.
+  static std::mutex mutex;
+  static auto* workspaces = new std::map<std::pair<int, cudaStream_t>, at::DataPtr>();
+  const auto stream = c10::cuda::getCurrentCUDAStream();
+  const auto key = std::make_pair(static_cast<int>(stream.device_index()), stream.stream());
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = workspaces->find(key);
+  if (it == workspaces->end()) {
+    it = workspaces->emplace(
+        key, c10::cuda::CUDACachingAllocator::get()->allocate(size)).first;
+  }
+  return it->second.get();
+}
+#endif
+
 }} // namespace at::cuda
@@ -178,6 +178,23 @@ static inline ${return_type} ${api_name}(${formals}) {
 }
 """)
 
+# add a redispatch method definition in Functions.h: like the function, but
+# dispatching on the given keys, see Dispatcher::callUnboxedWithKeySet
+REDISPATCH_FUNCTION_DEFINITION = CodeTemplate("""\
+
+// ${schema_string}
+static inline ${return_type} ${api_name}(c10::DispatchKeySet _ks${,formals}) {
+#ifdef USE_STATIC_DISPATCH
+    (void)_ks;
+    return at::${api_name}(${native_actuals});
+#else
+    static c10::OperatorHandle op = c10::Dispatcher::singleton()
+        .findSchemaOrThrow("aten::${operator_name}", "${overload_name}");
+    return op.callUnboxedWithKeySet<${formals_types_with_return}>(_ks${,native_actuals});
+#endif
+}
+""")
+
 # In order to rely on the linker to strip unused ops, it requires us to dispatch statically
 # in Functions.h and TensorMethods.h.
 #
@@ -394,6 +411,7 @@ TopEnvironment = TypedDict('TopEnvironment', {
     'tensor_method_definitions': List[str],
     'function_declarations': List[str],
     'function_definitions': List[str],
+    'redispatch_function_definitions': List[str],
     'type_ids': List[str],
     'native_function_declarations': List[str],
 })
@@ -1300,6 +1318,9 @@ def create_generic(top_env, declarations):
             code = gen_namespace_function(option, formals)
             top_env['function_definitions'].append(code.definition)
             top_env['function_declarations'].append(code.declaration)
+            if not option['deprecated']:
+                top_env['redispatch_function_definitions'].append(
+                    REDISPATCH_FUNCTION_DEFINITION.substitute(option))
             method_of.append('namespace')
 
         return OutputDeclaration(
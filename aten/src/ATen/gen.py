@@ -176,7 +176,7 @@ def backend_to_devicetype(backend):
     return backend
 
 backends = ['CPU', 'CUDA']
-densities = ['Dense', 'Sparse', 'Mkldnn']  # TODO: layout instead of densities?
+densities = ['Dense', 'Sparse', 'Mkldnn', 'SparseCsr', 'Nested']  # TODO: layout instead of densities?
 
 quantized_backends = ['QuantizedCPU', 'QuantizedCUDA']
 
@@ -205,6 +205,7 @@ top_env = {
     'tensor_method_definitions': [],
     'function_declarations': [],
     'function_definitions': [],
+    'redispatch_function_definitions': [],
     'type_ids': [],
     'native_function_declarations': [],
 }
@@ -378,7 +379,7 @@ def generate_storage_type_and_tensor(backend, density, declarations, per_op_regi
 def iterate_types():
     for backend in backends:
         for density in densities:
-            if density == 'Mkldnn' and backend != 'CPU':
+            if density in ['Mkldnn', 'SparseCsr', 'Nested'] and backend != 'CPU':
                 continue
             else:
                 yield (backend, density)
@@ -1,21 +1,17 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/Parallel.h>
+#include <ATen/native/AdaptivePooling.h>
+#include <ATen/native/xnnpack/Engine.h>
 #include <tuple>
 
 
 namespace at {
 namespace native {
 
-namespace {
-
-  inline int start_index(int a, int b, int c) {
-    return (int)std::floor((float)(a * c) / b);
-  }
+DEFINE_DISPATCH(adaptive_avg_pool2d_channels_last_kernel);
 
-  inline int end_index(int a, int b, int c) {
-    return (int)std::ceil((float)((a + 1) * c) / b);
-  }
+namespace {
 
   template <typename scalar_t>
   static void adaptive_avg_pool2d_single_out_frame(
@@ -128,6 +124,14 @@ namespace {
     auto osizeH = output_size[0];
     auto osizeW = output_size[1];
 
+    if (input.ndimension() == 4 &&
+        input.suggest_memory_format() == at::MemoryFormat::ChannelsLast &&
+        input.scalar_type() != at::ScalarType::Half) {
+      output.resize_({input.size(0), sizeD, osizeH, osizeW}, at::MemoryFormat::ChannelsLast);
+      adaptive_avg_pool2d_channels_last_kernel(kCPU, output, input, output_size);
+      return;
+    }
+
     /* resize output */
     if (input.ndimension() == 3 || input.size(-4) == 1)
     {
@@ -326,7 +330,17 @@ namespace {
       return at::mkldnn_adaptive_avg_pool2d(input, output_size);
     }
 
-    // TODO: fastpath for Channels_last should be explored later;
+    // Disable the xnnpack operators for both iOS and macOS temporarily due to the crash in pthreadpool
+    // TODO:T66297472 remove `!defined(__APPLE__)` once we figure out the root cause of the crash.
+#if defined(C10_MOBILE) && !defined(__APPLE__)
+    if (output_size[0] == 1 && output_size[1] == 1 &&
+        xnnpack::use_global_average_pool(input)) {
+      return xnnpack::global_average_pool(input);
+    }
+#endif
+
+    // Channels last inputs, including the global pooling case, go to the
+    // channels last kernel of _adaptive_avg_pool2d.
     if (input.suggest_memory_format() == at::MemoryFormat::Contiguous && !input.is_quantized() && output_size[0] == 1 && output_size[1] == 1) {
       // in this case, adaptive pooling is just computing mean over hw
       // dimensions, which can be done more efficiently
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at {
+namespace native {
+
+using adaptive_avg_pool2d_fn = void(*)(Tensor& output, const Tensor& input, IntArrayRef output_size);
+
+// Forward of adaptive_avg_pool2d for a 4-d channels last input, into a
+// channels last output.
+DECLARE_DISPATCH(adaptive_avg_pool2d_fn, adaptive_avg_pool2d_channels_last_kernel);
+
+static inline int start_index(int a, int b, int c) {
+  return (int)std::floor((float)(a * c) / b);
+}
+
+static inline int end_index(int a, int b, int c) {
+  return (int)std::ceil((float)((a + 1) * c) / b);
+}
+
+} // namespace native
+} // namespace at
@@ -1,6 +1,7 @@
 #include <ATen/Dispatch.h>
 #include <ATen/Parallel.h>
 #include <ATen/native/BucketizationUtils.h>
+#include <c10/util/llvmMathExtras.h>
 
 /* Implement a TF like searchsorted and a bucketize function running on cpu
  *
@@ -43,6 +44,121 @@ const input_t* cus_lower_bound(const input_t* start, const input_t* end, input_t
   return start;
 }
 
+// minimal number of values per boundary for searchsorted_cpu_contiguous to
+// search 1d boundaries through their Eytzinger layout, whose building is linear
+// in the number of boundaries
+constexpr int64_t SEARCHSORTED_EYTZINGER_VALUES_PER_BOUNDARY = 4;
+
+// number of values an Eytzinger search goes through the levels of the tree
+// with at once, for their loads to overlap
+constexpr int64_t SEARCHSORTED_EYTZINGER_BLOCK_SIZE = 16;
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SEARCHSORTED_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define SEARCHSORTED_PREFETCH(addr)
+#endif
+
+// The boundaries laid out in the BFS order of the implicit binary search tree
+// over them (the Eytzinger layout), node k having the children 2k and 2k + 1,
+// the root being node 1. The first levels, which every search reads, share
+// cache lines, and the 16 descendants of a node 4 levels down are contiguous,
+// so that they can be prefetched. The nodes are padded to a power of two,
+// searches going right on the padding, so that every search goes through the
+// same number of levels without branching.
+template<typename input_t>
+struct EytzingerBoundaries {
+  explicit EytzingerBoundaries(const input_t* data_bd, int64_t size)
+    : size(size),
+      levels(64 - c10::llvm::countLeadingZeros<uint64_t>(size)),
+      nodes(int64_t(1) << levels),
+      positions(int64_t(1) << levels) {
+    // walk the tree in order, which is the order of the boundaries
+    int64_t k = 1;
+    while (2 * k <= size) {
+      k = 2 * k;
+    }
+    for (int64_t i = 0; i < size; ++i) {
+      nodes[k] = data_bd[i];
+      positions[k] = i;
+      if (2 * k + 1 <= size) {
+        k = 2 * k + 1;
+        while (2 * k <= size) {
+          k = 2 * k;
+        }
+      } else {
+        // up to the parent of the first left child
+        while (k & 1) {
+          k >>= 1;
+        }
+        k >>= 1;
+      }
+    }
+    // searches that never go left, the boundaries being all below the value
+    positions[0] = size;
+  }
+
+  int64_t size;
+  int levels;
+  std::vector<input_t> nodes;
+  // the position in the boundaries of every node
+  std::vector<int64_t> positions;
+};
+
+// The lower bound goes right of the boundaries below the value, the upper
+// bound of those not above it, which sends 'nan' to the end as well.
+template<typename input_t, bool right>
+inline bool search_goes_right(input_t boundary, input_t val) {
+  return right ? !(val < boundary) : !(boundary >= val);
+}
+
+// Searches count values, going down a level of the tree for all of them at a
+// time. A search ends below the last node it went left of, which is found by
+// dropping the trailing right turns, and the one before them, from the node
+// it ends on.
+template<typename input_t, typename output_t, bool right>
+void eytzinger_search_block(
+    const EytzingerBoundaries<input_t>& tree,
+    const input_t* data_in,
+    output_t* data_out,
+    int64_t count) {
+  const input_t* nodes = tree.nodes.data();
+  uint64_t k[SEARCHSORTED_EYTZINGER_BLOCK_SIZE];
+  for (int64_t j = 0; j < count; ++j) {
+    k[j] = 1;
+  }
+  for (int level = 0; level < tree.levels; ++level) {
+    const bool prefetch = level + 4 < tree.levels;
+    for (int64_t j = 0; j < count; ++j) {
+      if (prefetch) {
+        SEARCHSORTED_PREFETCH(nodes + 16 * k[j]);
+      }
+      const bool go_right = k[j] > static_cast<uint64_t>(tree.size) ||
+        search_goes_right<input_t, right>(nodes[k[j]], data_in[j]);
+      k[j] = 2 * k[j] + go_right;
+    }
+  }
+  for (int64_t j = 0; j < count; ++j) {
+    k[j] >>= c10::llvm::countTrailingOnes<uint64_t>(k[j]) + 1;
+    // type conversion might happen here
+    data_out[j] = tree.positions[k[j]];
+  }
+}
+
+template<typename input_t, typename output_t, bool right>
+void searchsorted_cpu_eytzinger(
+    const EytzingerBoundaries<input_t>& tree,
+    const input_t* data_in,
+    output_t* data_out,
+    int64_t numel_in) {
+  at::parallel_for(0, numel_in, SEARCHSORTED_GRAIN_SIZE, [&](int64_t start, int64_t end) {
+    for (int64_t i = start; i < end; i += SEARCHSORTED_EYTZINGER_BLOCK_SIZE) {
+      eytzinger_search_block<input_t, output_t, right>(
+        tree, data_in + i, data_out + i, std::min(SEARCHSORTED_EYTZINGER_BLOCK_SIZE, end - i));
+    }
+  });
+}
+
 template<typename input_t, typename output_t>
 void searchsorted_cpu_contiguous(Tensor& result, const Tensor& input, const Tensor& boundaries, const bool& right) {
   int64_t numel_in = input.numel();
@@ -56,6 +172,16 @@ void searchsorted_cpu_contiguous(Tensor& result, const Tensor& input, const Tens
   output_t *data_out = result.data_ptr<output_t>();
 
   bool is_1d_boundaries = boundaries.dim() == 1;
+  if (is_1d_boundaries && idim_bd > 0 && numel_in >= SEARCHSORTED_EYTZINGER_VALUES_PER_BOUNDARY * idim_bd) {
+    EytzingerBoundaries<input_t> tree(data_bd, idim_bd);
+    if (right) {
+      searchsorted_cpu_eytzinger<input_t, output_t, true>(tree, data_in, data_out, numel_in);
+    } else {
+      searchsorted_cpu_eytzinger<input_t, output_t, false>(tree, data_in, data_out, numel_in);
+    }
+    return;
+  }
+
   at::parallel_for(0, numel_in, SEARCHSORTED_GRAIN_SIZE, [&](int64_t start, int64_t end) {
     for (int64_t i = start; i < end; ++i) {
       // If boundaries tensor is 1d, we always search the entire boundary tensor
@@ -2,6 +2,7 @@
 
 #include <ATen/NamedTensorUtils.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/native/xnnpack/Engine.h>
 #include <c10/util/Exception.h>
 
 #include <algorithm>
@@ -24,6 +25,14 @@ Tensor channel_shuffle(const Tensor& self, int64_t groups) {
              c, " channels and ", groups, " groups.");
   int64_t oc = c / groups;
 
+// Disable the xnnpack operators for both iOS and macOS temporarily due to the crash in pthreadpool
+// TODO:T66297472 remove `!defined(__APPLE__)` once we figure out the root cause of the crash.
+#if defined(C10_MOBILE) && !defined(__APPLE__)
+  if (xnnpack::use_channel_shuffle(self, groups)) {
+    return xnnpack::channel_shuffle(self, groups);
+  }
+#endif
+
   auto input_reshaped = self.view({b, groups, oc, -1});
   // TODO: contiguous can be made to preserve the memory format
   // of the input. However since the above reshape clobbers h and w
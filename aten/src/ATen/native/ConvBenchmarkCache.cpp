@@ -0,0 +1,138 @@
+#include <ATen/native/ConvBenchmarkCache.h>
+
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+namespace at { namespace native {
+
+namespace {
+
+constexpr ConvBackend all_backends[] = {
+  ConvBackend::Slow2d,
+  ConvBackend::Mkldnn,
+  ConvBackend::Nnpack,
+  ConvBackend::Xnnpack,
+  ConvBackend::Winograd3x3Depthwise,
+};
+
+struct ConvBenchmarkCache {
+  std::mutex mutex;
+  std::unordered_map<std::string, ConvBackend> map;
+};
+
+ConvBenchmarkCache& conv_benchmark_cache() {
+  static ConvBenchmarkCache cache;
+  return cache;
+}
+
+void print_sizes(std::ostream& out, const char* name, IntArrayRef sizes) {
+  out << ';' << name << '=';
+  for (size_t i = 0; i < sizes.size(); i++) {
+    if (i > 0) {
+      out << 'x';
+    }
+    out << sizes[i];
+  }
+}
+
+} // namespace
+
+const char* conv_backend_name(ConvBackend backend) {
+  switch (backend) {
+    case ConvBackend::Slow2d:
+      return "slow2d";
+    case ConvBackend::Mkldnn:
+      return "mkldnn";
+    case ConvBackend::Nnpack:
+      return "nnpack";
+    case ConvBackend::Xnnpack:
+      return "xnnpack";
+    case ConvBackend::Winograd3x3Depthwise:
+      return "winograd3x3_depthwise";
+  }
+  TORCH_INTERNAL_ASSERT(false, "unknown convolution backend");
+}
+
+std::string conv_benchmark_key(
+    const Tensor& input, const Tensor& weight, const Tensor& bias,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation,
+    int64_t groups) {
+  std::ostringstream key;
+  key << input.scalar_type() << ';' << input.suggest_memory_format();
+  print_sizes(key, "input", input.sizes());
+  print_sizes(key, "weight", weight.sizes());
+  key << ";bias=" << bias.defined();
+  print_sizes(key, "stride", stride);
+  print_sizes(key, "padding", padding);
+  print_sizes(key, "dilation", dilation);
+  key << ";groups=" << groups;
+  return key.str();
+}
+
+c10::optional<ConvBackend> conv_benchmark_cache_find(const std::string& key) {
+  auto& cache = conv_benchmark_cache();
+  std::lock_guard<std::mutex> guard(cache.mutex);
+  auto it = cache.map.find(key);
+  if (it == cache.map.end()) {
+    return c10::nullopt;
+  }
+  return it->second;
+}
+
+void conv_benchmark_cache_insert(const std::string& key, ConvBackend backend) {
+  auto& cache = conv_benchmark_cache();
+  std::lock_guard<std::mutex> guard(cache.mutex);
+  cache.map[key] = backend;
+}
+
+void conv_benchmark_cache_clear() {
+  auto& cache = conv_benchmark_cache();
+  std::lock_guard<std::mutex> guard(cache.mutex);
+  cache.map.clear();
+}
+
+void conv_benchmark_cache_save(const std::string& path) {
+  std::ofstream file(path);
+  TORCH_CHECK(file, "conv_benchmark_cache_save: cannot open ", path, " for writing");
+  {
+    auto& cache = conv_benchmark_cache();
+    std::lock_guard<std::mutex> guard(cache.mutex);
+    for (const auto& entry : cache.map) {
+      file << entry.first << ' ' << conv_backend_name(entry.second) << '\n';
+    }
+  }
+  TORCH_CHECK(file, "conv_benchmark_cache_save: failed to write ", path);
+}
+
+void conv_benchmark_cache_load(const std::string& path) {
+  std::ifstream file(path);
+  TORCH_CHECK(file, "conv_benchmark_cache_load: cannot open ", path);
+  std::unordered_map<std::string, ConvBackend> entries;
+  std::string line;
+  for (int64_t line_number = 1; std::getline(file, line); line_number++) {
+    if (line.empty()) {
+      continue;
+    }
+    const auto pos = line.rfind(' ');
+    TORCH_CHECK(pos != std::string::npos && pos > 0,
+        "conv_benchmark_cache_load: malformed line ", line_number, " in ", path);
+    const auto name = line.substr(pos + 1);
+    auto backend = std::find_if(
+        std::begin(all_backends), std::end(all_backends),
+        [&](ConvBackend b) { return name == conv_backend_name(b); });
+    TORCH_CHECK(backend != std::end(all_backends),
+        "conv_benchmark_cache_load: unknown backend '", name, "' on line ",
+        line_number, " in ", path);
+    entries[line.substr(0, pos)] = *backend;
+  }
+  auto& cache = conv_benchmark_cache();
+  std::lock_guard<std::mutex> guard(cache.mutex);
+  for (const auto& entry : entries) {
+    cache.map[entry.first] = entry.second;
+  }
+}
+
+}} // namespace at::native
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <ATen/ATen.h>
+
+#include <string>
+
+namespace at { namespace native {
+
+// The CPU convolution backends that the benchmark mode of _convolution
+// times against each other (see Context::benchmarkCPUConv).
+enum class ConvBackend : uint8_t {
+  Slow2d,  // thnn_conv2d or slow_conv_dilated2d, i.e. im2col + GEMM
+  Mkldnn,
+  Nnpack,
+  Xnnpack,
+  Winograd3x3Depthwise,
+};
+
+TORCH_API const char* conv_backend_name(ConvBackend backend);
+
+// The cache key of a convolution: dtype, memory format, shapes and
+// parameters, printed without spaces.
+TORCH_API std::string conv_benchmark_key(
+    const Tensor& input, const Tensor& weight, const Tensor& bias,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation,
+    int64_t groups);
+
+// The fastest backend found for each key, shared by all threads.
+TORCH_API c10::optional<ConvBackend> conv_benchmark_cache_find(const std::string& key);
+TORCH_API void conv_benchmark_cache_insert(const std::string& key, ConvBackend backend);
+TORCH_API void conv_benchmark_cache_clear();
+
+// The cache file holds one "<key> <backend name>" line per entry, so that it
+// can be written by one process and used to seed another. Loading adds the
+// entries of the file to the cache, replacing those with the same key.
+TORCH_API void conv_benchmark_cache_save(const std::string& path);
+TORCH_API void conv_benchmark_cache_load(const std::string& path);
+
+}} // namespace at::native
@@ -4,11 +4,16 @@
 #include <ATen/native/cpu/DepthwiseConvKernel.h>
 #include <ATen/native/utils/ParamUtils.h>
 #include <ATen/native/ConvUtils.h>
+#include <ATen/native/ConvBenchmarkCache.h>
+#include <ATen/native/mkldnn/Utils.h>
 #include <ATen/native/xnnpack/Engine.h>
 
 #include <ATen/Config.h>
+#include <ATen/core/grad_mode.h>
 #include <c10/macros/Macros.h>
 
+#include <chrono>
+
 #if AT_NNPACK_ENABLED()
 #include <nnpack.h>
 #endif
@@ -48,6 +53,8 @@ struct ConvParams {
   bool use_nnpack(const at::Tensor& input) const;
   bool use_xnnpack(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
   bool is_depthwise(const at::Tensor& input, const at::Tensor& weight) const;
+  std::vector<ConvBackend> cpu_backends(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
+  bool use_cpu_benchmark(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
 };
 
 std::ostream& operator<<(std::ostream & out, const ConvParams& params) {
@@ -228,7 +235,9 @@ auto ConvParams::use_mkldnn(const at::Tensor& input) const -> bool {
   }
   return (input.is_mkldnn()) || // input is mkldnn Tensor
     (input.options().backend() == at::Backend::CPU &&
-     input.scalar_type() == kFloat && // only on CPU Float Tensors
+     (input.scalar_type() == kFloat || // only on CPU Float Tensors
+      (input.scalar_type() == kBFloat16 && // or BFloat16 ones on the CPUs
+       mkldnn_bf16_device_check())) &&  // running the bfloat16 primitives
      !is_dilated() && // doesn't support dilation
      !transposed && // or transposed tensors
      input.ndimension() == 4); // must be in NCHW format
@@ -274,6 +283,48 @@ auto ConvParams::use_xnnpack(
   return false;
 }
 
+// The CPU backends that can run a 4-d, non transposed convolution, in the
+// order of preference of the heuristics below; the benchmark mode picks the
+// fastest of them instead.
+auto ConvParams::cpu_backends(
+    const at::Tensor& input,
+    const at::Tensor& weight,
+    const at::Tensor& bias) const -> std::vector<ConvBackend> {
+  std::vector<ConvBackend> backends;
+  if (use_mkldnn(input)) {
+    backends.push_back(ConvBackend::Mkldnn);
+  }
+  if (use_xnnpack(input, weight, bias)) {
+    backends.push_back(ConvBackend::Xnnpack);
+  }
+  if (use_cpu_depthwise3x3_winograd(input, weight, bias)) {
+    backends.push_back(ConvBackend::Winograd3x3Depthwise);
+  }
+#if AT_NNPACK_ENABLED()
+  // as use_nnpack, without the batch size heuristic
+  if (at::_nnpack_available() &&
+      input.scalar_type() == kFloat &&
+      !is_dilated()) {
+    backends.push_back(ConvBackend::Nnpack);
+  }
+#endif
+  backends.push_back(ConvBackend::Slow2d);
+  return backends;
+}
+
+auto ConvParams::use_cpu_benchmark(
+    const at::Tensor& input,
+    const at::Tensor& weight,
+    const at::Tensor& bias) const -> bool {
+  return at::globalContext().benchmarkCPUConv() &&
+         input.device().type() == c10::DeviceType::CPU &&
+         input.layout() == at::kStrided &&
+         (input.scalar_type() == at::kFloat || input.scalar_type() == at::kDouble) &&
+         input.ndimension() == 4 &&
+         !transposed &&
+         cpu_backends(input, weight, bias).size() > 1;
+}
+
 // We currently only have depthwise support for the case where groups ==
 // nInputPlane and nInputPlane == nOutputPlane (the latter due to the lack of
 // a depthwise multiplier)
@@ -543,6 +594,49 @@ at::Tensor conv2d(
                          false, {{0, 0}}, groups);
 }
 
+// The fused kernels below have no derivatives, so they are only used when no
+// gradient is required; otherwise this falls back to conv2d followed by an
+// in-place relu.
+at::Tensor _conv2d_relu(
+    const Tensor& input, const Tensor& weight, const Tensor& bias,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation, int64_t groups) {
+  const bool requires_grad = at::GradMode::is_enabled() &&
+      (input.requires_grad() || weight.requires_grad() ||
+       (bias.defined() && bias.requires_grad()));
+  if (!requires_grad && input.dim() == 4 && weight.dim() == 4 &&
+      input.size(0) > 0) {
+    ConvParams params;
+    params.stride = expand_param_if_needed(stride, "stride", 2);
+    params.padding = expand_param_if_needed(padding, "padding", 2);
+    params.dilation = expand_param_if_needed(dilation, "dilation", 2);
+    params.transposed = false;
+    params.output_padding = {0, 0};
+    params.groups = groups;
+    params.benchmark = false;
+    params.deterministic = false;
+    params.cudnn_enabled = false;
+#if AT_MKLDNN_ENABLED()
+    if (params.use_mkldnn(input) &&
+        input.options().type_equal(weight.options()) &&
+        (!bias.defined() || input.options().type_equal(bias.options()))) {
+      if (input.is_mkldnn()) {
+        return at::mkldnn_convolution_relu(input, weight, bias,
+            params.padding, params.stride, params.dilation, params.groups);
+      }
+      return at::mkldnn_convolution_relu(input.contiguous(), weight.contiguous(),
+          bias.defined() ? bias.contiguous() : bias,
+          params.padding, params.stride, params.dilation, params.groups);
+    }
+#endif
+    if (params.use_xnnpack(input, weight, bias)) {
+      return xnnpack::convolution2d(input, weight, bias, params.padding,
+          params.stride, params.dilation, params.groups,
+          /*output_min=*/0.f);
+    }
+  }
+  return at::conv2d(input, weight, bias, stride, padding, dilation, groups).relu_();
+}
+
 at::Tensor conv3d(
     const Tensor& input, const Tensor& weight, const Tensor& bias,
     IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation, int64_t groups) {
@@ -588,6 +682,103 @@ at::Tensor convolution_overrideable(
   AT_ERROR("You are likely triggering this with tensor backend other than CPU/CUDA/MKLDNN, if this is intended, please use TORCH_LIBRARY_IMPL to override this function ");
 }
 
+static at::Tensor cpu_convolution(
+    ConvBackend backend,
+    const Tensor& input, const Tensor& weight, const Tensor& bias,
+    const ConvParams& params) {
+  switch (backend) {
+    case ConvBackend::Mkldnn:
+#if AT_MKLDNN_ENABLED()
+      return at::mkldnn_convolution(input.contiguous(), weight.contiguous(), bias.defined() ? bias.contiguous() : bias,
+                                    params.padding, params.stride, params.dilation, params.groups);
+#else
+      break;
+#endif
+    case ConvBackend::Xnnpack:
+      return xnnpack::convolution2d(
+          input, weight, bias, params.padding, params.stride, params.dilation, params.groups);
+    case ConvBackend::Winograd3x3Depthwise:
+      return convolution_depthwise3x3_winograd_stub(
+          input.device().type(), input, weight, bias, params.stride, params.padding, params.groups);
+    case ConvBackend::Nnpack:
+    case ConvBackend::Slow2d: {
+      auto kernel_size = weight.sizes().slice(2);
+      auto conv_nogroup = [&](const Tensor& input_g, const Tensor& weight_g, const Tensor& bias_g) {
+#if AT_NNPACK_ENABLED()
+        if (backend == ConvBackend::Nnpack) {
+          return at::_nnpack_spatial_convolution(input_g, weight_g, bias_g, params.padding, params.stride);
+        }
+#endif
+        if (params.is_dilated()) {
+          return at::slow_conv_dilated2d(
+              input_g, weight_g, kernel_size, bias_g, params.stride, params.padding, params.dilation);
+        }
+        return at::thnn_conv2d(input_g, weight_g, kernel_size, bias_g, params.stride, params.padding);
+      };
+      auto input_c = input.contiguous();
+      if (params.groups == 1) {
+        return conv_nogroup(input_c, weight, bias);
+      }
+      auto weight_c = weight;
+      auto bias_c = bias;
+      std::vector<Tensor> outputs(params.groups);
+      for (int g = 0; g < params.groups; ++g) {
+        outputs[g] = conv_nogroup(
+            subtensor(input_c, 1, params.groups, g),
+            subtensor(weight_c, 0, params.groups, g),
+            subtensor(bias_c, 0, params.groups, g));
+      }
+      return at::cat(outputs, 1);
+    }
+  }
+  TORCH_INTERNAL_ASSERT(false, "convolution backend ", conv_backend_name(backend), " is not available");
+}
+
+// Runs every candidate backend a few times and returns the one with the
+// smallest time, like cudnn's benchmark mode. Backends that fail on the
+// given parameters are skipped.
+static ConvBackend find_fastest_cpu_backend(
+    const std::vector<ConvBackend>& backends,
+    const Tensor& input, const Tensor& weight, const Tensor& bias,
+    const ConvParams& params) {
+  constexpr int num_runs = 3;
+  at::NoGradGuard no_grad;
+  ConvBackend fastest = ConvBackend::Slow2d;
+  auto fastest_time = std::chrono::steady_clock::duration::max();
+  for (const auto backend : backends) {
+    try {
+      for (int run = 0; run < num_runs; run++) {
+        const auto start = std::chrono::steady_clock::now();
+        cpu_convolution(backend, input, weight, bias, params);
+        const auto time = std::chrono::steady_clock::now() - start;
+        if (time < fastest_time) {
+          fastest = backend;
+          fastest_time = time;
+        }
+      }
+    } catch (const c10::Error&) {
+      continue;
+    }
+  }
+  return fastest;
+}
+
+static at::Tensor cpu_convolution_benchmarked(
+    const Tensor& input, const Tensor& weight, const Tensor& bias,
+    const ConvParams& params) {
+  const auto backends = params.cpu_backends(input, weight, bias);
+  const auto key = conv_benchmark_key(
+      input, weight, bias, params.stride, params.padding, params.dilation, params.groups);
+  auto backend = conv_benchmark_cache_find(key);
+  // entries loaded from a file may name a backend that this build or this
+  // input cannot use
+  if (!backend || std::find(backends.begin(), backends.end(), *backend) == backends.end()) {
+    backend = find_fastest_cpu_backend(backends, input, weight, bias, params);
+    conv_benchmark_cache_insert(key, *backend);
+  }
+  return cpu_convolution(*backend, input, weight, bias, params);
+}
+
 at::Tensor _convolution(
     const Tensor& input_r, const Tensor& weight_r, const Tensor& bias_r,
     IntArrayRef stride_, IntArrayRef padding_, IntArrayRef dilation_,
@@ -712,6 +903,14 @@ at::Tensor _convolution(
           input.contiguous(), weight, bias,
           params.padding, params.stride, params.dilation, params.groups, params.benchmark, params.deterministic);
     }
+  } else if (params.use_cpu_benchmark(input, weight, bias)) {
+    TORCH_CHECK(input.options().type_equal(weight.options()),
+             "Input type (", input.toString(), ") and weight type (", weight.toString(),
+             ") should be the same");
+    TORCH_CHECK(!bias.defined() || (input.options().type_equal(bias.options())),
+             "Input type (", input.toString(), ") and bias type (", bias.toString(),
+             ") should be the same");
+    output = cpu_convolution_benchmarked(input, weight, bias, params);
   } else if (params.use_mkldnn(input)) {
 #if AT_MKLDNN_ENABLED()
     TORCH_CHECK(input.options().type_equal(weight.options()),
@@ -11,6 +11,7 @@ DEFINE_DISPATCH(pdist_forward_stub);
 DEFINE_DISPATCH(pdist_backward_stub);
 DEFINE_DISPATCH(cdist_stub);
 DEFINE_DISPATCH(cdist_backward_stub);
+DEFINE_DISPATCH(euclidean_dist_finish_stub);
 
 Tensor pairwise_distance(const Tensor& x1, const Tensor& x2, double p, double eps, bool keepdim) {
   return at::norm(x1 - x2 + eps, p, 1, keepdim);
@@ -25,7 +26,64 @@ Tensor pdist(const Tensor& self, const double p) {
   return at::_pdist_forward(self.contiguous(), p);
 }
 
+// Size of the tiles of the result computed by one GEMM in
+// euclidean_dist_cpu, small enough that the tile is still in cache when
+// euclidean_dist_finish_stub turns it into distances.
+constexpr int64_t kEuclideanDistTileRows = 256;
+constexpr int64_t kEuclideanDistTileCols = 1024;
+
+// ||x1 - x2||^2 = ||x1||^2 + ||x2||^2 - 2 x1 x2^T loses precision through
+// cancellation when the distance is small compared to the norms. Both inputs
+// are centered on the mean of x2 first, which leaves the distances unchanged
+// but makes the norms as small as possible, and euclidean_dist_finish_stub
+// recomputes the distances that are still too small to be trusted.
+static Tensor euclidean_dist_cpu(const Tensor& x1, const Tensor& x2) {
+  const int64_t r1 = x1.size(-2);
+  const int64_t r2 = x2.size(-2);
+  const int64_t m = x1.size(-1);
+  std::vector<int64_t> output_shape(x1.sizes().begin(), x1.sizes().end() - 2);
+  const int64_t batch = prod_intlist(output_shape);
+  output_shape.insert(output_shape.end(), {r1, r2});
+  if (batch * r1 * r2 == 0) {
+    return at::empty(output_shape, x1.options());
+  } else if (m == 0) {
+    return at::zeros(output_shape, x1.options());
+  }
+
+  Tensor x2_ = x2.reshape({batch, r2, m});
+  Tensor center = x2_.mean(-2, /*keepdim=*/true);
+  Tensor x1_centered = x1.reshape({batch, r1, m}) - center;
+  Tensor x2_centered = x2_ - center;
+  Tensor x1_norm = x1_centered.pow(2).sum(-1);
+  Tensor x2_norm = x2_centered.pow(2).sum(-1);
+
+  Tensor result = at::empty({batch, r1, r2}, x1.options());
+  for (int64_t b = 0; b < batch; b++) {
+    for (int64_t i = 0; i < r1; i += kEuclideanDistTileRows) {
+      const int64_t rows = std::min(kEuclideanDistTileRows, r1 - i);
+      Tensor x1_tile = x1_centered[b].narrow(0, i, rows);
+      Tensor x1_norm_tile = x1_norm[b].narrow(0, i, rows);
+      for (int64_t j = 0; j < r2; j += kEuclideanDistTileCols) {
+        const int64_t cols = std::min(kEuclideanDistTileCols, r2 - j);
+        Tensor x2_tile = x2_centered[b].narrow(0, j, cols);
+        Tensor dist = result[b].narrow(0, i, rows).narrow(1, j, cols);
+        at::mm_out(dist, x1_tile, x2_tile.t());
+        euclidean_dist_finish_stub(
+            kCPU, dist, x1_tile, x2_tile, x1_norm_tile, x2_norm[b].narrow(0, j, cols));
+      }
+    }
+  }
+  return result.view(output_shape);
+}
+
 Tensor _euclidean_dist(const Tensor& x1, const Tensor& x2) {
+  if (x1.device().type() == kCPU && x2.device().type() == kCPU &&
+      x1.scalar_type() == x2.scalar_type() &&
+      (x1.scalar_type() == kFloat || x1.scalar_type() == kDouble) &&
+      x1.dim() == x2.dim() && x1.size(-1) == x2.size(-1) &&
+      x1.sizes().slice(0, x1.dim() - 2) == x2.sizes().slice(0, x2.dim() - 2)) {
+    return euclidean_dist_cpu(x1, x2);
+  }
   /** This function does the fist part of the euclidean distance calculation
    * We divide it in two steps to simplify dealing with subgradients in the 
    * backward step */
@@ -90,7 +148,9 @@ static Tensor cdist_impl(const Tensor& x1, const Tensor& x2, const double p, c10
   } else if (c1 == 0) {
     result = at::zeros(output_shape, x1.options());
   } else if (p == 2 && (mode == 1 || (mode == 0 && (r1 > 25 || r2 > 25)))) {
-    Tensor dist = (expand_batch_product == 1) ? at::_euclidean_dist(x1, x2) :
+    // Dropping batch dims of size 1 is always a view.
+    Tensor dist = (expand_batch_product == 1) ?
+                  at::_euclidean_dist(x1.reshape({r1, c1}), x2.reshape({r2, c2})) :
                   at::_euclidean_dist(tensor1_expanded, tensor2_expanded);
     result = dist.view(output_shape);
   } else {
@@ -9,10 +9,14 @@ using pdist_forward_fn = void(*)(Tensor&, const Tensor&, const double p);
 using pdist_backward_fn = void(*)(Tensor&, const Tensor&, const Tensor&, const double p, const Tensor&);
 using cdist_fn = void(*)(Tensor&, const Tensor&, const Tensor&, const double p);
 using cdist_backward_fn = void(*)(Tensor&, const Tensor&, const Tensor&, const Tensor&, const double p, const Tensor&);
+// Turns a 2D tile of x1 x2^T into the euclidean distances between the rows of
+// x1 and x2, given the squared norms of those rows.
+using euclidean_dist_finish_fn = void(*)(Tensor& dist, const Tensor& x1, const Tensor& x2, const Tensor& x1_norm, const Tensor& x2_norm);
 
 DECLARE_DISPATCH(pdist_forward_fn, pdist_forward_stub);
 DECLARE_DISPATCH(pdist_backward_fn, pdist_backward_stub);
 DECLARE_DISPATCH(cdist_fn, cdist_stub);
 DECLARE_DISPATCH(cdist_backward_fn, cdist_backward_stub);
+DECLARE_DISPATCH(euclidean_dist_finish_fn, euclidean_dist_finish_stub);
 
 }} // namespace at::native
@@ -18,6 +18,7 @@
 #include <ATen/native/DistributionTemplates.h>
 #include <ATen/NamedTensorUtils.h>
 
+#include <algorithm>
 #include <type_traits>
 #include <functional>
 #include <assert.h>
@@ -118,6 +119,7 @@ DEFINE_DISPATCH(bernoulli_mkl_stub);
 DEFINE_DISPATCH(cauchy_stub);
 DEFINE_DISPATCH(exponential_stub);
 DEFINE_DISPATCH(multinomial_stub);
+DEFINE_DISPATCH(multinomial_alias_draw_stub);
 DEFINE_DISPATCH(geometric_stub);
 DEFINE_DISPATCH(log_normal_stub);
 DEFINE_DISPATCH(uniform_stub);
@@ -497,4 +499,83 @@ Tensor multinomial(const Tensor& self, int64_t n_sample, bool with_replacement,
   return result;
 }
 
+// Vose's alias method: q[i] is the probability with which a draw of the
+// uniform bucket i keeps i, and J[i] the outcome it returns otherwise.
+// Building the tables is O(n) and inherently sequential; drawing from them
+// is O(1) per sample, see multinomial_alias_draw_stub.
+template <typename scalar_t>
+static void multinomial_alias_setup_apply(const Tensor& probs, Tensor& J, Tensor& q) {
+  const int64_t n = probs.numel();
+  const scalar_t* probs_data = probs.data_ptr<scalar_t>();
+  int64_t* J_data = J.data_ptr<int64_t>();
+  scalar_t* q_data = q.data_ptr<scalar_t>();
+
+  std::vector<int64_t> smaller;
+  std::vector<int64_t> larger;
+  for (int64_t i = 0; i < n; i++) {
+    J_data[i] = -1;
+    q_data[i] = n * probs_data[i];
+    if (q_data[i] < 1) {
+      smaller.push_back(i);
+    } else {
+      larger.push_back(i);
+    }
+  }
+
+  // Fill up each small bucket with the mass of a large outcome, which
+  // becomes small itself once it has given away enough.
+  while (!smaller.empty() && !larger.empty()) {
+    const int64_t small = smaller.back();
+    const int64_t large = larger.back();
+    J_data[small] = large;
+    q_data[large] -= 1 - q_data[small];
+    if (q_data[large] < 1) {
+      smaller.back() = large;
+      larger.pop_back();
+    } else {
+      smaller.pop_back();
+    }
+  }
+
+  const auto q_minmax = std::minmax_element(q_data, q_data + n);
+  TORCH_CHECK(*q_minmax.first >= 0, "q_min is less than 0");
+  const scalar_t q_max = *q_minmax.second;
+  for (int64_t i = 0; i < n; i++) {
+    if (q_max > 1) {
+      q_data[i] /= q_max;
+    }
+    // Rounding can leave an outcome without an alias; it must then always
+    // keep its bucket.
+    if (J_data[i] < 0) {
+      q_data[i] = 1;
+    }
+  }
+}
+
+std::tuple<Tensor, Tensor> _multinomial_alias_setup_cpu(const Tensor& probs) {
+  TORCH_CHECK(probs.dim() == 1,
+      "expected 1-D probability tensor, got ", probs.dim(), "-D probability tensor instead");
+  Tensor probs_ = probs.contiguous();
+  Tensor J = at::empty({probs.numel()}, probs.options().dtype(kLong));
+  Tensor q = at::empty({probs.numel()}, probs.options());
+  AT_DISPATCH_FLOATING_TYPES(probs.scalar_type(), "multinomial_alias_setup", [&] {
+    multinomial_alias_setup_apply<scalar_t>(probs_, J, q);
+  });
+  return std::make_tuple(J, q);
+}
+
+Tensor _multinomial_alias_draw_cpu(const Tensor& q, const Tensor& J, int64_t n_sample, c10::optional<Generator> gen) {
+  TORCH_CHECK(q.dim() == 1,
+      "expected 1-D probability table, got ", q.dim(), "-D probability table instead");
+  TORCH_CHECK(J.dim() == 1,
+      "expected 1-D alias table, got ", J.dim(), "-D alias table instead");
+  TORCH_CHECK(n_sample > 0, "cannot sample <= 0 samples");
+  TORCH_CHECK(q.numel() == J.numel(),
+      "expected probability and alias tables of the same size, got ", q.numel(), " and ", J.numel());
+  TORCH_CHECK(J.scalar_type() == kLong, "expected Long alias table, got ", J.scalar_type());
+  Tensor result = at::empty({n_sample}, J.options());
+  multinomial_alias_draw_stub(kCPU, result, q.contiguous(), J.contiguous(), gen);
+  return result;
+}
+
 }} // namespace at::native
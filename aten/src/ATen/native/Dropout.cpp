@@ -1,6 +1,10 @@
 #include <ATen/ATen.h>
+#include <ATen/CPUGeneratorImpl.h>
 #include <ATen/Dispatch.h>
 #include <ATen/NamedTensorUtils.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/DistributionsHelper.h>
+#include <ATen/core/PhiloxRNGEngine.h>
 
 namespace at { namespace native {
 
@@ -25,6 +29,27 @@ bool is_fused_kernel_acceptable(const Tensor& input, double p) {
   return input.is_cuda() && p > 0 && p < 1 && input.numel() > 0;
 }
 
+// See Note [Bit-packed dropout masks]
+bool is_packed_kernel_acceptable(const Tensor& input, double p) {
+  if (input.layout() != kStrided || !input.is_floating_point() ||
+      !input.is_contiguous() || p <= 0 || p >= 1 || input.numel() == 0) {
+    return false;
+  }
+  if (input.is_cuda()) {
+    return true;
+  }
+  // On CPU the packed kernel reads the Philox stream, so it is only taken in
+  // the Philox mode of the default generator. Otherwise the mask has to come
+  // from the mt19937 engine, whatever the grad mode, so that restoring the
+  // state of the generator replays it, e.g. for checkpointing.
+  if (!input.device().is_cpu()) {
+    return false;
+  }
+  auto gen = check_generator<CPUGeneratorImpl>(detail::getDefaultCPUGenerator());
+  std::lock_guard<std::mutex> lock(gen->mutex_);
+  return gen->philox_enabled();
+}
+
 // NB: sure, we could have used different overloads here, but I would feel insecure
 // knowing that this dispatch depends only on the constness of the references
 template<bool inplace>
@@ -82,9 +107,98 @@ ALIAS_SPECIALIZATION(_feature_alpha_dropout, true,  true )
 
 } // anomymous namepsace
 
+// Note [Bit-packed dropout masks]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// _fused_dropout_packed returns the mask that backward needs with one bit
+// per element instead of a byte (or, for the unfused CPU path, a full element
+// of the input dtype), since for large activations, e.g. in transformers,
+// dropout masks are a large share of the memory kept for backward. Bit j of
+// byte i of the mask is set iff element 8 * i + j, in the row-major order of
+// the input, was kept. The output is always contiguous, so dropout only takes
+// this path for contiguous inputs; _masked_scale_packed applies the mask to
+// the gradient in backward. On CPU, dropout only takes it when the default
+// generator is in Philox mode, see is_packed_kernel_acceptable.
+//
+// The CPU kernel reads two 128 bit Philox numbers per mask byte from the
+// range given by CPUGeneratorImpl::philox_engine_inputs, so it runs in
+// parallel and gives the same mask regardless of the number of threads.
+// See Note [Counter-based CPU random fills]
+
+std::tuple<Tensor, Tensor>
+fused_dropout_packed_cpu(const Tensor& self, double p, c10::optional<Generator> gen_) {
+  TORCH_CHECK(p > 0 && p <= 1, "keep probability has to be in (0, 1], but got ", p);
+  auto gen = get_generator_or_default<CPUGeneratorImpl>(gen_, detail::getDefaultCPUGenerator());
+  Tensor input = self.contiguous();
+  Tensor ret = at::empty_like(input, MemoryFormat::Contiguous);
+  const int64_t nelem = input.numel();
+  const int64_t nbytes = (nelem + 7) / 8;
+  Tensor mask = at::empty({nbytes}, self.options().dtype(kByte));
+  if (nelem == 0) return std::tuple<Tensor,Tensor>(ret, mask);
+  std::pair<uint64_t, uint64_t> seed_and_offset;
+  {
+    // See Note [Acquire lock when using random generators]
+    std::lock_guard<std::mutex> lock(gen->mutex_);
+    seed_and_offset = gen->philox_engine_inputs(2 * nbytes);
+  }
+  AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16, input.scalar_type(), "fused_dropout_packed_cpu", [&] {
+    using accscalar_t = typename std::conditional<std::is_same<scalar_t, double>::value, double, float>::type;
+    const accscalar_t pinv = accscalar_t(1) / p;
+    const float pf = static_cast<float>(p);
+    const scalar_t* input_data = input.data_ptr<scalar_t>();
+    scalar_t* ret_data = ret.data_ptr<scalar_t>();
+    uint8_t* mask_data = mask.data_ptr<uint8_t>();
+    at::parallel_for(0, nbytes, internal::GRAIN_SIZE / 8, [&](int64_t begin, int64_t end) {
+      at::Philox4_32_10 engine(seed_and_offset.first, 0, seed_and_offset.second + 2 * begin);
+      for (int64_t i = begin; i < end; i++) {
+        uint8_t bits = 0;
+        // Always draw 8 randoms, so that every byte starts at a fixed position
+        // in the Philox stream.
+        for (int64_t j = 0; j < 8; j++) {
+          const bool keep = uniform_real_transformation<float>(engine(), 0.f, 1.f) < pf;
+          const int64_t li = i * 8 + j;
+          if (li < nelem) {
+            ret_data[li] = static_cast<accscalar_t>(input_data[li]) * keep * pinv;
+            bits |= static_cast<uint8_t>(keep) << j;
+          }
+        }
+        mask_data[i] = bits;
+      }
+    });
+  });
+  return std::tuple<Tensor,Tensor>(ret, mask);
+}
+
+Tensor masked_scale_packed_cpu(const Tensor& self, const Tensor& mask, double scale) {
+  TORCH_CHECK(mask.scalar_type() == at::ScalarType::Byte, "mask should be torch.uint8 dtype");
+  TORCH_CHECK(mask.dim() == 1 && mask.numel() == (self.numel() + 7) / 8,
+      "Expected a packed mask of ", (self.numel() + 7) / 8, " bytes for ", self.numel(),
+      " elements, but got a mask of size ", mask.sizes());
+  Tensor input = self.contiguous();
+  Tensor packed = mask.contiguous();
+  Tensor ret = at::empty_like(input, MemoryFormat::Contiguous);
+  const int64_t nelem = input.numel();
+  AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16, ret.scalar_type(), "masked_scale_packed_cpu", [&] {
+    using accscalar_t = typename std::conditional<std::is_same<scalar_t, double>::value, double, float>::type;
+    const accscalar_t scale_ = static_cast<accscalar_t>(scale);
+    const scalar_t* input_data = input.data_ptr<scalar_t>();
+    const uint8_t* mask_data = packed.data_ptr<uint8_t>();
+    scalar_t* ret_data = ret.data_ptr<scalar_t>();
+    at::parallel_for(0, nelem, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        const accscalar_t keep = (mask_data[i / 8] >> (i % 8)) & 1;
+        ret_data[i] = keep * static_cast<accscalar_t>(input_data[i]) * scale_;
+      }
+    });
+  });
+  return ret;
+}
+
 Tensor dropout(const Tensor& input, double p, bool train) {
   auto result = [&]() {
     NoNamesGuard guard;
+    if (train && is_packed_kernel_acceptable(input, p)) {
+      return std::get<0>(at::_fused_dropout_packed(input, 1 - p));
+    }
     if (train && is_fused_kernel_acceptable(input, p)) {
       return std::get<0>(at::_fused_dropout(input, 1 - p));
     }
@@ -5,10 +5,10 @@
 
 #include <TH/THBlasUtils.h>
 
+#include <caffe2/perfkernels/embedding_lookup_idx.h>
+
 #ifdef USE_FBGEMM
 #include <fbgemm/Fbgemm.h>
-#else
-#include <caffe2/perfkernels/embedding_lookup_idx.h>
 #endif
 
 #include <cstring>
@@ -37,258 +37,314 @@ static void make_offset2bag(const Tensor &offsets, const Tensor &indices, Tensor
 
 namespace {
 
-bool isFastPathIndexSelect(const Tensor& src, Tensor& output) {
-  return src.scalar_type() == kFloat && src.stride(1) == 1 && output.stride(1) == 1;
+// Rows of reduced precision weights are accumulated in float
+template <typename scalar_t>
+struct EmbeddingBagAccType {
+  using type = float;
+};
+
+template <>
+struct EmbeddingBagAccType<double> {
+  using type = double;
+};
+
+// Number of bags per parallel_for task, so that small inputs run on the
+// calling thread
+int64_t bag_grain_size(int64_t num_indices, int64_t num_bags, int64_t ddim) {
+  const int64_t avg_bag_cost =
+      std::max<int64_t>(1, num_indices / std::max<int64_t>(num_bags, 1)) *
+      std::max<int64_t>(ddim, 1);
+  return std::max<int64_t>(1, at::internal::GRAIN_SIZE / avg_bag_cost);
 }
 
-bool isFastPathIndexSelectScale(const Tensor& src, const Tensor& scale, Tensor& output) {
-  return src.scalar_type() == kFloat && src.stride(1) == 1 && output.stride(1) == 1 && scale.stride(0) == 1;
+// Returns the offsets of the bags with the end of the last bag appended,
+// using `storage` if that end isn't part of `offsets` already.
+const int64_t* bag_boundaries(
+    const Tensor& offsets,
+    int64_t num_indices,
+    bool include_last_offset,
+    std::vector<int64_t>& storage) {
+  if (include_last_offset) {
+    return offsets.data_ptr<int64_t>();
+  }
+  storage.resize(offsets.numel() + 1);
+  std::memcpy(
+      storage.data(),
+      offsets.data_ptr<int64_t>(),
+      sizeof(int64_t) * offsets.numel());
+  storage[offsets.numel()] = num_indices;
+  return storage.data();
 }
 
-// This function combines index_select (using select_indices as the index) and
-// index_add (using add_indices as the index), without creating an intermediary
-// tensor to hold the selected embeddings
-template<typename T>
-void index_select_add(const Tensor &select_indices,
-                             const Tensor &add_indices,
-                             const Tensor &src,
-                             Tensor &output,
-                             const Tensor& /*offsets*/,
-                             bool /*include_last_offset*/) {
-  AT_ASSERT(select_indices.numel() == add_indices.numel());
-  auto* add_indices_data = add_indices.data_ptr<int64_t>();
-  auto* select_indices_data = select_indices.data_ptr<int64_t>();
-  auto* src_data = src.data_ptr<T>();
-  auto* output_data = output.data_ptr<T>();
-  auto numel = add_indices.numel();
-  int64_t ddim = src.size(1);
-  auto src_stride0 = src.stride(0);
-  auto src_stride1 = src.stride(1);
-  auto output_stride0 = output.stride(0);
-  auto output_stride1 = output.stride(1);
-
-  for (int64_t i = 0; i < numel; i++) {
-    THBlas_axpy<T>(ddim, 1,
-            src_data + src_stride0 * select_indices_data[i], src_stride1,
-            output_data + output_stride0 * add_indices_data[i], output_stride1);
-  }
+bool isFastPathEmbeddingLookup(
+    const Tensor& weight,
+    const Tensor& per_sample_weights,
+    const Tensor& output) {
+  // the perfkernels address rows of `weight` and `output` as dense blocks
+  return weight.stride(1) == 1 && weight.stride(0) == weight.size(1) &&
+      output.is_contiguous() &&
+      (!per_sample_weights.defined() || per_sample_weights.stride(0) == 1);
 }
 
-template<>
-void index_select_add<float>(const Tensor &select_indices,
-                             const Tensor &add_indices,
-                             const Tensor &src,
-                             Tensor &output,
-                             const Tensor& offsets,
-                             bool include_last_offset) {
-  int64_t ddim = src.size(1);
-  auto* src_data = src.data_ptr<float>();
-  auto* select_indices_data = select_indices.data_ptr<int64_t>();
-  auto* output_data = output.data_ptr<float>();
+// Sum or mean of the (optionally scaled) rows of `weight` in each bag, with
+// the bags split across threads. The rows are accumulated in acc_t, so that
+// reduced precision weights don't lose precision over long bags.
+template <typename scalar_t>
+void embedding_bag_cpu_sum_mean_generic(
+    const Tensor& weight,
+    const Tensor& indices,
+    const int64_t* bag_offsets,
+    int64_t num_bags,
+    const Tensor& per_sample_weights,
+    int64_t mode,
+    Tensor& output) {
+  using acc_t = typename EmbeddingBagAccType<scalar_t>::type;
+  const int64_t ddim = weight.size(1);
+  const int64_t num_weights = weight.size(0);
+  const auto* weight_data = weight.data_ptr<scalar_t>();
+  const auto weight_stride0 = weight.stride(0);
+  const auto weight_stride1 = weight.stride(1);
+  const auto* indices_data = indices.data_ptr<int64_t>();
+  auto* output_data = output.data_ptr<scalar_t>();
+  const auto output_stride0 = output.stride(0);
+  const auto output_stride1 = output.stride(1);
+  const scalar_t* scale_data = per_sample_weights.defined()
+      ? per_sample_weights.data_ptr<scalar_t>()
+      : nullptr;
+  const auto scale_stride =
+      per_sample_weights.defined() ? per_sample_weights.stride(0) : 0;
+
+  at::parallel_for(
+      0, num_bags, bag_grain_size(indices.numel(), num_bags, ddim),
+      [&](int64_t begin, int64_t end) {
+        std::vector<acc_t> acc(ddim);
+        for (int64_t bag = begin; bag < end; bag++) {
+          std::fill(acc.begin(), acc.end(), static_cast<acc_t>(0));
+          for (int64_t i = bag_offsets[bag]; i < bag_offsets[bag + 1]; i++) {
+            const int64_t idx = indices_data[i];
+            TORCH_CHECK(
+                idx >= 0 && idx < num_weights,
+                "embedding_bag: index ", idx, " is out of bounds for ",
+                num_weights, " embeddings");
+            const scalar_t* row = weight_data + weight_stride0 * idx;
+            const acc_t scale = scale_data
+                ? static_cast<acc_t>(scale_data[i * scale_stride])
+                : static_cast<acc_t>(1);
+            if (weight_stride1 == 1) {
+              for (int64_t j = 0; j < ddim; j++) {
+                acc[j] += scale * static_cast<acc_t>(row[j]);
+              }
+            } else {
+              for (int64_t j = 0; j < ddim; j++) {
+                acc[j] += scale * static_cast<acc_t>(row[j * weight_stride1]);
+              }
+            }
+          }
+          const int64_t length = bag_offsets[bag + 1] - bag_offsets[bag];
+          // empty bags return all 0s for the mean as well
+          const acc_t divisor = (mode == MODE_MEAN && length > 0)
+              ? static_cast<acc_t>(length)
+              : static_cast<acc_t>(1);
+          scalar_t* output_row = output_data + output_stride0 * bag;
+          for (int64_t j = 0; j < ddim; j++) {
+            output_row[j * output_stride1] =
+                static_cast<scalar_t>(acc[j] / divisor);
+          }
+        }
+      });
+}
 
-  if (isFastPathIndexSelect(src, output)) {
-    int64_t output_size = offsets.numel() - 1;
-    auto* offsets_data = offsets.data_ptr<int64_t>();
-    std::vector<int64_t> offsets_include_last;
+template <typename scalar_t>
+void embedding_bag_cpu_sum_mean(
+    const Tensor& weight,
+    const Tensor& indices,
+    const int64_t* bag_offsets,
+    int64_t num_bags,
+    const Tensor& per_sample_weights,
+    int64_t mode,
+    Tensor& output) {
+  embedding_bag_cpu_sum_mean_generic<scalar_t>(
+      weight, indices, bag_offsets, num_bags, per_sample_weights, mode, output);
+}
 
-    if (include_last_offset) {
-      output_size = offsets.numel() - 1;
-    } else {
-      output_size = offsets.numel();
-      offsets_include_last.resize(offsets.numel() + 1);
-      std::memcpy(
-          offsets_include_last.data(),
-          offsets.data_ptr<int64_t>(),
-          sizeof(int64_t) * offsets.numel());
-      offsets_include_last[offsets.numel()] = select_indices.numel();
-      offsets_data = offsets_include_last.data();
-    }
+template <>
+void embedding_bag_cpu_sum_mean<float>(
+    const Tensor& weight,
+    const Tensor& indices,
+    const int64_t* bag_offsets,
+    int64_t num_bags,
+    const Tensor& per_sample_weights,
+    int64_t mode,
+    Tensor& output) {
+  if (!isFastPathEmbeddingLookup(weight, per_sample_weights, output)) {
+    embedding_bag_cpu_sum_mean_generic<float>(
+        weight, indices, bag_offsets, num_bags, per_sample_weights, mode, output);
+    return;
+  }
+  const int64_t ddim = weight.size(1);
+  const auto* weight_data = weight.data_ptr<float>();
+  const auto* indices_data = indices.data_ptr<int64_t>();
+  const float* scale_data = per_sample_weights.defined()
+      ? per_sample_weights.data_ptr<float>()
+      : nullptr;
+  auto* output_data = output.data_ptr<float>();
 
 #ifdef USE_FBGEMM
-    auto kernel_fp32_i64 =
-      fbgemm::GenerateEmbeddingSpMDM<float, int64_t, int64_t>(
-        /* block_size */ddim,
-        /* has_weight */false,
-        /* normalize_by_lengths */false,
-        /* prefetch */16,
-        /* is_weight_positional */false,
-        /* use_offsets */true
-      );
+  auto kernel_fp32_i64 =
+    fbgemm::GenerateEmbeddingSpMDM<float, int64_t, int64_t>(
+      /* block_size */ddim,
+      /* has_weight */scale_data != nullptr,
+      /* normalize_by_lengths */mode == MODE_MEAN,
+      /* prefetch */16,
+      /* is_weight_positional */false,
+      /* use_offsets */true
+    );
 #endif
-    at::parallel_for(
-        0, output_size, 1, [&](int64_t start_idx, int64_t end_idx) {
+  at::parallel_for(
+      0, num_bags, bag_grain_size(indices.numel(), num_bags, ddim),
+      [&](int64_t start_idx, int64_t end_idx) {
 #ifdef USE_FBGEMM
-          kernel_fp32_i64(
-            /* output_size */end_idx - start_idx,
-            /* index_size */offsets_data[end_idx] - offsets_data[start_idx],
-            /* data_size */src.size(0),
-            /* input */src_data,
-            /* indices */select_indices_data + offsets_data[start_idx],
-            /* offsets_or_lengths */offsets_data + start_idx,
-            /* weights */nullptr,
-            /* output */output_data + start_idx * ddim);
+        kernel_fp32_i64(
+          /* output_size */end_idx - start_idx,
+          /* index_size */bag_offsets[end_idx] - bag_offsets[start_idx],
+          /* data_size */weight.size(0),
+          /* input */weight_data,
+          /* indices */indices_data + bag_offsets[start_idx],
+          /* offsets_or_lengths */bag_offsets + start_idx,
+          /* weights */scale_data ? scale_data + bag_offsets[start_idx] : nullptr,
+          /* output */output_data + start_idx * ddim);
 #else
-          caffe2::EmbeddingLookupIdx(
-              /*block_size=*/ddim,
-              /*output_size=*/end_idx - start_idx,
-              /*index_size=*/offsets_data[end_idx] - offsets_data[start_idx],
-              /*data_size=*/src.size(0),
-              /*input=*/src_data,
-              /*indices=*/select_indices_data + offsets_data[start_idx],
-              /*offsets=*/offsets_data + start_idx,
-              /*weights=*/nullptr,
-              /*scale_bias=*/nullptr,
-              /*normalize_by_lengths=*/false,
-              /*out=*/output_data + start_idx * ddim);
+        caffe2::EmbeddingLookupIdx(
+            /*block_size=*/ddim,
+            /*output_size=*/end_idx - start_idx,
+            /*index_size=*/bag_offsets[end_idx] - bag_offsets[start_idx],
+            /*data_size=*/weight.size(0),
+            /*input=*/weight_data,
+            /*indices=*/indices_data + bag_offsets[start_idx],
+            /*offsets=*/bag_offsets + start_idx,
+            /*weights=*/scale_data ? scale_data + bag_offsets[start_idx] : nullptr,
+            /*scale_bias=*/nullptr,
+            /*normalize_by_lengths=*/mode == MODE_MEAN,
+            /*out=*/output_data + start_idx * ddim);
 #endif
-        });
-  } else {
-    AT_ASSERT(select_indices.numel() == add_indices.numel());
-    auto* add_indices_data = add_indices.data_ptr<int64_t>();
-    auto src_stride0 = src.stride(0);
-    auto src_stride1 = src.stride(1);
-    auto output_stride0 = output.stride(0);
-    auto output_stride1 = output.stride(1);
-    auto numel = add_indices.numel();
-    for (int64_t i = 0; i < numel; i++) {
-      THBlas_axpy<float>(
-          ddim,
-          1,
-          src_data + src_stride0 * select_indices_data[i],
-          src_stride1,
-          output_data + output_stride0 * add_indices_data[i],
-          output_stride1);
-    }
-  }
+      });
 }
 
-// This function fuses the following three fns:
-// index_select (using select_indices as the index)
-// mul (scaling by per_sample_weights)
-// index_add (using add_indices as the index)
-template<typename T>
-static void index_select_scale_add(const Tensor &select_indices,
-                                   const Tensor &add_indices,
-                                   const Tensor &scale,
-                                   const Tensor &src,
-                                   Tensor &output,
-                                   const Tensor& /*offsets*/,
-                                   bool /*include_last_offset*/) {
-  AT_ASSERT(select_indices.numel() == add_indices.numel());
-  auto* add_indices_data = add_indices.data_ptr<int64_t>();
-  auto* select_indices_data = select_indices.data_ptr<int64_t>();
-  auto* src_data = src.data_ptr<T>();
-  auto* output_data = output.data_ptr<T>();
-  auto numel = add_indices.numel();
-  int64_t ddim = src.size(1);
-  auto src_stride0 = src.stride(0);
-  auto src_stride1 = src.stride(1);
-  auto output_stride0 = output.stride(0);
-  auto output_stride1 = output.stride(1);
-
-  auto* scale_data = scale.data_ptr<T>();
-  auto scale_stride = scale.stride(0);
-
-  for (int64_t i = 0; i < numel; i++) {
-    auto* src_base = src_data + src_stride0 * select_indices_data[i];
-    auto* output_base = output_data + output_stride0 * add_indices_data[i];
-    auto scale = scale_data[i * scale_stride];
-    for (int64_t j = 0; j < ddim; j++) {
-      output_base[j * output_stride1] += src_base[j * src_stride1] * scale;
-    }
+// fp16 weights go through the same AVX2 kernels as fp32 ones, which convert
+// the rows and accumulate them in fp32; each task then rounds its bags back
+// to fp16.
+template <>
+void embedding_bag_cpu_sum_mean<at::Half>(
+    const Tensor& weight,
+    const Tensor& indices,
+    const int64_t* bag_offsets,
+    int64_t num_bags,
+    const Tensor& per_sample_weights,
+    int64_t mode,
+    Tensor& output) {
+  if (!isFastPathEmbeddingLookup(weight, per_sample_weights, output)) {
+    embedding_bag_cpu_sum_mean_generic<at::Half>(
+        weight, indices, bag_offsets, num_bags, per_sample_weights, mode, output);
+    return;
   }
+  const int64_t ddim = weight.size(1);
+  const auto* weight_data = weight.data_ptr<at::Half>();
+  const auto* indices_data = indices.data_ptr<int64_t>();
+  const at::Half* scale_data = per_sample_weights.defined()
+      ? per_sample_weights.data_ptr<at::Half>()
+      : nullptr;
+  auto* output_data = output.data_ptr<at::Half>();
+
+  at::parallel_for(
+      0, num_bags, bag_grain_size(indices.numel(), num_bags, ddim),
+      [&](int64_t start_idx, int64_t end_idx) {
+        const int64_t index_begin = bag_offsets[start_idx];
+        const int64_t index_size = bag_offsets[end_idx] - index_begin;
+        std::vector<float> scale_buf;
+        if (scale_data) {
+          scale_buf.resize(index_size);
+          for (int64_t i = 0; i < index_size; i++) {
+            scale_buf[i] = static_cast<float>(scale_data[index_begin + i]);
+          }
+        }
+        std::vector<float> output_buf((end_idx - start_idx) * ddim);
+        caffe2::EmbeddingLookupIdx(
+            /*block_size=*/ddim,
+            /*output_size=*/end_idx - start_idx,
+            /*index_size=*/index_size,
+            /*data_size=*/weight.size(0),
+            /*input=*/weight_data,
+            /*indices=*/indices_data + index_begin,
+            /*offsets=*/bag_offsets + start_idx,
+            /*weights=*/scale_data ? scale_buf.data() : nullptr,
+            /*scale_bias=*/nullptr,
+            /*normalize_by_lengths=*/mode == MODE_MEAN,
+            /*out=*/output_buf.data());
+        at::Half* output_base = output_data + start_idx * ddim;
+        for (size_t i = 0; i < output_buf.size(); i++) {
+          output_base[i] = static_cast<at::Half>(output_buf[i]);
+        }
+      });
 }
 
-template<>
-void index_select_scale_add<float>(const Tensor &select_indices,
-                                          const Tensor &add_indices,
-                                          const Tensor &scale,
-                                          const Tensor &src,
-                                          Tensor &output,
-                                          const Tensor& offsets,
-                                          bool include_last_offset) {
-  int64_t ddim = src.size(1);
-  auto* scale_data = scale.data_ptr<float>();
-  auto* select_indices_data = select_indices.data_ptr<int64_t>();
-  auto* src_data = src.data_ptr<float>();
-  auto* output_data = output.data_ptr<float>();
-
-  if (isFastPathIndexSelectScale(src, scale, output)) {
-    int64_t output_size = offsets.numel() - 1;
-    auto* offsets_data = offsets.data_ptr<int64_t>();
-    std::vector<int64_t> offsets_include_last;
-
-    if (include_last_offset) {
-      output_size = offsets.numel() - 1;
-    } else {
-      output_size = offsets.numel();
-      offsets_include_last.resize(offsets.numel() + 1);
-      std::memcpy(
-          offsets_include_last.data(),
-          offsets.data_ptr<int64_t>(),
-          sizeof(int64_t) * offsets.numel());
-      offsets_include_last[offsets.numel()] = select_indices.numel();
-      offsets_data = offsets_include_last.data();
-    }
-
-#ifdef USE_FBGEMM
-    auto kernel_fp32_i64 =
-      fbgemm::GenerateEmbeddingSpMDM<float, int64_t, int64_t>(
-        /* block_size */ddim,
-        /* has_weight */true,
-        /* normalize_by_lengths */false,
-        /* prefetch */16,
-        /* is_weight_positional */false,
-        /* use_offsets */true
-      );
-#endif
-    at::parallel_for(
-        0, output_size, 1, [&](int64_t start_idx, int64_t end_idx) {
-#ifdef USE_FBGEMM
-          kernel_fp32_i64(
-            /* output_size */end_idx - start_idx,
-            /* index_size */offsets_data[end_idx] - offsets_data[start_idx],
-            /* data_size */src.size(0),
-            /* input */src_data,
-            /* indices */select_indices_data + offsets_data[start_idx],
-            /* offsets_or_lengths */offsets_data + start_idx,
-            /* weights */scale_data + offsets_data[start_idx],
-            /* output */output_data + start_idx * ddim);
-#else
-          caffe2::EmbeddingLookupIdx(
-              /*block_size=*/ddim,
-              /*output_size=*/end_idx - start_idx,
-              /*index_size=*/offsets_data[end_idx] - offsets_data[start_idx],
-              /*data_size=*/src.size(0),
-              /*input=*/src_data,
-              /*indices=*/select_indices_data + offsets_data[start_idx],
-              /*offsets=*/offsets_data + start_idx,
-              /*weights=*/scale_data + offsets_data[start_idx],
-              /*scale_bias=*/nullptr,
-              /*normalize_by_lengths=*/false,
-              /*out=*/output_data + start_idx * ddim);
-#endif
-        });
-  } else {
-    AT_ASSERT(select_indices.numel() == add_indices.numel());
-    auto* add_indices_data = add_indices.data_ptr<int64_t>();
-    auto src_stride0 = src.stride(0);
-    auto src_stride1 = src.stride(1);
-    auto output_stride0 = output.stride(0);
-    auto output_stride1 = output.stride(1);
-    auto scale_stride = scale.stride(0);
-    auto numel = add_indices.numel();
-
-
-    for (int64_t i = 0; i < numel; i++) {
-      auto* src_base = src_data + src_stride0 * select_indices_data[i];
-      auto* output_base = output_data + output_stride0 * add_indices_data[i];
-      auto scale = scale_data[i * scale_stride];
-      for (int64_t j = 0; j < ddim; j++) {
-        output_base[j * output_stride1] += src_base[j * src_stride1] * scale;
-      }
-    }
-  }
+// Max of the rows of `weight` in each bag, with the bags split across
+// threads. max_indices records the row each maximum was taken from.
+template <typename scalar_t>
+void embedding_bag_cpu_max(
+    const Tensor& weight,
+    const Tensor& indices,
+    const int64_t* bag_offsets,
+    int64_t num_bags,
+    Tensor& output,
+    Tensor& max_indices) {
+  const int64_t ddim = weight.size(1);
+  const int64_t num_weights = weight.size(0);
+  const auto* weight_data = weight.data_ptr<scalar_t>();
+  const auto weight_stride0 = weight.stride(0);
+  const auto weight_stride1 = weight.stride(1);
+  const auto* indices_data = indices.data_ptr<int64_t>();
+  auto* output_data = output.data_ptr<scalar_t>();
+  const auto output_stride0 = output.stride(0);
+  auto* max_indices_data = max_indices.data_ptr<int64_t>();
+  const auto max_indices_stride0 = max_indices.stride(0);
+
+  at::parallel_for(
+      0, num_bags, bag_grain_size(indices.numel(), num_bags, ddim),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t bag = begin; bag < end; bag++) {
+          scalar_t* output_row = output_data + output_stride0 * bag;
+          int64_t* max_indices_row = max_indices_data + max_indices_stride0 * bag;
+          const int64_t bag_begin = bag_offsets[bag];
+          const int64_t bag_end = bag_offsets[bag + 1];
+          if (bag_begin >= bag_end) {
+            // empty bags return all 0s, max_indices is zero-initialized
+            std::fill(output_row, output_row + ddim, static_cast<scalar_t>(0));
+            continue;
+          }
+          for (int64_t i = bag_begin; i < bag_end; i++) {
+            const int64_t idx = indices_data[i];
+            TORCH_CHECK(
+                idx >= 0 && idx < num_weights,
+                "embedding_bag: index ", idx, " is out of bounds for ",
+                num_weights, " embeddings");
+            const scalar_t* row = weight_data + weight_stride0 * idx;
+            if (i == bag_begin) {
+              for (int64_t j = 0; j < ddim; j++) {
+                output_row[j] = row[j * weight_stride1];
+                max_indices_row[j] = idx;
+              }
+              continue;
+            }
+            for (int64_t j = 0; j < ddim; j++) {
+              const scalar_t weight_item = row[j * weight_stride1];
+              if (weight_item > output_row[j]) {
+                output_row[j] = weight_item;
+                max_indices_row[j] = idx;
+              }
+            }
+          }
+        }
+      });
 }
 
 }  // namespace
@@ -315,26 +371,6 @@ static at::Tensor make_bag_size(
   return bag_size;
 }
 
-static Tensor apply_bag_size(const Tensor &offsets, const Tensor &indices,
-                             const int64_t mode, Tensor &output,
-                             const Tensor &bag_size) {
-  if (mode == MODE_MEAN) {
-    // Avoid dividing by 0 for empty bags.
-    // Instead we want empty bags to return all 0s
-    if (offsets.size(0) == 1) {
-      auto bag_size_ = std::max(indices.size(0), static_cast<int64_t>(1));
-      output /= bag_size_;
-    } else {
-      auto bag_size_ = at::max(bag_size, at::ones_like(bag_size, LEGACY_CONTIGUOUS_MEMORY_FORMAT))
-                           .to(output.options())
-                           .unsqueeze(1)
-                           .expand_as(output);
-      output /= bag_size_;
-    }
-  }
-  return output;
-}
-
 static Tensor apply_bag_size_backward(const Tensor &offsets,
                                       const Tensor &indices, const int64_t mode,
                                       Tensor &output, const Tensor &offset2bag,
@@ -354,50 +390,6 @@ static Tensor apply_bag_size_backward(const Tensor &offsets,
 }
 
 
-template <typename scalar_t>
-std::tuple<Tensor, Tensor, Tensor, Tensor> embedding_bag_cpu_max(
-    const Tensor& weight,
-    const Tensor& indices,
-    const Tensor& offset2bag,
-    const Tensor& output,
-    const Tensor& bag_size,
-    const Tensor& offsets) {
-
-    auto max_indices = at::zeros({offsets.size(0), weight.size(1)}, indices.options());
-
-    int64_t numel = indices.numel();
-    int64_t dims = weight.size(1);
-    auto* indices_data = indices.data_ptr<int64_t>();
-    auto* offset2bag_data = offset2bag.data_ptr<int64_t>();
-
-    auto* max_indices_data = max_indices.data_ptr<int64_t>();
-    auto max_indices_stride = max_indices.stride(0);
-
-    auto* weight_data = weight.data_ptr<scalar_t>();
-    auto* output_data = output.data_ptr<scalar_t>();
-    auto weight_stride0 = weight.stride(0);
-    auto weight_stride1 = weight.stride(1);
-    auto output_stride = output.stride(0);
-
-    for (int i = 0; i < numel; i++) {
-      auto bag = offset2bag_data[i];
-      auto word_idx = indices_data[i];
-
-      for (int dim = 0; dim < dims; dim++) {
-        auto& current_item = output_data[output_stride * bag + dim];
-        auto weight_item = weight_data[weight_stride0 * word_idx + dim * weight_stride1];
-        bool is_first_for_bag = (i == 0) || offset2bag_data[i - 1] != bag;
-
-        if (is_first_for_bag || weight_item > current_item) {
-          current_item = weight_item;
-          max_indices_data[max_indices_stride * bag + dim] = word_idx;
-        }
-      }
-    }
-
-    return std::tuple<Tensor, Tensor, Tensor, Tensor>(output, offset2bag, bag_size, max_indices);
-}
-
 // embedding_bag wrapper to enforce contiguity in tensors other than `weight`.
 // This is created to save extra `.contiguous()` call in backward.
 // See NOTE [ embedding_bag Native Functions ] in native_functions.yaml for details
@@ -423,7 +415,7 @@ _embedding_bag_cpu(const Tensor &weight, const Tensor &indices,
   auto offsets_arg = TensorArg(offsets, "offsets", 1);
   checkScalarType("embedding_bag", offsets_arg, kLong);
   auto weight_arg = TensorArg(weight, "weight", 1);
-  checkScalarTypes("embedding_bag", weight_arg, {kFloat, kDouble});
+  checkScalarTypes("embedding_bag", weight_arg, {kFloat, kDouble, kHalf, kBFloat16});
   int64_t offset_0 = offsets.data_ptr<int64_t>()[0];
   int64_t offset_n = offsets.data_ptr<int64_t>()[offsets.size(0)-1];
   TORCH_CHECK(offset_0 == 0, "offsets[0] has to be 0, i.e., the first sequence "
@@ -451,64 +443,36 @@ _embedding_bag_cpu(const Tensor &weight, const Tensor &indices,
         "include_last_offset: number of offset should be at least 1");
   }
 
-  auto output = at::empty(
-      {include_last_offset ? offsets.size(0) - 1 : offsets.size(0),
-       weight.size(1)},
-      weight.options());
+  const int64_t num_bags =
+      include_last_offset ? offsets.size(0) - 1 : offsets.size(0);
+  auto output = at::empty({num_bags, weight.size(1)}, weight.options());
 
-  // To save compute, if we are going to go down the fast path case for the 'sum'
-  // mode, we skip calculating offset2bag, since it is not going to be used.
-  auto fast_path_sum = [&weight, &per_sample_weights, &output]() {
-    if (per_sample_weights.defined()) {
-      return isFastPathIndexSelectScale(weight, per_sample_weights, output);
-    } else {
-      return isFastPathIndexSelect(weight, output);
-    }
-  };
+  std::vector<int64_t> bag_offsets_storage;
+  const int64_t* bag_offsets = bag_boundaries(
+      offsets, indices.numel(), include_last_offset, bag_offsets_storage);
 
-  // Use an empty 0-element tensor as a sentinel that we have skipped the
-  // creation of offset2bag because autograd chokes when trying to use an
-  // undefined tensor as an input to a backward op.
+  // The kernels below walk the bags through their offsets, so offset2bag is
+  // not needed in forward; the backward functions compute it when they are
+  // given an empty 0-element tensor. That tensor is used as the sentinel
+  // because autograd chokes when trying to use an undefined tensor as an
+  // input to a backward op.
   Tensor offset2bag = at::empty({0}, offsets.options());
-  if (mode == MODE_MEAN || mode == MODE_MAX || !fast_path_sum()) {
-    // If the last entries are empty, that the last offsets are irrelevant as they
-    // won't change anything in the assignment of ID -> bag, but index_add would
-    // throw out of bounds error. So to keep it simple we just add one more
-    // entry to the end then get rid of it after make_offset2bag.
-    offset2bag = at::zeros(
-       {indices.sizes()[0] + 1}, indices.options()); // offset2bag = [0 0 0 0 0]
-
-    make_offset2bag(offsets, indices, offset2bag);
-
-    offset2bag.resize_({indices.sizes()[0]});
-
-    // only initialize output in slow path
-    output.zero_();
-  }
 
   if (mode == MODE_MEAN || mode == MODE_SUM) {
-    AT_DISPATCH_FLOATING_TYPES(weight.scalar_type(), "embedding_bag_cpu", [&]() {
-      if (per_sample_weights.defined()) {
-        AT_ASSERT(mode == MODE_SUM);
-        index_select_scale_add<scalar_t>(
-            indices, offset2bag, per_sample_weights, weight, output, offsets, include_last_offset);
-      } else {
-        index_select_add<scalar_t>(indices, offset2bag, weight, output, offsets, include_last_offset);
-      }
-    });
-    auto ret = apply_bag_size(offsets, indices, mode, output, bag_size);
-    return std::tuple<Tensor, Tensor, Tensor, Tensor>(ret, offset2bag, bag_size, bag_size);
+    AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16,
+      weight.scalar_type(), "embedding_bag_cpu", [&]() {
+        embedding_bag_cpu_sum_mean<scalar_t>(
+            weight, indices, bag_offsets, num_bags, per_sample_weights, mode, output);
+      });
+    return std::tuple<Tensor, Tensor, Tensor, Tensor>(output, offset2bag, bag_size, bag_size);
   } else { // MODE_MAX
-    at::optional<Tensor> maybe_per_sample_weights;
-    if (per_sample_weights.defined()) {
-      maybe_per_sample_weights = per_sample_weights;
-    }
-    return AT_DISPATCH_FLOATING_TYPES_AND_HALF(
+    auto max_indices = at::zeros({offsets.size(0), weight.size(1)}, indices.options());
+    AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16,
       weight.scalar_type(), "embedding_bag_cpu_max", [&]() {
-        return embedding_bag_cpu_max<scalar_t>(
-            weight, indices, offset2bag, output, bag_size, offsets);
-      }
-    );
+        embedding_bag_cpu_max<scalar_t>(
+            weight, indices, bag_offsets, num_bags, output, max_indices);
+      });
+    return std::tuple<Tensor, Tensor, Tensor, Tensor>(output, offset2bag, bag_size, max_indices);
   }
 }
 
@@ -0,0 +1,406 @@
+// The slow route of the _foreach_* ops: the op is applied tensor by tensor.
+// It is used for CPU tensors, and for CUDA lists that cannot go through the
+// multi-tensor kernels of cuda/ForeachOps.cu (see can_use_fast_route).
+//
+// The Adam, SGD and Adagrad steps of a contiguous floating point CPU parameter
+// are done in a single parallel pass over the parameter, its gradient and its
+// state instead of one pass per op.
+//
+// The total norm of a list is the norm of the norms of its tensors, which is
+// what clip_grad_norm_ used to compute.
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/ForeachUtils.h>
+
+#include <cmath>
+
+namespace at {
+namespace native {
+
+#define FOREACH_BINARY_OP_SCALAR(OP)                                          \
+void foreach_tensor_##OP##_scalar_kernel_slow_(TensorList tensors, Scalar scalar) { \
+  check_foreach_api_restrictions(tensors);                                    \
+  for (const auto& t : tensors) {                                             \
+    t.OP##_(scalar);                                                          \
+  }                                                                           \
+}                                                                             \
+                                                                              \
+std::vector<Tensor> foreach_tensor_##OP##_scalar_kernel_slow(TensorList tensors, Scalar scalar) { \
+  check_foreach_api_restrictions(tensors);                                    \
+  std::vector<Tensor> result;                                                 \
+  result.reserve(tensors.size());                                             \
+  for (const auto& t : tensors) {                                             \
+    result.emplace_back(t.OP(scalar));                                        \
+  }                                                                           \
+  return result;                                                              \
+}
+
+FOREACH_BINARY_OP_SCALAR(add)
+FOREACH_BINARY_OP_SCALAR(mul)
+
+void foreach_tensor_add_list_kernel_slow_(TensorList self, TensorList other, Scalar alpha) {
+  check_foreach_api_restrictions(self, other);
+  for (size_t i = 0; i < self.size(); i++) {
+    self[i].add_(other[i], alpha);
+  }
+}
+
+std::vector<Tensor> foreach_tensor_add_list_kernel_slow(TensorList tensors1, TensorList tensors2, Scalar alpha) {
+  check_foreach_api_restrictions(tensors1, tensors2);
+  std::vector<Tensor> result;
+  result.reserve(tensors1.size());
+  for (size_t i = 0; i < tensors1.size(); i++) {
+    result.emplace_back(tensors1[i].add(tensors2[i], alpha));
+  }
+  return result;
+}
+
+void foreach_tensor_mul_list_kernel_slow_(TensorList self, TensorList other) {
+  check_foreach_api_restrictions(self, other);
+  for (size_t i = 0; i < self.size(); i++) {
+    self[i].mul_(other[i]);
+  }
+}
+
+std::vector<Tensor> foreach_tensor_mul_list_kernel_slow(TensorList tensors1, TensorList tensors2) {
+  check_foreach_api_restrictions(tensors1, tensors2);
+  std::vector<Tensor> result;
+  result.reserve(tensors1.size());
+  for (size_t i = 0; i < tensors1.size(); i++) {
+    result.emplace_back(tensors1[i].mul(tensors2[i]));
+  }
+  return result;
+}
+
+#define FOREACH_POINTWISE_OP(OP)                                              \
+void foreach_tensor_##OP##_kernel_slow_(TensorList self, TensorList tensors1, TensorList tensors2, Scalar value) { \
+  check_foreach_api_restrictions(self, tensors1, tensors2);                   \
+  for (size_t i = 0; i < self.size(); i++) {                                  \
+    self[i].OP##_(tensors1[i], tensors2[i], value);                           \
+  }                                                                           \
+}
+
+FOREACH_POINTWISE_OP(addcmul)
+FOREACH_POINTWISE_OP(addcdiv)
+
+namespace {
+
+bool is_contiguous_cpu_step(const Tensor& param, TensorList state) {
+  if (!param.device().is_cpu() || param.layout() != at::kStrided ||
+      !param.is_contiguous() ||
+      (param.scalar_type() != at::kFloat && param.scalar_type() != at::kDouble)) {
+    return false;
+  }
+  for (const auto& t : state) {
+    if (t.defined() &&
+        (!t.device().is_cpu() || t.layout() != at::kStrided ||
+         !t.is_contiguous() || t.scalar_type() != param.scalar_type())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename scalar_t>
+void adam_step_contiguous(
+    const Tensor& param,
+    const Tensor& grad,
+    const Tensor& exp_avg,
+    const Tensor& exp_avg_sq,
+    const Tensor& max_exp_avg_sq,
+    double step_size,
+    double bias_correction2_sqrt,
+    double beta1,
+    double beta2,
+    double weight_decay,
+    double eps,
+    bool amsgrad) {
+  auto* param_data = param.data_ptr<scalar_t>();
+  const auto* grad_data = grad.data_ptr<scalar_t>();
+  auto* exp_avg_data = exp_avg.data_ptr<scalar_t>();
+  auto* exp_avg_sq_data = exp_avg_sq.data_ptr<scalar_t>();
+  auto* max_exp_avg_sq_data = amsgrad ? max_exp_avg_sq.data_ptr<scalar_t>() : nullptr;
+
+  const auto beta1_ = static_cast<scalar_t>(beta1);
+  const auto beta2_ = static_cast<scalar_t>(beta2);
+  const auto weight_decay_ = static_cast<scalar_t>(weight_decay);
+  const auto eps_ = static_cast<scalar_t>(eps);
+  const auto step_size_ = static_cast<scalar_t>(step_size);
+  const auto bias_correction2_sqrt_ = static_cast<scalar_t>(bias_correction2_sqrt);
+
+  at::parallel_for(0, param.numel(), at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      scalar_t grad_val = grad_data[i];
+      if (weight_decay_ != 0) {
+        grad_val += param_data[i] * weight_decay_;
+      }
+      const scalar_t m = exp_avg_data[i] * beta1_ + grad_val * (1 - beta1_);
+      scalar_t v = exp_avg_sq_data[i] * beta2_ + grad_val * grad_val * (1 - beta2_);
+      exp_avg_data[i] = m;
+      exp_avg_sq_data[i] = v;
+      if (amsgrad) {
+        // same NaN propagation as at::max
+        if (v > max_exp_avg_sq_data[i] || std::isnan(v)) {
+          max_exp_avg_sq_data[i] = v;
+        }
+        v = max_exp_avg_sq_data[i];
+      }
+      const scalar_t denom = std::sqrt(v) / bias_correction2_sqrt_ + eps_;
+      param_data[i] -= step_size_ * (m / denom);
+    }
+  });
+}
+
+template <typename scalar_t>
+void sgd_step_contiguous(
+    const Tensor& param,
+    const Tensor& grad,
+    const Tensor& momentum_buffer,
+    double lr,
+    double momentum,
+    double dampening,
+    double weight_decay,
+    bool nesterov) {
+  auto* param_data = param.data_ptr<scalar_t>();
+  const auto* grad_data = grad.data_ptr<scalar_t>();
+  auto* buf_data = momentum != 0 ? momentum_buffer.data_ptr<scalar_t>() : nullptr;
+
+  const auto lr_ = static_cast<scalar_t>(lr);
+  const auto momentum_ = static_cast<scalar_t>(momentum);
+  const auto dampening_ = static_cast<scalar_t>(dampening);
+  const auto weight_decay_ = static_cast<scalar_t>(weight_decay);
+
+  at::parallel_for(0, param.numel(), at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      scalar_t d_p = grad_data[i];
+      if (weight_decay_ != 0) {
+        d_p += param_data[i] * weight_decay_;
+      }
+      if (momentum_ != 0) {
+        const scalar_t buf = buf_data[i] * momentum_ + d_p * (1 - dampening_);
+        buf_data[i] = buf;
+        d_p = nesterov ? d_p + buf * momentum_ : buf;
+      }
+      param_data[i] -= d_p * lr_;
+    }
+  });
+}
+
+template <typename scalar_t>
+void adagrad_step_contiguous(
+    const Tensor& param,
+    const Tensor& grad,
+    const Tensor& state_sum,
+    double clr,
+    double weight_decay,
+    double eps) {
+  auto* param_data = param.data_ptr<scalar_t>();
+  const auto* grad_data = grad.data_ptr<scalar_t>();
+  auto* sum_data = state_sum.data_ptr<scalar_t>();
+
+  const auto clr_ = static_cast<scalar_t>(clr);
+  const auto weight_decay_ = static_cast<scalar_t>(weight_decay);
+  const auto eps_ = static_cast<scalar_t>(eps);
+
+  at::parallel_for(0, param.numel(), at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      scalar_t grad_val = grad_data[i];
+      if (weight_decay_ != 0) {
+        grad_val += param_data[i] * weight_decay_;
+      }
+      const scalar_t sum = sum_data[i] + grad_val * grad_val;
+      sum_data[i] = sum;
+      param_data[i] -= clr_ * (grad_val / (std::sqrt(sum) + eps_));
+    }
+  });
+}
+
+} // anonymous namespace
+
+void foreach_fused_adam_kernel_slow_(
+    TensorList self,
+    TensorList grads,
+    TensorList exp_avgs,
+    TensorList exp_avg_sqs,
+    TensorList max_exp_avg_sqs,
+    IntArrayRef steps,
+    double lr,
+    double beta1,
+    double beta2,
+    double weight_decay,
+    double eps,
+    bool amsgrad) {
+  check_foreach_api_restrictions(self, grads, exp_avgs);
+  check_foreach_api_restrictions(self, exp_avg_sqs);
+  if (amsgrad) {
+    check_foreach_api_restrictions(self, max_exp_avg_sqs);
+  }
+  TORCH_CHECK(
+      steps.size() == self.size(),
+      "_fused_adam_: expected ", self.size(), " steps, got ", steps.size());
+
+  for (size_t i = 0; i < self.size(); i++) {
+    const auto& param = self[i];
+    const auto& exp_avg = exp_avgs[i];
+    const auto& exp_avg_sq = exp_avg_sqs[i];
+    Tensor max_exp_avg_sq = amsgrad ? max_exp_avg_sqs[i] : Tensor();
+
+    const double bias_correction1 = 1 - std::pow(beta1, steps[i]);
+    const double bias_correction2 = 1 - std::pow(beta2, steps[i]);
+    const double step_size = lr / bias_correction1;
+
+    if (is_contiguous_cpu_step(param, {grads[i], exp_avg, exp_avg_sq, max_exp_avg_sq})) {
+      AT_DISPATCH_FLOATING_TYPES(param.scalar_type(), "_fused_adam_", [&] {
+        adam_step_contiguous<scalar_t>(
+            param, grads[i], exp_avg, exp_avg_sq, max_exp_avg_sq,
+            step_size, std::sqrt(bias_correction2),
+            beta1, beta2, weight_decay, eps, amsgrad);
+      });
+      continue;
+    }
+
+    auto grad = grads[i];
+    if (weight_decay != 0) {
+      grad = grad.add(param, weight_decay);
+    }
+    exp_avg.mul_(beta1).add_(grad, 1 - beta1);
+    exp_avg_sq.mul_(beta2).addcmul_(grad, grad, 1 - beta2);
+    Tensor denom;
+    if (amsgrad) {
+      at::max_out(max_exp_avg_sq, exp_avg_sq, max_exp_avg_sq);
+      denom = (max_exp_avg_sq.sqrt() / std::sqrt(bias_correction2)).add_(eps);
+    } else {
+      denom = (exp_avg_sq.sqrt() / std::sqrt(bias_correction2)).add_(eps);
+    }
+    param.addcdiv_(exp_avg, denom, -step_size);
+  }
+}
+
+void foreach_fused_sgd_kernel_slow_(
+    TensorList self,
+    TensorList grads,
+    TensorList momentum_buffers,
+    double lr,
+    double momentum,
+    double dampening,
+    double weight_decay,
+    bool nesterov) {
+  check_foreach_api_restrictions(self, grads);
+  if (momentum != 0) {
+    check_foreach_api_restrictions(self, momentum_buffers);
+  }
+
+  for (size_t i = 0; i < self.size(); i++) {
+    const auto& param = self[i];
+    Tensor buf = momentum != 0 ? momentum_buffers[i] : Tensor();
+
+    if (is_contiguous_cpu_step(param, {grads[i], buf})) {
+      AT_DISPATCH_FLOATING_TYPES(param.scalar_type(), "_fused_sgd_", [&] {
+        sgd_step_contiguous<scalar_t>(
+            param, grads[i], buf, lr, momentum, dampening, weight_decay, nesterov);
+      });
+      continue;
+    }
+
+    auto d_p = grads[i];
+    if (weight_decay != 0) {
+      d_p = d_p.add(param, weight_decay);
+    }
+    if (momentum != 0) {
+      buf.mul_(momentum).add_(d_p, 1 - dampening);
+      if (nesterov) {
+        d_p = d_p.add(buf, momentum);
+      } else {
+        d_p = buf;
+      }
+    }
+    param.add_(d_p, -lr);
+  }
+}
+
+void foreach_fused_adagrad_kernel_slow_(
+    TensorList self,
+    TensorList grads,
+    TensorList state_sums,
+    IntArrayRef steps,
+    double lr,
+    double lr_decay,
+    double weight_decay,
+    double eps) {
+  check_foreach_api_restrictions(self, grads, state_sums);
+  TORCH_CHECK(
+      steps.size() == self.size(),
+      "_fused_adagrad_: expected ", self.size(), " steps, got ", steps.size());
+
+  for (size_t i = 0; i < self.size(); i++) {
+    const auto& param = self[i];
+    const auto& state_sum = state_sums[i];
+    const double clr = lr / (1 + (steps[i] - 1) * lr_decay);
+
+    if (is_contiguous_cpu_step(param, {grads[i], state_sum})) {
+      AT_DISPATCH_FLOATING_TYPES(param.scalar_type(), "_fused_adagrad_", [&] {
+        adagrad_step_contiguous<scalar_t>(
+            param, grads[i], state_sum, clr, weight_decay, eps);
+      });
+      continue;
+    }
+
+    auto grad = grads[i];
+    if (weight_decay != 0) {
+      grad = grad.add(param, weight_decay);
+    }
+    state_sum.addcmul_(grad, grad, 1.0);
+    param.addcdiv_(grad, state_sum.sqrt().add_(eps), -clr);
+  }
+}
+
+Tensor foreach_total_norm_kernel_slow(TensorList tensors, double norm_type) {
+  check_foreach_api_restrictions(tensors);
+  const auto& first = tensors[0];
+  std::vector<Tensor> norms;
+  norms.reserve(tensors.size());
+  for (const auto& t : tensors) {
+    // The norms are combined in double, on the device of the first tensor.
+    if (t.numel() > 0) {
+      norms.push_back(at::norm(t, norm_type).to(first.device(), kDouble));
+    }
+  }
+  const auto options = first.options().layout(kStrided);
+  if (norms.empty()) {
+    return at::zeros({}, options);
+  }
+  return at::norm(at::stack(norms), norm_type).to(options.dtype());
+}
+
+void foreach_clip_by_total_norm_kernel_slow_(
+    TensorList self,
+    const Tensor& total_norm,
+    double max_norm) {
+  check_foreach_api_restrictions(self);
+  TORCH_CHECK(
+      total_norm.numel() == 1,
+      "_foreach_clip_by_total_norm_: expected a total_norm with one element, got ",
+      total_norm.numel());
+
+  if (total_norm.device().is_cpu()) {
+    const double clip_coef = max_norm / (total_norm.item<double>() + 1e-6);
+    if (clip_coef < 1) {
+      for (const auto& t : self) {
+        t.mul_(clip_coef);
+      }
+    }
+    return;
+  }
+  // The coefficient stays on the device, so the tensors are always scaled.
+  const auto clip_coef =
+      at::reciprocal(total_norm.reshape({}) + 1e-6).mul_(max_norm).clamp_max_(1);
+  for (const auto& t : self) {
+    t.mul_(clip_coef);
+  }
+}
+
+} // namespace native
+} // namespace at
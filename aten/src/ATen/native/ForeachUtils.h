@@ -0,0 +1,58 @@
+#pragma once
+
+#include <ATen/ATen.h>
+
+namespace at {
+namespace native {
+
+// The _foreach_* ops apply a pointwise op to every tensor of one or more
+// lists of tensors. The lists are processed tensor by tensor with the regular
+// ops ("slow route"), or, on CUDA, by a few chunked multi-tensor kernel
+// launches for the whole list ("fast route", see cuda/MultiTensorApply.cuh).
+
+inline void check_foreach_api_restrictions(TensorList tensors) {
+  TORCH_CHECK(tensors.size() > 0, "Tensor list must have at least one tensor.");
+}
+
+inline void check_foreach_api_restrictions(TensorList tensors1, TensorList tensors2) {
+  check_foreach_api_restrictions(tensors1);
+  TORCH_CHECK(
+      tensors1.size() == tensors2.size(),
+      "Tensor lists must have the same number of tensors, got ",
+      tensors1.size(), " and ", tensors2.size());
+  for (size_t i = 0; i < tensors1.size(); i++) {
+    TORCH_CHECK(
+        tensors1[i].sizes() == tensors2[i].sizes(),
+        "Corresponding tensors in lists must have the same size, got ",
+        tensors1[i].sizes(), " and ", tensors2[i].sizes(), " at index ", i);
+  }
+}
+
+inline void check_foreach_api_restrictions(TensorList tensors1, TensorList tensors2, TensorList tensors3) {
+  check_foreach_api_restrictions(tensors1, tensors2);
+  check_foreach_api_restrictions(tensors1, tensors3);
+}
+
+// Whether the tensors of all the lists can go through the fast route: strided
+// contiguous tensors of a single floating point dtype on a single device. The
+// lists are expected to have passed check_foreach_api_restrictions.
+inline bool can_use_fast_route(ArrayRef<TensorList> tensor_lists) {
+  const auto& first = tensor_lists[0][0];
+  const auto device = first.device();
+  const auto dtype = first.scalar_type();
+  if (!at::isFloatingType(dtype) || dtype == at::kBFloat16) {
+    return false;
+  }
+  for (const auto& tensors : tensor_lists) {
+    for (const auto& t : tensors) {
+      if (t.layout() != at::kStrided || t.device() != device ||
+          t.scalar_type() != dtype || !t.is_contiguous()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+} // namespace native
+} // namespace at
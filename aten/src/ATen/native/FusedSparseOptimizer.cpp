@@ -0,0 +1,227 @@
+// Optimizer steps for rows of a 2-dimensional parameter, e.g. an embedding
+// table, from the gradients of the rows that were used, given as
+// (indices, values) like the uncoalesced sparse gradient produced by
+// embedding / embedding_bag backward.
+//
+// The rows may be repeated in `indices`. The gradients of a row are summed
+// before its update, as if the gradient had been coalesced, and the updates
+// are done in one parallel pass over the distinct rows.
+
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+
+#include <caffe2/perfkernels/adagrad.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace at {
+namespace native {
+
+namespace {
+
+void check_row_update_args(
+    const char* name,
+    const Tensor& self,
+    const Tensor& indices,
+    const Tensor& values) {
+  TORCH_CHECK(
+      self.device().is_cpu() && indices.device().is_cpu() &&
+          values.device().is_cpu(),
+      name, ": only CPU tensors are supported");
+  TORCH_CHECK(self.dim() == 2, name, ": expected a 2-dimensional parameter");
+  TORCH_CHECK(
+      self.is_contiguous(), name, ": expected a contiguous parameter");
+  TORCH_CHECK(
+      indices.dim() == 1 && indices.scalar_type() == at::kLong,
+      name, ": expected 1-dimensional int64 indices");
+  TORCH_CHECK(
+      values.dim() == 2 && values.size(0) == indices.size(0) &&
+          values.size(1) == self.size(1),
+      name, ": expected gradient values of size [", indices.size(0), ", ",
+      self.size(1), "], got ", values.sizes());
+  TORCH_CHECK(
+      values.scalar_type() == self.scalar_type(),
+      name, ": expected gradient values of type ", self.scalar_type(),
+      ", got ", values.scalar_type());
+}
+
+// Positions of `indices` ordered by row, and the positions in `order` at which
+// the runs of each distinct row start (with the end appended).
+void group_by_row(
+    const Tensor& indices,
+    int64_t num_rows,
+    std::vector<int64_t>& order,
+    std::vector<int64_t>& group_starts) {
+  const int64_t nnz = indices.numel();
+  const auto* indices_data = indices.data_ptr<int64_t>();
+  for (int64_t i = 0; i < nnz; i++) {
+    TORCH_CHECK(
+        indices_data[i] >= 0 && indices_data[i] < num_rows,
+        "index ", indices_data[i], " is out of bounds for ", num_rows, " rows");
+  }
+  order.resize(nnz);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int64_t a, int64_t b) {
+    return indices_data[a] < indices_data[b];
+  });
+  group_starts.clear();
+  for (int64_t i = 0; i < nnz; i++) {
+    if (i == 0 || indices_data[order[i]] != indices_data[order[i - 1]]) {
+      group_starts.push_back(i);
+    }
+  }
+  group_starts.push_back(nnz);
+}
+
+// Calls f(row, grad) for every distinct row, in parallel. `grad` points to
+// the gradient of the row: the only gradient value if the row is used once,
+// otherwise the sum of them in a buffer of the calling thread.
+template <typename scalar_t, typename F>
+void for_each_row_gradient(
+    const Tensor& indices,
+    const Tensor& values,
+    int64_t num_rows,
+    const F& f) {
+  std::vector<int64_t> order;
+  std::vector<int64_t> group_starts;
+  group_by_row(indices, num_rows, order, group_starts);
+  const int64_t num_groups = group_starts.size() - 1;
+  const int64_t dim = values.size(1);
+  const auto* indices_data = indices.data_ptr<int64_t>();
+  const auto* values_data = values.data_ptr<scalar_t>();
+
+  at::parallel_for(
+      0,
+      num_groups,
+      std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(dim, 1)),
+      [&](int64_t begin, int64_t end) {
+        std::vector<scalar_t> grad_buffer;
+        for (int64_t group = begin; group < end; group++) {
+          const int64_t first = group_starts[group];
+          const int64_t last = group_starts[group + 1];
+          const int64_t row = indices_data[order[first]];
+          const scalar_t* grad = values_data + order[first] * dim;
+          if (last - first > 1) {
+            grad_buffer.assign(grad, grad + dim);
+            for (int64_t i = first + 1; i < last; i++) {
+              const scalar_t* other = values_data + order[i] * dim;
+              for (int64_t j = 0; j < dim; j++) {
+                grad_buffer[j] += other[j];
+              }
+            }
+            grad = grad_buffer.data();
+          }
+          f(row, grad);
+        }
+      });
+}
+
+template <typename scalar_t>
+void adagrad_row_update(
+    int64_t dim,
+    scalar_t* w,
+    const scalar_t* g,
+    scalar_t* h,
+    double lr,
+    double eps) {
+  for (int64_t j = 0; j < dim; j++) {
+    h[j] += g[j] * g[j];
+    w[j] -= lr * g[j] / (std::sqrt(h[j]) + eps);
+  }
+}
+
+template <>
+void adagrad_row_update<float>(
+    int64_t dim,
+    float* w,
+    const float* g,
+    float* h,
+    double lr,
+    double eps) {
+  // nw and nh may alias w and h
+  caffe2::adagrad_update(
+      dim, w, g, h, w, h, eps, /*decay=*/1.0f, -static_cast<float>(lr));
+}
+
+} // namespace
+
+Tensor& _fused_sparse_adagrad_(
+    Tensor& self,
+    Tensor& state_sum,
+    const Tensor& indices_,
+    const Tensor& values_,
+    double lr,
+    double eps) {
+  check_row_update_args("_fused_sparse_adagrad_", self, indices_, values_);
+  // a state of the size of self is regular Adagrad, one value per row is
+  // row-wise Adagrad
+  const bool rowwise = state_sum.dim() == 1;
+  TORCH_CHECK(
+      state_sum.sizes() == self.sizes() ||
+          (rowwise && state_sum.size(0) == self.size(0)),
+      "_fused_sparse_adagrad_: expected state_sum of size ", self.sizes(),
+      " or [", self.size(0), "], got ", state_sum.sizes());
+  TORCH_CHECK(
+      state_sum.is_contiguous() &&
+          state_sum.scalar_type() == self.scalar_type(),
+      "_fused_sparse_adagrad_: expected a contiguous state_sum of type ",
+      self.scalar_type());
+  const auto indices = indices_.contiguous();
+  const auto values = values_.contiguous();
+  const int64_t dim = self.size(1);
+
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "_fused_sparse_adagrad_", [&] {
+    auto* w_data = self.data_ptr<scalar_t>();
+    auto* h_data = state_sum.data_ptr<scalar_t>();
+    for_each_row_gradient<scalar_t>(
+        indices, values, self.size(0), [&](int64_t row, const scalar_t* g) {
+          scalar_t* w = w_data + row * dim;
+          if (!rowwise) {
+            adagrad_row_update<scalar_t>(dim, w, g, h_data + row * dim, lr, eps);
+            return;
+          }
+          scalar_t sum_squares = 0;
+          for (int64_t j = 0; j < dim; j++) {
+            sum_squares += g[j] * g[j];
+          }
+          scalar_t& h = h_data[row];
+          h += dim > 0 ? sum_squares / dim : 0;
+          const scalar_t step = lr / (std::sqrt(h) + eps);
+          for (int64_t j = 0; j < dim; j++) {
+            w[j] -= step * g[j];
+          }
+        });
+  });
+  return self;
+}
+
+Tensor& _fused_sparse_sgd_(
+    Tensor& self,
+    const Tensor& indices_,
+    const Tensor& values_,
+    double lr) {
+  check_row_update_args("_fused_sparse_sgd_", self, indices_, values_);
+  const auto indices = indices_.contiguous();
+  const auto values = values_.contiguous();
+  const int64_t dim = self.size(1);
+
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "_fused_sparse_sgd_", [&] {
+    auto* w_data = self.data_ptr<scalar_t>();
+    const auto step = static_cast<scalar_t>(lr);
+    for_each_row_gradient<scalar_t>(
+        indices, values, self.size(0), [&](int64_t row, const scalar_t* g) {
+          scalar_t* w = w_data + row * dim;
+          for (int64_t j = 0; j < dim; j++) {
+            w[j] -= step * g[j];
+          }
+        });
+  });
+  return self;
+}
+
+} // namespace native
+} // namespace at
@@ -1,5 +1,8 @@
 #include <ATen/ATen.h>
+#include <ATen/Config.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/NestedTensorUtils.h>
+#include <ATen/native/mkldnn/Utils.h>
 #include <ATen/native/xnnpack/Engine.h>
 #include <ATen/WrapDimUtilsMulti.h>
 #include <c10/macros/Macros.h>
@@ -13,10 +16,49 @@
 
 namespace at { namespace native {
 
+namespace {
+
+// Whether to run a dense bfloat16 linear with the inner product primitive of
+// MKL-DNN rather than with addmm, which has no bfloat16 BLAS to call. There is
+// no backward for mkldnn_linear, so it is taken for inference only.
+bool use_mkldnn_bf16_linear(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias) {
+#if AT_MKLDNN_ENABLED()
+  return at::globalContext().userEnabledMkldnn() &&
+      input.device().is_cpu() && input.layout() == kStrided &&
+      input.scalar_type() == kBFloat16 && input.dim() >= 2 &&
+      weight.device().is_cpu() && weight.layout() == kStrided &&
+      weight.scalar_type() == kBFloat16 && weight.dim() == 2 &&
+      (!bias.defined() ||
+       (bias.device().is_cpu() && bias.layout() == kStrided &&
+        bias.scalar_type() == kBFloat16)) &&
+      !input.requires_grad() && !weight.requires_grad() &&
+      !(bias.defined() && bias.requires_grad()) &&
+      mkldnn_bf16_device_check();
+#else
+  return false;
+#endif
+}
+
+} // namespace
+
 Tensor linear(const Tensor& input, const Tensor& weight, const Tensor& bias) {
   if (input.is_mkldnn()) {
     return at::mkldnn_linear(input, weight, bias);
   }
+  if (input.is_nested()) {
+    // Only the rows of the entries are multiplied, never the padding.
+    return at::nested::nested_like(
+        input, at::linear(at::nested::get_nested_impl(input)->buffer(), weight, bias));
+  }
+  if (use_mkldnn_bf16_linear(input, weight, bias)) {
+    return at::mkldnn_linear(
+        input.contiguous(),
+        weight.contiguous(),
+        bias.defined() ? bias.contiguous() : bias);
+  }
 // Disable the xnnpack operators for both iOS and macOS temporarily due to the crash in pthreadpool
 // TODO:T66297472 remove `!defined(__APPLE__)` once we figure out the root cause of the crash.
 #if defined(C10_MOBILE) && !defined(__APPLE__)
@@ -35,6 +77,16 @@ Tensor linear(const Tensor& input, const Tensor& weight, const Tensor& bias) {
   return output;
 }
 
+Tensor _linear_relu(const Tensor& input, const Tensor& weight, const Tensor& bias) {
+// See the comment on xnnpack in linear above.
+#if defined(C10_MOBILE) && !defined(__APPLE__)
+  if (xnnpack::use_linear(input, weight, bias, /*output_min=*/0.f)) {
+    return xnnpack::linear(input, weight, bias, /*output_min=*/0.f);
+  }
+#endif
+  return at::linear(input, weight, bias).relu_();
+}
+
 // sumproduct_pair computes `(left*right).sum(sumdims)` by means of permutation and
 // batch matrix multiplication
 // its main purpose is to provide a pairwise reduction for einsum
@@ -195,6 +195,40 @@ Tensor& addmm_cpu_out(Tensor &result, const Tensor& self, const Tensor& mat1, co
   return legacy::cpu::_th_addmm_out(result, b_self, mat1, mat2, beta, alpha);
 }
 
+// One matrix of baddbmm_cpu_kernel for rows of result and mat2 that are
+// contiguous, in i-k-j order so that the innermost loop runs along contiguous
+// rows. kCols > 0 fixes the number of columns at compile time, so that the
+// row of result is kept in registers for the small sizes.
+template <typename scalar_t, bool is_bmm, int64_t kCols>
+inline void baddbmm_cpu_matrix(
+    scalar_t* r, const scalar_t* s, const scalar_t* m,
+    int64_t is, int64_t js_, int64_t ks,
+    int64_t r_stride, int64_t s_stride0, int64_t s_stride1, int64_t m_stride,
+    scalar_t alpha, scalar_t beta) {
+  const int64_t js = kCols > 0 ? kCols : js_;
+  for (int64_t i = 0; i < is; i++) {
+    scalar_t* r_row = r + i * r_stride;
+    const scalar_t* s_row = s + i * s_stride0;
+    scalar_t acc[kCols > 0 ? kCols : 1];
+    scalar_t* out = kCols > 0 ? acc : r_row;
+    for (int64_t j = 0; j < js; j++) {
+      out[j] = is_bmm ? scalar_t(0) : r_row[j] * beta;
+    }
+    for (int64_t k = 0; k < ks; k++) {
+      const scalar_t a = is_bmm ? s_row[k * s_stride1] : alpha * s_row[k * s_stride1];
+      const scalar_t* m_row = m + k * m_stride;
+      for (int64_t j = 0; j < js; j++) {
+        out[j] += a * m_row[j];
+      }
+    }
+    if (kCols > 0) {
+      for (int64_t j = 0; j < js; j++) {
+        r_row[j] = acc[j];
+      }
+    }
+  }
+}
+
 template <typename scalar_t, bool is_bmm>
 inline void baddbmm_cpu_kernel(const Tensor& result, const Tensor& self, const Tensor& mat2, Scalar beta_, Scalar alpha_) {
   int64_t bs = result.size(0);
@@ -205,11 +239,37 @@ inline void baddbmm_cpu_kernel(const Tensor& result, const Tensor& self, const T
   scalar_t alpha = alpha_.to<scalar_t>();
   scalar_t beta = beta_.to<scalar_t>();
 
+  int64_t grain_size = std::max(internal::GRAIN_SIZE / (is * js * ks), (int64_t)1);
+
+  if (result.stride(2) == 1 && mat2.stride(2) == 1) {
+    auto r0 = result.data_ptr<scalar_t>();
+    auto s0 = self.data_ptr<scalar_t>();
+    auto m0 = mat2.data_ptr<scalar_t>();
+    auto matrix = &baddbmm_cpu_matrix<scalar_t, is_bmm, 0>;
+    switch (js) {
+      case 2: matrix = &baddbmm_cpu_matrix<scalar_t, is_bmm, 2>; break;
+      case 3: matrix = &baddbmm_cpu_matrix<scalar_t, is_bmm, 3>; break;
+      case 4: matrix = &baddbmm_cpu_matrix<scalar_t, is_bmm, 4>; break;
+      case 8: matrix = &baddbmm_cpu_matrix<scalar_t, is_bmm, 8>; break;
+      case 16: matrix = &baddbmm_cpu_matrix<scalar_t, is_bmm, 16>; break;
+      case 32: matrix = &baddbmm_cpu_matrix<scalar_t, is_bmm, 32>; break;
+    }
+    parallel_for(0, bs, grain_size, [&](int64_t b_begin, int64_t b_end) {
+        for (int64_t b = b_begin; b < b_end; b++) {
+          matrix(
+              r0 + b * result.stride(0), s0 + b * self.stride(0), m0 + b * mat2.stride(0),
+              is, js, ks,
+              result.stride(1), self.stride(1), self.stride(2), mat2.stride(1),
+              alpha, beta);
+        }
+      });
+    return;
+  }
+
   auto r0 = result.accessor<scalar_t, 3>();
   auto s0 = self.accessor<scalar_t, 3>();
   auto m0 = mat2.accessor<scalar_t, 3>();
 
-  int64_t grain_size = std::min(internal::GRAIN_SIZE / (is * js * ks), (int64_t)1);
   parallel_for(0, bs, grain_size, [&](int64_t b_begin, int64_t b_end) {
       for (int64_t b = b_begin; b < b_end; b++) {
         auto r1 = r0[b];
@@ -239,7 +299,9 @@ inline void baddbmm_cpu_kernel(const Tensor& result, const Tensor& self, const T
 
 // This tries to apply some optimizations to bmm/baddbmm:
 // - When the operand size is small, computation are parallelized over the batch
-//   dimension using OMP and naive matrix multiplication is applied.
+//   dimension using OMP and naive matrix multiplication is applied. Without
+//   MKL, this is also done for matrices of up to 32x32, for which the calls of
+//   one BLAS gemm per matrix cost more than the computation.
 // - When the operand size is larger than the threshold, if compiled with MKL, MKL's batch gemm is used.
 // - Otherwise, we use a series of matrix multiplications.
 // The threshold of 400 for the first has not been thoroughly benchmarked yet and may have room for further
@@ -288,7 +350,11 @@ static inline Tensor& bmm_out_or_baddbmm_(Tensor& self_or_result, const Tensor&
             || (t.stride(1) == 1 && t.stride(2) >= t.size(1));
   };
 
-  if (contraction_size * res_rows * res_cols < 400) {
+  const int64_t matrix_cost = contraction_size * res_rows * res_cols;
+  // bfloat16 takes the split path, whose addmm accumulates in float.
+  const bool is_bfloat16 = self_or_result.scalar_type() == kBFloat16;
+  if (!is_bfloat16 && (matrix_cost < 400 ||
+      (!at::hasMKL() && matrix_cost <= 32 * 32 * 32 && bs > 1))) {
     if (is_bmm_out) {
       AT_DISPATCH_ALL_TYPES(batch1.scalar_type(), "bmm", [&] {
           baddbmm_cpu_kernel<scalar_t, true>(self_or_result, batch1, batch2, beta, alpha);
@@ -298,7 +364,7 @@ static inline Tensor& bmm_out_or_baddbmm_(Tensor& self_or_result, const Tensor&
           baddbmm_cpu_kernel<scalar_t, false>(self_or_result, batch1, batch2, beta, alpha);
         });
     }
-  } else if (at::hasMKL() && at::native::is_floating_point(self_or_result)
+  } else if (!is_bfloat16 && at::hasMKL() && at::native::is_floating_point(self_or_result)
             && batch_items_contiguous_or_transposed(batch1)
             && batch_items_contiguous_or_transposed(batch2)
             && self_or_result.is_contiguous()) {
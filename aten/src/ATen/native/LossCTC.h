@@ -0,0 +1,32 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// The recursions of the CPU CTC loss, see LossCTC.cpp. The targets of batch
+// item b start at tg_batch_offsets[b] in `targets`, with stride
+// tg_target_stride.
+//
+// The forward writes the negative log likelihoods and the log alphas of every
+// batch item.
+using ctc_loss_fn = void(*)(
+    Tensor& neg_log_likelihood, Tensor& log_alpha,
+    const Tensor& log_probs, const Tensor& targets,
+    IntArrayRef input_lengths, IntArrayRef target_lengths,
+    IntArrayRef tg_batch_offsets, int64_t tg_target_stride, int64_t BLANK);
+// The backward computes the betas along the way and writes the gradient into
+// grad, a zero-initialized contiguous tensor of the size of log_probs.
+using ctc_loss_backward_fn = void(*)(
+    Tensor& grad, const Tensor& grad_out,
+    const Tensor& log_probs, const Tensor& targets,
+    IntArrayRef input_lengths, IntArrayRef target_lengths,
+    IntArrayRef tg_batch_offsets, int64_t tg_target_stride,
+    const Tensor& neg_log_likelihood, const Tensor& log_alpha,
+    int64_t BLANK, bool zero_infinity);
+
+DECLARE_DISPATCH(ctc_loss_fn, ctc_loss_stub);
+DECLARE_DISPATCH(ctc_loss_backward_fn, ctc_loss_backward_stub);
+
+}} // namespace at::native
@@ -0,0 +1,223 @@
+// The cross entropy of scores and class indices, fused over the softmax.
+//
+// For a row x of C scores, of target class t, the loss with label smoothing
+// eps and class weights w is
+//
+//   loss = -(1 - eps) * w[t] * log_softmax(x)[t] - eps / C * sum_c w[c] * log_softmax(x)[c]
+//
+// and its gradient with respect to x[c] is
+//
+//   softmax(x)[c] * ((1 - eps) * w[t] + eps / C * sum_c' w[c']) - (1 - eps) * w[t] * (c == t) - eps / C * w[c]
+//
+// Both only need the logsumexp of the row, as log_softmax(x)[c] = x[c] -
+// logsumexp(x). The forward keeps it for the backward, which recomputes the
+// softmax from it while writing the gradient. Unlike log_softmax followed by
+// nll_loss, the (N, C) log probabilities are never materialized.
+
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/TensorUtils.h>
+#include <ATen/native/LossCrossEntropy.h>
+
+namespace at {
+namespace native {
+
+DEFINE_DISPATCH(cross_entropy_loss_stub);
+DEFINE_DISPATCH(cross_entropy_loss_backward_stub);
+
+namespace {
+
+void check_inputs(
+    CheckedFrom c,
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    double label_smoothing) {
+  auto self_arg = TensorArg(self, "self", 1);
+  auto target_arg = TensorArg(target, "target", 2);
+  checkDim(c, self_arg, 2);
+  checkDim(c, target_arg, 1);
+  checkScalarType(c, target_arg, kLong);
+  checkSize(c, target_arg, 0, self.size(0));
+  TORCH_CHECK(
+      !weight.defined() || weight.numel() == self.size(1),
+      c, ": weight tensor should be defined either for all ", self.size(1),
+      " classes or no classes but got weight tensor of shape: ", weight.sizes());
+  TORCH_CHECK(
+      !weight.defined() || weight.scalar_type() == self.scalar_type(),
+      c, ": expected weight to have type ", self.scalar_type(),
+      " but got ", weight.scalar_type());
+  TORCH_CHECK(
+      0.0 <= label_smoothing && label_smoothing <= 1.0,
+      c, ": label_smoothing must be between 0.0 and 1.0, but got ", label_smoothing);
+}
+
+// The total weight of the targets that are not ignored
+Tensor total_target_weight(
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t ignore_index,
+    const TensorOptions& options) {
+  Tensor valid = target != ignore_index;
+  if (!weight.defined()) {
+    return valid.sum().to(options);
+  }
+  // The target of ignored rows may be out of the class range
+  Tensor safe_target = target.masked_fill(valid.logical_not(), 0);
+  return weight.index_select(0, safe_target).to(options).mul_(valid).sum();
+}
+
+bool can_use_fused_kernels(const Tensor& self) {
+  switch (self.device().type()) {
+    case kCPU:
+      return self.scalar_type() == kFloat || self.scalar_type() == kDouble;
+    case kCUDA:
+      return self.scalar_type() == kFloat || self.scalar_type() == kDouble ||
+          self.scalar_type() == kHalf;
+    default:
+      return false;
+  }
+}
+
+// Goes through the log probabilities, for the types without fused kernels
+Tensor cross_entropy_loss_unfused(
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t reduction,
+    int64_t ignore_index,
+    double label_smoothing) {
+  Tensor log_probs = at::log_softmax(self, 1);
+  if (label_smoothing == 0.0) {
+    return at::nll_loss(log_probs, target, weight, reduction, ignore_index);
+  }
+  Tensor nll = at::nll_loss(log_probs, target, weight, Reduction::None, ignore_index);
+  Tensor smooth = (weight.defined() ? log_probs * weight : log_probs).sum(1).neg_();
+  smooth.masked_fill_(target == ignore_index, 0);
+  Tensor losses = nll * (1 - label_smoothing) + smooth * (label_smoothing / self.size(1));
+  if (reduction == Reduction::None) {
+    return losses;
+  } else if (reduction == Reduction::Sum) {
+    return losses.sum();
+  }
+  return losses.sum() / total_target_weight(target, weight, ignore_index, losses.options());
+}
+
+} // namespace
+
+// The forward returns the loss, the logsumexp of the scores of every row, kept
+// for the backward, and the total weight of the rows that are not ignored.
+std::tuple<Tensor, Tensor, Tensor> _cross_entropy_loss_forward(
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t reduction,
+    int64_t ignore_index,
+    double label_smoothing) {
+  check_inputs("_cross_entropy_loss_forward", self, target, weight, label_smoothing);
+
+  auto input = self.contiguous();
+  auto target_ = target.contiguous();
+  auto weight_ = weight.defined() ? weight.contiguous() : weight;
+
+  const int64_t n_rows = input.size(0);
+  auto acc_options = input.options().dtype(toAccumulateType(input.scalar_type(), /*is_cuda=*/true));
+  Tensor losses = at::empty({n_rows}, acc_options);
+  Tensor logsumexp = at::empty({n_rows}, acc_options);
+  cross_entropy_loss_stub(
+      input.device().type(), losses, logsumexp, input, target_, weight_,
+      ignore_index, label_smoothing);
+
+  Tensor total_weight = total_target_weight(target_, weight_, ignore_index, acc_options);
+
+  Tensor output;
+  if (reduction == Reduction::None) {
+    output = losses.to(input.scalar_type());
+  } else if (reduction == Reduction::Sum) {
+    output = losses.sum().to(input.scalar_type());
+  } else {
+    output = losses.sum().div_(total_weight).to(input.scalar_type());
+  }
+  return std::make_tuple(output, logsumexp, total_weight);
+}
+
+Tensor _cross_entropy_loss_backward(
+    const Tensor& grad_output,
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t reduction,
+    int64_t ignore_index,
+    double label_smoothing,
+    const Tensor& logsumexp,
+    const Tensor& total_weight) {
+  auto input = self.contiguous();
+  auto target_ = target.contiguous();
+  auto weight_ = weight.defined() ? weight.contiguous() : weight;
+
+  const int64_t n_rows = input.size(0);
+  Tensor grad_losses = grad_output.to(logsumexp.scalar_type());
+  if (reduction == Reduction::Mean) {
+    grad_losses = grad_losses / total_weight;
+  }
+  grad_losses = grad_losses.expand({n_rows}).contiguous();
+
+  Tensor grad_input = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  cross_entropy_loss_backward_stub(
+      input.device().type(), grad_input, grad_losses, input, target_, weight_,
+      logsumexp.contiguous(), ignore_index, label_smoothing);
+  return grad_input;
+}
+
+// Takes scores of size (N, C) or (N, C, d_1, ..., d_K), the classes being
+// moved inner most for the fused kernels, and targets of size (N) or
+// (N, d_1, ..., d_K).
+Tensor cross_entropy_loss(
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t reduction,
+    int64_t ignore_index,
+    double label_smoothing) {
+  TORCH_CHECK(
+      self.dim() >= 2, "cross_entropy_loss: expected 2 or more dimensions (got ", self.dim(), ")");
+  TORCH_CHECK(
+      target.dim() == self.dim() - 1,
+      "cross_entropy_loss: expected target of ", self.dim() - 1,
+      " dimensions (got ", target.dim(), ")");
+  for (int64_t d = 0; d < target.dim(); d++) {
+    TORCH_CHECK(
+        target.size(d) == self.size(d == 0 ? 0 : d + 1),
+        "cross_entropy_loss: expected target of size ", self.sizes(),
+        " without dimension 1, but got ", target.sizes());
+  }
+  TORCH_CHECK(
+      0.0 <= label_smoothing && label_smoothing <= 1.0,
+      "cross_entropy_loss: label_smoothing must be between 0.0 and 1.0, but got ", label_smoothing);
+
+  Tensor input = self;
+  Tensor target_ = target;
+  if (self.dim() > 2) {
+    std::vector<int64_t> permutation(self.dim());
+    permutation[0] = 0;
+    for (int64_t d = 2; d < self.dim(); d++) {
+      permutation[d - 1] = d;
+    }
+    permutation.back() = 1;
+    input = self.permute(permutation).reshape({target.numel(), self.size(1)});
+    target_ = target.reshape({target.numel()});
+  }
+
+  Tensor output = can_use_fused_kernels(input)
+      ? std::get<0>(at::_cross_entropy_loss_forward(
+            input, target_, weight, reduction, ignore_index, label_smoothing))
+      : cross_entropy_loss_unfused(
+            input, target_, weight, reduction, ignore_index, label_smoothing);
+  if (reduction == Reduction::None && self.dim() > 2) {
+    output = output.view(target.sizes());
+  }
+  return output;
+}
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// The per-row kernels of the fused cross entropy, see LossCrossEntropy.cpp.
+// `self` is a contiguous (N, C) tensor of scores and `target` a contiguous
+// (N) tensor of class indices. `weight` holds the weight of each class, or is
+// undefined for all ones. Rows whose target is ignore_index get a zero loss
+// and a zero gradient.
+//
+// The forward writes the loss and the logsumexp of the scores of every row,
+// in the accumulate type of `self`.
+using cross_entropy_loss_fn = void(*)(
+    Tensor& losses, Tensor& logsumexp,
+    const Tensor& self, const Tensor& target, const Tensor& weight,
+    int64_t ignore_index, double label_smoothing);
+// The backward recomputes the softmax of the scores from the logsumexp, and
+// writes the gradient into grad_input, a contiguous tensor of the size of
+// self. grad_losses holds the gradient of the loss of every row.
+using cross_entropy_loss_backward_fn = void(*)(
+    Tensor& grad_input, const Tensor& grad_losses,
+    const Tensor& self, const Tensor& target, const Tensor& weight,
+    const Tensor& logsumexp, int64_t ignore_index, double label_smoothing);
+
+DECLARE_DISPATCH(cross_entropy_loss_fn, cross_entropy_loss_stub);
+DECLARE_DISPATCH(cross_entropy_loss_backward_fn, cross_entropy_loss_backward_stub);
+
+}} // namespace at::native
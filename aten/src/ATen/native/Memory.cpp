@@ -10,7 +10,7 @@ namespace at {
 namespace native {
 
 bool is_pinned(const Tensor& self) {
-  return detail::getCUDAHooks().isPinnedPtr(self.storage().data());
+  return detail::getCUDAHooks().isPinnedPtr(const_cast<void*>(self.storage().const_data()));
 }
 
 Tensor pin_memory(const Tensor& self) {
@@ -0,0 +1,359 @@
+// Basic functions on nested tensors
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/NestedTensorImpl.h>
+#include <ATen/NestedTensorUtils.h>
+#include <ATen/Parallel.h>
+#include <ATen/WrapDimUtils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace at { namespace native {
+
+using namespace at::nested;
+
+namespace {
+
+// Offsets of entries with the given lengths.
+Tensor offsets_from_lengths(const int64_t* lengths, int64_t num_entries) {
+  Tensor offsets = at::empty({num_entries + 1}, at::kLong);
+  int64_t* offsets_ptr = offsets.data_ptr<int64_t>();
+  offsets_ptr[0] = 0;
+  for (int64_t i = 0; i < num_entries; i++) {
+    offsets_ptr[i + 1] = offsets_ptr[i] + lengths[i];
+  }
+  return offsets;
+}
+
+bool same_offsets(const Tensor& offsets, const Tensor& other) {
+  return offsets.is_same(other) ||
+      (offsets.numel() == other.numel() && at::equal(offsets, other));
+}
+
+// Grain size of a parallel loop over the entries of a nested tensor, whose
+// cost is proportional to the total number of elements `numel`.
+int64_t entry_grain_size(int64_t num_entries, int64_t numel) {
+  return std::max<int64_t>(1, internal::GRAIN_SIZE * num_entries / std::max<int64_t>(1, numel));
+}
+
+// The operands of a binary op on the buffer of a nested tensor: the buffer of
+// a nested operand, which must have entries of the same lengths, or a dense
+// operand, which is broadcast over the entries and the ragged dim and so can
+// only have as many dims as the inner dims.
+std::tuple<Tensor, Tensor, NestedTensor> nested_binary_operands(
+    const Tensor& self,
+    const Tensor& other,
+    const char* op) {
+  const NestedTensor& nested = self.is_nested() ? self : other;
+  const Tensor offsets = get_nested_impl(nested)->offsets();
+  auto buffer_operand = [&](const Tensor& t) -> Tensor {
+    if (t.is_nested()) {
+      TORCH_CHECK(same_offsets(get_nested_impl(t)->offsets(), offsets),
+          op, "(): expected nested operands with entries of the same lengths");
+      return get_nested_impl(t)->buffer();
+    }
+    TORCH_CHECK(t.dim() <= nested.dim() - 2,
+        op, "(): a dense operand can only be broadcast over the inner dims of a nested tensor of size ",
+        nested.sizes(), ", but got size ", t.sizes());
+    return t;
+  };
+  return std::make_tuple(buffer_operand(self), buffer_operand(other), nested);
+}
+
+// Softmax over the ragged dim: the rows of every entry are normalized
+// independently, row by row so that the inner dims are read contiguously.
+template <typename scalar_t>
+void ragged_softmax(
+    scalar_t* out,
+    const scalar_t* in,
+    const int64_t* offsets,
+    int64_t num_entries,
+    int64_t row_numel,
+    int64_t grain_size) {
+  at::parallel_for(0, num_entries, grain_size, [&](int64_t begin, int64_t end) {
+    std::vector<scalar_t> max(row_numel);
+    std::vector<scalar_t> sum(row_numel);
+    for (int64_t i = begin; i < end; i++) {
+      const int64_t length = offsets[i + 1] - offsets[i];
+      if (length == 0) {
+        continue;
+      }
+      const scalar_t* x = in + offsets[i] * row_numel;
+      scalar_t* y = out + offsets[i] * row_numel;
+      std::copy(x, x + row_numel, max.begin());
+      for (int64_t r = 1; r < length; r++) {
+        for (int64_t j = 0; j < row_numel; j++) {
+          max[j] = std::max(max[j], x[r * row_numel + j]);
+        }
+      }
+      std::fill(sum.begin(), sum.end(), scalar_t(0));
+      for (int64_t r = 0; r < length; r++) {
+        for (int64_t j = 0; j < row_numel; j++) {
+          const scalar_t e = std::exp(x[r * row_numel + j] - max[j]);
+          y[r * row_numel + j] = e;
+          sum[j] += e;
+        }
+      }
+      for (int64_t j = 0; j < row_numel; j++) {
+        sum[j] = scalar_t(1) / sum[j];
+      }
+      for (int64_t r = 0; r < length; r++) {
+        for (int64_t j = 0; j < row_numel; j++) {
+          y[r * row_numel + j] *= sum[j];
+        }
+      }
+    }
+  });
+}
+
+} // namespace
+
+/******************************************************************************
+ * access methods
+ ******************************************************************************/
+
+Tensor values_nested(const NestedTensor& self) {
+  return get_nested_impl(self)->buffer().alias();
+}
+
+Tensor nested_offsets(const NestedTensor& self) {
+  return get_nested_impl(self)->offsets().alias();
+}
+
+/******************************************************************************
+ * conversions
+ ******************************************************************************/
+
+NestedTensor nested_tensor(TensorList tensors) {
+  TORCH_CHECK(!tensors.empty(), "nested_tensor(): expected a non-empty list of tensors");
+  const Tensor& first = tensors[0];
+  std::vector<int64_t> lengths(tensors.size());
+  for (size_t i = 0; i < tensors.size(); i++) {
+    const Tensor& t = tensors[i];
+    TORCH_CHECK(t.layout() == kStrided && t.device().type() == kCPU && !t.is_quantized(),
+        "nested_tensor(): expected strided CPU tensors, but tensor ", i,
+        " has layout ", t.layout(), " and type ", t.toString());
+    TORCH_CHECK(t.dim() >= 1,
+        "nested_tensor(): expected tensors with at least one dim, but tensor ", i, " is 0-dim");
+    TORCH_CHECK(t.scalar_type() == first.scalar_type(),
+        "nested_tensor(): expected tensors of the same dtype, but tensor 0 has dtype ",
+        first.scalar_type(), " and tensor ", i, " has dtype ", t.scalar_type());
+    TORCH_CHECK(t.sizes().slice(1) == first.sizes().slice(1),
+        "nested_tensor(): expected tensors whose sizes only differ in dim 0, but tensor 0 has size ",
+        first.sizes(), " and tensor ", i, " has size ", t.sizes());
+    lengths[i] = t.size(0);
+  }
+  Tensor offsets = offsets_from_lengths(lengths.data(), lengths.size());
+  return new_nested_with_tensors(at::cat(tensors, 0), offsets);
+}
+
+NestedTensor nested_from_padded(const Tensor& padded, const Tensor& lengths) {
+  TORCH_CHECK(padded.layout() == kStrided && padded.device().type() == kCPU && !padded.is_quantized(),
+      "nested_from_padded(): expected a strided CPU tensor, but got layout ", padded.layout(),
+      " and type ", padded.toString());
+  TORCH_CHECK(padded.dim() >= 2,
+      "nested_from_padded(): expected padded to have at least 2 dims, but it has ", padded.dim());
+  TORCH_CHECK(lengths.dim() == 1 && lengths.scalar_type() == kLong && lengths.device().type() == kCPU,
+      "nested_from_padded(): expected lengths to be a 1-D CPU LongTensor, but got ",
+      lengths.dim(), "-D ", lengths.toString());
+  const int64_t num_entries = padded.size(0);
+  const int64_t max_length = padded.size(1);
+  TORCH_CHECK(lengths.numel() == num_entries,
+      "nested_from_padded(): expected ", num_entries, " lengths, but got ", lengths.numel());
+
+  Tensor lengths_contig = lengths.contiguous();
+  const int64_t* lengths_ptr = lengths_contig.data_ptr<int64_t>();
+  for (int64_t i = 0; i < num_entries; i++) {
+    TORCH_CHECK(lengths_ptr[i] >= 0 && lengths_ptr[i] <= max_length,
+        "nested_from_padded(): expected lengths in [0, ", max_length, "], but entry ", i,
+        " has length ", lengths_ptr[i]);
+  }
+  Tensor offsets = offsets_from_lengths(lengths_ptr, num_entries);
+  const int64_t* offsets_ptr = offsets.data_ptr<int64_t>();
+
+  std::vector<int64_t> buffer_sizes(padded.sizes().begin() + 1, padded.sizes().end());
+  buffer_sizes[0] = offsets_ptr[num_entries];
+  Tensor buffer = at::empty(buffer_sizes, padded.options());
+  Tensor padded_contig = padded.contiguous();
+  const int64_t row_bytes = prod_intlist(padded.sizes().slice(2)) * padded.element_size();
+  const char* src = static_cast<const char*>(padded_contig.data_ptr());
+  char* dst = static_cast<char*>(buffer.data_ptr());
+  at::parallel_for(0, num_entries, entry_grain_size(num_entries, buffer.numel()), [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      const int64_t length = offsets_ptr[i + 1] - offsets_ptr[i];
+      if (length > 0) {
+        std::memcpy(dst + offsets_ptr[i] * row_bytes, src + i * max_length * row_bytes, length * row_bytes);
+      }
+    }
+  });
+  return new_nested_with_tensors(buffer, offsets);
+}
+
+// Only the padding is filled, the entries are copied from the buffer.
+Tensor nested_to_padded(const NestedTensor& self, Scalar padding) {
+  auto impl = get_nested_impl(self);
+  Tensor buffer = impl->buffer();
+  Tensor padded = at::empty(self.sizes(), buffer.options());
+  const int64_t num_entries = impl->num_entries();
+  const int64_t max_length = self.size(1);
+  const int64_t row_numel = prod_intlist(self.sizes().slice(2));
+  const int64_t* offsets_ptr = impl->offsets().data_ptr<int64_t>();
+  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(kBool, kHalf, kBFloat16, buffer.scalar_type(), "to_padded", [&]() {
+    const scalar_t pad = padding.to<scalar_t>();
+    const scalar_t* src = buffer.data_ptr<scalar_t>();
+    scalar_t* dst = padded.data_ptr<scalar_t>();
+    at::parallel_for(0, num_entries, entry_grain_size(num_entries, padded.numel()), [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        const int64_t n = (offsets_ptr[i + 1] - offsets_ptr[i]) * row_numel;
+        scalar_t* out = dst + i * max_length * row_numel;
+        if (n > 0) {
+          std::memcpy(out, src + offsets_ptr[i] * row_numel, n * sizeof(scalar_t));
+        }
+        std::fill(out + n, out + max_length * row_numel, pad);
+      }
+    });
+  });
+  return padded;
+}
+
+/******************************************************************************
+ * elementwise ops, on the buffer only
+ ******************************************************************************/
+
+Tensor add_nested(const Tensor& self, const Tensor& other, Scalar alpha) {
+  Tensor self_operand, other_operand;
+  NestedTensor nested;
+  std::tie(self_operand, other_operand, nested) = nested_binary_operands(self, other, "add");
+  return nested_like(nested, at::add(self_operand, other_operand, alpha));
+}
+
+Tensor mul_nested(const Tensor& self, const Tensor& other) {
+  Tensor self_operand, other_operand;
+  NestedTensor nested;
+  std::tie(self_operand, other_operand, nested) = nested_binary_operands(self, other, "mul");
+  return nested_like(nested, at::mul(self_operand, other_operand));
+}
+
+Tensor relu_nested(const NestedTensor& self) {
+  return nested_like(self, at::relu(get_nested_impl(self)->buffer()));
+}
+
+Tensor gelu_nested(const NestedTensor& self) {
+  return nested_like(self, at::gelu(get_nested_impl(self)->buffer()));
+}
+
+Tensor tanh_nested(const NestedTensor& self) {
+  return nested_like(self, at::tanh(get_nested_impl(self)->buffer()));
+}
+
+Tensor sigmoid_nested(const NestedTensor& self) {
+  return nested_like(self, at::sigmoid(get_nested_impl(self)->buffer()));
+}
+
+/******************************************************************************
+ * softmax and attention
+ ******************************************************************************/
+
+// A softmax over an inner dim is one over the matching dim of the buffer.
+// Over the ragged dim, the padding of the padded form is left out of the
+// normalization, as with a mask of -inf.
+Tensor softmax_nested(const NestedTensor& self, int64_t dim, bool half_to_float) {
+  TORCH_CHECK(!half_to_float, "softmax with half to float conversion is not supported on CPU");
+  dim = maybe_wrap_dim(dim, self.dim());
+  TORCH_CHECK(dim != 0, "softmax(): a nested tensor cannot be normalized over its entries (dim 0)");
+  auto impl = get_nested_impl(self);
+  Tensor buffer = impl->buffer();
+  if (dim > 1) {
+    return nested_like(self, at::_softmax(buffer, dim - 1, false));
+  }
+  Tensor result = at::empty_like(buffer);
+  const int64_t num_entries = impl->num_entries();
+  const int64_t row_numel = prod_intlist(self.sizes().slice(2));
+  AT_DISPATCH_FLOATING_TYPES(buffer.scalar_type(), "softmax_nested", [&]() {
+    ragged_softmax<scalar_t>(
+        result.data_ptr<scalar_t>(),
+        buffer.data_ptr<scalar_t>(),
+        impl->offsets().data_ptr<int64_t>(),
+        num_entries,
+        row_numel,
+        entry_grain_size(num_entries, buffer.numel()));
+  });
+  return nested_like(self, result);
+}
+
+// softmax(q k^T / sqrt(head_dim)) v for every entry and head, where the
+// entries of query are of size [q_length, head_dim] or
+// [q_length, num_heads, head_dim], and those of key and value of size
+// [k_length, head_dim] or [k_length, num_heads, head_dim] and
+// [k_length, value_dim] or [k_length, num_heads, value_dim]. The scores are
+// only computed between the rows of an entry, so none of the padding of the
+// padded form takes part in the GEMMs.
+NestedTensor nested_attention(const NestedTensor& query, const NestedTensor& key, const NestedTensor& value) {
+  TORCH_CHECK(query.is_nested() && key.is_nested() && value.is_nested(),
+      "nested_attention(): expected nested query, key and value");
+  auto query_impl = get_nested_impl(query);
+  auto key_impl = get_nested_impl(key);
+  auto value_impl = get_nested_impl(value);
+  TORCH_CHECK((query.dim() == 3 || query.dim() == 4) && key.dim() == query.dim() && value.dim() == query.dim(),
+      "nested_attention(): expected entries with 2 or 3 dims, but got query, key and value of sizes ",
+      query.sizes(), ", ", key.sizes(), " and ", value.sizes());
+  TORCH_CHECK(query_impl->num_entries() == key_impl->num_entries(),
+      "nested_attention(): expected query and key with the same number of entries, but got ",
+      query_impl->num_entries(), " and ", key_impl->num_entries());
+  TORCH_CHECK(same_offsets(key_impl->offsets(), value_impl->offsets()),
+      "nested_attention(): expected key and value with entries of the same lengths");
+  TORCH_CHECK(query.sizes().slice(2) == key.sizes().slice(2),
+      "nested_attention(): expected query and key with the same inner sizes, but got sizes ",
+      query.sizes(), " and ", key.sizes());
+  TORCH_CHECK(query.dim() == 3 || value.size(2) == query.size(2),
+      "nested_attention(): expected value with ", query.size(2), " heads, but got size ", value.sizes());
+  TORCH_CHECK(at::isFloatingType(query.scalar_type()) &&
+      key.scalar_type() == query.scalar_type() && value.scalar_type() == query.scalar_type(),
+      "nested_attention(): expected query, key and value of the same floating point dtype, but got ",
+      query.scalar_type(), ", ", key.scalar_type(), " and ", value.scalar_type());
+
+  // All of them seen as [rows, num_heads, dim].
+  auto as_heads = [&](const Tensor& buffer) {
+    return query.dim() == 3 ? buffer.unsqueeze(1) : buffer;
+  };
+  Tensor q = as_heads(query_impl->buffer());
+  Tensor k = as_heads(key_impl->buffer());
+  Tensor v = as_heads(value_impl->buffer());
+  const int64_t num_entries = query_impl->num_entries();
+  const int64_t num_heads = q.size(1);
+  const double scale = 1.0 / std::sqrt(static_cast<double>(q.size(2)));
+  Tensor out = at::empty({q.size(0), num_heads, v.size(2)}, q.options());
+  const int64_t* q_offsets = query_impl->offsets().data_ptr<int64_t>();
+  const int64_t* k_offsets = key_impl->offsets().data_ptr<int64_t>();
+
+  // One work item is one head of one entry: two GEMMs and a softmax.
+  at::parallel_for(0, num_entries * num_heads, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t item = begin; item < end; item++) {
+      const int64_t i = item / num_heads;
+      const int64_t h = item % num_heads;
+      const int64_t q_length = q_offsets[i + 1] - q_offsets[i];
+      const int64_t k_length = k_offsets[i + 1] - k_offsets[i];
+      if (q_length == 0) {
+        continue;
+      }
+      Tensor out_ih = out.narrow(0, q_offsets[i], q_length).select(1, h);
+      if (k_length == 0) {
+        out_ih.zero_();
+        continue;
+      }
+      Tensor q_ih = q.narrow(0, q_offsets[i], q_length).select(1, h);
+      Tensor k_ih = k.narrow(0, k_offsets[i], k_length).select(1, h);
+      Tensor v_ih = v.narrow(0, k_offsets[i], k_length).select(1, h);
+      Tensor scores = at::mm(q_ih, k_ih.t()).mul_(scale);
+      at::mm_out(out_ih, at::_softmax(scores, 1, false), v_ih);
+    }
+  });
+  return nested_like(query, query.dim() == 3 ? out.squeeze(1) : out);
+}
+
+}} // namespace at::native
@@ -0,0 +1,160 @@
+#include <ATen/native/PackedLinear.h>
+
+#include <ATen/Config.h>
+#include <ATen/NativeFunctions.h>
+#include <torch/custom_class.h>
+#include <torch/library.h>
+
+#include <limits>
+
+#if AT_MKL_ENABLED()
+#include <mkl.h>
+#endif
+
+namespace at {
+namespace native {
+
+c10::intrusive_ptr<LinearPackedContext> LinearPackedContext::create_context(
+    Tensor&& weight,
+    c10::optional<Tensor>&& bias) {
+  TORCH_CHECK(
+      weight.dim() == 2,
+      "linear_prepack: expected a 2-dimensional weight, got ", weight.dim(),
+      " dimensions");
+  TORCH_CHECK(
+      weight.device().is_cpu(), "linear_prepack: expected a CPU weight");
+  if (bias && bias->defined()) {
+    TORCH_CHECK(
+        bias->dim() == 1 && bias->size(0) == weight.size(0),
+        "linear_prepack: expected a bias of size [", weight.size(0),
+        "], got ", bias->sizes());
+    TORCH_CHECK(
+        bias->scalar_type() == weight.scalar_type() && bias->device().is_cpu(),
+        "linear_prepack: expected a CPU bias of type ", weight.scalar_type());
+  } else {
+    bias = c10::nullopt;
+  }
+  return c10::make_intrusive<LinearPackedContext>(
+      std::move(weight), std::move(bias));
+}
+
+#if AT_MKL_ENABLED()
+bool LinearPackedContext::can_use_packed_weight(
+    const Tensor& input,
+    int64_t rows) {
+  const int64_t out_features = orig_weight_.size(0);
+  const int64_t in_features = orig_weight_.size(1);
+  constexpr int64_t max_mkl_int = std::numeric_limits<MKL_INT>::max();
+  if (orig_weight_.scalar_type() != kFloat || input.scalar_type() != kFloat ||
+      !input.device().is_cpu() || input.layout() != kStrided ||
+      input.dim() < 1 || input.size(-1) != in_features || rows == 0 ||
+      out_features == 0 || in_features == 0 || rows > max_mkl_int ||
+      out_features > max_mkl_int || in_features > max_mkl_int) {
+    return false;
+  }
+  // The packed weight is a constant; training goes through at::linear.
+  if (GradMode::is_enabled() &&
+      (input.requires_grad() || orig_weight_.requires_grad() ||
+       (orig_bias_ && orig_bias_->requires_grad()))) {
+    return false;
+  }
+  std::call_once(pack_once_, [&] {
+    const auto weight = orig_weight_.contiguous();
+    const size_t size = cblas_sgemm_pack_get_size(
+        CblasBMatrix, rows, out_features, in_features);
+    packed_weight_ = at::empty(
+        {static_cast<int64_t>((size + sizeof(float) - 1) / sizeof(float))},
+        weight.options());
+    // B = weight^T, of size [in_features, out_features]
+    cblas_sgemm_pack(
+        CblasRowMajor,
+        CblasBMatrix,
+        CblasTrans,
+        rows,
+        out_features,
+        in_features,
+        1.0f,
+        weight.data_ptr<float>(),
+        in_features,
+        packed_weight_.data_ptr<float>());
+    packed_rows_ = rows;
+  });
+  return rows == packed_rows_;
+}
+#endif
+
+Tensor LinearPackedContext::run(const Tensor& input) {
+#if AT_MKL_ENABLED()
+  const int64_t out_features = orig_weight_.size(0);
+  const int64_t in_features = orig_weight_.size(1);
+  const int64_t rows = in_features > 0 ? input.numel() / in_features : 0;
+  if (can_use_packed_weight(input, rows)) {
+    const auto x = input.reshape({rows, in_features}).contiguous();
+    Tensor output;
+    float beta = 0.0f;
+    if (orig_bias_) {
+      output = orig_bias_->expand({rows, out_features}).contiguous();
+      beta = 1.0f;
+    } else {
+      output = at::empty({rows, out_features}, input.options());
+    }
+    cblas_sgemm_compute(
+        CblasRowMajor,
+        CblasNoTrans,
+        CblasPacked,
+        rows,
+        out_features,
+        in_features,
+        x.data_ptr<float>(),
+        in_features,
+        packed_weight_.data_ptr<float>(),
+        out_features,
+        beta,
+        output.data_ptr<float>(),
+        out_features);
+    auto output_sizes = input.sizes().vec();
+    output_sizes.back() = out_features;
+    return output.view(output_sizes);
+  }
+#endif
+  return at::linear(input, orig_weight_, orig_bias_ ? *orig_bias_ : Tensor());
+}
+
+c10::intrusive_ptr<LinearPackedContext> linear_prepack(
+    Tensor weight,
+    c10::optional<Tensor> bias) {
+  return LinearPackedContext::create_context(
+      std::move(weight), std::move(bias));
+}
+
+Tensor linear_run(
+    const Tensor& input,
+    const c10::intrusive_ptr<LinearPackedContext>& op_context) {
+  return op_context->run(input);
+}
+
+TORCH_LIBRARY(packed, m) {
+  m.class_<LinearPackedContext>("LinearOpContext")
+    .def_pickle(
+        [](const c10::intrusive_ptr<LinearPackedContext>& op_context)
+            -> SerializationTypeLinearPack { // __getstate__
+          return op_context->unpack();
+        },
+        [](SerializationTypeLinearPack state)
+            -> c10::intrusive_ptr<LinearPackedContext> { // __setstate__
+          return LinearPackedContext::create_context(
+              std::move(std::get<0>(state)),
+              std::move(std::get<1>(state)));
+        });
+
+  m.def("linear_prepack(Tensor W, Tensor? B=None) -> __torch__.torch.classes.packed.LinearOpContext");
+  m.def("linear_run(Tensor X, __torch__.torch.classes.packed.LinearOpContext W_prepack) -> Tensor Y");
+}
+
+TORCH_LIBRARY_IMPL(packed, CPU, m) {
+  m.impl("linear_prepack", linear_prepack);
+  m.impl("linear_run", linear_run);
+}
+
+} // namespace native
+} // namespace at
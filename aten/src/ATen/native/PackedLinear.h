@@ -0,0 +1,58 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/core/ivalue.h>
+
+#include <mutex>
+
+namespace at {
+namespace native {
+
+// A linear layer on CPU whose float weight is packed once for the GEMM
+// instead of on every call, for inference with fixed weights. With MKL the
+// weight is packed by cblas_sgemm_pack, for the number of rows of the first
+// input it is run on; other inputs, and builds without MKL, go through
+// at::linear with the original weight.
+//
+// Created by packed::linear_prepack and run by packed::linear_run. The
+// freezing pass rewrites aten::linear with a constant weight to these ops.
+
+using SerializationTypeLinearPack = std::tuple<Tensor, c10::optional<Tensor>>;
+
+class LinearPackedContext : public torch::jit::CustomClassHolder {
+ public:
+  LinearPackedContext(Tensor&& weight, c10::optional<Tensor>&& bias)
+      : orig_weight_(std::move(weight)), orig_bias_(std::move(bias)) {}
+
+  SerializationTypeLinearPack unpack() {
+    return std::make_tuple(orig_weight_, orig_bias_);
+  }
+
+  Tensor run(const Tensor& input);
+
+  static c10::intrusive_ptr<LinearPackedContext> create_context(
+      Tensor&& weight,
+      c10::optional<Tensor>&& bias);
+
+ private:
+  bool can_use_packed_weight(const Tensor& input, int64_t rows);
+
+  Tensor orig_weight_;
+  c10::optional<Tensor> orig_bias_;
+
+  // The packed weight and the number of input rows it was packed for.
+  std::once_flag pack_once_;
+  Tensor packed_weight_;
+  int64_t packed_rows_ = -1;
+};
+
+c10::intrusive_ptr<LinearPackedContext> linear_prepack(
+    Tensor weight,
+    c10::optional<Tensor> bias);
+
+Tensor linear_run(
+    const Tensor& input,
+    const c10::intrusive_ptr<LinearPackedContext>& op_context);
+
+} // namespace native
+} // namespace at
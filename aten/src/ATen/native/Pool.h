@@ -2,6 +2,7 @@
 #include <ATen/Parallel.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/div_rtn.h>
+#include <ATen/native/DispatchStub.h>
 #include <tuple>
 
 #pragma once
@@ -9,6 +10,13 @@
 namespace at {
 namespace native {
 
+using max_pool2d_fn = void(*)(Tensor& output, Tensor& indices, const Tensor& input,
+    int kW, int kH, int dW, int dH, int padW, int padH, int dilationW, int dilationH);
+
+// Forward of max_pool2d_with_indices for a 4-d channels last input; output
+// and indices are channels last as well.
+DECLARE_DISPATCH(max_pool2d_fn, max_pool2d_channels_last_kernel);
+
 namespace {
 
 template <typename dest_t, typename src_t>
@@ -2,6 +2,7 @@
 
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/TensorUtils.h>
 #include <ATen/core/op_registration/op_registration.h>
 #include <ATen/cpp_custom_type_hack.h>
 #include <ATen/native/c10_utils.h>
@@ -307,26 +308,20 @@ struct QuantizedCellParamsDynamic : public CellParamsBase {
   }
 
   Tensor linear_ih(const Tensor& input_ih) const override {
-    const auto kFuncName = "quantized::linear_dynamic";
-    const auto kOvrldName = "";
-    const std::vector<c10::IValue> output_ih_list =
-        callOp(kFuncName, kOvrldName, input_ih, packed_w_ih);
-    TORCH_INTERNAL_ASSERT(
-        output_ih_list.size() == 1,
-        "The output vector should have exact one element");
-    const Tensor output_ih = output_ih_list[0].toTensor();
-    return output_ih;
+    return linear_dynamic(input_ih, packed_w_ih);
   }
   Tensor linear_hh(const Tensor& input_hh) const override {
-    const auto kFuncName = "quantized::linear_dynamic";
-    const auto kOvrldName = "";
-    const std::vector<c10::IValue> output_hh_list =
-        callOp(kFuncName, kOvrldName, input_hh, packed_w_hh);
-    TORCH_INTERNAL_ASSERT(
-        output_hh_list.size() == 1,
-        "The output vector should have exact one element");
-    const Tensor output_hh = output_hh_list[0].toTensor();
-    return output_hh;
+    return linear_dynamic(input_hh, packed_w_hh);
+  }
+
+  // linear_hh runs at every time step: the operator is looked up once and
+  // called unboxed, rather than looked up by name and called with a stack.
+  static Tensor linear_dynamic(const Tensor& input, const Tensor& packed_w) {
+    static const c10::OperatorHandle op =
+        c10::Dispatcher::singleton().findSchemaOrThrow(
+            "quantized::linear_dynamic", "");
+    return c10::Dispatcher::singleton().callUnboxed<Tensor, Tensor, Tensor>(
+        op, input, packed_w);
   }
 
   const Tensor& b_ih() const override {
@@ -442,16 +437,11 @@ struct QuantizedCellParamsFP16 : public CellParamsBase {
     }
 #endif // USE_FBGEMM
 
-    const auto kFuncName = "quantized::linear_dynamic_fp16";
-    const auto kOvrldName = "";
-    const std::vector<c10::IValue> output_list =
-        callOp(kFuncName, kOvrldName, input, packed_weight);
-    TORCH_INTERNAL_ASSERT(
-        output_list.size() == 1,
-        "The output vector should have exact one element");
-    const Tensor output = output_list[0].toTensor();
-    return output;
-    TORCH_INTERNAL_ASSERT(false);
+    static const c10::OperatorHandle op =
+        c10::Dispatcher::singleton().findSchemaOrThrow(
+            "quantized::linear_dynamic_fp16", "");
+    return c10::Dispatcher::singleton().callUnboxed<Tensor, Tensor, Tensor>(
+        op, input, packed_weight);
   }
   Tensor linear_ih(const Tensor& input) const override {
     return linear_common(input, packed_ih, b_ih_);
@@ -783,6 +773,14 @@ struct SimpleCell : Cell<Tensor, cell_params> {
 };
 
 // TODO: can use inplace ops?
+// The gates of LSTM and GRU cells on CPU are computed by the vectorized kernels
+// of _thnn_fused_lstm_cell / _thnn_fused_gru_cell, in one pass per step. The
+// biases are already added by linear_ih / linear_hh.
+inline bool use_fused_cpu_cell(const Tensor& input) {
+  return input.device().is_cpu() && input.layout() == kStrided &&
+      (input.scalar_type() == kFloat || input.scalar_type() == kDouble);
+}
+
 template <typename cell_params>
 struct LSTMCell : Cell<std::tuple<Tensor, Tensor>, cell_params> {
   using hidden_type = std::tuple<Tensor, Tensor>;
@@ -805,6 +803,13 @@ struct LSTMCell : Cell<std::tuple<Tensor, Tensor>, cell_params> {
       return std::make_tuple(std::move(std::get<0>(result)), std::move(std::get<1>(result)));
     }
 
+    if (use_fused_cpu_cell(input)) {
+      auto igates = pre_compute_input ? input : params.linear_ih(input);
+      auto hgates = params.linear_hh(hx);
+      auto result = at::_thnn_fused_lstm_cell(igates, hgates, cx);
+      return std::make_tuple(std::move(std::get<0>(result)), std::move(std::get<1>(result)));
+    }
+
     const auto gates = params.linear_hh(hx).add_(
         pre_compute_input ? input : params.linear_ih(input));
     auto chunked_gates = gates.chunk(4, 1);
@@ -837,6 +842,11 @@ struct GRUCell : Cell<Tensor, cell_params> {
       // Slice off the workspace argument (it's needed only for AD).
       return std::move(std::get<0>(result));
     }
+    if (use_fused_cpu_cell(input)) {
+      auto igates = pre_compute_input ? input : params.linear_ih(input);
+      auto hgates = params.linear_hh(hidden);
+      return std::move(std::get<0>(at::_thnn_fused_gru_cell(igates, hgates, hidden)));
+    }
     const auto chunked_igates = pre_compute_input
         ? input.chunk(3, 1)
         : params.linear_ih(input).chunk(3, 1);
@@ -1646,6 +1656,136 @@ std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor> _thnn_differentiable_gru_cell
                          std::move(grad_hx), std::move(grad_input_bias), std::move(grad_hidden_bias));
 }
 
+DEFINE_DISPATCH(lstm_cell_stub);
+DEFINE_DISPATCH(lstm_cell_backward_stub);
+DEFINE_DISPATCH(gru_cell_stub);
+DEFINE_DISPATCH(gru_cell_backward_stub);
+
+// Factor will be 3 for GRU and 4 for LSTM
+static void check_fused_cell_sizes(CheckedFrom c,
+                const TensorArg& input_gates, const TensorArg& hidden_gates,
+                const TensorArg& input_bias, const TensorArg& hidden_bias,
+                int64_t factor, const TensorArg& prev_hidden) {
+  checkDim(c, input_gates, 2);
+  checkSameSize(c, input_gates, hidden_gates);
+  int64_t gates_size = input_gates->size(1);
+
+  if (input_bias->defined()) {
+    checkDim(c, input_bias, 1);
+    checkNumel(c, input_bias, gates_size);
+    checkSameSize(c, input_bias, hidden_bias);
+  }
+
+  checkDim(c, prev_hidden, 2);
+  checkNumel(c, prev_hidden, input_gates->size(0) * gates_size / factor);
+
+  checkAllSameType(c, {input_gates, hidden_gates, prev_hidden});
+}
+
+static Tensor contiguous_if_defined(const Tensor& t) {
+  return t.defined() ? t.contiguous() : t;
+}
+
+std::tuple<Tensor, Tensor, Tensor> _thnn_fused_lstm_cell_cpu(
+      const Tensor& input_gates, const Tensor& hidden_gates,
+      const Tensor& cx,
+      const Tensor& input_bias, const Tensor& hidden_bias) {
+  check_fused_cell_sizes("_thnn_fused_lstm_cell_cpu",
+             {input_gates, "input_gates", 1}, {hidden_gates, "hidden_gates", 2},
+             {input_bias, "input_bias", 3}, {hidden_bias, "hidden_bias", 4},
+             /*factor=*/4, {cx, "prev_hidden", 5});
+
+  auto workspace = at::empty_like(input_gates, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  auto hy = at::empty_like(cx, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  auto cy = at::empty_like(cx, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  lstm_cell_stub(kCPU, hy, cy, workspace,
+                 input_gates.contiguous(), hidden_gates.contiguous(), cx.contiguous(),
+                 contiguous_if_defined(input_bias), contiguous_if_defined(hidden_bias));
+  return std::make_tuple(hy, cy, workspace);
+}
+
+static void check_lstm_backward_sizes(const TensorArg& grad_hy, const TensorArg& grad_cy,
+                            const TensorArg& cx, const TensorArg& cy,
+                            const TensorArg& workspace) {
+  CheckedFrom c = "fused_lstm_cell_backward";
+  const TensorArg& defined_grad = grad_hy->defined() ? grad_hy : grad_cy;
+  checkDim(c, defined_grad, 2);
+  auto exp_size = defined_grad->sizes();
+  if (grad_hy->defined()) {
+    checkSize(c, grad_hy, exp_size);
+  }
+  if (grad_cy->defined()) {
+    checkSize(c, grad_cy, exp_size);
+  }
+  checkSize(c, cx, exp_size);
+  checkSize(c, cy, exp_size);
+  checkDim(c, workspace, 2);
+  checkNumel(c, workspace, exp_size[0] * exp_size[1] * 4);
+}
+
+std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor> _thnn_fused_lstm_cell_backward_cpu(
+      const Tensor& grad_hy, const Tensor& grad_cy,
+      const Tensor& cx, const Tensor& cy,
+      const Tensor& workspace, bool has_bias) {
+  check_lstm_backward_sizes({grad_hy, "grad_hy", 1}, {grad_cy, "grad_cy", 2},
+                            {cx, "cx", 3}, {cy, "cy", 4},
+                            {workspace, "workspace", 5});
+
+  auto grad_gates = at::empty_like(workspace, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  auto grad_cx = at::empty_like(cx, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  lstm_cell_backward_stub(kCPU, grad_gates, grad_cx,
+                          contiguous_if_defined(grad_hy), contiguous_if_defined(grad_cy),
+                          cx.contiguous(), cy.contiguous(), workspace.contiguous());
+
+  auto grad_bias = has_bias ? grad_gates.sum(0, /*keepdim=*/false) : at::Tensor{};
+  return std::make_tuple(grad_gates, grad_gates, grad_cx, grad_bias, grad_bias);
+}
+
+static constexpr int64_t GRU_WORKSPACE_MULTIPLIER = 5;
+
+std::tuple<Tensor, Tensor> _thnn_fused_gru_cell_cpu(
+      const Tensor& input_gates, const Tensor& hidden_gates,
+      const Tensor& hx,
+      const Tensor& input_bias, const Tensor& hidden_bias) {
+  check_fused_cell_sizes("_thnn_fused_gru_cell_cpu",
+             {input_gates, "input_gates", 1}, {hidden_gates, "hidden_gates", 2},
+             {input_bias, "input_bias", 3}, {hidden_bias, "hidden_bias", 4},
+             /*factor=*/3, {hx, "prev_hidden", 5});
+
+  auto workspace = at::empty({hx.size(0), hx.size(1) * GRU_WORKSPACE_MULTIPLIER}, hx.options());
+  auto hy = at::empty_like(hx, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  gru_cell_stub(kCPU, hy, workspace,
+                input_gates.contiguous(), hidden_gates.contiguous(), hx.contiguous(),
+                contiguous_if_defined(input_bias), contiguous_if_defined(hidden_bias));
+  return std::make_tuple(hy, workspace);
+}
+
+static void check_gru_backward_sizes(const TensorArg& grad_hy, const TensorArg& workspace) {
+  CheckedFrom c = "fused_gru_cell_backward";
+  checkDim(c, grad_hy, 2);
+  checkSize(c, workspace, {grad_hy->size(0), grad_hy->size(1) * GRU_WORKSPACE_MULTIPLIER});
+}
+
+std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor> _thnn_fused_gru_cell_backward_cpu(
+      const Tensor& grad_hy, const Tensor& workspace, bool has_bias) {
+  check_gru_backward_sizes({grad_hy, "grad_hy", 1}, {workspace, "workspace", 2});
+
+  int64_t hidden_size = workspace.size(1) / GRU_WORKSPACE_MULTIPLIER;
+  auto grad_input_gates = at::empty({workspace.size(0), hidden_size * 3}, workspace.options());
+  auto grad_hidden_gates = at::empty({workspace.size(0), hidden_size * 3}, workspace.options());
+  auto grad_hx = at::empty_like(grad_hy, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  gru_cell_backward_stub(kCPU, grad_input_gates, grad_hidden_gates, grad_hx,
+                         grad_hy.contiguous(), workspace.contiguous());
+
+  at::Tensor grad_input_bias, grad_hidden_bias;
+  if (has_bias) {
+    grad_input_bias = grad_input_gates.sum(0, /*keepdim=*/false);
+    grad_hidden_bias = grad_hidden_gates.sum(0, /*keepdim=*/false);
+  }
+
+  return std::make_tuple(grad_input_gates, grad_hidden_gates, grad_hx, grad_input_bias, grad_hidden_bias);
+}
+
 Tensor gru_cell(
     const Tensor& input, const Tensor& hx,
     const Tensor& w_ih, const Tensor& w_hh, const Tensor& b_ih, const Tensor& b_hh) {
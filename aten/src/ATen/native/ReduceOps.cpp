@@ -37,6 +37,8 @@ DEFINE_DISPATCH(argmax_stub);
 DEFINE_DISPATCH(argmin_stub);
 DEFINE_DISPATCH(cumsum_stub);
 DEFINE_DISPATCH(cumprod_stub);
+DEFINE_DISPATCH(logcumsumexp_stub);
+DEFINE_DISPATCH(fused_reduce_stub);
 
 #define OPTION_TYPE_EQUALITY_CHECK(option, out, self) \
 { \
@@ -223,6 +225,75 @@ Tensor& cumsum_out(Tensor& result, const Tensor& self, int64_t dim, c10::optiona
   return result;
 }
 
+Tensor _logcumsumexp_cpu(const Tensor& self, int64_t dim) {
+  Tensor result = at::empty_like(self, MemoryFormat::Contiguous);
+  logcumsumexp_stub(self.device().type(), result, self, dim);
+  return result;
+}
+
+Tensor& _logcumsumexp_out_cpu(Tensor& result, const Tensor& self, int64_t dim) {
+  logcumsumexp_stub(self.device().type(), result, self, dim);
+  return result;
+}
+
+// log(exp(x) + exp(y)) elementwise, with the same handling of infinities and
+// NaN as the CPU kernel.
+static Tensor log_add_exp(const Tensor& x, const Tensor& y) {
+  auto min = at::min(x, y);
+  auto max = at::max(x, y);
+  auto result = max + (min - max).exp_().log1p_();
+  // Infinities of the same sign would give NaN above but add up exactly.
+  result = at::where(
+      at::logical_and(min == max, max.abs() == std::numeric_limits<double>::infinity()),
+      max, result);
+  return at::where(at::logical_or(at::isnan(x), at::isnan(y)), x + y, result);
+}
+
+// Other devices have no fused kernel yet. Scanning with log_add_exp keeps a
+// running maximum, so that neither large nor small values overflow or
+// underflow exp. The scan doubles the distance it combines over every step.
+static Tensor logcumsumexp_composite(const Tensor& self, int64_t dim) {
+  if (self.dim() == 0 || self.numel() == 0) {
+    return self.clone();
+  }
+  const auto wrap_dim = maybe_wrap_dim(dim, self.dim());
+  const auto size = self.size(wrap_dim);
+  auto result = self.clone(MemoryFormat::Contiguous);
+  for (int64_t shift = 1; shift < size; shift *= 2) {
+    auto updated = log_add_exp(
+        result.narrow(wrap_dim, shift, size - shift),
+        result.narrow(wrap_dim, 0, size - shift));
+    result.narrow(wrap_dim, shift, size - shift).copy_(updated);
+  }
+  return result;
+}
+
+Tensor logcumsumexp(const Tensor& self, int64_t dim) {
+  auto result = [&]() {
+    NoNamesGuard guard;
+    if (self.device().type() != kCPU) {
+      return logcumsumexp_composite(self, dim);
+    }
+    return at::_logcumsumexp(self, dim);
+  }();
+  namedinference::propagate_names(result, self);
+  return result;
+}
+
+Tensor& logcumsumexp_out(Tensor& result, const Tensor& self, int64_t dim) {
+  check_scalar_type_device_layout_equal(result, self);
+  {
+    NoNamesGuard guard;
+    if (self.device().type() != kCPU) {
+      result.resize_as_(self).copy_(logcumsumexp_composite(self, dim));
+    } else {
+      at::_logcumsumexp_out(result, self, dim);
+    }
+  }
+  namedinference::propagate_names(result, self);
+  return result;
+}
+
 Tensor _cumprod_cpu(const Tensor& self, int64_t dim) {
   Tensor result = at::empty_like(self, MemoryFormat::Contiguous);
   cumprod_stub(self.device().type(), result, self, dim);
@@ -897,6 +968,57 @@ std::tuple<Tensor&,Tensor&> std_mean_out(Tensor &result1, Tensor &result2, const
   return std_var_mean_out("std_mean", result1, result2, self, {}, unbiased, false, true);
 }
 
+std::vector<Tensor> fused_reduce(const Tensor& self, ArrayRef<FusedReduction> reductions, IntArrayRef dim, bool keepdim) {
+  TORCH_CHECK(reductions.size() > 0 && reductions.size() <= max_fused_reductions,
+              "fused_reduce: expected between 1 and ", max_fused_reductions, " reductions, got ",
+              reductions.size());
+  TORCH_CHECK(self.device().type() == DeviceType::CPU || self.device().type() == DeviceType::CUDA,
+              "fused_reduce only supports CPU AND CUDA device type, got: ", self.device().type());
+  TORCH_CHECK(self.layout() == Layout::Strided,
+              "fused_reduce only supports strided layout, got: ", self.layout());
+  int64_t ndim = self.dim();
+  DimMask mask = make_dim_mask(dim, ndim);
+  std::vector<Tensor> results(reductions.size());
+  std::vector<Tensor> viewed_results;
+  viewed_results.reserve(reductions.size());
+  for (auto& result : results) {
+    allocate_reduction_result(result, self, mask, keepdim, self.scalar_type());
+    viewed_results.push_back(review_reduce_result(result, ndim, mask, keepdim));
+    namedinference::propagate_names_for_reduction(result, self, dim, keepdim);
+  }
+  auto iter = TensorIterator::reduce_op(viewed_results, self);
+  if (iter.numel() == 0) {
+    for (size_t i = 0; i < reductions.size(); i++) {
+      TORCH_CHECK(
+          results[i].numel() == 0 ||
+          (reductions[i] != FusedReduction::Min && reductions[i] != FusedReduction::Max),
+          "fused_reduce: min and max of a tensor with no elements are not defined.");
+      results[i].zero_();
+    }
+  } else {
+    fused_reduce_stub(iter.device_type(), iter, reductions);
+  }
+  return results;
+}
+
+std::tuple<Tensor,Tensor> _aminmax(const Tensor& self) {
+  TORCH_CHECK(self.numel() > 0, "_aminmax: cannot compute the min and max of a tensor with no elements.");
+  auto results = fused_reduce(self, {FusedReduction::Min, FusedReduction::Max}, {}, false);
+  return std::make_tuple(results[0], results[1]);
+}
+
+std::tuple<Tensor,Tensor> _aminmax(const Tensor& self, int64_t dim, bool keepdim) {
+  auto results = fused_reduce(self, {FusedReduction::Min, FusedReduction::Max}, dim, keepdim);
+  return std::make_tuple(results[0], results[1]);
+}
+
+std::tuple<Tensor,Tensor> _sum_and_sumsq(const Tensor& self, IntArrayRef dim, bool keepdim) {
+  TORCH_CHECK(at::isFloatingType(self.scalar_type()),
+              "_sum_and_sumsq only supports floating-point dtypes, got: ", self.scalar_type());
+  auto results = fused_reduce(self, {FusedReduction::Sum, FusedReduction::SumOfSquares}, dim, keepdim);
+  return std::make_tuple(results[0], results[1]);
+}
+
 std::tuple<Tensor,Tensor> var_mean(const Tensor& self, IntArrayRef dim, bool unbiased, bool keepdim) {
   Tensor result1 = at::empty({0}, self.options());
   Tensor result2 = at::empty({0}, self.options());
@@ -1025,6 +1147,12 @@ Tensor cumprod(const Tensor& self, Dimname dim, c10::optional<ScalarType> dtype)
 Tensor& cumprod_out(Tensor& result, const Tensor& self, Dimname dim, c10::optional<ScalarType> dtype) {
   return at::cumprod_out(result, self, dimname_to_position(self, dim), dtype);
 }
+Tensor logcumsumexp(const Tensor& self, Dimname dim) {
+  return at::logcumsumexp(self, dimname_to_position(self, dim));
+}
+Tensor& logcumsumexp_out(Tensor& result, const Tensor& self, Dimname dim) {
+  return at::logcumsumexp_out(result, self, dimname_to_position(self, dim));
+}
 std::tuple<Tensor, Tensor> cummax(const Tensor& self, Dimname dim) {
   return at::cummax(self, dimname_to_position(self, dim));
 }
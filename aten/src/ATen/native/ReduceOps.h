@@ -36,5 +36,27 @@ DECLARE_DISPATCH(reduce_fn_flag, norm_stub);
 using cum_fn = void (*)(Tensor&, const Tensor&, int64_t);
 DECLARE_DISPATCH(cum_fn, cumsum_stub);
 DECLARE_DISPATCH(cum_fn, cumprod_stub);
+DECLARE_DISPATCH(cum_fn, logcumsumexp_stub);
+
+// The reductions that fused_reduce can compute together in a single pass over
+// the input (see FusedReduceOps in SharedReduceOps.h).
+enum class FusedReduction : uint8_t { Sum, SumOfSquares, Min, Max };
+
+constexpr int max_fused_reductions = 4;
+
+using reduce_fused_fn = void (*)(TensorIterator&, ArrayRef<FusedReduction>);
+DECLARE_DISPATCH(reduce_fused_fn, fused_reduce_stub);
+
+// Reduces `self` over `dim` with each of `reductions` (at most
+// max_fused_reductions of them) while reading it only once, e.g. {Min, Max}
+// for the range of a quantization observer or {Sum, SumOfSquares} for
+// normalization statistics. Returns one tensor of the dtype of `self` per
+// reduction. This is the entry point for fusers that merge several reductions
+// of the same tensor.
+TORCH_API std::vector<Tensor> fused_reduce(
+    const Tensor& self,
+    ArrayRef<FusedReduction> reductions,
+    IntArrayRef dim,
+    bool keepdim);
 
 }} // namespace at::native
@@ -5,6 +5,8 @@
 #include <c10/macros/Macros.h>
 #include <ATen/detail/FunctionTraits.h>
 #include <ATen/NumericUtils.h>
+#include <ATen/core/Array.h>
+#include <ATen/native/ReduceOps.h>
 #if defined(__CUDACC__)
 #include <THC/THCDeviceUtils.cuh>
 #include <ATen/native/cuda/DeviceSqrt.cuh>
@@ -19,6 +21,8 @@
 #include <cmath>
 #define device_sqrt std::sqrt
 #endif
+#include <limits>
+#include <utility>
 #if defined(__CUDACC__) || defined(__HIPCC__)
 #define MAX(X, Y) ::max(X,Y)
 #define MIN(X, Y) ::min(X,Y)
@@ -117,7 +121,7 @@ struct WelfordOps {
     };
   }
 #endif
-  WelfordOps(bool unbiased, bool take_sqrt)
+  C10_HOST_DEVICE WelfordOps(bool unbiased, bool take_sqrt)
     : unbiased(unbiased), take_sqrt(take_sqrt) {
   }
 };
@@ -310,6 +314,92 @@ struct NormTwoOps {
 #endif
 };
 
+// Computes N of the reductions of FusedReduction over the same input in one
+// pass: the accumulator holds a value per reduction and `reductions` tells
+// how each of them is updated. The reductions are only known at runtime, so a
+// single instantiation serves every combination of N of them. res_t is a
+// tuple of N scalar_t (scalar_t itself when N == 1).
+template <typename scalar_t, typename acc_scalar_t, int N, typename res_t>
+struct FusedReduceOps {
+  using acc_t = at::detail::Array<acc_scalar_t, N>;
+  at::detail::Array<FusedReduction, N> reductions;
+
+  static inline C10_DEVICE acc_scalar_t combine_one(FusedReduction reduction, acc_scalar_t a, acc_scalar_t b) {
+    // min and max propagate NaN like torch.min and torch.max
+    switch (reduction) {
+      case FusedReduction::Min:
+        return (at::_isnan(a) || a < b) ? a : b;
+      case FusedReduction::Max:
+        return (at::_isnan(a) || a > b) ? a : b;
+      default:
+        return a + b;
+    }
+  }
+
+  inline C10_DEVICE acc_t reduce(acc_t acc, scalar_t data, int64_t /*idx*/) const {
+    acc_scalar_t value = static_cast<acc_scalar_t>(data);
+    for (int i = 0; i < N; i++) {
+      acc[i] = combine_one(reductions[i], acc[i],
+                           reductions[i] == FusedReduction::SumOfSquares ? value * value : value);
+    }
+    return acc;
+  }
+
+  inline C10_DEVICE acc_t combine(acc_t a, acc_t b) const {
+    for (int i = 0; i < N; i++) {
+      a[i] = combine_one(reductions[i], a[i], b[i]);
+    }
+    return a;
+  }
+
+  template <size_t... I>
+  inline C10_DEVICE res_t project_impl(acc_t acc, std::index_sequence<I...>) const {
+    return res_t{static_cast<scalar_t>(acc[I])...};
+  }
+
+  inline C10_DEVICE res_t project(acc_t acc) const {
+    return project_impl(acc, std::make_index_sequence<N>{});
+  }
+
+  static C10_DEVICE acc_t translate_idx(acc_t acc, int64_t /*base_idx*/) {
+    return acc;
+  }
+
+#if defined(__CUDACC__) || defined(__HIPCC__)
+  inline C10_DEVICE acc_t warp_shfl_down(acc_t acc, int offset) const {
+    for (int i = 0; i < N; i++) {
+      acc[i] = WARP_SHFL_DOWN(acc[i], offset);
+    }
+    return acc;
+  }
+#endif
+
+  // The identity of the accumulator, to be passed as `ident` to the reduction.
+  acc_t identity() const {
+    using limits = std::numeric_limits<acc_scalar_t>;
+    acc_t ident;
+    for (int i = 0; i < N; i++) {
+      switch (reductions[i]) {
+        case FusedReduction::Min:
+          ident[i] = limits::has_infinity ? limits::infinity() : limits::max();
+          break;
+        case FusedReduction::Max:
+          ident[i] = limits::has_infinity ? -limits::infinity() : limits::lowest();
+          break;
+        default:
+          ident[i] = 0;
+      }
+    }
+    return ident;
+  }
+
+  FusedReduceOps(ArrayRef<FusedReduction> reductions_) {
+    for (int i = 0; i < N; i++) {
+      reductions[i] = reductions_[i];
+    }
+  }
+};
+
 namespace detail {
 
 #if defined(__CUDACC__) || defined(__HIPCC__)
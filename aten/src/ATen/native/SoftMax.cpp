@@ -282,6 +282,15 @@ DEFINE_DISPATCH(log_softmax_lastdim_kernel);
 DEFINE_DISPATCH(softmax_backward_lastdim_kernel);
 DEFINE_DISPATCH(log_softmax_backward_lastdim_kernel);
 
+Tensor scaled_masked_softmax_cpu(const Tensor& self, const Tensor& mask, double scale) {
+  TORCH_CHECK(self.dim() > 0, "_scaled_masked_softmax: expected a tensor with at least one dimension");
+  return at::softmax(self * scale + mask, -1);
+}
+
+Tensor scaled_masked_softmax_backward_cpu(const Tensor& grad_output, const Tensor& output, double scale) {
+  return at::_softmax_backward_data(grad_output, output, -1, output) * scale;
+}
+
 Tensor softmax(const Tensor& self, Dimname dim, optional<ScalarType> dtype) {
   return at::softmax(self, dimname_to_position(self, dim), dtype);
 }
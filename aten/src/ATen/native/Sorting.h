@@ -6,7 +6,11 @@
 namespace at { namespace native {
 
 using topk_fn = void(*)(Tensor&, Tensor&, const Tensor&, int64_t, int64_t, bool, bool);
+// Sorts values in place along dim and writes the positions the values came
+// from to indices, which has the sizes of values.
+using sort_fn = void(*)(Tensor& values, Tensor& indices, int64_t dim, bool descending);
 
 DECLARE_DISPATCH(topk_fn, topk_stub);
+DECLARE_DISPATCH(sort_fn, sort_stub);
 
 }} // at::native
@@ -2,6 +2,7 @@
 
 #include <ATen/ATen.h>
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
 
 #include <tuple>
 
@@ -65,4 +66,91 @@ _bincount_cpu(const Tensor& self, const Tensor& weights, int64_t minlength) {
   });
 }
 
+///////////////// histc /////////////////
+namespace {
+
+// Every chunk of the input is counted into its own row of partial, which are
+// summed at the end, so that the threads do not contend on the bins.
+template <typename scalar_t>
+Tensor _histc_cpu_template(
+    const Tensor& self,
+    int64_t nbins,
+    scalar_t minvalue,
+    scalar_t maxvalue) {
+  if (nbins <= 0) {
+    AT_ERROR("bins must be > 0");
+  }
+  if (minvalue == maxvalue && self.numel() > 0) {
+    Tensor min, max;
+    std::tie(min, max) = at::_aminmax(self);
+    minvalue = min.item<scalar_t>();
+    maxvalue = max.item<scalar_t>();
+  }
+  if (minvalue == maxvalue) {
+    minvalue = minvalue - 1;
+    maxvalue = maxvalue + 1;
+  }
+  TORCH_CHECK(
+      !(std::isinf(minvalue) || std::isinf(maxvalue) ||
+        std::isnan(minvalue) || std::isnan(maxvalue)),
+      "range of [",
+      minvalue,
+      ", ",
+      maxvalue,
+      "] is not finite");
+  TORCH_CHECK(minvalue < maxvalue, "max must be larger than min");
+
+  const Tensor input = self.contiguous();
+  const scalar_t* input_p = input.data_ptr<scalar_t>();
+  const int64_t numel = input.numel();
+  const int64_t num_chunks = std::max<int64_t>(
+      1,
+      std::min<int64_t>(
+          at::get_num_threads(),
+          divup(numel, at::internal::GRAIN_SIZE)));
+  const int64_t chunk_size = divup(numel, num_chunks);
+
+  Tensor partial = at::zeros({num_chunks, nbins}, self.options());
+  scalar_t* partial_p = partial.data_ptr<scalar_t>();
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t chunk = begin; chunk < end; ++chunk) {
+      scalar_t* hist_p = partial_p + chunk * nbins;
+      const int64_t last = std::min(numel, (chunk + 1) * chunk_size);
+      for (int64_t i = chunk * chunk_size; i < last; ++i) {
+        const scalar_t value = input_p[i];
+        if (value >= minvalue && value <= maxvalue) {
+          const int64_t bin = static_cast<int64_t>(
+              (value - minvalue) / (maxvalue - minvalue) * nbins);
+          hist_p[std::min(bin, nbins - 1)] += 1;
+        }
+      }
+    }
+  });
+  return num_chunks == 1 ? partial[0] : partial.sum(0);
+}
+} // namespace
+
+Tensor _histc_cpu(
+    const Tensor& self,
+    int64_t nbins,
+    Scalar min,
+    Scalar max) {
+  return AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "histc", [&] {
+    return _histc_cpu_template<scalar_t>(
+        self, nbins, min.to<scalar_t>(), max.to<scalar_t>());
+  });
+}
+
+Tensor& _histc_out_cpu(
+    Tensor& result,
+    const Tensor& self,
+    int64_t bins,
+    Scalar min,
+    Scalar max) {
+  auto ret = _histc_cpu(self, bins, min, max);
+  result.resize_as_(ret);
+  result.copy_(ret);
+  return result;
+}
+
 }} // namespace at::native
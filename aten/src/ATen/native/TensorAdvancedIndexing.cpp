@@ -57,6 +57,7 @@
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/BinaryOps.h>
 #include <ATen/native/Copy.h>
+#include <ATen/native/cpu/AtomicAddFloat.h>
 #include <ATen/Parallel.h>
 
 #include <algorithm>
@@ -76,6 +77,8 @@ DEFINE_DISPATCH(gather_stub);
 DEFINE_DISPATCH(scatter_stub);
 DEFINE_DISPATCH(scatter_fill_stub);
 DEFINE_DISPATCH(scatter_add_stub);
+DEFINE_DISPATCH(scatter_reduce_stub);
+DEFINE_DISPATCH(segment_reduce_stub);
 
 static bool all_strides_match(TensorList tensors) {
   TORCH_CHECK(tensors.size() >= 1);
@@ -371,17 +374,72 @@ Tensor& index_add_cpu_(Tensor & self, int64_t dim, const Tensor & index, const T
     for (auto i = 0; i < numel; i++) {
       auto self_i = index_data[i];
       TORCH_CHECK_INDEX((self_i >= 0) && (self_i < self_dim_size), "index out of range in self");
-      auto self_data = static_cast<char*>(selfSlice.data_ptr()) + self_i * self_stride_bytes;
+    }
+    auto add_slice = [&](TensorIterator& slice_iter, int64_t i) {
+      auto self_data = static_cast<char*>(selfSlice.data_ptr()) + index_data[i] * self_stride_bytes;
       auto source_data = static_cast<char*>(sourceSlice.data_ptr()) + i * source_stride_bytes;
-      iter.unsafe_replace_operand(0, self_data);
-      iter.unsafe_replace_operand(1, self_data);
-      iter.unsafe_replace_operand(2, source_data);
-      add_stub(iter.device_type(), iter, 1);
+      slice_iter.unsafe_replace_operand(0, self_data);
+      slice_iter.unsafe_replace_operand(1, self_data);
+      slice_iter.unsafe_replace_operand(2, source_data);
+      add_stub(slice_iter.device_type(), slice_iter, 1);
+    };
+
+    // Large slices are already added in parallel by add_stub. For small ones
+    // the indices are grouped by destination slice and the groups are added
+    // in parallel, each group in the order of the indices, so the result
+    // doesn't depend on the number of threads.
+    const int64_t slice_numel = selfSlice.numel();
+    if (slice_numel >= internal::GRAIN_SIZE || numel < 2 || at::get_num_threads() == 1 ||
+        numel * slice_numel < internal::GRAIN_SIZE) {
+      for (auto i = 0; i < numel; i++) {
+        add_slice(iter, i);
+      }
+    } else {
+      std::vector<int64_t> order(numel);
+      std::iota(order.begin(), order.end(), 0);
+      std::stable_sort(order.begin(), order.end(), [&](int64_t a, int64_t b) {
+        return index_data[a] < index_data[b];
+      });
+      std::vector<int64_t> group_starts;
+      for (int64_t j = 0; j < numel; j++) {
+        if (j == 0 || index_data[order[j]] != index_data[order[j - 1]]) {
+          group_starts.push_back(j);
+        }
+      }
+      group_starts.push_back(numel);
+      const int64_t num_groups = group_starts.size() - 1;
+      at::parallel_for(0, num_groups, std::max<int64_t>(1, internal::GRAIN_SIZE / (slice_numel * numel / num_groups)),
+          [&](int64_t begin, int64_t end) {
+        auto slice_iter = iter;
+        for (int64_t group = begin; group < end; group++) {
+          for (int64_t j = group_starts[group]; j < group_starts[group + 1]; j++) {
+            add_slice(slice_iter, order[j]);
+          }
+        }
+      });
     }
   }
   else {
     TORCH_CHECK(source.dim() <= 1, "source.dim() (", source.dim(), ") must one or zero for given self.dim() (", self.dim(), ")");
 
+    if (self.scalar_type() == ScalarType::Float && numel >= internal::GRAIN_SIZE &&
+        at::get_num_threads() > 1 && !at::globalContext().deterministic()) {
+      // Single elements don't pay for grouping the indices, so the elements
+      // are added with atomics and the order of the additions isn't fixed.
+      auto self_stride = self.dim() == 0 ? 1 : self.stride(dim);
+      auto source_stride = source.dim() == 0 ? 1 : source.stride(dim);
+      auto self_numel = self.numel();
+      auto self_data = self.data_ptr<float>();
+      auto source_data = source.data_ptr<float>();
+      at::parallel_for(0, numel, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+        for (auto i = begin; i < end; i++) {
+          auto self_i = index_data[i];
+          TORCH_CHECK_INDEX((self_i >= 0) && (self_i < self_numel), "index out of range in self");
+          cpu_atomic_add_float(self_data + self_i * self_stride, source_data[i * source_stride]);
+        }
+      });
+      return self;
+    }
     AT_DISPATCH_ALL_TYPES(self.scalar_type(), "index_add_", [&] {
       auto self_stride = self.dim() == 0 ? 1 : self.stride(dim);
       auto source_stride = source.dim() == 0 ? 1 : source.stride(dim);
@@ -555,6 +613,88 @@ Tensor scatter_add(const Tensor & self, int64_t dim, const Tensor & index, const
   return self.clone(at::MemoryFormat::Preserve).scatter_add_(dim, index, source);
 }
 
+static ScatterReduceOp get_scatter_reduce_op(const char* name, const std::string& reduce) {
+  if (reduce == "sum") {
+    return ScatterReduceOp::Sum;
+  } else if (reduce == "prod") {
+    return ScatterReduceOp::Prod;
+  } else if (reduce == "mean") {
+    return ScatterReduceOp::Mean;
+  } else if (reduce == "max") {
+    return ScatterReduceOp::Max;
+  } else if (reduce == "min") {
+    return ScatterReduceOp::Min;
+  }
+  TORCH_CHECK(false, name, ": reduce must be one of \"sum\", \"prod\", \"mean\", \"max\" or \"min\", got \"", reduce, "\"");
+}
+
+// Reduces the contiguous [outer, n, inner] view of `self` along n into an
+// [outer, output_size, inner] result with `stub`, and returns the result and
+// the positions of the max / min values with the sizes of `self`, but
+// output_size at `dim`.
+template <typename Stub>
+static std::tuple<Tensor, Tensor> scatter_reduce_impl(
+    const Tensor& self, int64_t dim, const Tensor& index, ScatterReduceOp op,
+    int64_t output_size, Stub& stub) {
+  auto sizes = self.sizes().vec();
+  const int64_t outer = prod_intlist(IntArrayRef(sizes).slice(0, dim));
+  const int64_t inner = prod_intlist(IntArrayRef(sizes).slice(dim + 1));
+  auto self_ = self.contiguous().view({outer, self.size(dim), inner});
+  auto result = at::empty({outer, output_size, inner}, self.options());
+  auto arg = at::empty({0}, self.options().dtype(kLong));
+  const bool has_arg = op == ScatterReduceOp::Max || op == ScatterReduceOp::Min;
+  if (has_arg) {
+    arg.resize_({outer, output_size, inner});
+  }
+  stub(self.device().type(), result, arg, self_, index, op);
+  sizes[dim] = output_size;
+  return std::make_tuple(result.view(sizes), has_arg ? arg.view(sizes) : arg);
+}
+
+std::tuple<Tensor, Tensor> _scatter_reduce(const Tensor& self, int64_t dim, const Tensor& index, std::string reduce, int64_t output_size) {
+  const auto op = get_scatter_reduce_op("scatter_reduce", reduce);
+  TORCH_CHECK(self.dim() > 0, "scatter_reduce: expected a tensor with at least one dimension");
+  dim = maybe_wrap_dim(dim, self.dim());
+  TORCH_CHECK(index.scalar_type() == kLong, "scatter_reduce: expected index of type int64, got ", index.scalar_type());
+  TORCH_CHECK(index.device() == self.device(), "scatter_reduce: expected index on ", self.device(), ", got ", index.device());
+  // a 1-dimensional index applies to all the slices of self along dim
+  const bool broadcast_index = index.dim() == 1 && self.dim() > 1;
+  TORCH_CHECK(
+      broadcast_index ? index.size(0) == self.size(dim) : index.sizes() == self.sizes(),
+      "scatter_reduce: expected index of size ", self.sizes(), " or [", self.size(dim), "], got ", index.sizes());
+  TORCH_CHECK(output_size >= 0, "scatter_reduce: expected a non-negative output_size, got ", output_size);
+  return scatter_reduce_impl(self, dim, index.contiguous(), op, output_size, scatter_reduce_stub);
+}
+
+Tensor scatter_reduce(const Tensor& self, int64_t dim, const Tensor& index, std::string reduce, c10::optional<int64_t> output_size) {
+  const int64_t size = output_size.has_value()
+      ? *output_size
+      : (index.numel() == 0 ? 0 : index.max().item<int64_t>() + 1);
+  return std::get<0>(at::_scatter_reduce(self, dim, index, reduce, size));
+}
+
+std::tuple<Tensor, Tensor> _segment_reduce(const Tensor& data, std::string reduce, const Tensor& lengths, int64_t axis) {
+  const auto op = get_scatter_reduce_op("segment_reduce", reduce);
+  TORCH_CHECK(data.dim() > 0, "segment_reduce: expected a tensor with at least one dimension");
+  axis = maybe_wrap_dim(axis, data.dim());
+  TORCH_CHECK(
+      lengths.dim() == 1 && lengths.scalar_type() == kLong,
+      "segment_reduce: expected 1-dimensional int64 lengths");
+  TORCH_CHECK(lengths.device() == data.device(), "segment_reduce: expected lengths on ", data.device(), ", got ", lengths.device());
+  TORCH_CHECK(
+      lengths.numel() == 0 || lengths.min().item<int64_t>() >= 0,
+      "segment_reduce: expected non-negative lengths");
+  auto offsets = at::cat({at::zeros({1}, lengths.options()), lengths.cumsum(0)});
+  TORCH_CHECK(
+      offsets[-1].item<int64_t>() == data.size(axis),
+      "segment_reduce: expected lengths to sum to ", data.size(axis), ", the size of data at axis ", axis);
+  return scatter_reduce_impl(data, axis, offsets, op, lengths.numel(), segment_reduce_stub);
+}
+
+Tensor segment_reduce(const Tensor& data, std::string reduce, const Tensor& lengths, int64_t axis) {
+  return std::get<0>(at::_segment_reduce(data, reduce, lengths, axis));
+}
+
 Tensor masked_scatter(const Tensor & self, const Tensor & mask, const Tensor & source) {
   Tensor _mask, _self;
   std::tie(_mask, _self) = expand_outplace(mask, self);
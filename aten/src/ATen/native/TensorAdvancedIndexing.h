@@ -11,6 +11,9 @@ namespace at {
 
 namespace at { namespace native {
 
+// Reductions of scatter_reduce and segment_reduce
+enum class ScatterReduceOp { Sum, Prod, Mean, Max, Min };
+
 using index_fn = void(*)(TensorIterator &, IntArrayRef indexed_sizes, IntArrayRef indexed_strides);
 using index_put_fn = void(*)(TensorIterator &, IntArrayRef indexed_sizes, IntArrayRef indexed_strides, bool accumulate);
 using index_put_accum_fn = void(*)(Tensor &, TensorList , const Tensor &, bool unsafe);
@@ -20,6 +23,14 @@ using gather_fn = void (*)(Tensor & result, const Tensor & self, int64_t dim, co
 using scatter_fn = void(*)(Tensor& self, int64_t dim, const Tensor& index, const Tensor& src);
 using scatter_fill_fn = void(*)(Tensor& self, int64_t dim, const Tensor& index, Scalar src);
 using scatter_add_fn = void(*)(Tensor& self, int64_t dim, const Tensor& index, const Tensor& src);
+// self is contiguous of size [outer, n, inner] and index is contiguous with
+// either the sizes of self or the size [n]; result and, for Max and Min, arg are of size
+// [outer, output_size, inner]. arg is the position along n of the value
+// taken, or n if nothing was scattered to the element.
+using scatter_reduce_fn = void(*)(Tensor& result, Tensor& arg, const Tensor& self, const Tensor& index, ScatterReduceOp op);
+// Like scatter_reduce_fn, but segment s of data is [offsets[s], offsets[s + 1])
+// along n, with offsets a tensor of num_segments + 1 int64 values.
+using segment_reduce_fn = void(*)(Tensor& result, Tensor& arg, const Tensor& data, const Tensor& offsets, ScatterReduceOp op);
 
 DECLARE_DISPATCH(index_fn, index_stub);
 DECLARE_DISPATCH(index_put_fn, index_put_stub);
@@ -30,6 +41,8 @@ DECLARE_DISPATCH(gather_fn, gather_stub);
 DECLARE_DISPATCH(scatter_fn, scatter_stub);
 DECLARE_DISPATCH(scatter_fill_fn, scatter_fill_stub);
 DECLARE_DISPATCH(scatter_add_fn, scatter_add_stub);
+DECLARE_DISPATCH(scatter_reduce_fn, scatter_reduce_stub);
+DECLARE_DISPATCH(segment_reduce_fn, segment_reduce_stub);
 
 TORCH_API Tensor& index_out(Tensor& result, const Tensor & self, TensorList indices);
 
@@ -1,5 +1,6 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/native/TensorFactories.h>
 #include <c10/util/Optional.h>
 
 #include <c10/core/impl/DeviceGuardImplInterface.h>
@@ -31,6 +32,14 @@ static inline Tensor to_impl(const Tensor& self, const TensorOptions& options, b
 
   if (memory_format == MemoryFormat::Preserve) {
     if (self.is_non_overlapping_and_dense()) {
+      // A copy without conversion can share the data copy-on-write.
+      if (self.dtype() == options.dtype() && self.layout() == options.layout() &&
+          self.device() == options.device()) {
+        auto lazy = lazy_clone(self);
+        if (lazy.defined()) {
+          return lazy;
+        }
+      }
       // Copy all strides
       auto r = at::empty_strided(self.sizes(), self.strides(), options.memory_format(c10::nullopt));
       r.copy_(self, non_blocking);
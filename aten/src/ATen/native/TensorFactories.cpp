@@ -16,6 +16,7 @@
 #include <ATen/native/Resize.h>
 #include <ATen/native/TensorFactories.h>
 #include <c10/core/TensorOptions.h>
+#include <c10/core/impl/COW.h>
 #include <TH/THAllocator.h>
 #include <ATen/detail/CUDAHooksInterface.h>
 #include <c10/util/Exception.h>
@@ -120,13 +121,26 @@ Tensor empty_cpu(IntArrayRef size, const TensorOptions& options_, c10::optional<
   int64_t nelements = prod_intlist(size);
   auto dtype = options.dtype();
   int64_t size_bytes = nelements * dtype.itemsize();
-  auto storage_impl = c10::make_intrusive<StorageImpl>(
-      c10::StorageImpl::use_byte_size_t(),
-      dtype,
-      size_bytes,
-      allocator->allocate(size_bytes),
-      allocator,
-      /*resizeable=*/true);
+  c10::intrusive_ptr<StorageImpl> storage_impl;
+  if (size_bytes > 0 && size_bytes <= c10::StorageImpl::kInlineBufferBytes &&
+      !options.pinned_memory()) {
+    // Scalars and other tiny tensors keep their data in the StorageImpl
+    storage_impl = c10::make_intrusive<StorageImpl>(
+        c10::StorageImpl::use_byte_size_t(),
+        c10::StorageImpl::use_inline_buffer_t(),
+        dtype,
+        size_bytes,
+        allocator,
+        /*resizeable=*/true);
+  } else {
+    storage_impl = c10::make_intrusive<StorageImpl>(
+        c10::StorageImpl::use_byte_size_t(),
+        dtype,
+        size_bytes,
+        allocator->allocate(size_bytes),
+        allocator,
+        /*resizeable=*/true);
+  }
 
   auto tensor = detail::make_tensor<TensorImpl>(std::move(storage_impl), at::DispatchKey::CPU);
   // Default TensorImpl has size [0]
@@ -997,11 +1011,34 @@ Tensor from_file(std::string filename, c10::optional<bool> shared, c10::optional
 
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ clone ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
+Tensor lazy_clone(const Tensor& src) {
+  // The clone gets the whole storage of src, so src must span all of it.
+  if (!globalContext().copyOnWrite() || src.device().type() != kCPU ||
+      src.layout() != kStrided || src.is_quantized() || !src.has_storage() ||
+      src.storage_offset() != 0 || !src.is_non_overlapping_and_dense() ||
+      src.storage().nbytes() != src.numel() * src.itemsize()) {
+    return Tensor();
+  }
+  auto storage = c10::impl::cow::lazy_clone_storage(
+      *src.storage().unsafeGetStorageImpl());
+  if (!storage) {
+    return Tensor();
+  }
+  auto self = at::empty({0}, src.options());
+  self.unsafeGetTensorImpl()->set_storage(Storage(std::move(storage)));
+  self.unsafeGetTensorImpl()->set_sizes_and_strides(src.sizes(), src.strides());
+  return self;
+}
+
 Tensor clone(const Tensor& src, c10::optional<c10::MemoryFormat> optional_memory_format) {
   auto memory_format =
       optional_memory_format.value_or(MemoryFormat::Preserve);
   if (memory_format == MemoryFormat::Preserve) {
     if (src.is_non_overlapping_and_dense()) {
+      auto lazy = lazy_clone(src);
+      if (lazy.defined()) {
+        return lazy;
+      }
       // Copy all strides
       auto self = at::empty_strided(src.sizes(), src.strides(), src.options());
       self.copy_(src);
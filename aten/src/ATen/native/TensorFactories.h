@@ -1,8 +1,15 @@
 #pragma once
 
+#include <ATen/ATen.h>
 #include <c10/core/TensorOptions.h>
 
 namespace at { namespace native {
+
+// Returns a tensor sharing the data of src copy-on-write if
+// at::Context::copyOnWrite() is set and src supports it (a dense CPU tensor
+// spanning all of its storage), or an undefined tensor otherwise.
+Tensor lazy_clone(const Tensor& src);
+
 // Different combinations of row, col, and offset can lead to two cases:
 //
 // Case 1 - Trapezoid (Triangle as a special case): row + offset <= col
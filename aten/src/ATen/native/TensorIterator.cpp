@@ -1,6 +1,7 @@
 #include <ATen/native/TensorIterator.h>
 
 #include <array>
+#include <unordered_map>
 #include <ATen/ExpandUtils.h>
 #include <ATen/Parallel.h>
 #include <ATen/native/TypeProperties.h>
@@ -736,6 +737,28 @@ TensorIterator TensorIterator::reduce_op(Tensor& out1, Tensor& out2, const Tenso
   return iter;
 }
 
+TensorIterator TensorIterator::reduce_op(TensorList outs, const Tensor& a) {
+  TORCH_INTERNAL_ASSERT(outs.size() > 0);
+  auto iter = TensorIterator();
+  for (const auto& out : outs) {
+    TORCH_INTERNAL_ASSERT(out.defined());
+    TORCH_CHECK((!a.is_cuda() && !out.is_cuda()) || a.device() == out.device(),
+        "reduce_op(): expected input and outputs to be on same device, but input is on ", a.device(),
+        " and an output is on ", out.device());
+    TORCH_CHECK(out.sizes() == outs[0].sizes() && out.strides() == outs[0].strides(),
+        "reduce_op(): expected all outputs to have the same sizes and strides, but got ",
+        outs[0].sizes(), " with strides ", outs[0].strides(), " and ", out.sizes(),
+        " with strides ", out.strides());
+    iter.add_output(out);
+  }
+  iter.add_input(a);
+  iter.promote_gpu_output_dtypes_ = true;
+  iter.resize_outputs_ = false;
+  iter.is_reduction_ = true;
+  iter.build();
+  return iter;
+}
+
 void TensorIterator::mark_outputs() {
   for (int i = 0; i < num_outputs_; i++) {
     operands_[i].is_output = true;
@@ -1042,6 +1065,122 @@ FastSetupType TensorIterator::compute_fast_setup_type() {
   return FastSetupType::NONE;
 }
 
+// Note [TensorIterator plan cache]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// When fast_set_up() does not apply, build() computes the broadcast strides,
+// reorders and coalesces dimensions and picks the layout of outputs it has to
+// allocate. The result only depends on the iteration shape, on the sizes,
+// strides, element sizes and roles of the operands, and on a few flags, so it
+// is cached per thread under a key made of exactly those values. Serving
+// loops that see the same geometry over and over only pay for building the
+// key and one hash lookup. Cached plans never hold on to tensors.
+
+namespace {
+
+struct IterationPlan {
+  DimVector shape;
+  DimVector perm;
+  SmallVector<StrideVector, 4> stride_bytes;
+  // sizes and strides (in elements) of each output the iterator allocated;
+  // empty for outputs that were provided
+  SmallVector<std::pair<DimVector, DimVector>, 1> allocations;
+  bool has_coalesced_dimensions;
+};
+
+struct PlanKeyHash {
+  size_t operator()(const TensorIterator::PlanKey& key) const {
+    size_t seed = key.size();
+    for (auto v : key) {
+      seed ^= std::hash<int64_t>()(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+    return seed;
+  }
+};
+
+constexpr size_t kMaxCachedPlans = 256;
+
+using PlanCache =
+    std::unordered_map<TensorIterator::PlanKey, IterationPlan, PlanKeyHash>;
+
+PlanCache& get_plan_cache() {
+  static thread_local PlanCache cache;
+  return cache;
+}
+
+} // namespace
+
+TensorIterator::PlanKey TensorIterator::compute_plan_key() const {
+  PlanKey key;
+  key.push_back(
+      (int64_t)is_reduction_ | (int64_t)static_shape_ << 1 |
+      (int64_t)requires_channels_last_output_ << 2 |
+      (int64_t)requires_channels_last_3d_output_ << 3);
+  key.push_back(ndim());
+  key.append(shape_.begin(), shape_.end());
+  for (auto& op : operands_) {
+    bool defined = op.tensor.defined();
+    key.push_back((int64_t)defined | (int64_t)op.is_output << 1);
+    if (defined) {
+      key.push_back(op.tensor.element_size());
+      key.push_back(op.tensor.dim());
+      if (!static_shape_) {
+        key.append(op.tensor.sizes().begin(), op.tensor.sizes().end());
+      }
+      key.append(op.tensor.strides().begin(), op.tensor.strides().end());
+    } else {
+      key.push_back(elementSize(op.target_dtype));
+    }
+  }
+  return key;
+}
+
+bool TensorIterator::apply_cached_plan(const PlanKey& key) {
+  auto& cache = get_plan_cache();
+  auto it = cache.find(key);
+  if (it == cache.end()) {
+    return false;
+  }
+  const IterationPlan& plan = it->second;
+  shape_ = plan.shape;
+  perm_ = plan.perm;
+  for (int i = 0; i < ntensors(); i++) {
+    operands_[i].stride_bytes = plan.stride_bytes[i];
+  }
+  for (int i = 0; i < num_outputs_; i++) {
+    auto& op = operands_[i];
+    const auto& allocation = plan.allocations[i];
+    if (!op.tensor.defined()) {
+      op.tensor = at::empty_strided(allocation.first, allocation.second, op.options());
+      op.current_dtype = op.target_dtype;
+    }
+  }
+  has_coalesced_dimensions_ = plan.has_coalesced_dimensions;
+  return true;
+}
+
+void TensorIterator::cache_plan(PlanKey&& key, const SmallVector<bool, 4>& allocated) const {
+  auto& cache = get_plan_cache();
+  if (cache.size() >= kMaxCachedPlans) {
+    cache.clear();
+  }
+  IterationPlan plan;
+  plan.shape = shape_;
+  plan.perm = perm_;
+  for (auto& op : operands_) {
+    plan.stride_bytes.push_back(op.stride_bytes);
+  }
+  for (int i = 0; i < num_outputs_; i++) {
+    const auto& tensor = operands_[i].tensor;
+    if (allocated[i]) {
+      plan.allocations.emplace_back(DimVector(tensor.sizes()), DimVector(tensor.strides()));
+    } else {
+      plan.allocations.emplace_back();
+    }
+  }
+  plan.has_coalesced_dimensions = has_coalesced_dimensions_;
+  cache.emplace(std::move(key), std::move(plan));
+}
+
 void TensorIterator::build() {
   // check input tensors memory format to use it during output allocation
   analyze_memory_format();
@@ -1058,21 +1197,33 @@ void TensorIterator::build() {
   compute_types();
   // try fast setup output tensor, if failed, fallback to normal setup
   if (!fast_set_up()) {
-    // compute each tensor's stride after broadcasting
-    compute_strides();
-    // re-order dimensions to improve coalescing
-    reorder_dimensions();
-    // allocate the output tensor if it's not provided
-    allocate_outputs();
-    // coalesce adjacent dimensions when possible
-    coalesce_dimensions();
+    // reuse the strides and output layout computed by an earlier iterator
+    // with the same geometry, if any
+    PlanKey key = compute_plan_key();
+    if (!apply_cached_plan(key)) {
+      SmallVector<bool, 4> allocated;
+      for (int i = 0; i < num_outputs_; i++) {
+        allocated.push_back(!operands_[i].tensor.defined());
+      }
+      // compute each tensor's stride after broadcasting
+      compute_strides();
+      // re-order dimensions to improve coalescing
+      reorder_dimensions();
+      // allocate the output tensor if it's not provided
+      allocate_outputs();
+      // coalesce adjacent dimensions when possible
+      coalesce_dimensions();
+      cache_plan(std::move(key), allocated);
+    }
   }
   // perform name inference
   propagate_names_to_outputs();
 
   for (auto& op : operands_) {
     TORCH_INTERNAL_ASSERT(op.tensor.defined());
-    op.data = op.tensor.data_ptr();
+    // Inputs are only read, so they can keep sharing copy-on-write data.
+    op.data = op.is_output ? op.tensor.data_ptr()
+                           : const_cast<void*>(op.tensor.const_data_ptr());
   }
 
   // zero out offsets
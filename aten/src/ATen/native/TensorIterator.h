@@ -151,6 +151,7 @@ struct CAFFE2_API TensorIterator {
   using DimMask = std::bitset<64>;
   using PtrVector = SmallVector<char*, 4>;
   using StrideVector = SmallVector<int64_t, 6>;
+  using PlanKey = SmallVector<int64_t, 32>;
 
   TensorIterator() {}
 
@@ -180,6 +181,7 @@ struct CAFFE2_API TensorIterator {
   static TensorIterator nullary_op(Tensor& out);
   static TensorIterator reduce_op(Tensor& out, const Tensor& a);
   static TensorIterator reduce_op(Tensor& out1, Tensor& out2, const Tensor& a);
+  static TensorIterator reduce_op(TensorList outs, const Tensor& a);
 
   int ndim() const { return shape_.size(); }
   IntArrayRef shape() const { return shape_; }
@@ -393,6 +395,11 @@ protected:
   void coalesce_dimensions();
   void analyze_memory_format();
 
+  // See Note [TensorIterator plan cache]
+  PlanKey compute_plan_key() const;
+  bool apply_cached_plan(const PlanKey& key);
+  void cache_plan(PlanKey&& key, const SmallVector<bool, 4>& allocated) const;
+
 protected:
   DimVector shape_;
   DimVector perm_;
@@ -10,6 +10,7 @@
 #include <ATen/native/Resize.h>
 #include <ATen/native/TypeProperties.h>
 #include <ATen/SparseTensorUtils.h>
+#include <ATen/NestedTensorUtils.h>
 #include <ATen/quantized/QTensorImpl.h>
 #include <ATen/NamedTensorUtils.h>
 #include <ATen/native/TensorIterator.h>
@@ -21,7 +22,7 @@
 namespace at {
 namespace native {
 
-DEFINE_DISPATCH(cat_serial_stub);
+DEFINE_DISPATCH(cat_stub);
 
 Tensor _reshape_from_tensor(const Tensor& self, const Tensor& shape_tensor) {
   TORCH_CHECK(shape_tensor.dim() == 1);
@@ -97,16 +98,18 @@ static inline void check_cat_shape_except_dim(const Tensor & first, const Tensor
   }
 }
 
-Tensor & _cat_out_cpu(Tensor& result, TensorList tensors, int64_t dim) {
-  // previously, size [0] tensors were the only possible empty tensors; thus, it wasn't possible
-  // to cat empty tensors unless all the other tensors were 1-dimensional, so we allowed these tensors
-  // to be "skipped".  We maintain this behavior for backwards compatibility, but only for this specific
-  // size (i.e. other empty sizes are not skipped).
-  // FIXME: warn if this is the case
-  bool allSkipped = true;
-  bool allContiguous = true;
-  Tensor notSkippedTensor;
+static inline bool cat_kernel_supports(const Tensor& t) {
+  return t.device().type() == kCPU && t.layout() == kStrided &&
+      !t.is_quantized() && t.scalar_type() != ScalarType::ComplexHalf;
+}
+
+// Whether cat_stub can be used to copy tensors into result.
+static bool can_use_cat_kernel(const Tensor& result, TensorList tensors) {
+  return cat_kernel_supports(result) && result.is_contiguous() &&
+      std::all_of(tensors.begin(), tensors.end(), cat_kernel_supports);
+}
 
+static void check_cat_no_overlap(const Tensor& result, TensorList tensors) {
   // Inputs cannot alias the output tensor
   for (int64_t i = 0; i < tensors.size(); i++) {
     auto lap = at::get_overlap_status(result, tensors[i]);
@@ -115,6 +118,18 @@ Tensor & _cat_out_cpu(Tensor& result, TensorList tensors, int64_t dim) {
         "unsupported operation: the input tensors cannot refer to any of the "
         "output memory locations. Found overlap in input tensor ", i);
   }
+}
+
+Tensor & _cat_out_cpu(Tensor& result, TensorList tensors, int64_t dim) {
+  // previously, size [0] tensors were the only possible empty tensors; thus, it wasn't possible
+  // to cat empty tensors unless all the other tensors were 1-dimensional, so we allowed these tensors
+  // to be "skipped".  We maintain this behavior for backwards compatibility, but only for this specific
+  // size (i.e. other empty sizes are not skipped).
+  // FIXME: warn if this is the case
+  bool allSkipped = true;
+  Tensor notSkippedTensor;
+
+  check_cat_no_overlap(result, tensors);
 
   auto should_skip = [](const Tensor& t) { return t.numel() == 0 && t.dim() == 1; };
   for (auto const &tensor : tensors) {
@@ -133,30 +148,17 @@ Tensor & _cat_out_cpu(Tensor& result, TensorList tensors, int64_t dim) {
   TORCH_CHECK(tensors.size() > 0, "expected a non-empty list of Tensors");
   TORCH_CHECK(dim <= notSkippedTensor.dim(), "dimension ", dim, "out of range");
 
-  // when the input tensors are of the same size and strides,
-  // reuse the same iterator for all input tensors
-  bool reuse_iterator = true;
-
   // compute size of the result in the cat dimension
   int64_t cat_dim_size = 0;
+  std::vector<Tensor> inputs;
+  inputs.reserve(tensors.size());
   for (auto const &tensor : tensors) {
     if (should_skip(tensor)) {
-      // don't use fast path for empty tensor
-      allContiguous = false;
       continue;
     }
     check_cat_shape_except_dim(notSkippedTensor, tensor, dim);
     cat_dim_size += tensor.size(dim);
-
-    if (!tensor.is_contiguous()) {
-      allContiguous = false;
-    }
-
-    if (tensor.sizes() != notSkippedTensor.sizes() ||
-        tensor.strides() != notSkippedTensor.strides() ||
-        tensor.dtype() != notSkippedTensor.dtype()) {
-      reuse_iterator = false;
-    }
+    inputs.push_back(tensor);
   }
 
   // compute the size of the result
@@ -164,57 +166,24 @@ Tensor & _cat_out_cpu(Tensor& result, TensorList tensors, int64_t dim) {
   result_size[dim] = cat_dim_size;
   result.resize_(result_size);
 
-  // fast path for single thread when both inputs and result are contiguous and not empty
-  bool use_serial_kernel = result.numel() < at::internal::GRAIN_SIZE || at::get_num_threads() == 1;
-  allContiguous = allContiguous && result.is_contiguous();
-  ScalarType dtype = notSkippedTensor.scalar_type();
-  if (use_serial_kernel && allContiguous && (dtype == ScalarType::Double || dtype == ScalarType::Float)) {
-    cat_serial_stub(kCPU, result, tensors, dim);
+  if (can_use_cat_kernel(result, inputs)) {
+    cat_stub(kCPU, result, inputs, dim);
     return result;
   }
 
   int64_t offset = 0;
-  if (reuse_iterator && result.is_contiguous()) {
-    auto source_slice = notSkippedTensor;
-    auto slice_dim_size = source_slice.size(dim);
-    auto result_slice = result.narrow(dim, 0, slice_dim_size);
-    auto result_slice_data = result_slice.data_ptr();
-    auto result_stride_bytes = result.stride(dim) * elementSize(result.scalar_type());
+  for (auto const &tensor: inputs) {
+    auto slice_dim_size = tensor.size(dim);
+    auto result_slice = result.narrow(dim, offset, slice_dim_size);
 
     auto iter = TensorIterator();
     iter.dont_resize_outputs();
     iter.add_output(result_slice);
-    iter.add_input(source_slice);
+    iter.add_input(tensor);
+    iter.promote_common_dtype();
     iter.build();
-
-    for (auto const &tensor : tensors) {
-      if (should_skip(tensor)) {
-        continue;
-      }
-      auto source_data = static_cast<char*>(tensor.data_ptr());
-      auto result_data = static_cast<char*>(result_slice_data) + offset * result_stride_bytes;
-      iter.unsafe_replace_operand(0, result_data);
-      iter.unsafe_replace_operand(1, source_data);
-      copy_stub(iter.device_type(), iter, false);
-      offset += slice_dim_size;
-    }
-  } else {
-    for (auto const &tensor: tensors) {
-      if (should_skip(tensor)) {
-        continue;
-      }
-      auto slice_dim_size = tensor.size(dim);
-      auto result_slice = result.narrow(dim, offset, slice_dim_size);
-
-      auto iter = TensorIterator();
-      iter.dont_resize_outputs();
-      iter.add_output(result_slice);
-      iter.add_input(tensor);
-      iter.promote_common_dtype();
-      iter.build();
-      copy_stub(iter.device_type(), iter, false);
-      offset += slice_dim_size;
-    }
+    copy_stub(iter.device_type(), iter, false);
+    offset += slice_dim_size;
   }
 
   return result;
@@ -1042,23 +1011,50 @@ std::vector<Tensor> split_with_sizes(const Tensor& self, IntArrayRef split_sizes
 }
 
 // Precondition: tensors is non-empty
-static inline std::vector<Tensor> get_stack_inputs(TensorList tensors, int64_t dim) {
-  std::vector<Tensor> inputs(tensors.size());
+static inline void check_stack_inputs(TensorList tensors) {
   at::IntArrayRef entry_shape = tensors[0].sizes();
-  inputs[0] = tensors[0].unsqueeze(dim);
   for (size_t i = 1; i < tensors.size(); ++i) {
     TORCH_CHECK(tensors[i].sizes() == entry_shape,
       "stack expects each tensor to be equal size, but got ", entry_shape,
       " at entry 0 and ", tensors[i].sizes(), " at entry ", i);
+  }
+}
+
+// Precondition: tensors is non-empty
+static inline std::vector<Tensor> get_stack_inputs(TensorList tensors, int64_t dim) {
+  check_stack_inputs(tensors);
+  std::vector<Tensor> inputs(tensors.size());
+  for (size_t i = 0; i < tensors.size(); ++i) {
     inputs[i] = tensors[i].unsqueeze(dim);
   }
   return inputs;
 }
 
+// On CPU, stack copies the tensors as they are with cat_stub, without
+// creating unsqueezed views of them and going through cat.
+static inline bool can_use_cat_kernel_for_stack(TensorList tensors) {
+  return !at::has_names(tensors) &&
+      std::all_of(tensors.begin(), tensors.end(), cat_kernel_supports);
+}
+
+static inline std::vector<int64_t> stack_result_size(TensorList tensors, int64_t dim) {
+  auto result_size = tensors[0].sizes().vec();
+  result_size.insert(result_size.begin() + dim, tensors.size());
+  return result_size;
+}
+
 Tensor stack(TensorList tensors, int64_t dim) {
   TORCH_CHECK(tensors.size() > 0,
            "stack expects a non-empty TensorList");
   dim = maybe_wrap_dim(dim, tensors[0].dim() + 1);
+  if (can_use_cat_kernel_for_stack(tensors)) {
+    check_stack_inputs(tensors);
+    Tensor result = at::empty(
+        stack_result_size(tensors, dim),
+        tensors[0].options().dtype(result_type(tensors)));
+    cat_stub(kCPU, result, tensors, dim);
+    return result;
+  }
   return at::cat(get_stack_inputs(tensors, dim), dim);
 }
 
@@ -1066,6 +1062,15 @@ Tensor& stack_out(Tensor& result, TensorList tensors, int64_t dim) {
   TORCH_CHECK(tensors.size() > 0,
            "stack expects a non-empty TensorList");
   dim = maybe_wrap_dim(dim, tensors[0].dim() + 1);
+  if (can_use_cat_kernel_for_stack(tensors) && cat_kernel_supports(result)) {
+    check_stack_inputs(tensors);
+    check_cat_no_overlap(result, tensors);
+    result.resize_(stack_result_size(tensors, dim));
+    if (result.is_contiguous()) {
+      cat_stub(kCPU, result, tensors, dim);
+      return result;
+    }
+  }
   return at::cat_out(result, get_stack_inputs(tensors, dim), dim);
 }
 
@@ -1393,6 +1398,18 @@ int64_t numel(const Tensor& self) {
 
 std::vector<Tensor> unbind(const Tensor &self, int64_t dim) {
   dim = maybe_wrap_dim(dim, self.dim());
+  if (self.is_nested()) {
+    // The entries, as views of the buffer without padding.
+    TORCH_CHECK(dim == 0, "unbind(): a nested tensor can only be unbound along dim 0");
+    auto impl = at::nested::get_nested_impl(self);
+    Tensor buffer = impl->buffer();
+    const int64_t* offsets = impl->offsets().data_ptr<int64_t>();
+    std::vector<Tensor> entries(impl->num_entries());
+    for (int64_t i = 0; i < impl->num_entries(); i++) {
+      entries[i] = buffer.narrow(0, offsets[i], offsets[i + 1] - offsets[i]);
+    }
+    return entries;
+  }
   int64_t size = self.size(dim);
   std::vector<Tensor> tensors(size);
   for (int i = 0; i < size; i++) {
@@ -18,6 +18,7 @@
 #include <ATen/Parallel.h>
 #include <ATen/native/UnaryOps.h>
 #include <ATen/native/TensorIterator.h>
+#include <ATen/native/xnnpack/Engine.h>
 #include <ATen/NamedTensorUtils.h>
 
 #include <algorithm>
@@ -318,6 +319,19 @@ Tensor& clamp_out(Tensor& result, const Tensor& self, optional<Scalar> min, opti
 }
 
 Tensor clamp(const Tensor& self, optional<Scalar> min, optional<Scalar> max) {
+// Disable the xnnpack operators for both iOS and macOS temporarily due to the crash in pthreadpool
+// TODO:T66297472 remove `!defined(__APPLE__)` once we figure out the root cause of the crash.
+#if defined(C10_MOBILE) && !defined(__APPLE__)
+  if (min || max) {
+    const float output_min =
+        min ? min->to<float>() : -std::numeric_limits<float>::infinity();
+    const float output_max =
+        max ? max->to<float>() : std::numeric_limits<float>::infinity();
+    if (xnnpack::use_clamp(self, output_min, output_max)) {
+      return xnnpack::clamp(self, output_min, output_max);
+    }
+  }
+#endif
   Tensor result = at::empty({0}, self.options());
   return at::clamp_out(result, self, min, max);
 }
@@ -2,17 +2,96 @@
 
 #include <ATen/ATen.h>
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <c10/util/flat_hash_map.h>
 
+#include <algorithm>
+#include <numeric>
 #include <set>
 #include <tuple>
-#include <unordered_map>
-#include <unordered_set>
+#include <vector>
 
 namespace at {
 namespace native{
 
 namespace {
 
+// Note [Parallel unique on CPU]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// unique splits the input into one chunk per thread and scatters the
+// elements of every chunk into partitions by hash, so that equal elements end
+// up in the same partition, in the order of the input. Every partition is then
+// deduplicated by its own thread with a flat_hash_map, which also gives the
+// inverse indices and the counts in the same pass. The unique values of the
+// partitions are concatenated, and sorted if requested, after which the
+// inverse indices are offset by the start of their partition (or mapped to
+// their sorted position).
+//
+// unique_consecutive counts the runs in every chunk first, so that every
+// chunk knows where its runs start in the output.
+//
+// Small inputs are deduplicated on the calling thread as a single partition.
+
+// The partition of a hash. It is mixed with the finalizer of MurmurHash3
+// first, so that it does not depend on the bits flat_hash_map uses to place
+// the elements of a partition, and identity hashes of integers are spread.
+inline int64_t partition_of(size_t hash, int64_t npartitions) {
+  uint64_t h = hash;
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return static_cast<int64_t>(h % static_cast<uint64_t>(npartitions));
+}
+
+inline int64_t num_unique_chunks(int64_t numel) {
+  if (numel < internal::GRAIN_SIZE || at::in_parallel_region()) {
+    return 1;
+  }
+  return std::min<int64_t>(
+      at::get_num_threads(), divup(numel, internal::GRAIN_SIZE));
+}
+
+template <typename scalar_t>
+struct UniquePartition {
+  std::vector<scalar_t> values;
+  std::vector<int64_t> counts;
+};
+
+// Deduplicates data[0, n) in the order of first occurrence. If inverse is
+// given, the id of every element in values is written to inverse[indices[i]],
+// or to inverse[i] if indices is null.
+template <typename scalar_t>
+void unique_partition(
+    const scalar_t* data,
+    const int64_t* indices,
+    int64_t n,
+    bool return_counts,
+    int64_t* inverse,
+    UniquePartition<scalar_t>& partition) {
+  ska::flat_hash_map<scalar_t, int64_t> ids;
+  for (int64_t i = 0; i < n; i++) {
+    const int64_t next_id = partition.values.size();
+    // Every NaN is unique. They are kept out of the map, where they would
+    // all collide.
+    const bool is_nan = data[i] != data[i];
+    const int64_t id = is_nan ? next_id : ids.emplace(data[i], next_id).first->second;
+    if (id == next_id) {
+      partition.values.push_back(data[i]);
+      if (return_counts) {
+        partition.counts.push_back(0);
+      }
+    }
+    if (return_counts) {
+      partition.counts[id]++;
+    }
+    if (inverse) {
+      inverse[indices ? indices[i] : i] = id;
+    }
+  }
+}
+
 template <typename scalar_t>
 std::tuple<Tensor, Tensor, Tensor> unique_cpu_template(
     const Tensor& self,
@@ -22,49 +101,153 @@ std::tuple<Tensor, Tensor, Tensor> unique_cpu_template(
   const Tensor& input = self.contiguous();
   const scalar_t* input_data = input.data_ptr<scalar_t>();
   int64_t numel = input.numel();
-  Tensor output;
   Tensor inverse_indices = at::empty({0}, self.options().dtype(kLong));
   Tensor counts = at::empty({0}, self.options().dtype(kLong));
-
-  std::unordered_set<scalar_t> set(input_data, input_data + numel);
-  output = at::empty({static_cast<int64_t>(set.size())}, input.options());
-  scalar_t *output_data = output.data_ptr<scalar_t>();
-
-  if (sorted) {
-    std::vector<scalar_t> vec(set.begin(), set.end());
-    std::sort(vec.begin(), vec.end());
-    std::copy(vec.begin(), vec.end(), output_data);
-  } else {
-    std::copy(set.begin(), set.end(), output_data);
+  int64_t* inverse_data = nullptr;
+  if (return_inverse) {
+    inverse_indices.resize_(input.sizes());
+    inverse_data = inverse_indices.data_ptr<int64_t>();
   }
 
-  if (return_inverse || return_counts) {
-    inverse_indices.resize_(input.sizes());
-    int64_t* inverse_indices_data = inverse_indices.data_ptr<int64_t>();
-    std::unordered_map<scalar_t, int64_t> inverse_map;
-    inverse_map.reserve(output.numel());
-    for (int64_t i = 0; i < output.numel(); ++i) {
-      inverse_map[output_data[i]] = i;
+  const int64_t nchunks = num_unique_chunks(numel);
+  // A few partitions per thread, as they are not equally large.
+  const int64_t npartitions = nchunks == 1 ? 1 : 4 * nchunks;
+  std::vector<UniquePartition<scalar_t>> partitions(npartitions);
+  // Where every partition starts in the scattered input.
+  std::vector<int64_t> partition_begin(npartitions + 1, 0);
+  Tensor scattered_indices;
+
+  if (npartitions == 1) {
+    unique_partition(
+        input_data, nullptr, numel, return_counts, inverse_data, partitions[0]);
+    partition_begin[1] = numel;
+  } else {
+    const int64_t chunk_size = divup(numel, nchunks);
+    // offsets[c * npartitions + p] is the number of elements of chunk c in
+    // partition p, and then where they are scattered to.
+    std::vector<int64_t> offsets(nchunks * npartitions, 0);
+    std::hash<scalar_t> hash;
+    at::parallel_for(0, nchunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        int64_t* chunk_offsets = offsets.data() + c * npartitions;
+        const int64_t chunk_end = std::min(numel, (c + 1) * chunk_size);
+        for (int64_t i = c * chunk_size; i < chunk_end; i++) {
+          chunk_offsets[partition_of(hash(input_data[i]), npartitions)]++;
+        }
+      }
+    });
+    int64_t offset = 0;
+    for (int64_t p = 0; p < npartitions; p++) {
+      partition_begin[p] = offset;
+      for (int64_t c = 0; c < nchunks; c++) {
+        const int64_t count = offsets[c * npartitions + p];
+        offsets[c * npartitions + p] = offset;
+        offset += count;
+      }
     }
-    for(int64_t i = 0; i < numel; ++i) {
-      inverse_indices_data[i] = inverse_map[input_data[i]];
+    partition_begin[npartitions] = offset;
+
+    Tensor scattered = at::empty({numel}, input.options());
+    scalar_t* scattered_data = scattered.data_ptr<scalar_t>();
+    int64_t* scattered_indices_data = nullptr;
+    if (return_inverse) {
+      scattered_indices = at::empty({numel}, self.options().dtype(kLong));
+      scattered_indices_data = scattered_indices.data_ptr<int64_t>();
     }
-    if (return_counts) {
-      std::unordered_map<scalar_t, int64_t> counts_map;
-      counts_map.reserve(output.numel());
-      for (int64_t i = 0; i < output.numel(); ++i) {
-        counts_map[output_data[i]] = 0;
+    at::parallel_for(0, nchunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        int64_t* chunk_offsets = offsets.data() + c * npartitions;
+        const int64_t chunk_end = std::min(numel, (c + 1) * chunk_size);
+        for (int64_t i = c * chunk_size; i < chunk_end; i++) {
+          const int64_t pos =
+              chunk_offsets[partition_of(hash(input_data[i]), npartitions)]++;
+          scattered_data[pos] = input_data[i];
+          if (scattered_indices_data) {
+            scattered_indices_data[pos] = i;
+          }
+        }
       }
-      for(int64_t i = 0; i < numel; i++) {
-        counts_map[input_data[i]] += 1;
+    });
+
+    at::parallel_for(0, npartitions, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t p = begin; p < end; p++) {
+        unique_partition(
+            scattered_data + partition_begin[p],
+            scattered_indices_data ? scattered_indices_data + partition_begin[p] : nullptr,
+            partition_begin[p + 1] - partition_begin[p],
+            return_counts,
+            inverse_data,
+            partitions[p]);
       }
-      counts.resize_(output.sizes());
-      counts.fill_(0);
-      int64_t *counts_data = counts.data_ptr<int64_t>();
-      for(int64_t i = 0; i < output.numel(); i++) {
-        counts_data[i] = counts_map[output_data[i]];
+    });
+  }
+
+  // Where the unique values of every partition start in the output.
+  std::vector<int64_t> output_begin(npartitions + 1, 0);
+  for (int64_t p = 0; p < npartitions; p++) {
+    output_begin[p + 1] = output_begin[p] + partitions[p].values.size();
+  }
+  const int64_t num_unique = output_begin[npartitions];
+  Tensor output = at::empty({num_unique}, input.options());
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+  int64_t* counts_data = nullptr;
+  if (return_counts) {
+    counts.resize_({num_unique});
+    counts_data = counts.data_ptr<int64_t>();
+  }
+  at::parallel_for(0, npartitions, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t p = begin; p < end; p++) {
+      std::copy(
+          partitions[p].values.begin(),
+          partitions[p].values.end(),
+          output_data + output_begin[p]);
+      if (return_counts) {
+        std::copy(
+            partitions[p].counts.begin(),
+            partitions[p].counts.end(),
+            counts_data + output_begin[p]);
+      }
+    }
+  });
+  partitions.clear();
+
+  // rank[i] is the position of the unique value i after sorting.
+  std::vector<int64_t> rank;
+  if (sorted) {
+    std::vector<int64_t> order(num_unique);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int64_t a, int64_t b) {
+      return output_data[a] < output_data[b];
+    });
+    rank.resize(num_unique);
+    std::vector<scalar_t> values(num_unique);
+    std::vector<int64_t> sorted_counts(return_counts ? num_unique : 0);
+    for (int64_t i = 0; i < num_unique; i++) {
+      rank[order[i]] = i;
+      values[i] = output_data[order[i]];
+      if (return_counts) {
+        sorted_counts[i] = counts_data[order[i]];
       }
     }
+    std::copy(values.begin(), values.end(), output_data);
+    std::copy(sorted_counts.begin(), sorted_counts.end(), counts_data);
+  }
+
+  // The inverse indices are ids within their partition so far.
+  if (return_inverse && (sorted || npartitions > 1)) {
+    const int64_t* scattered_indices_data =
+        npartitions > 1 ? scattered_indices.data_ptr<int64_t>() : nullptr;
+    at::parallel_for(0, npartitions, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t p = begin; p < end; p++) {
+        for (int64_t pos = partition_begin[p]; pos < partition_begin[p + 1]; pos++) {
+          int64_t& id = inverse_data[scattered_indices_data ? scattered_indices_data[pos] : pos];
+          id += output_begin[p];
+          if (sorted) {
+            id = rank[id];
+          }
+        }
+      }
+    });
   }
   return std::make_tuple(output, inverse_indices, counts);
 }
@@ -87,33 +270,57 @@ std::tuple<Tensor, Tensor, Tensor> unique_consecutive_cpu_template(
 
   if (numel > 0) {
     scalar_t *output_data = output.data_ptr<scalar_t>();
-    int64_t *inverse_data = inverse_indices.data_ptr<int64_t>();;
-    int64_t *counts_data = nullptr;
-    *output_data = *input_data;
-
-    if (return_counts) {
-      counts.resize_({numel});
-      counts_data = counts.data_ptr<int64_t>();
-    }
-    scalar_t *p = output_data;
-    int64_t *q = counts_data;
-    int64_t last = 0;
-    for (int64_t i = 0; i < numel; i++) {
-      if (input_data[i] != *p) {
-        *(++p) = input_data[i];
-        if (return_counts) {
-          *(q++) = i - last;
-          last = i;
+    int64_t *inverse_data = return_inverse ? inverse_indices.data_ptr<int64_t>() : nullptr;
+
+    // run_begin[c] is the number of runs that start before chunk c.
+    const int64_t nchunks = num_unique_chunks(numel);
+    const int64_t chunk_size = divup(numel, nchunks);
+    std::vector<int64_t> run_begin(nchunks + 1, 0);
+    auto starts_run = [&](int64_t i) {
+      return i == 0 || input_data[i] != input_data[i - 1];
+    };
+    at::parallel_for(0, nchunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        const int64_t chunk_end = std::min(numel, (c + 1) * chunk_size);
+        int64_t runs = 0;
+        for (int64_t i = c * chunk_size; i < chunk_end; i++) {
+          runs += starts_run(i);
         }
+        run_begin[c + 1] = runs;
       }
-      if (return_inverse) {
-        inverse_data[i] = p - output_data;
+    });
+    std::partial_sum(run_begin.begin(), run_begin.end(), run_begin.begin());
+    const int64_t output_size = run_begin[nchunks];
+
+    // Where every run starts in the input, turned into counts below.
+    std::vector<int64_t> run_starts(return_counts ? output_size + 1 : 0);
+    at::parallel_for(0, nchunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        const int64_t chunk_end = std::min(numel, (c + 1) * chunk_size);
+        int64_t run = run_begin[c] - 1;
+        for (int64_t i = c * chunk_size; i < chunk_end; i++) {
+          if (starts_run(i)) {
+            output_data[++run] = input_data[i];
+            if (return_counts) {
+              run_starts[run] = i;
+            }
+          }
+          if (return_inverse) {
+            inverse_data[i] = run;
+          }
+        }
       }
-    }
-    int64_t output_size = p - output_data + 1;
+    });
+
     if (return_counts) {
-      *q = numel - last;
+      run_starts[output_size] = numel;
       counts.resize_({output_size});
+      int64_t *counts_data = counts.data_ptr<int64_t>();
+      at::parallel_for(0, output_size, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+        for (int64_t run = begin; run < end; run++) {
+          counts_data[run] = run_starts[run + 1] - run_starts[run];
+        }
+      });
     }
     output.resize_({output_size});
   }
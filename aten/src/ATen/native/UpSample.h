@@ -56,6 +56,10 @@ DECLARE_DISPATCH(upsampling_1d, upsample_nearest1d_backward_kernel);
 DECLARE_DISPATCH(upsampling_2d, upsample_nearest2d_backward_kernel);
 DECLARE_DISPATCH(upsampling_3d, upsample_nearest3d_backward_kernel);
 
+using upsampling_bilinear2d = void(*)(Tensor& output, const Tensor& input, bool align_corners, scale_t scales_h, scale_t scales_w);
+// Forward of upsample_bilinear2d for a channels last input and output.
+DECLARE_DISPATCH(upsampling_bilinear2d, upsample_bilinear2d_channels_last_kernel);
+
 static inline void upsample_1d_shape_check(
     const Tensor& input,
     const Tensor& grad_output,
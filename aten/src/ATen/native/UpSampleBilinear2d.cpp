@@ -7,6 +7,9 @@
 
 namespace at {
 namespace native {
+
+DEFINE_DISPATCH(upsample_bilinear2d_channels_last_kernel);
+
 namespace {
 
 template <typename scalar_t>
@@ -188,15 +191,22 @@ static void upsample_bilinear2d_out_cpu_template(
       output_height,
       output_width);
 
+  AT_ASSERT(
+      input_height > 0 && input_width > 0 && output_height > 0 &&
+      output_width > 0);
+
+  if (input_.suggest_memory_format() == at::MemoryFormat::ChannelsLast &&
+      input_.scalar_type() != at::ScalarType::Half) {
+    output.resize_({nbatch, channels, output_height, output_width}, at::MemoryFormat::ChannelsLast);
+    upsample_bilinear2d_channels_last_kernel(kCPU, output, input_, align_corners, scales_h, scales_w);
+    return;
+  }
+
   auto input = input_.contiguous();
 
   output.resize_({nbatch, channels, output_height, output_width});
   output.zero_();
 
-  AT_ASSERT(
-      input_height > 0 && input_width > 0 && output_height > 0 &&
-      output_width > 0);
-
   AT_DISPATCH_FLOATING_TYPES_AND_HALF(input.scalar_type(), "upsample_bilinear2d", [&] {
     auto* idata = input.data_ptr<scalar_t>();
     auto* odata = output.data_ptr<scalar_t>();
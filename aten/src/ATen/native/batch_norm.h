@@ -11,6 +11,7 @@ using batch_norm_fn = void (*)(Tensor&, const Tensor&, const Tensor&,
     const Tensor&, const Tensor&, const Tensor&, double);
 
 DECLARE_DISPATCH(batch_norm_fn, batch_norm_cpu_inference_contiguous_stub);
+DECLARE_DISPATCH(batch_norm_fn, batch_norm_cpu_inference_channels_last_stub);
 
 } // namespace native
 
@@ -0,0 +1,96 @@
+#include <ATen/ATen.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/AdaptivePooling.h>
+
+namespace at {
+namespace native {
+
+namespace {
+
+// Adaptive average pooling of an NHWC input: the window of every output
+// pixel is summed into the output row of its channels, Vec::size() channels
+// at a time, and scaled by the window size at the end.
+template <typename scalar_t>
+void cpu_adaptive_avg_pool2d_channels_last(
+    Tensor& output_,
+    const Tensor& input_,
+    IntArrayRef output_size) {
+  using Vec = vec256::Vec256<scalar_t>;
+
+  auto input = input_.contiguous(at::MemoryFormat::ChannelsLast);
+  auto output = output_.contiguous(at::MemoryFormat::ChannelsLast);
+
+  const auto* input_data = input.data_ptr<scalar_t>();
+  auto* output_data = output.data_ptr<scalar_t>();
+
+  const int64_t nbatch = input.size(0);
+  const int64_t channels = input.size(1);
+  const int64_t input_height = input.size(2);
+  const int64_t input_width = input.size(3);
+  const int64_t output_height = output_size[0];
+  const int64_t output_width = output_size[1];
+
+  // cost of the average window of a single channel
+  const int64_t window = std::max<int64_t>(
+      1, ((input_height + output_height - 1) / output_height) *
+          ((input_width + output_width - 1) / output_width));
+  const int64_t grain_size = std::max<int64_t>(
+      1, at::internal::GRAIN_SIZE / std::max<int64_t>(channels * window, 1));
+
+  at::parallel_for(0, nbatch * output_height * output_width, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      const int64_t ow = i % output_width;
+      const int64_t oh = (i / output_width) % output_height;
+      const int64_t n = i / (output_width * output_height);
+
+      const int64_t ih0 = start_index(oh, output_height, input_height);
+      const int64_t ih1 = end_index(oh, output_height, input_height);
+      const int64_t iw0 = start_index(ow, output_width, input_width);
+      const int64_t iw1 = end_index(ow, output_width, input_width);
+
+      scalar_t* out = output_data + i * channels;
+
+      for (int64_t c = 0; c < channels; c += Vec::size()) {
+        Vec(0).store(out + c, std::min<int64_t>(Vec::size(), channels - c));
+      }
+      for (int64_t ih = ih0; ih < ih1; ih++) {
+        for (int64_t iw = iw0; iw < iw1; iw++) {
+          const scalar_t* in = input_data +
+              ((n * input_height + ih) * input_width + iw) * channels;
+          for (int64_t c = 0; c < channels; c += Vec::size()) {
+            const int64_t count = std::min<int64_t>(Vec::size(), channels - c);
+            (Vec::loadu(out + c, count) + Vec::loadu(in + c, count)).store(out + c, count);
+          }
+        }
+      }
+      const Vec scale(scalar_t(1) / ((ih1 - ih0) * (iw1 - iw0)));
+      for (int64_t c = 0; c < channels; c += Vec::size()) {
+        const int64_t count = std::min<int64_t>(Vec::size(), channels - c);
+        (Vec::loadu(out + c, count) * scale).store(out + c, count);
+      }
+    }
+  });
+
+  if (!output_.is_contiguous(at::MemoryFormat::ChannelsLast)) {
+    output_.copy_(output);
+  }
+}
+
+void adaptive_avg_pool2d_channels_last_kernel_impl(
+    Tensor& output,
+    const Tensor& input,
+    IntArrayRef output_size) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "adaptive_avg_pool2d_channels_last", [&] {
+    cpu_adaptive_avg_pool2d_channels_last<scalar_t>(output, input, output_size);
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(adaptive_avg_pool2d_channels_last_kernel, &adaptive_avg_pool2d_channels_last_kernel_impl);
+
+} // namespace native
+} // namespace at
@@ -1,75 +1,174 @@
 #include <ATen/ATen.h>
 
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
 #include <ATen/native/cpu/CatKernel.h>
-#include <ATen/cpu/vec256/functional.h>
-#include <ATen/cpu/vec256/vec256.h>
+#include <c10/util/TypeCast.h>
+
+#include <algorithm>
+#include <cstring>
 
 namespace at { namespace native {
 
 namespace {
 
+// An input seen as [outer, inner], where outer spans its dims before dim and
+// inner those from dim on. Row i of the result is the concatenation of the
+// inner parts of all inputs at outer index i. The inner dims are coalesced,
+// so that a non-contiguous input is still copied in runs that are as long as
+// possible, and a contiguous one with a single memcpy per row.
 struct InputMeta {
-  void* data_ptr;
-  int64_t inner_size;
+  const char* data_ptr;
+  ScalarType dtype;
+  // Whether dtype differs from the dtype of the result.
+  bool needs_cast;
+  int64_t element_size;
+  IntArrayRef outer_strides;
+  DimVector inner_sizes;
+  DimVector inner_strides;
+  int64_t inner_numel;
+  // Where the input starts in a row of the result.
+  int64_t row_offset;
 
-  InputMeta(const Tensor& t, int64_t dim, int64_t inner)
-    : data_ptr(t.data_ptr())
-    , inner_size(t.size(dim) * inner) {}
+  InputMeta(const Tensor& t, int64_t dim, int64_t offset, ScalarType result_dtype)
+    : data_ptr(static_cast<const char*>(t.data_ptr()))
+    , dtype(t.scalar_type())
+    , needs_cast(dtype != result_dtype)
+    , element_size(t.element_size())
+    , outer_strides(t.strides().slice(0, dim))
+    , inner_numel(1)
+    , row_offset(offset) {
+    // Innermost dim first while coalescing, reversed at the end.
+    for (int64_t d = t.dim() - 1; d >= dim; d--) {
+      const int64_t size = t.size(d);
+      const int64_t stride = t.stride(d);
+      inner_numel *= size;
+      if (size == 1) {
+        continue;
+      }
+      if (!inner_sizes.empty() &&
+          inner_strides.back() * inner_sizes.back() == stride) {
+        inner_sizes.back() *= size;
+      } else {
+        inner_sizes.push_back(size);
+        inner_strides.push_back(stride);
+      }
+    }
+    if (inner_sizes.empty()) {
+      inner_sizes.push_back(1);
+      inner_strides.push_back(1);
+    }
+    std::reverse(inner_sizes.begin(), inner_sizes.end());
+    std::reverse(inner_strides.begin(), inner_strides.end());
+  }
 };
 
 template <typename scalar_t>
-void cat_serial_kernel_impl(Tensor& result, TensorList tensors, int64_t dim) {
-  auto size = result.sizes().vec();
-  int64_t outer = 1, inner = 1;
-  for (int64_t i = 0; i < dim; i++) {
-    outer *= size[i];
+inline void copy_run(
+    scalar_t* out,
+    const char* src,
+    int64_t size,
+    int64_t stride,
+    const InputMeta& input) {
+  if (!input.needs_cast) {
+    auto src_data = reinterpret_cast<const scalar_t*>(src);
+    if (stride == 1) {
+      std::memcpy(out, src_data, size * sizeof(scalar_t));
+    } else {
+      for (int64_t k = 0; k < size; k++) {
+        out[k] = src_data[k * stride];
+      }
+    }
+  } else {
+    const int64_t stride_bytes = stride * input.element_size;
+    for (int64_t k = 0; k < size; k++) {
+      out[k] = c10::fetch_and_cast<scalar_t>(input.dtype, src + k * stride_bytes);
+    }
   }
-  for (int64_t i = dim + 1; i < size.size(); i++) {
-    inner *= size[i];
+}
+
+// Copies the inner part of input at the given outer offset (in bytes) to out.
+template <typename scalar_t>
+void copy_inner(scalar_t* out, const InputMeta& input, const char* src) {
+  const int64_t ndim = input.inner_sizes.size();
+  const int64_t run_size = input.inner_sizes[ndim - 1];
+  const int64_t run_stride = input.inner_strides[ndim - 1];
+  if (ndim == 1) {
+    copy_run(out, src, run_size, run_stride, input);
+    return;
   }
-  scalar_t* result_data = result.data_ptr<scalar_t>();
-  int64_t ninputs = tensors.size();
-  std::vector<InputMeta> inputs;
-  inputs.reserve(ninputs);
-  for (auto const &tensor : tensors) {
-    inputs.emplace_back(tensor, dim, inner);
+  DimVector counter(ndim - 1, 0);
+  for (int64_t done = 0; done < input.inner_numel; done += run_size) {
+    int64_t offset = 0;
+    for (int64_t d = 0; d < ndim - 1; d++) {
+      offset += counter[d] * input.inner_strides[d];
+    }
+    copy_run(out + done, src + offset * input.element_size, run_size, run_stride, input);
+    for (int64_t d = ndim - 2; d >= 0; d--) {
+      if (++counter[d] < input.inner_sizes[d]) {
+        break;
+      }
+      counter[d] = 0;
+    }
+  }
+}
+
+template <typename scalar_t>
+void cat_kernel_impl(Tensor& result, TensorList tensors, int64_t dim) {
+  const auto outer_sizes = result.sizes().slice(0, dim);
+  const int64_t outer = prod_intlist(outer_sizes);
+  if (result.numel() == 0 || outer == 0) {
+    return;
   }
- 
-  using Vec = vec256::Vec256<scalar_t>;
+  const int64_t row_size = result.numel() / outer;
+
+  std::vector<InputMeta> inputs;
+  inputs.reserve(tensors.size());
   int64_t offset = 0;
-  for (int64_t i = 0; i < outer; i++) {
-    for (int64_t j = 0; j < ninputs; j++) {
-      scalar_t* result_ptr = result_data + offset;
-      int64_t local_inner = inputs[j].inner_size;
-      scalar_t* input_ptr = (scalar_t*)(inputs[j].data_ptr) + i * local_inner;
-      if (local_inner < Vec::size()) {
-        #ifndef _MSC_VER
-        # pragma unroll
-        #endif
-        for (int64_t k = 0; k < local_inner; k++) {
-          result_ptr[k] = input_ptr[k];
-        }
-      } else {
-        vec256::map(
-            [](Vec x) { return x; },
-            result_ptr,
-            input_ptr,
-            local_inner);
+  for (const auto& tensor : tensors) {
+    inputs.emplace_back(tensor, dim, offset, result.scalar_type());
+    offset += inputs.back().inner_numel;
+  }
+  TORCH_INTERNAL_ASSERT(offset == row_size);
+
+  // One work item is the copy of one input into one row, in the order of the
+  // result so that every thread writes a contiguous range of it.
+  const int64_t ninputs = inputs.size();
+  const int64_t nitems = outer * ninputs;
+  const int64_t grain_size =
+      std::max<int64_t>(1, internal::GRAIN_SIZE * nitems / result.numel());
+  scalar_t* result_data = result.data_ptr<scalar_t>();
+
+  at::parallel_for(0, nitems, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t item = begin; item < end; item++) {
+      const int64_t i = item / ninputs;
+      const auto& input = inputs[item % ninputs];
+      if (input.inner_numel == 0) {
+        continue;
+      }
+      int64_t outer_offset = 0;
+      int64_t remaining = i;
+      for (int64_t d = dim - 1; d >= 0; d--) {
+        outer_offset += (remaining % outer_sizes[d]) * input.outer_strides[d];
+        remaining /= outer_sizes[d];
       }
-      offset += local_inner;
+      copy_inner(
+          result_data + i * row_size + input.row_offset,
+          input,
+          input.data_ptr + outer_offset * input.element_size);
     }
-  }
+  });
 }
 
-void cat_serial_kernel(Tensor& result, TensorList tensors, int64_t dim) {
-  AT_DISPATCH_FLOATING_TYPES(result.scalar_type(), "cat_serial_kernel", [&]() {
-    cat_serial_kernel_impl<scalar_t>(result, tensors, dim);
+void cat_kernel(Tensor& result, TensorList tensors, int64_t dim) {
+  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(kBool, kHalf, kBFloat16,
+      result.scalar_type(), "cat_cpu", [&]() {
+    cat_kernel_impl<scalar_t>(result, tensors, dim);
   });
 }
 
 } // anonymous namespace
 
-REGISTER_DISPATCH(cat_serial_stub, &cat_serial_kernel);
+REGISTER_DISPATCH(cat_stub, &cat_kernel);
 
 }} // at::native
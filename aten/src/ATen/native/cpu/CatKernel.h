@@ -5,7 +5,13 @@
 
 namespace at { namespace native {
 
-using cat_serial_fn = void(*)(Tensor &, TensorList, int64_t);
-DECLARE_DISPATCH(cat_serial_fn, cat_serial_stub);
+// Copies tensors one after the other into every row of the contiguous
+// result, where a row spans the result dims from dim on and the part of each
+// tensor in a row spans its dims from dim on. This is cat along dim when the
+// tensors have the dims of the result, and stack along dim when they have one
+// dim less. The tensors may have any strides and any dtype castable to the
+// dtype of result, which must not be a quantized type or ComplexHalf.
+using cat_fn = void(*)(Tensor &, TensorList, int64_t);
+DECLARE_DISPATCH(cat_fn, cat_stub);
 
 }}  // namespace at::native
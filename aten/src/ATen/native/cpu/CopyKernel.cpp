@@ -1,6 +1,9 @@
 #include <ATen/ATen.h>
 
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/intrinsics.h>
+#include <ATen/cpu/vec256/vec256.h>
 #include <ATen/native/Copy.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
@@ -10,9 +13,262 @@ namespace at {
 namespace native {
 namespace {
 
+// Note [Transposing copies]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~
+// A copy whose output is contiguous along one dim and whose input is
+// contiguous along another one, e.g. x.t().contiguous() or NCHW <-> NHWC,
+// strides through the input in the element-wise loop and uses a single
+// element of every cache line it reads. Such copies are instead done in
+// tiles of kTransposeTile x kTransposeTile elements, so that both the rows
+// read from the input and the rows written to the output of a tile stay in
+// L1, and every tile is transposed in 8x8 blocks held in registers. The tiles
+// of all the other dims are copied in parallel. As the elements are only
+// moved, the kernel works on their bytes and handles every dtype of the same
+// size alike.
+
+constexpr int64_t kTransposeTile = 64;
+constexpr int64_t kTransposeBlock = 8;
+
+// out[j * ld_out + i] = in[i * ld_in + j] for i < ni and j < nj.
+template <typename scalar_t>
+inline void transpose_block(
+    const scalar_t* in, int64_t ld_in, scalar_t* out, int64_t ld_out,
+    int64_t ni, int64_t nj) {
+  for (int64_t j = 0; j < nj; j++) {
+    for (int64_t i = 0; i < ni; i++) {
+      out[j * ld_out + i] = in[i * ld_in + j];
+    }
+  }
+}
+
+template <typename scalar_t>
+inline void transpose_block_8x8(
+    const scalar_t* in, int64_t ld_in, scalar_t* out, int64_t ld_out) {
+  transpose_block(in, ld_in, out, ld_out, kTransposeBlock, kTransposeBlock);
+}
+
+#if (defined(CPU_CAPABILITY_AVX) || defined(CPU_CAPABILITY_AVX2)) && !defined(_MSC_VER)
+template <>
+inline void transpose_block_8x8<uint32_t>(
+    const uint32_t* in, int64_t ld_in, uint32_t* out, int64_t ld_out) {
+  auto src = reinterpret_cast<const float*>(in);
+  auto dst = reinterpret_cast<float*>(out);
+  __m256 r0 = _mm256_loadu_ps(src + 0 * ld_in);
+  __m256 r1 = _mm256_loadu_ps(src + 1 * ld_in);
+  __m256 r2 = _mm256_loadu_ps(src + 2 * ld_in);
+  __m256 r3 = _mm256_loadu_ps(src + 3 * ld_in);
+  __m256 r4 = _mm256_loadu_ps(src + 4 * ld_in);
+  __m256 r5 = _mm256_loadu_ps(src + 5 * ld_in);
+  __m256 r6 = _mm256_loadu_ps(src + 6 * ld_in);
+  __m256 r7 = _mm256_loadu_ps(src + 7 * ld_in);
+  // Interleave pairs of rows, then pairs of those, which leaves column c in
+  // the low lane of s[c % 4] and s[c % 4 + 4] for c < 4, and in their high
+  // lane for c >= 4.
+  __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+  __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+  __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+  __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+  __m256 t4 = _mm256_unpacklo_ps(r4, r5);
+  __m256 t5 = _mm256_unpackhi_ps(r4, r5);
+  __m256 t6 = _mm256_unpacklo_ps(r6, r7);
+  __m256 t7 = _mm256_unpackhi_ps(r6, r7);
+  __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+  __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+  __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+  __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+  __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+  __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+  __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+  __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+  _mm256_storeu_ps(dst + 0 * ld_out, _mm256_permute2f128_ps(s0, s4, 0x20));
+  _mm256_storeu_ps(dst + 1 * ld_out, _mm256_permute2f128_ps(s1, s5, 0x20));
+  _mm256_storeu_ps(dst + 2 * ld_out, _mm256_permute2f128_ps(s2, s6, 0x20));
+  _mm256_storeu_ps(dst + 3 * ld_out, _mm256_permute2f128_ps(s3, s7, 0x20));
+  _mm256_storeu_ps(dst + 4 * ld_out, _mm256_permute2f128_ps(s0, s4, 0x31));
+  _mm256_storeu_ps(dst + 5 * ld_out, _mm256_permute2f128_ps(s1, s5, 0x31));
+  _mm256_storeu_ps(dst + 6 * ld_out, _mm256_permute2f128_ps(s2, s6, 0x31));
+  _mm256_storeu_ps(dst + 7 * ld_out, _mm256_permute2f128_ps(s3, s7, 0x31));
+}
+#endif
+
+template <typename scalar_t>
+void transpose_tile(
+    const scalar_t* in, int64_t ld_in, scalar_t* out, int64_t ld_out,
+    int64_t ni, int64_t nj) {
+  const int64_t ni_blocked = ni - ni % kTransposeBlock;
+  const int64_t nj_blocked = nj - nj % kTransposeBlock;
+  for (int64_t i = 0; i < ni_blocked; i += kTransposeBlock) {
+    for (int64_t j = 0; j < nj_blocked; j += kTransposeBlock) {
+      transpose_block_8x8(in + i * ld_in + j, ld_in, out + j * ld_out + i, ld_out);
+    }
+    transpose_block(
+        in + i * ld_in + nj_blocked, ld_in, out + nj_blocked * ld_out + i, ld_out,
+        kTransposeBlock, nj - nj_blocked);
+  }
+  transpose_block(
+      in + ni_blocked * ld_in, ld_in, out + ni_blocked, ld_out,
+      ni - ni_blocked, nj);
+}
+
+// The dim along which the input of a copy is contiguous, if the output is
+// contiguous along dim 0 and the both are large enough for the copy to be
+// worth transposing in tiles (see Note [Transposing copies]), or -1.
+int transpose_copy_dim(TensorIterator& iter) {
+  const int64_t element_size = iter.element_size(0);
+  if (iter.ndim() < 2 || iter.dtype(0) != iter.dtype(1) ||
+      (element_size != 1 && element_size != 2 && element_size != 4 &&
+       element_size != 8)) {
+    return -1;
+  }
+  auto out_strides = iter.strides(0);
+  auto in_strides = iter.strides(1);
+  auto shape = iter.shape();
+  if (out_strides[0] != element_size || in_strides[0] == element_size ||
+      in_strides[0] == 0 || shape[0] < kTransposeBlock) {
+    return -1;
+  }
+  for (int dim = 1; dim < iter.ndim(); dim++) {
+    if (in_strides[dim] == element_size && out_strides[dim] != 0 &&
+        shape[dim] >= kTransposeBlock) {
+      return dim;
+    }
+  }
+  return -1;
+}
+
+template <typename scalar_t>
+void transpose_copy_kernel(TensorIterator& iter, int dim) {
+  const int64_t element_size = sizeof(scalar_t);
+  auto shape = iter.shape();
+  auto out_strides = iter.strides(0);
+  auto in_strides = iter.strides(1);
+  const int64_t ni = shape[0];
+  const int64_t nj = shape[dim];
+  const int64_t ld_in = in_strides[0] / element_size;
+  const int64_t ld_out = out_strides[dim] / element_size;
+
+  // The remaining dims, which are iterated over as a batch, in bytes.
+  DimVector batch_shape, batch_out_strides, batch_in_strides;
+  for (int d = 1; d < iter.ndim(); d++) {
+    if (d != dim) {
+      batch_shape.push_back(shape[d]);
+      batch_out_strides.push_back(out_strides[d]);
+      batch_in_strides.push_back(in_strides[d]);
+    }
+  }
+  const int64_t tiles_i = divup(ni, kTransposeTile);
+  const int64_t tiles_j = divup(nj, kTransposeTile);
+  const int64_t ntiles = prod_intlist(batch_shape) * tiles_i * tiles_j;
+  char* out_data = static_cast<char*>(iter.data_ptr(0));
+  const char* in_data = static_cast<const char*>(iter.data_ptr(1));
+
+  const int64_t grain_size = std::max<int64_t>(
+      1, internal::GRAIN_SIZE / (kTransposeTile * kTransposeTile));
+  at::parallel_for(0, ntiles, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t tile = begin; tile < end; tile++) {
+      const int64_t tj = tile % tiles_j;
+      const int64_t ti = (tile / tiles_j) % tiles_i;
+      int64_t batch = tile / (tiles_j * tiles_i);
+      int64_t out_offset = 0;
+      int64_t in_offset = 0;
+      for (int64_t d = batch_shape.size() - 1; d >= 0; d--) {
+        const int64_t index = batch % batch_shape[d];
+        batch /= batch_shape[d];
+        out_offset += index * batch_out_strides[d];
+        in_offset += index * batch_in_strides[d];
+      }
+      const int64_t i = ti * kTransposeTile;
+      const int64_t j = tj * kTransposeTile;
+      auto in = reinterpret_cast<const scalar_t*>(in_data + in_offset) + i * ld_in + j;
+      auto out = reinterpret_cast<scalar_t*>(out_data + out_offset) + j * ld_out + i;
+      transpose_tile(
+          in, ld_in, out, ld_out,
+          std::min(kTransposeTile, ni - i), std::min(kTransposeTile, nj - j));
+    }
+  });
+}
+
+void transpose_copy(TensorIterator& iter, int dim) {
+  switch (iter.element_size(0)) {
+    case 1:
+      return transpose_copy_kernel<uint8_t>(iter, dim);
+    case 2:
+      return transpose_copy_kernel<uint16_t>(iter, dim);
+    case 4:
+      return transpose_copy_kernel<uint32_t>(iter, dim);
+    case 8:
+      return transpose_copy_kernel<uint64_t>(iter, dim);
+    default:
+      TORCH_INTERNAL_ASSERT(false, "Unexpected element size");
+  }
+}
+
+// Note [Vectorized dtype conversions]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The conversions of casts like .half(), .bfloat16() or .long() go through
+// the vec256::convert specializations where there is one, the loop of
+// cpu_kernel not being vectorized by the compiler for them. They give the
+// same results as static_cast_with_inter_type: the floating point ones round
+// to nearest even and the integral ones keep the low bits. The inner loops
+// whose operands are not both contiguous are left to cpu_kernel.
+
+template <typename dst_t, typename src_t>
+void convert_copy_kernel(TensorIterator& iter) {
+  iter.for_each([&](char** data, const int64_t* strides, int64_t n) {
+    if (strides[0] == sizeof(dst_t) && strides[1] == sizeof(src_t)) {
+      vec256::convert(
+          reinterpret_cast<const src_t*>(data[1]), reinterpret_cast<dst_t*>(data[0]), n);
+      return;
+    }
+    for (int64_t i = 0; i < n; i++) {
+      auto src = *reinterpret_cast<const src_t*>(data[1] + i * strides[1]);
+      *reinterpret_cast<dst_t*>(data[0] + i * strides[0]) =
+          c10::static_cast_with_inter_type<dst_t, src_t>::apply(src);
+    }
+  });
+}
+
+// Whether the conversion of the copy has been done, see Note [Vectorized
+// dtype conversions].
+bool vectorized_convert_copy(TensorIterator& iter) {
+  const ScalarType dst = iter.dtype(0);
+  const ScalarType src = iter.dtype(1);
+  if (dst == ScalarType::Half && src == ScalarType::Float) {
+    convert_copy_kernel<at::Half, float>(iter);
+  } else if (dst == ScalarType::Float && src == ScalarType::Half) {
+    convert_copy_kernel<float, at::Half>(iter);
+  } else if (dst == ScalarType::BFloat16 && src == ScalarType::Float) {
+    convert_copy_kernel<at::BFloat16, float>(iter);
+  } else if (dst == ScalarType::Float && src == ScalarType::BFloat16) {
+    convert_copy_kernel<float, at::BFloat16>(iter);
+  } else if (dst == ScalarType::Int && src == ScalarType::Long) {
+    convert_copy_kernel<int32_t, int64_t>(iter);
+  } else if (dst == ScalarType::Long && src == ScalarType::Int) {
+    convert_copy_kernel<int64_t, int32_t>(iter);
+  } else if (dst == ScalarType::Float && src == ScalarType::Int) {
+    convert_copy_kernel<float, int32_t>(iter);
+  } else if (dst == ScalarType::Char && src == ScalarType::Float) {
+    convert_copy_kernel<int8_t, float>(iter);
+  } else if (dst == ScalarType::Float && src == ScalarType::Char) {
+    convert_copy_kernel<float, int8_t>(iter);
+  } else if (dst == ScalarType::Byte && src == ScalarType::Float) {
+    convert_copy_kernel<uint8_t, float>(iter);
+  } else if (dst == ScalarType::Float && src == ScalarType::Byte) {
+    convert_copy_kernel<float, uint8_t>(iter);
+  } else {
+    return false;
+  }
+  return true;
+}
+
 static void copy_kernel(TensorIterator& iter, bool non_blocking) {
   ScalarType dtype = iter.dtype(0);
   if (dtype == iter.dtype(1)) {
+    const int dim = transpose_copy_dim(iter);
+    if (dim > 0) {
+      transpose_copy(iter, dim);
+      return;
+    }
     if (dtype == ScalarType::Half) {
       cpu_kernel(iter, [=](at::Half a) -> at::Half { return a; });
     } else if (dtype == ScalarType::BFloat16) {
@@ -39,7 +295,7 @@ static void copy_kernel(TensorIterator& iter, bool non_blocking) {
                 [=](Vec256<scalar_t> a) { return a; });
           });
     }
-  } else {
+  } else if (!vectorized_convert_copy(iter)) {
     AT_DISPATCH_ALL_TYPES_AND_C10_COMPLEX_AND3(ScalarType::Half, ScalarType::Bool, ScalarType::BFloat16, dtype, "copy_", [&] {
       using dest_t = scalar_t;
       AT_DISPATCH_ALL_TYPES_AND_C10_COMPLEX_AND3(ScalarType::Half, ScalarType::Bool, ScalarType::BFloat16, iter.dtype(1), "copy_", [&] {
@@ -3,6 +3,7 @@
 #include <numeric>
 #include <iterator>
 #include <algorithm>
+#include <limits>
 
 #include <ATen/Dispatch.h>
 #include <ATen/Parallel.h>
@@ -193,6 +194,18 @@ struct Dist {
     }
   }
 
+  // Rows of t1 and t2 handled by one task of run_parallel_cdist
+  static constexpr int64_t cdist_block_rows = 64;
+  static constexpr int64_t cdist_block_cols = 256;
+  // Number of Vecs of distances computed at once
+  static constexpr int64_t cdist_tile_vecs = 4;
+
+  // The distances are vectorized over the rows of t2 rather than over the
+  // features, so that they need no horizontal reduction and work for any
+  // number of features. A task computes a block of the result: it packs a
+  // tile of t2 rows transposed, so that one feature of all rows of the tile
+  // is one contiguous run of Vecs, and runs every row of t1 in the block
+  // against it. The tile stays in L1 and the block of t1 in L2.
   template <typename F>
   static void run_parallel_cdist(Tensor& result, const Tensor& t1, const Tensor& t2, const scalar_t p) {
     const scalar_t * const t1_start = t1.data_ptr<scalar_t>();
@@ -203,40 +216,62 @@ struct Dist {
     int64_t m = t1.size(-1);
 
     scalar_t * const res_start = result.data_ptr<scalar_t>();
-    int64_t combs = r1 * r2;
-    int64_t size1 = r1 * m;
-    int64_t size2 = r2 * m;
+    const int64_t row_blocks = (r1 + cdist_block_rows - 1) / cdist_block_rows;
+    const int64_t col_blocks = (r2 + cdist_block_cols - 1) / cdist_block_cols;
+    const int64_t blocks = row_blocks * col_blocks;
+    constexpr int64_t tile = cdist_tile_vecs * Vec::size();
 
-    parallel_for(0, combs * d, internal::GRAIN_SIZE / (16 * m), [=](int64_t start, int64_t end) {
-      scalar_t * res = res_start + start;
-      const scalar_t * const res_end = res_start + end;
-      int64_t l = start / combs;
-      int64_t k = start % combs;
-      int64_t i = k / r2;
-      int64_t j = k % r2;
-      i = i * m;
-      j = j * m;
-
-      while (res != res_end) {
-        const scalar_t * self_i = t1_start + size1 * l + i;
-        const scalar_t * self_j = t2_start + size2 * l + j;
-
-        scalar_t agg = 0;
-        for (int x = 0; x < m; x++) {
-          scalar_t a = *(self_i + x);
-          scalar_t b = *(self_j + x);
-          agg = F::red(agg, F::map(std::abs(a-b), p));
-        }
-        *res = F::finish(agg, p);
+    // A block is at least cdist_block_rows * cdist_block_cols distances.
+    parallel_for(0, d * blocks, 1, [=](int64_t start, int64_t end) {
+      const Vec pvec(p);
+      std::vector<scalar_t> packed(m * tile);
+      scalar_t agg[tile];
+
+      for (int64_t task = start; task < end; task++) {
+        const int64_t l = task / blocks;
+        const int64_t i_begin = (task % blocks) / col_blocks * cdist_block_rows;
+        const int64_t i_end = std::min(i_begin + cdist_block_rows, r1);
+        const int64_t j_begin = task % col_blocks * cdist_block_cols;
+        const int64_t j_end = std::min(j_begin + cdist_block_cols, r2);
+        const scalar_t * const t1_l = t1_start + l * r1 * m;
+        const scalar_t * const t2_l = t2_start + l * r2 * m;
+        scalar_t * const res_l = res_start + l * r1 * r2;
+
+        for (int64_t j = j_begin; j < j_end; j += tile) {
+          const int64_t cols = std::min(tile, j_end - j);
+          // Zero padding for the missing rows, whose distances are dropped.
+          for (int64_t c = 0; c < cols; c++) {
+            const scalar_t * const row = t2_l + (j + c) * m;
+            for (int64_t x = 0; x < m; x++) {
+              packed[x * tile + c] = row[x];
+            }
+          }
+          for (int64_t c = cols; c < tile; c++) {
+            for (int64_t x = 0; x < m; x++) {
+              packed[x * tile + c] = 0;
+            }
+          }
 
-        res += 1;
-        j += m;
-        if (j == size2) {
-          j = 0;
-          i += m;
-          if (i == size1) {
-            i = 0;
-            l += 1;
+          for (int64_t i = i_begin; i < i_end; i++) {
+            const scalar_t * const self_i = t1_l + i * m;
+            Vec acc[cdist_tile_vecs];
+            for (int64_t v = 0; v < cdist_tile_vecs; v++) {
+              acc[v] = Vec(0);
+            }
+            for (int64_t x = 0; x < m; x++) {
+              const Vec a(self_i[x]);
+              const scalar_t * const b = packed.data() + x * tile;
+              for (int64_t v = 0; v < cdist_tile_vecs; v++) {
+                acc[v] = F::red(acc[v], F::map((a - Vec::loadu(b + v * Vec::size())).abs(), pvec));
+              }
+            }
+            for (int64_t v = 0; v < cdist_tile_vecs; v++) {
+              acc[v].store(agg + v * Vec::size());
+            }
+            scalar_t * const res = res_l + i * r2 + j;
+            for (int64_t c = 0; c < cols; c++) {
+              res[c] = F::finish(agg[c], p);
+            }
           }
         }
       }
@@ -245,16 +280,76 @@ struct Dist {
 
   static void apply_cdist(Tensor& result, const Tensor& x1, const Tensor& x2, const scalar_t p) {
     if (p == 0.0) {
-      run_parallel_cdist<zdist_calc<scalar_t>>(result, x1, x2, p);
+      run_parallel_cdist<zdist_calc<Vec>>(result, x1, x2, p);
     } else if (p == 1.0) {
-      run_parallel_cdist<odist_calc<scalar_t>>(result, x1, x2, p);
+      run_parallel_cdist<odist_calc<Vec>>(result, x1, x2, p);
     } else if (p == 2.0) {
-      run_parallel_cdist<tdist_calc<scalar_t>>(result, x1, x2, p);
+      run_parallel_cdist<tdist_calc<Vec>>(result, x1, x2, p);
     } else if (std::isinf(p)) {
-      run_parallel_cdist<idist_calc<scalar_t>>(result, x1, x2, p);
+      run_parallel_cdist<idist_calc<Vec>>(result, x1, x2, p);
     } else {
-      run_parallel_cdist<pdist_calc<scalar_t>>(result, x1, x2, p);
+      run_parallel_cdist<pdist_calc<Vec>>(result, x1, x2, p);
+    }
+  }
+
+  // A distance computed from the norms is recomputed directly when it is
+  // below this many epsilons times the sum of the squared norms, where the
+  // cancellation in ||x1||^2 + ||x2||^2 - 2 x1 x2 leaves too few correct bits.
+  static constexpr scalar_t euclidean_inexact_eps = 4096;
+
+  static scalar_t euclidean_dist_direct(const scalar_t * a, const scalar_t * b, int64_t m) {
+    scalar_t agg = 0;
+    for (int64_t x = 0; x < m; x++) {
+      const scalar_t diff = a[x] - b[x];
+      agg += diff * diff;
     }
+    return std::sqrt(agg);
+  }
+
+  static void apply_euclidean_dist_finish(Tensor& dist, const Tensor& x1, const Tensor& x2, const Tensor& x1_norm, const Tensor& x2_norm) {
+    const int64_t r1 = dist.size(0);
+    const int64_t r2 = dist.size(1);
+    const int64_t m = x1.size(1);
+    const int64_t dist_stride = dist.stride(0);
+    const int64_t x1_stride = x1.stride(0);
+    const int64_t x2_stride = x2.stride(0);
+    scalar_t * const dist_start = dist.data_ptr<scalar_t>();
+    const scalar_t * const x1_start = x1.data_ptr<scalar_t>();
+    const scalar_t * const x2_start = x2.data_ptr<scalar_t>();
+    const scalar_t * const x1_norm_start = x1_norm.data_ptr<scalar_t>();
+    const scalar_t * const x2_norm_start = x2_norm.data_ptr<scalar_t>();
+    const scalar_t tol = euclidean_inexact_eps * std::numeric_limits<scalar_t>::epsilon();
+    constexpr int all_exact = (1 << Vec::size()) - 1;
+
+    parallel_for(0, r1, std::max<int64_t>(1, internal::GRAIN_SIZE / r2), [=](int64_t start, int64_t end) {
+      for (int64_t i = start; i < end; i++) {
+        scalar_t * const res = dist_start + i * dist_stride;
+        const scalar_t * const self_i = x1_start + i * x1_stride;
+        const scalar_t norm_i = x1_norm_start[i];
+        int64_t j = 0;
+        for (; j + Vec::size() <= r2; j += Vec::size()) {
+          const Vec norms = Vec(norm_i) + Vec::loadu(x2_norm_start + j);
+          const Vec sq = norms - Vec(2) * Vec::loadu(res + j);
+          vec256::maximum(sq, Vec(0)).sqrt().store(res + j);
+          // Lanes of the comparison are zero where the distance is exact.
+          const int exact = (sq < norms * Vec(tol)).zero_mask();
+          if (exact != all_exact) {
+            for (int64_t k = 0; k < Vec::size(); k++) {
+              if (!(exact & (1 << k))) {
+                res[j + k] = euclidean_dist_direct(self_i, x2_start + (j + k) * x2_stride, m);
+              }
+            }
+          }
+        }
+        for (; j < r2; j++) {
+          const scalar_t norms = norm_i + x2_norm_start[j];
+          const scalar_t sq = norms - 2 * res[j];
+          res[j] = sq < norms * tol ?
+              euclidean_dist_direct(self_i, x2_start + j * x2_stride, m) :
+              std::sqrt(std::max(sq, scalar_t(0)));
+        }
+      }
+    });
   }
 
   // This does a backward pass down a Vec column of the input
@@ -426,6 +521,12 @@ static void cdist_kernel_impl(Tensor& result, const Tensor& x1, const Tensor& x2
   });
 }
 
+static void euclidean_dist_finish_kernel_impl(Tensor& dist, const Tensor& x1, const Tensor& x2, const Tensor& x1_norm, const Tensor& x2_norm) {
+  AT_DISPATCH_FLOATING_TYPES(dist.scalar_type(), "euclidean_dist_finish", [&] {
+    Dist<scalar_t>::apply_euclidean_dist_finish(dist, x1, x2, x1_norm, x2_norm);
+  });
+}
+
 static void cdist_backward_kernel_impl(Tensor& result, const Tensor& grad, const Tensor& x1, const Tensor& x2, const double p, const Tensor& dist) {
   AT_DISPATCH_FLOATING_TYPES(result.scalar_type(), "cdist_backward", [&] {
     Dist<scalar_t>::apply_backward_cdist(result, grad, x1, x2, p, dist);
@@ -439,5 +540,6 @@ REGISTER_DISPATCH(pdist_forward_stub, &pdist_forward_kernel_impl);
 REGISTER_DISPATCH(pdist_backward_stub, &pdist_backward_kernel_impl);
 REGISTER_DISPATCH(cdist_stub, &cdist_kernel_impl);
 REGISTER_DISPATCH(cdist_backward_stub, &cdist_backward_kernel_impl);
+REGISTER_DISPATCH(euclidean_dist_finish_stub, &euclidean_dist_finish_kernel_impl);
 
 }}  // namespace at::native
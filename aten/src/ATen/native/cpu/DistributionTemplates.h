@@ -1,9 +1,13 @@
 #pragma once
 
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
 #include <ATen/core/DistributionsHelper.h>
+#include <ATen/core/PhiloxRNGEngine.h>
+#include <ATen/cpu/vec256/vec256.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
+#include <algorithm>
 #include <limits>
 #include <mutex>
 
@@ -303,4 +307,152 @@ struct ExponentialKernel {
   }
 };
 
+// ==================================================== Philox ========================================================
+
+// Note [Counter-based CPU random fills]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The kernels above draw from the mt19937 engine of the generator, which can
+// only be advanced sequentially, so they hold the generator lock and run on a
+// single thread. A CPUGeneratorImpl in Philox mode instead hands out a range
+// of its counter-based Philox stream per fill (see
+// CPUGeneratorImpl::philox_engine_inputs). Element i of a fill is made from
+// the 32 bit randoms at positions [i * k, (i + 1) * k) of that range, with
+// k = 2 for double and k = 1 otherwise. Philox can skip to any position in
+// constant time, so every chunk of a parallel_for starts its own engine at
+// its first element, and the fill produces the same values regardless of the
+// number of threads.
+//
+// These kernels are only instantiated with CPUGeneratorImpl.
+
+namespace philox {
+
+template <typename scalar_t>
+constexpr int64_t randoms_per_element() {
+  return std::is_same<scalar_t, double>::value ? 2 : 1;
+}
+
+// The number of 128 bit numbers read by a fill of `numel` elements.
+template <typename scalar_t>
+uint64_t increment(int64_t numel) {
+  return (numel * randoms_per_element<scalar_t>() + 3) / 4;
+}
+
+// An engine at the 32 bit random `position` of the range that starts at the
+// 128 bit `offset` of the stream of `seed`.
+inline at::Philox4_32_10 engine_at(uint64_t seed, uint64_t offset, int64_t position) {
+  at::Philox4_32_10 engine(seed, 0, offset + position / 4);
+  for (int64_t i = 0; i < position % 4; i++) {
+    engine();
+  }
+  return engine;
+}
+
+template <typename scalar_t>
+inline uint64_t next_bits(at::Philox4_32_10& engine) {
+  if (randoms_per_element<scalar_t>() == 2) {
+    const uint64_t hi = engine();
+    const uint64_t lo = engine();
+    return (hi << 32) | lo;
+  }
+  return engine();
+}
+
+template <typename scalar_t>
+void normal_fill_16_vec(scalar_t *data, const scalar_t mean, const scalar_t std) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const Vec one(1);
+  const Vec minus_two(-2);
+  const Vec two_pi(2.0f * M_PI);
+  const Vec mean_v(mean);
+  const Vec std_v(std);
+  for (int j = 0; j < 8; j += Vec::size()) {
+    const Vec u1 = one - Vec::loadu(data + j); // [0, 1) -> (0, 1] for log.
+    const Vec u2 = Vec::loadu(data + j + 8);
+    const Vec radius = (minus_two * u1.log()).sqrt();
+    const Vec theta = two_pi * u2;
+    (radius * theta.cos() * std_v + mean_v).store(data + j);
+    (radius * theta.sin() * std_v + mean_v).store(data + j + 8);
+  }
+}
+
+inline void normal_fill_16(float *data, const float mean, const float std) {
+  normal_fill_16_vec<float>(data, mean, std);
+}
+
+inline void normal_fill_16(double *data, const double mean, const double std) {
+  normal_fill_16_vec<double>(data, mean, std);
+}
+
+inline void normal_fill_16(at::Half *data, const at::Half mean, const at::Half std) {
+  cpu::normal_fill_16<at::Half>(data, mean, std);
+}
+
+} // namespace philox
+
+template<typename RNG>
+void uniform_philox_kernel(TensorIterator& iter, double from, double to, RNG generator) {
+  Tensor self = iter.tensor(0);
+  Tensor out = self.is_contiguous() ? self : at::empty_like(self, MemoryFormat::Contiguous);
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(self.scalar_type(), "uniform_philox_kernel_cpu", [&]() {
+    const int64_t numel = out.numel();
+    std::pair<uint64_t, uint64_t> seed_and_offset;
+    {
+      // See Note [Acquire lock when using random generators]
+      std::lock_guard<std::mutex> lock(generator->mutex_);
+      seed_and_offset = generator->philox_engine_inputs(philox::increment<scalar_t>(numel));
+    }
+    const auto from_ = static_cast<scalar_t>(from);
+    const auto to_ = static_cast<scalar_t>(to);
+    scalar_t* data = out.data_ptr<scalar_t>();
+    at::parallel_for(0, numel, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      auto engine = philox::engine_at(
+          seed_and_offset.first, seed_and_offset.second, begin * philox::randoms_per_element<scalar_t>());
+      for (int64_t i = begin; i < end; i++) {
+        data[i] = static_cast<scalar_t>(
+            uniform_real_transformation<scalar_t>(philox::next_bits<scalar_t>(engine), from_, to_));
+      }
+    });
+  });
+  if (!out.is_same(self)) {
+    self.copy_(out);
+  }
+}
+
+template<typename RNG>
+void normal_philox_kernel(Tensor& self, double mean, double std, RNG generator) {
+  Tensor out = self.is_contiguous() ? self : at::empty_like(self, MemoryFormat::Contiguous);
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(self.scalar_type(), "normal_philox_kernel_cpu", [&] {
+    // Box-Muller turns groups of 16 uniforms into 16 normals, so the last,
+    // partial group reads 16 uniforms as well.
+    const int64_t numel = out.numel();
+    const int64_t num_groups = (numel + 15) / 16;
+    std::pair<uint64_t, uint64_t> seed_and_offset;
+    {
+      // See Note [Acquire lock when using random generators]
+      std::lock_guard<std::mutex> lock(generator->mutex_);
+      seed_and_offset = generator->philox_engine_inputs(philox::increment<scalar_t>(num_groups * 16));
+    }
+    const auto mean_ = static_cast<scalar_t>(mean);
+    const auto std_ = static_cast<scalar_t>(std);
+    scalar_t* data = out.data_ptr<scalar_t>();
+    at::parallel_for(0, num_groups, internal::GRAIN_SIZE / 16, [&](int64_t begin, int64_t end) {
+      auto engine = philox::engine_at(
+          seed_and_offset.first, seed_and_offset.second, begin * 16 * philox::randoms_per_element<scalar_t>());
+      scalar_t buffer[16];
+      for (int64_t group = begin; group < end; group++) {
+        for (int64_t j = 0; j < 16; j++) {
+          buffer[j] = static_cast<scalar_t>(uniform_real_transformation<scalar_t>(
+              philox::next_bits<scalar_t>(engine), static_cast<scalar_t>(0), static_cast<scalar_t>(1)));
+        }
+        philox::normal_fill_16(buffer, mean_, std_);
+        const int64_t len = std::min<int64_t>(16, numel - group * 16);
+        std::copy(buffer, buffer + len, data + group * 16);
+      }
+    });
+  });
+  if (!out.is_same(self)) {
+    self.copy_(out);
+  }
+}
+
 }}}}}
@@ -2,6 +2,8 @@
 
 #include <cmath>
 #include <iostream>
+#include <vector>
+#include <ATen/Context.h>
 #include <ATen/Dispatch.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/Parallel.h>
@@ -106,19 +108,73 @@ void index_kernel(TensorIterator& iter, IntArrayRef index_size, IntArrayRef inde
   });
 }
 
+// Accumulating index_put_ in parallel without atomics: the elements are
+// partitioned by the cache line of their destination, so that every
+// destination is only written by one thread, and each partition is
+// accumulated in the order of the iteration, which gives the same result as
+// the serial loop.
+template <typename scalar_t>
+void cpu_index_put_accumulate_partitioned(TensorIterator& iter, IntArrayRef index_size, IntArrayRef index_stride) {
+  const int ntensor = iter.ntensors();
+  const int64_t numel = iter.numel();
+  std::vector<char*> dst_ptrs(numel);
+  std::vector<char*> src_ptrs(numel);
+  at::parallel_for(0, numel, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    int64_t pos = begin;
+    iter.serial_for_each([&](char** data, const int64_t* strides, int64_t n) {
+      auto indexer = Indexer(ntensor - 2, &data[2], &strides[2], index_size, index_stride);
+      for (int64_t i = 0; i < n; i++, pos++) {
+        dst_ptrs[pos] = data[0] + strides[0] * i + indexer.get(i);
+        src_ptrs[pos] = data[1] + strides[1] * i;
+      }
+    }, {begin, end});
+  });
+
+  const int64_t num_partitions = at::get_num_threads();
+  constexpr uintptr_t kCacheLineSize = 64;
+  auto partition_of = [&](const char* dst) {
+    return static_cast<int64_t>((reinterpret_cast<uintptr_t>(dst) / kCacheLineSize) % num_partitions);
+  };
+  // counting sort of the element positions by partition, which keeps the
+  // iteration order within every partition
+  std::vector<int64_t> partition_starts(num_partitions + 1, 0);
+  for (int64_t i = 0; i < numel; i++) {
+    partition_starts[partition_of(dst_ptrs[i]) + 1]++;
+  }
+  for (int64_t p = 0; p < num_partitions; p++) {
+    partition_starts[p + 1] += partition_starts[p];
+  }
+  std::vector<int64_t> order(numel);
+  {
+    std::vector<int64_t> next(partition_starts.begin(), partition_starts.end() - 1);
+    for (int64_t i = 0; i < numel; i++) {
+      order[next[partition_of(dst_ptrs[i])]++] = i;
+    }
+  }
+
+  at::parallel_for(0, num_partitions, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t p = begin; p < end; p++) {
+      for (int64_t j = partition_starts[p]; j < partition_starts[p + 1]; j++) {
+        const int64_t i = order[j];
+        *(scalar_t*)dst_ptrs[i] += *(scalar_t*)src_ptrs[i];
+      }
+    }
+  });
+}
+
 void index_put_kernel(TensorIterator& iter, IntArrayRef index_size, IntArrayRef index_stride, bool accumulate) {
   // NOTE: duplicate indices are only supported if accumulate is true.
   AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(at::ScalarType::Half, at::ScalarType::Bool, at::ScalarType::BFloat16,
     iter.dtype(), "index_put", [&] {
     if (accumulate) {
       bool use_parallel_for = ((iter.numel() >= internal::GRAIN_SIZE) && (at::get_num_threads() > 1));
-      if (iter.dtype() == at::ScalarType::Float && use_parallel_for) {
+      if (iter.dtype() == at::ScalarType::Float && use_parallel_for && !at::globalContext().deterministic()) {
         cpu_index_kernel<float>(iter, index_size, index_stride, [](char* dst, char* src, int64_t offset) {
           cpu_atomic_add_float((float*)(dst + offset), *(float*)src);
         });
+      } else if (use_parallel_for) {
+        cpu_index_put_accumulate_partitioned<scalar_t>(iter, index_size, index_stride);
       } else {
-        // TODO: investigate parallelization of the accumulate kernel. Unlike the non-accumulate case,
-        // this needs to be thread-safe.
         cpu_index_kernel<scalar_t>(iter, index_size, index_stride, [](char* dst, char* src, int64_t offset) {
           *(scalar_t*)(dst + offset) += *(scalar_t*)src;
         }, /*serial_execution=*/true);
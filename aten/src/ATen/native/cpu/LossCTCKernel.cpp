@@ -0,0 +1,463 @@
+// The alpha and beta recursions of the CTC loss, see LossCTC.cpp; equation
+// numbers refer to Graves et al. (http://www.cs.toronto.edu/~graves/icml_2006.pdf).
+//
+// The states s of the augmented target l' of a batch item only depend on the
+// states s, s - 1 and s - 2 (alpha) or s, s + 1 and s + 2 (beta) of the
+// previous time step, so a time step is computed as one vectorized
+// log-sum-exp over all states. With fewer batch items than threads, the
+// batch items are taken one after the other and the states of every time step
+// are split among the threads instead.
+//
+// The backward never materializes the betas: it keeps the betas of two time
+// steps and accumulates the occupancies of eq (16) into the gradient as soon
+// as the betas of a time step are known. The gradient is then finished in a
+// single parallel pass over all batch items and time steps.
+
+#include <ATen/native/LossCTC.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace at { namespace native {
+
+namespace {
+
+using namespace vec256;
+
+// Splitting the states of a time step among threads costs a synchronization
+// per time step, which only pays off for long targets.
+constexpr int64_t kStateGrainSize = 256;
+
+// A batch item: its log_probs[:, b, :] and its augmented target l' (eq (4)),
+// with blanks between the labels and at both ends.
+template <typename scalar_t>
+struct CtcItem {
+  const scalar_t* log_probs;
+  int64_t time_stride;
+  int64_t label_stride;
+  int64_t input_length;
+  std::vector<int64_t> labels;
+  // Additive penalties, 0 or -inf, of the transitions from s - 2 to s (in the
+  // alphas) and from s + 2 to s (in the betas); they are only allowed between
+  // different labels, eq (6) and (10).
+  std::vector<scalar_t> skip_to;
+  std::vector<scalar_t> skip_from;
+
+  int64_t num_states() const {
+    return labels.size();
+  }
+};
+
+template <typename scalar_t, typename target_t>
+CtcItem<scalar_t> make_ctc_item(
+    const Tensor& log_probs,
+    int64_t b,
+    int64_t input_length,
+    const target_t* targets,
+    int64_t tg_batch_offset,
+    int64_t tg_target_stride,
+    int64_t target_length,
+    int64_t BLANK) {
+  constexpr scalar_t neginf = -std::numeric_limits<scalar_t>::infinity();
+  CtcItem<scalar_t> item;
+  item.log_probs = log_probs.data_ptr<scalar_t>() + b * log_probs.stride(1);
+  item.time_stride = log_probs.stride(0);
+  item.label_stride = log_probs.stride(2);
+  item.input_length = input_length;
+  const int64_t num_states = 2 * target_length + 1;
+  item.labels.resize(num_states);
+  for (int64_t s = 0; s < num_states; s++) {
+    item.labels[s] = (s % 2 == 0) ? BLANK : targets[tg_batch_offset + tg_target_stride * (s / 2)];
+  }
+  item.skip_to.assign(num_states, neginf);
+  item.skip_from.assign(num_states, neginf);
+  for (int64_t s = 2; s < num_states; s++) {
+    if (item.labels[s] != item.labels[s - 2]) {
+      item.skip_to[s] = 0;
+      item.skip_from[s - 2] = 0;
+    }
+  }
+  return item;
+}
+
+// out[i] = log(exp(x1[i]) + exp(x2[i]) + exp(x3[i] + penalty[i])) + emit[i],
+// with the maximum taken out of the exps.
+template <typename scalar_t>
+void log_add_exp3(
+    scalar_t* out,
+    const scalar_t* x1,
+    const scalar_t* x2,
+    const scalar_t* x3,
+    const scalar_t* penalty,
+    const scalar_t* emit,
+    int64_t n) {
+  using Vec = Vec256<scalar_t>;
+  const Vec neginf(-std::numeric_limits<scalar_t>::infinity());
+  const Vec zero(0);
+  auto compute = [&](int64_t i, int64_t count) {
+    const Vec a = Vec::loadu(x1 + i, count);
+    const Vec b = Vec::loadu(x2 + i, count);
+    const Vec c = Vec::loadu(x3 + i, count) + Vec::loadu(penalty + i, count);
+    Vec m = maximum(maximum(a, b), c);
+    // cannot do neginf - neginf
+    m = Vec::blendv(m, zero, m == neginf);
+    const Vec r = ((a - m).exp() + (b - m).exp() + (c - m).exp()).log() + m +
+        Vec::loadu(emit + i, count);
+    r.store(out + i, count);
+  };
+  int64_t i = 0;
+  for (; i + Vec::size() <= n; i += Vec::size()) {
+    compute(i, Vec::size());
+  }
+  if (i < n) {
+    compute(i, n - i);
+  }
+}
+
+// out[i] = exp(log_alpha[i] + log_beta[i] + nll - emit[i]), the share of the
+// paths through a state at a time step, eq (14) over the likelihood.
+template <typename scalar_t>
+void occupancy(
+    scalar_t* out,
+    const scalar_t* log_alpha,
+    const scalar_t* log_beta,
+    const scalar_t* emit,
+    scalar_t nll,
+    int64_t n) {
+  using Vec = Vec256<scalar_t>;
+  const Vec nll_vec(nll);
+  auto compute = [&](int64_t i, int64_t count) {
+    const Vec r = (Vec::loadu(log_alpha + i, count) + Vec::loadu(log_beta + i, count) +
+        nll_vec - Vec::loadu(emit + i, count)).exp();
+    r.store(out + i, count);
+  };
+  int64_t i = 0;
+  for (; i + Vec::size() <= n; i += Vec::size()) {
+    compute(i, Vec::size());
+  }
+  if (i < n) {
+    compute(i, n - i);
+  }
+}
+
+template <typename scalar_t>
+void gather_emissions(scalar_t* emit, const CtcItem<scalar_t>& item, int64_t t, int64_t begin, int64_t end) {
+  const scalar_t* log_probs_t = item.log_probs + t * item.time_stride;
+  for (int64_t s = begin; s < end; s++) {
+    emit[s] = log_probs_t[item.labels[s] * item.label_stride];
+  }
+}
+
+template <typename F>
+void for_each_state(int64_t num_states, bool parallel_states, const F& f) {
+  if (parallel_states) {
+    at::parallel_for(0, num_states, kStateGrainSize, f);
+  } else {
+    f(0, num_states);
+  }
+}
+
+// Writes the alphas of eq (6) and (7) into log_alpha, rows of time steps, and
+// returns the negative log likelihood of eq (8).
+template <typename scalar_t>
+scalar_t ctc_alpha(
+    scalar_t* log_alpha,
+    int64_t alpha_time_stride,
+    const CtcItem<scalar_t>& item,
+    bool parallel_states) {
+  constexpr scalar_t neginf = -std::numeric_limits<scalar_t>::infinity();
+  const int64_t num_states = item.num_states();
+  const int64_t input_length = item.input_length;
+  if (input_length == 0) {
+    // Only the empty target has a path through no time steps.
+    return num_states == 1 ? scalar_t(0) : std::numeric_limits<scalar_t>::infinity();
+  }
+  // The alphas of the previous and the current time step, after two states
+  // of -inf for the transitions from s - 1 and s - 2 at s = 0 and s = 1.
+  std::vector<scalar_t> prev(num_states + 2, neginf);
+  std::vector<scalar_t> cur(num_states + 2, neginf);
+  std::vector<scalar_t> emit(num_states);
+
+  // the first two items of alpha_t above eq (6)
+  gather_emissions(emit.data(), item, 0, 0, std::min<int64_t>(num_states, 2));
+  prev[2] = emit[0];
+  if (num_states > 1) {
+    prev[3] = emit[1];
+  }
+  std::copy(prev.begin() + 2, prev.end(), log_alpha);
+
+  for (int64_t t = 1; t < input_length; t++) {
+    for_each_state(num_states, parallel_states, [&](int64_t begin, int64_t end) {
+      gather_emissions(emit.data(), item, t, begin, end);
+      log_add_exp3(
+          cur.data() + 2 + begin,
+          prev.data() + 2 + begin,
+          prev.data() + 1 + begin,
+          prev.data() + begin,
+          item.skip_to.data() + begin,
+          emit.data() + begin,
+          end - begin);
+    });
+    std::swap(prev, cur);
+    std::copy(prev.begin() + 2, prev.end(), log_alpha + t * alpha_time_stride);
+  }
+
+  // the likelihood is the the sum of the last two alphas, eq (8), the loss is the negative log likelihood
+  const scalar_t* last = prev.data() + 2;
+  if (num_states == 1) {
+    // if the target is empty then there is no preceding BLANK state and hence there is no path to merge
+    return -last[0];
+  }
+  const scalar_t l1 = last[num_states - 1];
+  const scalar_t l2 = last[num_states - 2];
+  scalar_t m = std::max(l1, l2);
+  m = ((m == neginf) ? 0 : m);
+  return -(std::log(std::exp(l1 - m) + std::exp(l2 - m)) + m);
+}
+
+// Computes the betas of eq (10) and (11) from the last time step down and adds
+// the occupancy of every state to the gradient of its label at that time step,
+// the sum of eq (16). grad holds rows of time steps of num_labels elements.
+template <typename scalar_t>
+void ctc_beta_occupancies(
+    scalar_t* grad,
+    int64_t grad_time_stride,
+    const scalar_t* log_alpha,
+    int64_t alpha_time_stride,
+    const CtcItem<scalar_t>& item,
+    scalar_t nll,
+    bool parallel_states) {
+  constexpr scalar_t neginf = -std::numeric_limits<scalar_t>::infinity();
+  const int64_t num_states = item.num_states();
+  const int64_t input_length = item.input_length;
+  // The betas of the next and the current time step, before two states of
+  // -inf for the transitions from s + 1 and s + 2 at the last two states.
+  std::vector<scalar_t> next(num_states + 2, neginf);
+  std::vector<scalar_t> cur(num_states + 2, neginf);
+  std::vector<scalar_t> emit(num_states);
+  std::vector<scalar_t> occupancies(num_states);
+
+  for (int64_t t = input_length - 1; t >= 0; t--) {
+    const scalar_t* log_alpha_t = log_alpha + t * alpha_time_stride;
+    for_each_state(num_states, parallel_states, [&](int64_t begin, int64_t end) {
+      gather_emissions(emit.data(), item, t, begin, end);
+      if (t == input_length - 1) {
+        // the initialization of beta before eq (10): only the last two states
+        for (int64_t s = begin; s < end; s++) {
+          cur[s] = (s >= num_states - 2) ? emit[s] : neginf;
+        }
+      } else {
+        log_add_exp3(
+            cur.data() + begin,
+            next.data() + begin,
+            next.data() + 1 + begin,
+            next.data() + 2 + begin,
+            item.skip_from.data() + begin,
+            emit.data() + begin,
+            end - begin);
+      }
+      occupancy(
+          occupancies.data() + begin,
+          log_alpha_t + begin,
+          cur.data() + begin,
+          emit.data() + begin,
+          nll,
+          end - begin);
+    });
+    // several states share a label, so this one is sequential
+    scalar_t* grad_t = grad + t * grad_time_stride;
+    for (int64_t s = 0; s < num_states; s++) {
+      grad_t[item.labels[s]] += occupancies[s];
+    }
+    std::swap(next, cur);
+  }
+}
+
+// With the summed occupancies in grad, the remaining items of eq (16) give
+// the gradient with respect to the unnormalized activations.
+template <typename scalar_t>
+void finish_grad_row(
+    scalar_t* grad,
+    const scalar_t* log_probs,
+    int64_t label_stride,
+    int64_t num_labels,
+    scalar_t grad_out) {
+  using Vec = Vec256<scalar_t>;
+  int64_t c = 0;
+  if (label_stride == 1) {
+    const Vec grad_out_vec(grad_out);
+    for (; c + Vec::size() <= num_labels; c += Vec::size()) {
+      const Vec r = (Vec::loadu(log_probs + c).exp() - Vec::loadu(grad + c)) * grad_out_vec;
+      r.store(grad + c);
+    }
+  }
+  for (; c < num_labels; c++) {
+    grad[c] = (std::exp(log_probs[c * label_stride]) - grad[c]) * grad_out;
+  }
+}
+
+// With fewer batch items than threads, the states of every time step are
+// split among the threads instead of the batch items.
+template <typename F>
+void for_each_batch_item(int64_t batch_size, const F& f) {
+  if (batch_size >= at::get_num_threads()) {
+    at::parallel_for(0, batch_size, 1, [&](int64_t start, int64_t end) {
+      for (int64_t b = start; b < end; b++) {
+        f(b, /*parallel_states=*/false);
+      }
+    });
+  } else {
+    for (int64_t b = 0; b < batch_size; b++) {
+      f(b, /*parallel_states=*/true);
+    }
+  }
+}
+
+template <typename scalar_t, typename target_t>
+void ctc_loss_kernel_impl(
+    Tensor& neg_log_likelihood,
+    Tensor& log_alpha,
+    const Tensor& log_probs,
+    const Tensor& targets,
+    IntArrayRef input_lengths,
+    IntArrayRef target_lengths,
+    IntArrayRef tg_batch_offsets,
+    int64_t tg_target_stride,
+    int64_t BLANK) {
+  const target_t* targets_data = targets.data_ptr<target_t>();
+  scalar_t* nll_data = neg_log_likelihood.data_ptr<scalar_t>();
+  scalar_t* log_alpha_data = log_alpha.data_ptr<scalar_t>();
+  for_each_batch_item(log_probs.size(1), [&](int64_t b, bool parallel_states) {
+    const auto item = make_ctc_item<scalar_t>(
+        log_probs, b, input_lengths[b], targets_data, tg_batch_offsets[b],
+        tg_target_stride, target_lengths[b], BLANK);
+    nll_data[b] = ctc_alpha(
+        log_alpha_data + b * log_alpha.stride(0), log_alpha.stride(1), item, parallel_states);
+  });
+}
+
+template <typename scalar_t, typename target_t>
+void ctc_loss_backward_kernel_impl(
+    Tensor& grad,
+    const Tensor& grad_out,
+    const Tensor& log_probs,
+    const Tensor& targets,
+    IntArrayRef input_lengths,
+    IntArrayRef target_lengths,
+    IntArrayRef tg_batch_offsets,
+    int64_t tg_target_stride,
+    const Tensor& neg_log_likelihood,
+    const Tensor& log_alpha,
+    int64_t BLANK,
+    bool zero_infinity) {
+  const int64_t max_input_length = log_probs.size(0);
+  const int64_t batch_size = log_probs.size(1);
+  const int64_t num_labels = log_probs.size(2);
+  const target_t* targets_data = targets.data_ptr<target_t>();
+  const scalar_t* log_alpha_data = log_alpha.data_ptr<scalar_t>();
+  scalar_t* grad_data = grad.data_ptr<scalar_t>();
+  auto nll_a = neg_log_likelihood.accessor<scalar_t, 1>();
+  auto grad_out_a = grad_out.accessor<scalar_t, 1>();
+  // the gradient of these batch items stays zero
+  auto skipped = [&](int64_t b) {
+    return zero_infinity && nll_a[b] == std::numeric_limits<scalar_t>::infinity();
+  };
+
+  for_each_batch_item(batch_size, [&](int64_t b, bool parallel_states) {
+    if (skipped(b)) {
+      return;
+    }
+    const auto item = make_ctc_item<scalar_t>(
+        log_probs, b, input_lengths[b], targets_data, tg_batch_offsets[b],
+        tg_target_stride, target_lengths[b], BLANK);
+    ctc_beta_occupancies(
+        grad_data + b * num_labels, batch_size * num_labels,
+        log_alpha_data + b * log_alpha.stride(0), log_alpha.stride(1),
+        item, nll_a[b], parallel_states);
+  });
+
+  // grad is input_len x batch_size x num_labels; time steps after the input
+  // length of a batch item stay zero.
+  const scalar_t* log_probs_data = log_probs.data_ptr<scalar_t>();
+  const int64_t num_rows = max_input_length * batch_size;
+  at::parallel_for(0, num_rows, std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(1, num_labels)),
+      [&](int64_t start, int64_t end) {
+    for (int64_t row = start; row < end; row++) {
+      const int64_t t = row / batch_size;
+      const int64_t b = row % batch_size;
+      if (t >= input_lengths[b] || skipped(b)) {
+        continue;
+      }
+      finish_grad_row(
+          grad_data + row * num_labels,
+          log_probs_data + t * log_probs.stride(0) + b * log_probs.stride(1),
+          log_probs.stride(2),
+          num_labels,
+          grad_out_a[b]);
+    }
+  });
+}
+
+void ctc_loss_kernel(
+    Tensor& neg_log_likelihood,
+    Tensor& log_alpha,
+    const Tensor& log_probs,
+    const Tensor& targets,
+    IntArrayRef input_lengths,
+    IntArrayRef target_lengths,
+    IntArrayRef tg_batch_offsets,
+    int64_t tg_target_stride,
+    int64_t BLANK) {
+  AT_DISPATCH_FLOATING_TYPES(log_probs.scalar_type(), "ctc_loss_cpu", [&] {
+    if (targets.scalar_type() == kLong) {
+      ctc_loss_kernel_impl<scalar_t, int64_t>(
+          neg_log_likelihood, log_alpha, log_probs, targets, input_lengths,
+          target_lengths, tg_batch_offsets, tg_target_stride, BLANK);
+    } else {
+      ctc_loss_kernel_impl<scalar_t, int>(
+          neg_log_likelihood, log_alpha, log_probs, targets, input_lengths,
+          target_lengths, tg_batch_offsets, tg_target_stride, BLANK);
+    }
+  });
+}
+
+void ctc_loss_backward_kernel(
+    Tensor& grad,
+    const Tensor& grad_out,
+    const Tensor& log_probs,
+    const Tensor& targets,
+    IntArrayRef input_lengths,
+    IntArrayRef target_lengths,
+    IntArrayRef tg_batch_offsets,
+    int64_t tg_target_stride,
+    const Tensor& neg_log_likelihood,
+    const Tensor& log_alpha,
+    int64_t BLANK,
+    bool zero_infinity) {
+  AT_DISPATCH_FLOATING_TYPES(log_probs.scalar_type(), "ctc_loss_backward_cpu", [&] {
+    if (targets.scalar_type() == kLong) {
+      ctc_loss_backward_kernel_impl<scalar_t, int64_t>(
+          grad, grad_out, log_probs, targets, input_lengths, target_lengths,
+          tg_batch_offsets, tg_target_stride, neg_log_likelihood, log_alpha,
+          BLANK, zero_infinity);
+    } else {
+      ctc_loss_backward_kernel_impl<scalar_t, int>(
+          grad, grad_out, log_probs, targets, input_lengths, target_lengths,
+          tg_batch_offsets, tg_target_stride, neg_log_likelihood, log_alpha,
+          BLANK, zero_infinity);
+    }
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(ctc_loss_stub, &ctc_loss_kernel);
+REGISTER_DISPATCH(ctc_loss_backward_stub, &ctc_loss_backward_kernel);
+
+}} // namespace at::native
@@ -0,0 +1,206 @@
+// The per-row kernels of the fused cross entropy, see LossCrossEntropy.cpp.
+//
+// A row of the forward is three vectorized passes over the scores: their
+// maximum, the sum of their exponentials and, with label smoothing, their
+// (weighted) sum. A row of the backward is a single vectorized pass writing
+// the gradient, the softmax being recomputed from the logsumexp.
+
+#include <ATen/native/LossCrossEntropy.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/functional.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <algorithm>
+
+namespace at { namespace native {
+
+namespace {
+
+// See [Note AVX-SSE transitions] in SoftMaxKernel.cpp for why this doesn't
+// call into cmath.
+template <typename scalar_t>
+inline scalar_t vec_log(scalar_t x) {
+  using Vec = vec256::Vec256<scalar_t>;
+  scalar_t result[Vec::size()];
+  Vec(x).log().store(result);
+  return result[0];
+}
+
+template <typename scalar_t>
+inline scalar_t class_weight(const scalar_t* weight_data, int64_t c) {
+  return weight_data != nullptr ? weight_data[c] : scalar_t(1);
+}
+
+// The sum of the class weights, which scales the label smoothing term
+template <typename scalar_t>
+scalar_t total_class_weight(scalar_t* weight_data, int64_t n_classes) {
+  using Vec = vec256::Vec256<scalar_t>;
+  if (weight_data == nullptr) {
+    return static_cast<scalar_t>(n_classes);
+  }
+  return vec256::reduce_all<scalar_t>(
+      [](Vec& x, Vec& y) { return x + y; }, weight_data, n_classes);
+}
+
+template <typename scalar_t>
+void cross_entropy_loss_kernel_impl(
+    Tensor& losses,
+    Tensor& logsumexp,
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t ignore_index,
+    double label_smoothing) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const int64_t n_rows = self.size(0);
+  const int64_t n_classes = self.size(1);
+  scalar_t* input_data = self.data_ptr<scalar_t>();
+  const int64_t* target_data = target.data_ptr<int64_t>();
+  scalar_t* weight_data = weight.defined() ? weight.data_ptr<scalar_t>() : nullptr;
+  scalar_t* losses_data = losses.data_ptr<scalar_t>();
+  scalar_t* logsumexp_data = logsumexp.data_ptr<scalar_t>();
+
+  const scalar_t eps = label_smoothing;
+  const scalar_t smoothing = eps / n_classes;
+  const scalar_t weight_sum = total_class_weight(weight_data, n_classes);
+
+  // Roughly 16 operations per score, see the note on grainsize in
+  // SoftMaxKernel.cpp
+  int64_t grain_size = std::max<int64_t>(internal::GRAIN_SIZE / (16 * std::max<int64_t>(n_classes, 1)), 1);
+  parallel_for(0, n_rows, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      scalar_t* row = input_data + i * n_classes;
+      scalar_t max_input = vec256::reduce_all<scalar_t>(
+          [](Vec& x, Vec& y) { return vec256::maximum(x, y); }, row, n_classes);
+      scalar_t sum_exp = vec256::map_reduce_all<scalar_t>(
+          [max_input](Vec x) { return (x - Vec(max_input)).exp(); },
+          [](Vec x, Vec y) { return x + y; },
+          row,
+          n_classes);
+      scalar_t lse = max_input + vec_log(sum_exp);
+      logsumexp_data[i] = lse;
+
+      const int64_t t = target_data[i];
+      if (t == ignore_index) {
+        losses_data[i] = 0;
+        continue;
+      }
+      TORCH_CHECK(t >= 0 && t < n_classes, "Target ", t, " is out of bounds.");
+      scalar_t loss = -(1 - eps) * class_weight(weight_data, t) * (row[t] - lse);
+      if (eps != 0) {
+        scalar_t weighted_sum = weight_data == nullptr
+            ? vec256::reduce_all<scalar_t>(
+                  [](Vec& x, Vec& y) { return x + y; }, row, n_classes)
+            : vec256::map2_reduce_all<scalar_t>(
+                  [](Vec x, Vec w) { return x * w; },
+                  [](Vec x, Vec y) { return x + y; },
+                  row,
+                  weight_data,
+                  n_classes);
+        loss -= smoothing * (weighted_sum - weight_sum * lse);
+      }
+      losses_data[i] = loss;
+    }
+  });
+}
+
+template <typename scalar_t>
+void cross_entropy_loss_backward_kernel_impl(
+    Tensor& grad_input,
+    const Tensor& grad_losses,
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    const Tensor& logsumexp,
+    int64_t ignore_index,
+    double label_smoothing) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const int64_t n_rows = self.size(0);
+  const int64_t n_classes = self.size(1);
+  scalar_t* input_data = self.data_ptr<scalar_t>();
+  const int64_t* target_data = target.data_ptr<int64_t>();
+  scalar_t* weight_data = weight.defined() ? weight.data_ptr<scalar_t>() : nullptr;
+  const scalar_t* grad_losses_data = grad_losses.data_ptr<scalar_t>();
+  const scalar_t* logsumexp_data = logsumexp.data_ptr<scalar_t>();
+  scalar_t* grad_input_data = grad_input.data_ptr<scalar_t>();
+
+  const scalar_t eps = label_smoothing;
+  const scalar_t smoothing = eps / n_classes;
+  const scalar_t weight_sum = total_class_weight(weight_data, n_classes);
+
+  int64_t grain_size = std::max<int64_t>(internal::GRAIN_SIZE / (8 * std::max<int64_t>(n_classes, 1)), 1);
+  parallel_for(0, n_rows, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      scalar_t* row = input_data + i * n_classes;
+      scalar_t* grad_row = grad_input_data + i * n_classes;
+      const int64_t t = target_data[i];
+      if (t == ignore_index) {
+        std::fill(grad_row, grad_row + n_classes, scalar_t(0));
+        continue;
+      }
+      TORCH_CHECK(t >= 0 && t < n_classes, "Target ", t, " is out of bounds.");
+
+      const scalar_t grad = grad_losses_data[i];
+      const scalar_t lse = logsumexp_data[i];
+      const scalar_t target_weight = (1 - eps) * class_weight(weight_data, t);
+      // grad * (softmax * prob_scale - smoothing * w)
+      const Vec prob_scale(grad * (target_weight + smoothing * weight_sum));
+      const Vec vec_lse(lse);
+      const Vec smoothing_grad(grad * smoothing);
+      if (weight_data == nullptr) {
+        vec256::map(
+            [=](Vec x) { return (x - vec_lse).exp() * prob_scale - smoothing_grad; },
+            grad_row,
+            row,
+            n_classes);
+      } else {
+        vec256::map2(
+            [=](Vec x, Vec w) { return (x - vec_lse).exp() * prob_scale - smoothing_grad * w; },
+            grad_row,
+            row,
+            weight_data,
+            n_classes);
+      }
+      grad_row[t] -= grad * target_weight;
+    }
+  });
+}
+
+void cross_entropy_loss_kernel(
+    Tensor& losses,
+    Tensor& logsumexp,
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t ignore_index,
+    double label_smoothing) {
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "cross_entropy_loss_cpu", [&] {
+    cross_entropy_loss_kernel_impl<scalar_t>(
+        losses, logsumexp, self, target, weight, ignore_index, label_smoothing);
+  });
+}
+
+void cross_entropy_loss_backward_kernel(
+    Tensor& grad_input,
+    const Tensor& grad_losses,
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    const Tensor& logsumexp,
+    int64_t ignore_index,
+    double label_smoothing) {
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "cross_entropy_loss_backward_cpu", [&] {
+    cross_entropy_loss_backward_kernel_impl<scalar_t>(
+        grad_input, grad_losses, self, target, weight, logsumexp,
+        ignore_index, label_smoothing);
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(cross_entropy_loss_stub, &cross_entropy_loss_kernel);
+REGISTER_DISPATCH(cross_entropy_loss_backward_stub, &cross_entropy_loss_backward_kernel);
+
+}} // namespace at::native
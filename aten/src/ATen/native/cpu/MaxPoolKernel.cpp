@@ -0,0 +1,139 @@
+#include <ATen/ATen.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/Pool.h>
+
+namespace at {
+namespace native {
+
+namespace {
+
+// Max pooling of an NHWC input: for every output pixel the channels are
+// contiguous, so the running max and its index are updated for Vec::size()
+// channels at a time with a compare and blend instead of a branch. The
+// indices are kept in an integer type of the size of scalar_t while the
+// window is scanned, so that the value and the index lanes line up, and are
+// widened to int64_t once per output pixel.
+template <typename scalar_t>
+void cpu_max_pool2d_channels_last(
+    Tensor& output_,
+    Tensor& indices_,
+    const Tensor& input_,
+    int kW, int kH,
+    int dW, int dH,
+    int padW, int padH,
+    int dilationW, int dilationH) {
+  using Vec = vec256::Vec256<scalar_t>;
+  using integer_t = vec256::int_same_size_t<scalar_t>;
+  using iVec = vec256::Vec256<integer_t>;
+
+  auto input = input_.contiguous(at::MemoryFormat::ChannelsLast);
+  auto output = output_.contiguous(at::MemoryFormat::ChannelsLast);
+  auto indices = indices_.contiguous(at::MemoryFormat::ChannelsLast);
+
+  const auto* input_data = input.data_ptr<scalar_t>();
+  auto* output_data = output.data_ptr<scalar_t>();
+  auto* indices_data = indices.data_ptr<int64_t>();
+
+  const int64_t nbatch = input.size(0);
+  const int64_t channels = input.size(1);
+  const int64_t input_height = input.size(2);
+  const int64_t input_width = input.size(3);
+  const int64_t output_height = output.size(2);
+  const int64_t output_width = output.size(3);
+
+  const int64_t window = static_cast<int64_t>(kH) * kW;
+  const int64_t grain_size = std::max<int64_t>(
+      1, at::internal::GRAIN_SIZE / std::max<int64_t>(channels * window, 1));
+
+  at::parallel_for(0, nbatch * output_height * output_width, grain_size, [&](int64_t begin, int64_t end) {
+    std::vector<integer_t> index_buffer(channels);
+
+    for (int64_t i = begin; i < end; i++) {
+      const int64_t ow = i % output_width;
+      const int64_t oh = (i / output_width) % output_height;
+      const int64_t n = i / (output_width * output_height);
+
+      int64_t ih0 = oh * dH - padH;
+      int64_t iw0 = ow * dW - padW;
+      const int64_t ih1 = std::min(ih0 + (kH - 1) * dilationH + 1, input_height);
+      const int64_t iw1 = std::min(iw0 + (kW - 1) * dilationW + 1, input_width);
+      while (ih0 < 0) {
+        ih0 += dilationH;
+      }
+      while (iw0 < 0) {
+        iw0 += dilationW;
+      }
+
+      scalar_t* out = output_data + i * channels;
+      int64_t* ind = indices_data + i * channels;
+
+      const iVec start_index(ih0 * input_width + iw0);
+      const Vec lowest(-std::numeric_limits<scalar_t>::infinity());
+      for (int64_t c = 0; c < channels; c += Vec::size()) {
+        const int64_t count = std::min<int64_t>(Vec::size(), channels - c);
+        start_index.store(index_buffer.data() + c, count);
+        lowest.store(out + c, count);
+      }
+
+      for (int64_t ih = ih0; ih < ih1; ih += dilationH) {
+        for (int64_t iw = iw0; iw < iw1; iw += dilationW) {
+          const scalar_t* in = input_data +
+              ((n * input_height + ih) * input_width + iw) * channels;
+          const iVec index(ih * input_width + iw);
+          for (int64_t c = 0; c < channels; c += Vec::size()) {
+            const int64_t count = std::min<int64_t>(Vec::size(), channels - c);
+            const Vec val = Vec::loadu(in + c, count);
+            const Vec maxval = Vec::loadu(out + c, count);
+            // Take val if val > maxval || isnan(val), as in the contiguous
+            // kernel; val == val is false only for NaN.
+            const Vec greater = val > maxval;
+            const Vec ordered = val == val;
+            Vec::blendv(val, Vec::blendv(maxval, val, greater), ordered)
+                .store(out + c, count);
+            const iVec maxindex = iVec::loadu(index_buffer.data() + c, count);
+            iVec::blendv(
+                index,
+                iVec::blendv(maxindex, index, vec256::cast<integer_t>(greater)),
+                vec256::cast<integer_t>(ordered)).store(index_buffer.data() + c, count);
+          }
+        }
+      }
+
+      for (int64_t c = 0; c < channels; c++) {
+        ind[c] = index_buffer[c];
+      }
+    }
+  });
+
+  if (!output_.is_contiguous(at::MemoryFormat::ChannelsLast)) {
+    output_.copy_(output);
+  }
+  if (!indices_.is_contiguous(at::MemoryFormat::ChannelsLast)) {
+    indices_.copy_(indices);
+  }
+}
+
+void max_pool2d_channels_last_kernel_impl(
+    Tensor& output,
+    Tensor& indices,
+    const Tensor& input,
+    int kW, int kH,
+    int dW, int dH,
+    int padW, int padH,
+    int dilationW, int dilationH) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "max_pool2d_channels_last", [&] {
+    cpu_max_pool2d_channels_last<scalar_t>(
+        output, indices, input,
+        kW, kH, dW, dH, padW, padH, dilationW, dilationH);
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(max_pool2d_channels_last_kernel, &max_pool2d_channels_last_kernel_impl);
+
+} // namespace native
+} // namespace at
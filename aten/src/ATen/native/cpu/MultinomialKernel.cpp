@@ -6,6 +6,7 @@
 #include <ATen/native/cpu/Loops.h>
 #include <ATen/core/DistributionsHelper.h>
 #include <ATen/native/UnaryOps.h>
+#include <ATen/native/cpu/DistributionTemplates.h>
 
 namespace at {
 namespace native {
@@ -130,6 +131,60 @@ void multinomial_apply(Tensor& result, const Tensor& self, const int64_t n_sampl
   }
 }
 
+// A draw picks a uniform bucket i of the alias tables, and keeps i with
+// probability q[i] or returns J[i] otherwise. With a generator in Philox mode
+// one double u uniform in [0, K) does both: its integer part is the bucket
+// and its fractional part, uniform in [0, 1) and independent of it, the coin.
+// The draws are then independent and run in parallel, see
+// Note [Counter-based CPU random fills]. The mt19937 engine draws sequentially
+// with a uniform and a bernoulli per sample, as it always has.
+template<typename scalar_t>
+void multinomial_alias_draw_apply(Tensor& result, const Tensor& q, const Tensor& J, c10::optional<Generator> generator) {
+  auto gen = get_generator_or_default<CPUGeneratorImpl>(generator, detail::getDefaultCPUGenerator());
+  const int64_t n_sample = result.numel();
+  const int64_t K = J.numel();
+  const scalar_t* const q_ptr = q.data_ptr<scalar_t>();
+  const int64_t* const J_ptr = J.data_ptr<int64_t>();
+  int64_t* const result_ptr = result.data_ptr<int64_t>();
+
+  if (gen->philox_enabled()) {
+    namespace philox = templates::cpu::philox;
+    std::pair<uint64_t, uint64_t> seed_and_offset;
+    {
+      // See Note [Acquire lock when using random generators]
+      std::lock_guard<std::mutex> lock(gen->mutex_);
+      seed_and_offset = gen->philox_engine_inputs(philox::increment<double>(n_sample));
+    }
+    at::parallel_for(0, n_sample, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      auto engine = philox::engine_at(
+          seed_and_offset.first, seed_and_offset.second, begin * philox::randoms_per_element<double>());
+      for (int64_t i = begin; i < end; i++) {
+        const double u = uniform_real_transformation<double>(
+            philox::next_bits<double>(engine), 0.0, static_cast<double>(K));
+        // u rounds up to K for the largest randoms.
+        const int64_t bucket = std::min(static_cast<int64_t>(u), K - 1);
+        result_ptr[i] = u - bucket < q_ptr[bucket] ? bucket : J_ptr[bucket];
+      }
+    });
+    return;
+  }
+
+  // See Note [Acquire lock when using random generators]
+  std::lock_guard<std::mutex> lock(gen->mutex_);
+  at::uniform_real_distribution<double> uniform(0, K);
+  for (int64_t i = 0; i < n_sample; i++) {
+    const int64_t bucket = uniform(gen);
+    at::bernoulli_distribution<double> bernoulli(q_ptr[bucket]);
+    result_ptr[i] = bernoulli(gen) ? bucket : J_ptr[bucket];
+  }
+}
+
+static void multinomial_alias_draw_kernel_impl(Tensor& result, const Tensor& q, const Tensor& J, c10::optional<Generator> gen) {
+  AT_DISPATCH_FLOATING_TYPES(q.scalar_type(), "multinomial_alias_draw", [&] {
+    multinomial_alias_draw_apply<scalar_t>(result, q, J, gen);
+  });
+}
+
 static void multinomial_kernel_impl(Tensor& result, const Tensor& self, const int64_t n_sample, const bool with_replacement, c10::optional<Generator> gen) {
   AT_DISPATCH_FLOATING_TYPES_AND_HALF(self.scalar_type(), "multinomial", [&] {
     multinomial_apply<scalar_t>(result, self, n_sample, with_replacement, gen);
@@ -139,6 +194,7 @@ static void multinomial_kernel_impl(Tensor& result, const Tensor& self, const in
 }
 
 REGISTER_DISPATCH(multinomial_stub, &multinomial_kernel_impl);
+REGISTER_DISPATCH(multinomial_alias_draw_stub, &multinomial_alias_draw_kernel_impl);
 
 }
 }
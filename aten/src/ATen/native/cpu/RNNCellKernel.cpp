@@ -0,0 +1,239 @@
+#include <ATen/native/RNN.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <algorithm>
+
+namespace at {
+namespace native {
+
+namespace {
+
+// Pointwise parts of the LSTM and GRU cells, computed for a whole step in a
+// single pass over the gates. The layout of the gates and of the workspace is
+// the one of the CUDA kernels in cuda/RNN.cu, so that the same backward
+// formulas apply: rows of [hsz * 4] gates (i, f, c, o) for LSTM, resp.
+// [hsz * 3] gates (r, i, n) for GRU, vectorized over the hidden size and
+// parallel over the batch.
+
+template <typename scalar_t>
+using Vec = vec256::Vec256<scalar_t>;
+
+template <typename scalar_t>
+inline Vec<scalar_t> load_or_zero(const scalar_t* ptr, int64_t count) {
+  return ptr != nullptr ? Vec<scalar_t>::loadu(ptr, count) : Vec<scalar_t>(0);
+}
+
+template <typename scalar_t>
+inline Vec<scalar_t> sigmoid(const Vec<scalar_t>& x) {
+  const Vec<scalar_t> one(1);
+  return one / (one + x.neg().exp());
+}
+
+// Calls f(row, column, count) for the blocks of at most Vec::size() columns
+// of a [batch, hsz] hidden state.
+template <typename scalar_t, typename F>
+void for_each_block(int64_t batch, int64_t hsz, int64_t cost, const F& f) {
+  const int64_t grain_size =
+      std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(hsz * cost, 1));
+  at::parallel_for(0, batch, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; row++) {
+      for (int64_t j = 0; j < hsz; j += Vec<scalar_t>::size()) {
+        f(row, j, std::min<int64_t>(Vec<scalar_t>::size(), hsz - j));
+      }
+    }
+  });
+}
+
+void lstm_cell_kernel(
+    Tensor& hy,
+    Tensor& cy,
+    Tensor& workspace,
+    const Tensor& input_gates,
+    const Tensor& hidden_gates,
+    const Tensor& cx,
+    const Tensor& input_bias,
+    const Tensor& hidden_bias) {
+  const int64_t batch = cx.size(0);
+  const int64_t hsz = cx.size(1);
+  AT_DISPATCH_FLOATING_TYPES(cx.scalar_type(), "lstm_cell_cpu", [&] {
+    const auto* igates = input_gates.data_ptr<scalar_t>();
+    const auto* hgates = hidden_gates.data_ptr<scalar_t>();
+    const auto* ibias = input_bias.defined() ? input_bias.data_ptr<scalar_t>() : nullptr;
+    const auto* hbias = hidden_bias.defined() ? hidden_bias.data_ptr<scalar_t>() : nullptr;
+    const auto* cx_data = cx.data_ptr<scalar_t>();
+    auto* hy_data = hy.data_ptr<scalar_t>();
+    auto* cy_data = cy.data_ptr<scalar_t>();
+    auto* ws = workspace.data_ptr<scalar_t>();
+
+    for_each_block<scalar_t>(batch, hsz, 32, [&](int64_t row, int64_t j, int64_t count) {
+      const int64_t offset = row * 4 * hsz + j;
+      Vec<scalar_t> gates[4];
+      for (int64_t g = 0; g < 4; g++) {
+        const int64_t pos = offset + g * hsz;
+        gates[g] = Vec<scalar_t>::loadu(igates + pos, count) +
+            Vec<scalar_t>::loadu(hgates + pos, count) +
+            load_or_zero(ibias == nullptr ? nullptr : ibias + g * hsz + j, count) +
+            load_or_zero(hbias == nullptr ? nullptr : hbias + g * hsz + j, count);
+      }
+      const auto ig = sigmoid(gates[0]);
+      const auto fg = sigmoid(gates[1]);
+      const auto cg = gates[2].tanh();
+      const auto og = sigmoid(gates[3]);
+      const auto c = fg * Vec<scalar_t>::loadu(cx_data + row * hsz + j, count) + ig * cg;
+      (og * c.tanh()).store(hy_data + row * hsz + j, count);
+      c.store(cy_data + row * hsz + j, count);
+      ig.store(ws + offset, count);
+      fg.store(ws + offset + hsz, count);
+      cg.store(ws + offset + 2 * hsz, count);
+      og.store(ws + offset + 3 * hsz, count);
+    });
+  });
+}
+
+void lstm_cell_backward_kernel(
+    Tensor& grad_gates,
+    Tensor& grad_cx,
+    const Tensor& grad_hy,
+    const Tensor& grad_cy,
+    const Tensor& cx,
+    const Tensor& cy,
+    const Tensor& workspace) {
+  const int64_t batch = cx.size(0);
+  const int64_t hsz = cx.size(1);
+  AT_DISPATCH_FLOATING_TYPES(cx.scalar_type(), "lstm_cell_backward_cpu", [&] {
+    const auto* ghy = grad_hy.defined() ? grad_hy.data_ptr<scalar_t>() : nullptr;
+    const auto* gcy = grad_cy.defined() ? grad_cy.data_ptr<scalar_t>() : nullptr;
+    const auto* cx_data = cx.data_ptr<scalar_t>();
+    const auto* cy_data = cy.data_ptr<scalar_t>();
+    const auto* ws = workspace.data_ptr<scalar_t>();
+    auto* ggates = grad_gates.data_ptr<scalar_t>();
+    auto* gcx_data = grad_cx.data_ptr<scalar_t>();
+
+    for_each_block<scalar_t>(batch, hsz, 16, [&](int64_t row, int64_t j, int64_t count) {
+      const Vec<scalar_t> one(1);
+      const int64_t offset = row * 4 * hsz + j;
+      const int64_t pos = row * hsz + j;
+      const auto ig = Vec<scalar_t>::loadu(ws + offset, count);
+      const auto fg = Vec<scalar_t>::loadu(ws + offset + hsz, count);
+      const auto cg = Vec<scalar_t>::loadu(ws + offset + 2 * hsz, count);
+      const auto og = Vec<scalar_t>::loadu(ws + offset + 3 * hsz, count);
+      const auto go = load_or_zero(ghy == nullptr ? nullptr : ghy + pos, count);
+      const auto goc = load_or_zero(gcy == nullptr ? nullptr : gcy + pos, count);
+
+      const auto tanh_cy = Vec<scalar_t>::loadu(cy_data + pos, count).tanh();
+      const auto gog = go * tanh_cy;
+      const auto gcx = go * og * (one - tanh_cy * tanh_cy) + goc;
+      const auto gig = gcx * cg;
+      const auto gfg = gcx * Vec<scalar_t>::loadu(cx_data + pos, count);
+      const auto gcg = gcx * ig;
+
+      (gig * (one - ig) * ig).store(ggates + offset, count);
+      (gfg * (one - fg) * fg).store(ggates + offset + hsz, count);
+      (gcg * (one - cg * cg)).store(ggates + offset + 2 * hsz, count);
+      (gog * (one - og) * og).store(ggates + offset + 3 * hsz, count);
+      (gcx * fg).store(gcx_data + pos, count);
+    });
+  });
+}
+
+void gru_cell_kernel(
+    Tensor& hy,
+    Tensor& workspace,
+    const Tensor& input_gates,
+    const Tensor& hidden_gates,
+    const Tensor& hx,
+    const Tensor& input_bias,
+    const Tensor& hidden_bias) {
+  const int64_t batch = hx.size(0);
+  const int64_t hsz = hx.size(1);
+  AT_DISPATCH_FLOATING_TYPES(hx.scalar_type(), "gru_cell_cpu", [&] {
+    const auto* igates = input_gates.data_ptr<scalar_t>();
+    const auto* hgates = hidden_gates.data_ptr<scalar_t>();
+    const auto* ibias = input_bias.defined() ? input_bias.data_ptr<scalar_t>() : nullptr;
+    const auto* hbias = hidden_bias.defined() ? hidden_bias.data_ptr<scalar_t>() : nullptr;
+    const auto* hx_data = hx.data_ptr<scalar_t>();
+    auto* hy_data = hy.data_ptr<scalar_t>();
+    auto* ws = workspace.data_ptr<scalar_t>();
+
+    for_each_block<scalar_t>(batch, hsz, 24, [&](int64_t row, int64_t j, int64_t count) {
+      const int64_t offset = row * 3 * hsz + j;
+      const int64_t ws_offset = row * 5 * hsz + j;
+      const int64_t pos = row * hsz + j;
+      Vec<scalar_t> in[3];
+      Vec<scalar_t> hn[3];
+      for (int64_t g = 0; g < 3; g++) {
+        in[g] = Vec<scalar_t>::loadu(igates + offset + g * hsz, count) +
+            load_or_zero(ibias == nullptr ? nullptr : ibias + g * hsz + j, count);
+        hn[g] = Vec<scalar_t>::loadu(hgates + offset + g * hsz, count) +
+            load_or_zero(hbias == nullptr ? nullptr : hbias + g * hsz + j, count);
+      }
+      const auto rg = sigmoid(in[0] + hn[0]);
+      const auto ig = sigmoid(in[1] + hn[1]);
+      const auto ng = (in[2] + rg * hn[2]).tanh();
+      const auto h = Vec<scalar_t>::loadu(hx_data + pos, count);
+      (ng + ig * (h - ng)).store(hy_data + pos, count);
+
+      rg.store(ws + ws_offset, count);
+      ig.store(ws + ws_offset + hsz, count);
+      ng.store(ws + ws_offset + 2 * hsz, count);
+      h.store(ws + ws_offset + 3 * hsz, count);
+      hn[2].store(ws + ws_offset + 4 * hsz, count);
+    });
+  });
+}
+
+void gru_cell_backward_kernel(
+    Tensor& grad_input_gates,
+    Tensor& grad_hidden_gates,
+    Tensor& grad_hx,
+    const Tensor& grad_hy,
+    const Tensor& workspace) {
+  const int64_t batch = grad_hy.size(0);
+  const int64_t hsz = grad_hy.size(1);
+  AT_DISPATCH_FLOATING_TYPES(grad_hy.scalar_type(), "gru_cell_backward_cpu", [&] {
+    const auto* ghy = grad_hy.data_ptr<scalar_t>();
+    const auto* ws = workspace.data_ptr<scalar_t>();
+    auto* gigates = grad_input_gates.data_ptr<scalar_t>();
+    auto* ghgates = grad_hidden_gates.data_ptr<scalar_t>();
+    auto* ghx = grad_hx.data_ptr<scalar_t>();
+
+    for_each_block<scalar_t>(batch, hsz, 16, [&](int64_t row, int64_t j, int64_t count) {
+      const Vec<scalar_t> one(1);
+      const int64_t offset = row * 3 * hsz + j;
+      const int64_t ws_offset = row * 5 * hsz + j;
+      const int64_t pos = row * hsz + j;
+      const auto rg = Vec<scalar_t>::loadu(ws + ws_offset, count);
+      const auto ig = Vec<scalar_t>::loadu(ws + ws_offset + hsz, count);
+      const auto ng = Vec<scalar_t>::loadu(ws + ws_offset + 2 * hsz, count);
+      const auto hx = Vec<scalar_t>::loadu(ws + ws_offset + 3 * hsz, count);
+      const auto hn = Vec<scalar_t>::loadu(ws + ws_offset + 4 * hsz, count);
+      const auto go = Vec<scalar_t>::loadu(ghy + pos, count);
+
+      const auto gig = go * (hx - ng) * (one - ig) * ig;
+      const auto gin = go * (one - ig) * (one - ng * ng);
+      const auto grg = gin * hn * (one - rg) * rg;
+
+      grg.store(gigates + offset, count);
+      gig.store(gigates + offset + hsz, count);
+      gin.store(gigates + offset + 2 * hsz, count);
+      grg.store(ghgates + offset, count);
+      gig.store(ghgates + offset + hsz, count);
+      (gin * rg).store(ghgates + offset + 2 * hsz, count);
+      (go * ig).store(ghx + pos, count);
+    });
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(lstm_cell_stub, &lstm_cell_kernel);
+REGISTER_DISPATCH(lstm_cell_backward_stub, &lstm_cell_backward_kernel);
+REGISTER_DISPATCH(gru_cell_stub, &gru_cell_kernel);
+REGISTER_DISPATCH(gru_cell_backward_stub, &gru_cell_backward_kernel);
+
+} // namespace native
+} // namespace at
@@ -2,7 +2,9 @@
 #include <iterator>
 #include <algorithm>
 
+#include <ATen/Context.h>
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
 #include <ATen/cpu/vec256/vec256.h>
 #include <ATen/native/ReduceOps.h>
 #include <ATen/native/ReduceOpsUtils.h>
@@ -18,85 +20,193 @@ namespace at { namespace native { namespace {
 
 using namespace vec256;
 
-template <typename scalar_t, typename func_t>
-static inline void cpu_cum_base_kernel(Tensor& result,
-    const Tensor& self,
+// Scans n elements into out from acc, where op(acc, x) updates acc with x.
+// Returns the final acc.
+template <typename scalar_t, typename acc_t, typename op_t>
+static inline acc_t cpu_scan_sequential(
+    const scalar_t* self_data, int64_t self_stride,
+    scalar_t* result_data, int64_t result_stride,
+    int64_t n, acc_t acc, const op_t& op) {
+  for (int64_t i = 0; i < n; ++i) {
+    op(acc, self_data[i * self_stride]);
+    result_data[i * result_stride] = (scalar_t)acc;
+  }
+  return acc;
+}
+
+// Note [Parallel scans on CPU]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// A scan along dim of a contiguous tensor is seen as [outer, n, inner]:
+//
+// - If inner > 1, the n rows of every [n, inner] block are scanned together
+//   in chunks of the inner dim, with a contiguous loop over the chunk that
+//   the compiler vectorizes, in parallel over blocks and chunks.
+// - If inner == 1 and there are enough slices to keep every thread busy,
+//   every slice is scanned on one thread, in parallel over slices.
+// - Otherwise every long slice is scanned in two parallel passes: the first
+//   reduces blocks of the slice, which gives the initial value of every
+//   block, and the second scans every block from it. This relies on op being
+//   associative, and may round floating point values differently than a
+//   sequential scan.
+//
+// Results that are not contiguous are scanned one slice at a time.
+template <typename scalar_t, typename acc_t, typename op_t>
+static void cpu_scan_kernel(
+    Tensor& result,
+    const Tensor& self_,
     int64_t dim,
-    const func_t& f,
-    scalar_t init_val) {
-  if (result.sizes() != self.sizes()) {
-    result.resize_as_(self);
+    acc_t init,
+    const op_t& op) {
+  if (result.sizes() != self_.sizes()) {
+    result.resize_as_(self_);
   }
-  if (self.numel() == 0) {
+  if (self_.numel() == 0) {
     return;
   }
-  const auto input_ndim = self.dim();
-  if (input_ndim == 0) {
-    result.fill_(self);
+  if (self_.dim() == 0) {
+    result.fill_(self_);
     return;
   }
 
-  auto iter = TensorIterator();
-  iter.dont_compute_common_dtype();
-  iter.dont_resize_outputs();
-  iter.declare_static_shape(self.sizes(), /*squash_dim=*/dim);
-  iter.add_output(result);
-  iter.add_input(self);
-  iter.build();
-
-  auto result_dim_stride = ensure_nonempty_stride(result, dim);
-  auto self_dim_stride = ensure_nonempty_stride(self, dim);
-
-  auto loop = [&](char** data, const int64_t* strides, int64_t n) {
-    auto* result_data_bytes = data[0];
-    const auto* self_data_bytes = data[1];
-
-    for (int64_t i = 0; i < n; ++i) {
-      f(
-        (scalar_t*)result_data_bytes, result_dim_stride,
-        (scalar_t*)self_data_bytes, self_dim_stride, init_val
-      );
-      result_data_bytes += strides[0];
-      self_data_bytes += strides[1];
-    }
-  };
+  if (!result.is_contiguous()) {
+    auto iter = TensorIterator();
+    iter.dont_compute_common_dtype();
+    iter.dont_resize_outputs();
+    iter.declare_static_shape(self_.sizes(), /*squash_dim=*/dim);
+    iter.add_output(result);
+    iter.add_input(self_);
+    iter.build();
+
+    const auto n = self_.size(dim);
+    const auto result_dim_stride = ensure_nonempty_stride(result, dim);
+    const auto self_dim_stride = ensure_nonempty_stride(self_, dim);
+    iter.for_each([&](char** data, const int64_t* strides, int64_t size) {
+      for (int64_t i = 0; i < size; ++i) {
+        cpu_scan_sequential(
+            (const scalar_t*)(data[1] + i * strides[1]), self_dim_stride,
+            (scalar_t*)(data[0] + i * strides[0]), result_dim_stride,
+            n, init, op);
+      }
+    });
+    return;
+  }
+
+  const Tensor self = self_.contiguous();
+  const int64_t n = self.size(dim);
+  const int64_t outer = prod_intlist(self.sizes().slice(0, dim));
+  const int64_t inner = prod_intlist(self.sizes().slice(dim + 1));
+  const scalar_t* self_data = self.data_ptr<scalar_t>();
+  scalar_t* result_data = result.data_ptr<scalar_t>();
 
-  iter.for_each(loop);
+  if (inner > 1) {
+    constexpr int64_t kChunk = 64;
+    const int64_t chunks = divup(inner, kChunk);
+    const int64_t grain_size =
+        std::max<int64_t>(1, internal::GRAIN_SIZE / (n * kChunk));
+    at::parallel_for(0, outer * chunks, grain_size, [&](int64_t begin, int64_t end) {
+      acc_t acc[kChunk];
+      for (int64_t item = begin; item < end; item++) {
+        const int64_t offset = (item / chunks) * n * inner + (item % chunks) * kChunk;
+        const int64_t len = std::min(kChunk, inner - (item % chunks) * kChunk);
+        const scalar_t* self_row = self_data + offset;
+        scalar_t* result_row = result_data + offset;
+        std::fill(acc, acc + len, init);
+        for (int64_t i = 0; i < n; i++) {
+          for (int64_t k = 0; k < len; k++) {
+            op(acc[k], self_row[k]);
+            result_row[k] = (scalar_t)acc[k];
+          }
+          self_row += inner;
+          result_row += inner;
+        }
+      }
+    });
+  } else if (outer >= at::get_num_threads() || n < internal::GRAIN_SIZE) {
+    const int64_t grain_size = std::max<int64_t>(1, internal::GRAIN_SIZE / n);
+    at::parallel_for(0, outer, grain_size, [&](int64_t begin, int64_t end) {
+      for (int64_t o = begin; o < end; o++) {
+        cpu_scan_sequential(
+            self_data + o * n, 1, result_data + o * n, 1, n, init, op);
+      }
+    });
+  } else {
+    const int64_t nblocks =
+        std::min<int64_t>(at::get_num_threads(), divup(n, internal::GRAIN_SIZE));
+    const int64_t block_size = divup(n, nblocks);
+    std::vector<acc_t> block_init(nblocks);
+    for (int64_t o = 0; o < outer; o++) {
+      const scalar_t* self_slice = self_data + o * n;
+      scalar_t* result_slice = result_data + o * n;
+      at::parallel_for(0, nblocks, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t b = begin; b < end; b++) {
+          acc_t acc = init;
+          const int64_t block_end = std::min(n, (b + 1) * block_size);
+          for (int64_t i = b * block_size; i < block_end; i++) {
+            op(acc, self_slice[i]);
+          }
+          block_init[b] = acc;
+        }
+      });
+      acc_t acc = init;
+      for (int64_t b = 0; b < nblocks; b++) {
+        const acc_t block_total = block_init[b];
+        block_init[b] = acc;
+        op(acc, block_total);
+      }
+      at::parallel_for(0, nblocks, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t b = begin; b < end; b++) {
+          const int64_t block_begin = b * block_size;
+          const int64_t len = std::min(n, block_begin + block_size) - block_begin;
+          cpu_scan_sequential(
+              self_slice + block_begin, 1, result_slice + block_begin, 1,
+              len, block_init[b], op);
+        }
+      });
+    }
+  }
 }
 
 static void cumsum_cpu_kernel(Tensor& result, const Tensor& self, int64_t dim) {
   auto wrap_dim = maybe_wrap_dim(dim, self.dim());
-  int64_t self_dim_size = ensure_nonempty_size(self, wrap_dim);
 
   AT_DISPATCH_ALL_TYPES_AND_COMPLEX(self.scalar_type(), "cumsum_out_cpu", [&] {
-    cpu_cum_base_kernel<scalar_t>(result, self, wrap_dim, [&] (
-      scalar_t* result_data, auto result_dim_stride,
-      const scalar_t* self_data, auto self_dim_stride, scalar_t init_val) {
-        auto cum_number = (at::acc_type<scalar_t, false>)init_val;
-        for (int64_t i = 0; i < self_dim_size; ++i) {
-          cum_number += self_data[i * self_dim_stride];
-          result_data[i * result_dim_stride] = (scalar_t)cum_number;
-        }
-      }, /*init_val=*/ 0
-    );
+    using acc_t = at::acc_type<scalar_t, false>;
+    cpu_scan_kernel<scalar_t>(result, self, wrap_dim, /*init=*/acc_t(0),
+      [](acc_t& acc, const auto& x) { acc += x; });
   });
 }
 
 static void cumprod_cpu_kernel(Tensor& result, const Tensor& self, int64_t dim) {
   auto wrap_dim = maybe_wrap_dim(dim, self.dim());
-  int64_t self_dim_size = ensure_nonempty_size(self, wrap_dim);
 
   AT_DISPATCH_ALL_TYPES_AND_COMPLEX(self.scalar_type(), "cumprod_out_cpu", [&] {
-    cpu_cum_base_kernel<scalar_t>(result, self, wrap_dim, [&] (
-      scalar_t* result_data, auto result_dim_stride,
-      const scalar_t* self_data, auto self_dim_stride, scalar_t init_val) {
-        auto cum_number = (at::acc_type<scalar_t, false>)init_val;
-        for (int64_t i = 0; i < self_dim_size; ++i) {
-          cum_number *= self_data[i * self_dim_stride];
-          result_data[i * result_dim_stride] = (scalar_t)cum_number;
-        }
-      }, /*init_val=*/ 1
-    );
+    using acc_t = at::acc_type<scalar_t, false>;
+    cpu_scan_kernel<scalar_t>(result, self, wrap_dim, /*init=*/acc_t(1),
+      [](acc_t& acc, const auto& x) { acc *= x; });
+  });
+}
+
+// log(exp(x) + exp(y)), which is exact for infinite x or y of the same sign
+// and propagates NaN.
+template <typename scalar_t>
+static inline scalar_t log_add_exp(scalar_t x, scalar_t y) {
+  // std::min and std::max return their first argument if y is NaN.
+  const scalar_t min = std::isnan(y) ? y : std::min(x, y);
+  const scalar_t max = std::isnan(y) ? y : std::max(x, y);
+  if (min != max || std::isfinite(min)) {
+    return max + std::log1p(std::exp(min - max));
+  }
+  return x;
+}
+
+static void logcumsumexp_cpu_kernel(Tensor& result, const Tensor& self, int64_t dim) {
+  auto wrap_dim = maybe_wrap_dim(dim, self.dim());
+
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "logcumsumexp_out_cpu", [&] {
+    using acc_t = at::acc_type<scalar_t, false>;
+    cpu_scan_kernel<scalar_t>(result, self, wrap_dim,
+      /*init=*/-std::numeric_limits<acc_t>::infinity(),
+      [](acc_t& acc, const auto& x) { acc = log_add_exp(acc, static_cast<acc_t>(x)); });
   });
 }
 
@@ -120,16 +230,153 @@ static void mean_kernel_impl(TensorIterator& iter) {
   });
 }
 
-static void std_var_kernel_impl(TensorIterator &iter, bool unbiased, bool take_sqrt) {
-  AT_DISPATCH_FLOATING_TYPES_AND_HALF(iter.dtype(), "std_cpu", [&] {
-    binary_kernel_reduce(
-      iter,
-      WelfordOps<scalar_t, double, int64_t, double, std::tuple<scalar_t, scalar_t>> { unbiased, take_sqrt },
-      WelfordData<double, int64_t, double>()
-    );
+// Note [Vectorized Welford]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~
+// std and var of float and double tensors reduce the contiguous inner loops
+// of the input in vectors: every lane of kWelfordVecs vectors accumulates the
+// mean and m2 of the elements of its position, all lanes having seen the same
+// number of elements, so that the reciprocal of the count is shared. The lanes
+// and the elements left over are merged with WelfordOps::combine, like the
+// partial results of the threads. Float tensors accumulate in double unless
+// Context::allowFloatAccumulationCPU() is set. Both outputs of var_mean and
+// std_mean come from the same pass.
+
+constexpr int64_t kWelfordVecs = 4;
+
+template <typename acc_scalar_t, typename scalar_t>
+inline Vec256<acc_scalar_t> load_as(const scalar_t* data) {
+  __at_align32__ acc_scalar_t buffer[Vec256<acc_scalar_t>::size()];
+  for (int64_t i = 0; i < Vec256<acc_scalar_t>::size(); i++) {
+    buffer[i] = static_cast<acc_scalar_t>(data[i]);
+  }
+  return Vec256<acc_scalar_t>::loadu(buffer);
+}
+
+template <>
+inline Vec256<float> load_as<float, float>(const float* data) {
+  return Vec256<float>::loadu(data);
+}
+
+template <>
+inline Vec256<double> load_as<double, double>(const double* data) {
+  return Vec256<double>::loadu(data);
+}
+
+template <typename scalar_t, typename acc_scalar_t>
+using WelfordOpsCPU = WelfordOps<scalar_t, acc_scalar_t, int64_t, acc_scalar_t, std::tuple<scalar_t, scalar_t>>;
+
+template <typename scalar_t, typename acc_scalar_t>
+WelfordData<acc_scalar_t, int64_t, acc_scalar_t> welford_reduce_contiguous(
+    const WelfordOpsCPU<scalar_t, acc_scalar_t>& ops, const scalar_t* data, int64_t n) {
+  using Vec = Vec256<acc_scalar_t>;
+  using acc_t = WelfordData<acc_scalar_t, int64_t, acc_scalar_t>;
+  constexpr int64_t step = kWelfordVecs * Vec::size();
+  const int64_t steps = n / step;
+
+  acc_t acc;
+  if (steps > 0) {
+    Vec mean[kWelfordVecs];
+    Vec m2[kWelfordVecs];
+    for (int64_t k = 0; k < kWelfordVecs; k++) {
+      mean[k] = Vec(0);
+      m2[k] = Vec(0);
+    }
+    for (int64_t s = 0; s < steps; s++) {
+      const Vec inv_count(acc_scalar_t(1) / (s + 1));
+      const scalar_t* block = data + s * step;
+      for (int64_t k = 0; k < kWelfordVecs; k++) {
+        Vec x = load_as<acc_scalar_t>(block + k * Vec::size());
+        Vec delta = x - mean[k];
+        mean[k] = mean[k] + delta * inv_count;
+        m2[k] = m2[k] + delta * (x - mean[k]);
+      }
+    }
+    __at_align32__ acc_scalar_t lane_mean[Vec::size()];
+    __at_align32__ acc_scalar_t lane_m2[Vec::size()];
+    for (int64_t k = 0; k < kWelfordVecs; k++) {
+      mean[k].store(lane_mean);
+      m2[k].store(lane_m2);
+      for (int64_t l = 0; l < Vec::size(); l++) {
+        acc = ops.combine(acc, acc_t(lane_mean[l], lane_m2[l], steps, acc_scalar_t(steps)));
+      }
+    }
+  }
+
+  acc_t tail;
+  for (int64_t i = steps * step; i < n; i++) {
+    tail = ops.reduce(tail, data[i], i);
+  }
+  return ops.combine(acc, tail);
+}
+
+// binary_kernel_reduce with the inner loops of welford_reduce_contiguous, see
+// Note [Vectorized Welford].
+template <typename scalar_t, typename acc_scalar_t>
+void std_var_welford_kernel(TensorIterator& iter, bool unbiased, bool take_sqrt) {
+  using ops_t = WelfordOpsCPU<scalar_t, acc_scalar_t>;
+  using acc_t = WelfordData<acc_scalar_t, int64_t, acc_scalar_t>;
+  using r_traits = binary_function_traits<decltype(&ops_t::reduce)>;
+  const ops_t ops{unbiased, take_sqrt};
+  const int num_outputs = iter.noutputs();
+  iter.foreach_reduced_elt([&ops, num_outputs](TensorIterator& sub_iter) {
+    auto reduction_body = [&ops, &sub_iter](acc_t acc, int64_t begin, int64_t end) -> acc_t {
+      const int ntensors = sub_iter.ntensors();
+      sub_iter.serial_for_each([&acc, &ops, ntensors](char** data, const int64_t* strides, int64_t size) {
+        const char* in = data[ntensors - 1];
+        const int64_t stride = strides[ntensors - 1];
+        if (stride == sizeof(scalar_t)) {
+          acc = ops.combine(acc, welford_reduce_contiguous(ops, reinterpret_cast<const scalar_t*>(in), size));
+          return;
+        }
+        acc_t part;
+        for (int64_t i = 0; i < size; i++) {
+          part = ops.reduce(part, *reinterpret_cast<const scalar_t*>(in + i * stride), i);
+        }
+        acc = ops.combine(acc, part);
+      }, {begin, end});
+      return acc;
+    };
+    acc_t total_acc;
+    auto numel = sub_iter.numel();
+    if (numel < at::internal::GRAIN_SIZE || at::get_num_threads() == 1 ||
+        at::in_parallel_region()) {
+      total_acc = reduction_body(total_acc, 0, numel);
+    } else {
+      std::vector<acc_t> buffer(at::get_num_threads());
+      at::parallel_for(0, numel, internal::GRAIN_SIZE,
+        [&](int64_t begin, int64_t end) {
+          auto& acc = buffer[at::get_thread_num()];
+          acc = reduction_body(acc, begin, end);
+        }
+      );
+      for (const auto& acc : buffer) {
+        total_acc = ops.combine(total_acc, acc);
+      }
+    }
+    set_results<r_traits>(ops.project(total_acc), sub_iter, num_outputs);
   });
 }
 
+static void std_var_kernel_impl(TensorIterator &iter, bool unbiased, bool take_sqrt) {
+  if (iter.dtype() == kFloat) {
+    if (at::globalContext().allowFloatAccumulationCPU()) {
+      std_var_welford_kernel<float, float>(iter, unbiased, take_sqrt);
+    } else {
+      std_var_welford_kernel<float, double>(iter, unbiased, take_sqrt);
+    }
+  } else if (iter.dtype() == kDouble) {
+    std_var_welford_kernel<double, double>(iter, unbiased, take_sqrt);
+  } else {
+    AT_DISPATCH_FLOATING_TYPES_AND_HALF(iter.dtype(), "std_cpu", [&] {
+      binary_kernel_reduce(
+        iter,
+        WelfordOps<scalar_t, double, int64_t, double, std::tuple<scalar_t, scalar_t>> { unbiased, take_sqrt },
+        WelfordData<double, int64_t, double>()
+      );
+    });
+  }
+}
+
 static void prod_kernel_impl(TensorIterator& iter) {
   AT_DISPATCH_ALL_TYPES_AND_COMPLEX(iter.dtype(), "prod_cpu", [&] {
     binary_kernel_reduce_vec(
@@ -278,6 +525,34 @@ static void argmin_kernel_impl(TensorIterator &iter) {
   });
 }
 
+template <typename scalar_t, int N, typename res_t>
+static void fused_reduce_kernel(TensorIterator& iter, ArrayRef<FusedReduction> reductions) {
+  using acc_t = at::acc_type<scalar_t, /*is_cuda=*/false>;
+  auto ops = FusedReduceOps<scalar_t, acc_t, N, res_t>(reductions);
+  binary_kernel_reduce(iter, ops, ops.identity());
+}
+
+static void fused_reduce_kernel_impl(TensorIterator& iter, ArrayRef<FusedReduction> reductions) {
+  AT_DISPATCH_ALL_TYPES_AND(kBFloat16, iter.dtype(), "fused_reduce_cpu", [&] {
+    switch (reductions.size()) {
+      case 1:
+        fused_reduce_kernel<scalar_t, 1, scalar_t>(iter, reductions);
+        break;
+      case 2:
+        fused_reduce_kernel<scalar_t, 2, std::tuple<scalar_t, scalar_t>>(iter, reductions);
+        break;
+      case 3:
+        fused_reduce_kernel<scalar_t, 3, std::tuple<scalar_t, scalar_t, scalar_t>>(iter, reductions);
+        break;
+      case 4:
+        fused_reduce_kernel<scalar_t, 4, std::tuple<scalar_t, scalar_t, scalar_t, scalar_t>>(iter, reductions);
+        break;
+      default:
+        TORCH_INTERNAL_ASSERT(false, "fused_reduce: unexpected number of reductions ", reductions.size());
+    }
+  });
+}
+
 }  // anonymous namespace
 
 REGISTER_DISPATCH(sum_stub, &sum_kernel_impl);
@@ -293,5 +568,7 @@ REGISTER_DISPATCH(argmax_stub, &argmax_kernel_impl);
 REGISTER_DISPATCH(argmin_stub, &argmin_kernel_impl);
 REGISTER_DISPATCH(cumprod_stub, &cumprod_cpu_kernel);
 REGISTER_DISPATCH(cumsum_stub, &cumsum_cpu_kernel);
+REGISTER_DISPATCH(logcumsumexp_stub, &logcumsumexp_cpu_kernel);
+REGISTER_DISPATCH(fused_reduce_stub, &fused_reduce_kernel_impl);
 
 }}  // namespace at::native
@@ -1,8 +1,12 @@
 #include <ATen/native/ScatterGatherShapeChecks.h>
 #include <ATen/native/DispatchStub.h>
+#include <ATen/native/TensorAdvancedIndexing.h>
 #include <ATen/native/TensorIterator.h>
+#include <ATen/Dispatch.h>
 #include <ATen/Parallel.h>
 
+#include <algorithm>
+
 namespace at { namespace native {
 
 namespace {
@@ -195,11 +199,230 @@ void scatter_add_cpu_kernel(Tensor& self, int64_t dim, const Tensor& index, cons
   );
 }
 
+// Per-element updates of scatter_reduce and segment_reduce. `pos` is the
+// position of `val` along the reduced dimension and `arg` the position of the
+// value taken by max / min so far, `none` if there is none.
+template <ScatterReduceOp op>
+struct _cpu_scatter_reducer;
+
+template <>
+struct _cpu_scatter_reducer<ScatterReduceOp::Sum> {
+  static constexpr bool has_arg = false;
+  template <typename scalar_t>
+  static void init(scalar_t& acc) { acc = 0; }
+  template <typename scalar_t>
+  static void update(scalar_t& acc, scalar_t val, int64_t pos, int64_t& arg, int64_t none) { acc += val; }
+  template <typename scalar_t>
+  static void finalize(scalar_t& acc, int64_t count, int64_t arg, int64_t none) {}
+};
+
+template <>
+struct _cpu_scatter_reducer<ScatterReduceOp::Prod> {
+  static constexpr bool has_arg = false;
+  template <typename scalar_t>
+  static void init(scalar_t& acc) { acc = 1; }
+  template <typename scalar_t>
+  static void update(scalar_t& acc, scalar_t val, int64_t pos, int64_t& arg, int64_t none) { acc *= val; }
+  template <typename scalar_t>
+  static void finalize(scalar_t& acc, int64_t count, int64_t arg, int64_t none) {}
+};
+
+template <>
+struct _cpu_scatter_reducer<ScatterReduceOp::Mean> {
+  static constexpr bool has_arg = false;
+  template <typename scalar_t>
+  static void init(scalar_t& acc) { acc = 0; }
+  template <typename scalar_t>
+  static void update(scalar_t& acc, scalar_t val, int64_t pos, int64_t& arg, int64_t none) { acc += val; }
+  template <typename scalar_t>
+  static void finalize(scalar_t& acc, int64_t count, int64_t arg, int64_t none) {
+    if (count > 0) {
+      acc = acc / static_cast<scalar_t>(count);
+    }
+  }
+};
+
+template <bool is_max>
+struct _cpu_scatter_arg_reducer {
+  static constexpr bool has_arg = true;
+  template <typename scalar_t>
+  static void init(scalar_t& acc) { acc = 0; }
+  template <typename scalar_t>
+  static void update(scalar_t& acc, scalar_t val, int64_t pos, int64_t& arg, int64_t none) {
+    // the first NaN wins, otherwise the first of equal values
+    const bool val_is_nan = val != val;
+    if (arg == none || (is_max ? val > acc : val < acc) || (val_is_nan && !(acc != acc))) {
+      acc = val;
+      arg = pos;
+    }
+  }
+  template <typename scalar_t>
+  static void finalize(scalar_t& acc, int64_t count, int64_t arg, int64_t none) {
+    if (arg == none) {
+      acc = 0;
+    }
+  }
+};
+
+template <>
+struct _cpu_scatter_reducer<ScatterReduceOp::Max> : _cpu_scatter_arg_reducer<true> {};
+
+template <>
+struct _cpu_scatter_reducer<ScatterReduceOp::Min> : _cpu_scatter_arg_reducer<false> {};
+
+template <typename func_t>
+void dispatch_scatter_reduce_op(ScatterReduceOp op, const func_t& f) {
+  switch (op) {
+    case ScatterReduceOp::Sum:
+      return f(_cpu_scatter_reducer<ScatterReduceOp::Sum>());
+    case ScatterReduceOp::Prod:
+      return f(_cpu_scatter_reducer<ScatterReduceOp::Prod>());
+    case ScatterReduceOp::Mean:
+      return f(_cpu_scatter_reducer<ScatterReduceOp::Mean>());
+    case ScatterReduceOp::Max:
+      return f(_cpu_scatter_reducer<ScatterReduceOp::Max>());
+    case ScatterReduceOp::Min:
+      return f(_cpu_scatter_reducer<ScatterReduceOp::Min>());
+  }
+}
+
+// Calls f(o, j_begin, j_end) for blocks of the outer * inner columns (o, :, j)
+// in parallel. A column of the result is only written by the task reducing
+// the same column of the input, so there are no races between the tasks and
+// the result does not depend on the number of threads.
+template <typename func_t>
+void parallel_for_columns(int64_t outer, int64_t inner, int64_t column_cost, const func_t& f) {
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(column_cost, 1));
+  at::parallel_for(0, outer * inner, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end;) {
+      const int64_t o = c / inner;
+      const int64_t j_begin = c % inner;
+      const int64_t j_end = std::min(inner, j_begin + (end - c));
+      f(o, j_begin, j_end);
+      c += j_end - j_begin;
+    }
+  });
+}
+
+void scatter_reduce_cpu_kernel(Tensor& result, Tensor& arg, const Tensor& self, const Tensor& index, ScatterReduceOp op) {
+  const int64_t outer = self.size(0);
+  const int64_t n = self.size(1);
+  const int64_t inner = self.size(2);
+  const int64_t output_size = result.size(1);
+  if (result.numel() == 0) {
+    return;
+  }
+  // a 1-dimensional index is the same for all the columns
+  const bool broadcast_index = index.numel() != self.numel();
+  const int64_t index_outer_stride = broadcast_index ? 0 : n * inner;
+  const int64_t index_dim_stride = broadcast_index ? 1 : inner;
+  const int64_t index_inner_stride = broadcast_index ? 0 : 1;
+  const auto* index_data = index.data_ptr<int64_t>();
+  // number of values scattered to each element, for the mean
+  auto count = op == ScatterReduceOp::Mean ? at::zeros(result.sizes(), index.options()) : Tensor();
+  auto* count_data = count.defined() ? count.data_ptr<int64_t>() : nullptr;
+  auto* arg_data = arg.numel() > 0 ? arg.data_ptr<int64_t>() : nullptr;
+
+  AT_DISPATCH_ALL_TYPES_AND2(ScalarType::Half, ScalarType::BFloat16, self.scalar_type(), "scatter_reduce_cpu", [&] {
+    const auto* self_data = self.data_ptr<scalar_t>();
+    auto* result_data = result.data_ptr<scalar_t>();
+    dispatch_scatter_reduce_op(op, [&](auto reducer) {
+      using reducer_t = decltype(reducer);
+      parallel_for_columns(outer, inner, n + output_size, [&](int64_t o, int64_t j_begin, int64_t j_end) {
+        int64_t unused_arg = 0;
+        for (int64_t k = 0; k < output_size; k++) {
+          for (int64_t j = j_begin; j < j_end; j++) {
+            const int64_t r = (o * output_size + k) * inner + j;
+            reducer_t::init(result_data[r]);
+            if (reducer_t::has_arg) {
+              arg_data[r] = n;
+            }
+          }
+        }
+        for (int64_t i = 0; i < n; i++) {
+          const int64_t* index_row = index_data + o * index_outer_stride + i * index_dim_stride;
+          const scalar_t* self_row = self_data + (o * n + i) * inner;
+          for (int64_t j = j_begin; j < j_end; j++) {
+            const int64_t k = index_row[j * index_inner_stride];
+            TORCH_CHECK(k >= 0 && k < output_size,
+              "scatter_reduce: index ", index_row[j * index_inner_stride],
+              " is out of bounds for output size ", output_size);
+            const int64_t r = (o * output_size + k) * inner + j;
+            reducer_t::update(result_data[r], self_row[j], i, reducer_t::has_arg ? arg_data[r] : unused_arg, n);
+            if (count_data) {
+              count_data[r]++;
+            }
+          }
+        }
+        for (int64_t k = 0; k < output_size; k++) {
+          for (int64_t j = j_begin; j < j_end; j++) {
+            const int64_t r = (o * output_size + k) * inner + j;
+            reducer_t::finalize(
+              result_data[r], count_data ? count_data[r] : 0, reducer_t::has_arg ? arg_data[r] : n, n);
+          }
+        }
+      });
+    });
+  });
+}
+
+void segment_reduce_cpu_kernel(Tensor& result, Tensor& arg, const Tensor& data, const Tensor& offsets, ScatterReduceOp op) {
+  const int64_t outer = data.size(0);
+  const int64_t n = data.size(1);
+  const int64_t inner = data.size(2);
+  const int64_t num_segments = result.size(1);
+  if (result.numel() == 0) {
+    return;
+  }
+  const auto offsets_ = offsets.contiguous();
+  const auto* offsets_data = offsets_.data_ptr<int64_t>();
+  auto* arg_data = arg.numel() > 0 ? arg.data_ptr<int64_t>() : nullptr;
+
+  AT_DISPATCH_ALL_TYPES_AND2(ScalarType::Half, ScalarType::BFloat16, data.scalar_type(), "segment_reduce_cpu", [&] {
+    const auto* data_data = data.data_ptr<scalar_t>();
+    auto* result_data = result.data_ptr<scalar_t>();
+    dispatch_scatter_reduce_op(op, [&](auto reducer) {
+      using reducer_t = decltype(reducer);
+      // the segments are disjoint, so the tasks are over whole output rows
+      // (o, s, :) and read the input rows of the segment contiguously
+      const int64_t row_cost = inner * std::max<int64_t>(1, n / num_segments);
+      const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(row_cost, 1));
+      at::parallel_for(0, outer * num_segments, grain_size, [&](int64_t begin, int64_t end) {
+        int64_t unused_arg = 0;
+        for (int64_t row = begin; row < end; row++) {
+          const int64_t o = row / num_segments;
+          const int64_t s = row % num_segments;
+          scalar_t* result_row = result_data + row * inner;
+          int64_t* arg_row = reducer_t::has_arg ? arg_data + row * inner : nullptr;
+          for (int64_t j = 0; j < inner; j++) {
+            reducer_t::init(result_row[j]);
+            if (reducer_t::has_arg) {
+              arg_row[j] = n;
+            }
+          }
+          for (int64_t i = offsets_data[s]; i < offsets_data[s + 1]; i++) {
+            const scalar_t* data_row = data_data + (o * n + i) * inner;
+            for (int64_t j = 0; j < inner; j++) {
+              reducer_t::update(result_row[j], data_row[j], i, reducer_t::has_arg ? arg_row[j] : unused_arg, n);
+            }
+          }
+          const int64_t count = offsets_data[s + 1] - offsets_data[s];
+          for (int64_t j = 0; j < inner; j++) {
+            reducer_t::finalize(result_row[j], count, reducer_t::has_arg ? arg_row[j] : n, n);
+          }
+        }
+      });
+    });
+  });
+}
+
 } // anonymous namespace
 
 REGISTER_DISPATCH(gather_stub, &gather_cpu_kernel);
 REGISTER_DISPATCH(scatter_stub, &scatter_cpu_kernel);
 REGISTER_DISPATCH(scatter_fill_stub, &scatter_fill_cpu_kernel);
 REGISTER_DISPATCH(scatter_add_stub, &scatter_add_cpu_kernel);
+REGISTER_DISPATCH(scatter_reduce_stub, &scatter_reduce_cpu_kernel);
+REGISTER_DISPATCH(segment_reduce_stub, &segment_reduce_cpu_kernel);
 
 }} // namespace at::native
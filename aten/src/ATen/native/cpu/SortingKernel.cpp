@@ -5,10 +5,221 @@
 #include <ATen/native/Sorting.h>
 #include <ATen/native/SortingUtils.h>
 
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+
 namespace at { namespace native {
 
 namespace {
 
+// Slices of at least this size are sorted, or have their top k selected, by
+// all threads together if there are fewer slices than threads. Smaller
+// slices are sorted one per thread.
+constexpr int64_t PARALLEL_SORT_MIN_SIZE = 1 << 16;
+
+// Linear offsets of the first element of slice `slice` along dim
+template <size_t N>
+void slice_offsets(
+    const std::array<const Tensor*, N>& tensors, int64_t dim, int64_t slice,
+    std::array<int64_t, N>& offsets) {
+  offsets.fill(0);
+  const auto& t = *tensors[0];
+  for (int64_t d = t.dim() - 1; d >= 0; d--) {
+    if (d == dim) {
+      continue;
+    }
+    const int64_t i = slice % t.size(d);
+    slice /= t.size(d);
+    for (size_t j = 0; j < N; j++) {
+      offsets[j] += i * tensors[j]->stride(d);
+    }
+  }
+}
+
+// The comparisons like TH: NaN is larger than any other value, so it is last
+// in ascending and first in descending order. `x != x` is the NaN test that
+// also works for Half.
+template <typename scalar_t>
+struct SortAscending {
+  bool operator()(const std::pair<scalar_t, int64_t>& x, const std::pair<scalar_t, int64_t>& y) const {
+    return (!(x.first != x.first) && y.first != y.first) || x.first < y.first;
+  }
+};
+
+template <typename scalar_t>
+struct SortDescending {
+  bool operator()(const std::pair<scalar_t, int64_t>& x, const std::pair<scalar_t, int64_t>& y) const {
+    return (x.first != x.first && !(y.first != y.first)) || x.first > y.first;
+  }
+};
+
+// The split of the first `d` elements of the stable merge of a and b: the
+// number of them that come from a.
+template <typename elem_t, typename Comp>
+int64_t merge_path(const elem_t* a, int64_t na, const elem_t* b, int64_t nb, int64_t d, const Comp& comp) {
+  int64_t lo = std::max<int64_t>(0, d - nb);
+  int64_t hi = std::min<int64_t>(d, na);
+  while (lo < hi) {
+    const int64_t mid = lo + (hi - lo) / 2;
+    // a[mid] is merged before b[d - mid - 1] unless b's is strictly smaller
+    if (!comp(b[d - mid - 1], a[mid])) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+// std::merge of a and b into out, with the output split between the threads
+template <typename elem_t, typename Comp>
+void parallel_merge(const elem_t* a, int64_t na, const elem_t* b, int64_t nb, elem_t* out, const Comp& comp) {
+  at::parallel_for(0, na + nb, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    const int64_t a_begin = merge_path(a, na, b, nb, begin, comp);
+    const int64_t a_end = merge_path(a, na, b, nb, end, comp);
+    std::merge(
+        a + a_begin, a + a_end, b + (begin - a_begin), b + (end - a_end),
+        out + begin, comp);
+  });
+}
+
+// Stable sort of data with all threads: the chunks of the threads are sorted,
+// then merged pairwise with parallel merges. Returns data or buffer,
+// whichever holds the result, so the result is the same as the one of
+// std::stable_sort for any number of threads.
+template <typename elem_t, typename Comp>
+elem_t* parallel_stable_sort(elem_t* data, elem_t* buffer, int64_t n, const Comp& comp) {
+  const int64_t num_chunks = std::max<int64_t>(1, std::min<int64_t>(
+      at::get_num_threads(), n / at::internal::GRAIN_SIZE));
+  std::vector<int64_t> bounds(num_chunks + 1);
+  for (int64_t c = 0; c <= num_chunks; c++) {
+    bounds[c] = n * c / num_chunks;
+  }
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      std::stable_sort(data + bounds[c], data + bounds[c + 1], comp);
+    }
+  });
+  elem_t* src = data;
+  elem_t* dst = buffer;
+  for (int64_t width = 1; width < num_chunks; width *= 2) {
+    for (int64_t c = 0; c < num_chunks; c += 2 * width) {
+      const int64_t lo = bounds[c];
+      const int64_t mid = bounds[std::min(c + width, num_chunks)];
+      const int64_t hi = bounds[std::min(c + 2 * width, num_chunks)];
+      parallel_merge(src + lo, mid - lo, src + mid, hi - mid, dst + lo, comp);
+    }
+    std::swap(src, dst);
+  }
+  return src;
+}
+
+static void sort_kernel(
+    Tensor& values,
+    Tensor& indices,
+    int64_t dim,
+    bool descending) {
+  const int64_t n = values.size(dim);
+  if (values.numel() == 0) {
+    return;
+  }
+  const int64_t num_slices = values.numel() / n;
+  const int64_t values_stride = values.stride(dim);
+  const int64_t indices_stride = indices.stride(dim);
+  // sort the slices one after another with all threads, or many slices at
+  // once with one thread each
+  const bool sort_within_slice = n >= PARALLEL_SORT_MIN_SIZE &&
+      num_slices < at::get_num_threads() && !at::in_parallel_region();
+
+  AT_DISPATCH_ALL_TYPES_AND(ScalarType::Half, values.scalar_type(), "sort_cpu", [&] {
+    using elem_t = std::pair<scalar_t, int64_t>;
+    auto* values_data = values.data_ptr<scalar_t>();
+    auto* indices_data = indices.data_ptr<int64_t>();
+
+    auto sort_slice = [&](int64_t slice, std::vector<elem_t>& elems, std::vector<elem_t>& buffer) {
+      std::array<int64_t, 2> offsets;
+      slice_offsets<2>({&values, &indices}, dim, slice, offsets);
+      scalar_t* slice_values = values_data + offsets[0];
+      int64_t* slice_indices = indices_data + offsets[1];
+      elems.resize(n);
+      for (int64_t i = 0; i < n; i++) {
+        elems[i] = elem_t(slice_values[i * values_stride], i);
+      }
+      const elem_t* sorted = elems.data();
+      if (sort_within_slice) {
+        buffer.resize(n);
+        sorted = descending
+            ? parallel_stable_sort(elems.data(), buffer.data(), n, SortDescending<scalar_t>())
+            : parallel_stable_sort(elems.data(), buffer.data(), n, SortAscending<scalar_t>());
+      } else if (descending) {
+        std::stable_sort(elems.begin(), elems.end(), SortDescending<scalar_t>());
+      } else {
+        std::stable_sort(elems.begin(), elems.end(), SortAscending<scalar_t>());
+      }
+      for (int64_t i = 0; i < n; i++) {
+        slice_values[i * values_stride] = sorted[i].first;
+        slice_indices[i * indices_stride] = sorted[i].second;
+      }
+    };
+
+    if (sort_within_slice) {
+      std::vector<elem_t> elems;
+      std::vector<elem_t> buffer;
+      for (int64_t slice = 0; slice < num_slices; slice++) {
+        sort_slice(slice, elems, buffer);
+      }
+      return;
+    }
+    at::parallel_for(0, num_slices, std::max<int64_t>(1, at::internal::GRAIN_SIZE / n), [&](int64_t begin, int64_t end) {
+      std::vector<elem_t> elems;
+      std::vector<elem_t> buffer;
+      for (int64_t slice = begin; slice < end; slice++) {
+        sort_slice(slice, elems, buffer);
+      }
+    });
+  });
+}
+
+// The orders of topk, like sort but with NaN as the largest value and equal
+// values ordered by index, so the top k are the same for any partition of a
+// slice between threads.
+template <typename scalar_t, bool largest>
+struct TopkBetter {
+  bool operator()(const std::pair<scalar_t, int64_t>& x, const std::pair<scalar_t, int64_t>& y) const {
+    const bool x_nan = _isnan<scalar_t>(x.first);
+    const bool y_nan = _isnan<scalar_t>(y.first);
+    if (x_nan && y_nan) {
+      return x.second < y.second;
+    }
+    if (x_nan || y_nan) {
+      return largest ? x_nan : y_nan;
+    }
+    if (x.first != y.first) {
+      return largest ? x.first > y.first : x.first < y.first;
+    }
+    return x.second < y.second;
+  }
+};
+
+// Moves the top k elements of queue to its front, in order if sorted
+template <typename elem_t, typename Comp>
+void topk_select(std::vector<elem_t>& queue, int64_t k, bool sorted, const Comp& comp) {
+  const int64_t n = queue.size();
+  if (k == 0) {
+    return;
+  }
+  if (k * 64 <= n) {
+    std::partial_sort(queue.begin(), queue.begin() + k, queue.end(), comp);
+  } else {
+    std::nth_element(queue.begin(), queue.begin() + k - 1, queue.end(), comp);
+    if (sorted) {
+      std::sort(queue.begin(), queue.begin() + k - 1, comp);
+    }
+  }
+}
+
 static void topk_kernel(
     Tensor& values,
     Tensor& indices,
@@ -17,7 +228,61 @@ static void topk_kernel(
     int64_t dim,
     bool largest,
     bool sorted) {
+  const int64_t n = self.dim() > 0 ? self.size(dim) : 1;
+  const int64_t num_slices = n > 0 ? self.numel() / n : 0;
+  // select the top k of one slice after another with all threads, each
+  // selecting the top k of a chunk, if that leaves few candidates
+  const bool select_within_slice = n >= PARALLEL_SORT_MIN_SIZE &&
+      num_slices < at::get_num_threads() && !at::in_parallel_region() &&
+      k * at::get_num_threads() * 4 <= n;
+
   AT_DISPATCH_ALL_TYPES(self.scalar_type(), "topk_cpu", [&] {
+    using elem_t = std::pair<scalar_t, int64_t>;
+
+    auto select = [&](std::vector<elem_t>& queue, int64_t k, bool sorted) {
+      if (largest) {
+        topk_select(queue, k, sorted, TopkBetter<scalar_t, true>());
+      } else {
+        topk_select(queue, k, sorted, TopkBetter<scalar_t, false>());
+      }
+    };
+
+    if (select_within_slice) {
+      std::array<int64_t, 3> offsets;
+      const int64_t num_chunks = std::max<int64_t>(1, std::min<int64_t>(
+          at::get_num_threads(), n / at::internal::GRAIN_SIZE));
+      std::vector<elem_t> candidates(num_chunks * k);
+      for (int64_t slice = 0; slice < num_slices; slice++) {
+        slice_offsets<3>({&self, &values, &indices}, dim, slice, offsets);
+        const scalar_t* self_data = self.data_ptr<scalar_t>() + offsets[0];
+        const int64_t self_stride = self.stride(dim);
+        at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+          std::vector<elem_t> queue;
+          for (int64_t c = begin; c < end; c++) {
+            const int64_t chunk_begin = n * c / num_chunks;
+            const int64_t chunk_end = n * (c + 1) / num_chunks;
+            queue.resize(chunk_end - chunk_begin);
+            for (int64_t j = chunk_begin; j < chunk_end; j++) {
+              queue[j - chunk_begin] = elem_t(self_data[j * self_stride], j);
+            }
+            select(queue, k, /*sorted=*/false);
+            std::copy(queue.begin(), queue.begin() + k, candidates.begin() + c * k);
+          }
+        });
+        std::vector<elem_t> queue(candidates);
+        select(queue, k, sorted);
+        scalar_t* values_data = values.data_ptr<scalar_t>() + offsets[1];
+        int64_t* indices_data = indices.data_ptr<int64_t>() + offsets[2];
+        const int64_t values_stride = values.stride(dim);
+        const int64_t indices_stride = indices.stride(dim);
+        for (int64_t j = 0; j < k; j++) {
+          values_data[j * values_stride] = queue[j].first;
+          indices_data[j * indices_stride] = queue[j].second;
+        }
+      }
+      return;
+    }
+
     dim_apply(
         {self, values, indices},
         dim,
@@ -27,9 +292,7 @@ static void topk_kernel(
           auto mode_indices = tl[2].accessor<int64_t, 1>();
 
           auto n = tmp_values.size(0);
-          auto use_partial_sort = k * 64 <= n;
 
-          using elem_t = std::pair<scalar_t, int64_t>;
           std::vector<elem_t> queue(n);
           for (int64_t j = 0; j < n; j++) {
             queue[j].first = tmp_values[j];
@@ -37,43 +300,7 @@ static void topk_kernel(
           }
 
           // we want NaN to be sorted as top for numpy compatibility
-          if (use_partial_sort) {
-            if (largest) {
-              std::partial_sort(queue.begin(), queue.begin() + k, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
-                });
-            } else {
-              std::partial_sort(queue.begin(), queue.begin() + k, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
-                });
-            }
-          } else {
-            if (largest) {
-              std::nth_element(queue.begin(), queue.begin() + k - 1, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
-                });
-              if (sorted) {
-                std::sort(queue.begin(), queue.begin() + k - 1,
-                  [](const elem_t& x, const elem_t& y) -> bool {
-                    return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
-                  });
-              }
-            } else {
-              std::nth_element(queue.begin(), queue.begin() + k -1, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
-                });
-              if (sorted) {
-                std::sort(queue.begin(), queue.begin() + k -1,
-                  [](const elem_t& x, const elem_t& y) -> bool {
-                    return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
-                  });
-              }
-            }
-          }
+          select(queue, k, sorted);
 
           for (int64_t j = 0; j < k; j++) {
             mode_values[j] = queue[j].first;
@@ -86,5 +313,6 @@ static void topk_kernel(
 } // anonymous namespace
 
 REGISTER_DISPATCH(topk_stub, &topk_kernel);
+REGISTER_DISPATCH(sort_stub, &sort_kernel);
 
 }} //at::native
@@ -334,11 +334,19 @@ static void log_normal_kernel(TensorIterator& iter, double mean, double std, c10
 
 void uniform_kernel(TensorIterator& iter, double from, double to, c10::optional<Generator> gen) {
   CPUGeneratorImpl* generator = get_generator_or_default<CPUGeneratorImpl>(gen, detail::getDefaultCPUGenerator());
+  if (generator->philox_enabled()) {
+    templates::cpu::uniform_philox_kernel(iter, from, to, generator);
+    return;
+  }
   templates::cpu::uniform_kernel(iter, from, to, generator);
 }
 
 void normal_kernel(Tensor& self, double mean, double std, c10::optional<Generator> gen) {
   CPUGeneratorImpl* generator = get_generator_or_default<CPUGeneratorImpl>(gen, detail::getDefaultCPUGenerator());
+  if (generator->philox_enabled()) {
+    templates::cpu::normal_philox_kernel(self, mean, std, generator);
+    return;
+  }
   templates::cpu::normal_kernel(self, mean, std, generator);
 }
 
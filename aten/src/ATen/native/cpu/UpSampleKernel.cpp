@@ -3,6 +3,7 @@
 #include <ATen/Dispatch.h>
 #include <ATen/native/UpSample.h>
 #include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
 
 namespace at {
 namespace native {
@@ -233,6 +234,92 @@ void cpu_upsample_nearest_channels_last(
   }
 }
 
+// Bilinear upsampling of an NHWC input: every output pixel interpolates the
+// four neighbouring input pixels with the same weights for all channels, so
+// the channels are blended Vec::size() at a time.
+template <typename scalar_t>
+void cpu_upsample_bilinear2d_channels_last(
+    Tensor& output_,
+    const Tensor& input_,
+    bool align_corners,
+    c10::optional<double> scales_h,
+    c10::optional<double> scales_w) {
+  TORCH_CHECK(input_.dtype() == output_.dtype(), "expected dtype ", input_.dtype(),
+              " for `output` but got dtype ", output_.dtype());
+  using Vec = vec256::Vec256<scalar_t>;
+
+  auto input = input_.contiguous(at::MemoryFormat::ChannelsLast);
+  auto output = output_.contiguous(at::MemoryFormat::ChannelsLast);
+
+  const auto* input_data = input.data_ptr<scalar_t>();
+  auto* output_data = output.data_ptr<scalar_t>();
+
+  const int64_t num_batches = input.size(0);
+  const int64_t channels = input.size(1);
+  const int64_t input_height = input.size(2);
+  const int64_t input_width = input.size(3);
+  const int64_t output_height = output.size(2);
+  const int64_t output_width = output.size(3);
+
+  const scalar_t rheight = area_pixel_compute_scale<scalar_t>(
+      input_height, output_height, align_corners, scales_h);
+  const scalar_t rwidth = area_pixel_compute_scale<scalar_t>(
+      input_width, output_width, align_corners, scales_w);
+  const bool same_size = input_height == output_height && input_width == output_width;
+
+  auto loop = [&](int64_t start, int64_t end) {
+    int64_t n = 0;
+    int64_t oh = 0;
+    int64_t ow = 0;
+    data_index_init(start, n, num_batches, oh, output_height, ow, output_width);
+
+    for (int64_t i = start; i < end; i++) {
+      scalar_t* out = output_data + i * channels;
+      if (same_size) {
+        // special case: just copy
+        std::memcpy(out, input_data + i * channels, sizeof(scalar_t) * channels);
+        data_index_step(n, num_batches, oh, output_height, ow, output_width);
+        continue;
+      }
+
+      const scalar_t h1r = area_pixel_compute_source_index<scalar_t>(
+          rheight, oh, align_corners, /*cubic=*/false);
+      const int64_t h1 = h1r;
+      const int64_t h1p = (h1 < input_height - 1) ? 1 : 0;
+      const Vec h1lambda(h1r - h1);
+      const Vec h0lambda(static_cast<scalar_t>(1.) - (h1r - h1));
+
+      const scalar_t w1r = area_pixel_compute_source_index<scalar_t>(
+          rwidth, ow, align_corners, /*cubic=*/false);
+      const int64_t w1 = w1r;
+      const int64_t w1p = (w1 < input_width - 1) ? 1 : 0;
+      const Vec w1lambda(w1r - w1);
+      const Vec w0lambda(static_cast<scalar_t>(1.) - (w1r - w1));
+
+      const scalar_t* in00 = input_data + ((n * input_height + h1) * input_width + w1) * channels;
+      const scalar_t* in01 = in00 + w1p * channels;
+      const scalar_t* in10 = in00 + h1p * input_width * channels;
+      const scalar_t* in11 = in10 + w1p * channels;
+
+      for (int64_t c = 0; c < channels; c += Vec::size()) {
+        const int64_t count = std::min<int64_t>(Vec::size(), channels - c);
+        const Vec top = w0lambda * Vec::loadu(in00 + c, count) + w1lambda * Vec::loadu(in01 + c, count);
+        const Vec bottom = w0lambda * Vec::loadu(in10 + c, count) + w1lambda * Vec::loadu(in11 + c, count);
+        (h0lambda * top + h1lambda * bottom).store(out + c, count);
+      }
+      data_index_step(n, num_batches, oh, output_height, ow, output_width);
+    }
+  };
+
+  const int64_t grain_size = std::max<int64_t>(
+      1, at::internal::GRAIN_SIZE / std::max<int64_t>(channels * 4, 1));
+  at::parallel_for(0, num_batches * output_height * output_width, grain_size, loop);
+
+  if (!output_.is_contiguous(at::MemoryFormat::ChannelsLast)) {
+    output_.copy_(output);
+  }
+}
+
 template <typename scalar_t, typename scale_type>
 void cpu_upsample_nearest_backward(
     Tensor& grad_input_,
@@ -367,6 +454,17 @@ void upsample_nearest3d_kernel_impl(
   }
 }
 
+void upsample_bilinear2d_channels_last_kernel_impl(
+    Tensor& output,
+    const Tensor& input,
+    bool align_corners,
+    c10::optional<double> scales_h,
+    c10::optional<double> scales_w) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "upsample_bilinear2d_channels_last", [&] {
+    cpu_upsample_bilinear2d_channels_last<scalar_t>(output, input, align_corners, scales_h, scales_w);
+  });
+}
+
 void upsample_nearest1d_backward_kernel_impl(
     Tensor& grad_input,
     const Tensor& grad_output,
@@ -406,6 +504,7 @@ REGISTER_DISPATCH(upsample_nearest3d_kernel, &upsample_nearest3d_kernel_impl);
 REGISTER_DISPATCH(upsample_nearest1d_backward_kernel, &upsample_nearest1d_backward_kernel_impl);
 REGISTER_DISPATCH(upsample_nearest2d_backward_kernel, &upsample_nearest2d_backward_kernel_impl);
 REGISTER_DISPATCH(upsample_nearest3d_backward_kernel, &upsample_nearest3d_backward_kernel_impl);
+REGISTER_DISPATCH(upsample_bilinear2d_channels_last_kernel, &upsample_bilinear2d_channels_last_kernel_impl);
 
 } // namespace native
 } // namespace at
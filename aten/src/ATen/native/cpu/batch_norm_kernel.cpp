@@ -100,6 +100,54 @@ void batch_norm_cpu_inference_contiguous_impl(Tensor& output,
   }
 }
 
+/// A fast path for CPU inference when the input is channels last contiguous:
+/// every pixel holds all the channels, so alpha and beta are applied
+/// Vec::size() channels at a time.
+template<typename scalar_t>
+void batch_norm_cpu_inference_channels_last_impl(Tensor& output,
+    const Tensor& input, const Tensor& weight, const Tensor& bias,
+    const Tensor& mean, const Tensor& variance, double eps) {
+
+  using Vec = Vec256<scalar_t>;
+  int64_t n_batch = input.size(0);
+  int64_t n_channel = input.size(1);
+  int64_t image_size = input.numel() / n_batch / n_channel;
+
+  Tensor alpha = at::empty_like(mean, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  Tensor beta = at::empty_like(mean, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  auto alpha_data = alpha.accessor<scalar_t, 1>();
+  auto beta_data = beta.accessor<scalar_t, 1>();
+
+  batch_norm_cpu_inference_collect_linear_and_constant_terms<scalar_t>(
+     alpha_data, beta_data, n_channel, weight, bias, mean, variance, eps);
+
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+  const scalar_t* alpha_ptr = alpha.data_ptr<scalar_t>();
+  const scalar_t* beta_ptr = beta.data_ptr<scalar_t>();
+
+  // Apply the linear terms to the input,
+  // output(n, h, w, c) = input(n, h, w, c) * alpha(c) + beta(c)
+  // No need to use parallel_for as this function is supposed to be
+  // memory-limited.
+  const int64_t loop_size = n_channel - (n_channel % Vec::size());
+  for (int64_t i = 0; i < n_batch * image_size; i++) {
+    int64_t offset = i * n_channel;
+    int64_t d = 0;
+    for (; d < loop_size; d += Vec::size()) {
+      Vec data_vec = Vec::loadu(input_data + offset + d);
+      Vec output_vec = data_vec * Vec::loadu(alpha_ptr + d) + Vec::loadu(beta_ptr + d);
+      output_vec.store(output_data + offset + d);
+    }
+    if (n_channel - d > 0) {
+      Vec data_vec = Vec::loadu(input_data + offset + d, n_channel - d);
+      Vec output_vec = data_vec * Vec::loadu(alpha_ptr + d, n_channel - d) +
+          Vec::loadu(beta_ptr + d, n_channel - d);
+      output_vec.store(output_data + offset + d, n_channel - d);
+    }
+  }
+}
+
 void batch_norm_cpu_inference_contiguous_kernel(Tensor& output, const Tensor& input,
     const Tensor& weight, const Tensor& bias, const Tensor& mean, const Tensor& variance, double eps) {
   AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "batch_norm_cpu_inference_contiguous", [&] {
@@ -107,8 +155,16 @@ void batch_norm_cpu_inference_contiguous_kernel(Tensor& output, const Tensor& in
   });
 }
 
+void batch_norm_cpu_inference_channels_last_kernel(Tensor& output, const Tensor& input,
+    const Tensor& weight, const Tensor& bias, const Tensor& mean, const Tensor& variance, double eps) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "batch_norm_cpu_inference_channels_last", [&] {
+    batch_norm_cpu_inference_channels_last_impl<scalar_t>(output, input, weight, bias, mean, variance, eps);
+  });
+}
+
 }// anonymous namespace
 
 REGISTER_DISPATCH(batch_norm_cpu_inference_contiguous_stub, &batch_norm_cpu_inference_contiguous_kernel);
+REGISTER_DISPATCH(batch_norm_cpu_inference_channels_last_stub, &batch_norm_cpu_inference_channels_last_kernel);
 
 }} // namespace at::native
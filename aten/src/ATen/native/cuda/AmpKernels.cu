@@ -4,8 +4,10 @@
 
 #include <ATen/ATen.h>
 #include <ATen/Dispatch.h>
+#include <ATen/native/ForeachUtils.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cuda/Loops.cuh>
+#include <ATen/native/cuda/MultiTensorApply.cuh>
 
 namespace {
 // Thin wrapper around https://docs.nvidia.com/cuda/cuda-math-api/group__CUDA__MATH__SINGLE.html#group__CUDA__MATH__SINGLE_1g57a3c8313f570282a1a7bcc78743b08e,
@@ -80,6 +82,76 @@ void _amp_non_finite_check_and_unscale_cuda_(Tensor& scaled_grad,
 }
 
 
+namespace {
+
+template <typename scalar_t>
+struct UnscaleFunctor {
+  __device__ void operator()(int64_t chunk_size,
+                             TensorListMetadata<1>& tl,
+                             float* found_inf_ptr,
+                             const float* inv_scale_ptr) {
+    int tensor_loc;
+    int64_t offset, n;
+    chunk_bounds(chunk_size, tl, tensor_loc, offset, n);
+    scalar_t* grad = static_cast<scalar_t*>(tl.addresses[0][tensor_loc]) + offset;
+    const auto inv_scale_val = *inv_scale_ptr;
+    for (int64_t i = threadIdx.x; i < n; i += blockDim.x) {
+      float fval = static_cast<float>(grad[i]);
+      // See isfinite_ensure_cuda_math above.
+      if (!isfinite_ensure_cuda_math(fval)) {
+        *found_inf_ptr = 1.f;
+      }
+      grad[i] = static_cast<scalar_t>(inv_scale_val == 1.f ? fval : fval*inv_scale_val);
+    }
+  }
+};
+
+} // anonymous namespace
+
+
+// _amp_non_finite_check_and_unscale_cuda_ for a list of gradients.  Gradients of the same dtype on the device of
+// found_inf are unscaled by a few multi-tensor kernel launches instead of one launch per gradient.
+//
+// Args:
+// scaled_grads:  A list of (scaled) gradient tensors.  May contain infs or NaNs.
+// found_inf:  As for _amp_non_finite_check_and_unscale_cuda_.
+// inv_scale:  As for _amp_non_finite_check_and_unscale_cuda_.
+void _amp_foreach_non_finite_check_and_unscale_cuda_(TensorList scaled_grads,
+                                                     Tensor& found_inf,
+                                                     const Tensor& inv_scale)
+{
+  if (scaled_grads.size() == 0) {
+    return;
+  }
+
+  TORCH_CHECK(inv_scale.is_cuda(), "inv_scale must be a CUDA tensor.");
+  TORCH_CHECK(found_inf.is_cuda(), "found_inf must be a CUDA tensor.");
+  TORCH_CHECK(inv_scale.numel() == 1, "inv_scale must be a 1-element tensor.");
+  TORCH_CHECK(found_inf.numel() == 1, "found_inf must be a 1-element tensor.");
+  TORCH_CHECK(inv_scale.scalar_type() == at::ScalarType::Float, "inv_scale must be a float tensor.");
+  TORCH_CHECK(found_inf.scalar_type() == at::ScalarType::Float, "found_inf must be a float tensor.");
+
+  if (!can_use_fast_route({scaled_grads}) || scaled_grads[0].device() != found_inf.device() ||
+      inv_scale.device() != found_inf.device()) {
+    for (const auto& t : scaled_grads) {
+      Tensor grad = t;
+      _amp_non_finite_check_and_unscale_cuda_(grad, found_inf, inv_scale);
+    }
+    return;
+  }
+
+  std::vector<std::vector<Tensor>> tensor_lists{scaled_grads.vec()};
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(
+    scaled_grads[0].scalar_type(),
+    "_amp_foreach_non_finite_check_and_unscale_cuda",
+    [&tensor_lists, &found_inf, &inv_scale] {
+      multi_tensor_apply<1>(tensor_lists,
+                            UnscaleFunctor<scalar_t>(),
+                            found_inf.data_ptr<float>(),
+                            inv_scale.data_ptr<float>());
+    });
+}
+
 // amp_update_scale_cuda_kernel is launched with a single thread to compute the new scale.
 // The scale factor is maintained and updated on the GPU to avoid synchronization.
 __global__ void amp_update_scale_cuda_kernel(int* growth_tracker,
@@ -3,6 +3,7 @@
 #include <ATen/Dispatch.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/cuda/PinnedMemoryAllocator.h>
+#include <ATen/cuda/CUDABlas.h>
 #include <ATen/cuda/CUDAApplyUtils.cuh>
 #include <ATen/cuda/detail/IndexUtils.cuh>
 
@@ -528,6 +529,299 @@ void magmaLuSolveBatched<float>(
   auto storage_##name = pin_memory<type>(size); \
   name = static_cast<type*>(storage_##name.data());
 
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ small matrices ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// MAGMA goes through the matrices of a batch with kernels that are tuned for
+// larger ones, which is slow for the large batches of tiny matrices that come
+// up in geometry and filtering. These get instead
+//
+// - up to kRegisterMatrixMaxSize, a thread per matrix that holds it in
+//   registers, with a kernel fully unrolled for every size. This also takes
+//   single matrices, which saves the round trip of MAGMA through the CPU.
+// - up to kCublasBatchedMaxSize, when batched, the batched LU routines of
+//   cuBLAS. Without MAGMA these take the batched matrices of any size.
+
+constexpr int64_t kRegisterMatrixMaxSize = 4;
+constexpr int64_t kCublasBatchedMaxSize = 32;
+constexpr int kRegisterMatrixThreads = 128;
+
+static inline bool use_register_kernels(int64_t n) {
+  return n <= kRegisterMatrixMaxSize;
+}
+
+static inline bool use_cublas_batched(int64_t n) {
+#if defined(__HIP_PLATFORM_HCC__)
+  return false;
+#elif defined(USE_MAGMA)
+  return n <= kCublasBatchedMaxSize;
+#else
+  return true;
+#endif
+}
+
+// Inverts the N x N column major matrices of the batch in place by
+// Gauss-Jordan elimination with partial pivoting. The row swaps are unrolled
+// into selects, so that the matrices are only ever indexed by constants and
+// stay in registers. infos gets the first zero pivot, 1-based, like getrf.
+template <typename scalar_t, int N>
+C10_LAUNCH_BOUNDS_1(kRegisterMatrixThreads)
+__global__ void small_inverse_kernel(scalar_t* self, int* infos, int64_t batch_size) {
+  const int64_t i = blockIdx.x * static_cast<int64_t>(blockDim.x) + threadIdx.x;
+  if (i >= batch_size) {
+    return;
+  }
+  scalar_t* matrix = self + i * N * N;
+  scalar_t a[N][N];
+  scalar_t inv[N][N];
+#pragma unroll
+  for (int c = 0; c < N; c++) {
+#pragma unroll
+    for (int r = 0; r < N; r++) {
+      a[r][c] = matrix[c * N + r];
+      inv[r][c] = r == c ? scalar_t(1) : scalar_t(0);
+    }
+  }
+
+  int info = 0;
+#pragma unroll
+  for (int k = 0; k < N; k++) {
+    int pivot = k;
+    scalar_t pivot_abs = ::fabs(a[k][k]);
+#pragma unroll
+    for (int r = k + 1; r < N; r++) {
+      if (::fabs(a[r][k]) > pivot_abs) {
+        pivot_abs = ::fabs(a[r][k]);
+        pivot = r;
+      }
+    }
+    if (pivot_abs == scalar_t(0)) {
+      info = k + 1;
+      break;
+    }
+#pragma unroll
+    for (int r = k + 1; r < N; r++) {
+      if (r == pivot) {
+#pragma unroll
+        for (int c = 0; c < N; c++) {
+          scalar_t t = a[k][c];
+          a[k][c] = a[r][c];
+          a[r][c] = t;
+          t = inv[k][c];
+          inv[k][c] = inv[r][c];
+          inv[r][c] = t;
+        }
+      }
+    }
+
+    const scalar_t scale = scalar_t(1) / a[k][k];
+#pragma unroll
+    for (int c = 0; c < N; c++) {
+      a[k][c] *= scale;
+      inv[k][c] *= scale;
+    }
+#pragma unroll
+    for (int r = 0; r < N; r++) {
+      if (r != k) {
+        const scalar_t factor = a[r][k];
+#pragma unroll
+        for (int c = 0; c < N; c++) {
+          a[r][c] -= factor * a[k][c];
+          inv[r][c] -= factor * inv[k][c];
+        }
+      }
+    }
+  }
+
+#pragma unroll
+  for (int c = 0; c < N; c++) {
+#pragma unroll
+    for (int r = 0; r < N; r++) {
+      matrix[c * N + r] = inv[r][c];
+    }
+  }
+  infos[i] = info;
+}
+
+// The lower Cholesky factors of the N x N column major matrices of the batch,
+// in place, leaving their upper triangles as they are. infos gets the order
+// of the first minor that is not positive definite, like potrf.
+template <typename scalar_t, int N>
+C10_LAUNCH_BOUNDS_1(kRegisterMatrixThreads)
+__global__ void small_cholesky_kernel(scalar_t* self, int* infos, int64_t batch_size) {
+  const int64_t i = blockIdx.x * static_cast<int64_t>(blockDim.x) + threadIdx.x;
+  if (i >= batch_size) {
+    return;
+  }
+  scalar_t* matrix = self + i * N * N;
+  scalar_t a[N][N];
+#pragma unroll
+  for (int c = 0; c < N; c++) {
+#pragma unroll
+    for (int r = c; r < N; r++) {
+      a[r][c] = matrix[c * N + r];
+    }
+  }
+
+  int info = 0;
+#pragma unroll
+  for (int j = 0; j < N; j++) {
+    scalar_t diagonal = a[j][j];
+#pragma unroll
+    for (int k = 0; k < j; k++) {
+      diagonal -= a[j][k] * a[j][k];
+    }
+    // Also catches NaN
+    if (!(diagonal > scalar_t(0))) {
+      info = j + 1;
+      break;
+    }
+    diagonal = ::sqrt(diagonal);
+    a[j][j] = diagonal;
+#pragma unroll
+    for (int r = j + 1; r < N; r++) {
+      scalar_t value = a[r][j];
+#pragma unroll
+      for (int k = 0; k < j; k++) {
+        value -= a[r][k] * a[j][k];
+      }
+      a[r][j] = value / diagonal;
+    }
+  }
+
+#pragma unroll
+  for (int c = 0; c < N; c++) {
+#pragma unroll
+    for (int r = c; r < N; r++) {
+      matrix[c * N + r] = a[r][c];
+    }
+  }
+  infos[i] = info;
+}
+
+// The launchers of the register kernels, by size, for apply_small_matrix_kernel
+#define SMALL_MATRIX_KERNEL_LAUNCHER(kernel)                                   \
+  template <typename scalar_t, int N>                                          \
+  struct kernel##_launcher {                                                   \
+    static void launch(scalar_t* self, int* infos, int64_t batch_size) {       \
+      const int64_t blocks =                                                   \
+          (batch_size + kRegisterMatrixThreads - 1) / kRegisterMatrixThreads;  \
+      kernel<scalar_t, N>                                                      \
+          <<<blocks, kRegisterMatrixThreads, 0, at::cuda::getCurrentCUDAStream()>>>( \
+              self, infos, batch_size);                                        \
+      AT_CUDA_CHECK(cudaGetLastError());                                       \
+    }                                                                          \
+  };
+
+SMALL_MATRIX_KERNEL_LAUNCHER(small_inverse_kernel)
+SMALL_MATRIX_KERNEL_LAUNCHER(small_cholesky_kernel)
+
+#undef SMALL_MATRIX_KERNEL_LAUNCHER
+
+// Runs the register kernel for the size of the matrices of self, which must be
+// at most kRegisterMatrixMaxSize and in column major order, over the batch.
+template <typename scalar_t, template <typename, int> class Launcher>
+static void apply_small_matrix_kernel(Tensor& self, Tensor& infos) {
+  const int64_t batch_size = batchCount(self);
+  if (batch_size == 0) {
+    return;
+  }
+  auto self_data = self.data_ptr<scalar_t>();
+  auto infos_data = infos.data_ptr<int>();
+  switch (self.size(-1)) {
+    case 1:
+      Launcher<scalar_t, 1>::launch(self_data, infos_data, batch_size);
+      break;
+    case 2:
+      Launcher<scalar_t, 2>::launch(self_data, infos_data, batch_size);
+      break;
+    case 3:
+      Launcher<scalar_t, 3>::launch(self_data, infos_data, batch_size);
+      break;
+    case 4:
+      Launcher<scalar_t, 4>::launch(self_data, infos_data, batch_size);
+      break;
+    default:
+      TORCH_INTERNAL_ASSERT(false, "no register kernel for matrices of size ", self.size(-1));
+  }
+}
+
+#ifndef __HIP_PLATFORM_HCC__
+// The device array of pointers to the matrices of a batch, which the batched
+// routines of cuBLAS take, made on the device
+template <typename scalar_t>
+static Tensor batch_pointers(Tensor& batch) {
+  static_assert(sizeof(scalar_t*) == sizeof(int64_t), "pointers are expected to be 64 bits");
+  auto base = reinterpret_cast<int64_t>(batch.data_ptr<scalar_t>());
+  return at::arange(batchCount(batch), batch.options().dtype(at::kLong))
+      .mul_(matrixStride(batch) * static_cast<int64_t>(sizeof(scalar_t)))
+      .add_(base);
+}
+
+template <typename scalar_t>
+static scalar_t** pointers_data(Tensor& pointers) {
+  return reinterpret_cast<scalar_t**>(pointers.data_ptr<int64_t>());
+}
+
+// The LU factorization of the square matrices of self, in place, with pivots
+// of size (*, n) if get_pivots, and infos of the size of the batch
+template <typename scalar_t>
+static void apply_batched_lu_cublas(Tensor& self, Tensor& pivots, Tensor& infos, bool get_pivots) {
+  const int64_t batch_size = batchCount(self);
+  if (batch_size == 0) {
+    return;
+  }
+  const int64_t n = self.size(-1);
+  auto self_array = batch_pointers<scalar_t>(self);
+  at::cuda::blas::getrfBatched<scalar_t>(
+      n, pointers_data<scalar_t>(self_array), std::max<int64_t>(1, n),
+      get_pivots ? pivots.data_ptr<int>() : nullptr, infos.data_ptr<int>(), batch_size);
+}
+
+template <typename scalar_t>
+static void apply_batched_inverse_cublas(Tensor& self, Tensor& self_inv, Tensor& infos) {
+  const int64_t batch_size = batchCount(self);
+  if (batch_size == 0) {
+    return;
+  }
+  const int64_t n = self.size(-1);
+  const int64_t lda = std::max<int64_t>(1, n);
+  auto self_array = batch_pointers<scalar_t>(self);
+  auto self_inv_array = batch_pointers<scalar_t>(self_inv);
+  auto pivots = at::empty({batch_size, n}, self.options().dtype(at::kInt));
+  at::cuda::blas::getrfBatched<scalar_t>(
+      n, pointers_data<scalar_t>(self_array), lda, pivots.data_ptr<int>(),
+      infos.data_ptr<int>(), batch_size);
+  // getri flags the same zero pivots of U as getrf, so that its infos can
+  // take the place of those of getrf
+  at::cuda::blas::getriBatched<scalar_t>(
+      n, pointers_data<scalar_t>(self_array), lda, pivots.data_ptr<int>(),
+      pointers_data<scalar_t>(self_inv_array), lda, infos.data_ptr<int>(), batch_size);
+}
+
+// Solves A X = b in place of b, leaving the LU factorization of A in A
+template <typename scalar_t>
+static void apply_batched_solve_cublas(Tensor& b, Tensor& A, Tensor& infos) {
+  const int64_t batch_size = batchCount(A);
+  if (batch_size == 0) {
+    return;
+  }
+  const int64_t n = A.size(-2);
+  const int64_t nrhs = b.size(-1);
+  const int64_t lda = std::max<int64_t>(1, n);
+  auto A_array = batch_pointers<scalar_t>(A);
+  auto b_array = batch_pointers<scalar_t>(b);
+  auto pivots = at::empty({batch_size, n}, A.options().dtype(at::kInt));
+  at::cuda::blas::getrfBatched<scalar_t>(
+      n, pointers_data<scalar_t>(A_array), lda, pivots.data_ptr<int>(),
+      infos.data_ptr<int>(), batch_size);
+  int info = 0;
+  at::cuda::blas::getrsBatched<scalar_t>(
+      'n', n, nrhs, pointers_data<scalar_t>(A_array), lda, pivots.data_ptr<int>(),
+      pointers_data<scalar_t>(b_array), lda, &info, batch_size);
+  TORCH_CHECK(info == 0, "solve_cuda: Argument ", -info, " has illegal value");
+}
+#endif
+
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ solve ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
 template <typename scalar_t>
@@ -607,6 +901,16 @@ AT_ERROR("solve: MAGMA library not found in "
 std::tuple<Tensor, Tensor> _solve_helper_cuda(const Tensor& self, const Tensor& A) {
   auto self_working_copy = cloneBatchedColumnMajor(self);
   auto A_working_copy = cloneBatchedColumnMajor(A);
+#ifndef __HIP_PLATFORM_HCC__
+  if (self.dim() > 2 && use_cublas_batched(A.size(-1))) {
+    auto infos = at::zeros({batchCount(self)}, self.options().dtype(at::kInt));
+    AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "solve_cuda", [&]{
+      apply_batched_solve_cublas<scalar_t>(self_working_copy, A_working_copy, infos);
+    });
+    batchCheckErrors(infos, "solve_cuda");
+    return std::tuple<Tensor, Tensor>(self_working_copy, A_working_copy);
+  }
+#endif
   std::vector<int64_t> infos(batchCount(self), 0);
   AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "solve_cuda", [&]{
     apply_solve<scalar_t>(self_working_copy, A_working_copy, infos);
@@ -715,6 +1019,31 @@ AT_ERROR("inverse: MAGMA library not found in "
 
 Tensor _inverse_helper_cuda(const Tensor& self) {
   auto self_inv_working_copy = cloneBatchedColumnMajor(self);
+  if (use_register_kernels(self.size(-1))) {
+    auto infos = at::zeros({batchCount(self)}, self.options().dtype(at::kInt));
+    AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "inverse_cuda", [&]{
+      apply_small_matrix_kernel<scalar_t, small_inverse_kernel_launcher>(
+        self_inv_working_copy, infos);
+    });
+    if (self.dim() > 2) {
+      batchCheckErrors(infos, "inverse_cuda");
+    } else {
+      singleCheckErrors(infos.item<int64_t>(), "inverse_cuda");
+    }
+    return self_inv_working_copy;
+  }
+#ifndef __HIP_PLATFORM_HCC__
+  if (self.dim() > 2 && use_cublas_batched(self.size(-1))) {
+    auto infos = at::zeros({batchCount(self)}, self.options().dtype(at::kInt));
+    auto self_working_copy = cloneBatchedColumnMajor(self);
+    AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "inverse_cuda", [&]{
+      apply_batched_inverse_cublas<scalar_t>(
+        self_working_copy, self_inv_working_copy, infos);
+    });
+    batchCheckErrors(infos, "inverse_cuda");
+    return self_inv_working_copy;
+  }
+#endif
   if (self.dim() > 2) {
     std::vector<int64_t> infos(batchCount(self), 0);
     auto self_working_copy = cloneBatchedColumnMajor(self);
@@ -886,6 +1215,20 @@ Tensor _cholesky_helper_cuda(const Tensor& self, bool upper) {
     self_working_copy = cloneBatchedColumnMajor(self);
   }
 
+  if (use_register_kernels(self.size(-1))) {
+    auto infos_tensor = at::zeros({batchCount(self)}, self.options().dtype(at::kInt));
+    AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "cholesky_cuda", [&]{
+      apply_small_matrix_kernel<scalar_t, small_cholesky_kernel_launcher>(
+        self_working_copy, infos_tensor);
+    });
+    if (self.dim() > 2) {
+      batchCheckErrors(infos_tensor, "cholesky_cuda");
+    } else {
+      singleCheckErrors(infos_tensor.item<int64_t>(), "cholesky_cuda");
+    }
+    return upper ? self_working_copy.transpose(-1, -2) : self_working_copy;
+  }
+
   AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "cholesky_cuda", [&]{
     apply_cholesky<scalar_t>(self_working_copy, false, infos);
   });
@@ -984,9 +1327,18 @@ std::tuple<Tensor, Tensor, Tensor> _lu_with_info_cuda(const Tensor& self, bool p
     self_working_copy = at::empty_like(self, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
   } else {
     self_working_copy = cloneBatchedColumnMajor(self);
-    AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "lu_cuda", [&]{
-        apply_lu<scalar_t>(self_working_copy, pivots_tensor, infos_tensor, pivot);
-    });
+#ifndef __HIP_PLATFORM_HCC__
+    if (self.dim() > 2 && m == n && use_cublas_batched(n)) {
+      AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "lu_cuda", [&]{
+          apply_batched_lu_cublas<scalar_t>(self_working_copy, pivots_tensor, infos_tensor, pivot);
+      });
+    } else
+#endif
+    {
+      AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "lu_cuda", [&]{
+          apply_lu<scalar_t>(self_working_copy, pivots_tensor, infos_tensor, pivot);
+      });
+    }
   }
   if (check_errors) {
     if (self.dim() == 2) {
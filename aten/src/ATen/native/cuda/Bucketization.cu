@@ -66,6 +66,36 @@ __global__ void searchsorted_cuda_kernel(
   }
 }
 
+// 1d boundaries are read by every thread, they are cached in shared memory
+// when they fit in SEARCHSORTED_MAX_SHARED_BOUNDARIES_BYTES
+constexpr int64_t SEARCHSORTED_MAX_SHARED_BOUNDARIES_BYTES = 16 * 1024;
+
+template<typename input_t, typename output_t>
+__global__ void searchsorted_cuda_shared_kernel(
+  output_t *data_out,
+  const input_t *data_in,
+  const input_t *data_bd,
+  int64_t idim_bd,
+  int64_t numel_in,
+  bool right) {
+
+  extern __shared__ unsigned char smem[];
+  input_t *shared_bd = reinterpret_cast<input_t*>(smem);
+  for (int64_t i = threadIdx.x; i < idim_bd; i += blockDim.x) {
+    shared_bd[i] = data_bd[i];
+  }
+  __syncthreads();
+
+  for (int64_t tid = blockIdx.x * blockDim.x + threadIdx.x; tid < numel_in; tid += blockDim.x * gridDim.x) {
+    int64_t pos = !right ?
+      lower_bound<input_t>(shared_bd, 0, idim_bd, data_in[tid]) :
+      upper_bound<input_t>(shared_bd, 0, idim_bd, data_in[tid]);
+
+    // type conversion might happen here
+    data_out[tid] = pos;
+  }
+}
+
 template<typename input_t, typename output_t>
 void searchsorted_cuda_contiguous(Tensor& result, const Tensor& input, const Tensor& boundaries, const bool& right) {
   int64_t numel_in = input.numel();
@@ -84,6 +114,14 @@ void searchsorted_cuda_contiguous(Tensor& result, const Tensor& input, const Ten
   dim3 grid  = dim3(std::min(maxGrid, cuda::ATenCeilDiv<int64_t>(numel_in, block.x)));
   at::cuda::CUDAStream stream = at::cuda::getCurrentCUDAStream();
 
+  const int64_t shared_bytes = idim_bd * sizeof(input_t);
+  if (boundaries.dim() == 1 && shared_bytes <= SEARCHSORTED_MAX_SHARED_BOUNDARIES_BYTES) {
+    searchsorted_cuda_shared_kernel<<<grid, block, shared_bytes, stream>>>(
+      data_out, data_in, data_bd, idim_bd, numel_in, right);
+    THCudaCheck(cudaGetLastError());
+    return;
+  }
+
   searchsorted_cuda_kernel<<<grid, block, 0, stream>>>(
     data_out, data_in, data_bd, idim_in, idim_bd, numel_in, right, boundaries.dim() == 1);
   THCudaCheck(cudaGetLastError());
@@ -182,6 +182,14 @@ __global__ void unrolled_elementwise_kernel(int N, func_t f, array_t data, inp_c
   elementwise_kernel_helper(f, memory::policies::unroll<array_t, inp_calc_t, out_calc_t>(data, remaining, ic, oc));
 }
 
+template<int vec_size, bool dynamic_casting, typename func_t, typename array_t, typename offset_calc_t, typename meta_t>
+C10_LAUNCH_BOUNDS_1(num_threads)
+__global__ void vectorized_strided_elementwise_kernel(int N, func_t f, array_t data, offset_calc_t oc, meta_t meta) {
+  int remaining = N - block_work_size * blockIdx.x;
+  using policy_t = memory::policies::vectorized_strided<vec_size, array_t, offset_calc_t, meta_t, dynamic_casting>;
+  elementwise_kernel_helper(f, policy_t(data, remaining, oc, meta));
+}
+
 // this function assume trivial 1d and no dynamic casting
 template<typename func_t, typename array_t>
 static inline void launch_vectorized_kernel(int64_t N, const func_t& f, array_t data) {
@@ -218,13 +226,59 @@ static inline void launch_unrolled_kernel(int64_t N, const func_t& f, array_t da
   AT_CUDA_CHECK(cudaGetLastError());
 }
 
+template<int vec_size, bool dynamic_casting, typename func_t, typename array_t, typename offset_calc_t, typename meta_t>
+static inline void launch_vectorized_strided_kernel(int64_t N, const func_t& f, array_t data, offset_calc_t oc, meta_t meta) {
+  TORCH_INTERNAL_ASSERT(N > 0 && N <= std::numeric_limits<int32_t>::max());
+  int64_t grid = (N + block_work_size - 1) / block_work_size;
+  auto stream = at::cuda::getCurrentCUDAStream();
+  vectorized_strided_elementwise_kernel<vec_size, dynamic_casting, func_t, array_t><<<grid, num_threads, 0, stream>>>(N, f, data, oc, meta);
+  AT_CUDA_CHECK(cudaGetLastError());
+}
+
+// Fills the dtypes and element sizes of `meta` and returns whether the operands
+// of `iter` satisfy the assumptions of memory::policies::vectorized_strided for
+// `vec_size`, marking in `meta` the inputs broadcast along the innermost
+// dimension.
+template<int ntensors>
+static inline bool can_vectorize_strided(const TensorIterator& iter, int vec_size, memory::vectorized_strided_meta<ntensors>& meta) {
+  meta.broadcast_mask = 0;
+  for (int i = 0; i < ntensors; i++) {
+    meta.dtypes[i] = iter.dtype(i);
+    meta.element_sizes[i] = iter.element_size(i);
+  }
+  if (vec_size == 1) {
+    return true;
+  }
+  if (iter.ndim() == 0 || iter.shape()[0] % vec_size != 0) {
+    return false;
+  }
+  for (int i = 0; i < ntensors; i++) {
+    const int64_t element_size = iter.element_size(i);
+    const auto strides = iter.strides(i);
+    if (i > 0 && strides[0] == 0) {
+      meta.broadcast_mask |= 1u << i;
+      continue;
+    }
+    const int64_t alignment = element_size * vec_size;
+    if (strides[0] != element_size ||
+        reinterpret_cast<uintptr_t>(iter.data_ptr(i)) % alignment != 0) {
+      return false;
+    }
+    for (int dim = 1; dim < iter.ndim(); dim++) {
+      if (strides[dim] % alignment != 0) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 } // namespace modern
 
 
 template <typename func_t>
 void gpu_kernel_impl(TensorIterator& iter, const func_t& f) {
   using traits = function_traits<func_t>;
-  using arg0_t = typename traits::result_type;
   constexpr int ntensors = traits::arity + 1;
 
   TORCH_INTERNAL_ASSERT(iter.can_use_32bit_indexing());
@@ -245,54 +299,29 @@ void gpu_kernel_impl(TensorIterator& iter, const func_t& f) {
     return;
   }
 
+  // Strided operands and dynamic casting go through the vectorized strided
+  // policy whenever the innermost dimension allows vectors of 4 elements. Other
+  // strides fall back to the unrolled kernel, or, with dynamic casting, to the
+  // same policy with a single element per vector.
+  auto offset_calc = ::make_offset_calculator<ntensors>(iter);
+  memory::vectorized_strided_meta<ntensors> meta;
+  bool vectorize = modern::can_vectorize_strided(iter, 4, meta);
+
   if (!dynamic_casting) {
-    // !contiguous
+    if (vectorize) {
+      modern::launch_vectorized_strided_kernel<4, false>(numel, f, data, offset_calc, meta);
+      return;
+    }
     auto input_offset_calculator = make_input_offset_calculator<traits::arity>(iter);
     auto output_offset_calculator = make_output_offset_calculator(iter);
     modern::launch_unrolled_kernel(numel, f, data, input_offset_calculator, output_offset_calculator);
     return;
   }
 
-  at::detail::Array<ScalarType, ntensors> dtypes;
-  for (int i = 0; i < ntensors; i++) {
-    dtypes[i] = iter.tensor(i).scalar_type();
-  }
-
-  if (iter.is_trivial_1d()) {
-    auto inner_strides = iter.get_inner_strides();
-    at::detail::Array<int, ntensors> strides;
-    for (int i = 0; i < ntensors; i++) {
-      strides[i] = inner_strides[i];
-    }
-
-    if (needs_dynamic_casting<func_t>::check(iter)) {
-      legacy::launch_kernel<launch_size_1d, 1>(numel, [=]GPU_LAMBDA(int idx) {
-        void* out = data[0] + strides[0] * idx;
-        arg0_t result = legacy::invoke(f, &data.data[1], &strides.data[1], &dtypes.data[1], idx);
-        c10::cast_and_store<arg0_t>(dtypes[0], out, result);
-      });
-    } else {
-      legacy::launch_kernel<launch_size_1d, 1>(numel, [=]GPU_LAMBDA(int idx) {
-        arg0_t* out = (arg0_t*)(data[0] + strides[0] * idx);
-        *out = legacy::invoke(f, &data.data[1], &strides.data[1], idx);
-      });
-    }
+  if (vectorize) {
+    modern::launch_vectorized_strided_kernel<4, true>(numel, f, data, offset_calc, meta);
   } else {
-    auto offset_calc = ::make_offset_calculator<traits::arity + 1>(iter);
-    if (needs_dynamic_casting<func_t>::check(iter)) {
-      legacy::launch_kernel<launch_size_nd, launch_bound2>(numel, [=]GPU_LAMBDA(int idx) {
-        auto offsets = offset_calc.get(idx);
-        void* out = data[0] + offsets[0];
-        arg0_t result = legacy::invoke(f, &data.data[1], &offsets.data[1], &dtypes.data[1], 1);
-        c10::cast_and_store<arg0_t>(dtypes[0], out, result);
-      });
-    } else {
-      legacy::launch_kernel<launch_size_nd, launch_bound2>(numel, [=]GPU_LAMBDA(int idx) {
-        auto offsets = offset_calc.get(idx);
-        arg0_t* out = (arg0_t*)(data[0] + offsets[0]);
-        *out = legacy::invoke(f, &data.data[1], &offsets.data[1], 1);
-      });
-    }
+    modern::launch_vectorized_strided_kernel<1, true>(numel, f, data, offset_calc, meta);
   }
 }
 
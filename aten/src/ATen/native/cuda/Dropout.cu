@@ -2,6 +2,7 @@
 #include <ATen/AccumulateType.h>
 #include <ATen/cuda/CUDAApplyUtils.cuh>
 #include <ATen/CUDAGeneratorImpl.h>
+#include <ATen/cuda/CUDAGraphsUtils.cuh>
 #include <ATen/cuda/detail/IndexUtils.cuh>
 #include <ATen/cuda/detail/TensorInfo.cuh>
 #include <c10/macros/Macros.h>
@@ -38,7 +39,7 @@ __global__ void
 fused_dropout_kernel_vec(at::cuda::detail::TensorInfo<scalar_t, IndexType> a,
                             at::cuda::detail::TensorInfo<scalar_t, IndexType> b,
                             at::cuda::detail::TensorInfo<uint8_t, IndexType> c,
-                            IndexType totalElements, accscalar_t p, std::pair<uint64_t, uint64_t> seeds
+                            IndexType totalElements, accscalar_t p, PhiloxCudaState philox_args
                            ) {
 
   // make sure we don't break assumption that we can't have > 4 elements / thread
@@ -50,10 +51,11 @@ fused_dropout_kernel_vec(at::cuda::detail::TensorInfo<scalar_t, IndexType> a,
   accscalar_t pinv = accscalar_t(1)/p;
   IndexType idx = blockIdx.x * blockDim.x + threadIdx.x;
   curandStatePhilox4_32_10_t state;
+  auto seeds = at::cuda::philox::unpack(philox_args);
   curand_init(
-      seeds.first,
+      std::get<0>(seeds),
       idx,
-      seeds.second,
+      std::get<1>(seeds),
       &state);
 
   // Note: Vectorized loads means we'll stride each thread by an additional VEC factor, as we'll load VEC elements at a time
@@ -112,16 +114,17 @@ __global__ void
 fused_dropout_kernel(cuda::detail::TensorInfo<scalar_t, IndexType> a,
                       cuda::detail::TensorInfo<scalar_t, IndexType> b,
                       cuda::detail::TensorInfo<uint8_t, IndexType> c,
-                      IndexType totalElements, accscalar_t p, std::pair<uint64_t, uint64_t> seeds
+                      IndexType totalElements, accscalar_t p, PhiloxCudaState philox_args
                       ) {
 
   accscalar_t pinv = accscalar_t(1)/p;
   IndexType idx = blockIdx.x * blockDim.x + threadIdx.x;
   curandStatePhilox4_32_10_t state;
+    auto seeds = at::cuda::philox::unpack(philox_args);
     curand_init(
-        seeds.first,
+        std::get<0>(seeds),
         idx,
-        seeds.second,
+        std::get<1>(seeds),
         &state);
   IndexType rounded_size = ((totalElements - 1)/(blockDim.x * gridDim.x * UNROLL)+1) *
         blockDim.x * gridDim.x * UNROLL;
@@ -158,6 +161,67 @@ fused_dropout_kernel(cuda::detail::TensorInfo<scalar_t, IndexType> a,
   }
 }
 
+// See Note [Bit-packed dropout masks]
+template <
+          typename scalar_t,
+          typename accscalar_t,
+          typename IndexType>
+#if __CUDA_ARCH__ >= 350
+C10_LAUNCH_BOUNDS_2(256, 8)
+#elif defined (__HIP_PLATFORM_HCC__)
+C10_LAUNCH_BOUNDS_2(256, 4)
+#endif
+__global__ void
+fused_dropout_packed_kernel(const scalar_t* a, scalar_t* b, uint8_t* c,
+                            IndexType totalElements, accscalar_t p, PhiloxCudaState philox_args
+                            ) {
+  accscalar_t pinv = accscalar_t(1)/p;
+  IndexType idx = blockIdx.x * blockDim.x + threadIdx.x;
+  curandStatePhilox4_32_10_t state;
+  auto seeds = at::cuda::philox::unpack(philox_args);
+  curand_init(
+      std::get<0>(seeds),
+      idx,
+      std::get<1>(seeds),
+      &state);
+  IndexType totalBytes = (totalElements + 7) / 8;
+  // Every thread handles 8 consecutive elements at a time, so that it writes
+  // whole bytes of the mask.
+  for (IndexType byteIndex = idx;
+       byteIndex < totalBytes;
+       byteIndex += gridDim.x * blockDim.x) {
+    float4 rand[2];
+    rand[0] = curand_uniform4(&state);
+    rand[1] = curand_uniform4(&state);
+    uint8_t bits = 0;
+    #pragma unroll
+    for (int ii = 0; ii < 8; ii++) {
+      IndexType li = byteIndex * 8 + ii;
+      if (li < totalElements) {
+        bool keep = (&rand[ii / 4].x)[ii % 4] < p;
+        b[li] = static_cast<accscalar_t>(a[li]) * keep * pinv;
+        bits |= static_cast<uint8_t>(keep) << ii;
+      }
+    }
+    c[byteIndex] = bits;
+  }
+}
+
+template <
+          typename scalar_t,
+          typename accscalar_t,
+          typename IndexType>
+__global__ void
+masked_scale_packed_kernel(const scalar_t* src, const uint8_t* mask, scalar_t* ret,
+                           IndexType totalElements, accscalar_t scale) {
+  for (IndexType li = blockIdx.x * blockDim.x + threadIdx.x;
+       li < totalElements;
+       li += gridDim.x * blockDim.x) {
+    accscalar_t keep = (mask[li / 8] >> (li % 8)) & 1;
+    ret[li] = keep * static_cast<accscalar_t>(src[li]) * scale;
+  }
+}
+
 template<typename scalar_t, typename accscalar_t>
 void masked_scale_kernel(at::Tensor& ret, const at::Tensor src, const at::Tensor mask, accscalar_t scale){
    auto iter = at::TensorIterator();
@@ -212,11 +276,11 @@ fused_dropout_cuda(const Tensor& self, double p, c10::optional<Generator> gen_){
   grid.x = std::min((unsigned int)at::cuda::getCurrentDeviceProperties()->multiProcessorCount * blocks_per_sm, grid.x);
 //number of times random will be generated per thread, to offset philox counter in thc random state
   int64_t counter_offset = ((nelem - 1)/(block_size*grid.x*UNROLL)+1)*UNROLL;
-  std::pair<uint64_t, uint64_t> rng_engine_inputs;
+  PhiloxCudaState rng_engine_inputs;
   {
     // See Note [Acquire lock when using random generators]
     std::lock_guard<std::mutex> lock(gen->mutex_);
-    rng_engine_inputs = gen->philox_engine_inputs(counter_offset);
+    rng_engine_inputs = gen->philox_cuda_state(counter_offset);
   }
   if (cuda::detail::canUse32BitIndexMath(self)){
   AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16, self.scalar_type(), "fused_dropout", [&] {
@@ -304,5 +368,76 @@ Tensor masked_scale_cuda(const Tensor& self, const Tensor& mask, double scale){
   return ret;
 }
 
+std::tuple<Tensor,Tensor>
+fused_dropout_packed_cuda(const Tensor& self, double p, c10::optional<Generator> gen_){
+  auto gen = get_generator_or_default<CUDAGeneratorImpl>(gen_, cuda::detail::getDefaultCUDAGenerator());
+  Tensor input = self.contiguous();
+  Tensor ret = at::empty_like(input, MemoryFormat::Contiguous);
+  const int64_t nelem = input.numel();
+  const int64_t nbytes = (nelem + 7) / 8;
+  Tensor mask = at::empty({nbytes}, self.options().dtype(kByte));
+  if (nelem==0) return std::tuple<Tensor,Tensor>(ret, mask);
+  const int64_t block_size = 256;
+  unsigned int blocks_per_sm = at::cuda::getCurrentDeviceProperties()->maxThreadsPerMultiProcessor/block_size;
+  dim3 dim_block(block_size);
+  dim3 grid((nbytes + block_size -1)/block_size);
+  grid.x = std::min((unsigned int)at::cuda::getCurrentDeviceProperties()->multiProcessorCount * blocks_per_sm, grid.x);
+  //every thread generates 8 randoms per mask byte it writes
+  int64_t counter_offset = ((nbytes - 1)/(block_size*grid.x)+1)*8;
+  PhiloxCudaState rng_engine_inputs;
+  {
+    // See Note [Acquire lock when using random generators]
+    std::lock_guard<std::mutex> lock(gen->mutex_);
+    rng_engine_inputs = gen->philox_cuda_state(counter_offset);
+  }
+  AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16, input.scalar_type(), "fused_dropout_packed", [&] {
+    AT_SKIP_BFLOAT16_IF_NOT_ROCM(scalar_t, "fused_dropout_packed", [&] {
+      using accscalar_t = acc_type<scalar_t, true>;
+      accscalar_t pa = (accscalar_t)(p);
+      if (cuda::detail::canUse32BitIndexMath(input)) {
+        fused_dropout_packed_kernel<scalar_t, accscalar_t, unsigned int><<<grid, dim_block, 0, at::cuda::getCurrentCUDAStream()>>>(
+            input.data_ptr<scalar_t>(), ret.data_ptr<scalar_t>(), mask.data_ptr<uint8_t>(), nelem, pa, rng_engine_inputs);
+      } else {
+        fused_dropout_packed_kernel<scalar_t, accscalar_t, uint64_t><<<grid, dim_block, 0, at::cuda::getCurrentCUDAStream()>>>(
+            input.data_ptr<scalar_t>(), ret.data_ptr<scalar_t>(), mask.data_ptr<uint8_t>(), nelem, pa, rng_engine_inputs);
+      }
+    });
+  });
+  AT_CUDA_CHECK(cudaGetLastError());
+  return std::tuple<Tensor,Tensor>(ret, mask);
+}
+
+Tensor masked_scale_packed_cuda(const Tensor& self, const Tensor& mask, double scale){
+  TORCH_CHECK(mask.scalar_type() == at::ScalarType::Byte, "mask should be torch.uint8 dtype");
+  TORCH_CHECK(mask.dim() == 1 && mask.numel() == (self.numel() + 7) / 8,
+      "Expected a packed mask of ", (self.numel() + 7) / 8, " bytes for ", self.numel(),
+      " elements, but got a mask of size ", mask.sizes());
+  Tensor input = self.contiguous();
+  Tensor packed = mask.contiguous();
+  Tensor ret = at::empty_like(input, MemoryFormat::Contiguous);
+  const int64_t nelem = input.numel();
+  if (nelem==0) return ret;
+  const int64_t block_size = 256;
+  unsigned int blocks_per_sm = at::cuda::getCurrentDeviceProperties()->maxThreadsPerMultiProcessor/block_size;
+  dim3 dim_block(block_size);
+  dim3 grid((nelem + block_size -1)/block_size);
+  grid.x = std::min((unsigned int)at::cuda::getCurrentDeviceProperties()->multiProcessorCount * blocks_per_sm, grid.x);
+  AT_DISPATCH_FLOATING_TYPES_AND2(at::ScalarType::Half, at::ScalarType::BFloat16, ret.scalar_type(), "masked_scale_packed", [&] {
+    AT_SKIP_BFLOAT16_IF_NOT_ROCM(scalar_t, "masked_scale_packed", [&] {
+      using accscalar_t = acc_type<scalar_t, true>;
+      accscalar_t pa = (accscalar_t)(scale);
+      if (cuda::detail::canUse32BitIndexMath(input)) {
+        masked_scale_packed_kernel<scalar_t, accscalar_t, unsigned int><<<grid, dim_block, 0, at::cuda::getCurrentCUDAStream()>>>(
+            input.data_ptr<scalar_t>(), packed.data_ptr<uint8_t>(), ret.data_ptr<scalar_t>(), nelem, pa);
+      } else {
+        masked_scale_packed_kernel<scalar_t, accscalar_t, uint64_t><<<grid, dim_block, 0, at::cuda::getCurrentCUDAStream()>>>(
+            input.data_ptr<scalar_t>(), packed.data_ptr<uint8_t>(), ret.data_ptr<scalar_t>(), nelem, pa);
+      }
+    });
+  });
+  AT_CUDA_CHECK(cudaGetLastError());
+  return ret;
+}
+
 }
 }
@@ -5,6 +5,7 @@
 #include <c10/util/Exception.h>
 #include <c10/macros/Macros.h>
 
+#include <THC/THCAtomics.cuh>
 #include <THC/THCDeviceUtils.cuh>
 #include <THC/THCTensorMathReduce.cuh>
 #include <THC/THCTensorSort.cuh>
@@ -27,6 +28,13 @@ static const int BLOCKDIMY = 16;
 static const int BLOCKDIMY = 32;
 #endif
 
+// Without scale_grad_by_freq and deterministic mode, float and double
+// gradients are accumulated with atomic adds instead of sorting the indices
+// when the vocabulary is small, or much larger than the number of indices,
+// in which case few of them are expected to be duplicates.
+constexpr int64_t kEmbeddingAtomicMaxWeights = 4096;
+constexpr int64_t kEmbeddingAtomicWeightsPerIndex = 8;
+
 template
   <typename scalar_t,
    typename accscalar_t>
@@ -178,6 +186,26 @@ __global__ void embedding_backward_kernel(
   }
 }
 
+// Adds every row of grad to its row of grad_weight with atomic adds, without
+// sorting the indices. The order of the additions to a row, and so the
+// rounding of its gradient, depends on the scheduling of the warps.
+template <typename scalar_t>
+__global__ void embedding_backward_atomic_kernel(
+  const int64_t* indices, const scalar_t* grad, scalar_t* grad_weight,
+  int64_t num_indices, int64_t stride, int64_t padding_idx) {
+
+  for (int64_t idx = blockIdx.x * blockDim.y + threadIdx.y; idx < num_indices;
+       idx += gridDim.x * blockDim.y) {
+    const int64_t weight_row = indices[idx];
+    if (weight_row == padding_idx) {
+      continue;
+    }
+    for (int64_t f = threadIdx.x; f < stride; f += blockDim.x) {
+      gpuAtomicAdd(&grad_weight[weight_row * stride + f], grad[idx * stride + f]);
+    }
+  }
+}
+
 /* Calculate norms of the rows of weight_ptr given by idx_ptr and capture them in norms */
 template <typename scalar_t, typename accscalar_t>
 __global__ void renorm_kernel(
@@ -268,30 +296,32 @@ Tensor embedding_dense_backward_cuda(const Tensor & grad_, const Tensor & indice
     return grad_weight;
   }
 
-  auto sorted_indices = at::empty_like(indices, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
-  auto orig_indices = at::empty_like(indices, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
-  using device_ptr = thrust::device_ptr<int64_t>;
-
-  // Sort the inputs into sorted with the corresponding indices; we
-  // don't need a stable or multidimensional sort, so just use Thrust
-  // directly
-  {
-    sorted_indices.copy_(indices);
-
-    auto allocator = THCThrustAllocator(globalContext().lazyInitCUDA());
-    auto policy = thrust::cuda::par(allocator).on(stream);
-
-    // Fill sortedOrigIndices with sequential indices
-    auto count_iter = thrust::counting_iterator<int64_t>(0);
-    auto orig_data = device_ptr(orig_indices.data_ptr<int64_t>());
-    thrust::copy(policy, count_iter, count_iter + num_indices, orig_data);
-
-    // Sort; a stable sort is not required
-    auto sorted_data = device_ptr(sorted_indices.data_ptr<int64_t>());
-    thrust::sort_by_key(policy, sorted_data, sorted_data + num_indices, orig_data,
-                        ThrustLTOp<int64_t>());
+  if (!scale_grad_by_freq && !globalContext().deterministic() &&
+      (grad.scalar_type() == kFloat || grad.scalar_type() == kDouble) &&
+      (num_weights <= kEmbeddingAtomicMaxWeights ||
+       num_weights >= num_indices * kEmbeddingAtomicWeightsPerIndex)) {
+    auto indices_contig = indices.contiguous();
+    auto grad_weight = at::zeros({num_weights, grad_.size(-1)}, grad_.options());
+    int64_t stride = grad_weight.stride(0);
+    constexpr int64_t kRowsPerBlock = 8;
+    dim3 block(C10_WARP_SIZE, kRowsPerBlock);
+    dim3 grid(std::min<int64_t>(THCCeilDiv(num_indices, kRowsPerBlock),
+                                std::numeric_limits<int32_t>::max()));
+    AT_DISPATCH_FLOATING_TYPES(grad.scalar_type(), "embedding_backward", [&] {
+      embedding_backward_atomic_kernel<scalar_t><<<grid, block, 0, stream>>>(
+          indices_contig.data_ptr<int64_t>(),
+          grad.data_ptr<scalar_t>(),
+          grad_weight.data_ptr<scalar_t>(),
+          num_indices, stride, padding_idx);
+    });
+    AT_CUDA_CHECK(cudaGetLastError());
+    return grad_weight;
   }
 
+  Tensor sorted_indices, orig_indices;
+  std::tie(sorted_indices, orig_indices) = embedding_sort_indices(indices);
+  using device_ptr = thrust::device_ptr<int64_t>;
+
   Tensor count;
   if (scale_grad_by_freq) {
     count = at::empty_like(indices, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
@@ -12,10 +12,13 @@
 #include <THC/THCAtomics.cuh>
 
 #include <thrust/execution_policy.h>
+#include <thrust/sort.h>
 #include <thrust/unique.h>
 
 #include <c10/macros/Macros.h>
 
+#include <mutex>
+
 namespace at {
 namespace native {
 
@@ -179,6 +182,25 @@ __global__ void sum_and_scatter(
   }
 }
 
+// The last indices sorted by embedding_sort_indices.
+struct SortedIndicesCache {
+  std::mutex mutex;
+  // Keeps the storage of the indices alive, so that a tensor with the same
+  // data pointer, and version, has the same values.
+  Tensor indices;
+  uint32_t version = 0;
+  bool stable = false;
+  c10::optional<at::cuda::CUDAStream> stream;
+  Tensor sorted_indices;
+  Tensor orig_indices;
+};
+
+SortedIndicesCache& sorted_indices_cache() {
+  // Leaked to not free CUDA memory during static destruction.
+  static auto* cache = new SortedIndicesCache();
+  return *cache;
+}
+
 } // anon namespace
 
 Tensor embedding_backward_cuda_kernel(
@@ -323,4 +345,65 @@ Tensor embedding_backward_cuda_kernel(
   return grad_weight;
 }
 
+std::tuple<Tensor, Tensor> embedding_sort_indices(const Tensor &indices) {
+  const bool stable = globalContext().deterministic();
+  const auto stream = at::cuda::getCurrentCUDAStream();
+  const uint32_t version =
+      indices.unsafeGetTensorImpl()->version_counter().current_version();
+  const bool cacheable = indices.is_contiguous();
+  auto& cache = sorted_indices_cache();
+  if (cacheable) {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    if (cache.indices.defined() &&
+        cache.indices.data_ptr() == indices.data_ptr() &&
+        cache.indices.numel() == indices.numel() &&
+        cache.indices.device() == indices.device() &&
+        cache.version == version && cache.stream == stream &&
+        (cache.stable || !stable)) {
+      return std::make_tuple(cache.sorted_indices, cache.orig_indices);
+    }
+  }
+
+  const ptrdiff_t numel = indices.numel();
+  auto sorted_indices = at::empty({numel}, indices.options());
+  auto orig_indices = at::empty({numel}, indices.options());
+  using device_ptr = thrust::device_ptr<int64_t>;
+
+  // Sort the inputs into sorted with the corresponding indices; a
+  // multidimensional sort is not needed, so just use Thrust directly
+  {
+    sorted_indices.copy_(indices.reshape({numel}));
+
+    auto allocator = THCThrustAllocator(globalContext().lazyInitCUDA());
+    auto policy = thrust::cuda::par(allocator).on(stream);
+
+    // Fill sortedOrigIndices with sequential indices
+    auto count_iter = thrust::counting_iterator<int64_t>(0);
+    auto orig_data = device_ptr(orig_indices.data_ptr<int64_t>());
+    thrust::copy(policy, count_iter, count_iter + numel, orig_data);
+
+    // A stable sort keeps the positions of equal indices in order, so that
+    // the gradients of a row are always summed in the same order
+    auto sorted_data = device_ptr(sorted_indices.data_ptr<int64_t>());
+    if (stable) {
+      thrust::stable_sort_by_key(policy, sorted_data, sorted_data + numel,
+                                 orig_data, ThrustLTOp<int64_t>());
+    } else {
+      thrust::sort_by_key(policy, sorted_data, sorted_data + numel, orig_data,
+                          ThrustLTOp<int64_t>());
+    }
+  }
+
+  if (cacheable) {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.indices = indices;
+    cache.version = version;
+    cache.stable = stable;
+    cache.stream = stream;
+    cache.sorted_indices = sorted_indices;
+    cache.orig_indices = orig_indices;
+  }
+  return std::make_tuple(sorted_indices, orig_indices);
+}
+
 }}
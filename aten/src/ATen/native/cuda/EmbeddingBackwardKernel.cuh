@@ -20,6 +20,17 @@
 namespace at {
 namespace native {
 
+// Sorts the (flattened) indices of an embedding backward and returns
+// (sorted_indices, orig_indices), where orig_indices[i] is the position in
+// `indices` of sorted_indices[i]. The sort is stable when
+// at::globalContext().deterministic() is set.
+//
+// The result of the last call is kept together with a reference to
+// `indices`, so that the backward of embedding and embedding_bag calls of the
+// same step that use the same (unmodified) indices sort them only once. The
+// returned tensors must not be modified.
+std::tuple<Tensor, Tensor> embedding_sort_indices(const Tensor &indices);
+
 Tensor embedding_backward_cuda_kernel(
     const Tensor &grad,
     const Tensor &orig_indices,
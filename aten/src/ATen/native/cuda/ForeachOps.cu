@@ -0,0 +1,719 @@
+// The fast route of the _foreach_* ops on CUDA: lists of contiguous tensors
+// of a single floating point dtype on a single device are processed by a few
+// multi-tensor kernel launches (see MultiTensorApply.cuh). Other lists go
+// through the slow route of ForeachOpsKernels.cpp, tensor by tensor.
+
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/ForeachUtils.h>
+#include <ATen/native/cuda/MultiTensorApply.cuh>
+
+namespace at {
+namespace native {
+
+namespace {
+
+// The functors get the chunk of the tensor of their block from the
+// TensorListMetadata. Inputs are read from the first lists and the result is
+// written to the list at res_arg_index, which is an input list for the
+// in-place ops.
+
+template <typename scalar_t, int depth, int res_arg_index>
+struct UnaryOpFunctor {
+  template <typename Op>
+  __device__ void operator()(
+      int64_t chunk_size,
+      TensorListMetadata<depth>& tl,
+      Op op) {
+    int tensor_loc;
+    int64_t offset, n;
+    chunk_bounds(chunk_size, tl, tensor_loc, offset, n);
+    const scalar_t* a = static_cast<scalar_t*>(tl.addresses[0][tensor_loc]) + offset;
+    scalar_t* out = static_cast<scalar_t*>(tl.addresses[res_arg_index][tensor_loc]) + offset;
+    for (int64_t i = threadIdx.x; i < n; i += blockDim.x) {
+      out[i] = static_cast<scalar_t>(op(a[i]));
+    }
+  }
+};
+
+template <typename scalar_t, int depth, int res_arg_index>
+struct BinaryOpFunctor {
+  template <typename Op>
+  __device__ void operator()(
+      int64_t chunk_size,
+      TensorListMetadata<depth>& tl,
+      Op op) {
+    int tensor_loc;
+    int64_t offset, n;
+    chunk_bounds(chunk_size, tl, tensor_loc, offset, n);
+    const scalar_t* a = static_cast<scalar_t*>(tl.addresses[0][tensor_loc]) + offset;
+    const scalar_t* b = static_cast<scalar_t*>(tl.addresses[1][tensor_loc]) + offset;
+    scalar_t* out = static_cast<scalar_t*>(tl.addresses[res_arg_index][tensor_loc]) + offset;
+    for (int64_t i = threadIdx.x; i < n; i += blockDim.x) {
+      out[i] = static_cast<scalar_t>(op(a[i], b[i]));
+    }
+  }
+};
+
+template <typename scalar_t, int depth, int res_arg_index>
+struct TernaryOpFunctor {
+  template <typename Op>
+  __device__ void operator()(
+      int64_t chunk_size,
+      TensorListMetadata<depth>& tl,
+      Op op) {
+    int tensor_loc;
+    int64_t offset, n;
+    chunk_bounds(chunk_size, tl, tensor_loc, offset, n);
+    const scalar_t* a = static_cast<scalar_t*>(tl.addresses[0][tensor_loc]) + offset;
+    const scalar_t* b = static_cast<scalar_t*>(tl.addresses[1][tensor_loc]) + offset;
+    const scalar_t* c = static_cast<scalar_t*>(tl.addresses[2][tensor_loc]) + offset;
+    scalar_t* out = static_cast<scalar_t*>(tl.addresses[res_arg_index][tensor_loc]) + offset;
+    for (int64_t i = threadIdx.x; i < n; i += blockDim.x) {
+      out[i] = static_cast<scalar_t>(op(a[i], b[i], c[i]));
+    }
+  }
+};
+
+// The ops compute in opmath_t, float for half.
+template <typename opmath_t>
+struct AddScalarOp {
+  opmath_t scalar;
+  __device__ opmath_t operator()(opmath_t a) const { return a + scalar; }
+};
+
+template <typename opmath_t>
+struct MulScalarOp {
+  opmath_t scalar;
+  __device__ opmath_t operator()(opmath_t a) const { return a * scalar; }
+};
+
+template <typename opmath_t>
+struct AddOp {
+  opmath_t alpha;
+  __device__ opmath_t operator()(opmath_t a, opmath_t b) const { return a + alpha * b; }
+};
+
+template <typename opmath_t>
+struct MulOp {
+  __device__ opmath_t operator()(opmath_t a, opmath_t b) const { return a * b; }
+};
+
+template <typename opmath_t>
+struct AddcmulOp {
+  opmath_t value;
+  __device__ opmath_t operator()(opmath_t a, opmath_t b, opmath_t c) const { return a + value * b * c; }
+};
+
+template <typename opmath_t>
+struct AddcdivOp {
+  opmath_t value;
+  __device__ opmath_t operator()(opmath_t a, opmath_t b, opmath_t c) const { return a + value * (b / c); }
+};
+
+std::vector<Tensor> empty_like_list(TensorList tensors) {
+  std::vector<Tensor> result;
+  result.reserve(tensors.size());
+  for (const auto& t : tensors) {
+    result.emplace_back(at::empty_like(t, LEGACY_CONTIGUOUS_MEMORY_FORMAT));
+  }
+  return result;
+}
+
+template <template <typename> class Op>
+std::vector<Tensor> foreach_unary_op(TensorList tensors, Scalar scalar) {
+  auto result = empty_like_list(tensors);
+  std::vector<std::vector<Tensor>> tensor_lists{tensors.vec(), result};
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(tensors[0].scalar_type(), "foreach_scalar_op_cuda", [&] {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    multi_tensor_apply<2>(
+        tensor_lists, UnaryOpFunctor<scalar_t, 2, 1>(), Op<opmath_t>{scalar.to<opmath_t>()});
+  });
+  return result;
+}
+
+template <template <typename> class Op>
+void foreach_unary_op_(TensorList self, Scalar scalar) {
+  std::vector<std::vector<Tensor>> tensor_lists{self.vec()};
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(self[0].scalar_type(), "foreach_scalar_op_cuda_", [&] {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    multi_tensor_apply<1>(
+        tensor_lists, UnaryOpFunctor<scalar_t, 1, 0>(), Op<opmath_t>{scalar.to<opmath_t>()});
+  });
+}
+
+} // anonymous namespace
+
+std::vector<Tensor> foreach_tensor_add_scalar_kernel_cuda(TensorList tensors, Scalar scalar) {
+  check_foreach_api_restrictions(tensors);
+  if (!can_use_fast_route({tensors})) {
+    return at::native::foreach_tensor_add_scalar_kernel_slow(tensors, scalar);
+  }
+  return foreach_unary_op<AddScalarOp>(tensors, scalar);
+}
+
+void foreach_tensor_add_scalar_kernel_cuda_(TensorList self, Scalar scalar) {
+  check_foreach_api_restrictions(self);
+  if (!can_use_fast_route({self})) {
+    return at::native::foreach_tensor_add_scalar_kernel_slow_(self, scalar);
+  }
+  foreach_unary_op_<AddScalarOp>(self, scalar);
+}
+
+std::vector<Tensor> foreach_tensor_mul_scalar_kernel_cuda(TensorList tensors, Scalar scalar) {
+  check_foreach_api_restrictions(tensors);
+  if (!can_use_fast_route({tensors})) {
+    return at::native::foreach_tensor_mul_scalar_kernel_slow(tensors, scalar);
+  }
+  return foreach_unary_op<MulScalarOp>(tensors, scalar);
+}
+
+void foreach_tensor_mul_scalar_kernel_cuda_(TensorList self, Scalar scalar) {
+  check_foreach_api_restrictions(self);
+  if (!can_use_fast_route({self})) {
+    return at::native::foreach_tensor_mul_scalar_kernel_slow_(self, scalar);
+  }
+  foreach_unary_op_<MulScalarOp>(self, scalar);
+}
+
+std::vector<Tensor> foreach_tensor_add_list_kernel_cuda(TensorList tensors1, TensorList tensors2, Scalar alpha) {
+  check_foreach_api_restrictions(tensors1, tensors2);
+  if (!can_use_fast_route({tensors1, tensors2})) {
+    return at::native::foreach_tensor_add_list_kernel_slow(tensors1, tensors2, alpha);
+  }
+  auto result = empty_like_list(tensors1);
+  std::vector<std::vector<Tensor>> tensor_lists{tensors1.vec(), tensors2.vec(), result};
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(tensors1[0].scalar_type(), "foreach_add_list_cuda", [&] {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    multi_tensor_apply<3>(
+        tensor_lists, BinaryOpFunctor<scalar_t, 3, 2>(), AddOp<opmath_t>{alpha.to<opmath_t>()});
+  });
+  return result;
+}
+
+void foreach_tensor_add_list_kernel_cuda_(TensorList self, TensorList other, Scalar alpha) {
+  check_foreach_api_restrictions(self, other);
+  if (!can_use_fast_route({self, other})) {
+    return at::native::foreach_tensor_add_list_kernel_slow_(self, other, alpha);
+  }
+  std::vector<std::vector<Tensor>> tensor_lists{self.vec(), other.vec()};
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(self[0].scalar_type(), "foreach_add_list_cuda_", [&] {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    multi_tensor_apply<2>(
+        tensor_lists, BinaryOpFunctor<scalar_t, 2, 0>(), AddOp<opmath_t>{alpha.to<opmath_t>()});
+  });
+}
+
+std::vector<Tensor> foreach_tensor_mul_list_kernel_cuda(TensorList tensors1, TensorList tensors2) {
+  check_foreach_api_restrictions(tensors1, tensors2);
+  if (!can_use_fast_route({tensors1, tensors2})) {
+    return at::native::foreach_tensor_mul_list_kernel_slow(tensors1, tensors2);
+  }
+  auto result = empty_like_list(tensors1);
+  std::vector<std::vector<Tensor>> tensor_lists{tensors1.vec(), tensors2.vec(), result};
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(tensors1[0].scalar_type(), "foreach_mul_list_cuda", [&] {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    multi_tensor_apply<3>(
+        tensor_lists, BinaryOpFunctor<scalar_t, 3, 2>(), MulOp<opmath_t>());
+  });
+  return result;
+}
+
+void foreach_tensor_mul_list_kernel_cuda_(TensorList self, TensorList other) {
+  check_foreach_api_restrictions(self, other);
+  if (!can_use_fast_route({self, other})) {
+    return at::native::foreach_tensor_mul_list_kernel_slow_(self, other);
+  }
+  std::vector<std::vector<Tensor>> tensor_lists{self.vec(), other.vec()};
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(self[0].scalar_type(), "foreach_mul_list_cuda_", [&] {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    multi_tensor_apply<2>(
+        tensor_lists, BinaryOpFunctor<scalar_t, 2, 0>(), MulOp<opmath_t>());
+  });
+}
+
+void foreach_tensor_addcmul_kernel_cuda_(TensorList self, TensorList tensors1, TensorList tensors2, Scalar value) {
+  check_foreach_api_restrictions(self, tensors1, tensors2);
+  if (!can_use_fast_route({self, tensors1, tensors2})) {
+    return at::native::foreach_tensor_addcmul_kernel_slow_(self, tensors1, tensors2, value);
+  }
+  std::vector<std::vector<Tensor>> tensor_lists{self.vec(), tensors1.vec(), tensors2.vec()};
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(self[0].scalar_type(), "foreach_addcmul_cuda_", [&] {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    multi_tensor_apply<3>(
+        tensor_lists, TernaryOpFunctor<scalar_t, 3, 0>(), AddcmulOp<opmath_t>{value.to<opmath_t>()});
+  });
+}
+
+void foreach_tensor_addcdiv_kernel_cuda_(TensorList self, TensorList tensors1, TensorList tensors2, Scalar value) {
+  check_foreach_api_restrictions(self, tensors1, tensors2);
+  if (!can_use_fast_route({self, tensors1, tensors2})) {
+    return at::native::foreach_tensor_addcdiv_kernel_slow_(self, tensors1, tensors2, value);
+  }
+  std::vector<std::vector<Tensor>> tensor_lists{self.vec(), tensors1.vec(), tensors2.vec()};
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(self[0].scalar_type(), "foreach_addcdiv_cuda_", [&] {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    multi_tensor_apply<3>(
+        tensor_lists, TernaryOpFunctor<scalar_t, 3, 0>(), AddcdivOp<opmath_t>{value.to<opmath_t>()});
+  });
+}
+
+namespace {
+
+// Lists: params, grads, exp_avgs, exp_avg_sqs and, with amsgrad,
+// max_exp_avg_sqs. All the parameters of a launch are at the same step.
+template <typename scalar_t, int depth>
+struct AdamFunctor {
+  using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+
+  __device__ void operator()(
+      int64_t chunk_size,
+      TensorListMetadata<depth>& tl,
+      opmath_t step_size,
+      opmath_t bias_correction2_sqrt,
+      opmath_t beta1,
+      opmath_t beta2,
+      opmath_t weight_decay,
+      opmath_t eps) {
+    int tensor_loc;
+    int64_t offset, n;
+    chunk_bounds(chunk_size, tl, tensor_loc, offset, n);
+    scalar_t* param = static_cast<scalar_t*>(tl.addresses[0][tensor_loc]) + offset;
+    const scalar_t* grad = static_cast<scalar_t*>(tl.addresses[1][tensor_loc]) + offset;
+    scalar_t* exp_avg = static_cast<scalar_t*>(tl.addresses[2][tensor_loc]) + offset;
+    scalar_t* exp_avg_sq = static_cast<scalar_t*>(tl.addresses[3][tensor_loc]) + offset;
+    scalar_t* max_exp_avg_sq = depth == 5
+        ? static_cast<scalar_t*>(tl.addresses[depth - 1][tensor_loc]) + offset
+        : nullptr;
+
+    for (int64_t i = threadIdx.x; i < n; i += blockDim.x) {
+      opmath_t p = param[i];
+      opmath_t g = grad[i];
+      if (weight_decay != 0) {
+        g += p * weight_decay;
+      }
+      const opmath_t m = static_cast<opmath_t>(exp_avg[i]) * beta1 + g * (1 - beta1);
+      opmath_t v = static_cast<opmath_t>(exp_avg_sq[i]) * beta2 + g * g * (1 - beta2);
+      exp_avg[i] = static_cast<scalar_t>(m);
+      exp_avg_sq[i] = static_cast<scalar_t>(v);
+      if (depth == 5) {
+        // same NaN propagation as at::max
+        const opmath_t v_max = max_exp_avg_sq[i];
+        if (v > v_max || v != v) {
+          max_exp_avg_sq[i] = static_cast<scalar_t>(v);
+        } else {
+          v = v_max;
+        }
+      }
+      const opmath_t denom = ::sqrt(v) / bias_correction2_sqrt + eps;
+      param[i] = static_cast<scalar_t>(p - step_size * (m / denom));
+    }
+  }
+};
+
+// Lists: params, grads and, with momentum, momentum_buffers.
+template <typename scalar_t, int depth>
+struct SGDFunctor {
+  using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+
+  __device__ void operator()(
+      int64_t chunk_size,
+      TensorListMetadata<depth>& tl,
+      opmath_t lr,
+      opmath_t momentum,
+      opmath_t dampening,
+      opmath_t weight_decay,
+      bool nesterov) {
+    int tensor_loc;
+    int64_t offset, n;
+    chunk_bounds(chunk_size, tl, tensor_loc, offset, n);
+    scalar_t* param = static_cast<scalar_t*>(tl.addresses[0][tensor_loc]) + offset;
+    const scalar_t* grad = static_cast<scalar_t*>(tl.addresses[1][tensor_loc]) + offset;
+    scalar_t* buf = depth == 3
+        ? static_cast<scalar_t*>(tl.addresses[depth - 1][tensor_loc]) + offset
+        : nullptr;
+
+    for (int64_t i = threadIdx.x; i < n; i += blockDim.x) {
+      opmath_t p = param[i];
+      opmath_t d_p = grad[i];
+      if (weight_decay != 0) {
+        d_p += p * weight_decay;
+      }
+      if (depth == 3) {
+        const opmath_t b = static_cast<opmath_t>(buf[i]) * momentum + d_p * (1 - dampening);
+        buf[i] = static_cast<scalar_t>(b);
+        d_p = nesterov ? d_p + b * momentum : b;
+      }
+      param[i] = static_cast<scalar_t>(p - d_p * lr);
+    }
+  }
+};
+
+// Lists: params, grads and state_sums. All the parameters of a launch are at
+// the same step.
+template <typename scalar_t>
+struct AdagradFunctor {
+  using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+
+  __device__ void operator()(
+      int64_t chunk_size,
+      TensorListMetadata<3>& tl,
+      opmath_t clr,
+      opmath_t weight_decay,
+      opmath_t eps) {
+    int tensor_loc;
+    int64_t offset, n;
+    chunk_bounds(chunk_size, tl, tensor_loc, offset, n);
+    scalar_t* param = static_cast<scalar_t*>(tl.addresses[0][tensor_loc]) + offset;
+    const scalar_t* grad = static_cast<scalar_t*>(tl.addresses[1][tensor_loc]) + offset;
+    scalar_t* state_sum = static_cast<scalar_t*>(tl.addresses[2][tensor_loc]) + offset;
+
+    for (int64_t i = threadIdx.x; i < n; i += blockDim.x) {
+      opmath_t p = param[i];
+      opmath_t g = grad[i];
+      if (weight_decay != 0) {
+        g += p * weight_decay;
+      }
+      const opmath_t sum = static_cast<opmath_t>(state_sum[i]) + g * g;
+      state_sum[i] = static_cast<scalar_t>(sum);
+      param[i] = static_cast<scalar_t>(p - clr * (g / (::sqrt(sum) + eps)));
+    }
+  }
+};
+
+} // anonymous namespace
+
+void foreach_fused_adam_kernel_cuda_(
+    TensorList self,
+    TensorList grads,
+    TensorList exp_avgs,
+    TensorList exp_avg_sqs,
+    TensorList max_exp_avg_sqs,
+    IntArrayRef steps,
+    double lr,
+    double beta1,
+    double beta2,
+    double weight_decay,
+    double eps,
+    bool amsgrad) {
+  check_foreach_api_restrictions(self, grads, exp_avgs);
+  check_foreach_api_restrictions(self, exp_avg_sqs);
+  if (amsgrad) {
+    check_foreach_api_restrictions(self, max_exp_avg_sqs);
+  }
+  TORCH_CHECK(
+      steps.size() == self.size(),
+      "_fused_adam_: expected ", self.size(), " steps, got ", steps.size());
+  if (!(amsgrad ? can_use_fast_route({self, grads, exp_avgs, exp_avg_sqs, max_exp_avg_sqs})
+                : can_use_fast_route({self, grads, exp_avgs, exp_avg_sqs}))) {
+    return at::native::foreach_fused_adam_kernel_slow_(
+        self, grads, exp_avgs, exp_avg_sqs, max_exp_avg_sqs, steps,
+        lr, beta1, beta2, weight_decay, eps, amsgrad);
+  }
+
+  // The bias corrections depend on the step, so the parameters are launched
+  // by step. They are usually all at the same step.
+  std::vector<bool> done(self.size(), false);
+  for (size_t first = 0; first < self.size(); first++) {
+    if (done[first]) {
+      continue;
+    }
+    const int64_t step = steps[first];
+    std::vector<std::vector<Tensor>> tensor_lists(amsgrad ? 5 : 4);
+    for (size_t i = first; i < self.size(); i++) {
+      if (done[i] || steps[i] != step) {
+        continue;
+      }
+      done[i] = true;
+      tensor_lists[0].push_back(self[i]);
+      tensor_lists[1].push_back(grads[i]);
+      tensor_lists[2].push_back(exp_avgs[i]);
+      tensor_lists[3].push_back(exp_avg_sqs[i]);
+      if (amsgrad) {
+        tensor_lists[4].push_back(max_exp_avg_sqs[i]);
+      }
+    }
+
+    const double bias_correction1 = 1 - std::pow(beta1, step);
+    const double bias_correction2 = 1 - std::pow(beta2, step);
+    AT_DISPATCH_FLOATING_TYPES_AND_HALF(self[0].scalar_type(), "_fused_adam_cuda_", [&] {
+      using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+      const auto step_size = static_cast<opmath_t>(lr / bias_correction1);
+      const auto bias_correction2_sqrt = static_cast<opmath_t>(std::sqrt(bias_correction2));
+      if (amsgrad) {
+        multi_tensor_apply<5>(
+            tensor_lists, AdamFunctor<scalar_t, 5>(), step_size, bias_correction2_sqrt,
+            static_cast<opmath_t>(beta1), static_cast<opmath_t>(beta2),
+            static_cast<opmath_t>(weight_decay), static_cast<opmath_t>(eps));
+      } else {
+        multi_tensor_apply<4>(
+            tensor_lists, AdamFunctor<scalar_t, 4>(), step_size, bias_correction2_sqrt,
+            static_cast<opmath_t>(beta1), static_cast<opmath_t>(beta2),
+            static_cast<opmath_t>(weight_decay), static_cast<opmath_t>(eps));
+      }
+    });
+  }
+}
+
+void foreach_fused_sgd_kernel_cuda_(
+    TensorList self,
+    TensorList grads,
+    TensorList momentum_buffers,
+    double lr,
+    double momentum,
+    double dampening,
+    double weight_decay,
+    bool nesterov) {
+  check_foreach_api_restrictions(self, grads);
+  if (momentum != 0) {
+    check_foreach_api_restrictions(self, momentum_buffers);
+  }
+  if (!(momentum != 0 ? can_use_fast_route({self, grads, momentum_buffers})
+                      : can_use_fast_route({self, grads}))) {
+    return at::native::foreach_fused_sgd_kernel_slow_(
+        self, grads, momentum_buffers, lr, momentum, dampening, weight_decay, nesterov);
+  }
+
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(self[0].scalar_type(), "_fused_sgd_cuda_", [&] {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    if (momentum != 0) {
+      std::vector<std::vector<Tensor>> tensor_lists{self.vec(), grads.vec(), momentum_buffers.vec()};
+      multi_tensor_apply<3>(
+          tensor_lists, SGDFunctor<scalar_t, 3>(), static_cast<opmath_t>(lr),
+          static_cast<opmath_t>(momentum), static_cast<opmath_t>(dampening),
+          static_cast<opmath_t>(weight_decay), nesterov);
+    } else {
+      std::vector<std::vector<Tensor>> tensor_lists{self.vec(), grads.vec()};
+      multi_tensor_apply<2>(
+          tensor_lists, SGDFunctor<scalar_t, 2>(), static_cast<opmath_t>(lr),
+          static_cast<opmath_t>(momentum), static_cast<opmath_t>(dampening),
+          static_cast<opmath_t>(weight_decay), nesterov);
+    }
+  });
+}
+
+void foreach_fused_adagrad_kernel_cuda_(
+    TensorList self,
+    TensorList grads,
+    TensorList state_sums,
+    IntArrayRef steps,
+    double lr,
+    double lr_decay,
+    double weight_decay,
+    double eps) {
+  check_foreach_api_restrictions(self, grads, state_sums);
+  TORCH_CHECK(
+      steps.size() == self.size(),
+      "_fused_adagrad_: expected ", self.size(), " steps, got ", steps.size());
+  if (!can_use_fast_route({self, grads, state_sums})) {
+    return at::native::foreach_fused_adagrad_kernel_slow_(
+        self, grads, state_sums, steps, lr, lr_decay, weight_decay, eps);
+  }
+
+  // The learning rate decays with the step, so the parameters are launched by
+  // step, as for Adam.
+  std::vector<bool> done(self.size(), false);
+  for (size_t first = 0; first < self.size(); first++) {
+    if (done[first]) {
+      continue;
+    }
+    const int64_t step = steps[first];
+    std::vector<std::vector<Tensor>> tensor_lists(3);
+    for (size_t i = first; i < self.size(); i++) {
+      if (done[i] || steps[i] != step) {
+        continue;
+      }
+      done[i] = true;
+      tensor_lists[0].push_back(self[i]);
+      tensor_lists[1].push_back(grads[i]);
+      tensor_lists[2].push_back(state_sums[i]);
+    }
+
+    const double clr = lr / (1 + (step - 1) * lr_decay);
+    AT_DISPATCH_FLOATING_TYPES_AND_HALF(self[0].scalar_type(), "_fused_adagrad_cuda_", [&] {
+      using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+      multi_tensor_apply<3>(
+          tensor_lists, AdagradFunctor<scalar_t>(), static_cast<opmath_t>(clr),
+          static_cast<opmath_t>(weight_decay), static_cast<opmath_t>(eps));
+    });
+  }
+}
+
+namespace {
+
+// How the elements of a tensor contribute to the total norm: the sum of |x|,
+// x * x or |x|^p, or the max of |x|.
+enum class NormKind { L1, L2, Lp, LInf };
+
+template <NormKind kind, typename opmath_t>
+__device__ opmath_t norm_combine(opmath_t acc, opmath_t a) {
+  if (kind == NormKind::LInf) {
+    // same NaN propagation as at::max
+    return (a > acc || a != a) ? a : acc;
+  }
+  return acc + a;
+}
+
+// Lists: tensors and the partial results of their chunks. Every block writes
+// the sum (or max) of the contributions of its chunk, in opmath_t, to the
+// chunk_idx-th partial result of its tensor, so that the total norm is a
+// deterministic reduction of the partial results.
+template <typename scalar_t, NormKind kind>
+struct TotalNormFunctor {
+  using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+
+  __device__ void operator()(
+      int64_t chunk_size,
+      TensorListMetadata<2>& tl,
+      opmath_t norm_type) {
+    int tensor_loc;
+    int64_t offset, n;
+    chunk_bounds(chunk_size, tl, tensor_loc, offset, n);
+    const scalar_t* x = static_cast<scalar_t*>(tl.addresses[0][tensor_loc]) + offset;
+    opmath_t* partial = static_cast<opmath_t*>(tl.addresses[1][tensor_loc]) +
+        tl.block_to_chunk[blockIdx.x];
+
+    opmath_t acc = 0;
+    for (int64_t i = threadIdx.x; i < n; i += blockDim.x) {
+      const opmath_t a = ::fabs(static_cast<opmath_t>(x[i]));
+      switch (kind) {
+        case NormKind::L1:
+        case NormKind::LInf:
+          acc = norm_combine<kind>(acc, a);
+          break;
+        case NormKind::L2:
+          acc += a * a;
+          break;
+        case NormKind::Lp:
+          acc += ::pow(a, norm_type);
+          break;
+      }
+    }
+
+    __shared__ opmath_t shared[kBlockSize];
+    shared[threadIdx.x] = acc;
+    __syncthreads();
+    for (int stride = blockDim.x / 2; stride > 0; stride /= 2) {
+      if (threadIdx.x < stride) {
+        shared[threadIdx.x] =
+            norm_combine<kind>(shared[threadIdx.x], shared[threadIdx.x + stride]);
+      }
+      __syncthreads();
+    }
+    if (threadIdx.x == 0) {
+      *partial = shared[0];
+    }
+  }
+};
+
+// Lists: the tensors to clip. The coefficient is computed from the total norm
+// on the device, and the blocks return without a write when it is at least 1.
+template <typename scalar_t>
+struct ClipByTotalNormFunctor {
+  using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+
+  __device__ void operator()(
+      int64_t chunk_size,
+      TensorListMetadata<1>& tl,
+      const opmath_t* total_norm,
+      opmath_t max_norm) {
+    const opmath_t clip_coef = max_norm / (*total_norm + static_cast<opmath_t>(1e-6));
+    if (!(clip_coef < 1)) {
+      return;
+    }
+    int tensor_loc;
+    int64_t offset, n;
+    chunk_bounds(chunk_size, tl, tensor_loc, offset, n);
+    scalar_t* x = static_cast<scalar_t*>(tl.addresses[0][tensor_loc]) + offset;
+    for (int64_t i = threadIdx.x; i < n; i += blockDim.x) {
+      x[i] = static_cast<scalar_t>(static_cast<opmath_t>(x[i]) * clip_coef);
+    }
+  }
+};
+
+} // anonymous namespace
+
+Tensor foreach_total_norm_kernel_cuda(TensorList tensors, double norm_type) {
+  check_foreach_api_restrictions(tensors);
+  // The fast route takes the norms that are sums (or the max) of a function
+  // of the elements.
+  if (!can_use_fast_route({tensors}) || !(norm_type > 0)) {
+    return at::native::foreach_total_norm_kernel_slow(tensors, norm_type);
+  }
+
+  const auto& first = tensors[0];
+  const auto opmath_dtype = first.scalar_type() == kDouble ? kDouble : kFloat;
+  int64_t n_chunks = 0;
+  for (const auto& t : tensors) {
+    n_chunks += (t.numel() + kChunkSize - 1) / kChunkSize;
+  }
+  if (n_chunks == 0) {
+    return at::zeros({}, first.options());
+  }
+  auto partials = at::empty({n_chunks}, first.options().dtype(opmath_dtype));
+  std::vector<Tensor> tensor_partials;
+  tensor_partials.reserve(tensors.size());
+  int64_t chunk_offset = 0;
+  for (const auto& t : tensors) {
+    const int64_t chunks = (t.numel() + kChunkSize - 1) / kChunkSize;
+    tensor_partials.push_back(partials.narrow(0, chunk_offset, chunks));
+    chunk_offset += chunks;
+  }
+  std::vector<std::vector<Tensor>> tensor_lists{tensors.vec(), tensor_partials};
+
+  const bool is_inf = std::isinf(norm_type);
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(first.scalar_type(), "_foreach_total_norm_cuda", [&] {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    const auto p = static_cast<opmath_t>(norm_type);
+    if (is_inf) {
+      multi_tensor_apply<2>(tensor_lists, TotalNormFunctor<scalar_t, NormKind::LInf>(), p);
+    } else if (norm_type == 1) {
+      multi_tensor_apply<2>(tensor_lists, TotalNormFunctor<scalar_t, NormKind::L1>(), p);
+    } else if (norm_type == 2) {
+      multi_tensor_apply<2>(tensor_lists, TotalNormFunctor<scalar_t, NormKind::L2>(), p);
+    } else {
+      multi_tensor_apply<2>(tensor_lists, TotalNormFunctor<scalar_t, NormKind::Lp>(), p);
+    }
+  });
+
+  Tensor total_norm;
+  if (is_inf) {
+    total_norm = partials.max();
+  } else if (norm_type == 1) {
+    total_norm = partials.sum();
+  } else if (norm_type == 2) {
+    total_norm = partials.sum().sqrt_();
+  } else {
+    total_norm = partials.sum().pow_(1 / norm_type);
+  }
+  return total_norm.to(first.scalar_type());
+}
+
+void foreach_clip_by_total_norm_kernel_cuda_(
+    TensorList self,
+    const Tensor& total_norm,
+    double max_norm) {
+  check_foreach_api_restrictions(self);
+  TORCH_CHECK(
+      total_norm.numel() == 1,
+      "_foreach_clip_by_total_norm_: expected a total_norm with one element, got ",
+      total_norm.numel());
+  if (!can_use_fast_route({self}) || total_norm.device() != self[0].device()) {
+    return at::native::foreach_clip_by_total_norm_kernel_slow_(self, total_norm, max_norm);
+  }
+
+  std::vector<std::vector<Tensor>> tensor_lists{self.vec()};
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(self[0].scalar_type(), "_foreach_clip_by_total_norm_cuda_", [&] {
+    using opmath_t = acc_type<scalar_t, /*is_cuda=*/true>;
+    const auto opmath_dtype = std::is_same<opmath_t, double>::value ? kDouble : kFloat;
+    const auto norm = total_norm.to(opmath_dtype).contiguous();
+    multi_tensor_apply<1>(
+        tensor_lists, ClipByTotalNormFunctor<scalar_t>(), norm.data_ptr<opmath_t>(),
+        static_cast<opmath_t>(max_norm));
+  });
+}
+
+} // namespace native
+} // namespace at
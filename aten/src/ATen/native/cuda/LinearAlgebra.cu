@@ -103,9 +103,23 @@ Tensor& addmm_out_cuda_impl(Tensor& result, const Tensor& self, const Tensor& ma
   TORCH_CHECK(self_sizes[0] == mat1_sizes[0], "self dim 0 must match mat1 dim 0");
   TORCH_CHECK(self_sizes[1] == mat2_sizes[1], "self dim 1 must match mat2 dim 1");
 
+  // With self a bias row broadcast over the rows of a contiguous result (as
+  // in nn.Linear), the bias can be added in the epilogue of the GEMM rather
+  // than copied to result first: cuBLAS computes the transposed result, in
+  // which the bias is added to every column.
+  bool use_bias_epilogue = false;
+#ifdef AT_CUDA_CUBLASLT_ENABLED
+  use_bias_epilogue = beta.to<double>() == 1.0 && result.is_contiguous() &&
+      result.size(0) > 1 && result.size(1) > 1 &&
+      self.stride(0) == 0 && self.stride(1) == 1 &&
+      (self.scalar_type() == at::ScalarType::Half ||
+       self.scalar_type() == at::ScalarType::Float ||
+       self.scalar_type() == at::ScalarType::Double);
+#endif
+
   // If self and result either point to the same data or if beta is zero,
   // we can avoid copying self into result. Otherwise, we need to copy.
-  if (beta.to<double>() != 0.0) {
+  if (beta.to<double>() != 0.0 && !use_bias_epilogue) {
     if ((result.data_ptr() != self.data_ptr()) || (result.strides() != self.strides())) {
       result.copy_(self);
     }
@@ -149,6 +163,23 @@ Tensor& addmm_out_cuda_impl(Tensor& result, const Tensor& self, const Tensor& ma
     scalar_t* mat1_ptr = mat1_.data_ptr<scalar_t>();
     scalar_t* mat2_ptr = mat2_.data_ptr<scalar_t>();
     scalar_t* result_ptr = result_.data_ptr<scalar_t>();
+#ifdef AT_CUDA_CUBLASLT_ENABLED
+    if (use_bias_epilogue) {
+      if (at::cuda::blas::gemm_and_bias<scalar_t>(
+            transpose_mat1 ? 't' : 'n',
+            transpose_mat2 ? 't' : 'n',
+            m, n, k,
+            alpha_val,
+            mat1_ptr, mat1_ld,
+            mat2_ptr, mat2_ld,
+            self.data_ptr<scalar_t>(),
+            result_ptr, result_ld)) {
+        return;
+      }
+      // No algorithm with a bias epilogue: add self like for other shapes
+      result_.copy_(self);
+    }
+#endif
     at::cuda::blas::gemm<scalar_t>(
       transpose_mat1 ? 't' : 'n',
       transpose_mat2 ? 't' : 'n',
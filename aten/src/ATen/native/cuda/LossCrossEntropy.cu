@@ -0,0 +1,252 @@
+// The per-row kernels of the fused cross entropy, see LossCrossEntropy.cpp.
+//
+// A block takes a row at a time: its threads stride over the scores of the
+// row, and are reduced in shared memory for the maximum, the sum of the
+// exponentials and, with label smoothing, the (weighted) sum of the scores.
+// The backward recomputes the softmax from the logsumexp while writing the
+// gradient.
+
+#include <ATen/native/LossCrossEntropy.h>
+
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/macros/Macros.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace at { namespace native {
+
+namespace {
+
+constexpr int MIN_THREADS = 32;
+constexpr int MAX_THREADS = 512;
+
+// A power of two number of threads, enough for the row to be read at once
+// when it is short.
+int threads_for(int64_t n_classes) {
+  int threads = MIN_THREADS;
+  while (threads < n_classes && threads < MAX_THREADS) {
+    threads *= 2;
+  }
+  return threads;
+}
+
+// Reduces the value of every thread of the block, whose size must be a power
+// of two. Every thread gets the result.
+template <typename T, typename Op>
+__device__ __forceinline__ T block_reduce(T* shared, T value, const Op& op) {
+  shared[threadIdx.x] = value;
+  __syncthreads();
+  for (int offset = blockDim.x / 2; offset > 0; offset /= 2) {
+    if (threadIdx.x < offset) {
+      shared[threadIdx.x] = op(shared[threadIdx.x], shared[threadIdx.x + offset]);
+    }
+    __syncthreads();
+  }
+  T result = shared[0];
+  __syncthreads();
+  return result;
+}
+
+template <typename scalar_t, typename accscalar_t>
+__device__ __forceinline__ accscalar_t class_weight(const scalar_t* weight, int64_t c) {
+  return weight != nullptr ? static_cast<accscalar_t>(weight[c]) : accscalar_t(1);
+}
+
+template <typename scalar_t, typename accscalar_t>
+C10_LAUNCH_BOUNDS_1(MAX_THREADS)
+__global__ void cross_entropy_loss_cuda_kernel(
+    accscalar_t* losses,
+    accscalar_t* logsumexp,
+    const scalar_t* input,
+    const int64_t* target,
+    const scalar_t* weight,
+    const accscalar_t* weight_sum,
+    int64_t n_rows,
+    int64_t n_classes,
+    int64_t ignore_index,
+    accscalar_t eps) {
+  extern __shared__ unsigned char smem[];
+  accscalar_t* shared = reinterpret_cast<accscalar_t*>(smem);
+  const accscalar_t total = weight != nullptr ? *weight_sum : accscalar_t(n_classes);
+
+  for (int64_t i = blockIdx.x; i < n_rows; i += gridDim.x) {
+    const scalar_t* row = input + i * n_classes;
+
+    accscalar_t max_input = -std::numeric_limits<accscalar_t>::infinity();
+    for (int64_t c = threadIdx.x; c < n_classes; c += blockDim.x) {
+      max_input = ::max(max_input, static_cast<accscalar_t>(row[c]));
+    }
+    max_input = block_reduce(
+        shared, max_input, [](accscalar_t a, accscalar_t b) { return ::max(a, b); });
+
+    accscalar_t sum_exp = 0;
+    for (int64_t c = threadIdx.x; c < n_classes; c += blockDim.x) {
+      sum_exp += std::exp(static_cast<accscalar_t>(row[c]) - max_input);
+    }
+    sum_exp = block_reduce(
+        shared, sum_exp, [](accscalar_t a, accscalar_t b) { return a + b; });
+    const accscalar_t lse = max_input + std::log(sum_exp);
+
+    // The condition is uniform over the block, which has to reduce together
+    const int64_t t = target[i];
+    accscalar_t weighted_sum = 0;
+    if (eps != 0 && t != ignore_index) {
+      for (int64_t c = threadIdx.x; c < n_classes; c += blockDim.x) {
+        weighted_sum += static_cast<accscalar_t>(row[c]) *
+            class_weight<scalar_t, accscalar_t>(weight, c);
+      }
+      weighted_sum = block_reduce(
+          shared, weighted_sum, [](accscalar_t a, accscalar_t b) { return a + b; });
+    }
+
+    if (threadIdx.x == 0) {
+      logsumexp[i] = lse;
+      if (t == ignore_index) {
+        losses[i] = 0;
+      } else {
+        CUDA_KERNEL_ASSERT(t >= 0 && t < n_classes);
+        accscalar_t loss = -(1 - eps) * class_weight<scalar_t, accscalar_t>(weight, t) *
+            (static_cast<accscalar_t>(row[t]) - lse);
+        if (eps != 0) {
+          loss -= eps / n_classes * (weighted_sum - total * lse);
+        }
+        losses[i] = loss;
+      }
+    }
+  }
+}
+
+template <typename scalar_t, typename accscalar_t>
+C10_LAUNCH_BOUNDS_1(MAX_THREADS)
+__global__ void cross_entropy_loss_backward_cuda_kernel(
+    scalar_t* grad_input,
+    const accscalar_t* grad_losses,
+    const scalar_t* input,
+    const int64_t* target,
+    const scalar_t* weight,
+    const accscalar_t* weight_sum,
+    const accscalar_t* logsumexp,
+    int64_t n_rows,
+    int64_t n_classes,
+    int64_t ignore_index,
+    accscalar_t eps) {
+  const accscalar_t smoothing = eps / n_classes;
+  const accscalar_t total = weight != nullptr ? *weight_sum : accscalar_t(n_classes);
+
+  for (int64_t i = blockIdx.x; i < n_rows; i += gridDim.x) {
+    const scalar_t* row = input + i * n_classes;
+    scalar_t* grad_row = grad_input + i * n_classes;
+
+    const int64_t t = target[i];
+    if (t == ignore_index) {
+      for (int64_t c = threadIdx.x; c < n_classes; c += blockDim.x) {
+        grad_row[c] = 0;
+      }
+      continue;
+    }
+    CUDA_KERNEL_ASSERT(t >= 0 && t < n_classes);
+
+    const accscalar_t grad = grad_losses[i];
+    const accscalar_t lse = logsumexp[i];
+    const accscalar_t target_weight = (1 - eps) * class_weight<scalar_t, accscalar_t>(weight, t);
+    const accscalar_t prob_scale = target_weight + smoothing * total;
+    for (int64_t c = threadIdx.x; c < n_classes; c += blockDim.x) {
+      accscalar_t prob = std::exp(static_cast<accscalar_t>(row[c]) - lse);
+      accscalar_t g = prob * prob_scale - smoothing * class_weight<scalar_t, accscalar_t>(weight, c);
+      if (c == t) {
+        g -= target_weight;
+      }
+      grad_row[c] = static_cast<scalar_t>(grad * g);
+    }
+  }
+}
+
+// The number of blocks, each of them striding over the rows
+int64_t blocks_for(int64_t n_rows) {
+  return std::min<int64_t>(n_rows, at::cuda::getCurrentDeviceProperties()->maxGridSize[0]);
+}
+
+// The sum of the class weights, which scales the label smoothing term. It is
+// left on the device.
+Tensor total_class_weight(const Tensor& weight, ScalarType acc_type) {
+  return weight.defined() ? weight.to(acc_type).sum() : Tensor();
+}
+
+void cross_entropy_loss_kernel(
+    Tensor& losses,
+    Tensor& logsumexp,
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    int64_t ignore_index,
+    double label_smoothing) {
+  const int64_t n_rows = self.size(0);
+  const int64_t n_classes = self.size(1);
+  if (n_rows == 0) {
+    return;
+  }
+  Tensor weight_sum = total_class_weight(weight, losses.scalar_type());
+  const int threads = threads_for(n_classes);
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(self.scalar_type(), "cross_entropy_loss_cuda", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    cross_entropy_loss_cuda_kernel<scalar_t, accscalar_t>
+        <<<blocks_for(n_rows), threads, threads * sizeof(accscalar_t), at::cuda::getCurrentCUDAStream()>>>(
+            losses.data_ptr<accscalar_t>(),
+            logsumexp.data_ptr<accscalar_t>(),
+            self.data_ptr<scalar_t>(),
+            target.data_ptr<int64_t>(),
+            weight.defined() ? weight.data_ptr<scalar_t>() : nullptr,
+            weight.defined() ? weight_sum.data_ptr<accscalar_t>() : nullptr,
+            n_rows,
+            n_classes,
+            ignore_index,
+            static_cast<accscalar_t>(label_smoothing));
+  });
+  AT_CUDA_CHECK(cudaGetLastError());
+}
+
+void cross_entropy_loss_backward_kernel(
+    Tensor& grad_input,
+    const Tensor& grad_losses,
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& weight,
+    const Tensor& logsumexp,
+    int64_t ignore_index,
+    double label_smoothing) {
+  const int64_t n_rows = self.size(0);
+  const int64_t n_classes = self.size(1);
+  if (n_rows == 0) {
+    return;
+  }
+  Tensor weight_sum = total_class_weight(weight, logsumexp.scalar_type());
+  const int threads = threads_for(n_classes);
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(self.scalar_type(), "cross_entropy_loss_backward_cuda", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    cross_entropy_loss_backward_cuda_kernel<scalar_t, accscalar_t>
+        <<<blocks_for(n_rows), threads, 0, at::cuda::getCurrentCUDAStream()>>>(
+            grad_input.data_ptr<scalar_t>(),
+            grad_losses.data_ptr<accscalar_t>(),
+            self.data_ptr<scalar_t>(),
+            target.data_ptr<int64_t>(),
+            weight.defined() ? weight.data_ptr<scalar_t>() : nullptr,
+            weight.defined() ? weight_sum.data_ptr<accscalar_t>() : nullptr,
+            logsumexp.data_ptr<accscalar_t>(),
+            n_rows,
+            n_classes,
+            ignore_index,
+            static_cast<accscalar_t>(label_smoothing));
+  });
+  AT_CUDA_CHECK(cudaGetLastError());
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(cross_entropy_loss_stub, &cross_entropy_loss_kernel);
+REGISTER_DISPATCH(cross_entropy_loss_backward_stub, &cross_entropy_loss_backward_kernel);
+
+}} // namespace at::native
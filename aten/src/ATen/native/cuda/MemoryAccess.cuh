@@ -2,7 +2,9 @@
 
 #include <cstdint>
 #include <type_traits>
+#include <c10/core/ScalarType.h>
 #include <c10/util/Exception.h>
+#include <c10/util/TypeCast.h>
 #include <c10/macros/Macros.h>
 #include <ATen/detail/FunctionTraits.h>
 #include <ATen/cuda/detail/OffsetCalculator.cuh>
@@ -73,6 +75,21 @@ struct unroll_load_helper {
   }
 };
 
+template<int arg_index>
+struct vectorized_strided_load_helper {
+  template <typename args_t, typename policy_t, typename offset_t>
+  static __device__ void apply(policy_t &self, args_t *args, offset_t offsets, int thread_unroll_base) {
+    using arg_t = std::tuple_element_t<arg_index, args_t>;
+    // `data` and `offsets` hold [output, input0, input1, ...], so we need a
+    // +1 offset to get the input
+    const char *ptr = self.data[arg_index + 1] + offsets[arg_index + 1];
+    auto args_accessor = [&args, thread_unroll_base] __device__ (int j) -> arg_t & {
+      return std::get<arg_index>(args[thread_unroll_base + j]);
+    };
+    self.template load_arg<arg_t>(args_accessor, ptr, arg_index + 1);
+  }
+};
+
 }  // namespace detail
 
 // aligned vector generates vectorized load/store on CUDA
@@ -81,6 +98,109 @@ struct alignas(sizeof(scalar_t) * vec_size) aligned_vector {
   scalar_t val[vec_size];
 };
 
+// Per-operand information used by policies::vectorized_strided, indexed like
+// `data`: [output, input0, input1, ...]. Bit i of `broadcast_mask` is set when
+// operand i has a stride of 0 in the innermost dimension.
+template <int ntensors>
+struct vectorized_strided_meta {
+  at::detail::Array<c10::ScalarType, ntensors> dtypes;
+  at::detail::Array<int, ntensors> element_sizes;
+  uint32_t broadcast_mask;
+};
+
+namespace detail {
+
+// Raw storage for an element of a dtype that is only known at runtime, so that
+// it can be moved with vectorized loads and stores of its size.
+template <int size> struct raw_element;
+template <> struct raw_element<1> { using type = uint8_t; };
+template <> struct raw_element<2> { using type = uint16_t; };
+template <> struct raw_element<4> { using type = uint32_t; };
+template <> struct raw_element<8> { using type = uint64_t; };
+template <> struct raw_element<16> { using type = aligned_vector<uint64_t, 2>; };
+
+template <int vec_size, typename arg_t, typename accessor_t>
+__device__ inline void load_vector(accessor_t to, const char *from, bool broadcast) {
+  if (broadcast) {
+    arg_t v = *reinterpret_cast<const arg_t *>(from);
+    #pragma unroll
+    for (int j = 0; j < vec_size; j++) {
+      to(j) = v;
+    }
+    return;
+  }
+  using vec_t = aligned_vector<arg_t, vec_size>;
+  vec_t v = *reinterpret_cast<const vec_t *>(from);
+  #pragma unroll
+  for (int j = 0; j < vec_size; j++) {
+    to(j) = v.val[j];
+  }
+}
+
+template <int vec_size, int element_size, typename arg_t, typename accessor_t>
+__device__ inline void load_and_cast_vector(accessor_t to, const char *from, c10::ScalarType dtype, bool broadcast) {
+  if (broadcast) {
+    arg_t v = c10::fetch_and_cast<arg_t>(dtype, from);
+    #pragma unroll
+    for (int j = 0; j < vec_size; j++) {
+      to(j) = v;
+    }
+    return;
+  }
+  using vec_t = aligned_vector<typename raw_element<element_size>::type, vec_size>;
+  vec_t v = *reinterpret_cast<const vec_t *>(from);
+  #pragma unroll
+  for (int j = 0; j < vec_size; j++) {
+    to(j) = c10::fetch_and_cast<arg_t>(dtype, &v.val[j]);
+  }
+}
+
+template <int vec_size, typename arg_t, typename accessor_t>
+__device__ inline void load_and_cast_vector(accessor_t to, const char *from, c10::ScalarType dtype, int element_size, bool broadcast) {
+  switch (element_size) {
+    case 1: load_and_cast_vector<vec_size, 1, arg_t>(to, from, dtype, broadcast); break;
+    case 2: load_and_cast_vector<vec_size, 2, arg_t>(to, from, dtype, broadcast); break;
+    case 4: load_and_cast_vector<vec_size, 4, arg_t>(to, from, dtype, broadcast); break;
+    case 8: load_and_cast_vector<vec_size, 8, arg_t>(to, from, dtype, broadcast); break;
+    case 16: load_and_cast_vector<vec_size, 16, arg_t>(to, from, dtype, broadcast); break;
+  }
+}
+
+template <int vec_size, typename scalar_t>
+__device__ inline void store_vector(const scalar_t *from, char *to) {
+  using vec_t = aligned_vector<scalar_t, vec_size>;
+  vec_t v;
+  #pragma unroll
+  for (int j = 0; j < vec_size; j++) {
+    v.val[j] = from[j];
+  }
+  *reinterpret_cast<vec_t *>(to) = v;
+}
+
+template <int vec_size, int element_size, typename scalar_t>
+__device__ inline void cast_and_store_vector(const scalar_t *from, char *to, c10::ScalarType dtype) {
+  using vec_t = aligned_vector<typename raw_element<element_size>::type, vec_size>;
+  vec_t v;
+  #pragma unroll
+  for (int j = 0; j < vec_size; j++) {
+    c10::cast_and_store<scalar_t>(dtype, &v.val[j], from[j]);
+  }
+  *reinterpret_cast<vec_t *>(to) = v;
+}
+
+template <int vec_size, typename scalar_t>
+__device__ inline void cast_and_store_vector(const scalar_t *from, char *to, c10::ScalarType dtype, int element_size) {
+  switch (element_size) {
+    case 1: cast_and_store_vector<vec_size, 1>(from, to, dtype); break;
+    case 2: cast_and_store_vector<vec_size, 2>(from, to, dtype); break;
+    case 4: cast_and_store_vector<vec_size, 4>(from, to, dtype); break;
+    case 8: cast_and_store_vector<vec_size, 8>(from, to, dtype); break;
+    case 16: cast_and_store_vector<vec_size, 16>(from, to, dtype); break;
+  }
+}
+
+}  // namespace detail
+
 namespace policies {
 
 // Assumption:
@@ -193,6 +313,81 @@ struct vectorized {
   }
 };
 
+// Assumption:
+// the innermost dimension of every tensor is contiguous (stride ==
+// sizeof(type)), or has a stride of 0 for an input broadcast along it, and its
+// size is a multiple of vec_size, so that the `vec_size` elements of a vector
+// are always in the same row. The outer dimensions may have any stride, which
+// covers inputs broadcast along an outer dimension such as the bias of a
+// [N, C] + [C] addition. `offset_calculator` gives the offsets in bytes of
+// [output, input0, input1, ...] and is evaluated once per vector.
+//
+// With dynamic_casting, the operands are read and written as vectors of raw
+// elements of their own size and converted from and to the types of `func_t`
+// in registers, so mixed dtype traffic (e.g. a half tensor added to a float
+// one) is also done with vectorized memory access. vec_size can then be 1 to
+// handle any strides.
+template <int vec_size, typename data_t, typename offset_calc_t, typename meta_t, bool dynamic_casting>
+struct vectorized_strided {
+
+  static_assert(thread_work_size % vec_size == 0, "The workload per thread must be a multiple of vec_size");
+  static constexpr int loop_size = thread_work_size / vec_size;
+
+  data_t data;
+  int remaining;
+  offset_calc_t offset_calculator;
+  meta_t meta;
+
+  __device__ vectorized_strided(data_t data, int remaining, offset_calc_t oc, meta_t meta):
+    data(data), remaining(remaining), offset_calculator(oc), meta(meta) {}
+
+  __device__ inline bool check_inbounds(int thread_work_elem) {
+    int vec_idx = thread_work_elem / vec_size;
+    return (threadIdx.x + vec_idx * num_threads) * vec_size + thread_work_elem % vec_size < remaining;
+  }
+
+  template<typename arg_t, typename accessor_t>
+  __device__ inline void load_arg(accessor_t to, const char *from, int arg) {
+    bool broadcast = meta.broadcast_mask & (1u << arg);
+    if (dynamic_casting) {
+      detail::load_and_cast_vector<vec_size, arg_t>(to, from, meta.dtypes[arg], meta.element_sizes[arg], broadcast);
+    } else {
+      detail::load_vector<vec_size, arg_t>(to, from, broadcast);
+    }
+  }
+
+  template<typename args_t>
+  __device__ inline void load(args_t *args, int idx) {
+    constexpr int arity = std::tuple_size<args_t>::value;
+    #pragma unroll
+    for (int i = 0; i < loop_size; i++) {
+      int local_idx = (threadIdx.x + i * num_threads) * vec_size;
+      if (local_idx >= remaining) {
+        return;
+      }
+      auto offsets = offset_calculator.get(local_idx + block_work_size * idx);
+      detail::static_unroll<detail::vectorized_strided_load_helper, arity>::with_args(*this, args, offsets, vec_size * i);
+    }
+  }
+
+  template<typename scalar_t>
+  __device__ inline void store(scalar_t *from, int idx) {
+    #pragma unroll
+    for (int i = 0; i < loop_size; i++) {
+      int local_idx = (threadIdx.x + i * num_threads) * vec_size;
+      if (local_idx >= remaining) {
+        return;
+      }
+      char *to = data[0] + offset_calculator.get(local_idx + block_work_size * idx)[0];
+      if (dynamic_casting) {
+        detail::cast_and_store_vector<vec_size>(from + vec_size * i, to, meta.dtypes[0], meta.element_sizes[0]);
+      } else {
+        detail::store_vector<vec_size>(from + vec_size * i, to);
+      }
+    }
+  }
+};
+
 }  // namespace policies
 
 // This is only used in host, but we will wrap this into some templates
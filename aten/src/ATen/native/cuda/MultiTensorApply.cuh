@@ -0,0 +1,143 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/cuda/CUDAGuard.h>
+#include <c10/macros/Macros.h>
+
+#include <vector>
+
+namespace at {
+namespace native {
+
+// Multi-tensor apply: runs a functor over every element of `depth` lists of
+// tensors with a few kernel launches for the whole lists, instead of one (or
+// more) launch per tensor.
+//
+// The tensors are split in chunks of kChunkSize elements and every block of
+// a launch processes one chunk. The data pointers and sizes of the tensors
+// and the (tensor, chunk) of every block are passed to the kernel by value in
+// a TensorListMetadata, so a launch is made whenever it is full.
+//
+// The tensors of the lists are expected to be contiguous, on the same device
+// and of the same dtype (see can_use_fast_route in ForeachUtils.h), and
+// tensors at the same position in the lists to have the same number of
+// elements.
+
+namespace {
+
+static constexpr int64_t kChunkSize = 65536;
+static constexpr int64_t kBlockSize = 512;
+
+// Sized so that a TensorListMetadata stays below the 4kB limit of kernel
+// arguments.
+static constexpr int depth_to_max_tensors[5] = {110, 64, 48, 36, 30};
+static constexpr int depth_to_max_blocks[5] = {320, 320, 320, 320, 320};
+
+template <int n>
+struct TensorListMetadata {
+  void* addresses[n][depth_to_max_tensors[n - 1]];
+  int64_t numel_for_tensor[depth_to_max_tensors[n - 1]];
+  unsigned char block_to_tensor[depth_to_max_blocks[n - 1]];
+  int block_to_chunk[depth_to_max_blocks[n - 1]];
+};
+
+// The tensor of the block of a functor, and the offset and number of elements
+// of its chunk in the tensor.
+template <typename T>
+__device__ void chunk_bounds(
+    int64_t chunk_size,
+    const T& tl,
+    int& tensor_loc,
+    int64_t& offset,
+    int64_t& n) {
+  tensor_loc = tl.block_to_tensor[blockIdx.x];
+  const int chunk_idx = tl.block_to_chunk[blockIdx.x];
+  offset = chunk_idx * chunk_size;
+  n = tl.numel_for_tensor[tensor_loc] - offset;
+  if (n > chunk_size) {
+    n = chunk_size;
+  }
+}
+
+template <typename T, typename U, typename... ArgTypes>
+C10_LAUNCH_BOUNDS_1(kBlockSize)
+__global__ void multi_tensor_apply_kernel(
+    T tensorListMeta,
+    U callable,
+    ArgTypes... args) {
+  // Hand the chunk information to the user-supplied functor to process however
+  // it likes.
+  callable(kChunkSize, tensorListMeta, args...);
+}
+
+template <int depth, typename T, typename... ArgTypes>
+void multi_tensor_apply(
+    std::vector<std::vector<at::Tensor>>& tensor_lists,
+    T callable,
+    ArgTypes... args) {
+  TORCH_CHECK(
+      tensor_lists.size() == depth,
+      "multi_tensor_apply: expected ", depth, " tensor lists, got ",
+      tensor_lists.size());
+  const size_t n_tensors = tensor_lists[0].size();
+  const at::cuda::OptionalCUDAGuard device_guard(device_of(tensor_lists[0][0]));
+  auto stream = at::cuda::getCurrentCUDAStream();
+
+  TensorListMetadata<depth> tensorListMeta;
+  int loc_block_info = 0;
+  int loc_tensor_info = 0;
+
+  auto launch = [&]() {
+    multi_tensor_apply_kernel<<<loc_block_info, kBlockSize, 0, stream>>>(
+        tensorListMeta, callable, args...);
+    AT_CUDA_CHECK(cudaGetLastError());
+  };
+
+  for (size_t t = 0; t < n_tensors; t++) {
+    const int64_t numel = tensor_lists[0][t].numel();
+    if (numel == 0) {
+      continue;
+    }
+    tensorListMeta.numel_for_tensor[loc_tensor_info] = numel;
+    for (int d = 0; d < depth; d++) {
+      tensorListMeta.addresses[d][loc_tensor_info] = tensor_lists[d][t].data_ptr();
+    }
+    loc_tensor_info++;
+
+    const int64_t chunks = (numel + kChunkSize - 1) / kChunkSize;
+    for (int64_t chunk = 0; chunk < chunks; chunk++) {
+      tensorListMeta.block_to_tensor[loc_block_info] = loc_tensor_info - 1;
+      tensorListMeta.block_to_chunk[loc_block_info] = chunk;
+      loc_block_info++;
+
+      const bool tensors_full =
+          (loc_tensor_info == depth_to_max_tensors[depth - 1] && chunk == chunks - 1);
+      const bool blocks_full = (loc_block_info == depth_to_max_blocks[depth - 1]);
+      if (tensors_full || blocks_full) {
+        launch();
+        loc_block_info = 0;
+        if (chunk == chunks - 1) {
+          loc_tensor_info = 0;
+        } else {
+          // The remaining chunks of the current tensor go to the next launch.
+          tensorListMeta.numel_for_tensor[0] =
+              tensorListMeta.numel_for_tensor[loc_tensor_info - 1];
+          for (int d = 0; d < depth; d++) {
+            tensorListMeta.addresses[d][0] =
+                tensorListMeta.addresses[d][loc_tensor_info - 1];
+          }
+          loc_tensor_info = 1;
+        }
+      }
+    }
+  }
+
+  if (loc_block_info != 0) {
+    launch();
+  }
+}
+
+} // anonymous namespace
+} // namespace native
+} // namespace at
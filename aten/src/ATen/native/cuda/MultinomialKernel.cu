@@ -3,6 +3,7 @@
 #include <ATen/LegacyTHFunctionsCUDA.h>
 #include <ATen/native/UnaryOps.h>
 #include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAGraphsUtils.cuh>
 #include <ATen/cuda/CUDAApplyUtils.cuh>
 #include <ATen/native/cuda/LaunchUtils.h>
 #include <ATen/AccumulateType.h>
@@ -113,7 +114,7 @@ __device__ int binarySearchForMultinomial(scalar_t* cumdist,
 
 template <typename scalar_t>
 __global__ void
-sampleMultinomialWithReplacement(std::pair<uint64_t, uint64_t> seeds,
+sampleMultinomialWithReplacement(PhiloxCudaState philox_args,
                                  int totalSamples,
                                  int64_t* dest,
                                  int64_t distributions,
@@ -128,7 +129,8 @@ sampleMultinomialWithReplacement(std::pair<uint64_t, uint64_t> seeds,
   int idx = blockIdx.x * blockDim.x * blockDim.y + threadIdx.y * blockDim.x + threadIdx.x;
 
   curandStatePhilox4_32_10_t state;
-  curand_init(seeds.first, idx, seeds.second, &state);
+  auto seeds = at::cuda::philox::unpack(philox_args);
+  curand_init(std::get<0>(seeds), idx, std::get<1>(seeds), &state);
 
   // The block determines the distribution for which we generate a point
   for (int64_t curDist = blockIdx.x;
@@ -160,7 +162,7 @@ sampleMultinomialWithReplacement(std::pair<uint64_t, uint64_t> seeds,
 
 template <typename scalar_t>
 __global__ void
-sampleMultinomialWithoutReplacement(std::pair<uint64_t, uint64_t> seeds,
+sampleMultinomialWithoutReplacement(PhiloxCudaState philox_args,
                                     int totalSamples,
                                     int sample,
                                     int64_t* dest,
@@ -176,7 +178,8 @@ sampleMultinomialWithoutReplacement(std::pair<uint64_t, uint64_t> seeds,
   int idx = blockIdx.x * blockDim.x * blockDim.y + threadIdx.y * blockDim.x + threadIdx.x;
 
   curandStatePhilox4_32_10_t state;
-  curand_init(seeds.first, idx, seeds.second, &state);
+  auto seeds = at::cuda::philox::unpack(philox_args);
+  curand_init(std::get<0>(seeds), idx, std::get<1>(seeds), &state);
 
   // The block and warp determines the distribution for which we
   // generate a point
@@ -412,7 +415,7 @@ void multinomial_kernel_impl(Tensor& result, const Tensor& self, const int64_t n
       // Prefix sum along rows
       legacy::cuda::_th_cumsum_out(prefixSum, normDist, 1);
 
-      std::pair<uint64_t, uint64_t> rng_engine_inputs;
+      PhiloxCudaState rng_engine_inputs;
 
       if (with_replacement) {
         {
@@ -422,7 +425,7 @@ void multinomial_kernel_impl(Tensor& result, const Tensor& self, const int64_t n
           // each thread will utilize one random, however, since we have to use
           // curand_uniform4 (See Note [Register spilling in curand call for CUDA < 10]),
           // offset is 4.
-          rng_engine_inputs = gen->philox_engine_inputs(4);
+          rng_engine_inputs = gen->philox_cuda_state(4);
         }
         // Sample with replacement
 
@@ -473,7 +476,7 @@ void multinomial_kernel_impl(Tensor& result, const Tensor& self, const int64_t n
             // each thread will utilize one random, however, since we have to use
             // curand_uniform4 (See Note [Register spilling in curand call for CUDA < 10]),
             // offset is 4.
-            rng_engine_inputs = gen->philox_engine_inputs(4);
+            rng_engine_inputs = gen->philox_cuda_state(4);
           }
 
           // The kernel can only draw one sample before we have to
@@ -7,6 +7,7 @@
 #include <stdint.h>
 #include <cuda_fp16.h>
 #include <c10/macros/Macros.h>
+#include <ATen/cuda/detail/OffsetCalculator.cuh>
 
 namespace {
 
@@ -43,6 +44,74 @@ __device__ __forceinline__ void warp_reduce(acc_t* sum) {
     }
 }
 
+// Reduces the value of every thread of a block of blockDim.y warps of
+// C10_WARP_SIZE threads. `shared` holds one value per warp and must not be
+// reused by the block before it has synchronized again.
+template <typename acc_t, int WARPS, template<typename> class ReduceOp>
+__device__ __forceinline__ acc_t block_reduce(acc_t val, acc_t* shared) {
+    ReduceOp<acc_t> r;
+    warp_reduce<acc_t, 1, C10_WARP_SIZE, ReduceOp>(&val);
+    if (threadIdx.x == 0) {
+        shared[threadIdx.y] = val;
+    }
+    __syncthreads();
+    val = shared[0];
+    #pragma unroll
+    for (int w = 1;  w < WARPS;  ++w) {
+        val = r(val, shared[w]);
+    }
+    return val;
+}
+
+// The forward kernels read their input through a Load functor: load.row(r)
+// returns an accessor for the elements of row r, so that anything computed
+// per row is done once. SoftmaxLoad reads the input tensor,
+// ScaledMaskedSoftmaxLoad computes scale * input + mask on the fly, where the
+// rows of the mask may be broadcast across the rows of the input.
+template <typename input_t, typename acc_t>
+struct SoftmaxLoad {
+    struct Row {
+        const input_t* src;
+        __device__ __forceinline__ acc_t operator()(int element_index) const {
+            return static_cast<acc_t>(src[element_index]);
+        }
+    };
+
+    __device__ __forceinline__ Row row(int row_index) const {
+        return Row{src + static_cast<int64_t>(row_index) * stride};
+    }
+
+    const input_t* src;
+    int stride;
+};
+
+template <typename input_t, typename acc_t>
+struct ScaledMaskedSoftmaxLoad {
+    struct Row {
+        const input_t* src;
+        const input_t* mask;
+        acc_t scale;
+        __device__ __forceinline__ acc_t operator()(int element_index) const {
+            return static_cast<acc_t>(src[element_index]) * scale +
+                static_cast<acc_t>(mask[element_index]);
+        }
+    };
+
+    __device__ __forceinline__ Row row(int row_index) const {
+        return Row{
+            src + static_cast<int64_t>(row_index) * stride,
+            mask + mask_offset.get(row_index)[0],
+            scale};
+    }
+
+    const input_t* src;
+    const input_t* mask;
+    // offset of the mask row of each row of the input
+    OffsetCalculator<1> mask_offset;
+    acc_t scale;
+    int stride;
+};
+
 // The softmax_warp_* methods perform softmax forward and backward propagation on samples spanning the fast dimension.
 // Each sample contains element_count scalar elements. element_count can be any integer value <= 1024.
 // The template arguments have the following meaning:
@@ -60,9 +129,16 @@ __device__ __forceinline__ void warp_reduce(acc_t* sum) {
 // input_t=half,  acc_t=float, output_t=half  => read half tensor, float accumulators, write half tensor.
 // input_t=half,  acc_t=float, output_t=float => read half tensor, float accumulators, write float tensor.
 // input_t_float, acc_t=float, output_t=half  => read float tensor, float accumulators, write half tensor.
+//
+// The softmax_block_* methods handle samples of 1025 to max_persistent_softmax_elements elements the same way,
+// except that a sample is spread over the WARPS_PER_ROW warps of a block, which combine their reductions
+// through shared memory. Every thread still keeps at most 1024 / C10_WARP_SIZE elements in registers.
 
-template <typename input_t, typename output_t, typename acc_t, int log2_elements, bool is_log_softmax>
-__global__ void softmax_warp_forward(output_t *dst, const input_t *src, int batch_size, int stride, int element_count)
+constexpr int max_persistent_softmax_log2_elements = 13;
+constexpr int max_persistent_softmax_elements = 1 << max_persistent_softmax_log2_elements;
+
+template <typename input_t, typename output_t, typename acc_t, int log2_elements, bool is_log_softmax, typename Load>
+__global__ void softmax_warp_forward(output_t *dst, Load load, int batch_size, int stride, int element_count)
 {
     // WARP_SIZE and WARP_BATCH must match the return values batches_per_warp and warp_size of method warp_softmax_forward_kernel.
     constexpr int next_power_of_two = 1 << log2_elements;
@@ -81,8 +157,7 @@ __global__ void softmax_warp_forward(output_t *dst, const input_t *src, int batc
     // there might be multiple batches per warp. compute the index within the batch
     int local_idx = threadIdx.x;
 
-    src += first_batch * stride + local_idx;
-    dst += first_batch * stride + local_idx;
+    dst += static_cast<int64_t>(first_batch) * stride + local_idx;
 
     // The nested loops over WARP_BATCH and then WARP_ITERATIONS can be simplified to one loop,
     // but I think doing so would obfuscate the logic of the algorithm, thus I chose to keep
@@ -93,10 +168,11 @@ __global__ void softmax_warp_forward(output_t *dst, const input_t *src, int batc
     acc_t elements[WARP_BATCH][WARP_ITERATIONS];
     for (int i = 0;  i < WARP_BATCH;  ++i) {
         int batch_element_count = (i >= local_batches) ? 0 : element_count;
+        auto row = load.row(first_batch + i);
         for (int it = 0;  it < WARP_ITERATIONS;  ++it) {
             int element_index = local_idx + it * WARP_SIZE;
             if (element_index < batch_element_count) {
-                elements[i][it] = src[i*element_count+it*WARP_SIZE];
+                elements[i][it] = row(element_index);
             } else {
                 elements[i][it] = -std::numeric_limits<acc_t>::infinity();
             }
@@ -141,9 +217,9 @@ __global__ void softmax_warp_forward(output_t *dst, const input_t *src, int batc
             int element_index = local_idx + it * WARP_SIZE;
             if (element_index < element_count) {
                 if (is_log_softmax) {
-                    dst[i*element_count+it*WARP_SIZE] = elements[i][it] - sum[i];
+                    dst[i*stride+it*WARP_SIZE] = elements[i][it] - sum[i];
                 } else {
-                    dst[i*element_count+it*WARP_SIZE] = elements[i][it] / sum[i];
+                    dst[i*stride+it*WARP_SIZE] = elements[i][it] / sum[i];
                 }
             } else {
                 break;
@@ -152,8 +228,69 @@ __global__ void softmax_warp_forward(output_t *dst, const input_t *src, int batc
     }
 }
 
+template <typename input_t, typename output_t, typename acc_t, int log2_elements, bool is_log_softmax, typename Load>
+__global__ void softmax_block_forward(output_t *dst, Load load, int stride, int element_count)
+{
+    // WARPS_PER_ROW must match the value computed in dispatch_softmax_forward_impl.
+    constexpr int next_power_of_two = 1 << log2_elements;
+    constexpr int WARP_ITERATIONS = 1024 / C10_WARP_SIZE;
+    constexpr int WARPS_PER_ROW = next_power_of_two / 1024;
+    constexpr int ROW_THREADS = C10_WARP_SIZE * WARPS_PER_ROW;
+
+    __shared__ acc_t max_shared[WARPS_PER_ROW];
+    __shared__ acc_t sum_shared[WARPS_PER_ROW];
+
+    // one row per block
+    int local_idx = threadIdx.y * C10_WARP_SIZE + threadIdx.x;
+    auto row = load.row(blockIdx.x);
+    dst += static_cast<int64_t>(blockIdx.x) * stride + local_idx;
+
+    // load data from global memory
+    acc_t elements[WARP_ITERATIONS];
+    acc_t max_value = -std::numeric_limits<acc_t>::infinity();
+    #pragma unroll
+    for (int it = 0;  it < WARP_ITERATIONS;  ++it) {
+        int element_index = local_idx + it * ROW_THREADS;
+        if (element_index < element_count) {
+            elements[it] = row(element_index);
+        } else {
+            elements[it] = -std::numeric_limits<acc_t>::infinity();
+        }
+        max_value = (max_value > elements[it]) ? max_value : elements[it];
+    }
+    max_value = block_reduce<acc_t, WARPS_PER_ROW, Max>(max_value, max_shared);
+
+    acc_t sum = 0;
+    #pragma unroll
+    for (int it = 0;  it < WARP_ITERATIONS;  ++it) {
+        if (is_log_softmax) {
+            sum += std::exp(elements[it] - max_value);
+        } else {
+            elements[it] = std::exp(elements[it] - max_value);
+            sum += elements[it];
+        }
+    }
+    sum = block_reduce<acc_t, WARPS_PER_ROW, Add>(sum, sum_shared);
+
+    // store result
+    if (is_log_softmax) sum = max_value + std::log(sum);
+    #pragma unroll
+    for (int it = 0;  it < WARP_ITERATIONS;  ++it) {
+        int element_index = local_idx + it * ROW_THREADS;
+        if (element_index < element_count) {
+            if (is_log_softmax) {
+                dst[it*ROW_THREADS] = elements[it] - sum;
+            } else {
+                dst[it*ROW_THREADS] = elements[it] / sum;
+            }
+        }
+    }
+}
+
+// `grad` is the incoming gradient for log-softmax, and the incoming gradient
+// times the output for softmax. The result is multiplied by `scale`.
 template <typename input_t, typename output_t, typename acc_t, int log2_elements, bool is_log_softmax>
-__global__ void softmax_warp_backward(output_t *gradInput, const input_t *grad, const input_t *output, int batch_size, int stride, int element_count)
+__global__ void softmax_warp_backward(output_t *gradInput, const input_t *grad, const input_t *output, int batch_size, int stride, int element_count, acc_t scale)
 {
     // WARP_SIZE and WARP_BATCH must match the return values batches_per_warp and warp_size of method warp_softmax_backward_kernel.
     constexpr int next_power_of_two = 1 << log2_elements;
@@ -173,7 +310,7 @@ __global__ void softmax_warp_backward(output_t *gradInput, const input_t *grad,
     int local_idx = threadIdx.x % WARP_SIZE;
 
     // the first element to process by the current thread
-    int thread_offset = first_batch * stride + local_idx;
+    int64_t thread_offset = static_cast<int64_t>(first_batch) * stride + local_idx;
     grad += thread_offset;
     output += thread_offset;
     gradInput += thread_offset;
@@ -191,8 +328,8 @@ __global__ void softmax_warp_backward(output_t *gradInput, const input_t *grad,
         for (int it = 0;  it < WARP_ITERATIONS;  ++it) {
             int element_index = local_idx + it * WARP_SIZE;
             if (element_index < batch_element_count) {
-                grad_reg[i][it] = grad[i*element_count+it*WARP_SIZE];
-                output_reg[i][it] = output[i*element_count+it*WARP_SIZE];
+                grad_reg[i][it] = grad[i*stride+it*WARP_SIZE];
+                output_reg[i][it] = output[i*stride+it*WARP_SIZE];
             } else {
                 grad_reg[i][it] = acc_t(0);
                 output_reg[i][it] = acc_t(0);
@@ -222,164 +359,234 @@ __global__ void softmax_warp_backward(output_t *gradInput, const input_t *grad,
             if (element_index < element_count) {
                 // compute gradients
                 if (is_log_softmax) {
-                    gradInput[i*element_count+it*WARP_SIZE] = (grad_reg[i][it] - std::exp(output_reg[i][it]) * sum[i]);
+                    gradInput[i*stride+it*WARP_SIZE] = scale * (grad_reg[i][it] - std::exp(output_reg[i][it]) * sum[i]);
                 } else {
-                    gradInput[i*element_count+it*WARP_SIZE] = (grad_reg[i][it] - output_reg[i][it] * sum[i]);
+                    gradInput[i*stride+it*WARP_SIZE] = scale * (grad_reg[i][it] - output_reg[i][it] * sum[i]);
                 }
             }
         }
     }
 }
 
+template <typename input_t, typename output_t, typename acc_t, int log2_elements, bool is_log_softmax>
+__global__ void softmax_block_backward(output_t *gradInput, const input_t *grad, const input_t *output, int stride, int element_count, acc_t scale)
+{
+    // WARPS_PER_ROW must match the value computed in dispatch_softmax_backward_impl.
+    constexpr int next_power_of_two = 1 << log2_elements;
+    constexpr int WARP_ITERATIONS = 1024 / C10_WARP_SIZE;
+    constexpr int WARPS_PER_ROW = next_power_of_two / 1024;
+    constexpr int ROW_THREADS = C10_WARP_SIZE * WARPS_PER_ROW;
+
+    __shared__ acc_t sum_shared[WARPS_PER_ROW];
+
+    // one row per block
+    int local_idx = threadIdx.y * C10_WARP_SIZE + threadIdx.x;
+    int64_t thread_offset = static_cast<int64_t>(blockIdx.x) * stride + local_idx;
+    grad += thread_offset;
+    output += thread_offset;
+    gradInput += thread_offset;
+
+    // load data from global memory
+    acc_t grad_reg[WARP_ITERATIONS];
+    acc_t output_reg[WARP_ITERATIONS];
+    acc_t sum = 0;
+    #pragma unroll
+    for (int it = 0;  it < WARP_ITERATIONS;  ++it) {
+        int element_index = local_idx + it * ROW_THREADS;
+        if (element_index < element_count) {
+            grad_reg[it] = grad[it*ROW_THREADS];
+            output_reg[it] = output[it*ROW_THREADS];
+        } else {
+            grad_reg[it] = acc_t(0);
+            output_reg[it] = acc_t(0);
+        }
+        sum += grad_reg[it];
+    }
+    sum = block_reduce<acc_t, WARPS_PER_ROW, Add>(sum, sum_shared);
+
+    // store result
+    #pragma unroll
+    for (int it = 0;  it < WARP_ITERATIONS;  ++it) {
+        int element_index = local_idx + it * ROW_THREADS;
+        if (element_index < element_count) {
+            // compute gradients
+            if (is_log_softmax) {
+                gradInput[it*ROW_THREADS] = scale * (grad_reg[it] - std::exp(output_reg[it]) * sum);
+            } else {
+                gradInput[it*ROW_THREADS] = scale * (grad_reg[it] - output_reg[it] * sum);
+            }
+        }
+    }
+}
+
 } // end of anonymous namespace
 
-template<typename input_t, typename output_t, typename acc_t, bool is_log_softmax>
-void dispatch_softmax_forward(output_t *dst, const input_t *src, int softmax_elements, int softmax_elements_stride, int batch_count)
-{
-    TORCH_INTERNAL_ASSERT( softmax_elements >= 0 && softmax_elements <= 1024 );
-    if (softmax_elements == 0) {
-        return;
-    } else {
-        int log2_elements = log2_ceil(softmax_elements);
-        const int next_power_of_two = 1 << log2_elements;
+// Whether rows of `softmax_elements` elements can go through
+// dispatch_softmax_forward and dispatch_softmax_backward. Rows of more than
+// 1024 elements are only handled for types of at most 4 bytes.
+template<typename scalar_t>
+bool can_use_persistent_softmax(int64_t softmax_elements) {
+    if (softmax_elements <= 1024) {
+        return softmax_elements * sizeof(scalar_t) <= 4096;
+    }
+    return softmax_elements <= max_persistent_softmax_elements && sizeof(scalar_t) <= 4;
+}
 
-        // This value must match the WARP_SIZE constexpr value computed inside softmax_warp_forward.
-        int warp_size = (next_power_of_two < C10_WARP_SIZE) ? next_power_of_two : C10_WARP_SIZE;
+#define LAUNCH_SOFTMAX_WARP_FORWARD(L2E)                                      \
+    case L2E:                                                                 \
+        softmax_warp_forward<input_t, output_t, acc_t, L2E, is_log_softmax>  \
+            <<<blocks, threads, 0, stream>>>(dst, load, batch_count, softmax_elements_stride, softmax_elements); \
+        break;
 
-        // This value must match the WARP_BATCH constexpr value computed inside softmax_warp_forward.
-        int batches_per_warp = (next_power_of_two <= 128) ? 2 : 1;
+#define LAUNCH_SOFTMAX_BLOCK_FORWARD(L2E)                                     \
+    case L2E:                                                                 \
+        softmax_block_forward<input_t, output_t, acc_t, L2E, is_log_softmax> \
+            <<<batch_count, dim3(C10_WARP_SIZE, (1 << L2E) / 1024, 1), 0, stream>>>(dst, load, softmax_elements_stride, softmax_elements); \
+        break;
 
-        // use 128 threads per block to maximimize gpu utilization
-        constexpr int threads_per_block = 128;
+template<typename input_t, typename output_t, typename acc_t, bool is_log_softmax, typename Load>
+void dispatch_softmax_forward_impl(output_t *dst, Load load, int softmax_elements, int softmax_elements_stride, int batch_count)
+{
+    TORCH_INTERNAL_ASSERT( softmax_elements >= 0 && softmax_elements <= max_persistent_softmax_elements );
+    if (softmax_elements == 0 || batch_count == 0) {
+        return;
+    }
+    int log2_elements = log2_ceil(softmax_elements);
+    const int next_power_of_two = 1 << log2_elements;
+    auto stream = at::cuda::getCurrentCUDAStream();
 
-        int warps_per_block = (threads_per_block / warp_size);
-        int batches_per_block = warps_per_block * batches_per_warp;
-        int blocks = (batch_count + batches_per_block - 1) / batches_per_block;
-        dim3 threads(warp_size, warps_per_block, 1);
-        // Launch code would be more elegant if C++ supported FOR CONSTEXPR
+    if (log2_elements > 10) {
+        // One row per block of next_power_of_two / 1024 warps.
         switch (log2_elements) {
-            case 0: // 1
-                softmax_warp_forward<input_t, output_t, acc_t, 0, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, batch_count, softmax_elements_stride, softmax_elements);
-                break;
-            case 1: // 2
-                softmax_warp_forward<input_t, output_t, acc_t, 1, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, batch_count, softmax_elements_stride, softmax_elements);
-                break;
-            case 2: // 4
-                softmax_warp_forward<input_t, output_t, acc_t, 2, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, batch_count, softmax_elements_stride, softmax_elements);
-                break;
-            case 3: // 8
-                softmax_warp_forward<input_t, output_t, acc_t, 3, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, batch_count, softmax_elements_stride, softmax_elements);
-                break;
-            case 4: // 16
-                softmax_warp_forward<input_t, output_t, acc_t, 4, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, batch_count, softmax_elements_stride, softmax_elements);
-                break;
-            case 5: // 32
-                softmax_warp_forward<input_t, output_t, acc_t, 5, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, batch_count, softmax_elements_stride, softmax_elements);
-                break;
-            case 6: // 64
-                softmax_warp_forward<input_t, output_t, acc_t, 6, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, batch_count, softmax_elements_stride, softmax_elements);
-                break;
-            case 7: // 128
-                softmax_warp_forward<input_t, output_t, acc_t, 7, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, batch_count, softmax_elements_stride, softmax_elements);
-                break;
-            case 8: // 256
-                softmax_warp_forward<input_t, output_t, acc_t, 8, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, batch_count, softmax_elements_stride, softmax_elements);
-                break;
-            case 9: // 512
-                softmax_warp_forward<input_t, output_t, acc_t, 9, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, batch_count, softmax_elements_stride, softmax_elements);
-                break;
-            case 10: // 1024
-                softmax_warp_forward<input_t, output_t, acc_t, 10, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(dst, src, batch_count, softmax_elements_stride, softmax_elements);
-                break;
+            LAUNCH_SOFTMAX_BLOCK_FORWARD(11) // 2048
+            LAUNCH_SOFTMAX_BLOCK_FORWARD(12) // 4096
+            LAUNCH_SOFTMAX_BLOCK_FORWARD(13) // 8192
             default:
                 break;
         }
+        return;
+    }
+
+    // This value must match the WARP_SIZE constexpr value computed inside softmax_warp_forward.
+    int warp_size = (next_power_of_two < C10_WARP_SIZE) ? next_power_of_two : C10_WARP_SIZE;
+
+    // This value must match the WARP_BATCH constexpr value computed inside softmax_warp_forward.
+    int batches_per_warp = (next_power_of_two <= 128) ? 2 : 1;
+
+    // use 128 threads per block to maximimize gpu utilization
+    constexpr int threads_per_block = 128;
+
+    int warps_per_block = (threads_per_block / warp_size);
+    int batches_per_block = warps_per_block * batches_per_warp;
+    int blocks = (batch_count + batches_per_block - 1) / batches_per_block;
+    dim3 threads(warp_size, warps_per_block, 1);
+    // Launch code would be more elegant if C++ supported FOR CONSTEXPR
+    switch (log2_elements) {
+        LAUNCH_SOFTMAX_WARP_FORWARD(0)  // 1
+        LAUNCH_SOFTMAX_WARP_FORWARD(1)  // 2
+        LAUNCH_SOFTMAX_WARP_FORWARD(2)  // 4
+        LAUNCH_SOFTMAX_WARP_FORWARD(3)  // 8
+        LAUNCH_SOFTMAX_WARP_FORWARD(4)  // 16
+        LAUNCH_SOFTMAX_WARP_FORWARD(5)  // 32
+        LAUNCH_SOFTMAX_WARP_FORWARD(6)  // 64
+        LAUNCH_SOFTMAX_WARP_FORWARD(7)  // 128
+        LAUNCH_SOFTMAX_WARP_FORWARD(8)  // 256
+        LAUNCH_SOFTMAX_WARP_FORWARD(9)  // 512
+        LAUNCH_SOFTMAX_WARP_FORWARD(10) // 1024
+        default:
+            break;
     }
 }
 
+#undef LAUNCH_SOFTMAX_WARP_FORWARD
+#undef LAUNCH_SOFTMAX_BLOCK_FORWARD
+
 template<typename input_t, typename output_t, typename acc_t, bool is_log_softmax>
-void dispatch_softmax_backward(output_t *grad_input, const input_t *grad, const input_t *output, int softmax_elements, int softmax_elements_stride, int batch_count)
+void dispatch_softmax_forward(output_t *dst, const input_t *src, int softmax_elements, int softmax_elements_stride, int batch_count)
 {
-    TORCH_INTERNAL_ASSERT( softmax_elements >= 0 && softmax_elements <= 1024 );
-    if (softmax_elements == 0) {
-       return;
-    } else {
-        int log2_elements = log2_ceil(softmax_elements);
-        const int next_power_of_two = 1 << log2_elements;
+    dispatch_softmax_forward_impl<input_t, output_t, acc_t, is_log_softmax>(
+        dst, SoftmaxLoad<input_t, acc_t>{src, softmax_elements_stride},
+        softmax_elements, softmax_elements_stride, batch_count);
+}
 
-        // This value must match the WARP_SIZE constexpr value computed inside softmax_warp_backward.
-        int warp_size = (next_power_of_two < C10_WARP_SIZE) ? next_power_of_two : C10_WARP_SIZE;
+// softmax(scale * src + mask) over rows of softmax_elements contiguous
+// elements. mask_offset maps the index of a row to the offset of its row of
+// mask, whose elements are contiguous as well.
+template<typename input_t, typename output_t, typename acc_t>
+void dispatch_scaled_masked_softmax_forward(output_t *dst, const input_t *src, const input_t *mask, const OffsetCalculator<1>& mask_offset, acc_t scale, int softmax_elements, int softmax_elements_stride, int batch_count)
+{
+    dispatch_softmax_forward_impl<input_t, output_t, acc_t, false>(
+        dst, ScaledMaskedSoftmaxLoad<input_t, acc_t>{src, mask, mask_offset, scale, softmax_elements_stride},
+        softmax_elements, softmax_elements_stride, batch_count);
+}
 
-        // This value must match the WARP_BATCH constexpr value computed inside softmax_warp_backward.
-        int batches_per_warp = (next_power_of_two <= 128) ? 2 : 1;
+#define LAUNCH_SOFTMAX_WARP_BACKWARD(L2E)                                     \
+    case L2E:                                                                 \
+        softmax_warp_backward<input_t, output_t, acc_t, L2E, is_log_softmax> \
+            <<<blocks, threads, 0, stream>>>(grad_input, grad, output, batch_count, softmax_elements_stride, softmax_elements, scale); \
+        break;
 
-        // use 128 threads per block to maximimize gpu utilization
-        constexpr int threads_per_block = 128;
+#define LAUNCH_SOFTMAX_BLOCK_BACKWARD(L2E)                                    \
+    case L2E:                                                                 \
+        softmax_block_backward<input_t, output_t, acc_t, L2E, is_log_softmax> \
+            <<<batch_count, dim3(C10_WARP_SIZE, (1 << L2E) / 1024, 1), 0, stream>>>(grad_input, grad, output, softmax_elements_stride, softmax_elements, scale); \
+        break;
 
-        int warps_per_block = (threads_per_block / warp_size);
-        int batches_per_block = warps_per_block * batches_per_warp;
-        int blocks = (batch_count + batches_per_block - 1) / batches_per_block;
-        dim3 threads(warp_size, warps_per_block, 1);
-        // Launch code would be more elegant if C++ supported FOR CONSTEXPR
+// For softmax, `grad` is the incoming gradient times the output (see
+// softmax_warp_backward). The gradient is multiplied by `scale`.
+template<typename input_t, typename output_t, typename acc_t, bool is_log_softmax>
+void dispatch_softmax_backward(output_t *grad_input, const input_t *grad, const input_t *output, int softmax_elements, int softmax_elements_stride, int batch_count, acc_t scale = acc_t(1))
+{
+    TORCH_INTERNAL_ASSERT( softmax_elements >= 0 && softmax_elements <= max_persistent_softmax_elements );
+    if (softmax_elements == 0 || batch_count == 0) {
+       return;
+    }
+    int log2_elements = log2_ceil(softmax_elements);
+    const int next_power_of_two = 1 << log2_elements;
+    auto stream = at::cuda::getCurrentCUDAStream();
+
+    if (log2_elements > 10) {
+        // One row per block of next_power_of_two / 1024 warps.
         switch (log2_elements) {
-            case 0: // 1
-                softmax_warp_backward<input_t, output_t, acc_t, 0, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, batch_count, softmax_elements_stride, softmax_elements);
-                break;
-            case 1: // 2
-                softmax_warp_backward<input_t, output_t, acc_t, 1, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, batch_count, softmax_elements_stride, softmax_elements);
-                break;
-            case 2: // 4
-                softmax_warp_backward<input_t, output_t, acc_t, 2, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, batch_count, softmax_elements_stride, softmax_elements);
-                break;
-            case 3: // 8
-                softmax_warp_backward<input_t, output_t, acc_t, 3, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, batch_count, softmax_elements_stride, softmax_elements);
-                break;
-            case 4: // 16
-                softmax_warp_backward<input_t, output_t, acc_t, 4, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, batch_count, softmax_elements_stride, softmax_elements);
-                break;
-            case 5: // 32
-                softmax_warp_backward<input_t, output_t, acc_t, 5, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, batch_count, softmax_elements_stride, softmax_elements);
-                break;
-            case 6: // 64
-                softmax_warp_backward<input_t, output_t, acc_t, 6, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, batch_count, softmax_elements_stride, softmax_elements);
-                break;
-            case 7: // 128
-                softmax_warp_backward<input_t, output_t, acc_t, 7, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, batch_count, softmax_elements_stride, softmax_elements);
-                break;
-            case 8: // 256
-                softmax_warp_backward<input_t, output_t, acc_t, 8, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, batch_count, softmax_elements_stride, softmax_elements);
-                break;
-            case 9: // 512
-                softmax_warp_backward<input_t, output_t, acc_t, 9, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, batch_count, softmax_elements_stride, softmax_elements);
-                break;
-            case 10: // 1024
-                softmax_warp_backward<input_t, output_t, acc_t, 10, is_log_softmax>
-                    <<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(grad_input, grad, output, batch_count, softmax_elements_stride, softmax_elements);
-                break;
+            LAUNCH_SOFTMAX_BLOCK_BACKWARD(11) // 2048
+            LAUNCH_SOFTMAX_BLOCK_BACKWARD(12) // 4096
+            LAUNCH_SOFTMAX_BLOCK_BACKWARD(13) // 8192
             default:
                 break;
         }
+        return;
+    }
+
+    // This value must match the WARP_SIZE constexpr value computed inside softmax_warp_backward.
+    int warp_size = (next_power_of_two < C10_WARP_SIZE) ? next_power_of_two : C10_WARP_SIZE;
+
+    // This value must match the WARP_BATCH constexpr value computed inside softmax_warp_backward.
+    int batches_per_warp = (next_power_of_two <= 128) ? 2 : 1;
+
+    // use 128 threads per block to maximimize gpu utilization
+    constexpr int threads_per_block = 128;
+
+    int warps_per_block = (threads_per_block / warp_size);
+    int batches_per_block = warps_per_block * batches_per_warp;
+    int blocks = (batch_count + batches_per_block - 1) / batches_per_block;
+    dim3 threads(warp_size, warps_per_block, 1);
+    // Launch code would be more elegant if C++ supported FOR CONSTEXPR
+    switch (log2_elements) {
+        LAUNCH_SOFTMAX_WARP_BACKWARD(0)  // 1
+        LAUNCH_SOFTMAX_WARP_BACKWARD(1)  // 2
+        LAUNCH_SOFTMAX_WARP_BACKWARD(2)  // 4
+        LAUNCH_SOFTMAX_WARP_BACKWARD(3)  // 8
+        LAUNCH_SOFTMAX_WARP_BACKWARD(4)  // 16
+        LAUNCH_SOFTMAX_WARP_BACKWARD(5)  // 32
+        LAUNCH_SOFTMAX_WARP_BACKWARD(6)  // 64
+        LAUNCH_SOFTMAX_WARP_BACKWARD(7)  // 128
+        LAUNCH_SOFTMAX_WARP_BACKWARD(8)  // 256
+        LAUNCH_SOFTMAX_WARP_BACKWARD(9)  // 512
+        LAUNCH_SOFTMAX_WARP_BACKWARD(10) // 1024
+        default:
+            break;
     }
 }
 
+#undef LAUNCH_SOFTMAX_WARP_BACKWARD
+#undef LAUNCH_SOFTMAX_BLOCK_BACKWARD
@@ -38,6 +38,10 @@ static inline int last_pow2(int n) {
   return std::max(1, n - (n >> 1));
 }
 
+// The largest number of outputs of a reduction: ops projecting to a tuple of
+// values write each of them to a separate output sharing the same strides.
+static constexpr int max_reduce_outputs = 4;
+
 // returns reduced fraction numerator & denominator
 C10_HOST_DEVICE static void reduce_fraction(size_t &numerator, size_t &denominator) {
   // get GCD of num and denom using Euclid's algorithm.
@@ -284,7 +288,7 @@ struct ReduceOp {
   InputCalculator input_calc;
   OutputCalculator output_calc;
   const void* src;
-  const char* dst[2]; //it accepts at most two destinations
+  const char* dst[max_reduce_outputs];
   // acc_buf used for accumulation among sub Tensor Iterator when accumulation on
   // output is not permissible
   void* acc_buf;
@@ -302,8 +306,7 @@ struct ReduceOp {
       InputCalculator input_calc,
       OutputCalculator output_calc,
       const void* src,
-      char* dst0,
-      optional<char*> dst1,
+      char* const* dsts,
       void* acc_buf,
       void* cta_buf,
       int* semaphores,
@@ -321,9 +324,8 @@ struct ReduceOp {
         semaphores(semaphores),
         base_idx(base_idx),
         noutputs(noutputs) {
-    dst[0] = dst0;
-    if (dst1.has_value()) {
-      dst[1] = dst1.value();
+    for (int i = 0; i < noutputs; i++) {
+      dst[i] = dsts[i];
     }
   }
 
@@ -622,17 +624,36 @@ struct ReduceOp {
     *res = x;
   }
 
-  //Currently implemented for max of two outputs
+  template<int i, class T>
+  C10_DEVICE int set_result(const T x, const index_t base_offset) const {
+    if (i < noutputs) {
+      auto res = (out_scalar_t*)((char*)dst[i] + base_offset);
+      *res = x;
+    }
+    return 0;
+  }
+
+  template<class tuple_t, size_t... I>
+  C10_DEVICE void set_tuple_results(const tuple_t& x, const index_t base_offset, std::index_sequence<I...>) const {
+    int unused[] = {set_result<I>(thrust::get<I>(x), base_offset)...};
+    (void)unused;
+  }
+
+  // Multi-output reductions project to a tuple with one value per output, up
+  // to max_reduce_outputs of them.
   template<class T>
   C10_DEVICE void set_results(const thrust::tuple<T, T> x, const index_t base_offset) const {
-    if (noutputs >= 1) {
-      auto res0 = (out_scalar_t*)((char*)dst[0] + base_offset);
-      *res0 = thrust::get<0>(x);
-    }
-    if (noutputs >= 2) {
-      auto res1 = (out_scalar_t *) ((char *) dst[1] + base_offset);
-      *res1 = thrust::get<1>(x);
-    }
+    set_tuple_results(x, base_offset, std::make_index_sequence<2>{});
+  }
+
+  template<class T>
+  C10_DEVICE void set_results(const thrust::tuple<T, T, T> x, const index_t base_offset) const {
+    set_tuple_results(x, base_offset, std::make_index_sequence<3>{});
+  }
+
+  template<class T>
+  C10_DEVICE void set_results(const thrust::tuple<T, T, T, T> x, const index_t base_offset) const {
+    set_tuple_results(x, base_offset, std::make_index_sequence<4>{});
   }
 
   C10_DEVICE void set_results_to_output(arg_t value, index_t base_offset) const {
@@ -803,15 +824,13 @@ inline void gpu_reduce_kernel(TensorIterator& iter, const ops_t& ops, ident_t id
   }
 
   const char* in_data = (char*)iter.data_ptr(iter.ntensors() - 1);
-  char* out_data = (char*)iter.data_ptr(0);
   const auto noutputs = iter.noutputs();
-  optional<char*> out_data_extra;
-  if (noutputs > 1) {
-    out_data_extra = (char*)iter.data_ptr(1);
-  } else {
-    out_data_extra = nullopt;
+  AT_ASSERT(noutputs <= max_reduce_outputs);
+  char* out_data[max_reduce_outputs];
+  for (int i = 0; i < noutputs; i++) {
+    out_data[i] = (char*)iter.data_ptr(i);
   }
-  char* acc_data = acc_buf_ptr->get_acc_slice(out_data);
+  char* acc_data = acc_buf_ptr->get_acc_slice(out_data[0]);
 
   // Start by assuming that each thread handles a single output and all
   // the inputs for that output.
@@ -938,7 +957,6 @@ inline void gpu_reduce_kernel(TensorIterator& iter, const ops_t& ops, ident_t id
       output_calc,
       in_data,
       out_data,
-      out_data_extra,
       acc_data,
       buffer.get(),
       (int*)semaphores.get(),
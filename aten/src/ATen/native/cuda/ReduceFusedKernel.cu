@@ -0,0 +1,44 @@
+#include <ATen/native/TensorIterator.h>
+#include <ATen/native/cuda/Reduce.cuh>
+#include <ATen/native/DispatchStub.h>
+#include <ATen/native/SharedReduceOps.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/native/ReduceOps.h>
+
+namespace at { namespace native {
+
+template <typename scalar_t, int N, typename res_t>
+void fused_reduce_kernel_impl(TensorIterator& iter, ArrayRef<FusedReduction> reductions) {
+  using acc_t = at::acc_type<scalar_t, /*is_cuda=*/true>;
+  auto ops = FusedReduceOps<scalar_t, acc_t, N, res_t>(reductions);
+  // Three or four accumulators per value: reduce the unrolling factor to 2 to
+  // lower register usage, like the welford kernel.
+  constexpr int vt0 = N > 2 ? 2 : 4;
+  gpu_reduce_kernel<scalar_t, scalar_t, vt0>(iter, ops, ops.identity());
+}
+
+static void fused_reduce_kernel_cuda(TensorIterator& iter, ArrayRef<FusedReduction> reductions) {
+  AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Half, iter.dtype(), "fused_reduce_cuda", [&]() {
+    switch (reductions.size()) {
+      case 1:
+        fused_reduce_kernel_impl<scalar_t, 1, scalar_t>(iter, reductions);
+        break;
+      case 2:
+        fused_reduce_kernel_impl<scalar_t, 2, thrust::tuple<scalar_t, scalar_t>>(iter, reductions);
+        break;
+      case 3:
+        fused_reduce_kernel_impl<scalar_t, 3, thrust::tuple<scalar_t, scalar_t, scalar_t>>(iter, reductions);
+        break;
+      case 4:
+        fused_reduce_kernel_impl<scalar_t, 4, thrust::tuple<scalar_t, scalar_t, scalar_t, scalar_t>>(iter, reductions);
+        break;
+      default:
+        TORCH_INTERNAL_ASSERT(false, "fused_reduce: unexpected number of reductions ", reductions.size());
+    }
+  });
+}
+
+REGISTER_DISPATCH(fused_reduce_stub, &fused_reduce_kernel_cuda);
+
+}} // namespace at::native
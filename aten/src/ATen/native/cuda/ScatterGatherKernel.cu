@@ -1,6 +1,7 @@
 #include <ATen/native/TensorAdvancedIndexing.h>
 
 #include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
 #include <ATen/Dispatch.h>
 
 #include <ATen/native/ScatterGatherShapeChecks.h>
@@ -288,7 +289,178 @@ void scatter_fill_cuda_kernel(Tensor& self, int64_t dim, const Tensor& index, Sc
   );
 }
 
+// scatter_reduce and segment_reduce compute each element (o, k, j) of the
+// [outer, output_size, inner] result in one thread, from the range of the
+// positions along n that are reduced into it. The ranges are contiguous:
+// for segment_reduce they are the segments, and for scatter_reduce the index
+// is sorted first. So no atomics are needed, and the values are reduced in the
+// order of their positions like on CPU.
+
+// The range of the positions with index k in column (o, :, j) of the keys
+// index * n + position sorted along n.
+struct _cuda_scatter_reduce_key_range {
+  const int64_t* keys;
+  int64_t n;
+  int64_t outer_stride;
+  int64_t dim_stride;
+  int64_t inner_stride;
+
+  C10_DEVICE const int64_t* column(int64_t o, int64_t j) const {
+    return keys + o * outer_stride + j * inner_stride;
+  }
+
+  C10_DEVICE int64_t lower_bound(const int64_t* col, int64_t key) const {
+    int64_t lo = 0;
+    int64_t hi = n;
+    while (lo < hi) {
+      const int64_t mid = lo + (hi - lo) / 2;
+      if (col[mid * dim_stride] < key) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  C10_DEVICE void range(int64_t o, int64_t k, int64_t j, int64_t& begin, int64_t& end) const {
+    const int64_t* col = column(o, j);
+    begin = lower_bound(col, k * n);
+    end = lower_bound(col, (k + 1) * n);
+  }
+
+  C10_DEVICE int64_t position(int64_t o, int64_t p, int64_t j) const {
+    return column(o, j)[p * dim_stride] % n;
+  }
+};
+
+struct _cuda_segment_reduce_range {
+  const int64_t* offsets;
+
+  C10_DEVICE void range(int64_t o, int64_t k, int64_t j, int64_t& begin, int64_t& end) const {
+    begin = offsets[k];
+    end = offsets[k + 1];
+  }
+
+  C10_DEVICE int64_t position(int64_t o, int64_t p, int64_t j) const {
+    return p;
+  }
+};
+
+template <typename scalar_t, typename range_t>
+static void _cuda_scatter_reduce_internal_kernel(
+    Tensor& result, Tensor& arg, const Tensor& self,
+    ScatterReduceOp op, const range_t& ranges) {
+  using accscalar_t = at::acc_type<scalar_t, /*is_cuda=*/true>;
+  const int64_t n = self.size(1);
+  const int64_t inner = self.size(2);
+  const int64_t output_size = result.size(1);
+  const scalar_t* self_data = self.data_ptr<scalar_t>();
+  scalar_t* result_data = result.data_ptr<scalar_t>();
+  int64_t* arg_data = arg.numel() > 0 ? arg.data_ptr<int64_t>() : nullptr;
+
+  auto loop = [=]C10_DEVICE(int r) {
+    const int64_t j = r % inner;
+    const int64_t k = (r / inner) % output_size;
+    const int64_t o = r / inner / output_size;
+    int64_t begin, end;
+    ranges.range(o, k, j, begin, end);
+    const scalar_t* self_column = self_data + o * n * inner + j;
+
+    accscalar_t acc = op == ScatterReduceOp::Prod ? 1 : 0;
+    int64_t arg_pos = n;
+    for (int64_t p = begin; p < end; ++p) {
+      const int64_t i = ranges.position(o, p, j);
+      const accscalar_t val = static_cast<accscalar_t>(self_column[i * inner]);
+      switch (op) {
+        case ScatterReduceOp::Sum:
+        case ScatterReduceOp::Mean:
+          acc += val;
+          break;
+        case ScatterReduceOp::Prod:
+          acc *= val;
+          break;
+        case ScatterReduceOp::Max:
+        case ScatterReduceOp::Min: {
+          // the first NaN wins, otherwise the first of equal values
+          const bool better = op == ScatterReduceOp::Max ? val > acc : val < acc;
+          if (arg_pos == n || better || (val != val && acc == acc)) {
+            acc = val;
+            arg_pos = i;
+          }
+          break;
+        }
+      }
+    }
+    if (op == ScatterReduceOp::Mean && end > begin) {
+      acc = acc / static_cast<accscalar_t>(end - begin);
+    }
+    result_data[r] = static_cast<scalar_t>(acc);
+    if (arg_data != nullptr) {
+      arg_data[r] = arg_pos;
+    }
+  };
+
+  _launch_scatter_gather_kernel<num_threads, thread_work_size>(result.numel(), loop);
+}
+
+void scatter_reduce_cuda_kernel(Tensor& result, Tensor& arg, const Tensor& self, const Tensor& index, ScatterReduceOp op) {
+  if (result.numel() == 0) {
+    return;
+  }
+  const int64_t n = self.size(1);
+  const int64_t inner = self.size(2);
+  const int64_t output_size = result.size(1);
+  // a 1-dimensional index is the same for all the columns
+  const bool broadcast_index = index.numel() != self.numel();
+  if (index.numel() > 0) {
+    TORCH_CHECK(
+      index.min().item<int64_t>() >= 0 && index.max().item<int64_t>() < output_size,
+      "scatter_reduce: index out of bounds for output size ", output_size);
+  }
+
+  // index * n + position is unique, so sorting the keys orders the positions
+  // by index and keeps the positions with the same index in order
+  auto positions = at::arange(n, index.options());
+  auto keys = broadcast_index
+    ? index * n + positions
+    : index.view({self.size(0), n, inner}) * n + positions.view({1, n, 1});
+  keys = std::get<0>(keys.sort(/*dim=*/broadcast_index ? 0 : 1)).contiguous();
+
+  _cuda_scatter_reduce_key_range ranges;
+  ranges.keys = keys.data_ptr<int64_t>();
+  ranges.n = n;
+  ranges.outer_stride = broadcast_index ? 0 : n * inner;
+  ranges.dim_stride = broadcast_index ? 1 : inner;
+  ranges.inner_stride = broadcast_index ? 0 : 1;
+
+  AT_DISPATCH_ALL_TYPES_AND2(
+    at::ScalarType::Half, at::ScalarType::BFloat16,
+    self.scalar_type(), "scatter_reduce_cuda", [&] {
+      _cuda_scatter_reduce_internal_kernel<scalar_t>(result, arg, self, op, ranges);
+    }
+  );
+}
+
+void segment_reduce_cuda_kernel(Tensor& result, Tensor& arg, const Tensor& data, const Tensor& offsets, ScatterReduceOp op) {
+  if (result.numel() == 0) {
+    return;
+  }
+  auto offsets_ = offsets.contiguous();
+  _cuda_segment_reduce_range ranges;
+  ranges.offsets = offsets_.data_ptr<int64_t>();
+
+  AT_DISPATCH_ALL_TYPES_AND2(
+    at::ScalarType::Half, at::ScalarType::BFloat16,
+    data.scalar_type(), "segment_reduce_cuda", [&] {
+      _cuda_scatter_reduce_internal_kernel<scalar_t>(result, arg, data, op, ranges);
+    }
+  );
+}
+
 REGISTER_DISPATCH(scatter_stub, &scatter_cuda_kernel);
 REGISTER_DISPATCH(scatter_fill_stub, &scatter_fill_cuda_kernel);
+REGISTER_DISPATCH(scatter_reduce_stub, &scatter_reduce_cuda_kernel);
+REGISTER_DISPATCH(segment_reduce_stub, &segment_reduce_cuda_kernel);
 
 }} // namespace at::native
@@ -514,7 +514,7 @@ Tensor host_softmax(const Tensor & input_, const int64_t dim_, const bool half_t
       AT_SKIP_BFLOAT16_IF_NOT_ROCM(scalar_t, "host_softmax", [&] {
       using accscalar_t = acc_type<scalar_t, true>;
       if (!half_to_float) {
-        if (dim_size <= 1024 && dim_size*sizeof(scalar_t) <= 4096) {
+        if (can_use_persistent_softmax<scalar_t>(dim_size)) {
           dispatch_softmax_forward<scalar_t, scalar_t, accscalar_t, is_log_softmax>(
               output.data_ptr<scalar_t>(), input.data_ptr<scalar_t>(), dim_size, dim_size, outer_size);
         } else {
@@ -524,7 +524,7 @@ Tensor host_softmax(const Tensor & input_, const int64_t dim_, const bool half_t
           );
         }
       } else {
-        if (dim_size <= 1024 && dim_size*sizeof(scalar_t) <= 4096) {
+        if (can_use_persistent_softmax<scalar_t>(dim_size)) {
           dispatch_softmax_forward<scalar_t, accscalar_t, accscalar_t, is_log_softmax>(
               output.data_ptr<accscalar_t>(), input.data_ptr<scalar_t>(), dim_size, dim_size, outer_size);
         } else {
@@ -602,7 +602,7 @@ Tensor host_softmax_backward(const Tensor &grad_, const Tensor &output_, int64_t
     AT_SKIP_BFLOAT16_IF_NOT_ROCM(scalar_t, "host_softmax_backward", [&] {
     using accscalar_t = acc_type<scalar_t, true>;
     if (!half_to_float) {
-      if (dim_size <= 1024 && dim_size*sizeof(scalar_t) <= 4096) {
+      if (can_use_persistent_softmax<scalar_t>(dim_size)) {
         dispatch_softmax_backward<scalar_t, scalar_t, accscalar_t, is_log_softmax>(
             gI.data_ptr<scalar_t>(), grad.data_ptr<scalar_t>(), output.data_ptr<scalar_t>(), dim_size, dim_size, outer_size);
       } else {
@@ -612,7 +612,7 @@ Tensor host_softmax_backward(const Tensor &grad_, const Tensor &output_, int64_t
         );
       }
     } else {
-      if (dim_size <= 1024 && dim_size*sizeof(scalar_t) <= 4096) {
+      if (can_use_persistent_softmax<scalar_t>(dim_size)) {
         dispatch_softmax_backward<accscalar_t, scalar_t, accscalar_t, is_log_softmax>(
             gI.data_ptr<scalar_t>(), grad.data_ptr<accscalar_t>(), output.data_ptr<accscalar_t>(), dim_size, dim_size, outer_size);
       } else {
@@ -686,5 +686,79 @@ Tensor softmax_backward_cuda(const Tensor &grad, const Tensor &output, int64_t d
   return host_softmax_backward<SoftMaxBackwardEpilogue,false>(tmp, output, dim, half_to_float);
 }
 
+// softmax(self * scale + mask) over the last dimension, where mask is
+// broadcastable to self, as used by the attention of transformers. Rows of up
+// to max_persistent_softmax_elements contiguous elements are computed by the
+// persistent softmax kernels without materializing self * scale + mask.
+Tensor scaled_masked_softmax_cuda(const Tensor& self, const Tensor& mask, double scale) {
+  TORCH_CHECK(self.dim() > 0, "_scaled_masked_softmax: expected a tensor with at least one dimension");
+  auto input = self.contiguous();
+  const int64_t dim_size = input.size(-1);
+  const int64_t outer_size = dim_size == 0 ? 0 : input.numel() / dim_size;
+  bool fast_path = input.numel() > 0 && mask.scalar_type() == input.scalar_type() &&
+      (input.scalar_type() == ScalarType::Float || input.scalar_type() == ScalarType::Double ||
+       input.scalar_type() == ScalarType::Half) &&
+      input.numel() <= std::numeric_limits<int32_t>::max();
+  Tensor expanded_mask;
+  if (fast_path) {
+    expanded_mask = mask.expand(input.sizes());
+    fast_path = expanded_mask.stride(-1) == 1 && expanded_mask.device() == input.device();
+  }
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(input.scalar_type(), "_scaled_masked_softmax", [&] {
+    fast_path = fast_path && can_use_persistent_softmax<scalar_t>(dim_size);
+  });
+  if (!fast_path) {
+    return at::softmax(self * scale + mask, -1);
+  }
+
+  // The offset of the mask row of every row of input: the outer dimensions,
+  // innermost first, with the strides of the broadcast mask.
+  const int dims = input.dim() - 1;
+  std::vector<int64_t> sizes(dims);
+  std::vector<int64_t> strides(dims);
+  for (int i = 0; i < dims; i++) {
+    sizes[i] = expanded_mask.size(dims - 1 - i);
+    strides[i] = expanded_mask.stride(dims - 1 - i);
+  }
+  const int64_t* strides_ptr = strides.data();
+  OffsetCalculator<1> mask_offset(dims, sizes.data(), &strides_ptr);
+
+  Tensor output = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(input.scalar_type(), "_scaled_masked_softmax", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    dispatch_scaled_masked_softmax_forward<scalar_t, scalar_t, accscalar_t>(
+        output.data_ptr<scalar_t>(), input.data_ptr<scalar_t>(), expanded_mask.data_ptr<scalar_t>(),
+        mask_offset, static_cast<accscalar_t>(scale), dim_size, dim_size, outer_size);
+  });
+  AT_CUDA_CHECK(cudaGetLastError());
+  return output;
+}
+
+Tensor scaled_masked_softmax_backward_cuda(const Tensor& grad_output, const Tensor& output_, double scale) {
+  TORCH_CHECK(output_.dim() > 0, "_scaled_masked_softmax_backward: expected a tensor with at least one dimension");
+  auto output = output_.contiguous();
+  const int64_t dim_size = output.size(-1);
+  bool fast_path = output.numel() > 0 && grad_output.scalar_type() == output.scalar_type() &&
+      (output.scalar_type() == ScalarType::Float || output.scalar_type() == ScalarType::Double ||
+       output.scalar_type() == ScalarType::Half);
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(output.scalar_type(), "_scaled_masked_softmax_backward", [&] {
+    fast_path = fast_path && can_use_persistent_softmax<scalar_t>(dim_size);
+  });
+  if (!fast_path) {
+    return at::_softmax_backward_data(grad_output, output, -1, output) * scale;
+  }
+
+  Tensor tmp = (grad_output * output).contiguous();
+  Tensor grad_input = at::empty_like(output, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(output.scalar_type(), "_scaled_masked_softmax_backward", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    dispatch_softmax_backward<scalar_t, scalar_t, accscalar_t, false>(
+        grad_input.data_ptr<scalar_t>(), tmp.data_ptr<scalar_t>(), output.data_ptr<scalar_t>(),
+        dim_size, dim_size, output.numel() / dim_size, static_cast<accscalar_t>(scale));
+  });
+  AT_CUDA_CHECK(cudaGetLastError());
+  return grad_input;
+}
+
 }
 }
@@ -188,10 +188,14 @@ static inline Tensor _run_cufft(
   // set output
   auto output = at::empty(output_sizes, input.options());
 
+  auto ws = at::empty({ config.workspace_size() }, at::device(at::kCUDA).dtype(at::kByte));
+
+  // The plan may be shared with other threads, which set their own stream and
+  // work area before launching it.
+  std::unique_lock<std::mutex> exec_guard(config.exec_mutex());
+
   // set to current stream
   CUFFT_CHECK(cufftSetStream(plan, at::cuda::getCurrentCUDAStream()));
-
-  auto ws = at::empty({ config.workspace_size() }, at::device(at::kCUDA).dtype(at::kByte));
   CUFFT_CHECK(cufftSetWorkArea(plan, ws.data_ptr()));
 
   // run
@@ -234,6 +238,7 @@ static inline Tensor _run_cufft(
   CUFFT_CHECK(cufftXtExec(plan, input.data_ptr(), output.data_ptr(),
     inverse ? CUFFT_INVERSE : CUFFT_FORWARD));
 #endif
+  exec_guard.unlock();
 
   // rescale if needed by normalized flag or inverse transform
   auto size_last_signal_dim = checked_signal_sizes[signal_ndim - 1];
@@ -291,7 +296,9 @@ int64_t cufft_get_plan_cache_max_size_impl(int64_t device_index) {
     "cufft_get_plan_cache_max_size: expected 0 <= device_index < ",
     at::detail::getCUDAHooks().getNumGPUs(), "], but got device_index=",
     device_index);
-  return cufft_get_plan_cache(device_index).max_size();
+  auto& plan_cache = cufft_get_plan_cache(device_index);
+  std::lock_guard<std::mutex> guard(plan_cache.mutex);
+  return plan_cache.max_size();
 }
 
 void cufft_set_plan_cache_max_size_impl(int64_t device_index, int64_t max_size) {
@@ -299,7 +306,9 @@ void cufft_set_plan_cache_max_size_impl(int64_t device_index, int64_t max_size)
     "cufft_set_plan_cache_max_size: expected 0 <= device_index < ",
     at::detail::getCUDAHooks().getNumGPUs(), "], but got device_index=",
     device_index);
-  return cufft_get_plan_cache(device_index).resize(max_size);
+  auto& plan_cache = cufft_get_plan_cache(device_index);
+  std::lock_guard<std::mutex> guard(plan_cache.mutex);
+  plan_cache.resize(max_size);
 }
 
 int64_t cufft_get_plan_cache_size_impl(int64_t device_index) {
@@ -307,7 +316,9 @@ int64_t cufft_get_plan_cache_size_impl(int64_t device_index) {
     "cufft_get_plan_cache_size: expected 0 <= device_index < ",
     at::detail::getCUDAHooks().getNumGPUs(), "], but got device_index=",
     device_index);
-  return cufft_get_plan_cache(device_index).size();
+  auto& plan_cache = cufft_get_plan_cache(device_index);
+  std::lock_guard<std::mutex> guard(plan_cache.mutex);
+  return plan_cache.size();
 }
 
 void cufft_clear_plan_cache_impl(int64_t device_index) {
@@ -315,13 +326,17 @@ void cufft_clear_plan_cache_impl(int64_t device_index) {
     "cufft_clear_plan_cache: expected 0 <= device_index < ",
     at::detail::getCUDAHooks().getNumGPUs(), "], but got device_index=",
     device_index);
-  return cufft_get_plan_cache(device_index).clear();
+  auto& plan_cache = cufft_get_plan_cache(device_index);
+  std::lock_guard<std::mutex> guard(plan_cache.mutex);
+  plan_cache.clear();
 }
 
 } // namespace at::native::detail
 
 // cuFFT
 // Currently not utilizing multi GPUs so this can be potentially sped up.
+// Every device has its own plan cache (and limit, see
+// cufft_set_plan_cache_max_size_impl).
 Tensor _fft_cufft(const Tensor& self, int64_t signal_ndim,
                   bool complex_input, bool complex_output, bool inverse,
                   IntArrayRef checked_signal_sizes, bool normalized, bool onesided,
@@ -370,13 +385,21 @@ Tensor _fft_cufft(const Tensor& self, int64_t signal_ndim,
     CuFFTParams params;
     setCuFFTParams(&params, input, signal_ndim, complex_input,
       complex_output, checked_signal_sizes, onesided);
-    std::lock_guard<std::mutex> guard(plan_cache.mutex);
-    if (plan_cache.max_size() > 0) {  // check again after acquiring the lock
-      const CuFFTConfig &config = plan_cache.try_emplace_value(std::move(params),
-                                             input, signal_ndim, complex_input,
-                                             complex_output, checked_signal_sizes,
-                                             onesided, output_sizes);
-      return _run_cufft(config, input, signal_ndim, complex_input,
+    std::shared_ptr<const CuFFTConfig> config;
+    {
+      // The lock only covers the lookup (and the plan creation on a miss), so
+      // that threads running FFTs on other streams are not serialized behind
+      // each other's launches.
+      std::lock_guard<std::mutex> guard(plan_cache.mutex);
+      if (plan_cache.max_size() > 0) {  // check again after acquiring the lock
+        config = plan_cache.try_emplace_value(std::move(params),
+                                              input, signal_ndim, complex_input,
+                                              complex_output, checked_signal_sizes,
+                                              onesided, output_sizes);
+      }
+    }
+    if (config) {
+      return _run_cufft(*config, input, signal_ndim, complex_input,
                         complex_output, inverse, checked_signal_sizes, normalized,
                         onesided, output_sizes, input_was_cloned);
     }
@@ -6,6 +6,8 @@
 #include <ATen/NativeFunctions.h>
 #include <ATen/cuda/CUDAApplyUtils.cuh>
 #include <ATen/cuda/detail/IndexUtils.cuh>
+#include <ATen/native/SharedReduceOps.h>
+#include <ATen/native/cuda/MemoryAccess.cuh>
 #include <THC/THCDeviceUtils.cuh>
 
 #include <c10/cuda/CUDAMathCompat.h>
@@ -18,6 +20,11 @@ namespace {
 constexpr int kCUDANumThreads = 256;
 constexpr int kCUDABlockReduceNumThreads = 512;
 constexpr int kColwiseReduceTileSize = 32;
+// Rows of up to kCUDANumThreads * kFusedItemsPerThread elements are
+// normalized by LayerNormForwardFusedCUDAKernel, which keeps the row in
+// registers between the statistics and the normalization.
+constexpr int kFusedItemsPerThread = 16;
+constexpr int64_t kFusedMaxRowSize = kCUDANumThreads * kFusedItemsPerThread;
 
 template <typename T>
 __inline__ __device__ T WarpReduceSum(T val) {
@@ -44,6 +51,57 @@ __inline__ __device__ T BlockReduceSum(T val, T* shared) {
   return val;
 }
 
+template <typename T_ACC>
+using WelfordType = WelfordData<T_ACC, int, T_ACC>;
+
+template <typename T_ACC>
+using WelfordOpsType =
+    WelfordOps<T_ACC, T_ACC, int, T_ACC, thrust::pair<T_ACC, T_ACC>>;
+
+template <typename T_ACC>
+__inline__ __device__ WelfordType<T_ACC> WarpReduceWelford(
+    WelfordType<T_ACC> val,
+    const WelfordOpsType<T_ACC>& op) {
+#pragma unroll
+  for (int offset = (C10_WARP_SIZE >> 1); offset > 0; offset >>= 1) {
+    val = op.combine(val, op.warp_shfl_down(val, offset));
+  }
+  return val;
+}
+
+// Combines the Welford states of all the threads of the block, every thread
+// gets the result. blockDim.x must be a multiple of C10_WARP_SIZE.
+template <typename T_ACC>
+__inline__ __device__ WelfordType<T_ACC> BlockReduceWelford(
+    WelfordType<T_ACC> val,
+    const WelfordOpsType<T_ACC>& op,
+    T_ACC* mean_shared,
+    T_ACC* m2_shared,
+    T_ACC* nf_shared) {
+  const int lid = threadIdx.x % C10_WARP_SIZE;
+  const int wid = threadIdx.x / C10_WARP_SIZE;
+  val = WarpReduceWelford(val, op);
+  if (lid == 0) {
+    mean_shared[wid] = val.mean;
+    m2_shared[wid] = val.m2;
+    nf_shared[wid] = val.nf;
+  }
+  __syncthreads();
+  if (wid == 0) {
+    val = lid < blockDim.x / C10_WARP_SIZE
+        ? WelfordType<T_ACC>(mean_shared[lid], m2_shared[lid], 0, nf_shared[lid])
+        : WelfordType<T_ACC>();
+    val = WarpReduceWelford(val, op);
+    if (lid == 0) {
+      mean_shared[0] = val.mean;
+      m2_shared[0] = val.m2;
+      nf_shared[0] = val.nf;
+    }
+  }
+  __syncthreads();
+  return WelfordType<T_ACC>(mean_shared[0], m2_shared[0], 0, nf_shared[0]);
+}
+
 template <typename T>
 __global__ void RowwiseMomentsCUDAKernel(
     int64_t N,
@@ -96,79 +154,157 @@ __global__ void LayerNormForwardCUDAKernel(
   }
 }
 
-template <typename T>
-__global__ void ComputeInternalGradientsCUDAKernel(
+// One block per row: the elements of the row are loaded once, kVecSize at a
+// time, into registers, where their mean and variance are computed with
+// Welford's algorithm before they are normalized and stored.
+template <typename T, int kVecSize>
+__global__ void LayerNormForwardFusedCUDAKernel(
     int64_t N,
-    const T* dY,
+    acc_type<T, true> eps,
     const T* X,
     const T* gamma,
-    acc_type<T, true>* ds,
-    acc_type<T, true>* db) {
+    const T* beta,
+    T* Y,
+    T* mean,
+    T* rstd) {
   using T_ACC = acc_type<T, true>;
-  __shared__ T_ACC ds_shared[C10_WARP_SIZE];
-  __shared__ T_ACC db_shared[C10_WARP_SIZE];
+  using vec_t = memory::aligned_vector<T, kVecSize>;
+  constexpr int kLoops = kFusedItemsPerThread / kVecSize;
+  __shared__ T_ACC mean_shared[kCUDANumThreads / C10_WARP_SIZE];
+  __shared__ T_ACC m2_shared[kCUDANumThreads / C10_WARP_SIZE];
+  __shared__ T_ACC nf_shared[kCUDANumThreads / C10_WARP_SIZE];
   const int64_t i = blockIdx.x;
-  T_ACC sum1 = 0;
-  T_ACC sum2 = 0;
-  for (int64_t j = threadIdx.x; j < N; j += blockDim.x) {
-    const int64_t index = i * N + j;
-    const T_ACC gamma_v =
-        gamma == nullptr ? T_ACC(1) : static_cast<T_ACC>(gamma[j]);
-    sum1 +=
-        static_cast<T_ACC>(dY[index]) * static_cast<T_ACC>(X[index]) * gamma_v;
-    sum2 += static_cast<T_ACC>(dY[index]) * gamma_v;
+  const vec_t* X_vec = reinterpret_cast<const vec_t*>(X + i * N);
+  vec_t* Y_vec = reinterpret_cast<vec_t*>(Y + i * N);
+  const vec_t* gamma_vec = reinterpret_cast<const vec_t*>(gamma);
+  const vec_t* beta_vec = reinterpret_cast<const vec_t*>(beta);
+  const int64_t num_vecs = N / kVecSize;
+
+  WelfordOpsType<T_ACC> op(/*unbiased=*/false, /*take_sqrt=*/false);
+  WelfordType<T_ACC> welford;
+  T_ACC x_reg[kFusedItemsPerThread];
+#pragma unroll
+  for (int l = 0; l < kLoops; ++l) {
+    const int64_t j = l * blockDim.x + threadIdx.x;
+    if (j < num_vecs) {
+      const vec_t v = X_vec[j];
+#pragma unroll
+      for (int k = 0; k < kVecSize; ++k) {
+        x_reg[l * kVecSize + k] = static_cast<T_ACC>(v.val[k]);
+        welford = op.reduce(welford, x_reg[l * kVecSize + k], 0);
+      }
+    }
   }
-  sum1 = BlockReduceSum<T_ACC>(sum1, ds_shared);
-  sum2 = BlockReduceSum<T_ACC>(sum2, db_shared);
+  welford = BlockReduceWelford<T_ACC>(
+      welford, op, mean_shared, m2_shared, nf_shared);
+  const T_ACC mean_v = welford.mean;
+  const T_ACC rstd_v = c10::cuda::compat::rsqrt(
+      c10::cuda::compat::max(welford.m2 / welford.nf, T_ACC(0)) + eps);
   if (threadIdx.x == 0) {
-    ds[i] = sum1;
-    db[i] = sum2;
+    mean[i] = mean_v;
+    rstd[i] = rstd_v;
   }
-}
 
-template <typename T>
-__global__ void ComputeGradientFusedParamsCUDAKernel(
-    int64_t M,
-    int64_t N,
-    const T* mean,
-    const T* rstd,
-    const acc_type<T, true>* ds,
-    const acc_type<T, true>* db,
-    acc_type<T, true>* c1,
-    acc_type<T, true>* c2) {
-  using T_ACC = acc_type<T, true>;
-  const int64_t index = blockIdx.x * blockDim.x + threadIdx.x;
-  if (index < M) {
-    const T_ACC s = T_ACC(1) / static_cast<T_ACC>(N);
-    const T_ACC a = (db[index] * static_cast<T_ACC>(mean[index]) - ds[index]) *
-        static_cast<T_ACC>(rstd[index]) * static_cast<T_ACC>(rstd[index]) *
-        static_cast<T_ACC>(rstd[index]) * s;
-    c1[index] = a;
-    c2[index] =
-        -(a * static_cast<T_ACC>(mean[index]) +
-          db[index] * static_cast<T_ACC>(rstd[index]) * s);
+#pragma unroll
+  for (int l = 0; l < kLoops; ++l) {
+    const int64_t j = l * blockDim.x + threadIdx.x;
+    if (j < num_vecs) {
+      vec_t gamma_v;
+      vec_t beta_v;
+      if (gamma != nullptr) {
+        gamma_v = gamma_vec[j];
+      }
+      if (beta != nullptr) {
+        beta_v = beta_vec[j];
+      }
+      vec_t y;
+#pragma unroll
+      for (int k = 0; k < kVecSize; ++k) {
+        const T_ACC g =
+            gamma == nullptr ? T_ACC(1) : static_cast<T_ACC>(gamma_v.val[k]);
+        const T_ACC b =
+            beta == nullptr ? T_ACC(0) : static_cast<T_ACC>(beta_v.val[k]);
+        y.val[k] = (x_reg[l * kVecSize + k] - mean_v) * rstd_v * g + b;
+      }
+      Y_vec[j] = y;
+    }
   }
 }
 
-template <typename T>
-__global__ void LayerNormBackwardCUDAKenrel(
+// One block per row computes dX: the row is reduced to
+//   ds = sum(dY * X * gamma) and db = sum(dY * gamma)
+// from which dX = rstd * dY * gamma + c1 * X + c2 follows, with
+//   c1 = (db * mean - ds) * rstd^3 / N
+//   c2 = -(c1 * mean + db * rstd / N).
+template <typename T, int kVecSize>
+__global__ void LayerNormBackwardFusedCUDAKernel(
     int64_t N,
     const T* dY,
     const T* X,
+    const T* mean,
+    const T* rstd,
     const T* gamma,
-    const T* a,
-    const acc_type<T, true>* b,
-    const acc_type<T, true>* c,
     T* dX) {
   using T_ACC = acc_type<T, true>;
+  using vec_t = memory::aligned_vector<T, kVecSize>;
+  __shared__ T_ACC ds_shared[C10_WARP_SIZE];
+  __shared__ T_ACC db_shared[C10_WARP_SIZE];
   const int64_t i = blockIdx.x;
-  for (int64_t j = threadIdx.x; j < N; j += blockDim.x) {
-    const int64_t index = i * N + j;
-    const T_ACC gamma_v =
-        gamma == nullptr ? T_ACC(1) : static_cast<T_ACC>(gamma[j]);
-    dX[index] =
-        static_cast<T_ACC>(a[i]) * static_cast<T_ACC>(dY[index]) * gamma_v +
-        b[i] * static_cast<T_ACC>(X[index]) + c[i];
+  const vec_t* dY_vec = reinterpret_cast<const vec_t*>(dY + i * N);
+  const vec_t* X_vec = reinterpret_cast<const vec_t*>(X + i * N);
+  const vec_t* gamma_vec = reinterpret_cast<const vec_t*>(gamma);
+  vec_t* dX_vec = reinterpret_cast<vec_t*>(dX + i * N);
+  const int64_t num_vecs = N / kVecSize;
+
+  T_ACC sum1 = 0;
+  T_ACC sum2 = 0;
+  for (int64_t j = threadIdx.x; j < num_vecs; j += blockDim.x) {
+    const vec_t dy = dY_vec[j];
+    const vec_t x = X_vec[j];
+    vec_t gamma_v;
+    if (gamma != nullptr) {
+      gamma_v = gamma_vec[j];
+    }
+#pragma unroll
+    for (int k = 0; k < kVecSize; ++k) {
+      const T_ACC dy_g = static_cast<T_ACC>(dy.val[k]) *
+          (gamma == nullptr ? T_ACC(1) : static_cast<T_ACC>(gamma_v.val[k]));
+      sum1 += dy_g * static_cast<T_ACC>(x.val[k]);
+      sum2 += dy_g;
+    }
+  }
+  sum1 = BlockReduceSum<T_ACC>(sum1, ds_shared);
+  sum2 = BlockReduceSum<T_ACC>(sum2, db_shared);
+  __syncthreads();
+  if (threadIdx.x == 0) {
+    ds_shared[0] = sum1;
+    db_shared[0] = sum2;
+  }
+  __syncthreads();
+
+  const T_ACC ds = ds_shared[0];
+  const T_ACC db = db_shared[0];
+  const T_ACC s = T_ACC(1) / static_cast<T_ACC>(N);
+  const T_ACC mean_v = static_cast<T_ACC>(mean[i]);
+  const T_ACC rstd_v = static_cast<T_ACC>(rstd[i]);
+  const T_ACC c1 = (db * mean_v - ds) * rstd_v * rstd_v * rstd_v * s;
+  const T_ACC c2 = -(c1 * mean_v + db * rstd_v * s);
+  for (int64_t j = threadIdx.x; j < num_vecs; j += blockDim.x) {
+    const vec_t dy = dY_vec[j];
+    const vec_t x = X_vec[j];
+    vec_t gamma_v;
+    if (gamma != nullptr) {
+      gamma_v = gamma_vec[j];
+    }
+    vec_t dx;
+#pragma unroll
+    for (int k = 0; k < kVecSize; ++k) {
+      const T_ACC g =
+          gamma == nullptr ? T_ACC(1) : static_cast<T_ACC>(gamma_v.val[k]);
+      dx.val[k] = rstd_v * static_cast<T_ACC>(dy.val[k]) * g +
+          c1 * static_cast<T_ACC>(x.val[k]) + c2;
+    }
+    dX_vec[j] = dx;
   }
 }
 
@@ -279,6 +415,25 @@ __global__ void GammaBetaBackwardCUDAKernel(
   }
 }
 
+// The widest vectorized access (4, 2 or 1 elements) that the rows of N
+// elements of all of `ptrs`, nullptr being ignored, are aligned to.
+template <typename T>
+int GetVecSize(int64_t N, std::initializer_list<const T*> ptrs) {
+  int vec_size = 4;
+  for (const T* ptr : ptrs) {
+    if (ptr != nullptr) {
+      vec_size = std::min(
+          vec_size,
+          memory::can_vectorize_up_to<T>(
+              reinterpret_cast<char*>(const_cast<T*>(ptr))));
+    }
+  }
+  while (N % vec_size != 0) {
+    vec_size /= 2;
+  }
+  return vec_size;
+}
+
 template <typename T>
 void LayerNormKernelImplInternal(
     const Tensor& X,
@@ -300,11 +455,37 @@ void LayerNormKernelImplInternal(
   T* mean_data = mean->data_ptr<T>();
   T* rstd_data = rstd->data_ptr<T>();
   cudaStream_t cuda_stream = at::cuda::getCurrentCUDAStream();
-  RowwiseMomentsCUDAKernel<T>
-      <<<M, kCUDABlockReduceNumThreads, 0, cuda_stream>>>(
-          N, eps, X_data, mean_data, rstd_data);
-  LayerNormForwardCUDAKernel<T><<<M, kCUDANumThreads, 0, cuda_stream>>>(
-      N, X_data, mean_data, rstd_data, gamma_data, beta_data, Y_data);
+  if (N > 0 && N <= kFusedMaxRowSize) {
+    using T_ACC = acc_type<T, true>;
+    const int vec_size = GetVecSize<T>(N, {X_data, gamma_data, beta_data, Y_data});
+    // Enough warps for every thread to have at least one vector of the row.
+    const int64_t num_threads = std::min<int64_t>(
+        kCUDANumThreads,
+        (N / vec_size + C10_WARP_SIZE - 1) / C10_WARP_SIZE * C10_WARP_SIZE);
+#define LAUNCH_LAYER_NORM_FORWARD_FUSED(VEC)                          \
+    LayerNormForwardFusedCUDAKernel<T, VEC>                           \
+        <<<M, num_threads, 0, cuda_stream>>>(                         \
+            N, static_cast<T_ACC>(eps), X_data, gamma_data,           \
+            beta_data, Y_data, mean_data, rstd_data)
+    switch (vec_size) {
+      case 4:
+        LAUNCH_LAYER_NORM_FORWARD_FUSED(4);
+        break;
+      case 2:
+        LAUNCH_LAYER_NORM_FORWARD_FUSED(2);
+        break;
+      default:
+        LAUNCH_LAYER_NORM_FORWARD_FUSED(1);
+        break;
+    }
+#undef LAUNCH_LAYER_NORM_FORWARD_FUSED
+  } else {
+    RowwiseMomentsCUDAKernel<T>
+        <<<M, kCUDABlockReduceNumThreads, 0, cuda_stream>>>(
+            N, eps, X_data, mean_data, rstd_data);
+    LayerNormForwardCUDAKernel<T><<<M, kCUDANumThreads, 0, cuda_stream>>>(
+        N, X_data, mean_data, rstd_data, gamma_data, beta_data, Y_data);
+  }
   AT_CUDA_CHECK(cudaGetLastError());
 }
 
@@ -339,7 +520,6 @@ void LayerNormBackwardKernelImplInternal(
     Tensor* dX,
     Tensor* dgamma,
     Tensor* dbeta) {
-  using T_ACC = acc_type<T, true>;
   DCHECK_EQ(dY.numel(), M * N);
   DCHECK_EQ(X.numel(), M * N);
   DCHECK_EQ(mean.numel(), M);
@@ -354,38 +534,23 @@ void LayerNormBackwardKernelImplInternal(
   T* dX_data = dX->defined() ? dX->template data_ptr<T>() : nullptr;
   cudaStream_t cuda_stream = at::cuda::getCurrentCUDAStream();
   if (dX_data != nullptr) {
-    const auto kAccType = (X.scalar_type() == kHalf || X.scalar_type() == kBFloat16) ? kFloat : X.scalar_type();
-    Tensor ds = at::empty({M}, X.options().dtype(kAccType));
-    Tensor db = at::empty({M}, X.options().dtype(kAccType));
-    Tensor scale = at::empty({M}, X.options().dtype(kAccType));
-    Tensor bias = at::empty({M}, X.options().dtype(kAccType));
-    T_ACC* ds_data = ds.template data_ptr<T_ACC>();
-    T_ACC* db_data = db.template data_ptr<T_ACC>();
-    T_ACC* scale_data = scale.template data_ptr<T_ACC>();
-    T_ACC* bias_data = bias.template data_ptr<T_ACC>();
-    ComputeInternalGradientsCUDAKernel<T>
-        <<<M, kCUDABlockReduceNumThreads, 0, cuda_stream>>>(
-            N, dY_data, X_data, gamma_data, ds_data, db_data);
-    const int64_t B = (M + kCUDANumThreads - 1) / kCUDANumThreads;
-    ComputeGradientFusedParamsCUDAKernel<T>
-        <<<B, kCUDANumThreads, 0, cuda_stream>>>(
-            M,
-            N,
-            mean_data,
-            rstd_data,
-            ds_data,
-            db_data,
-            scale_data,
-            bias_data);
-    LayerNormBackwardCUDAKenrel<T><<<M, kCUDANumThreads, 0, cuda_stream>>>(
-        N,
-        dY_data,
-        X_data,
-        gamma_data,
-        rstd_data,
-        scale_data,
-        bias_data,
-        dX_data);
+    const int vec_size = GetVecSize<T>(N, {dY_data, X_data, gamma_data, dX_data});
+#define LAUNCH_LAYER_NORM_BACKWARD_FUSED(VEC)                           \
+    LayerNormBackwardFusedCUDAKernel<T, VEC>                            \
+        <<<M, kCUDABlockReduceNumThreads, 0, cuda_stream>>>(            \
+            N, dY_data, X_data, mean_data, rstd_data, gamma_data, dX_data)
+    switch (vec_size) {
+      case 4:
+        LAUNCH_LAYER_NORM_BACKWARD_FUSED(4);
+        break;
+      case 2:
+        LAUNCH_LAYER_NORM_BACKWARD_FUSED(2);
+        break;
+      default:
+        LAUNCH_LAYER_NORM_BACKWARD_FUSED(1);
+        break;
+    }
+#undef LAUNCH_LAYER_NORM_BACKWARD_FUSED
   }
   if (dgamma->defined() || dbeta->defined()) {
     T* dgamma_data =
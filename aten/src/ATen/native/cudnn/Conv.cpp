@@ -76,6 +76,8 @@ std::tuple<at::Tensor,at::Tensor> cudnn_convolution_transpose_backward(
 
 #include <THC/THC.h>
 
+#include <ATen/cuda/CUDAContext.h>
+
 #include <ATen/cudnn/cudnn-wrapper.h>
 #include <ATen/cudnn/Descriptors.h>
 #include <ATen/cudnn/Types.h>
@@ -84,6 +86,8 @@ std::tuple<at::Tensor,at::Tensor> cudnn_convolution_transpose_backward(
 
 #include <ATen/TensorUtils.h>
 
+#include <cstdlib>
+#include <fstream>
 #include <functional>
 #include <iterator>
 #include <sstream>
@@ -272,14 +276,90 @@ struct ConvolutionArgs {
 //
 // ---------------------------------------------------------------------
 
+// Benchmark results can be persisted to the file named by
+// PYTORCH_CUDNN_BENCHMARK_CACHE, so that new processes don't have to search
+// the algorithms of every convolution again. Every result found with
+// benchmark=True is appended to the file as one line:
+//
+//     <search> <device> <params> <algo> <mathType> <memory>
+//
+// where <device> identifies the GPU model and the cuDNN version the search was
+// run with, and <params> is the hex dump of the ConvolutionParams. The file is
+// read when a cache is first used, keeping the lines of the current device;
+// later lines override the earlier ones.  Lines are appended in a single
+// write, so workers running concurrently may share a file, and the results
+// of all of them are merged the next time the file is read.  A cache can be
+// precomputed for a model by running it once with benchmark=True and the
+// variable set, and then shipping the file.
+//
+// NB: ConvolutionParams doesn't include the device, so the in-memory cache is
+// shared by all devices of a process. The file is keyed by the GPU model
+// rather than the device index. Every line is written with the model of the
+// device that ran the search, and lines are loaded for the model of the device
+// that is current when the cache is first used.
+
+static const char* benchmarkCachePath() {
+  static const char* path = std::getenv("PYTORCH_CUDNN_BENCHMARK_CACHE");
+  return path;
+}
+
+static std::string benchmarkCacheDeviceKey() {
+  cudaDeviceProp* prop = at::cuda::getCurrentDeviceProperties();
+  std::string name = prop->name;
+  std::replace(name.begin(), name.end(), ' ', '_');
+  std::ostringstream key;
+  key << name << ":sm" << prop->major << prop->minor << ":cudnn" << cudnnGetVersion();
+  return key.str();
+}
+
+static std::string paramsToHex(const ConvolutionParams& params) {
+  static const char* digits = "0123456789abcdef";
+  auto bytes = reinterpret_cast<const uint8_t*>(&params);
+  std::string hex;
+  hex.reserve(2 * sizeof(ConvolutionParams));
+  for (size_t i = 0; i < sizeof(ConvolutionParams); ++i) {
+    hex.push_back(digits[bytes[i] >> 4]);
+    hex.push_back(digits[bytes[i] & 0xf]);
+  }
+  return hex;
+}
+
+static bool paramsFromHex(const std::string& hex, ConvolutionParams* params) {
+  if (hex.size() != 2 * sizeof(ConvolutionParams)) {
+    return false;
+  }
+  auto bytes = reinterpret_cast<uint8_t*>(params);
+  for (size_t i = 0; i < sizeof(ConvolutionParams); ++i) {
+    int value = 0;
+    for (char c : {hex[2 * i], hex[2 * i + 1]}) {
+      value <<= 4;
+      if (c >= '0' && c <= '9') {
+        value |= c - '0';
+      } else if (c >= 'a' && c <= 'f') {
+        value |= c - 'a' + 10;
+      } else {
+        return false;
+      }
+    }
+    bytes[i] = static_cast<uint8_t>(value);
+  }
+  return true;
+}
+
 // TODO: Use something less heavy duty than a big honking mutex
 template <typename T>
 struct BenchmarkCache {
   std::mutex mutex;
   std::unordered_map<ConvolutionParams, T, ParamsHash<ConvolutionParams>, ParamsEqual<ConvolutionParams>> map;
+  // Names the search in the persistent cache file
+  const char* search_name;
+  bool loaded = false;
+
+  explicit BenchmarkCache(const char* search_name) : search_name(search_name) {}
 
   bool find(const ConvolutionParams& params, T* results) {
     std::lock_guard<std::mutex> guard(mutex);
+    load();
     auto it = map.find(params);
     if (it == map.end()) {
       return false;
@@ -288,15 +368,63 @@ struct BenchmarkCache {
     return true;
   }
 
-  void insert(const ConvolutionParams& params, const T& results) {
+  // Results of benchmarking are also persisted when a cache file is set.
+  void insert(const ConvolutionParams& params, const T& results, bool benchmarked) {
     std::lock_guard<std::mutex> guard(mutex);
     map[params] = results;
+    if (benchmarked && benchmarkCachePath() != nullptr) {
+      load();
+      std::ostringstream line;
+      line << search_name << " " << benchmarkCacheDeviceKey() << " " << paramsToHex(params) << " "
+           << static_cast<int>(results.algo) << " " << static_cast<int>(results.mathType)
+           << " " << results.memory << "\n";
+      std::ofstream file(benchmarkCachePath(), std::ios::app);
+      file << line.str() << std::flush;
+      if (!file) {
+        TORCH_WARN_ONCE("Unable to write to the cuDNN benchmark cache ", benchmarkCachePath());
+      }
+    }
+  }
+
+ private:
+  // Reads the persisted results of this search for the current device, while
+  // keeping the ones already in memory. Must be called with the mutex held.
+  void load() {
+    if (loaded || benchmarkCachePath() == nullptr) {
+      return;
+    }
+    loaded = true;
+    const auto device_key = benchmarkCacheDeviceKey();
+    std::ifstream file(benchmarkCachePath());
+    std::unordered_map<ConvolutionParams, T, ParamsHash<ConvolutionParams>, ParamsEqual<ConvolutionParams>> persisted;
+    std::string line;
+    while (std::getline(file, line)) {
+      std::istringstream fields(line);
+      std::string search, device, hex;
+      int algo, mathType;
+      size_t memory;
+      ConvolutionParams params;
+      if (!(fields >> search >> device >> hex >> algo >> mathType >> memory) ||
+          search != search_name || device != device_key || !paramsFromHex(hex, &params)) {
+        continue;
+      }
+      T results;
+      memset(&results, 0, sizeof(T));
+      results.algo = static_cast<decltype(results.algo)>(algo);
+      results.status = CUDNN_STATUS_SUCCESS;
+      results.mathType = static_cast<cudnnMathType_t>(mathType);
+      results.memory = memory;
+      persisted[params] = results;
+    }
+    for (auto& entry : persisted) {
+      map.emplace(entry.first, entry.second);
+    }
   }
 };
 
-BenchmarkCache<cudnnConvolutionFwdAlgoPerf_t> fwd_algos;
-BenchmarkCache<cudnnConvolutionBwdDataAlgoPerf_t> bwd_data_algos;
-BenchmarkCache<cudnnConvolutionBwdFilterAlgoPerf_t> bwd_filter_algos;
+BenchmarkCache<cudnnConvolutionFwdAlgoPerf_t> fwd_algos("fwd");
+BenchmarkCache<cudnnConvolutionBwdDataAlgoPerf_t> bwd_data_algos("bwd_data");
+BenchmarkCache<cudnnConvolutionBwdFilterAlgoPerf_t> bwd_filter_algos("bwd_filter");
 
 // TODO: Stop manually allocating CUDA memory; allocate an ATen byte
 // tensor instead.
@@ -681,7 +809,7 @@ public:
     for (auto &algoPerf : perfResults) {
       try {
         f(algoPerf);
-        cache.insert(args.params, algoPerf);
+        cache.insert(args.params, algoPerf, benchmark);
         return;
       } catch (c10::CUDAOutOfMemoryError &e) {
         cudaGetLastError(); // clear CUDA error
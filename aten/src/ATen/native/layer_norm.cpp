@@ -11,6 +11,7 @@
 #include <ATen/CPUApplyUtils.h>
 #include <ATen/Config.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/NestedTensorUtils.h>
 #include <ATen/Parallel.h>
 #include <torch/library.h>
 
@@ -130,6 +131,15 @@ Tensor layer_norm(
     const Tensor& bias /* optional */,
     double eps,
     bool /* cudnn_enable, deprecated */) {
+  if (input.is_nested()) {
+    // The normalized dims are inner dims, so every row of the buffer is
+    // normalized on its own.
+    TORCH_CHECK(static_cast<int64_t>(normalized_shape.size()) <= input.dim() - 2,
+        "layer_norm(): a nested tensor of size ", input.sizes(),
+        " can only be normalized over its inner dims, but got normalized_shape ", normalized_shape);
+    return at::nested::nested_like(input, at::layer_norm(
+        at::nested::get_nested_impl(input)->buffer(), normalized_shape, weight, bias, eps));
+  }
 
   auto inputs = _prepare_layer_norm_inputs(input, normalized_shape, weight, bias);
   auto X = std::get<0>(inputs);
@@ -30,19 +30,30 @@ Tensor mkldnn_linear(
     const Tensor& bias) {
   TORCH_CHECK(self.dim() >= 2,
       "mkldnn_linear: input needs to has dim at least 2, input dim ", self.dim());
-  TORCH_CHECK(self.is_mkldnn(),
-      "mkldnn_linear: input needs to be mkldnn layout");
-  TORCH_CHECK(weight.is_mkldnn() && bias.is_mkldnn(),
-      "mkldnn_linear: weight and bias need to be mkldnn layout");
+  // Either all the tensors are in the mkldnn layout, or they are all dense
+  // contiguous tensors, which at::linear passes for bfloat16 inference.
+  const bool is_mkldnn = self.is_mkldnn();
+  if (is_mkldnn) {
+    TORCH_CHECK(weight.is_mkldnn() && (!bias.defined() || bias.is_mkldnn()),
+        "mkldnn_linear: weight and bias need to be mkldnn layout");
+  } else {
+    TORCH_CHECK(self.is_contiguous() && weight.is_contiguous() &&
+        (!bias.defined() || bias.is_contiguous()),
+        "mkldnn_linear: the dense input, weight and bias need to be contiguous");
+  }
+  const auto get_mkldnn_tensor = [is_mkldnn](const Tensor& tensor) {
+    return is_mkldnn ? itensor_from_mkldnn(tensor)
+                     : itensor_view_from_dense(tensor);
+  };
 
   // reshape first if input dim is greater than 2 and the reshape will cost a memory copy.
   auto self_reshaped = self.dim() > 2 ? self.reshape({-1, self.size(self.dim() - 1)}) : self;
-  const ideep::tensor x = itensor_from_mkldnn(self_reshaped);
-  const ideep::tensor w = itensor_from_mkldnn(weight);
+  const ideep::tensor x = get_mkldnn_tensor(self_reshaped);
+  const ideep::tensor w = get_mkldnn_tensor(weight);
 
   ideep::tensor y;
   if (bias.defined()) {
-    const ideep::tensor b = itensor_from_mkldnn(bias);
+    const ideep::tensor b = get_mkldnn_tensor(bias);
     ideep::inner_product_forward::compute(x, w, b, y);
   } else {
     ideep::inner_product_forward::compute(x, w, y);
@@ -52,10 +63,14 @@ Tensor mkldnn_linear(
   std::vector<int64_t> output_size(input_size.begin(), input_size.end() - 1);
   output_size.push_back(weight.size(0));
 
+  Tensor output = new_with_itensor_mkldnn(std::move(y), self.options());
+  if (!is_mkldnn) {
+    output = mkldnn_to_dense(output);
+  }
   if (self.dim() > 2) {
-    return new_with_itensor_mkldnn(std::move(y), self.options()).reshape(output_size);
+    return output.reshape(output_size);
   }
-  return new_with_itensor_mkldnn(std::move(y), self.options());
+  return output;
 }
 
 } // namespace native
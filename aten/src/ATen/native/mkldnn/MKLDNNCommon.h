@@ -8,6 +8,9 @@
 
 namespace at { namespace native {
 
+// Mapping ScalarType to ideep tensor data_type
+ideep::tensor::data_type get_mkldnn_dtype(ScalarType type);
+
 // Construct aten MKL-DNN tensor given an ideep tensor
 Tensor new_with_itensor_mkldnn(ideep::tensor&& it, const TensorOptions& options);
 
@@ -14,7 +14,7 @@ Tensor empty_mkldnn(IntArrayRef sizes, const TensorOptions& options, c10::option
   // NOTE: int32_t dims from ideep::tensor but sizes needs int64_t
   // TODO: support int64_t dims in ideep::tensor to avoid extra conversion
   ideep::tensor::dims dst_dims (sizes.begin(), sizes.end());
-  ideep::tensor it {dst_dims, ideep::tensor::data_type::f32};
+  ideep::tensor it {dst_dims, get_mkldnn_dtype(typeMetaToScalarType(options.dtype()))};
   return new_with_itensor_mkldnn(std::move(it), options);
 }
 
@@ -1,6 +1,8 @@
 #include <ATen/native/mkldnn/Utils.h>
 #include <ATen/native/Pool.h>
 
+#include <cpuinfo.h>
+
 namespace at { namespace native {
 
 std::vector<int64_t> pool_output_sizes(
@@ -31,4 +33,15 @@ std::vector<int64_t> pool_output_sizes(
    return output_size;
 }
 
+bool mkldnn_bf16_device_check() {
+#if defined(__powerpc__) || defined(__s390x__)
+  return false;
+#else
+  static const bool supported = cpuinfo_initialize() &&
+      cpuinfo_has_x86_avx512f() && cpuinfo_has_x86_avx512bw() &&
+      cpuinfo_has_x86_avx512vl() && cpuinfo_has_x86_avx512dq();
+  return supported;
+#endif
+}
+
 }}
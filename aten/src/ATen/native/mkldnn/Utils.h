@@ -13,4 +13,10 @@ std::vector<int64_t> pool_output_sizes(
     IntArrayRef padding_r,
     IntArrayRef dilation,
     bool ceil_mode);
+
+// Whether the CPU runs the bfloat16 primitives of MKL-DNN, which need the
+// AVX512 (avx512f, avx512bw, avx512vl and avx512dq) instructions. MKL-DNN
+// uses the VDPBF16PS dot products on the CPUs with AVX512-BF16, such as
+// Cooper Lake, and emulates them with float FMAs otherwise.
+bool mkldnn_bf16_device_check();
 }}
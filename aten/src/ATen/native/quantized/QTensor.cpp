@@ -224,5 +224,154 @@ std::tuple<double, int64_t> _choose_qparams_per_tensor(
   return std::make_tuple(q_params.scale, q_params.zero_point);
 }
 
+namespace {
+
+// The L2 norm of the values uniformly distributed with density between
+// delta_begin and delta_end: density * (delta_end^3 - delta_begin^3) / 3
+inline double histogram_l2_norm(
+    double delta_begin,
+    double delta_end,
+    double density) {
+  return density *
+      (delta_end * delta_end * delta_end -
+       delta_begin * delta_begin * delta_begin) /
+      3;
+}
+
+// The quantization error of the histogram if the range from start_bin to
+// end_bin is quantized into dst_nbins bins
+double histogram_l2_error(
+    const double* histogram,
+    int64_t bins,
+    double bin_width,
+    int64_t start_bin,
+    int64_t end_bin,
+    int64_t dst_nbins) {
+  const double dst_bin_width =
+      bin_width * (end_bin - start_bin + 1) / dst_nbins;
+  if (dst_bin_width == 0.0) {
+    return 0.0;
+  }
+  double norm = 0.0;
+  for (int64_t src_bin = 0; src_bin < bins; ++src_bin) {
+    if (histogram[src_bin] == 0) {
+      continue;
+    }
+    // distances from the beginning of the first dst bin to the beginning and
+    // the end of src_bin
+    const double src_bin_begin = (src_bin - start_bin) * bin_width;
+    const double src_bin_end = src_bin_begin + bin_width;
+
+    // the dst bins the beginning and the end of src_bin belong to
+    const double dst_bin_of_begin = std::min<double>(
+        dst_nbins - 1, std::max(0.0, std::floor(src_bin_begin / dst_bin_width)));
+    const double dst_bin_of_end = std::min<double>(
+        dst_nbins - 1, std::max(0.0, std::floor(src_bin_end / dst_bin_width)));
+    const double dst_bin_of_begin_center =
+        dst_bin_of_begin * dst_bin_width + dst_bin_width / 2;
+
+    const double density = histogram[src_bin] / bin_width;
+    if (dst_bin_of_begin == dst_bin_of_end) {
+      // src_bin is entirely within one dst bin
+      norm += histogram_l2_norm(
+          src_bin_begin - dst_bin_of_begin_center,
+          src_bin_end - dst_bin_of_begin_center,
+          density);
+    } else {
+      norm += histogram_l2_norm(
+          src_bin_begin - dst_bin_of_begin_center,
+          dst_bin_width / 2,
+          density);
+      norm += (dst_bin_of_end - dst_bin_of_begin - 1) *
+          histogram_l2_norm(-dst_bin_width / 2, dst_bin_width / 2, density);
+      const double dst_bin_of_end_center =
+          dst_bin_of_end * dst_bin_width + dst_bin_width / 2;
+      norm += histogram_l2_norm(
+          -dst_bin_width / 2, src_bin_end - dst_bin_of_end_center, density);
+    }
+  }
+  return norm;
+}
+
+} // namespace
+
+/*
+ * Searches the range of the histogram of the values from min to max which,
+ * quantized into dst_nbins bins, approximately minimizes the L2 quantization
+ * error, clipping the outliers. The range is narrowed from the side with the
+ * fewest values in steps of 1e-5 of the quantiles, for as long as the error
+ * decreases. This follows NormMinimization::NonlinearQuantizationParamsSearch
+ * of caffe2/quantization/server/norm_minimization.cc.
+ */
+std::tuple<double, double> _histogram_l2_range_search(
+    const Tensor& histogram,
+    double min,
+    double max,
+    int64_t dst_nbins) {
+  TORCH_CHECK(
+      histogram.dim() == 1 && histogram.numel() > 0,
+      "_histogram_l2_range_search: expected a non-empty 1-d histogram");
+  TORCH_CHECK(
+      dst_nbins > 0, "_histogram_l2_range_search: dst_nbins must be > 0");
+  const Tensor hist = histogram.to(kCPU, kDouble).contiguous();
+  const double* hist_p = hist.data_ptr<double>();
+  const int64_t bins = hist.numel();
+  const double bin_width = (max - min) / bins;
+
+  std::vector<double> c_sum(bins);
+  double total = 0.0;
+  for (int64_t i = 0; i < bins; ++i) {
+    total += hist_p[i];
+    c_sum[i] = total;
+  }
+
+  const double stepsize = 1e-5;
+  double alpha = 0.0; // lower bound
+  double beta = 1.0; // upper bound
+  int64_t start_bin = 0;
+  int64_t end_bin = bins - 1;
+  double norm_min = std::numeric_limits<double>::infinity();
+
+  while (alpha < beta) {
+    const double next_alpha = alpha + stepsize;
+    const double next_beta = beta - stepsize;
+
+    // the left and right bins between the quantile bounds
+    int64_t l = start_bin;
+    int64_t r = end_bin;
+    while (l < end_bin && c_sum[l] < next_alpha * total) {
+      ++l;
+    }
+    while (r > start_bin && c_sum[r] > next_beta * total) {
+      --r;
+    }
+
+    int64_t next_start_bin = start_bin;
+    int64_t next_end_bin = end_bin;
+    if ((l - start_bin) > (end_bin - r)) {
+      next_start_bin = l;
+      alpha = next_alpha;
+    } else {
+      next_end_bin = r;
+      beta = next_beta;
+    }
+    if (next_start_bin == start_bin && next_end_bin == end_bin) {
+      continue;
+    }
+
+    const double norm = histogram_l2_error(
+        hist_p, bins, bin_width, next_start_bin, next_end_bin, dst_nbins);
+    if (norm > norm_min) {
+      break;
+    }
+    norm_min = norm;
+    start_bin = next_start_bin;
+    end_bin = next_end_bin;
+  }
+
+  return std::make_tuple(
+      min + bin_width * start_bin, min + bin_width * (end_bin + 1));
+}
+
 } // namespace native
 } // namespace at
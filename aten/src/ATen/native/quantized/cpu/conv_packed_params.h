@@ -13,6 +13,18 @@ struct ConvPackedParamsBase : public torch::jit::CustomClassHolder {
       const at::Tensor& input,
       double output_scale,
       int64_t output_zero_point) = 0;
+  // Convolution of input plus accum (of the shape of the output), (ReLU and)
+  // requantization of the sum in one pass, as in residual blocks.
+  virtual at::Tensor apply_add(
+      const at::Tensor& input,
+      const at::Tensor& accum,
+      double output_scale,
+      int64_t output_zero_point) = 0;
+  virtual at::Tensor apply_add_relu(
+      const at::Tensor& input,
+      const at::Tensor& accum,
+      double output_scale,
+      int64_t output_zero_point) = 0;
 
   virtual std::tuple<at::Tensor, c10::optional<at::Tensor>> unpack() = 0;
 
@@ -7,6 +7,8 @@
 
 #include <ATen/Tensor.h>
 #include <ATen/native/quantized/cpu/conv_packed_params.h>
+#include <ATen/native/quantized/cpu/qlinear_sparse.h>
+#include <ATen/native/quantized/cpu/quant_utils.h>
 #include <c10/core/QScheme.h>
 
 
@@ -26,6 +28,11 @@ struct CAFFE2_API PackedLinearWeight {
   std::vector<float> w_scale;
   std::vector<int32_t> w_zp;
   c10::QScheme q_scheme;
+  // See quantized::linear_dynamic_cached_range
+  std::unique_ptr<quant_utils::InputRangeCache> input_range =
+      std::make_unique<quant_utils::InputRangeCache>();
+  // Set instead of w for the pruned weights, see BlockSparseLinearWeight.
+  std::unique_ptr<at::native::BlockSparseLinearWeight> sparse;
 };
 
 struct CAFFE2_API PackedLinearWeightFp16 {
@@ -81,6 +88,18 @@ struct CAFFE2_API PackedConvWeight : public ConvPackedParamsBase<kSpatialDim> {
       double output_scale,
       int64_t output_zero_point) override;
 
+  at::Tensor apply_add(
+      const at::Tensor& input,
+      const at::Tensor& accum,
+      double output_scale,
+      int64_t output_zero_point) override;
+
+  at::Tensor apply_add_relu(
+      const at::Tensor& input,
+      const at::Tensor& accum,
+      double output_scale,
+      int64_t output_zero_point) override;
+
   std::tuple<at::Tensor, c10::optional<at::Tensor>> unpack() override;
 
   static c10::intrusive_ptr<ConvPackedParamsBase<kSpatialDim>> prepack(
@@ -121,6 +140,13 @@ struct CAFFE2_API PackedConvWeight : public ConvPackedParamsBase<kSpatialDim> {
       const at::Tensor& input,
       double output_scale,
       int64_t output_zero_point);
+
+  template <bool ReluFused>
+  at::Tensor apply_add_impl(
+      const at::Tensor& input,
+      const at::Tensor& accum,
+      double output_scale,
+      int64_t output_zero_point);
 };
 
 // PackWeight: Convert the weight from uint8 to int8.
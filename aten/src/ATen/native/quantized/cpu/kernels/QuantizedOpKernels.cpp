@@ -1875,20 +1875,51 @@ void fake_quantize_grad_tensor_kernel(
   });
 }
 
+// The per channel fake quantization loops over the iterator built by
+// fake_quantize_per_channel_affine(_backward), whose scale and zero point
+// operands are broadcast along the axis. In the common case of an axis other
+// than the innermost one, they are constant over each inner loop, which is
+// vectorized with the channel's parameters.
 void fake_quant_per_channel_cpu(
     TensorIterator& iter,
     int64_t quant_min,
     int64_t quant_max) {
-  cpu_kernel(iter, [=](float self, float scale, int64_t zero_point) -> float {
-    float inv_scale = 1.0f / scale;
-    return (std::fmin(
-                std::fmax(
-                    static_cast<int64_t>(
-                        zero_point + std::nearbyint(self * inv_scale)),
-                    quant_min),
-                quant_max) -
-            zero_point) *
-        scale;
+  iter.for_each([&](char** data, const int64_t* strides, int64_t n) {
+    int64_t i = 0;
+    if (strides[2] == 0 && strides[3] == 0 && strides[0] == sizeof(float) &&
+        strides[1] == sizeof(float)) {
+      float* out = reinterpret_cast<float*>(data[0]);
+      const float* self = reinterpret_cast<const float*>(data[1]);
+      const float scale = *reinterpret_cast<float*>(data[2]);
+      const float zero_point = *reinterpret_cast<int64_t*>(data[3]);
+      const Vec256<float> scale_vec(scale);
+      const Vec256<float> inv_scale_vec(1.0f / scale);
+      const Vec256<float> zero_point_vec(zero_point);
+      const Vec256<float> quant_min_vec(quant_min);
+      const Vec256<float> quant_max_vec(quant_max);
+      for (; i + Vec256<float>::size() <= n; i += Vec256<float>::size()) {
+        auto xq = (Vec256<float>::loadu(self + i) * inv_scale_vec).round() +
+            zero_point_vec;
+        xq = vec256::minimum(vec256::maximum(xq, quant_min_vec), quant_max_vec);
+        ((xq - zero_point_vec) * scale_vec).store(out + i);
+      }
+    }
+    for (; i < n; ++i) {
+      const float self = *reinterpret_cast<float*>(data[1] + i * strides[1]);
+      const float scale = *reinterpret_cast<float*>(data[2] + i * strides[2]);
+      const int64_t zero_point =
+          *reinterpret_cast<int64_t*>(data[3] + i * strides[3]);
+      const float inv_scale = 1.0f / scale;
+      *reinterpret_cast<float*>(data[0] + i * strides[0]) =
+          (std::fmin(
+               std::fmax(
+                   static_cast<int64_t>(
+                       zero_point + std::nearbyint(self * inv_scale)),
+                   quant_min),
+               quant_max) -
+           zero_point) *
+          scale;
+    }
   });
 }
 
@@ -1896,13 +1927,41 @@ void fake_quant_grad_per_channel_cpu(
     TensorIterator& iter,
     int64_t quant_min,
     int64_t quant_max) {
-  cpu_kernel(
-      iter, [=](float x, float dy, float scale, int64_t zero_point) -> float {
-        float inv_scale = 1.0f / scale;
-        int64_t xq =
-            static_cast<int64_t>(zero_point + std::nearbyint(x * inv_scale));
-        return dy * (xq >= quant_min && xq <= quant_max);
-      });
+  iter.for_each([&](char** data, const int64_t* strides, int64_t n) {
+    int64_t i = 0;
+    if (strides[3] == 0 && strides[4] == 0 && strides[0] == sizeof(float) &&
+        strides[1] == sizeof(float) && strides[2] == sizeof(float)) {
+      float* dx = reinterpret_cast<float*>(data[0]);
+      const float* x = reinterpret_cast<const float*>(data[1]);
+      const float* dy = reinterpret_cast<const float*>(data[2]);
+      const float scale = *reinterpret_cast<float*>(data[3]);
+      const float zero_point = *reinterpret_cast<int64_t*>(data[4]);
+      const Vec256<float> inv_scale_vec(1.0f / scale);
+      const Vec256<float> zero_point_vec(zero_point);
+      const Vec256<float> quant_min_vec(quant_min);
+      const Vec256<float> quant_max_vec(quant_max);
+      const Vec256<float> zero_vec(0.0f);
+      for (; i + Vec256<float>::size() <= n; i += Vec256<float>::size()) {
+        const auto xq = (Vec256<float>::loadu(x + i) * inv_scale_vec).round() +
+            zero_point_vec;
+        const auto mask = (xq >= quant_min_vec) & (xq <= quant_max_vec);
+        Vec256<float>::blendv(zero_vec, Vec256<float>::loadu(dy + i), mask)
+            .store(dx + i);
+      }
+    }
+    for (; i < n; ++i) {
+      const float x = *reinterpret_cast<float*>(data[1] + i * strides[1]);
+      const float dy = *reinterpret_cast<float*>(data[2] + i * strides[2]);
+      const float scale = *reinterpret_cast<float*>(data[3] + i * strides[3]);
+      const int64_t zero_point =
+          *reinterpret_cast<int64_t*>(data[4] + i * strides[4]);
+      const float inv_scale = 1.0f / scale;
+      const int64_t xq =
+          static_cast<int64_t>(zero_point + std::nearbyint(x * inv_scale));
+      *reinterpret_cast<float*>(data[0] + i * strides[0]) =
+          dy * (xq >= quant_min && xq <= quant_max);
+    }
+  });
 }
 
 template <typename T>
@@ -2201,7 +2260,9 @@ void dequantize_tensor_per_tensor_affine_cpu(
 }
 #endif // USE_FBGEMM
 
-// TODO: add fbgemm for per channel
+// The elements of a channel of a batch are contiguous: each of these blocks is
+// (de)quantized with the parameters of its channel, vectorized, and the blocks
+// are spread over the threads.
 void quantize_tensor_per_channel_affine_cpu(
     Tensor rtensor,
     Tensor qtensor,
@@ -2210,6 +2271,7 @@ void quantize_tensor_per_channel_affine_cpu(
     int64_t axis) {
   AT_DISPATCH_QINT_TYPES(
       qtensor.scalar_type(), "quantize_tensor_per_channel_affine_cpu", [&]() {
+        using Vec = Vec256<scalar_t>;
         int64_t batches = size_to_dim_(axis, rtensor.sizes());
         int64_t elements_per_channel =
             size_from_dim_(axis + 1, rtensor.sizes());
@@ -2218,16 +2280,33 @@ void quantize_tensor_per_channel_affine_cpu(
         auto zero_points_data = zero_points.data_ptr<int64_t>();
         const float* rdata = rtensor.data_ptr<float>();
         auto qdata = qtensor.data_ptr<scalar_t>();
-        for (auto b = 0; b < batches; ++b) {
-          for (auto c = 0; c < channel; ++c) {
-            for (auto e = 0; e < elements_per_channel; ++e) {
-              auto i = b * channel * elements_per_channel +
-                  c * elements_per_channel + e;
-              qdata[i] = quantize_val<scalar_t>(
-                  scales_data[c], zero_points_data[c], rdata[i]);
-            }
-          }
-        }
+        const int64_t grain_size = std::max<int64_t>(
+            1, internal::GRAIN_SIZE / std::max<int64_t>(elements_per_channel, 1));
+        at::parallel_for(
+            0, batches * channel, grain_size, [&](int64_t begin, int64_t end) {
+              for (int64_t bc = begin; bc < end; ++bc) {
+                const int64_t c = bc % channel;
+                const float scale = scales_data[c];
+                const int32_t zero_point = zero_points_data[c];
+                const float inv_scale = 1.0f / scale;
+                const float* src = rdata + bc * elements_per_channel;
+                scalar_t* dst = qdata + bc * elements_per_channel;
+                int64_t e = 0;
+                for (; e + Vec::size() <= elements_per_channel;
+                     e += Vec::size()) {
+                  typename Vec::float_vec_return_type float_vals;
+                  for (int i = 0; i < Vec::float_num_vecs(); ++i) {
+                    float_vals[i] = Vec256<float>::loadu(
+                        src + e + i * Vec256<float>::size());
+                  }
+                  Vec::quantize(float_vals, scale, zero_point, inv_scale)
+                      .store(dst + e);
+                }
+                for (; e < elements_per_channel; ++e) {
+                  dst[e] = quantize_val<scalar_t>(scale, zero_point, src[e]);
+                }
+              }
+            });
       });
 }
 
@@ -2239,6 +2318,7 @@ void dequantize_tensor_per_channel_affine_cpu(
     int64_t axis) {
   AT_DISPATCH_QINT_TYPES(
       qtensor.scalar_type(), "dequantize_tensor_per_channel_affine_cpu", [&]() {
+        using Vec = Vec256<scalar_t>;
         int64_t batches = size_to_dim_(axis, rtensor.sizes());
         int64_t elements_per_channel =
             size_from_dim_(axis + 1, rtensor.sizes());
@@ -2247,18 +2327,37 @@ void dequantize_tensor_per_channel_affine_cpu(
         auto zero_points_data = zero_points.data_ptr<int64_t>();
         const auto* qd = qtensor.data_ptr<scalar_t>();
         float* rd = rtensor.data_ptr<float>();
-        for (auto b = 0; b < batches; ++b) {
-          for (auto c = 0; c < channel; ++c) {
-            for (auto e = 0; e < elements_per_channel; ++e) {
-              auto i = b * channel * elements_per_channel +
-                  c * elements_per_channel + e;
-              // We need to convert the qint8 value to float to ensure the
-              // subtraction subexpression returns a float
-              rd[i] = (static_cast<float>(qd[i].val_) - zero_points_data[c]) *
-                  scales_data[c];
-            }
-          }
-        }
+        const int64_t grain_size = std::max<int64_t>(
+            1, internal::GRAIN_SIZE / std::max<int64_t>(elements_per_channel, 1));
+        at::parallel_for(
+            0, batches * channel, grain_size, [&](int64_t begin, int64_t end) {
+              for (int64_t bc = begin; bc < end; ++bc) {
+                const int64_t c = bc % channel;
+                const float scale = scales_data[c];
+                const float zero_point = zero_points_data[c];
+                const scalar_t* src = qd + bc * elements_per_channel;
+                float* dst = rd + bc * elements_per_channel;
+                const Vec256<float> scale_vec(scale);
+                const Vec256<float> zero_point_vec(zero_point);
+                const Vec256<float> scale_neg_zp_premul_vec =
+                    scale_vec * zero_point_vec.neg();
+                int64_t e = 0;
+                for (; e + Vec::size() <= elements_per_channel;
+                     e += Vec::size()) {
+                  const auto float_vals = Vec::loadu(src + e).dequantize(
+                      scale_vec, zero_point_vec, scale_neg_zp_premul_vec);
+                  for (int i = 0; i < Vec::float_num_vecs(); ++i) {
+                    float_vals[i].store(dst + e + i * Vec256<float>::size());
+                  }
+                }
+                for (; e < elements_per_channel; ++e) {
+                  // We need to convert the qint8 value to float to ensure the
+                  // subtraction subexpression returns a float
+                  dst[e] = (static_cast<float>(src[e].val_) - zero_point) *
+                      scale;
+                }
+              }
+            });
       });
 }
 
@@ -1,5 +1,7 @@
 #include <algorithm>
 #include <cmath>
+#include <limits>
+#include <tuple>
 #include <vector>
 
 #include <ATen/ATen.h>
@@ -9,6 +11,7 @@
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
 #include <ATen/native/quantized/cpu/qnnpack_utils.h>
 #include <ATen/native/quantized/cpu/conv_packed_params.h>
+#include <ATen/native/quantized/cpu/quantized_ops.h>
 #include <caffe2/utils/threadpool/ThreadPoolMobile.h>
 
 template <int kSpatialDim = 2>
@@ -48,6 +51,49 @@ bool ConvDimChecks(
   return true;
 }
 
+// The quantization of the convolution before the accumulator is added in
+// conv_add. Convolution values out of the range [out_min - accum_max,
+// out_max - accum_min] saturate the output whatever the accumulator is, so
+// they can be clamped, and that range is quantized with the scale
+// output_scale + accum_scale.
+std::pair<double, int64_t> ConvAddIntermediateQParams(
+    double output_scale,
+    int64_t output_zero_point,
+    const at::Tensor& accum) {
+  const double accum_scale = accum.q_scale();
+  const int64_t accum_zero_point = accum.q_zero_point();
+  const int64_t qmax = std::numeric_limits<uint8_t>::max();
+  const double conv_scale = output_scale + accum_scale;
+  const int64_t conv_zero_point = std::nearbyint(
+      (output_zero_point * output_scale +
+       (qmax - accum_zero_point) * accum_scale) /
+      conv_scale);
+  return {conv_scale, std::min(std::max<int64_t>(conv_zero_point, 0), qmax)};
+}
+
+template <int kSpatialDim = 2>
+void ConvAddChecks(const at::Tensor& accum, at::IntArrayRef output_sizes) {
+  TORCH_CHECK(
+      accum.scalar_type() == c10::kQUInt8,
+      "quantized::conv",
+      kSpatialDim,
+      "d_add(): Expected the accumulator to be quint8.");
+  TORCH_CHECK(
+      accum.qscheme() == c10::kPerTensorAffine,
+      "quantized::conv",
+      kSpatialDim,
+      "d_add(): Only per tensor quantization is supported for the "
+      "accumulator.");
+  TORCH_CHECK(
+      accum.sizes() == output_sizes,
+      "quantized::conv",
+      kSpatialDim,
+      "d_add(): Expected the accumulator to have the sizes of the output ",
+      output_sizes,
+      " but got ",
+      accum.sizes());
+}
+
 #ifdef USE_FBGEMM
 
 template <int kSpatialDim = 2>
@@ -187,6 +233,72 @@ at::Tensor PackedConvWeight<kSpatialDim>::apply_relu(
   return apply_impl<true>(input, output_scale, output_zero_point);
 }
 
+template <int kSpatialDim>
+at::Tensor PackedConvWeight<kSpatialDim>::apply_add(
+    const at::Tensor& input,
+    const at::Tensor& accum,
+    double output_scale,
+    int64_t output_zero_point) {
+  return apply_add_impl<false>(input, accum, output_scale, output_zero_point);
+}
+
+template <int kSpatialDim>
+at::Tensor PackedConvWeight<kSpatialDim>::apply_add_relu(
+    const at::Tensor& input,
+    const at::Tensor& accum,
+    double output_scale,
+    int64_t output_zero_point) {
+  return apply_add_impl<true>(input, accum, output_scale, output_zero_point);
+}
+
+template <int kSpatialDim>
+template <bool kReluFused>
+at::Tensor PackedConvWeight<kSpatialDim>::apply_add_impl(
+    const at::Tensor& act,
+    const at::Tensor& accum,
+    double output_scale,
+    int64_t output_zero_point) {
+  // fbgemmConv only takes ReQuantizeOutput output processors, so the
+  // convolution is requantized to the intermediate quantization, and the
+  // addition of the accumulator and the requantization of the sum are one
+  // vectorized pass over it, without dispatching a separate quantized::add.
+  const auto conv_qparams =
+      ConvAddIntermediateQParams(output_scale, output_zero_point, accum);
+  const at::Tensor conv_output =
+      apply_impl<false>(act, conv_qparams.first, conv_qparams.second);
+  ConvAddChecks<kSpatialDim>(accum, conv_output.sizes());
+
+  at::Tensor output = kSpatialDim == 2
+      ? at::_empty_affine_quantized(
+            conv_output.sizes(),
+            device(c10::kCPU)
+                .dtype(c10::kQUInt8)
+                .memory_format(c10::MemoryFormat::ChannelsLast),
+            output_scale,
+            output_zero_point,
+            c10::nullopt)
+      : at::native::fbgemm_utils::MakeEmptyAffineQuantizedChannelsLast3dTensor(
+            conv_output.size(0),
+            conv_output.size(1),
+            conv_output.size(2),
+            conv_output.size(3),
+            conv_output.size(4),
+            device(c10::kCPU).dtype(c10::kQUInt8),
+            output_scale,
+            output_zero_point);
+  // The accumulator in the layout of the output, so that the pass is over
+  // contiguous memory
+  const at::Tensor accum_nhwc = kSpatialDim == 2
+      ? accum.contiguous(c10::MemoryFormat::ChannelsLast)
+      : at::native::fbgemm_utils::ConvertToChannelsLast3dTensor(accum);
+  if (kReluFused) {
+    at::native::qadd_relu_stub(c10::kCPU, output, conv_output, accum_nhwc);
+  } else {
+    at::native::qadd_stub(c10::kCPU, output, conv_output, accum_nhwc);
+  }
+  return output;
+}
+
 template <int kSpatialDim>
 template <bool kReluFused>
 at::Tensor PackedConvWeight<kSpatialDim>::apply_impl(
@@ -438,6 +550,30 @@ template at::Tensor PackedConvWeight<3>::apply_relu(
     double output_scale,
     int64_t output_zero_point);
 
+template at::Tensor PackedConvWeight<2>::apply_add(
+    const at::Tensor& act,
+    const at::Tensor& accum,
+    double output_scale,
+    int64_t output_zero_point);
+
+template at::Tensor PackedConvWeight<2>::apply_add_relu(
+    const at::Tensor& act,
+    const at::Tensor& accum,
+    double output_scale,
+    int64_t output_zero_point);
+
+template at::Tensor PackedConvWeight<3>::apply_add(
+    const at::Tensor& act,
+    const at::Tensor& accum,
+    double output_scale,
+    int64_t output_zero_point);
+
+template at::Tensor PackedConvWeight<3>::apply_add_relu(
+    const at::Tensor& act,
+    const at::Tensor& accum,
+    double output_scale,
+    int64_t output_zero_point);
+
 #endif // USE_FBGEMM
 
 #ifdef USE_PYTORCH_QNNPACK
@@ -447,7 +583,8 @@ at::Tensor PackedConvWeightsQnnp<kSpatialDim>::apply(
     const at::Tensor& input,
     double output_scale,
     int64_t output_zero_point) {
-  return apply_impl<false>(input, output_scale, output_zero_point);
+  return apply_impl<false>(
+      input, c10::nullopt, output_scale, output_zero_point);
 }
 
 template <int kSpatialDim>
@@ -455,13 +592,33 @@ at::Tensor PackedConvWeightsQnnp<kSpatialDim>::apply_relu(
     const at::Tensor& input,
     double output_scale,
     int64_t output_zero_point) {
-  return apply_impl<false>(input, output_scale, output_zero_point);
+  return apply_impl<false>(
+      input, c10::nullopt, output_scale, output_zero_point);
+}
+
+template <int kSpatialDim>
+at::Tensor PackedConvWeightsQnnp<kSpatialDim>::apply_add(
+    const at::Tensor& input,
+    const at::Tensor& accum,
+    double output_scale,
+    int64_t output_zero_point) {
+  return apply_impl<false>(input, accum, output_scale, output_zero_point);
+}
+
+template <int kSpatialDim>
+at::Tensor PackedConvWeightsQnnp<kSpatialDim>::apply_add_relu(
+    const at::Tensor& input,
+    const at::Tensor& accum,
+    double output_scale,
+    int64_t output_zero_point) {
+  return apply_impl<true>(input, accum, output_scale, output_zero_point);
 }
 
 template <int kSpatialDim>
 template <bool kReluFused>
 at::Tensor PackedConvWeightsQnnp<kSpatialDim>::apply_impl(
     const at::Tensor& act,
+    const c10::optional<at::Tensor>& accum,
     double output_scale,
     int64_t output_zero_point) {
   TORCH_CHECK(
@@ -505,6 +662,14 @@ at::Tensor PackedConvWeightsQnnp<kSpatialDim>::apply_impl(
       ? activationLimits(output_scale, output_zero_point, Activation::RELU)
             .second
       : std::numeric_limits<uint8_t>::max();
+  // With an accumulator, the convolution is requantized to the intermediate
+  // quantization without clamping, and the ReLU applies to the sum.
+  double conv_scale = output_scale;
+  int64_t conv_zero_point = output_zero_point;
+  if (accum.has_value()) {
+    std::tie(conv_scale, conv_zero_point) =
+        ConvAddIntermediateQParams(output_scale, output_zero_point, *accum);
+  }
   qnnpack::conv_param_t conv_p(
       {kernel_w, kernel_h},
       {stride_w, stride_h},
@@ -516,8 +681,8 @@ at::Tensor PackedConvWeightsQnnp<kSpatialDim>::apply_impl(
       M,
       kernel_zp,
       kernel_scale,
-      output_min,
-      output_max,
+      accum.has_value() ? std::numeric_limits<uint8_t>::min() : output_min,
+      accum.has_value() ? std::numeric_limits<uint8_t>::max() : output_max,
       /*transpose=*/false);
 
   double act_input_scale = act_nhwc.q_scale();
@@ -576,6 +741,38 @@ at::Tensor PackedConvWeightsQnnp<kSpatialDim>::apply_impl(
       output_zero_point,
       c10::nullopt);
 
+  if (accum.has_value()) {
+    ConvAddChecks<kSpatialDim>(*accum, output.sizes());
+    const at::Tensor accum_nhwc =
+        accum->contiguous(c10::MemoryFormat::ChannelsLast);
+    const pytorch_qnnp_status run_status = qnnpack::qnnpackConvAdd(
+        conv_p,
+        pack_w->getPackedWeights(),
+        N,
+        H,
+        W,
+        act_nhwc.q_scale(),
+        act_nhwc.q_zero_point(),
+        reinterpret_cast<uint8_t*>(act_nhwc.template data_ptr<c10::quint8>()),
+        conv_scale,
+        conv_zero_point,
+        accum_nhwc.q_scale(),
+        accum_nhwc.q_zero_point(),
+        reinterpret_cast<uint8_t*>(
+            accum_nhwc.template data_ptr<c10::quint8>()),
+        output.q_scale(),
+        output.q_zero_point(),
+        output_min,
+        output_max,
+        reinterpret_cast<uint8_t*>(output.template data_ptr<c10::quint8>()),
+        caffe2::mobile_pthreadpool());
+    TORCH_CHECK(
+        run_status == pytorch_qnnp_status_success,
+        "failed to run quantized::conv2d_add (qnnpack) operator, the "
+        "accumulator and output scales may be too far apart");
+    return output;
+  }
+
   const pytorch_qnnp_status run_status = qnnpack::qnnpackConv(
       conv_p,
       pack_w->getPackedWeights(),
@@ -617,6 +814,30 @@ template at::Tensor PackedConvWeightsQnnp<3>::apply_relu(
     double output_scale,
     int64_t output_zero_point);
 
+template at::Tensor PackedConvWeightsQnnp<2>::apply_add(
+    const at::Tensor& act,
+    const at::Tensor& accum,
+    double output_scale,
+    int64_t output_zero_point);
+
+template at::Tensor PackedConvWeightsQnnp<2>::apply_add_relu(
+    const at::Tensor& act,
+    const at::Tensor& accum,
+    double output_scale,
+    int64_t output_zero_point);
+
+template at::Tensor PackedConvWeightsQnnp<3>::apply_add(
+    const at::Tensor& act,
+    const at::Tensor& accum,
+    double output_scale,
+    int64_t output_zero_point);
+
+template at::Tensor PackedConvWeightsQnnp<3>::apply_add_relu(
+    const at::Tensor& act,
+    const at::Tensor& accum,
+    double output_scale,
+    int64_t output_zero_point);
+
 #endif // USE_PYTORCH_QNNPACK
 
 namespace at {
@@ -668,6 +889,25 @@ class QConvInt8 final {
   }
 };
 
+template <int kSpatialDim, bool kReluFused>
+class QConvAddInt8 final {
+ public:
+  static Tensor run(
+      Tensor act,
+      Tensor accum,
+      const c10::intrusive_ptr<ConvPackedParamsBase<kSpatialDim>>& packed_weight,
+      double output_scale,
+      int64_t output_zero_point) {
+    if (kReluFused) {
+      return packed_weight->apply_add_relu(
+          act, accum, output_scale, output_zero_point);
+    } else {
+      return packed_weight->apply_add(
+          act, accum, output_scale, output_zero_point);
+    }
+  }
+};
+
 // kernel for maintaining backward compatibility
 template <int kSpatialDim, bool kReluFused>
 class QConvInt8ForBC final {
@@ -702,6 +942,8 @@ TORCH_LIBRARY_IMPL(quantized, QuantizedCPU, m) {
   m.impl("conv2d_relu.new", QConvInt8<2, true>::run);
   m.impl("conv3d.new",      QConvInt8<3, false>::run);
   m.impl("conv3d_relu.new", QConvInt8<3, true>::run);
+  m.impl("conv2d_add",      QConvAddInt8<2, false>::run);
+  m.impl("conv2d_add_relu", QConvAddInt8<2, true>::run);
   // for backward compatibility
   m.impl("conv2d", QConvInt8ForBC<2, false>::run);
   m.impl("conv2d_relu", QConvInt8ForBC<2, true>::run);
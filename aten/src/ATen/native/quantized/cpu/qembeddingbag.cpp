@@ -0,0 +1,478 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <torch/library.h>
+
+#include <caffe2/perfkernels/fused_8bit_rowwise_embedding_lookup_idx.h>
+
+#include <algorithm>
+#include <vector>
+
+#ifdef __ARM_NEON__
+#include <arm_neon.h>
+#endif
+
+namespace at {
+namespace native {
+namespace {
+
+// See qembeddingbag_prepack.cpp for the layout of the packed tables.
+
+constexpr int64_t kModeSum = 0;
+constexpr int64_t kModeMean = 1;
+
+// Offsets of the bags as int64, with the end of the last bag appended.
+// Without offsets, `indices` is a 2-dimensional batch of bags of equal size.
+std::vector<int64_t> make_bag_offsets(
+    const Tensor& indices,
+    const c10::optional<Tensor>& offsets_in,
+    bool include_last_offset) {
+  std::vector<int64_t> bag_offsets;
+  if (!offsets_in.has_value()) {
+    TORCH_CHECK(
+        indices.dim() == 2,
+        "quantized::embedding_bag: indices has to be 2-dimensional if offsets "
+        "are not given, got ", indices.dim(), " dimensions");
+    const int64_t bag_length = indices.size(1);
+    bag_offsets.resize(indices.size(0) + 1);
+    for (size_t i = 0; i < bag_offsets.size(); ++i) {
+      bag_offsets[i] = i * bag_length;
+    }
+    return bag_offsets;
+  }
+  TORCH_CHECK(
+      indices.dim() == 1,
+      "quantized::embedding_bag: indices has to be 1-dimensional if offsets "
+      "are given, got ", indices.dim(), " dimensions");
+  const auto offsets = offsets_in->to(at::kLong).contiguous();
+  TORCH_CHECK(
+      offsets.dim() == 1,
+      "quantized::embedding_bag: offsets has to be 1-dimensional");
+  TORCH_CHECK(
+      !include_last_offset || offsets.numel() >= 1,
+      "include_last_offset: number of offset should be at least 1");
+  const auto* offsets_data = offsets.data_ptr<int64_t>();
+  bag_offsets.assign(offsets_data, offsets_data + offsets.numel());
+  if (!include_last_offset) {
+    bag_offsets.push_back(indices.numel());
+  }
+  TORCH_CHECK(
+      bag_offsets.front() == 0,
+      "offsets[0] has to be 0, i.e., the first sequence in the mini-batch "
+      "has to start from position 0. However, got ", bag_offsets.front());
+  for (size_t i = 1; i < bag_offsets.size(); ++i) {
+    TORCH_CHECK(
+        bag_offsets[i - 1] <= bag_offsets[i] &&
+            bag_offsets[i] <= indices.numel(),
+        "quantized::embedding_bag: offsets have to be non-decreasing and not "
+        "greater than the number of indices");
+  }
+  return bag_offsets;
+}
+
+// Offsets of the bags from their lengths, as in the SparseLengthsSum family
+// of caffe2 operators, with the end of the last bag appended.
+std::vector<int64_t> make_bag_offsets_from_lengths(
+    const Tensor& indices,
+    const Tensor& lengths_in) {
+  TORCH_CHECK(
+      indices.dim() == 1,
+      "quantized::embedding_bag: indices has to be 1-dimensional if lengths "
+      "are given, got ", indices.dim(), " dimensions");
+  const auto lengths = lengths_in.to(at::kLong).contiguous();
+  TORCH_CHECK(
+      lengths.dim() == 1,
+      "quantized::embedding_bag: lengths has to be 1-dimensional");
+  const auto* lengths_data = lengths.data_ptr<int64_t>();
+  std::vector<int64_t> bag_offsets(lengths.numel() + 1);
+  bag_offsets[0] = 0;
+  for (int64_t i = 0; i < lengths.numel(); ++i) {
+    TORCH_CHECK(
+        lengths_data[i] >= 0,
+        "quantized::embedding_bag: lengths have to be non-negative");
+    bag_offsets[i + 1] = bag_offsets[i] + lengths_data[i];
+  }
+  TORCH_CHECK(
+      bag_offsets.back() == indices.numel(),
+      "quantized::embedding_bag: lengths have to sum up to the number of "
+      "indices, got ", bag_offsets.back(), " for ", indices.numel(),
+      " indices");
+  return bag_offsets;
+}
+
+void check_arguments(
+    const char* op_name,
+    const Tensor& packed_weight,
+    const Tensor& indices,
+    int64_t mode,
+    bool sparse,
+    const c10::optional<Tensor>& per_sample_weights) {
+  TORCH_CHECK(
+      packed_weight.dim() == 2 &&
+          packed_weight.scalar_type() == at::ScalarType::Byte,
+      op_name, " expects a packed uint8 table, see ", op_name, "_prepack");
+  TORCH_CHECK(
+      indices.scalar_type() == at::kLong || indices.scalar_type() == at::kInt,
+      op_name, ": indices have to be int64 or int32, got ",
+      indices.scalar_type());
+  TORCH_CHECK(
+      mode == kModeSum || mode == kModeMean,
+      op_name, " only supports mode='sum' and mode='mean', got mode ", mode);
+  TORCH_CHECK(!sparse, op_name, " doesn't support sparse gradients");
+  if (per_sample_weights.has_value()) {
+    TORCH_CHECK(
+        mode == kModeSum,
+        op_name, ": per_sample_weights only supported with mode='sum'");
+    TORCH_CHECK(
+        per_sample_weights->scalar_type() == at::kFloat,
+        op_name, ": per_sample_weights have to be float");
+    TORCH_CHECK(
+        per_sample_weights->numel() == indices.numel(),
+        op_name, ": per_sample_weights have to have the same number of "
+        "elements as indices");
+  }
+}
+
+int64_t bag_grain_size(int64_t num_indices, int64_t num_bags, int64_t dim) {
+  const int64_t avg_bag_cost =
+      std::max<int64_t>(1, num_indices / std::max<int64_t>(num_bags, 1)) *
+      std::max<int64_t>(dim, 1);
+  return std::max<int64_t>(1, at::internal::GRAIN_SIZE / avg_bag_cost);
+}
+
+#ifdef __ARM_NEON__
+// out[0:8] += scale * q + bias
+inline void accumulate_uint8x8(
+    uint8x8_t q,
+    float32x4_t vscale,
+    float32x4_t vbias,
+    float* out) {
+  const uint16x8_t q16 = vmovl_u8(q);
+  const float32x4_t q_lo = vcvtq_f32_u32(vmovl_u16(vget_low_u16(q16)));
+  const float32x4_t q_hi = vcvtq_f32_u32(vmovl_u16(vget_high_u16(q16)));
+  vst1q_f32(
+      out, vmlaq_f32(vaddq_f32(vld1q_f32(out), vbias), q_lo, vscale));
+  vst1q_f32(
+      out + 4,
+      vmlaq_f32(vaddq_f32(vld1q_f32(out + 4), vbias), q_hi, vscale));
+}
+#endif // __ARM_NEON__
+
+// out += scale * row + bias, for a row of embedding_dim elements of the 8-bit
+// table.
+inline void accumulate_byte_row(
+    const uint8_t* row,
+    float scale,
+    float bias,
+    int64_t embedding_dim,
+    float* out) {
+  int64_t col = 0;
+#ifdef __ARM_NEON__
+  const float32x4_t vscale = vdupq_n_f32(scale);
+  const float32x4_t vbias = vdupq_n_f32(bias);
+  for (; col + 8 <= embedding_dim; col += 8) {
+    accumulate_uint8x8(vld1_u8(row + col), vscale, vbias, out + col);
+  }
+#endif // __ARM_NEON__
+  for (; col < embedding_dim; ++col) {
+    out[col] += scale * row[col] + bias;
+  }
+}
+
+// out += scale * row + bias, for a row of packed_cols bytes, that is
+// 2 * packed_cols elements, of the 4-bit table.
+inline void accumulate_4bit_row(
+    const uint8_t* row,
+    float scale,
+    float bias,
+    int64_t packed_cols,
+    float* out) {
+  int64_t col = 0;
+#ifdef __ARM_NEON__
+  const float32x4_t vscale = vdupq_n_f32(scale);
+  const float32x4_t vbias = vdupq_n_f32(bias);
+  const uint8x8_t vmask = vdup_n_u8(0x0F);
+  for (; col + 8 <= packed_cols; col += 8) {
+    const uint8x8_t packed = vld1_u8(row + col);
+    // interleaves the lower (even columns) and the upper (odd columns)
+    // nibbles back into the order of the columns
+    const uint8x8x2_t q =
+        vzip_u8(vand_u8(packed, vmask), vshr_n_u8(packed, 4));
+    accumulate_uint8x8(q.val[0], vscale, vbias, out + 2 * col);
+    accumulate_uint8x8(q.val[1], vscale, vbias, out + 2 * col + 8);
+  }
+#endif // __ARM_NEON__
+  for (; col < packed_cols; ++col) {
+    const uint8_t q = row[col];
+    out[2 * col] += scale * (q & 0x0F) + bias;
+    out[2 * col + 1] += scale * (q >> 4) + bias;
+  }
+}
+
+// Reduces every bag row by row, with the scale and bias of the row of type
+// ScaleBiasType stored at the end of the row.
+template <typename IndexType, typename ScaleBiasType, bool Is4Bit>
+void embedding_bag_rows_impl(
+    const char* op_name,
+    const Tensor& packed_weight,
+    const Tensor& indices,
+    const std::vector<int64_t>& bag_offsets,
+    const float* per_sample_weights_data,
+    bool normalize_by_lengths,
+    Tensor& output) {
+  const int64_t num_bags = bag_offsets.size() - 1;
+  const int64_t embedding_dim = output.size(1);
+  const int64_t num_embeddings = packed_weight.size(0);
+  const int64_t packed_row_size = packed_weight.size(1);
+  const int64_t packed_cols = Is4Bit ? embedding_dim / 2 : embedding_dim;
+  const auto* weight_data = packed_weight.data_ptr<uint8_t>();
+  const auto* indices_data = indices.data_ptr<IndexType>();
+  auto* output_data = output.data_ptr<float>();
+
+  at::parallel_for(
+      0, num_bags, bag_grain_size(indices.numel(), num_bags, embedding_dim),
+      [&](int64_t start_idx, int64_t end_idx) {
+        for (int64_t bag = start_idx; bag < end_idx; ++bag) {
+          float* output_row = output_data + bag * embedding_dim;
+          std::fill(output_row, output_row + embedding_dim, 0.f);
+          for (int64_t i = bag_offsets[bag]; i < bag_offsets[bag + 1]; ++i) {
+            const int64_t idx = indices_data[i];
+            TORCH_CHECK(
+                idx >= 0 && idx < num_embeddings,
+                op_name, ": index ", idx, " is out of bounds for ",
+                num_embeddings, " embeddings");
+            const uint8_t* row = weight_data + idx * packed_row_size;
+            const auto* scale_bias =
+                reinterpret_cast<const ScaleBiasType*>(row + packed_cols);
+            const float weight =
+                per_sample_weights_data ? per_sample_weights_data[i] : 1.f;
+            const float scale = weight * static_cast<float>(scale_bias[0]);
+            const float bias = weight * static_cast<float>(scale_bias[1]);
+            if (Is4Bit) {
+              accumulate_4bit_row(row, scale, bias, packed_cols, output_row);
+            } else {
+              accumulate_byte_row(row, scale, bias, packed_cols, output_row);
+            }
+          }
+          const int64_t length = bag_offsets[bag + 1] - bag_offsets[bag];
+          if (normalize_by_lengths && length > 0) {
+            const float inverse_length = 1.f / length;
+            for (int64_t col = 0; col < embedding_dim; ++col) {
+              output_row[col] *= inverse_length;
+            }
+          }
+        }
+      });
+}
+
+template <typename IndexType>
+void embedding_bag_byte_impl(
+    const Tensor& packed_weight,
+    const Tensor& indices,
+    const std::vector<int64_t>& bag_offsets,
+    const float* per_sample_weights_data,
+    bool normalize_by_lengths,
+    Tensor& output) {
+#ifdef __ARM_NEON__
+  // The perfkernels only have AVX2 (and AVX-512) implementations.
+  embedding_bag_rows_impl<IndexType, float, /*Is4Bit=*/false>(
+      "quantized::embedding_bag_byte", packed_weight, indices, bag_offsets,
+      per_sample_weights_data, normalize_by_lengths, output);
+#else
+  const int64_t num_bags = bag_offsets.size() - 1;
+  const int64_t embedding_dim = output.size(1);
+  const auto* weight_data = packed_weight.data_ptr<uint8_t>();
+  const auto* indices_data = indices.data_ptr<IndexType>();
+  auto* output_data = output.data_ptr<float>();
+
+  at::parallel_for(
+      0, num_bags, bag_grain_size(indices.numel(), num_bags, embedding_dim),
+      [&](int64_t start_idx, int64_t end_idx) {
+        const int64_t index_begin = bag_offsets[start_idx];
+        caffe2::Fused8BitRowwiseEmbeddingLookupIdx(
+            /*block_size=*/embedding_dim,
+            /*output_size=*/end_idx - start_idx,
+            /*index_size=*/bag_offsets[end_idx] - index_begin,
+            /*data_size=*/packed_weight.size(0),
+            /*input=*/weight_data,
+            /*indices=*/indices_data + index_begin,
+            /*offsets=*/bag_offsets.data() + start_idx,
+            /*weights=*/per_sample_weights_data
+                ? per_sample_weights_data + index_begin
+                : nullptr,
+            /*normalize_by_lengths=*/normalize_by_lengths,
+            /*out=*/output_data + start_idx * embedding_dim);
+      });
+#endif // __ARM_NEON__
+}
+
+template <typename IndexType>
+void embedding_bag_4bit_impl(
+    const Tensor& packed_weight,
+    const Tensor& indices,
+    const std::vector<int64_t>& bag_offsets,
+    const float* per_sample_weights_data,
+    bool normalize_by_lengths,
+    Tensor& output) {
+  embedding_bag_rows_impl<IndexType, at::Half, /*Is4Bit=*/true>(
+      "quantized::embedding_bag_4bit", packed_weight, indices, bag_offsets,
+      per_sample_weights_data, normalize_by_lengths, output);
+}
+
+Tensor embedding_bag_byte_helper(
+    const Tensor& packed_weight,
+    const Tensor& indices,
+    const std::vector<int64_t>& bag_offsets,
+    int64_t mode,
+    const c10::optional<Tensor>& per_sample_weights) {
+  TORCH_CHECK(
+      packed_weight.size(1) >= 2 * static_cast<int64_t>(sizeof(float)),
+      "quantized::embedding_bag_byte: rows of the packed table are too short");
+  const auto weight_contig = packed_weight.contiguous();
+  const auto indices_contig = indices.contiguous();
+  Tensor per_sample_weights_contig;
+  if (per_sample_weights.has_value()) {
+    per_sample_weights_contig = per_sample_weights->contiguous();
+  }
+  const int64_t num_bags = bag_offsets.size() - 1;
+  const int64_t embedding_dim =
+      packed_weight.size(1) - 2 * static_cast<int64_t>(sizeof(float));
+  auto output = at::empty(
+      {num_bags, embedding_dim}, packed_weight.options().dtype(at::kFloat));
+  const float* per_sample_weights_data = per_sample_weights_contig.defined()
+      ? per_sample_weights_contig.data_ptr<float>()
+      : nullptr;
+
+  if (indices.scalar_type() == at::kLong) {
+    embedding_bag_byte_impl<int64_t>(
+        weight_contig, indices_contig, bag_offsets, per_sample_weights_data,
+        mode == kModeMean, output);
+  } else {
+    embedding_bag_byte_impl<int32_t>(
+        weight_contig, indices_contig, bag_offsets, per_sample_weights_data,
+        mode == kModeMean, output);
+  }
+  return output;
+}
+
+Tensor embedding_bag_4bit_helper(
+    const Tensor& packed_weight,
+    const Tensor& indices,
+    const std::vector<int64_t>& bag_offsets,
+    int64_t mode,
+    const c10::optional<Tensor>& per_sample_weights) {
+  TORCH_CHECK(
+      packed_weight.size(1) >= 2 * static_cast<int64_t>(sizeof(at::Half)),
+      "quantized::embedding_bag_4bit: rows of the packed table are too short");
+  const auto weight_contig = packed_weight.contiguous();
+  const auto indices_contig = indices.contiguous();
+  Tensor per_sample_weights_contig;
+  if (per_sample_weights.has_value()) {
+    per_sample_weights_contig = per_sample_weights->contiguous();
+  }
+  const int64_t num_bags = bag_offsets.size() - 1;
+  // like embedding_bag_4bit_unpack, this always returns an even number of
+  // columns
+  const int64_t embedding_dim =
+      2 * (packed_weight.size(1) - 2 * static_cast<int64_t>(sizeof(at::Half)));
+  auto output = at::empty(
+      {num_bags, embedding_dim}, packed_weight.options().dtype(at::kFloat));
+  const float* per_sample_weights_data = per_sample_weights_contig.defined()
+      ? per_sample_weights_contig.data_ptr<float>()
+      : nullptr;
+
+  if (indices.scalar_type() == at::kLong) {
+    embedding_bag_4bit_impl<int64_t>(
+        weight_contig, indices_contig, bag_offsets, per_sample_weights_data,
+        mode == kModeMean, output);
+  } else {
+    embedding_bag_4bit_impl<int32_t>(
+        weight_contig, indices_contig, bag_offsets, per_sample_weights_data,
+        mode == kModeMean, output);
+  }
+  return output;
+}
+
+Tensor embedding_bag_byte_rowwise_offsets(
+    const Tensor& packed_weight,
+    const Tensor& indices,
+    c10::optional<Tensor> offsets,
+    bool scale_grad_by_freq,
+    int64_t mode,
+    bool sparse,
+    c10::optional<Tensor> per_sample_weights,
+    bool include_last_offset) {
+  check_arguments(
+      "quantized::embedding_bag_byte",
+      packed_weight, indices, mode, sparse, per_sample_weights);
+  return embedding_bag_byte_helper(
+      packed_weight,
+      indices,
+      make_bag_offsets(indices, offsets, include_last_offset),
+      mode,
+      per_sample_weights);
+}
+
+Tensor embedding_bag_4bit_rowwise_offsets(
+    const Tensor& packed_weight,
+    const Tensor& indices,
+    c10::optional<Tensor> offsets,
+    bool scale_grad_by_freq,
+    int64_t mode,
+    bool sparse,
+    c10::optional<Tensor> per_sample_weights,
+    bool include_last_offset) {
+  check_arguments(
+      "quantized::embedding_bag_4bit",
+      packed_weight, indices, mode, sparse, per_sample_weights);
+  return embedding_bag_4bit_helper(
+      packed_weight,
+      indices,
+      make_bag_offsets(indices, offsets, include_last_offset),
+      mode,
+      per_sample_weights);
+}
+
+Tensor embedding_bag_byte_rowwise_lengths(
+    const Tensor& packed_weight,
+    const Tensor& indices,
+    const Tensor& lengths,
+    int64_t mode,
+    c10::optional<Tensor> per_sample_weights) {
+  check_arguments(
+      "quantized::embedding_bag_byte",
+      packed_weight, indices, mode, /*sparse=*/false, per_sample_weights);
+  return embedding_bag_byte_helper(
+      packed_weight,
+      indices,
+      make_bag_offsets_from_lengths(indices, lengths),
+      mode,
+      per_sample_weights);
+}
+
+Tensor embedding_bag_4bit_rowwise_lengths(
+    const Tensor& packed_weight,
+    const Tensor& indices,
+    const Tensor& lengths,
+    int64_t mode,
+    c10::optional<Tensor> per_sample_weights) {
+  check_arguments(
+      "quantized::embedding_bag_4bit",
+      packed_weight, indices, mode, /*sparse=*/false, per_sample_weights);
+  return embedding_bag_4bit_helper(
+      packed_weight,
+      indices,
+      make_bag_offsets_from_lengths(indices, lengths),
+      mode,
+      per_sample_weights);
+}
+
+TORCH_LIBRARY_IMPL(quantized, CPU, m) {
+  m.impl("embedding_bag_byte_rowwise_offsets", embedding_bag_byte_rowwise_offsets);
+  m.impl("embedding_bag_4bit_rowwise_offsets", embedding_bag_4bit_rowwise_offsets);
+  m.impl("embedding_bag_byte_rowwise_lengths", embedding_bag_byte_rowwise_lengths);
+  m.impl("embedding_bag_4bit_rowwise_lengths", embedding_bag_4bit_rowwise_lengths);
+}
+
+} // namespace
+} // namespace native
+} // namespace at
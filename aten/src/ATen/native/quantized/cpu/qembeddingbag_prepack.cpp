@@ -0,0 +1,208 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <torch/library.h>
+
+#include <caffe2/perfkernels/fused_8bit_rowwise_conversion.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace at {
+namespace native {
+namespace {
+
+// Packed rowwise-quantized embedding tables
+//
+// 8-bit: every row of a float [N, D] table is quantized to uint8 with its
+// own scale and bias, which are stored as two floats at the end of the row,
+// so the packed table is uint8 [N, D + 8]. This is the fused 8-bit rowwise
+// layout of caffe2 (see caffe2/perfkernels/fused_8bit_rowwise_conversion.h).
+//
+// 4-bit: two elements are packed in every byte, the lower nibble holding the
+// element with the even column index, followed by the scale and bias of the
+// row as two halfs, so the packed table is uint8 [N, ceil(D / 2) + 4].
+//
+// In both cases an element is dequantized as scale * q + bias.
+
+constexpr float kEpsilon = 1e-8f;
+
+Tensor qembeddingbag_byte_prepack(const Tensor& weight) {
+  TORCH_CHECK(
+      weight.dim() == 2,
+      "quantized::embedding_bag_byte_prepack expects a 2-dimensional weight");
+  TORCH_CHECK(
+      weight.scalar_type() == at::ScalarType::Float,
+      "quantized::embedding_bag_byte_prepack expects a float weight, got ",
+      weight.scalar_type());
+  const auto weight_contig = weight.contiguous();
+  const int64_t embedding_rows = weight.size(0);
+  const int64_t embedding_cols = weight.size(1);
+  auto output = at::empty(
+      {embedding_rows, embedding_cols + 2 * static_cast<int64_t>(sizeof(float))},
+      weight.options().dtype(at::kByte));
+  const auto* weight_data = weight_contig.data_ptr<float>();
+  auto* output_data = output.data_ptr<uint8_t>();
+  const int64_t output_columns = output.size(1);
+
+  at::parallel_for(
+      0,
+      embedding_rows,
+      std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(embedding_cols, 1)),
+      [&](int64_t start_idx, int64_t end_idx) {
+        caffe2::FloatToFused8BitRowwiseQuantized(
+            weight_data + start_idx * embedding_cols,
+            end_idx - start_idx,
+            embedding_cols,
+            output_data + start_idx * output_columns);
+      });
+  return output;
+}
+
+Tensor qembeddingbag_byte_unpack(const Tensor& packed_weight) {
+  TORCH_CHECK(
+      packed_weight.dim() == 2 &&
+          packed_weight.scalar_type() == at::ScalarType::Byte &&
+          packed_weight.size(1) >= 2 * static_cast<int64_t>(sizeof(float)),
+      "quantized::embedding_bag_byte_unpack expects a packed uint8 table");
+  const auto packed_contig = packed_weight.contiguous();
+  const int64_t embedding_rows = packed_weight.size(0);
+  const int64_t input_columns = packed_weight.size(1);
+  const int64_t embedding_cols =
+      input_columns - 2 * static_cast<int64_t>(sizeof(float));
+  auto output = at::empty(
+      {embedding_rows, embedding_cols},
+      packed_weight.options().dtype(at::kFloat));
+  const auto* input_data = packed_contig.data_ptr<uint8_t>();
+  auto* output_data = output.data_ptr<float>();
+
+  at::parallel_for(
+      0,
+      embedding_rows,
+      std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(embedding_cols, 1)),
+      [&](int64_t start_idx, int64_t end_idx) {
+        caffe2::Fused8BitRowwiseQuantizedToFloat(
+            input_data + start_idx * input_columns,
+            end_idx - start_idx,
+            input_columns,
+            output_data + start_idx * embedding_cols);
+      });
+  return output;
+}
+
+Tensor qembeddingbag_4bit_prepack(const Tensor& weight) {
+  TORCH_CHECK(
+      weight.dim() == 2,
+      "quantized::embedding_bag_4bit_prepack expects a 2-dimensional weight");
+  TORCH_CHECK(
+      weight.scalar_type() == at::ScalarType::Float,
+      "quantized::embedding_bag_4bit_prepack expects a float weight, got ",
+      weight.scalar_type());
+  const auto weight_contig = weight.contiguous();
+  const int64_t embedding_rows = weight.size(0);
+  const int64_t embedding_cols = weight.size(1);
+  const int64_t packed_cols = (embedding_cols + 1) / 2;
+  const int64_t output_columns =
+      packed_cols + 2 * static_cast<int64_t>(sizeof(at::Half));
+  auto output = at::empty(
+      {embedding_rows, output_columns}, weight.options().dtype(at::kByte));
+  const auto* weight_data = weight_contig.data_ptr<float>();
+  auto* output_data = output.data_ptr<uint8_t>();
+
+  at::parallel_for(
+      0,
+      embedding_rows,
+      std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(embedding_cols, 1)),
+      [&](int64_t start_idx, int64_t end_idx) {
+        for (int64_t row = start_idx; row < end_idx; ++row) {
+          const float* input_row = weight_data + row * embedding_cols;
+          uint8_t* output_row = output_data + row * output_columns;
+          auto* output_row_scale_bias =
+              reinterpret_cast<at::Half*>(output_row + packed_cols);
+
+          float minimum_element = 0;
+          float maximum_element = 0;
+          if (embedding_cols > 0) {
+            minimum_element =
+                *std::min_element(input_row, input_row + embedding_cols);
+            maximum_element =
+                *std::max_element(input_row, input_row + embedding_cols);
+          }
+          // The bias is stored as a half, so quantize with the rounded value
+          // to not shift the whole row.
+          const at::Half bias = minimum_element;
+          minimum_element = static_cast<float>(bias);
+          const float range = maximum_element - minimum_element;
+          at::Half scale = range == 0 ? 1.0f : range / 15.0f;
+          if (static_cast<float>(scale) == 0) {
+            // underflow of the half scale
+            scale = 1.0f;
+          }
+          const float inverse_scale = 1.0f / static_cast<float>(scale);
+          output_row_scale_bias[0] = scale;
+          output_row_scale_bias[1] = bias;
+
+          std::fill(output_row, output_row + packed_cols, 0);
+          for (int64_t col = 0; col < embedding_cols; ++col) {
+            const long quantized = std::lrintf(
+                (input_row[col] - minimum_element) * inverse_scale);
+            const auto q = static_cast<uint8_t>(
+                std::max<long>(0, std::min<long>(15, quantized)));
+            output_row[col / 2] |= (col % 2 == 0) ? q : (q << 4);
+          }
+        }
+      });
+  return output;
+}
+
+Tensor qembeddingbag_4bit_unpack(const Tensor& packed_weight) {
+  TORCH_CHECK(
+      packed_weight.dim() == 2 &&
+          packed_weight.scalar_type() == at::ScalarType::Byte &&
+          packed_weight.size(1) >= 2 * static_cast<int64_t>(sizeof(at::Half)),
+      "quantized::embedding_bag_4bit_unpack expects a packed uint8 table");
+  const auto packed_contig = packed_weight.contiguous();
+  const int64_t embedding_rows = packed_weight.size(0);
+  const int64_t input_columns = packed_weight.size(1);
+  const int64_t packed_cols =
+      input_columns - 2 * static_cast<int64_t>(sizeof(at::Half));
+  // the number of columns is ambiguous for odd sizes, unpacking always
+  // returns an even number of them
+  const int64_t embedding_cols = packed_cols * 2;
+  auto output = at::empty(
+      {embedding_rows, embedding_cols},
+      packed_weight.options().dtype(at::kFloat));
+  const auto* input_data = packed_contig.data_ptr<uint8_t>();
+  auto* output_data = output.data_ptr<float>();
+
+  at::parallel_for(
+      0,
+      embedding_rows,
+      std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(embedding_cols, 1)),
+      [&](int64_t start_idx, int64_t end_idx) {
+        for (int64_t row = start_idx; row < end_idx; ++row) {
+          const uint8_t* input_row = input_data + row * input_columns;
+          const auto* input_row_scale_bias =
+              reinterpret_cast<const at::Half*>(input_row + packed_cols);
+          const float scale = input_row_scale_bias[0];
+          const float bias = input_row_scale_bias[1];
+          float* output_row = output_data + row * embedding_cols;
+          for (int64_t col = 0; col < embedding_cols; ++col) {
+            const uint8_t q = (col % 2 == 0) ? (input_row[col / 2] & 0x0F)
+                                             : (input_row[col / 2] >> 4);
+            output_row[col] = scale * q + bias;
+          }
+        }
+      });
+  return output;
+}
+
+TORCH_LIBRARY_IMPL(quantized, CPU, m) {
+  m.impl("embedding_bag_byte_prepack", qembeddingbag_byte_prepack);
+  m.impl("embedding_bag_byte_unpack", qembeddingbag_byte_unpack);
+  m.impl("embedding_bag_4bit_prepack", qembeddingbag_4bit_prepack);
+  m.impl("embedding_bag_4bit_unpack", qembeddingbag_4bit_unpack);
+}
+
+} // namespace
+} // namespace native
+} // namespace at
@@ -45,6 +45,10 @@ class QLinearInt8 final {
     // Pull out the PackBMatrix and col_offsets instance from the owning tensor.
     auto& pack_ptr =
         cpp_custom_type_hack::cast<PackedLinearWeight>(packed_weight);
+    if (pack_ptr.sparse) {
+      return pack_ptr.sparse->apply(
+          input, pack_ptr.bias, output_scale, output_zero_point, ReluFused);
+    }
     auto packB = pack_ptr.w.get();
     // packB->printPackedMatrix("packedB inside fbgemm_linear (QLinearInt8): ");
     auto& col_offsets = pack_ptr.col_offsets;
@@ -230,6 +234,14 @@ class QLinearInt8 final {
 
     auto& pack_ptr =
         cpp_custom_type_hack::cast<PackedLinearWeightsQnnp>(packed_weight);
+    if (pack_ptr.sparse) {
+      return pack_ptr.sparse->apply(
+          input_contig,
+          pack_ptr.bias,
+          output_scale,
+          output_zero_point,
+          ReluFused);
+    }
     auto packB = pack_ptr.w.get();
     // Adjust weight zero point, similar to weight data.
     auto kernel_zp = pack_ptr.w_zp + 128;
@@ -9,6 +9,7 @@
 
 #include <algorithm>
 #include <string>
+#include <tuple>
 
 namespace at {
 namespace native {
@@ -18,7 +19,10 @@ template <bool ReluFused>
 class QLinearDynamicInt8 final {
  public:
 #ifdef USE_FBGEMM
-  static at::Tensor fbgemm_linear(at::Tensor input, at::Tensor packed_weight) {
+  static at::Tensor fbgemm_linear(
+      at::Tensor input,
+      at::Tensor packed_weight,
+      int64_t range_refresh_interval) {
     // fp32 * int8 -> fp32 (with quantization on activation, and dequantization
     // on the result).
 
@@ -42,6 +46,27 @@ class QLinearDynamicInt8 final {
     // Pull out the PackBMatrix and col_offsets instance from the owning tensor.
     auto& pack_ptr =
         cpp_custom_type_hack::cast<PackedLinearWeight>(packed_weight);
+
+    // Calculate statistics for quantization of the input Tensor
+    const auto compute_range = [&]() {
+      float x_min, x_max;
+      fbgemm::FindMinMax(
+          /*m=*/input_ptr,
+          /*min=*/&x_min,
+          /*max=*/&x_max,
+          /*len=*/input.numel());
+      return std::make_pair(x_min, x_max);
+    };
+    float x_min, x_max;
+    std::tie(x_min, x_max) = range_refresh_interval > 0
+        ? pack_ptr.input_range->get(range_refresh_interval, compute_range)
+        : compute_range();
+
+    if (pack_ptr.sparse) {
+      return pack_ptr.sparse->apply_dynamic(
+          input_contig, x_min, x_max, pack_ptr.bias, ReluFused);
+    }
+
     auto packB = pack_ptr.w.get();
     // packB->printPackedMatrix("packedB inside fbgemm_linear_dynamic
     // (QLinearDynamicInt8): ");
@@ -54,14 +79,6 @@ class QLinearDynamicInt8 final {
         "The number of rows in the packB should be equal to K: " +
             std::to_string(K));
 
-    // Calculate statistics for quantization of the input Tensor
-    float x_min, x_max;
-    fbgemm::FindMinMax(
-        /*m=*/input_ptr,
-        /*min=*/&x_min,
-        /*max=*/&x_max,
-        /*len=*/input.numel());
-
     // Input tensor is quantized as 8-bit unsigned values
     static constexpr int precision = 8;
     static constexpr bool is_signed = false;
@@ -213,7 +230,10 @@ class QLinearDynamicInt8 final {
 #endif // USE_FBGEMM
 #ifdef USE_PYTORCH_QNNPACK
 
-  static at::Tensor qnnpack_linear(at::Tensor input, at::Tensor packed_weight) {
+  static at::Tensor qnnpack_linear(
+      at::Tensor input,
+      at::Tensor packed_weight,
+      int64_t range_refresh_interval) {
     TORCH_CHECK(
         input.dim() >= 2,
         "The dimension of input tensor should be larger than or equal to 2");
@@ -237,10 +257,22 @@ class QLinearDynamicInt8 final {
     auto bias_contig = bias_vec.contiguous();
     const float* bias_ptr = bias_contig.data_ptr<float>();
 
-    // Calculate statistics for quantization of input Tensor
-    // TODO: optimized kernel
-    float x_min = input_contig.min().item<float>();
-    float x_max = input_contig.max().item<float>();
+    // Calculate statistics for quantization of input Tensor, in one pass
+    const auto compute_range = [&]() {
+      const auto x_min_max = at::_aminmax(input_contig);
+      return std::make_pair(
+          std::get<0>(x_min_max).item<float>(),
+          std::get<1>(x_min_max).item<float>());
+    };
+    float x_min, x_max;
+    std::tie(x_min, x_max) = range_refresh_interval > 0
+        ? pack_ptr.input_range->get(range_refresh_interval, compute_range)
+        : compute_range();
+
+    if (pack_ptr.sparse) {
+      return pack_ptr.sparse->apply_dynamic(
+          input_contig, x_min, x_max, bias_contig, ReluFused);
+    }
 
     auto q_params = quant_utils::ChooseQuantizationParams(
         /*min=*/x_min,
@@ -318,16 +350,37 @@ class QLinearDynamicInt8 final {
 #endif // USE_PYTORCH_QNNPACK
 
   static at::Tensor run(at::Tensor input, at::Tensor packed_weight) {
+    return run_impl(input, packed_weight, /*range_refresh_interval=*/0);
+  }
+
+  // Quantizes the input with the range cached in the packed weight, which is
+  // recomputed from the input every range_refresh_interval calls only.
+  static at::Tensor run_cached_range(
+      at::Tensor input,
+      at::Tensor packed_weight,
+      int64_t range_refresh_interval) {
+    TORCH_CHECK(
+        range_refresh_interval > 0,
+        "quantized::linear_dynamic_cached_range: refresh_interval has to be "
+        "positive, got ", range_refresh_interval);
+    return run_impl(input, packed_weight, range_refresh_interval);
+  }
+
+ private:
+  static at::Tensor run_impl(
+      at::Tensor input,
+      at::Tensor packed_weight,
+      int64_t range_refresh_interval) {
     auto& ctx = at::globalContext();
 
 #ifdef USE_FBGEMM
     if (ctx.qEngine() == at::QEngine::FBGEMM) {
-      return fbgemm_linear(input, packed_weight);
+      return fbgemm_linear(input, packed_weight, range_refresh_interval);
     }
 #endif
 #ifdef USE_PYTORCH_QNNPACK
     if (ctx.qEngine() == at::QEngine::QNNPACK) {
-      return qnnpack_linear(input, packed_weight);
+      return qnnpack_linear(input, packed_weight, range_refresh_interval);
     }
 #endif
     TORCH_CHECK(
@@ -400,6 +453,9 @@ TORCH_LIBRARY_IMPL(quantized, CPU, m) {
   m.impl("linear_dynamic", QLinearDynamicInt8<false>::run);
   m.impl("linear_relu_dynamic", QLinearDynamicInt8<true>::run);
   m.impl("linear_dynamic_fp16", QLinearDynamicFp16<false>::run);
+  m.impl(
+      "linear_dynamic_cached_range",
+      QLinearDynamicInt8<false>::run_cached_range);
 }
 
 TORCH_LIBRARY_IMPL(_quantized, CPU, m) {
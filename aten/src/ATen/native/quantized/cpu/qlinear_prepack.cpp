@@ -105,20 +105,28 @@ class QLinearPackWeightInt8 final {
           "bias should have N elements: " + std::to_string(N));
       bias_contig = bias->contiguous();
     }
+    // The pruned weights are run by the block-sparse kernels only, so they
+    // are not packed for FBGEMM.
+    auto sparse = BlockSparseLinearWeight::pack_if_sparse(weight_contig);
+    std::unique_ptr<fbgemm::PackBMatrix<int8_t>> packB;
+    if (!sparse) {
+      packB = std::make_unique<fbgemm::PackBMatrix<int8_t>>(
+          /*trans=*/fbgemm::matrix_op_t::Transpose,
+          /*nRow=*/K,
+          /*nCol=*/N,
+          /*smat=*/weight_ptr_int8,
+          /*ld=*/K,
+          /*pmat=*/nullptr, // PackBMatrix manages ownership of pmat
+          /*groups=*/1);
+    }
     auto ret_ptr = std::make_unique<PackedLinearWeight>(PackedLinearWeight{
-        std::make_unique<fbgemm::PackBMatrix<int8_t>>(
-            /*trans=*/fbgemm::matrix_op_t::Transpose,
-            /*nRow=*/K,
-            /*nCol=*/N,
-            /*smat=*/weight_ptr_int8,
-            /*ld=*/K,
-            /*pmat=*/nullptr, // PackBMatrix manages ownership of pmat
-            /*groups=*/1),
+        std::move(packB),
         bias_contig,
         col_offsets,
         weight_scales_float,
         weight_zero_points_int32,
         qtype});
+    ret_ptr->sparse = std::move(sparse);
 
     // TODO: we will need to replace this with torchscript classes at a later
     // point.
@@ -170,6 +178,7 @@ class QLinearPackWeightInt8 final {
                                 c10::nullopt, /* input_scale */
                                 weight.q_scale(),
                                 weight_zp});
+    wt_ptr->sparse = BlockSparseLinearWeight::pack_if_sparse(weight_contig);
     return cpp_custom_type_hack::create(std::move(wt_ptr), weight.options());
   }
 #endif
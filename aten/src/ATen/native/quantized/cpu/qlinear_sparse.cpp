@@ -0,0 +1,276 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/quantized/cpu/qlinear_sparse.h>
+#include <ATen/native/quantized/cpu/quant_utils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+
+namespace at {
+namespace native {
+
+constexpr int64_t BlockSparseLinearWeight::kBlockSize;
+constexpr double BlockSparseLinearWeight::kMaxDensity;
+
+namespace {
+
+// C(output) = A(input) x B(weight)^T, where C, A, B are M x N, M x K, N x K
+// matrices, respectively. Calls store(n, acc) for every output channel n, with
+// acc[m] the sum over k of (A[m][k] - input_zero_point) * (B[n][k] - w_zp[n]),
+// the output channels split among the threads.
+template <typename Store>
+void block_sparse_gemm(
+    const BlockSparseLinearWeight& weight,
+    const uint8_t* input,
+    int64_t M,
+    int32_t input_zero_point,
+    const Store& store) {
+  constexpr int64_t kBlockSize = BlockSparseLinearWeight::kBlockSize;
+  const int64_t N = weight.output_channels;
+  const int64_t K = weight.input_channels;
+  const int64_t K_padded = (K + kBlockSize - 1) / kBlockSize * kBlockSize;
+
+  // The input transposed to K x M, with the zero point subtracted, so that
+  // the accumulation of every weight vectorizes over the rows of the input.
+  // The input channels in the padding of the last blocks are zero.
+  std::vector<int16_t> input_t(K_padded * M, 0);
+  for (int64_t m = 0; m < M; ++m) {
+    for (int64_t k = 0; k < K; ++k) {
+      input_t[k * M + m] =
+          static_cast<int16_t>(input[m * K + k]) - input_zero_point;
+    }
+  }
+
+  const int64_t work_per_channel = std::max<int64_t>(
+      1, static_cast<int64_t>(weight.values.size()) / std::max<int64_t>(N, 1) *
+          M);
+  const int64_t grain_size =
+      std::max<int64_t>(1, at::internal::GRAIN_SIZE / work_per_channel);
+  at::parallel_for(0, N, grain_size, [&](int64_t begin, int64_t end) {
+    std::vector<int32_t> acc(M);
+    for (int64_t n = begin; n < end; ++n) {
+      std::fill(acc.begin(), acc.end(), 0);
+      for (int32_t b = weight.row_offsets[n]; b < weight.row_offsets[n + 1];
+           ++b) {
+        const int16_t* values = weight.values.data() + b * kBlockSize;
+        const int16_t* x = input_t.data() + weight.block_columns[b] * M;
+        for (int64_t j = 0; j < kBlockSize; ++j) {
+          const int32_t value = values[j];
+          const int16_t* x_j = x + j * M;
+          for (int64_t m = 0; m < M; ++m) {
+            acc[m] += value * x_j[m];
+          }
+        }
+      }
+      store(n, acc.data());
+    }
+  });
+}
+
+const float* bias_data(
+    const c10::optional<at::Tensor>& bias,
+    int64_t N,
+    at::Tensor& bias_contig) {
+  if (!bias.has_value() || !bias->defined()) {
+    return nullptr;
+  }
+  TORCH_CHECK(bias->dim() == 1, "bias should be a vector (1D Tensor)");
+  TORCH_CHECK(
+      bias->size(0) == N, "bias should have N elements: " + std::to_string(N));
+  bias_contig = bias->contiguous();
+  return bias_contig.data_ptr<float>();
+}
+
+std::vector<int64_t> output_sizes(const at::Tensor& input, int64_t N) {
+  std::vector<int64_t> out_sizes = input.sizes().vec();
+  out_sizes.back() = N;
+  return out_sizes;
+}
+
+void check_input(const at::Tensor& input, int64_t K) {
+  TORCH_CHECK(
+      input.dim() >= 2,
+      "The dimension of input tensor should be larger than or equal to 2");
+  TORCH_CHECK(
+      input.size(input.dim() - 1) == K,
+      "The number of input channels should be equal to K: " +
+          std::to_string(K));
+}
+
+} // namespace
+
+std::unique_ptr<BlockSparseLinearWeight> BlockSparseLinearWeight::
+    pack_if_sparse(const at::Tensor& weight) {
+  const auto qtype = weight.qscheme();
+  if (weight.dim() != 2 || weight.scalar_type() != kQInt8 ||
+      !(qtype == kPerTensorAffine ||
+        (qtype == kPerChannelAffine && weight.q_per_channel_axis() == 0))) {
+    return nullptr;
+  }
+  const int64_t N = weight.size(0);
+  const int64_t K = weight.size(1);
+  if (N == 0 || K == 0) {
+    return nullptr;
+  }
+
+  std::vector<float> w_scale(N);
+  std::vector<int32_t> w_zp(N);
+  if (qtype == kPerTensorAffine) {
+    std::fill(w_scale.begin(), w_scale.end(), weight.q_scale());
+    std::fill(w_zp.begin(), w_zp.end(), weight.q_zero_point());
+  } else {
+    const auto scales = weight.q_per_channel_scales().to(kFloat).contiguous();
+    const auto zero_points =
+        weight.q_per_channel_zero_points().to(kInt).contiguous();
+    std::copy_n(scales.data_ptr<float>(), N, w_scale.begin());
+    std::copy_n(zero_points.data_ptr<int32_t>(), N, w_zp.begin());
+  }
+
+  const auto weight_contig = weight.contiguous();
+  const int8_t* data =
+      reinterpret_cast<int8_t*>(weight_contig.data_ptr<c10::qint8>());
+  const int64_t blocks_per_row = (K + kBlockSize - 1) / kBlockSize;
+  const auto is_nonzero_block = [&](int64_t n, int64_t k) {
+    for (int64_t j = k; j < std::min(k + kBlockSize, K); ++j) {
+      if (data[n * K + j] != w_zp[n]) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  int64_t nonzero_blocks = 0;
+  for (int64_t n = 0; n < N; ++n) {
+    for (int64_t k = 0; k < K; k += kBlockSize) {
+      nonzero_blocks += is_nonzero_block(n, k);
+    }
+  }
+  if (nonzero_blocks > kMaxDensity * N * blocks_per_row) {
+    return nullptr;
+  }
+
+  auto packed = std::make_unique<BlockSparseLinearWeight>();
+  packed->output_channels = N;
+  packed->input_channels = K;
+  packed->row_offsets.reserve(N + 1);
+  packed->block_columns.reserve(nonzero_blocks);
+  packed->values.reserve(nonzero_blocks * kBlockSize);
+  packed->row_offsets.push_back(0);
+  for (int64_t n = 0; n < N; ++n) {
+    for (int64_t k = 0; k < K; k += kBlockSize) {
+      if (!is_nonzero_block(n, k)) {
+        continue;
+      }
+      packed->block_columns.push_back(k);
+      for (int64_t j = k; j < k + kBlockSize; ++j) {
+        packed->values.push_back(j < K ? data[n * K + j] - w_zp[n] : 0);
+      }
+    }
+    packed->row_offsets.push_back(packed->block_columns.size());
+  }
+  packed->w_scale = std::move(w_scale);
+  packed->w_zp = std::move(w_zp);
+  return packed;
+}
+
+void BlockSparseLinearWeight::unpack(int8_t* weight) const {
+  const int64_t K = input_channels;
+  for (int64_t n = 0; n < output_channels; ++n) {
+    int8_t* row = weight + n * K;
+    std::fill(row, row + K, static_cast<int8_t>(w_zp[n]));
+    for (int32_t b = row_offsets[n]; b < row_offsets[n + 1]; ++b) {
+      for (int64_t j = 0; j < kBlockSize && block_columns[b] + j < K; ++j) {
+        row[block_columns[b] + j] =
+            static_cast<int8_t>(values[b * kBlockSize + j] + w_zp[n]);
+      }
+    }
+  }
+}
+
+at::Tensor BlockSparseLinearWeight::apply(
+    const at::Tensor& input,
+    const c10::optional<at::Tensor>& bias,
+    double output_scale,
+    int64_t output_zero_point,
+    bool relu) const {
+  check_input(input, input_channels);
+  const int64_t M = size_to_dim_(input.dim() - 1, input.sizes());
+  const int64_t N = output_channels;
+  const auto input_contig = input.contiguous();
+  at::Tensor bias_contig;
+  const float* bias_ptr = bias_data(bias, N, bias_contig);
+
+  auto output = at::_empty_affine_quantized(
+      output_sizes(input, N),
+      at::device(kCPU).dtype(kQUInt8),
+      output_scale,
+      output_zero_point);
+  auto* output_ptr = reinterpret_cast<uint8_t*>(output.data_ptr<c10::quint8>());
+
+  const float input_scale = input.q_scale();
+  const float inverse_output_scale = 1.0f / static_cast<float>(output_scale);
+  const int32_t output_min = relu ? output_zero_point : 0;
+  const int32_t output_max = std::numeric_limits<uint8_t>::max();
+  block_sparse_gemm(
+      *this,
+      reinterpret_cast<uint8_t*>(input_contig.data_ptr<c10::quint8>()),
+      M,
+      input.q_zero_point(),
+      [&](int64_t n, const int32_t* acc) {
+        const float multiplier = input_scale * w_scale[n];
+        const float b = bias_ptr ? bias_ptr[n] : 0.0f;
+        for (int64_t m = 0; m < M; ++m) {
+          const int32_t q = output_zero_point +
+              static_cast<int32_t>(std::nearbyint(
+                  (acc[m] * multiplier + b) * inverse_output_scale));
+          output_ptr[m * N + n] =
+              static_cast<uint8_t>(std::min(std::max(q, output_min), output_max));
+        }
+      });
+  return output;
+}
+
+at::Tensor BlockSparseLinearWeight::apply_dynamic(
+    const at::Tensor& input,
+    float input_min,
+    float input_max,
+    const c10::optional<at::Tensor>& bias,
+    bool relu) const {
+  check_input(input, input_channels);
+  const int64_t M = size_to_dim_(input.dim() - 1, input.sizes());
+  const int64_t N = output_channels;
+  at::Tensor bias_contig;
+  const float* bias_ptr = bias_data(bias, N, bias_contig);
+
+  const auto q_params = quant_utils::ChooseQuantizationParams(
+      /*min=*/input_min,
+      /*max=*/input_max,
+      /*qmin=*/0,
+      /*qmax=*/255);
+  const auto q_input = at::quantize_per_tensor(
+      input.contiguous(), q_params.scale, q_params.zero_point, kQUInt8);
+
+  auto output = at::empty(output_sizes(input, N), input.options().dtype(kFloat));
+  float* output_ptr = output.data_ptr<float>();
+
+  const float input_scale = q_params.scale;
+  block_sparse_gemm(
+      *this,
+      reinterpret_cast<uint8_t*>(q_input.data_ptr<c10::quint8>()),
+      M,
+      q_params.zero_point,
+      [&](int64_t n, const int32_t* acc) {
+        const float multiplier = input_scale * w_scale[n];
+        const float b = bias_ptr ? bias_ptr[n] : 0.0f;
+        for (int64_t m = 0; m < M; ++m) {
+          const float y = acc[m] * multiplier + b;
+          output_ptr[m * N + n] = relu ? std::max(y, 0.0f) : y;
+        }
+      });
+  return output;
+}
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <ATen/ATen.h>
+
+#include <memory>
+#include <vector>
+
+namespace at {
+namespace native {
+
+// The int8 weight of a linear layer pruned to blocks of 1 x kBlockSize
+// weights, stored in the block compressed sparse row (BCSR) format. The
+// weights of output channel n are the blocks row_offsets[n] to
+// row_offsets[n + 1] - 1, block b covering the input channels
+// block_columns[b] to block_columns[b] + kBlockSize - 1 with the values
+// values[b * kBlockSize] to values[(b + 1) * kBlockSize - 1]. The values have
+// the zero point of their output channel subtracted, so that the blocks left
+// out contribute nothing to the accumulation, and the ones past the last
+// input channel are zero.
+//
+// quantized::linear_prepack packs the weights whose fraction of nonzero blocks
+// is at most kMaxDensity in this format, with both the FBGEMM and the QNNPACK
+// engines, and quantized::linear and quantized::linear_dynamic run them with
+// the kernels below instead of the dense GEMM of the engine.
+struct CAFFE2_API BlockSparseLinearWeight {
+  static constexpr int64_t kBlockSize = 4;
+  static constexpr double kMaxDensity = 0.25;
+
+  int64_t output_channels;
+  int64_t input_channels;
+  std::vector<int32_t> row_offsets;
+  std::vector<int32_t> block_columns;
+  std::vector<int16_t> values;
+  // The weight scales and zero points, one per output channel.
+  std::vector<float> w_scale;
+  std::vector<int32_t> w_zp;
+
+  // Returns the block-sparse packing of a per tensor or per output channel
+  // quantized 2D qint8 weight, or nullptr if it is too dense for it.
+  static std::unique_ptr<BlockSparseLinearWeight> pack_if_sparse(
+      const at::Tensor& weight);
+
+  // Writes the output_channels x input_channels int8 weight the packing was
+  // created from.
+  void unpack(int8_t* weight) const;
+
+  // quantized::linear: the quint8 output of the quint8 input, requantized to
+  // output_scale and output_zero_point.
+  at::Tensor apply(
+      const at::Tensor& input,
+      const c10::optional<at::Tensor>& bias,
+      double output_scale,
+      int64_t output_zero_point,
+      bool relu) const;
+
+  // quantized::linear_dynamic: the float output of the float input, quantized
+  // to quint8 with the range [input_min, input_max].
+  at::Tensor apply_dynamic(
+      const at::Tensor& input,
+      float input_min,
+      float input_max,
+      const c10::optional<at::Tensor>& bias,
+      bool relu) const;
+};
+
+} // namespace native
+} // namespace at
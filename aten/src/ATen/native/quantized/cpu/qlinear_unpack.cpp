@@ -17,9 +17,12 @@ class QLinearUnpackWeightInt8 final {
     auto& pack_ptr =
         cpp_custom_type_hack::cast<PackedLinearWeight>(packed_weight);
     auto packB = pack_ptr.w.get();
+    const auto& sparse = pack_ptr.sparse;
 
-    int64_t N = static_cast<int64_t>(packB->numCols());
-    int64_t K = static_cast<int64_t>(packB->numRows());
+    int64_t N = sparse ? sparse->output_channels
+                       : static_cast<int64_t>(packB->numCols());
+    int64_t K = sparse ? sparse->input_channels
+                       : static_cast<int64_t>(packB->numRows());
 
     Tensor weight_origin;
     if (pack_ptr.q_scheme == kPerTensorAffine) {
@@ -49,7 +52,11 @@ class QLinearUnpackWeightInt8 final {
 
     // packB->printPackedMatrix("packedB inside fbgemm_unpack
     // (QLinearUnpackWeightInt8): ");
-    packB->unpack(weight_ptr_int8);
+    if (sparse) {
+      sparse->unpack(weight_ptr_int8);
+    } else {
+      packB->unpack(weight_ptr_int8);
+    }
 
     return std::tuple<at::Tensor, c10::optional<Tensor>>(
         weight_origin, pack_ptr.bias);
@@ -107,6 +107,35 @@ enum pytorch_qnnp_status qnnpackConv(
     uint8_t* output,
     pthreadpool_t threadpool);
 
+/*
+ * Convolution requantized to (conv_scale, conv_zero_point) within
+ * [conv_p.output_min, conv_p.output_max], plus accum, requantized to
+ * (output_scale, output_zero_point) within [output_min, output_max]. The
+ * addition is done on every tile of the output right after the convolution
+ * ukernel writes it, while it is still in cache. accum has the layout of the
+ * output.
+ */
+enum pytorch_qnnp_status qnnpackConvAdd(
+    const conv_param_t& conv_p,
+    void* packed_weights,
+    const size_t batch_size,
+    const size_t input_height,
+    const size_t input_width,
+    const float input_scale,
+    const uint8_t input_zero_point,
+    const uint8_t* input,
+    const float conv_scale,
+    const uint8_t conv_zero_point,
+    const float accum_scale,
+    const uint8_t accum_zero_point,
+    const uint8_t* accum,
+    const float output_scale,
+    const uint8_t output_zero_point,
+    const uint8_t output_min,
+    const uint8_t output_max,
+    uint8_t* output,
+    pthreadpool_t threadpool);
+
 enum pytorch_qnnp_status qnnpackLinearDynamic(
     const size_t batch_size,
     const size_t input_channels,
@@ -7,6 +7,36 @@
 
 namespace qnnpack {
 
+struct accumulator_add_context {
+  const uint8_t* accum;
+  union pytorch_qnnp_add_quantization_params quantization_params;
+  const pytorch_q8vadd_ukernel_function ukernel;
+};
+/*
+ * Adds the accumulator to the rows x columns tile at offset of the output,
+ * which the convolution ukernel just wrote, and requantizes the sum in place.
+ */
+static void add_accumulator(
+    const struct accumulator_add_context* context,
+    uint8_t* output,
+    size_t offset,
+    size_t rows,
+    size_t columns,
+    size_t stride) {
+  if (context == nullptr) {
+    return;
+  }
+  for (size_t row = 0; row < rows; row++) {
+    uint8_t* c = output + offset + row * stride;
+    context->ukernel(
+        columns,
+        c,
+        context->accum + offset + row * stride,
+        c,
+        &context->quantization_params);
+  }
+}
+
 struct q8gemm_xzp_context {
   size_t k;
   size_t k_stride;
@@ -23,6 +53,7 @@ struct q8gemm_xzp_context {
   size_t a_sum_stride;
   union pytorch_qnnp_q31_requantization_params requantization_params;
   const pytorch_q8gemm_xzp_ukernel_function ukernel;
+  const struct accumulator_add_context* accumulator;
 };
 static void compute_q8gemm_xzp(
     const struct q8gemm_xzp_context context[1],
@@ -60,6 +91,14 @@ static void compute_q8gemm_xzp(
           group_index * n,
       c_stride,
       &context->requantization_params);
+  add_accumulator(
+      context->accumulator,
+      c,
+      (pixel_index + mr_block_start) * c_stride + nr_block_start +
+          group_index * n,
+      mr_block_size,
+      nr_block_size,
+      c_stride);
 }
 
 struct q8gemm_context {
@@ -74,6 +113,7 @@ struct q8gemm_context {
   size_t c_stride;
   union pytorch_qnnp_conv_quantization_params quantization_params;
   const pytorch_q8gemm_ukernel_function ukernel;
+  const struct accumulator_add_context* accumulator;
 };
 static void compute_q8gemm(
     const struct q8gemm_context context[1],
@@ -106,6 +146,14 @@ static void compute_q8gemm(
           group_index * n,
       c_stride,
       &context->quantization_params);
+  add_accumulator(
+      context->accumulator,
+      c,
+      (pixel_index + mr_block_start) * c_stride + nr_block_start +
+          group_index * n,
+      mr_block_size,
+      nr_block_size,
+      c_stride);
 }
 
 struct q8conv_context {
@@ -123,6 +171,7 @@ struct q8conv_context {
   size_t c_stride;
   union pytorch_qnnp_conv_quantization_params quantization_params;
   const pytorch_q8conv_ukernel_function ukernel;
+  const struct accumulator_add_context* accumulator;
 };
 static void compute_q8conv(
     const struct q8conv_context context[1],
@@ -159,6 +208,14 @@ static void compute_q8conv(
           nr_block_start,
       c_stride,
       &context->quantization_params);
+  add_accumulator(
+      context->accumulator,
+      c,
+      (mr_block_start + image_index * m) * c_stride + group_index * n +
+          nr_block_start,
+      mr_block_size,
+      nr_block_size,
+      c_stride);
 }
 
 struct q8sum_rows_context {
@@ -214,6 +271,7 @@ struct q8dwconv_context {
   union pytorch_qnnp_conv_quantization_params quantization_params;
   const pytorch_q8dwconv_up_ukernel_function unipass_ukernel;
   const pytorch_q8dwconv_mp_ukernel_function multipass_ukernel;
+  const struct accumulator_add_context* accumulator;
 };
 static void compute_dwconv_unipass(
     const struct q8dwconv_context context[1],
@@ -233,6 +291,13 @@ static void compute_dwconv_unipass(
       context->indirection_buffer_col_stride,
       context->output_col_increment,
       &context->quantization_params);
+  add_accumulator(
+      context->accumulator,
+      context->output,
+      (image * output_height + output_y) * context->output_row_stride,
+      1,
+      context->output_row_stride,
+      0);
 }
 static void compute_dwconv_multiipass(
     const struct q8dwconv_context context[1],
@@ -259,6 +324,13 @@ static void compute_dwconv_multiipass(
       context->indirection_buffer_col_stride,
       context->output_col_increment,
       &context->quantization_params);
+  add_accumulator(
+      context->accumulator,
+      context->output,
+      (image * output_height + output_y) * context->output_row_stride,
+      1,
+      context->output_row_stride,
+      0);
 
 #ifdef _MSC_VER
   _freea(multipass_acc);
@@ -271,7 +343,7 @@ struct QnnpackDeleter {
   }
 };
 
-enum pytorch_qnnp_status qnnpackConv(
+static enum pytorch_qnnp_status qnnpackConvImpl(
     const conv_param_t& conv_p,
     void* packed_weights,
     const size_t batch_size,
@@ -283,6 +355,7 @@ enum pytorch_qnnp_status qnnpackConv(
     const float output_scale,
     const uint8_t output_zero_point,
     uint8_t* output,
+    const struct accumulator_add_context* accumulator,
     pthreadpool_t threadpool) {
   const size_t input_pixel_stride = conv_p.input_channels;
   const size_t output_pixel_stride = conv_p.output_channels;
@@ -437,6 +510,7 @@ enum pytorch_qnnp_status qnnpackConv(
               .quantization_params = conv_quantization_params,
               .unipass_ukernel = pytorch_qnnp_params.q8dw9.updw,
               .multipass_ukernel = pytorch_qnnp_params.q8dw25.mpdw,
+              .accumulator = accumulator,
           };
           pthreadpool_compute_2d(
               threadpool,
@@ -466,6 +540,7 @@ enum pytorch_qnnp_status qnnpackConv(
               .quantization_params = conv_quantization_params,
               .unipass_ukernel = pytorch_qnnp_params.q8dw9.updw,
               .multipass_ukernel = pytorch_qnnp_params.q8dw25.mpdw,
+              .accumulator = accumulator,
           };
           pthreadpool_compute_2d(
               threadpool,
@@ -539,6 +614,7 @@ enum pytorch_qnnp_status qnnpackConv(
           .a_sum_stride = input_size,
           .requantization_params = requantization_params,
           .ukernel = pytorch_qnnp_params.q8conv_xzp.gemm,
+          .accumulator = accumulator,
       };
       pthreadpool_compute_4d_tiled(
           threadpool,
@@ -575,6 +651,7 @@ enum pytorch_qnnp_status qnnpackConv(
           .c_stride = output_pixel_stride,
           .quantization_params = conv_quantization_params,
           .ukernel = pytorch_qnnp_params.q8conv.gemm,
+          .accumulator = accumulator,
       };
 
       pthreadpool_compute_4d_tiled(
@@ -653,6 +730,7 @@ enum pytorch_qnnp_status qnnpackConv(
           .c_stride = output_pixel_stride,
           .quantization_params = conv_quantization_params,
           .ukernel = pytorch_qnnp_params.q8conv.conv,
+          .accumulator = accumulator,
       };
 
       pthreadpool_compute_4d_tiled(
@@ -676,4 +754,98 @@ enum pytorch_qnnp_status qnnpackConv(
   }
   return pytorch_qnnp_status_success;
 }
+
+enum pytorch_qnnp_status qnnpackConv(
+    const conv_param_t& conv_p,
+    void* packed_weights,
+    const size_t batch_size,
+    const size_t input_height,
+    const size_t input_width,
+    const float input_scale,
+    const uint8_t input_zero_point,
+    const uint8_t* input,
+    const float output_scale,
+    const uint8_t output_zero_point,
+    uint8_t* output,
+    pthreadpool_t threadpool) {
+  return qnnpackConvImpl(
+      conv_p,
+      packed_weights,
+      batch_size,
+      input_height,
+      input_width,
+      input_scale,
+      input_zero_point,
+      input,
+      output_scale,
+      output_zero_point,
+      output,
+      /*accumulator=*/nullptr,
+      threadpool);
+}
+
+enum pytorch_qnnp_status qnnpackConvAdd(
+    const conv_param_t& conv_p,
+    void* packed_weights,
+    const size_t batch_size,
+    const size_t input_height,
+    const size_t input_width,
+    const float input_scale,
+    const uint8_t input_zero_point,
+    const uint8_t* input,
+    const float conv_scale,
+    const uint8_t conv_zero_point,
+    const float accum_scale,
+    const uint8_t accum_zero_point,
+    const uint8_t* accum,
+    const float output_scale,
+    const uint8_t output_zero_point,
+    const uint8_t output_min,
+    const uint8_t output_max,
+    uint8_t* output,
+    pthreadpool_t threadpool) {
+  const float conv_output_scale = conv_scale / output_scale;
+  if (conv_output_scale < 0x1.0p-14f || conv_output_scale >= 0x1.0p+8f) {
+    pytorch_qnnp_log_error(
+        "failed to run convolution with %.7g convolution-to-output scale ratio: "
+        "scale ratio must be in [2**-14, 2**8) range",
+        conv_output_scale);
+    return pytorch_qnnp_status_unsupported_parameter;
+  }
+  const float accum_output_scale = accum_scale / output_scale;
+  if (accum_output_scale < 0x1.0p-14f || accum_output_scale >= 0x1.0p+8f) {
+    pytorch_qnnp_log_error(
+        "failed to run convolution with %.7g accumulator-to-output scale ratio: "
+        "scale ratio must be in [2**-14, 2**8) range",
+        accum_output_scale);
+    return pytorch_qnnp_status_unsupported_parameter;
+  }
+
+  const struct accumulator_add_context accumulator = {
+      .accum = accum,
+      .quantization_params = pytorch_qnnp_compute_add_quantization_params(
+          conv_zero_point,
+          accum_zero_point,
+          output_zero_point,
+          conv_output_scale,
+          accum_output_scale,
+          output_min,
+          output_max),
+      .ukernel = pytorch_qnnp_params.q8vadd,
+  };
+  return qnnpackConvImpl(
+      conv_p,
+      packed_weights,
+      batch_size,
+      input_height,
+      input_width,
+      input_scale,
+      input_zero_point,
+      input,
+      conv_scale,
+      conv_zero_point,
+      output,
+      &accumulator,
+      threadpool);
+}
 } // namespace qnnpack
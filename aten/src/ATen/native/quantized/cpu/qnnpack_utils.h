@@ -5,6 +5,8 @@
 #include <qnnpack_func.h>
 
 #include <ATen/native/quantized/cpu/conv_packed_params.h>
+#include <ATen/native/quantized/cpu/qlinear_sparse.h>
+#include <ATen/native/quantized/cpu/quant_utils.h>
 
 struct QnnpackOperatorDeleter {
   void operator()(pytorch_qnnp_operator_t op) {
@@ -28,6 +30,12 @@ struct PackedLinearWeightsQnnp {
   c10::optional<double> input_scale;
   double w_scale;
   int64_t w_zp;
+  // See quantized::linear_dynamic_cached_range
+  std::unique_ptr<quant_utils::InputRangeCache> input_range =
+      std::make_unique<quant_utils::InputRangeCache>();
+  // Set for the pruned weights, which are run without ever packing w, see
+  // BlockSparseLinearWeight.
+  std::unique_ptr<at::native::BlockSparseLinearWeight> sparse;
 };
 
 template <int kSpatialDim = 2>
@@ -78,6 +86,18 @@ struct PackedConvWeightsQnnp : public ConvPackedParamsBase<kSpatialDim> {
       double output_scale,
       int64_t output_zero_point) override;
 
+  at::Tensor apply_add(
+      const at::Tensor& input,
+      const at::Tensor& accum,
+      double output_scale,
+      int64_t output_zero_point) override;
+
+  at::Tensor apply_add_relu(
+      const at::Tensor& input,
+      const at::Tensor& accum,
+      double output_scale,
+      int64_t output_zero_point) override;
+
   std::tuple<at::Tensor, c10::optional<at::Tensor>> unpack() override;
 
   static c10::intrusive_ptr<ConvPackedParamsBase<kSpatialDim>> prepack(
@@ -105,9 +125,11 @@ struct PackedConvWeightsQnnp : public ConvPackedParamsBase<kSpatialDim> {
   }
 
  private:
+  // With accum, see apply_add()
   template <bool ReluFused>
   at::Tensor apply_impl(
       const at::Tensor& input,
+      const c10::optional<at::Tensor>& accum,
       double output_scale,
       int64_t output_zero_point);
 };
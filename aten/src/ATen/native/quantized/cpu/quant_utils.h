@@ -3,6 +3,8 @@
 #include <ATen/ATen.h>
 #include <algorithm>
 #include <cmath>
+#include <mutex>
+#include <utility>
 
 namespace quant_utils {
 using namespace std;
@@ -121,4 +123,32 @@ inline TensorQuantizationParams ChooseQuantizationParams(
   return result;
 }
 
+// The range of the inputs of a dynamically quantized layer, cached by the
+// operators that run with a range refresh interval, which compute the range
+// of their input once every refresh_interval calls instead of on every call.
+// Inputs outside of a cached range saturate, like those of a statically
+// quantized layer.
+class InputRangeCache {
+ public:
+  // Returns the (min, max) range to quantize the input with, computing it with
+  // compute_range() on the first call and on every refresh_interval-th call
+  // after it.
+  template <typename ComputeRange>
+  std::pair<float, float> get(
+      int64_t refresh_interval,
+      const ComputeRange& compute_range) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (calls_ % refresh_interval == 0) {
+      range_ = compute_range();
+    }
+    ++calls_;
+    return range_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::pair<float, float> range_{0.f, 0.f};
+  int64_t calls_ = 0;
+};
+
 } // namespace quant_utils
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/cuda/CUDAConfig.h>
+#include <ATen/native/quantized/cpu/conv_packed_params.h>
+
+// The packed weights of the QuantizedCUDA linear and convolution. The int8
+// GEMMs and convolutions of cuBLAS and cuDNN take signed activations and
+// have no zero points: the quint8 activations are shifted to int8 by
+// subtracting 128 and the weights must be symmetric (zero point 0), so that
+//
+//   sum((x - x_zp) * w) = sum((x - 128) * w) - (x_zp - 128) * sum(w)
+//
+// where the sums of the weights (w_sum) are computed in the prepacking step.
+// The int8 GEMMs and convolutions also need the reduction dimension to be a
+// multiple of 4, which the packed weights are padded to with zeros.
+
+#ifndef __HIP_PLATFORM_HCC__
+// The weight of the fully connected layer as an N x K_padded int8 matrix
+struct PackedLinearWeightCublas {
+  at::Tensor w;
+  at::Tensor w_sum;
+  c10::optional<at::Tensor> bias;
+  int64_t input_channels;
+  double w_scale;
+};
+#endif
+
+#if AT_CUDNN_ENABLED()
+// The weight of the convolution as a K x R x S x C_padded (NHWC) int8 filter
+struct PackedConvWeightCudnn : public ConvPackedParamsBase<2> {
+  PackedConvWeightCudnn(
+      at::Tensor w,
+      at::Tensor w_sum,
+      c10::optional<at::Tensor> bias,
+      at::Tensor orig_weight,
+      torch::List<int64_t> stride,
+      torch::List<int64_t> padding,
+      torch::List<int64_t> dilation,
+      int64_t groups,
+      double w_scale)
+      : w(std::move(w)),
+        w_sum(std::move(w_sum)),
+        bias(std::move(bias)),
+        orig_weight(std::move(orig_weight)),
+        stride_(std::move(stride)),
+        padding_(std::move(padding)),
+        dilation_(std::move(dilation)),
+        groups_(groups),
+        w_scale(w_scale) {}
+
+  at::Tensor w;
+  at::Tensor w_sum;
+  c10::optional<at::Tensor> bias;
+  at::Tensor orig_weight;
+  torch::List<int64_t> stride_;
+  torch::List<int64_t> padding_;
+  torch::List<int64_t> dilation_;
+  int64_t groups_;
+  double w_scale;
+
+  at::Tensor apply(
+      const at::Tensor& input,
+      double output_scale,
+      int64_t output_zero_point) override;
+
+  at::Tensor apply_relu(
+      const at::Tensor& input,
+      double output_scale,
+      int64_t output_zero_point) override;
+
+  at::Tensor apply_add(
+      const at::Tensor& input,
+      const at::Tensor& accum,
+      double output_scale,
+      int64_t output_zero_point) override;
+
+  at::Tensor apply_add_relu(
+      const at::Tensor& input,
+      const at::Tensor& accum,
+      double output_scale,
+      int64_t output_zero_point) override;
+
+  std::tuple<at::Tensor, c10::optional<at::Tensor>> unpack() override;
+
+  static c10::intrusive_ptr<ConvPackedParamsBase<2>> prepack(
+      at::Tensor weight,
+      c10::optional<at::Tensor> bias,
+      torch::List<int64_t> stride,
+      torch::List<int64_t> padding,
+      torch::List<int64_t> dilation,
+      int64_t groups);
+
+  torch::List<int64_t> stride() const override {
+    return stride_;
+  }
+
+  torch::List<int64_t> padding() const override {
+    return padding_;
+  }
+
+  torch::List<int64_t> dilation() const override {
+    return dilation_;
+  }
+
+  int64_t groups() const override {
+    return groups_;
+  }
+
+ private:
+  at::Tensor apply_impl(
+      const at::Tensor& input,
+      const c10::optional<at::Tensor>& accum,
+      bool relu,
+      double output_scale,
+      int64_t output_zero_point);
+};
+#endif // AT_CUDNN_ENABLED()
+
+namespace at {
+namespace native {
+
+// The activation quint8 tensor as int8, shifted by -128 (see above)
+inline Tensor quantized_cuda_shift_to_int8(const Tensor& input) {
+  return (input.int_repr().to(kInt) - 128).to(kChar);
+}
+
+// Requantizes the int32 (or float holding int32) result acc of the int8 GEMM
+// or convolution of the shifted input with the packed weights, whose channels
+// are the last dimension of acc, adding in the float dequantized accum (of the
+// shape of acc) if any, to quint8.
+inline Tensor quantized_cuda_requantize(
+    const Tensor& acc,
+    const Tensor& w_sum,
+    const c10::optional<Tensor>& bias,
+    double input_scale,
+    int64_t input_zero_point,
+    double w_scale,
+    const c10::optional<Tensor>& accum,
+    bool relu,
+    double output_scale,
+    int64_t output_zero_point) {
+  const double scale = input_scale * w_scale;
+  // bias - (x_zp - 128) * sum(w) in the real domain, per channel
+  Tensor offset = w_sum * (-scale * (input_zero_point - 128));
+  if (bias.has_value() && bias->defined()) {
+    offset.add_(*bias);
+  }
+  Tensor real = acc.to(kFloat).mul_(scale).add_(offset);
+  if (accum.has_value()) {
+    real.add_(*accum);
+  }
+  if (relu) {
+    real.relu_();
+  }
+  return at::quantize_per_tensor(
+      real, output_scale, output_zero_point, kQUInt8);
+}
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,239 @@
+#include <ATen/ATen.h>
+#include <torch/library.h>
+#include <ATen/native/quantized/cuda/cuda_utils.h>
+
+#if AT_CUDNN_ENABLED()
+
+#include <ATen/cudnn/Descriptors.h>
+#include <ATen/cudnn/Handle.h>
+
+at::Tensor PackedConvWeightCudnn::apply(
+    const at::Tensor& input,
+    double output_scale,
+    int64_t output_zero_point) {
+  return apply_impl(
+      input, c10::nullopt, /*relu=*/false, output_scale, output_zero_point);
+}
+
+at::Tensor PackedConvWeightCudnn::apply_relu(
+    const at::Tensor& input,
+    double output_scale,
+    int64_t output_zero_point) {
+  return apply_impl(
+      input, c10::nullopt, /*relu=*/true, output_scale, output_zero_point);
+}
+
+at::Tensor PackedConvWeightCudnn::apply_add(
+    const at::Tensor& input,
+    const at::Tensor& accum,
+    double output_scale,
+    int64_t output_zero_point) {
+  return apply_impl(input, accum, /*relu=*/false, output_scale, output_zero_point);
+}
+
+at::Tensor PackedConvWeightCudnn::apply_add_relu(
+    const at::Tensor& input,
+    const at::Tensor& accum,
+    double output_scale,
+    int64_t output_zero_point) {
+  return apply_impl(input, accum, /*relu=*/true, output_scale, output_zero_point);
+}
+
+std::tuple<at::Tensor, c10::optional<at::Tensor>> PackedConvWeightCudnn::
+    unpack() {
+  return std::tuple<at::Tensor, c10::optional<at::Tensor>>(orig_weight, bias);
+}
+
+// The convolution runs in cuDNN's INT8_EXT configuration: int8 NHWC input and
+// filter, int32 accumulation and float NHWC output, which the requantization
+// then reads. The input is padded explicitly with its (shifted) zero point so
+// that the zero point correction is the same at the borders, and the channels
+// are padded to the multiple of 4 of the packed filter.
+at::Tensor PackedConvWeightCudnn::apply_impl(
+    const at::Tensor& act,
+    const c10::optional<at::Tensor>& accum,
+    bool relu,
+    double output_scale,
+    int64_t output_zero_point) {
+  TORCH_CHECK(
+      act.ndimension() == 4,
+      "quantized::conv2d (cudnn): Expected activation tensor to have 4 "
+      "dimensions");
+  TORCH_CHECK(
+      act.scalar_type() == at::kQUInt8,
+      "quantized::conv2d (cudnn): Expected activation data type quint8");
+  const int64_t N = act.size(0);
+  const int64_t C = act.size(1);
+  const int64_t H = act.size(2);
+  const int64_t W = act.size(3);
+  const int64_t K = w.size(0);
+  const int64_t R = w.size(1);
+  const int64_t S = w.size(2);
+  const int64_t C_padded = w.size(3);
+  TORCH_CHECK(
+      C == orig_weight.size(1),
+      "quantized::conv2d (cudnn): Input channels of the activation (",
+      C,
+      ") and of the weight (",
+      orig_weight.size(1),
+      ") differ");
+  const int64_t pad_h = padding_[0];
+  const int64_t pad_w = padding_[1];
+  const int act_zero_point = act.q_zero_point();
+
+  // N x C x H x W -> N x (H + 2 pad_h) x (W + 2 pad_w) x C_padded
+  at::Tensor input = at::constant_pad_nd(
+      at::native::quantized_cuda_shift_to_int8(act).permute({0, 2, 3, 1}),
+      {0, C_padded - C, pad_w, pad_w, pad_h, pad_h},
+      act_zero_point - 128).contiguous();
+
+  at::native::TensorDescriptor idesc;
+  AT_CUDNN_CHECK(cudnnSetTensor4dDescriptor(
+      idesc.mut_desc(),
+      CUDNN_TENSOR_NHWC,
+      CUDNN_DATA_INT8,
+      N,
+      C_padded,
+      H + 2 * pad_h,
+      W + 2 * pad_w));
+  at::native::FilterDescriptor wdesc;
+  AT_CUDNN_CHECK(cudnnSetFilter4dDescriptor(
+      wdesc.mut_desc(), CUDNN_DATA_INT8, CUDNN_TENSOR_NHWC, K, C_padded, R, S));
+  at::native::ConvolutionDescriptor cdesc;
+  AT_CUDNN_CHECK(cudnnSetConvolution2dDescriptor(
+      cdesc.mut_desc(),
+      0,
+      0,
+      stride_[0],
+      stride_[1],
+      dilation_[0],
+      dilation_[1],
+      CUDNN_CROSS_CORRELATION,
+      CUDNN_DATA_INT32));
+  int out_n, out_k, out_h, out_w;
+  AT_CUDNN_CHECK(cudnnGetConvolution2dForwardOutputDim(
+      cdesc.desc(), idesc.desc(), wdesc.desc(), &out_n, &out_k, &out_h, &out_w));
+  at::Tensor output =
+      at::empty({out_n, out_h, out_w, out_k}, act.options().dtype(at::kFloat));
+  at::native::TensorDescriptor odesc;
+  AT_CUDNN_CHECK(cudnnSetTensor4dDescriptor(
+      odesc.mut_desc(),
+      CUDNN_TENSOR_NHWC,
+      CUDNN_DATA_FLOAT,
+      out_n,
+      out_k,
+      out_h,
+      out_w));
+
+  // The only algorithm of the int8 convolutions
+  const auto algo = CUDNN_CONVOLUTION_FWD_ALGO_IMPLICIT_PRECOMP_GEMM;
+  cudnnHandle_t handle = at::native::getCudnnHandle();
+  size_t workspace_size = 0;
+  AT_CUDNN_CHECK(cudnnGetConvolutionForwardWorkspaceSize(
+      handle,
+      idesc.desc(),
+      wdesc.desc(),
+      cdesc.desc(),
+      odesc.desc(),
+      algo,
+      &workspace_size));
+  at::Tensor workspace = at::empty(
+      {static_cast<int64_t>(workspace_size)}, act.options().dtype(at::kByte));
+  const float alpha = 1;
+  const float beta = 0;
+  AT_CUDNN_CHECK(cudnnConvolutionForward(
+      handle,
+      &alpha,
+      idesc.desc(),
+      input.data_ptr(),
+      wdesc.desc(),
+      w.data_ptr(),
+      cdesc.desc(),
+      algo,
+      workspace.data_ptr(),
+      workspace_size,
+      &beta,
+      odesc.desc(),
+      output.data_ptr()));
+
+  c10::optional<at::Tensor> accum_nhwc;
+  if (accum.has_value()) {
+    TORCH_CHECK(
+        accum->scalar_type() == at::kQUInt8 &&
+            accum->sizes() ==
+                at::IntArrayRef({out_n, out_k, out_h, out_w}),
+        "quantized::conv2d_add (cudnn): Expected a quint8 accumulator of the "
+        "shape of the output");
+    accum_nhwc = accum->dequantize().permute({0, 2, 3, 1});
+  }
+  // N x OH x OW x K -> N x K x OH x OW, in the channels last memory format
+  return at::native::quantized_cuda_requantize(
+             output,
+             w_sum,
+             bias,
+             act.q_scale(),
+             act_zero_point,
+             w_scale,
+             accum_nhwc,
+             relu,
+             output_scale,
+             output_zero_point)
+      .permute({0, 3, 1, 2});
+}
+
+namespace at {
+namespace native {
+namespace {
+
+template <bool kReluFused>
+class QConvInt8Cudnn final {
+ public:
+  static Tensor run(
+      Tensor act,
+      const c10::intrusive_ptr<ConvPackedParamsBase<2>>& packed_weight,
+      double output_scale,
+      int64_t output_zero_point) {
+    if (kReluFused) {
+      return packed_weight->apply_relu(act, output_scale, output_zero_point);
+    } else {
+      return packed_weight->apply(act, output_scale, output_zero_point);
+    }
+  }
+};
+
+template <bool kReluFused>
+class QConvAddInt8Cudnn final {
+ public:
+  static Tensor run(
+      Tensor act,
+      Tensor accum,
+      const c10::intrusive_ptr<ConvPackedParamsBase<2>>& packed_weight,
+      double output_scale,
+      int64_t output_zero_point) {
+    if (kReluFused) {
+      return packed_weight->apply_add_relu(
+          act, accum, output_scale, output_zero_point);
+    } else {
+      return packed_weight->apply_add(
+          act, accum, output_scale, output_zero_point);
+    }
+  }
+};
+
+TORCH_LIBRARY_IMPL(quantized, QuantizedCUDA, m) {
+  m.impl("conv2d.new",      QConvInt8Cudnn<false>::run);
+  m.impl("conv2d_relu.new", QConvInt8Cudnn<true>::run);
+  m.impl("conv2d_add",      QConvAddInt8Cudnn<false>::run);
+  m.impl("conv2d_add_relu", QConvAddInt8Cudnn<true>::run);
+}
+
+TORCH_LIBRARY_IMPL(_quantized, QuantizedCUDA, m) {
+  m.impl("conv2d",      QConvInt8Cudnn<false>::run);
+  m.impl("conv2d_relu", QConvInt8Cudnn<true>::run);
+}
+
+} // namespace
+} // namespace native
+} // namespace at
+
+#endif // AT_CUDNN_ENABLED()
@@ -0,0 +1,98 @@
+#include <ATen/ATen.h>
+#include <torch/library.h>
+#include <ATen/native/quantized/cuda/cuda_utils.h>
+
+#if AT_CUDNN_ENABLED()
+
+c10::intrusive_ptr<ConvPackedParamsBase<2>> PackedConvWeightCudnn::prepack(
+    at::Tensor weight,
+    c10::optional<at::Tensor> bias,
+    torch::List<int64_t> stride,
+    torch::List<int64_t> padding,
+    torch::List<int64_t> dilation,
+    int64_t groups) {
+  TORCH_CHECK(
+      weight.ndimension() == 4,
+      "quantized::conv2d_prepack (cudnn): Weights are expected to have 4 "
+      "dimensions");
+  TORCH_CHECK(
+      weight.scalar_type() == at::kQInt8,
+      "quantized::conv2d_prepack (cudnn): Weight should be qint8");
+  TORCH_CHECK(
+      weight.qscheme() == at::kPerTensorAffine && weight.q_zero_point() == 0,
+      "quantized::conv2d_prepack (cudnn) only supports symmetric Per Tensor "
+      "Quantization Scheme (zero point 0)");
+  TORCH_CHECK(stride.size() == 2, "2D convolution only");
+  TORCH_CHECK(
+      padding.size() == 2,
+      "Specify front/top/left padding only. "
+      "end/bottom/right padding assumed to be equal to front/top/left");
+  TORCH_CHECK(dilation.size() == 2, "2D convolution only");
+  TORCH_CHECK(
+      groups == 1,
+      "quantized::conv2d_prepack (cudnn) only supports groups == 1");
+
+  const int64_t output_channels = weight.size(0);
+  const int64_t input_channels = weight.size(1);
+  const int64_t input_channels_padded = (input_channels + 3) / 4 * 4;
+  // K x C x R x S -> K x R x S x C_padded
+  at::Tensor w = at::constant_pad_nd(
+      weight.int_repr().permute({0, 2, 3, 1}),
+      {0, input_channels_padded - input_channels},
+      0).contiguous();
+  at::Tensor w_sum = w.to(at::kInt).sum({1, 2, 3}).to(at::kFloat);
+
+  c10::optional<at::Tensor> bias_contig;
+  if (bias.has_value()) {
+    at::Tensor bias_vec = bias.value();
+    TORCH_CHECK(bias_vec.dim() == 1, "bias should be a vector (1D Tensor)");
+    TORCH_CHECK(
+        bias_vec.size(0) == output_channels,
+        "bias should have K elements: " + std::to_string(output_channels));
+    bias_contig = bias_vec.to(weight.device(), at::kFloat).contiguous();
+  }
+  return c10::make_intrusive<PackedConvWeightCudnn>(
+      std::move(w),
+      std::move(w_sum),
+      bias_contig,
+      weight,
+      stride,
+      padding,
+      dilation,
+      groups,
+      weight.q_scale());
+}
+
+namespace at {
+namespace native {
+namespace {
+
+class QConvPackWeightInt8Cudnn final {
+ public:
+  static c10::intrusive_ptr<ConvPackedParamsBase<2>> run(
+      Tensor weight,
+      c10::optional<Tensor> bias,
+      torch::List<int64_t> stride,
+      torch::List<int64_t> padding,
+      torch::List<int64_t> dilation,
+      int64_t groups) {
+    return PackedConvWeightCudnn::prepack(
+        weight, bias, stride, padding, dilation, groups);
+  }
+};
+
+TORCH_LIBRARY_IMPL(quantized, QuantizedCUDA, m) {
+  // conv_prepack is deprecated, please use conv2d_prepack for 2D conv.
+  m.impl("conv_prepack", QConvPackWeightInt8Cudnn::run);
+  m.impl("conv2d_prepack", QConvPackWeightInt8Cudnn::run);
+}
+
+TORCH_LIBRARY_IMPL(_quantized, QuantizedCUDA, m) {
+  m.impl("conv2d_prepack", QConvPackWeightInt8Cudnn::run);
+}
+
+} // namespace
+} // namespace native
+} // namespace at
+
+#endif // AT_CUDNN_ENABLED()
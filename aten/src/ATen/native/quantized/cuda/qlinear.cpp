@@ -0,0 +1,90 @@
+#include <ATen/ATen.h>
+#include <torch/library.h>
+#include <ATen/cpp_custom_type_hack.h>
+#include <ATen/cuda/CUDABlas.h>
+#include <ATen/native/quantized/cuda/cuda_utils.h>
+
+#include <string>
+
+#ifndef __HIP_PLATFORM_HCC__
+namespace at {
+namespace native {
+namespace {
+
+template <bool ReluFused>
+class QLinearInt8Cuda final {
+ public:
+  static at::Tensor run(
+      at::Tensor input,
+      at::Tensor packed_weight,
+      double output_scale,
+      int64_t output_zero_point) {
+    TORCH_CHECK(
+        input.scalar_type() == kQUInt8,
+        "quantized::linear (cuda): Input should be quint8");
+    TORCH_CHECK(
+        input.dim() >= 2,
+        "The dimension of input tensor should be larger than or equal to 2");
+    auto& pack_ptr =
+        cpp_custom_type_hack::cast<PackedLinearWeightCublas>(packed_weight);
+    // C(output) = A(input) x B(weight)^T, where C, A, B are M x N, M x K,
+    // N x K matrices, respectively.
+    const int64_t M = size_to_dim_(input.dim() - 1, input.sizes());
+    const int64_t K = input.size(input.dim() - 1);
+    const int64_t N = pack_ptr.w.size(0);
+    const int64_t K_padded = pack_ptr.w.size(1);
+    TORCH_CHECK(
+        K == pack_ptr.input_channels,
+        "The number of columns in the packed weight should be equal to K: " +
+            std::to_string(K));
+
+    Tensor input_int8 =
+        quantized_cuda_shift_to_int8(input.contiguous()).view({M, K});
+    if (K_padded != K) {
+      input_int8 = at::constant_pad_nd(input_int8, {0, K_padded - K}, 0);
+    }
+    Tensor acc = at::empty({M, N}, input.options().dtype(kInt));
+    // Column-major, acc^T = B x A^T
+    at::cuda::blas::int8_gemm(
+        't',
+        'n',
+        N,
+        M,
+        K_padded,
+        pack_ptr.w.data_ptr<int8_t>(),
+        K_padded,
+        input_int8.data_ptr<int8_t>(),
+        K_padded,
+        acc.data_ptr<int32_t>(),
+        N);
+
+    std::vector<int64_t> out_sizes = input.sizes().vec();
+    out_sizes.back() = N;
+    return quantized_cuda_requantize(
+               acc,
+               pack_ptr.w_sum,
+               pack_ptr.bias,
+               input.q_scale(),
+               input.q_zero_point(),
+               pack_ptr.w_scale,
+               c10::nullopt,
+               ReluFused,
+               output_scale,
+               output_zero_point)
+        .view(out_sizes);
+  }
+};
+
+TORCH_LIBRARY_IMPL(quantized, QuantizedCUDA, m) {
+  m.impl("linear", QLinearInt8Cuda<false>::run);
+  m.impl("linear_relu", QLinearInt8Cuda<true>::run);
+}
+
+TORCH_LIBRARY_IMPL(_quantized, QuantizedCUDA, m) {
+  m.impl("linear", QLinearInt8Cuda<false>::run);
+}
+
+} // namespace
+} // namespace native
+} // namespace at
+#endif // __HIP_PLATFORM_HCC__
@@ -0,0 +1,64 @@
+#include <ATen/ATen.h>
+#include <torch/library.h>
+#include <ATen/cpp_custom_type_hack.h>
+#include <ATen/native/quantized/cuda/cuda_utils.h>
+
+#ifndef __HIP_PLATFORM_HCC__
+namespace caffe2 {
+// Required for cpp_custom_type_hack to work
+CAFFE_KNOWN_TYPE(PackedLinearWeightCublas);
+} // namespace caffe2
+
+namespace at {
+namespace native {
+namespace {
+
+class QLinearPackWeightInt8Cuda final {
+ public:
+  static at::Tensor run(at::Tensor weight, c10::optional<Tensor> bias) {
+    TORCH_CHECK(
+        weight.dim() == 2,
+        "quantized::linear_prepack (cuda): Weight tensor rank should be == 2");
+    TORCH_CHECK(
+        weight.scalar_type() == kQInt8,
+        "quantized::linear_prepack (cuda): Weight should be qint8");
+    TORCH_CHECK(
+        weight.qscheme() == kPerTensorAffine && weight.q_zero_point() == 0,
+        "quantized::linear_prepack (cuda) only supports symmetric Per Tensor "
+        "Quantization Scheme (zero point 0)");
+
+    const int64_t N = weight.size(0);
+    const int64_t K = weight.size(1);
+    const int64_t K_padded = (K + 3) / 4 * 4;
+    Tensor w = at::constant_pad_nd(
+        weight.int_repr().contiguous(), {0, K_padded - K}, 0);
+    Tensor w_sum = w.to(kInt).sum(1).to(kFloat);
+
+    c10::optional<at::Tensor> bias_contig;
+    if (bias.has_value()) {
+      Tensor bias_vec = bias.value();
+      TORCH_CHECK(bias_vec.dim() == 1, "bias should be a vector (1D Tensor)");
+      TORCH_CHECK(
+          bias_vec.size(0) == N,
+          "bias should have N elements: " + std::to_string(N));
+      bias_contig = bias_vec.to(weight.device(), kFloat).contiguous();
+    }
+    auto ret_ptr =
+        std::make_unique<PackedLinearWeightCublas>(PackedLinearWeightCublas{
+            std::move(w), std::move(w_sum), bias_contig, K, weight.q_scale()});
+    return cpp_custom_type_hack::create(std::move(ret_ptr), weight.options());
+  }
+};
+
+TORCH_LIBRARY_IMPL(quantized, QuantizedCUDA, m) {
+  m.impl("linear_prepack", QLinearPackWeightInt8Cuda::run);
+}
+
+TORCH_LIBRARY_IMPL(_quantized, QuantizedCUDA, m) {
+  m.impl("linear_prepack", QLinearPackWeightInt8Cuda::run);
+}
+
+} // namespace
+} // namespace native
+} // namespace at
+#endif // __HIP_PLATFORM_HCC__
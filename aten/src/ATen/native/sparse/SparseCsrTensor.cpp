@@ -0,0 +1,183 @@
+// Basic functions on sparse CSR tensors
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/SparseCsrTensorImpl.h>
+#include <ATen/SparseCsrTensorUtils.h>
+#include <ATen/NativeFunctions.h>
+
+namespace at { namespace native {
+
+using namespace at::sparse_csr;
+
+namespace {
+
+// Wraps already validated member tensors into a new CSR tensor. Like the COO
+// constructor, the member tensors are shallow-copied so that they don't carry
+// AutogradMeta; the CSR tensor is not differentiable.
+SparseCsrTensor new_sparse_csr_with_tensors(
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    IntArrayRef size) {
+  auto shallow_copy = [](const Tensor& t) {
+    return Tensor(t.unsafeGetTensorImpl()->shallow_copy_and_detach(
+        /*version_counter=*/t.unsafeGetTensorImpl()->version_counter(),
+        /*allow_tensor_metadata_change=*/true));
+  };
+  SparseCsrTensor self = detail::make_tensor<SparseCsrTensorImpl>(
+      DispatchKeySet(DispatchKey::SparseCsrCPU), values.dtype());
+  get_sparse_csr_impl(self)->set_member_tensors_unsafe(
+      shallow_copy(crow_indices), shallow_copy(col_indices), shallow_copy(values), size);
+  return self;
+}
+
+// crow_indices of a matrix with `num_rows` rows whose elements lie in the
+// (sorted) rows `rows`.
+Tensor crow_indices_from_sorted_rows(const Tensor& rows, int64_t num_rows) {
+  Tensor rows_contig = rows.contiguous();
+  Tensor crow_indices = at::empty({num_rows + 1}, rows.options());
+  const int64_t* rows_ptr = rows_contig.data_ptr<int64_t>();
+  int64_t* crow_ptr = crow_indices.data_ptr<int64_t>();
+  const int64_t nnz = rows_contig.numel();
+  int64_t p = 0;
+  for (int64_t i = 0; i <= num_rows; i++) {
+    while (p < nnz && rows_ptr[p] < i) {
+      p++;
+    }
+    crow_ptr[i] = p;
+  }
+  return crow_indices;
+}
+
+} // namespace
+
+/******************************************************************************
+ * access methods
+ ******************************************************************************/
+
+int64_t _nnz_sparse_csr(const SparseCsrTensor& self) {
+  return get_sparse_csr_impl(self)->nnz();
+}
+
+Tensor crow_indices_sparse_csr(const SparseCsrTensor& self) {
+  return get_sparse_csr_impl(self)->crow_indices().alias();
+}
+
+Tensor col_indices_sparse_csr(const SparseCsrTensor& self) {
+  return get_sparse_csr_impl(self)->col_indices().alias();
+}
+
+Tensor values_sparse_csr(const SparseCsrTensor& self) {
+  return get_sparse_csr_impl(self)->values().alias();
+}
+
+/******************************************************************************
+ * creation methods
+ ******************************************************************************/
+
+SparseCsrTensor sparse_csr_tensor(
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    IntArrayRef size) {
+  TORCH_CHECK(size.size() == 2, "sparse_csr_tensor: expected a 2-D size, but got ", size);
+  TORCH_CHECK(crow_indices.layout() == kStrided && col_indices.layout() == kStrided && values.layout() == kStrided,
+      "sparse_csr_tensor: expected crow_indices, col_indices and values to be dense tensors");
+  TORCH_CHECK(crow_indices.dim() == 1 && col_indices.dim() == 1 && values.dim() == 1,
+      "sparse_csr_tensor: expected crow_indices, col_indices and values to be 1-D, but got ",
+      crow_indices.dim(), "-D, ", col_indices.dim(), "-D and ", values.dim(), "-D");
+  TORCH_CHECK(crow_indices.scalar_type() == kLong && col_indices.scalar_type() == kLong,
+      "sparse_csr_tensor: crow_indices and col_indices must be int64 tensors");
+  TORCH_CHECK(!crow_indices.is_cuda() && !col_indices.is_cuda() && !values.is_cuda(),
+      "sparse_csr_tensor: sparse CSR tensors are only supported on CPU");
+
+  const int64_t num_rows = size[0];
+  const int64_t num_cols = size[1];
+  TORCH_CHECK(num_rows >= 0 && num_cols >= 0, "sparse_csr_tensor: found negative size ", size);
+  TORCH_CHECK(crow_indices.numel() == num_rows + 1,
+      "sparse_csr_tensor: crow_indices must have size(0) + 1 = ", num_rows + 1, " elements, but got ", crow_indices.numel());
+  TORCH_CHECK(col_indices.numel() == values.numel(),
+      "sparse_csr_tensor: col_indices and values must have the same number of elements, but got ",
+      col_indices.numel(), " and ", values.numel());
+
+  Tensor crow = crow_indices.contiguous();
+  Tensor col = col_indices.contiguous();
+  const int64_t* crow_ptr = crow.data_ptr<int64_t>();
+  const int64_t* col_ptr = col.data_ptr<int64_t>();
+  const int64_t nnz = col.numel();
+  TORCH_CHECK(crow_ptr[0] == 0, "sparse_csr_tensor: crow_indices[0] must be 0, but got ", crow_ptr[0]);
+  TORCH_CHECK(crow_ptr[num_rows] == nnz,
+      "sparse_csr_tensor: crow_indices[-1] must be nnz = ", nnz, ", but got ", crow_ptr[num_rows]);
+  for (int64_t i = 0; i < num_rows; i++) {
+    TORCH_CHECK(crow_ptr[i] <= crow_ptr[i + 1], "sparse_csr_tensor: crow_indices must be non-decreasing");
+    for (int64_t p = crow_ptr[i]; p < crow_ptr[i + 1]; p++) {
+      TORCH_CHECK(col_ptr[p] >= 0 && col_ptr[p] < num_cols,
+          "sparse_csr_tensor: column index ", col_ptr[p], " of row ", i, " is out of bounds for ", num_cols, " columns");
+      TORCH_CHECK(p == crow_ptr[i] || col_ptr[p - 1] < col_ptr[p],
+          "sparse_csr_tensor: column indices of row ", i, " must be strictly increasing");
+    }
+  }
+
+  return new_sparse_csr_with_tensors(crow, col, values.contiguous(), size);
+}
+
+/******************************************************************************
+ * conversions
+ ******************************************************************************/
+
+SparseCsrTensor dense_to_sparse_csr(const Tensor& self) {
+  TORCH_CHECK(self.dim() == 2, "to_sparse_csr: expected a 2-D tensor, but got a ", self.dim(), "-D tensor");
+  // nonzero() lists the elements in row-major order, which is the CSR order
+  Tensor nz = self.nonzero();
+  Tensor rows = nz.select(1, 0);
+  Tensor cols = nz.select(1, 1);
+  Tensor values = self.index({rows, cols});
+  return new_sparse_csr_with_tensors(
+      crow_indices_from_sorted_rows(rows, self.size(0)),
+      cols.contiguous(),
+      values.contiguous(),
+      self.sizes());
+}
+
+SparseCsrTensor coo_to_sparse_csr(const Tensor& self) {
+  TORCH_CHECK(self.sparse_dim() == 2 && self.dense_dim() == 0,
+      "to_sparse_csr: expected a sparse COO matrix with scalar values, but got sparse_dim ",
+      self.sparse_dim(), " and dense_dim ", self.dense_dim());
+  // coalescing sorts the elements in row-major order and sums duplicates
+  Tensor coalesced = self.coalesce();
+  Tensor indices = coalesced._indices();
+  return new_sparse_csr_with_tensors(
+      crow_indices_from_sorted_rows(indices.select(0, 0), self.size(0)),
+      indices.select(0, 1).contiguous(),
+      coalesced._values().contiguous(),
+      self.sizes());
+}
+
+Tensor sparse_csr_to_dense(const SparseCsrTensor& self) {
+  auto impl = get_sparse_csr_impl(self);
+  Tensor dst = at::zeros(self.sizes(), self.options().layout(kStrided));
+  if (impl->nnz() == 0) {
+    return dst;
+  }
+  const int64_t num_rows = self.size(0);
+  const int64_t num_cols = self.size(1);
+  const int64_t* crow_ptr = impl->crow_indices().data_ptr<int64_t>();
+  const int64_t* col_ptr = impl->col_indices().data_ptr<int64_t>();
+  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(kBool, kHalf, kBFloat16, self.scalar_type(), "sparse_csr_to_dense", [&] {
+    const scalar_t* values_ptr = impl->values().data_ptr<scalar_t>();
+    scalar_t* dst_ptr = dst.data_ptr<scalar_t>();
+    const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(num_cols, 1));
+    at::parallel_for(0, num_rows, grain_size, [&](int64_t start, int64_t end) {
+      for (int64_t i = start; i < end; i++) {
+        for (int64_t p = crow_ptr[i]; p < crow_ptr[i + 1]; p++) {
+          dst_ptr[i * num_cols + col_ptr[p]] = values_ptr[p];
+        }
+      }
+    });
+  });
+  return dst;
+}
+
+}} // namespace at::native
@@ -0,0 +1,250 @@
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/ExpandUtils.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+#include <ATen/ScalarOps.h>
+#include <ATen/SparseCsrTensorImpl.h>
+#include <ATen/SparseCsrTensorUtils.h>
+#include <ATen/native/sparse/SparseTensorMath.h>
+
+#include <algorithm>
+
+namespace at { namespace native {
+
+using namespace at::sparse_csr;
+
+namespace {
+
+// Number of rows handed to one thread, so that a task does about GRAIN_SIZE
+// multiply-adds on average.
+int64_t csr_row_grain_size(int64_t nnz, int64_t num_rows, int64_t work_per_element) {
+  const int64_t avg_row_cost =
+      std::max<int64_t>(1, nnz / std::max<int64_t>(num_rows, 1) * work_per_element);
+  return std::max<int64_t>(1, at::internal::GRAIN_SIZE / avg_row_cost);
+}
+
+// --------------------------------------------------------------------
+// r += alpha * mm(S, D), S in CSR format, r and D contiguous
+//
+// Every row of r only depends on one row of S, so the rows are split across
+// threads without any synchronization, and the innermost loop runs over a
+// contiguous row of D and r.
+// --------------------------------------------------------------------
+
+template <typename scalar_t>
+void addmm_out_sparse_csr_dense_worker(
+    int64_t dim_i,
+    int64_t dim_k,
+    Tensor& r,
+    Scalar alpha,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& dense) {
+  const scalar_t cast_alpha = alpha.to<scalar_t>();
+  const int64_t* crow_ptr = crow_indices.data_ptr<int64_t>();
+  const int64_t* col_ptr = col_indices.data_ptr<int64_t>();
+  const scalar_t* values_ptr = values.data_ptr<scalar_t>();
+  const scalar_t* dense_ptr = dense.data_ptr<scalar_t>();
+  scalar_t* r_ptr = r.data_ptr<scalar_t>();
+
+  at::parallel_for(0, dim_i, csr_row_grain_size(values.numel(), dim_i, dim_k), [&](int64_t start, int64_t end) {
+    for (int64_t i = start; i < end; i++) {
+      scalar_t* r_row = r_ptr + i * dim_k;
+      for (int64_t p = crow_ptr[i]; p < crow_ptr[i + 1]; p++) {
+        const scalar_t val = cast_alpha * values_ptr[p];
+        const scalar_t* dense_row = dense_ptr + col_ptr[p] * dim_k;
+        for (int64_t k = 0; k < dim_k; k++) {
+          r_row[k] += val * dense_row[k];
+        }
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void mv_sparse_csr_worker(
+    int64_t dim_i,
+    Tensor& r,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& vec) {
+  const int64_t* crow_ptr = crow_indices.data_ptr<int64_t>();
+  const int64_t* col_ptr = col_indices.data_ptr<int64_t>();
+  const scalar_t* values_ptr = values.data_ptr<scalar_t>();
+  const scalar_t* vec_ptr = vec.data_ptr<scalar_t>();
+  const int64_t vec_stride = vec.stride(0);
+  scalar_t* r_ptr = r.data_ptr<scalar_t>();
+
+  at::parallel_for(0, dim_i, csr_row_grain_size(values.numel(), dim_i, 1), [&](int64_t start, int64_t end) {
+    for (int64_t i = start; i < end; i++) {
+      scalar_t acc = 0;
+      for (int64_t p = crow_ptr[i]; p < crow_ptr[i + 1]; p++) {
+        acc += values_ptr[p] * vec_ptr[col_ptr[p] * vec_stride];
+      }
+      r_ptr[i] = acc;
+    }
+  });
+}
+
+// D = beta * t + alpha * mm(S, D2), without broadcasting t
+Tensor& s_addmm_out_sparse_csr_dense_cpu(
+    Tensor& r,
+    const Tensor& t,
+    const SparseCsrTensor& sparse,
+    const Tensor& dense,
+    Scalar beta,
+    Scalar alpha) {
+  TORCH_CHECK(sparse.is_sparse_csr(), "addmm: expected 'mat1' to be a sparse CSR tensor, but got layout ", sparse.layout());
+  TORCH_CHECK(dense.layout() == kStrided, "addmm: expected 'mat2' to be a dense tensor, but got layout ", dense.layout());
+  TORCH_CHECK(t.layout() == kStrided, "addmm: expected 'self' to be a dense tensor, but got layout ", t.layout());
+  TORCH_CHECK(r.layout() == kStrided, "addmm: expected 'out' to be a dense tensor, but got layout ", r.layout());
+  TORCH_CHECK(!r.is_cuda() && !t.is_cuda() && !dense.is_cuda(),
+      "addmm: expected CPU tensors when 'mat1' is a sparse CSR tensor");
+  TORCH_CHECK(dense.dim() == 2, "addmm: matrices expected, got ", dense.dim(), "D tensor");
+  TORCH_CHECK(dense.scalar_type() == sparse.scalar_type(),
+      "addmm: expected 'mat1' and 'mat2' to have the same dtype, but got ", sparse.scalar_type(), " and ", dense.scalar_type());
+
+  // ixj * jxk = ixk
+  const int64_t dim_i = sparse.size(0);
+  const int64_t dim_j = sparse.size(1);
+  const int64_t dim_k = dense.size(1);
+
+  TORCH_CHECK(dense.size(0) == dim_j,
+      "addmm: Argument #3 (dense): Expected dim 0 size ", dim_j, ", got ", dense.size(0));
+  TORCH_CHECK(t.size(0) == dim_i,
+      "addmm: Argument #1 (t): Expected dim 0 size ", dim_i, ", got ", t.size(0));
+  TORCH_CHECK(t.size(1) == dim_k,
+      "addmm: Argument #1 (t): Expected dim 1 size ", dim_k, ", got ", t.size(1));
+
+  r.resize_({dim_i, dim_k});
+
+  auto impl = get_sparse_csr_impl(sparse);
+  AT_DISPATCH_ALL_TYPES(sparse.scalar_type(), "addmm_sparse_csr_dense", [&] {
+    const scalar_t cast_beta = beta.to<scalar_t>();
+    if (cast_beta == 0) {
+      r.zero_();
+    } else if (cast_beta == 1) {
+      if (!r.is_same(t)) {
+        r.copy_(t);
+      }
+    } else {
+      at::mul_out(r, t, scalar_to_tensor(beta));
+    }
+    if (impl->nnz() == 0) {
+      return;
+    }
+    Tensor dense_contig = dense.contiguous();
+    Tensor r_contig = r.contiguous();
+    addmm_out_sparse_csr_dense_worker<scalar_t>(
+        dim_i, dim_k, r_contig, alpha, impl->crow_indices(), impl->col_indices(), impl->values(), dense_contig);
+    if (!r.is_same(r_contig)) {
+      r.copy_(r_contig);
+    }
+  });
+  return r;
+}
+
+// mm(S1, S2) -> S, S1, S2 and S in CSR format, with the kernel of the COO
+// version, see spgemm_csr_cpu
+SparseCsrTensor sparse_csr_sparse_csr_mm(const SparseCsrTensor& mat1, const SparseCsrTensor& mat2) {
+  TORCH_CHECK(mat2.scalar_type() == mat1.scalar_type(),
+      "mm: expected 'mat1' and 'mat2' to have the same dtype, but got ", mat1.scalar_type(), " and ", mat2.scalar_type());
+  TORCH_CHECK(mat2.size(0) == mat1.size(1),
+      "mm: Argument #2: Expected dim 0 size ", mat1.size(1), ", got ", mat2.size(0));
+
+  const int64_t dim_i = mat1.size(0);
+  const int64_t dim_k = mat2.size(1);
+  auto impl1 = get_sparse_csr_impl(mat1);
+  auto impl2 = get_sparse_csr_impl(mat2);
+  Tensor crow_indices, col_indices, values;
+  std::tie(crow_indices, col_indices, values) = spgemm_csr_cpu(
+      dim_i, dim_k,
+      impl1->crow_indices(), impl1->col_indices(), impl1->values(),
+      impl2->crow_indices(), impl2->col_indices(), impl2->values());
+  return at::sparse_csr_tensor(crow_indices, col_indices, values, {dim_i, dim_k});
+}
+
+} // namespace
+
+// --------------------------------------------------------------------
+// addmm(D1, S, D2, beta, alpha) -> D  [broadcasts]
+//
+// D = beta * D1 + alpha * mm(S, D2), S in CSR format
+// --------------------------------------------------------------------
+
+Tensor& addmm_out_sparse_csr_dense_cpu(
+    Tensor& result,
+    const Tensor& self,
+    const SparseCsrTensor& mat1,
+    const Tensor& mat2,
+    Scalar beta,
+    Scalar alpha) {
+  TORCH_CHECK(mat1.is_sparse_csr(), "addmm: expected 'mat1' to be a sparse CSR tensor, but got layout ", mat1.layout());
+  Tensor b_self;
+  std::tie(b_self) = expand_size(self, {mat1.size(0), mat2.size(1)}, "addmm_out");
+  return s_addmm_out_sparse_csr_dense_cpu(result, b_self, mat1, mat2, beta, alpha);
+}
+
+Tensor addmm_sparse_csr_dense_cpu(
+    const Tensor& self,
+    const SparseCsrTensor& mat1,
+    const Tensor& mat2,
+    Scalar beta,
+    Scalar alpha) {
+  Tensor r = at::empty({0}, mat2.options());
+  return addmm_out_sparse_csr_dense_cpu(r, self, mat1, mat2, beta, alpha);
+}
+
+// NB: Like the COO version, the inplace version doesn't broadcast
+Tensor& addmm_sparse_csr_dense_cpu_(
+    Tensor& self,
+    const SparseCsrTensor& mat1,
+    const Tensor& mat2,
+    Scalar beta,
+    Scalar alpha) {
+  return s_addmm_out_sparse_csr_dense_cpu(self, self, mat1, mat2, beta, alpha);
+}
+
+Tensor& sparse_csr_mm_out(Tensor& result, const SparseCsrTensor& self, const Tensor& mat2) {
+  TORCH_CHECK(self.is_sparse_csr(), "mm: only the first argument may be a sparse CSR tensor, but got layouts ",
+      self.layout(), " and ", mat2.layout());
+  Tensor t = at::zeros({}, mat2.options());
+  return addmm_out_sparse_csr_dense_cpu(result, t, self, mat2, 0, 1);
+}
+
+Tensor sparse_csr_mm(const SparseCsrTensor& self, const Tensor& mat2) {
+  if (self.is_sparse_csr() && mat2.is_sparse_csr()) {
+    return sparse_csr_sparse_csr_mm(self, mat2);
+  }
+  Tensor result = at::empty({0}, mat2.options());
+  return sparse_csr_mm_out(result, self, mat2);
+}
+
+// --------------------------------------------------------------------
+// mv(S, D) -> D, S in CSR format
+// --------------------------------------------------------------------
+
+Tensor sparse_csr_mv(const SparseCsrTensor& self, const Tensor& vec) {
+  TORCH_CHECK(self.is_sparse_csr(), "mv: only the first argument may be a sparse CSR tensor, but got layouts ",
+      self.layout(), " and ", vec.layout());
+  TORCH_CHECK(vec.layout() == kStrided && !vec.is_cuda(),
+      "mv: expected 'vec' to be a dense CPU tensor when 'self' is a sparse CSR tensor");
+  TORCH_CHECK(vec.dim() == 1, "mv: expected a 1-D vector, but got a ", vec.dim(), "-D tensor");
+  TORCH_CHECK(vec.size(0) == self.size(1), "mv: expected self.size(-1) == vec.size(-1)");
+  TORCH_CHECK(vec.scalar_type() == self.scalar_type(),
+      "mv: expected 'self' and 'vec' to have the same dtype, but got ", self.scalar_type(), " and ", vec.scalar_type());
+
+  const int64_t dim_i = self.size(0);
+  Tensor result = at::empty({dim_i}, vec.options());
+  auto impl = get_sparse_csr_impl(self);
+  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "mv_sparse_csr", [&] {
+    mv_sparse_csr_worker<scalar_t>(
+        dim_i, result, impl->crow_indices(), impl->col_indices(), impl->values(), vec);
+  });
+  return result;
+}
+
+}} // namespace at::native
@@ -10,6 +10,9 @@
 
 #include <TH/THBlasUtils.h>
 
+#include <algorithm>
+#include <numeric>
+
 namespace at { namespace native {
 
 using namespace at::sparse;
@@ -352,6 +355,132 @@ SparseTensor& copy_sparse_(SparseTensor& self, const SparseTensor& src, bool non
   return self._coalesced_(src.is_coalesced());
 }
 
+namespace {
+
+// Splits [0, n) in about as many chunks as there are threads, each of them
+// having at least GRAIN_SIZE elements, for the passes of coalesce that need a
+// fixed partition of the elements.
+struct CoalesceChunks {
+  explicit CoalesceChunks(int64_t n)
+      : n(n),
+        num_chunks(std::max<int64_t>(
+            1, std::min<int64_t>(at::get_num_threads(), divup(n, at::internal::GRAIN_SIZE)))),
+        chunk_size(divup(std::max<int64_t>(n, 1), num_chunks)) {}
+
+  // Calls f(chunk, begin, end) for every chunk, in parallel
+  template <typename F>
+  void parallel_for_each(const F& f) const {
+    at::parallel_for(0, num_chunks, 1, [&](int64_t chunk_begin, int64_t chunk_end) {
+      for (int64_t c = chunk_begin; c < chunk_end; c++) {
+        f(c, std::min(n, c * chunk_size), std::min(n, (c + 1) * chunk_size));
+      }
+    });
+  }
+
+  int64_t n;
+  int64_t num_chunks;
+  int64_t chunk_size;
+};
+
+// Sorts the keys, which all lie in [0, max_key], and returns them with the
+// permutation that sorts them.
+//
+// This is a least significant digit radix sort, with as many passes over the
+// keys as max_key has bytes. Every chunk of the keys counts its digits, the
+// counts give where every digit of every chunk goes, and the chunks then
+// scatter their keys in parallel. The sort is stable, so the duplicates of a
+// key keep their order.
+std::tuple<LongTensor, LongTensor> radix_sort_keys(const LongTensor& keys, int64_t max_key) {
+  constexpr int kRadixBits = 8;
+  constexpr int64_t kRadix = 1 << kRadixBits;
+  const int64_t n = keys.numel();
+  const CoalesceChunks chunks(n);
+
+  LongTensor sorted = keys.clone(at::MemoryFormat::Contiguous);
+  LongTensor permutation = at::arange(n, keys.options());
+  LongTensor sorted_buffer = at::empty_like(sorted);
+  LongTensor permutation_buffer = at::empty_like(permutation);
+  std::vector<int64_t> offsets(chunks.num_chunks * kRadix);
+
+  for (int shift = 0; shift < 64 && (max_key >> shift) > 0; shift += kRadixBits) {
+    const int64_t* src_keys = sorted.data_ptr<int64_t>();
+    const int64_t* src_perm = permutation.data_ptr<int64_t>();
+    int64_t* dst_keys = sorted_buffer.data_ptr<int64_t>();
+    int64_t* dst_perm = permutation_buffer.data_ptr<int64_t>();
+
+    std::fill(offsets.begin(), offsets.end(), 0);
+    chunks.parallel_for_each([&](int64_t c, int64_t begin, int64_t end) {
+      int64_t* chunk_offsets = offsets.data() + c * kRadix;
+      for (int64_t j = begin; j < end; j++) {
+        chunk_offsets[(src_keys[j] >> shift) & (kRadix - 1)]++;
+      }
+    });
+    // The keys of a digit go after those of the smaller digits, and after
+    // those of the same digit in the earlier chunks
+    int64_t offset = 0;
+    for (int64_t digit = 0; digit < kRadix; digit++) {
+      for (int64_t c = 0; c < chunks.num_chunks; c++) {
+        const int64_t count = offsets[c * kRadix + digit];
+        offsets[c * kRadix + digit] = offset;
+        offset += count;
+      }
+    }
+    chunks.parallel_for_each([&](int64_t c, int64_t begin, int64_t end) {
+      int64_t* chunk_offsets = offsets.data() + c * kRadix;
+      for (int64_t j = begin; j < end; j++) {
+        const int64_t pos = chunk_offsets[(src_keys[j] >> shift) & (kRadix - 1)]++;
+        dst_keys[pos] = src_keys[j];
+        dst_perm[pos] = src_perm[j];
+      }
+    });
+    std::swap(sorted, sorted_buffer);
+    std::swap(permutation, permutation_buffer);
+  }
+  return std::make_tuple(sorted, permutation);
+}
+
+// The positions in the sorted keys where a run of equal keys starts, followed
+// by the number of keys. Every chunk counts the runs that start in it, which
+// gives where it writes them.
+LongTensor run_starts_of_sorted_keys(const LongTensor& sorted_keys) {
+  const int64_t n = sorted_keys.numel();
+  const int64_t* keys_ptr = sorted_keys.data_ptr<int64_t>();
+  const CoalesceChunks chunks(n);
+  auto starts_run = [&](int64_t j) {
+    return j == 0 || keys_ptr[j] != keys_ptr[j - 1];
+  };
+
+  std::vector<int64_t> chunk_offsets(chunks.num_chunks + 1, 0);
+  chunks.parallel_for_each([&](int64_t c, int64_t begin, int64_t end) {
+    int64_t count = 0;
+    for (int64_t j = begin; j < end; j++) {
+      count += starts_run(j);
+    }
+    chunk_offsets[c + 1] = count;
+  });
+  std::partial_sum(chunk_offsets.begin(), chunk_offsets.end(), chunk_offsets.begin());
+
+  const int64_t num_runs = chunk_offsets.back();
+  LongTensor run_starts = at::empty({num_runs + 1}, sorted_keys.options());
+  int64_t* starts_ptr = run_starts.data_ptr<int64_t>();
+  chunks.parallel_for_each([&](int64_t c, int64_t begin, int64_t end) {
+    int64_t pos = chunk_offsets[c];
+    for (int64_t j = begin; j < end; j++) {
+      if (starts_run(j)) {
+        starts_ptr[pos++] = j;
+      }
+    }
+  });
+  starts_ptr[num_runs] = n;
+  return run_starts;
+}
+
+} // namespace
+
+// The elements are sorted by their flattened index with a parallel radix
+// sort, after which every run of equal indices becomes an element of the
+// result. The runs are found and summed in parallel, each of them being read
+// and written by a single thread.
 SparseTensor coalesce_sparse_cpu(const SparseTensor& self) {
   AT_ASSERT(self.defined());
   TORCH_INTERNAL_ASSERT(at::impl::variable_excluded_from_dispatch());
@@ -372,55 +501,56 @@ SparseTensor coalesce_sparse_cpu(const SparseTensor& self) {
   Tensor values = self._values().contiguous();
   int64_t sparse_dim = self.sparse_dim();
   int64_t dense_dim = self.dense_dim();
-  int64_t nnz = self._nnz();
 
   LongTensor indices_scalar = flatten_indices(indices, self.sizes());
 
+  LongTensor indicesBuffer;
+  LongTensor indicesPermutation;
+  std::tie(indicesBuffer, indicesPermutation) =
+      radix_sort_keys(indices_scalar, indices_scalar.max().item<int64_t>());
+  LongTensor runStarts = run_starts_of_sorted_keys(indicesBuffer);
+  const int64_t newNnz = runStarts.numel() - 1;
+
   SparseTensor dst = new_sparse(self.options());
   get_sparse_impl(dst)->resize_(sparse_dim, dense_dim, self.sizes());
-  // TODO: is there a more idiomatic way to do this?
-  LongTensor newIndices = at::empty(indices.sizes(), indices.options());
-  Tensor newValues = at::empty(values.sizes(), values.options());
+  std::vector<int64_t> newValuesSize = values.sizes().vec();
+  newValuesSize[0] = newNnz;
+  LongTensor newIndices = at::empty({sparse_dim, newNnz}, indices.options());
+  Tensor newValues = at::empty(newValuesSize, values.options());
   alias_into_sparse(dst, newIndices, newValues);
 
-  LongTensor indicesBuffer;
-  LongTensor indicesPermutation;
-  std::tie(indicesBuffer, indicesPermutation) = indices_scalar.sort(0);
   // NB: The accessor accesses here rely on self._nnz() > 0 (tested earlier in this function)
   auto newIndicesAccessor = newIndices.accessor<int64_t, 2>();
   auto indicesAccessor = indices.accessor<int64_t, 2>();
-  auto indicesPermutationAccessor = indicesPermutation.accessor<int64_t, 1>();
-  auto indicesBufferAccessor = indicesBuffer.accessor<int64_t, 1>();
+  const int64_t* permutation_ptr = indicesPermutation.data_ptr<int64_t>();
+  const int64_t* starts_ptr = runStarts.data_ptr<int64_t>();
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE * newNnz / self._nnz());
 
-  int64_t i = -1;
   AT_DISPATCH_ALL_TYPES(
       values.scalar_type(), "coalesce", [&] {
-        int64_t prev = -1;
         int64_t blockSize = values.stride(0);
         scalar_t* values_ptr = values.data_ptr<scalar_t>();
         scalar_t* newValues_ptr = newValues.data_ptr<scalar_t>();
-        for (int64_t j = 0; j < nnz; j++) {
-          int64_t pos = indicesPermutationAccessor[j];
-          int64_t curr = indicesBufferAccessor[j];
-          if (curr == prev) {
-            if (values.numel() > 0) {  // if values is an empty tensor, there are no elements to copy
-              THBlas_axpy<scalar_t>(blockSize, 1, values_ptr + pos * blockSize, 1, newValues_ptr + i * blockSize, 1);
-            }
-          } else {
-            ++i;
+        at::parallel_for(0, newNnz, grain_size, [&](int64_t start, int64_t end) {
+          for (int64_t i = start; i < end; i++) {
+            const int64_t first = permutation_ptr[starts_ptr[i]];
             for (int64_t d = 0; d < sparse_dim; d++) {
-              newIndicesAccessor[d][i] = indicesAccessor[d][pos];
+              newIndicesAccessor[d][i] = indicesAccessor[d][first];
             }
-            if (values.numel() > 0) {  // if values is an empty tensor, there are no elements to copy
-              THBlas_copy<scalar_t>(blockSize, values_ptr + pos * blockSize, 1, newValues_ptr + i * blockSize, 1);
+            if (values.numel() == 0) {  // if values is an empty tensor, there are no elements to copy
+              continue;
+            }
+            THBlas_copy<scalar_t>(blockSize, values_ptr + first * blockSize, 1, newValues_ptr + i * blockSize, 1);
+            for (int64_t j = starts_ptr[i] + 1; j < starts_ptr[i + 1]; j++) {
+              const int64_t pos = permutation_ptr[j];
+              THBlas_axpy<scalar_t>(blockSize, 1, values_ptr + pos * blockSize, 1, newValues_ptr + i * blockSize, 1);
             }
           }
-          prev = curr;
-        }
+        });
     });
 
   dst._coalesced_(true);
-  get_sparse_impl(dst)->set_nnz_and_narrow(i + 1);
+  get_sparse_impl(dst)->set_nnz_and_narrow(newNnz);
 
   return dst;
 }
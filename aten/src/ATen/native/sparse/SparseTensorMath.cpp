@@ -928,6 +928,9 @@ Tensor _sparse_mm(
   const SparseTensor& sparse,
   const Tensor& dense
 ) {
+  if (sparse.is_sparse() && dense.is_sparse()) {
+    return at::_sparse_sparse_matmul(sparse, dense);
+  }
   Tensor t = at::zeros({}, dense.options());
   return at::_sparse_addmm(t, sparse, dense, 0, 1);  // redispatch!
 }
@@ -940,6 +943,10 @@ SparseTensor& _sparse_mm_out(
   const SparseTensor& sparse,
   const Tensor& dense
 ) {
+  if (sparse.is_sparse() && dense.is_sparse()) {
+    TORCH_CHECK(result.is_sparse(), "mm: expected 'out' to be a sparse tensor when multiplying two sparse tensors");
+    return result.copy_(at::_sparse_sparse_matmul(sparse, dense));
+  }
   Tensor t = at::zeros({}, dense.options());
   return at::addmm_out(result, t, sparse, dense, 0, 1);  // redispatch!
 }
@@ -1160,6 +1167,216 @@ Tensor sspaddmm(const Tensor& self, const Tensor& mat1, const Tensor& mat2,
   return result;
 }
 
+// --------------------------------------------------------------------
+// mm(S1, S2) -> S
+//
+// Gustavson's algorithm: row i of the result sums the rows of S2 picked by
+// the columns of the elements of row i of S1, scaled by these elements. The
+// rows are split across threads, each of them accumulating its rows in a hash
+// table keyed by the column, and the entries of a row are sorted by column
+// once it is done, which keeps the result coalesced.
+// --------------------------------------------------------------------
+
+namespace {
+
+// An open addressing hash table from the columns of a row to their sums, kept
+// from one row to the next by a thread.
+template <typename scalar_t>
+class SpGEMMRowAccumulator {
+ public:
+  // Makes room for `max_entries` columns. The table must be empty.
+  void reserve(int64_t max_entries) {
+    int64_t capacity = 16;
+    while (capacity < 2 * max_entries) {
+      capacity *= 2;
+    }
+    if (capacity > static_cast<int64_t>(columns_.size())) {
+      columns_.assign(capacity, -1);
+      sums_.resize(capacity);
+    }
+  }
+
+  void add(int64_t column, scalar_t value) {
+    const uint64_t mask = columns_.size() - 1;
+    uint64_t slot = ((static_cast<uint64_t>(column) * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+    while (columns_[slot] != -1 && columns_[slot] != column) {
+      slot = (slot + 1) & mask;
+    }
+    if (columns_[slot] == -1) {
+      columns_[slot] = column;
+      sums_[slot] = value;
+      used_slots_.push_back(slot);
+    } else {
+      sums_[slot] += value;
+    }
+  }
+
+  // Appends the entries of the row by increasing column, and empties the table
+  void flush(std::vector<int64_t>& columns, std::vector<scalar_t>& values) {
+    std::sort(used_slots_.begin(), used_slots_.end(), [&](uint64_t a, uint64_t b) {
+      return columns_[a] < columns_[b];
+    });
+    for (const auto slot : used_slots_) {
+      columns.push_back(columns_[slot]);
+      values.push_back(sums_[slot]);
+      columns_[slot] = -1;
+    }
+    used_slots_.clear();
+  }
+
+ private:
+  std::vector<int64_t> columns_;
+  std::vector<scalar_t> sums_;
+  std::vector<uint64_t> used_slots_;
+};
+
+template <typename scalar_t>
+void spgemm_csr_worker(
+    int64_t dim_i,
+    int64_t dim_k,
+    const Tensor& crow1,
+    const Tensor& col1,
+    const Tensor& values1,
+    const Tensor& crow2,
+    const Tensor& col2,
+    const Tensor& values2,
+    Tensor& r_crow,
+    Tensor& r_col,
+    Tensor& r_values) {
+  const int64_t* crow1_ptr = crow1.data_ptr<int64_t>();
+  const int64_t* col1_ptr = col1.data_ptr<int64_t>();
+  const scalar_t* values1_ptr = values1.data_ptr<scalar_t>();
+  const int64_t* crow2_ptr = crow2.data_ptr<int64_t>();
+  const int64_t* col2_ptr = col2.data_ptr<int64_t>();
+  const scalar_t* values2_ptr = values2.data_ptr<scalar_t>();
+  int64_t* r_crow_ptr = r_crow.data_ptr<int64_t>();
+
+  // About GRAIN_SIZE multiply-adds per chunk of rows, on average
+  const int64_t dim_j = crow2.numel() - 1;
+  const int64_t avg_row_cost = std::max<int64_t>(
+      1, (values1.numel() / std::max<int64_t>(dim_i, 1)) * (values2.numel() / std::max<int64_t>(dim_j, 1)));
+  const int64_t rows_per_chunk = std::max<int64_t>(1, at::internal::GRAIN_SIZE / avg_row_cost);
+  const int64_t num_chunks = divup(dim_i, rows_per_chunk);
+
+  // The rows of every chunk are first written to its own buffers, r_crow
+  // holding the number of elements of the chunk up to every row.
+  std::vector<std::vector<int64_t>> chunk_cols(num_chunks);
+  std::vector<std::vector<scalar_t>> chunk_values(num_chunks);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t chunk_begin, int64_t chunk_end) {
+    SpGEMMRowAccumulator<scalar_t> accumulator;
+    for (int64_t c = chunk_begin; c < chunk_end; c++) {
+      auto& cols = chunk_cols[c];
+      auto& values = chunk_values[c];
+      for (int64_t i = c * rows_per_chunk; i < std::min(dim_i, (c + 1) * rows_per_chunk); i++) {
+        int64_t max_entries = 0;
+        for (int64_t p = crow1_ptr[i]; p < crow1_ptr[i + 1]; p++) {
+          max_entries += crow2_ptr[col1_ptr[p] + 1] - crow2_ptr[col1_ptr[p]];
+        }
+        accumulator.reserve(std::min(max_entries, dim_k));
+        for (int64_t p = crow1_ptr[i]; p < crow1_ptr[i + 1]; p++) {
+          const scalar_t val = values1_ptr[p];
+          const int64_t j = col1_ptr[p];
+          for (int64_t q = crow2_ptr[j]; q < crow2_ptr[j + 1]; q++) {
+            accumulator.add(col2_ptr[q], val * values2_ptr[q]);
+          }
+        }
+        accumulator.flush(cols, values);
+        r_crow_ptr[i + 1] = cols.size();
+      }
+    }
+  });
+
+  std::vector<int64_t> chunk_offsets(num_chunks + 1, 0);
+  for (int64_t c = 0; c < num_chunks; c++) {
+    chunk_offsets[c + 1] = chunk_offsets[c] + chunk_cols[c].size();
+  }
+  const int64_t r_nnz = chunk_offsets[num_chunks];
+  r_crow_ptr[0] = 0;
+  r_col.resize_({r_nnz});
+  r_values.resize_({r_nnz});
+  int64_t* r_col_ptr = r_col.data_ptr<int64_t>();
+  scalar_t* r_values_ptr = r_values.data_ptr<scalar_t>();
+  at::parallel_for(0, num_chunks, 1, [&](int64_t chunk_begin, int64_t chunk_end) {
+    for (int64_t c = chunk_begin; c < chunk_end; c++) {
+      for (int64_t i = c * rows_per_chunk; i < std::min(dim_i, (c + 1) * rows_per_chunk); i++) {
+        r_crow_ptr[i + 1] += chunk_offsets[c];
+      }
+      std::copy(chunk_cols[c].begin(), chunk_cols[c].end(), r_col_ptr + chunk_offsets[c]);
+      std::copy(chunk_values[c].begin(), chunk_values[c].end(), r_values_ptr + chunk_offsets[c]);
+      // Frees the buffers of the chunk as soon as they are copied
+      std::vector<int64_t>().swap(chunk_cols[c]);
+      std::vector<scalar_t>().swap(chunk_values[c]);
+    }
+  });
+}
+
+} // namespace
+
+std::tuple<Tensor, Tensor, Tensor> spgemm_csr_cpu(
+    int64_t dim_i,
+    int64_t dim_k,
+    const Tensor& crow1,
+    const Tensor& col1,
+    const Tensor& values1,
+    const Tensor& crow2,
+    const Tensor& col2,
+    const Tensor& values2) {
+  Tensor r_crow = at::empty({dim_i + 1}, crow1.options());
+  Tensor r_col = at::empty({0}, col1.options());
+  Tensor r_values = at::empty({0}, values1.options());
+  AT_DISPATCH_ALL_TYPES(values1.scalar_type(), "spgemm_csr", [&] {
+    spgemm_csr_worker<scalar_t>(
+        dim_i, dim_k, crow1, col1, values1.contiguous(), crow2, col2, values2.contiguous(),
+        r_crow, r_col, r_values);
+  });
+  return std::make_tuple(r_crow, r_col, r_values);
+}
+
+SparseTensor sparse_sparse_matmul_cpu(const SparseTensor& mat1_, const SparseTensor& mat2_) {
+  AT_ASSERT(!mat1_.is_cuda()); // dispatch argument
+  TORCH_CHECK(!mat2_.is_cuda(), "mm: expected 'mat2' to be a CPU tensor, but got a CUDA tensor");
+  TORCH_CHECK(mat1_.is_sparse() && mat2_.is_sparse(),
+      "mm: expected both arguments to be sparse tensors, but got layouts ", mat1_.layout(), " and ", mat2_.layout());
+  TORCH_CHECK(mat1_.sparse_dim() == 2 && mat1_.dense_dim() == 0,
+      "mm: Argument #1: matrices with scalar values expected, got ", mat1_.sparse_dim(), "D tensor with ",
+      mat1_.dense_dim(), "D values");
+  TORCH_CHECK(mat2_.sparse_dim() == 2 && mat2_.dense_dim() == 0,
+      "mm: Argument #2: matrices with scalar values expected, got ", mat2_.sparse_dim(), "D tensor with ",
+      mat2_.dense_dim(), "D values");
+  TORCH_CHECK(mat1_.scalar_type() == mat2_.scalar_type(),
+      "mm: expected 'mat1' and 'mat2' to have the same dtype, but got ", mat1_.scalar_type(), " and ",
+      mat2_.scalar_type());
+
+  // ixj * jxk = ixk
+  const int64_t dim_i = mat1_.size(0);
+  const int64_t dim_j = mat1_.size(1);
+  const int64_t dim_k = mat2_.size(1);
+  TORCH_CHECK(mat2_.size(0) == dim_j,
+      "mm: Argument #2: Expected dim 0 size ", dim_j, ", got ", mat2_.size(0));
+
+  SparseTensor mat1 = mat1_.coalesce();
+  SparseTensor mat2 = mat2_.coalesce();
+  LongTensor indices1 = mat1._indices().contiguous();
+  LongTensor indices2 = mat2._indices().contiguous();
+
+  Tensor r_crow, r_col, r_values;
+  std::tie(r_crow, r_col, r_values) = spgemm_csr_cpu(
+      dim_i,
+      dim_k,
+      _to_csr(indices1.data_ptr<int64_t>(), dim_i, mat1._nnz()),
+      indices1.select(0, 1).contiguous(),
+      mat1._values(),
+      _to_csr(indices2.data_ptr<int64_t>(), dim_j, mat2._nnz()),
+      indices2.select(0, 1).contiguous(),
+      mat2._values());
+
+  LongTensor r_rows = at::repeat_interleave(r_crow.slice(0, 1) - r_crow.narrow(0, 0, dim_i));
+  SparseTensor r = new_sparse(mat1.options());
+  get_sparse_impl(r)->raw_resize_(2, 0, {dim_i, dim_k});
+  get_sparse_impl(r)->set_indices_and_values_unsafe(at::stack({r_rows, r_col}), r_values);
+  return r._coalesced_(true);
+}
+
 // --------------------------------------------------------------------
 // sparse.sum()
 //
@@ -8,4 +8,17 @@ namespace at { namespace native {
 TORCH_API sparse::SparseTensor& mul_out_sparse_scalar(sparse::SparseTensor& r, const sparse::SparseTensor& t, Scalar value);
 TORCH_API sparse::SparseTensor& mul_out_sparse_zerodim(sparse::SparseTensor& r, const sparse::SparseTensor& t, const Tensor& value);
 
+// The CSR arrays (crow_indices, col_indices, values) of the product of two
+// CSR matrices of dim_i rows and of dim_k columns for the second one. The
+// columns of every row of the result are sorted and unique.
+TORCH_API std::tuple<Tensor, Tensor, Tensor> spgemm_csr_cpu(
+    int64_t dim_i,
+    int64_t dim_k,
+    const Tensor& crow1,
+    const Tensor& col1,
+    const Tensor& values1,
+    const Tensor& crow2,
+    const Tensor& col2,
+    const Tensor& values2);
+
 }}
@@ -286,6 +286,68 @@ template<> void csrmm2<double>(
 
 #endif
 
+/* Sparse x sparse */
+namespace {
+
+cusparseStatus_t csrgemm2_bufferSizeExt(cusparseHandle_t handle, int m, int n, int k, const float *alpha, cusparseMatDescr_t desc, int nnza, const int *csrrowptra, const int *csrcolinda, int nnzb, const int *csrrowptrb, const int *csrcolindb, csrgemm2Info_t info, size_t *pBufferSizeInBytes) {
+  return cusparseScsrgemm2_bufferSizeExt(handle, m, n, k, alpha, desc, nnza, csrrowptra, csrcolinda, desc, nnzb, csrrowptrb, csrcolindb, nullptr, desc, 0, nullptr, nullptr, info, pBufferSizeInBytes);
+}
+
+cusparseStatus_t csrgemm2_bufferSizeExt(cusparseHandle_t handle, int m, int n, int k, const double *alpha, cusparseMatDescr_t desc, int nnza, const int *csrrowptra, const int *csrcolinda, int nnzb, const int *csrrowptrb, const int *csrcolindb, csrgemm2Info_t info, size_t *pBufferSizeInBytes) {
+  return cusparseDcsrgemm2_bufferSizeExt(handle, m, n, k, alpha, desc, nnza, csrrowptra, csrcolinda, desc, nnzb, csrrowptrb, csrcolindb, nullptr, desc, 0, nullptr, nullptr, info, pBufferSizeInBytes);
+}
+
+cusparseStatus_t csrgemm2_compute(cusparseHandle_t handle, int m, int n, int k, const float *alpha, cusparseMatDescr_t desc, int nnza, const float *csrvala, const int *csrrowptra, const int *csrcolinda, int nnzb, const float *csrvalb, const int *csrrowptrb, const int *csrcolindb, float *csrvalc, const int *csrrowptrc, int *csrcolindc, csrgemm2Info_t info, void *pBuffer) {
+  return cusparseScsrgemm2(handle, m, n, k, alpha, desc, nnza, csrvala, csrrowptra, csrcolinda, desc, nnzb, csrvalb, csrrowptrb, csrcolindb, nullptr, desc, 0, nullptr, nullptr, nullptr, desc, csrvalc, csrrowptrc, csrcolindc, info, pBuffer);
+}
+
+cusparseStatus_t csrgemm2_compute(cusparseHandle_t handle, int m, int n, int k, const double *alpha, cusparseMatDescr_t desc, int nnza, const double *csrvala, const int *csrrowptra, const int *csrcolinda, int nnzb, const double *csrvalb, const int *csrrowptrb, const int *csrcolindb, double *csrvalc, const int *csrrowptrc, int *csrcolindc, csrgemm2Info_t info, void *pBuffer) {
+  return cusparseDcsrgemm2(handle, m, n, k, alpha, desc, nnza, csrvala, csrrowptra, csrcolinda, desc, nnzb, csrvalb, csrrowptrb, csrcolindb, nullptr, desc, 0, nullptr, nullptr, nullptr, desc, csrvalc, csrrowptrc, csrcolindc, info, pBuffer);
+}
+
+} // namespace
+
+template<typename T>
+void csrgemm2(int64_t m, int64_t n, int64_t k, int64_t nnza, const T *csrvala, const int *csrrowptra, const int *csrcolinda, int64_t nnzb, const T *csrvalb, const int *csrrowptrb, const int *csrcolindb, int *csrrowptrc, const std::function<void(int64_t, T**, int**)>& allocate)
+{
+  static_assert(std::is_same<float, T>::value || std::is_same<double, T>::value, "csrgemm2 only supports float and double");
+  TORCH_CHECK((m <= INT_MAX) && (n <= INT_MAX) && (k <= INT_MAX) && (nnza <= INT_MAX) && (nnzb <= INT_MAX),
+    "cusparseXcsrgemm2 only supports m, n, k, nnz with the bound [val] <= ", INT_MAX);
+  int i_m = (int)m;
+  int i_n = (int)n;
+  int i_k = (int)k;
+  int i_nnza = (int)nnza;
+  int i_nnzb = (int)nnzb;
+  const T alpha = 1;
+
+  auto handle = at::cuda::getCurrentCUDASparseHandle();
+  cusparseMatDescr_t desc;
+  TORCH_CUDASPARSE_CHECK(cusparseCreateMatDescr(&desc));
+  csrgemm2Info_t info;
+  TORCH_CUDASPARSE_CHECK(cusparseCreateCsrgemm2Info(&info));
+
+  size_t bufferSize;
+  TORCH_CUDASPARSE_CHECK(csrgemm2_bufferSizeExt(handle, i_m, i_n, i_k, &alpha, desc, i_nnza, csrrowptra, csrcolinda, i_nnzb, csrrowptrb, csrcolindb, info, &bufferSize));
+  auto& allocator = *c10::cuda::CUDACachingAllocator::get();
+  auto dataPtr = allocator.allocate(bufferSize);
+
+  // The number of elements of C is returned to the host
+  int nnzc;
+  TORCH_CUDASPARSE_CHECK(cusparseXcsrgemm2Nnz(handle, i_m, i_n, i_k, desc, i_nnza, csrrowptra, csrcolinda, desc, i_nnzb, csrrowptrb, csrcolindb, desc, 0, nullptr, nullptr, desc, csrrowptrc, &nnzc, info, dataPtr.get()));
+
+  T *csrvalc = nullptr;
+  int *csrcolindc = nullptr;
+  allocate(nnzc, &csrvalc, &csrcolindc);
+  if (nnzc > 0) {
+    TORCH_CUDASPARSE_CHECK(csrgemm2_compute(handle, i_m, i_n, i_k, &alpha, desc, i_nnza, csrvala, csrrowptra, csrcolinda, i_nnzb, csrvalb, csrrowptrb, csrcolindb, csrvalc, csrrowptrc, csrcolindc, info, dataPtr.get()));
+  }
+
+  TORCH_CUDASPARSE_CHECK(cusparseDestroyCsrgemm2Info(info));
+  TORCH_CUDASPARSE_CHECK(cusparseDestroyMatDescr(desc));
+}
+template void csrgemm2<float>(int64_t m, int64_t n, int64_t k, int64_t nnza, const float *csrvala, const int *csrrowptra, const int *csrcolinda, int64_t nnzb, const float *csrvalb, const int *csrrowptrb, const int *csrcolindb, int *csrrowptrc, const std::function<void(int64_t, float**, int**)>& allocate);
+template void csrgemm2<double>(int64_t m, int64_t n, int64_t k, int64_t nnza, const double *csrvala, const int *csrrowptra, const int *csrcolinda, int64_t nnzb, const double *csrvalb, const int *csrrowptrb, const int *csrcolindb, int *csrrowptrc, const std::function<void(int64_t, double**, int**)>& allocate);
+
 /* format conversion */
 void CreateIdentityPermutation(int64_t nnz, int *P) {
   TORCH_CHECK((nnz <= INT_MAX),
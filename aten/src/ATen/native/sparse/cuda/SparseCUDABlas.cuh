@@ -2,6 +2,8 @@
 
 #include <ATen/cuda/ATenCUDAGeneral.h>
 
+#include <functional>
+
 namespace at { namespace native { namespace sparse { namespace cuda {
 
 TORCH_CUDA_API void Xcoo2csr(const int *coorowind, int64_t nnz, int64_t m, int *csrrowptr);
@@ -10,6 +12,13 @@ TORCH_CUDA_API void Xcoo2csr(const int *coorowind, int64_t nnz, int64_t m, int *
 template<typename T> 
 TORCH_CUDA_API void csrmm2(char transa, char transb, int64_t m, int64_t n, int64_t k, int64_t nnz, T alpha, T *csrvala, int *csrrowptra, int *csrcolinda, T *b, int64_t ldb, T beta, T *c, int64_t ldc);
 
+/* Sparse x sparse, T can only be float or double */
+// C = A * B, all three in CSR format. The m + 1 row offsets of C are written
+// first, after which `allocate` is called with the number of elements of C to
+// get where its values and column indices go.
+template<typename T>
+TORCH_CUDA_API void csrgemm2(int64_t m, int64_t n, int64_t k, int64_t nnza, const T *csrvala, const int *csrrowptra, const int *csrcolinda, int64_t nnzb, const T *csrvalb, const int *csrrowptrb, const int *csrcolindb, int *csrrowptrc, const std::function<void(int64_t, T**, int**)>& allocate);
+
 /* format conversion */
 TORCH_CUDA_API void CreateIdentityPermutation(int64_t nnz, int *P);
 TORCH_CUDA_API void Xcsrsort_bufferSizeExt(int64_t m, int64_t n, int64_t nnz, const int *csrRowPtr, const int *csrColInd, size_t *pBufferSizeInBytes);
@@ -279,6 +279,89 @@ SparseTensor hspmm_sparse_cuda(const SparseTensor& sparse, const Tensor& dense)
   return r;
 }
 
+// --------------------------------------------------------------------
+// mm(SparseTensor mat1, SparseTensor mat2) -> SparseTensor
+//
+// Both matrices go to CSR for cuSPARSE's csrgemm2, whose result is turned
+// back to COO.
+// --------------------------------------------------------------------
+
+SparseTensor sparse_sparse_matmul_cuda(const SparseTensor& mat1_, const SparseTensor& mat2_) {
+  TORCH_CHECK(mat1_.is_cuda(), "mm: expected 'mat1' to be CUDA, but got CPU");
+  TORCH_CHECK(mat2_.is_cuda(), "mm: expected 'mat2' to be CUDA, but got CPU");
+  TORCH_CHECK(cuda::check_device({mat1_, mat2_}));
+  TORCH_CHECK(mat1_.is_sparse() && mat2_.is_sparse(),
+      "mm: expected both arguments to be sparse tensors, but got layouts ", mat1_.layout(), " and ", mat2_.layout());
+  TORCH_CHECK(mat1_.sparse_dim() == 2 && mat1_.dense_dim() == 0,
+      "mm: Argument #1: matrices with scalar values expected, got ", mat1_.sparse_dim(), "D tensor with ",
+      mat1_.dense_dim(), "D values");
+  TORCH_CHECK(mat2_.sparse_dim() == 2 && mat2_.dense_dim() == 0,
+      "mm: Argument #2: matrices with scalar values expected, got ", mat2_.sparse_dim(), "D tensor with ",
+      mat2_.dense_dim(), "D values");
+  TORCH_CHECK(mat1_.scalar_type() == mat2_.scalar_type(),
+      "mm: expected 'mat1' and 'mat2' to have the same dtype, but got ", mat1_.scalar_type(), " and ",
+      mat2_.scalar_type());
+
+  // ixj * jxk = ixk
+  int64_t dim_i = mat1_.size(0);
+  int64_t dim_j = mat1_.size(1);
+  int64_t dim_k = mat2_.size(1);
+  TORCH_CHECK(mat2_.size(0) == dim_j,
+      "mm: Argument #2: Expected dim 0 size ", dim_j, ", got ", mat2_.size(0));
+
+  SparseTensor r = at::empty({0}, mat1_.options());
+  get_sparse_impl(r)->resize_and_clear_(2, 0, {dim_i, dim_k});
+
+  SparseTensor mat1 = mat1_.coalesce();
+  SparseTensor mat2 = mat2_.coalesce();
+  int64_t nnz1 = mat1._nnz();
+  int64_t nnz2 = mat2._nnz();
+  if (nnz1 == 0 || nnz2 == 0) {
+    return r._coalesced_(true);
+  }
+
+  LongTensor indices1 = mat1._indices();
+  LongTensor indices2 = mat2._indices();
+  IntTensor crow1 = _to_csr_int(indices1.select(0, 0), dim_i, nnz1);
+  IntTensor crow2 = _to_csr_int(indices2.select(0, 0), dim_j, nnz2);
+  IntTensor col1 = indices1.select(0, 1).to(kInt);
+  IntTensor col2 = indices2.select(0, 1).to(kInt);
+  IntTensor r_crow = at::empty({dim_i + 1}, crow1.options());
+  IntTensor r_col;
+  Tensor r_values;
+
+  AT_DISPATCH_FLOATING_TYPES(mat1.scalar_type(), "sparse_sparse_matmul_cuda", [&] {
+    Tensor values1 = mat1._values().contiguous();
+    Tensor values2 = mat2._values().contiguous();
+    sparse::cuda::csrgemm2<scalar_t>(
+      dim_i,
+      dim_k,
+      dim_j,
+      nnz1,
+      values1.data_ptr<scalar_t>(),
+      crow1.data_ptr<int32_t>(),
+      col1.data_ptr<int32_t>(),
+      nnz2,
+      values2.data_ptr<scalar_t>(),
+      crow2.data_ptr<int32_t>(),
+      col2.data_ptr<int32_t>(),
+      r_crow.data_ptr<int32_t>(),
+      [&](int64_t r_nnz, scalar_t** r_values_ptr, int** r_col_ptr) {
+        r_values = at::empty({r_nnz}, values1.options());
+        r_col = at::empty({r_nnz}, crow1.options());
+        *r_values_ptr = r_values.data_ptr<scalar_t>();
+        *r_col_ptr = r_col.data_ptr<int32_t>();
+      });
+  });
+
+  LongTensor r_crow_long = r_crow.to(kLong);
+  LongTensor r_rows = at::repeat_interleave(r_crow_long.slice(0, 1) - r_crow_long.narrow(0, 0, dim_i));
+  get_sparse_impl(r)->set_indices_and_values_unsafe(at::stack({r_rows, r_col.to(kLong)}), r_values);
+  // The elements are unique, but cuSPARSE does not promise their order within
+  // a row
+  return r._coalesced_(false);
+}
+
 // --------------------------------------------------------------------
 // add(Tensor, SparseTensor, Scalar)
 //    formerly known as spcadd
@@ -37,8 +37,11 @@ struct ContextConv2D final {
   Operator op;
   std::array<int64_t, 4> weight_size_;
   std::array<int64_t, 2> padding_;
+  std::array<int64_t, 2> output_padding_;
   std::array<int64_t, 2> stride_;
   std::array<int64_t, 2> dilation_;
+  int64_t groups_;
+  bool transposed_;
 
   ContextConv2D() = delete;
 
@@ -46,13 +49,19 @@ struct ContextConv2D final {
       Operator&& o,
       std::array<int64_t, 4> weight_size,
       std::array<int64_t, 2> padding,
+      std::array<int64_t, 2> output_padding,
       std::array<int64_t, 2> stride,
-      std::array<int64_t, 2> dilation)
+      std::array<int64_t, 2> dilation,
+      int64_t groups,
+      bool transposed)
       :  op(std::move(o)),
          weight_size_(weight_size),
          padding_(padding),
+         output_padding_(output_padding),
          stride_(stride),
-         dilation_(dilation) {}
+         dilation_(dilation),
+         groups_(groups),
+         transposed_(transposed) {}
   static constexpr float kMin = -std::numeric_limits<float>::infinity();
   static constexpr float kMax = std::numeric_limits<float>::infinity();
 };
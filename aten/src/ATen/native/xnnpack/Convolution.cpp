@@ -16,21 +16,29 @@ namespace convolution2d {
 
 namespace {
 
-// Supports NHWC and NCHW FP32 convolutions with any valid
+// Supports NHWC and NCHW FP32 convolutions and transposed convolutions with
+// any valid
 //  - kernel size
 //  - padding
+//  - output padding (transposed convolutions only)
 //  - stride
 //  - dilation
 //  - grouping
+//
+// The weight of a transposed convolution is laid out as
+// [input channels, output channels / groups, height, width], that is with the
+// Filter::output and Filter::input dimensions swapped.
 
 // TODO: Decouple and improve error handling and messages.
 bool available(
     const Tensor& weight,
     const c10::optional<Tensor>& bias,
     const IntArrayRef padding,
+    const IntArrayRef output_padding,
     const IntArrayRef stride,
     const IntArrayRef dilation,
     const int64_t groups,
+    const bool transposed,
     const float output_min,
     const float output_max) {
          // XNNPACK
@@ -45,11 +53,19 @@ bool available(
          ((bias && bias->defined()) ? ((1 == bias->ndimension()) &&
                                       (c10::DeviceType::CPU == bias->device().type()) &&
                                       (kFloat == bias->scalar_type()) &&
-                                      (weight.size(Layout::Filter::output)) == bias->size(0))
+                                      ((transposed ? (weight.size(Layout::Filter::input) * groups)
+                                                   : weight.size(Layout::Filter::output)) == bias->size(0)))
                                     : true) &&
          // Padding
          (padding[Layout::Parameter::height] >= 0) &&
          (padding[Layout::Parameter::width] >= 0) &&
+         // Output Padding
+         (!transposed || ((output_padding[Layout::Parameter::height] >= 0) &&
+                          (output_padding[Layout::Parameter::width] >= 0) &&
+                          (output_padding[Layout::Parameter::height] <
+                              std::max(stride[Layout::Parameter::height], dilation[Layout::Parameter::height])) &&
+                          (output_padding[Layout::Parameter::width] <
+                              std::max(stride[Layout::Parameter::width], dilation[Layout::Parameter::width])))) &&
          // Stride
          (stride[Layout::Parameter::height] > 0) &&
          (stride[Layout::Parameter::width] > 0) &&
@@ -62,7 +78,7 @@ bool available(
          (weight.size(Layout::Filter::input) > 0) &&
          // Output
          (weight.size(Layout::Filter::output) > 0) &&
-         // Output - Groups
+         // Output - Groups (the input channels of transposed convolutions)
          ((weight.size(Layout::Filter::output) % groups) == 0) &&
          // Output Min / Max
          (output_max > output_min) &&
@@ -98,9 +114,11 @@ Tensor create_and_run(
           weight,
           bias,
           padding,
+          {},
           stride,
           dilation,
           groups,
+          false,
           output_min,
           output_max),
       input);
@@ -112,68 +130,126 @@ ContextConv2D create(
     const Tensor& weight,
     const c10::optional<Tensor>& bias,
     const IntArrayRef padding,
+    const IntArrayRef output_padding,
     const IntArrayRef stride,
     const IntArrayRef dilation,
     const int64_t groups,
+    const bool transposed,
     const float output_min,
     const float output_max) {
   const auto padding_expanded = expand_param_if_needed(padding, "padding", 2);
+  const auto output_padding_expanded =
+      transposed ? expand_param_if_needed(output_padding, "output_padding", 2)
+                 : std::vector<int64_t>{0, 0};
   const auto stride_expanded = expand_param_if_needed(stride, "stride", 2);
   const auto dilation_expanded = expand_param_if_needed(dilation, "dilation", 2);
-  const Tensor weight_nhwc = weight.contiguous(MemoryFormat::ChannelsLast);
 
   TORCH_CHECK(
       available(
-          weight_nhwc,
+          weight,
           bias,
           padding_expanded,
+          output_padding_expanded,
           stride_expanded,
           dilation_expanded,
           groups,
+          transposed,
           output_min,
           output_max),
       "xnnpack::convolution not available! "
-      "Reason: The provided (weight, bias, padding, stride, dilation, groups, output_min, output_max) "
+      "Reason: The provided (weight, bias, padding, output_padding, stride, dilation, groups, transposed, output_min, output_max) "
       "parameters are either invalid individually or their combination is not supported by XNNPACK.");
 
   xnn_operator_t convolution_op{};
 
-  const xnn_status create_status = xnn_create_convolution2d_nhwc_f32(
-      padding_expanded[Layout::Parameter::height],                    // input_padding_top
-      padding_expanded[Layout::Parameter::width],                     // input_padding_right
-      padding_expanded[Layout::Parameter::height],                    // input_padding_bottom
-      padding_expanded[Layout::Parameter::width],                     // input_padding_left
-      weight_nhwc.size(Layout::Filter::height),                       // kernel_height
-      weight_nhwc.size(Layout::Filter::width),                        // kernel_width
-      stride_expanded[Layout::Parameter::height],                     // subsampling_height
-      stride_expanded[Layout::Parameter::width],                      // subsampling_width
-      dilation_expanded[Layout::Parameter::height],                   // dilation_height
-      dilation_expanded[Layout::Parameter::width],                    // dilation_width
-      groups,                                                         // groups
-      weight_nhwc.size(Layout::Filter::input),                        // group_input_channels
-      weight_nhwc.size(Layout::Filter::output) / groups,              // group_output_channels
-      weight_nhwc.size(Layout::Filter::input) * groups,               // input_pixel_stride
-      weight_nhwc.size(Layout::Filter::output),                       // output_pixel_stride
-      weight_nhwc.data_ptr<float>(),                                  // kernel
-      (bias && bias->defined())
-          ? bias->contiguous().data_ptr<float>()
-          : nullptr,                                                  // bias
-      output_min,                                                     // output_min
-      output_max,                                                     // output_max
-      0u,                                                             // flags
-      &convolution_op);                                               // operator
-
-  TORCH_CHECK(
-      xnn_status_success == create_status,
-      "xnn_create_convolution2d_nhwc_f32 failed!");
+  if (transposed) {
+    // XNNPACK expects the weight of a deconvolution as
+    // [groups, group_output_channels, height, width, group_input_channels].
+    const int64_t group_input_channels =
+        weight.size(Layout::Filter::output) / groups;
+    const int64_t group_output_channels = weight.size(Layout::Filter::input);
+    const Tensor weight_reordered = weight
+        .view({
+            groups,
+            group_input_channels,
+            group_output_channels,
+            weight.size(Layout::Filter::height),
+            weight.size(Layout::Filter::width),
+        })
+        .permute({0, 2, 3, 4, 1})
+        .contiguous();
+
+    const xnn_status create_status = xnn_create_deconvolution2d_nhwc_f32(
+        padding_expanded[Layout::Parameter::height],                  // output_padding_top
+        padding_expanded[Layout::Parameter::width],                   // output_padding_right
+        padding_expanded[Layout::Parameter::height],                  // output_padding_bottom
+        padding_expanded[Layout::Parameter::width],                   // output_padding_left
+        weight.size(Layout::Filter::height),                          // kernel_height
+        weight.size(Layout::Filter::width),                           // kernel_width
+        stride_expanded[Layout::Parameter::height],                   // stride_height
+        stride_expanded[Layout::Parameter::width],                    // stride_width
+        dilation_expanded[Layout::Parameter::height],                 // dilation_height
+        dilation_expanded[Layout::Parameter::width],                  // dilation_width
+        groups,                                                       // groups
+        group_input_channels,                                         // group_input_channels
+        group_output_channels,                                        // group_output_channels
+        group_input_channels * groups,                                // input_pixel_stride
+        group_output_channels * groups,                               // output_pixel_stride
+        weight_reordered.data_ptr<float>(),                           // kernel
+        (bias && bias->defined())
+            ? bias->contiguous().data_ptr<float>()
+            : nullptr,                                                // bias
+        output_min,                                                   // output_min
+        output_max,                                                   // output_max
+        0u,                                                           // flags
+        &convolution_op);                                             // operator
+
+    TORCH_CHECK(
+        xnn_status_success == create_status,
+        "xnn_create_deconvolution2d_nhwc_f32 failed!");
+  } else {
+    const Tensor weight_nhwc = weight.contiguous(MemoryFormat::ChannelsLast);
+
+    const xnn_status create_status = xnn_create_convolution2d_nhwc_f32(
+        padding_expanded[Layout::Parameter::height],                  // input_padding_top
+        padding_expanded[Layout::Parameter::width],                   // input_padding_right
+        padding_expanded[Layout::Parameter::height],                  // input_padding_bottom
+        padding_expanded[Layout::Parameter::width],                   // input_padding_left
+        weight_nhwc.size(Layout::Filter::height),                     // kernel_height
+        weight_nhwc.size(Layout::Filter::width),                      // kernel_width
+        stride_expanded[Layout::Parameter::height],                   // subsampling_height
+        stride_expanded[Layout::Parameter::width],                    // subsampling_width
+        dilation_expanded[Layout::Parameter::height],                 // dilation_height
+        dilation_expanded[Layout::Parameter::width],                  // dilation_width
+        groups,                                                       // groups
+        weight_nhwc.size(Layout::Filter::input),                      // group_input_channels
+        weight_nhwc.size(Layout::Filter::output) / groups,            // group_output_channels
+        weight_nhwc.size(Layout::Filter::input) * groups,             // input_pixel_stride
+        weight_nhwc.size(Layout::Filter::output),                     // output_pixel_stride
+        weight_nhwc.data_ptr<float>(),                                // kernel
+        (bias && bias->defined())
+            ? bias->contiguous().data_ptr<float>()
+            : nullptr,                                                // bias
+        output_min,                                                   // output_min
+        output_max,                                                   // output_max
+        0u,                                                           // flags
+        &convolution_op);                                             // operator
+
+    TORCH_CHECK(
+        xnn_status_success == create_status,
+        "xnn_create_convolution2d_nhwc_f32 failed!");
+  }
 
   return ContextConv2D{
       Operator(convolution_op),
-      {weight_nhwc.sizes()[0], weight_nhwc.sizes()[1],
-          weight_nhwc.sizes()[2], weight_nhwc.sizes()[3]},
+      {weight.sizes()[0], weight.sizes()[1],
+          weight.sizes()[2], weight.sizes()[3]},
       {padding_expanded[0], padding_expanded[1]},
+      {output_padding_expanded[0], output_padding_expanded[1]},
       {stride_expanded[0], stride_expanded[1]},
-      {dilation_expanded[0], dilation_expanded[1]}
+      {dilation_expanded[0], dilation_expanded[1]},
+      groups,
+      transposed,
   };
 }
 
@@ -191,28 +267,54 @@ Tensor run(
       "Reason: The provided input tensor is either invalid or unsupported by XNNPACK.");
 
   Tensor output = empty_with_tail_padding(
-      conv_output_size(
-          padded_input_nhwc.sizes(),
-          context.weight_size_,
-          context.padding_,
-          context.stride_,
-          context.dilation_),
+      context.transposed_
+          ? conv_input_size(
+                padded_input_nhwc.sizes(),
+                context.weight_size_,
+                context.padding_,
+                context.output_padding_,
+                context.stride_,
+                context.dilation_,
+                context.groups_)
+          : conv_output_size(
+                padded_input_nhwc.sizes(),
+                context.weight_size_,
+                context.padding_,
+                context.stride_,
+                context.dilation_),
       padded_input_nhwc.options().dtype(),
       MemoryFormat::ChannelsLast,
       padded_input_nhwc.names());
 
-  const xnn_status setup_status = xnn_setup_convolution2d_nhwc_f32(
-      context.op.get(),                                      // operator
-      padded_input_nhwc.size(Layout::Activation4D::batch),   // batch_size
-      padded_input_nhwc.size(Layout::Activation4D::height),  // input_height
-      padded_input_nhwc.size(Layout::Activation4D::width),   // input_width
-      padded_input_nhwc.data_ptr<float>(),                   // input
-      output.data_ptr<float>(),                              // output
-      caffe2::xnnpack_threadpool());                         // threadpool
-
-  TORCH_CHECK(
-      xnn_status_success == setup_status,
-      "xnn_setup_convolution2d_nhwc_f32 failed!");
+  if (context.transposed_) {
+    const xnn_status setup_status = xnn_setup_deconvolution2d_nhwc_f32(
+        context.op.get(),                                      // operator
+        padded_input_nhwc.size(Layout::Activation4D::batch),   // batch_size
+        padded_input_nhwc.size(Layout::Activation4D::height),  // input_height
+        padded_input_nhwc.size(Layout::Activation4D::width),   // input_width
+        context.output_padding_[Layout::Parameter::height],    // adjustment_height
+        context.output_padding_[Layout::Parameter::width],     // adjustment_width
+        padded_input_nhwc.data_ptr<float>(),                   // input
+        output.data_ptr<float>(),                              // output
+        caffe2::xnnpack_threadpool());                         // threadpool
+
+    TORCH_CHECK(
+        xnn_status_success == setup_status,
+        "xnn_setup_deconvolution2d_nhwc_f32 failed!");
+  } else {
+    const xnn_status setup_status = xnn_setup_convolution2d_nhwc_f32(
+        context.op.get(),                                      // operator
+        padded_input_nhwc.size(Layout::Activation4D::batch),   // batch_size
+        padded_input_nhwc.size(Layout::Activation4D::height),  // input_height
+        padded_input_nhwc.size(Layout::Activation4D::width),   // input_width
+        padded_input_nhwc.data_ptr<float>(),                   // input
+        output.data_ptr<float>(),                              // output
+        caffe2::xnnpack_threadpool());                         // threadpool
+
+    TORCH_CHECK(
+        xnn_status_success == setup_status,
+        "xnn_setup_convolution2d_nhwc_f32 failed!");
+  }
 
   const xnn_status run_status = xnn_run_operator(
       context.op.get(),               // operator
@@ -252,6 +354,35 @@ Tensor conv2d_clamp_run(
   return op_context->run(input);
 }
 
+c10::intrusive_ptr<xnnpack::TransposeConv2dOpContext>
+    createConv2dTransposeClampPrePackOpContext(
+        Tensor weight,
+        c10::optional<Tensor> bias,
+        std::vector<int64_t> stride,
+        std::vector<int64_t> padding,
+        std::vector<int64_t> output_padding,
+        std::vector<int64_t> dilation,
+        int64_t groups,
+        c10::optional<Scalar> output_min,
+        c10::optional<Scalar> output_max) {
+      return xnnpack::XNNPackTransposeConv2dOpContext::create_context(
+          std::move(weight),
+          std::move(bias),
+          std::move(padding),
+          std::move(output_padding),
+          std::move(stride),
+          std::move(dilation),
+          groups,
+          output_min,
+          output_max);
+}
+
+Tensor conv2d_transpose_clamp_run(
+    const Tensor& input,
+    const c10::intrusive_ptr<xnnpack::TransposeConv2dOpContext>& op_context) {
+  return op_context->run(input);
+}
+
 } // namespace convolution2d
 } // namespace internal
 
@@ -262,16 +393,20 @@ bool use_convolution2d(
     const IntArrayRef padding,
     const IntArrayRef stride,
     const IntArrayRef dilation,
-    const int64_t groups) {
+    const int64_t groups,
+    const float output_min,
+    const float output_max) {
   return internal::convolution2d::available(
             weight,
             bias,
             padding,
+            {},
             stride,
             dilation,
             groups,
-            ContextConv2D::kMin,
-            ContextConv2D::kMax) &&
+            false,
+            output_min,
+            output_max) &&
          internal::convolution2d::usable(input);
 }
 
@@ -282,7 +417,9 @@ Tensor convolution2d(
     const IntArrayRef padding,
     const IntArrayRef stride,
     const IntArrayRef dilation,
-    const int64_t groups) {
+    const int64_t groups,
+    const float output_min,
+    const float output_max) {
   return internal::convolution2d::create_and_run(
       input,
       weight,
@@ -291,8 +428,8 @@ Tensor convolution2d(
       stride,
       dilation,
       groups,
-      ContextConv2D::kMin,
-      ContextConv2D::kMax);
+      output_min,
+      output_max);
 }
 
 } // namespace xnnpack
@@ -27,13 +27,33 @@ Tensor conv2d_clamp_run(
     const Tensor& input,
     const c10::intrusive_ptr<xnnpack::Conv2dOpContext>& op_context);
 
+c10::intrusive_ptr<xnnpack::TransposeConv2dOpContext>
+    createConv2dTransposeClampPrePackOpContext(
+        Tensor weight,
+        c10::optional<Tensor> bias,
+        std::vector<int64_t> stride,
+        std::vector<int64_t> padding,
+        std::vector<int64_t> output_padding,
+        std::vector<int64_t> dilation,
+        int64_t groups,
+        c10::optional<Scalar> output_min,
+        c10::optional<Scalar> output_max);
+
+Tensor conv2d_transpose_clamp_run(
+    const Tensor& input,
+    const c10::intrusive_ptr<xnnpack::TransposeConv2dOpContext>& op_context);
+
+// output_padding is only used by, and weight is laid out as that of,
+// transposed convolutions if transposed is set.
 ContextConv2D create(
     const Tensor& weight,
     const c10::optional<Tensor>& bias,
     const IntArrayRef padding,
+    const IntArrayRef output_padding,
     const IntArrayRef stride,
     const IntArrayRef dilation,
     const int64_t groups,
+    const bool transposed,
     const float output_min,
     const float output_max);
 
@@ -0,0 +1,226 @@
+#ifdef USE_XNNPACK
+
+#include <ATen/native/xnnpack/Common.h>
+#include <ATen/native/xnnpack/Engine.h>
+#include <ATen/native/xnnpack/Factory.h>
+
+namespace at {
+namespace native {
+namespace xnnpack {
+
+// Supports FP32 elementwise operators on tensors of any shape, in any memory
+// format.  The tensors are processed in the order of their memory, as one
+// contiguous block, so that the NHWC activations of the XNNPACK convolutions
+// and pooling operators are neither copied nor converted to NCHW in between.
+
+namespace internal {
+namespace elementwise {
+namespace {
+
+bool usable(const Tensor& input) {
+  return xnnpack::internal::available() &&
+      // Input
+      (c10::DeviceType::CPU == input.device().type()) &&
+      (kFloat == input.scalar_type()) &&
+      (c10::kStrided == input.layout()) &&
+      (input.numel() > 0) &&
+      !input.requires_grad() &&
+      true;
+}
+
+// The output in the memory format of the input
+Tensor allocate_output(const Tensor& input_padded_contig) {
+  return empty_with_tail_padding(
+      input_padded_contig.sizes(),
+      input_padded_contig.options().dtype(),
+      input_padded_contig.suggest_memory_format(),
+      input_padded_contig.names());
+}
+
+void run(const xnn_operator_t op) {
+  const xnn_status run_status = xnn_run_operator(
+      op,                             // operator
+      caffe2::xnnpack_threadpool());  // threadpool
+
+  TORCH_INTERNAL_ASSERT(
+      xnn_status_success == run_status,
+      "xnn_run_operator failed!");
+}
+
+} // namespace
+} // namespace elementwise
+} // namespace internal
+
+//
+// Add
+//
+
+bool use_add(const Tensor& input, const Tensor& other) {
+  // Broadcasting, name unification and the tensors of different memory
+  // formats are left to TensorIterator.
+  return internal::elementwise::usable(input) &&
+      internal::elementwise::usable(other) &&
+      (input.sizes() == other.sizes()) &&
+      (input.suggest_memory_format() == other.suggest_memory_format()) &&
+      !input.has_names() &&
+      !other.has_names() &&
+      true;
+}
+
+Tensor add(const Tensor& input, const Tensor& other) {
+  using namespace internal;
+
+  const c10::MemoryFormat memory_format = input.suggest_memory_format();
+  const Tensor input_padded_contig =
+      allocate_padded_contiguous_if_needed(input, memory_format);
+  const Tensor other_padded_contig =
+      allocate_padded_contiguous_if_needed(other, memory_format);
+  Tensor output_padded_contig =
+      elementwise::allocate_output(input_padded_contig);
+
+  xnn_operator_t add_op{};
+
+  const xnn_status create_status = xnn_create_add_nd_f32(
+      -std::numeric_limits<float>::infinity(),  // output_min
+      std::numeric_limits<float>::infinity(),   // output_max
+      0u,                                       // flags
+      &add_op);                                 // operator
+
+  TORCH_CHECK(
+      xnn_status_success == create_status,
+      "xnn_create_add_nd_f32 failed!");
+
+  Operator add_scoped_op(add_op);
+
+  const size_t shape[1] = {static_cast<size_t>(input_padded_contig.numel())};
+
+  const xnn_status setup_status = xnn_setup_add_nd_f32(
+      add_op,                                   // operator
+      1u,                                       // num_input1_dims
+      shape,                                    // input1_shape
+      1u,                                       // num_input2_dims
+      shape,                                    // input2_shape
+      input_padded_contig.data_ptr<float>(),    // input1
+      other_padded_contig.data_ptr<float>(),    // input2
+      output_padded_contig.data_ptr<float>(),   // output
+      caffe2::xnnpack_threadpool());            // threadpool
+
+  TORCH_CHECK(
+      xnn_status_success == setup_status,
+      "xnn_setup_add_nd_f32 failed!");
+
+  elementwise::run(add_op);
+
+  return output_padded_contig;
+}
+
+//
+// Clamp
+//
+
+bool use_clamp(
+    const Tensor& input,
+    const float output_min,
+    const float output_max) {
+  return internal::elementwise::usable(input) &&
+      // Output Min / Max
+      (output_max > output_min) &&
+      true;
+}
+
+Tensor clamp(
+    const Tensor& input,
+    const float output_min,
+    const float output_max) {
+  using namespace internal;
+
+  const Tensor input_padded_contig = allocate_padded_contiguous_if_needed(
+      input, input.suggest_memory_format());
+  Tensor output_padded_contig =
+      elementwise::allocate_output(input_padded_contig);
+
+  xnn_operator_t clamp_op{};
+
+  const xnn_status create_status = xnn_create_clamp_nc_f32(
+      1u,           // channels
+      1u,           // input_stride
+      1u,           // output_stride
+      output_min,   // output_min
+      output_max,   // output_max
+      0u,           // flags
+      &clamp_op);   // operator
+
+  TORCH_CHECK(
+      xnn_status_success == create_status,
+      "xnn_create_clamp_nc_f32 failed!");
+
+  Operator clamp_scoped_op(clamp_op);
+
+  const xnn_status setup_status = xnn_setup_clamp_nc_f32(
+      clamp_op,                                 // operator
+      input_padded_contig.numel(),              // batch_size
+      input_padded_contig.data_ptr<float>(),    // input
+      output_padded_contig.data_ptr<float>(),   // output
+      caffe2::xnnpack_threadpool());            // threadpool
+
+  TORCH_CHECK(
+      xnn_status_success == setup_status,
+      "xnn_setup_clamp_nc_f32 failed!");
+
+  elementwise::run(clamp_op);
+
+  return output_padded_contig;
+}
+
+//
+// Hardswish
+//
+
+bool use_hardswish(const Tensor& input) {
+  return internal::elementwise::usable(input);
+}
+
+Tensor hardswish(const Tensor& input) {
+  using namespace internal;
+
+  const Tensor input_padded_contig = allocate_padded_contiguous_if_needed(
+      input, input.suggest_memory_format());
+  Tensor output_padded_contig =
+      elementwise::allocate_output(input_padded_contig);
+
+  xnn_operator_t hardswish_op{};
+
+  const xnn_status create_status = xnn_create_hardswish_nc_f32(
+      1u,               // channels
+      1u,               // input_stride
+      1u,               // output_stride
+      0u,               // flags
+      &hardswish_op);   // operator
+
+  TORCH_CHECK(
+      xnn_status_success == create_status,
+      "xnn_create_hardswish_nc_f32 failed!");
+
+  Operator hardswish_scoped_op(hardswish_op);
+
+  const xnn_status setup_status = xnn_setup_hardswish_nc_f32(
+      hardswish_op,                             // operator
+      input_padded_contig.numel(),              // batch_size
+      input_padded_contig.data_ptr<float>(),    // input
+      output_padded_contig.data_ptr<float>(),   // output
+      caffe2::xnnpack_threadpool());            // threadpool
+
+  TORCH_CHECK(
+      xnn_status_success == setup_status,
+      "xnn_setup_hardswish_nc_f32 failed!");
+
+  elementwise::run(hardswish_op);
+
+  return output_padded_contig;
+}
+
+} // namespace xnnpack
+} // namespace native
+} // namespace at
+
+#endif /* USE_XNNPACK */
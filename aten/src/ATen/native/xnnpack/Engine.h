@@ -17,7 +17,9 @@ bool use_convolution2d(
     const IntArrayRef padding,
     const IntArrayRef stride,
     const IntArrayRef dilation,
-    const int64_t groups);
+    const int64_t groups,
+    float output_min = -std::numeric_limits<float>::infinity(),
+    float output_max = +std::numeric_limits<float>::infinity());
 
 Tensor convolution2d(
     const Tensor& input,
@@ -26,7 +28,9 @@ Tensor convolution2d(
     const IntArrayRef padding,
     const IntArrayRef stride,
     const IntArrayRef dilation,
-    const int64_t groups);
+    const int64_t groups,
+    float output_min = -std::numeric_limits<float>::infinity(),
+    float output_max = +std::numeric_limits<float>::infinity());
 
 //
 // Linear
@@ -35,12 +39,16 @@ Tensor convolution2d(
 bool use_linear(
   const Tensor& input,
   const Tensor& weight,
-  const Tensor& bias);
+  const Tensor& bias,
+  float output_min = -std::numeric_limits<float>::infinity(),
+  float output_max = +std::numeric_limits<float>::infinity());
 
 Tensor linear(
   const Tensor& input,
   const Tensor& weight,
-  const Tensor& bias);
+  const Tensor& bias,
+  float output_min = -std::numeric_limits<float>::infinity(),
+  float output_max = +std::numeric_limits<float>::infinity());
 
 //
 // Max Pooling
@@ -66,6 +74,38 @@ Tensor max_pool2d(
     float output_min = -std::numeric_limits<float>::infinity(),
     float output_max = +std::numeric_limits<float>::infinity());
 
+//
+// Global Average Pooling
+//
+
+bool use_global_average_pool(const Tensor& input);
+
+Tensor global_average_pool(const Tensor& input);
+
+//
+// Channel Shuffle
+//
+
+bool use_channel_shuffle(const Tensor& input, int64_t groups);
+
+Tensor channel_shuffle(const Tensor& input, int64_t groups);
+
+//
+// Elementwise
+//
+
+bool use_add(const Tensor& input, const Tensor& other);
+
+Tensor add(const Tensor& input, const Tensor& other);
+
+bool use_clamp(const Tensor& input, float output_min, float output_max);
+
+Tensor clamp(const Tensor& input, float output_min, float output_max);
+
+bool use_hardswish(const Tensor& input);
+
+Tensor hardswish(const Tensor& input);
+
 } // namespace xnnpack
 } // namespace native
 } // namespace at
@@ -175,12 +175,14 @@ Tensor linear_clamp_run(
 bool use_linear(
     const Tensor& input,
     const Tensor& weight,
-    const Tensor& bias) {
+    const Tensor& bias,
+    const float output_min,
+    const float output_max) {
   return internal::linear::available(
             weight,
             bias,
-            ContextLinear::kMin,
-            ContextLinear::kMax) &&
+            output_min,
+            output_max) &&
          internal::linear::usable(input);
       internal::linear::usable(input);
 }
@@ -188,13 +190,15 @@ bool use_linear(
 Tensor linear(
     const Tensor& input,
     const Tensor& weight,
-    const Tensor& bias) {
+    const Tensor& bias,
+    const float output_min,
+    const float output_max) {
   return internal::linear::create_and_run(
       input,
       weight,
       bias,
-      ContextLinear::kMin,
-      ContextLinear::kMax);
+      output_min,
+      output_max);
 }
 
 } // namespace xnnpack
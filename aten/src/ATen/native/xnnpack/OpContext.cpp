@@ -48,9 +48,11 @@ XNNPackConv2dOpContext::create_context(at::Tensor&& weight,
           weight,
           bias,
           padding,
+          {},
           stride,
           dilation,
           groups,
+          false,
           output_min ? output_min->to<float>()
                      : xnnpack::ContextConv2D::kMin,
           output_max ? output_max->to<float>()
@@ -73,6 +75,49 @@ Tensor XNNPackConv2dOpContext::run(const Tensor& input) {
   return xnnpack::internal::convolution2d::run(op_context_, input);
 }
 
+c10::intrusive_ptr<TransposeConv2dOpContext>
+XNNPackTransposeConv2dOpContext::create_context(at::Tensor&& weight,
+    c10::optional<at::Tensor>&& bias,
+    std::vector<int64_t>&& padding,
+    std::vector<int64_t>&& output_padding,
+    std::vector<int64_t>&& stride,
+    std::vector<int64_t>&& dilation,
+    int64_t groups,
+    const c10::optional<Scalar> output_min,
+    const c10::optional<Scalar> output_max) {
+  auto op_context =
+      xnnpack::internal::convolution2d::create(
+          weight,
+          bias,
+          padding,
+          output_padding,
+          stride,
+          dilation,
+          groups,
+          true,
+          output_min ? output_min->to<float>()
+                     : xnnpack::ContextConv2D::kMin,
+          output_max ? output_max->to<float>()
+                     : xnnpack::ContextConv2D::kMax);
+  auto conv2d_op_context =
+      c10::make_intrusive<XNNPackTransposeConv2dOpContext>(
+          std::move(weight),
+          std::move(bias),
+          std::move(padding),
+          std::move(output_padding),
+          std::move(stride),
+          std::move(dilation),
+          groups,
+          output_min,
+          output_max,
+          std::move(op_context));
+  return conv2d_op_context;
+}
+
+Tensor XNNPackTransposeConv2dOpContext::run(const Tensor& input) {
+  return xnnpack::internal::convolution2d::run(op_context_, input);
+}
+
 } // namespace xnnpack
 } // namespace native
 } // namespace at
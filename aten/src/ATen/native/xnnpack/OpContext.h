@@ -24,6 +24,16 @@ using SerializationTypeConv2dPrePack = std::tuple<
     int64_t,
     c10::optional<Scalar>,
     c10::optional<Scalar>>;
+using SerializationTypeTransposeConv2dPrePack = std::tuple<
+    Tensor,
+    c10::optional<Tensor>,
+    std::vector<int64_t>,
+    std::vector<int64_t>,
+    std::vector<int64_t>,
+    std::vector<int64_t>,
+    int64_t,
+    c10::optional<Scalar>,
+    c10::optional<Scalar>>;
 
 class LinearOpContext : public torch::jit::CustomClassHolder {
  protected:
@@ -132,6 +142,77 @@ class XNNPackConv2dOpContext final : public Conv2dOpContext {
       const c10::optional<Scalar> output_min,
       const c10::optional<Scalar> output_max);
 };
+
+class TransposeConv2dOpContext : public torch::jit::CustomClassHolder {
+ protected:
+  Tensor orig_weight_;
+  c10::optional<Tensor> orig_bias_;
+  std::vector<int64_t> stride_;
+  std::vector<int64_t> padding_;
+  std::vector<int64_t> output_padding_;
+  std::vector<int64_t> dilation_;
+  int64_t groups_;
+  c10::optional<Scalar> output_min_;
+  c10::optional<Scalar> output_max_;
+
+ public:
+  SerializationTypeTransposeConv2dPrePack unpack() {
+    return std::make_tuple(
+        orig_weight_,
+        orig_bias_,
+        stride_,
+        padding_,
+        output_padding_,
+        dilation_,
+        groups_,
+        output_min_,
+        output_max_);
+  }
+
+  virtual Tensor run(const Tensor& input) = 0;
+};
+
+class XNNPackTransposeConv2dOpContext final : public TransposeConv2dOpContext {
+ private:
+  ContextConv2D op_context_;
+
+ public:
+  XNNPackTransposeConv2dOpContext(
+      Tensor&& weight,
+      c10::optional<Tensor>&& bias,
+      std::vector<int64_t>&& padding,
+      std::vector<int64_t>&& output_padding,
+      std::vector<int64_t>&& stride,
+      std::vector<int64_t>&& dilation,
+      uint64_t groups,
+      c10::optional<Scalar> min,
+      c10::optional<Scalar> max,
+      ContextConv2D&& op_context)
+      : op_context_(std::move(op_context)) {
+    orig_weight_ = std::move(weight);
+    orig_bias_ = std::move(bias);
+    padding_ = std::move(padding);
+    output_padding_ = std::move(output_padding);
+    stride_ = std::move(stride);
+    dilation_ = std::move(dilation);
+    groups_ = groups;
+    output_min_ = min;
+    output_max_ = max;
+  }
+
+  Tensor run(const Tensor& input);
+
+  static c10::intrusive_ptr<TransposeConv2dOpContext> create_context(
+      Tensor&& weight,
+      c10::optional<Tensor>&& bias,
+      std::vector<int64_t>&& padding,
+      std::vector<int64_t>&& output_padding,
+      std::vector<int64_t>&& stride,
+      std::vector<int64_t>&& dilation,
+      int64_t groups,
+      const c10::optional<Scalar> output_min,
+      const c10::optional<Scalar> output_max);
+};
 } // namespace xnnpack
 
 } // namespace native
@@ -35,7 +35,9 @@ bool use_convolution2d(
     const IntArrayRef,
     const IntArrayRef,
     const IntArrayRef,
-    const int64_t) {
+    const int64_t,
+    const float,
+    const float) {
   return false;
 }
 
@@ -46,21 +48,27 @@ Tensor convolution2d(
     const IntArrayRef,
     const IntArrayRef,
     const IntArrayRef,
-    const int64_t) {
+    const int64_t,
+    const float,
+    const float) {
   TORCH_CHECK(false, internal::kError);
 }
 
 bool use_linear(
     const Tensor&,
     const Tensor&,
-    const Tensor&) {
+    const Tensor&,
+    const float,
+    const float) {
   return false;
 }
 
 Tensor linear(
     const Tensor&,
     const Tensor&,
-    const Tensor&) {
+    const Tensor&,
+    const float,
+    const float) {
   TORCH_CHECK(false, internal::kError);
 }
 
@@ -88,6 +96,46 @@ Tensor max_pool2d(
   TORCH_CHECK(false, internal::kError);
 }
 
+bool use_global_average_pool(const Tensor&) {
+  return false;
+}
+
+Tensor global_average_pool(const Tensor&) {
+  TORCH_CHECK(false, internal::kError);
+}
+
+bool use_channel_shuffle(const Tensor&, const int64_t) {
+  return false;
+}
+
+Tensor channel_shuffle(const Tensor&, const int64_t) {
+  TORCH_CHECK(false, internal::kError);
+}
+
+bool use_add(const Tensor&, const Tensor&) {
+  return false;
+}
+
+Tensor add(const Tensor&, const Tensor&) {
+  TORCH_CHECK(false, internal::kError);
+}
+
+bool use_clamp(const Tensor&, const float, const float) {
+  return false;
+}
+
+Tensor clamp(const Tensor&, const float, const float) {
+  TORCH_CHECK(false, internal::kError);
+}
+
+bool use_hardswish(const Tensor&) {
+  return false;
+}
+
+Tensor hardswish(const Tensor&) {
+  TORCH_CHECK(false, internal::kError);
+}
+
 } // namespace xnnpack
 
 } // namespace native
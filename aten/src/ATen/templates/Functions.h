@@ -92,4 +92,14 @@ inline int64_t numel(const Tensor& tensor) {
 // invoke the actual dynamic dispatch on the correct argument
 ${function_definitions}
 
+// at::redispatch functions take the keys to dispatch on as first argument,
+// instead of computing them from the arguments and the TLS, see
+// Dispatcher::callUnboxedWithKeySet.  For kernels calling other operators
+// when the keys of the call are known, e.g. backend kernels past autograd.
+namespace redispatch {
+
+${redispatch_function_definitions}
+
+} // namespace redispatch
+
 }
@@ -316,6 +316,12 @@ class CAFFE2_API Tensor {
   /// Returns if a `Tensor` is mkldnn tensor.
   bool is_mkldnn() const;
 
+  /// Returns if a `Tensor` has sparse CSR layout.
+  bool is_sparse_csr() const;
+
+  /// Returns if a `Tensor` has nested layout.
+  bool is_nested() const;
+
   /// Returns if a `Tensor` has quantized backend.
   bool is_quantized() const;
 
@@ -338,6 +344,13 @@ class CAFFE2_API Tensor {
     return this->unsafeGetTensorImpl()->data();
   }
 
+  /// Like data_ptr(), but the data must only be read through the returned
+  /// pointer; a tensor sharing its data copy-on-write with other tensors
+  /// (see at::Context::setCopyOnWrite) doesn't copy it.
+  const void* const_data_ptr() const {
+    return this->unsafeGetTensorImpl()->const_data();
+  }
+
   template <typename T>
   T * data_ptr() const;
 
@@ -130,6 +130,24 @@ inline bool is_mkldnn(Tensor self) {
   return self.is_mkldnn();
 }
 
+inline bool Tensor::is_sparse_csr() const {
+  // NB: this is not a native function to avoid dispatching overhead.
+  return impl_->is_sparse_csr();
+}
+
+inline bool is_sparse_csr(Tensor self) {
+  return self.is_sparse_csr();
+}
+
+inline bool Tensor::is_nested() const {
+  // NB: this is not a native function to avoid dispatching overhead.
+  return impl_->is_nested();
+}
+
+inline bool is_nested(Tensor self) {
+  return self.is_nested();
+}
+
 inline bool Tensor::is_quantized() const {
   // NB: this is not a native function to avoid dispatching overhead.
   return impl_->is_quantized();
@@ -3,6 +3,7 @@
 #include <ATen/ATen.h>
 #include <ATen/Utils.h>
 #include <ATen/CPUGeneratorImpl.h>
+#include <ATen/Parallel.h>
 #include <ATen/core/PhiloxRNGEngine.h>
 #include <thread>
 #include <limits>
@@ -200,6 +201,105 @@ TEST(CPUGeneratorImpl, TestPhiloxEngineIndex) {
   ASSERT_NE(engine1(), engine2());
 }
 
+TEST(CPUGeneratorImpl, TestPhiloxModeOffset) {
+  // Test Description:
+  //   Tests that a fill in Philox mode advances the philox offset
+  //   by the number of 128 bit numbers it reads, and that reseeding
+  //   and cloning keep the offset consistent.
+  auto gen = at::detail::createCPUGenerator(123);
+  auto cpu_gen = check_generator<CPUGeneratorImpl>(gen);
+  cpu_gen->set_philox_enabled(true);
+  ASSERT_EQ(cpu_gen->philox_offset(), 0);
+  at::empty({10}, at::kFloat).uniform_(0, 1, gen);
+  ASSERT_EQ(cpu_gen->philox_offset(), 3);
+  at::empty({10}, at::kDouble).uniform_(0, 1, gen);
+  ASSERT_EQ(cpu_gen->philox_offset(), 8);
+  auto gen2 = gen.clone();
+  auto cpu_gen2 = check_generator<CPUGeneratorImpl>(gen2);
+  ASSERT_TRUE(cpu_gen2->philox_enabled());
+  ASSERT_EQ(cpu_gen2->philox_offset(), 8);
+  ASSERT_TRUE(at::empty({100}).uniform_(0, 1, gen).equal(
+      at::empty({100}).uniform_(0, 1, gen2)));
+  gen.set_current_seed(123);
+  ASSERT_EQ(cpu_gen->philox_offset(), 0);
+}
+
+TEST(CPUGeneratorImpl, TestPhiloxModeThreadCount) {
+  // Test Description:
+  //   Tests that fills in Philox mode give the same values
+  //   regardless of the number of threads, for contiguous
+  //   and non-contiguous tensors.
+  // See Note [Counter-based CPU random fills]
+  auto fill = [](int num_threads, at::ScalarType dtype) {
+    at::set_num_threads(num_threads);
+    auto gen = at::detail::createCPUGenerator(42);
+    check_generator<CPUGeneratorImpl>(gen)->set_philox_enabled(true);
+    auto uniform = at::empty({1000, 100}, dtype).uniform_(-1, 1, gen);
+    auto normal = at::empty({1000, 101}, dtype).normal_(2, 3, gen);
+    auto strided = at::empty({100, 1000}, dtype).t().normal_(0, 1, gen);
+    return std::make_tuple(uniform, normal, strided);
+  };
+  for (auto dtype : {at::kFloat, at::kDouble}) {
+    auto expected = fill(1, dtype);
+    auto actual = fill(4, dtype);
+    ASSERT_TRUE(std::get<0>(expected).equal(std::get<0>(actual)));
+    ASSERT_TRUE(std::get<1>(expected).equal(std::get<1>(actual)));
+    ASSERT_TRUE(std::get<2>(expected).equal(std::get<2>(actual)));
+    auto uniform = std::get<0>(actual);
+    ASSERT_GE(uniform.min().item<double>(), -1);
+    ASSERT_LT(uniform.max().item<double>(), 1);
+    ASSERT_NEAR(std::get<1>(actual).mean().item<double>(), 2, 0.1);
+    ASSERT_NEAR(std::get<1>(actual).std().item<double>(), 3, 0.1);
+  }
+}
+
+TEST(CPUGeneratorImpl, TestPhiloxModeAliasDraw) {
+  // Test Description:
+  //   Tests that alias draws in Philox mode give the same samples
+  //   regardless of the number of threads, and that they follow
+  //   the distribution of the alias tables.
+  auto probs = at::tensor({0.5, 0.25, 0.125, 0.125, 0.0}, at::kDouble);
+  auto tables = at::_multinomial_alias_setup(probs);
+  auto draw = [&](int num_threads) {
+    at::set_num_threads(num_threads);
+    auto gen = at::detail::createCPUGenerator(42);
+    check_generator<CPUGeneratorImpl>(gen)->set_philox_enabled(true);
+    return at::_multinomial_alias_draw(
+        std::get<1>(tables), std::get<0>(tables), 200000, gen);
+  };
+  auto expected = draw(1);
+  auto actual = draw(4);
+  ASSERT_TRUE(expected.equal(actual));
+  auto freqs = at::bincount(actual, {}, 5).to(at::kDouble) / 200000;
+  ASSERT_TRUE(freqs.allclose(probs, 0, 0.01));
+}
+
+TEST(CPUGeneratorImpl, TestDropoutReplaysGeneratorState) {
+  // Test Description:
+  //   Tests that dropout outside of the Philox mode draws its mask from
+  //   the mt19937 engine with and without grad mode, so that restoring
+  //   the state of the generator replays it, as checkpointing does.
+  auto gen = at::detail::getDefaultCPUGenerator();
+  auto cpu_gen = check_generator<CPUGeneratorImpl>(gen);
+  auto input = at::ones({20000}, at::kFloat).requires_grad_();
+  at::mt19937 engine;
+  {
+    std::lock_guard<std::mutex> lock(gen.mutex());
+    engine = cpu_gen->engine();
+  }
+  at::Tensor expected;
+  {
+    at::NoGradGuard no_grad;
+    expected = at::dropout(input, 0.5, /*train=*/true);
+  }
+  {
+    std::lock_guard<std::mutex> lock(gen.mutex());
+    cpu_gen->set_engine(engine);
+  }
+  auto actual = at::dropout(input, 0.5, /*train=*/true);
+  ASSERT_TRUE(expected.equal(actual.detach()));
+}
+
 /**
  * MT19937 CPU Engine Tests
  */
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include <ATen/ATen.h>
+#include <ATen/DeferredMode.h>
+
+using namespace at;
+
+namespace {
+
+struct DeferredGuard {
+  DeferredGuard() {
+    deferred::set_enabled(true);
+  }
+  ~DeferredGuard() {
+    deferred::set_enabled(false);
+  }
+};
+
+} // namespace
+
+TEST(DeferredTest, PointwiseChain) {
+  auto a = randn({100, 37});
+  auto b = randn({100, 37});
+  auto c = randn({37});
+  auto expected = (a * b + c).sigmoid() - a.exp() / 2;
+
+  Tensor result;
+  {
+    DeferredGuard guard;
+    result = (a * b + c).sigmoid() - a.exp() / 2;
+  }
+  ASSERT_TRUE(result.allclose(expected));
+}
+
+TEST(DeferredTest, OtherOpsFlush) {
+  auto a = randn({1000});
+  auto expected = (a * 3 + 1).tanh().sum();
+
+  DeferredGuard guard;
+  auto result = (a * 3 + 1).tanh().sum();
+  ASSERT_TRUE(result.allclose(expected));
+}
+
+TEST(DeferredTest, ExplicitFlush) {
+  auto a = randn({64});
+  auto expected = -(a + a);
+
+  DeferredGuard guard;
+  auto result = -(a + a);
+  deferred::flush();
+  float* data = result.data_ptr<float>();
+  float* expected_data = expected.data_ptr<float>();
+  for (int64_t i = 0; i < result.numel(); ++i) {
+    ASSERT_FLOAT_EQ(data[i], expected_data[i]);
+  }
+}
+
+TEST(DeferredTest, InplaceAndViews) {
+  auto a = randn({8, 8});
+  auto doubled = a * 2;
+  auto expected = doubled.t().clone();
+  expected.add_(1);
+
+  DeferredGuard guard;
+  auto t = (a * 2).t();
+  t.add_(1);
+  ASSERT_TRUE(t.allclose(expected));
+
+  // an in-place op on an input of a pending op runs after it
+  auto b = a.clone();
+  auto c = b * 2;
+  b.mul_(0);
+  ASSERT_TRUE(c.allclose(doubled));
+}
+
+TEST(DeferredTest, UnsupportedInputsRunEagerly) {
+  auto a = randint(10, {16}, kLong);
+  auto b = randn({4, 4}).t();
+
+  DeferredGuard guard;
+  ASSERT_TRUE((a * a).equal(a.pow(2)));
+  ASSERT_TRUE((b + b).allclose(b * 2));
+}
@@ -226,3 +226,20 @@ TEST(TensorIteratorTest, FailNonPromotingBinaryOp) {
   iter.add_input(at::ones({1,1}, at::dtype(at::kInt)));
   ASSERT_ANY_THROW(iter.build());
 }
+
+TEST(TensorIteratorTest, CachedPlanMatchesFreshPlan) {
+  // broadcast and transposed operands take the slow setup path, whose result
+  // is cached and reused by the second iterator
+  auto a = at::randn({3, 5, 7}).transpose(0, 2);
+  auto b = at::randn({1, 5, 1});
+  Tensor out1, out2;
+  auto iter1 = TensorIterator::binary_op(out1, a, b);
+  auto iter2 = TensorIterator::binary_op(out2, a, b);
+  ASSERT_EQ(iter1.shape(), iter2.shape());
+  for (int i = 0; i < iter1.ntensors(); i++) {
+    ASSERT_EQ(iter1.strides(i), iter2.strides(i));
+  }
+  ASSERT_EQ(iter1.output().sizes(), iter2.output().sizes());
+  ASSERT_EQ(iter1.output().strides(), iter2.output().strides());
+  ASSERT_NE(iter1.output().data_ptr(), iter2.output().data_ptr());
+}
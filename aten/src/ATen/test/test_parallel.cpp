@@ -4,9 +4,12 @@
 #include <ATen/DLConvertor.h>
 #include <ATen/Parallel.h>
 
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <string.h>
 #include <sstream>
+#include <thread>
 
 using namespace at;
 
@@ -52,6 +55,22 @@ TEST(TestParallel, Exceptions) {
     std::runtime_error);
 }
 
+TEST(TestParallel, UnevenWork) {
+  // every index must be visited exactly once, whatever the scheduling
+  std::vector<std::atomic<int>> visits(1000);
+  at::parallel_for(0, 1000, 1, [&](int64_t begin, int64_t end) {
+    for (auto i = begin; i < end; ++i) {
+      if (i < 100) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+      }
+      visits[i]++;
+    }
+  });
+  for (auto& v : visits) {
+    ASSERT_EQ(v.load(), 1);
+  }
+}
+
 TEST(TestParallel, IntraOpLaunchFuture) {
   int v1 = 0;
   int v2 = 0;
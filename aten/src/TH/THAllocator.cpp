@@ -18,6 +18,11 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <unistd.h>
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+#include <sys/vfs.h>
+#include <linux/magic.h>
+#define TH_MAP_HUGE_PAGES 1
+#endif
 #endif
 /* end of stuff for mapped files */
 
@@ -55,7 +60,7 @@ THMapAllocator::THMapAllocator(WithFd, const char *filename, int fd, int flags,
   if (!(flags & TH_ALLOCATOR_MAPPED_SHARED) && !(flags & TH_ALLOCATOR_MAPPED_SHAREDMEM)) {
     flags &= ~TH_ALLOCATOR_MAPPED_NOCREATE;
   }
-  if ((flags ^ TH_ALLOCATOR_MAPPED_EXCLUSIVE) == 0) {
+  if (((flags & ~TH_ALLOCATOR_MAPPED_HUGEPAGE) ^ TH_ALLOCATOR_MAPPED_EXCLUSIVE) == 0) {
     AT_ERROR("TH_ALLOCATOR_MAPPED_EXCLUSIVE flag requires opening the file in shared mode");
   }
 #ifdef _WIN32
@@ -249,10 +254,27 @@ THMapAllocator::THMapAllocator(WithFd, const char *filename, int fd, int flags,
       AT_ERROR("unable to stat the file <", filename_, ">");
     }
 
+#ifdef TH_MAP_HUGE_PAGES
+    if (flags_ & TH_ALLOCATOR_MAPPED_HUGEPAGE) {
+      struct statfs fs_stat;
+      if (fstatfs(fd, &fs_stat) == 0 && fs_stat.f_type == HUGETLBFS_MAGIC) {
+        hugetlb_page_size_ = fs_stat.f_bsize;
+      }
+    }
+#endif
+    // hugetlbfs files can only be resized to whole huge pages
+    auto stretched_size = [&](ptrdiff_t size) -> ptrdiff_t {
+      if (hugetlb_page_size_ == 0) {
+        return size;
+      }
+      const ptrdiff_t page = hugetlb_page_size_;
+      return (size + page - 1) / page * page;
+    };
+
     if (size > 0) {
       if (size > file_stat.st_size) {
-        if (flags_) {
-          if (ftruncate(fd, size) == -1) {
+        if (flags_ & ~TH_ALLOCATOR_MAPPED_HUGEPAGE) {
+          if (ftruncate(fd, stretched_size(size)) == -1) {
             AT_ERROR("unable to resize file <", filename_, "> to the right size");
           }
           if (fstat(fd, &file_stat) == -1 || file_stat.st_size < size) {
@@ -281,15 +303,27 @@ THMapAllocator::THMapAllocator(WithFd, const char *filename, int fd, int flags,
 
     /* map it */
     if (flags_ & (TH_ALLOCATOR_MAPPED_SHARED | TH_ALLOCATOR_MAPPED_SHAREDMEM)) {
-      base_ptr_ = mmap(nullptr, size_, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+      base_ptr_ = mmap(nullptr, stretched_size(size_), PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
     } else {
-      base_ptr_ = mmap(nullptr, size_, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0);
+      base_ptr_ = mmap(nullptr, stretched_size(size_), PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0);
     }
 
     if (base_ptr_ == MAP_FAILED) {
       base_ptr_ = nullptr; /* let's be sure it is NULL */
     }
 
+#ifdef TH_MAP_HUGE_PAGES
+    if (base_ptr_ && (flags_ & TH_ALLOCATOR_MAPPED_HUGEPAGE)) {
+      const bool hugetlb = hugetlb_page_size_ != 0;
+      // The kernel may not back the advised mapping with huge pages, which is
+      // only known from its smaps
+      huge_page_backed_ = hugetlb || madvise(base_ptr_, size_, MADV_HUGEPAGE) == 0;
+      if (huge_page_backed_) {
+        c10::reportHugePageAllocation(stretched_size(size_), hugetlb);
+      }
+    }
+#endif
+
     if (flags_ & TH_ALLOCATOR_MAPPED_KEEPFD) {
       fd_ = fd;
     } else {
@@ -367,9 +401,7 @@ void THMapAllocator::close() {
     }
   }
 
-  if (munmap(base_ptr_, size_)) {
-    AT_ERROR("could not unmap the shared memory file");
-  }
+  unmap();
 
   if (!(flags_ & (TH_ALLOCATOR_MAPPED_FROMFD | TH_ALLOCATOR_MAPPED_UNLINK))) {
     if (flags_ & TH_ALLOCATOR_MAPPED_SHAREDMEM) {
@@ -385,6 +417,22 @@ void THMapAllocator::close() {
 #endif /* _WIN32 */
 }
 
+#ifndef _WIN32
+void THMapAllocator::unmap() {
+  size_t mapped_size = size_;
+  if (hugetlb_page_size_ != 0) {
+    mapped_size = (mapped_size + hugetlb_page_size_ - 1) / hugetlb_page_size_ * hugetlb_page_size_;
+  }
+  if (huge_page_backed_) {
+    c10::reportHugePageFree(mapped_size, hugetlb_page_size_ != 0);
+    huge_page_backed_ = false;
+  }
+  if (munmap(base_ptr_, mapped_size)) {
+    AT_ERROR("could not unmap the shared memory file ", filename_);
+  }
+}
+#endif /* _WIN32 */
+
 #else /* defined(_WIN32) || defined(HAVE_MMAP) */
 
 THMapAllocator::THMapAllocator(const char *filename, int flags, size_t size) {
@@ -478,9 +526,7 @@ void THRefcountedMapAllocator::close() {
     AT_ERROR("could not unlink the shared memory file ", filename_, ", shm_unlink not available on platform");
 #endif /* HAVE_SHM_UNLINK */
   }
-  if (munmap(info, size_)) {
-    AT_ERROR("could not unmap the shared memory file ", filename_);
-  }
+  unmap();
 #endif /* _WIN32 */
 }
 
@@ -11,6 +11,10 @@
 #define TH_ALLOCATOR_MAPPED_KEEPFD 16
 #define TH_ALLOCATOR_MAPPED_FROMFD 32
 #define TH_ALLOCATOR_MAPPED_UNLINK 64
+// Back the mapping with huge pages: files of hugetlbfs are mapped in whole huge
+// pages, other mappings are advised with MADV_HUGEPAGE (shared memory getting
+// transparent huge pages with shmem_enabled=advise). See c10::getHugePageStats.
+#define TH_ALLOCATOR_MAPPED_HUGEPAGE 128
 
 /* default malloc/free allocator. malloc and realloc raise an error (using
  * THError) on allocation failure.
@@ -56,10 +60,17 @@ class CAFFE2_API THMapAllocator {
   virtual ~THMapAllocator() { close(); }
 
 protected:
+  // Unmaps base_ptr_, in whole huge pages for hugetlbfs
+  void unmap();
+
   bool closed_ = false;
   std::string filename_;
   int flags_ = 0;
   ptrdiff_t size_; /* mapped size */
+  // With TH_ALLOCATOR_MAPPED_HUGEPAGE, the huge page size of hugetlbfs files
+  // (0 for other files), and whether the mapping is counted in the stats
+  size_t hugetlb_page_size_ = 0;
+  bool huge_page_backed_ = false;
 #ifdef _WIN32
   void* handle_;
   void* event_;
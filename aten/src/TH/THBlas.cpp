@@ -1,5 +1,7 @@
 #include <TH/THBlas.h>
 
+#include <vector>
+
 #include <TH/generic/THBlas.cpp>
 #include <TH/THGenerateAllTypes.h>
 
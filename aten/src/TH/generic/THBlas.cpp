@@ -273,6 +273,56 @@ void THBlas_(gemm)(
   }
 #endif
 
+#if defined(USE_BLAS) && defined(TH_REAL_IS_BFLOAT16)
+  // There is no bfloat16 BLAS, so the matrices are converted to float and
+  // multiplied with sgemm, which accumulates in float instead of rounding every
+  // partial sum to bfloat16 like the loops below.
+  if( (m <= INT_MAX) && (n <= INT_MAX) && (k <= INT_MAX) )
+  {
+    const int64_t a_rows = transa_ ? k : m;
+    const int64_t a_cols = transa_ ? m : k;
+    const int64_t b_rows = transb_ ? n : k;
+    const int64_t b_cols = transb_ ? k : n;
+    std::vector<float> a_float(a_rows * a_cols);
+    std::vector<float> b_float(b_rows * b_cols);
+    std::vector<float> c_float(m * n);
+    for (int64_t j = 0; j < a_cols; j++) {
+      for (int64_t i = 0; i < a_rows; i++) {
+        a_float[j * a_rows + i] = a[j * lda + i];
+      }
+    }
+    for (int64_t j = 0; j < b_cols; j++) {
+      for (int64_t i = 0; i < b_rows; i++) {
+        b_float[j * b_rows + i] = b[j * ldb + i];
+      }
+    }
+    if (beta != 0) {
+      for (int64_t j = 0; j < n; j++) {
+        for (int64_t i = 0; i < m; i++) {
+          c_float[j * m + i] = c[j * ldc + i];
+        }
+      }
+    }
+
+    int i_m = (int)m;
+    int i_n = (int)n;
+    int i_k = (int)k;
+    int i_lda = (int)THMax(1, a_rows);
+    int i_ldb = (int)THMax(1, b_rows);
+    int i_ldc = (int)THMax(1, m);
+    float alpha_float = alpha;
+    float beta_float = beta;
+    sgemm_(&transa, &transb, &i_m, &i_n, &i_k, &alpha_float, a_float.data(), &i_lda, b_float.data(), &i_ldb, &beta_float, c_float.data(), &i_ldc);
+
+    for (int64_t j = 0; j < n; j++) {
+      for (int64_t i = 0; i < m; i++) {
+        c[j * ldc + i] = c_float[j * m + i];
+      }
+    }
+    return;
+  }
+#endif
+
 #if defined(USE_FBGEMM) && defined(TH_REAL_IS_LONG)
   if (alpha == 1 && (beta == 0 || beta == 1)) {
     // In FBGEMM, we assume row-major ordering; However, here we assume the
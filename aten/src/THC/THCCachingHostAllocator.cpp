@@ -1,20 +1,68 @@
 #include <THC/THCCachingHostAllocator.h>
 #include <ATen/DeviceGuard.h>
 #include <ATen/detail/CUDAHooksInterface.h>
+#include <c10/util/numa.h>
 
 
 #include <cuda_runtime_api.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
 #include <deque>
+#include <fstream>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <stdint.h>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <set>
 #include <utility>
+#include <vector>
 
 namespace {
 
+constexpr size_t kMinBlockSize = 512;        // all sizes are rounded to at least 512 bytes
+constexpr size_t kSmallSize = 1048576;       // largest "small" allocation is 1 MiB
+constexpr size_t kMinSlabSize = 2097152;     // slabs of small blocks are 2 MiB...
+constexpr size_t kMaxSlabSize = 16777216;    // ... to 16 MiB
+constexpr size_t kSlabBlocks = 32;           // blocks per slab, within those bounds
+
+// Four size classes per power of two: the rounding wastes at most a quarter
+// of the block.
+size_t roundSize(size_t size) {
+  if (size <= kMinBlockSize) {
+    return kMinBlockSize;
+  }
+  size_t pow2 = 1;
+  while (pow2 <= (size - 1) / 2) {
+    pow2 *= 2;
+  }
+  const size_t step = pow2 / 4;
+  return (size + step - 1) / step * step;
+}
+
+// Page-locked host memory shared by the blocks of a size class, allocated on
+// a NUMA node and registered with a single cudaHostRegister call.
+struct Slab
+{
+  void*   ptr;
+  size_t  size;
+  size_t  block_size;
+  int     numa_node;
+  size_t  carved;   // number of blocks carved out of the slab so far
+  size_t  in_use;   // carved blocks that are not available for re-use
+
+  Slab(void* ptr, size_t size, size_t block_size, int numa_node) :
+      ptr(ptr), size(size), block_size(block_size), numa_node(numa_node),
+      carved(0), in_use(0) {}
+
+  bool full() const {
+    return (carved + 1) * block_size > size;
+  }
+};
+
 struct BlockSize
 {
   size_t  size; // allocation size
@@ -27,10 +75,13 @@ struct Block : public BlockSize
 {
   bool  allocated;    // true if the block is currently allocated
   int   event_count;  // number of outstanding cuda events
+  size_t requested;   // size requested by the current allocation
+  Slab* slab;         // slab the block was carved from
   std::unordered_set<at::cuda::CUDAStream> streams;
 
-  Block(size_t size, void* ptr, bool allocated) :
-      BlockSize(size, ptr), allocated(allocated), event_count(0), streams() {}
+  Block(size_t size, void* ptr, bool allocated, Slab* slab) :
+      BlockSize(size, ptr), allocated(allocated), event_count(0),
+      requested(0), slab(slab), streams() {}
 };
 
 static bool BlockComparator(const BlockSize& a, const BlockSize& b)
@@ -42,6 +93,43 @@ static bool BlockComparator(const BlockSize& a, const BlockSize& b)
   return (uintptr_t)a.ptr < (uintptr_t)b.ptr;
 }
 
+size_t memoryLimitFromEnv() {
+  const char* env = std::getenv("PYTORCH_CUDA_HOST_MEMORY_LIMIT_MB");
+  if (env == nullptr) {
+    return 0;
+  }
+  char* end = nullptr;
+  const unsigned long long limit_mb = std::strtoull(env, &end, 10);
+  if (end == env || *end != '\0') {
+    TORCH_WARN("Ignoring invalid PYTORCH_CUDA_HOST_MEMORY_LIMIT_MB value: ", env);
+    return 0;
+  }
+  return limit_mb * 1048576;
+}
+
+// The NUMA node closest to a GPU, or -1 if unknown
+int deviceNUMANode(int device) {
+#ifdef __linux__
+  char bus_id[32];
+  if (cudaDeviceGetPCIBusId(bus_id, sizeof(bus_id), device) != cudaSuccess) {
+    cudaGetLastError(); // clear the error
+    return -1;
+  }
+  std::string path = "/sys/bus/pci/devices/";
+  for (const char* c = bus_id; *c; ++c) {
+    path += static_cast<char>(std::tolower(*c));
+  }
+  std::ifstream file(path + "/numa_node");
+  int node = -1;
+  if (!(file >> node)) {
+    return -1;
+  }
+  return node;
+#else
+  return -1;
+#endif
+}
+
 struct HostAllocator
 {
   typedef bool (*Comparison)(const BlockSize&, const BlockSize&);
@@ -52,13 +140,69 @@ struct HostAllocator
   // blocks by pointer
   std::unordered_map<void*, Block> blocks;
 
-  // pointers that are ready to be allocated (event_count=0)
-  std::set<BlockSize, Comparison> available;
+  // pointers that are ready to be allocated (event_count=0), by NUMA node
+  std::map<int, std::set<BlockSize, Comparison>> available;
+
+  // slabs with room for more blocks, by NUMA node and block size
+  std::map<std::pair<int, size_t>, std::vector<Slab*>> partial_slabs;
+
+  // all the slabs
+  std::unordered_map<void*, std::unique_ptr<Slab>> slabs;
 
   // outstanding cuda events
   std::deque<std::pair<cudaEvent_t, void*>> cuda_events;
 
-  HostAllocator() : available(BlockComparator) {}
+  // NUMA node of every device, queried on first use
+  std::vector<int> device_numa_nodes;
+
+  size_t limit;
+  THCCachingHostAllocatorStats stats;
+
+  HostAllocator() : limit(memoryLimitFromEnv()) {}
+
+  std::set<BlockSize, Comparison>& availableOnNode(int numa_node) {
+    auto it = available.find(numa_node);
+    if (it == available.end()) {
+      it = available.emplace(numa_node, std::set<BlockSize, Comparison>(BlockComparator)).first;
+    }
+    return it->second;
+  }
+
+  int currentNUMANode(int device) {
+    if (!c10::IsNUMAEnabled()) {
+      return -1;
+    }
+    if (device_numa_nodes.empty()) {
+      int count = 0;
+      if (cudaGetDeviceCount(&count) != cudaSuccess) {
+        cudaGetLastError();
+        count = 0;
+      }
+      device_numa_nodes.assign(count, -2);
+    }
+    if (device < 0 || device >= (int)device_numa_nodes.size()) {
+      return -1;
+    }
+    if (device_numa_nodes[device] == -2) {
+      device_numa_nodes[device] = deviceNUMANode(device);
+    }
+    return device_numa_nodes[device];
+  }
+
+  void makeAvailable(Block& block) {
+    availableOnNode(block.slab->numa_node).insert(block);
+    block.slab->in_use--;
+  }
+
+  void takeAvailable(Block& block) {
+    block.slab->in_use++;
+  }
+
+  void updateAllocatedStats(int64_t allocated, int64_t requested) {
+    stats.allocated_bytes += allocated;
+    stats.requested_bytes += requested;
+    stats.peak_allocated_bytes = std::max(stats.peak_allocated_bytes, stats.allocated_bytes);
+  }
 
   cudaError_t malloc(void** ptr, size_t size)
   {
@@ -70,18 +214,6 @@ struct HostAllocator
       return err;
     }
 
-    // search for the smallest block which can hold this allocation
-    BlockSize search_key(size);
-    auto it = available.lower_bound(search_key);
-    if (it != available.end()) {
-      Block& block = blocks.at(it->ptr);
-      THAssert(!block.allocated && block.event_count == 0);
-      block.allocated = true;
-      *ptr = block.ptr;
-      available.erase(it);
-      return cudaSuccess;
-    }
-
     // Pinned memory pointers allocated by any device can be directly used by any
     // other device, regardless of the current device at the time of allocation,
     // since we assume unified addressing.
@@ -92,20 +224,165 @@ struct HostAllocator
     if (primary_ctx_device_index.has_value()) {
       device_guard.reset_device(at::Device(at::DeviceType::CUDA, *primary_ctx_device_index));
     }
+    int device = -1;
+    if (cudaGetDevice(&device) != cudaSuccess) {
+      cudaGetLastError();
+      device = -1;
+    }
+    const int numa_node = currentNUMANode(device);
+
+    const size_t block_size = roundSize(size);
+    stats.num_allocs++;
+
+    // search for a free block of the size class
+    auto& pool = availableOnNode(numa_node);
+    BlockSize search_key(block_size);
+    auto it = pool.lower_bound(search_key);
+    if (it != pool.end() && it->size == block_size) {
+      Block& block = blocks.at(it->ptr);
+      THAssert(!block.allocated && block.event_count == 0);
+      block.allocated = true;
+      block.requested = size;
+      *ptr = block.ptr;
+      pool.erase(it);
+      takeAvailable(block);
+      updateAllocatedStats(block.size, size);
+      stats.num_cache_hits++;
+      return cudaSuccess;
+    }
 
-    // note that cudaHostAlloc may not touch pointer if size is 0
-    *ptr = 0;
+    // carve a new block out of a slab of the size class, registering a new
+    // slab if needed
+    Slab* slab = nullptr;
+    auto& partial = partial_slabs[{numa_node, block_size}];
+    if (!partial.empty()) {
+      slab = partial.back();
+    } else {
+      const size_t slab_size = block_size > kSmallSize ? block_size :
+        std::min(std::max(block_size * kSlabBlocks, kMinSlabSize), kMaxSlabSize);
+      err = allocateSlab(&slab, slab_size, block_size, numa_node);
+      if (err != cudaSuccess) {
+        return err;
+      }
+      partial.push_back(slab);
+    }
 
-    // allocate a new block if no cached allocation is found
-    err = cudaHostAlloc(ptr, size, cudaHostAllocDefault);
+    void* block_ptr = static_cast<char*>(slab->ptr) + slab->carved * block_size;
+    slab->carved++;
+    slab->in_use++;
+    if (slab->full()) {
+      partial.erase(std::find(partial.begin(), partial.end(), slab));
+    }
+
+    Block& block = blocks.emplace(block_ptr, Block(block_size, block_ptr, true, slab)).first->second;
+    block.requested = size;
+    *ptr = block_ptr;
+    updateAllocatedStats(block.size, size);
+    return cudaSuccess;
+  }
+
+  cudaError_t allocateSlab(Slab** slab, size_t size, size_t block_size, int numa_node)
+  {
+    if (limit > 0 && stats.reserved_bytes + size > limit) {
+      // release the unused slabs, then the ones only waiting for their
+      // cuda events
+      releaseSlabs(stats.reserved_bytes + size - limit);
+      if (stats.reserved_bytes + size > limit && !cuda_events.empty()) {
+        cudaError_t err = synchronizeEvents();
+        if (err != cudaSuccess) {
+          return err;
+        }
+        releaseSlabs(stats.reserved_bytes + size - limit);
+      }
+      TORCH_CHECK(stats.reserved_bytes + size <= limit,
+        "CUDA host memory limit of ", limit, " bytes reached: tried to allocate ",
+        size, " more bytes with ", stats.allocated_bytes, " bytes in use");
+    }
+
+    void* ptr = nullptr;
+#ifdef _WIN32
+    ptr = _aligned_malloc(size, 4096);
+#else
+    if (posix_memalign(&ptr, 4096, size) != 0) {
+      ptr = nullptr;
+    }
+#endif
+    if (ptr == nullptr) {
+      return cudaErrorMemoryAllocation;
+    }
+    // The pages are not touched yet, so this only sets their placement
+    c10::NUMAMove(ptr, size, numa_node);
+
+    cudaError_t err = cudaHostRegister(ptr, size, cudaHostRegisterDefault);
     if (err != cudaSuccess) {
+      freeHostMemory(ptr);
       return err;
     }
 
-    blocks.insert({*ptr, Block(size, *ptr, true)});
+    auto owned = std::unique_ptr<Slab>(new Slab(ptr, size, block_size, numa_node));
+    *slab = owned.get();
+    slabs.emplace(ptr, std::move(owned));
+    stats.reserved_bytes += size;
+    stats.peak_reserved_bytes = std::max(stats.peak_reserved_bytes, stats.reserved_bytes);
+    stats.num_slab_allocs++;
     return cudaSuccess;
   }
 
+  static void freeHostMemory(void* ptr)
+  {
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    ::free(ptr);
+#endif
+  }
+
+  // Releases slabs without blocks in use, largest first, until `size` bytes
+  // are released (or all of them if `size` is 0)
+  void releaseSlabs(size_t size)
+  {
+    std::vector<Slab*> unused;
+    for (auto& it : slabs) {
+      if (it.second->in_use == 0) {
+        unused.push_back(it.second.get());
+      }
+    }
+    std::sort(unused.begin(), unused.end(), [](Slab* a, Slab* b) {
+      return a->size > b->size;
+    });
+
+    size_t released = 0;
+    for (Slab* slab : unused) {
+      if (size > 0 && released >= size) {
+        break;
+      }
+      released += slab->size;
+      releaseSlab(slab);
+    }
+  }
+
+  void releaseSlab(Slab* slab)
+  {
+    auto& pool = availableOnNode(slab->numa_node);
+    for (size_t i = 0; i < slab->carved; ++i) {
+      void* block_ptr = static_cast<char*>(slab->ptr) + i * slab->block_size;
+      pool.erase(BlockSize(slab->block_size, block_ptr));
+      blocks.erase(block_ptr);
+    }
+    auto& partial = partial_slabs[{slab->numa_node, slab->block_size}];
+    auto it = std::find(partial.begin(), partial.end(), slab);
+    if (it != partial.end()) {
+      partial.erase(it);
+    }
+
+    THCudaCheckWarn(cudaHostUnregister(slab->ptr));
+    freeHostMemory(slab->ptr);
+    stats.reserved_bytes -= slab->size;
+    stats.num_slab_evictions++;
+    void* slab_ptr = slab->ptr;
+    slabs.erase(slab_ptr);
+  }
+
   cudaError_t free(void* ptr)
   {
     std::lock_guard<std::mutex> lock(mutex);
@@ -129,6 +406,8 @@ struct HostAllocator
     // free (on valid memory) shouldn't fail, so mark unallocated before
     // we process the streams.
     block.allocated = false;
+    updateAllocatedStats(-(int64_t)block.size, -(int64_t)block.requested);
+    block.requested = 0;
 
     // insert CUDA events for each stream on which this block was used. This
     err = insertEvents(block);
@@ -138,7 +417,7 @@ struct HostAllocator
 
     if (block.event_count == 0) {
       // the block can be re-used if there are no outstanding cuda events
-      available.insert(block);
+      makeAvailable(block);
     }
     return cudaSuccess;
   }
@@ -185,13 +464,26 @@ struct HostAllocator
       Block& block = blocks.at(e.second);
       block.event_count--;
       if (block.event_count == 0 && !block.allocated) {
-        available.insert(block);
+        makeAvailable(block);
       }
       cuda_events.pop_front();
     }
     return cudaSuccess;
   }
 
+  // Waits for all the outstanding cuda events, making their blocks
+  // available if they are freed
+  cudaError_t synchronizeEvents()
+  {
+    for (auto& e : cuda_events) {
+      cudaError_t err = cudaEventSynchronize(e.first);
+      if (err != cudaSuccess) {
+        return err;
+      }
+    }
+    return processEvents();
+  }
+
   void emptyCache()
   {
     std::lock_guard<std::mutex> lock(mutex);
@@ -203,23 +495,62 @@ struct HostAllocator
       if (!block.allocated) {
         THCudaCheckWarn(cudaEventDestroy(event));
         block.event_count--;
+        if (block.event_count == 0) {
+          makeAvailable(block);
+        }
       }
     }
 
     // all cuda_events have been processed
     cuda_events.clear();
 
-    // clear list of available blocks
-    available.clear();
+    // free the slabs without allocated blocks
+    releaseSlabs(0);
+  }
+
+  THCCachingHostAllocatorStats getStats()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
 
-    // free and erase non-allocated blocks
-    for (auto it = blocks.begin(); it != blocks.end();) {
-      Block& block = it->second;
-      if (!block.allocated) {
-        THCudaCheckWarn(cudaFreeHost(block.ptr));
-        it = blocks.erase(it);
+    THCCachingHostAllocatorStats result = stats;
+    result.limit_bytes = limit;
+    std::map<size_t, THCCachingHostAllocatorSizeClassStats> size_classes;
+    for (const auto& it : blocks) {
+      const Block& block = it.second;
+      auto& size_class = size_classes[block.size];
+      size_class.size = block.size;
+      if (block.allocated) {
+        size_class.allocated++;
       } else {
-        ++it;
+        size_class.cached++;
+      }
+    }
+    for (const auto& it : size_classes) {
+      result.size_classes.push_back(it.second);
+    }
+    return result;
+  }
+
+  void resetStats()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    stats.peak_allocated_bytes = stats.allocated_bytes;
+    stats.peak_reserved_bytes = stats.reserved_bytes;
+    stats.num_allocs = 0;
+    stats.num_cache_hits = 0;
+    stats.num_slab_allocs = 0;
+    stats.num_slab_evictions = 0;
+  }
+
+  void setMemoryLimit(size_t new_limit)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    limit = new_limit;
+    if (limit > 0 && (size_t)stats.reserved_bytes > limit) {
+      if (processEvents() == cudaSuccess) {
+        releaseSlabs(stats.reserved_bytes - limit);
       }
     }
   }
@@ -267,6 +598,21 @@ void THCCachingHostAllocator_emptyCache()
   allocator.emptyCache();
 }
 
+THCCachingHostAllocatorStats THCCachingHostAllocator_getStats()
+{
+  return allocator.getStats();
+}
+
+void THCCachingHostAllocator_resetStats()
+{
+  allocator.resetStats();
+}
+
+void THCCachingHostAllocator_setMemoryLimit(size_t limit)
+{
+  allocator.setMemoryLimit(limit);
+}
+
 static void THCCachingHostDeleter(void* ptr) {
   allocator.free(ptr);
 }
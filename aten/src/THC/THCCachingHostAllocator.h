@@ -6,6 +6,8 @@
 
 #include <c10/cuda/CUDAStream.h>
 
+#include <vector>
+
 //
 // A caching allocator for CUDA host allocations (pinned memory).
 //
@@ -18,8 +20,20 @@
 // call between host and device. We implement this for storages and tensors in
 // copy_from_cpu_async_ and copy_to_cpu_async_.
 //
-// Note that this allocator does not split larger allocations into smaller
-// blocks, unlike the caching device allocator.
+// Allocations are rounded up to size classes, four per power of two, so that
+// at most a quarter of a block is wasted and freed blocks can be re-used by
+// requests of slightly different sizes. Up to 1 MiB, blocks of a class are
+// carved out of larger slabs, which are page-locked with one cudaHostRegister
+// call each; larger blocks get a slab of their own.
+//
+// Slabs are placed on the NUMA node of the GPU in use when NUMA is enabled
+// (see c10::IsNUMAEnabled), and blocks are only re-used on the same node.
+//
+// The pinned memory held by the allocator can be bounded with
+// THCCachingHostAllocator_setMemoryLimit, or with the
+// PYTORCH_CUDA_HOST_MEMORY_LIMIT_MB environment variable: when a new slab
+// would exceed the limit, slabs without allocated blocks are released first,
+// and the allocation fails if that is not enough.
 //
 THC_API c10::Allocator* getTHCCachingHostAllocator(void);
 
@@ -30,4 +44,41 @@ THC_API cudaError_t THCCachingHostAllocator_recordEvent(void *ptr, at::cuda::CUD
 // Releases cached pinned memory allocations via cudaHostFree
 THC_API void THCCachingHostAllocator_emptyCache(void);
 
+struct THCCachingHostAllocatorSizeClassStats {
+  size_t size;            // block size of the class
+  int64_t allocated;      // number of blocks in use
+  int64_t cached;         // number of free blocks kept for re-use
+};
+
+struct THCCachingHostAllocatorStats {
+  // Bytes of the blocks in use, and bytes requested for them; the
+  // difference is lost to the size class rounding.
+  int64_t allocated_bytes = 0;
+  int64_t requested_bytes = 0;
+  int64_t peak_allocated_bytes = 0;
+  // Bytes of pinned memory held by the allocator, in use or not
+  int64_t reserved_bytes = 0;
+  int64_t peak_reserved_bytes = 0;
+  // 0 if unlimited
+  int64_t limit_bytes = 0;
+
+  int64_t num_allocs = 0;
+  // allocations served by a cached block
+  int64_t num_cache_hits = 0;
+  // slabs registered and released to stay below the limit
+  int64_t num_slab_allocs = 0;
+  int64_t num_slab_evictions = 0;
+
+  std::vector<THCCachingHostAllocatorSizeClassStats> size_classes;
+};
+
+THC_API THCCachingHostAllocatorStats THCCachingHostAllocator_getStats(void);
+
+// Resets the peak and accumulated (num_*) statistics
+THC_API void THCCachingHostAllocator_resetStats(void);
+
+// Bounds the pinned memory held by the allocator, 0 meaning unlimited.
+// Cached memory above the new limit is released.
+THC_API void THCCachingHostAllocator_setMemoryLimit(size_t limit);
+
 #endif
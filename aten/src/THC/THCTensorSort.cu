@@ -1,6 +1,15 @@
 #include <THC/THCTensorSort.cuh>
 #include <ATen/cuda/CUDAContext.h>
 
+#ifndef __HIP_PLATFORM_HCC__
+__global__ void fillContiguousSlicesWithIndex(int64_t* out, int64_t sliceSize, int64_t n) {
+  for (int64_t i = blockIdx.x * (int64_t) blockDim.x + threadIdx.x; i < n;
+       i += blockDim.x * (int64_t) gridDim.x) {
+    out[i] = i % sliceSize;
+  }
+}
+#endif // __HIP_PLATFORM_HCC__
+
 void THCudaLongTensor_fillSliceWithIndex(THCState* state,
                                          THCudaLongTensor* t,
                                          int dim) {
@@ -9,6 +9,16 @@
 #include <THC/THCTensorTypeUtils.cuh>
 
 #include <THC/THCThrustAllocator.cuh>
+#include <THC/THCAsmUtils.cuh>
+#include <THC/THCDeviceUtils.cuh>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/native/cuda/SortingRadixSelect.cuh>
+#ifndef __HIP_PLATFORM_HCC__
+#include <cub/device/device_radix_sort.cuh>
+#include <cub/device/device_segmented_radix_sort.cuh>
+#include <cub/iterator/counting_input_iterator.cuh>
+#include <cub/iterator/transform_input_iterator.cuh>
+#endif
 #include <thrust/device_ptr.h>
 #include <thrust/sort.h>
 #if CUDA_VERSION >= 7000 || defined(__HIP_PLATFORM_HCC__)
@@ -97,6 +107,41 @@ struct GlobalIndexToPerSliceIndex {
   const int64_t sliceSize;
 };
 
+#ifndef __HIP_PLATFORM_HCC__
+// For sorting with cub radix sorts: the values are sorted through keys with
+// the same order (see TopKTypeConfig), in which NaNs come after all other
+// values, like for the comparison based sorts.
+template <typename T, typename bitwise_t>
+__global__ void valuesToRadixSortKeys(const T* values, bitwise_t* keys, int64_t n) {
+  for (int64_t i = blockIdx.x * (int64_t) blockDim.x + threadIdx.x; i < n;
+       i += blockDim.x * (int64_t) gridDim.x) {
+    keys[i] = at::native::TopKTypeConfig<T>::convert(values[i]);
+  }
+}
+
+template <typename T, typename bitwise_t>
+__global__ void radixSortKeysToValues(const bitwise_t* keys, T* values, int64_t n) {
+  for (int64_t i = blockIdx.x * (int64_t) blockDim.x + threadIdx.x; i < n;
+       i += blockDim.x * (int64_t) gridDim.x) {
+    values[i] = at::native::TopKTypeConfig<T>::deconvert(keys[i]);
+  }
+}
+
+// Fills contiguous slices of `sliceSize` elements with their per-slice index
+__global__ void fillContiguousSlicesWithIndex(int64_t* out, int64_t sliceSize, int64_t n);
+
+// Offset of the slice `i` of segmented sorts
+struct SliceOffsetOp {
+  SliceOffsetOp(int size) : sliceSize(size) {}
+
+  __host__ __device__ __forceinline__ int operator()(int i) const {
+    return i * sliceSize;
+  }
+
+  const int sliceSize;
+};
+#endif // __HIP_PLATFORM_HCC__
+
 void THCudaLongTensor_fillSliceWithIndex(THCState* state,
                                          THCudaLongTensor* t,
                                          int dim);
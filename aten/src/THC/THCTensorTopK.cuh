@@ -10,6 +10,7 @@
 #include <THC/THCTensorTypeUtils.cuh>
 #include <THC/THCTensorMathReduce.cuh>
 #include <ATen/WrapDimUtils.h>
+#include <ATen/cuda/CUDAContext.h>
 #include <algorithm> // for std::min
 
 #if CUDA_VERSION >= 7000 || defined __HIP_PLATFORM_HCC__
@@ -155,6 +156,234 @@ __global__ void gatherTopK(TensorInfo<T, IndexType> input,
   }
 }
 
+// Multi-block top-k, for a few very long slices that would leave most of the
+// GPU idle with one block per slice. Every slice is split in chunks of
+// `chunkSize` elements, block (x, y) handling chunk x of slice y, and the
+// k-th value is selected one MULTI_BLOCK_RADIX_BITS digit at a time: each
+// pass accumulates the digit histogram of the whole slice in global memory
+// (radixCountMultiBlock), then one block per slice picks the digit of the
+// k-th value (radixSelectDigitMultiBlock).
+//
+// The per-slice selection state lives in global memory and must be
+// zero-initialized:
+//  - desired, desiredMask: as in radixSelect,
+//  - countBefore: the number of values strictly before the values matching
+//    `desired` in the selection order. Once all the digits are selected,
+//    `desired` is the k-th value and `countBefore` the number of values
+//    that are strictly in the top-k.
+constexpr int MULTI_BLOCK_RADIX_BITS = 8;
+constexpr int MULTI_BLOCK_RADIX_SIZE = 1 << MULTI_BLOCK_RADIX_BITS;
+constexpr int MULTI_BLOCK_RADIX_MASK = MULTI_BLOCK_RADIX_SIZE - 1;
+constexpr int MULTI_BLOCK_THREADS = 512;
+
+template <typename T>
+C10_LAUNCH_BOUNDS_1(MULTI_BLOCK_THREADS)
+__global__ void radixCountMultiBlock(TensorInfo<T, uint32_t> input,
+                                     uint32_t sliceSize,
+                                     uint32_t withinSliceStride,
+                                     uint32_t chunkSize,
+                                     const typename TopKTypeConfig<T>::RadixType* desired,
+                                     const typename TopKTypeConfig<T>::RadixType* desiredMask,
+                                     int digitPos,
+                                     uint32_t* counts) {
+  using bitwise_t = typename TopKTypeConfig<T>::RadixType;
+  __shared__ uint32_t smem[MULTI_BLOCK_RADIX_SIZE];
+
+  for (int i = threadIdx.x; i < MULTI_BLOCK_RADIX_SIZE; i += blockDim.x) {
+    smem[i] = 0;
+  }
+  __syncthreads();
+
+  const uint32_t slice = blockIdx.y;
+  const T* data = &input.data[IndexToOffset<T, uint32_t, -1>::get(slice, input)];
+  const bitwise_t sliceDesired = desired[slice];
+  const bitwise_t sliceDesiredMask = desiredMask[slice];
+
+  const uint32_t begin = blockIdx.x * chunkSize;
+  const uint32_t end = min(begin + chunkSize, sliceSize);
+  for (uint32_t i = begin + threadIdx.x; i < end; i += blockDim.x) {
+    const bitwise_t val = TopKTypeConfig<T>::convert(doLdg(&data[i * withinSliceStride]));
+    if ((val & sliceDesiredMask) == sliceDesired) {
+      atomicAdd(&smem[Bitfield<bitwise_t>::getBitfield(val, digitPos, MULTI_BLOCK_RADIX_BITS)], 1u);
+    }
+  }
+  __syncthreads();
+
+  uint32_t* sliceCounts = &counts[slice * MULTI_BLOCK_RADIX_SIZE];
+  for (int i = threadIdx.x; i < MULTI_BLOCK_RADIX_SIZE; i += blockDim.x) {
+    if (smem[i] > 0) {
+      atomicAdd(&sliceCounts[i], smem[i]);
+    }
+  }
+}
+
+// Launched with one block of MULTI_BLOCK_RADIX_SIZE threads per slice. Also
+// clears the histogram for the next pass.
+template <typename bitwise_t, bool Order>
+__global__ void radixSelectDigitMultiBlock(uint32_t* counts,
+                                           bitwise_t* desired,
+                                           bitwise_t* desiredMask,
+                                           uint32_t* countBefore,
+                                           uint32_t k,
+                                           int digitPos) {
+  const uint32_t slice = blockIdx.x;
+  uint32_t* sliceCounts = &counts[slice * MULTI_BLOCK_RADIX_SIZE];
+
+  if (threadIdx.x == 0) {
+    uint32_t before = countBefore[slice];
+    uint32_t kToFind = k - before;
+    for (int j = 0; j < MULTI_BLOCK_RADIX_SIZE; ++j) {
+      const int i = Order ? MULTI_BLOCK_RADIX_SIZE - 1 - j : j;
+      const uint32_t count = sliceCounts[i];
+      if (count >= kToFind) {
+        desired[slice] = Bitfield<bitwise_t>::setBitfield(
+          desired[slice], i, digitPos, MULTI_BLOCK_RADIX_BITS);
+        desiredMask[slice] = Bitfield<bitwise_t>::setBitfield(
+          desiredMask[slice], MULTI_BLOCK_RADIX_MASK, digitPos, MULTI_BLOCK_RADIX_BITS);
+        break;
+      }
+      kToFind -= count;
+      before += count;
+    }
+    countBefore[slice] = before;
+  }
+  __syncthreads();
+
+  sliceCounts[threadIdx.x] = 0;
+}
+
+// Counts the values of each chunk that are strictly in the top-k and that
+// are equal to the k-th value, from which the chunks of a slice know where
+// to write their results.
+template <typename T, bool Order>
+C10_LAUNCH_BOUNDS_1(MULTI_BLOCK_THREADS)
+__global__ void topKCountMultiBlock(TensorInfo<T, uint32_t> input,
+                                    uint32_t sliceSize,
+                                    uint32_t withinSliceStride,
+                                    uint32_t chunkSize,
+                                    const typename TopKTypeConfig<T>::RadixType* kthValues,
+                                    uint32_t* chunkCounts) {
+  using bitwise_t = typename TopKTypeConfig<T>::RadixType;
+  __shared__ uint32_t smem[2];
+
+  if (threadIdx.x < 2) {
+    smem[threadIdx.x] = 0;
+  }
+  __syncthreads();
+
+  const uint32_t slice = blockIdx.y;
+  const T* data = &input.data[IndexToOffset<T, uint32_t, -1>::get(slice, input)];
+  const bitwise_t kth = kthValues[slice];
+
+  uint32_t strict = 0;
+  uint32_t equal = 0;
+  const uint32_t begin = blockIdx.x * chunkSize;
+  const uint32_t end = min(begin + chunkSize, sliceSize);
+  for (uint32_t i = begin + threadIdx.x; i < end; i += blockDim.x) {
+    const bitwise_t val = TopKTypeConfig<T>::convert(doLdg(&data[i * withinSliceStride]));
+    strict += Order ? (val > kth) : (val < kth);
+    equal += (val == kth);
+  }
+  atomicAdd(&smem[0], strict);
+  atomicAdd(&smem[1], equal);
+  __syncthreads();
+
+  if (threadIdx.x < 2) {
+    chunkCounts[(slice * gridDim.x + blockIdx.x) * 2 + threadIdx.x] = smem[threadIdx.x];
+  }
+}
+
+// Writes the top-k of every chunk, in the same order as gatherTopK: the
+// values strictly in the top-k first, in index order, then the first
+// values equal to the k-th value.
+template <typename T, bool Order>
+C10_LAUNCH_BOUNDS_1(MULTI_BLOCK_THREADS)
+__global__ void gatherTopKMultiBlock(TensorInfo<T, uint32_t> input,
+                                     uint32_t sliceSize,
+                                     uint32_t withinSliceStride,
+                                     uint32_t chunkSize,
+                                     uint32_t k,
+                                     const typename TopKTypeConfig<T>::RadixType* kthValues,
+                                     const uint32_t* countBefore,
+                                     const uint32_t* chunkCounts,
+                                     TensorInfo<T, uint32_t> topK,
+                                     uint32_t topKWithinSliceStride,
+                                     TensorInfo<int64_t, uint32_t> indices,
+                                     uint32_t indicesWithinSliceStride) {
+  using bitwise_t = typename TopKTypeConfig<T>::RadixType;
+#ifdef __HIP_PLATFORM_HCC__
+  __shared__ int smem[64];
+#else
+  __shared__ int smem[32]; // one per each warp, up to warp limit
+#endif
+  __shared__ uint32_t chunkStart[2];
+
+  if (threadIdx.x < 2) {
+    chunkStart[threadIdx.x] = 0;
+  }
+  __syncthreads();
+
+  const uint32_t slice = blockIdx.y;
+  const T* inputSliceStart = &input.data[IndexToOffset<T, uint32_t, -1>::get(slice, input)];
+  T* topKSliceStart = &topK.data[IndexToOffset<T, uint32_t, -1>::get(slice, topK)];
+  int64_t* indicesSliceStart =
+    &indices.data[IndexToOffset<int64_t, uint32_t, -1>::get(slice, indices)];
+
+  // The values of the previous chunks come first
+  uint32_t strictBefore = 0;
+  uint32_t equalBefore = 0;
+  const uint32_t* sliceChunkCounts = &chunkCounts[slice * gridDim.x * 2];
+  for (uint32_t c = threadIdx.x; c < blockIdx.x; c += blockDim.x) {
+    strictBefore += sliceChunkCounts[c * 2];
+    equalBefore += sliceChunkCounts[c * 2 + 1];
+  }
+  atomicAdd(&chunkStart[0], strictBefore);
+  atomicAdd(&chunkStart[1], equalBefore);
+  __syncthreads();
+
+  const bitwise_t kth = kthValues[slice];
+  const uint32_t strictCount = countBefore[slice];
+  const uint32_t equalCount = k - strictCount;
+  uint32_t strictIndexStart = chunkStart[0];
+  uint32_t equalIndexStart = chunkStart[1];
+
+  const uint32_t begin = blockIdx.x * chunkSize;
+  const uint32_t end = min(begin + chunkSize, sliceSize);
+  // All threads need to participate in the loop and the prefix sums
+  const uint32_t numIterations = THCRoundUp(end - begin, (uint32_t) blockDim.x);
+
+  for (uint32_t i = begin + threadIdx.x; i < begin + numIterations; i += blockDim.x) {
+    if (equalIndexStart >= equalCount && strictIndexStart >= strictCount) {
+      break;
+    }
+    const bool inRange = (i < end);
+    const T v =
+      inRange ? doLdg(&inputSliceStart[i * withinSliceStride]) : ScalarConvert<int, T>::to(0);
+    const bitwise_t convertedV = TopKTypeConfig<T>::convert(v);
+    const bool isStrict = inRange && (Order ? (convertedV > kth) : (convertedV < kth));
+    const bool isEqual = inRange && (convertedV == kth);
+
+    int index;
+    int carry;
+    exclusiveBinaryPrefixScan<int, true>(smem, isStrict, &index, &carry, AddOp<int>());
+    if (isStrict) {
+      const uint32_t writeIndex = strictIndexStart + index;
+      CUDA_KERNEL_ASSERT(writeIndex < strictCount);
+      topKSliceStart[writeIndex * topKWithinSliceStride] = v;
+      indicesSliceStart[writeIndex * indicesWithinSliceStride] = i;
+    }
+    strictIndexStart += carry;
+
+    exclusiveBinaryPrefixScan<int, true>(smem, isEqual, &index, &carry, AddOp<int>());
+    if (isEqual && equalIndexStart + index < equalCount) {
+      const uint32_t writeIndex = strictCount + equalIndexStart + index;
+      topKSliceStart[writeIndex * topKWithinSliceStride] = v;
+      indicesSliceStart[writeIndex * indicesWithinSliceStride] = i;
+    }
+    equalIndexStart += carry;
+  }
+}
+
 #undef RADIX_BITS
 #undef RADIX_SIZE
 #undef RADIX_MASK
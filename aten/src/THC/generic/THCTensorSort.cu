@@ -151,18 +151,108 @@ void THCTensor_(sortKeyValueInplace)(THCState* state,
   THCudaCheck(cudaGetLastError());
 }
 
-void THCTensor_(sortViaThrust)(THCState* state,
-                               THCTensor* sorted,
-                               THCudaLongTensor* indices,
-                               THCTensor* input,
-                               int dim, bool dir) {
+#ifndef __HIP_PLATFORM_HCC__
+// Sorts the contiguous slices of `keys` with cub radix sorts, and writes the
+// per-slice indices of the sorted values in `indices`. Equal values keep
+// their relative order.
+//
+// Few long slices are sorted one at a time by the device-wide radix sort,
+// which spreads every slice over the whole GPU. Otherwise, the segmented
+// radix sort sorts all of them in one go with one block per slice.
+static void THCTensor_(radixSortContiguousSlices)(THCState* state,
+                                                  scalar_t* keys,
+                                                  int64_t* indices,
+                                                  int64_t totalElements,
+                                                  int64_t sliceSize,
+                                                  bool dir) {
+  using bitwise_t = typename at::native::TopKTypeConfig<scalar_t>::RadixType;
+  if (totalElements == 0) {
+    return;
+  }
+  cudaStream_t stream = c10::cuda::getCurrentCUDAStream();
+  const int64_t numSlices = totalElements / sliceSize;
+  const int numSMs = at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+  const dim3 block(512);
+  const dim3 grid(std::min(THCCeilDiv(totalElements, (int64_t) block.x), (int64_t) numSMs * 8));
+  const int endBit = sizeof(scalar_t) * 8;
+
+  bitwise_t* keysIn = static_cast<bitwise_t*>(
+    THCudaMalloc(state, 2 * totalElements * sizeof(bitwise_t)));
+  bitwise_t* keysOut = keysIn + totalElements;
+  int64_t* indicesIn = static_cast<int64_t*>(
+    THCudaMalloc(state, totalElements * sizeof(int64_t)));
+  valuesToRadixSortKeys<<<grid, block, 0, stream>>>(keys, keysIn, totalElements);
+  fillContiguousSlicesWithIndex<<<grid, block, 0, stream>>>(indicesIn, sliceSize, totalElements);
+
+  size_t tempBytes = 0;
+  void* temp = nullptr;
+  if (numSlices < numSMs && sliceSize >= 32768) {
+    const int n = sliceSize;
+    if (dir) {
+      THCudaCheck(cub::DeviceRadixSort::SortPairsDescending(
+        nullptr, tempBytes, keysIn, keysOut, indicesIn, indices, n, 0, endBit, stream));
+    } else {
+      THCudaCheck(cub::DeviceRadixSort::SortPairs(
+        nullptr, tempBytes, keysIn, keysOut, indicesIn, indices, n, 0, endBit, stream));
+    }
+    temp = THCudaMalloc(state, tempBytes);
+    for (int64_t slice = 0; slice < numSlices; ++slice) {
+      const int64_t offset = slice * sliceSize;
+      if (dir) {
+        THCudaCheck(cub::DeviceRadixSort::SortPairsDescending(
+          temp, tempBytes, keysIn + offset, keysOut + offset,
+          indicesIn + offset, indices + offset, n, 0, endBit, stream));
+      } else {
+        THCudaCheck(cub::DeviceRadixSort::SortPairs(
+          temp, tempBytes, keysIn + offset, keysOut + offset,
+          indicesIn + offset, indices + offset, n, 0, endBit, stream));
+      }
+    }
+  } else {
+    const int n = totalElements;
+    cub::TransformInputIterator<int, SliceOffsetOp, cub::CountingInputIterator<int>>
+      offsets(cub::CountingInputIterator<int>(0), SliceOffsetOp(sliceSize));
+    for (int pass = 0; pass < 2; ++pass) {
+      // The first pass only queries the temporary storage size
+      if (pass == 1) {
+        temp = THCudaMalloc(state, tempBytes);
+      }
+      if (dir) {
+        THCudaCheck(cub::DeviceSegmentedRadixSort::SortPairsDescending(
+          temp, tempBytes, keysIn, keysOut, indicesIn, indices, n, numSlices,
+          offsets, offsets + 1, 0, endBit, stream));
+      } else {
+        THCudaCheck(cub::DeviceSegmentedRadixSort::SortPairs(
+          temp, tempBytes, keysIn, keysOut, indicesIn, indices, n, numSlices,
+          offsets, offsets + 1, 0, endBit, stream));
+      }
+    }
+  }
+
+  radixSortKeysToValues<<<grid, block, 0, stream>>>(keysOut, keys, totalElements);
+  THCudaCheck(cudaGetLastError());
+
+  THCudaFree(state, temp);
+  THCudaFree(state, indicesIn);
+  THCudaFree(state, keysIn);
+}
+#endif // __HIP_PLATFORM_HCC__
+
+// Sorts slices of any size and layout, through a copy of the input in which
+// the slices are contiguous.
+void THCTensor_(sortOutOfPlace)(THCState* state,
+                                THCTensor* sorted,
+                                THCudaLongTensor* indices,
+                                THCTensor* input,
+                                int dim, bool dir) {
   int nDims = THCTensor_(nDimensionLegacyAll)(state, input);
 
   ptrdiff_t totalElements = THCTensor_(nElement)(state, input);
   int64_t sliceSize = THCTensor_(sizeLegacyNoScalars)(state, input, dim);
   int64_t sliceStride = THTensor_strideLegacyNoScalars(input, dim);
 
-  // We perform a vectorized segmented sort in Thrust.
+  // Without cub, or for too many elements, we perform a vectorized
+  // segmented sort in Thrust.
   // Say we are sorting a (2, 3) tensor. We have in flattened form:
   // values 0.4 1.2 5.3 6.2 1.3 2.3
   // indices  0   1   2   3   4   5
@@ -200,67 +290,78 @@ void THCTensor_(sortViaThrust)(THCState* state,
     THCudaLongTensor_transpose(state, trIndices, NULL, dim, nDims - 1);
   }
 
-  // Thrust must operate on a contiguous layout
+  // The sorts must operate on a contiguous layout
   THCTensor* trContigKey = THCTensor_(newContiguous)(state, trKeys);
   THCudaLongTensor* trContigIndices = THCudaLongTensor_newContiguous(state, trIndices);
 
   THCTensor_(free)(state, trKeys);
   THCudaLongTensor_free(state, trIndices);
 
-  THCThrustAllocator thrustAlloc(state);
+#ifndef __HIP_PLATFORM_HCC__
+  // The radix sorts of cub index the elements with ints
+  if (totalElements <= INT_MAX) {
+    THCTensor_(radixSortContiguousSlices)(
+      state, THCTensor_(data)(state, trContigKey),
+      THCudaLongTensor_data(state, trContigIndices),
+      totalElements, sliceSize, dir);
+  } else
+#endif
+  {
+    THCThrustAllocator thrustAlloc(state);
 
-  thrust::device_ptr<scalar_t> keyIter(THCTensor_(data)(state, trContigKey));
+    thrust::device_ptr<scalar_t> keyIter(THCTensor_(data)(state, trContigKey));
 
-  // Since we are composing a global index across all segments rather
-  // than a per-segment index, we treat the memory as int so we don't
-  // have problems sorting slices < 2^24 but where the entire tensor
-  // has more than 2^24 elements
-  thrust::device_ptr<int64_t>
-    indexIter((int64_t*) THCudaLongTensor_data(state, trContigIndices));
+    // Since we are composing a global index across all segments rather
+    // than a per-segment index, we treat the memory as int so we don't
+    // have problems sorting slices < 2^24 but where the entire tensor
+    // has more than 2^24 elements
+    thrust::device_ptr<int64_t>
+      indexIter((int64_t*) THCudaLongTensor_data(state, trContigIndices));
 
-  // Fill the indices with a global index across all slices
-  thrust::counting_iterator<int64_t> countIter(0);
-  thrust::copy(
+    // Fill the indices with a global index across all slices
+    thrust::counting_iterator<int64_t> countIter(0);
+    thrust::copy(
 #if CUDA_VERSION >= 7000 || defined __HIP_PLATFORM_HCC__
-    thrust::cuda::par(thrustAlloc).on(c10::cuda::getCurrentCUDAStream()),
+      thrust::cuda::par(thrustAlloc).on(c10::cuda::getCurrentCUDAStream()),
 #endif
-    countIter, countIter + totalElements, indexIter);
-    auto begin = thrust::make_zip_iterator(thrust::make_tuple(indexIter, keyIter));
-  if (dir){
-    if (totalElements < INT_MAX)
-       thrust::sort(
+      countIter, countIter + totalElements, indexIter);
+      auto begin = thrust::make_zip_iterator(thrust::make_tuple(indexIter, keyIter));
+    if (dir){
+      if (totalElements < INT_MAX)
+         thrust::sort(
 #if CUDA_VERSION >= 7000 || defined __HIP_PLATFORM_HCC__
-       thrust::cuda::par(thrustAlloc).on(c10::cuda::getCurrentCUDAStream()),
+         thrust::cuda::par(thrustAlloc).on(c10::cuda::getCurrentCUDAStream()),
 #endif
-       begin, begin + totalElements, ThrustSliceGTOp<scalar_t, int, true>(sliceSize));
-    else
-       thrust::sort(
+         begin, begin + totalElements, ThrustSliceGTOp<scalar_t, int, true>(sliceSize));
+      else
+         thrust::sort(
 #if CUDA_VERSION >= 7000 || defined __HIP_PLATFORM_HCC__
-       thrust::cuda::par(thrustAlloc).on(c10::cuda::getCurrentCUDAStream()),
+         thrust::cuda::par(thrustAlloc).on(c10::cuda::getCurrentCUDAStream()),
 #endif
-       begin, begin + totalElements, ThrustSliceGTOp<scalar_t, int64_t, true>(sliceSize));
-  } else {
-    if (totalElements < INT_MAX)
-       thrust::sort(
+         begin, begin + totalElements, ThrustSliceGTOp<scalar_t, int64_t, true>(sliceSize));
+    } else {
+      if (totalElements < INT_MAX)
+         thrust::sort(
 #if CUDA_VERSION >= 7000 || defined __HIP_PLATFORM_HCC__
-       thrust::cuda::par(thrustAlloc).on(c10::cuda::getCurrentCUDAStream()),
+         thrust::cuda::par(thrustAlloc).on(c10::cuda::getCurrentCUDAStream()),
 #endif
-       begin, begin + totalElements, ThrustSliceLTOp<scalar_t, int, true>(sliceSize));
-    else
-       thrust::sort(
+         begin, begin + totalElements, ThrustSliceLTOp<scalar_t, int, true>(sliceSize));
+      else
+         thrust::sort(
 #if CUDA_VERSION >= 7000 || defined __HIP_PLATFORM_HCC__
-       thrust::cuda::par(thrustAlloc).on(c10::cuda::getCurrentCUDAStream()),
+         thrust::cuda::par(thrustAlloc).on(c10::cuda::getCurrentCUDAStream()),
 #endif
-       begin, begin + totalElements, ThrustSliceLTOp<scalar_t, int64_t, true>(sliceSize));
-  }
-  // Translate the global integer 0-based index to a per-slice real
-  // Lua index
-  thrust::for_each(
+         begin, begin + totalElements, ThrustSliceLTOp<scalar_t, int64_t, true>(sliceSize));
+    }
+    // Translate the global integer 0-based index to a per-slice real
+    // Lua index
+    thrust::for_each(
 #if CUDA_VERSION >= 7000 || defined __HIP_PLATFORM_HCC__
-    thrust::cuda::par(thrustAlloc).on(c10::cuda::getCurrentCUDAStream()),
+      thrust::cuda::par(thrustAlloc).on(c10::cuda::getCurrentCUDAStream()),
 #endif
-    indexIter, indexIter + totalElements,
-    GlobalIndexToPerSliceIndex(sliceSize));
+      indexIter, indexIter + totalElements,
+      GlobalIndexToPerSliceIndex(sliceSize));
+  }
 
   // Reverse the transposition as needed
   if (dim != nDims - 1) {
@@ -320,9 +421,10 @@ void THCTensor_(sort)(THCState* state,
     // layout
     THCTensor_(sortKeyValueInplace)(state, sorted, indices, dim, order);
   } else {
-    // Otherwise, fall back upon Thrust, which handles all other cases
-    // (potentially slowly, with extra copies/memory allocations)
-    THCTensor_(sortViaThrust)(state, sorted, indices, input, dim, (bool) order);
+    // Otherwise, sort a copy of the input with contiguous slices, using cub
+    // radix sorts or Thrust, which handle all other cases (with extra
+    // copies/memory allocations)
+    THCTensor_(sortOutOfPlace)(state, sorted, indices, input, dim, (bool) order);
   }
 
   THCudaCheck(cudaGetLastError());
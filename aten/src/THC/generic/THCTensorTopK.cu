@@ -4,6 +4,90 @@
 
 #include <c10/macros/Macros.h>
 
+#if !defined(THC_REAL_IS_BFLOAT16) || defined(__HIP_PLATFORM_HCC__)
+// Top-k of `inputSlices` long slices with `blocksPerSlice` blocks per slice,
+// see radixCountMultiBlock. All the tensors must be indexable with 32 bits.
+static void THCTensor_(topkMultiBlock)(THCState* state,
+                                       THCTensor* topK,
+                                       THCudaLongTensor* indices,
+                                       THCTensor* input,
+                                       int64_t k, int dim, int dir,
+                                       int64_t inputSlices,
+                                       int64_t blocksPerSlice) {
+  using bitwise_t = typename TopKTypeConfig<scalar_t>::RadixType;
+  cudaStream_t stream = c10::cuda::getCurrentCUDAStream();
+
+  TensorInfo<scalar_t, uint32_t> inputInfo =
+    getTensorInfo<scalar_t, THCTensor, uint32_t>(state, input);
+  TensorInfo<scalar_t, uint32_t> topKInfo =
+    getTensorInfo<scalar_t, THCTensor, uint32_t>(state, topK);
+  TensorInfo<int64_t, uint32_t> indicesInfo =
+    getTensorInfo<int64_t, THCudaLongTensor, uint32_t>(state, indices);
+  inputInfo.sizes[dim] = 1;
+  topKInfo.sizes[dim] = 1;
+  indicesInfo.sizes[dim] = 1;
+  int collapseInputDim = inputInfo.collapseDims(dim);
+  int collapseTopKDim = topKInfo.collapseDims(dim);
+  int collapseIndicesDim = indicesInfo.collapseDims(dim);
+
+  const uint32_t sliceSize = THCTensor_(sizeLegacyNoScalars)(state, input, dim);
+  const uint32_t withinSliceStride = inputInfo.strides[collapseInputDim];
+  const uint32_t chunkSize =
+    THCRoundUp(THCCeilDiv((int64_t) sliceSize, blocksPerSlice), (int64_t) MULTI_BLOCK_THREADS);
+  blocksPerSlice = THCCeilDiv((int64_t) sliceSize, (int64_t) chunkSize);
+
+  // The selection state and the digit histograms are zero-initialized, the
+  // chunk counts are fully written by topKCountMultiBlock
+  const size_t stateSize = inputSlices *
+    (2 * sizeof(bitwise_t) + sizeof(uint32_t) * (1 + MULTI_BLOCK_RADIX_SIZE));
+  const size_t chunkCountsSize = inputSlices * blocksPerSlice * 2 * sizeof(uint32_t);
+  char* scratch = static_cast<char*>(THCudaMalloc(state, stateSize + chunkCountsSize));
+  THCudaCheck(cudaMemsetAsync(scratch, 0, stateSize, stream));
+  bitwise_t* desired = reinterpret_cast<bitwise_t*>(scratch);
+  bitwise_t* desiredMask = desired + inputSlices;
+  uint32_t* countBefore = reinterpret_cast<uint32_t*>(desiredMask + inputSlices);
+  uint32_t* counts = countBefore + inputSlices;
+  uint32_t* chunkCounts = counts + inputSlices * MULTI_BLOCK_RADIX_SIZE;
+
+  const dim3 grid(blocksPerSlice, inputSlices);
+  const dim3 block(MULTI_BLOCK_THREADS);
+
+  for (int digitPos = sizeof(scalar_t) * 8 - MULTI_BLOCK_RADIX_BITS; digitPos >= 0;
+       digitPos -= MULTI_BLOCK_RADIX_BITS) {
+    radixCountMultiBlock<scalar_t><<<grid, block, 0, stream>>>(
+      inputInfo, sliceSize, withinSliceStride, chunkSize,
+      desired, desiredMask, digitPos, counts);
+    if (dir) {
+      radixSelectDigitMultiBlock<bitwise_t, true><<<inputSlices, MULTI_BLOCK_RADIX_SIZE, 0, stream>>>(
+        counts, desired, desiredMask, countBefore, k, digitPos);
+    } else {
+      radixSelectDigitMultiBlock<bitwise_t, false><<<inputSlices, MULTI_BLOCK_RADIX_SIZE, 0, stream>>>(
+        counts, desired, desiredMask, countBefore, k, digitPos);
+    }
+  }
+
+#define RUN_GATHER(DIR)                                                 \
+  topKCountMultiBlock<scalar_t, DIR><<<grid, block, 0, stream>>>(       \
+    inputInfo, sliceSize, withinSliceStride, chunkSize,                 \
+    desired, chunkCounts);                                              \
+  gatherTopKMultiBlock<scalar_t, DIR><<<grid, block, 0, stream>>>(      \
+    inputInfo, sliceSize, withinSliceStride, chunkSize, k,              \
+    desired, countBefore, chunkCounts,                                  \
+    topKInfo, topKInfo.strides[collapseTopKDim],                        \
+    indicesInfo, indicesInfo.strides[collapseIndicesDim])
+
+  if (dir) {
+    RUN_GATHER(true);
+  } else {
+    RUN_GATHER(false);
+  }
+#undef RUN_GATHER
+
+  THCudaCheck(cudaGetLastError());
+  THCudaFree(state, scratch);
+}
+#endif // !THC_REAL_IS_BFLOAT16 || __HIP_PLATFORM_HCC__
+
 void THCTensor_(topk)(THCState* state,
                       THCTensor *topK,
                       THCudaLongTensor *indices,
@@ -122,11 +206,27 @@ void THCTensor_(topk)(THCState* state,
   // the below is safe with 0-dimensional tensors because it is based on
   // THCTensorInfo which implicitly expands to 1-dimensional.
   if (THCTensor_nElement(state, input) > 0) {
+    const bool canUse32BitIndexMath =
+      THCTensor_canUse32BitIndexMath(state, input) &&
+      THCTensor_canUse32BitIndexMath(state, topK) &&
+      THCTensor_canUse32BitIndexMath(state, indices);
+
+    // With one block per slice, fewer slices than SMs would leave most of
+    // the GPU idle: long slices are split across several blocks, as long as
+    // the chunks of every block stay large enough to amortize the extra
+    // passes over the input.
+    const int64_t inputSlices = THCTensor_nElement(state, input) / sliceSize;
+    const int64_t numSMs = at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+    const int64_t blocksPerSlice = std::min(
+      THCCeilDiv(sliceSize, (int64_t) (8 * MULTI_BLOCK_THREADS)),
+      THCCeilDiv(4 * numSMs, inputSlices));
+
     // Based on required index size, run the algorithm with the
     // appropriate index type
-    if (THCTensor_canUse32BitIndexMath(state, input) &&
-        THCTensor_canUse32BitIndexMath(state, topK) &&
-        THCTensor_canUse32BitIndexMath(state, indices)) {
+    if (canUse32BitIndexMath && k > 0 && inputSlices < numSMs && blocksPerSlice >= 4) {
+      THCTensor_(topkMultiBlock)(state, topK, indices, input, k, dim, dir,
+                                 inputSlices, blocksPerSlice);
+    } else if (canUse32BitIndexMath) {
       RUN_T(uint32_t);
     } else {
       RUN_T(uint64_t);
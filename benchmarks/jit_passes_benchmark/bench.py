@@ -0,0 +1,73 @@
+import argparse
+import time
+
+import torch
+
+
+def chain_of_views(num_nodes):
+    # A single long chain of aliases, ending in a list of the last view
+    lines = ["graph(%x : Tensor):", "  %v0 : Tensor = aten::neg(%x)"]
+    for i in range(1, num_nodes):
+        lines.append("  %v{} : Tensor = aten::t(%v{})".format(i, i - 1))
+    lines.append("  %l : Tensor[] = prim::ListConstruct(%v{})".format(num_nodes - 1))
+    lines.append("  return (%l)")
+    return "\n".join(lines)
+
+
+def duplicated_exprs(num_nodes):
+    # One node in three is a duplicate, for CSE to remove
+    lines = ["graph(%x0 : Tensor):"]
+    for i in range(num_nodes // 3):
+        lines.append("  %a{0} : Tensor = aten::neg(%x{0})".format(i))
+        lines.append("  %b{0} : Tensor = aten::neg(%x{0})".format(i))
+        lines.append("  %x{1} : Tensor = aten::mul(%a{0}, %b{0})".format(i, i + 1))
+    lines.append("  return (%x{})".format(num_nodes // 3))
+    return "\n".join(lines)
+
+
+GRAPHS = {
+    "chain_of_views": chain_of_views,
+    "duplicated_exprs": duplicated_exprs,
+}
+
+
+def bench(make_graph, num_nodes, num_repeats):
+    ir = make_graph(num_nodes)
+    times = []
+    for _ in range(num_repeats):
+        graph = torch._C.parse_ir(ir)
+        time_start = time.time()
+        torch._C._jit_pass_cse(graph)
+        times.append(time.time() - time_start)
+    return min(times)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Time the alias analysis and CSE passes on large synthetic graphs."
+    )
+    parser.add_argument(
+        "--nodes",
+        "-n",
+        type=int,
+        nargs="+",
+        default=[10000, 50000, 200000],
+        help="The numbers of nodes of the graphs.",
+    )
+    parser.add_argument(
+        "--nreps",
+        type=int,
+        default=3,
+        help="The number of repeats, of which the fastest is reported.",
+    )
+    args = parser.parse_args()
+
+    for name, make_graph in GRAPHS.items():
+        for num_nodes in args.nodes:
+            bench_time = bench(make_graph, num_nodes, args.nreps)
+            print("{:<18} {:>8} nodes: {:.3f}s ({:.2f}us per node)".format(
+                name, num_nodes, bench_time, bench_time / num_nodes * 1e6))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+"""Compares two JSON outputs of tensoriterator_op_benchmark.
+
+Run the benchmark with --benchmark_out=<file> --benchmark_out_format=json on
+the base and the new build, then
+
+    python compare_op_benchmarks.py base.json new.json
+
+prints the cases that got slower or faster by more than --threshold and exits
+with 1 if any got slower. With --benchmark_repetitions, the median of the
+repetitions is compared, which is much less noisy than a single run.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path, metric):
+    """Returns {case name: time in ns} for the runs in a benchmark JSON."""
+    with open(path) as f:
+        data = json.load(f)
+    scale = {'ns': 1., 'us': 1e3, 'ms': 1e6, 's': 1e9}
+    times = {}
+    medians = {}
+    for run in data['benchmarks']:
+        name = run.get('run_name', run['name'])
+        time = run[metric] * scale[run.get('time_unit', 'ns')]
+        if run.get('run_type') == 'aggregate':
+            if run.get('aggregate_name') == 'median':
+                medians[name] = time
+            continue
+        # Without aggregates, keep the fastest of repeated runs.
+        times[name] = min(time, times.get(name, time))
+    times.update(medians)
+    return times
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('base', help='JSON output of the base run')
+    parser.add_argument('new', help='JSON output of the new run')
+    parser.add_argument(
+        '--threshold', type=float, default=0.1,
+        help='relative change to report, e.g. 0.1 for 10%% (default: 0.1)')
+    parser.add_argument(
+        '--metric', choices=['real_time', 'cpu_time'], default='real_time',
+        help='time to compare (default: real_time)')
+    parser.add_argument(
+        '--min-time-us', type=float, default=0.,
+        help='ignore cases faster than this in the base run')
+    args = parser.parse_args()
+
+    base = load(args.base, args.metric)
+    new = load(args.new, args.metric)
+
+    regressions = []
+    improvements = []
+    for name in sorted(set(base) & set(new)):
+        if base[name] < args.min_time_us * 1e3 or base[name] == 0:
+            continue
+        ratio = new[name] / base[name]
+        if ratio > 1 + args.threshold:
+            regressions.append((ratio, name))
+        elif ratio < 1 / (1 + args.threshold):
+            improvements.append((ratio, name))
+
+    def report(title, cases):
+        if not cases:
+            return
+        print('{} ({}):'.format(title, len(cases)))
+        for ratio, name in cases:
+            print('  {:<64} {:>12.3f}us {:>12.3f}us {:>7.2f}x'.format(
+                name, base[name] / 1e3, new[name] / 1e3, ratio))
+
+    report('Regressions', sorted(regressions, reverse=True))
+    report('Improvements', sorted(improvements))
+    missing = sorted(set(base) - set(new))
+    if missing:
+        print('Cases missing from {}: {}'.format(args.new, len(missing)))
+    print('Compared {} cases, {} regressions and {} improvements beyond {:.0%}'.format(
+        len(set(base) & set(new)), len(regressions), len(improvements),
+        args.threshold))
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -16,7 +16,11 @@
 
 #include "benchmark/benchmark.h"
 
+#include <ATen/ATen.h>
+#include <ATen/core/dispatch/Dispatcher.h>
 #include <c10/util/Logging.h>
+#include <torch/csrc/autograd/record_function.h>
+#include <torch/library.h>
 
 #if defined(__GNUC__)
 #define NOINLINE __attribute__((noinline))
@@ -55,4 +59,47 @@ static void BM_NoAPILogging(benchmark::State& state) {
 }
 BENCHMARK(BM_NoAPILogging);
 
+// Per-op overhead of the dispatcher: a no-op kernel called through the
+// dispatcher, and a small CPU add, with and without RecordFunction callbacks.
+
+TORCH_LIBRARY(_overhead_bench, m) {
+  m.def("noop(Tensor self) -> Tensor", [](const at::Tensor& self) {
+    return self;
+  });
+}
+
+static void BM_DispatchNoop(benchmark::State& state) {
+  auto op = c10::Dispatcher::singleton().findSchemaOrThrow(
+      "_overhead_bench::noop", "");
+  auto t = at::ones({1});
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(op.callUnboxed<at::Tensor, const at::Tensor&>(t));
+  }
+}
+BENCHMARK(BM_DispatchNoop);
+
+static void BM_SmallAdd(benchmark::State& state) {
+  auto a = at::ones({1});
+  auto b = at::ones({1});
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(at::add(a, b));
+  }
+}
+BENCHMARK(BM_SmallAdd);
+
+static void BM_SmallAddWithCallbacks(benchmark::State& state) {
+  namespace profiler = torch::autograd::profiler;
+  profiler::pushCallback(
+      [](const profiler::RecordFunction&) { return true; },
+      [](const profiler::RecordFunction&) {},
+      /* needs_inputs */ false);
+  auto a = at::ones({1});
+  auto b = at::ones({1});
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(at::add(a, b));
+  }
+  profiler::popCallback();
+}
+BENCHMARK(BM_SmallAddWithCallbacks);
+
 BENCHMARK_MAIN();
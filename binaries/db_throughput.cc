@@ -22,6 +22,7 @@
 #include "caffe2/core/init.h"
 #include "caffe2/core/timer.h"
 #include "caffe2/core/logging.h"
+#include "caffe2/db/prefetching_db_reader.h"
 
 C10_DEFINE_string(input_db, "", "The input db.");
 C10_DEFINE_string(input_db_type, "", "The input db type.");
@@ -32,10 +33,23 @@ C10_DEFINE_int(
     num_read_threads,
     1,
     "The number of concurrent reading threads.");
+C10_DEFINE_bool(
+    use_prefetching_reader,
+    false,
+    "If true, use the prefetching reader interface.");
+C10_DEFINE_int(
+    num_prefetch_threads,
+    4,
+    "The number of threads reading ahead for the prefetching reader.");
+C10_DEFINE_int(
+    prefetch_capacity,
+    1024,
+    "The number of records the prefetching reader buffers.");
 
 using caffe2::db::Cursor;
 using caffe2::db::DB;
 using caffe2::db::DBReader;
+using caffe2::db::PrefetchingDBReader;
 using caffe2::string;
 
 void TestThroughputWithDB() {
@@ -44,9 +58,11 @@ void TestThroughputWithDB() {
   std::unique_ptr<Cursor> cursor(in_db->NewCursor());
   for (int iter_id = 0; iter_id < FLAGS_repeat; ++iter_id) {
     caffe2::Timer timer;
+    size_t bytes = 0;
     for (int i = 0; i < FLAGS_report_interval; ++i) {
       string key = cursor->key();
       string value = cursor->value();
+      bytes += value.size();
       //VLOG(1) << "Key " << key;
       cursor->Next();
       if (!cursor->Valid()) {
@@ -55,10 +71,12 @@ void TestThroughputWithDB() {
     }
     double elapsed_seconds = timer.Seconds();
     printf(
-        "Iteration %03d, took %4.5f seconds, throughput %f items/sec.\n",
+        "Iteration %03d, took %4.5f seconds, throughput %f items/sec, "
+        "%f MB/sec.\n",
         iter_id,
         elapsed_seconds,
-        FLAGS_report_interval / elapsed_seconds);
+        FLAGS_report_interval / elapsed_seconds,
+        bytes / elapsed_seconds / (1 << 20));
   }
 }
 
@@ -66,18 +84,50 @@ void TestThroughputWithReaderWorker(const DBReader* reader, int thread_id) {
   string key, value;
   for (int iter_id = 0; iter_id < FLAGS_repeat; ++iter_id) {
     caffe2::Timer timer;
+    size_t bytes = 0;
     for (int i = 0; i < FLAGS_report_interval; ++i) {
       reader->Read(&key, &value);
+      bytes += value.size();
     }
     double elapsed_seconds = timer.Seconds();
     printf(
         "Thread %03d iteration %03d, took %4.5f seconds, "
-        "throughput %f items/sec.\n",
+        "throughput %f items/sec, %f MB/sec.\n",
         thread_id,
         iter_id,
         elapsed_seconds,
-        FLAGS_report_interval / elapsed_seconds);
+        FLAGS_report_interval / elapsed_seconds,
+        bytes / elapsed_seconds / (1 << 20));
+  }
+}
+
+void TestThroughputWithPrefetchingReader() {
+  PrefetchingDBReader reader(
+      FLAGS_input_db_type,
+      FLAGS_input_db,
+      FLAGS_num_prefetch_threads,
+      FLAGS_prefetch_capacity);
+  string key, value;
+  for (int iter_id = 0; iter_id < FLAGS_repeat; ++iter_id) {
+    caffe2::Timer timer;
+    size_t bytes = 0;
+    for (int i = 0; i < FLAGS_report_interval; ++i) {
+      reader.Read(&key, &value);
+      bytes += value.size();
+    }
+    double elapsed_seconds = timer.Seconds();
+    printf(
+        "Iteration %03d, took %4.5f seconds, throughput %f items/sec, "
+        "%f MB/sec.\n",
+        iter_id,
+        elapsed_seconds,
+        FLAGS_report_interval / elapsed_seconds,
+        bytes / elapsed_seconds / (1 << 20));
   }
+  printf(
+      "Prefetched %lld items, %lld bytes in total.\n",
+      (long long)reader.records_read(),
+      (long long)reader.bytes_read());
 }
 
 void TestThroughputWithReader() {
@@ -95,7 +145,9 @@ void TestThroughputWithReader() {
 
 int main(int argc, char** argv) {
   caffe2::GlobalInit(&argc, &argv);
-  if (FLAGS_use_reader) {
+  if (FLAGS_use_prefetching_reader) {
+    TestThroughputWithPrefetchingReader();
+  } else if (FLAGS_use_reader) {
     TestThroughputWithReader();
   } else {
     TestThroughputWithDB();
@@ -0,0 +1,200 @@
+// Per-op overhead of each layer between a caller and a kernel, on 1-element
+// CPU tensors so that the kernel itself is negligible:
+//
+//   dispatcher/*   a no-op kernel called through the dispatcher, unboxed and
+//                  boxed
+//   autograd/*     a small add below VariableType, through VariableType, and
+//                  through VariableType while recording a graph
+//   interpreter/*  TorchScript functions, per loop iteration or tensor op
+//   module/*       Module::forward of an identity module
+//   rpc/*          an RPC of aten::add without transport, see BM_RpcLoopback
+//
+// All cases report items per second, i.e. the cost of one op is the inverse.
+// The difference between two rows adding one layer is the cost of that layer,
+// e.g. autograd/add minus autograd/add_no_variable_type is the cost of the
+// VariableType kernel.
+
+#include "benchmark/benchmark.h"
+
+#include <ATen/ATen.h>
+#include <ATen/core/LegacyTypeDispatch.h>
+#include <ATen/core/dispatch/Dispatcher.h>
+#include <torch/csrc/api/include/torch/jit.h>
+#include <torch/csrc/jit/api/module.h>
+#include <torch/library.h>
+
+#ifdef USE_DISTRIBUTED
+#include <torch/csrc/distributed/rpc/script_call.h>
+#include <torch/csrc/distributed/rpc/script_resp.h>
+#include <torch/csrc/distributed/rpc/utils.h>
+#include <torch/csrc/jit/runtime/operator.h>
+#endif
+
+TORCH_LIBRARY(_framework_overhead_bench, m) {
+  m.def("noop(Tensor self) -> Tensor", [](const at::Tensor& self) {
+    return self;
+  });
+}
+
+static void BM_DispatcherNoop(benchmark::State& state) {
+  auto op = c10::Dispatcher::singleton().findSchemaOrThrow(
+      "_framework_overhead_bench::noop", "");
+  auto t = at::ones({1});
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(op.callUnboxed<at::Tensor, const at::Tensor&>(t));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DispatcherNoop)->Name("dispatcher/noop");
+
+// The interpreter calls every op boxed like this.
+static void BM_DispatcherNoopBoxed(benchmark::State& state) {
+  auto op = c10::Dispatcher::singleton().findSchemaOrThrow(
+      "_framework_overhead_bench::noop", "");
+  auto t = at::ones({1});
+  torch::jit::Stack stack;
+  while (state.KeepRunning()) {
+    stack.emplace_back(t);
+    op.callBoxed(&stack);
+    stack.clear();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DispatcherNoopBoxed)->Name("dispatcher/noop_boxed");
+
+static void BM_AddNoVariableType(benchmark::State& state) {
+  at::AutoNonVariableTypeMode guard(true);
+  auto a = at::ones({1});
+  auto b = at::ones({1});
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(at::add(a, b));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AddNoVariableType)->Name("autograd/add_no_variable_type");
+
+static void BM_Add(benchmark::State& state) {
+  auto a = at::ones({1});
+  auto b = at::ones({1});
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(at::add(a, b));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Add)->Name("autograd/add");
+
+// Also creates an AddBackward node and sets up the history of the output.
+static void BM_AddRequiresGrad(benchmark::State& state) {
+  auto a = at::ones({1}).requires_grad_(true);
+  auto b = at::ones({1});
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(at::add(a, b));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AddRequiresGrad)->Name("autograd/add_requires_grad");
+
+static const char* kScriptSource = R"JIT(
+def loop(n: int) -> int:
+    x = 0
+    for i in range(n):
+        x = x + i
+    return x
+
+def adds(x: Tensor, n: int) -> Tensor:
+    for _ in range(n):
+        x = x + x
+    return x
+)JIT";
+
+// The cost of an interpreter instruction: each iteration of the loop is a
+// handful of instructions on ints, without any dispatcher call.
+static void BM_InterpreterLoop(benchmark::State& state) {
+  auto cu = torch::jit::compile(kScriptSource);
+  auto& loop = cu->get_function("loop");
+  const int64_t n = state.range(0);
+  // Warm up, so the graph executor is done optimizing.
+  loop({n});
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(loop({n}));
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_InterpreterLoop)->Name("interpreter/int_loop")->Arg(1000);
+
+// The cost of a tensor op in TorchScript, to compare with autograd/add.
+static void BM_InterpreterAdds(benchmark::State& state) {
+  auto cu = torch::jit::compile(kScriptSource);
+  auto& adds = cu->get_function("adds");
+  const int64_t n = state.range(0);
+  auto x = at::ones({1});
+  adds({x, n});
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(adds({x, n}));
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_InterpreterAdds)->Name("interpreter/tensor_adds")->Arg(100);
+
+// The fixed cost of calling a method: method lookup, stack setup and
+// running an interpreter frame that only returns its input.
+static void BM_ModuleForward(benchmark::State& state) {
+  torch::jit::Module m("m");
+  m.define(R"JIT(
+    def forward(self, x):
+        return x
+  )JIT");
+  auto x = at::ones({1});
+  m.forward({x});
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(m.forward({x}));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ModuleForward)->Name("module/forward_identity");
+
+#ifdef USE_DISTRIBUTED
+// Everything an RPC of a builtin op does to the request and the response on
+// both ends, in one thread: building the ScriptCall message, wire
+// serialization and deserialization, parsing the request, running the op,
+// and the same for the ScriptResp. The agents live in libtorch_python, so
+// the transport and the thread pool hand-offs are not included.
+static void BM_RpcLoopback(benchmark::State& state) {
+  namespace rpc = torch::distributed::rpc;
+  auto op = torch::jit::getOperatorForLiteral(
+      "aten::add.Tensor(Tensor self, Tensor other, *, Scalar alpha=1) -> Tensor");
+  auto a = at::ones({1});
+  auto b = at::ones({1});
+  while (state.KeepRunning()) {
+    auto request =
+        rpc::ScriptCall(op, {a, b, 1}).toMessage();
+    auto requestWire = rpc::wireSerialize(request.payload(), request.tensors());
+    auto requestData =
+        rpc::wireDeserialize(requestWire.data(), requestWire.size());
+    rpc::Message received(
+        std::move(requestData.first),
+        std::move(requestData.second),
+        rpc::MessageType::SCRIPT_CALL);
+
+    auto call = rpc::deserializeRequest(received);
+    auto& scriptCall = static_cast<rpc::ScriptCall&>(*call);
+    auto& stack = scriptCall.stackRef();
+    scriptCall.op()->getOperation()(stack);
+
+    auto response = rpc::ScriptResp(std::move(stack.front())).toMessage();
+    auto responseWire =
+        rpc::wireSerialize(response.payload(), response.tensors());
+    auto responseData =
+        rpc::wireDeserialize(responseWire.data(), responseWire.size());
+    rpc::Message responseReceived(
+        std::move(responseData.first),
+        std::move(responseData.second),
+        rpc::MessageType::SCRIPT_RET);
+    benchmark::DoNotOptimize(rpc::deserializeRespToIValue(responseReceived));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RpcLoopback)->Name("rpc/add_loopback");
+#endif
+
+BENCHMARK_MAIN();
@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Converts an embedding table which is too large to be loaded at once, stored
+// as raw row major floats, to the fused 8-bit rowwise format of
+// FloatToFused8BitRowwiseQuantized. The table is memory mapped and converted
+// chunk_rows rows at a time, so that only a chunk of it and of the output are
+// resident at any time.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include <c10/util/Half.h>
+
+#include "caffe2/core/init.h"
+#include "caffe2/core/logging.h"
+#include "caffe2/core/timer.h"
+#include "caffe2/perfkernels/fused_8bit_rowwise_conversion.h"
+
+C10_DEFINE_string(input, "", "The table, as raw row major floats.");
+C10_DEFINE_string(output, "", "The fused 8-bit rowwise table to write.");
+C10_DEFINE_int(columns, 0, "The number of columns of the table.");
+C10_DEFINE_int(chunk_rows, 65536, "The number of rows converted at once.");
+C10_DEFINE_bool(
+    half_scale_bias,
+    false,
+    "Store the scales and biases as halves instead of floats.");
+
+namespace caffe2 {
+
+static int QuantizeEmbeddingTable(int argc, char** argv) {
+  GlobalInit(&argc, &argv);
+
+  CAFFE_ENFORCE(FLAGS_input.size(), "Must specify --input=/path/to/table.");
+  CAFFE_ENFORCE(FLAGS_output.size(), "Must specify --output=/path/to/table.");
+  CAFFE_ENFORCE_GT(FLAGS_columns, 0, "Must specify --columns.");
+  CAFFE_ENFORCE_GT(FLAGS_chunk_rows, 0);
+
+  int fd = open(FLAGS_input.c_str(), O_RDONLY);
+  CAFFE_ENFORCE_NE(fd, -1, "Cannot open input table: ", FLAGS_input);
+  struct stat st;
+  CAFFE_ENFORCE_EQ(fstat(fd, &st), 0, "Cannot stat ", FLAGS_input);
+  const size_t row_bytes = FLAGS_columns * sizeof(float);
+  CAFFE_ENFORCE_EQ(
+      st.st_size % row_bytes,
+      0,
+      "The size of ",
+      FLAGS_input,
+      " is not a multiple of the size of a row of ",
+      FLAGS_columns,
+      " floats");
+  const int64_t rows = st.st_size / row_bytes;
+  const int output_columns = FLAGS_columns +
+      2 * (FLAGS_half_scale_bias ? sizeof(at::Half) : sizeof(float));
+
+  const char* table = nullptr;
+  if (st.st_size > 0) {
+    void* ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    CAFFE_ENFORCE(ptr != MAP_FAILED, "Cannot map ", FLAGS_input);
+    table = static_cast<const char*>(ptr);
+    madvise(ptr, st.st_size, MADV_SEQUENTIAL);
+  }
+  close(fd);
+
+  FILE* out = fopen(FLAGS_output.c_str(), "wb");
+  CAFFE_ENFORCE(out, "Cannot open output table: ", FLAGS_output);
+  std::vector<uint8_t> buffer((size_t)FLAGS_chunk_rows * output_columns);
+
+  Timer timer;
+  for (int64_t begin = 0; begin < rows; begin += FLAGS_chunk_rows) {
+    const int chunk_rows = std::min<int64_t>(FLAGS_chunk_rows, rows - begin);
+    const char* chunk = table + begin * row_bytes;
+    const float* input = reinterpret_cast<const float*>(chunk);
+    if (FLAGS_half_scale_bias) {
+      FloatToFused8BitRowwiseQuantizedSBHalf(
+          input, chunk_rows, FLAGS_columns, buffer.data());
+    } else {
+      FloatToFused8BitRowwiseQuantized(
+          input, chunk_rows, FLAGS_columns, buffer.data());
+    }
+    const size_t bytes = (size_t)chunk_rows * output_columns;
+    CAFFE_ENFORCE_EQ(
+        fwrite(buffer.data(), 1, bytes, out),
+        bytes,
+        "Cannot write to ",
+        FLAGS_output);
+    // The converted rows are not read again, drop their pages
+    const uintptr_t page = sysconf(_SC_PAGESIZE);
+    const uintptr_t start = reinterpret_cast<uintptr_t>(chunk) / page * page;
+    madvise(
+        reinterpret_cast<void*>(start),
+        reinterpret_cast<uintptr_t>(chunk) + chunk_rows * row_bytes - start,
+        MADV_DONTNEED);
+  }
+  CAFFE_ENFORCE_EQ(fclose(out), 0, "Cannot write to ", FLAGS_output);
+  if (table) {
+    munmap(const_cast<char*>(table), st.st_size);
+  }
+  LOG(INFO) << "Converted " << rows << " rows of " << FLAGS_columns
+            << " columns in " << timer.Seconds() << " seconds";
+  return 0;
+}
+
+} // namespace caffe2
+
+int main(int argc, char** argv) {
+  return caffe2::QuantizeEmbeddingTable(argc, argv);
+}
@@ -14,13 +14,22 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "ATen/ATen.h"
+#include "ATen/core/dispatch/Dispatcher.h"
+#include "ATen/native/quantized/cpu/conv_packed_params.h"
 #include "caffe2/core/timer.h"
 #include "caffe2/utils/string_utils.h"
 #include "torch/csrc/autograd/grad_mode.h"
+#include "torch/csrc/autograd/profiler.h"
+#include "torch/csrc/autograd/record_function.h"
 #include "torch/csrc/jit/serialization/import.h"
 #include "torch/script.h"
 
@@ -62,6 +71,24 @@ C10_DEFINE_bool(
   "Whether to print performance stats for AI-PEP.");
 
 C10_DEFINE_int(pytext_len, 0, "Length of input sequence.");
+C10_DEFINE_string(
+    perf_events,
+    "",
+    "If set, run the iterations once more under the autograd profiler and "
+    "report these comma separated hardware counters (Linux only, e.g. "
+    "cycles,instructions,cache_misses,branch_misses) per operator.");
+C10_DEFINE_string(
+    qengines,
+    "",
+    "If set, benchmark the model with each of these comma separated "
+    "quantized engines (e.g. fbgemm,qnnpack), loading it anew for every "
+    "engine. Uses the default engine otherwise.");
+C10_DEFINE_bool(
+    report_op_stats,
+    false,
+    "Whether to run the iterations once more and report the latency of every "
+    "operator, with the GOPS and memory bandwidth of the quantized linear and "
+    "convolution operators.");
 
 std::vector<std::string>
 split(char separator, const std::string& string, bool ignore_empty = true) {
@@ -149,6 +176,313 @@ std::vector<c10::IValue> create_inputs() {
   return inputs;
 }
 
+struct OpStats {
+  int64_t count = 0;
+  double cpu_us = 0;
+  std::vector<uint64_t> counters;
+};
+
+// Runs the model under the autograd profiler with FLAGS_perf_events and
+// prints the wall time and counters of every operator, summed over all
+// calls. Counters of nested operators are included in their callers.
+void report_perf_counters(
+    torch::jit::Module& module,
+    const std::vector<c10::IValue>& inputs) {
+  namespace profiler = torch::autograd::profiler;
+  const std::vector<std::string> events = split(',', FLAGS_perf_events);
+  profiler::enableProfiler(profiler::ProfilerConfig(
+      profiler::ProfilerState::CPU, false, false, events));
+  for (int i = 0; i < FLAGS_iter; ++i) {
+    module.forward(inputs);
+  }
+  auto thread_events = profiler::disableProfiler();
+
+  std::map<std::string, OpStats> stats;
+  for (auto& thread : thread_events) {
+    std::vector<profiler::Event*> stack;
+    for (auto& e : thread) {
+      if (e.kind() == "push") {
+        stack.push_back(&e);
+      } else if (e.kind() == "pop" && !stack.empty()) {
+        profiler::Event* start = stack.back();
+        stack.pop_back();
+        auto& op = stats[start->name()];
+        op.count += 1;
+        op.cpu_us += start->cpu_elapsed_us(e);
+        if (start->perf_counters().size() != events.size() ||
+            e.perf_counters().size() != events.size()) {
+          continue;
+        }
+        op.counters.resize(events.size());
+        for (size_t j = 0; j < events.size(); ++j) {
+          op.counters[j] += e.perf_counters()[j] - start->perf_counters()[j];
+        }
+      }
+    }
+  }
+
+  auto index_of = [&](const char* name) -> int {
+    auto it = std::find(events.begin(), events.end(), name);
+    return it == events.end() ? -1 : it - events.begin();
+  };
+  const int cycles = index_of("cycles");
+  const int instructions = index_of("instructions");
+  const int cache_misses = index_of("cache_misses");
+  auto ratio = [](double num, uint64_t den) {
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(2) << num / std::max<uint64_t>(den, 1);
+    return ss.str();
+  };
+
+  std::cout << std::left << std::setw(40) << "Operator" << std::setw(10)
+            << "Calls" << std::setw(15) << "CPU total (us)";
+  for (const auto& name : events) {
+    std::cout << std::setw(18) << name;
+  }
+  if (cycles >= 0 && instructions >= 0) {
+    std::cout << std::setw(8) << "IPC";
+  }
+  if (cache_misses >= 0 && instructions >= 0) {
+    std::cout << std::setw(10) << "LLC MPKI";
+  }
+  std::cout << std::endl;
+  for (const auto& kv : stats) {
+    const auto& op = kv.second;
+    std::cout << std::left << std::setw(40) << kv.first << std::setw(10)
+              << op.count << std::setw(15) << op.cpu_us;
+    if (op.counters.empty()) {
+      std::cout << std::endl;
+      continue;
+    }
+    for (auto count : op.counters) {
+      std::cout << std::setw(18) << count;
+    }
+    if (cycles >= 0 && instructions >= 0) {
+      std::cout << std::setw(8)
+                << ratio(op.counters[instructions], op.counters[cycles]);
+    }
+    if (cache_misses >= 0 && instructions >= 0) {
+      std::cout << std::setw(10)
+                << ratio(
+                       1000.0 * op.counters[cache_misses],
+                       op.counters[instructions]);
+    }
+    std::cout << std::endl;
+  }
+}
+
+// The work of one operator call: the multiply-adds, counted as two
+// operations, and the bytes of its inputs, weights and outputs. ops is 0 for
+// the operators whose arithmetic is not known.
+struct OpWork {
+  double ops = 0;
+  double bytes = 0;
+};
+
+struct OpLatency {
+  int64_t count = 0;
+  double us = 0;
+  OpWork work;
+};
+
+double tensor_bytes(const at::Tensor& t) {
+  return t.defined() && t.has_storage() ? t.numel() * t.element_size() : 0;
+}
+
+// Estimates the work of the quantized linear and convolution operators from
+// their inputs, and counts the input bytes of every other operator. The
+// weight shapes are unpacked once per packed weight.
+class OpWorkEstimator {
+ public:
+  OpWork estimate(
+      const std::string& name,
+      const std::vector<c10::IValue>& inputs) {
+    if (name.rfind("quantized::linear", 0) == 0 && inputs.size() >= 2 &&
+        inputs[0].isTensor() && inputs[1].isTensor()) {
+      return linear(name, inputs[0].toTensor(), inputs[1].toTensor());
+    }
+    if (name.rfind("quantized::conv3d", 0) == 0) {
+      return conv<3>(name, inputs);
+    }
+    if (name.rfind("quantized::conv", 0) == 0) {
+      return conv<2>(name, inputs);
+    }
+    OpWork work;
+    for (const auto& input : inputs) {
+      if (input.isTensor()) {
+        work.bytes += tensor_bytes(input.toTensor());
+      }
+    }
+    return work;
+  }
+
+ private:
+  OpWork linear(
+      const std::string& name,
+      const at::Tensor& input,
+      const at::Tensor& packed_weight) {
+    OpWork work;
+    const bool fp16 = name.find("fp16") != std::string::npos;
+    const void* key = packed_weight.unsafeGetTensorImpl();
+    auto it = weight_sizes_.find(key);
+    if (it == weight_sizes_.end()) {
+      auto op = c10::Dispatcher::singleton().findSchemaOrThrow(
+          fp16 ? "quantized::linear_unpack_fp16" : "quantized::linear_unpack",
+          "");
+      auto weight = std::get<0>(
+          op.callUnboxed<
+              std::tuple<at::Tensor, c10::optional<at::Tensor>>,
+              const at::Tensor&>(packed_weight));
+      it = weight_sizes_
+               .emplace(
+                   key, WeightInfo{weight.sizes().vec(), tensor_bytes(weight)})
+               .first;
+    }
+    const auto& weight = it->second;
+    if (weight.sizes.size() != 2 || input.dim() < 1) {
+      return work;
+    }
+    const double N = weight.sizes[0];
+    const double K = weight.sizes[1];
+    const double M = input.numel() / std::max<double>(K, 1);
+    // The dynamic operators have float outputs.
+    const bool dynamic = name.find("dynamic") != std::string::npos;
+    work.ops = 2 * M * N * K;
+    work.bytes = tensor_bytes(input) + weight.bytes + M * N * (dynamic ? 4 : 1);
+    return work;
+  }
+
+  template <int kSpatialDim>
+  OpWork conv(const std::string& name, const std::vector<c10::IValue>& inputs) {
+    OpWork work;
+    if (inputs.empty() || !inputs[0].isTensor()) {
+      return work;
+    }
+    const at::Tensor& input = inputs[0].toTensor();
+    auto packed = std::find_if(
+        inputs.begin(), inputs.end(), [](const c10::IValue& v) {
+          return v.isObject();
+        });
+    if (packed == inputs.end() || input.dim() != kSpatialDim + 2) {
+      return work;
+    }
+    auto params =
+        packed->template toCustomClass<ConvPackedParamsBase<kSpatialDim>>();
+    const void* key = params.get();
+    auto it = weight_sizes_.find(key);
+    if (it == weight_sizes_.end()) {
+      auto weight = std::get<0>(params->unpack());
+      it = weight_sizes_
+               .emplace(
+                   key, WeightInfo{weight.sizes().vec(), tensor_bytes(weight)})
+               .first;
+    }
+    const auto& weight = it->second;
+    const auto stride = params->stride();
+    const auto padding = params->padding();
+    const auto dilation = params->dilation();
+    // O x C / groups x kernel
+    double macs_per_output = weight.sizes[1];
+    double outputs = input.size(0) * weight.sizes[0];
+    for (int i = 0; i < kSpatialDim; ++i) {
+      const int64_t kernel = weight.sizes[i + 2];
+      macs_per_output *= kernel;
+      outputs *= (input.size(i + 2) + 2 * padding[i] -
+                  dilation[i] * (kernel - 1) - 1) /
+              stride[i] +
+          1;
+    }
+    work.ops = 2 * outputs * macs_per_output;
+    work.bytes = tensor_bytes(input) + weight.bytes + outputs;
+    // The accumulator of conv2d_add is read once more.
+    if (name.find("_add") != std::string::npos) {
+      work.bytes += outputs;
+    }
+    return work;
+  }
+
+  struct WeightInfo {
+    std::vector<int64_t> sizes;
+    double bytes;
+  };
+  std::unordered_map<const void*, WeightInfo> weight_sizes_;
+};
+
+// Runs the model once more with RecordFunction callbacks timing every
+// operator, and prints their latency, summed over all calls, with the GOPS and
+// GB/s achieved by the operators of known work. Nested operators are included
+// in the latency of their callers.
+void report_op_stats(
+    torch::jit::Module& module,
+    const std::vector<c10::IValue>& inputs) {
+  namespace profiler = torch::autograd::profiler;
+  struct Call {
+    high_resolution_clock::time_point start;
+    OpWork work;
+  };
+  static thread_local std::vector<Call> calls;
+  std::mutex mutex;
+  std::map<std::string, OpLatency> stats;
+  OpWorkEstimator estimator;
+
+  profiler::pushCallback(
+      [&](const profiler::RecordFunction& fn) {
+        OpWork work;
+        {
+          // The weights are unpacked with operators of their own.
+          profiler::DisableRecordFunctionGuard no_observers;
+          std::lock_guard<std::mutex> lock(mutex);
+          work = estimator.estimate(fn.name().str(), fn.inputs());
+        }
+        calls.push_back({high_resolution_clock::now(), work});
+        return true;
+      },
+      [&](const profiler::RecordFunction& fn) {
+        const auto stop = high_resolution_clock::now();
+        if (calls.empty()) {
+          return;
+        }
+        const Call call = calls.back();
+        calls.pop_back();
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& op = stats[fn.name().str()];
+        op.count += 1;
+        op.us += duration_cast<duration<double, std::micro>>(stop - call.start)
+                     .count();
+        op.work.ops += call.work.ops;
+        op.work.bytes += call.work.bytes;
+      },
+      /* needs_inputs */ true);
+  for (int i = 0; i < FLAGS_iter; ++i) {
+    module.forward(inputs);
+  }
+  profiler::popCallback();
+
+  std::vector<std::pair<std::string, OpLatency>> sorted(
+      stats.begin(), stats.end());
+  std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+    return a.second.us > b.second.us;
+  });
+  auto per_us = [](double amount, double us) {
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(2)
+       << amount / 1000 / std::max(us, 1e-3);
+    return ss.str();
+  };
+  std::cout << std::left << std::setw(40) << "Operator" << std::setw(10)
+            << "Calls" << std::setw(15) << "Total (us)" << std::setw(12)
+            << "Avg (us)" << std::setw(10) << "GOPS" << std::setw(10) << "GB/s"
+            << std::endl;
+  for (const auto& kv : sorted) {
+    const auto& op = kv.second;
+    std::cout << std::left << std::setw(40) << kv.first << std::setw(10)
+              << op.count << std::setw(15) << op.us << std::setw(12)
+              << op.us / std::max<int64_t>(op.count, 1) << std::setw(10)
+              << (op.work.ops > 0 ? per_us(op.work.ops, op.us) : "-")
+              << std::setw(10) << per_us(op.work.bytes, op.us) << std::endl;
+  }
+}
+
 int main(int argc, char** argv) {
   c10::SetUsageMessage(
     "Run speed benchmark for pytorch model.\n"
@@ -157,78 +491,125 @@ int main(int argc, char** argv) {
     " --model=<model_file>"
     " --use_bundled_input=0"
     " --warmup=5"
-    " --iter=20");
+    " --iter=20\n"
+    "Quantized models can be compared across engines with"
+    " --qengines=fbgemm,qnnpack --report_op_stats");
   if (!c10::ParseCommandLineFlags(&argc, &argv)) {
     std::cerr << "Failed to parse command line flags!" << std::endl;
     return 1;
   }
 
-  std::vector<c10::IValue> inputs = create_inputs();
+  const std::vector<c10::IValue> created_inputs = create_inputs();
+  // The packed weights of quantized models are created for the engine that is
+  // current when the model is loaded.
+  std::vector<std::string> qengines = split(',', FLAGS_qengines);
+  if (qengines.empty()) {
+    qengines.push_back("");
+  }
+  std::vector<std::pair<std::string, double>> qengine_millis;
 
   torch::autograd::AutoGradMode guard(false);
   torch::jit::GraphOptimizerEnabledGuard no_optimizer_guard(false);
-  auto module = torch::jit::load(FLAGS_model);
+  for (const auto& qengine : qengines) {
+    if (!qengine.empty()) {
+      const auto& supported = at::globalContext().supportedQEngines();
+      auto it = std::find_if(
+          supported.begin(), supported.end(), [&](at::QEngine e) {
+            std::string name = c10::toString(e);
+            std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+            return name == qengine;
+          });
+      if (it == supported.end()) {
+        std::cerr << "Quantized engine " << qengine
+                  << " is not supported by this build." << std::endl;
+        return 1;
+      }
+      at::globalContext().setQEngine(*it);
+      std::cout << "Benchmarking with quantized engine " << qengine << "."
+                << std::endl;
+    }
 
-  if (FLAGS_use_bundled_input >= 0) {
-    auto get_method = module.find_method("get_all_bundled_inputs");
-    if (!get_method) {
-      std::cerr << "Model does not have bundled inputs.  Before saving," << std::endl
-        << "use torch.utils.bundled_inputs.augment_model_with_bundled_inputs." << std::endl;
-      return 1;
+    std::vector<c10::IValue> inputs = created_inputs;
+    auto module = torch::jit::load(FLAGS_model);
+
+    if (FLAGS_use_bundled_input >= 0) {
+      auto get_method = module.find_method("get_all_bundled_inputs");
+      if (!get_method) {
+        std::cerr << "Model does not have bundled inputs.  Before saving," << std::endl
+          << "use torch.utils.bundled_inputs.augment_model_with_bundled_inputs." << std::endl;
+        return 1;
+      }
+
+      auto all_inputs = (*get_method)({}).toList();
+      if (FLAGS_use_bundled_input >= all_inputs.size()) {
+        // NOTE: This check is only to make the error message nicer.
+        // The get call below does internal bounds checking.
+        std::cerr << "Model has only " << all_inputs.size() << " bundled inputs." << std::endl;
+        return 1;
+      }
+      inputs = all_inputs.get(FLAGS_use_bundled_input).toTuple()->elements();
     }
 
-    auto all_inputs = (*get_method)({}).toList();
-    if (FLAGS_use_bundled_input >= all_inputs.size()) {
-      // NOTE: This check is only to make the error message nicer.
-      // The get call below does internal bounds checking.
-      std::cerr << "Model has only " << all_inputs.size() << " bundled inputs." << std::endl;
-      return 1;
+    module.eval();
+    if (FLAGS_print_output) {
+      std::cout << module.forward(inputs) << std::endl;
     }
-    inputs = all_inputs.get(FLAGS_use_bundled_input).toTuple()->elements();
-  }
 
-  module.eval();
-  if (FLAGS_print_output) {
-    std::cout << module.forward(inputs) << std::endl;
-  }
+    std::cout << "Starting benchmark." << std::endl;
+    std::cout << "Running warmup runs." << std::endl;
+    CAFFE_ENFORCE(
+        FLAGS_warmup >= 0,
+        "Number of warm up runs should be non negative, provided ",
+        FLAGS_warmup,
+        ".");
+    for (int i = 0; i < FLAGS_warmup; ++i) {
+      module.forward(inputs);
+    }
 
-  std::cout << "Starting benchmark." << std::endl;
-  std::cout << "Running warmup runs." << std::endl;
-  CAFFE_ENFORCE(
-      FLAGS_warmup >= 0,
-      "Number of warm up runs should be non negative, provided ",
-      FLAGS_warmup,
-      ".");
-  for (int i = 0; i < FLAGS_warmup; ++i) {
-    module.forward(inputs);
-  }
+    std::cout << "Main runs." << std::endl;
+    CAFFE_ENFORCE(
+        FLAGS_iter >= 0,
+        "Number of main runs should be non negative, provided ",
+        FLAGS_iter,
+        ".");
+    caffe2::Timer timer;
+    std::vector<float> times;
+    auto millis = timer.MilliSeconds();
+    for (int i = 0; i < FLAGS_iter; ++i) {
+      auto start = high_resolution_clock::now();
+      module.forward(inputs);
+      auto stop = high_resolution_clock::now();
+      auto duration = duration_cast<milliseconds>(stop - start);
+      times.push_back(duration.count());
+    }
+    millis = timer.MilliSeconds();
+    if (FLAGS_report_pep) {
+      for (auto t : times) {
+        std::cout << "PyTorchObserver {\"type\": \"NET\", \"unit\": \"us\", \"metric\": \"latency\", \"value\": \"" << t << "\"}" << std::endl;
+      }
+    }
+    std::cout << "Main run finished. Milliseconds per iter: "
+              << millis / FLAGS_iter
+              << ". Iters per second: " << 1000.0 * FLAGS_iter / millis
+              << std::endl;
+    qengine_millis.emplace_back(qengine, millis / FLAGS_iter);
 
-  std::cout << "Main runs." << std::endl;
-  CAFFE_ENFORCE(
-      FLAGS_iter >= 0,
-      "Number of main runs should be non negative, provided ",
-      FLAGS_iter,
-      ".");
-  caffe2::Timer timer;
-  std::vector<float> times;
-  auto millis = timer.MilliSeconds();
-  for (int i = 0; i < FLAGS_iter; ++i) {
-    auto start = high_resolution_clock::now();
-    module.forward(inputs);
-    auto stop = high_resolution_clock::now();
-    auto duration = duration_cast<milliseconds>(stop - start);
-    times.push_back(duration.count());
+    if (!FLAGS_perf_events.empty()) {
+      report_perf_counters(module, inputs);
+    }
+    if (FLAGS_report_op_stats) {
+      report_op_stats(module, inputs);
+    }
   }
-  millis = timer.MilliSeconds();
-  if (FLAGS_report_pep) {
-    for (auto t : times) {
-      std::cout << "PyTorchObserver {\"type\": \"NET\", \"unit\": \"us\", \"metric\": \"latency\", \"value\": \"" << t << "\"}" << std::endl;
+
+  if (qengine_millis.size() > 1) {
+    std::cout << std::left << std::setw(16) << "Quantized engine"
+              << "Milliseconds per iter" << std::endl;
+    for (const auto& kv : qengine_millis) {
+      std::cout << std::left << std::setw(16) << kv.first << kv.second
+                << std::endl;
     }
   }
-  std::cout << "Main run finished. Milliseconds per iter: "
-            << millis / FLAGS_iter
-            << ". Iters per second: " << 1000.0 * FLAGS_iter / millis
-            << std::endl;
 
   return 0;
 }
@@ -0,0 +1,384 @@
+// Benchmarks of the TensorIterator based unary, binary and reduction ops
+// across dtypes, memory layouts and sizes, without any Python overhead.
+//
+// Every case is named <kind>/<op>/<dtype>/<layout>/<numel>, e.g.
+// binary/add/float/broadcast/1048576, and the names don't change between
+// runs, so that two runs can be compared case by case:
+//
+//   ./tensoriterator_op_benchmark --benchmark_out=base.json \
+//       --benchmark_out_format=json
+//   ./tensoriterator_op_benchmark --benchmark_out=new.json \
+//       --benchmark_out_format=json
+//   python binaries/compare_op_benchmarks.py base.json new.json
+//
+// Use --benchmark_filter to select cases with a regex and --max_numel to
+// skip the large ones. The layouts are:
+//
+//   contiguous     a 1-D contiguous tensor.
+//   strided        every other element of a 1-D tensor.
+//   channels_last  a {1, 16, 1, numel / 16} tensor in channels_last format.
+//   broadcast      binary ops only: a {rows, cols} tensor with a {1, cols}
+//                  one.
+//
+// Reductions reduce all elements ("reduce") or the last dimension of a
+// {rows, cols} tensor ("reduce_dim").
+
+#include "benchmark/benchmark.h"
+
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <c10/util/Flags.h>
+#include <c10/util/string_utils.h>
+
+#include <functional>
+#include <numeric>
+#include <string>
+#include <vector>
+
+C10_DEFINE_int64(max_numel, 100000000, "Skip cases with more elements");
+C10_DEFINE_bool(
+    small_only,
+    false,
+    "Only run cases with at most 1024 elements, to check op overheads");
+
+namespace {
+
+const std::vector<int64_t> kSizes =
+    {1, 16, 1024, 65536, 1 << 20, 1 << 24, 100000000};
+
+const std::vector<at::ScalarType> kDtypes =
+    {at::kFloat, at::kDouble, at::kInt, at::kLong};
+
+using UnaryFn = std::function<at::Tensor(const at::Tensor&)>;
+using BinaryFn = std::function<at::Tensor(const at::Tensor&, const at::Tensor&)>;
+
+struct UnaryOp {
+  std::string name;
+  UnaryFn fn;
+  bool floating_only;
+};
+
+struct BinaryOp {
+  std::string name;
+  BinaryFn fn;
+  bool floating_only;
+};
+
+const std::vector<UnaryOp>& unaryOps() {
+  static const std::vector<UnaryOp> ops = {
+      {"abs", [](const at::Tensor& a) { return at::abs(a); }, false},
+      {"neg", [](const at::Tensor& a) { return at::neg(a); }, false},
+      {"bitwise_not",
+       [](const at::Tensor& a) { return at::bitwise_not(a); },
+       false},
+      {"ceil", [](const at::Tensor& a) { return at::ceil(a); }, true},
+      {"exp", [](const at::Tensor& a) { return at::exp(a); }, true},
+      {"log", [](const at::Tensor& a) { return at::log(a); }, true},
+      {"sqrt", [](const at::Tensor& a) { return at::sqrt(a); }, true},
+      {"rsqrt", [](const at::Tensor& a) { return at::rsqrt(a); }, true},
+      {"sin", [](const at::Tensor& a) { return at::sin(a); }, true},
+      {"tanh", [](const at::Tensor& a) { return at::tanh(a); }, true},
+      {"sigmoid", [](const at::Tensor& a) { return at::sigmoid(a); }, true},
+      {"relu", [](const at::Tensor& a) { return at::relu(a); }, true},
+      {"clone", [](const at::Tensor& a) { return a.clone(); }, false},
+      {"to_double",
+       [](const at::Tensor& a) { return a.to(at::kDouble); },
+       false},
+  };
+  return ops;
+}
+
+const std::vector<BinaryOp>& binaryOps() {
+  static const std::vector<BinaryOp> ops = {
+      {"add",
+       [](const at::Tensor& a, const at::Tensor& b) { return at::add(a, b); },
+       false},
+      {"sub",
+       [](const at::Tensor& a, const at::Tensor& b) { return at::sub(a, b); },
+       false},
+      {"mul",
+       [](const at::Tensor& a, const at::Tensor& b) { return at::mul(a, b); },
+       false},
+      {"div",
+       [](const at::Tensor& a, const at::Tensor& b) { return at::div(a, b); },
+       true},
+      {"pow",
+       [](const at::Tensor& a, const at::Tensor& b) { return at::pow(a, b); },
+       true},
+      {"max",
+       [](const at::Tensor& a, const at::Tensor& b) { return at::max(a, b); },
+       false},
+      {"lt",
+       [](const at::Tensor& a, const at::Tensor& b) { return at::lt(a, b); },
+       false},
+      {"bitwise_and",
+       [](const at::Tensor& a, const at::Tensor& b) {
+         return at::bitwise_and(a, b);
+       },
+       false},
+      {"copy_",
+       [](const at::Tensor& a, const at::Tensor& b) {
+         return at::empty_like(a).copy_(b);
+       },
+       false},
+  };
+  return ops;
+}
+
+const std::vector<UnaryOp>& reductionOps() {
+  static const std::vector<UnaryOp> ops = {
+      {"sum", [](const at::Tensor& a) { return at::sum(a); }, false},
+      {"prod", [](const at::Tensor& a) { return at::prod(a); }, false},
+      {"mean", [](const at::Tensor& a) { return at::mean(a); }, true},
+      {"norm", [](const at::Tensor& a) { return at::norm(a); }, true},
+      {"max", [](const at::Tensor& a) { return at::max(a); }, false},
+      {"argmax", [](const at::Tensor& a) { return at::argmax(a); }, false},
+  };
+  return ops;
+}
+
+const std::vector<UnaryOp>& dimReductionOps() {
+  static const std::vector<UnaryOp> ops = {
+      {"sum", [](const at::Tensor& a) { return at::sum(a, {-1}); }, false},
+      {"mean", [](const at::Tensor& a) { return at::mean(a, {-1}); }, true},
+      {"norm", [](const at::Tensor& a) { return at::norm(a, 2, {-1}); }, true},
+      {"argmax", [](const at::Tensor& a) { return at::argmax(a, -1); }, false},
+  };
+  return ops;
+}
+
+std::string dtypeName(at::ScalarType dtype) {
+  switch (dtype) {
+    case at::kFloat:
+      return "float";
+    case at::kDouble:
+      return "double";
+    case at::kInt:
+      return "int32";
+    case at::kLong:
+      return "int64";
+    default:
+      return c10::toString(dtype);
+  }
+}
+
+// The number of columns of the {rows, cols} shape of the broadcast and
+// reduce_dim cases.
+int64_t numCols(int64_t numel) {
+  int64_t a = numel;
+  int64_t b = 1024;
+  while (b != 0) {
+    const int64_t t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+// Positive values, so that log, sqrt and pow are well defined, and no zeros
+// for integer division.
+at::Tensor makeValues(at::IntArrayRef sizes, at::ScalarType dtype) {
+  if (at::isFloatingType(dtype)) {
+    return at::rand(sizes, at::dtype(dtype)).add_(0.5);
+  }
+  return at::randint(1, 100, sizes, at::dtype(dtype));
+}
+
+at::Tensor makeInput(
+    int64_t numel,
+    at::ScalarType dtype,
+    const std::string& layout) {
+  if (layout == "strided") {
+    return makeValues({2 * numel}, dtype).slice(0, 0, 2 * numel, 2);
+  }
+  if (layout == "channels_last") {
+    return makeValues({1, 16, 1, numel / 16}, dtype)
+        .contiguous(at::MemoryFormat::ChannelsLast);
+  }
+  if (layout == "rows") {
+    const int64_t cols = numCols(numel);
+    return makeValues({numel / cols, cols}, dtype);
+  }
+  return makeValues({numel}, dtype);
+}
+
+int64_t bytes(const at::Tensor& t) {
+  return t.numel() * t.element_size();
+}
+
+void setCounters(benchmark::State& state, int64_t numel, int64_t num_bytes) {
+  state.SetItemsProcessed(state.iterations() * numel);
+  state.SetBytesProcessed(state.iterations() * num_bytes);
+  state.counters["threads"] = at::get_num_threads();
+}
+
+bool skipped(int64_t numel) {
+  return numel > FLAGS_max_numel || (FLAGS_small_only && numel > 1024);
+}
+
+void registerCase(
+    const std::string& name,
+    std::function<void(benchmark::State&)> fn) {
+  benchmark::RegisterBenchmark(
+      name.c_str(), [fn](benchmark::State& state) { fn(state); })
+      ->Unit(benchmark::kMicrosecond);
+}
+
+std::string caseName(
+    const std::string& kind,
+    const std::string& op,
+    at::ScalarType dtype,
+    const std::string& layout,
+    int64_t numel) {
+  return kind + "/" + op + "/" + dtypeName(dtype) + "/" + layout + "/" +
+      c10::to_string(numel);
+}
+
+void registerUnaryCases() {
+  for (const auto& op : unaryOps()) {
+    for (const auto dtype : kDtypes) {
+      if (op.floating_only && !at::isFloatingType(dtype)) {
+        continue;
+      }
+      if (op.name == "bitwise_not" && at::isFloatingType(dtype)) {
+        continue;
+      }
+      for (const std::string layout : {"contiguous", "strided", "channels_last"}) {
+        for (const auto numel : kSizes) {
+          if (skipped(numel) || (layout == "channels_last" && numel < 16)) {
+            continue;
+          }
+          const auto fn = op.fn;
+          registerCase(
+              caseName("unary", op.name, dtype, layout, numel),
+              [=](benchmark::State& state) {
+                const auto a = makeInput(numel, dtype, layout);
+                at::Tensor out;
+                while (state.KeepRunning()) {
+                  out = fn(a);
+                  benchmark::DoNotOptimize(out.data_ptr());
+                }
+                setCounters(state, numel, bytes(a) + bytes(out));
+              });
+        }
+      }
+    }
+  }
+}
+
+void registerBinaryCases() {
+  for (const auto& op : binaryOps()) {
+    for (const auto dtype : kDtypes) {
+      if (op.floating_only && !at::isFloatingType(dtype)) {
+        continue;
+      }
+      if (op.name == "bitwise_and" && at::isFloatingType(dtype)) {
+        continue;
+      }
+      for (const std::string layout :
+           {"contiguous", "strided", "channels_last", "broadcast"}) {
+        for (const auto numel : kSizes) {
+          if (skipped(numel) || (layout == "channels_last" && numel < 16)) {
+            continue;
+          }
+          const auto fn = op.fn;
+          registerCase(
+              caseName("binary", op.name, dtype, layout, numel),
+              [=](benchmark::State& state) {
+                at::Tensor a;
+                at::Tensor b;
+                if (layout == "broadcast") {
+                  a = makeInput(numel, dtype, "rows");
+                  b = makeValues({1, a.size(1)}, dtype);
+                  if (op.name == "copy_") {
+                    b = b.expand_as(a);
+                  }
+                } else {
+                  a = makeInput(numel, dtype, layout);
+                  b = makeInput(numel, dtype, layout);
+                }
+                at::Tensor out;
+                while (state.KeepRunning()) {
+                  out = fn(a, b);
+                  benchmark::DoNotOptimize(out.data_ptr());
+                }
+                setCounters(state, numel, bytes(a) + bytes(b) + bytes(out));
+              });
+        }
+      }
+    }
+  }
+}
+
+void registerReductionCases() {
+  for (const auto& op : reductionOps()) {
+    for (const auto dtype : kDtypes) {
+      if (op.floating_only && !at::isFloatingType(dtype)) {
+        continue;
+      }
+      for (const std::string layout : {"contiguous", "strided", "channels_last"}) {
+        for (const auto numel : kSizes) {
+          if (skipped(numel) || (layout == "channels_last" && numel < 16)) {
+            continue;
+          }
+          const auto fn = op.fn;
+          registerCase(
+              caseName("reduce", op.name, dtype, layout, numel),
+              [=](benchmark::State& state) {
+                const auto a = makeInput(numel, dtype, layout);
+                while (state.KeepRunning()) {
+                  auto out = fn(a);
+                  benchmark::DoNotOptimize(out.data_ptr());
+                }
+                setCounters(state, numel, bytes(a));
+              });
+        }
+      }
+    }
+  }
+  for (const auto& op : dimReductionOps()) {
+    for (const auto dtype : kDtypes) {
+      if (op.floating_only && !at::isFloatingType(dtype)) {
+        continue;
+      }
+      // "strided" reduces the last dimension of a transposed tensor, i.e.
+      // along the outer dimension of its memory.
+      for (const std::string layout : {"contiguous", "strided"}) {
+        for (const auto numel : kSizes) {
+          if (skipped(numel)) {
+            continue;
+          }
+          const auto fn = op.fn;
+          registerCase(
+              caseName("reduce_dim", op.name, dtype, layout, numel),
+              [=](benchmark::State& state) {
+                auto a = makeInput(numel, dtype, "rows");
+                if (layout == "strided") {
+                  a = a.t();
+                }
+                while (state.KeepRunning()) {
+                  auto out = fn(a);
+                  benchmark::DoNotOptimize(out.data_ptr());
+                }
+                setCounters(state, numel, bytes(a));
+              });
+        }
+      }
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  // Google benchmark removes its own flags, the rest are c10 flags.
+  benchmark::Initialize(&argc, argv);
+  if (!c10::ParseCommandLineFlags(&argc, &argv)) {
+    return 1;
+  }
+  registerUnaryCases();
+  registerBinaryCases();
+  registerReductionCases();
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
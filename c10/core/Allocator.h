@@ -214,4 +214,25 @@ struct AllocatorRegisterer {
   static AllocatorRegisterer<t> g_allocator_d(f); \
   }
 
+// An interface for reporting allocations to a memory profiler (e.g. the
+// autograd profiler). While a reporter is set, allocators call
+// reportMemoryUsageToProfiler with a positive size for every allocation and
+// with the negated size when it is freed, on the thread doing it.
+struct C10_API MemoryReportingInfoBase {
+  virtual ~MemoryReportingInfoBase() = default;
+  virtual void reportMemoryUsage(
+      void* ptr,
+      int64_t alloc_size,
+      Device device) = 0;
+};
+
+// The reporter is expected to have static lifetime; pass nullptr to stop
+// reporting.
+C10_API void SetMemoryReporter(MemoryReportingInfoBase* reporter);
+C10_API bool memoryProfilingEnabled();
+C10_API void reportMemoryUsageToProfiler(
+    void* ptr,
+    int64_t alloc_size,
+    Device device);
+
 } // namespace c10
@@ -1,6 +1,16 @@
 #include <c10/core/CPUAllocator.h>
 #include <c10/core/DeviceType.h>
 
+#include <algorithm>
+#include <atomic>
+
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <sys/mman.h>
+#if defined(MADV_HUGEPAGE)
+#define C10_CPU_HUGE_PAGES
+#endif
+#endif
+
 // TODO: rename flags to C10
 C10_DEFINE_bool(
     caffe2_report_cpu_memory_usage,
@@ -17,35 +27,212 @@ C10_DEFINE_bool(
     false,
     "If set, fill memory with deterministic junk when allocating on CPU");
 
+C10_DEFINE_int64(
+    caffe2_cpu_numa_alloc_min_bytes,
+    65536,
+    "Allocations of at least this many bytes by threads bound to a NUMA node "
+    "(e.g. of the NUMA pools of async nets) get fresh pages of the node, "
+    "instead of memory of the heap which may be on another node");
+
+C10_DEFINE_int64(
+    caffe2_cpu_allocator_huge_page_min_bytes,
+    0,
+    "Allocations of at least this many bytes (none if 0) are mapped 2MB "
+    "aligned and advised with MADV_HUGEPAGE, for the kernel to back them with "
+    "transparent huge pages, which cuts the TLB misses of random accesses to "
+    "large tensors");
+
+C10_DEFINE_bool(
+    caffe2_cpu_allocator_use_hugetlb,
+    false,
+    "If set, the allocations of at least "
+    "caffe2_cpu_allocator_huge_page_min_bytes are first drawn from the huge "
+    "pages reserved for hugetlbfs (vm.nr_hugepages)");
+
 namespace c10 {
 
-void memset_junk(void* data, size_t num) {
-  // This garbage pattern is NaN when interpreted as floating point values,
-  // or as very large integer values.
-  static constexpr int32_t kJunkPattern = 0x7fedbeef;
-  static constexpr int64_t kJunkPattern64 =
-      static_cast<int64_t>(kJunkPattern) << 32 | kJunkPattern;
-  int32_t int64_count = num / sizeof(kJunkPattern64);
-  int32_t remaining_bytes = num % sizeof(kJunkPattern64);
-  int64_t* data_i64 = reinterpret_cast<int64_t*>(data);
-  for (int i = 0; i < int64_count; i++) {
-    data_i64[i] = kJunkPattern64;
+namespace {
+
+struct HugePageCounters {
+  std::mutex mutex;
+  HugePageStats stats;
+};
+
+HugePageCounters& hugePageCounters() {
+  // Leaked, memory may be freed during the destruction of static objects
+  static auto* counters = new HugePageCounters();
+  return *counters;
+}
+
+// The allocations of alloc_cpu by NUMAAlloc, which free_cpu needs the size of
+struct NUMAAllocations {
+  std::mutex mutex;
+  std::unordered_map<void*, size_t> sizes;
+  std::atomic<int64_t> count{0};
+};
+
+NUMAAllocations& numaAllocations() {
+  // Leaked, memory may be freed during the destruction of static objects
+  static auto* allocations = new NUMAAllocations();
+  return *allocations;
+}
+
+void* alloc_cpu_numa(size_t nbytes) {
+  const int numa_node_id = GetThreadNUMANode();
+  if (numa_node_id < 0 ||
+      static_cast<int64_t>(nbytes) < FLAGS_caffe2_cpu_numa_alloc_min_bytes) {
+    return nullptr;
   }
-  if (remaining_bytes > 0) {
-    memcpy(data_i64 + int64_count, &kJunkPattern64, remaining_bytes);
+  // page aligned, hence gAlignment aligned
+  void* data = NUMAAlloc(nbytes, numa_node_id);
+  if (data) {
+    auto& allocations = numaAllocations();
+    std::lock_guard<std::mutex> guard(allocations.mutex);
+    allocations.sizes.emplace(data, nbytes);
+    ++allocations.count;
   }
+  return data;
 }
 
-void* alloc_cpu(size_t nbytes) {
-  if (nbytes == 0) {
+bool free_cpu_numa(void* data) {
+  auto& allocations = numaAllocations();
+  if (allocations.count.load(std::memory_order_relaxed) == 0) {
+    return false;
+  }
+  size_t nbytes;
+  {
+    std::lock_guard<std::mutex> guard(allocations.mutex);
+    auto it = allocations.sizes.find(data);
+    if (it == allocations.sizes.end()) {
+      return false;
+    }
+    nbytes = it->second;
+    allocations.sizes.erase(it);
+    --allocations.count;
+  }
+  NUMAFree(data, nbytes);
+  return true;
+}
+
+#ifdef C10_CPU_HUGE_PAGES
+
+constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+// The allocations of alloc_cpu by alloc_cpu_huge, which free_cpu needs the
+// size of, and whether they come from hugetlbfs
+struct HugePageAllocations {
+  std::mutex mutex;
+  std::unordered_map<void*, std::pair<size_t, bool>> sizes;
+  std::atomic<int64_t> count{0};
+};
+
+HugePageAllocations& hugePageAllocations() {
+  // Leaked, memory may be freed during the destruction of static objects
+  static auto* allocations = new HugePageAllocations();
+  return *allocations;
+}
+
+void* alloc_cpu_huge(size_t nbytes) {
+  if (FLAGS_caffe2_cpu_allocator_huge_page_min_bytes <= 0 ||
+      static_cast<int64_t>(nbytes) <
+          FLAGS_caffe2_cpu_allocator_huge_page_min_bytes) {
     return nullptr;
   }
-  // We might have clowny upstream code that tries to alloc a negative number
-  // of bytes. Let's catch it early.
-  CAFFE_ENFORCE(
-    ((ptrdiff_t)nbytes) >= 0,
-    "alloc_cpu() seems to have been called with negative number: ", nbytes);
+  const size_t size = (nbytes + kHugePageSize - 1) & ~(kHugePageSize - 1);
+  void* data = MAP_FAILED;
+  bool hugetlb = false;
+#ifdef MAP_HUGETLB
+  if (FLAGS_caffe2_cpu_allocator_use_hugetlb) {
+    data = mmap(
+        nullptr,
+        size,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+        -1,
+        0);
+    hugetlb = data != MAP_FAILED;
+  }
+#endif
+  if (data == MAP_FAILED) {
+    // Over-allocates by a huge page to trim the mapping to a 2MB aligned one,
+    // transparent huge pages only backing aligned ranges
+    const size_t mapped_size = size + kHugePageSize;
+    void* mapped = mmap(
+        nullptr,
+        mapped_size,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS,
+        -1,
+        0);
+    if (mapped == MAP_FAILED) {
+      return nullptr;
+    }
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(mapped);
+    const uintptr_t aligned =
+        (begin + kHugePageSize - 1) & ~(uintptr_t)(kHugePageSize - 1);
+    if (aligned > begin) {
+      munmap(mapped, aligned - begin);
+    }
+    if (aligned + size < begin + mapped_size) {
+      munmap(
+          reinterpret_cast<void*>(aligned + size),
+          begin + mapped_size - aligned - size);
+    }
+    data = reinterpret_cast<void*>(aligned);
+    // The kernel may run without transparent huge pages, the memory then
+    // being regular pages
+    madvise(data, size, MADV_HUGEPAGE);
+  }
+
+  // like the memory of the heap, or of the thread's NUMA node
+  const int numa_node_id = GetThreadNUMANode();
+  NUMAMove(
+      data, size, numa_node_id >= 0 ? numa_node_id : GetCurrentNUMANode());
+
+  auto& allocations = hugePageAllocations();
+  {
+    std::lock_guard<std::mutex> guard(allocations.mutex);
+    allocations.sizes.emplace(data, std::make_pair(size, hugetlb));
+    ++allocations.count;
+  }
+  reportHugePageAllocation(size, hugetlb);
+  return data;
+}
+
+bool free_cpu_huge(void* data) {
+  auto& allocations = hugePageAllocations();
+  if (allocations.count.load(std::memory_order_relaxed) == 0) {
+    return false;
+  }
+  std::pair<size_t, bool> size;
+  {
+    std::lock_guard<std::mutex> guard(allocations.mutex);
+    auto it = allocations.sizes.find(data);
+    if (it == allocations.sizes.end()) {
+      return false;
+    }
+    size = it->second;
+    allocations.sizes.erase(it);
+    --allocations.count;
+  }
+  munmap(data, size.first);
+  reportHugePageFree(size.first, size.second);
+  return true;
+}
+
+#else
+
+void* alloc_cpu_huge(size_t /* nbytes */) {
+  return nullptr;
+}
 
+bool free_cpu_huge(void* /* data */) {
+  return false;
+}
+
+#endif // C10_CPU_HUGE_PAGES
+
+void* alloc_cpu_heap(size_t nbytes) {
   void* data;
 #ifdef __ANDROID__
   data = memalign(gAlignment, nbytes);
@@ -73,6 +260,45 @@ void* alloc_cpu(size_t nbytes) {
 
   // move data to a thread's NUMA node
   NUMAMove(data, nbytes, GetCurrentNUMANode());
+  return data;
+}
+
+} // namespace
+
+void memset_junk(void* data, size_t num) {
+  // This garbage pattern is NaN when interpreted as floating point values,
+  // or as very large integer values.
+  static constexpr int32_t kJunkPattern = 0x7fedbeef;
+  static constexpr int64_t kJunkPattern64 =
+      static_cast<int64_t>(kJunkPattern) << 32 | kJunkPattern;
+  int32_t int64_count = num / sizeof(kJunkPattern64);
+  int32_t remaining_bytes = num % sizeof(kJunkPattern64);
+  int64_t* data_i64 = reinterpret_cast<int64_t*>(data);
+  for (int i = 0; i < int64_count; i++) {
+    data_i64[i] = kJunkPattern64;
+  }
+  if (remaining_bytes > 0) {
+    memcpy(data_i64 + int64_count, &kJunkPattern64, remaining_bytes);
+  }
+}
+
+void* alloc_cpu(size_t nbytes) {
+  if (nbytes == 0) {
+    return nullptr;
+  }
+  // We might have clowny upstream code that tries to alloc a negative number
+  // of bytes. Let's catch it early.
+  CAFFE_ENFORCE(
+    ((ptrdiff_t)nbytes) >= 0,
+    "alloc_cpu() seems to have been called with negative number: ", nbytes);
+
+  void* data = alloc_cpu_huge(nbytes);
+  if (!data) {
+    data = alloc_cpu_numa(nbytes);
+  }
+  if (!data) {
+    data = alloc_cpu_heap(nbytes);
+  }
   CHECK(
       !FLAGS_caffe2_cpu_allocator_do_zero_fill ||
       !FLAGS_caffe2_cpu_allocator_do_junk_fill)
@@ -87,6 +313,9 @@ void* alloc_cpu(size_t nbytes) {
 }
 
 void free_cpu(void* data) {
+  if (free_cpu_numa(data) || free_cpu_huge(data)) {
+    return;
+  }
 #ifdef _MSC_VER
   _aligned_free(data);
 #else
@@ -94,20 +323,6 @@ void free_cpu(void* data) {
 #endif
 }
 
-// A virtual struct that is used to report C10's memory allocation and
-// deallocation status
-class C10_API MemoryAllocationReporter {
- public:
-  MemoryAllocationReporter() : allocated_(0) {}
-  void New(void* ptr, size_t nbytes);
-  void Delete(void* ptr);
-
- private:
-  std::mutex mutex_;
-  std::unordered_map<void*, size_t> size_table_;
-  size_t allocated_;
-};
-
 struct C10_API DefaultCPUAllocator final : at::Allocator {
   DefaultCPUAllocator() {}
   ~DefaultCPUAllocator() override {}
@@ -115,30 +330,31 @@ struct C10_API DefaultCPUAllocator final : at::Allocator {
     void* data = alloc_cpu(nbytes);
     if (FLAGS_caffe2_report_cpu_memory_usage && nbytes > 0) {
       getMemoryAllocationReporter().New(data, nbytes);
-      return {data, data, &ReportAndDelete, at::Device(at::DeviceType::CPU)};
     }
-    return {data, data, &free_cpu, at::Device(at::DeviceType::CPU)};
+    profiledCPUMemoryReporter().New(data, nbytes);
+    return {data, data, &ReportAndDelete, at::Device(at::DeviceType::CPU)};
   }
 
+  // Memory profiling can be turned on and off at any time, so every
+  // allocation gets this deleter.
   static void ReportAndDelete(void* ptr) {
     if (!ptr) {
       return;
     }
-    getMemoryAllocationReporter().Delete(ptr);
+    if (FLAGS_caffe2_report_cpu_memory_usage) {
+      getMemoryAllocationReporter().Delete(ptr);
+    }
+    profiledCPUMemoryReporter().Delete(ptr);
     free_cpu(ptr);
   }
 
   at::DeleterFnPtr raw_deleter() const override {
-    if (FLAGS_caffe2_report_cpu_memory_usage) {
-      return &ReportAndDelete;
-    }
-    return &free_cpu;
+    return &ReportAndDelete;
   }
 
  protected:
   static MemoryAllocationReporter& getMemoryAllocationReporter() {
-    static MemoryAllocationReporter reporter_;
-    return reporter_;
+    return GetMemoryAllocationReporter();
   }
 
 };
@@ -175,6 +391,7 @@ class DefaultMobileCPUAllocator final : public at::Allocator {
       return;
     }
 
+    profiledCPUMemoryReporter().Delete(pointer);
     c10::free_cpu(pointer);
   }
 
@@ -189,6 +406,8 @@ class DefaultMobileCPUAllocator final : public at::Allocator {
     }
 
     void* const data = c10::alloc_cpu(PreGuardBytes + nbytes + PostGuardBytes);
+    profiledCPUMemoryReporter().New(
+        data, PreGuardBytes + nbytes + PostGuardBytes);
 
     return {
         reinterpret_cast<uint8_t*>(data) + PreGuardBytes,
@@ -205,7 +424,24 @@ class DefaultMobileCPUAllocator final : public at::Allocator {
 
 void NoDelete(void*) {}
 
+namespace {
+thread_local at::Allocator* thread_local_cpu_allocator = nullptr;
+} // namespace
+
+ThreadLocalCPUAllocatorGuard::ThreadLocalCPUAllocatorGuard(
+    at::Allocator* alloc)
+    : prev_(thread_local_cpu_allocator) {
+  thread_local_cpu_allocator = alloc;
+}
+
+ThreadLocalCPUAllocatorGuard::~ThreadLocalCPUAllocatorGuard() {
+  thread_local_cpu_allocator = prev_;
+}
+
 at::Allocator* GetCPUAllocator() {
+  if (auto* alloc = thread_local_cpu_allocator) {
+    return alloc;
+  }
   return GetAllocator(DeviceType::CPU);
 }
 
@@ -248,6 +484,35 @@ REGISTER_ALLOCATOR(DeviceType::CPU, &g_cpu_alloc);
 
 #endif /* C10_Mobile */
 
+void reportHugePageAllocation(size_t nbytes, bool hugetlb) {
+  auto& counters = hugePageCounters();
+  std::lock_guard<std::mutex> guard(counters.mutex);
+  auto& stats = counters.stats;
+  ++stats.allocations;
+  (hugetlb ? stats.hugetlb_bytes : stats.advised_bytes) += nbytes;
+  stats.peak_bytes =
+      std::max(stats.peak_bytes, stats.advised_bytes + stats.hugetlb_bytes);
+}
+
+void reportHugePageFree(size_t nbytes, bool hugetlb) {
+  auto& counters = hugePageCounters();
+  std::lock_guard<std::mutex> guard(counters.mutex);
+  auto& stats = counters.stats;
+  --stats.allocations;
+  (hugetlb ? stats.hugetlb_bytes : stats.advised_bytes) -= nbytes;
+}
+
+HugePageStats getHugePageStats() {
+  auto& counters = hugePageCounters();
+  std::lock_guard<std::mutex> guard(counters.mutex);
+  return counters.stats;
+}
+
+MemoryAllocationReporter& GetMemoryAllocationReporter() {
+  static MemoryAllocationReporter reporter_;
+  return reporter_;
+}
+
 void MemoryAllocationReporter::New(void* ptr, size_t nbytes) {
   std::lock_guard<std::mutex> guard(mutex_);
   size_table_[ptr] = nbytes;
@@ -266,4 +531,42 @@ void MemoryAllocationReporter::Delete(void* ptr) {
   size_table_.erase(it);
 }
 
+ProfiledCPUMemoryReporter& profiledCPUMemoryReporter() {
+  static ProfiledCPUMemoryReporter reporter_;
+  return reporter_;
+}
+
+void ProfiledCPUMemoryReporter::New(void* ptr, size_t nbytes) {
+  if (nbytes == 0 || !memoryProfilingEnabled()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    size_table_[ptr] = nbytes;
+  }
+  reportMemoryUsageToProfiler(
+      ptr, static_cast<int64_t>(nbytes), Device(DeviceType::CPU));
+}
+
+void ProfiledCPUMemoryReporter::Delete(void* ptr) {
+  if (!memoryProfilingEnabled()) {
+    // Entries of allocations freed while profiling was off may be left
+    // behind; they are overwritten once their address is handed out again.
+    return;
+  }
+  size_t nbytes = 0;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = size_table_.find(ptr);
+    if (it == size_table_.end()) {
+      // allocated before memory profiling was enabled
+      return;
+    }
+    nbytes = it->second;
+    size_table_.erase(it);
+  }
+  reportMemoryUsageToProfiler(
+      ptr, -static_cast<int64_t>(nbytes), Device(DeviceType::CPU));
+}
+
 } // namespace c10
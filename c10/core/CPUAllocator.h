@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstring>
+#include <mutex>
 #include <unordered_map>
 
 #include <c10/core/Allocator.h>
@@ -11,6 +12,8 @@
 C10_DECLARE_bool(caffe2_report_cpu_memory_usage);
 C10_DECLARE_bool(caffe2_cpu_allocator_do_zero_fill);
 C10_DECLARE_bool(caffe2_cpu_allocator_do_junk_fill);
+C10_DECLARE_int64(caffe2_cpu_allocator_huge_page_min_bytes);
+C10_DECLARE_bool(caffe2_cpu_allocator_use_hugetlb);
 
 namespace c10 {
 
@@ -37,16 +40,84 @@ C10_API void memset_junk(void* data, size_t num);
 C10_API void* alloc_cpu(size_t nbytes);
 C10_API void free_cpu(void* data);
 
+// The memory backed by huge pages: the allocations of alloc_cpu of at least
+// caffe2_cpu_allocator_huge_page_min_bytes, and the mappings of
+// THMapAllocator with TH_ALLOCATOR_MAPPED_HUGEPAGE.
+struct HugePageStats {
+  // COUNT: current allocations and mappings
+  int64_t allocations = 0;
+  // SUM: current bytes advised with MADV_HUGEPAGE, which the kernel backs with
+  // transparent huge pages as far as it can
+  int64_t advised_bytes = 0;
+  // SUM: current bytes drawn from hugetlbfs
+  int64_t hugetlb_bytes = 0;
+  // SUM: peak of advised_bytes + hugetlb_bytes
+  int64_t peak_bytes = 0;
+};
+
+C10_API HugePageStats getHugePageStats();
+// For the allocators backing memory with huge pages outside of alloc_cpu
+C10_API void reportHugePageAllocation(size_t nbytes, bool hugetlb);
+C10_API void reportHugePageFree(size_t nbytes, bool hugetlb);
+
 // Get the CPU Allocator.
 C10_API at::Allocator* GetCPUAllocator();
 // Sets the CPU allocator to the given allocator: the caller gives away the
 // ownership of the pointer.
 C10_API void SetCPUAllocator(at::Allocator* alloc);
 
+// Makes GetCPUAllocator() return `alloc` on the current thread only, for the
+// lifetime of the guard. Other threads keep getting the CPU allocator set
+// with SetCPUAllocator. Guards nest.
+struct C10_API ThreadLocalCPUAllocatorGuard {
+  explicit ThreadLocalCPUAllocatorGuard(at::Allocator* alloc);
+  ~ThreadLocalCPUAllocatorGuard();
+  ThreadLocalCPUAllocatorGuard(const ThreadLocalCPUAllocatorGuard&) = delete;
+  ThreadLocalCPUAllocatorGuard& operator=(const ThreadLocalCPUAllocatorGuard&) =
+      delete;
+
+ private:
+  at::Allocator* prev_;
+};
+
 // Get the Default CPU Allocator
 C10_API at::Allocator* GetDefaultCPUAllocator();
 
 // Get the Default Mobile CPU Allocator
 C10_API at::Allocator* GetDefaultMobileCPUAllocator();
 
+// A virtual struct that is used to report C10's memory allocation and
+// deallocation status
+class C10_API MemoryAllocationReporter {
+ public:
+  MemoryAllocationReporter() : allocated_(0) {}
+  void New(void* ptr, size_t nbytes);
+  void Delete(void* ptr);
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<void*, size_t> size_table_;
+  size_t allocated_;
+};
+
+// Get the reporter shared by all CPU allocators when
+// FLAGS_caffe2_report_cpu_memory_usage is set.
+C10_API MemoryAllocationReporter& GetMemoryAllocationReporter();
+
+// Keeps track of the sizes of the CPU allocations made while memory
+// profiling is enabled, so that their frees can be reported to the profiler
+// too (see reportMemoryUsageToProfiler).
+class C10_API ProfiledCPUMemoryReporter {
+ public:
+  ProfiledCPUMemoryReporter() {}
+  void New(void* ptr, size_t nbytes);
+  void Delete(void* ptr);
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<void*, size_t> size_table_;
+};
+
+C10_API ProfiledCPUMemoryReporter& profiledCPUMemoryReporter();
+
 } // namespace c10
@@ -0,0 +1,363 @@
+#include <c10/core/CPUCachingAllocator.h>
+
+#include <c10/core/CPUAllocator.h>
+#include <c10/util/llvmMathExtras.h>
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+C10_DEFINE_int64(
+    caffe2_cpu_caching_allocator_max_thread_cache_bytes,
+    256 * 1024 * 1024,
+    "Maximum number of bytes each thread may hold in the free lists of the "
+    "CPU caching allocator. Blocks freed beyond this limit are returned to "
+    "the system.");
+
+namespace c10 {
+namespace CPUCachingAllocator {
+
+//
+// A caching allocator for CPU memory.
+//
+// - Requests are rounded up to a size class. Size classes start at 512 bytes
+//   and are spaced four per power of two, so at most 25% of a block is
+//   wasted by rounding.
+// - Every thread owns a set of free lists, one per size class. Freed blocks
+//   go onto the free list of the thread that frees them and are handed out
+//   again to the next request of the same size class on that thread, without
+//   calling into the system allocator.
+// - Requests larger than kMaxCachedSize bypass the free lists and go straight
+//   to alloc_cpu()/free_cpu().
+// - Each thread caches at most
+//   FLAGS_caffe2_cpu_caching_allocator_max_thread_cache_bytes bytes; blocks
+//   freed beyond that are released. The cache of a thread is released when
+//   the thread exits, and emptyCache() releases the caches of all threads.
+//
+// The size class of a block is recorded in a header placed in the gAlignment
+// bytes just before the pointer handed to the client, so the data pointer is
+// its own context and the raw allocate/deallocate interface is supported.
+//
+
+namespace {
+
+constexpr unsigned kMinBlockShift = 9;   // smallest size class is 512 bytes
+constexpr unsigned kMaxBlockShift = 26;  // largest size class is 64 MiB
+constexpr size_t kMinBlockSize = size_t(1) << kMinBlockShift;
+constexpr size_t kMaxCachedSize = size_t(1) << kMaxBlockShift;
+constexpr size_t kSubClasses = 4;        // size classes per power of two
+constexpr size_t kNumSizeClasses =
+    1 + (kMaxBlockShift - kMinBlockShift) * kSubClasses;
+constexpr uint32_t kUncached = kNumSizeClasses;
+
+struct BlockHeader {
+  size_t size;          // block size in bytes, not counting the header
+  uint32_t size_class;  // free list index, or kUncached
+  bool reported;        // registered with the MemoryAllocationReporter
+};
+
+static_assert(
+    sizeof(BlockHeader) <= gAlignment,
+    "CPUCachingAllocator block header must fit in the alignment padding");
+
+uint32_t size_class_for(size_t nbytes) {
+  if (nbytes <= kMinBlockSize) {
+    return 0;
+  }
+  if (nbytes > kMaxCachedSize) {
+    return kUncached;
+  }
+  // 2^shift < nbytes <= 2^(shift + 1)
+  const unsigned shift = llvm::Log2_64(nbytes - 1);
+  const size_t step = size_t(1) << (shift - 2);
+  const size_t sub = (nbytes - (size_t(1) << shift) + step - 1) / step;
+  return (shift - kMinBlockShift) * kSubClasses + sub;
+}
+
+size_t size_of_class(uint32_t size_class) {
+  if (size_class == 0) {
+    return kMinBlockSize;
+  }
+  const unsigned shift = kMinBlockShift + (size_class - 1) / kSubClasses;
+  const size_t sub = (size_class - 1) % kSubClasses + 1;
+  return (size_t(1) << shift) + sub * (size_t(1) << (shift - 2));
+}
+
+BlockHeader* header_of(void* data) {
+  return reinterpret_cast<BlockHeader*>(
+      static_cast<uint8_t*>(data) - gAlignment);
+}
+
+struct AtomicStat {
+  std::atomic<int64_t> current{0};
+  std::atomic<int64_t> peak{0};
+  std::atomic<int64_t> allocated{0};
+  std::atomic<int64_t> freed{0};
+
+  void update(int64_t amount) {
+    const int64_t now = current.fetch_add(amount) + amount;
+    if (amount > 0) {
+      allocated.fetch_add(amount);
+      int64_t prev_peak = peak.load();
+      while (now > prev_peak && !peak.compare_exchange_weak(prev_peak, now)) {
+      }
+    } else {
+      freed.fetch_add(-amount);
+    }
+  }
+
+  Stat get() const {
+    Stat stat;
+    stat.current = current.load();
+    stat.peak = peak.load();
+    stat.allocated = allocated.load();
+    stat.freed = freed.load();
+    return stat;
+  }
+
+  void reset_accumulated() {
+    allocated = 0;
+    freed = 0;
+  }
+
+  void reset_peak() {
+    peak = current.load();
+  }
+};
+
+struct ThreadCache;
+
+struct AllocatorState {
+  // lock around the set of live thread caches
+  std::mutex mutex;
+  std::unordered_set<ThreadCache*> thread_caches;
+
+  AtomicStat allocation;
+  AtomicStat allocated_bytes;
+  AtomicStat cached_bytes;
+  std::atomic<int64_t> num_cache_hits{0};
+  std::atomic<int64_t> num_cache_misses{0};
+};
+
+// Intentionally leaked: threads may still free blocks during static
+// destruction.
+AllocatorState& state() {
+  static AllocatorState* state_ = new AllocatorState();
+  return *state_;
+}
+
+struct ThreadCache {
+  // Only contended while emptyCache() runs on another thread.
+  std::mutex mutex;
+  std::array<std::vector<void*>, kNumSizeClasses> free_blocks;
+  size_t cached_bytes = 0;
+
+  ThreadCache() {
+    auto& s = state();
+    std::lock_guard<std::mutex> guard(s.mutex);
+    s.thread_caches.insert(this);
+  }
+
+  ~ThreadCache();
+
+  // Returns a cached block of the given class, or nullptr. Caller holds mutex.
+  void* pop(uint32_t size_class, size_t size) {
+    auto& blocks = free_blocks[size_class];
+    if (blocks.empty()) {
+      return nullptr;
+    }
+    void* base = blocks.back();
+    blocks.pop_back();
+    cached_bytes -= size;
+    state().cached_bytes.update(-static_cast<int64_t>(size));
+    return base;
+  }
+
+  // Caches a block if the thread is under its limit. Caller holds mutex.
+  bool push(void* base, uint32_t size_class, size_t size) {
+    if (cached_bytes + size >
+        static_cast<size_t>(
+            FLAGS_caffe2_cpu_caching_allocator_max_thread_cache_bytes)) {
+      return false;
+    }
+    free_blocks[size_class].push_back(base);
+    cached_bytes += size;
+    state().cached_bytes.update(static_cast<int64_t>(size));
+    return true;
+  }
+
+  // Returns all cached blocks to the system. Caller holds mutex.
+  void release() {
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+      for (void* base : free_blocks[i]) {
+        free_cpu(base);
+      }
+      free_blocks[i].clear();
+    }
+    state().cached_bytes.update(-static_cast<int64_t>(cached_bytes));
+    cached_bytes = 0;
+  }
+};
+
+#ifndef CAFFE2_FB_LIMITED_MOBILE_CAPABILITY
+
+// NB: POD, so it stays valid after the thread's cache has been destroyed.
+thread_local bool tls_cache_destroyed = false;
+
+ThreadCache::~ThreadCache() {
+  {
+    auto& s = state();
+    std::lock_guard<std::mutex> guard(s.mutex);
+    s.thread_caches.erase(this);
+  }
+  std::lock_guard<std::mutex> guard(mutex);
+  release();
+  tls_cache_destroyed = true;
+}
+
+// Returns nullptr once the calling thread has started tearing down its
+// thread locals; blocks freed after that point go back to the system.
+ThreadCache* local_cache() {
+  if (C10_UNLIKELY(tls_cache_destroyed)) {
+    return nullptr;
+  }
+  static thread_local ThreadCache cache;
+  return &cache;
+}
+
+#else // defined(CAFFE2_FB_LIMITED_MOBILE_CAPABILITY)
+
+// Without thread_local there are no per-thread free lists; every request is
+// served by the system allocator.
+ThreadCache::~ThreadCache() {}
+
+ThreadCache* local_cache() {
+  return nullptr;
+}
+
+#endif
+
+void Delete(void* data) {
+  if (C10_UNLIKELY(!data)) {
+    return;
+  }
+  BlockHeader* header = header_of(data);
+  if (header->reported) {
+    GetMemoryAllocationReporter().Delete(data);
+  }
+  const size_t size = header->size;
+  const uint32_t size_class = header->size_class;
+  auto& s = state();
+  s.allocation.update(-1);
+  s.allocated_bytes.update(-static_cast<int64_t>(size));
+
+  void* base = header;
+  if (size_class != kUncached) {
+    if (ThreadCache* cache = local_cache()) {
+      std::lock_guard<std::mutex> guard(cache->mutex);
+      if (cache->push(base, size_class, size)) {
+        return;
+      }
+    }
+  }
+  free_cpu(base);
+}
+
+struct CachingCPUAllocator final : public at::Allocator {
+  at::DataPtr allocate(size_t nbytes) const override {
+    if (C10_UNLIKELY(nbytes == 0)) {
+      return {nullptr, nullptr, &Delete, at::Device(DeviceType::CPU)};
+    }
+    const uint32_t size_class = size_class_for(nbytes);
+    const size_t size =
+        size_class == kUncached ? nbytes : size_of_class(size_class);
+    auto& s = state();
+
+    void* base = nullptr;
+    if (size_class != kUncached) {
+      if (ThreadCache* cache = local_cache()) {
+        std::lock_guard<std::mutex> guard(cache->mutex);
+        base = cache->pop(size_class, size);
+      }
+    }
+    void* data;
+    if (base) {
+      s.num_cache_hits++;
+      data = static_cast<uint8_t*>(base) + gAlignment;
+      // alloc_cpu() applies these to fresh memory; do the same for reuse.
+      if (FLAGS_caffe2_cpu_allocator_do_zero_fill) {
+        memset(data, 0, nbytes);
+      } else if (FLAGS_caffe2_cpu_allocator_do_junk_fill) {
+        memset_junk(data, nbytes);
+      }
+    } else {
+      s.num_cache_misses++;
+      base = alloc_cpu(size + gAlignment);
+      data = static_cast<uint8_t*>(base) + gAlignment;
+    }
+
+    BlockHeader* header = static_cast<BlockHeader*>(base);
+    header->size = size;
+    header->size_class = size_class;
+    header->reported = FLAGS_caffe2_report_cpu_memory_usage;
+    if (header->reported) {
+      GetMemoryAllocationReporter().New(data, nbytes);
+    }
+    s.allocation.update(1);
+    s.allocated_bytes.update(static_cast<int64_t>(size));
+    return {data, data, &Delete, at::Device(DeviceType::CPU)};
+  }
+
+  at::DeleterFnPtr raw_deleter() const override {
+    return &Delete;
+  }
+};
+
+CachingCPUAllocator g_caching_cpu_alloc;
+
+} // namespace
+
+Allocator* get() {
+  return &g_caching_cpu_alloc;
+}
+
+void emptyCache() {
+  auto& s = state();
+  std::lock_guard<std::mutex> guard(s.mutex);
+  for (ThreadCache* cache : s.thread_caches) {
+    std::lock_guard<std::mutex> cache_guard(cache->mutex);
+    cache->release();
+  }
+}
+
+AllocatorStats getStats() {
+  auto& s = state();
+  AllocatorStats stats;
+  stats.allocation = s.allocation.get();
+  stats.allocated_bytes = s.allocated_bytes.get();
+  stats.cached_bytes = s.cached_bytes.get();
+  stats.num_cache_hits = s.num_cache_hits.load();
+  stats.num_cache_misses = s.num_cache_misses.load();
+  return stats;
+}
+
+void resetAccumulatedStats() {
+  auto& s = state();
+  s.allocation.reset_accumulated();
+  s.allocated_bytes.reset_accumulated();
+  s.cached_bytes.reset_accumulated();
+  s.num_cache_hits = 0;
+  s.num_cache_misses = 0;
+}
+
+void resetPeakStats() {
+  auto& s = state();
+  s.allocation.reset_peak();
+  s.allocated_bytes.reset_peak();
+  s.cached_bytes.reset_peak();
+}
+
+} // namespace CPUCachingAllocator
+} // namespace c10
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <c10/core/Allocator.h>
+#include <c10/util/Flags.h>
+
+C10_DECLARE_int64(caffe2_cpu_caching_allocator_max_thread_cache_bytes);
+
+namespace c10 {
+
+// An optional caching allocator for CPU memory.  It is not registered by
+// default; to use it, install it as the CPU allocator during initialization:
+//
+//   c10::SetCPUAllocator(c10::CPUCachingAllocator::get());
+//
+// See the comment in CPUCachingAllocator.cpp for the design.
+namespace CPUCachingAllocator {
+
+struct Stat {
+  int64_t current = 0;
+  int64_t peak = 0;
+  int64_t allocated = 0;
+  int64_t freed = 0;
+};
+
+// Struct containing summary statistics for the CPU caching allocator.
+struct AllocatorStats {
+  // COUNT: allocations requested by client code
+  Stat allocation;
+  // SUM: bytes (rounded up to the size class) handed out to client code
+  Stat allocated_bytes;
+  // SUM: bytes held in the per-thread free lists
+  Stat cached_bytes;
+
+  // COUNT: allocations served from a per-thread free list
+  int64_t num_cache_hits = 0;
+  // COUNT: allocations that had to go to the system allocator
+  int64_t num_cache_misses = 0;
+};
+
+C10_API Allocator* get();
+C10_API void emptyCache();
+C10_API AllocatorStats getStats();
+C10_API void resetAccumulatedStats();
+C10_API void resetPeakStats();
+
+} // namespace CPUCachingAllocator
+} // namespace c10
@@ -32,14 +32,22 @@ const char* toString(DispatchKey t) {
       return "XLA";
     case DispatchKey::MkldnnCPU:
       return "MkldnnCPU";
+    case DispatchKey::SparseCsrCPU:
+      return "SparseCsrCPU";
+    case DispatchKey::NestedCPU:
+      return "NestedCPU";
     case DispatchKey::QuantizedCPU:
       return "QuantizedCPU";
     case DispatchKey::Autograd:
       return "Autograd";
     case DispatchKey::BackendSelect:
       return "BackendSelect";
+    case DispatchKey::Deferred:
+      return "Deferred";
     case DispatchKey::TESTING_ONLY_GenericMode:
       return "TESTING_ONLY_GenericMode";
+    case DispatchKey::AutocastCPU:
+      return "AutocastCPU";
     case DispatchKey::Autocast:
       return "Autocast";
     case DispatchKey::TESTING_ONLY_GenericWrapper:
@@ -97,6 +97,8 @@ enum class DispatchKey : uint8_t {
   SparseCUDA, // registered at build/aten/src/ATen/SparseCUDAType.cpp
   SparseHIP, // TODO: I think this is not actually used, due to Note
              // [Masquerading as CUDA]
+  SparseCsrCPU, // registered at build/aten/src/ATen/SparseCsrCPUType.cpp
+  NestedCPU, // registered at build/aten/src/ATen/NestedCPUType.cpp
 
   // Here are reserved backends for user-defined backends, see Note [Private use
   // DispatchKey]
@@ -112,6 +114,11 @@ enum class DispatchKey : uint8_t {
   // correct backend.
   BackendSelect,
 
+  // Deferred execution of pointwise ops, see ATen/DeferredMode.h. It is
+  // processed after autograd so that only the numeric computation is
+  // deferred, and is only ever set in the thread local included set.
+  Deferred,
+
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~ AUTOGRAD ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ //
   // All backends are oblivious to autograd; autograd is handled as a
   // layer which happens on top of all backends.  It inspects the autograd
@@ -138,6 +145,9 @@ enum class DispatchKey : uint8_t {
 
   // Autocasting precedes VariableTypeId, to ensure casts are autograd-exposed
   // and inputs are saved for backward in the post-autocast type.
+  // AutocastCPU casts CPU tensors (to bfloat16), Autocast CUDA tensors (to
+  // float16).
+  AutocastCPU,
   Autocast,
 
   // Here are some reserved pre-autograd keys for user-defined backends, see
@@ -106,6 +106,15 @@ struct Event final {
     return impl_.query();
   }
 
+/**
+ * Waits in the calling thread until the version of the event that exists at
+ * the time of this call is marked as recorded. Does nothing if the event has
+ * not been scheduled to be recorded.
+ */
+  void synchronize() const {
+    impl_.synchronize();
+  }
+
 private:
   impl::InlineEvent<impl::VirtualGuardImpl> impl_;
 };
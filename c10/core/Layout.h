@@ -6,11 +6,13 @@
 #include <iostream>
 
 namespace c10 {
-enum class Layout : int8_t { Strided, Sparse, Mkldnn, NumOptions };
+enum class Layout : int8_t { Strided, Sparse, Mkldnn, SparseCsr, Nested, NumOptions };
 
 constexpr auto kStrided = Layout::Strided;
 constexpr auto kSparse = Layout::Sparse;
 constexpr auto kMkldnn = Layout::Mkldnn;
+constexpr auto kSparseCsr = Layout::SparseCsr;
+constexpr auto kNested = Layout::Nested;
 
 inline Layout layout_from_backend(Backend backend) {
   switch (backend) {
@@ -20,6 +22,10 @@ inline Layout layout_from_backend(Backend backend) {
       return Layout::Sparse;
     case Backend::MkldnnCPU:
       return Layout::Mkldnn;
+    case Backend::SparseCsrCPU:
+      return Layout::SparseCsr;
+    case Backend::NestedCPU:
+      return Layout::Nested;
     default:
       return Layout::Strided;
   }
@@ -33,6 +39,10 @@ inline std::ostream& operator<<(std::ostream& stream, at::Layout layout) {
       return stream << "Sparse";
     case at::kMkldnn:
       return stream << "Mkldnn";
+    case at::kSparseCsr:
+      return stream << "SparseCsr";
+    case at::kNested:
+      return stream << "Nested";
     default:
       AT_ERROR("Unknown layout");
   }
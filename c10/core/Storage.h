@@ -77,6 +77,10 @@ struct C10_API Storage {
     return storage_impl_->resizable();
   }
 
+  bool read_only() const {
+    return storage_impl_->read_only();
+  }
+
   size_t nbytes() const {
     return storage_impl_->nbytes();
   }
@@ -86,6 +90,14 @@ struct C10_API Storage {
     return storage_impl_.get()->data();
   }
 
+  const void* const_data() const {
+    return storage_impl_->const_data();
+  }
+
+  bool is_cow() const {
+    return storage_impl_->is_cow();
+  }
+
   const caffe2::TypeMeta& dtype() const {
     return storage_impl_->dtype();
   }
@@ -2,14 +2,24 @@
 
 #include <c10/core/Allocator.h>
 #include <c10/core/ScalarType.h>
+#include <c10/core/impl/COW.h>
+#include <c10/core/impl/ImplObjectCache.h>
 
 #include <c10/util/intrusive_ptr.h>
 
+#include <atomic>
+#include <cstring>
+
 namespace c10 {
 
 struct C10_API StorageImpl final : public c10::intrusive_ptr_target {
  public:
   struct use_byte_size_t {};
+  struct use_inline_buffer_t {};
+
+  // Size of the buffer of a StorageImpl, which can hold the data of small CPU
+  // storages (scalars, short vectors) and save the allocation of their data
+  static constexpr size_t kInlineBufferBytes = 32;
 
   StorageImpl(
       use_byte_size_t use_byte_size,
@@ -23,7 +33,10 @@ struct C10_API StorageImpl final : public c10::intrusive_ptr_target {
         size_bytes_(size_bytes),
         resizable_(resizable),
         received_cuda_(false),
+        read_only_(false),
         allocator_(allocator) {
+    is_cow_.store(
+        impl::cow::is_cow_data_ptr(data_ptr_), std::memory_order_relaxed);
     if (resizable) {
       AT_ASSERTM(
           allocator_, "For resizable storage, allocator must be provided");
@@ -50,13 +63,67 @@ struct C10_API StorageImpl final : public c10::intrusive_ptr_target {
             allocator,
             resizable) {}
 
-  StorageImpl& operator=(StorageImpl&& other) = default;
+  // A CPU storage of at most kInlineBufferBytes bytes with its data in the
+  // buffer of the StorageImpl.  The allocator is only used if the storage is
+  // resized, or given a new data_ptr.
+  StorageImpl(
+      use_byte_size_t use_byte_size,
+      use_inline_buffer_t use_inline_buffer,
+      caffe2::TypeMeta data_type,
+      size_t size_bytes,
+      at::Allocator* allocator,
+      bool resizable)
+      : StorageImpl(
+            use_byte_size_t(),
+            data_type,
+            size_bytes,
+            at::DataPtr(nullptr, Device(DeviceType::CPU)),
+            allocator,
+            resizable) {
+    TORCH_INTERNAL_ASSERT(size_bytes <= kInlineBufferBytes);
+    data_ptr_ = inline_data_ptr();
+  }
+
+  // The data of a storage using its buffer is copied to the buffer of the
+  // new StorageImpl
+  StorageImpl& operator=(StorageImpl&& other) {
+    const bool other_is_inline = other.is_inline();
+    data_type_ = other.data_type_;
+    data_ptr_ = std::move(other.data_ptr_);
+    size_bytes_ = other.size_bytes_;
+    resizable_ = other.resizable_;
+    received_cuda_ = other.received_cuda_;
+    read_only_ = other.read_only_;
+    allocator_ = other.allocator_;
+    if (other_is_inline) {
+      std::memcpy(inline_buffer_, other.inline_buffer_, kInlineBufferBytes);
+      data_ptr_ = inline_data_ptr();
+    }
+    is_cow_.store(
+        impl::cow::is_cow_data_ptr(data_ptr_), std::memory_order_release);
+    return *this;
+  }
   StorageImpl& operator=(const StorageImpl&) = delete;
   StorageImpl() = delete;
-  StorageImpl(StorageImpl&& other) = default;
+  StorageImpl(StorageImpl&& other)
+      : data_type_(other.data_type_),
+        size_bytes_(other.size_bytes_),
+        resizable_(other.resizable_),
+        received_cuda_(other.received_cuda_),
+        read_only_(other.read_only_),
+        allocator_(other.allocator_) {
+    *this = std::move(other);
+  }
   StorageImpl(const StorageImpl&) = delete;
   ~StorageImpl() = default;
 
+  static void* operator new(size_t size) {
+    return impl::allocate_impl_object(size);
+  }
+  static void operator delete(void* ptr, size_t size) {
+    impl::free_impl_object(ptr, size);
+  }
+
   void reset() {
     data_ptr_.clear();
     size_bytes_ = 0;
@@ -82,6 +149,7 @@ struct C10_API StorageImpl final : public c10::intrusive_ptr_target {
 
   template <typename T>
   inline T* unsafe_data() const {
+    maybe_materialize_cow();
     return static_cast<T*>(this->data_ptr_.get());
   }
 
@@ -89,6 +157,11 @@ struct C10_API StorageImpl final : public c10::intrusive_ptr_target {
     data_ptr_.clear();
   }
 
+  // Whether the data of the storage is in the buffer of the StorageImpl
+  bool is_inline() const {
+    return data_ptr_.get() == inline_buffer_;
+  }
+
   size_t nbytes() const {
     return size_bytes_;
   }
@@ -103,9 +176,13 @@ struct C10_API StorageImpl final : public c10::intrusive_ptr_target {
   };
 
   at::DataPtr& data_ptr() {
+    maybe_materialize_cow();
     return data_ptr_;
   };
 
+  // Unlike the other accessors of the data, this one and const_data() don't
+  // give a copy-on-write storage its own copy of the data, so the data must
+  // not be written through them.
   const at::DataPtr& data_ptr() const {
     return data_ptr_;
   };
@@ -113,6 +190,8 @@ struct C10_API StorageImpl final : public c10::intrusive_ptr_target {
   // Returns the previous data_ptr
   at::DataPtr set_data_ptr(at::DataPtr&& data_ptr) {
     std::swap(data_ptr_, data_ptr);
+    is_cow_.store(
+        impl::cow::is_cow_data_ptr(data_ptr_), std::memory_order_release);
     return std::move(data_ptr);
   };
 
@@ -125,13 +204,25 @@ struct C10_API StorageImpl final : public c10::intrusive_ptr_target {
 
   // TODO: Return const ptr eventually if possible
   void* data() {
+    maybe_materialize_cow();
     return data_ptr_.get();
   }
 
   void* data() const {
+    maybe_materialize_cow();
     return data_ptr_.get();
   }
 
+  const void* const_data() const {
+    return data_ptr_.get();
+  }
+
+  // Whether the data is shared copy-on-write with other storages, see
+  // c10/core/impl/COW.h
+  bool is_cow() const {
+    return is_cow_.load(std::memory_order_acquire);
+  }
+
   at::DeviceType device_type() const {
     return data_ptr_.device().type();
   }
@@ -196,6 +287,7 @@ struct C10_API StorageImpl final : public c10::intrusive_ptr_target {
           "already set.");
     }
     data_ptr_ = std::move(data_ptr);
+    is_cow_.store(false, std::memory_order_release);
     size_bytes_ = size_bytes;
     allocator_ = nullptr;
     resizable_ = false;
@@ -211,6 +303,17 @@ struct C10_API StorageImpl final : public c10::intrusive_ptr_target {
     return received_cuda_;
   }
 
+  // A read-only storage wraps memory owned by someone else that must not be
+  // written, like the buffer of a non-writeable NumPy array. In-place and
+  // out= ops refuse tensors using it.
+  void set_read_only(bool read_only) {
+    read_only_ = read_only;
+  }
+
+  bool read_only() const {
+    return read_only_;
+  }
+
  private:
   caffe2::TypeMeta data_type_;
   DataPtr data_ptr_;
@@ -219,6 +322,24 @@ struct C10_API StorageImpl final : public c10::intrusive_ptr_target {
   // Identifies that Storage was received from another process and doesn't have
   // local to process cuda memory allocation
   bool received_cuda_;
+  bool read_only_;
+  // Whether data_ptr_ is copy-on-write. It is set after data_ptr_ changes, so
+  // that a thread that sees it cleared also sees the materialized data_ptr_.
+  std::atomic<bool> is_cow_{false};
   Allocator* allocator_;
+  alignas(16) char inline_buffer_[kInlineBufferBytes];
+
+  at::DataPtr inline_data_ptr() {
+    return at::DataPtr(inline_buffer_, Device(DeviceType::CPU));
+  }
+
+  // Gives a copy-on-write storage its own copy of the data before it's
+  // accessed for writing.  This is const because all the accessors of the
+  // data may be used for writing it, including the const ones.
+  void maybe_materialize_cow() const {
+    if (C10_UNLIKELY(is_cow())) {
+      impl::cow::materialize_cow_storage(const_cast<StorageImpl&>(*this));
+    }
+  }
 };
 } // namespace c10
@@ -9,6 +9,7 @@
 #include <c10/core/Storage.h>
 #include <c10/core/TensorOptions.h>
 #include <c10/core/DispatchKeySet.h>
+#include <c10/core/impl/ImplObjectCache.h>
 #include <c10/core/impl/LocalDispatchKeySet.h>
 #include <c10/core/CopyBytes.h>
 
@@ -346,6 +347,17 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
   TensorImpl(TensorImpl&&) = default;
   TensorImpl& operator=(TensorImpl&&) = default;
 
+  /**
+   * Impl objects are allocated through the impl object cache, see
+   * ImplObjectCache.h.  The size is the one of the most derived class.
+   */
+  static void* operator new(size_t size) {
+    return impl::allocate_impl_object(size);
+  }
+  static void operator delete(void* ptr, size_t size) {
+    impl::free_impl_object(ptr, size);
+  }
+
   /**
    * Release (decref) storage, and any other external allocations.  This
    * override is for `intrusive_ptr_target` and is used to implement weak
@@ -451,6 +463,16 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
     return key_set_.has(DispatchKey::MkldnnCPU);
   }
 
+  bool is_sparse_csr() const {
+    // NB: This method is not virtual and avoid dispatches for performance reasons.
+    return key_set_.has(DispatchKey::SparseCsrCPU);
+  }
+
+  bool is_nested() const {
+    // NB: This method is not virtual and avoid dispatches for performance reasons.
+    return key_set_.has(DispatchKey::NestedCPU);
+  }
+
   int64_t get_device() const {
     TORCH_CHECK(
         device_opt_.has_value(),
@@ -473,6 +495,10 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
       return kSparse;
     } else if (is_mkldnn()) {
       return kMkldnn;
+    } else if (is_sparse_csr()) {
+      return kSparseCsr;
+    } else if (is_nested()) {
+      return kNested;
     } else {
       return kStrided;
     }
@@ -622,6 +648,21 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
         data_type_.itemsize() * storage_offset_);
   }
 
+  /**
+   * Like data(), but the data must only be read through the returned pointer,
+   * which doesn't make a copy-on-write storage copy its data.
+   */
+  inline const void* const_data() const {
+    TORCH_CHECK(has_storage(),
+        "Cannot access data pointer of Tensor that doesn't have storage");
+    TORCH_CHECK(dtype_initialized(),
+        "Cannot access data pointer of Tensor that doesn't have initialized dtype "
+        "(e.g., caffe2::Tensor x(CPU), prior to calling mutable_data<T>() on x)");
+    return static_cast<const void*>(
+        static_cast<const char*>(storage_.const_data()) +
+        data_type_.itemsize() * storage_offset_);
+  }
+
   /**
    * Like data<T>(), but performs no checks.  You are responsible for ensuring
    * that all invariants required by data() are upheld here.
@@ -1321,7 +1362,7 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
    */
   bool storage_initialized() const {
     TORCH_CHECK(has_storage(), "cannot call storage_initialized on tensor that does not have storage");
-    return storage_.data() || numel_ == 0;
+    return storage_.const_data() || numel_ == 0;
   }
 
   /**
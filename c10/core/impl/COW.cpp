@@ -0,0 +1,108 @@
+#include <c10/core/impl/COW.h>
+
+#include <c10/core/StorageImpl.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+
+namespace c10 {
+namespace impl {
+namespace cow {
+
+namespace {
+
+// Owns the buffer shared by copy-on-write storages, one reference per
+// storage.
+struct CowContext {
+  explicit CowContext(DataPtr data) : data(std::move(data)) {}
+
+  std::atomic<size_t> refcount{1};
+  DataPtr data;
+};
+
+DataPtr make_cow_data_ptr(CowContext* ctx) {
+  return DataPtr(ctx->data.get(), ctx, &cow_deleter, ctx->data.device());
+}
+
+// Serializes the changes of the data_ptr of a storage between lazy clones and
+// materializations, which can run on any thread that accesses the data, e.g.
+// on the threads that read a tensor shared between them. Storages are spread
+// over a fixed set of mutexes to keep StorageImpl small.
+std::mutex& storage_mutex(const StorageImpl& storage) {
+  constexpr size_t kNumMutexes = 64;
+  static std::mutex mutexes[kNumMutexes];
+  const auto address = reinterpret_cast<std::uintptr_t>(&storage);
+  return mutexes[(address / alignof(StorageImpl)) % kNumMutexes];
+}
+
+} // namespace
+
+void cow_deleter(void* ctx) {
+  auto* cow_ctx = static_cast<CowContext*>(ctx);
+  if (--cow_ctx->refcount == 0) {
+    delete cow_ctx;
+  }
+}
+
+c10::intrusive_ptr<StorageImpl> lazy_clone_storage(StorageImpl& storage) {
+  std::lock_guard<std::mutex> guard(storage_mutex(storage));
+  // The const accessor doesn't materialize the storage.
+  const DataPtr& data_ptr = static_cast<const StorageImpl&>(storage).data_ptr();
+  if (storage.device_type() != DeviceType::CPU || storage.is_inline() ||
+      storage.read_only() || data_ptr.get() == nullptr) {
+    return c10::intrusive_ptr<StorageImpl>();
+  }
+
+  if (!is_cow_data_ptr(data_ptr)) {
+    Allocator* allocator = storage.allocator();
+    if (allocator == nullptr || allocator->raw_deleter() == nullptr ||
+        data_ptr.get_deleter() != allocator->raw_deleter() ||
+        data_ptr.get() != data_ptr.get_context()) {
+      return c10::intrusive_ptr<StorageImpl>();
+    }
+    auto* ctx = new CowContext(storage.set_data_ptr(DataPtr()));
+    storage.set_data_ptr(make_cow_data_ptr(ctx));
+  }
+
+  auto* ctx = static_cast<CowContext*>(data_ptr.get_context());
+  ++ctx->refcount;
+  return c10::make_intrusive<StorageImpl>(
+      StorageImpl::use_byte_size_t(),
+      storage.dtype(),
+      storage.nbytes(),
+      make_cow_data_ptr(ctx),
+      storage.allocator(),
+      storage.resizable());
+}
+
+void materialize_cow_storage(StorageImpl& storage) {
+  std::lock_guard<std::mutex> guard(storage_mutex(storage));
+  // Another thread may have materialized the storage since it was checked.
+  if (!storage.is_cow()) {
+    return;
+  }
+  const DataPtr& data_ptr = static_cast<const StorageImpl&>(storage).data_ptr();
+  TORCH_INTERNAL_ASSERT(is_cow_data_ptr(data_ptr));
+  auto* ctx = static_cast<CowContext*>(data_ptr.get_context());
+
+  DataPtr new_data_ptr;
+  if (ctx->refcount.load() == 1) {
+    // No other storage shares the buffer anymore, and none can start sharing
+    // it without going through this one, so take it back.
+    new_data_ptr = std::move(ctx->data);
+  } else {
+    TORCH_INTERNAL_ASSERT(storage.allocator());
+    new_data_ptr = storage.allocator()->allocate(storage.nbytes());
+    if (storage.nbytes() > 0) {
+      std::memcpy(new_data_ptr.get(), data_ptr.get(), storage.nbytes());
+    }
+  }
+  // Drops the reference of this storage to the shared buffer.
+  storage.set_data_ptr(std::move(new_data_ptr));
+}
+
+} // namespace cow
+} // namespace impl
+} // namespace c10
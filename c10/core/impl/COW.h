@@ -0,0 +1,53 @@
+#pragma once
+
+#include <c10/core/Allocator.h>
+#include <c10/macros/Macros.h>
+#include <c10/util/intrusive_ptr.h>
+
+// Copy-on-write sharing of the data of CPU storages
+//
+// A lazy clone of a storage is a new StorageImpl that shares the data of the
+// original one instead of copying it.  The DataPtrs of both storages then
+// point at the same buffer and hold a reference to a common context owning
+// it.  Reading the data is free; the first access that may write it, i.e.
+// any access except StorageImpl::const_data() and the const data_ptr(),
+// "materializes" the storage: it gets its own copy of the buffer, or takes
+// the buffer back if the other storages are gone.  Both the original and the
+// clone materialize on a write, so neither sees the writes of the other.
+// Lazy clones and materializations of a storage are serialized, so threads
+// that only read a tensor can share it even if their accesses materialize it;
+// the storage is materialized once, by the first of them.
+//
+// Only data that a storage allocated with its own allocator can be shared,
+// since memory owned by someone else (from_blob, NumPy arrays, shared memory)
+// may be written behind the storage's back.  For the same reason, raw
+// pointers to the data taken before the lazy clone keep writing to the
+// shared buffer; this is why lazy cloning is opt-in, see
+// at::Context::setCopyOnWrite.
+
+namespace c10 {
+
+struct StorageImpl;
+
+namespace impl {
+namespace cow {
+
+// The deleter of the DataPtrs of copy-on-write storages; it drops their
+// reference to the shared buffer.
+C10_API void cow_deleter(void* ctx);
+
+inline bool is_cow_data_ptr(const DataPtr& data_ptr) {
+  return data_ptr.get_deleter() == &cow_deleter;
+}
+
+// Returns a StorageImpl sharing the data of `storage` copy-on-write, or
+// nullptr if its data can't be shared.  This turns `storage` into a
+// copy-on-write storage too, without moving its data.
+C10_API c10::intrusive_ptr<StorageImpl> lazy_clone_storage(StorageImpl& storage);
+
+// Gives a copy-on-write storage its own copy of its data.
+C10_API void materialize_cow_storage(StorageImpl& storage);
+
+} // namespace cow
+} // namespace impl
+} // namespace c10
@@ -0,0 +1,99 @@
+#include <c10/core/impl/ImplObjectCache.h>
+
+#include <cstdlib>
+#include <new>
+#include <string>
+
+namespace c10 {
+namespace impl {
+
+namespace {
+
+constexpr size_t kSizeClassBytes = 16;
+constexpr size_t kNumSizeClasses = 32; // objects of up to 512 bytes
+
+bool cache_enabled() {
+  static const bool enabled = []() {
+    const char* env = std::getenv("PYTORCH_CACHE_IMPL_OBJECTS");
+    return env != nullptr && std::string(env) == "1";
+  }();
+  return enabled;
+}
+
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+// Set when the cache of the thread is destroyed, for the impl objects freed
+// later during the exit of the thread.  Trivially destructible so that it can
+// still be read then.
+thread_local bool cache_destroyed = false;
+
+struct ThreadCache {
+  FreeBlock* blocks[kNumSizeClasses] = {};
+  size_t num_blocks[kNumSizeClasses] = {};
+
+  ~ThreadCache() {
+    cache_destroyed = true;
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+      while (blocks[i] != nullptr) {
+        FreeBlock* block = blocks[i];
+        blocks[i] = block->next;
+        ::operator delete(block);
+      }
+    }
+  }
+};
+
+ThreadCache* thread_cache() {
+  if (cache_destroyed) {
+    return nullptr;
+  }
+  static thread_local ThreadCache cache;
+  return &cache;
+}
+
+} // namespace
+
+void* allocate_impl_object(size_t size) {
+  if (!cache_enabled() || size == 0 ||
+      size > kSizeClassBytes * kNumSizeClasses) {
+    return ::operator new(size);
+  }
+  const size_t size_class = (size - 1) / kSizeClassBytes;
+  ThreadCache* cache = thread_cache();
+  if (cache != nullptr && cache->blocks[size_class] != nullptr) {
+    FreeBlock* block = cache->blocks[size_class];
+    cache->blocks[size_class] = block->next;
+    cache->num_blocks[size_class]--;
+    return block;
+  }
+  // Allocate the whole size class so that the block can be reused by any
+  // object of the class
+  return ::operator new((size_class + 1) * kSizeClassBytes);
+}
+
+void free_impl_object(void* ptr, size_t size) noexcept {
+  if (ptr == nullptr) {
+    return;
+  }
+  if (!cache_enabled() || size == 0 ||
+      size > kSizeClassBytes * kNumSizeClasses) {
+    ::operator delete(ptr);
+    return;
+  }
+  const size_t size_class = (size - 1) / kSizeClassBytes;
+  ThreadCache* cache = thread_cache();
+  if (cache == nullptr ||
+      cache->num_blocks[size_class] >= kMaxCachedImplObjects) {
+    ::operator delete(ptr);
+    return;
+  }
+  FreeBlock* block = static_cast<FreeBlock*>(ptr);
+  block->next = cache->blocks[size_class];
+  cache->blocks[size_class] = block;
+  cache->num_blocks[size_class]++;
+}
+
+} // namespace impl
+} // namespace c10
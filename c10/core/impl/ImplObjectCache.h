@@ -0,0 +1,31 @@
+#pragma once
+
+#include <c10/macros/Macros.h>
+
+#include <cstddef>
+
+// Per-thread caches of the memory of freed TensorImpl and StorageImpl objects,
+// and of the IValue containers (tuples, lists, dicts, strings)
+//
+// Code creating many small tensors (wrapped scalars, index math), or
+// TorchScript code building many containers, pays for a heap allocation per
+// impl object.  With PYTORCH_CACHE_IMPL_OBJECTS=1, the
+// memory of freed impl objects is kept in per-thread free lists, one per
+// 16-byte size class, and handed to the next impl objects of the same size
+// class created on the thread.  A thread keeps at most kMaxCachedImplObjects
+// blocks per size class and frees its blocks when it exits.
+//
+// The blocks always come from the global operator new, so an object can be
+// freed on another thread than the one that created it, and the cache can be
+// disabled at any time.
+
+namespace c10 {
+namespace impl {
+
+constexpr size_t kMaxCachedImplObjects = 1024;
+
+C10_API void* allocate_impl_object(size_t size);
+C10_API void free_impl_object(void* ptr, size_t size) noexcept;
+
+} // namespace impl
+} // namespace c10
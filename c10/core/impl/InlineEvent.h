@@ -89,6 +89,11 @@ struct InlineEvent final {
     return backend_.queryEvent(event_);
   }
 
+  void synchronize() const {
+    if (!was_marked_for_recording_) return;
+    backend_.synchronizeEvent(event_);
+  }
+
 private:
   void* event_ = nullptr;
   T backend_;
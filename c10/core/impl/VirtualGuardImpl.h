@@ -40,6 +40,9 @@ public:
   Stream getDefaultStream(Device d) const override {
     return impl_->getDefaultStream(d);
   }
+  Stream getStreamFromGlobalPool(Device d, bool isHighPriority = false) const override {
+    return impl_->getStreamFromGlobalPool(d, isHighPriority);
+  }
   Stream exchangeStream(Stream s) const noexcept override {
     return impl_->exchangeStream(s);
   }
@@ -62,6 +65,9 @@ public:
   bool queryEvent(void* event) const override {
     return impl_->queryEvent(event);
   }
+  void synchronizeEvent(void* event) const override {
+    impl_->synchronizeEvent(event);
+  }
   void destroyEvent(
     void* event,
     const DeviceIndex device_index) const noexcept override {
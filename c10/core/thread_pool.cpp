@@ -1,7 +1,27 @@
 #include <c10/core/thread_pool.h>
 
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
 namespace c10 {
 
+namespace {
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(_M_X64)
+  _mm_pause();
+#else
+  std::this_thread::yield();
+#endif
+}
+
+} // namespace
+
 ThreadPool::ThreadPool(
       int pool_size,
       int numa_node_id,
@@ -11,7 +31,8 @@ ThreadPool::ThreadPool(
       complete_(true),
       available_(threads_.size()),
       total_(threads_.size()),
-      numa_node_id_(numa_node_id) {
+      numa_node_id_(numa_node_id),
+      spin_time_us_(defaultSpinTime().count()) {
   for (std::size_t i = 0; i < threads_.size(); ++i) {
     threads_[i] = std::thread([this, i, init_thread](){
       if (init_thread) {
@@ -65,7 +86,80 @@ void ThreadPool::run(std::function<void()> func) {
   // wake up and use the task.
   tasks_.emplace(std::move(func));
   complete_ = false;
-  condition_.notify_one();
+  wakeWorkers();
+}
+
+void ThreadPool::runBulk(std::vector<std::function<void()>> funcs) {
+  if (funcs.empty()) {
+    return;
+  }
+  if (threads_.size() == 0) {
+    throw std::runtime_error("No threads to run a task");
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (auto& func : funcs) {
+    tasks_.emplace(std::move(func));
+  }
+  complete_ = false;
+  wakeWorkers();
+}
+
+void ThreadPool::wakeWorkers() {
+  pending_.store(tasks_.size(), std::memory_order_release);
+  // Every spinning worker and every notified worker will take a task.
+  std::size_t awake = spinning_ + notified_;
+  if (tasks_.size() <= awake || notified_ >= sleeping_) {
+    return;
+  }
+  std::size_t to_notify =
+      std::min(tasks_.size() - awake, sleeping_ - notified_);
+  if (to_notify == sleeping_ - notified_) {
+    condition_.notify_all();
+  } else {
+    for (std::size_t i = 0; i < to_notify; ++i) {
+      condition_.notify_one();
+    }
+  }
+  notified_ += to_notify;
+  stats_.notifications += to_notify;
+}
+
+void ThreadPool::waitForTask(std::unique_lock<std::mutex>& lock) {
+  const auto spin_time =
+      std::chrono::microseconds(spin_time_us_.load(std::memory_order_relaxed));
+  if (spin_time.count() > 0) {
+    ++spinning_;
+    lock.unlock();
+    const auto deadline = std::chrono::steady_clock::now() + spin_time;
+    for (uint64_t i = 1; pending_.load(std::memory_order_acquire) == 0 && running_;
+         ++i) {
+      cpu_relax();
+      // Reading the clock is much slower than polling
+      if (i % 64 == 0 && std::chrono::steady_clock::now() >= deadline) {
+        break;
+      }
+    }
+    lock.lock();
+    --spinning_;
+    if (!tasks_.empty()) {
+      ++stats_.spin_hits;
+      return;
+    }
+  }
+
+  // Wait on condition variable while the task is empty and
+  // the pool is still running.
+  ++sleeping_;
+  while (tasks_.empty() && running_) {
+    condition_.wait(lock);
+    ++stats_.wakeups;
+    // Spurious wakeups may consume a notification, at worst waking another
+    // worker for nothing later on.
+    if (notified_ > 0) {
+      --notified_;
+    }
+  }
+  --sleeping_;
 }
 
 void ThreadPool::waitWorkComplete() {
@@ -75,13 +169,45 @@ void ThreadPool::waitWorkComplete() {
   }
 }
 
+void ThreadPool::setSpinTime(std::chrono::microseconds spin_time) {
+  spin_time_us_.store(spin_time.count(), std::memory_order_relaxed);
+}
+
+std::chrono::microseconds ThreadPool::spinTime() const {
+  return std::chrono::microseconds(spin_time_us_.load(std::memory_order_relaxed));
+}
+
+ThreadPool::Stats ThreadPool::stats() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void ThreadPool::resetStats() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  stats_ = Stats();
+}
+
+std::chrono::microseconds ThreadPool::defaultSpinTime() {
+  static const std::chrono::microseconds spin_time = []() {
+    const char* env = std::getenv("PYTORCH_THREAD_POOL_SPIN_US");
+    if (env == nullptr) {
+      return std::chrono::microseconds(0);
+    }
+    try {
+      return std::chrono::microseconds(std::max(std::stoll(env), 0LL));
+    } catch (const std::exception&) {
+      LOG(WARNING) << "Ignoring invalid PYTORCH_THREAD_POOL_SPIN_US=" << env;
+      return std::chrono::microseconds(0);
+    }
+  }();
+  return spin_time;
+}
+
 void ThreadPool::main_loop(std::size_t index) {
   std::unique_lock<std::mutex> lock(mutex_);
   while (running_) {
-    // Wait on condition variable while the task is empty and
-    // the pool is still running.
-    while (tasks_.empty() && running_) {
-      condition_.wait(lock);
+    if (tasks_.empty()) {
+      waitForTask(lock);
     }
     // If pool is no longer running, break out of loop.
     if (!running_) {
@@ -96,9 +222,18 @@ void ThreadPool::main_loop(std::size_t index) {
     {
       task_element_t tasks = std::move(tasks_.front());
       tasks_.pop();
+      pending_.store(tasks_.size(), std::memory_order_release);
       // Decrement count, indicating thread is no longer available.
       --available_;
 
+      const uint64_t latency_ns =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now() - tasks.submitted)
+              .count();
+      ++stats_.tasks;
+      stats_.total_latency_ns += latency_ns;
+      stats_.max_latency_ns = std::max(stats_.max_latency_ns, latency_ns);
+
       lock.unlock();
 
       // Run the task.
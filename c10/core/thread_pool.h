@@ -1,11 +1,14 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <functional>
 #include <mutex>
 #include <queue>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include <c10/util/Optional.h>
 #include <c10/util/intrusive_ptr.h>
@@ -19,6 +22,16 @@ class C10_API TaskThreadPoolBase {
  public:
   virtual void run(std::function<void()> func) = 0;
 
+  /**
+   * Run all of `funcs`. Pools may submit them at once, waking all the
+   * workers they need together instead of one per task.
+   */
+  virtual void runBulk(std::vector<std::function<void()>> funcs) {
+    for (auto& func : funcs) {
+      run(std::move(func));
+    }
+  }
+
   virtual size_t size() const = 0;
 
   /**
@@ -42,17 +55,44 @@ class C10_API TaskThreadPoolBase {
   }
 };
 
+// Idle workers first poll the queue for a while (the spin time) before they
+// sleep on a condition variable. Tasks submitted within that window are
+// picked up without the futex wakeup, which costs tens of microseconds per
+// worker and dominates short parallel regions. Submitters only notify the
+// sleeping workers needed for the tasks that spinning workers won't take.
+//
+// The spin time defaults to PYTORCH_THREAD_POOL_SPIN_US microseconds, or 0
+// (sleep immediately) when it isn't set.
 class C10_API ThreadPool : public c10::TaskThreadPoolBase {
+ public:
+  // Counters since the creation of the pool or the last resetStats()
+  struct Stats {
+    // Tasks started by the workers
+    uint64_t tasks = 0;
+    // Tasks found by a worker while spinning, i.e. without sleeping
+    uint64_t spin_hits = 0;
+    // Returns of workers from the condition variable
+    uint64_t wakeups = 0;
+    // Notifications of the condition variable by submitters
+    uint64_t notifications = 0;
+    // Time from the submission of tasks to their start, summed and maximum
+    uint64_t total_latency_ns = 0;
+    uint64_t max_latency_ns = 0;
+  };
+
  protected:
   struct task_element_t {
     bool run_with_id;
     const std::function<void()> no_id;
     const std::function<void(std::size_t)> with_id;
+    std::chrono::steady_clock::time_point submitted;
 
     explicit task_element_t(std::function<void()> f)
-      : run_with_id(false), no_id(std::move(f)), with_id(nullptr) {}
+      : run_with_id(false), no_id(std::move(f)), with_id(nullptr),
+        submitted(std::chrono::steady_clock::now()) {}
     explicit task_element_t(std::function<void(std::size_t)> f)
-      : run_with_id(true), no_id(nullptr), with_id(std::move(f)) {}
+      : run_with_id(true), no_id(nullptr), with_id(std::move(f)),
+        submitted(std::chrono::steady_clock::now()) {}
   };
 
   std::queue<task_element_t> tasks_;
@@ -66,6 +106,16 @@ class C10_API ThreadPool : public c10::TaskThreadPoolBase {
   std::size_t total_;
   int numa_node_id_;
 
+  // Size of tasks_, polled by spinning workers without the lock
+  std::atomic<std::size_t> pending_{0};
+  std::atomic<int64_t> spin_time_us_;
+  // Workers spinning or sleeping for a task, and notifications that sleeping
+  // workers haven't received yet. Guarded by mutex_.
+  std::size_t spinning_ = 0;
+  std::size_t sleeping_ = 0;
+  std::size_t notified_ = 0;
+  Stats stats_;
+
  public:
   ThreadPool() = delete;
 
@@ -84,6 +134,8 @@ class C10_API ThreadPool : public c10::TaskThreadPoolBase {
 
   void run(std::function<void()> func) override;
 
+  void runBulk(std::vector<std::function<void()>> funcs) override;
+
   template <typename Task>
   void runTaskWithID(Task task) {
     std::unique_lock<std::mutex> lock(mutex_);
@@ -92,15 +144,34 @@ class C10_API ThreadPool : public c10::TaskThreadPoolBase {
     // wake up and use the task.
     tasks_.emplace(static_cast<std::function<void(std::size_t)>>(task));
     complete_ = false;
-    condition_.notify_one();
+    wakeWorkers();
   }
 
   /// @brief Wait for queue to be empty
   void waitWorkComplete();
 
+  /// @brief Set how long idle workers poll for a task before sleeping
+  void setSpinTime(std::chrono::microseconds spin_time);
+
+  std::chrono::microseconds spinTime() const;
+
+  Stats stats();
+
+  void resetStats();
+
+  static std::chrono::microseconds defaultSpinTime();
+
  private:
   // @brief Entry point for pool threads.
   void main_loop(std::size_t index);
+
+  // Wakes the sleeping workers needed for the queued tasks. Must be called
+  // with the lock held.
+  void wakeWorkers();
+
+  // Waits until there is a task or the pool stops, spinning first. Must be
+  // called with the lock held, which it holds again on return.
+  void waitForTask(std::unique_lock<std::mutex>& lock);
 };
 
 class C10_API TaskThreadPool : public c10::ThreadPool {
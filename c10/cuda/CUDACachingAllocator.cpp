@@ -4,10 +4,12 @@
 #include <c10/cuda/CUDAException.h>
 #include <c10/cuda/CUDAFunctions.h>
 #include <c10/util/UniqueVoidPtr.h>
+#include <c10/util/llvmMathExtras.h>
 
 #include <cuda_runtime_api.h>
 #include <algorithm>
 #include <bitset>
+#include <cstdlib>
 #include <deque>
 #include <iterator>
 #include <map>
@@ -51,12 +53,59 @@ namespace CUDACachingAllocator {
 // ensure that the block is not reused before each recorded stream completes
 // work.
 //
+// Expandable segments (PYTORCH_CUDA_EXPANDABLE_SEGMENTS=1):
+//
+// - Instead of a new cudaMalloc for every large-pool miss, each (device,
+//   stream) pair reserves one range of virtual addresses, as large as the
+//   device memory, and maps physical memory into it on demand with the CUDA
+//   virtual memory management API (cuMemCreate/cuMemMap).
+// - A miss grows the segment at its end by just enough granules (usually
+//   2 MiB) to satisfy the request; if the last block of the segment is free
+//   it is extended in place. Requests are not rounded up to kLargeBuffer.
+// - All large blocks of a stream are therefore neighbours in a single
+//   segment and merge with each other when freed, instead of being stranded
+//   in separate, partially used cudaMalloc segments.
+// - Releasing cached memory unmaps the free granules at the end of the
+//   segment. Free blocks in the middle stay mapped until everything after
+//   them is freed as well.
+// - The small pool keeps using kSmallBuffer cudaMalloc segments. Memory in
+//   expandable segments cannot be shared with cudaIpcGetMemHandle.
+//
+// Private pools (createPool/setStreamPool):
+//
+// - Allocations on a stream assigned to a private pool are served from, and
+//   freed to, that pool only. Its blocks never mix with the default pools or
+//   with other private pools.
+// - Any stream assigned to the pool can reuse a block freed by another. When
+//   a block is freed, an event is recorded on its allocation stream and on
+//   every stream passed to recordStream(); the next stream to take the block
+//   waits on those events with cudaStreamWaitEvent. The block is reusable
+//   immediately and the host never polls the events, unlike the
+//   insert_events/process_events path of the default pools.
+// - Private pools do not use expandable segments.
+//
+// CUDA graph capture (notifyCaptureBegin/notifyCaptureEnd):
+//
+// - The capture stream allocates from the private pool of the graph. The
+//   pool is marked as a graph pool: its free blocks are still written by
+//   every replay, so emptyCache() and the out-of-memory retry never return
+//   them to the system. They are only released by releasePool().
+// - No call that would break or invalidate the capture is made while a
+//   capture is underway: outstanding events are not queried, events for
+//   blocks of the default pools freed with stream uses are only recorded
+//   once all captures are over, and failed allocations are not retried
+//   after freeing cached memory.
+//
 
 
 namespace {
 
 using stream_set = std::unordered_set<cuda::CUDAStream>;
 
+#if !defined(__HIP_PLATFORM_HCC__) && defined(CUDA_VERSION) && CUDA_VERSION >= 10020
+#define C10_CUDA_HAS_VMM
+#endif
+
 constexpr size_t kMinBlockSize = 512;       // all sizes are rounded to at least 512 bytes
 constexpr size_t kSmallSize = 1048576;      // largest "small" allocation is 1 MiB
 constexpr size_t kSmallBuffer = 2097152;    // "small" allocations are packed in 2 MiB blocks
@@ -97,9 +146,180 @@ void update_stat_array(StatArray& stat_array, int64_t amount, const StatTypes& s
   }
 }
 
+bool expandable_segments_enabled() {
+  static const bool enabled = []() {
+    const char* env = std::getenv("PYTORCH_CUDA_EXPANDABLE_SEGMENTS");
+    if (env == nullptr || std::string(env) != "1") {
+      return false;
+    }
+#ifdef C10_CUDA_HAS_VMM
+    return true;
+#else
+    TORCH_WARN(
+        "PYTORCH_CUDA_EXPANDABLE_SEGMENTS=1 requires the CUDA 10.2 virtual "
+        "memory management API; using regular segments instead.");
+    return false;
+#endif
+  }();
+  return enabled;
+}
+
+#ifdef C10_CUDA_HAS_VMM
+#define C10_CUDA_DRIVER_CHECK(EXPR)                            \
+  do {                                                         \
+    CUresult __err = EXPR;                                     \
+    if (__err != CUDA_SUCCESS) {                               \
+      const char* err_str = nullptr;                           \
+      cuGetErrorString(__err, &err_str);                       \
+      TORCH_CHECK(false, "CUDA driver error: ",                \
+                  err_str ? err_str : "unknown error");         \
+    }                                                          \
+  } while (0)
+#endif
+
 struct Block;
+
+// A reserved range of device virtual addresses of which a prefix is backed
+// by physical memory, one granule at a time. See the note on expandable
+// segments above.
+struct ExpandableSegment {
+  int           device;
+  cudaStream_t  stream;
+  size_t        granularity = 0;  // size of each physical allocation
+  size_t        max_size = 0;     // size of the reserved address range
+  char*         base = nullptr;   // start of the reserved address range
+  Block*        tail = nullptr;   // block ending at base + size(), if any
+#ifdef C10_CUDA_HAS_VMM
+  std::vector<CUmemGenericAllocationHandle> handles; // one per mapped granule
+#endif
+
+  ExpandableSegment(int device, cudaStream_t stream) :
+    device(device), stream(stream) {
+#ifdef C10_CUDA_HAS_VMM
+    size_t device_free;
+    size_t device_total;
+    C10_CUDA_CHECK(cudaMemGetInfo(&device_free, &device_total));
+    C10_CUDA_DRIVER_CHECK(cuMemGetAllocationGranularity(
+        &granularity, &prop(), CU_MEM_ALLOC_GRANULARITY_MINIMUM));
+    max_size = granularity * ((device_total + granularity - 1) / granularity);
+    CUdeviceptr ptr;
+    C10_CUDA_DRIVER_CHECK(cuMemAddressReserve(&ptr, max_size, 0, 0, 0));
+    base = reinterpret_cast<char*>(ptr);
+#else
+    TORCH_INTERNAL_ASSERT(false, "expandable segments are not supported");
+#endif
+  }
+
+  ExpandableSegment(const ExpandableSegment&) = delete;
+  ExpandableSegment& operator=(const ExpandableSegment&) = delete;
+
+  ~ExpandableSegment() {
+#ifdef C10_CUDA_HAS_VMM
+    // The allocator is only destroyed at exit, when the driver may already
+    // be gone, so errors are ignored.
+    if (!handles.empty()) {
+      cuMemUnmap(reinterpret_cast<CUdeviceptr>(base), size());
+      for (auto handle : handles) {
+        cuMemRelease(handle);
+      }
+    }
+    cuMemAddressFree(reinterpret_cast<CUdeviceptr>(base), max_size);
+#endif
+  }
+
+  // bytes currently backed by physical memory
+  size_t size() const {
+#ifdef C10_CUDA_HAS_VMM
+    return handles.size() * granularity;
+#else
+    return 0;
+#endif
+  }
+
+  size_t round_up(size_t nbytes) const {
+    return granularity * ((nbytes + granularity - 1) / granularity);
+  }
+
+  /** maps nbytes (a multiple of granularity) at the end; returns false if out of memory */
+  bool grow(size_t nbytes) {
+#ifdef C10_CUDA_HAS_VMM
+    if (size() + nbytes > max_size) {
+      return false;
+    }
+    const size_t old_size = size();
+    for (size_t offset = 0; offset < nbytes; offset += granularity) {
+      CUmemGenericAllocationHandle handle;
+      CUresult err = cuMemCreate(&handle, granularity, &prop(), 0);
+      if (err == CUDA_ERROR_OUT_OF_MEMORY) {
+        unmap(old_size, size() - old_size);
+        return false;
+      }
+      C10_CUDA_DRIVER_CHECK(err);
+      C10_CUDA_DRIVER_CHECK(cuMemMap(
+          reinterpret_cast<CUdeviceptr>(base + size()), granularity, 0, handle, 0));
+      handles.push_back(handle);
+    }
+    CUmemAccessDesc desc = {};
+    desc.location = prop().location;
+    desc.flags = CU_MEM_ACCESS_FLAGS_PROT_READWRITE;
+    C10_CUDA_DRIVER_CHECK(cuMemSetAccess(
+        reinterpret_cast<CUdeviceptr>(base + old_size), nbytes, &desc, 1));
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  /** unmaps the last nbytes (a multiple of granularity) */
+  void shrink(size_t nbytes) {
+    cuda::CUDAGuard device_guard(device);
+    // cuMemUnmap does not wait for kernels still using the memory.
+    C10_CUDA_CHECK(cudaStreamSynchronize(stream));
+    unmap(size() - nbytes, nbytes);
+  }
+
+ private:
+  void unmap(size_t offset, size_t nbytes) {
+#ifdef C10_CUDA_HAS_VMM
+    if (nbytes == 0) {
+      return;
+    }
+    C10_CUDA_DRIVER_CHECK(cuMemUnmap(
+        reinterpret_cast<CUdeviceptr>(base + offset), nbytes));
+    for (size_t i = offset / granularity; i < handles.size(); ++i) {
+      C10_CUDA_DRIVER_CHECK(cuMemRelease(handles[i]));
+    }
+    handles.resize(offset / granularity);
+#endif
+  }
+
+#ifdef C10_CUDA_HAS_VMM
+  const CUmemAllocationProp& prop() {
+    if (prop_.location.type != CU_MEM_LOCATION_TYPE_DEVICE) {
+      prop_.type = CU_MEM_ALLOCATION_TYPE_PINNED;
+      prop_.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
+      prop_.location.id = device;
+    }
+    return prop_;
+  }
+
+  CUmemAllocationProp prop_ = {};
+#endif
+};
+
+struct PrivatePool;
+
 typedef bool (*Comparison)(const Block*, const Block*);
-typedef std::set<Block*, Comparison> BlockPool;
+
+struct BlockPool : public std::set<Block*, Comparison> {
+  BlockPool(Comparison comparator, bool small, PrivatePool* owner = nullptr) :
+    std::set<Block*, Comparison>(comparator), is_small(small), owner(owner) {}
+
+  const bool is_small;        // holds blocks of at most kSmallSize
+  PrivatePool* const owner;   // owning private pool, if any
+};
+
+using SharedEvent = std::shared_ptr<std::remove_pointer<cudaEvent_t>::type>;
 
 struct Block {
   int           device;      // gpu
@@ -112,15 +332,21 @@ struct Block {
   Block*        prev;        // prev block if split from a larger allocation
   Block*        next;        // next block if split from a larger allocation
   int           event_count; // number of outstanding CUDA events
+  ExpandableSegment* expandable; // owning segment if it is expandable
+  // events recorded when the block was freed to a private pool, with the
+  // streams they were recorded on
+  std::vector<std::pair<cudaStream_t, SharedEvent>> free_events;
 
   Block(int device, cudaStream_t stream, size_t size, BlockPool* pool, void* ptr) :
     device(device), stream(stream), stream_uses(), size(size), pool(pool),
-    ptr(ptr), allocated(0), prev(nullptr), next(nullptr), event_count(0) { }
+    ptr(ptr), allocated(0), prev(nullptr), next(nullptr), event_count(0),
+    expandable(nullptr) { }
 
   // constructor for search key
   Block(int device, cudaStream_t stream, size_t size) :
     device(device), stream(stream), stream_uses(), size(size), pool(nullptr),
-    ptr(nullptr), allocated(0), prev(nullptr), next(nullptr), event_count(0) { }
+    ptr(nullptr), allocated(0), prev(nullptr), next(nullptr), event_count(0),
+    expandable(nullptr) { }
 
   bool is_split() const {
     return (prev != nullptr) || (next != nullptr);
@@ -141,6 +367,39 @@ static bool BlockComparator(const Block* a, const Block* b)
   return (uintptr_t)a->ptr < (uintptr_t)b->ptr;
 }
 
+// Blocks in a private pool may be reused on any stream, so the stream does
+// not participate in the order.
+static bool PrivatePoolBlockComparator(const Block* a, const Block* b)
+{
+  if (a->device != b->device) {
+    return a->device < b->device;
+  }
+  if (a->size != b->size) {
+    return a->size < b->size;
+  }
+  return (uintptr_t)a->ptr < (uintptr_t)b->ptr;
+}
+
+struct PrivatePool {
+  explicit PrivatePool(MempoolId id) :
+    id(id),
+    large_blocks(PrivatePoolBlockComparator, false, this),
+    small_blocks(PrivatePoolBlockComparator, true, this) {}
+
+  const MempoolId id;
+  // unallocated cached blocks larger than 1 MB
+  BlockPool large_blocks;
+  // unallocated cached blocks 1 MB or smaller
+  BlockPool small_blocks;
+  // number of blocks handed out and not yet freed
+  int allocated_count = 0;
+  // set by releasePool(): the pool is destroyed once allocated_count drops to 0
+  bool released = false;
+  // set by notifyCaptureBegin(): the pool holds the memory of a CUDA graph,
+  // and its cached blocks are kept until the pool is released
+  bool graph = false;
+};
+
 static std::string format_size(uint64_t size) {
   std::ostringstream os;
   os.precision(2);
@@ -181,17 +440,35 @@ class THCCachingAllocator {
   // unallocated cached blocks 1 MB or smaller
   BlockPool small_blocks;
 
+  // private pools by id, and the pool each assigned stream allocates from
+  std::unordered_map<MempoolId, std::unique_ptr<PrivatePool>> private_pools;
+  std::unordered_map<cudaStream_t, PrivatePool*> stream_to_private_pool;
+  MempoolId next_pool_id = 1;
+
+  // destroyed events kept for reuse, by device
+  std::vector<std::vector<cudaEvent_t>> free_event_cache;
+
   // allocated blocks by device pointer
   std::unordered_map<void*, Block*> allocated_blocks;
 
   // outstanding cuda events
   std::deque<std::pair<cudaEvent_t, Block*>> cuda_events;
 
+  // number of CUDA graph captures underway
+  int captures_underway = 0;
+
+  // blocks freed with stream uses during a capture, whose events are
+  // recorded once no capture is underway
+  std::vector<Block*> needs_events_deferred_until_no_capture;
+
+  // expandable segments by device and stream
+  std::map<std::pair<int, cudaStream_t>, std::unique_ptr<ExpandableSegment>> expandable_segments;
+
  public:
 
   THCCachingAllocator() :
-      large_blocks(BlockComparator),
-      small_blocks(BlockComparator) {}
+      large_blocks(BlockComparator, false),
+      small_blocks(BlockComparator, true) {}
 
   std::mutex* getCudaFreeMutex() const {
     return &cuda_free_mutex;
@@ -209,12 +486,15 @@ class THCCachingAllocator {
     C10_CUDA_CHECK(cudaGetDevice(&device));
 
     // process outstanding cudaEvents
-    process_events();
+    if (captures_underway == 0) {
+      insert_deferred_events();
+      process_events();
+    }
 
     size = round_size(size);
 
     Block search_key(device, stream, size);
-    auto& pool = get_pool(size);
+    auto& pool = get_pool(size, stream);
 
     DeviceStats& stats = get_stats_for_device(device);
     StatTypes stat_types;
@@ -224,9 +504,12 @@ class THCCachingAllocator {
     auto find_free_block = [&]()->Block*{
       auto it = pool.lower_bound(&search_key);
       if (it != pool.end() && (*it)->device == device &&
-          (*it)->stream == stream) {
+          (pool.owner || (*it)->stream == stream)) {
         Block* block = *it;
         pool.erase(it);
+        if (pool.owner) {
+          wait_free_events(block, stream);
+        }
         return block;
       }
       return nullptr;
@@ -246,13 +529,20 @@ class THCCachingAllocator {
     if (block == nullptr) {
       void* ptr;
       size_t alloc_size = get_allocation_size(size);
-      cudaError_t err = cuda_malloc_with_retry(device, &ptr, alloc_size);
+      cudaError_t err;
+      if (&pool == &large_blocks && expandable_segments_enabled()) {
+        block = expand_segment_with_retry(device, stream, size, &alloc_size);
+        err = block ? cudaSuccess : cudaErrorMemoryAllocation;
+      } else {
+        err = cuda_malloc_with_retry(device, &ptr, alloc_size);
+        if (err == cudaSuccess) {
+          block = new Block(device, stream, alloc_size, &pool, ptr);
+          update_stat_array(stats.segment, 1, stat_types);
+          update_stat_array(stats.reserved_bytes, alloc_size, stat_types);
+        }
+      }
 
-      if (err == cudaSuccess) {
-        block = new Block(device, stream, alloc_size, &pool, ptr);
-        update_stat_array(stats.segment, 1, stat_types);
-        update_stat_array(stats.reserved_bytes, alloc_size, stat_types);
-      } else if (err == cudaErrorMemoryAllocation) {
+      if (err == cudaErrorMemoryAllocation) {
         cudaGetLastError();  // clear CUDA error
 
         size_t device_free;
@@ -300,6 +590,7 @@ class THCCachingAllocator {
       remaining = block;
 
       block = new Block(device, stream, size, &pool, block->ptr);
+      block->expandable = remaining->expandable;
       block->prev = remaining->prev;
       if (block->prev) {
         block->prev->next = block;
@@ -327,6 +618,12 @@ class THCCachingAllocator {
     }
 
     block->allocated = true;
+    if (pool.owner) {
+      // Subsequent events only concern this allocation.
+      block->stream = stream;
+      block->free_events.clear();
+      pool.owner->allocated_count += 1;
+    }
     allocated_blocks[block->ptr] = block;
 
     *devPtr = block->ptr;
@@ -335,6 +632,9 @@ class THCCachingAllocator {
     update_stat_array(stats.allocated_bytes, block->size, stat_types);
     update_stat_array(stats.active, 1, stat_types);
     update_stat_array(stats.active_bytes, block->size, stat_types);
+
+    c10::reportMemoryUsageToProfiler(
+        block->ptr, block->size, c10::Device(c10::DeviceType::CUDA, device));
   }
 
   void free(void* ptr)
@@ -360,13 +660,83 @@ class THCCachingAllocator {
     update_stat_array(stats.allocation, -1, {stat_types});
     update_stat_array(stats.allocated_bytes, -block->size, {stat_types});
 
-    if (!block->stream_uses.empty()) {
-      insert_events(block);
+    c10::reportMemoryUsageToProfiler(
+        block->ptr,
+        -static_cast<int64_t>(block->size),
+        c10::Device(c10::DeviceType::CUDA, block->device));
+
+    if (PrivatePool* private_pool = block->pool->owner) {
+      record_free_events(block);
+      free_block(block);
+      private_pool->allocated_count -= 1;
+      if (private_pool->released) {
+        release_private_pool(private_pool);
+      }
+    } else if (!block->stream_uses.empty()) {
+      if (C10_UNLIKELY(captures_underway > 0)) {
+        needs_events_deferred_until_no_capture.push_back(block);
+      } else {
+        insert_deferred_events();
+        insert_events(block);
+      }
     } else {
       free_block(block);
     }
   }
 
+  MempoolId createPool() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    const MempoolId id = next_pool_id++;
+    private_pools[id].reset(new PrivatePool(id));
+    return id;
+  }
+
+  void setStreamPool(cudaStream_t stream, MempoolId id) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (id == 0) {
+      stream_to_private_pool.erase(stream);
+      return;
+    }
+    auto it = private_pools.find(id);
+    TORCH_CHECK(it != private_pools.end() && !it->second->released,
+        "setStreamPool: invalid memory pool id ", id);
+    stream_to_private_pool[stream] = it->second.get();
+  }
+
+  void notifyCaptureBegin(cudaStream_t stream, MempoolId id) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = private_pools.find(id);
+    TORCH_CHECK(it != private_pools.end() && !it->second->released,
+        "notifyCaptureBegin: invalid memory pool id ", id);
+    it->second->graph = true;
+    stream_to_private_pool[stream] = it->second.get();
+    captures_underway++;
+  }
+
+  void notifyCaptureEnd(cudaStream_t stream) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    TORCH_INTERNAL_ASSERT(captures_underway > 0);
+    captures_underway--;
+    stream_to_private_pool.erase(stream);
+  }
+
+  void releasePool(MempoolId id) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = private_pools.find(id);
+    TORCH_CHECK(it != private_pools.end() && !it->second->released,
+        "releasePool: invalid memory pool id ", id);
+    PrivatePool* private_pool = it->second.get();
+    for (auto s = stream_to_private_pool.begin(); s != stream_to_private_pool.end();) {
+      if (s->second == private_pool) {
+        s = stream_to_private_pool.erase(s);
+      } else {
+        ++s;
+      }
+    }
+    private_pool->released = true;
+    release_private_pool(private_pool);
+  }
+
   void* getBaseAllocation(void* ptr, size_t* outSize) {
     std::lock_guard<std::recursive_mutex> lock(mutex);
     Block* block = find_allocated_block(ptr);
@@ -419,9 +789,20 @@ class THCCachingAllocator {
   /** returns cached blocks to the system allocator **/
   void emptyCache() {
     std::lock_guard<std::recursive_mutex> lock(mutex);
+    TORCH_CHECK(captures_underway == 0,
+        "emptyCache: the cache cannot be emptied during a CUDA graph capture");
+    insert_deferred_events();
     synchronize_and_free_events(nullopt);
     free_blocks(large_blocks, large_blocks.begin(), large_blocks.end());
     free_blocks(small_blocks, small_blocks.begin(), small_blocks.end());
+    for (auto& item : private_pools) {
+      PrivatePool& private_pool = *item.second;
+      if (private_pool.graph) {
+        continue;
+      }
+      free_blocks(private_pool.large_blocks, private_pool.large_blocks.begin(), private_pool.large_blocks.end());
+      free_blocks(private_pool.small_blocks, private_pool.small_blocks.begin(), private_pool.small_blocks.end());
+    }
   }
 
   /** Retrieves info (total size + largest block) of the memory cache **/
@@ -439,7 +820,14 @@ class THCCachingAllocator {
   /** Returns a copy of the memory allocator stats for the device **/
   DeviceStats getStatsForDevice(int dev_id) {
     std::lock_guard<std::recursive_mutex> lock(mutex);
-    return get_stats_for_device(dev_id);
+    DeviceStats stats = get_stats_for_device(dev_id);
+    free_block_histogram_aux(small_blocks, dev_id, stats);
+    free_block_histogram_aux(large_blocks, dev_id, stats);
+    for (auto& item : private_pools) {
+      free_block_histogram_aux(item.second->small_blocks, dev_id, stats);
+      free_block_histogram_aux(item.second->large_blocks, dev_id, stats);
+    }
+    return stats;
   }
 
   /** Resets the historical accumulation stats for the device **/
@@ -494,7 +882,8 @@ class THCCachingAllocator {
       SegmentInfo& segment_info = result.back();
       segment_info.device = head_block->device;
       segment_info.address = reinterpret_cast<int64_t>(head_block->ptr);
-      segment_info.is_large = (head_block->pool == &large_blocks);
+      segment_info.is_large = !head_block->pool->is_small;
+      segment_info.is_expandable = (head_block->expandable != nullptr);
 
       const Block* block = head_block;
       while (block != nullptr) {
@@ -543,6 +932,11 @@ class THCCachingAllocator {
     std::vector<const Block*> blocks;
     blocks.insert(blocks.end(), small_blocks.begin(), small_blocks.end());
     blocks.insert(blocks.end(), large_blocks.begin(), large_blocks.end());
+    for (const auto& item : private_pools) {
+      const PrivatePool& private_pool = *item.second;
+      blocks.insert(blocks.end(), private_pool.small_blocks.begin(), private_pool.small_blocks.end());
+      blocks.insert(blocks.end(), private_pool.large_blocks.begin(), private_pool.large_blocks.end());
+    }
     for (const auto& item : allocated_blocks) {
       blocks.push_back(item.second);
     }
@@ -608,6 +1002,13 @@ class THCCachingAllocator {
       }
     }
 
+    if (src->expandable && src->expandable->tail == src) {
+      src->expandable->tail = dst;
+    }
+    // whoever reuses the merged block must wait for uses of both parts
+    dst->free_events.insert(
+        dst->free_events.end(), src->free_events.begin(), src->free_events.end());
+
     const size_t subsumed_size = src->size;
     dst->size += subsumed_size;
     pool.erase(src);
@@ -616,7 +1017,14 @@ class THCCachingAllocator {
     return subsumed_size;
   }
 
-  BlockPool& get_pool(size_t size) {
+  BlockPool& get_pool(size_t size, cudaStream_t stream) {
+    if (!stream_to_private_pool.empty()) {
+      auto it = stream_to_private_pool.find(stream);
+      if (it != stream_to_private_pool.end()) {
+        PrivatePool* private_pool = it->second;
+        return size <= kSmallSize ? private_pool->small_blocks : private_pool->large_blocks;
+      }
+    }
     if (size <= kSmallSize) {
       return small_blocks;
     } else {
@@ -625,23 +1033,72 @@ class THCCachingAllocator {
   }
 
   StatType get_stat_type_for_pool(const BlockPool& pool) {
-    if (&pool == &small_blocks) {
-      return StatType::SMALL_POOL;
-    } else if (&pool == &large_blocks) {
-      return StatType::LARGE_POOL;
-    } else {
-      AT_ERROR("get_stat_type_for_pool: invalid pool");
-    }
+    return pool.is_small ? StatType::SMALL_POOL : StatType::LARGE_POOL;
   }
 
   bool should_split(const Block* block, size_t size) {
     size_t remaining = block->size - size;
-    if (block->pool == &small_blocks) {
+    if (block->pool->is_small) {
       return remaining >= kMinBlockSize;
-    } else if (block->pool == &large_blocks) {
+    } else {
       return remaining > kSmallSize;
+    }
+  }
+
+  SharedEvent create_event(int device) {
+    if ((size_t) device >= free_event_cache.size()) {
+      free_event_cache.resize(device + 1);
+    }
+    cudaEvent_t event;
+    auto& cached = free_event_cache[device];
+    if (!cached.empty()) {
+      event = cached.back();
+      cached.pop_back();
     } else {
-      AT_ERROR("should_split: invalid pool");
+      C10_CUDA_CHECK(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+    }
+    // Events are only dropped by blocks while the allocator mutex is held.
+    return SharedEvent(event, [this, device](cudaEvent_t event) {
+      free_event_cache[device].push_back(event);
+    });
+  }
+
+  /** records the events that a reuse of a block freed to a private pool waits on */
+  void record_free_events(Block* block)
+  {
+    stream_set streams(std::move(block->stream_uses));
+    AT_ASSERT(block->stream_uses.empty());
+    cuda::CUDAGuard device_guard(block->device);
+    SharedEvent event = create_event(block->device);
+    C10_CUDA_CHECK(cudaEventRecord(event.get(), block->stream));
+    block->free_events.emplace_back(block->stream, std::move(event));
+    for (const auto& stream : streams) {
+      device_guard.set_index(stream.device_index());
+      SharedEvent use_event = create_event(stream.device_index());
+      C10_CUDA_CHECK(cudaEventRecord(use_event.get(), stream.stream()));
+      block->free_events.emplace_back(stream.stream(), std::move(use_event));
+    }
+  }
+
+  /** makes stream wait for all uses of a block taken from a private pool */
+  void wait_free_events(const Block* block, cudaStream_t stream)
+  {
+    for (const auto& e : block->free_events) {
+      // work on the same stream is already ordered
+      if (e.first != stream) {
+        C10_CUDA_CHECK(cudaStreamWaitEvent(stream, e.second.get(), 0));
+      }
+    }
+  }
+
+  /** frees the cached blocks of a released private pool, and the pool itself once it is unused */
+  void release_private_pool(PrivatePool* private_pool)
+  {
+    free_blocks(private_pool->large_blocks, private_pool->large_blocks.begin(), private_pool->large_blocks.end());
+    free_blocks(private_pool->small_blocks, private_pool->small_blocks.begin(), private_pool->small_blocks.end());
+    if (private_pool->allocated_count == 0) {
+      AT_ASSERT(private_pool->large_blocks.empty() && private_pool->small_blocks.empty());
+      private_pools.erase(private_pool->id);
     }
   }
 
@@ -669,7 +1126,9 @@ class THCCachingAllocator {
     // and retries.
     cudaError_t err = cudaMalloc(devPtr, size);
 
-    if (err != cudaSuccess) {
+    // Freeing memory synchronizes the device, which is not allowed during
+    // a capture.
+    if (err != cudaSuccess && captures_underway == 0) {
       DeviceStats& stats = get_stats_for_device(device);
       stats.num_alloc_retries += 1;
       cudaGetLastError();  // reset the last CUDA error
@@ -683,10 +1142,128 @@ class THCCachingAllocator {
     return cudaSuccess;
   }
 
+  ExpandableSegment& get_expandable_segment(int device, cudaStream_t stream) {
+    auto& segment = expandable_segments[std::make_pair(device, stream)];
+    if (!segment) {
+      segment.reset(new ExpandableSegment(device, stream));
+    }
+    return *segment;
+  }
+
+  /** maps enough memory at the end of the stream's expandable segment to
+      hold size bytes, and returns a free block of at least that size that
+      is not in the pool. Returns nullptr if the device is out of memory. */
+  Block* expand_segment(int device, cudaStream_t stream, size_t size, size_t* mapped)
+  {
+    ExpandableSegment& segment = get_expandable_segment(device, stream);
+    Block* tail = segment.tail;
+    const bool extend_tail = tail && !tail->allocated && tail->event_count == 0;
+    // the caller found no free block large enough, so a free tail is too small
+    AT_ASSERT(!extend_tail || tail->size < size);
+
+    const size_t old_size = segment.size();
+    *mapped = segment.round_up(extend_tail ? size - tail->size : size);
+    if (!segment.grow(*mapped)) {
+      return nullptr;
+    }
+
+    DeviceStats& stats = get_stats_for_device(device);
+    StatTypes stat_types;
+    stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
+    stat_types[static_cast<size_t>(StatType::LARGE_POOL)] = true;
+    if (old_size == 0) {
+      update_stat_array(stats.segment, 1, stat_types);
+    }
+    update_stat_array(stats.reserved_bytes, *mapped, stat_types);
+
+    if (extend_tail) {
+      large_blocks.erase(tail);
+      if (tail->is_split()) {
+        update_stat_array(stats.inactive_split_bytes, *mapped, stat_types);
+      }
+      tail->size += *mapped;
+      return tail;
+    }
+
+    Block* block = new Block(device, stream, *mapped, &large_blocks, segment.base + old_size);
+    block->expandable = &segment;
+    if (tail) {
+      // The new block is an inactive split block until malloc() takes it.
+      tail->next = block;
+      block->prev = tail;
+      update_stat_array(stats.inactive_split, 1, stat_types);
+      update_stat_array(stats.inactive_split_bytes, block->size, stat_types);
+    }
+    segment.tail = block;
+    return block;
+  }
+
+  Block* expand_segment_with_retry(int device, cudaStream_t stream, size_t size, size_t* mapped)
+  {
+    // Try to grow the segment. If that fails, release all free cached
+    // memory on the device and retry.
+    Block* block = expand_segment(device, stream, size, mapped);
+    if (!block && captures_underway == 0) {
+      DeviceStats& stats = get_stats_for_device(device);
+      stats.num_alloc_retries += 1;
+      free_cached_blocks(device);
+      block = expand_segment(device, stream, size, mapped);
+    }
+    return block;
+  }
+
+  /** unmaps the granules covered by a free block at the end of an
+      expandable segment. The block must not be in a pool; whatever is left
+      of it is put back into the large pool. */
+  void release_expandable_tail(Block* block)
+  {
+    ExpandableSegment& segment = *block->expandable;
+    AT_ASSERT(segment.tail == block && !block->allocated && block->event_count == 0);
+
+    const size_t offset = static_cast<char*>(block->ptr) - segment.base;
+    // bytes of the block that share a granule with the block before it
+    const size_t keep = segment.round_up(offset) - offset;
+    const size_t released = block->size - keep;
+    if (released == 0) {
+      large_blocks.insert(block);
+      return;
+    }
+    segment.shrink(released);
+
+    DeviceStats& stats = get_stats_for_device(block->device);
+    StatTypes stat_types;
+    stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
+    stat_types[static_cast<size_t>(StatType::LARGE_POOL)] = true;
+    update_stat_array(stats.reserved_bytes, -released, stat_types);
+
+    if (keep > 0) {
+      // A block that starts inside a granule always has a predecessor.
+      AT_ASSERT(block->prev);
+      block->size = keep;
+      update_stat_array(stats.inactive_split_bytes, -released, stat_types);
+      large_blocks.insert(block);
+      return;
+    }
+
+    Block* prev = block->prev;
+    if (prev) {
+      // prev is in use; a free prev would have been merged into block.
+      AT_ASSERT(prev->allocated || prev->event_count > 0);
+      prev->next = nullptr;
+      update_stat_array(stats.inactive_split, -1, stat_types);
+      update_stat_array(stats.inactive_split_bytes, -block->size, stat_types);
+    } else {
+      update_stat_array(stats.segment, -1, stat_types);
+    }
+    segment.tail = prev;
+    delete block;
+  }
+
   void free_cached_blocks(int device)
   {
     // First ensure that all blocks that can't currently be allocated due to
     // outstanding events are returned to the pool.
+    insert_deferred_events();
     synchronize_and_free_events(device);
 
     // Free all non-split cached blocks on device
@@ -701,14 +1278,33 @@ class THCCachingAllocator {
         small_blocks,
         small_blocks.lower_bound(&lower_bound),
         small_blocks.lower_bound(&upper_bound));
+    for (auto& item : private_pools) {
+      if (item.second->graph) {
+        continue;
+      }
+      for (BlockPool* pool : {&item.second->large_blocks, &item.second->small_blocks}) {
+        free_blocks(
+            *pool,
+            pool->lower_bound(&lower_bound),
+            pool->lower_bound(&upper_bound));
+      }
+    }
   }
 
   void free_blocks(BlockPool& blocks, BlockPool::iterator it, BlockPool::iterator end)
   {
-    // Frees all non-split blocks between `it` and `end`
+    // Frees all non-split blocks between `it` and `end`, and unmaps the
+    // free ends of expandable segments
     while (it != end) {
       Block* block = *it;
-      if (!block->prev && !block->next) {
+      if (block->expandable) {
+        auto cur = it;
+        ++it;
+        if (!block->next) {
+          blocks.erase(cur);
+          release_expandable_tail(block);
+        }
+      } else if (!block->prev && !block->next) {
         C10_CUDA_CHECK(cudaFree((void*)block->ptr));
 
         DeviceStats& stats = get_stats_for_device(block->device);
@@ -783,6 +1379,17 @@ class THCCachingAllocator {
     C10_CUDA_CHECK(cudaSetDevice(prev_device));
   }
 
+  void insert_deferred_events()
+  {
+    if (C10_LIKELY(needs_events_deferred_until_no_capture.empty())) {
+      return;
+    }
+    for (Block* block : needs_events_deferred_until_no_capture) {
+      insert_events(block);
+    }
+    needs_events_deferred_until_no_capture.clear();
+  }
+
   void process_events()
   {
     // Process outstanding cudaEvents. Events that are completed are removed
@@ -814,6 +1421,21 @@ class THCCachingAllocator {
     }
   }
 
+  // Adds all memory blocks for given device in given pool to the free block histogram
+  void free_block_histogram_aux(BlockPool& blocks, int dev_id, DeviceStats& stats)
+  {
+    Block search_key(dev_id, 0, 0);
+    auto it = blocks.lower_bound(&search_key);
+    for (; it != blocks.end() && *it && (*it)->device == dev_id; ++it) {
+      const int64_t blocksize = (*it)->size;
+      const size_t bucket = std::min<size_t>(
+          llvm::Log2_64(blocksize / kMinBlockSize), kNumFreeBlockBuckets - 1);
+      stats.free_block_count[bucket] += 1;
+      stats.free_block_bytes[bucket] += blocksize;
+      stats.largest_free_block = std::max(stats.largest_free_block, blocksize);
+    }
+  }
+
   // Accumulates sizes of all memory blocks for given device in given pool
   void cache_info_aux(BlockPool& blocks, int dev_id, size_t* total, size_t* largest)
   {
@@ -903,6 +1525,26 @@ std::vector<SegmentInfo> snapshot() {
   return caching_allocator.snapshot();
 }
 
+MempoolId createPool() {
+  return caching_allocator.createPool();
+}
+
+void setStreamPool(CUDAStream stream, MempoolId pool) {
+  caching_allocator.setStreamPool(stream.stream(), pool);
+}
+
+void releasePool(MempoolId pool) {
+  caching_allocator.releasePool(pool);
+}
+
+void notifyCaptureBegin(CUDAStream stream, MempoolId pool) {
+  caching_allocator.notifyCaptureBegin(stream.stream(), pool);
+}
+
+void notifyCaptureEnd(CUDAStream stream) {
+  caching_allocator.notifyCaptureEnd(stream.stream());
+}
+
 //
 // In CUDA IPC, sender sends a tensor to receiver, getIpcDevPtr
 // is called by the receiving process to map the CUDA memory from the sending
@@ -919,18 +1561,66 @@ std::vector<SegmentInfo> snapshot() {
 // will be used to reconstruct all storages in this CudaMalloc allocation.
 // And it will deleted in cudaIpcCloseMemHandle when its reference count is 0.
 //
+// Most pipelines send batch after batch carved from the same few segments
+// of the sender, but each batch is usually freed before the next one
+// arrives, which would close the handle and pay for opening it again. The
+// most recently used handles are thus also kept open by
+// ipc_recent_devptrs, up to PYTORCH_CUDA_IPC_HANDLE_CACHE_SIZE of them
+// (default 16, 0 disables it). emptyIpcDevPtrCache() closes those that no
+// storage uses anymore.
+//
 namespace {
   std::mutex IpcMutex;
   std::unordered_map<std::string, std::weak_ptr<void>> ipcMemHandle_to_devptr;
+  // Most recently used first. Leaked, as closing the handles while the
+  // process exits could fail once the CUDA runtime is unloaded.
+  std::deque<std::shared_ptr<void>>& ipc_recent_devptrs =
+      *new std::deque<std::shared_ptr<void>>();
+
+  size_t ipc_devptr_cache_size() {
+    static const size_t size = []() -> size_t {
+      const char* env = std::getenv("PYTORCH_CUDA_IPC_HANDLE_CACHE_SIZE");
+      if (env == nullptr) {
+        return 16;
+      }
+      return std::max(std::atoi(env), 0);
+    }();
+    return size;
+  }
+
+  // Must be called with IpcMutex held. The evicted pointers must be released
+  // after it, since their deleter takes it.
+  void retain_ipc_devptr(
+      const std::shared_ptr<void>& devptr,
+      std::vector<std::shared_ptr<void>>& evicted) {
+    const size_t max_size = ipc_devptr_cache_size();
+    if (max_size == 0) {
+      return;
+    }
+    auto it = std::find(ipc_recent_devptrs.begin(), ipc_recent_devptrs.end(), devptr);
+    if (it != ipc_recent_devptrs.end()) {
+      ipc_recent_devptrs.erase(it);
+    }
+    ipc_recent_devptrs.push_front(devptr);
+    while (ipc_recent_devptrs.size() > max_size) {
+      evicted.push_back(std::move(ipc_recent_devptrs.back()));
+      ipc_recent_devptrs.pop_back();
+    }
+  }
 }
 
 std::shared_ptr<void> getIpcDevPtr(std::string handle) {
+  // Declared before the lock so that they are released after it
+  std::vector<std::shared_ptr<void>> evicted;
   std::lock_guard<std::mutex> lock(IpcMutex);
 
   auto iter = ipcMemHandle_to_devptr.find(handle);
   if (iter != ipcMemHandle_to_devptr.end()) {
     auto devptr = iter->second.lock();
-    if (devptr) return devptr;
+    if (devptr) {
+      retain_ipc_devptr(devptr, evicted);
+      return devptr;
+    }
   }
   // This ipcMemHandle hasn't been opened, or already expired, open it to
   // enable IPC access to that mem block.
@@ -953,10 +1643,19 @@ std::shared_ptr<void> getIpcDevPtr(std::string handle) {
   // But in the deleter for sp we erased the entry,
   // this should be safe to do now.
   ipcMemHandle_to_devptr.insert(iter, {handle, wp});
+  retain_ipc_devptr(sp, evicted);
 
   return sp;
 }
 
+void emptyIpcDevPtrCache() {
+  std::deque<std::shared_ptr<void>> released;
+  {
+    std::lock_guard<std::mutex> lock(IpcMutex);
+    released.swap(ipc_recent_devptrs);
+  }
+}
+
 void* raw_alloc(size_t nbytes) {
   if (nbytes == 0) {
     return nullptr;
@@ -60,6 +60,13 @@ enum struct StatType : uint64_t {
 
 typedef std::array<Stat, static_cast<size_t>(StatType::NUM_TYPES)> StatArray;
 
+// Number of buckets in the free block histogram. Bucket i covers cached free
+// blocks with a size in [512 << i, 512 << (i + 1)); the last bucket also
+// covers every larger block.
+constexpr size_t kNumFreeBlockBuckets = 24;
+
+typedef std::array<int64_t, kNumFreeBlockBuckets> FreeBlockHistogram;
+
 // Struct containing memory allocator summary statistics for a device.
 struct DeviceStats {
   // COUNT: allocations requested by client code
@@ -85,6 +92,16 @@ struct DeviceStats {
 
   // COUNT: total number of OOMs (i.e. failed calls to CUDA after cache flush)
   int64_t num_ooms = 0;
+
+  // The fields below describe fragmentation of the cache. They are computed
+  // when the stats are queried and have no peak or history.
+
+  // HISTOGRAM: number of cached free blocks, by size (see kNumFreeBlockBuckets)
+  FreeBlockHistogram free_block_count = {};
+  // HISTOGRAM: bytes in cached free blocks, by size
+  FreeBlockHistogram free_block_bytes = {};
+  // size of the largest cached free block
+  int64_t largest_free_block = 0;
 };
 
 // Struct containing info of an allocation block (i.e. a fractional part of a cudaMalloc)..
@@ -102,9 +119,13 @@ struct SegmentInfo {
   int64_t allocated_size = 0;
   int64_t active_size = 0;
   bool is_large = false;
+  bool is_expandable = false;
   std::vector<BlockInfo> blocks;
 };
 
+// Identifies a private memory pool; 0 stands for the default pools.
+typedef uint64_t MempoolId;
+
 C10_CUDA_API void* raw_alloc(size_t nbytes);
 C10_CUDA_API void* raw_alloc_with_stream(size_t nbytes, cudaStream_t stream);
 C10_CUDA_API void raw_delete(void* ptr);
@@ -119,9 +140,33 @@ C10_CUDA_API void resetAccumulatedStats(int device);
 C10_CUDA_API void resetPeakStats(int device);
 C10_CUDA_API std::vector<SegmentInfo> snapshot();
 
+// Private memory pools. Allocations on the streams assigned to a pool are
+// isolated from all other memory, and blocks freed by one of these streams
+// can be reused right away by any other of them: the reusing stream waits on
+// events recorded at free time instead of the allocator polling them. See
+// the comment in CUDACachingAllocator.cpp.
+C10_CUDA_API MempoolId createPool();
+// Makes allocations on `stream` come from `pool`, or from the default pools
+// again if `pool` is 0. A pool can be shared by any number of streams.
+C10_CUDA_API void setStreamPool(CUDAStream stream, MempoolId pool);
+// Unassigns the streams of `pool` and releases its cached memory. Blocks
+// still in use are released as they are freed.
+C10_CUDA_API void releasePool(MempoolId pool);
+
+// CUDA graph capture. Between these calls allocations on `stream` come from
+// `pool`, whose cached memory is then kept for the replays of the graph until
+// the pool is released, and the allocator makes no call that is illegal
+// during a capture. Called by at::cuda::CUDAGraph.
+C10_CUDA_API void notifyCaptureBegin(CUDAStream stream, MempoolId pool);
+C10_CUDA_API void notifyCaptureEnd(CUDAStream stream);
+
 C10_CUDA_API std::mutex* getFreeMutex();
 
 C10_CUDA_API std::shared_ptr<void> getIpcDevPtr(std::string handle);
+
+// Closes the IPC handles kept open for reuse by getIpcDevPtr() that no
+// storage uses anymore.
+C10_CUDA_API void emptyIpcDevPtrCache();
 } // namespace CUDACachingAllocator
 
 }} // namespace c10::cuda
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/cuda/CUDAFunctions.h>
+#include <c10/cuda/CUDAGuard.h>
+
+using namespace c10::cuda;
+
+TEST(CUDACachingAllocatorTest, PrivatePoolIsSharedBetweenItsStreams) {
+  if (device_count() == 0) {
+    return;
+  }
+  CUDAGuard device_guard(0);
+  CUDAStream s1 = getStreamFromPool();
+  CUDAStream s2 = getStreamFromPool();
+  ASSERT_NE(s1, s2);
+
+  auto pool = CUDACachingAllocator::createPool();
+  CUDACachingAllocator::setStreamPool(s1, pool);
+  CUDACachingAllocator::setStreamPool(s2, pool);
+
+  void* p1 = CUDACachingAllocator::raw_alloc_with_stream(4096, s1.stream());
+  CUDACachingAllocator::raw_delete(p1);
+  // The block freed on s1 is reusable on s2 without any synchronization.
+  void* p2 = CUDACachingAllocator::raw_alloc_with_stream(4096, s2.stream());
+  ASSERT_EQ(p1, p2);
+  CUDACachingAllocator::raw_delete(p2);
+
+  CUDACachingAllocator::releasePool(pool);
+}
+
+TEST(CUDACachingAllocatorTest, PrivatePoolIsIsolated) {
+  if (device_count() == 0) {
+    return;
+  }
+  CUDAGuard device_guard(0);
+  CUDAStream s = getStreamFromPool();
+
+  auto pool = CUDACachingAllocator::createPool();
+  CUDACachingAllocator::setStreamPool(s, pool);
+  void* in_pool = CUDACachingAllocator::raw_alloc_with_stream(8192, s.stream());
+  CUDACachingAllocator::raw_delete(in_pool);
+
+  // Once the stream is back on the default pools it cannot see the block.
+  CUDACachingAllocator::setStreamPool(s, 0);
+  void* outside = CUDACachingAllocator::raw_alloc_with_stream(8192, s.stream());
+  ASSERT_NE(in_pool, outside);
+  CUDACachingAllocator::raw_delete(outside);
+
+  CUDACachingAllocator::releasePool(pool);
+  ASSERT_THROW(CUDACachingAllocator::setStreamPool(s, pool), c10::Error);
+}
+
+TEST(CUDACachingAllocatorTest, GraphPoolIsKeptUntilReleased) {
+  if (device_count() == 0) {
+    return;
+  }
+  CUDAGuard device_guard(0);
+  CUDAStream s = getStreamFromPool();
+  auto reserved = [] {
+    return CUDACachingAllocator::getDeviceStats(0)
+        .reserved_bytes[static_cast<size_t>(CUDACachingAllocator::StatType::AGGREGATE)]
+        .current;
+  };
+  CUDACachingAllocator::emptyCache();
+  const int64_t reserved_before = reserved();
+
+  // No capture is actually started: only the allocator side is exercised.
+  auto pool = CUDACachingAllocator::createPool();
+  CUDACachingAllocator::notifyCaptureBegin(s, pool);
+  void* p = CUDACachingAllocator::raw_alloc_with_stream(8192, s.stream());
+  CUDACachingAllocator::notifyCaptureEnd(s);
+  CUDACachingAllocator::raw_delete(p);
+
+  // The memory of a graph may still be used by its replays.
+  CUDACachingAllocator::emptyCache();
+  ASSERT_GT(reserved(), reserved_before);
+
+  CUDACachingAllocator::releasePool(pool);
+  ASSERT_EQ(reserved(), reserved_before);
+}
@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/CPUAllocator.h>
+
+using namespace c10;
+
+TEST(CPUAllocatorTest, HugePageAllocations) {
+  const auto min_bytes = FLAGS_caffe2_cpu_allocator_huge_page_min_bytes;
+  FLAGS_caffe2_cpu_allocator_huge_page_min_bytes = 4 << 20;
+  const auto before = getHugePageStats();
+
+  const size_t nbytes = 5 << 20;
+  void* data = alloc_cpu(nbytes);
+  ASSERT_NE(data, nullptr);
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(data) % gAlignment, 0);
+  // Huge pages are only used where the kernel supports them
+  const auto during = getHugePageStats();
+  if (during.allocations > before.allocations) {
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(data) % (2 << 20), 0);
+    ASSERT_GE(
+        during.advised_bytes + during.hugetlb_bytes,
+        before.advised_bytes + before.hugetlb_bytes + static_cast<int64_t>(nbytes));
+    ASSERT_GE(during.peak_bytes, during.advised_bytes + during.hugetlb_bytes);
+  }
+  static_cast<char*>(data)[0] = 1;
+  static_cast<char*>(data)[nbytes - 1] = 1;
+  free_cpu(data);
+
+  const auto after = getHugePageStats();
+  ASSERT_EQ(after.allocations, before.allocations);
+  ASSERT_EQ(after.advised_bytes, before.advised_bytes);
+  ASSERT_EQ(after.hugetlb_bytes, before.hugetlb_bytes);
+
+  // Below the threshold, the heap is used
+  void* small = alloc_cpu(1 << 20);
+  ASSERT_EQ(getHugePageStats().allocations, before.allocations);
+  free_cpu(small);
+
+  FLAGS_caffe2_cpu_allocator_huge_page_min_bytes = min_bytes;
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/CPUAllocator.h>
+#include <c10/core/CPUCachingAllocator.h>
+
+#include <thread>
+
+using namespace c10;
+
+TEST(CPUCachingAllocatorTest, ReusesFreedBlocks) {
+  Allocator* allocator = CPUCachingAllocator::get();
+  CPUCachingAllocator::emptyCache();
+  void* first = nullptr;
+  {
+    auto data = allocator->allocate(1000);
+    first = data.get();
+    ASSERT_NE(first, nullptr);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(first) % gAlignment, 0);
+  }
+  auto hits = CPUCachingAllocator::getStats().num_cache_hits;
+  // 900 bytes rounds up to the same 1 KiB size class as 1000 bytes.
+  auto data = allocator->allocate(900);
+  ASSERT_EQ(data.get(), first);
+  ASSERT_EQ(CPUCachingAllocator::getStats().num_cache_hits, hits + 1);
+}
+
+TEST(CPUCachingAllocatorTest, EmptyCacheReleasesBlocks) {
+  Allocator* allocator = CPUCachingAllocator::get();
+  {
+    auto a = allocator->allocate(4096);
+    auto b = allocator->allocate(100000);
+  }
+  ASSERT_GT(CPUCachingAllocator::getStats().cached_bytes.current, 0);
+  CPUCachingAllocator::emptyCache();
+  ASSERT_EQ(CPUCachingAllocator::getStats().cached_bytes.current, 0);
+}
+
+TEST(CPUCachingAllocatorTest, Stats) {
+  Allocator* allocator = CPUCachingAllocator::get();
+  CPUCachingAllocator::emptyCache();
+  CPUCachingAllocator::resetAccumulatedStats();
+  CPUCachingAllocator::resetPeakStats();
+  {
+    auto a = allocator->allocate(512);
+    auto b = allocator->allocate(640);
+    auto stats = CPUCachingAllocator::getStats();
+    ASSERT_EQ(stats.allocation.current, 2);
+    ASSERT_EQ(stats.allocated_bytes.current, 512 + 640);
+  }
+  auto stats = CPUCachingAllocator::getStats();
+  ASSERT_EQ(stats.allocation.current, 0);
+  ASSERT_EQ(stats.allocation.peak, 2);
+  ASSERT_EQ(stats.allocation.allocated, 2);
+  ASSERT_EQ(stats.allocation.freed, 2);
+  ASSERT_EQ(stats.cached_bytes.current, 512 + 640);
+  CPUCachingAllocator::emptyCache();
+}
+
+TEST(CPUCachingAllocatorTest, LargeAllocationsAreNotCached) {
+  Allocator* allocator = CPUCachingAllocator::get();
+  CPUCachingAllocator::emptyCache();
+  { auto data = allocator->allocate(128 * 1024 * 1024); }
+  ASSERT_EQ(CPUCachingAllocator::getStats().cached_bytes.current, 0);
+}
+
+TEST(CPUCachingAllocatorTest, RawInterface) {
+  Allocator* allocator = CPUCachingAllocator::get();
+  void* ptr = allocator->raw_allocate(256);
+  ASSERT_NE(ptr, nullptr);
+  allocator->raw_deallocate(ptr);
+}
+
+TEST(CPUCachingAllocatorTest, FreeOnAnotherThread) {
+  Allocator* allocator = CPUCachingAllocator::get();
+  CPUCachingAllocator::emptyCache();
+  auto data = allocator->allocate(2048);
+  std::thread t([&]() { data.clear(); });
+  t.join();
+  // The freeing thread's cache was released when it exited.
+  ASSERT_EQ(CPUCachingAllocator::getStats().cached_bytes.current, 0);
+  ASSERT_EQ(CPUCachingAllocator::getStats().allocation.current, 0);
+}
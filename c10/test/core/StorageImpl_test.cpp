@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/CPUAllocator.h>
+#include <c10/core/StorageImpl.h>
+
+#include <utility>
+
+using namespace c10;
+
+namespace {
+
+intrusive_ptr<StorageImpl> make_inline_storage(size_t n) {
+  return make_intrusive<StorageImpl>(
+      StorageImpl::use_byte_size_t(),
+      StorageImpl::use_inline_buffer_t(),
+      caffe2::TypeMeta::Make<float>(),
+      n * sizeof(float),
+      GetCPUAllocator(),
+      /*resizable=*/true);
+}
+
+} // namespace
+
+TEST(StorageImplTest, InlineBuffer) {
+  auto storage = make_inline_storage(4);
+  ASSERT_TRUE(storage->is_inline());
+  ASSERT_EQ(storage->nbytes(), 4 * sizeof(float));
+  ASSERT_EQ(storage->device(), Device(DeviceType::CPU));
+  float* data = storage->data<float>();
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(data) % 16, 0);
+  for (int i = 0; i < 4; ++i) {
+    data[i] = i;
+  }
+
+  // A new data_ptr replaces the buffer
+  auto old_data = storage->set_data_ptr(GetCPUAllocator()->allocate(64));
+  ASSERT_EQ(old_data.get(), data);
+  ASSERT_FALSE(storage->is_inline());
+}
+
+TEST(StorageImplTest, MoveInlineStorage) {
+  auto a = make_inline_storage(2);
+  auto b = make_intrusive<StorageImpl>(
+      StorageImpl::use_byte_size_t(),
+      caffe2::TypeMeta::Make<float>(),
+      1024 * sizeof(float),
+      GetCPUAllocator(),
+      /*resizable=*/true);
+  a->data<float>()[0] = 1;
+  a->data<float>()[1] = 2;
+  void* b_data = b->data();
+
+  // The data of an inline storage moves to the buffer of its new StorageImpl
+  std::swap(*a, *b);
+  ASSERT_FALSE(a->is_inline());
+  ASSERT_EQ(a->data(), b_data);
+  ASSERT_TRUE(b->is_inline());
+  ASSERT_EQ(b->nbytes(), 2 * sizeof(float));
+  ASSERT_EQ(b->data<float>()[0], 1);
+  ASSERT_EQ(b->data<float>()[1], 2);
+}
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/thread_pool.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+using namespace c10;
+
+namespace {
+
+void runTasks(ThreadPool& pool, int num_tasks, std::atomic<int>& count) {
+  for (int i = 0; i < num_tasks; ++i) {
+    pool.run([&count]() { ++count; });
+  }
+  pool.waitWorkComplete();
+}
+
+} // namespace
+
+TEST(ThreadPoolTest, RunWithoutSpinning) {
+  ThreadPool pool(4);
+  pool.setSpinTime(std::chrono::microseconds(0));
+  std::atomic<int> count{0};
+  runTasks(pool, 100, count);
+  ASSERT_EQ(count, 100);
+  ASSERT_EQ(pool.stats().spin_hits, 0);
+}
+
+TEST(ThreadPoolTest, RunWithSpinning) {
+  ThreadPool pool(4);
+  pool.setSpinTime(std::chrono::microseconds(1000));
+  ASSERT_EQ(pool.spinTime(), std::chrono::microseconds(1000));
+  std::atomic<int> count{0};
+  for (int round = 0; round < 10; ++round) {
+    runTasks(pool, 10, count);
+  }
+  ASSERT_EQ(count, 100);
+}
+
+TEST(ThreadPoolTest, RunBulk) {
+  ThreadPool pool(4);
+  std::atomic<int> count{0};
+  std::vector<std::function<void()>> funcs;
+  for (int i = 0; i < 50; ++i) {
+    funcs.emplace_back([&count]() { ++count; });
+  }
+  pool.runBulk(std::move(funcs));
+  pool.waitWorkComplete();
+  ASSERT_EQ(count, 50);
+}
+
+TEST(ThreadPoolTest, Stats) {
+  ThreadPool pool(2);
+  std::atomic<int> count{0};
+  runTasks(pool, 20, count);
+  auto stats = pool.stats();
+  ASSERT_EQ(stats.tasks, 20);
+  ASSERT_GE(stats.total_latency_ns, stats.max_latency_ns);
+
+  pool.resetStats();
+  stats = pool.stats();
+  ASSERT_EQ(stats.tasks, 0);
+  ASSERT_EQ(stats.total_latency_ns, 0);
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/CPUAllocator.h>
+#include <c10/core/StorageImpl.h>
+#include <c10/core/impl/COW.h>
+
+#include <thread>
+#include <vector>
+
+using namespace c10;
+
+namespace {
+
+intrusive_ptr<StorageImpl> make_storage(size_t n) {
+  auto storage = make_intrusive<StorageImpl>(
+      StorageImpl::use_byte_size_t(),
+      caffe2::TypeMeta::Make<float>(),
+      n * sizeof(float),
+      GetCPUAllocator(),
+      /*resizable=*/true);
+  for (size_t i = 0; i < n; ++i) {
+    storage->data<float>()[i] = i;
+  }
+  return storage;
+}
+
+} // namespace
+
+TEST(COWTest, LazyCloneSharesData) {
+  auto a = make_storage(64);
+  const void* data = a->const_data();
+  auto b = impl::cow::lazy_clone_storage(*a);
+  ASSERT_TRUE(b);
+  ASSERT_TRUE(a->is_cow());
+  ASSERT_TRUE(b->is_cow());
+  ASSERT_EQ(a->const_data(), data);
+  ASSERT_EQ(b->const_data(), data);
+  ASSERT_EQ(b->nbytes(), a->nbytes());
+
+  // A write access gives the storage its own copy
+  float* b_data = b->data<float>();
+  ASSERT_FALSE(b->is_cow());
+  ASSERT_NE(b_data, data);
+  ASSERT_EQ(b_data[63], 63);
+  b_data[0] = -1;
+  ASSERT_EQ(static_cast<const float*>(a->const_data())[0], 0);
+
+  // The last storage sharing the data takes it back
+  ASSERT_TRUE(a->is_cow());
+  ASSERT_EQ(a->data(), data);
+  ASSERT_FALSE(a->is_cow());
+}
+
+TEST(COWTest, LazyCloneOfClone) {
+  auto a = make_storage(16);
+  const void* data = a->const_data();
+  auto b = impl::cow::lazy_clone_storage(*a);
+  auto c = impl::cow::lazy_clone_storage(*b);
+  ASSERT_TRUE(c);
+  ASSERT_EQ(c->const_data(), data);
+
+  a.reset();
+  ASSERT_NE(b->data(), data);
+  ASSERT_EQ(c->data(), data);
+  ASSERT_EQ(static_cast<float*>(c->data())[15], 15);
+}
+
+TEST(COWTest, UnsupportedStorages) {
+  // Inline storages are cheaper to copy
+  auto inline_storage = make_intrusive<StorageImpl>(
+      StorageImpl::use_byte_size_t(),
+      StorageImpl::use_inline_buffer_t(),
+      caffe2::TypeMeta::Make<float>(),
+      4 * sizeof(float),
+      GetCPUAllocator(),
+      /*resizable=*/false);
+  ASSERT_FALSE(impl::cow::lazy_clone_storage(*inline_storage));
+
+  // Memory owned by someone else may be written behind the storage's back
+  float external[64];
+  auto external_storage = make_intrusive<StorageImpl>(
+      StorageImpl::use_byte_size_t(),
+      caffe2::TypeMeta::Make<float>(),
+      sizeof(external),
+      DataPtr(external, Device(DeviceType::CPU)),
+      /*allocator=*/nullptr,
+      /*resizable=*/false);
+  ASSERT_FALSE(impl::cow::lazy_clone_storage(*external_storage));
+  ASSERT_FALSE(external_storage->is_cow());
+}
+
+TEST(COWTest, ConcurrentMaterialization) {
+  // Threads reading a shared storage through accessors that materialize it
+  // must agree on a single copy, and leave the buffer to the other storage.
+  for (int iter = 0; iter < 100; ++iter) {
+    auto a = make_storage(1024);
+    const void* data = a->const_data();
+    auto b = impl::cow::lazy_clone_storage(*a);
+    ASSERT_TRUE(b);
+
+    constexpr int kThreads = 8;
+    std::vector<const float*> seen(kThreads);
+    std::vector<float> sums(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+      threads.emplace_back([&, t] {
+        const float* values = a->data<float>();
+        float sum = 0;
+        for (size_t i = 0; i < 1024; ++i) {
+          sum += values[i];
+        }
+        seen[t] = values;
+        sums[t] = sum;
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    ASSERT_FALSE(a->is_cow());
+    for (int t = 0; t < kThreads; ++t) {
+      ASSERT_EQ(seen[t], seen[0]);
+      ASSERT_EQ(sums[t], 1023 * 1024 / 2);
+    }
+    ASSERT_NE(seen[0], data);
+    // b still shares the original buffer, now alone
+    ASSERT_TRUE(b->is_cow());
+    ASSERT_EQ(b->data(), data);
+    ASSERT_FALSE(b->is_cow());
+  }
+}
@@ -14,6 +14,14 @@ C10_DEFINE_bool(caffe2_cpu_numa_enabled, false, "Use NUMA whenever possible.");
 
 namespace c10 {
 
+namespace {
+thread_local int thread_numa_node_id = -1;
+} // namespace
+
+int GetThreadNUMANode() {
+  return thread_numa_node_id;
+}
+
 #ifdef C10_ENABLE_NUMA
 bool IsNUMAEnabled() {
   return FLAGS_caffe2_cpu_numa_enabled && numa_available() >= 0;
@@ -37,6 +45,7 @@ void NUMABind(int numa_node_id) {
   numa_bitmask_setbit(bm, numa_node_id);
   numa_bind(bm);
   numa_bitmask_free(bm);
+  thread_numa_node_id = numa_node_id;
 }
 
 int GetNUMANode(const void* ptr) {
@@ -103,6 +112,17 @@ int GetCurrentNUMANode() {
   return n;
 }
 
+void* NUMAAlloc(size_t size, int numa_node_id) {
+  if (numa_node_id < 0 || !IsNUMAEnabled()) {
+    return nullptr;
+  }
+  return numa_alloc_onnode(size, numa_node_id);
+}
+
+void NUMAFree(void* ptr, size_t size) {
+  numa_free(ptr, size);
+}
+
 #else // C10_ENABLE_NUMA
 
 bool IsNUMAEnabled() {
@@ -127,6 +147,13 @@ int GetCurrentNUMANode() {
   return -1;
 }
 
+void* NUMAAlloc(size_t size, int numa_node_id) {
+  return nullptr;
+}
+
+void NUMAFree(void* ptr, size_t size) {
+}
+
 #endif // C10_NUMA_ENABLED
 
 } // namespace c10
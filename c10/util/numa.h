@@ -37,4 +37,20 @@ C10_API void NUMAMove(void* ptr, size_t size, int numa_node_id);
  */
 C10_API int GetCurrentNUMANode();
 
+/**
+ * Get the NUMA node the current thread was bound to by NUMABind, or -1
+ */
+C10_API int GetThreadNUMANode();
+
+/**
+ * Allocate `size` bytes of fresh pages on a given NUMA node, returns nullptr
+ * if NUMA is not enabled or the allocation failed
+ */
+C10_API void* NUMAAlloc(size_t size, int numa_node_id);
+
+/**
+ * Free memory allocated by NUMAAlloc
+ */
+C10_API void NUMAFree(void* ptr, size_t size);
+
 } // namespace c10
@@ -2,6 +2,8 @@
 #include "caffe2/core/event_cpu.h"
 #include "caffe2/core/operator.h"
 
+#include <c10/core/thread_pool.h>
+
 #include <atomic>
 #include <iostream>
 
@@ -37,18 +39,81 @@ struct CudaEventWrapper {
   std::mutex mutex_recorded_;
   std::condition_variable cv_recorded_;
   std::string err_msg_;
+
+  // Callbacks waiting for the event to finish, and whether a host function
+  // that runs them was enqueued after the event on cuda_stream_
+  std::vector<EventCallbackFunction> callbacks_;
+  bool host_func_enqueued_ = false;
+  // Bumped by every reset, so that the host function of an earlier record
+  // does not finish the event of a later one
+  int64_t generation_ = 0;
 };
 
 namespace {
 const std::string kNoError = "No error";
+
+#if CUDA_VERSION >= 10000
+// CUDA host functions must not call CUDA, the callbacks (which usually query
+// other events) are run on this thread instead, which sleeps while there are
+// none.
+c10::ThreadPool& callbackPool() {
+  static auto* pool = new c10::ThreadPool(1);
+  return *pool;
+}
+
+struct HostFuncData {
+  std::shared_ptr<void> event;
+  int64_t generation;
+};
+
+void finishFromHostFunc(const HostFuncData& data) {
+  auto* wrapper = static_cast<CudaEventWrapper*>(data.event.get());
+  std::vector<EventCallbackFunction> callbacks;
+  {
+    std::unique_lock<std::mutex> lock(wrapper->mutex_recorded_);
+    if (wrapper->generation_ != data.generation) {
+      return;
+    }
+    // all the work enqueued before the event is done
+    if (wrapper->status_ == EventStatus::EVENT_SCHEDULED) {
+      wrapper->status_ = EventStatus::EVENT_SUCCESS;
+    }
+    callbacks.swap(wrapper->callbacks_);
+  }
+  for (auto& callback : callbacks) {
+    callback();
+  }
 }
 
+void CUDART_CB eventHostFunc(void* user_data) {
+  // the last reference to the event may be dropped with data, which destroys
+  // the CUDA event, hence not here either
+  std::shared_ptr<HostFuncData> data(static_cast<HostFuncData*>(user_data));
+  callbackPool().run([data]() { finishFromHostFunc(*data); });
+}
+
+// Requires mutex_recorded_ and the event to be scheduled
+void enqueueHostFunc(const Event* event, CudaEventWrapper* wrapper) {
+  if (wrapper->host_func_enqueued_) {
+    return;
+  }
+  CUDAGuard g(wrapper->device_id_);
+  CUDA_ENFORCE(cudaLaunchHostFunc(
+      wrapper->cuda_stream_,
+      eventHostFunc,
+      new HostFuncData{event->event_, wrapper->generation_}));
+  wrapper->host_func_enqueued_ = true;
+}
+#endif // CUDA_VERSION >= 10000
+} // namespace
+
 void EventCreateCUDA(const DeviceOption& option, Event* event) {
   event->event_ = std::make_shared<CudaEventWrapper>(option);
 }
 
 void EventRecordCUDA(Event* event, const void* context, const char* err_msg) {
   auto* wrapper = static_cast<CudaEventWrapper*>(event->event_.get());
+  std::vector<EventCallbackFunction> callbacks;
   {
     std::unique_lock<std::mutex> lock(wrapper->mutex_recorded_);
 
@@ -85,12 +150,21 @@ void EventRecordCUDA(Event* event, const void* context, const char* err_msg) {
       wrapper->cuda_stream_ =
           static_cast<const CUDAContext*>(context)->cuda_stream();
       wrapper->status_ = EventStatus::EVENT_SCHEDULED;
+#if CUDA_VERSION >= 10000
+      if (!wrapper->callbacks_.empty()) {
+        enqueueHostFunc(event, wrapper);
+      }
+#endif
     } else {
       wrapper->err_msg_ = err_msg;
       wrapper->status_ = EventStatus::EVENT_FAILED;
+      callbacks.swap(wrapper->callbacks_);
     }
   }
   wrapper->cv_recorded_.notify_all();
+  for (auto& callback : callbacks) {
+    callback();
+  }
 }
 
 void EventFinishCUDA(const Event* event) {
@@ -180,6 +254,7 @@ const std::string& EventErrorMessageCUDA(const Event* event) {
 
 void EventSetFinishedCUDA(const Event* event, const char* err_msg) {
   auto* wrapper = static_cast<CudaEventWrapper*>(event->event_.get());
+  std::vector<EventCallbackFunction> callbacks;
   {
     std::unique_lock<std::mutex> lock(wrapper->mutex_recorded_);
 
@@ -194,8 +269,12 @@ void EventSetFinishedCUDA(const Event* event, const char* err_msg) {
       wrapper->err_msg_ = err_msg;
       wrapper->status_ = EventStatus::EVENT_FAILED;
     }
+    callbacks.swap(wrapper->callbacks_);
   }
   wrapper->cv_recorded_.notify_all();
+  for (auto& callback : callbacks) {
+    callback();
+  }
 }
 
 void EventResetCUDA(Event* event) {
@@ -204,7 +283,30 @@ void EventResetCUDA(Event* event) {
   wrapper->status_ = EventStatus::EVENT_INITIALIZED;
   wrapper->err_msg_ = "";
   wrapper->cuda_stream_ = nullptr;
+  wrapper->callbacks_.clear();
+  wrapper->host_func_enqueued_ = false;
+  ++wrapper->generation_;
+}
+
+#if CUDA_VERSION >= 10000
+// The callback runs once the work enqueued before the event is done, woken by
+// a CUDA host function rather than by polling the event.
+void EventSetCallbackCUDA(Event* event, EventCallbackFunction callback) {
+  auto* wrapper = static_cast<CudaEventWrapper*>(event->event_.get());
+  {
+    std::unique_lock<std::mutex> lock(wrapper->mutex_recorded_);
+    if (wrapper->status_ != EventStatus::EVENT_SUCCESS &&
+        wrapper->status_ != EventStatus::EVENT_FAILED) {
+      wrapper->callbacks_.push_back(std::move(callback));
+      if (wrapper->status_ == EventStatus::EVENT_SCHEDULED) {
+        enqueueHostFunc(event, wrapper);
+      }
+      return;
+    }
+  }
+  callback();
 }
+#endif // CUDA_VERSION >= 10000
 
 REGISTER_EVENT_CREATE_FUNCTION(CUDA, EventCreateCUDA);
 REGISTER_EVENT_RECORD_FUNCTION(CUDA, EventRecordCUDA);
@@ -217,6 +319,9 @@ REGISTER_EVENT_QUERY_FUNCTION(CUDA, EventQueryCUDA);
 REGISTER_EVENT_ERROR_MESSAGE_FUNCTION(CUDA, EventErrorMessageCUDA);
 REGISTER_EVENT_SET_FINISHED_FUNCTION(CUDA, EventSetFinishedCUDA);
 REGISTER_EVENT_RESET_FUNCTION(CUDA, EventResetCUDA);
+#if CUDA_VERSION >= 10000
+REGISTER_EVENT_SET_CALLBACK_FUNCTION(CUDA, EventSetCallbackCUDA);
+#endif
 
 REGISTER_EVENT_WAIT_FUNCTION(MKLDNN, CUDA, EventWaitCPUCUDA);
 REGISTER_EVENT_WAIT_FUNCTION(CUDA, MKLDNN, EventWaitCUDACPU);
@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <condition_variable>
+#include <mutex>
 #include "caffe2/core/context.h"
 #include "caffe2/core/context_gpu.h"
 #include "caffe2/core/event.h"
@@ -47,4 +49,54 @@ TEST(EventCUDATest, EventBasics) {
   context_cuda.WaitEvent(event_cpu);
 }
 
+TEST(EventCUDATest, EventCallbacks) {
+  if (!HasCudaGPU())
+    return;
+  DeviceOption device_cuda;
+  device_cuda.set_device_type(PROTO_CUDA);
+  CUDAContext context_cuda(device_cuda);
+  Event event_cuda(device_cuda);
+  if (!event_cuda.SupportsCallback()) {
+    return;
+  }
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  int calls = 0;
+  auto callback = [&]() {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++calls;
+    cv.notify_all();
+  };
+  auto wait_for_calls = [&](int n) {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&]() { return calls >= n; });
+  };
+
+  context_cuda.SwitchToDevice();
+  // set before the event is recorded
+  event_cuda.SetCallback(callback);
+  context_cuda.Record(&event_cuda);
+  wait_for_calls(1);
+  EXPECT_EQ(event_cuda.Query(), EventStatus::EVENT_SUCCESS);
+
+  // set after the event is finished
+  event_cuda.SetCallback(callback);
+  wait_for_calls(2);
+
+  // set while the event is scheduled
+  event_cuda.Reset();
+  context_cuda.Record(&event_cuda);
+  event_cuda.SetCallback(callback);
+  wait_for_calls(3);
+  event_cuda.Finish();
+
+  // callbacks are dropped by a reset
+  event_cuda.Reset();
+  event_cuda.SetCallback(callback);
+  event_cuda.Reset();
+  event_cuda.SetFinished();
+  EXPECT_EQ(calls, 3);
+}
+
 } // namespace caffe2
@@ -24,6 +24,13 @@ NetDef optimize_inference_net(
       LOG(INFO) << "Memonger does not support RecurrentNetwork yet";
       return net;
     }
+    for (auto& arg : op.arg()) {
+      if (arg.has_n() || arg.nets_size() > 0) {
+        // the blobs used by the subnets are not visible here
+        LOG(INFO) << "Memonger does not support ops with subnets yet";
+        return net;
+      }
+    }
     ops.push_back(op);
   }
 
@@ -1,5 +1,7 @@
 #include "caffe2/core/net_async_base.h"
 
+#include <algorithm>
+
 #include "caffe2/core/net_async_tracing.h"
 #include "caffe2/core/operator.h"
 #include "caffe2/core/timer.h"
@@ -86,6 +88,14 @@ AsyncNetBase::AsyncNetBase(
     chains_.push_back(kv.second);
   }
   chain_nodes_ = dag_utils::prepareChainGraphNodes(operator_nodes_, chains_);
+  for (int task_id = 0; task_id < (int)chain_nodes_.size(); ++task_id) {
+    if (chain_nodes_[task_id].parents_.empty()) {
+      root_tasks_.push_back(task_id);
+    }
+  }
+  if (options_.use_critical_path_scheduling_) {
+    updateTaskRanks();
+  }
 
   events_.reserve(chains_.size());
   for (const auto& chain : chains_) {
@@ -367,9 +377,33 @@ void AsyncNetBase::reset() {
     task_op_node.scheduled_.clear();
   }
 
+  // refine the ranks with the stats of the previous runs
+  if (options_.use_critical_path_scheduling_ && options_.report_stats_) {
+    updateTaskRanks();
+  }
+
   success_ = true;
 }
 
+void AsyncNetBase::updateTaskRanks() {
+  auto op_times = counters_.GetPerOpMeanTime();
+  std::vector<float> task_costs(tasksNum(), 0.0);
+  for (auto task_id = 0; task_id < tasksNum(); ++task_id) {
+    for (auto op_id : chains_[task_id]) {
+      task_costs[task_id] += op_times.empty() ? 1.0 : op_times[op_id];
+    }
+  }
+  auto task_ranks = dag_utils::computeUpwardRanks(chain_nodes_, task_costs);
+  auto by_rank = [&task_ranks](int lhs, int rhs) {
+    return task_ranks[lhs] > task_ranks[rhs];
+  };
+  // children are scheduled in this order once a task finishes
+  for (auto& node : chain_nodes_) {
+    std::stable_sort(node.children_.begin(), node.children_.end(), by_rank);
+  }
+  std::stable_sort(root_tasks_.begin(), root_tasks_.end(), by_rank);
+}
+
 void AsyncNetBase::handleChainError(
     int task_id,
     OperatorBase* op,
@@ -599,6 +633,10 @@ ExecutionOptions::ExecutionOptions(
       CAFFE_ENFORCE(arg.has_i(), "deferrable_mode should be an int");
       use_dfs_scheduling_ = arg.i() == 1; // corr. to DFS scheduling
     }
+    if (arg.has_name() && arg.name() == "critical_path_scheduling") {
+      CAFFE_ENFORCE(arg.has_i(), "critical_path_scheduling should be an int");
+      use_critical_path_scheduling_ = arg.i() == 1;
+    }
   }
 
   if (FLAGS_caffe2_net_async_profile_operators) {
@@ -55,6 +55,10 @@ struct ExecutionOptions {
   bool use_dfs_scheduling_ = false;
   // run net's root tasks in RunAsync thread instead of in thread pool
   bool run_root_tasks_inline_ = false;
+  // schedule the ready tasks with the longest path to the end of the net
+  // first, estimating the cost of ops from the profiled runs if report_stats_
+  // is set and by their number otherwise
+  bool use_critical_path_scheduling_ = false;
 };
 
 struct CAFFE2_API AsyncNetCancelled : public std::exception {
@@ -126,6 +130,9 @@ class CAFFE2_API AsyncNetBase : public NetBase {
 
   virtual void reset();
 
+  // Orders children and root tasks by decreasing upward rank
+  void updateTaskRanks();
+
   bool handleRunError() override;
 
   // Operator/task graph
@@ -133,6 +140,7 @@ class CAFFE2_API AsyncNetBase : public NetBase {
   std::vector<dag_utils::OperatorNode> operator_nodes_;
   std::vector<std::vector<int>> chains_;
   std::vector<dag_utils::OpGraphNode> chain_nodes_; // chains' parents/children
+  std::vector<int> root_tasks_; // chains without parents
   dag_utils::ExecutionChains execution_chains_; // for testing
 
   // Pools and streams
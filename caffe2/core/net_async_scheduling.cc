@@ -251,10 +251,8 @@ bool AsyncSchedulingNet::RunAsync() {
 
   // schedule() is not expected to throw, at this moment all the initial tasks
   // will be scheduled and the full graph of tasks will be executed
-  for (auto task_id = 0; task_id < tasksNum(); ++task_id) {
-    if (parents(task_id).empty()) {
-      schedule(task_id, options_.run_root_tasks_inline_);
-    }
+  for (auto task_id : root_tasks_) {
+    schedule(task_id, options_.run_root_tasks_inline_);
   }
 
   if (tasksNum() == 0) {
@@ -1,5 +1,6 @@
 #include "caffe2/core/net_dag_utils.h"
 
+#include <algorithm>
 #include <set>
 #include <stack>
 #include <unordered_map>
@@ -512,5 +513,39 @@ std::vector<OpGraphNode> prepareChainGraphNodes(
   return chain_nodes;
 }
 
+std::vector<float> computeUpwardRanks(
+    const std::vector<OpGraphNode>& chain_nodes,
+    const std::vector<float>& chain_costs) {
+  CAFFE_ENFORCE_EQ(chain_nodes.size(), chain_costs.size());
+  // visit the chains in reverse topological order, starting from the sinks
+  std::vector<float> ranks(chain_nodes.size(), 0.0);
+  std::vector<int> pending_children(chain_nodes.size());
+  std::vector<int> ready;
+  for (int chain_idx = 0; chain_idx < (int)chain_nodes.size(); ++chain_idx) {
+    pending_children[chain_idx] = chain_nodes[chain_idx].children_.size();
+    if (pending_children[chain_idx] == 0) {
+      ready.push_back(chain_idx);
+    }
+  }
+  size_t num_visited = 0;
+  while (!ready.empty()) {
+    auto chain_idx = ready.back();
+    ready.pop_back();
+    ++num_visited;
+    float max_child_rank = 0.0;
+    for (const auto& child_idx : chain_nodes[chain_idx].children_) {
+      max_child_rank = std::max(max_child_rank, ranks[child_idx]);
+    }
+    ranks[chain_idx] = chain_costs[chain_idx] + max_child_rank;
+    for (const auto& parent_idx : chain_nodes[chain_idx].parents_) {
+      if (--pending_children[parent_idx] == 0) {
+        ready.push_back(parent_idx);
+      }
+    }
+  }
+  CAFFE_ENFORCE_EQ(num_visited, chain_nodes.size(), "Chain graph has a cycle");
+  return ranks;
+}
+
 } // namespace dag_utils
 } // namespace caffe2
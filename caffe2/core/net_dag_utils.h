@@ -63,6 +63,13 @@ std::vector<OpGraphNode> prepareChainGraphNodes(
     const std::vector<dag_utils::OperatorNode>& operator_nodes,
     const std::vector<std::vector<int>>& execution_chains);
 
+// Computes the upward rank of each chain: its cost plus the largest upward
+// rank of its children, i.e. the cost of the longest path from the chain to
+// the end of the graph.
+std::vector<float> computeUpwardRanks(
+    const std::vector<OpGraphNode>& chain_nodes,
+    const std::vector<float>& chain_costs);
+
 } // namespace dag_utils
 } // namespace caffe2
 
@@ -293,4 +293,26 @@ TEST(DagUtilTest, Mixed2) {
       {0, {0}}, {1, {1}}, {3, {3, 6}}, {4, {4, 2, 5}}, {7, {7}}, {8, {8}}};
   EXPECT_EQ(chains, expected);
 }
+
+TEST(DagUtilTest, UpwardRanks) {
+  // 0 -> 1 -> 3, 0 -> 2 -> 3, 4
+  std::vector<dag_utils::OpGraphNode> nodes(5);
+  auto add_edge = [&nodes](int parent, int child) {
+    nodes[parent].children_.push_back(child);
+    nodes[child].parents_.push_back(parent);
+  };
+  add_edge(0, 1);
+  add_edge(0, 2);
+  add_edge(1, 3);
+  add_edge(2, 3);
+  auto ranks =
+      dag_utils::computeUpwardRanks(nodes, {1.0, 5.0, 2.0, 1.0, 3.0});
+  std::vector<float> expected{7.0, 6.0, 3.0, 1.0, 3.0};
+  EXPECT_EQ(ranks, expected);
+
+  add_edge(3, 0);
+  EXPECT_THROW(
+      dag_utils::computeUpwardRanks(nodes, {1.0, 1.0, 1.0, 1.0, 1.0}),
+      EnforceNotMet);
+}
 } // namespace caffe2
@@ -105,6 +105,10 @@ class ProfDAGCounters {
   void AddPerOpAsyncEndTime(size_t op_id);
   ProfDAGReport GetReport() const;
 
+  // Mean time in ms of each operator during the profiled runs so far, empty
+  // if no run was profiled
+  std::vector<float> GetPerOpMeanTime() const;
+
  private:
   Timer timer_;
 
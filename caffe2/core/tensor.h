@@ -105,6 +105,12 @@ class CAFFE2_API Tensor final {
     CopyFrom(src);
   }
 
+  /**
+   * @brief Creates a tensor sharing the given implementation
+   */
+  explicit Tensor(c10::intrusive_ptr<TensorImpl, UndefinedTensorImpl> tensor_impl)
+      : impl_(std::move(tensor_impl)) {}
+
   /**
    * @brief Mutual conversion with at::Tensor
    *
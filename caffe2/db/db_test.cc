@@ -7,6 +7,7 @@
 #include "caffe2/core/blob_serialization.h"
 #include "caffe2/core/db.h"
 #include "caffe2/core/logging.h"
+#include "caffe2/db/prefetching_db_reader.h"
 #include "caffe2/proto/caffe2_pb.h"
 #include "common/gtest/gtest_extensions.h"
 
@@ -200,5 +201,29 @@ TEST(DBReaderShardedTest, Reader) {
   EXPECT_EQ(value, "05");
 }
 
+TEST(PrefetchingDBReaderTest, Reader) {
+  std::string name = std::tmpnam(nullptr);
+  CreateAndFill("leveldb", name);
+  PrefetchingDBReader reader("leveldb", name, 3, 4);
+  string key;
+  string value;
+  // the readers wrap around at the end of the db
+  std::set<string> keys;
+  for (int i = 0; i < 5 * kMaxItems; ++i) {
+    reader.Read(&key, &value);
+    EXPECT_EQ(key, value);
+    keys.insert(key);
+  }
+  EXPECT_LE(keys.size(), kMaxItems);
+  EXPECT_GE(reader.records_read(), 5 * kMaxItems);
+
+  // in sharded mode only the records of the shard are read
+  PrefetchingDBReader sharded("leveldb", name, 2, 4, 3, 1);
+  for (int i = 0; i < kMaxItems; ++i) {
+    sharded.Read(&key, &value);
+    EXPECT_TRUE(key == "01" || key == "04" || key == "07") << key;
+  }
+}
+
 } // namespace db
 } // namespace caffe2
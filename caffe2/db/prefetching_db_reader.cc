@@ -0,0 +1,124 @@
+#include "caffe2/db/prefetching_db_reader.h"
+
+#include "caffe2/core/logging.h"
+
+namespace caffe2 {
+namespace db {
+
+PrefetchingDBReader::PrefetchingDBReader(
+    const string& db_type,
+    const string& source,
+    int num_readers,
+    int capacity,
+    int32_t num_shards,
+    int32_t shard_id)
+    : capacity_(capacity),
+      num_shards_(num_shards),
+      shard_id_(shard_id),
+      num_active_readers_(num_readers) {
+  CAFFE_ENFORCE_GE(num_readers, 1);
+  CAFFE_ENFORCE_GE(capacity, 1);
+  CAFFE_ENFORCE(num_shards >= 1);
+  CAFFE_ENFORCE(shard_id >= 0);
+  CAFFE_ENFORCE(shard_id < num_shards);
+  CAFFE_ENFORCE(
+      num_readers == 1 || db_type != "minidb",
+      "minidb does not support concurrent cursors");
+  db_ = CreateDB(db_type, source, READ);
+  CAFFE_ENFORCE(
+      db_,
+      "Cannot find db implementation of type ",
+      db_type,
+      " (while trying to open ",
+      source,
+      ")");
+  for (int i = 0; i < num_readers; ++i) {
+    cursors_.push_back(db_->NewCursor());
+  }
+  for (int i = 0; i < num_readers; ++i) {
+    threads_.emplace_back(&PrefetchingDBReader::ReaderLoop, this, i);
+  }
+}
+
+PrefetchingDBReader::~PrefetchingDBReader() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stop_ = true;
+  }
+  not_full_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void PrefetchingDBReader::Read(string* key, string* value) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  not_empty_.wait(lock, [this] {
+    return !records_.empty() || error_ || num_active_readers_ == 0;
+  });
+  if (records_.empty()) {
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+    CAFFE_THROW("Db has fewer rows than shard id: ", shard_id_);
+  }
+  *key = std::move(records_.front().first);
+  *value = std::move(records_.front().second);
+  records_.pop_front();
+  lock.unlock();
+  not_full_.notify_one();
+}
+
+bool PrefetchingDBReader::MoveToBeginning(Cursor* cursor, int reader_id) const {
+  cursor->SeekToFirst();
+  const int64_t offset = shard_id_ + (int64_t)reader_id * num_shards_;
+  for (int64_t s = 0; s < offset && cursor->Valid(); s++) {
+    cursor->Next();
+  }
+  return cursor->Valid();
+}
+
+void PrefetchingDBReader::ReaderLoop(int reader_id) {
+  auto* cursor = cursors_[reader_id].get();
+  const int64_t step = (int64_t)num_shards_ * cursors_.size();
+  try {
+    if (!MoveToBeginning(cursor, reader_id)) {
+      std::lock_guard<std::mutex> guard(mutex_);
+      --num_active_readers_;
+      not_empty_.notify_all();
+      return;
+    }
+    while (true) {
+      string key = cursor->key();
+      string value = cursor->value();
+      records_read_ += 1;
+      bytes_read_ += value.size();
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(
+            lock, [this] { return stop_ || (int)records_.size() < capacity_; });
+        if (stop_) {
+          return;
+        }
+        records_.emplace_back(std::move(key), std::move(value));
+      }
+      not_empty_.notify_one();
+
+      for (int64_t s = 0; s < step; s++) {
+        cursor->Next();
+        if (!cursor->Valid()) {
+          MoveToBeginning(cursor, reader_id);
+          break;
+        }
+      }
+    }
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Error while prefetching from db: " << e.what();
+    std::lock_guard<std::mutex> guard(mutex_);
+    error_ = std::current_exception();
+    not_empty_.notify_all();
+  }
+}
+
+} // namespace db
+} // namespace caffe2
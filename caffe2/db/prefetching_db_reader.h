@@ -0,0 +1,86 @@
+#ifndef CAFFE2_DB_PREFETCHING_DB_READER_H_
+#define CAFFE2_DB_PREFETCHING_DB_READER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "caffe2/core/db.h"
+
+namespace caffe2 {
+namespace db {
+
+/**
+ * A reader that reads a db with several threads ahead of its consumers.
+ *
+ * Each of the num_readers threads has its own cursor over every
+ * num_readers-th record of the shard (shard_id of num_shards) of the db, and
+ * pushes the records into a queue of at most capacity records, from which
+ * Read() takes them. As with DBReader, the cursors go back to the head of the
+ * db when they reach its end; unlike with DBReader, the records of the
+ * different threads come out interleaved in no particular order.
+ *
+ * Several readers need a db type that supports concurrent cursors (e.g.
+ * leveldb, lmdb or protodb, but not minidb).
+ */
+class CAFFE2_API PrefetchingDBReader {
+ public:
+  PrefetchingDBReader(
+      const string& db_type,
+      const string& source,
+      int num_readers = 1,
+      int capacity = 1024,
+      int32_t num_shards = 1,
+      int32_t shard_id = 0);
+  ~PrefetchingDBReader();
+
+  /**
+   * Takes the next record, waiting for one if none was read yet. Thread safe.
+   * Rethrows the error of a reading thread.
+   */
+  void Read(string* key, string* value);
+
+  // Number of records and bytes of values read from the db so far
+  int64_t records_read() const {
+    return records_read_;
+  }
+  int64_t bytes_read() const {
+    return bytes_read_;
+  }
+
+ private:
+  void ReaderLoop(int reader_id);
+  // Moves the cursor to its first record, returns false if there is none
+  bool MoveToBeginning(Cursor* cursor, int reader_id) const;
+
+  unique_ptr<DB> db_;
+  std::vector<unique_ptr<Cursor>> cursors_;
+  std::vector<std::thread> threads_;
+  const int capacity_;
+  int32_t num_shards_;
+  int32_t shard_id_;
+
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::deque<std::pair<string, string>> records_;
+  // readers which are still reading, the others found no records
+  int num_active_readers_;
+  std::exception_ptr error_;
+  bool stop_ = false;
+
+  std::atomic<int64_t> records_read_{0};
+  std::atomic<int64_t> bytes_read_{0};
+
+  C10_DISABLE_COPY_AND_ASSIGN(PrefetchingDBReader);
+};
+
+} // namespace db
+} // namespace caffe2
+
+#endif // CAFFE2_DB_PREFETCHING_DB_READER_H_
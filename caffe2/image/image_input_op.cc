@@ -14,6 +14,11 @@ bool ImageInputOp<CPUContext>::ApplyTransformOnGPU(
   return false;
 }
 
+template <>
+bool ImageInputOp<CPUContext>::DecodeDeferredImages() {
+  return false;
+}
+
 REGISTER_CPU_OPERATOR(ImageInput, ImageInputOp<CPUContext>);
 
 OPERATOR_SCHEMA(ImageInput)
@@ -130,6 +135,12 @@ The dimension of the output image will always be cropxcrop
         "use_gpu_transform",
         "1 if GPU acceleration should be used."
         " Defaults to 0. Can only be 1 in a CUDAContext")
+    .Arg(
+        "use_nvjpeg",
+        "1 if the baseline JPEGs should be decoded in batches on GPU with"
+        " nvJPEG, the resizing and cropping being fused with the GPU"
+        " transform. Other images are still decoded on CPU."
+        " Defaults to 0. Requires use_gpu_transform")
     .Arg(
         "decode_threads",
         "Number of CPU decode/transform threads."
@@ -19,6 +19,7 @@
 namespace caffe2 {
 
 class CUDAContext;
+class NvjpegBatchDecoder;
 
 template <class Context>
 class ImageInputOp final : public PrefetchOperator<Context> {
@@ -74,12 +75,32 @@ class ImageInputOp final : public PrefetchOperator<Context> {
   // to be privatized per launch.
   using PerImageArg = struct { BoundingBox bounding_params; };
 
+  // An image of the batch whose decoding is deferred to nvJPEG. Its crop is
+  // still decided on the decode threads, as a region of the decoded image
+  // which is resized to crop x crop.
+  using DeferredImage = struct {
+    bool deferred;
+    std::string encoded;
+    float roi_x;
+    float roi_y;
+    float roi_width;
+    float roi_height;
+    bool mirror;
+  };
+
   bool GetImageAndLabelAndInfoFromDBValue(
       const string& value,
       cv::Mat* img,
       PerImageArg& info,
       int item_id,
-      std::mt19937* randgen);
+      std::mt19937* randgen,
+      DeferredImage* deferred = nullptr);
+  void CropDeferredImage(
+      int height,
+      int width,
+      const PerImageArg& info,
+      std::mt19937* randgen,
+      DeferredImage* deferred);
   void DecodeAndTransform(
       const std::string& value,
       float* image_data,
@@ -92,6 +113,17 @@ class ImageInputOp final : public PrefetchOperator<Context> {
       int item_id,
       const int channels,
       std::size_t thread_index);
+  void DecodeOrDefer(
+      const std::string& value,
+      uint8_t* image_data,
+      int item_id,
+      const int channels,
+      std::size_t thread_index);
+  void DecodeDeferredOnCPU(
+      uint8_t* image_data,
+      int item_id,
+      const int channels);
+  bool DecodeDeferredImages();
   bool ApplyTransformOnGPU(
       const std::vector<std::int64_t>& dims,
       const c10::Device& type);
@@ -135,6 +167,7 @@ class ImageInputOp final : public PrefetchOperator<Context> {
   bool is_test_;
   bool use_caffe_datum_;
   bool gpu_transform_;
+  bool use_nvjpeg_;
   bool mean_std_copied_ = false;
 
   // thread pool for parse + decode
@@ -147,6 +180,12 @@ class ImageInputOp final : public PrefetchOperator<Context> {
   // Output type for GPU transform path
   TensorProto_DataType output_type_;
 
+  // nvJPEG path: the images of the batch deferred to the GPU, the decoder
+  // holding them once decoded, and the crops passed to the transform kernel
+  std::vector<DeferredImage> deferred_images_;
+  std::shared_ptr<NvjpegBatchDecoder> nvjpeg_decoder_;
+  Tensor deferred_crops_on_device_;
+
   // random minsize
   vector<int> random_scale_;
   bool random_scaling_;
@@ -205,6 +244,8 @@ ImageInputOp<Context>::ImageInputOp(
       gpu_transform_(OperatorBase::template GetSingleArgument<int>(
           "use_gpu_transform",
           0)),
+      use_nvjpeg_(
+          OperatorBase::template GetSingleArgument<int>("use_nvjpeg", 0)),
       num_decode_threads_(
           OperatorBase::template GetSingleArgument<int>("decode_threads", 4)),
       additional_output_sizes_(
@@ -312,6 +353,14 @@ ImageInputOp<Context>::ImageInputOp(
       !use_caffe_datum_ || OutputSize() == 2,
       "There can only be 2 outputs if the Caffe datum format is used");
 
+  CAFFE_ENFORCE(
+      !use_nvjpeg_ || (gpu_transform_ && Context::GetDeviceType() == CUDA),
+      "nvJPEG decoding can only be used with use_gpu_transform in a "
+      "CUDAContext");
+#ifndef CAFFE2_USE_NVJPEG
+  CAFFE_ENFORCE(!use_nvjpeg_, "Caffe2 was not built with nvJPEG");
+#endif
+
   CAFFE_ENFORCE(
       random_scale_.size() == 2, "Must provide [scale_min, scale_max]");
   CAFFE_ENFORCE_GE(
@@ -339,6 +388,9 @@ ImageInputOp<Context>::ImageInputOp(
   if (gpu_transform_) {
     LOG(INFO) << "    Performing transformation on GPU";
   }
+  if (use_nvjpeg_) {
+    LOG(INFO) << "    Decoding baseline JPEGs on GPU with nvJPEG";
+  }
   LOG(INFO) << "    Outputting in batches of " << batch_size_ << " images;";
   LOG(INFO) << "    Treating input image as "
             << (color_ ? "color " : "grayscale ") << "image;";
@@ -410,6 +462,66 @@ ImageInputOp<Context>::ImageInputOp(
     prefetched_additional_outputs_on_device_.emplace_back();
     prefetched_additional_outputs_.emplace_back();
   }
+  if (use_nvjpeg_) {
+    deferred_images_.resize(batch_size_);
+  }
+}
+
+// Reads the size of a JPEG from its frame header, returning false unless it
+// is an 8 bit baseline (or extended sequential) Huffman coded JPEG of 1 or 3
+// components, the encodings decoded by nvJPEG. Progressive, arithmetic coded,
+// lossless and 12 bit JPEGs, as well as any other image format, are left to
+// OpenCV.
+inline bool ReadBaselineJpegHeader(
+    const std::string& encoded,
+    int* height,
+    int* width,
+    int* components) {
+  const auto* data = reinterpret_cast<const unsigned char*>(encoded.data());
+  const size_t size = encoded.size();
+  if (size < 4 || data[0] != 0xFF || data[1] != 0xD8) {
+    return false;
+  }
+  size_t pos = 2;
+  while (pos + 4 <= size) {
+    if (data[pos] != 0xFF) {
+      return false;
+    }
+    const unsigned char marker = data[pos + 1];
+    if (marker == 0xFF) {
+      // fill byte
+      ++pos;
+      continue;
+    }
+    if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8)) {
+      // markers without a payload
+      pos += 2;
+      continue;
+    }
+    const size_t length = (data[pos + 2] << 8) | data[pos + 3];
+    if (length < 2 || pos + 2 + length > size) {
+      return false;
+    }
+    if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 &&
+        marker != 0xC8 && marker != 0xCC) {
+      // start of frame
+      if ((marker != 0xC0 && marker != 0xC1) || length < 8) {
+        return false;
+      }
+      const unsigned char* frame = data + pos + 4;
+      *height = (frame[1] << 8) | frame[2];
+      *width = (frame[3] << 8) | frame[4];
+      *components = frame[5];
+      return frame[0] == 8 && *height > 0 && *width > 0 &&
+          (*components == 1 || *components == 3);
+    }
+    if (marker == 0xDA || marker == 0xD9) {
+      // start of scan or end of image before any frame header
+      return false;
+    }
+    pos += 2 + length;
+  }
+  return false;
 }
 
 // Inception-stype scale jittering
@@ -451,7 +563,8 @@ bool ImageInputOp<Context>::GetImageAndLabelAndInfoFromDBValue(
     cv::Mat* img,
     PerImageArg& info,
     int item_id,
-    std::mt19937* randgen) {
+    std::mt19937* randgen,
+    DeferredImage* deferred) {
   //
   // recommend using --caffe2_use_fatal_for_enforce=1 when using ImageInputOp
   // as this function runs on a worker thread and the exceptions from
@@ -459,6 +572,22 @@ bool ImageInputOp<Context>::GetImageAndLabelAndInfoFromDBValue(
   //
   cv::Mat src;
 
+  // With nvJPEG, the encoded images it supports are kept for the GPU instead
+  // of being decoded here
+  int jpeg_height = 0, jpeg_width = 0;
+  auto defer_jpeg = [&](const std::string& encoded) {
+    int components = 0;
+    if (deferred == nullptr ||
+        !ReadBaselineJpegHeader(
+            encoded, &jpeg_height, &jpeg_width, &components) ||
+        (color_ && components != 3)) {
+      return false;
+    }
+    deferred->deferred = true;
+    deferred->encoded = encoded;
+    return true;
+  };
+
   // Use the default information for images
   info = default_arg_;
   if (use_caffe_datum_) {
@@ -470,21 +599,23 @@ bool ImageInputOp<Context>::GetImageAndLabelAndInfoFromDBValue(
     if (datum.encoded()) {
       // encoded image in datum.
       // count the number of exceptions from opencv imdecode
-      try {
-        src = cv::imdecode(
-            cv::Mat(
-                1,
-                datum.data().size(),
-                CV_8UC1,
-                const_cast<char*>(datum.data().data())),
-            color_ ? cv::IMREAD_COLOR : cv::IMREAD_GRAYSCALE);
-        if (src.rows == 0 || src.cols == 0) {
+      if (!defer_jpeg(datum.data())) {
+        try {
+          src = cv::imdecode(
+              cv::Mat(
+                  1,
+                  datum.data().size(),
+                  CV_8UC1,
+                  const_cast<char*>(datum.data().data())),
+              color_ ? cv::IMREAD_COLOR : cv::IMREAD_GRAYSCALE);
+          if (src.rows == 0 || src.cols == 0) {
+            num_decode_errors_in_batch_++;
+            src = cv::Mat::zeros(cv::Size(224, 224), CV_8UC3);
+          }
+        } catch (cv::Exception& e) {
           num_decode_errors_in_batch_++;
           src = cv::Mat::zeros(cv::Size(224, 224), CV_8UC3);
         }
-      } catch (cv::Exception& e) {
-        num_decode_errors_in_batch_++;
-        src = cv::Mat::zeros(cv::Size(224, 224), CV_8UC3);
       }
     } else {
       // Raw image in datum.
@@ -545,21 +676,23 @@ bool ImageInputOp<Context>::GetImageAndLabelAndInfoFromDBValue(
       int encoded_size = encoded_image_str.size();
       // We use a cv::Mat to wrap the encoded str so we do not need a copy.
       // count the number of exceptions from opencv imdecode
-      try {
-        src = cv::imdecode(
-            cv::Mat(
-                1,
-                &encoded_size,
-                CV_8UC1,
-                const_cast<char*>(encoded_image_str.data())),
-            color_ ? cv::IMREAD_COLOR : cv::IMREAD_GRAYSCALE);
-        if (src.rows == 0 || src.cols == 0) {
+      if (!defer_jpeg(encoded_image_str)) {
+        try {
+          src = cv::imdecode(
+              cv::Mat(
+                  1,
+                  &encoded_size,
+                  CV_8UC1,
+                  const_cast<char*>(encoded_image_str.data())),
+              color_ ? cv::IMREAD_COLOR : cv::IMREAD_GRAYSCALE);
+          if (src.rows == 0 || src.cols == 0) {
+            num_decode_errors_in_batch_++;
+            src = cv::Mat::zeros(cv::Size(224, 224), CV_8UC3);
+          }
+        } catch (cv::Exception& e) {
           num_decode_errors_in_batch_++;
           src = cv::Mat::zeros(cv::Size(224, 224), CV_8UC3);
         }
-      } catch (cv::Exception& e) {
-        num_decode_errors_in_batch_++;
-        src = cv::Mat::zeros(cv::Size(224, 224), CV_8UC3);
       }
     } else if (image_proto.data_type() == TensorProto::BYTE) {
       // raw image content.
@@ -687,6 +820,11 @@ bool ImageInputOp<Context>::GetImageAndLabelAndInfoFromDBValue(
     }
   }
 
+  if (deferred != nullptr && deferred->deferred) {
+    CropDeferredImage(jpeg_height, jpeg_width, info, randgen, deferred);
+    return true;
+  }
+
   //
   // convert source to the color format requested from Op
   //
@@ -1146,6 +1284,184 @@ void ImageInputOp<Context>::DecodeAndTransposeOnly(
       is_test_);
 }
 
+// Decides the crop of an image left to nvJPEG the way the CPU path does: the
+// bounding box, then either the inception-style random crop or the rescaling
+// followed by the (random) crop, and the random mirroring. The crop is a
+// region of the height x width decoded image.
+template <class Context>
+void ImageInputOp<Context>::CropDeferredImage(
+    int height,
+    int width,
+    const PerImageArg& info,
+    std::mt19937* randgen,
+    DeferredImage* deferred) {
+  float x = 0, y = 0;
+  int im_height = height, im_width = width;
+  if (info.bounding_params.valid &&
+      height >= info.bounding_params.ymin + info.bounding_params.height &&
+      width >= info.bounding_params.xmin + info.bounding_params.width) {
+    x = info.bounding_params.xmin;
+    y = info.bounding_params.ymin;
+    im_height = info.bounding_params.height;
+    im_width = info.bounding_params.width;
+  }
+
+  std::bernoulli_distribution mirror_this_image(0.5f);
+  deferred->mirror = mirror_ && mirror_this_image(*randgen);
+
+  if (scale_jitter_type_ == INCEPTION_STYLE && !is_test_) {
+    // See RandomSizedCropping
+    int area = im_height * im_width;
+    std::uniform_real_distribution<> area_dis(0.08, 1.0);
+    std::uniform_real_distribution<> aspect_ratio_dis(3.0 / 4.0, 4.0 / 3.0);
+    for (int i = 0; i < 10; ++i) {
+      int target_area = int(ceil(area_dis(*randgen) * area));
+      float aspect_ratio = aspect_ratio_dis(*randgen);
+      int nh = floor(std::sqrt(((float)target_area / aspect_ratio)));
+      int nw = floor(std::sqrt(((float)target_area * aspect_ratio)));
+      if (nh >= 1 && nh <= im_height && nw >= 1 && nw <= im_width) {
+        deferred->roi_x = x +
+            std::uniform_int_distribution<>(0, im_width - nw)(*randgen);
+        deferred->roi_y = y +
+            std::uniform_int_distribution<>(0, im_height - nh)(*randgen);
+        deferred->roi_width = nw;
+        deferred->roi_height = nh;
+        return;
+      }
+    }
+  }
+
+  // See the end of GetImageAndLabelAndInfoFromDBValue
+  int scaled_width = im_width, scaled_height = im_height;
+  int scale_to_use = scale_ > 0 ? scale_ : minsize_;
+  if (random_scaling_) {
+    scale_to_use = std::uniform_int_distribution<>(
+        random_scale_[0], random_scale_[1])(*randgen);
+  }
+  int new_width, new_height;
+  if (warp_) {
+    new_width = scale_to_use;
+    new_height = scale_to_use;
+  } else if (im_height > im_width) {
+    new_width = scale_to_use;
+    new_height = static_cast<float>(im_height) * scale_to_use / im_width;
+  } else {
+    new_height = scale_to_use;
+    new_width = static_cast<float>(im_width) * scale_to_use / im_height;
+  }
+  if ((scale_ > 0 && (new_height != im_height || new_width != im_width)) ||
+      (new_height > im_height || new_width > im_width)) {
+    scaled_width = new_width;
+    scaled_height = new_height;
+  }
+
+  // See CropTransposeImage
+  CAFFE_ENFORCE_GE(
+      scaled_height, crop_, "Image height must be bigger than crop.");
+  CAFFE_ENFORCE_GE(
+      scaled_width, crop_, "Image width must be bigger than crop.");
+  int width_offset, height_offset;
+  if (is_test_) {
+    width_offset = (scaled_width - crop_) / 2;
+    height_offset = (scaled_height - crop_) / 2;
+  } else {
+    width_offset =
+        std::uniform_int_distribution<>(0, scaled_width - crop_)(*randgen);
+    height_offset =
+        std::uniform_int_distribution<>(0, scaled_height - crop_)(*randgen);
+  }
+  const float x_scale = static_cast<float>(im_width) / scaled_width;
+  const float y_scale = static_cast<float>(im_height) / scaled_height;
+  deferred->roi_x = x + width_offset * x_scale;
+  deferred->roi_y = y + height_offset * y_scale;
+  deferred->roi_width = crop_ * x_scale;
+  deferred->roi_height = crop_ * y_scale;
+}
+
+// Like DecodeAndTransposeOnly, except that the images nvJPEG supports are only
+// cropped, their decoding being left to DecodeDeferredImages
+template <class Context>
+void ImageInputOp<Context>::DecodeOrDefer(
+    const std::string& value,
+    uint8_t* image_data,
+    int item_id,
+    const int channels,
+    std::size_t thread_index) {
+  CAFFE_ENFORCE((int)thread_index < num_decode_threads_);
+
+  std::bernoulli_distribution mirror_this_image(0.5f);
+  std::mt19937* randgen = &(randgen_per_thread_[thread_index]);
+
+  DeferredImage* deferred = &deferred_images_[item_id];
+  deferred->deferred = false;
+  deferred->encoded.clear();
+
+  cv::Mat img;
+  PerImageArg info;
+  CHECK(GetImageAndLabelAndInfoFromDBValue(
+      value, &img, info, item_id, randgen, deferred));
+  if (deferred->deferred) {
+    return;
+  }
+
+  CropTransposeImage<Context>(
+      img,
+      channels,
+      image_data,
+      crop_,
+      mirror_,
+      randgen,
+      &mirror_this_image,
+      is_test_);
+}
+
+// Decodes a deferred image with OpenCV, for when nvJPEG fails on its batch,
+// and applies the crop already decided for it
+template <class Context>
+void ImageInputOp<Context>::DecodeDeferredOnCPU(
+    uint8_t* image_data,
+    int item_id,
+    const int channels) {
+  DeferredImage* deferred = &deferred_images_[item_id];
+  cv::Mat src;
+  try {
+    int encoded_size = deferred->encoded.size();
+    src = cv::imdecode(
+        cv::Mat(
+            1,
+            &encoded_size,
+            CV_8UC1,
+            const_cast<char*>(deferred->encoded.data())),
+        color_ ? cv::IMREAD_COLOR : cv::IMREAD_GRAYSCALE);
+  } catch (cv::Exception& e) {
+    src = cv::Mat();
+  }
+  deferred->deferred = false;
+  if (src.rows == 0 || src.cols == 0) {
+    num_decode_errors_in_batch_++;
+    memset(image_data, 0, crop_ * crop_ * channels);
+    return;
+  }
+
+  int x = std::min<int>(std::lround(deferred->roi_x), src.cols - 1);
+  int y = std::min<int>(std::lround(deferred->roi_y), src.rows - 1);
+  cv::Rect roi(
+      x,
+      y,
+      std::max<int>(
+          std::min<int>(std::lround(deferred->roi_width), src.cols - x), 1),
+      std::max<int>(
+          std::min<int>(std::lround(deferred->roi_height), src.rows - y), 1));
+  cv::Mat cropped;
+  cv::resize(
+      src(roi), cropped, cv::Size(crop_, crop_), 0, 0, cv::INTER_AREA);
+  if (deferred->mirror) {
+    cv::flip(cropped, cropped, 1);
+  }
+  CAFFE_ENFORCE(cropped.isContinuous());
+  memcpy(image_data, cropped.ptr<uint8_t>(0), crop_ * crop_ * channels);
+}
+
 template <class Context>
 bool ImageInputOp<Context>::Prefetch() {
   if (!owned_reader_.get()) {
@@ -1218,7 +1534,18 @@ bool ImageInputOp<Context>::Prefetch() {
 
     // launch into thread pool for processing
     // TODO: support color jitter and color lighting in gpu_transform
-    if (gpu_transform_) {
+    if (use_nvjpeg_) {
+      uint8_t* image_data = prefetched_image_.mutable_data<uint8_t>() +
+          crop_ * crop_ * channels * item_id;
+      thread_pool_->runTaskWithID(std::bind(
+          &ImageInputOp<Context>::DecodeOrDefer,
+          this,
+          std::string(value),
+          image_data,
+          item_id,
+          channels,
+          std::placeholders::_1));
+    } else if (gpu_transform_) {
       // output of decode will still be int8
       uint8_t* image_data = prefetched_image_.mutable_data<uint8_t>() +
           crop_ * crop_ * channels * item_id;
@@ -1245,6 +1572,23 @@ bool ImageInputOp<Context>::Prefetch() {
   }
   thread_pool_->waitWorkComplete();
 
+  if (use_nvjpeg_ && !DecodeDeferredImages()) {
+    // nvJPEG fails on the whole batch if any of its images is corrupted
+    LOG(WARNING) << "nvJPEG failed to decode the batch, decoding on CPU";
+    for (int item_id = 0; item_id < batch_size_; ++item_id) {
+      if (deferred_images_[item_id].deferred) {
+        thread_pool_->run(std::bind(
+            &ImageInputOp<Context>::DecodeDeferredOnCPU,
+            this,
+            prefetched_image_.mutable_data<uint8_t>() +
+                crop_ * crop_ * channels * item_id,
+            item_id,
+            channels));
+      }
+    }
+    thread_pool_->waitWorkComplete();
+  }
+
   // we allow to get at most max_decode_error_ratio from
   // opencv imdecode until raising a runtime exception
   if ((float)num_decode_errors_in_batch_ / batch_size_ >
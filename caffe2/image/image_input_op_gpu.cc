@@ -2,31 +2,234 @@
 #include "caffe2/core/context_gpu.h"
 #include "caffe2/image/image_input_op.h"
 
+#ifdef CAFFE2_USE_NVJPEG
+#include <nvjpeg.h>
+#endif
+
 namespace caffe2 {
 
+#ifdef CAFFE2_USE_NVJPEG
+
+// Decodes batches of JPEGs with nvJPEG into device memory, as interleaved BGR
+// (or grayscale) images, the layout of the images decoded by OpenCV.
+class NvjpegBatchDecoder {
+ public:
+  explicit NvjpegBatchDecoder(bool color)
+      : output_format_(color ? NVJPEG_OUTPUT_BGRI : NVJPEG_OUTPUT_Y),
+        channels_(color ? 3 : 1) {
+    CAFFE_ENFORCE_EQ(
+        nvjpegCreate(NVJPEG_BACKEND_DEFAULT, nullptr, &handle_),
+        NVJPEG_STATUS_SUCCESS,
+        "Failed to create the nvJPEG handle");
+    CAFFE_ENFORCE_EQ(
+        nvjpegJpegStateCreate(handle_, &state_),
+        NVJPEG_STATUS_SUCCESS,
+        "Failed to create the nvJPEG state");
+  }
+
+  ~NvjpegBatchDecoder() {
+    nvjpegJpegStateDestroy(state_);
+    nvjpegDestroy(handle_);
+  }
+
+  // Returns false if any of the images fails to decode, nvJPEG decoding the
+  // batch as a whole
+  bool Decode(
+      const std::vector<const std::string*>& images,
+      CUDAContext* context) {
+    const int batch_size = images.size();
+    data_.resize(batch_size);
+    lengths_.resize(batch_size);
+    heights_.resize(batch_size);
+    widths_.resize(batch_size);
+    offsets_.resize(batch_size);
+    destinations_.resize(batch_size);
+
+    size_t total_size = 0;
+    for (int i = 0; i < batch_size; ++i) {
+      data_[i] = reinterpret_cast<const unsigned char*>(images[i]->data());
+      lengths_[i] = images[i]->size();
+      int components = 0;
+      nvjpegChromaSubsampling_t subsampling;
+      int widths[NVJPEG_MAX_COMPONENT], heights[NVJPEG_MAX_COMPONENT];
+      if (nvjpegGetImageInfo(
+              handle_,
+              data_[i],
+              lengths_[i],
+              &components,
+              &subsampling,
+              widths,
+              heights) != NVJPEG_STATUS_SUCCESS ||
+          subsampling == NVJPEG_CSS_UNKNOWN) {
+        return false;
+      }
+      heights_[i] = heights[0];
+      widths_[i] = widths[0];
+      offsets_[i] = total_size;
+      total_size += static_cast<size_t>(heights[0]) * widths[0] * channels_;
+    }
+
+    ReinitializeTensor(
+        &decoded_,
+        {static_cast<int64_t>(total_size)},
+        at::dtype<uint8_t>().device(CUDA));
+    uint8_t* decoded_data = decoded_.mutable_data<uint8_t>();
+    for (int i = 0; i < batch_size; ++i) {
+      memset(&destinations_[i], 0, sizeof(nvjpegImage_t));
+      destinations_[i].channel[0] = decoded_data + offsets_[i];
+      destinations_[i].pitch[0] = widths_[i] * channels_;
+    }
+
+    if (batch_size != initialized_batch_size_) {
+      if (nvjpegDecodeBatchedInitialize(
+              handle_, state_, batch_size, 1, output_format_) !=
+          NVJPEG_STATUS_SUCCESS) {
+        initialized_batch_size_ = 0;
+        return false;
+      }
+      initialized_batch_size_ = batch_size;
+    }
+    return nvjpegDecodeBatched(
+               handle_,
+               state_,
+               data_.data(),
+               lengths_.data(),
+               destinations_.data(),
+               context->cuda_stream()) == NVJPEG_STATUS_SUCCESS;
+  }
+
+  // The i-th image of the last decoded batch, as a crop of all of it
+  ImageCrop crop(int i) const {
+    ImageCrop image;
+    image.data = decoded_.data<uint8_t>() + offsets_[i];
+    image.pitch = widths_[i] * channels_;
+    image.height = heights_[i];
+    image.width = widths_[i];
+    image.roi_x = 0;
+    image.roi_y = 0;
+    image.roi_width = widths_[i];
+    image.roi_height = heights_[i];
+    image.mirror = 0;
+    return image;
+  }
+
+ private:
+  const nvjpegOutputFormat_t output_format_;
+  const int channels_;
+  nvjpegHandle_t handle_;
+  nvjpegJpegState_t state_;
+  int initialized_batch_size_ = 0;
+
+  std::vector<const unsigned char*> data_;
+  std::vector<size_t> lengths_;
+  std::vector<int> heights_;
+  std::vector<int> widths_;
+  std::vector<size_t> offsets_;
+  std::vector<nvjpegImage_t> destinations_;
+  Tensor decoded_;
+};
+
+#endif // CAFFE2_USE_NVJPEG
+
+template <>
+bool ImageInputOp<CUDAContext>::DecodeDeferredImages() {
+#ifdef CAFFE2_USE_NVJPEG
+  std::vector<const std::string*> images;
+  for (const auto& deferred : deferred_images_) {
+    if (deferred.deferred) {
+      images.push_back(&deferred.encoded);
+    }
+  }
+  if (images.empty()) {
+    return true;
+  }
+  if (!nvjpeg_decoder_) {
+    nvjpeg_decoder_ = std::make_shared<NvjpegBatchDecoder>(color_);
+  }
+  return nvjpeg_decoder_->Decode(images, &context_);
+#else
+  return false;
+#endif
+}
+
 template <>
 bool ImageInputOp<CUDAContext>::ApplyTransformOnGPU(
     const std::vector<std::int64_t>& dims,
     const c10::Device& type) {
+  // With nvJPEG, the crops of the deferred images are taken out of the
+  // decoded images and resized by the transform, the other images being
+  // already cropped
+  std::vector<ImageCrop> crops;
+#ifdef CAFFE2_USE_NVJPEG
+  if (use_nvjpeg_) {
+    const int C = dims[1], crop = dims[2];
+    const uint8_t* cropped_data =
+        prefetched_image_on_device_.template data<uint8_t>();
+    int decoded = 0;
+    for (int n = 0; n < batch_size_; ++n) {
+      const auto& deferred = deferred_images_[n];
+      if (deferred.deferred) {
+        ImageCrop image_crop = nvjpeg_decoder_->crop(decoded++);
+        image_crop.roi_x = deferred.roi_x;
+        image_crop.roi_y = deferred.roi_y;
+        image_crop.roi_width = deferred.roi_width;
+        image_crop.roi_height = deferred.roi_height;
+        image_crop.mirror = deferred.mirror;
+        crops.push_back(image_crop);
+      } else {
+        crops.push_back(ImageCrop{cropped_data + n * crop * crop * C,
+                                  crop * C,
+                                  crop,
+                                  crop,
+                                  0.f,
+                                  0.f,
+                                  static_cast<float>(crop),
+                                  static_cast<float>(crop),
+                                  0});
+      }
+    }
+  }
+#endif
+
   // GPU transform kernel allows explicitly setting output type
   if (output_type_ == TensorProto_DataType_FLOAT) {
     auto* image_output =
         OperatorBase::OutputTensor(0, dims, at::dtype<float>().device(type));
-    TransformOnGPU<uint8_t, float, CUDAContext>(
-        prefetched_image_on_device_,
-        image_output,
-        mean_gpu_,
-        std_gpu_,
-        &context_);
+    if (use_nvjpeg_) {
+      ResizeCropTransformOnGPU<float, CUDAContext>(
+          crops,
+          &deferred_crops_on_device_,
+          image_output,
+          mean_gpu_,
+          std_gpu_,
+          &context_);
+    } else {
+      TransformOnGPU<uint8_t, float, CUDAContext>(
+          prefetched_image_on_device_,
+          image_output,
+          mean_gpu_,
+          std_gpu_,
+          &context_);
+    }
   } else if (output_type_ == TensorProto_DataType_FLOAT16) {
     auto* image_output =
         OperatorBase::OutputTensor(0, dims, at::dtype<at::Half>().device(type));
-    TransformOnGPU<uint8_t, at::Half, CUDAContext>(
-        prefetched_image_on_device_,
-        image_output,
-        mean_gpu_,
-        std_gpu_,
-        &context_);
+    if (use_nvjpeg_) {
+      ResizeCropTransformOnGPU<at::Half, CUDAContext>(
+          crops,
+          &deferred_crops_on_device_,
+          image_output,
+          mean_gpu_,
+          std_gpu_,
+          &context_);
+    } else {
+      TransformOnGPU<uint8_t, at::Half, CUDAContext>(
+          prefetched_image_on_device_,
+          image_output,
+          mean_gpu_,
+          std_gpu_,
+          &context_);
+    }
   } else {
     return false;
   }
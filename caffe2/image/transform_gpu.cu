@@ -46,6 +46,94 @@ __global__ void transform_kernel(
   }
 }
 
+// Averages the pixels of the footprint of an output pixel, weighted by their
+// overlap with it, like cv::INTER_AREA does when downscaling
+__device__ void area_sample(
+    const ImageCrop& img,
+    const int C,
+    const float x0,
+    const float y0,
+    const float x_scale,
+    const float y_scale,
+    float* value) {
+  const float x1 = x0 + x_scale, y1 = y0 + y_scale;
+  for (int y = floorf(y0); y < ceilf(y1); ++y) {
+    const float wy = fminf(y1, y + 1) - fmaxf(y0, y);
+    const uint8_t* row =
+        img.data + min(max(y, 0), img.height - 1) * img.pitch;
+    for (int x = floorf(x0); x < ceilf(x1); ++x) {
+      const float weight = wy * (fminf(x1, x + 1) - fmaxf(x0, x));
+      const uint8_t* pixel = row + min(max(x, 0), img.width - 1) * C;
+      for (int c = 0; c < C; ++c) {
+        value[c] += weight * pixel[c];
+      }
+    }
+  }
+  const float norm = 1.f / (x_scale * y_scale);
+  for (int c = 0; c < C; ++c) {
+    value[c] *= norm;
+  }
+}
+
+// Interpolates the pixels around the center of an output pixel, when
+// upscaling
+__device__ void bilinear_sample(
+    const ImageCrop& img,
+    const int C,
+    float x,
+    float y,
+    float* value) {
+  x = fminf(fmaxf(x, 0.f), img.width - 1);
+  y = fminf(fmaxf(y, 0.f), img.height - 1);
+  const int x0 = x, y0 = y;
+  const int x1 = min(x0 + 1, img.width - 1), y1 = min(y0 + 1, img.height - 1);
+  const float fx = x - x0, fy = y - y0;
+  const uint8_t* row0 = img.data + y0 * img.pitch;
+  const uint8_t* row1 = img.data + y1 * img.pitch;
+  for (int c = 0; c < C; ++c) {
+    value[c] = (1 - fy) * ((1 - fx) * row0[x0 * C + c] + fx * row0[x1 * C + c]) +
+        fy * ((1 - fx) * row1[x0 * C + c] + fx * row1[x1 * C + c]);
+  }
+}
+
+// input in (int8, HWC) crops of any size, output in (fp32, NCHW) of
+// H = W = crop
+template <typename Out>
+__global__ void resize_crop_transform_kernel(
+    const int C,
+    const int crop,
+    const ImageCrop* crops,
+    const float* mean,
+    const float* std,
+    Out* out) {
+  const int n = blockIdx.x;
+  const ImageCrop img = crops[n];
+  Out* output_ptr = &out[n*C*crop*crop];
+
+  const float x_scale = img.roi_width / crop;
+  const float y_scale = img.roi_height / crop;
+  const bool downscale = x_scale >= 1.f && y_scale >= 1.f;
+  for (int h=threadIdx.y; h < crop; h += blockDim.y) {
+    const float y0 = img.roi_y + h * y_scale;
+    for (int w=threadIdx.x; w < crop; w += blockDim.x) {
+      const float x0 =
+          img.roi_x + (img.mirror ? crop - 1 - w : w) * x_scale;
+      float value[3] = {0.f, 0.f, 0.f};
+      if (downscale) {
+        area_sample(img, C, x0, y0, x_scale, y_scale, value);
+      } else {
+        bilinear_sample(
+            img, C, x0 + 0.5f * x_scale - 0.5f, y0 + 0.5f * y_scale - 0.5f,
+            value);
+      }
+      for (int c=0; c < C; ++c) {
+        output_ptr[c*crop*crop + h*crop + w] =
+            convert::To<float,Out>((value[c]-mean[c]) * std[c]);
+      }
+    }
+  }
+}
+
 }
 
 template <typename T_IN, typename T_OUT, class Context>
@@ -67,6 +155,33 @@ bool TransformOnGPU(
   return true;
 };
 
+template <typename T_OUT, class Context>
+bool ResizeCropTransformOnGPU(
+    const std::vector<ImageCrop>& crops,
+    Tensor* crops_on_device,
+    Tensor* Y,
+    Tensor& mean,
+    Tensor& std,
+    Context* context) {
+  const int N = Y->dim32(0), C = Y->dim32(1), crop = Y->dim32(2);
+  CAFFE_ENFORCE_EQ(crops.size(), static_cast<size_t>(N));
+  CAFFE_ENFORCE_LE(C, 3);
+  const size_t nbytes = N * sizeof(ImageCrop);
+  ReinitializeTensor(
+      crops_on_device,
+      {static_cast<int64_t>(nbytes)},
+      at::dtype<uint8_t>().device(Context::GetDeviceType()));
+  auto* crops_data = crops_on_device->template mutable_data<uint8_t>();
+  context->CopyBytesFromCPU(nbytes, crops.data(), crops_data);
+  auto* output_data = Y->template mutable_data<T_OUT>();
+
+  resize_crop_transform_kernel<
+    T_OUT><<<N, dim3(16, 16), 0, context->cuda_stream()>>>(
+      C, crop, reinterpret_cast<const ImageCrop*>(crops_data),
+      mean.template data<float>(), std.template data<float>(), output_data);
+  return true;
+}
+
 template bool TransformOnGPU<uint8_t, float, CUDAContext>(
     Tensor& X,
     Tensor* Y,
@@ -81,4 +196,20 @@ template bool TransformOnGPU<uint8_t, at::Half, CUDAContext>(
     Tensor& std,
     CUDAContext* context);
 
+template bool ResizeCropTransformOnGPU<float, CUDAContext>(
+    const std::vector<ImageCrop>& crops,
+    Tensor* crops_on_device,
+    Tensor* Y,
+    Tensor& mean,
+    Tensor& std,
+    CUDAContext* context);
+
+template bool ResizeCropTransformOnGPU<at::Half, CUDAContext>(
+    const std::vector<ImageCrop>& crops,
+    Tensor* crops_on_device,
+    Tensor* Y,
+    Tensor& mean,
+    Tensor& std,
+    CUDAContext* context);
+
 }  // namespace caffe2
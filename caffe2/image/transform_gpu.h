@@ -38,6 +38,31 @@ bool TransformOnGPU(
     Tensor& std,
     Context* context);
 
+// A region of an HWC uint8 image on the device (of at most 3 channels), which
+// is resized to the output image, and optionally mirrored
+struct ImageCrop {
+  const uint8_t* data;
+  int pitch;
+  int height;
+  int width;
+  float roi_x;
+  float roi_y;
+  float roi_width;
+  float roi_height;
+  int mirror;
+};
+
+// Fuses the resizing of the crops to Y (NCHW, of one crop per image) with
+// the transform of TransformOnGPU. The crops are copied up to crops_on_device.
+template <typename T_OUT, class Context>
+bool ResizeCropTransformOnGPU(
+    const std::vector<ImageCrop>& crops,
+    Tensor* crops_on_device,
+    Tensor* Y,
+    Tensor& mean,
+    Tensor& std,
+    Context* context);
+
 }  // namespace caffe2
 
 #endif
@@ -0,0 +1,228 @@
+#include "latency_histogram_observer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+
+#include "caffe2/core/init.h"
+#include "caffe2/core/logging.h"
+
+C10_DEFINE_bool(
+    caffe2_op_latency_histograms,
+    false,
+    "If set, records histograms of the latencies of the operators of all the "
+    "nets by operator type, see LatencyHistogramNetObserver.");
+
+namespace caffe2 {
+
+constexpr int LatencyHistogram::kSubBuckets;
+constexpr int LatencyHistogram::kMaxShift;
+constexpr int LatencyHistogram::kNumBuckets;
+
+int LatencyHistogram::BucketOf(int64_t nanos) {
+  if (nanos < kSubBuckets) {
+    return std::max<int64_t>(nanos, 0);
+  }
+  const int msb = 63 - __builtin_clzll(nanos);
+  const int shift = msb - 4;
+  if (shift >= kMaxShift) {
+    return kNumBuckets - 1;
+  }
+  return (shift + 1) * kSubBuckets + (nanos >> shift) - kSubBuckets;
+}
+
+double LatencyHistogram::BucketValue(int bucket) {
+  if (bucket < kSubBuckets) {
+    return bucket;
+  }
+  const int shift = bucket / kSubBuckets - 1;
+  const int64_t lower = (int64_t)(bucket % kSubBuckets + kSubBuckets) << shift;
+  return lower + ((int64_t(1) << shift) - 1) / 2.0;
+}
+
+void LatencyHistogram::Record(int64_t nanos) {
+  Add(&buckets_[BucketOf(nanos)], 1);
+  Add(&count_, 1);
+  Add(&sum_, nanos);
+  if (nanos > max_.load(std::memory_order_relaxed)) {
+    max_.store(nanos, std::memory_order_relaxed);
+  }
+}
+
+void LatencyHistogram::MergeFrom(const LatencyHistogram& other) {
+  for (int i = 0; i < kNumBuckets; ++i) {
+    Add(&buckets_[i], other.buckets_[i].load(std::memory_order_relaxed));
+  }
+  Add(&count_, other.count_.load(std::memory_order_relaxed));
+  Add(&sum_, other.sum_.load(std::memory_order_relaxed));
+  max_.store(
+      std::max(
+          max_.load(std::memory_order_relaxed),
+          other.max_.load(std::memory_order_relaxed)),
+      std::memory_order_relaxed);
+}
+
+double LatencyHistogram::MeanMicros() const {
+  const int64_t n = count();
+  return n == 0 ? 0.0 : sum_.load(std::memory_order_relaxed) / 1000.0 / n;
+}
+
+double LatencyHistogram::MaxMicros() const {
+  return max_.load(std::memory_order_relaxed) / 1000.0;
+}
+
+double LatencyHistogram::PercentileMicros(double fraction) const {
+  // the buckets rather than count_, which may be behind or ahead of them
+  // while the histogram is recorded into
+  int64_t total = 0;
+  for (const auto& bucket : buckets_) {
+    total += bucket.load(std::memory_order_relaxed);
+  }
+  if (total == 0) {
+    return 0.0;
+  }
+  const int64_t rank = std::max<int64_t>(1, std::ceil(fraction * total));
+  int64_t seen = 0;
+  for (int i = 0; i < kNumBuckets; ++i) {
+    seen += buckets_[i].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      return std::min(BucketValue(i), (double)max_.load()) / 1000.0;
+    }
+  }
+  return MaxMicros();
+}
+
+LatencyHistogram* OpLatencyStats::LocalHistogram() {
+  thread_local std::unordered_map<const OpLatencyStats*, LatencyHistogram*>
+      histograms;
+  auto& histogram = histograms[this];
+  if (!histogram) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    histograms_.push_back(std::make_unique<LatencyHistogram>());
+    histogram = histograms_.back().get();
+  }
+  return histogram;
+}
+
+void OpLatencyStats::MergeInto(LatencyHistogram* histogram) const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (const auto& h : histograms_) {
+    histogram->MergeFrom(*h);
+  }
+}
+
+namespace {
+
+struct OpLatencyStatsRegistry {
+  std::mutex mutex;
+  std::map<std::pair<std::string, std::string>, std::unique_ptr<OpLatencyStats>>
+      stats;
+};
+
+// Leaked, the thread local histograms point into it
+OpLatencyStatsRegistry& registry() {
+  static auto* registry = new OpLatencyStatsRegistry();
+  return *registry;
+}
+
+} // namespace
+
+OpLatencyStats* GetOpLatencyStats(
+    const std::string& net_name,
+    const std::string& op_type) {
+  auto& r = registry();
+  std::lock_guard<std::mutex> guard(r.mutex);
+  auto& stats = r.stats[std::make_pair(net_name, op_type)];
+  if (!stats) {
+    stats = std::make_unique<OpLatencyStats>(net_name, op_type);
+  }
+  return stats.get();
+}
+
+std::vector<OpLatencySummary> GetOpLatencySummaries(
+    const std::string& net_name) {
+  std::vector<const OpLatencyStats*> all_stats;
+  {
+    auto& r = registry();
+    std::lock_guard<std::mutex> guard(r.mutex);
+    for (const auto& entry : r.stats) {
+      if (net_name.empty() || entry.first.first == net_name) {
+        all_stats.push_back(entry.second.get());
+      }
+    }
+  }
+  std::vector<OpLatencySummary> summaries;
+  for (const auto* stats : all_stats) {
+    LatencyHistogram histogram;
+    stats->MergeInto(&histogram);
+    summaries.push_back(OpLatencySummary{stats->net_name(),
+                                         stats->op_type(),
+                                         histogram.count(),
+                                         histogram.MeanMicros(),
+                                         histogram.PercentileMicros(0.5),
+                                         histogram.PercentileMicros(0.9),
+                                         histogram.PercentileMicros(0.99),
+                                         histogram.MaxMicros()});
+  }
+  return summaries;
+}
+
+LatencyHistogramOperatorObserver::LatencyHistogramOperatorObserver(
+    OperatorBase* op,
+    LatencyHistogramNetObserver* netObserver)
+    : ObserverBase<OperatorBase>(op), netObserver_(netObserver) {
+  CAFFE_ENFORCE(netObserver_, "Observers can't operate outside of the net");
+  stats_ = GetOpLatencyStats(netObserver_->subject()->Name(), op->type());
+}
+
+void LatencyHistogramOperatorObserver::Start() {
+  start_ = std::chrono::steady_clock::now();
+}
+
+void LatencyHistogramOperatorObserver::Stop() {
+  stats_->Record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now() - start_)
+                     .count());
+}
+
+std::unique_ptr<ObserverBase<OperatorBase>>
+LatencyHistogramOperatorObserver::rnnCopy(
+    OperatorBase* subject,
+    int /* rnn_order */) const {
+  return std::unique_ptr<ObserverBase<OperatorBase>>(
+      new LatencyHistogramOperatorObserver(subject, netObserver_));
+}
+
+std::string LatencyHistogramNetObserver::debugInfo() {
+  std::stringstream ss;
+  for (const auto& summary : GetOpLatencySummaries(subject_->Name())) {
+    ss << summary.op_type << ": count " << summary.count << " mean "
+       << summary.mean_us << "us p50 " << summary.p50_us << "us p90 "
+       << summary.p90_us << "us p99 " << summary.p99_us << "us max "
+       << summary.max_us << "us\n";
+  }
+  return ss.str();
+}
+
+namespace {
+
+bool Caffe2InitOpLatencyHistograms(int*, char***) {
+  if (FLAGS_caffe2_op_latency_histograms) {
+    AddGlobalNetObserverCreator([](NetBase* net) {
+      return std::make_unique<LatencyHistogramNetObserver>(net);
+    });
+  }
+  return true;
+}
+
+} // namespace
+
+REGISTER_CAFFE2_INIT_FUNCTION(
+    Caffe2InitOpLatencyHistograms,
+    &Caffe2InitOpLatencyHistograms,
+    "Attaches a LatencyHistogramNetObserver to all the nets if "
+    "caffe2_op_latency_histograms is set.");
+
+} // namespace caffe2
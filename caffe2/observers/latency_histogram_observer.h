@@ -0,0 +1,161 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "caffe2/core/common.h"
+#include "caffe2/core/net.h"
+#include "caffe2/core/observer.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/observers/operator_attaching_net_observer.h"
+
+namespace caffe2 {
+
+/**
+ * A histogram of latencies in nanoseconds with buckets of a relative width of
+ * at most 1/16 (as HDR histograms with 4 bits of precision), from 1ns to
+ * about 18 minutes. Longer latencies go into the last bucket.
+ *
+ * Record() must be called by one thread at a time, but the histogram can be
+ * read (e.g. merged into another one) while it is recorded into.
+ */
+class CAFFE2_API LatencyHistogram {
+ public:
+  static constexpr int kSubBuckets = 16;
+  static constexpr int kMaxShift = 36;
+  static constexpr int kNumBuckets = (kMaxShift + 1) * kSubBuckets;
+
+  void Record(int64_t nanos);
+  void MergeFrom(const LatencyHistogram& other);
+
+  int64_t count() const {
+    return count_.load(std::memory_order_relaxed);
+  }
+  double MeanMicros() const;
+  double MaxMicros() const;
+  // The latency below which a fraction (0 to 1) of the records are
+  double PercentileMicros(double fraction) const;
+
+  static int BucketOf(int64_t nanos);
+  // The middle of the bucket, in nanoseconds
+  static double BucketValue(int bucket);
+
+ private:
+  static void Add(std::atomic<int64_t>* counter, int64_t value) {
+    counter->store(
+        counter->load(std::memory_order_relaxed) + value,
+        std::memory_order_relaxed);
+  }
+
+  std::array<std::atomic<int64_t>, kNumBuckets> buckets_{};
+  std::atomic<int64_t> count_{0};
+  std::atomic<int64_t> sum_{0};
+  std::atomic<int64_t> max_{0};
+};
+
+/**
+ * The latencies of the operators of one type in one net, recorded into a
+ * histogram per thread so that recording takes no lock and shares no cache
+ * line with the other threads.
+ */
+class CAFFE2_API OpLatencyStats {
+ public:
+  OpLatencyStats(std::string net_name, std::string op_type)
+      : net_name_(std::move(net_name)), op_type_(std::move(op_type)) {}
+
+  void Record(int64_t nanos) {
+    LocalHistogram()->Record(nanos);
+  }
+  // Merges the histograms of all the threads into histogram
+  void MergeInto(LatencyHistogram* histogram) const;
+
+  const std::string& net_name() const {
+    return net_name_;
+  }
+  const std::string& op_type() const {
+    return op_type_;
+  }
+
+ private:
+  LatencyHistogram* LocalHistogram();
+
+  const std::string net_name_;
+  const std::string op_type_;
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<LatencyHistogram>> histograms_;
+};
+
+// The stats of the operators of a type in a net, which live until the end of
+// the process
+CAFFE2_API OpLatencyStats* GetOpLatencyStats(
+    const std::string& net_name,
+    const std::string& op_type);
+
+struct OpLatencySummary {
+  std::string net_name;
+  std::string op_type;
+  int64_t count;
+  double mean_us;
+  double p50_us;
+  double p90_us;
+  double p99_us;
+  double max_us;
+};
+
+// Summaries of the stats of all the operator types of all the nets, or of
+// those of net_name if it is not empty
+CAFFE2_API std::vector<OpLatencySummary> GetOpLatencySummaries(
+    const std::string& net_name = "");
+
+class LatencyHistogramNetObserver;
+
+class CAFFE2_API LatencyHistogramOperatorObserver final
+    : public ObserverBase<OperatorBase> {
+ public:
+  explicit LatencyHistogramOperatorObserver(OperatorBase* op) = delete;
+  LatencyHistogramOperatorObserver(
+      OperatorBase* op,
+      LatencyHistogramNetObserver* netObserver);
+  std::unique_ptr<ObserverBase<OperatorBase>> rnnCopy(
+      OperatorBase* subject,
+      int rnn_order) const override;
+
+ private:
+  void Start() override;
+  void Stop() override;
+
+  LatencyHistogramNetObserver* netObserver_;
+  OpLatencyStats* stats_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+/**
+ * Records the latency of every operator run of the net (from the start to the
+ * end of Run(), or of RunAsync() for asynchronous operators) into the
+ * OpLatencyStats of its type. Cheap enough to be always on, it is attached to
+ * all the nets if caffe2_op_latency_histograms is set.
+ */
+class CAFFE2_API LatencyHistogramNetObserver final
+    : public OperatorAttachingNetObserver<
+          LatencyHistogramOperatorObserver,
+          LatencyHistogramNetObserver> {
+ public:
+  explicit LatencyHistogramNetObserver(NetBase* subject)
+      : OperatorAttachingNetObserver<
+            LatencyHistogramOperatorObserver,
+            LatencyHistogramNetObserver>(subject, this) {}
+
+  // The latencies of the operator types of the net, one per line
+  std::string debugInfo() override;
+
+ private:
+  void Start() override {}
+  void Stop() override {}
+};
+
+} // namespace caffe2
@@ -0,0 +1,126 @@
+#include "caffe2/core/common.h"
+#include "caffe2/core/net.h"
+#include "caffe2/core/operator.h"
+#include "latency_histogram_observer.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+namespace caffe2 {
+
+namespace {
+
+class LatencyTestSleepOp final : public OperatorBase {
+ public:
+  LatencyTestSleepOp(const OperatorDef& operator_def, Workspace* ws)
+      : OperatorBase(operator_def, ws),
+        ms_(GetSingleArgument<int>("ms", 1)) {}
+  bool Run(int /* unused */) override {
+    StartAllObservers();
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms_));
+    StopAllObservers();
+    return true;
+  }
+
+ private:
+  int ms_;
+};
+
+REGISTER_CPU_OPERATOR(LatencyTestSleepOp, LatencyTestSleepOp);
+
+OPERATOR_SCHEMA(LatencyTestSleepOp)
+    .NumInputs(0, INT_MAX)
+    .NumOutputs(0, INT_MAX);
+
+unique_ptr<NetBase> CreateNetTestHelper(Workspace* ws, const string& type) {
+  NetDef net_def;
+  net_def.set_name("latency_test_" + type);
+  net_def.set_type(type);
+  for (int ms : {1, 20}) {
+    auto& op = *(net_def.add_op());
+    op.set_type("LatencyTestSleepOp");
+    auto& arg = *op.add_arg();
+    arg.set_name("ms");
+    arg.set_i(ms);
+  }
+  return CreateNet(net_def, ws);
+}
+
+} // namespace
+
+TEST(LatencyHistogramTest, Buckets) {
+  for (int64_t v : {0, 1, 15, 16, 17, 31, 32, 1000, 123456789}) {
+    const int bucket = LatencyHistogram::BucketOf(v);
+    EXPECT_LT(bucket, LatencyHistogram::kNumBuckets);
+    EXPECT_NEAR(LatencyHistogram::BucketValue(bucket), v, v / 16.0 + 1);
+    EXPECT_LE(bucket, LatencyHistogram::BucketOf(v + 1));
+  }
+  EXPECT_EQ(
+      LatencyHistogram::BucketOf(int64_t(1) << 62),
+      LatencyHistogram::kNumBuckets - 1);
+}
+
+TEST(LatencyHistogramTest, Percentiles) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.PercentileMicros(0.5), 0);
+  for (int us = 1; us <= 1000; ++us) {
+    histogram.Record(us * 1000);
+  }
+  EXPECT_EQ(histogram.count(), 1000);
+  EXPECT_NEAR(histogram.MeanMicros(), 500.5, 1e-6);
+  EXPECT_EQ(histogram.MaxMicros(), 1000);
+  EXPECT_NEAR(histogram.PercentileMicros(0.5), 500, 500 / 16.0);
+  EXPECT_NEAR(histogram.PercentileMicros(0.99), 990, 990 / 16.0);
+  EXPECT_LE(histogram.PercentileMicros(1), 1000);
+
+  LatencyHistogram merged;
+  merged.MergeFrom(histogram);
+  merged.MergeFrom(histogram);
+  EXPECT_EQ(merged.count(), 2000);
+  EXPECT_EQ(merged.PercentileMicros(0.5), histogram.PercentileMicros(0.5));
+}
+
+TEST(LatencyHistogramTest, Threads) {
+  OpLatencyStats stats("net", "op");
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&stats, t]() {
+      for (int i = 0; i < 1000; ++i) {
+        stats.Record((t + 1) * 1000);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  LatencyHistogram histogram;
+  stats.MergeInto(&histogram);
+  EXPECT_EQ(histogram.count(), 4000);
+  EXPECT_EQ(histogram.MaxMicros(), 4);
+}
+
+TEST(LatencyHistogramNetObserverTest, OpTypes) {
+  for (const string type : {"simple", "async_scheduling"}) {
+    Workspace ws;
+    unique_ptr<NetBase> net(CreateNetTestHelper(&ws, type));
+    auto net_ob = std::make_unique<LatencyHistogramNetObserver>(net.get());
+    auto* ob = net_ob.get();
+    net->AttachObserver(std::move(net_ob));
+    for (int i = 0; i < 3; ++i) {
+      ASSERT_TRUE(net->Run());
+    }
+    const auto summaries = GetOpLatencySummaries(net->Name());
+    ASSERT_EQ(summaries.size(), 1);
+    EXPECT_EQ(summaries[0].op_type, "LatencyTestSleepOp");
+    EXPECT_EQ(summaries[0].count, 6);
+    EXPECT_GE(summaries[0].p50_us, 1000);
+    EXPECT_GE(summaries[0].max_us, 20000);
+    EXPECT_LE(summaries[0].p50_us, summaries[0].p99_us);
+    EXPECT_NE(
+        ob->debugInfo().find("LatencyTestSleepOp: count 6"),
+        string::npos);
+  }
+}
+
+} // namespace caffe2
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "caffe2/core/logging.h"
+
+namespace caffe2 {
+
+class HotRowCacheBase {
+ public:
+  virtual ~HotRowCacheBase() = default;
+};
+
+/**
+ * A cache of the most frequently looked up rows of an embedding table, copied
+ * into one contiguous block so that they stay in the CPU caches when the
+ * lookups follow a skewed (e.g. Zipfian) distribution over a large table.
+ *
+ * Split() counts a sample of the looked up rows and partitions the lookups of
+ * every segment between the cache and the table. Every refresh_interval calls,
+ * Refresh() admits the (at most capacity) rows with the highest counts which
+ * were seen at least kMinCount times, and halves all the counts so that rows
+ * that are no longer looked up age out.
+ *
+ * The cached rows are copies: the table must not be modified in place while
+ * the cache is in use, which is the case for inference but not for training.
+ */
+template <typename InputType, typename IndexType>
+class HotRowCache : public HotRowCacheBase {
+ public:
+  HotRowCache(int64_t capacity, int refresh_interval)
+      : capacity_(capacity), refresh_interval_(refresh_interval) {
+    CAFFE_ENFORCE_GT(capacity, 0);
+    CAFFE_ENFORCE_GT(refresh_interval, 0);
+  }
+
+  // Refills the cache if it is due or if the table is another one than the
+  // one it was filled from.
+  void Refresh(const InputType* data, int64_t num_rows, int64_t block_size) {
+    const bool same_table =
+        data == data_ && num_rows == num_rows_ && block_size == block_size_;
+    if (same_table && ++calls_ < refresh_interval_) {
+      return;
+    }
+    calls_ = 0;
+    data_ = data;
+    num_rows_ = num_rows;
+    block_size_ = block_size;
+
+    std::vector<std::pair<uint32_t, IndexType>> candidates;
+    for (const auto& count : counts_) {
+      if (count.second >= kMinCount && count.first < num_rows) {
+        candidates.emplace_back(count.second, count.first);
+      }
+    }
+    if (candidates.size() > static_cast<size_t>(capacity_)) {
+      std::nth_element(
+          candidates.begin(),
+          candidates.begin() + capacity_,
+          candidates.end(),
+          std::greater<std::pair<uint32_t, IndexType>>());
+      candidates.resize(capacity_);
+    }
+
+    VLOG(1) << "Hot row cache hit " << hits_ << " of " << lookups_
+            << " lookups, refilling it with " << candidates.size() << " of "
+            << counts_.size() << " counted rows";
+    slots_.clear();
+    slots_.reserve(candidates.size());
+    rows_.resize(candidates.size() * block_size);
+    for (size_t slot = 0; slot < candidates.size(); ++slot) {
+      const IndexType idx = candidates[slot].second;
+      slots_.emplace(idx, slot);
+      std::memcpy(
+          &rows_[slot * block_size],
+          data + idx * block_size,
+          block_size * sizeof(InputType));
+    }
+    Age();
+    hits_ = 0;
+    lookups_ = 0;
+  }
+
+  // Checks the indices and lengths like EmbeddingLookup does, and splits them
+  // (and the weights, if any) into the lookups of cached rows, whose indices
+  // are slots of rows(), and those of the other rows of the table.
+  void Split(
+      const IndexType* indices,
+      int64_t index_size,
+      const int* lengths,
+      int64_t output_size,
+      const float* weights) {
+    hot_indices_.clear();
+    cold_indices_.clear();
+    hot_weights_.clear();
+    cold_weights_.clear();
+    hot_lengths_.assign(output_size, 0);
+    cold_lengths_.assign(output_size, 0);
+
+    int64_t current = 0;
+    for (int64_t m = 0; m < output_size; ++m) {
+      for (int i = 0; i < lengths[m]; ++i) {
+        CAFFE_ENFORCE_LT(
+            current,
+            index_size,
+            "Your input seems to be incorrect: the sum of lengths values "
+            "should be the size of the indices tensor, but it appears not.");
+        const IndexType idx = indices[current];
+        CAFFE_ENFORCE(
+            0 <= idx && idx < num_rows_,
+            "Index ",
+            current,
+            " is out of bounds: ",
+            idx,
+            ", range 0 to ",
+            num_rows_);
+        if (current % kSampleStride == 0) {
+          ++counts_[idx];
+        }
+        auto it = slots_.find(idx);
+        if (it != slots_.end()) {
+          hot_indices_.push_back(it->second);
+          ++hot_lengths_[m];
+          if (weights) {
+            hot_weights_.push_back(weights[current]);
+          }
+        } else {
+          cold_indices_.push_back(idx);
+          ++cold_lengths_[m];
+          if (weights) {
+            cold_weights_.push_back(weights[current]);
+          }
+        }
+        ++current;
+      }
+    }
+    CAFFE_ENFORCE_EQ(
+        current,
+        index_size,
+        "Your input seems to be incorrect: the sum of lengths values should be "
+        "the size of the indices tensor, but it appears not.");
+    hits_ += hot_indices_.size();
+    lookups_ += index_size;
+    if (counts_.size() > static_cast<size_t>(kMaxCountedPerRow * capacity_)) {
+      Age();
+    }
+  }
+
+  // The cached rows, size() x block_size
+  const InputType* rows() const {
+    return rows_.data();
+  }
+  int64_t size() const {
+    return slots_.size();
+  }
+
+  const std::vector<IndexType>& hot_indices() const {
+    return hot_indices_;
+  }
+  const std::vector<int>& hot_lengths() const {
+    return hot_lengths_;
+  }
+  const std::vector<float>& hot_weights() const {
+    return hot_weights_;
+  }
+  const std::vector<IndexType>& cold_indices() const {
+    return cold_indices_;
+  }
+  const std::vector<int>& cold_lengths() const {
+    return cold_lengths_;
+  }
+  const std::vector<float>& cold_weights() const {
+    return cold_weights_;
+  }
+
+ private:
+  // Rows need to be counted at least kMinCount times to be admitted
+  static constexpr uint32_t kMinCount = 2;
+  // Every kSampleStride-th lookup is counted
+  static constexpr int64_t kSampleStride = 4;
+  // Bounds the number of counted rows to kMaxCountedPerRow * capacity
+  static constexpr int64_t kMaxCountedPerRow = 16;
+
+  void Age() {
+    for (auto it = counts_.begin(); it != counts_.end();) {
+      it->second /= 2;
+      it = it->second == 0 ? counts_.erase(it) : std::next(it);
+    }
+  }
+
+  const int64_t capacity_;
+  const int refresh_interval_;
+  int calls_ = 0;
+
+  const InputType* data_ = nullptr;
+  int64_t num_rows_ = 0;
+  int64_t block_size_ = 0;
+
+  std::unordered_map<IndexType, uint32_t> counts_;
+  std::unordered_map<IndexType, IndexType> slots_;
+  std::vector<InputType> rows_;
+  int64_t hits_ = 0;
+  int64_t lookups_ = 0;
+
+  std::vector<IndexType> hot_indices_;
+  std::vector<IndexType> cold_indices_;
+  std::vector<int> hot_lengths_;
+  std::vector<int> cold_lengths_;
+  std::vector<float> hot_weights_;
+  std::vector<float> cold_weights_;
+};
+
+template <typename InputType, typename IndexType>
+constexpr uint32_t HotRowCache<InputType, IndexType>::kMinCount;
+template <typename InputType, typename IndexType>
+constexpr int64_t HotRowCache<InputType, IndexType>::kSampleStride;
+template <typename InputType, typename IndexType>
+constexpr int64_t HotRowCache<InputType, IndexType>::kMaxCountedPerRow;
+
+} // namespace caffe2
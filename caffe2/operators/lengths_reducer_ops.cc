@@ -79,6 +79,15 @@ OPERATOR_SCHEMA(SparseLengthsSum)
         SparseLengthsSumOp::LENGTHS)
     .SetDoc(FormatDoc<SparseLengthsSumDef>())
     .Output(0, "OUTPUT", "Aggregated tensor")
+    .Arg(
+        "hot_row_cache_size",
+        "(int, default 0) Number of the most frequently looked up rows of "
+        "DATA to keep in a contiguous cache, 0 to disable the cache. DATA must "
+        "not be modified in place while the cache is used.")
+    .Arg(
+        "hot_row_cache_refresh_interval",
+        "(int, default 100) Number of runs between refills of the hot row "
+        "cache")
     .FillUsing(SparseLengthsSumDef::PopulateSchema)
     .InheritOnnxSchema();
 REGISTER_CPU_OPERATOR(
@@ -106,6 +115,15 @@ OPERATOR_SCHEMA(SparseLengthsWeightedSum)
         SparseLengthsWeightedSumOp::WEIGHT)
     .SetDoc(FormatDoc<SparseLengthsWeightedSumDef>())
     .Output(0, "OUTPUT", "Aggregated tensor")
+    .Arg(
+        "hot_row_cache_size",
+        "(int, default 0) Number of the most frequently looked up rows of "
+        "DATA to keep in a contiguous cache, 0 to disable the cache. DATA must "
+        "not be modified in place while the cache is used.")
+    .Arg(
+        "hot_row_cache_refresh_interval",
+        "(int, default 100) Number of runs between refills of the hot row "
+        "cache")
     .FillUsing(SparseLengthsWeightedSumDef::PopulateSchema)
     .InheritOnnxSchema();
 REGISTER_CPU_OPERATOR(
@@ -134,6 +152,15 @@ OPERATOR_SCHEMA(SparseLengthsMean)
         SparseLengthsMeanOp::LENGTHS)
     .SetDoc(FormatDoc<SparseLengthsMeanDef>())
     .Output(0, "OUTPUT", "Aggregated tensor")
+    .Arg(
+        "hot_row_cache_size",
+        "(int, default 0) Number of the most frequently looked up rows of "
+        "DATA to keep in a contiguous cache, 0 to disable the cache. DATA must "
+        "not be modified in place while the cache is used.")
+    .Arg(
+        "hot_row_cache_refresh_interval",
+        "(int, default 100) Number of runs between refills of the hot row "
+        "cache")
     .FillUsing(SparseLengthsMeanDef::PopulateSchema);
 REGISTER_CPU_OPERATOR(
     SparseLengthsMeanGradient,
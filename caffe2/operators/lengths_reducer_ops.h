@@ -1,7 +1,9 @@
 #pragma once
 #include "caffe2/core/context.h"
 #include "caffe2/core/operator.h"
+#include "caffe2/operators/hot_row_cache.h"
 #include "caffe2/perfkernels/embedding_lookup.h"
+#include "caffe2/utils/math.h"
 #ifdef USE_FBGEMM
 #include "fbgemm/Fbgemm.h"
 #endif
@@ -23,9 +25,17 @@ class CPUSparseLengthsReductionOp : public Operator<CPUContext> {
   USE_OPERATOR_FUNCTIONS(CPUContext);
   template <class... Args>
   explicit CPUSparseLengthsReductionOp(Args&&... args)
-      : Operator<CPUContext>(std::forward<Args>(args)...) {
+      : Operator<CPUContext>(std::forward<Args>(args)...),
+        hot_row_cache_size_(
+            this->template GetSingleArgument<int64_t>("hot_row_cache_size", 0)),
+        hot_row_cache_refresh_interval_(this->template GetSingleArgument<int>(
+            "hot_row_cache_refresh_interval",
+            100)) {
     static_assert(
         !(USE_WEIGHT & USE_MEAN), "Cannot both specify weight and mean.");
+    CAFFE_ENFORCE(
+        hot_row_cache_size_ == 0 || !USE_POSITIONAL_WEIGHT,
+        "hot_row_cache_size is not supported with positional weights");
   }
 
   ~CPUSparseLengthsReductionOp() {}
@@ -87,6 +97,19 @@ class CPUSparseLengthsReductionOp : public Operator<CPUContext> {
       in_weight = weightInput.template data<T>();
     }
 
+    if (hot_row_cache_size_ > 0) {
+      return RunWithHotRowCache(
+          D,
+          M,
+          indices_size,
+          N,
+          in_data,
+          indices,
+          lengths,
+          in_weight,
+          out_data);
+    }
+
 #ifdef USE_FBGEMM
     // If this is the first call or block size has changed (should never
     // happen actually), generate a kernel.
@@ -234,6 +257,72 @@ class CPUSparseLengthsReductionOp : public Operator<CPUContext> {
     return true;
   }
 
+  // Looks up the rows of the hot row cache and the other rows of the table
+  // separately, and sums the two.
+  template <typename InputType, typename IndexType>
+  bool RunWithHotRowCache(
+      const int64_t D,
+      const int64_t M,
+      const int64_t indices_size,
+      const int64_t N,
+      const InputType* in_data,
+      const IndexType* indices,
+      const int* lengths,
+      const T* in_weight,
+      T* out_data) {
+    using Cache = HotRowCache<InputType, IndexType>;
+    auto* cache = dynamic_cast<Cache*>(hot_row_cache_.get());
+    if (!cache) {
+      cache = new Cache(hot_row_cache_size_, hot_row_cache_refresh_interval_);
+      hot_row_cache_.reset(cache);
+    }
+    cache->Refresh(in_data, N, D);
+    cache->Split(indices, indices_size, lengths, M, in_weight);
+
+    EmbeddingLookup<IndexType, InputType, T>(
+        D,
+        M,
+        cache->cold_indices().size(),
+        N,
+        in_data,
+        cache->cold_indices().data(),
+        cache->cold_lengths().data(),
+        in_weight ? cache->cold_weights().data() : nullptr,
+        nullptr,
+        false,
+        out_data);
+    if (!cache->hot_indices().empty()) {
+      hot_rows_sum_.resize(M * D);
+      EmbeddingLookup<IndexType, InputType, T>(
+          D,
+          M,
+          cache->hot_indices().size(),
+          cache->size(),
+          cache->rows(),
+          cache->hot_indices().data(),
+          cache->hot_lengths().data(),
+          in_weight ? cache->hot_weights().data() : nullptr,
+          nullptr,
+          false,
+          hot_rows_sum_.data());
+      math::Add<T, CPUContext>(
+          M * D, out_data, hot_rows_sum_.data(), out_data, &context_);
+    }
+    if (USE_MEAN) {
+      for (int64_t m = 0; m < M; ++m) {
+        if (lengths[m] > 0) {
+          math::Scale<T, T, CPUContext>(
+              D,
+              1.f / lengths[m],
+              out_data + m * D,
+              out_data + m * D,
+              &context_);
+        }
+      }
+    }
+    return true;
+  }
+
   enum {
     DATA = 0, // Data input.
     WEIGHT = 1, // Weight input used in SparseLengthsWeightedSum
@@ -243,8 +332,13 @@ class CPUSparseLengthsReductionOp : public Operator<CPUContext> {
                               // 3 in SparseLengthsWeightedSum
   };
 
-#ifdef USE_FBGEMM
  private:
+  const int64_t hot_row_cache_size_;
+  const int hot_row_cache_refresh_interval_;
+  std::unique_ptr<HotRowCacheBase> hot_row_cache_;
+  std::vector<T> hot_rows_sum_;
+
+#ifdef USE_FBGEMM
   std::int64_t last_block_size{-1};
   fbgemm::EmbeddingSpMDMKernelSignature<float, std::int32_t>::Type
       kernel_fp32_i32_;
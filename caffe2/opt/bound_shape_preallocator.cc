@@ -0,0 +1,83 @@
+#include "caffe2/opt/bound_shape_preallocator.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include "caffe2/core/tensor.h"
+#include "caffe2/core/types.h"
+
+namespace caffe2 {
+
+size_t PreallocateBoundShapes(
+    Workspace* ws,
+    const NetDef& net,
+    const ShapeInfoMap& shape_hints,
+    const BoundShapeSpec& spec) {
+  CAFFE_ENFORCE(ws);
+  ShapeInfoMap shape_map = shape_hints;
+  for (const auto& name : ws->Blobs()) {
+    auto shape_info = getShapeInfoFromBlob(ws->GetBlob(name));
+    if (shape_info.dimTypeIsSet()) {
+      shape_map.emplace(name, shape_info);
+    }
+  }
+  auto eng = BoundShapeInferencerRegistry()->Create("C10", spec);
+  eng->InferBoundShapeAndType(net, shape_map, ws);
+  const auto& bound_shapes = eng->shape_info();
+
+  const std::unordered_set<std::string> external_inputs(
+      net.external_input().begin(), net.external_input().end());
+  size_t total_bytes = 0;
+  for (const auto& op : net.op()) {
+    const auto& device = op.has_device_option() ? op.device_option()
+                                                : net.device_option();
+    if (device.device_type() != PROTO_CPU) {
+      continue;
+    }
+    for (const auto& output : op.output()) {
+      if (external_inputs.count(output)) {
+        continue;
+      }
+      const auto it = bound_shapes.find(output);
+      if (it == bound_shapes.end() || it->second.is_quantized) {
+        continue;
+      }
+      const auto& shape = it->second.shape;
+      if (shape.unknown_shape() || shape.dims_size() == 0 ||
+          shape.data_type() == TensorProto_DataType_UNDEFINED) {
+        continue;
+      }
+      std::vector<int64_t> dims(shape.dims().begin(), shape.dims().end());
+      if (std::any_of(
+              dims.begin(), dims.end(), [](int64_t d) { return d <= 0; })) {
+        continue;
+      }
+      Blob* blob = ws->GetBlob(output);
+      if (blob && blob->GetRaw() && !BlobIsTensorType(*blob, CPU)) {
+        continue;
+      }
+      if (!blob) {
+        blob = ws->CreateBlob(output);
+      }
+
+      // Reserve the max batch of a tensor with an empty batch, which becomes
+      // of the max shape without giving up the reservation.
+      const auto max_batch = dims[0];
+      dims[0] = 0;
+      Tensor* tensor = BlobGetMutableTensor(
+          blob,
+          dims,
+          at::dtype(DataTypeToTypeMeta(shape.data_type())).device(CPU));
+      tensor->ReserveSpace(max_batch);
+      dims[0] = max_batch;
+      tensor->Resize(dims);
+      tensor->raw_mutable_data();
+      total_bytes += tensor->nbytes();
+    }
+  }
+  VLOG(1) << "Pre-allocated " << total_bytes << " bytes for the outputs of "
+          << net.name();
+  return total_bytes;
+}
+
+} // namespace caffe2
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "caffe2/core/workspace.h"
+#include "caffe2/opt/bound_shape_inferencer.h"
+#include "caffe2/opt/shape_info.h"
+#include "caffe2/proto/caffe2_pb.h"
+
+namespace caffe2 {
+
+/// Allocates the CPU tensors the ops of a net output with the bound shapes
+/// BoundShapeInferencer infers for them, so that the runs of the net on
+/// batches up to the bound resize these tensors without allocating memory.
+///
+/// shape_hints are the shapes of the inputs of the net, with the max batch
+/// size; the shapes of the blobs already in the workspace are added to them.
+/// The tensors are reserved (see TensorImpl::ReserveSpace), which keeps their
+/// memory when they shrink regardless of caffe2_keep_on_shrink. Outputs whose
+/// shape or type could not be inferred, quantized outputs, external inputs
+/// and blobs that already hold something else than a CPU tensor are skipped.
+///
+/// Returns the number of bytes pre-allocated.
+CAFFE2_API size_t PreallocateBoundShapes(
+    Workspace* ws,
+    const NetDef& net,
+    const ShapeInfoMap& shape_hints,
+    const BoundShapeSpec& spec);
+
+} // namespace caffe2
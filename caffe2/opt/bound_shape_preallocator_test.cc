@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include "caffe2/core/common.h"
+#include "caffe2/core/net.h"
+#include "caffe2/core/workspace.h"
+#include "caffe2/opt/bound_shape_preallocator.h"
+#include "caffe2/utils/math.h"
+#include "caffe2/utils/proto_utils.h"
+
+using namespace caffe2;
+namespace {
+
+void fillTensor(
+    Workspace* ws,
+    const std::string& name,
+    std::vector<int64_t> dims) {
+  auto* tensor = BlobGetMutableTensor(
+      ws->CreateBlob(name), dims, at::dtype<float>().device(CPU));
+  float* data = tensor->mutable_data<float>();
+  CPUContext context;
+  math::Set<float, CPUContext>(tensor->numel(), 0.5f, data, &context);
+}
+
+} // namespace
+
+TEST(BoundShapePreallocator, ResizesWithoutAllocating) {
+  NetDef net;
+  net.set_name("test");
+  net.add_op()->CopyFrom(
+      CreateOperatorDef("FC", "", {"X", "W", "B"}, {"Y"}, {}));
+  net.add_op()->CopyFrom(CreateOperatorDef("Relu", "", {"Y"}, {"Z"}, {}));
+  net.add_external_input("X");
+  net.add_external_input("W");
+  net.add_external_input("B");
+  net.add_external_output("Z");
+
+  Workspace ws;
+  fillTensor(&ws, "W", {64, 16});
+  fillTensor(&ws, "B", {64});
+  ShapeInfoMap shape_hints;
+  shape_hints.emplace(
+      "X",
+      constructShapeInfoWithDefaultDimType(
+          CreateTensorShape(std::vector<int>{32, 16}, TensorProto::FLOAT)));
+  const auto bytes =
+      PreallocateBoundShapes(&ws, net, shape_hints, BoundShapeSpec(32, 1));
+  EXPECT_EQ(bytes, 2 * 32 * 64 * sizeof(float));
+
+  const auto& y = ws.GetBlob("Y")->Get<Tensor>();
+  const auto& z = ws.GetBlob("Z")->Get<Tensor>();
+  EXPECT_EQ(y.sizes(), (std::vector<int64_t>{32, 64}));
+  const void* y_data = y.raw_data();
+  const void* z_data = z.raw_data();
+
+  auto* net_instance = ws.CreateNet(net);
+  ASSERT_TRUE(net_instance);
+  for (int64_t batch : {8, 32, 1, 17}) {
+    fillTensor(&ws, "X", {batch, 16});
+    ASSERT_TRUE(net_instance->Run());
+    const auto& out = ws.GetBlob("Z")->Get<Tensor>();
+    EXPECT_EQ(out.sizes(), (std::vector<int64_t>{batch, 64}));
+    EXPECT_FLOAT_EQ(out.data<float>()[0], 16 * 0.25f + 0.5f);
+    EXPECT_EQ(ws.GetBlob("Y")->Get<Tensor>().raw_data(), y_data);
+    EXPECT_EQ(out.raw_data(), z_data);
+  }
+}
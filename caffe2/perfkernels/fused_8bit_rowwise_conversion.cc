@@ -1,5 +1,6 @@
 #include "fused_8bit_rowwise_conversion.h"
 
+#include <ATen/Parallel.h>
 #include <c10/util/Half.h>
 #include <algorithm>
 #include <cmath>
@@ -8,6 +9,31 @@
 
 namespace caffe2 {
 
+namespace {
+
+// Converts the rows of a table in parallel, with chunks of rows of about
+// at::internal::GRAIN_SIZE elements.
+template <typename InType, typename OutType, typename F>
+void ConvertRowsInParallel(
+    const InType* input,
+    int input_rows,
+    int input_columns,
+    int output_columns,
+    OutType* output,
+    F convert_rows) {
+  const int64_t grain_rows = std::max<int64_t>(
+      1, at::internal::GRAIN_SIZE / std::max(input_columns, 1));
+  at::parallel_for(0, input_rows, grain_rows, [&](int64_t begin, int64_t end) {
+    convert_rows(
+        input + begin * input_columns,
+        end - begin,
+        input_columns,
+        output + begin * output_columns);
+  });
+}
+
+} // namespace
+
 void FloatToFused8BitRowwiseQuantized__base(
     const float* input,
     int input_rows,
@@ -58,13 +84,21 @@ void Fused8BitRowwiseQuantizedToFloat__base(
   }
 }
 
+decltype(FloatToFused8BitRowwiseQuantized__base)
+    FloatToFused8BitRowwiseQuantized__avx512;
 decltype(FloatToFused8BitRowwiseQuantized__base)
     FloatToFused8BitRowwiseQuantized__avx2_fma;
-void FloatToFused8BitRowwiseQuantized(
+static void FloatToFused8BitRowwiseQuantizedRows(
     const float* input,
     int input_rows,
     int input_columns,
     std::uint8_t* output) {
+  AVX512_DO(
+      FloatToFused8BitRowwiseQuantized,
+      input,
+      input_rows,
+      input_columns,
+      output);
   AVX2_FMA_DO(
       FloatToFused8BitRowwiseQuantized,
       input,
@@ -79,13 +113,35 @@ void FloatToFused8BitRowwiseQuantized(
       output);
 }
 
+void FloatToFused8BitRowwiseQuantized(
+    const float* input,
+    int input_rows,
+    int input_columns,
+    std::uint8_t* output) {
+  ConvertRowsInParallel(
+      input,
+      input_rows,
+      input_columns,
+      input_columns + 2 * sizeof(float),
+      output,
+      FloatToFused8BitRowwiseQuantizedRows);
+}
+
+decltype(Fused8BitRowwiseQuantizedToFloat__base)
+    Fused8BitRowwiseQuantizedToFloat__avx512;
 decltype(Fused8BitRowwiseQuantizedToFloat__base)
     Fused8BitRowwiseQuantizedToFloat__avx2_fma;
-void Fused8BitRowwiseQuantizedToFloat(
+static void Fused8BitRowwiseQuantizedToFloatRows(
     const std::uint8_t* input,
     int input_rows,
     int input_columns,
     float* output) {
+  AVX512_DO(
+      Fused8BitRowwiseQuantizedToFloat,
+      input,
+      input_rows,
+      input_columns,
+      output);
   AVX2_FMA_DO(
       Fused8BitRowwiseQuantizedToFloat,
       input,
@@ -100,6 +156,20 @@ void Fused8BitRowwiseQuantizedToFloat(
       output);
 }
 
+void Fused8BitRowwiseQuantizedToFloat(
+    const std::uint8_t* input,
+    int input_rows,
+    int input_columns,
+    float* output) {
+  ConvertRowsInParallel(
+      input,
+      input_rows,
+      input_columns,
+      input_columns - 2 * sizeof(float),
+      output,
+      Fused8BitRowwiseQuantizedToFloatRows);
+}
+
 void FloatToFused8BitRowwiseQuantizedSBHalf__base(
     const float* input,
     int input_rows,
@@ -158,7 +228,7 @@ void Fused8BitRowwiseQuantizedSBHalfToFloat__base(
 
 decltype(FloatToFused8BitRowwiseQuantizedSBHalf__base)
     FloatToFused8BitRowwiseQuantizedSBHalf__avx2_fma;
-void FloatToFused8BitRowwiseQuantizedSBHalf(
+static void FloatToFused8BitRowwiseQuantizedSBHalfRows(
     const float* input,
     int input_rows,
     int input_columns,
@@ -172,9 +242,23 @@ void FloatToFused8BitRowwiseQuantizedSBHalf(
       output);
 }
 
+void FloatToFused8BitRowwiseQuantizedSBHalf(
+    const float* input,
+    int input_rows,
+    int input_columns,
+    std::uint8_t* output) {
+  ConvertRowsInParallel(
+      input,
+      input_rows,
+      input_columns,
+      input_columns + 2 * sizeof(at::Half),
+      output,
+      FloatToFused8BitRowwiseQuantizedSBHalfRows);
+}
+
 decltype(Fused8BitRowwiseQuantizedSBHalfToFloat__base)
     Fused8BitRowwiseQuantizedSBHalfToFloat__avx2_fma;
-void Fused8BitRowwiseQuantizedSBHalfToFloat(
+static void Fused8BitRowwiseQuantizedSBHalfToFloatRows(
     const std::uint8_t* input,
     int input_rows,
     int input_columns,
@@ -188,4 +272,18 @@ void Fused8BitRowwiseQuantizedSBHalfToFloat(
       output);
 }
 
+void Fused8BitRowwiseQuantizedSBHalfToFloat(
+    const std::uint8_t* input,
+    int input_rows,
+    int input_columns,
+    float* output) {
+  ConvertRowsInParallel(
+      input,
+      input_rows,
+      input_columns,
+      input_columns - 2 * sizeof(at::Half),
+      output,
+      Fused8BitRowwiseQuantizedSBHalfToFloatRows);
+}
+
 } // namespace caffe2
@@ -4,6 +4,9 @@
 
 namespace caffe2 {
 
+// The conversions of tables with many rows run on the intra-op thread pool
+// (at::parallel_for), in chunks of rows.
+
 void FloatToFused8BitRowwiseQuantized(
     const float* input,
     int input_rows,
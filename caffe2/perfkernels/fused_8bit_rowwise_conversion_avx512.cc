@@ -0,0 +1,102 @@
+#include "fused_8bit_rowwise_conversion.h"
+
+#include <immintrin.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace caffe2 {
+
+constexpr int VLEN = 16;
+
+void FloatToFused8BitRowwiseQuantized__avx512(
+    const float* input,
+    int input_rows,
+    int input_columns,
+    std::uint8_t* output) {
+  constexpr float kEpsilon = 1e-8f;
+
+  int output_columns = input_columns + 2 * sizeof(float);
+  for (std::size_t row = 0; row < input_rows; ++row) {
+    const float* input_row = input + row * input_columns;
+    std::uint8_t* output_row = output + row * output_columns;
+    float* output_row_scale_bias =
+        reinterpret_cast<float*>(output_row + input_columns);
+
+    float minimum_element = FLT_MAX;
+    float maximum_element = -FLT_MAX;
+    __m512 min_v = _mm512_set1_ps(minimum_element);
+    __m512 max_v = _mm512_set1_ps(maximum_element);
+    std::size_t col;
+    for (col = 0; col < input_columns / VLEN * VLEN; col += VLEN) {
+      __m512 in_v = _mm512_loadu_ps(input_row + col);
+      min_v = _mm512_min_ps(min_v, in_v);
+      max_v = _mm512_max_ps(max_v, in_v);
+    }
+    minimum_element = std::min(minimum_element, _mm512_reduce_min_ps(min_v));
+    maximum_element = std::max(maximum_element, _mm512_reduce_max_ps(max_v));
+    for (; col < input_columns; ++col) {
+      minimum_element = std::min(minimum_element, input_row[col]);
+      maximum_element = std::max(maximum_element, input_row[col]);
+    }
+
+    float range = maximum_element - minimum_element;
+
+    output_row_scale_bias[0] = range / 255.0f;
+    output_row_scale_bias[1] = minimum_element;
+    const auto inverse_scale = 255.0f / (range + kEpsilon);
+    min_v = _mm512_set1_ps(minimum_element);
+    __m512 inverse_scale_v = _mm512_set1_ps(inverse_scale);
+    __m512i zero_v = _mm512_setzero_si512();
+
+    for (col = 0; col < input_columns / VLEN * VLEN; col += VLEN) {
+      __m512i rounded_v = _mm512_cvtps_epi32(_mm512_mul_ps(
+          _mm512_sub_ps(_mm512_loadu_ps(input_row + col), min_v),
+          inverse_scale_v));
+      // Clamps to [0, 255] like the signed and unsigned saturating packs of
+      // the AVX2 version do
+      rounded_v = _mm512_max_epi32(rounded_v, zero_v);
+      _mm_storeu_si128(
+          reinterpret_cast<__m128i*>(output_row + col),
+          _mm512_cvtusepi32_epi8(rounded_v));
+    }
+    for (; col < input_columns; ++col) {
+      output_row[col] =
+          std::lrintf((input_row[col] - minimum_element) * inverse_scale);
+    }
+  }
+}
+
+void Fused8BitRowwiseQuantizedToFloat__avx512(
+    const std::uint8_t* input,
+    int input_rows,
+    int input_columns,
+    float* output) {
+  int output_columns = input_columns - 2 * sizeof(float);
+
+  for (std::size_t row = 0; row < input_rows; ++row) {
+    const std::uint8_t* input_row = input + row * input_columns;
+    const float* input_row_scale_bias =
+        reinterpret_cast<const float*>(input_row + output_columns);
+    float* output_row = output + row * output_columns;
+
+    __m512 scale_v = _mm512_set1_ps(input_row_scale_bias[0]);
+    __m512 bias_v = _mm512_set1_ps(input_row_scale_bias[1]);
+
+    std::size_t col;
+    for (col = 0; col < output_columns / VLEN * VLEN; col += VLEN) {
+      __m512 in_v = _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(input_row + col))));
+      _mm512_storeu_ps(
+          output_row + col,
+          _mm512_add_ps(_mm512_mul_ps(in_v, scale_v), bias_v));
+    }
+
+    for (; col < output_columns; ++col) {
+      output_row[col] =
+          input_row[col] * input_row_scale_bias[0] + input_row_scale_bias[1];
+    }
+  }
+}
+
+} // namespace caffe2
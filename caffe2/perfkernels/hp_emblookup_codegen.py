@@ -6,31 +6,65 @@ import sys
 
 sizeof = {"float": 4, "at::Half": 2, "uint8_t": 1}
 
+# vector type, intrinsics prefix, number of floats per vector, suffix of the
+# generated functions, prefetch distance in indices, loads of a vector worth
+# of fp16 and uint8 elements, and the isa of the generic code for the leftover
+# of less than a vector
+isa_info = {
+    "avx2": {
+        "vec": "__m256",
+        "mm": "_mm256",
+        "width": 8,
+        "suffix": "__avx2_fma",
+        "prefdist": 16,
+        "half_load": "_mm_loadu_si128(reinterpret_cast<const __m128i*>",
+        "uint8_load": "_mm_loadl_epi64(reinterpret_cast<const __m128i*>",
+        "remainder": None,
+    },
+    "avx512": {
+        "vec": "__m512",
+        "mm": "_mm512",
+        "width": 16,
+        "suffix": "__avx512",
+        "prefdist": 16,
+        "half_load": "_mm256_loadu_si256(reinterpret_cast<const __m256i*>",
+        "uint8_load": "_mm_loadu_si128(reinterpret_cast<const __m128i*>",
+        "remainder": "avx2",
+    },
+}
+
 
 def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
+    mm = isa_info[isa]["mm"]
+    vec = isa_info[isa]["vec"]
+    width = isa_info[isa]["width"]
+
     def compute(regid, InType, use_weights, isa, prefetch):
         code = []
+        info = isa_info[isa]
 
         if InType == "float":
             code.append(
-                "        vop%d = _mm256_fmadd_ps(vwgt, _mm256_loadu_ps(ip + (%d)), vop%d);"  # noqa
-                % (regid, regid, regid)
+                "        vop%d = %s_fmadd_ps(vwgt, %s_loadu_ps(ip + (%d)), vop%d);"  # noqa
+                % (regid, mm, mm, regid, regid)
             )
         elif InType == "at::Half":
             code.append(
-                "        vop%d = _mm256_fmadd_ps(\n"
+                "        vop%d = %s_fmadd_ps(\n"
                 "            vwgt,\n"
-                "            _mm256_cvtph_ps(\n"
-                "                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (%d)))),\n"  # noqa
-                "            vop%d);" % (regid, regid, regid)
+                "            %s_cvtph_ps(\n"
+                "                %s(ip + (%d)))),\n"  # noqa
+                "            vop%d);"
+                % (regid, mm, mm, info["half_load"], regid, regid)
             )
         elif InType == "uint8_t":
             code.append(
-                "        vop%d = _mm256_fmadd_ps(\n"
+                "        vop%d = %s_fmadd_ps(\n"
                 "            vwgt,\n"
-                "            _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(\n"
-                "                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(ip + (%d))))),\n"  # noqa
-                "            _mm256_add_ps(vop%d, vbio));" % (regid, regid, regid)
+                "            %s_cvtepi32_ps(%s_cvtepu8_epi32(\n"
+                "                %s(ip + (%d))))),\n"  # noqa
+                "            %s_add_ps(vop%d, vbio));"
+                % (regid, mm, mm, mm, info["uint8_load"], regid, mm, regid)
             )
         else:
             assert False
@@ -66,8 +100,8 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
 
     code.append("      " + OutType + "* op = &out[rangeIndex * block_size];")
     for i in range(0, uf):
-        j = 8 * i
-        code.append("      __m256 vop" + str(j) + " = _mm256_setzero_ps();")
+        j = width * i
+        code.append("      " + vec + " vop" + str(j) + " = " + mm + "_setzero_ps();")
 
     # inner loop
     if use_offsets:
@@ -120,7 +154,7 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
         else:
             code.append("        bio = wgt * scale_bias[2 * idx + 1];")
             code.append("        wgt = wgt * scale_bias[2 * idx];")
-        code.append("        __m256 vbio = _mm256_set1_ps(bio);")
+        code.append("        " + vec + " vbio = " + mm + "_set1_ps(bio);")
     else:
         code.append("        " + OutType + " wgt = 1.f;")
         code.append("        if (weights) {")
@@ -128,7 +162,7 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
             "          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];"  # noqa
         )
         code.append("        }")
-    code.append("        __m256 vwgt = _mm256_set1_ps(wgt);")
+    code.append("        " + vec + " vwgt = " + mm + "_set1_ps(wgt);")
 
     code.append("        const {}* ip = &input[idx * fused_block_size];".format(InType))
     code.append(
@@ -150,7 +184,7 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
     )
 
     for i in range(0, uf):
-        j = 8 * i
+        j = width * i
         cachelinesize = 64
         byteoffset = sizeof[InType] * j
         prefetch = (byteoffset % cachelinesize) == 0
@@ -162,20 +196,22 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
     else:
         code.append("      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {")
     for i in range(0, uf):
-        j = 8 * i
-        code.append("        _mm256_storeu_ps(&op[" + str(j) + "], vop" + str(j) + ");")
+        j = width * i
+        code.append("        " + mm + "_storeu_ps(&op[" + str(j) + "], vop" + str(j) + ");")
     code.append("      } else {")
     # inv of length
     if use_offsets:
-        code.append("        __m256 vlen_inv = _mm256_set1_ps(1.0f / length);")
+        code.append("        " + vec + " vlen_inv = " + mm + "_set1_ps(1.0f / length);")
     else:
-        code.append("        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);")
+        code.append(
+            "        " + vec + " vlen_inv = " + mm + "_set1_ps(1.0f / lengths[rangeIndex]);"
+        )
     for i in range(0, uf):
-        j = 8 * i
+        j = width * i
         code.append(
-            "        _mm256_storeu_ps(&op["
+            "        " + mm + "_storeu_ps(&op["
             + str(j)
-            + "], _mm256_mul_ps("
+            + "], " + mm + "_mul_ps("
             + "vop"
             + str(j)
             + ", vlen_inv));"
@@ -187,34 +223,49 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
 
 
 def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
-    def compute(InType, use_weights, isa):
+    mm = isa_info[isa]["mm"]
+    vec = isa_info[isa]["vec"]
+    width = isa_info[isa]["width"]
+    remainder = isa_info[isa]["remainder"]
+
+    # vsuffix is the suffix of the names of the vwgt and vbio vectors
+    def compute(InType, use_weights, isa, vsuffix=""):
         code = []
+        info = isa_info[isa]
+        mm = info["mm"]
+        vwgt = "vwgt" + vsuffix
+        vbio = "vbio" + vsuffix
         if InType == "float":
             code.append(
-                "          _mm256_storeu_ps(\n"
+                "          %s_storeu_ps(\n"
                 "              &op[j],\n"
-                "              _mm256_fmadd_ps(\n"
-                "                  vwgt, _mm256_loadu_ps(&ip[j]), _mm256_loadu_ps(&op[j])));"  # noqa
+                "              %s_fmadd_ps(\n"
+                "                  %s, %s_loadu_ps(&ip[j]), %s_loadu_ps(&op[j])));"  # noqa
+                % (mm, mm, vwgt, mm, mm)
             )
         elif InType == "at::Half":
+            half_load, half_ptr = info["half_load"].split("(", 1)
             code.append(
-                "          _mm256_storeu_ps(\n"
+                "          %s_storeu_ps(\n"
                 "              &op[j],\n"
-                "              _mm256_fmadd_ps(\n"
-                "                  vwgt,\n"
-                "                  _mm256_cvtph_ps(_mm_loadu_si128(\n"
-                "                      reinterpret_cast<const __m128i*>(&ip[j]))),\n"
-                "                  _mm256_loadu_ps(&op[j])));"
+                "              %s_fmadd_ps(\n"
+                "                  %s,\n"
+                "                  %s_cvtph_ps(%s(\n"
+                "                      %s(&ip[j]))),\n"
+                "                  %s_loadu_ps(&op[j])));"
+                % (mm, mm, vwgt, mm, half_load, half_ptr, mm)
             )
         elif InType == "uint8_t":
+            uint8_load, uint8_ptr = info["uint8_load"].split("(", 1)
             code.append(
-                "          _mm256_storeu_ps(\n"
+                "          %s_storeu_ps(\n"
                 "              &op[j],\n"
-                "              _mm256_fmadd_ps(\n"
-                "                  vwgt,\n"
-                "                  _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(\n"  # noqa
-                "                      reinterpret_cast<const __m128i*>(&ip[j])))),\n"
-                "                  _mm256_add_ps(_mm256_loadu_ps(&op[j]), vbio)));"
+                "              %s_fmadd_ps(\n"
+                "                  %s,\n"
+                "                  %s_cvtepi32_ps(%s_cvtepu8_epi32(%s(\n"  # noqa
+                "                      %s(&ip[j])))),\n"
+                "                  %s_add_ps(%s_loadu_ps(&op[j]), %s)));"
+                % (mm, mm, vwgt, mm, mm, uint8_load, uint8_ptr, mm, mm, vbio)
             )
         else:
             assert False
@@ -249,9 +300,19 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
 
     # initialize to 0
     code.append("      int64_t j = 0;")
-    code.append("      for (; j + 8 <= block_size; j += 8) {")
-    code.append("        _mm256_storeu_ps(op + j, _mm256_setzero_ps());")
+    code.append(
+        "      for (; j + {} <= block_size; j += {}) {{".format(width, width)
+    )
+    code.append("        " + mm + "_storeu_ps(op + j, " + mm + "_setzero_ps());")
     code.append("      }")
+    if remainder:
+        rmm = isa_info[remainder]["mm"]
+        rwidth = isa_info[remainder]["width"]
+        code.append(
+            "      for (; j + {} <= block_size; j += {}) {{".format(rwidth, rwidth)
+        )
+        code.append("        " + rmm + "_storeu_ps(op + j, " + rmm + "_setzero_ps());")
+        code.append("      }")
     code.append("      for (; j < block_size; j++) {")
     code.append("        op[j] = 0.0f;")
     code.append("      }")
@@ -307,7 +368,7 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
         else:
             code.append("        bio = wgt * scale_bias[2 * idx + 1];")
             code.append("        wgt = wgt * scale_bias[2 * idx];")
-        code.append("        __m256 vbio = _mm256_set1_ps(bio);")
+        code.append("        " + vec + " vbio = " + mm + "_set1_ps(bio);")
     else:
         code.append("        " + OutType + " wgt = 1.f;")
         code.append("        if (weights) {")
@@ -315,7 +376,7 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
             "          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];"  # noqa
         )
         code.append("        }")
-    code.append("        __m256 vwgt = _mm256_set1_ps(wgt);")
+    code.append("        " + vec + " vwgt = " + mm + "_set1_ps(wgt);")
 
     code.append("        const {}* ip = &input[idx * fused_block_size];".format(InType))
     code.append(
@@ -337,9 +398,26 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
 
     # compute and store main loop
     code.append("        j = 0;")
-    code.append("        for (; j + 8 <= block_size; j += 8) {")
+    code.append(
+        "        for (; j + {} <= block_size; j += {}) {{".format(width, width)
+    )
     code.extend(compute(InType, use_weights, isa))
     code.append("        }")
+    if remainder:
+        rvec = isa_info[remainder]["vec"]
+        cast = mm + "_castps" + vec[3:] + "_ps" + rvec[3:]
+        code.append(
+            "        {} vwgt_rem = {}(vwgt);".format(rvec, cast)
+        )
+        if InType == "uint8_t":
+            code.append(
+                "        {} vbio_rem = {}(vbio);".format(rvec, cast)
+            )
+        code.append(
+            "        for (; j + {} <= block_size; j += {}) {{".format(rwidth, rwidth)
+        )
+        code.extend(compute(InType, use_weights, remainder, "_rem"))
+        code.append("        }")
     # leftover
     code.append("        for (; j < block_size; j++) {")
     if InType == "float":
@@ -366,14 +444,30 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
     else:
         code.append("      if (normalize_by_lengths && lengths[rangeIndex]) {")
         code.append("        float len_inv = 1.0f / lengths[rangeIndex];")
-    code.append("        __m256 vlen_inv = _mm256_set1_ps(len_inv);")
+    code.append("        " + vec + " vlen_inv = " + mm + "_set1_ps(len_inv);")
     code.append("        j = 0;")
-    code.append("        for (; j + 8 <= block_size; j += 8) {")
     code.append(
-        "          _mm256_storeu_ps(\n"
-        "              &op[j], _mm256_mul_ps(_mm256_loadu_ps(&op[j]), vlen_inv));"
+        "        for (; j + {} <= block_size; j += {}) {{".format(width, width)
+    )
+    code.append(
+        "          {}_storeu_ps(\n"
+        "              &op[j], {}_mul_ps({}_loadu_ps(&op[j]), vlen_inv));".format(
+            mm, mm, mm
+        )
     )
     code.append("        }")
+    if remainder:
+        code.append(
+            "        for (; j + {} <= block_size; j += {}) {{".format(rwidth, rwidth)
+        )
+        code.append(
+            "          {}_storeu_ps(\n"
+            "              &op[j],\n"
+            "              {}_mul_ps({}_loadu_ps(&op[j]), {}_set1_ps(len_inv)));".format(
+                rmm, rmm, rmm, rmm
+            )
+        )
+        code.append("        }")
     code.append("        for (; j < block_size; j++) {")
     code.append("          op[j] = len_inv * op[j];")
     code.append("        }")
@@ -389,19 +483,20 @@ parser = argparse.ArgumentParser()
 parser.add_argument("-f", "--filename", help="file name")
 parser.add_argument("--fused", action="store_true")
 parser.add_argument("--use-offsets", action="store_true")
+parser.add_argument("--isa", choices=sorted(isa_info.keys()), default="avx2")
 opts = parser.parse_args()
 if opts.filename:
     filename = opts.filename
 elif opts.fused:
     if opts.use_offsets:
-        filename = "embedding_lookup_fused_8bit_rowwise_idx_avx2.cc"
+        filename = "embedding_lookup_fused_8bit_rowwise_idx_{}.cc".format(opts.isa)
     else:
-        filename = "embedding_lookup_fused_8bit_rowwise_avx2.cc"
+        filename = "embedding_lookup_fused_8bit_rowwise_{}.cc".format(opts.isa)
 else:
     if opts.use_offsets:
-        filename = "embedding_lookup_idx_avx2.cc"
+        filename = "embedding_lookup_idx_{}.cc".format(opts.isa)
     else:
-        filename = "embedding_lookup_avx2.cc"
+        filename = "embedding_lookup_{}.cc".format(opts.isa)
 
 options = [
     ["int32_t", "int", "float", "float", "float", "float"],
@@ -438,7 +533,7 @@ for o in options:
         fn_base = "{}EmbeddingLookup_{}_{}_{}".format(
             prefix, IndexTypeName, InTypeName, OutTypeName
         )
-    suffix = "__avx2_fma"
+    suffix = isa_info[opts.isa]["suffix"]
     fn = "static bool " + fn_base + suffix
     code.append(fn + "(")
 
@@ -460,7 +555,9 @@ for o in options:
     args.append("    " + OutType + "* out) {")
     code += args
 
-    code.append("  const " + IndexType + " prefdist_T0 = 16;")
+    code.append(
+        "  const {} prefdist_T0 = {};".format(IndexType, isa_info[opts.isa]["prefdist"])
+    )
     # block_size is the number of elements and fused_block_size is the size of
     # an entire row, including scale and bias.
     offset = (8 // sizeof[InType]) if opts.fused else 0
@@ -474,17 +571,27 @@ for o in options:
 
     # code.append("printf(\"calling " + fn + "\\n\");");
 
-    code.append("  if (block_size == 128) {")
-    code += unroll(16, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
-    code.append("  } else if (block_size == 64) {")
-    code += unroll(8, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
-    code.append("  } else if (block_size == 32) {")
-    code += unroll(4, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
-    code.append("  } else if (block_size == 16) {")
-    code += unroll(2, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
+    width = isa_info[opts.isa]["width"]
+    for i, block_size in enumerate([128, 64, 32, 16]):
+        if block_size < width:
+            break
+        code.append(
+            ("  if" if i == 0 else "  } else if")
+            + " (block_size == {}) {{".format(block_size)
+        )
+        code += unroll(
+            block_size // width,
+            IndexType,
+            InType,
+            OutType,
+            True,
+            opts.isa,
+            opts.fused,
+            opts.use_offsets,
+        )
     code.append("  } else {")
     code.append("    // generic code")
-    code += generic(IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
+    code += generic(IndexType, InType, OutType, True, opts.isa, opts.fused, opts.use_offsets)
     code.append("  }")
     code.append("  return dataInd == index_size;")
 
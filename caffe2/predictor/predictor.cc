@@ -1,6 +1,8 @@
 #include "caffe2/predictor/predictor.h"
+#include <set>
 #include <unordered_set>
 #include "caffe2/core/init.h"
+#include "caffe2/core/memonger.h"
 
 namespace caffe2 {
 
@@ -25,6 +27,25 @@ const Tensor& getTensor(Workspace* ws, const std::string& name) {
   return *BlobGetMutableTensor(getBlob(ws, name), CPU);
 }
 
+// Lets the intermediate blobs of the net whose lifetimes don't overlap share
+// a blob, so that a predictor keeps fewer buffers alive between runs. Blobs
+// which are initialized, inputs or outputs are never shared.
+void shareIntermediateBlobs(PredictorConfig& config) {
+  if (ArgumentHelper::HasArgument(*config.predict_net, "disable_memonger")) {
+    return;
+  }
+  const auto& initialized = config.ws->Blobs();
+  std::set<std::string> static_blobs{initialized.begin(), initialized.end()};
+  const auto& net = *config.predict_net;
+  static_blobs.insert(net.external_input().begin(), net.external_input().end());
+  static_blobs.insert(
+      net.external_output().begin(), net.external_output().end());
+  static_blobs.insert(config.input_names.begin(), config.input_names.end());
+  static_blobs.insert(config.output_names.begin(), config.output_names.end());
+  config.predict_net = std::make_shared<NetDef>(
+      memonger::optimize_inference_net(net, static_blobs));
+}
+
 } // namespace
 
 Predictor::Predictor(
@@ -41,6 +62,7 @@ Predictor::Predictor(
           optimization)) {}
 
 Predictor::Predictor(PredictorConfig config) : config_(std::move(config)) {
+  shareIntermediateBlobs(config_);
   const auto& initialized_vec = config_.ws->Blobs();
   const std::unordered_set<std::string> initialized{initialized_vec.begin(),
                                                     initialized_vec.end()};
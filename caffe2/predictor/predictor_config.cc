@@ -1,6 +1,9 @@
 #include "predictor_config.h"
 
 #include <atomic>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
 
 #include "caffe2/core/init.h"
 #include "caffe2/utils/proto_utils.h"
@@ -8,10 +11,102 @@
 #include "caffe2/opt/optimizer.h"
 #endif
 
+C10_DEFINE_bool(
+    caffe2_predictor_share_identical_parameters,
+    false,
+    "If set, the parameter tensors initialized for predictors share their "
+    "memory with identical tensors (same type, shape and content) of the other "
+    "predictors in the process. The parameters must not be modified.");
+
 namespace caffe2 {
 
 namespace {
 
+// Parameters smaller than this are not worth hashing
+constexpr size_t kMinSharedParameterBytes = 4096;
+
+uint64_t hashTensorData(const Tensor& tensor) {
+  const char* data = static_cast<const char*>(tensor.raw_data());
+  const size_t nbytes = tensor.nbytes();
+  uint64_t hash = nbytes;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= nbytes; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(uint64_t));
+    hash = (hash ^ word) * 0x9E3779B97F4A7C15ULL;
+    hash ^= hash >> 32;
+  }
+  for (; i < nbytes; ++i) {
+    hash = (hash ^ static_cast<unsigned char>(data[i])) * 0x9E3779B97F4A7C15ULL;
+  }
+  return hash;
+}
+
+bool isSameTensor(const Tensor& lhs, const Tensor& rhs) {
+  return lhs.dtype() == rhs.dtype() && lhs.sizes() == rhs.sizes() &&
+      std::memcmp(lhs.raw_data(), rhs.raw_data(), lhs.nbytes()) == 0;
+}
+
+// The parameters of all the predictors in the process, by content hash. Only
+// weak references are kept, so that the parameters go away with the last
+// predictor using them.
+struct SharedParameters {
+  std::mutex mutex;
+  std::unordered_multimap<
+      uint64_t,
+      c10::weak_intrusive_ptr<TensorImpl, UndefinedTensorImpl>>
+      tensors;
+};
+
+SharedParameters& sharedParameters() {
+  static SharedParameters* shared = new SharedParameters();
+  return *shared;
+}
+
+// Replaces the tensors of ws which are identical to the ones of an earlier
+// predictor with those, and registers the others.
+void shareIdenticalParameters(Workspace* ws) {
+  auto& shared = sharedParameters();
+  std::lock_guard<std::mutex> guard(shared.mutex);
+  for (auto it = shared.tensors.begin(); it != shared.tensors.end();) {
+    it = it->second.expired() ? shared.tensors.erase(it) : std::next(it);
+  }
+
+  for (const auto& name : ws->LocalBlobs()) {
+    auto* blob = ws->GetBlob(name);
+    if (!BlobIsTensorType(*blob, CPU)) {
+      continue;
+    }
+    const auto& tensor = blob->Get<Tensor>();
+    // only plain data can be compared bytewise
+    if (tensor.nbytes() < kMinSharedParameterBytes ||
+        tensor.dtype().placementNew() != nullptr) {
+      continue;
+    }
+    const auto hash = hashTensorData(tensor);
+    bool found = false;
+    auto range = shared.tensors.equal_range(hash);
+    for (auto it = range.first; it != range.second && !found; ++it) {
+      Tensor other(it->second.lock());
+      if (!other) {
+        continue;
+      }
+      if (other.is_same(tensor)) {
+        found = true;
+      } else if (isSameTensor(other, tensor)) {
+        BlobSetTensor(blob, std::move(other));
+        found = true;
+      }
+    }
+    if (!found) {
+      shared.tensors.emplace(
+          hash,
+          c10::weak_intrusive_ptr<TensorImpl, UndefinedTensorImpl>(
+              tensor.getIntrusivePtr()));
+    }
+  }
+}
+
 // We don't use the getNet() from predictor_utils.cc here because that file
 // has additional dependencies that we want to avoid bringing in, to keep the
 // binary size as small as possible.
@@ -70,6 +165,9 @@ PredictorConfig makePredictorConfig(
   config.predict_net = std::make_shared<NetDef>(run_net);
   if (run_init) {
     CAFFE_ENFORCE(ws.RunNetOnce(init_net));
+    if (FLAGS_caffe2_predictor_share_identical_parameters) {
+      shareIdenticalParameters(&ws);
+    }
   }
 #ifdef C10_MOBILE
   GlobalInit();
@@ -6,6 +6,8 @@
 
 #include <gtest/gtest.h>
 
+C10_DECLARE_bool(caffe2_predictor_share_identical_parameters);
+
 namespace caffe2 {
 
 namespace {
@@ -205,4 +207,103 @@ TEST_F(PredictorTest, SimpleBatchSizedMapInput) {
   EXPECT_NEAR(output.front().data<float>()[4], 0.1209, 1E-4);
 }
 
+TEST(PredictorParametersTest, SharesIdenticalParameters) {
+  const char* paramsSpec = R"DOC(
+        name: "init"
+        op {
+          type: "ConstantFill"
+          output: "W"
+          arg {
+            name: "shape"
+            ints: 1024
+            ints: 4
+          }
+          arg {
+            name: "value"
+            f: 2.0
+          }
+        }
+        op {
+          type: "ConstantFill"
+          output: "b"
+          arg {
+            name: "shape"
+            ints: 1024
+            ints: 4
+          }
+          arg {
+            name: "value"
+            f: 3.0
+          }
+        }
+)DOC";
+  auto getData = [](const PredictorConfig& config, const std::string& name) {
+    return config.ws->GetBlob(name)->Get<Tensor>().raw_data();
+  };
+  auto init = parseNetDef(paramsSpec);
+  auto config1 = makePredictorConfig(init, NetDef(), nullptr, true, 0);
+  FLAGS_caffe2_predictor_share_identical_parameters = true;
+  auto config2 = makePredictorConfig(init, NetDef(), nullptr, true, 0);
+  auto config3 = makePredictorConfig(init, NetDef(), nullptr, true, 0);
+  init.mutable_op(1)->mutable_arg(1)->set_f(4.0);
+  auto config4 = makePredictorConfig(init, NetDef(), nullptr, true, 0);
+  FLAGS_caffe2_predictor_share_identical_parameters = false;
+
+  EXPECT_NE(getData(config1, "W"), getData(config2, "W"));
+  EXPECT_EQ(getData(config2, "W"), getData(config3, "W"));
+  EXPECT_EQ(getData(config2, "b"), getData(config3, "b"));
+  EXPECT_EQ(getData(config2, "W"), getData(config4, "W"));
+  EXPECT_NE(getData(config2, "b"), getData(config4, "b"));
+}
+
+TEST(PredictorMemongerTest, SharesIntermediateBlobs) {
+  const char* chainSpec = R"DOC(
+        name: "chain"
+        external_input: "data"
+        external_output: "y"
+        op {
+          input: "data"
+          output: "h1"
+          type: "Relu"
+        }
+        op {
+          input: "h1"
+          output: "h2"
+          type: "Relu"
+        }
+        op {
+          input: "h2"
+          output: "h3"
+          type: "Relu"
+        }
+        op {
+          input: "h3"
+          output: "y"
+          type: "Relu"
+        }
+)DOC";
+  Predictor p(makePredictorConfig(
+      NetDef(), parseNetDef(chainSpec), nullptr, /*run_init=*/false, 0));
+  std::set<std::string> intermediates;
+  for (const auto& op : p.def().op()) {
+    intermediates.insert(op.output().begin(), op.output().end());
+  }
+  intermediates.erase("y");
+  // h1 and h3 share a blob
+  EXPECT_EQ(intermediates.size(), 2);
+
+  CPUContext ctx;
+  auto inputData = randomTensor({2, 3}, &ctx);
+  Predictor::TensorList input;
+  input.emplace_back(BlobGetMutableTensor(inputData.get(), CPU)->Alias());
+  Predictor::TensorList output;
+  ASSERT_TRUE(p(input, &output));
+  ASSERT_EQ(output.size(), 1);
+  const float* in = input.front().data<float>();
+  const float* out = output.front().data<float>();
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_EQ(out[i], std::max(in[i], 0.0f));
+  }
+}
+
 } // namespace caffe2
@@ -49,5 +49,28 @@ class NUMATest(TestCase):
         self.assertEqual(workspace.GetBlobNUMANode("output_blob_1"), 1)
 
 
+@unittest.skipIf(not workspace.IsNUMAEnabled(), "NUMA is not enabled")
+@unittest.skipIf(workspace.GetNumNUMANodes() < 2, "Not enough NUMA nodes")
+class NUMAAllocTest(TestCase):
+    def test_numa_alloc(self):
+        net = core.Net("test_numa_alloc")
+        net.Proto().type = "async_scheduling"
+
+        # large enough to be allocated on fresh pages of the node of the pool
+        for node in range(2):
+            numa_device_option = caffe2_pb2.DeviceOption()
+            numa_device_option.device_type = caffe2_pb2.CPU
+            numa_device_option.numa_node_id = node
+            net.ConstantFill([], "large_blob_{}".format(node),
+                             shape=[1 << 20], value=1.0,
+                             device_option=numa_device_option)
+
+        workspace.RunNetOnce(net)
+
+        self.assertEqual(workspace.GetBlobNUMANode("large_blob_0"), 0)
+        self.assertEqual(workspace.GetBlobNUMANode("large_blob_1"), 1)
+        workspace.ResetWorkspace()
+
+
 if __name__ == '__main__':
     unittest.main()
@@ -636,6 +636,39 @@ class TestSegmentOps(hu.HypothesisTestCase):
         with self.assertRaises(RuntimeError):
             workspace.RunOperatorOnce(op)
 
+    @given(
+        op_name=st.sampled_from(
+            ["SparseLengthsSum", "SparseLengthsWeightedSum",
+             "SparseLengthsMean"]),
+        index_type=st.sampled_from([np.int32, np.int64]),
+        **hu.gcs_cpu_only
+    )
+    def test_sparse_lengths_hot_row_cache(self, op_name, index_type, gc, dc):
+        D = np.random.rand(1000, 16).astype(np.float32)
+        inputs = ["D", "W", "I", "L"] if "Weighted" in op_name else \
+            ["D", "I", "L"]
+        net = core.Net("hot_row_cache")
+        getattr(net, op_name)(inputs, "out")
+        # the cache lives in the operator, which is kept by the net
+        getattr(net, op_name)(
+            inputs, "cached_out",
+            hot_row_cache_size=20, hot_row_cache_refresh_interval=3)
+        workspace.FeedBlob("D", D)
+        workspace.FeedBlob("L", np.asarray([10, 0, 40, 50]).astype(np.int32))
+        workspace.FeedBlob("W", np.random.rand(100).astype(np.float32))
+        workspace.FeedBlob("I", np.zeros(100).astype(index_type))
+        workspace.CreateNet(net)
+        for _ in range(10):
+            # most of the lookups go to a few rows
+            I = np.minimum(np.random.zipf(1.5, size=100) - 1, 999)
+            workspace.FeedBlob("W", np.random.rand(100).astype(np.float32))
+            workspace.FeedBlob("I", I.astype(index_type))
+            workspace.RunNet(net)
+            np.testing.assert_allclose(
+                workspace.FetchBlob("cached_out"),
+                workspace.FetchBlob("out"),
+                rtol=1e-5, atol=1e-5)
+
     @serial.given(**hu.gcs_cpu_only)
     def test_sparse_lengths_positional_weighted_sum(
             self, gc, dc):
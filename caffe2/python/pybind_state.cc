@@ -20,6 +20,7 @@
 #include "caffe2/onnx/backend.h"
 #include "caffe2/onnx/helper.h"
 #include "caffe2/onnx/onnx_exporter.h"
+#include "caffe2/opt/bound_shape_preallocator.h"
 #include "caffe2/opt/converter.h"
 #include "caffe2/opt/fusion.h"
 #include "caffe2/opt/mobile.h"
@@ -1781,6 +1782,31 @@ void addGlobalMethods(py::module& m) {
         pred_net.SerializeToString(&pred_net_str2);
         return py::bytes(pred_net_str2);
       });
+  m.def(
+      "preallocate_bound_shapes",
+      [](const py::bytes& net_str,
+         const std::unordered_map<std::string, std::vector<int>>& shapes,
+         int max_batch_size,
+         int max_seq_size) {
+        caffe2::NetDef net;
+        CAFFE_ENFORCE(
+            ParseProtoFromLargeString(net_str.cast<std::string>(), &net),
+            "broken net protobuf");
+        Workspace* curr_ws = GetCurrentWorkspace();
+        CAFFE_ENFORCE(curr_ws);
+        ShapeInfoMap shape_map;
+        for (const auto& it : shapes) {
+          shape_map.emplace(
+              it.first,
+              constructShapeInfoWithDefaultDimType(
+                  CreateTensorShape(it.second, TensorProto::FLOAT)));
+        }
+        return PreallocateBoundShapes(
+            curr_ws,
+            net,
+            shape_map,
+            BoundShapeSpec(max_batch_size, max_seq_size));
+      });
   m.def(
       "run_workspace_transform",
       [](const std::string& transform_name, py::bytes def) {
@@ -312,6 +312,25 @@ def InferShapesAndTypes(nets, blob_dimensions=None, nets_proto=False,
     return (shapes, types)
 
 
+def PreallocateBoundShapes(net, input_shapes, max_batch_size,
+                           max_seq_size=1):
+    """Allocates the outputs of the ops of a net for the max batch size.
+
+    Inputs:
+      net: the net, or its protobuffer representation
+      input_shapes: a dictionary of the dimensions of the inputs of the net
+          which are not in the workspace, with max_batch_size as first one
+      max_batch_size, max_seq_size: bounds of the batch and sequence sizes
+    Returns:
+      The number of bytes allocated. The runs of the net on batches up to
+      max_batch_size do not need to allocate these outputs again.
+    """
+    if isinstance(net, core.Net):
+        net = net.Proto()
+    return C.preallocate_bound_shapes(
+        StringifyProto(net), input_shapes, max_batch_size, max_seq_size)
+
+
 def _StringifyName(name, expected_type):
     if isinstance(name, basestring):
         return name
@@ -36,7 +36,9 @@ BlobsQueue::BlobsQueue(
     stats_.queue_dequeued_bytes.setDetails(fieldNames);
   }
   queue_.reserve(capacity);
+  sequence_.reset(new std::atomic<int64_t>[capacity]);
   for (size_t i = 0; i < capacity; ++i) {
+    sequence_[i] = i;
     std::vector<Blob*> blobs;
     blobs.reserve(numBlobs);
     for (size_t j = 0; j < numBlobs; ++j) {
@@ -54,6 +56,54 @@ BlobsQueue::BlobsQueue(
   DCHECK_EQ(queue_.size(), capacity);
 }
 
+int64_t BlobsQueue::tryClaimRead() {
+  const int64_t capacity = queue_.size();
+  auto pos = reader_.load(std::memory_order_relaxed);
+  while (true) {
+    auto seq = sequence_[pos % capacity].load(std::memory_order_acquire);
+    if (seq == pos + 1) {
+      if (reader_.compare_exchange_weak(pos, pos + 1)) {
+        return pos;
+      }
+    } else if (seq < pos + 1) {
+      // not written yet
+      return -1;
+    } else {
+      pos = reader_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+int64_t BlobsQueue::tryClaimWrite() {
+  const int64_t capacity = queue_.size();
+  auto pos = writer_.load(std::memory_order_relaxed);
+  while (true) {
+    auto seq = sequence_[pos % capacity].load(std::memory_order_acquire);
+    if (seq == pos) {
+      if (writer_.compare_exchange_weak(pos, pos + 1)) {
+        return pos;
+      }
+    } else if (seq < pos) {
+      // not read yet
+      return -1;
+    } else {
+      pos = writer_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+void BlobsQueue::notify(
+    std::condition_variable& cv,
+    std::atomic<int>& waiters) {
+  // pairs with the increment of waiters before the sleeping thread checks the
+  // queue, so that either it sees the update or we see it waiting
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (waiters.load() > 0) {
+    std::lock_guard<std::mutex> g(mutex_);
+    cv.notify_all();
+  }
+}
+
 bool BlobsQueue::blockingRead(
     const std::vector<Blob*>& inputs,
     float timeout_secs) {
@@ -61,22 +111,25 @@ bool BlobsQueue::blockingRead(
   auto keeper = this->shared_from_this();
   const auto& name = name_.c_str();
   CAFFE_SDT(queue_read_start, name, (void*)this, SDT_BLOCKING_OP);
-  std::unique_lock<std::mutex> g(mutex_);
-  auto canRead = [this]() {
-    CAFFE_ENFORCE_LE(reader_, writer_);
-    return reader_ != writer_;
-  };
   // Decrease queue balance before reading to indicate queue read pressure
   // is being increased (-ve queue balance indicates more reads than writes)
   CAFFE_EVENT(stats_, queue_balance, -1);
-  if (timeout_secs > 0) {
-    std::chrono::milliseconds timeout_ms(int(timeout_secs * 1000));
-    cv_.wait_for(
-        g, timeout_ms, [this, canRead]() { return closing_ || canRead(); });
-  } else {
-    cv_.wait(g, [this, canRead]() { return closing_ || canRead(); });
+  auto pos = tryClaimRead();
+  if (pos < 0) {
+    std::unique_lock<std::mutex> g(mutex_);
+    ++waitingReaders_;
+    auto ready = [this, &pos]() {
+      return (pos = tryClaimRead()) >= 0 || closing_;
+    };
+    if (timeout_secs > 0) {
+      std::chrono::milliseconds timeout_ms(int(timeout_secs * 1000));
+      canRead_.wait_for(g, timeout_ms, ready);
+    } else {
+      canRead_.wait(g, ready);
+    }
+    --waitingReaders_;
   }
-  if (!canRead()) {
+  if (pos < 0) {
     if (timeout_secs > 0 && !closing_) {
       LOG(ERROR) << "DequeueBlobs timed out in " << timeout_secs << " secs";
       CAFFE_SDT(queue_read_end, name, (void*)this, SDT_TIMEOUT);
@@ -85,21 +138,26 @@ bool BlobsQueue::blockingRead(
     }
     return false;
   }
-  DCHECK(canRead());
-  auto& result = queue_[reader_ % queue_.size()];
+  doRead(pos, inputs);
+  CAFFE_EVENT(stats_, read_time_ns, readTimer.NanoSeconds());
+  return true;
+}
+
+void BlobsQueue::doRead(int64_t pos, const std::vector<Blob*>& inputs) {
+  auto& result = queue_[pos % queue_.size()];
   CAFFE_ENFORCE(inputs.size() >= result.size());
+  const auto& name = name_.c_str();
   for (auto i = 0; i < result.size(); ++i) {
     auto bytes = BlobStat::sizeBytes(*result[i]);
     CAFFE_EVENT(stats_, queue_dequeued_bytes, bytes, i);
     using std::swap;
     swap(*(inputs[i]), *(result[i]));
   }
-  CAFFE_SDT(queue_read_end, name, (void*)this, writer_ - reader_);
+  CAFFE_SDT(queue_read_end, name, (void*)this, writer_ - pos - 1);
   CAFFE_EVENT(stats_, queue_dequeued_records);
-  ++reader_;
-  cv_.notify_all();
-  CAFFE_EVENT(stats_, read_time_ns, readTimer.NanoSeconds());
-  return true;
+  sequence_[pos % queue_.size()].store(
+      pos + queue_.size(), std::memory_order_release);
+  notify(canWrite_, waitingWriters_);
 }
 
 bool BlobsQueue::tryWrite(const std::vector<Blob*>& inputs) {
@@ -107,16 +165,15 @@ bool BlobsQueue::tryWrite(const std::vector<Blob*>& inputs) {
   auto keeper = this->shared_from_this();
   const auto& name = name_.c_str();
   CAFFE_SDT(queue_write_start, name, (void*)this, SDT_NONBLOCKING_OP);
-  std::unique_lock<std::mutex> g(mutex_);
-  if (!canWrite()) {
+  auto pos = tryClaimWrite();
+  if (pos < 0) {
     CAFFE_SDT(queue_write_end, name, (void*)this, SDT_ABORT);
     return false;
   }
   // Increase queue balance before writing to indicate queue write pressure is
   // being increased (+ve queue balance indicates more writes than reads)
   CAFFE_EVENT(stats_, queue_balance, 1);
-  DCHECK(canWrite());
-  doWrite(inputs);
+  doWrite(pos, inputs);
   CAFFE_EVENT(stats_, write_time_ns, writeTimer.NanoSeconds());
   return true;
 }
@@ -126,17 +183,23 @@ bool BlobsQueue::blockingWrite(const std::vector<Blob*>& inputs) {
   auto keeper = this->shared_from_this();
   const auto& name = name_.c_str();
   CAFFE_SDT(queue_write_start, name, (void*)this, SDT_BLOCKING_OP);
-  std::unique_lock<std::mutex> g(mutex_);
   // Increase queue balance before writing to indicate queue write pressure is
   // being increased (+ve queue balance indicates more writes than reads)
   CAFFE_EVENT(stats_, queue_balance, 1);
-  cv_.wait(g, [this]() { return closing_ || canWrite(); });
-  if (!canWrite()) {
+  auto pos = tryClaimWrite();
+  if (pos < 0) {
+    std::unique_lock<std::mutex> g(mutex_);
+    ++waitingWriters_;
+    canWrite_.wait(g, [this, &pos]() {
+      return (pos = tryClaimWrite()) >= 0 || closing_;
+    });
+    --waitingWriters_;
+  }
+  if (pos < 0) {
     CAFFE_SDT(queue_write_end, name, (void*)this, SDT_ABORT);
     return false;
   }
-  DCHECK(canWrite());
-  doWrite(inputs);
+  doWrite(pos, inputs);
   CAFFE_EVENT(stats_, write_time_ns, writeTimer.NanoSeconds());
   return true;
 }
@@ -145,19 +208,12 @@ void BlobsQueue::close() {
   closing_ = true;
 
   std::lock_guard<std::mutex> g(mutex_);
-  cv_.notify_all();
-}
-
-bool BlobsQueue::canWrite() {
-  // writer is always within [reader, reader + size)
-  // we can write if reader is within [reader, reader + size)
-  CAFFE_ENFORCE_LE(reader_, writer_);
-  CAFFE_ENFORCE_LE(writer_, reader_ + queue_.size());
-  return writer_ != reader_ + queue_.size();
+  canRead_.notify_all();
+  canWrite_.notify_all();
 }
 
-void BlobsQueue::doWrite(const std::vector<Blob*>& inputs) {
-  auto& result = queue_[writer_ % queue_.size()];
+void BlobsQueue::doWrite(int64_t pos, const std::vector<Blob*>& inputs) {
+  auto& result = queue_[pos % queue_.size()];
   CAFFE_ENFORCE(inputs.size() >= result.size());
   const auto& name = name_.c_str();
   for (auto i = 0; i < result.size(); ++i) {
@@ -165,9 +221,9 @@ void BlobsQueue::doWrite(const std::vector<Blob*>& inputs) {
     swap(*(inputs[i]), *(result[i]));
   }
   CAFFE_SDT(
-      queue_write_end, name, (void*)this, reader_ + queue_.size() - writer_);
-  ++writer_;
-  cv_.notify_all();
+      queue_write_end, name, (void*)this, reader_ + queue_.size() - pos - 1);
+  sequence_[pos % queue_.size()].store(pos + 1, std::memory_order_release);
+  notify(canRead_, waitingReaders_);
 }
 
 } // namespace caffe2
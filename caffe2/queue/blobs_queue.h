@@ -20,6 +20,12 @@ namespace caffe2 {
 // Containing blobs are owned by the workspace.
 // On read, we swap out the underlying data for the blob passed in for blobs
 
+// Readers and writers claim their slot of the buffer with a compare-and-swap
+// on the read or write position, and every slot carries a sequence number
+// telling whether it is ready for the reader or the writer of that position
+// (a bounded MPMC queue as described by Dmitry Vyukov). Threads only take the
+// mutex to sleep when the queue is empty or full, and to wake sleepers up.
+
 class CAFFE2_API BlobsQueue : public std::enable_shared_from_this<BlobsQueue> {
  public:
   BlobsQueue(
@@ -45,19 +51,30 @@ class CAFFE2_API BlobsQueue : public std::enable_shared_from_this<BlobsQueue> {
   }
 
  private:
-  bool canWrite();
-  void doWrite(const std::vector<Blob*>& inputs);
+  // Claim the slot of the next position, return -1 if there is none
+  int64_t tryClaimRead();
+  int64_t tryClaimWrite();
+  void doRead(int64_t pos, const std::vector<Blob*>& inputs);
+  void doWrite(int64_t pos, const std::vector<Blob*>& inputs);
+  // Wakes up the threads sleeping on cv, if any
+  void notify(std::condition_variable& cv, std::atomic<int>& waiters);
 
   std::atomic<bool> closing_{false};
 
   size_t numBlobs_;
-  std::mutex mutex_; // protects all variables in the class.
-  std::condition_variable cv_;
-  int64_t reader_{0};
-  int64_t writer_{0};
   std::vector<std::vector<Blob*>> queue_;
+  // position of the reader (writer) the slot is ready for
+  std::unique_ptr<std::atomic<int64_t>[]> sequence_;
+  alignas(64) std::atomic<int64_t> reader_{0};
+  alignas(64) std::atomic<int64_t> writer_{0};
   const std::string name_;
 
+  std::mutex mutex_; // only used to sleep and wake up
+  std::condition_variable canRead_;
+  std::condition_variable canWrite_;
+  std::atomic<int> waitingReaders_{0};
+  std::atomic<int> waitingWriters_{0};
+
   struct QueueStats {
     CAFFE_STAT_CTOR(QueueStats);
     CAFFE_EXPORTED_STAT(queue_balance);
@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "caffe2/core/workspace.h"
+#include "caffe2/queue/blobs_queue.h"
+#include <gtest/gtest.h>
+
+namespace caffe2 {
+namespace {
+
+std::shared_ptr<BlobsQueue> makeQueue(Workspace* ws, size_t capacity) {
+  return std::make_shared<BlobsQueue>(ws, "queue", capacity, 1, true);
+}
+
+bool write(BlobsQueue& queue, int value, bool blocking = true) {
+  Blob blob;
+  *blob.GetMutable<int>() = value;
+  return blocking ? queue.blockingWrite({&blob}) : queue.tryWrite({&blob});
+}
+
+} // namespace
+
+TEST(BlobsQueueTest, MultipleProducersAndConsumers) {
+  constexpr int kProducers = 4;
+  constexpr int kConsumers = 4;
+  constexpr int kRecordsPerProducer = 2000;
+  Workspace ws;
+  // A small capacity keeps both producers and consumers waiting on each other.
+  auto queue = makeQueue(&ws, 4);
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&queue, p]() {
+      for (int i = 0; i < kRecordsPerProducer; ++i) {
+        const int value = p * kRecordsPerProducer + i;
+        // One producer spins on tryWrite instead of sleeping.
+        if (p == 0) {
+          while (!write(*queue, value, /*blocking=*/false)) {
+            std::this_thread::yield();
+          }
+        } else {
+          EXPECT_TRUE(write(*queue, value));
+        }
+      }
+    });
+  }
+
+  std::mutex mutex;
+  std::vector<int> received;
+  std::atomic<bool> inOrder{true};
+  std::vector<std::thread> consumers;
+  for (int c = 0; c < kConsumers; ++c) {
+    consumers.emplace_back([&]() {
+      // Every consumer sees the records of every producer in the order they
+      // were written.
+      std::vector<int> last(kProducers, -1);
+      std::vector<int> values;
+      Blob blob;
+      while (queue->blockingRead({&blob})) {
+        const int value = blob.Get<int>();
+        const int p = value / kRecordsPerProducer;
+        if (value <= last[p]) {
+          inOrder = false;
+        }
+        last[p] = value;
+        values.push_back(value);
+      }
+      std::lock_guard<std::mutex> g(mutex);
+      received.insert(received.end(), values.begin(), values.end());
+    });
+  }
+
+  for (auto& t : producers) {
+    t.join();
+  }
+  // The consumers drain what is left before they see the close.
+  queue->close();
+  for (auto& t : consumers) {
+    t.join();
+  }
+
+  EXPECT_TRUE(inOrder);
+  ASSERT_EQ(received.size(), size_t(kProducers * kRecordsPerProducer));
+  std::sort(received.begin(), received.end());
+  for (int i = 0; i < kProducers * kRecordsPerProducer; ++i) {
+    EXPECT_EQ(received[i], i);
+  }
+}
+
+TEST(BlobsQueueTest, CloseCancelsBlockedReaders) {
+  Workspace ws;
+  auto queue = makeQueue(&ws, 4);
+  std::atomic<int> succeeded{0};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i) {
+    readers.emplace_back([&]() {
+      Blob blob;
+      if (queue->blockingRead({&blob})) {
+        ++succeeded;
+      }
+    });
+  }
+  queue->close();
+  for (auto& t : readers) {
+    t.join();
+  }
+  EXPECT_EQ(succeeded.load(), 0);
+}
+
+TEST(BlobsQueueTest, CloseCancelsBlockedWriters) {
+  Workspace ws;
+  auto queue = makeQueue(&ws, 2);
+  EXPECT_TRUE(write(*queue, 0, /*blocking=*/false));
+  EXPECT_TRUE(write(*queue, 1, /*blocking=*/false));
+  EXPECT_FALSE(write(*queue, 2, /*blocking=*/false));
+
+  std::atomic<int> succeeded{0};
+  std::vector<std::thread> writers;
+  for (int i = 0; i < 4; ++i) {
+    writers.emplace_back([&, i]() {
+      if (write(*queue, 2 + i)) {
+        ++succeeded;
+      }
+    });
+  }
+  queue->close();
+  for (auto& t : writers) {
+    t.join();
+  }
+  EXPECT_EQ(succeeded.load(), 0);
+
+  // What was written before the close can still be read, then reads fail.
+  Blob blob;
+  EXPECT_TRUE(queue->blockingRead({&blob}));
+  EXPECT_EQ(blob.Get<int>(), 0);
+  EXPECT_TRUE(queue->blockingRead({&blob}));
+  EXPECT_EQ(blob.Get<int>(), 1);
+  EXPECT_FALSE(queue->blockingRead({&blob}));
+}
+
+TEST(BlobsQueueTest, ReadTimesOut) {
+  Workspace ws;
+  auto queue = makeQueue(&ws, 2);
+  Blob blob;
+  EXPECT_FALSE(queue->blockingRead({&blob}, 0.01f));
+  EXPECT_TRUE(write(*queue, 7));
+  EXPECT_TRUE(queue->blockingRead({&blob}, 0.01f));
+  EXPECT_EQ(blob.Get<int>(), 7);
+}
+
+} // namespace caffe2
@@ -10,6 +10,8 @@
 namespace caffe2 {
 namespace serialize {
 
+// Reads a file. Except on Windows, reads are positional (pread) and may be
+// issued from several threads at once.
 class CAFFE2_API FileAdapter final : public ReadAdapterInterface {
  public:
   C10_DISABLE_COPY_AND_ASSIGN(FileAdapter);
@@ -17,11 +19,17 @@ class CAFFE2_API FileAdapter final : public ReadAdapterInterface {
   size_t size() const override;
   size_t read(uint64_t pos, void* buf, size_t n, const char* what = "")
       const override;
+  bool supports_concurrent_reads() const override;
   ~FileAdapter();
 
  private:
+#ifdef _WIN32
   std::ifstream file_stream_;
   std::unique_ptr<IStreamAdapter> istream_adapter_;
+#else
+  int fd_;
+  size_t size_;
+#endif
 };
 
 } // namespace serialize
@@ -1,10 +1,13 @@
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
 #include <cerrno>
 #include <istream>
 #include <ostream>
 #include <fstream>
+#include <vector>
 
+#include <ATen/Parallel.h>
 #include <c10/core/Allocator.h>
 #include <c10/core/Backend.h>
 
@@ -17,6 +20,10 @@
 
 #include "miniz.h"
 
+#ifdef CAFFE2_USE_ZSTD
+#include <zstd.h>
+#endif
+
 namespace caffe2 {
 namespace serialize {
 
@@ -179,7 +186,173 @@ static size_t getPadding(
   return padding_size_plus_fbxx;
 }
 
+// Chunked records (see PyTorchStreamWriter::writeChunkedRecord) are stored
+// uncompressed and tagged with kChunkedRecordTag as their file comment. The
+// data of such a record is framed as
+//
+//   tag          8 bytes, kChunkedRecordTag
+//   codec        8 bytes, RecordCompression
+//   size         8 bytes, size of the uncompressed record
+//   chunk_size   8 bytes, uncompressed size of every chunk but the last
+//   chunk_ends   8 bytes per chunk, end of each compressed chunk counted
+//                from the start of the first one
+//   the compressed chunks
+//
+// with all integers in little endian. A chunk that does not get smaller when
+// compressed is stored as is; readers tell by its compressed size being equal
+// to its uncompressed size.
+constexpr char kChunkedRecordTag[] = "PTCHUNK1";
+constexpr size_t kChunkedRecordTagSize = 8;
+constexpr size_t kChunkedRecordHeaderSize = 32;
+
+struct ChunkedRecordHeader {
+  RecordCompression codec;
+  size_t size;
+  size_t chunk_size;
+  size_t num_chunks;
+};
+
+static void write_le_64(uint8_t* buf, uint64_t value) {
+  for (size_t i = 0; i < 8; ++i) {
+    buf[i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+}
+
+static uint64_t read_le_64(const uint8_t* buf) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < 8; ++i) {
+    value |= static_cast<uint64_t>(buf[i]) << (8 * i);
+  }
+  return value;
+}
+
+static bool isChunkedRecord(const mz_zip_archive_file_stat& stat) {
+  return stat.m_method == 0 && stat.m_comp_size == stat.m_uncomp_size &&
+      stat.m_comment_size == kChunkedRecordTagSize &&
+      memcmp(stat.m_comment, kChunkedRecordTag, kChunkedRecordTagSize) == 0;
+}
+
+static ChunkedRecordHeader readChunkedRecordHeader(
+    const ReadAdapterInterface& in,
+    size_t data_offset,
+    size_t framed_size,
+    const std::string& name) {
+  if (framed_size < kChunkedRecordHeaderSize) {
+    CAFFE_THROW("chunked record ", name, " is truncated");
+  }
+  uint8_t buf[kChunkedRecordHeaderSize];
+  in.read(data_offset, buf, sizeof(buf), "reading chunked record header");
+  if (memcmp(buf, kChunkedRecordTag, kChunkedRecordTagSize) != 0) {
+    CAFFE_THROW("chunked record ", name, " has an invalid header");
+  }
+  ChunkedRecordHeader header;
+  header.codec = static_cast<RecordCompression>(read_le_64(buf + 8));
+  header.size = read_le_64(buf + 16);
+  header.chunk_size = read_le_64(buf + 24);
+  if (!isRecordCompressionAvailable(header.codec)) {
+    CAFFE_THROW(
+        "record ",
+        name,
+        " uses record compression ",
+        static_cast<uint64_t>(header.codec),
+        ", which is not available in this build");
+  }
+  if (header.chunk_size == 0 || header.chunk_size > kMaxRecordChunkSize) {
+    CAFFE_THROW(
+        "chunked record ", name, " has invalid chunk size ", header.chunk_size);
+  }
+  header.num_chunks =
+      header.size / header.chunk_size + (header.size % header.chunk_size != 0);
+  if (header.num_chunks >
+      (framed_size - kChunkedRecordHeaderSize) / sizeof(uint64_t)) {
+    CAFFE_THROW("chunked record ", name, " is truncated");
+  }
+  return header;
+}
+
+// Compresses n bytes from src into dst, which has room for capacity bytes.
+// Returns the compressed size, or 0 if the compressed data does not fit.
+static size_t compressChunk(
+    RecordCompression codec,
+    const void* src,
+    size_t n,
+    void* dst,
+    size_t capacity) {
+  switch (codec) {
+    case RecordCompression::kDeflate: {
+      mz_ulong dst_len = capacity;
+      int status = mz_compress2(
+          static_cast<unsigned char*>(dst),
+          &dst_len,
+          static_cast<const unsigned char*>(src),
+          n,
+          MZ_BEST_SPEED);
+      return status == MZ_OK ? dst_len : 0;
+    }
+    case RecordCompression::kZstd:
+#ifdef CAFFE2_USE_ZSTD
+    {
+      size_t dst_len =
+          ZSTD_compress(dst, capacity, src, n, ZSTD_CLEVEL_DEFAULT);
+      return ZSTD_isError(dst_len) ? 0 : dst_len;
+    }
+#endif
+      break;
+  }
+  CAFFE_THROW(
+      "record compression ",
+      static_cast<uint64_t>(codec),
+      " is not available in this build");
+}
+
+static void decompressChunk(
+    RecordCompression codec,
+    const void* src,
+    size_t n,
+    void* dst,
+    size_t size,
+    const std::string& name) {
+  bool ok = false;
+  switch (codec) {
+    case RecordCompression::kDeflate: {
+      mz_ulong dst_len = size;
+      ok = mz_uncompress(
+               static_cast<unsigned char*>(dst),
+               &dst_len,
+               static_cast<const unsigned char*>(src),
+               n) == MZ_OK &&
+          dst_len == size;
+      break;
+    }
+    case RecordCompression::kZstd:
+#ifdef CAFFE2_USE_ZSTD
+      // errors are reported as sizes that no chunk can have
+      ok = ZSTD_decompress(dst, size, src, n) == size;
+#endif
+      break;
+  }
+  if (!ok) {
+    CAFFE_THROW(
+        "PytorchStreamReader failed decompressing chunked record ", name);
+  }
+}
+
+bool isRecordCompressionAvailable(RecordCompression codec) {
+  switch (codec) {
+    case RecordCompression::kDeflate:
+      return true;
+    case RecordCompression::kZstd:
+#ifdef CAFFE2_USE_ZSTD
+      return true;
+#else
+      return false;
+#endif
+  }
+  return false;
+}
+
 bool PyTorchStreamReader::hasRecord(const std::string& name) {
+  std::lock_guard<std::mutex> guard(reader_lock_);
   std::string ss = archive_name_plus_slash_ + name;
   mz_zip_reader_locate_file(ar_.get(), ss.c_str(), nullptr, 0);
   bool result = ar_->m_last_error != MZ_ZIP_FILE_NOT_FOUND;
@@ -191,6 +364,7 @@ bool PyTorchStreamReader::hasRecord(const std::string& name) {
 }
 
 std::vector<std::string> PyTorchStreamReader::getAllRecords() {
+  std::lock_guard<std::mutex> guard(reader_lock_);
   mz_uint num_files = mz_zip_reader_get_num_files(ar_.get());
   std::vector<std::string> out;
   char buf[MZ_ZIP_MAX_ARCHIVE_FILENAME_SIZE];
@@ -213,10 +387,44 @@ size_t PyTorchStreamReader::getRecordID(const std::string& name) {
 
 // return dataptr, size
 std::tuple<at::DataPtr, size_t> PyTorchStreamReader::getRecord(const std::string& name) {
+  std::unique_lock<std::mutex> guard(reader_lock_);
   size_t key = getRecordID(name);
   mz_zip_archive_file_stat stat;
   mz_zip_reader_file_stat(ar_.get(), key, &stat);
   valid("retrieving file meta-data for ", name.c_str());
+  if (isChunkedRecord(stat)) {
+    return readChunkedRecord(
+        name,
+        getDataOffset(stat.m_local_header_ofs),
+        stat.m_uncomp_size,
+        stat.m_crc32,
+        0,
+        c10::nullopt,
+        guard);
+  }
+  if (stat.m_method == 0 && stat.m_comp_size == stat.m_uncomp_size) {
+    const size_t offset = getDataOffset(stat.m_local_header_ofs);
+    // Uncompressed records can be returned in place by readers that hold the
+    // archive in memory...
+    at::DataPtr alias = in_->alias(offset, stat.m_uncomp_size);
+    if (alias) {
+      return std::make_tuple(std::move(alias), stat.m_uncomp_size);
+    }
+    // ...and read without holding the lock if the reader allows it, so that
+    // several threads can load records at once.
+    if (in_->supports_concurrent_reads()) {
+      guard.unlock();
+      void* ptr = malloc(stat.m_uncomp_size);
+      at::DataPtr retval(ptr, ptr, free, at::kCPU);
+      in_->read(offset, ptr, stat.m_uncomp_size, "reading file");
+      if (mz_crc32(MZ_CRC32_INIT, static_cast<const mz_uint8*>(ptr),
+                   stat.m_uncomp_size) != stat.m_crc32) {
+        CAFFE_THROW("PytorchStreamReader failed reading file ", name,
+                    ": CRC-32 check failed");
+      }
+      return std::make_tuple(std::move(retval), stat.m_uncomp_size);
+    }
+  }
   void * ptr = malloc(stat.m_uncomp_size);
   mz_zip_reader_extract_to_mem(ar_.get(), key, ptr, stat.m_uncomp_size, 0);
   valid("reading file ", name.c_str());
@@ -225,23 +433,197 @@ std::tuple<at::DataPtr, size_t> PyTorchStreamReader::getRecord(const std::string
   return std::make_tuple(std::move(retval), stat.m_uncomp_size);
 }
 
+at::DataPtr PyTorchStreamReader::getRecordRange(
+    const std::string& name,
+    size_t offset,
+    size_t n) {
+  std::unique_lock<std::mutex> guard(reader_lock_);
+  size_t key = getRecordID(name);
+  mz_zip_archive_file_stat stat;
+  mz_zip_reader_file_stat(ar_.get(), key, &stat);
+  valid("retrieving file meta-data for ", name.c_str());
+  const size_t data_offset = getDataOffset(stat.m_local_header_ofs);
+  if (isChunkedRecord(stat)) {
+    return std::get<0>(readChunkedRecord(
+        name, data_offset, stat.m_uncomp_size, stat.m_crc32, offset, n, guard));
+  }
+  AT_ASSERTM(
+      offset <= stat.m_uncomp_size && n <= stat.m_uncomp_size - offset,
+      "range [", offset, ", ", offset + n, ") is out of bounds of record ",
+      name, " of size ", stat.m_uncomp_size);
+  if (stat.m_method == 0 && stat.m_comp_size == stat.m_uncomp_size) {
+    at::DataPtr alias = in_->alias(data_offset + offset, n);
+    if (alias) {
+      return alias;
+    }
+    if (in_->supports_concurrent_reads()) {
+      guard.unlock();
+    }
+    void* ptr = malloc(n);
+    at::DataPtr retval(ptr, ptr, free, at::kCPU);
+    in_->read(data_offset + offset, ptr, n, "reading file");
+    return retval;
+  }
+  // zip compressed records can only be extracted as a whole
+  guard.unlock();
+  at::DataPtr record;
+  std::tie(record, std::ignore) = getRecord(name);
+  void* ptr = malloc(n);
+  memcpy(ptr, static_cast<const char*>(record.get()) + offset, n);
+  return at::DataPtr(ptr, ptr, free, at::kCPU);
+}
+
+size_t PyTorchStreamReader::getRecordSize(const std::string& name) {
+  std::lock_guard<std::mutex> guard(reader_lock_);
+  mz_zip_archive_file_stat stat;
+  mz_zip_reader_file_stat(ar_.get(), getRecordID(name), &stat);
+  valid("retrieving file meta-data for ", name.c_str());
+  if (isChunkedRecord(stat)) {
+    return readChunkedRecordHeader(
+               *in_,
+               getDataOffset(stat.m_local_header_ofs),
+               stat.m_uncomp_size,
+               name)
+        .size;
+  }
+  return stat.m_uncomp_size;
+}
+
+std::tuple<at::DataPtr, size_t> PyTorchStreamReader::readChunkedRecord(
+    const std::string& name,
+    size_t data_offset,
+    size_t framed_size,
+    uint32_t crc32,
+    size_t offset,
+    c10::optional<size_t> n_opt,
+    std::unique_lock<std::mutex>& guard) {
+  const ChunkedRecordHeader header =
+      readChunkedRecordHeader(*in_, data_offset, framed_size, name);
+  AT_ASSERTM(
+      offset <= header.size,
+      "offset ", offset, " is out of bounds of record ", name, " of size ",
+      header.size);
+  const size_t n = n_opt ? *n_opt : header.size - offset;
+  AT_ASSERTM(
+      n <= header.size - offset,
+      "range [", offset, ", ", offset + n, ") is out of bounds of record ",
+      name, " of size ", header.size);
+  void* out = malloc(n);
+  at::DataPtr retval(out, out, free, at::kCPU);
+  if (n == 0) {
+    return std::make_tuple(std::move(retval), n);
+  }
+
+  // Read the ends of chunks first - 1 through last; the end of chunk
+  // first - 1 is where chunk first starts.
+  const size_t first = offset / header.chunk_size;
+  const size_t last = (offset + n - 1) / header.chunk_size;
+  const size_t table_begin = first == 0 ? 0 : first - 1;
+  std::vector<uint8_t> table(sizeof(uint64_t) * (last + 1 - table_begin));
+  in_->read(
+      data_offset + kChunkedRecordHeaderSize + sizeof(uint64_t) * table_begin,
+      table.data(),
+      table.size(),
+      "reading chunked record table");
+  std::vector<size_t> starts(last + 2 - first);
+  starts[0] = first == 0 ? 0 : read_le_64(table.data());
+  for (size_t c = first; c <= last; ++c) {
+    starts[c + 1 - first] =
+        read_le_64(table.data() + sizeof(uint64_t) * (c - table_begin));
+  }
+  const size_t payload_offset =
+      kChunkedRecordHeaderSize + sizeof(uint64_t) * header.num_chunks;
+  for (size_t i = 1; i < starts.size(); ++i) {
+    if (starts[i] < starts[i - 1] ||
+        starts[i] > framed_size - payload_offset) {
+      CAFFE_THROW("chunked record ", name, " has an invalid chunk table");
+    }
+  }
+
+  // The compressed chunks are read without holding the lock if the reader
+  // allows it, and decompressed without it.
+  const size_t span_offset = data_offset + payload_offset + starts.front();
+  const size_t span_size = starts.back() - starts.front();
+  at::DataPtr span = in_->alias(span_offset, span_size);
+  if (!span) {
+    if (in_->supports_concurrent_reads()) {
+      guard.unlock();
+    }
+    void* ptr = malloc(span_size);
+    span = at::DataPtr(ptr, ptr, free, at::kCPU);
+    in_->read(span_offset, ptr, span_size, "reading chunked record");
+  }
+  if (guard.owns_lock()) {
+    guard.unlock();
+  }
+  const uint8_t* compressed = static_cast<const uint8_t*>(span.get());
+
+  if (first == 0 && last + 1 == header.num_chunks) {
+    uint8_t header_buf[kChunkedRecordHeaderSize];
+    memcpy(header_buf, kChunkedRecordTag, kChunkedRecordTagSize);
+    write_le_64(header_buf + 8, static_cast<uint64_t>(header.codec));
+    write_le_64(header_buf + 16, header.size);
+    write_le_64(header_buf + 24, header.chunk_size);
+    mz_ulong crc = mz_crc32(MZ_CRC32_INIT, header_buf, sizeof(header_buf));
+    crc = mz_crc32(crc, table.data(), table.size());
+    crc = mz_crc32(crc, compressed, span_size);
+    if (crc != crc32 || payload_offset + span_size != framed_size) {
+      CAFFE_THROW(
+          "PytorchStreamReader failed reading file ",
+          name,
+          ": CRC-32 check failed");
+    }
+  }
+
+  at::parallel_for(
+      first, last + 1, 1, [&](int64_t begin, int64_t end) {
+        std::vector<uint8_t> scratch;
+        for (size_t c = begin; c < static_cast<size_t>(end); ++c) {
+          const size_t chunk_begin = c * header.chunk_size;
+          const size_t chunk_len =
+              std::min(header.chunk_size, header.size - chunk_begin);
+          const uint8_t* src = compressed + starts[c - first] - starts.front();
+          const size_t src_len = starts[c + 1 - first] - starts[c - first];
+          const size_t lo = std::max(offset, chunk_begin);
+          const size_t hi = std::min(offset + n, chunk_begin + chunk_len);
+          uint8_t* dst = static_cast<uint8_t*>(out) + (lo - offset);
+          if (src_len == chunk_len) {
+            memcpy(dst, src + (lo - chunk_begin), hi - lo);
+          } else if (lo == chunk_begin && hi == chunk_begin + chunk_len) {
+            decompressChunk(header.codec, src, src_len, dst, chunk_len, name);
+          } else {
+            scratch.resize(chunk_len);
+            decompressChunk(
+                header.codec, src, src_len, scratch.data(), chunk_len, name);
+            memcpy(dst, scratch.data() + (lo - chunk_begin), hi - lo);
+          }
+        }
+      });
+  return std::make_tuple(std::move(retval), n);
+}
+
 static int64_t read_le_16(uint8_t* buf) {
   return buf[0] + (buf[1] << 8);
 }
 
 size_t PyTorchStreamReader::getRecordOffset(const std::string& name) {
+  std::lock_guard<std::mutex> guard(reader_lock_);
   mz_zip_archive_file_stat stat;
   mz_zip_reader_file_stat(ar_.get(), getRecordID(name), &stat);
   valid("retrieving file meta-data for ", name.c_str());
+  return getDataOffset(stat.m_local_header_ofs);
+}
+
+size_t PyTorchStreamReader::getDataOffset(uint64_t local_header_offset) {
   uint8_t local_header[MZ_ZIP_LOCAL_DIR_HEADER_SIZE];
   in_->read(
-      stat.m_local_header_ofs,
+      local_header_offset,
       local_header,
       MZ_ZIP_LOCAL_DIR_HEADER_SIZE,
       "reading file header");
   size_t filename_len = read_le_16(local_header + MZ_ZIP_LDH_FILENAME_LEN_OFS);
   size_t extra_len = read_le_16(local_header + MZ_ZIP_LDH_EXTRA_LEN_OFS);
-  return stat.m_local_header_ofs + MZ_ZIP_LOCAL_DIR_HEADER_SIZE + filename_len + extra_len;
+  return local_header_offset + MZ_ZIP_LOCAL_DIR_HEADER_SIZE + filename_len + extra_len;
 }
 
 
@@ -314,19 +696,94 @@ void PyTorchStreamWriter::writeRecord(
     const void* data,
     size_t size,
     bool compress) {
+  uint32_t flags = compress ? MZ_BEST_COMPRESSION : 0;
+  writeRecordWithComment(name, data, size, flags, nullptr, 0);
+}
+
+void PyTorchStreamWriter::writeChunkedRecord(
+    const std::string& name,
+    const void* data,
+    size_t size,
+    RecordCompression codec,
+    size_t chunk_size) {
+  AT_ASSERTM(
+      isRecordCompressionAvailable(codec),
+      "record compression ",
+      static_cast<uint64_t>(codec),
+      " is not available in this build");
+  AT_ASSERTM(
+      chunk_size > 0 && chunk_size <= kMaxRecordChunkSize,
+      "invalid chunk size ",
+      chunk_size);
+  const size_t num_chunks =
+      size / chunk_size + (size % chunk_size != 0);
+  const uint8_t* src = static_cast<const uint8_t*>(data);
+  std::vector<std::vector<uint8_t>> chunks(num_chunks);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; ++c) {
+      const size_t chunk_begin = c * chunk_size;
+      const size_t chunk_len = std::min(chunk_size, size - chunk_begin);
+      auto& chunk = chunks[c];
+      // only keep the compressed data if it is smaller
+      chunk.resize(chunk_len - 1);
+      size_t compressed_len = chunk_len > 1
+          ? compressChunk(
+                codec, src + chunk_begin, chunk_len, chunk.data(), chunk_len - 1)
+          : 0;
+      if (compressed_len == 0) {
+        chunk.assign(src + chunk_begin, src + chunk_begin + chunk_len);
+      } else {
+        chunk.resize(compressed_len);
+      }
+    }
+  });
+
+  std::vector<uint8_t> framed(
+      kChunkedRecordHeaderSize + sizeof(uint64_t) * num_chunks);
+  memcpy(framed.data(), kChunkedRecordTag, kChunkedRecordTagSize);
+  write_le_64(framed.data() + 8, static_cast<uint64_t>(codec));
+  write_le_64(framed.data() + 16, size);
+  write_le_64(framed.data() + 24, chunk_size);
+  size_t chunk_end = 0;
+  for (size_t c = 0; c < num_chunks; ++c) {
+    chunk_end += chunks[c].size();
+    write_le_64(
+        framed.data() + kChunkedRecordHeaderSize + sizeof(uint64_t) * c,
+        chunk_end);
+  }
+  framed.reserve(framed.size() + chunk_end);
+  for (auto& chunk : chunks) {
+    framed.insert(framed.end(), chunk.begin(), chunk.end());
+    std::vector<uint8_t>().swap(chunk);
+  }
+  writeRecordWithComment(
+      name,
+      framed.data(),
+      framed.size(),
+      0,
+      kChunkedRecordTag,
+      kChunkedRecordTagSize);
+}
+
+void PyTorchStreamWriter::writeRecordWithComment(
+    const std::string& name,
+    const void* data,
+    size_t size,
+    uint32_t flags,
+    const char* comment,
+    size_t comment_size) {
   AT_ASSERT(!finalized_);
   AT_ASSERT(!archive_name_plus_slash_.empty());
   std::string full_name = archive_name_plus_slash_ + name;
   size_t padding_size =
       getPadding(ar_->m_archive_size, full_name.size(), size, padding_);
-  uint32_t flags = compress ? MZ_BEST_COMPRESSION : 0;
   mz_zip_writer_add_mem_ex_v2(
       ar_.get(),
       full_name.c_str(),
       data,
       size,
-      nullptr,
-      0,
+      comment,
+      comment_size,
       flags,
       0,
       0,
@@ -5,10 +5,12 @@
 #include <cstring>
 #include <fstream>
 #include <istream>
+#include <mutex>
 #include <ostream>
 
 #include <c10/core/Allocator.h>
 #include <c10/core/Backend.h>
+#include <c10/util/Optional.h>
 
 #include "caffe2/serialize/istream_adapter.h"
 #include "caffe2/serialize/read_adapter_interface.h"
@@ -52,6 +54,8 @@ typedef struct mz_zip_archive mz_zip_archive;
 // 2. It provides a getRecordOffset function which returns the offset into the
 //    raw file where file data lives. If the file was written with
 //    PyTorchStreamWriter it is guaranteed to be 64 byte aligned.
+// 3. Given a ReadAdapterInterface that maps the file into memory
+//    (MmapAdapter), getRecord returns uncompressed records without copying.
 
 // PyTorchReader/Writer handle checking the version number on the archive format
 // and ensure that all files are written to a archive_name directory so they
@@ -102,6 +106,19 @@ constexpr uint64_t kProducedFileFormatVersion = 0x3L;
 // Writer-specific constants
 constexpr uint64_t kFieldAlignment = 64;
 
+// Codecs for records written with PyTorchStreamWriter::writeChunkedRecord.
+enum class RecordCompression : uint64_t {
+  // deflate through miniz, always available
+  kDeflate = 1,
+  // zstd, only available when built with USE_ZSTD
+  kZstd = 2,
+};
+
+constexpr size_t kDefaultRecordChunkSize = 1 << 20;
+constexpr size_t kMaxRecordChunkSize = 1 << 30;
+
+CAFFE2_API bool isRecordCompressionAvailable(RecordCompression codec);
+
 class CAFFE2_API PyTorchStreamReader final {
  public:
   explicit PyTorchStreamReader(const std::string& file_name);
@@ -109,7 +126,21 @@ class CAFFE2_API PyTorchStreamReader final {
   explicit PyTorchStreamReader(std::unique_ptr<ReadAdapterInterface> in);
 
   // return dataptr, size
+  // The data aliases the input instead of being copied if the
+  // ReadAdapterInterface supports it, e.g. for MmapAdapter.
+  // All methods may be called from several threads at once; uncompressed
+  // records are then read concurrently if the ReadAdapterInterface
+  // supports_concurrent_reads().
+  // Chunked records are decompressed, several chunks at once, on the intra-op
+  // thread pool.
   std::tuple<at::DataPtr, size_t> getRecord(const std::string& name);
+  // bytes [offset, offset + n) of a record; of a chunked record only the
+  // chunks that overlap them are read and decompressed
+  at::DataPtr getRecordRange(const std::string& name, size_t offset, size_t n);
+  // size of the data returned by getRecord()
+  size_t getRecordSize(const std::string& name);
+  // offset of the data in the archive; for a chunked record this is the
+  // offset of its framed, compressed data
   size_t getRecordOffset(const std::string& name);
   bool hasRecord(const std::string& name);
   std::vector<std::string> getAllRecords();
@@ -124,6 +155,20 @@ class CAFFE2_API PyTorchStreamReader final {
   size_t read(uint64_t pos, char* buf, size_t n);
   void valid(const char* what, const char* info = "");
   size_t getRecordID(const std::string& name);
+  // offset of the data of the record whose local header is at the given
+  // offset
+  size_t getDataOffset(uint64_t local_header_offset);
+  // Reads bytes [offset, offset + n) of the chunked record whose framed data
+  // is at data_offset, and releases guard once done with ar_ and in_. The
+  // CRC-32 of the framed data is checked when the whole record is read.
+  std::tuple<at::DataPtr, size_t> readChunkedRecord(
+      const std::string& name,
+      size_t data_offset,
+      size_t framed_size,
+      uint32_t crc32,
+      size_t offset,
+      c10::optional<size_t> n,
+      std::unique_lock<std::mutex>& guard);
 
   friend size_t
   istream_read_func(void* pOpaque, uint64_t file_ofs, void* pBuf, size_t n);
@@ -132,6 +177,8 @@ class CAFFE2_API PyTorchStreamReader final {
   std::string archive_name_plus_slash_;
   std::unique_ptr<ReadAdapterInterface> in_;
   int64_t version_;
+  // guards ar_, and in_ unless it supports concurrent reads
+  std::mutex reader_lock_;
 };
 
 class CAFFE2_API PyTorchStreamWriter final {
@@ -145,6 +192,18 @@ class CAFFE2_API PyTorchStreamWriter final {
       const void* data,
       size_t size,
       bool compress = false);
+  // Writes a record whose data is split into chunks of chunk_size bytes
+  // that are compressed independently, on the intra-op thread pool, so that
+  // readers can decompress them in parallel and read part of the record
+  // without decompressing all of it. The record itself is stored
+  // uncompressed and aligned like any other; it needs a reader that knows
+  // about chunked records.
+  void writeChunkedRecord(
+      const std::string& name,
+      const void* data,
+      size_t size,
+      RecordCompression codec = RecordCompression::kDeflate,
+      size_t chunk_size = kDefaultRecordChunkSize);
   void writeEndOfFile();
 
   bool finalized() const {
@@ -159,6 +218,13 @@ class CAFFE2_API PyTorchStreamWriter final {
 
  private:
   void setup(const std::string& file_name);
+  void writeRecordWithComment(
+      const std::string& name,
+      const void* data,
+      size_t size,
+      uint32_t flags,
+      const char* comment,
+      size_t comment_size);
   void valid(const char* what, const char* info = "");
   size_t current_pos_ = 0;
   std::unique_ptr<mz_zip_archive> ar_;
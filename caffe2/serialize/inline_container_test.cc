@@ -1,10 +1,14 @@
 #include <cstdio>
 #include <string>
 #include <array>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
 #include "caffe2/serialize/inline_container.h"
+#include "caffe2/serialize/mmap_adapter.h"
 
 namespace caffe2 {
 namespace serialize {
@@ -63,6 +67,165 @@ TEST(PyTorchStreamWriterAndReader, SaveAndLoad) {
   ASSERT_EQ(memcmp(the_file.c_str() + off2, data2.data(), data2.size()), 0);
 }
 
+TEST(PyTorchStreamWriterAndReader, MmapAdapterAliasesRecords) {
+  std::ostringstream oss;
+  PyTorchStreamWriter writer([&](const void* b, size_t n) -> size_t {
+    oss.write(static_cast<const char*>(b), n);
+    return oss ? n : 0;
+  });
+  std::array<char, 300> data1;
+  for (int i = 0; i < data1.size(); ++i) {
+    data1[i] = i % 127;
+  }
+  writer.writeRecord("key1", data1.data(), data1.size());
+  std::array<char, 100> data2;
+  for (int i = 0; i < data2.size(); ++i) {
+    data2[i] = data2.size() - i;
+  }
+  writer.writeRecord("key2", data2.data(), data2.size(), /*compress=*/true);
+  writer.writeEndOfFile();
+
+  const std::string file_name = "output_mmap.zip";
+  {
+    std::ofstream out(file_name, std::ofstream::binary);
+    const std::string the_file = oss.str();
+    out.write(the_file.c_str(), the_file.size());
+  }
+
+  at::DataPtr data_ptr;
+  int64_t size;
+  {
+    PyTorchStreamReader reader(std::make_unique<MmapAdapter>(file_name));
+    std::tie(data_ptr, size) = reader.getRecord("key1");
+    ASSERT_EQ(size, data1.size());
+    ASSERT_EQ(memcmp(data_ptr.get(), data1.data(), data1.size()), 0);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(data_ptr.get()) % kFieldAlignment, 0);
+    // an uncompressed record is not copied
+    ASSERT_EQ(std::get<0>(reader.getRecord("key1")).get(), data_ptr.get());
+
+    // compressed records are still decompressed into fresh memory
+    at::DataPtr compressed;
+    std::tie(compressed, size) = reader.getRecord("key2");
+    ASSERT_EQ(size, data2.size());
+    ASSERT_EQ(memcmp(compressed.get(), data2.data(), data2.size()), 0);
+  }
+  // the record keeps the mapping alive after the reader is gone
+  ASSERT_EQ(memcmp(data_ptr.get(), data1.data(), data1.size()), 0);
+  data_ptr.clear();
+  std::remove(file_name.c_str());
+}
+
+TEST(PyTorchStreamWriterAndReader, ConcurrentGetRecord) {
+  const std::string file_name = "output_concurrent.zip";
+  std::vector<std::vector<char>> records(16);
+  {
+    std::ofstream out(file_name, std::ofstream::binary);
+    PyTorchStreamWriter writer([&](const void* b, size_t n) -> size_t {
+      out.write(static_cast<const char*>(b), n);
+      return out ? n : 0;
+    });
+    for (size_t r = 0; r < records.size(); ++r) {
+      records[r].resize(1000 + 97 * r);
+      for (size_t i = 0; i < records[r].size(); ++i) {
+        records[r][i] = static_cast<char>(r * 31 + i);
+      }
+      writer.writeRecord(
+          "data/" + std::to_string(r),
+          records[r].data(),
+          records[r].size(),
+          /*compress=*/r % 4 == 0);
+    }
+    writer.writeEndOfFile();
+  }
+
+  PyTorchStreamReader reader(file_name);
+  std::vector<std::thread> threads;
+  std::atomic<int> mismatches{0};
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int k = 0; k < 50; ++k) {
+        size_t r = (t * 7 + k) % records.size();
+        at::DataPtr data_ptr;
+        size_t size;
+        std::tie(data_ptr, size) =
+            reader.getRecord("data/" + std::to_string(r));
+        if (size != records[r].size() ||
+            memcmp(data_ptr.get(), records[r].data(), size) != 0) {
+          mismatches++;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(mismatches.load(), 0);
+  std::remove(file_name.c_str());
+}
+
+TEST(PyTorchStreamWriterAndReader, ChunkedRecords) {
+  std::ostringstream oss;
+  PyTorchStreamWriter writer([&](const void* b, size_t n) -> size_t {
+    oss.write(static_cast<const char*>(b), n);
+    return oss ? n : 0;
+  });
+  // compressible data, except for a random looking stretch in the middle
+  std::vector<char> data(10000);
+  uint32_t state = 1;
+  for (size_t i = 0; i < data.size(); ++i) {
+    state = state * 1103515245 + 12345;
+    data[i] = i >= 4000 && i < 5000 ? static_cast<char>(state >> 16) : i % 7;
+  }
+  writer.writeChunkedRecord(
+      "chunked", data.data(), data.size(), RecordCompression::kDeflate, 1000);
+  writer.writeChunkedRecord(
+      "one_chunk", data.data(), 100, RecordCompression::kDeflate);
+  writer.writeChunkedRecord(
+      "empty", data.data(), 0, RecordCompression::kDeflate);
+  writer.writeRecord("plain", data.data(), data.size());
+  writer.writeEndOfFile();
+
+  std::string the_file = oss.str();
+  std::istringstream iss(the_file);
+  PyTorchStreamReader reader(&iss);
+
+  at::DataPtr data_ptr;
+  size_t size;
+  std::tie(data_ptr, size) = reader.getRecord("chunked");
+  ASSERT_EQ(size, data.size());
+  ASSERT_EQ(memcmp(data_ptr.get(), data.data(), data.size()), 0);
+  ASSERT_EQ(reader.getRecordSize("chunked"), data.size());
+  ASSERT_EQ(reader.getRecordOffset("chunked") % kFieldAlignment, 0);
+  std::tie(data_ptr, size) = reader.getRecord("one_chunk");
+  ASSERT_EQ(size, 100);
+  ASSERT_EQ(memcmp(data_ptr.get(), data.data(), 100), 0);
+  std::tie(data_ptr, size) = reader.getRecord("empty");
+  ASSERT_EQ(size, 0);
+
+  // ranges within a chunk, across chunks, and over the stored chunks
+  for (auto range : std::vector<std::pair<size_t, size_t>>{
+           {0, 10}, {1500, 200}, {999, 2}, {3500, 2000}, {9990, 10}}) {
+    for (const char* name : {"chunked", "plain"}) {
+      data_ptr = reader.getRecordRange(name, range.first, range.second);
+      ASSERT_EQ(
+          memcmp(data_ptr.get(), data.data() + range.first, range.second), 0);
+    }
+  }
+  ASSERT_ANY_THROW(reader.getRecordRange("chunked", 9990, 11));
+  ASSERT_ANY_THROW(reader.getRecordRange("plain", 10001, 0));
+
+  // the chunks are smaller than the data, except for the random ones
+  ASSERT_LT(the_file.size(), 2 * data.size());
+
+  // a corrupted chunk is detected
+  const size_t offset = reader.getRecordOffset("chunked");
+  std::string corrupted = the_file;
+  corrupted[offset + 32 + 8 * 10 + 1] ^= 0x55;
+  std::istringstream corrupted_iss(corrupted);
+  PyTorchStreamReader corrupted_reader(&corrupted_iss);
+  ASSERT_ANY_THROW(corrupted_reader.getRecord("chunked"));
+}
+
 } // namespace
 } // namespace serialize
 } // namespace caffe2
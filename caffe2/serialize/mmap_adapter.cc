@@ -0,0 +1,139 @@
+#include "caffe2/serialize/mmap_adapter.h"
+
+#include <c10/util/Exception.h>
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace caffe2 {
+namespace serialize {
+
+namespace {
+
+void deleteAlias(void* ctx) {
+  delete static_cast<std::shared_ptr<char>*>(ctx);
+}
+
+} // namespace
+
+#ifdef _WIN32
+
+MmapAdapter::MmapAdapter(const std::string& file_name) : size_(0) {
+  HANDLE file = CreateFileA(
+      file_name.c_str(),
+      GENERIC_READ,
+      FILE_SHARE_READ,
+      nullptr,
+      OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL,
+      nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    AT_ERROR("open file failed, file path: ", file_name);
+  }
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size)) {
+    CloseHandle(file);
+    AT_ERROR("could not get the size of ", file_name);
+  }
+  size_ = static_cast<size_t>(file_size.QuadPart);
+  if (size_ == 0) {
+    CloseHandle(file);
+    return;
+  }
+  HANDLE mapping =
+      CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (!mapping) {
+    AT_ERROR("could not map ", file_name, ", error code ", GetLastError());
+  }
+  void* base = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+  // the view keeps the mapping object alive
+  CloseHandle(mapping);
+  if (!base) {
+    AT_ERROR("could not map ", file_name, ", error code ", GetLastError());
+  }
+  data_ = std::shared_ptr<char>(
+      static_cast<char*>(base), [](char* p) { UnmapViewOfFile(p); });
+}
+
+#else // !defined(_WIN32)
+
+MmapAdapter::MmapAdapter(const std::string& file_name) : size_(0) {
+  int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd == -1) {
+    AT_ERROR("open file failed, file path: ", file_name);
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) == -1) {
+    close(fd);
+    AT_ERROR("could not get the size of ", file_name, ": ", strerror(errno));
+  }
+  size_ = static_cast<size_t>(file_stat.st_size);
+  if (size_ == 0) {
+    close(fd);
+    return;
+  }
+  void* base =
+      mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  // the mapping keeps the file open
+  close(fd);
+  if (base == MAP_FAILED) {
+    AT_ERROR("could not map ", file_name, ": ", strerror(errno));
+  }
+  const size_t size = size_;
+  data_ = std::shared_ptr<char>(
+      static_cast<char*>(base), [size](char* p) { munmap(p, size); });
+}
+
+#endif // _WIN32
+
+size_t MmapAdapter::size() const {
+  return size_;
+}
+
+size_t MmapAdapter::read(uint64_t pos, void* buf, size_t n, const char* what)
+    const {
+  if (pos + n > size_) {
+    AT_ERROR("MmapAdapter read past the end of the file: ", what, ".");
+  }
+  std::memcpy(buf, data_.get() + pos, n);
+  return n;
+}
+
+at::DataPtr MmapAdapter::alias(uint64_t pos, size_t n) const {
+  TORCH_CHECK(
+      pos + n <= size_,
+      "MmapAdapter: bytes [",
+      pos,
+      ", ",
+      pos + n,
+      ") are out of range for a file of ",
+      size_,
+      " bytes");
+  if (!data_) {
+    return at::DataPtr();
+  }
+  return at::DataPtr(
+      data_.get() + pos,
+      new std::shared_ptr<char>(data_),
+      &deleteAlias,
+      at::kCPU);
+}
+
+bool MmapAdapter::supports_concurrent_reads() const {
+  return true;
+}
+
+MmapAdapter::~MmapAdapter() {}
+
+} // namespace serialize
+} // namespace caffe2
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "c10/macros/Macros.h"
+#include "caffe2/serialize/read_adapter_interface.h"
+
+namespace caffe2 {
+namespace serialize {
+
+// Reads a file by mapping all of it into memory. Pages are read from disk
+// on first access, and mappings of the same file share them through the
+// page cache.
+//
+// alias() hands out views of the mapping, so PyTorchStreamReader::getRecord
+// returns uncompressed records without copying them. The mapping is private:
+// writes through these views are copy-on-write and never reach the file.
+// It stays alive until the adapter and every DataPtr from alias() are gone.
+class CAFFE2_API MmapAdapter final : public ReadAdapterInterface {
+ public:
+  C10_DISABLE_COPY_AND_ASSIGN(MmapAdapter);
+  explicit MmapAdapter(const std::string& file_name);
+  size_t size() const override;
+  size_t read(uint64_t pos, void* buf, size_t n, const char* what = "")
+      const override;
+  at::DataPtr alias(uint64_t pos, size_t n) const override;
+  bool supports_concurrent_reads() const override;
+  ~MmapAdapter();
+
+ private:
+  size_t size_;
+  // base of the mapping; the deleter unmaps it
+  std::shared_ptr<char> data_;
+};
+
+} // namespace serialize
+} // namespace caffe2
@@ -3,6 +3,7 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "c10/core/Allocator.h"
 #include "c10/macros/Macros.h"
 
 namespace caffe2 {
@@ -16,6 +17,14 @@ class CAFFE2_API ReadAdapterInterface {
   virtual size_t size() const = 0;
   virtual size_t read(uint64_t pos, void* buf, size_t n, const char* what = "")
       const = 0;
+  // Returns n bytes of the input starting at pos without copying them, for
+  // readers that hold the whole input in memory (see MmapAdapter). The
+  // returned DataPtr keeps that memory alive. The default implementation
+  // returns an empty DataPtr, in which case callers fall back to read().
+  virtual at::DataPtr alias(uint64_t pos, size_t n) const;
+  // Whether read() may be called from several threads at once. If not,
+  // PyTorchStreamReader serializes all reads.
+  virtual bool supports_concurrent_reads() const;
   virtual ~ReadAdapterInterface();
 };
 
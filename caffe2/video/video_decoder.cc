@@ -5,8 +5,89 @@
 #include <random>
 #include <array>
 
+// Hardware decoding goes through the hwcontext API and the hardware
+// configurations of codecs, the latter appearing in FFmpeg 4.0
+#if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(58, 18, 100)
+#define CAFFE2_VIDEO_HWACCEL 1
+extern "C" {
+#include <libavutil/hwcontext.h>
+}
+#endif
+
 namespace caffe2 {
 
+namespace {
+
+#ifdef CAFFE2_VIDEO_HWACCEL
+// Picks the pixel format of the hardware frames, kept in the opaque field of
+// the codec context, if the decoder offers it for the stream.
+AVPixelFormat getHardwareFormat(
+    AVCodecContext* codecContext,
+    const AVPixelFormat* formats) {
+  const auto hwFormat = static_cast<AVPixelFormat>(
+      reinterpret_cast<intptr_t>(codecContext->opaque));
+  for (auto format = formats; *format != AV_PIX_FMT_NONE; format++) {
+    if (*format == hwFormat) {
+      return *format;
+    }
+  }
+  LOG(WARNING) << "Hardware decoding unsupported for the stream, "
+               << "decoding in software";
+  return avcodec_default_get_format(codecContext, formats);
+}
+#endif
+
+// Sets the codec context up to decode on the hardware device named `name`,
+// returning the device, or nullptr to decode in software.
+AVBufferRef* initHardwareDecoding(
+    AVCodecContext* codecContext,
+    const AVCodec* codec,
+    const std::string& name) {
+#ifdef CAFFE2_VIDEO_HWACCEL
+  const auto type = av_hwdevice_find_type_by_name(name.c_str());
+  if (type == AV_HWDEVICE_TYPE_NONE) {
+    LOG(WARNING) << "Unknown hardware device " << name
+                 << ", decoding in software";
+    return nullptr;
+  }
+  AVPixelFormat hwFormat = AV_PIX_FMT_NONE;
+  for (int i = 0;; i++) {
+    const AVCodecHWConfig* config = avcodec_get_hw_config(codec, i);
+    if (config == nullptr) {
+      break;
+    }
+    if ((config->methods & AV_CODEC_HW_CONFIG_METHOD_HW_DEVICE_CTX) &&
+        config->device_type == type) {
+      hwFormat = config->pix_fmt;
+      break;
+    }
+  }
+  if (hwFormat == AV_PIX_FMT_NONE) {
+    LOG(WARNING) << "Decoder " << codec->name << " doesn't support " << name
+                 << ", decoding in software";
+    return nullptr;
+  }
+  AVBufferRef* device = nullptr;
+  const int ret = av_hwdevice_ctx_create(&device, type, nullptr, nullptr, 0);
+  if (ret < 0) {
+    LOG(WARNING) << "Unable to create hardware device " << name
+                 << ", decoding in software";
+    return nullptr;
+  }
+  codecContext->hw_device_ctx = av_buffer_ref(device);
+  codecContext->opaque =
+      reinterpret_cast<void*>(static_cast<intptr_t>(hwFormat));
+  codecContext->get_format = getHardwareFormat;
+  return device;
+#else
+  LOG(WARNING) << "Hardware decoding requires FFmpeg 4.0 or later, "
+               << "decoding in software";
+  return nullptr;
+#endif
+}
+
+} // namespace
+
 VideoDecoder::VideoDecoder() {
   static bool gInitialized = false;
   static std::mutex gMutex;
@@ -136,6 +217,9 @@ void VideoDecoder::decodeLoop(
   AVPacket packet;
   av_init_packet(&packet); // init packet
   SwsContext* scaleContext_ = nullptr;
+  // Device of the hardware decoder and host copy of its frames, if any
+  AVBufferRef* hwDevice = nullptr;
+  AVFrame* hwTransferFrame = nullptr;
 
   try {
     inputContext->pb = ioctx.get_avio();
@@ -208,11 +292,21 @@ void VideoDecoder::decodeLoop(
     // Initialize codec
     AVDictionary* opts = nullptr;
     videoCodecContext_ = videoStream_->codec;
+    AVCodec* videoCodec = avcodec_find_decoder(videoCodecContext_->codec_id);
+    if (videoCodec == nullptr) {
+      LOG(ERROR) << "Unable to find a decoder for " << videoName;
+      return;
+    }
+    if (params.decoderThreads_ != 1) {
+      videoCodecContext_->thread_count = params.decoderThreads_;
+      videoCodecContext_->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+    }
+    if (!params.hwAccel_.empty()) {
+      hwDevice = initHardwareDecoding(
+          videoCodecContext_, videoCodec, params.hwAccel_);
+    }
     try {
-      ret = avcodec_open2(
-          videoCodecContext_,
-          avcodec_find_decoder(videoCodecContext_->codec_id),
-          &opts);
+      ret = avcodec_open2(videoCodecContext_, videoCodec, &opts);
     } catch (const std::exception&) {
       LOG(ERROR) << "Exception during open video codec";
       return;
@@ -359,6 +453,9 @@ void VideoDecoder::decodeLoop(
     // These will be reused across calls.
     videoStreamFrame_ = av_frame_alloc();
     audioStreamFrame_ = av_frame_alloc();
+    if (hwDevice != nullptr) {
+      hwTransferFrame = av_frame_alloc();
+    }
 
     // frame index in video stream
     int frameIndex = -1;
@@ -488,6 +585,13 @@ void VideoDecoder::decodeLoop(
           }
         }
 
+        // Only the frames from start_ts on are sampled. Those before it are
+        // still decoded for the frames referring to them, which frames that
+        // aren't references never are, so the decoder can skip them.
+        videoCodecContext_->skip_frame = !mustDecodeAll &&
+                packet.pts != AV_NOPTS_VALUE && packet.pts < start_ts
+            ? AVDISCARD_NONREF
+            : AVDISCARD_DEFAULT;
         ret = avcodec_decode_video2(
             videoCodecContext_, videoStreamFrame_, &gotPicture, &packet);
         if (ret < 0) {
@@ -594,12 +698,48 @@ void VideoDecoder::decodeLoop(
                   outWidth,
                   outHeight);
 
+              // Frames of a hardware decoder are copied to host memory first
+              AVFrame* srcFrame = videoStreamFrame_;
+#ifdef CAFFE2_VIDEO_HWACCEL
+              if (videoStreamFrame_->hw_frames_ctx != nullptr) {
+                av_frame_unref(hwTransferFrame);
+                ret = av_hwframe_transfer_data(
+                    hwTransferFrame, videoStreamFrame_, 0);
+                if (ret < 0) {
+                  LOG(ERROR) << "Error transferring hardware frame : "
+                             << ffmpegErrorStr(ret);
+                  av_frame_free(&rgbFrame);
+                  return;
+                }
+                srcFrame = hwTransferFrame;
+              }
+#endif
+              // The source format differs from the one of the codec for
+              // hardware frames, and the context is only recreated when the
+              // format or size change.
+              scaleContext_ = sws_getCachedContext(
+                  scaleContext_,
+                  srcFrame->width,
+                  srcFrame->height,
+                  static_cast<AVPixelFormat>(srcFrame->format),
+                  outWidth,
+                  outHeight,
+                  pixFormat,
+                  SWS_FAST_BILINEAR,
+                  nullptr,
+                  nullptr,
+                  nullptr);
+              if (scaleContext_ == nullptr) {
+                LOG(ERROR) << "Unable to scale a frame of " << videoName;
+                av_frame_free(&rgbFrame);
+                return;
+              }
               sws_scale(
                   scaleContext_,
-                  videoStreamFrame_->data,
-                  videoStreamFrame_->linesize,
+                  srcFrame->data,
+                  srcFrame->linesize,
                   0,
-                  videoCodecContext_->height,
+                  srcFrame->height,
                   rgbFrame->data,
                   rgbFrame->linesize);
 
@@ -641,7 +781,9 @@ void VideoDecoder::decodeLoop(
     av_packet_unref(&packet);
     av_frame_free(&videoStreamFrame_);
     av_frame_free(&audioStreamFrame_);
+    av_frame_free(&hwTransferFrame);
     avcodec_close(videoCodecContext_);
+    av_buffer_unref(&hwDevice);
     if (audioCodecContext_ != nullptr) {
       avcodec_close(audioCodecContext_);
     }
@@ -655,7 +797,9 @@ void VideoDecoder::decodeLoop(
     av_packet_unref(&packet);
     av_frame_free(&videoStreamFrame_);
     av_frame_free(&audioStreamFrame_);
+    av_frame_free(&hwTransferFrame);
     avcodec_close(videoCodecContext_);
+    av_buffer_unref(&hwDevice);
     avcodec_close(audioCodecContext_);
     avformat_close_input(&inputContext);
     avformat_free_context(inputContext);
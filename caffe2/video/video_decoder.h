@@ -93,6 +93,17 @@ class Params {
   // -1 will automatically decode the first video stream.
   int streamIndex_ = -1;
 
+  // Threads of the FFmpeg decoder, decoding several frames or slices of a
+  // video at once. 0 lets FFmpeg pick from the number of cores, 1 decodes on
+  // the calling thread.
+  int decoderThreads_ = 1;
+
+  // Hardware device to decode on, as named by FFmpeg, e.g. "cuda" (NVDEC) or
+  // "vaapi"; empty to decode in software. Decoded frames are transferred back
+  // to host memory to be scaled. Decoding falls back to software when the
+  // device or the codec doesn't support it, or FFmpeg predates 4.0.
+  std::string hwAccel_;
+
   // How many frames to output at most from the video
   // -1 no limit
   int maximumOutputFrames_ = -1;
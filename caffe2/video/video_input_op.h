@@ -118,6 +118,11 @@ class VideoInputOp final : public PrefetchOperator<Context> {
   // thread pool for parse + decode
   int num_decode_threads_;
   std::shared_ptr<TaskThreadPool> thread_pool_;
+
+  // threads of the decoder of each video, and the hardware device to decode
+  // on if any, see Params
+  int decoder_threads_;
+  std::string hw_accel_;
 };
 
 template <class Context>
@@ -265,6 +270,14 @@ void VideoInputOp<Context>::CheckParamsAndPrint() {
     }
   }
 
+  CAFFE_ENFORCE_GE(
+      decoder_threads_, 0, "Number of decoder threads can't be negative.");
+  LOG(INFO) << "    Using " << decoder_threads_ << " decoder threads per video"
+            << (decoder_threads_ == 0 ? " (automatic)" : "");
+  if (!hw_accel_.empty()) {
+    LOG(INFO) << "    Decoding on hardware device " << hw_accel_;
+  }
+
   if (decode_type_ == DecodeType::DO_TMP_JITTER) {
     LOG(INFO) << "    Do temporal jittering";
   } else if (decode_type_ == DecodeType::USE_START_FRM) {
@@ -363,7 +376,12 @@ VideoInputOp<Context>::VideoInputOp(
       num_decode_threads_(OperatorBase::template GetSingleArgument<int>(
           "num_decode_threads",
           4)),
-      thread_pool_(std::make_shared<TaskThreadPool>(num_decode_threads_)) {
+      thread_pool_(std::make_shared<TaskThreadPool>(num_decode_threads_)),
+      decoder_threads_(
+          OperatorBase::template GetSingleArgument<int>("decoder_threads", 1)),
+      hw_accel_(OperatorBase::template GetSingleArgument<std::string>(
+          "hw_accel",
+          "")) {
   try {
     num_of_required_frame_ = 0;
 
@@ -692,6 +710,8 @@ bool VideoInputOp<Context>::GetClipsAndLabelsFromDBValue(
   params.outputHeight_ = scale_h_;
   params.decode_type_ = decode_type_;
   params.num_of_required_frame_ = num_of_required_frame_;
+  params.decoderThreads_ = decoder_threads_;
+  params.hwAccel_ = hw_accel_;
 
   if (jitter_scales_.size() > 0) {
     int select_idx =
@@ -184,6 +184,10 @@ find_library(CUDA_CUDA_LIB cuda
 find_library(CUDA_NVRTC_LIB nvrtc
     PATHS ${CUDA_TOOLKIT_ROOT_DIR}
     PATH_SUFFIXES lib lib64 lib/x64)
+# libnvjpeg.so only ships with CUDA 10 and above
+find_library(CUDA_NVJPEG_LIB nvjpeg
+    PATHS ${CUDA_TOOLKIT_ROOT_DIR}
+    PATH_SUFFIXES lib lib64 lib/x64)
 
 # Create new style imported libraries.
 # Several of these libraries have a hardcoded path if CAFFE2_STATIC_LINK_CUDA
@@ -301,6 +305,21 @@ set_property(
     TARGET caffe2::cufft PROPERTY INTERFACE_INCLUDE_DIRECTORIES
     ${CUDA_INCLUDE_DIRS})
 
+# nvjpeg, used by the image input operator to decode JPEGs on GPU
+if(CUDA_NVJPEG_LIB)
+  add_library(caffe2::nvjpeg UNKNOWN IMPORTED)
+  set_property(
+      TARGET caffe2::nvjpeg PROPERTY IMPORTED_LOCATION
+      ${CUDA_NVJPEG_LIB})
+  set_property(
+      TARGET caffe2::nvjpeg PROPERTY INTERFACE_INCLUDE_DIRECTORIES
+      ${CUDA_INCLUDE_DIRS})
+  set(CAFFE2_USE_NVJPEG ON)
+else()
+  message(STATUS "nvJPEG not found. Images will only be decoded on CPU.")
+  set(CAFFE2_USE_NVJPEG OFF)
+endif()
+
 # TensorRT
 if(CAFFE2_USE_TENSORRT)
   add_library(caffe2::tensorrt UNKNOWN IMPORTED)
@@ -328,6 +347,15 @@ else()
     set_property(
         TARGET caffe2::cublas PROPERTY INTERFACE_LINK_LIBRARIES
         ${CUDA_CUBLAS_LIBRARIES})
+    # ATen calls cuBLASLt directly from CUDA 11 (see ATen/cuda/CUDABlas.cpp)
+    if(CUDA_VERSION VERSION_GREATER_EQUAL 11.0)
+      find_library(CUDA_cublasLt_LIBRARY cublasLt
+          HINTS ${CUDA_TOOLKIT_ROOT_DIR}
+          PATH_SUFFIXES lib64 lib lib/x64)
+      set_property(
+        TARGET caffe2::cublas APPEND PROPERTY INTERFACE_LINK_LIBRARIES
+        ${CUDA_cublasLt_LIBRARY})
+    endif()
 endif()
 set_property(
     TARGET caffe2::cublas PROPERTY INTERFACE_INCLUDE_DIRECTORIES
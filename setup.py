@@ -153,6 +153,7 @@
 #       OMP - use OpenMP for intra-op and native backend for inter-op tasks
 #       NATIVE - use native thread pool for both intra- and inter-op tasks
 #       TBB - using TBB for intra- and native thread pool for inter-op parallelism
+#       NATIVE_WS - NATIVE, with work stealing between intra-op workers
 #
 #   USE_TBB
 #      enable TBB support
@@ -2,6 +2,9 @@
 
 #include <torch/torch.h>
 
+#include <torch/csrc/autograd/engine.h>
+#include <torch/csrc/autograd/saved_variable_hooks.h>
+
 #include <test/cpp/api/support.h>
 
 using namespace torch::autograd;
@@ -35,6 +38,54 @@ TEST(AutogradAPITests, BackwardSimpleTest) {
   ASSERT_VARIABLE_EQ(y.grad(), x + torch::ones({2, 2})*2);
 }
 
+TEST(AutogradAPITests, SavedVariableHooks) {
+  struct CountingHooks : public SavedVariableHooks {
+    struct Packed : public PackedSavedTensor {
+      Packed(at::Tensor data, int* unpacks)
+          : data_(std::move(data)), unpacks_(unpacks) {}
+      at::Tensor unpack() override {
+        ++*unpacks_;
+        return data_;
+      }
+      at::Tensor data_;
+      int* unpacks_;
+    };
+
+    std::unique_ptr<PackedSavedTensor> pack(const at::Tensor& data) override {
+      ++packs;
+      return std::make_unique<Packed>(data.clone(), &unpacks);
+    }
+
+    int packs = 0;
+    int unpacks = 0;
+  };
+
+  auto x = torch::randn({3, 3}, torch::requires_grad());
+  auto hooks = std::make_shared<CountingHooks>();
+  Variable y;
+  {
+    SavedVariableHooksGuard guard(hooks);
+    y = (x * x).sum();
+  }
+  ASSERT_EQ(hooks->packs, 2);
+  y.backward();
+  ASSERT_EQ(hooks->unpacks, 2);
+  ASSERT_VARIABLE_EQ(x.grad(), 2 * x);
+
+  // Floating point tensors are saved at half precision, masks as bits.
+  x = torch::randn({3, 3}, torch::requires_grad());
+  auto mask = torch::rand({13}) > 0.5;
+  auto z = torch::randn({13}, torch::requires_grad());
+  {
+    SavedVariableHooksGuard guard(
+        std::make_shared<CompressSavedVariableHooks>(at::kHalf));
+    y = (x * x).sum() + z.masked_fill(mask, 0).sum();
+  }
+  y.backward();
+  ASSERT_TRUE(torch::allclose(x.grad(), 2 * x, 1e-2, 1e-2));
+  ASSERT_VARIABLE_EQ(z.grad(), 1 - mask.to(torch::kFloat));
+}
+
 TEST(AutogradAPITests, BackwardTest) {
   Variable x = torch::randn({2, 2}, torch::requires_grad());
   Variable y = torch::randn({2, 2}, torch::requires_grad());
@@ -587,6 +638,85 @@ TEST(CustomAutogradTest, ReentrantPriority) {
   ASSERT_EQ(order.back(), 0);
 }
 
+TEST(CustomAutogradTest, NodeTaskPriority) {
+  std::vector<char> order;
+  auto a = torch::randn({2}, torch::requires_grad());
+  auto b = torch::randn({2}, torch::requires_grad());
+  a.register_hook([&](Variable grad) { order.push_back('a'); });
+  b.register_hook([&](Variable grad) { order.push_back('b'); });
+
+  // By default, the most recently created nodes run first.
+  ((a * 2).sum() + (b * 3).sum()).backward();
+  ASSERT_EQ(order, std::vector<char>({'b', 'a'}));
+
+  // The branch of a runs first if it has a higher priority.
+  order.clear();
+  auto sum_a = (a * 2).sum();
+  auto sum_b = (b * 3).sum();
+  std::unordered_set<const Node*> branch_a = {
+      sum_a.grad_fn().get(),
+      sum_a.grad_fn()->next_edges()[0].function.get(),
+      impl::grad_accumulator(a).get()};
+  auto& engine = Engine::get_default_engine();
+  engine.set_node_task_priority_fn([branch_a](const Node& node) -> int64_t {
+    return branch_a.count(&node);
+  });
+  (sum_a + sum_b).backward();
+  engine.set_node_task_priority_fn(nullptr);
+  ASSERT_EQ(order, std::vector<char>({'a', 'b'}));
+}
+
+TEST(CustomAutogradTest, MultithreadedCPUBackward) {
+  static std::mutex mutex;
+  static std::set<std::thread::id> thread_ids;
+
+  struct SlowIdentity : public Function<SlowIdentity> {
+    static Variable forward(AutogradContext*, Variable x) {
+      return x;
+    }
+
+    static variable_list backward(AutogradContext*, variable_list grad) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      std::lock_guard<std::mutex> lock(mutex);
+      thread_ids.insert(std::this_thread::get_id());
+      return grad;
+    }
+  };
+
+  struct Reenter : public Function<Reenter> {
+    static Variable forward(AutogradContext*, Variable x) {
+      return x;
+    }
+
+    static variable_list backward(AutogradContext*, variable_list grad) {
+      auto y = torch::ones({2}, torch::requires_grad());
+      (SlowIdentity::apply(y) * 2).sum().backward();
+      return {grad[0] * y.grad()};
+    }
+  };
+
+  auto& engine = Engine::get_default_engine();
+  engine.set_num_cpu_threads(4);
+  std::vector<Variable> leaves;
+  Variable loss = torch::zeros({});
+  for (int i = 0; i < 8; ++i) {
+    leaves.push_back(torch::randn({2}, torch::requires_grad()));
+    auto branch = SlowIdentity::apply(leaves.back() * (i + 1));
+    if (i == 0) {
+      branch = Reenter::apply(branch);
+    }
+    loss = loss + branch.sum();
+  }
+  loss.backward();
+  engine.set_num_cpu_threads(1);
+
+  ASSERT_VARIABLE_EQ(leaves[0].grad(), torch::full({2}, 2.));
+  for (int i = 1; i < 8; ++i) {
+    ASSERT_VARIABLE_EQ(leaves[i].grad(), torch::full({2}, i + 1.));
+  }
+  ASSERT_GT(thread_ids.size(), 1);
+}
+
 TEST(CustomAutogradTest, Hooks) {
   Variable x = torch::ones({5,5}, torch::requires_grad());
   Variable y = torch::ones({5,5})*4;
@@ -485,6 +485,30 @@ TEST(DataTest, StackTransformWorksForTensorExample) {
   ASSERT_TRUE(second.data.allclose(torch::eye(4).slice(/*dim=*/0, 2, 4)));
 }
 
+TEST(DataTest, StackTransformRecyclesPooledBuffers) {
+  auto pool = std::make_shared<transforms::BatchBufferPool>();
+  auto d = datasets::TensorDataset(torch::eye(4))
+               .map(transforms::Stack<TensorExample>(pool));
+
+  {
+    TensorExample batch = d.get_batch({0, 1});
+    ASSERT_TRUE(batch.data.allclose(torch::eye(4).slice(/*dim=*/0, 0, 2)));
+    ASSERT_EQ(pool->size(), 1);
+
+    // The first batch still uses its buffer.
+    TensorExample second = d.get_batch({2, 3});
+    ASSERT_TRUE(second.data.allclose(torch::eye(4).slice(/*dim=*/0, 2, 4)));
+    ASSERT_EQ(pool->size(), 2);
+  }
+
+  TensorExample third = d.get_batch({1, 2});
+  ASSERT_TRUE(third.data.allclose(torch::eye(4).slice(/*dim=*/0, 1, 3)));
+  // A smaller batch fits in a buffer of the pool as well.
+  TensorExample last = d.get_batch({3});
+  ASSERT_TRUE(last.data.allclose(torch::eye(4).slice(/*dim=*/0, 3, 4)));
+  ASSERT_EQ(pool->size(), 2);
+}
+
 // Template classes cannot be nested in functions.
 template <typename Target>
 struct T : transforms::TensorTransform<Target> {
@@ -688,6 +712,39 @@ TEST(DataTest, QueueClearEmptiesTheQueue) {
   ASSERT_THROWS_WITH(queue.pop(1 * kMillisecond), "Timeout");
 }
 
+TEST(DataTest, QueuePushBlocksWhileFullAndPopsFromManyThreads) {
+  torch::data::detail::Queue<int> queue(/*capacity=*/2);
+  const int kThreads = 4;
+  const int kValuesPerThread = 1000;
+  std::vector<std::thread> producers;
+  for (int t = 0; t < kThreads; ++t) {
+    producers.emplace_back([&queue] {
+      for (int i = 0; i < kValuesPerThread; ++i) {
+        queue.push(i);
+      }
+    });
+  }
+  std::vector<std::future<int64_t>> consumers;
+  for (int t = 0; t < kThreads; ++t) {
+    consumers.push_back(std::async(std::launch::async, [&queue] {
+      int64_t sum = 0;
+      for (int i = 0; i < kValuesPerThread; ++i) {
+        sum += queue.pop();
+      }
+      return sum;
+    }));
+  }
+  int64_t sum = 0;
+  for (auto& consumer : consumers) {
+    sum += consumer.get();
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  ASSERT_EQ(sum, kThreads * kValuesPerThread * (kValuesPerThread - 1) / 2);
+  ASSERT_EQ(queue.clear(), 0);
+}
+
 TEST(DataTest, DataShuttleCanPushAndPopJob) {
   torch::data::detail::DataShuttle<int, int> shuttle;
   shuttle.push_job(1);
@@ -1030,6 +1087,7 @@ TEST(DataLoaderTest, DataLoaderOptionsDefaultAsExpected) {
   ASSERT_EQ(full_options.max_jobs, 0);
   ASSERT_FALSE(full_options.timeout.has_value());
   ASSERT_TRUE(full_options.enforce_ordering);
+  ASSERT_FALSE(full_options.device.has_value());
 }
 
 TEST(DataLoaderTest, DataLoaderOptionsCoalesceOptionalValues) {
@@ -1767,6 +1825,61 @@ TEST(DataLoaderTest, ChunkDataSetWithEmptyBatch) {
   }
 }
 
+TEST(DataLoaderTest, ChunkDataSetKeepsIoDepthChunkReadsInFlight) {
+  struct AsyncChunkDataReader : DummyChunkDataReader {
+    std::future<BatchType> read_chunk_async(size_t chunk_index) override {
+      auto running = running_;
+      auto max_running = max_running_;
+      return std::async(std::launch::async, [=] {
+        const size_t now = ++*running;
+        size_t max = max_running->load();
+        while (now > max && !max_running->compare_exchange_weak(max, now)) {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        --*running;
+        return this->read_chunk(chunk_index);
+      });
+    }
+
+    std::shared_ptr<std::atomic<size_t>> running_ =
+        std::make_shared<std::atomic<size_t>>(0);
+    std::shared_ptr<std::atomic<size_t>> max_running_ =
+        std::make_shared<std::atomic<size_t>>(0);
+  };
+
+  const size_t batch_size = 5;
+  AsyncChunkDataReader data_reader;
+  auto max_running = data_reader.max_running_;
+  samplers::SequentialSampler sampler(0);
+  datasets::SharedBatchDataset<datasets::ChunkDataset<
+      AsyncChunkDataReader,
+      samplers::SequentialSampler,
+      samplers::SequentialSampler>>
+      dataset = datasets::make_shared_dataset<datasets::ChunkDataset<
+          AsyncChunkDataReader,
+          samplers::SequentialSampler,
+          samplers::SequentialSampler>>(
+          data_reader,
+          sampler,
+          sampler,
+          datasets::ChunkDatasetOptions(/*preloader_count=*/1, batch_size)
+              .io_depth(3));
+
+  auto data_loader = torch::data::make_data_loader(
+      dataset, DataLoaderOptions(batch_size).workers(0));
+
+  std::vector<int> examples;
+  for (auto iterator = data_loader->begin(); iterator != data_loader->end();
+       ++iterator) {
+    examples.insert(examples.end(), iterator->begin(), iterator->end());
+  }
+  std::vector<int> expected(35);
+  std::iota(expected.begin(), expected.end(), 0);
+  ASSERT_EQ(examples, expected);
+  // A single preloader read the three chunks concurrently.
+  ASSERT_GT(max_running->load(), 1);
+}
+
 TEST(DataLoaderTest, ChunkDataSetGetBatchWithUnevenBatchSize) {
   struct D : public datasets::ChunkDataReader<int> {
    public:
@@ -2302,4 +2415,72 @@ TEST(DataLoaderTest, CustomPreprocessPolicy) {
       }
     }
   }
-}
\ No newline at end of file
+}
+struct IndexTensorDataset
+    : datasets::Dataset<IndexTensorDataset, Example<>> {
+  Example<> get(size_t index) override {
+    const auto value = static_cast<double>(index);
+    // A non-contiguous data tensor, and targets of another dtype
+    return {torch::full({5, 3}, value).t(),
+            torch::full({2}, static_cast<int64_t>(index), torch::kLong)};
+  }
+
+  torch::optional<size_t> size() const override {
+    return 64;
+  }
+};
+
+TEST(DataLoaderTest, CopiesBatchesToDevice_CUDA) {
+  for (size_t workers : {0, 2}) {
+    auto data_loader = torch::data::make_data_loader(
+        IndexTensorDataset(),
+        samplers::SequentialSampler(64),
+        DataLoaderOptions(8).workers(workers).device(torch::kCUDA));
+    size_t index = 0;
+    for (auto& batch : *data_loader) {
+      ASSERT_EQ(batch.size(), 8);
+      for (auto& example : batch) {
+        ASSERT_TRUE(example.data.is_cuda());
+        ASSERT_TRUE(example.target.is_cuda());
+        ASSERT_EQ(example.target.dtype(), torch::kLong);
+        ASSERT_TRUE(example.data.cpu().equal(
+            torch::full({3, 5}, static_cast<double>(index))));
+        ASSERT_TRUE(example.target.cpu().equal(
+            torch::full({2}, static_cast<int64_t>(index), torch::kLong)));
+        ++index;
+      }
+    }
+    ASSERT_EQ(index, 64);
+  }
+}
+
+TEST(DataLoaderTest, PrefetchesNextBatchToDeviceWithoutWorkers_CUDA) {
+  struct D : datasets::BatchDataset<D, Example<>> {
+    explicit D(std::shared_ptr<std::atomic<size_t>> loaded)
+        : loaded(std::move(loaded)) {}
+    Example<> get_batch(torch::ArrayRef<size_t> indices) override {
+      ++*loaded;
+      return {torch::ones({static_cast<int64_t>(indices.size()), 4}),
+              torch::zeros({static_cast<int64_t>(indices.size())})};
+    }
+    torch::optional<size_t> size() const override {
+      return 32;
+    }
+    std::shared_ptr<std::atomic<size_t>> loaded;
+  };
+
+  auto loaded = std::make_shared<std::atomic<size_t>>(0);
+  auto data_loader = torch::data::make_data_loader(
+      D(loaded),
+      samplers::SequentialSampler(32),
+      DataLoaderOptions(8).device(torch::kCUDA));
+  size_t batches = 0;
+  for (auto& batch : *data_loader) {
+    ++batches;
+    ASSERT_TRUE(batch.data.is_cuda());
+    ASSERT_TRUE(batch.data.cpu().equal(torch::ones({8, 4})));
+    // The next batch was loaded before this one was handed out.
+    ASSERT_EQ(loaded->load(), std::min<size_t>(batches + 1, 4));
+  }
+  ASSERT_EQ(batches, 4);
+}
@@ -71,6 +71,53 @@ TEST_F(ModuleTest, ZeroGradWithUndefined) {
   ASSERT_EQ(module.x.grad().sum().item<float>(), 0);
 }
 
+TEST_F(ModuleTest, CoalesceParametersMovesParametersAndGradsIntoFlatBuffers) {
+  torch::manual_seed(0);
+  Sequential module(Linear(3, 4), Linear(4, 2));
+  module->parameters()[0].sum().backward();
+  std::vector<torch::Tensor> values;
+  for (const auto& parameter : module->parameters()) {
+    values.push_back(parameter.clone());
+  }
+  auto weight_grad = module->parameters()[0].grad().clone();
+
+  auto buffers = module->coalesce_parameters();
+  ASSERT_EQ(buffers.size(), 1);
+  const auto& buffer = buffers.front();
+  ASSERT_EQ(buffer.data.numel(), 3 * 4 + 4 + 4 * 2 + 2);
+  ASSERT_EQ(buffer.grad.numel(), buffer.data.numel());
+  ASSERT_EQ(buffer.parameters.size(), 4);
+
+  const auto parameters = module->parameters();
+  int64_t offset = 0;
+  for (size_t i = 0; i < parameters.size(); ++i) {
+    ASSERT_TRUE(parameters[i].requires_grad());
+    ASSERT_TRUE(parameters[i].allclose(values[i]));
+    ASSERT_EQ(
+        parameters[i].data_ptr<float>(),
+        buffer.data.data_ptr<float>() + offset);
+    ASSERT_EQ(
+        parameters[i].grad().data_ptr<float>(),
+        buffer.grad.data_ptr<float>() + offset);
+    offset += parameters[i].numel();
+  }
+  ASSERT_TRUE(parameters[0].grad().allclose(weight_grad));
+  ASSERT_EQ(parameters[1].grad().sum().item<float>(), 0);
+
+  module->zero_grad();
+  ASSERT_EQ(buffer.grad.sum().item<float>(), 0);
+  module->forward(torch::ones({5, 3})).sum().backward();
+  ASSERT_TRUE(buffer.grad.narrow(0, 0, 12).allclose(
+      parameters[0].grad().flatten()));
+  ASSERT_NE(buffer.grad.abs().sum().item<float>(), 0);
+
+  {
+    torch::NoGradGuard guard;
+    buffer.data.fill_(1);
+  }
+  ASSERT_EQ(parameters[2].sum().item<float>(), parameters[2].numel());
+}
+
 TEST_F(ModuleTest, RegisterModuleThrowsForEmptyOrDottedName) {
   struct TestModel : public torch::nn::Module {};
   ASSERT_THROWS_WITH(
@@ -519,6 +566,46 @@ TEST_F(ModuleTest, CloneCopiesTheValuesOfVariablesOfSubmodules) {
   ASSERT_EQ(b->module->value, a->module->value);
 }
 
+TEST_F(ModuleTest, CloneSharingParametersSharesParametersButNotBuffers) {
+  Sequential a(Linear(3, 4), BatchNorm1d(4));
+  auto b = std::dynamic_pointer_cast<SequentialImpl>(
+      a->clone_sharing_parameters());
+  ASSERT_NE(b, nullptr);
+
+  const auto a_parameters = a->named_parameters();
+  const auto b_parameters = b->named_parameters();
+  ASSERT_EQ(a_parameters.size(), b_parameters.size());
+  for (const auto& parameter : a_parameters) {
+    const auto& other = b_parameters[parameter.key()];
+    ASSERT_FALSE(pointer_equal(other, parameter.value()));
+    ASSERT_EQ(other.data_ptr(), parameter->data_ptr());
+    ASSERT_TRUE(other.requires_grad());
+  }
+  const auto a_buffers = a->named_buffers();
+  const auto b_buffers = b->named_buffers();
+  ASSERT_EQ(a_buffers.size(), b_buffers.size());
+  for (const auto& buffer : a_buffers) {
+    ASSERT_NE(b_buffers[buffer.key()].data_ptr(), buffer->data_ptr());
+  }
+
+  // The running statistics of the copy are its own.
+  b->forward(torch::randn({8, 3}));
+  ASSERT_TRUE(a_buffers["1.running_mean"].equal(torch::zeros(4)));
+  ASSERT_FALSE(b_buffers["1.running_mean"].equal(torch::zeros(4)));
+
+  // Updates of the weights reach both modules.
+  {
+    torch::NoGradGuard no_grad;
+    a_parameters["0.weight"].fill_(2);
+  }
+  ASSERT_TRUE(b_parameters["0.weight"].equal(a_parameters["0.weight"]));
+
+  // A plain clone() still copies them.
+  auto c = a->clone();
+  ASSERT_NE(c->named_parameters()["0.weight"].data_ptr(),
+            a_parameters["0.weight"].data_ptr());
+}
+
 TEST_F(ModuleTest, CloneToDevicePreservesTheDeviceOfParameters_CUDA) {
   struct TestModule : public Cloneable<TestModule> {
     TestModule() {
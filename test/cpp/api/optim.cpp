@@ -409,6 +409,55 @@ TEST(OptimTest, ExternalVectorOfParameters) {
   ASSERT_TRUE(parameters[2].allclose(original_parameters[2] - 1.0));
 }
 
+template <typename OptimizerClass, typename Options>
+void check_sparse_matches_dense(Options options) {
+  torch::manual_seed(0);
+  // rows 1 and 5 are used twice, rows 0 and 7 not at all
+  const auto indices = torch::tensor({3, 1, 5, 1, 2, 5, 6, 4}, torch::kLong);
+  std::vector<torch::Tensor> sparse_params = {torch::randn({8, 20})};
+  std::vector<torch::Tensor> dense_params = {sparse_params[0].clone()};
+  OptimizerClass sparse_optimizer(sparse_params, options);
+  OptimizerClass dense_optimizer(dense_params, options);
+
+  for (int step = 0; step < 3; step++) {
+    const auto values = torch::randn({indices.size(0), 20});
+    const auto grad =
+        torch::sparse_coo_tensor(indices.unsqueeze(0), values, {8, 20});
+    sparse_params[0].grad() = grad;
+    dense_params[0].grad() = grad.to_dense();
+    sparse_optimizer.step();
+    dense_optimizer.step();
+    ASSERT_TRUE(sparse_params[0].allclose(dense_params[0], 1e-5, 1e-6));
+  }
+}
+
+TEST(OptimTest, SparseGradientMatchesDense_Adagrad) {
+  check_sparse_matches_dense<Adagrad>(AdagradOptions(0.1).lr_decay(1e-2));
+}
+
+TEST(OptimTest, SparseGradientMatchesDense_SGD) {
+  check_sparse_matches_dense<SGD>(SGDOptions(0.1));
+}
+
+TEST(OptimTest, FusedSparseRowwiseAdagrad) {
+  torch::manual_seed(0);
+  const auto indices = torch::tensor({2, 0, 2}, torch::kLong);
+  const auto values = torch::randn({3, 4});
+  auto weight = torch::randn({3, 4});
+  auto state_sum = torch::zeros({3});
+  const auto expected_weight = weight.clone();
+  const auto expected_state_sum = state_sum.clone();
+
+  at::_fused_sparse_adagrad_(weight, state_sum, indices, values, 0.5, 1e-10);
+
+  const auto grad = torch::zeros({3, 4}).index_add_(0, indices, values);
+  expected_state_sum.add_(grad.pow(2).mean(1));
+  expected_weight.sub_(
+      0.5 * grad / (expected_state_sum.sqrt() + 1e-10).unsqueeze(1));
+  ASSERT_TRUE(state_sum.allclose(expected_state_sum));
+  ASSERT_TRUE(weight.allclose(expected_weight));
+}
+
 TEST(OptimTest, AddParameter_LBFGS) {
   torch::manual_seed(0);
 
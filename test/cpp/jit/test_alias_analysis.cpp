@@ -3,6 +3,7 @@
 #include "test/cpp/jit/test_base.h"
 #include "torch/csrc/jit/frontend/ir_emitter.h"
 #include "torch/csrc/jit/ir/alias_analysis.h"
+#include "torch/csrc/jit/passes/common_subexpression_elimination.h"
 #include "torch/csrc/jit/runtime/custom_operator.h"
 #include "torch/csrc/utils/memory.h"
 
@@ -1149,6 +1150,45 @@ void testMemoryDAG() {
   }
 }
 
+void testAliasAnalysisLargeGraph() {
+  // A chain of views too long to be walked recursively
+  constexpr int64_t kChainLength = 200000;
+  {
+    auto graph = std::make_shared<Graph>();
+    auto input = graph->addInput();
+    auto fresh = graph->insert(aten::neg, {input});
+    Value* view = fresh;
+    for (int64_t i = 0; i < kChainLength; i++) {
+      view = graph->insert(aten::t, {view});
+    }
+    auto list =
+        graph->insertNode(graph->createList(TensorType::get(), {view}))
+            ->output();
+    graph->registerOutput(list);
+
+    AliasDb aliasDb(graph);
+    ASSERT_TRUE(aliasDb.mayAlias(view, fresh));
+    ASSERT_FALSE(aliasDb.mayAlias(view, input));
+    ASSERT_TRUE(aliasDb.mayContainAlias(list, fresh));
+    ASSERT_FALSE(aliasDb.mayContainAlias(list, input));
+  }
+  {
+    // One node in three is a duplicate, for CSE to remove
+    auto graph = std::make_shared<Graph>();
+    Value* value = graph->addInput();
+    for (int64_t i = 0; i < kChainLength / 2; i++) {
+      auto a = graph->insert(aten::neg, {value});
+      auto b = graph->insert(aten::neg, {value});
+      value = graph->insert(aten::mul, {a, b});
+    }
+    graph->registerOutput(value);
+
+    EliminateCommonSubexpression(graph);
+    const auto nodes = graph->nodes();
+    ASSERT_EQ(std::distance(nodes.begin(), nodes.end()), kChainLength);
+  }
+}
+
 void testAliasRegistration() {
   {
     auto registry = torch::RegisterOperators().op(
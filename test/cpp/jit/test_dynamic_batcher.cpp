@@ -0,0 +1,58 @@
+#include <test/cpp/jit/test_base.h>
+
+#include <torch/csrc/jit/api/dynamic_batcher.h>
+#include <torch/torch.h>
+
+#include <thread>
+
+namespace torch {
+namespace jit {
+
+void testDynamicBatcher() {
+  Module m("m");
+  m.define(R"(
+    def forward(self, x):
+        # every row learns the size of the batch it ran in
+        return x * 2 + x.size(0)
+  )");
+
+  {
+    // The batch fills up long before the deadline.
+    DynamicBatcherOptions options;
+    options.max_batch_size = 4;
+    options.max_delay = std::chrono::seconds(60);
+    DynamicBatcher batcher(m, options);
+    std::vector<at::Tensor> results(4);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+      threads.emplace_back([&, i] {
+        auto x = torch::full({1, 3}, float(i));
+        results[i] = batcher.forward({x}).toTensor();
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+    for (int i = 0; i < 4; ++i) {
+      ASSERT_TRUE(results[i].equal(torch::full({1, 3}, float(2 * i + 4))));
+    }
+  }
+
+  {
+    // A lone request runs once its deadline passes; mismatched shapes are
+    // not batched together.
+    DynamicBatcherOptions options;
+    options.max_delay = std::chrono::milliseconds(1);
+    DynamicBatcher batcher(m, options);
+    auto a = batcher.forwardAsync({torch::zeros({2, 3})});
+    auto b = batcher.forwardAsync({torch::zeros({1, 5})});
+    a->wait();
+    b->wait();
+    ASSERT_TRUE(a->value().toTensor().equal(torch::full({2, 3}, 2.)));
+    ASSERT_TRUE(b->value().toTensor().equal(torch::full({1, 5}, 1.)));
+    ASSERT_ANY_THROW(batcher.forwardAsync({c10::IValue(1)}));
+  }
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,80 @@
+#include <test/cpp/jit/test_base.h>
+#include <test/cpp/jit/test_utils.h>
+
+#include <torch/csrc/autograd/grad_mode.h>
+#include <torch/csrc/jit/ir/irparser.h>
+#include <torch/csrc/jit/passes/fork_independent_subgraphs.h>
+#include <torch/csrc/jit/runtime/interpreter.h>
+#include <torch/csrc/jit/testing/file_check.h>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// two towers joined by a cat
+const auto towers_ir = R"IR(
+graph(%x : Tensor, %y : Tensor, %w : Tensor):
+  %one : int = prim::Constant[value=1]()
+  %a1 : Tensor = aten::mm(%x, %w)
+  %a2 : Tensor = aten::relu(%a1)
+  %a3 : Tensor = aten::mm(%a2, %w)
+  %a4 : Tensor = aten::relu(%a3)
+  %b1 : Tensor = aten::mm(%y, %w)
+  %b2 : Tensor = aten::tanh(%b1)
+  %b3 : Tensor = aten::mm(%b2, %w)
+  %b4 : Tensor = aten::tanh(%b3)
+  %l : Tensor[] = prim::ListConstruct(%a4, %b4, %a2)
+  %r : Tensor = aten::cat(%l, %one)
+  return (%r))IR";
+
+std::shared_ptr<Graph> parseTowers() {
+  auto graph = std::make_shared<Graph>();
+  parseIR(towers_ir, graph.get());
+  return graph;
+}
+
+at::Tensor runGraph(const std::shared_ptr<Graph>& graph) {
+  torch::autograd::AutoGradMode no_grad(false);
+  Code code(graph, "");
+  Stack stack = {at::arange(16, at::kFloat).view({4, 4}),
+                 at::ones({4, 4}),
+                 at::eye(4) * 0.5};
+  InterpreterState(code).run(stack);
+  return stack.at(0).toTensor();
+}
+
+} // namespace
+
+void testForkIndependentSubgraphs() {
+  // the first tower is forked, with both of its used values as results
+  auto graph = parseTowers();
+  ASSERT_TRUE(ForkIndependentSubgraphs(graph, /*min_cost=*/4));
+  testing::FileCheck()
+      .check_count("prim::fork", 1, /*exactly=*/true)
+      ->check("aten::tanh")
+      ->check("aten::wait")
+      ->check("prim::TupleUnpack")
+      ->check("aten::cat")
+      ->run(*graph);
+  ASSERT_TRUE(runGraph(graph).equal(runGraph(parseTowers())));
+
+  // towers cheaper than the scheduling overhead run inline
+  graph = parseTowers();
+  ASSERT_FALSE(ForkIndependentSubgraphs(graph, /*min_cost=*/5));
+
+  // mutation is not reordered
+  graph = std::make_shared<Graph>();
+  parseIR(
+      R"IR(
+graph(%x : Tensor, %y : Tensor):
+  %a : Tensor = aten::relu(%x)
+  %b : Tensor = aten::relu_(%y)
+  %r : Tensor = aten::mul(%a, %b)
+  return (%r))IR",
+      graph.get());
+  ASSERT_FALSE(ForkIndependentSubgraphs(graph, /*min_cost=*/1));
+}
+
+} // namespace jit
+} // namespace torch
@@ -5,6 +5,7 @@
 #include "torch/csrc/autograd/generated/variable_factories.h"
 #include "torch/csrc/autograd/variable.h"
 #include "torch/csrc/jit/codegen/fuser/interface.h"
+#include "torch/csrc/jit/codegen/fuser/kernel_spec.h"
 #include "torch/csrc/jit/frontend/code_template.h"
 #include "torch/csrc/jit/frontend/tracer.h"
 #include "torch/csrc/jit/ir/alias_analysis.h"
@@ -201,6 +202,42 @@ void testFusionAliasing() {
       ->run(*g);
 }
 
+void testFusionHorizontal() {
+  // Independent chains over the same inputs are packed into one group
+  const auto graph_string = R"IR(
+    graph(%0 : Tensor,
+          %1 : Tensor):
+      %2 : Tensor = aten::sigmoid(%0)
+      %3 : Tensor = aten::mul(%2, %1)
+      %4 : Tensor = aten::tanh(%0)
+      %5 : Tensor = aten::mul(%4, %1)
+      return (%3, %5))IR";
+  auto g = std::make_shared<Graph>();
+  torch::jit::parseIR(graph_string, g.get());
+  FuseGraph(g);
+  testing::FileCheck()
+      .check("prim::FusionGroup_0")
+      ->check_not("prim::FusionGroup_1")
+      ->run(*g);
+
+  // Chains over different inputs of different sizes are not
+  const auto different_sizes_string = R"IR(
+    graph(%0 : Float(2, 3),
+          %1 : Float(4, 3)):
+      %2 : Float(2, 3) = aten::sigmoid(%0)
+      %3 : Float(2, 3) = aten::mul(%2, %0)
+      %4 : Float(4, 3) = aten::tanh(%1)
+      %5 : Float(4, 3) = aten::mul(%4, %1)
+      return (%3, %5))IR";
+  auto g2 = std::make_shared<Graph>();
+  torch::jit::parseIR(different_sizes_string, g2.get());
+  FuseGraph(g2);
+  testing::FileCheck()
+      .check("prim::FusionGroup_0")
+      ->check("prim::FusionGroup_1")
+      ->run(*g2);
+}
+
 void testRegisterFusionCachesKernel() {
   // Constructs two functionally equivalent graphs
   const auto graph0_string = R"IR(
@@ -249,5 +286,40 @@ void testRegisterFusionCachesKernel() {
   // and therefore share a KernelSpec to share kernels for specializations
   ASSERT_EQ(second_key, expected_key);
 }
+
+void testFusionKernelCache() {
+  // The strides of dimensions of size 1 don't matter, so these share a kernel
+  auto contiguous = at::rand({4, 1, 5});
+  auto strided = at::rand({20}).as_strided({4, 1, 5}, {5, 7, 1});
+  ASSERT_EQ(fuser::TensorDesc(contiguous), fuser::TensorDesc(strided));
+  ASSERT_EQ(fuser::TensorDesc(strided).nDim(), 1);
+  auto transposed = at::rand({5, 4}).t().unsqueeze(1);
+  ASSERT_NE(fuser::TensorDesc(contiguous), fuser::TensorDesc(transposed));
+
+  const auto graph_string = R"IR(
+    graph(%0 : Tensor):
+      %1 : Tensor = aten::neg(%0)
+      return (%1))IR";
+  auto g = std::make_shared<Graph>();
+  torch::jit::parseIR(graph_string, g.get());
+  fuser::KernelSpec spec(0, g);
+
+  // Evicts the least recently used kernel when over the limit
+  const auto old_limit = maxCachedKernelsPerFusion();
+  overrideMaxCachedKernelsPerFusion(2);
+  fuser::ArgSpec float_spec({at::rand({3})}, kCPUDevice);
+  fuser::ArgSpec double_spec({at::rand({3}, at::kDouble)}, kCPUDevice);
+  fuser::ArgSpec long_spec({at::zeros({3}, at::kLong)}, kCPUDevice);
+  spec.cacheKernel(float_spec, nullptr);
+  spec.cacheKernel(double_spec, nullptr);
+  ASSERT_TRUE(spec.findKernel(float_spec));
+  spec.cacheKernel(long_spec, nullptr);
+  overrideMaxCachedKernelsPerFusion(old_limit);
+
+  ASSERT_EQ(spec.nCachedKernels(), 2);
+  ASSERT_TRUE(spec.findKernel(float_spec));
+  ASSERT_FALSE(spec.findKernel(double_spec));
+  ASSERT_TRUE(spec.findKernel(long_spec));
+}
 } // namespace jit
 } // namespace torch
@@ -1074,6 +1074,48 @@ void testGPU_FusionLoopUnroll() {
   TORCH_CHECK(output.equal(check));
 }
 
+void testGPU_FusionReduction() {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  // Set up your input tensor views
+  TensorView* tv0 = makeDummyTensor(2);
+  fusion.addInput(tv0);
+
+  // tv1[I0, R1] = tv0[I0, I1]
+  TensorView* tv1 = sum(tv0, {1});
+  fusion.addOutput(tv1);
+
+  TORCH_CHECK(fusion.origin(tv1)->getExprType() == ExprType::ReductionOp);
+
+  int numel_x = 65;
+  int numel_y = 1025;
+  int tidx = 128;
+
+  // tv1[I0, R1o, R1i{128}] = tv0[I0, I1]
+  tv1->split(1, tidx);
+
+  tv1->axis(0)->parallelize(ParallelType::BIDx);
+  tv1->axis(-1)->parallelize(ParallelType::TIDx);
+
+  torch::jit::fuser::cuda::CudaKernel prog;
+  prog.device_ = 0;
+  prog.grid(numel_x);
+  prog.block(tidx);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor input = at::rand({numel_x, numel_y}, options);
+  at::Tensor output = at::empty({numel_x}, options);
+  std::vector<at::Tensor> inputs{{input}};
+  std::vector<at::Tensor> outputs{{output}};
+
+  torch::jit::fuser::cuda::compileKernel(fusion, &prog);
+  torch::jit::fuser::cuda::runTestKernel(prog, inputs, outputs);
+
+  auto aten_output = input.sum({1});
+  TORCH_CHECK(aten_output.allclose(output));
+}
+
 } // namespace jit
 } // namespace torch
 #endif // #if defined(USE_CUDA)
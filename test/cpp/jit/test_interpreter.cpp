@@ -1,6 +1,8 @@
 #include "test/cpp/jit/test_base.h"
 #include "test/cpp/jit/test_utils.h"
 
+#include <torch/csrc/jit/ir/irparser.h>
+
 namespace torch {
 namespace jit {
 
@@ -27,5 +29,36 @@ void testInterp() {
   ASSERT_TRUE(exactlyEqual(outputs[0], hx));
   ASSERT_TRUE(exactlyEqual(outputs[1], cx));
 }
+
+void testInterpContainers() {
+  // Containers built by the interpreter, with the stack and the registers
+  // sized ahead from the previous runs of the same code
+  auto graph = std::make_shared<Graph>();
+  parseIR(
+      R"IR(
+graph(%a : Tensor, %b : Tensor):
+  %c : Tensor = aten::mul(%a, %b)
+  %t : (Tensor, Tensor, Tensor) = prim::TupleConstruct(%a, %b, %c)
+  %l : Tensor[] = prim::ListConstruct(%c, %b, %a)
+  return (%t, %l)
+)IR",
+      &*graph);
+  Code code(graph, "");
+  for (int i = 0; i < 3; ++i) {
+    auto a = at::randn({2, 3});
+    auto b = at::randn({2, 3});
+    Stack stack = {a, b};
+    InterpreterState(code).run(stack);
+    ASSERT_EQ(stack.size(), 2);
+    auto tuple = stack[0].toTuple();
+    ASSERT_EQ(tuple->elements().size(), 3);
+    ASSERT_TRUE(tuple->elements()[0].toTensor().equal(a));
+    ASSERT_TRUE(tuple->elements()[2].toTensor().equal(a * b));
+    auto list = stack[1].toTensorList();
+    ASSERT_EQ(list.size(), 3);
+    ASSERT_TRUE(list.get(0).equal(a * b));
+    ASSERT_TRUE(list.get(2).equal(a));
+  }
+}
 } // namespace jit
 } // namespace torch
@@ -1,9 +1,12 @@
 #include <c10/core/TensorOptions.h>
+#include <c10/util/tempfile.h>
+#include <caffe2/serialize/inline_container.h>
 #include <test/cpp/jit/test_base.h>
 #include <torch/csrc/autograd/generated/variable_factories.h>
 #include <torch/csrc/jit/api/module.h>
 #include <torch/csrc/jit/mobile/import.h>
 #include <torch/csrc/jit/mobile/module.h>
+#include <torch/csrc/jit/mobile/observer.h>
 #include <torch/csrc/jit/serialization/import.h>
 #include <torch/custom_class.h>
 #include <torch/torch.h>
@@ -101,6 +104,43 @@ void testLiteInterpreterConv() {
       outputref[0][0][0][0].item<int>() == output[0][0][0][0].item<int>());
 }
 
+void testLiteInterpreterQuantizedEmbeddingBag() {
+  auto prepack = c10::Dispatcher::singleton().findSchemaOrThrow(
+      "quantized::embedding_bag_byte_prepack", "");
+  Module m("m");
+  m.register_buffer(
+      "weight",
+      prepack.callUnboxed<at::Tensor, at::Tensor>(torch::randn({10, 16})));
+  m.define(R"(
+    def forward(self, indices, offsets, lengths):
+      by_offsets = torch.ops.quantized.embedding_bag_byte_rowwise_offsets(
+          self.weight, indices, offsets)
+      by_lengths = torch.ops.quantized.embedding_bag_byte_rowwise_lengths(
+          self.weight, indices, lengths, 1)
+      return by_offsets, by_lengths
+  )");
+
+  std::vector<IValue> inputs;
+  inputs.emplace_back(torch::tensor({1, 4, 9, 0, 3}, at::kLong));
+  inputs.emplace_back(torch::tensor({0, 2}, at::kLong));
+  inputs.emplace_back(torch::tensor({2, 3}, at::kLong));
+  auto ref = m.forward(inputs);
+
+  std::stringstream ss;
+  m._save_for_mobile(ss);
+  mobile::Module bc = _load_for_mobile(ss);
+  auto res = bc.forward(inputs);
+
+  auto res_elements = res.toTuple()->elements();
+  auto ref_elements = ref.toTuple()->elements();
+  AT_ASSERT(res_elements[0].toTensor().equal(ref_elements[0].toTensor()));
+  AT_ASSERT(res_elements[1].toTensor().equal(ref_elements[1].toTensor()));
+  // the sums of the bags divided by their lengths
+  AT_ASSERT(res_elements[1].toTensor().allclose(
+      res_elements[0].toTensor() /
+      torch::tensor({2.f, 3.f}).unsqueeze(1)));
+}
+
 void testLiteInterpreterInline() {
   Module m("m");
   m.define(R"JIT(
@@ -139,6 +179,83 @@ void testLiteInterpreterTuple() {
   AT_ASSERT(output.toTuple()->elements()[1].toInt() == 2);
 }
 
+void testLiteInterpreterFlatBytecode() {
+  Module m("m");
+  m.register_parameter("foo", torch::ones({2}), false);
+  m.define(R"(
+    def forward(self, x, n: int):
+      ys = []
+      for i in range(n):
+        if i % 2 == 0:
+          ys.append(self.foo * x + i)
+      return ys
+  )");
+  std::vector<IValue> inputs{torch::rand({2}), 5};
+  auto ref = m.forward(inputs).toTensorVector();
+
+  auto check = [&](mobile::Module& bc) {
+    auto res = bc.forward(inputs).toTensorVector();
+    AT_ASSERT(res.size() == ref.size());
+    for (size_t i = 0; i < ref.size(); ++i) {
+      AT_ASSERT(res[i].equal(ref[i]));
+    }
+  };
+
+  std::stringstream ss;
+  m._save_for_mobile(ss, ExtraFilesMap(), /*flat_bytecode=*/true);
+  {
+    caffe2::serialize::PyTorchStreamReader reader(&ss);
+    AT_ASSERT(reader.hasRecord("bytecode.flat"));
+    AT_ASSERT(!reader.hasRecord("bytecode.pkl"));
+  }
+  ss.seekg(0);
+  mobile::Module bc = _load_for_mobile(ss);
+  check(bc);
+
+  auto tempfile = c10::make_tempfile();
+  m._save_for_mobile(tempfile.name, ExtraFilesMap(), /*flat_bytecode=*/true);
+  mobile::Module mapped = _load_for_mobile_mmap(tempfile.name);
+  check(mapped);
+}
+
+void testLiteInterpreterOpLatency() {
+  Module m("m");
+  m.define(R"(
+    def forward(self, x):
+      return x + x * 2
+  )");
+  std::stringstream ss;
+  m._save_for_mobile(ss);
+  mobile::Module bc = _load_for_mobile(ss);
+  std::vector<IValue> inputs{torch::ones({4})};
+
+  // Nothing is collected until it is enabled
+  bc.forward(inputs);
+  AT_ASSERT(torch::observerConfig().getOpLatencyStats() == nullptr);
+
+  torch::observerConfig().setOpLatencyCollection(true);
+  auto stats = torch::observerConfig().getOpLatencyStats();
+  AT_ASSERT(stats != nullptr);
+  stats->reset();
+  for (int i = 0; i < 10; ++i) {
+    bc.forward(inputs);
+  }
+  torch::observerConfig().setOpLatencyCollection(false);
+  bc.forward(inputs);
+
+  auto summary = stats->summary();
+  AT_ASSERT(summary.size() == 2);
+  for (const auto& op : summary) {
+    AT_ASSERT(
+        op.op_name == "aten::add.Tensor" || op.op_name == "aten::mul.Scalar");
+    AT_ASSERT(op.count == 10);
+    AT_ASSERT(op.p50_ns <= op.p90_ns && op.p90_ns <= op.p99_ns);
+    AT_ASSERT(op.p99_ns <= op.max_ns && op.max_ns <= op.total_ns);
+  }
+  stats->reset();
+  AT_ASSERT(stats->summary().empty());
+}
+
 void testLiteInterpreterDict() {
   Module m("m");
   m.define(R"JIT(
@@ -0,0 +1,133 @@
+#include <test/cpp/jit/test_base.h>
+#include <test/cpp/jit/test_utils.h>
+
+#include <c10/core/CPUAllocator.h>
+#include <torch/csrc/autograd/grad_mode.h>
+#include <torch/csrc/jit/ir/irparser.h>
+#include <torch/csrc/jit/passes/memory_planning.h>
+#include <torch/csrc/jit/runtime/interpreter.h>
+#include <torch/csrc/jit/runtime/planned_memory.h>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+const auto chain_ir = R"IR(
+graph(%x : Float(4, 4)):
+  %one : int = prim::Constant[value=1]()
+  %a : Float(4, 4) = aten::mul(%x, %x)
+  %b : Float(4, 4) = aten::add(%a, %x, %one)
+  %c : Float(4, 4) = aten::mul(%b, %b)
+  %d : Float(4, 4) = aten::add(%c, %x, %one)
+  return (%d))IR";
+
+const MemoryPlan::Slab& slabOf(const MemoryPlan& plan, const Value* v) {
+  auto it = plan.node_slabs.find(v->node());
+  AT_ASSERT(it != plan.node_slabs.end() && it->second.size() == 1);
+  return it->second[0];
+}
+
+} // namespace
+
+void testMemoryPlanning() {
+  auto graph = std::make_shared<Graph>();
+  std::unordered_map<std::string, Value*> vmap;
+  parseIR(chain_ir, graph.get(), vmap);
+  auto plan = PlanStaticMemory(graph);
+  ASSERT_TRUE(plan);
+
+  // 16 floats each; %a and %c are never live at the same time.
+  const auto& a = slabOf(*plan, vmap["a"]);
+  const auto& b = slabOf(*plan, vmap["b"]);
+  const auto& c = slabOf(*plan, vmap["c"]);
+  ASSERT_EQ(a.size, 64);
+  ASSERT_EQ(a.offset, c.offset);
+  ASSERT_NE(a.offset, b.offset);
+  ASSERT_EQ(plan->arena_size, 128);
+  // the graph output must outlive the arena
+  ASSERT_EQ(plan->node_slabs.count(vmap["d"]->node()), 0);
+
+  // views share memory with their input and are not planned
+  auto view_graph = std::make_shared<Graph>();
+  vmap.clear();
+  parseIR(
+      R"IR(
+graph(%x : Float(4, 4)):
+  %zero : int = prim::Constant[value=0]()
+  %a : Float(4, 4) = aten::mul(%x, %x)
+  %v : Float(4) = aten::select(%a, %zero, %zero)
+  %b : Float(4) = aten::mul(%v, %v)
+  return (%b))IR",
+      view_graph.get(),
+      vmap);
+  plan = PlanStaticMemory(view_graph);
+  ASSERT_TRUE(plan);
+  ASSERT_EQ(plan->node_slabs.count(vmap["v"]->node()), 0);
+  ASSERT_EQ(slabOf(*plan, vmap["a"]).size, 64);
+
+  // nodes with an output that is not planned are not planned at all, as the
+  // allocator could not tell their outputs apart
+  auto sibling_graph = std::make_shared<Graph>();
+  vmap.clear();
+  parseIR(
+      R"IR(
+graph(%x : Float(4, 4)):
+  %zero : int = prim::Constant[value=0]()
+  %true : bool = prim::Constant[value=1]()
+  %false : bool = prim::Constant[value=0]()
+  %dims : int[] = prim::ListConstruct(%zero)
+  %a : Float(4, 4) = aten::mul(%x, %x)
+  %std : Float(4), %mean : Float(4) = aten::std_mean(%a, %dims, %true, %false)
+  %b : Float(4) = aten::mul(%std, %std)
+  return (%b, %mean))IR",
+      sibling_graph.get(),
+      vmap);
+  plan = PlanStaticMemory(sibling_graph);
+  ASSERT_TRUE(plan);
+  ASSERT_EQ(plan->node_slabs.count(vmap["std"]->node()), 0);
+  ASSERT_EQ(slabOf(*plan, vmap["a"]).size, 64);
+
+  // control flow is not planned
+  auto loop_graph = std::make_shared<Graph>();
+  parseIR(
+      R"IR(
+graph(%x : Float(4, 4), %n : int):
+  %true : bool = prim::Constant[value=1]()
+  %y : Tensor = prim::Loop(%n, %true, %x)
+    block0(%i : int, %acc : Tensor):
+      %z : Float(4, 4) = aten::mul(%acc, %acc)
+      -> (%true, %z)
+  return (%y))IR",
+      loop_graph.get());
+  ASSERT_FALSE(PlanStaticMemory(loop_graph));
+
+  // planned execution computes the same result, run after run
+  auto run_chain = [&](bool planned) {
+    auto g = std::make_shared<Graph>();
+    parseIR(chain_ir, g.get());
+    const bool old_mode = getStaticMemoryPlanningMode();
+    getStaticMemoryPlanningMode() = planned;
+    Code code(g, "");
+    getStaticMemoryPlanningMode() = old_mode;
+    torch::autograd::AutoGradMode no_grad(false);
+    std::vector<at::Tensor> results;
+    for (int i = 0; i < 3; ++i) {
+      Stack stack = {at::arange(16, at::kFloat).view({4, 4}) + i};
+      InterpreterState(code).run(stack);
+      results.push_back(stack.at(0).toTensor());
+    }
+    return results;
+  };
+  auto* cpu_allocator = c10::GetCPUAllocator();
+  auto expected = run_chain(false);
+  auto actual = run_chain(true);
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_TRUE(expected[i].equal(actual[i]));
+  }
+  // the planned allocator is only installed while a planned node runs
+  ASSERT_EQ(c10::GetCPUAllocator(), cpu_allocator);
+}
+
+} // namespace jit
+} // namespace torch
@@ -42,6 +42,7 @@
 #include "torch/csrc/jit/serialization/import.h"
 
 #include "torch/csrc/autograd/engine.h"
+#include "torch/csrc/autograd/sampling_profiler.h"
 #include "torch/csrc/autograd/variable.h"
 
 #include <torch/csrc/jit/testing/file_check.h>
@@ -54,12 +55,15 @@
 #include "onnx/onnx_pb.h"
 
 #include <c10/util/Exception.h>
+#include <c10/util/tempfile.h>
 
 #include <algorithm>
 #include <cstddef>
+#include <fstream>
 #include <functional>
 #include <iostream>
 #include <memory>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <tuple>
@@ -997,6 +1001,42 @@ void checkDebugInfo(at::DebugInfoKind kind, int model_id) {
   TORCH_CHECK(test_debug_info->getModelId() == model_id);
 }
 
+void testSamplingProfiler() {
+  using namespace torch::autograd::profiler;
+  auto tempfile = c10::make_tempfile();
+  SamplingProfilerConfig config;
+  config.trace_path = tempfile.name;
+  config.sampling_prob = 1.0;
+  config.buffer_size = 16;
+  // long enough that the buffer only gets drained when disabling
+  config.flush_interval = std::chrono::milliseconds(60 * 1000);
+
+  enableSamplingProfiler(config);
+  ASSERT_TRUE(samplingProfilerEnabled());
+  {
+    RECORD_USER_SCOPE("sampled_scope");
+  }
+  auto t = torch::ones({2});
+  for (int i = 0; i < 100; i++) {
+    t = t + 1;
+  }
+  const auto dropped = disableSamplingProfiler();
+  ASSERT_FALSE(samplingProfilerEnabled());
+  // only 16 events fit in the ring buffer
+  ASSERT_TRUE(dropped > 0);
+
+  std::ifstream in(tempfile.name);
+  std::stringstream trace;
+  trace << in.rdbuf();
+  const auto str = trace.str();
+  ASSERT_EQ(str.find("{\"traceEvents\": ["), 0);
+  ASSERT_NE(str.find("\"name\": \"sampled_scope\", \"cat\": \"user_scope\""),
+            std::string::npos);
+  ASSERT_NE(str.find("\"name\": \"aten::add\""), std::string::npos);
+  ASSERT_NE(str.find("\"ph\": \"X\""), std::string::npos);
+  ASSERT_NE(str.rfind("]}"), std::string::npos);
+}
+
 void testThreadLocalDebugInfo() {
   // enable observers
   c10::impl::IncludeDispatchKeyGuard observer_guard(c10::DispatchKey::Profiler);
@@ -1078,6 +1118,32 @@ void testThreadLocalDebugInfo() {
       }
     }
   }
+
+  // check that a state guard sets and restores the debug info, and leaves
+  // an already current state alone
+  at::ThreadLocalState state_with_info = [&]() {
+    at::DebugInfoGuard guard(at::DebugInfoKind::TEST_INFO, debug_info);
+    return at::ThreadLocalState();
+  }();
+  TORCH_CHECK(
+      at::ThreadLocalDebugInfo::get(at::DebugInfoKind::TEST_INFO) == nullptr);
+  TORCH_CHECK(at::ThreadLocalState::isCurrentThreadLocalState(
+      at::ThreadLocalState()));
+  TORCH_CHECK(!at::ThreadLocalState::isCurrentThreadLocalState(
+      state_with_info));
+  {
+    at::ThreadLocalStateGuard guard(state_with_info);
+    checkDebugInfo(at::DebugInfoKind::TEST_INFO, 42);
+    TORCH_CHECK(at::ThreadLocalState::isCurrentThreadLocalState(
+        state_with_info));
+    {
+      at::ThreadLocalStateGuard nested_guard(state_with_info);
+      checkDebugInfo(at::DebugInfoKind::TEST_INFO, 42);
+    }
+    checkDebugInfo(at::DebugInfoKind::TEST_INFO, 42);
+  }
+  TORCH_CHECK(
+      at::ThreadLocalDebugInfo::get(at::DebugInfoKind::TEST_INFO) == nullptr);
 }
 
 void testAutogradProfiler() {
@@ -208,5 +208,32 @@ void testModuleParameter() {
   ASSERT_TRUE(m.hasattr("none_param2"));
 }
 
+void testModuleWarmup() {
+  Module m("m");
+  m.register_parameter("foo", torch::ones({2}), false);
+  m.define(R"(
+    def add_it(self, x):
+      return self.foo + x
+    def mul_it(self, x):
+      return self.foo * x
+    def both(self, x):
+      return self.add_it(x) + self.mul_it(x)
+  )");
+
+  m.warmup({{"add_it", {torch::ones({2})}}, {"both", {torch::ones({2})}}});
+  // the plans for the example inputs are compiled before the first call
+  for (const std::string& name : {"add_it", "both"}) {
+    auto& fn = static_cast<GraphFunction&>(m.get_method(name).function());
+    ASSERT_EQ(fn.getDebugState().execution_plans.size(), 1);
+  }
+  ASSERT_TRUE(
+      m.run_method("both", torch::ones({2})).toTensor().equal(torch::full(
+          {2}, 3)));
+
+  ASSERT_THROWS_WITH(
+      m.warmup({{"missing", {torch::ones({2})}}}), "no method named");
+  ASSERT_ANY_THROW(m.warmup({{"add_it", {}}}));
+}
+
 } // namespace jit
 } // namespace torch
@@ -56,6 +56,27 @@ void testSaveExtraFilesHook() {
   }
 }
 
+void testSaveLoadManyTensors() {
+  Module m("m");
+  for (int i = 0; i < 32; ++i) {
+    m.register_parameter(
+        "p" + c10::guts::to_string(i), torch::randn({i + 1, 17}), false);
+  }
+  const std::string file_name = "save_load_many_tensors.pt";
+  m.save(file_name);
+
+  auto check = [&](const Module& loaded) {
+    for (int i = 0; i < 32; ++i) {
+      auto name = "p" + c10::guts::to_string(i);
+      ASSERT_TRUE(loaded.attr(name).toTensor().equal(m.attr(name).toTensor()));
+    }
+  };
+  // storages are read ahead of the unpickler on the intra-op pool
+  check(jit::load(file_name));
+  check(jit::load_mmap(file_name));
+  std::remove(file_name.c_str());
+}
+
 void testTypeTags() {
   auto list = c10::List<c10::List<int64_t>>();
   list.push_back(c10::List<int64_t>({1, 2, 3}));
@@ -0,0 +1,85 @@
+#include <test/cpp/jit/test_base.h>
+#include <test/cpp/jit/test_utils.h>
+
+#include <torch/csrc/jit/ir/irparser.h>
+#include <torch/csrc/jit/passes/shape_analysis.h>
+
+#include <sstream>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+const auto symbolic_ir = R"IR(
+graph(%x : Float(SS(-2), 4),
+      %w : Float(8, 4),
+      %y : Float(SS(-2), 8)):
+  %none : NoneType = prim::Constant()
+  %zero : int = prim::Constant[value=0]()
+  %one : int = prim::Constant[value=1]()
+  %minus_one : int = prim::Constant[value=-1]()
+  %true : bool = prim::Constant[value=1]()
+  %a : Tensor = aten::linear(%x, %w, %none)
+  %b : Tensor = aten::relu(%a)
+  %c : Tensor = aten::add(%b, %y, %one)
+  %u : Tensor = aten::unsqueeze(%c, %one)
+  %n : int = aten::size(%x, %zero)
+  %shape : int[] = prim::ListConstruct(%n, %minus_one)
+  %v : Tensor = aten::view(%u, %shape)
+  %tensors : Tensor[] = prim::ListConstruct(%v, %x)
+  %d : Tensor = aten::cat(%tensors, %one)
+  %t : Tensor = aten::t(%w)
+  %e : Tensor = aten::mm(%x, %t)
+  %f : Tensor = aten::argmax(%d, %zero, %true)
+  return (%d, %e, %f))IR";
+
+std::vector<c10::optional<c10::ShapeSymbol>> symbolicSizesOf(Value* v) {
+  auto sizes = v->type()->expect<TensorType>()->symbolic_sizes().sizes();
+  AT_ASSERT(sizes);
+  return *sizes;
+}
+
+} // namespace
+
+void testSymbolicShapePropagation() {
+  auto graph = std::make_shared<Graph>();
+  std::unordered_map<std::string, Value*> vmap;
+  parseIR(symbolic_ir, graph.get(), vmap);
+  PropagateInputShapes(graph);
+
+  // the dims of the same symbol in the IR are the same symbol
+  auto batch = symbolicSizesOf(vmap["x"])[0];
+  ASSERT_TRUE(batch && !batch->is_static());
+  ASSERT_TRUE(symbolicSizesOf(vmap["y"])[0] == batch);
+  ASSERT_FALSE(vmap["x"]->type()->expect<TensorType>()->isComplete());
+
+  const auto static_dim = [](int64_t size) {
+    return c10::optional<c10::ShapeSymbol>(
+        c10::ShapeSymbol::fromStaticSize(size));
+  };
+  for (const char* name : {"a", "b", "c", "v", "e"}) {
+    auto sizes = symbolicSizesOf(vmap[name]);
+    ASSERT_EQ(sizes.size(), 2);
+    ASSERT_TRUE(sizes[0] == batch);
+    ASSERT_TRUE(sizes[1] == static_dim(8));
+  }
+  auto u = symbolicSizesOf(vmap["u"]);
+  ASSERT_EQ(u.size(), 3);
+  ASSERT_TRUE(u[0] == batch && u[1] == static_dim(1) && u[2] == static_dim(8));
+  auto d = symbolicSizesOf(vmap["d"]);
+  ASSERT_EQ(d.size(), 2);
+  ASSERT_TRUE(d[0] == batch && d[1] == static_dim(12));
+  auto f = symbolicSizesOf(vmap["f"]);
+  ASSERT_EQ(f.size(), 2);
+  ASSERT_TRUE(f[0] == static_dim(1) && f[1] == static_dim(12));
+
+  // symbolic dims print as they are parsed
+  std::stringstream ss;
+  ss << *vmap["d"]->type();
+  ASSERT_EQ(ss.str().find("Float(SS("), 0);
+  ASSERT_NE(ss.str().find("), 12)"), std::string::npos);
+}
+
+} // namespace jit
+} // namespace torch
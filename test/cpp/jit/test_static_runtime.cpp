@@ -0,0 +1,72 @@
+#include <test/cpp/jit/test_base.h>
+#include <test/cpp/jit/test_utils.h>
+
+#include <torch/csrc/jit/ir/irparser.h>
+#include <torch/csrc/jit/runtime/static_runtime.h>
+#include <torch/torch.h>
+
+namespace torch {
+namespace jit {
+
+void testStaticRuntime() {
+  {
+    Module m("m");
+    m.register_parameter("weight", torch::randn({8, 4}), false);
+    m.register_parameter("bias", torch::randn({8}), false);
+    m.define(R"(
+      def forward(self, x):
+          y = torch.addmm(self.bias, x, self.weight.t())
+          z = torch.relu(y) * torch.sigmoid(y) + y
+          return torch.tanh(z).sum(1)
+    )");
+    m.eval();
+    StaticRuntime runtime(m);
+    // addmm, relu, sigmoid, mul, add and tanh
+    ASSERT_EQ(runtime.num_unboxed_nodes(), 6);
+    torch::NoGradGuard no_grad;
+    for (int i = 0; i < 3; ++i) {
+      // intermediates are reused across runs, even if the shapes change
+      auto x = torch::randn({i + 2, 4});
+      auto expected = m.forward({x}).toTensor();
+      auto actual = runtime.run({x}).toTensor();
+      ASSERT_TRUE(expected.allclose(actual));
+    }
+  }
+  {
+    // outputs are never overwritten by the next run, even through a view
+    auto graph = std::make_shared<Graph>();
+    parseIR(
+        R"IR(
+graph(%x : Tensor, %y : Tensor):
+  %zero : int = prim::Constant[value=0]()
+  %a : Tensor = aten::mul(%x, %y)
+  %b : Tensor = aten::select(%a, %zero, %zero)
+  %c : Tensor = aten::mul(%a, %a)
+  %out : (Tensor, Tensor) = prim::TupleConstruct(%b, %c)
+  return (%out))IR",
+        graph.get());
+    StaticRuntime runtime(graph);
+    auto first = runtime.run({torch::ones({2, 2}), torch::ones({2, 2})});
+    auto b = first.toTuple()->elements()[0].toTensor().clone();
+    runtime.run({torch::zeros({2, 2}), torch::zeros({2, 2})});
+    ASSERT_TRUE(b.equal(first.toTuple()->elements()[0].toTensor()));
+  }
+  {
+    // control flow is rejected
+    auto graph = std::make_shared<Graph>();
+    parseIR(
+        R"IR(
+graph(%x : Tensor, %c : bool):
+  %y : Tensor = prim::If(%c)
+    block0():
+      -> (%x)
+    block1():
+      -> (%x)
+  return (%y))IR",
+        graph.get());
+    ASSERT_THROWS_WITH(StaticRuntime{graph}, "control flow");
+  }
+}
+
+} // namespace jit
+} // namespace torch
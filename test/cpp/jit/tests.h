@@ -29,6 +29,7 @@ namespace jit {
   _(PassManagement)                    \
   _(Proto)                             \
   _(RegisterFusionCachesKernel)        \
+  _(FusionKernelCache)                 \
   _(SchemaParser)                      \
   _(TopologicalIndex)                  \
   _(TopologicalMove)                   \
@@ -39,6 +40,10 @@ namespace jit {
   _(WriteTracking)                     \
   _(Wildcards)                         \
   _(MemoryDAG)                         \
+  _(AliasAnalysisLargeGraph)           \
+  _(MemoryPlanning)                    \
+  _(ForkIndependentSubgraphs)          \
+  _(InterpContainers)                  \
   _(IRParser)                          \
   _(ConstantPooling)                   \
   _(THNNConv)                          \
@@ -46,11 +51,13 @@ namespace jit {
   _(NoneSchemaMatch)                   \
   _(ClassParser)                       \
   _(UnifyTypes)                        \
+  _(SymbolicShapePropagation)          \
   _(Profiler)                          \
   _(InsertAndEliminateRedundantGuards) \
   _(InsertBailOuts)                    \
   _(PeepholeOptimize)                  \
   _(RecordFunction)                    \
+  _(SamplingProfiler)                  \
   _(ThreadLocalDebugInfo)              \
   _(SubgraphMatching)                  \
   _(SubgraphRewriter)                  \
@@ -62,23 +69,28 @@ namespace jit {
   _(ModuleDeepcopyString)              \
   _(ModuleDeepcopyAliasing)            \
   _(ModuleDefine)                      \
+  _(ModuleWarmup)                      \
   _(QualifiedName)                     \
   _(ClassImport)                       \
   _(ScriptObject)                      \
   _(SaveExtraFilesHook)                \
+  _(SaveLoadManyTensors)               \
   _(TypeTags)                          \
   _(DCE)                               \
+  _(DynamicBatcher)                    \
   _(CustomFusionNestedBlocks)          \
   _(ClassDerive)                       \
   _(SaveLoadTorchbind)                 \
   _(ModuleInterfaceSerialization)      \
   _(ClassTypeAddRemoveAttr)            \
   _(Inliner)                           \
+  _(StaticRuntime)                     \
   _(LiteInterpreterAdd)                \
   _(LiteInterpreterConv)               \
   _(LiteInterpreterInline)             \
   _(LiteInterpreterTuple)              \
   _(LiteInterpreterUpsampleNearest2d)  \
+  _(LiteInterpreterQuantizedEmbeddingBag) \
   _(CommonAncestor)                    \
   _(AutogradSymbols)                   \
   _(MobileTypeParser)                  \
@@ -90,7 +102,10 @@ namespace jit {
   _(LiteInterpreterSetState)           \
   _(TorchbindIValueAPI)                \
   _(LiteInterpreterDict)               \
-  _(FusionAliasing)
+  _(LiteInterpreterFlatBytecode)       \
+  _(LiteInterpreterOpLatency)          \
+  _(FusionAliasing)                    \
+  _(FusionHorizontal)
 
 #if defined(USE_CUDA)
 #define TH_FORALL_TESTS_CUDA(_)  \
@@ -120,7 +135,8 @@ namespace jit {
   _(GPU_FusionSimplePWise)       \
   _(GPU_FusionExecKernel)        \
   _(GPU_FusionForLoop)           \
-  _(GPU_FusionLoopUnroll)
+  _(GPU_FusionLoopUnroll)        \
+  _(GPU_FusionReduction)
 #else
 #define TH_FORALL_TESTS_CUDA(_) \
   _(ArgumentSpec)               \
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include <torch/csrc/distributed/rpc/metrics/RpcLatencyMetrics.h>
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+
+using torch::distributed::rpc::LatencyHistogram;
+using torch::distributed::rpc::MessageType;
+using torch::distributed::rpc::RpcLatencyMetrics;
+using torch::distributed::rpc::RpcStage;
+
+TEST(LatencyHistogram, Percentiles) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.count(), 0);
+  EXPECT_EQ(histogram.percentileMicros(50), 0);
+
+  for (int i = 0; i < 99; i++) {
+    histogram.record(std::chrono::microseconds(3));
+  }
+  histogram.record(std::chrono::microseconds(1000));
+  EXPECT_EQ(histogram.count(), 100);
+  EXPECT_EQ(histogram.sumMicros(), 99 * 3 + 1000);
+  // 3us falls into [2, 4), and 1000us into [512, 1024).
+  EXPECT_EQ(histogram.percentileMicros(50), 4);
+  EXPECT_EQ(histogram.percentileMicros(99), 4);
+  EXPECT_EQ(histogram.percentileMicros(100), 1024);
+}
+
+TEST(LatencyHistogram, Extremes) {
+  LatencyHistogram histogram;
+  histogram.record(std::chrono::microseconds(0));
+  EXPECT_EQ(histogram.percentileMicros(100), 1);
+  histogram.record(std::chrono::hours(24 * 365 * 100));
+  EXPECT_EQ(
+      histogram.percentileMicros(100),
+      int64_t(1) << (LatencyHistogram::kNumBuckets - 1));
+}
+
+TEST(RpcLatencyMetrics, AddToMetrics) {
+  RpcLatencyMetrics latencyMetrics;
+  latencyMetrics.record(
+      MessageType::SCRIPT_CALL,
+      RpcStage::ROUND_TRIP,
+      std::chrono::microseconds(100));
+  latencyMetrics.record(
+      MessageType::SCRIPT_CALL,
+      RpcStage::ROUND_TRIP,
+      std::chrono::microseconds(300));
+  EXPECT_EQ(
+      latencyMetrics.histogram(MessageType::SCRIPT_CALL, RpcStage::ROUND_TRIP)
+          .count(),
+      2);
+  EXPECT_EQ(
+      latencyMetrics.histogram(MessageType::SCRIPT_CALL, RpcStage::EXECUTION)
+          .count(),
+      0);
+
+  std::unordered_map<std::string, std::string> metrics;
+  latencyMetrics.addToMetrics(metrics);
+  EXPECT_EQ(metrics.size(), 4);
+  EXPECT_EQ(metrics.at("agent.latency.round_trip_us.script_call.count"), "2");
+  EXPECT_EQ(
+      std::stod(metrics.at("agent.latency.round_trip_us.script_call.avg")),
+      200);
+  EXPECT_EQ(metrics.at("agent.latency.round_trip_us.script_call.p50"), "128");
+  EXPECT_EQ(metrics.at("agent.latency.round_trip_us.script_call.p99"), "512");
+}
@@ -65,6 +65,8 @@ TEST(TensorpipeSerialize, Base) {
   recvingTpMessage.metadata = sendingTpMessage.metadata;
 
   // Data is ready
+  torch::distributed::rpc::tensorpipeMoveTensorsToDevices(
+      recvingTpMessage.metadata, recvingRpcMessage);
   EXPECT_EQ(mtype, recvingRpcMessage.type());
   EXPECT_EQ(payloadCopy, recvingRpcMessage.payload());
   EXPECT_EQ(mId, recvingRpcMessage.id());
@@ -134,3 +136,53 @@ TEST(TensorpipeSerialize, NoDeleterTensors) {
           t2.storage().data(),
           sendingTpMessage.tensors[1].length) == 0);
 }
+
+TEST(TensorpipeSerialize, CudaTensorsMovedToMappedDevice) {
+  if (!torch::cuda::is_available()) {
+    return;
+  }
+  at::Tensor t1 = torch::ones({16}, torch::kCUDA);
+  at::Tensor t2 = torch::ones({16});
+  std::vector<at::Tensor> tensors{t1, t2};
+  std::vector<char> payload = {'1', '2', '3'};
+  torch::distributed::rpc::Message sendingRpcMessage(
+      std::move(payload),
+      std::move(tensors),
+      torch::distributed::rpc::MessageType::UNKNOWN);
+
+  torch::distributed::rpc::TensorPipeEntry tpEntry =
+      torch::distributed::rpc::tensorpipeSerialize(
+          sendingRpcMessage, {{0, 0}});
+  tensorpipe::Message sendingTpMessage = std::move(tpEntry.message);
+  // The CUDA tensor is sent from a host copy.
+  EXPECT_TRUE(tpEntry.reservedTensors[0].device().is_cpu());
+  EXPECT_EQ(
+      tpEntry.reservedTensors[0].storage().data(),
+      sendingTpMessage.tensors[0].data);
+
+  tensorpipe::Message recvingTpMessage;
+  recvingTpMessage.length = sendingTpMessage.length;
+  recvingTpMessage.metadata = sendingTpMessage.metadata;
+  for (auto& tpTensor : sendingTpMessage.tensors) {
+    tensorpipe::Message::Tensor t;
+    t.length = tpTensor.length;
+    t.metadata = tpTensor.metadata;
+    recvingTpMessage.tensors.push_back(std::move(t));
+  }
+  torch::distributed::rpc::Message recvingRpcMessage =
+      torch::distributed::rpc::tensorpipeAllocateMessage(recvingTpMessage);
+  for (int i = 0; i < recvingRpcMessage.tensors().size(); i++) {
+    EXPECT_TRUE(recvingRpcMessage.tensors()[i].device().is_cpu());
+    memcpy(
+        recvingRpcMessage.tensors()[i].data_ptr(),
+        sendingTpMessage.tensors[i].data,
+        sendingTpMessage.tensors[i].length);
+  }
+
+  torch::distributed::rpc::tensorpipeMoveTensorsToDevices(
+      recvingTpMessage.metadata, recvingRpcMessage);
+  EXPECT_TRUE(recvingRpcMessage.tensors()[0].is_cuda());
+  EXPECT_TRUE(recvingRpcMessage.tensors()[1].device().is_cpu());
+  EXPECT_TRUE(torch::equal(t1, recvingRpcMessage.tensors()[0]));
+  EXPECT_TRUE(torch::equal(t2, recvingRpcMessage.tensors()[1]));
+}
@@ -100,3 +100,43 @@ TEST(WireSerialize, DISABLED_Sparse) {
   auto deser = torch::distributed::rpc::wireDeserialize(ser.data(), ser.size());
   EXPECT_TRUE(torch::equal(main, deser.second[0]));
 }
+
+TEST(WireSerialize, OutOfBand) {
+  auto run = [](const std::string& payload,
+                const std::vector<at::Tensor>& tensors) {
+    std::vector<char> mpayload(payload.begin(), payload.end());
+    auto serialized =
+        torch::distributed::rpc::wireSerializeOutOfBand(mpayload, tensors);
+    auto deser = torch::distributed::rpc::wireDeserializeOutOfBand(
+        serialized.first.data(), serialized.first.size());
+    auto& buffers = std::get<2>(deser);
+    ASSERT_EQ(serialized.second.size(), buffers.size());
+    for (size_t i = 0; i < buffers.size(); ++i) {
+      // Data buffers alias the sender's storages; nothing is copied into
+      // the header.
+      EXPECT_EQ(serialized.second[i].numel(), buffers[i].numel());
+      buffers[i].copy_(serialized.second[i]);
+    }
+    const auto& dpayload = std::get<0>(deser);
+    EXPECT_EQ(payload, std::string(dpayload.begin(), dpayload.end()));
+    EXPECT_EQ(tensors.size(), std::get<1>(deser).size());
+    for (size_t i = 0; i < tensors.size(); ++i) {
+      EXPECT_TRUE(torch::equal(tensors[i], std::get<1>(deser)[i]));
+    }
+  };
+  run("", {});
+  run("hi", {});
+  run("", {torch::randn({5, 5})});
+  run("more", {torch::randn({5, 5}), torch::rand({10, 10}), torch::empty({0})});
+
+  // Views of the same storage share a data buffer.
+  at::Tensor main = torch::randn({4, 4});
+  run("views", {main.select(0, 1), main.select(1, 2)});
+
+  at::Tensor large = torch::randn({1024, 1024});
+  auto serialized =
+      torch::distributed::rpc::wireSerializeOutOfBand({}, {large});
+  ASSERT_EQ(serialized.second.size(), 1);
+  EXPECT_EQ(serialized.second[0].data_ptr(), large.data_ptr());
+  EXPECT_LT(serialized.first.size(), 1024);
+}
@@ -5,6 +5,7 @@
 #include "test/cpp/tensorexpr/test_utils.h"
 #include "torch/csrc/jit/tensorexpr/buffer.h"
 #include "torch/csrc/jit/tensorexpr/eval.h"
+#include "torch/csrc/jit/tensorexpr/execution_counter.h"
 #include "torch/csrc/jit/tensorexpr/function.h"
 #include "torch/csrc/jit/tensorexpr/ir.h"
 #include "torch/csrc/jit/tensorexpr/ir_printer.h"
@@ -13,6 +14,9 @@
 #include "torch/csrc/jit/tensorexpr/loopnest.h"
 #include "torch/csrc/jit/tensorexpr/tensor.h"
 
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+
 #include <numeric>
 
 namespace torch {
@@ -1014,6 +1018,72 @@ void testLLVMSimpleMath01() {
   ExpectAllNear(f_v, f_ref, 1e-5);
 }
 
+void testLLVMParallelFor() {
+  KernelScope kernel_scope;
+  const int M = 64;
+  const int N = 32;
+  Buffer a(BufHandle("a", {M, N}, kFloat));
+  VarHandle scale("scale", kFloat);
+  Tensor* c = Compute(
+      "c", {{M, "i"}, {N, "j"}}, [&](const VarHandle& i, const VarHandle& j) {
+        return a(i, j) * scale + cast<float>(i);
+      });
+  LoopNest l({c});
+  std::vector<For*> loops = l.getLoopStmtsFor(c);
+  l.setParallel(loops[0]);
+  l.prepareForCodegen();
+  Stmt* s = IRSimplifier::simplify(l.root_stmt());
+
+  LLVMCodeGen cg(s, {a, c, scale});
+
+  std::vector<float> a_vec(M * N);
+  std::iota(a_vec.begin(), a_vec.end(), 0);
+  std::vector<float> c_vec(M * N, 0.0f);
+  cg.call({a_vec, c_vec, 2.0f});
+  for (int i = 0; i < M; i++) {
+    for (int j = 0; j < N; j++) {
+      ASSERT_EQ(c_vec[i * N + j], a_vec[i * N + j] * 2.0f + i);
+    }
+  }
+}
+
+void testLLVMCompiledKernelCache() {
+  KernelScope kernel_scope;
+  llvm::SmallString<128> dir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("nnc_cache", dir));
+  std::string old_dir = getLLVMCacheDir();
+  setLLVMCacheDir(dir.str().str());
+  ExecutionCounter hits(
+      *ExecutionTriggerList::GetInstance().FindByName("llvm_codegen_cache_hit"));
+
+  const int N = 1024;
+  auto run = [&](float c) {
+    Buffer a(BufHandle("a", {N}, kFloat));
+    Tensor* b = Compute(
+        "b", {{N, "i"}}, [&](const VarHandle& i) { return a(i) * c; });
+    LoopNest l({b});
+    l.prepareForCodegen();
+    Stmt* s = IRSimplifier::simplify(l.root_stmt());
+    LLVMCodeGen cg(s, {a, b});
+
+    std::vector<float> a_vec(N, 21.0f);
+    std::vector<float> b_vec(N, 0.0f);
+    cg.call({a_vec, b_vec});
+    assertAllEqual(b_vec, 21.0f * c);
+  };
+
+  run(2.0f);
+  ASSERT_EQ(hits.elapsed_value(), 0);
+  // The same kernel is loaded from the cache, a different one is not.
+  run(2.0f);
+  ASSERT_EQ(hits.elapsed_value(), 1);
+  run(3.0f);
+  ASSERT_EQ(hits.elapsed_value(), 1);
+
+  setLLVMCacheDir(old_dir);
+  llvm::sys::fs::remove_directories(dir);
+}
+
 void testLLVMComputeMul() {
   KernelScope kernel_scope;
   const int N = 1024;
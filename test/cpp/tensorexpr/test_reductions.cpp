@@ -860,5 +860,49 @@ void testReduce3DRfactorInsertionPoint() {
   ASSERT_EQ(out[0], 4950);
 }
 
+// A row-wise reduction and its elementwise consumer end up in a single loop
+// over rows.
+void testReduceFuseOuterLoops() {
+  KernelScope kernel_scope;
+
+  const int M = 4;
+  const int N = 6;
+
+  Buffer b(BufHandle("b", {M, N}, kFloat));
+  std::vector<float> in(M * N);
+  for (int i = 0; i < M; ++i) {
+    for (int j = 0; j < N; ++j) {
+      in[i * N + j] = i * N + j;
+    }
+  }
+  std::vector<float> rowMax(M, -1.f);
+  std::vector<float> out(M * N, -1.f);
+
+  Tensor* mx = Reduce("mx", {{M, "m"}}, Maximum(kFloat), b, {{N, "n"}});
+  Tensor* c = Compute(
+      "c", {{M, "m"}, {N, "n"}}, [&](const VarHandle& m, const VarHandle& n) {
+        return b(m, n) - mx->call(m);
+      });
+  LoopNest loop({c, mx});
+  loop.fuseOuterLoops();
+  loop.prepareForCodegen();
+  Stmt* s = IRSimplifier::simplify(loop.root_stmt());
+
+  Block* root = dynamic_cast<Block*>(s);
+  ASSERT_NE(root, nullptr);
+  ASSERT_EQ(root->nstmts(), 1);
+  ASSERT_NE(dynamic_cast<For*>(root->front()), nullptr);
+
+  SimpleIREvaluator cg(s, {b, c, mx});
+  cg.call({in, out, rowMax});
+
+  for (int i = 0; i < M; ++i) {
+    ASSERT_EQ(rowMax[i], i * N + N - 1);
+    for (int j = 0; j < N; ++j) {
+      ASSERT_EQ(out[i * N + j], j - (N - 1));
+    }
+  }
+}
+
 } // namespace jit
 } // namespace torch
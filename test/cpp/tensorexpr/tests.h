@@ -66,6 +66,7 @@ namespace jit {
   _(Reduce3DRfactorInsertionPoint)          \
   _(SplitReduceAxis)                        \
   _(SplitNonReduceAxis)                     \
+  _(ReduceFuseOuterLoops)                   \
   _(TypeTest01)                             \
   _(TypePropagation)                        \
   _(Cond01)                                 \
@@ -287,6 +288,8 @@ namespace jit {
   _(LLVMStoreFloat)                        \
   _(LLVMSimpleMath01)                      \
   _(LLVMComputeMul)                        \
+  _(LLVMParallelFor)                       \
+  _(LLVMCompiledKernelCache)               \
   _(LLVMBroadcastAdd)                      \
   _(LLVMBitwiseOps)                        \
   _(LLVMDynamicShapeAdd)                   \
@@ -4,6 +4,7 @@ import copy
 import math
 import os
 import random
+import shutil
 import signal
 import sys
 import tempfile
@@ -214,6 +215,18 @@ class StoreTestBase(object):
     def test_set_get(self):
         self._test_set_get(self._create_store())
 
+    def _test_multi_set_get(self, fs):
+        fs.set("key0", "value0")
+        fs.multi_set(["key1", "key2"], ["value1", "value2"])
+        self.assertEqual([b"value2", b"value0", b"value1"],
+                         fs.multi_get(["key2", "key0", "key1"]))
+        self.assertEqual([], fs.multi_get([]))
+        with self.assertRaises(ValueError):
+            fs.multi_set(["key3"], [])
+
+    def test_multi_set_get(self):
+        self._test_multi_set_get(self._create_store())
+
 
 class FileStoreTest(TestCase, StoreTestBase):
     def setUp(self):
@@ -793,6 +806,38 @@ class ProcessGroupGlooTest(MultiProcessTestCase):
     def test_allreduce_basics_cuda(self):
         self._test_allreduce_basics(lambda t: t.clone().cuda())
 
+    @skip_if_not_multigpu
+    def test_allreduce_cuda_algorithms(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        algorithms = [
+            c10d.ProcessGroupGloo.CudaAllreduceAlgorithm.HOST,
+            c10d.ProcessGroupGloo.CudaAllreduceAlgorithm.RING_CHUNKED,
+            c10d.ProcessGroupGloo.CudaAllreduceAlgorithm.HALVING_DOUBLING,
+            c10d.ProcessGroupGloo.CudaAllreduceAlgorithm.AUTO,
+        ]
+        for i, algorithm in enumerate(algorithms):
+            opts = self.opts()
+            opts.cuda_allreduce_algorithm = algorithm
+            opts.cuda_allreduce_pipelined = i % 2 == 0
+            pg = c10d.ProcessGroupGloo(
+                c10d.PrefixStore(str(i), store), self.rank, self.world_size, opts)
+            for dtype in [torch.float, torch.double, torch.half]:
+                for numel in [1, 1000, 100000]:
+                    tensor = torch.full([numel], self.rank + 1, dtype=dtype).cuda()
+                    pg.allreduce([tensor]).wait()
+                    expected = self.world_size * (self.world_size + 1) / 2
+                    self.assertEqual(torch.full([numel], expected, dtype=dtype), tensor.cpu())
+
+            # Non-contiguous tensors and other reductions
+            tensor = torch.full([10, 10], self.rank + 1.0).cuda().t()
+            pg.allreduce([tensor]).wait()
+            self.assertEqual(torch.full([10, 10], self.world_size * (self.world_size + 1) / 2), tensor.cpu())
+            opts = c10d.AllreduceOptions()
+            opts.reduceOp = c10d.ReduceOp.MAX
+            tensor = torch.tensor([self.rank + 1.0]).cuda()
+            pg.allreduce([tensor], opts).wait()
+            self.assertEqual(torch.tensor([float(self.world_size)]), tensor.cpu())
+
     def _test_allreduce_stress(self, inputs):
         store = c10d.FileStore(self.file_name, self.world_size)
         pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts(threads=8))
@@ -1544,6 +1589,55 @@ class ProcessGroupGlooTest(MultiProcessTestCase):
                 self.assertEqual(torch.full([10, 10], self.world_size), tensor)
             del pg
 
+    def _create_hierarchical_process_group(self, local_size):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        return c10d._hierarchical_process_group(
+            store,
+            self.rank,
+            self.world_size,
+            lambda store, rank, size: c10d.ProcessGroupGloo(
+                store, rank, size, self.opts()),
+            local_size=local_size,
+            use_reduce_scatter=False)
+
+    def test_hierarchical_allreduce(self):
+        pg = self._create_hierarchical_process_group(local_size=2)
+        expected = sum(range(self.world_size))
+
+        # The number of elements isn't a multiple of the local size.
+        tensor = torch.full([7, 3], float(self.rank))
+        pg.allreduce(tensor).wait()
+        self.assertEqual(torch.full([7, 3], float(expected)), tensor)
+
+        # Non-contiguous input.
+        tensor = torch.full([4, 6], float(self.rank)).t()
+        pg.allreduce(tensor, c10d.ReduceOp.MAX).wait()
+        self.assertEqual(torch.full([6, 4], float(self.world_size - 1)), tensor)
+
+    def test_hierarchical_allreduce_coalesced(self):
+        pg = self._create_hierarchical_process_group(local_size=2)
+        expected = sum(range(self.world_size))
+        tensors = [torch.full([i + 1, 2], float(self.rank)) for i in range(3)]
+        pg.allreduce_coalesced(tensors).wait()
+        for i, tensor in enumerate(tensors):
+            self.assertEqual(torch.full([i + 1, 2], float(expected)), tensor)
+
+    def test_hierarchical_barrier_waits_for_allreduce(self):
+        pg = self._create_hierarchical_process_group(local_size=2)
+        tensors = [torch.full([100], float(i)) for i in range(8)]
+        for tensor in tensors:
+            # Note: leak the returned work handle
+            pg.allreduce(tensor)
+        pg.barrier().wait()
+        for i, tensor in enumerate(tensors):
+            self.assertEqual(torch.full([100], float(i * self.world_size)), tensor)
+
+    def test_hierarchical_forwards_other_collectives(self):
+        pg = self._create_hierarchical_process_group(local_size=2)
+        tensor = torch.full([10], float(self.rank))
+        pg.broadcast(tensor, root=1).wait()
+        self.assertEqual(torch.full([10], 1.0), tensor)
+
 
 @requires_nccl()
 class ProcessGroupNCCLTest(TestCase):
@@ -1606,6 +1700,31 @@ class ProcessGroupNCCLTest(TestCase):
             for i in range(self.num_gpus):
                 self.assertEqual(tensors[i], tensors[rt])
 
+    def test_allreduce_channels(self):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        os.environ["NCCL_STREAMS_PER_DEVICE"] = "2"
+        try:
+            pg = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
+        finally:
+            del os.environ["NCCL_STREAMS_PER_DEVICE"]
+
+        # channels 0 and 2 share the communicators of channel 0
+        works = []
+        tensor_lists = []
+        for channel in range(4):
+            tensors = [torch.tensor([channel + i + 1.]).cuda(i)
+                       for i in range(self.num_gpus)]
+            opts = c10d.AllreduceOptions()
+            opts.channel = channel
+            works.append(pg.allreduce(tensors, opts))
+            tensor_lists.append(tensors)
+        for work in works:
+            work.wait()
+        for channel, tensors in enumerate(tensor_lists):
+            expected = sum(channel + i + 1. for i in range(self.num_gpus))
+            for tensor in tensors:
+                self.assertEqual(torch.tensor([expected]), tensor)
+
     def test_allreduce_ops(self):
         store = c10d.FileStore(self.file.name, self.world_size)
         pg = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
@@ -1989,6 +2108,46 @@ class DistributedDataParallelTest(MultiProcessTestCase):
     def test_gloo_backend_cpu_module(self):
         self._test_gloo_backend([torch.device('cpu')], [])
 
+    @requires_gloo()
+    def test_gloo_ddp_gradient_as_bucket_view(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupGloo(store, self.rank, self.world_size)
+        global_batch_size = self.world_size
+
+        model = Net()
+        ddp_model = DistributedDataParallel(
+            copy.deepcopy(model),
+            process_group=process_group,
+            bucket_cap_mb=0.001,
+            gradient_as_bucket_view=True)
+        opt = torch.optim.SGD(model.parameters(), lr=0.1)
+        ddp_opt = torch.optim.SGD(ddp_model.parameters(), lr=0.1)
+
+        input = torch.randn(global_batch_size, 2)
+        target = torch.randn(global_batch_size, 4)
+
+        def step_model(model, opt, input, target):
+            opt.zero_grad()
+            F.mse_loss(model(input), target).backward()
+            opt.step()
+
+        # Covers the first iteration, the one after the buckets were rebuilt
+        # and the ones accumulating into the bucket views in place.
+        for iteration in range(4):
+            step_model(model, opt, input, target)
+            step_model(ddp_model, ddp_opt,
+                       input[self.rank: self.rank + 1],
+                       target[self.rank: self.rank + 1])
+            for i, j in zip(model.parameters(), ddp_model.parameters()):
+                self.assertEqual(i.grad, j.grad)
+                self.assertEqual(i, j)
+                # the grads are views of the buckets
+                self.assertIsNotNone(j.grad._base)
+
+            # Shuffle the input so that DDP input is different
+            torch.manual_seed(1337 + iteration)
+            input = input[torch.randperm(global_batch_size)]
+
     @requires_gloo()
     @skip_if_not_multigpu
     def test_gloo_backend_1gpu_module_device_ids_integer_list(self):
@@ -2029,6 +2188,49 @@ class DistributedDataParallelTest(MultiProcessTestCase):
         devices = list([torch.device('cuda:' + str(i)) for i in int_devices])
         self._test_nccl_backend(devices, int_devices)
 
+    def _test_zero_redundancy_optimizer(self, overlap):
+        from torch.distributed.optim import ZeroRedundancyOptimizer
+
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
+        device_id = gpus_for_rank(self.world_size)[self.rank][0]
+        torch.manual_seed(1337)
+        model = nn.Sequential(nn.Linear(2, 10), nn.ReLU(), nn.Linear(10, 3)).cuda(device_id)
+        reference = copy.deepcopy(model)
+        # Tiny buckets to get several buckets and padded shards.
+        optimizer = ZeroRedundancyOptimizer(
+            model.parameters(), torch.optim.Adam, process_group=process_group,
+            bucket_cap_mb=1e-4, module=model if overlap else None, lr=0.01)
+        reference_optimizer = torch.optim.Adam(reference.parameters(), lr=0.01)
+        for _ in range(3):
+            inputs = [torch.rand(4, 2).cuda(device_id) for _ in range(self.world_size)]
+            optimizer.zero_grad()
+            model(inputs[self.rank]).sum().backward()
+            optimizer.step()
+            # The average of the gradients of all ranks.
+            reference_optimizer.zero_grad()
+            sum(reference(input).sum() for input in inputs).div(self.world_size).backward()
+            reference_optimizer.step()
+            if not overlap:
+                for p, q in zip(model.parameters(), reference.parameters()):
+                    self.assertEqual(p, q)
+        optimizer.wait_for_parameters()
+        for p, q in zip(model.parameters(), reference.parameters()):
+            self.assertEqual(p, q)
+        # The local optimizer only holds this rank's shards.
+        shard_numel = sum(p.numel() for p in optimizer.optim.param_groups[0]["params"])
+        self.assertLess(shard_numel, sum(p.numel() for p in model.parameters()))
+
+    @requires_nccl()
+    @skip_if_not_multigpu
+    def test_zero_redundancy_optimizer(self):
+        self._test_zero_redundancy_optimizer(overlap=False)
+
+    @requires_nccl()
+    @skip_if_not_multigpu
+    def test_zero_redundancy_optimizer_overlap(self):
+        self._test_zero_redundancy_optimizer(overlap=True)
+
     @requires_nccl()
     @skip_if_not_multigpu
     def test_nccl_backend_1gpu_module_device_ids_torch_device_list(self):
@@ -2827,6 +3029,47 @@ class DistributedDataParallelTest(MultiProcessTestCase):
             loss = criterion(output, target)
             loss.backward()
 
+    @requires_gloo()
+    def test_find_unused_parameters_by_hooks(self):
+        """
+        Test that parameters unused in some iterations are found without
+        traversing the autograd graph, and that the used ones are reduced.
+        """
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupGloo(store, self.rank, self.world_size)
+
+        class BranchModule(nn.Module):
+            def __init__(self):
+                super(BranchModule, self).__init__()
+                self.fc1 = nn.Linear(2, 4, bias=False)
+                self.fc2 = nn.Linear(4, 4, bias=False)
+                self.fc3 = nn.Linear(4, 4, bias=False)
+
+            def forward(self, x, use_fc2):
+                x = self.fc1(x)
+                return self.fc2(x) if use_fc2 else self.fc3(x)
+
+        model = DistributedDataParallel(
+            BranchModule().float(),
+            process_group=process_group,
+            find_unused_parameters_by_hooks=True,
+        )
+
+        # Every rank computes the gradient of its own rank for the used
+        # branch, whose average is the gradient for the mean of the ranks.
+        input = torch.ones([4, 2], dtype=torch.float)
+        for iteration in range(4):
+            use_fc2 = iteration % 2 == 0
+            model.zero_grad()
+            output = model(input, use_fc2)
+            (output.sum() * (self.rank + 1)).backward()
+
+            used = model.module.fc2 if use_fc2 else model.module.fc3
+            expected = torch.ones_like(used.weight).mul_(
+                model.module.fc1(input).sum(0)).mul_(
+                    (self.world_size + 1) / 2)
+            self.assertEqual(used.weight.grad, expected)
+
     @requires_nccl()
     @skip_if_not_multigpu
     def test_failure_recovery(self):
@@ -3046,6 +3289,29 @@ class ReducerTest(TestCase):
         # is considered being globally unused, it will be kept untouched as None.
         self.assertEqual(None, model.fc3.weight.grad)
 
+    def test_rebuild_buckets(self):
+        batch_size = 10
+        model = ReducerModule()
+        reference = copy.deepcopy(model)
+        reducer = self._create_reducer_for_models([model])
+        loss = nn.CrossEntropyLoss()
+        self.assertEqual(reducer.get_bucket_indices(), [[0, 1, 2]])
+        for i in range(3):
+            for m in (model, reference):
+                m.zero_grad()
+            input = torch.rand([batch_size, 2])
+            target = torch.LongTensor([random.randrange(4) for _ in range(batch_size)])
+            output = loss(model(input), target)
+            reducer.prepare_for_backward(output)
+            # The second iteration starts with the buckets rebuilt in the
+            # order the gradients became ready, i.e. from fc3 back to fc1.
+            expected = [[0, 1, 2]] if i == 0 else [[2, 1, 0]]
+            self.assertEqual(reducer.get_bucket_indices(), expected)
+            output.backward()
+            loss(reference(input), target).backward()
+            for p, q in zip(model.parameters(), reference.parameters()):
+                self.assertEqual(p.grad, q.grad)
+
     def test_forward_backward_optimizer(self):
         batch_size = 10
         model = self._create_mixed_precision_model()
@@ -3067,6 +3333,67 @@ class ReducerTest(TestCase):
             output.backward()
             optimizer.step()
 
+    def _run_with_comm_hook(self, register_hook):
+        batch_size = 10
+        model = self._create_mixed_precision_model()
+        reference = copy.deepcopy(model)
+        reducer = self._create_reducer_for_models([model])
+        register_hook(reducer)
+        loss = nn.CrossEntropyLoss()
+        input = torch.rand([batch_size, 2], dtype=torch.double)
+        target = torch.LongTensor([random.randrange(4) for _ in range(batch_size)])
+        output = loss(model(input), target)
+        reducer.prepare_for_backward(output)
+        output.backward()
+        loss(reference(input), target).backward()
+        return model, reference
+
+    def test_fp16_compress_hook(self):
+        model, reference = self._run_with_comm_hook(
+            lambda reducer: reducer._register_fp16_compress_hook(self.process_group))
+        for p, q in zip(model.parameters(), reference.parameters()):
+            self.assertEqual(p.grad, q.grad, prec=1e-3)
+
+    def test_topk_hook(self):
+        # Keeping every element is lossless.
+        model, reference = self._run_with_comm_hook(
+            lambda reducer: reducer._register_topk_hook(self.process_group, ratio=1.0))
+        for p, q in zip(model.parameters(), reference.parameters()):
+            self.assertEqual(p.grad, q.grad)
+
+    def test_powersgd_hook(self):
+        rank, seed = 2, 7
+        model = nn.Linear(16, 16, bias=False).double()
+        reference = copy.deepcopy(model)
+        reducer = self._create_reducer_for_models([model])
+        reducer._register_powersgd_hook(
+            self.process_group, matrix_approximation_rank=rank,
+            min_compression_numel=0, seed=seed)
+        input = torch.rand([10, 16], dtype=torch.double)
+        output = model(input).pow(2).sum()
+        reducer.prepare_for_backward(output)
+        output.backward()
+        reference(input).pow(2).sum().backward()
+
+        # With a single process the hook computes the rank-r reconstruction
+        # P P^T M, where P is the orthonormalized projection of the gradient M
+        # onto the shared random Q of the only bucket.
+        grad = reference.weight.grad
+        q = torch.randn(
+            [16, rank], generator=torch.Generator().manual_seed(seed),
+            dtype=torch.double)
+        p, _ = torch.qr(grad.mm(q))
+        expected = p.mm(p.t().mm(grad))
+        self.assertEqual(model.weight.grad, expected, prec=1e-6)
+        self.assertNotEqual(model.weight.grad, grad)
+
+    def test_register_comm_hook_twice(self):
+        model = ReducerModule()
+        reducer = self._create_reducer_for_models([model])
+        reducer._register_fp16_compress_hook(self.process_group)
+        with self.assertRaisesRegex(RuntimeError, "only be called once"):
+            reducer._register_fp16_compress_hook(self.process_group)
+
 
 class ComputeBucketAssignmentTest(TestCase):
     def test_single_limit_single_dtype(self):
@@ -3363,6 +3690,66 @@ class CommTest(MultiProcessTestCase):
         self._test_broadcast_coalesced(process_group, device)
 
 
+class ShardedCheckpointTest(MultiProcessTestCase):
+    def setUp(self):
+        super(ShardedCheckpointTest, self).setUp()
+        self._fork_processes()
+
+    def tearDown(self):
+        super(ShardedCheckpointTest, self).tearDown()
+        try:
+            os.remove(self.file_name)
+        except OSError:
+            pass
+
+    @property
+    def world_size(self):
+        return 2
+
+    @requires_gloo()
+    def test_save_load_resharded(self):
+        from torch.distributed.checkpoint import Shard, load_sharded, save_sharded
+
+        c10d.init_process_group(
+            backend='gloo', init_method='file://{}'.format(self.file_name),
+            rank=self.rank, world_size=self.world_size)
+        # Every process sees the same directory, as derived from the file of
+        # the store they share
+        path = self.file_name + '.checkpoint'
+        weight = torch.arange(48, dtype=torch.float32).view(6, 8)
+        bias = torch.arange(8, dtype=torch.float64)
+        rows = 6 // self.world_size
+        state_dict = {
+            'weight': Shard(weight[self.rank * rows:(self.rank + 1) * rows].clone(),
+                            (self.rank * rows, 0), weight.size()),
+            'bias': bias.clone(),
+            'steps': torch.tensor(self.rank),
+            'epoch': 3,
+        }
+        save_sharded(state_dict, path)
+
+        # Loads by columns instead of rows, and each rank reads only part of
+        # the bias
+        columns = 8 // self.world_size
+        loaded = {
+            'weight': Shard(torch.zeros(6, columns), (0, self.rank * columns), weight.size()),
+            'bias': torch.zeros(8, dtype=torch.float64),
+            'steps': torch.tensor(-1),
+            'epoch': 0,
+        }
+        load_sharded(loaded, path)
+        self.assertEqual(loaded['weight'].tensor,
+                         weight[:, self.rank * columns:(self.rank + 1) * columns])
+        self.assertEqual(loaded['bias'], bias)
+        self.assertEqual(loaded['epoch'], 3)
+        # A replicated tensor is written by a single rank
+        self.assertIn(loaded['steps'].item(), range(self.world_size))
+
+        c10d.distributed_c10d.barrier()
+        if self.rank == 0:
+            shutil.rmtree(path)
+
+
 if __name__ == '__main__':
     assert not torch.cuda._initialized, "test_distributed must not have initialized CUDA context on main process"
 
@@ -1,10 +1,12 @@
 import torch
 import torch.nn as nn
+import torch.nn.functional as F
 from torch.testing._internal.jit_utils import JitTestCase
 
 from torch.testing import FileCheck
 
 import io
+import unittest
 
 if __name__ == '__main__':
     raise RuntimeError("This test file is not meant to be run directly, use:\n\n"
@@ -833,3 +835,130 @@ class TestFreezing(JitTestCase):
         out3 = smod(inp)
         self.assertNotEqual(out1, out2)
         self.assertEqual(out2, out3)
+
+    def test_freeze_module_pack_linear_weights(self):
+        class M(nn.Module):
+            def __init__(self):
+                super(M, self).__init__()
+                self.fc1 = nn.Linear(16, 32)
+                self.fc2 = nn.Linear(32, 8, bias=False)
+
+            def forward(self, x):
+                return self.fc2(torch.relu(self.fc1(x)))
+
+        m = torch.jit.script(M())
+        m.eval()
+        frozen = torch._C._freeze_module(m._c)
+        torch._C._jit_pass_pack_linear_weights(frozen)
+        FileCheck().check_not('aten::linear') \
+                   .check_count('packed::linear_run', 2, exactly=True) \
+                   .run(frozen._get_method('forward').graph)
+        # the weight is packed for the rows of the first input, later inputs
+        # of other sizes fall back to aten::linear
+        with torch.no_grad():
+            for x in (torch.randn(4, 16), torch.randn(4, 16), torch.randn(3, 5, 16)):
+                self.assertEqual(frozen.forward(x), m(x))
+        buffer = io.BytesIO()
+        torch.jit.save(frozen, buffer)
+        buffer.seek(0)
+        loaded = torch.jit.load(buffer)
+        x = torch.randn(4, 16)
+        with torch.no_grad():
+            self.assertEqual(loaded(x), m(x))
+
+    @unittest.skipIf(not torch._C.has_mkldnn, "MKL-DNN build is disabled")
+    def test_freeze_module_convert_ops_to_mkldnn(self):
+        class M(nn.Module):
+            def __init__(self):
+                super(M, self).__init__()
+                self.conv1 = nn.Conv2d(3, 8, 3, padding=1)
+                self.bn = nn.BatchNorm2d(8)
+                self.relu = nn.ReLU(inplace=True)
+                self.conv2 = nn.Conv2d(8, 8, 3, groups=2, bias=False)
+                self.fc = nn.Linear(8, 4)
+
+            def forward(self, x):
+                x = self.relu(self.bn(self.conv1(x)))
+                x = F.max_pool2d(x, 2)
+                x = F.adaptive_avg_pool2d(torch.relu(self.conv2(x)), 1)
+                return self.fc(torch.flatten(x, 1))
+
+        m = torch.jit.script(M())
+        m.eval()
+        frozen = torch._C._freeze_module(m._c)
+        torch._C._jit_pass_convert_frozen_ops_to_mkldnn(frozen)
+        # the chain from conv1 to the pooling is converted at its edges only,
+        # the input of the linear layer has no known rank
+        FileCheck().check_count('aten::to_mkldnn', 1, exactly=True) \
+                   .check('aten::conv2d') \
+                   .check('aten::batch_norm') \
+                   .check('aten::relu_') \
+                   .check('aten::max_pool2d') \
+                   .check('aten::conv2d') \
+                   .check('aten::adaptive_avg_pool2d') \
+                   .check_count('aten::to_dense', 1, exactly=True) \
+                   .check('aten::linear') \
+                   .run(frozen._get_method('forward').graph)
+        with torch.no_grad():
+            x = torch.randn(2, 3, 16, 16)
+            self.assertEqual(frozen.forward(x), m(x))
+
+    def test_freeze_module_optimize_frozen_module(self):
+        class M(nn.Module):
+            def __init__(self):
+                super(M, self).__init__()
+                self.conv = nn.Conv2d(3, 8, 3, bias=False)
+                self.bn1 = nn.BatchNorm2d(8)
+                self.fc = nn.Linear(8, 4)
+                self.bn2 = nn.BatchNorm1d(4)
+
+            def forward(self, x):
+                x = torch.relu(self.bn1(self.conv(x)))
+                x = torch.flatten(F.adaptive_avg_pool2d(x, 1), 1)
+                return self.bn2(self.fc(x))
+
+        m = M()
+        # non-trivial batch norm statistics and parameters
+        for bn in (m.bn1, m.bn2):
+            bn.running_mean.uniform_(-1, 1)
+            bn.running_var.uniform_(0.5, 2)
+            bn.weight.data.uniform_(0.5, 2)
+            bn.bias.data.uniform_(-1, 1)
+        m = torch.jit.script(m)
+        m.eval()
+        frozen = torch._C._freeze_module(m._c)
+        torch._C._jit_pass_optimize_frozen_module(frozen)
+        graph = frozen._get_method('forward').graph
+        FileCheck().check_not('aten::batch_norm').run(graph)
+        FileCheck().check('aten::conv2d') \
+                   .check('packed::linear_run') \
+                   .run(graph)
+        with torch.no_grad():
+            x = torch.randn(2, 3, 16, 16)
+            self.assertEqual(frozen.forward(x), m(x))
+
+    def test_freeze_module_insert_inplace_ops(self):
+        class M(nn.Module):
+            def __init__(self):
+                super(M, self).__init__()
+                self.fc = nn.Linear(8, 8)
+
+            def forward(self, x):
+                y = torch.sigmoid(torch.relu(self.fc(x)))
+                return torch.tanh(x), y + torch.relu(y)
+
+        m = torch.jit.script(M())
+        m.eval()
+        frozen = torch._C._freeze_module(m._c)
+        graph = frozen._get_method('forward').graph
+        torch._C._jit_pass_insert_inplace_ops(graph)
+        # the input of the module and y, which is used after the second
+        # relu, are not overwritten
+        FileCheck().check_count('aten::relu_', 1, exactly=True) \
+                   .check('aten::sigmoid_') \
+                   .run(graph)
+        FileCheck().check_not('aten::tanh_').run(graph)
+        FileCheck().check_count('aten::relu(', 1, exactly=True).run(graph)
+        with torch.no_grad():
+            x = torch.randn(4, 8)
+            self.assertEqual(frozen.forward(x), m(x))
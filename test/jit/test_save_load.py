@@ -3,6 +3,7 @@ import io
 import sys
 import random
 import torch
+import zipfile
 from torch import Tensor
 from typing import NamedTuple
 
@@ -20,6 +21,51 @@ if __name__ == "__main__":
 
 
 class TestSaveLoad(JitTestCase):
+    def test_lazy_compilation_on_load(self):
+        class M(torch.nn.Module):
+            def forward(self, x):
+                return x + 1
+
+            @torch.jit.export
+            def unused(self, x):
+                return x * 3
+
+        saved = io.BytesIO()
+        torch.jit.save(torch.jit.script(M()), saved)
+
+        # The same archive with an unused() that does not compile, and code of
+        # the same length so that the source ranges stay valid.
+        broken = io.BytesIO()
+        replaced = False
+        with zipfile.ZipFile(io.BytesIO(saved.getvalue())) as src, zipfile.ZipFile(broken, 'w') as dst:
+            for info in src.infolist():
+                data = src.read(info)
+                if '/code/' in info.filename and b'torch.mul(x, 3)' in data:
+                    data = data.replace(b'torch.mul(x, 3)', b'torch.mux(x, 3)')
+                    replaced = True
+                dst.writestr(info, data)
+        self.assertTrue(replaced)
+
+        with self.assertRaisesRegex(RuntimeError, "mux"):
+            torch.jit.load(io.BytesIO(broken.getvalue()))
+
+        x = torch.ones(3)
+        torch._C._jit_set_lazy_compilation_on_load(True)
+        try:
+            m = torch.jit.load(io.BytesIO(broken.getvalue()))
+            self.assertEqual(m(x), x + 1)
+            for _ in range(2):
+                with self.assertRaisesRegex(RuntimeError, "mux"):
+                    m.unused(x)
+
+            m = torch.jit.load(io.BytesIO(saved.getvalue()))
+            torch._C._jit_compile_lazily_loaded_functions_async(m._c)
+            self.assertEqual(m.unused(x), x * 3)
+            self.assertEqual(m(x), x + 1)
+            self.assertEqual(m.unused.code, torch.jit.load(io.BytesIO(saved.getvalue())).unused.code)
+        finally:
+            torch._C._jit_set_lazy_compilation_on_load(False)
+
     def test_versioned_symbols(self):
         """
         Tests Torchscript symbol versioning. See note [Versioned Symbols].
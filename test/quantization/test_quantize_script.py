@@ -1276,6 +1276,52 @@ class TestQuantizeScriptPTSQOps(JitTestCase):
                    .check_not("quantized::relu(") \
                    .run(model.graph)
 
+    @unittest.skipUnless('fbgemm' in torch.backends.quantized.supported_engines,
+                         " Quantized operations require FBGEMM. FBGEMM is only optimized for CPUs"
+                         " with instruction set support avx2 or newer.")
+    def test_quantized_conv2d_add(self):
+        class ConvAdd(torch.nn.Module):
+            def __init__(self):
+                super(ConvAdd, self).__init__()
+                self.conv = torch.nn.Conv2d(3, 3, 3, padding=1).float()
+
+            def forward(self, x):
+                return self.conv(x) + x
+
+        class ConvInplaceAdd(torch.nn.Module):
+            def __init__(self):
+                super(ConvInplaceAdd, self).__init__()
+                self.conv = torch.nn.Conv2d(3, 3, 3, padding=1).float()
+
+            def forward(self, x):
+                out = self.conv(x)
+                out += x
+                return out
+
+        class ConvAddReLU(torch.nn.Module):
+            def __init__(self):
+                super(ConvAddReLU, self).__init__()
+                self.conv = torch.nn.Conv2d(3, 3, 3, padding=1).float()
+                self.relu = torch.nn.ReLU()
+
+            def forward(self, x):
+                out = self.conv(x)
+                out += x
+                return self.relu(out)
+
+        data = [(torch.randn(1, 3, 10, 10, dtype=torch.float),
+                 torch.randint(0, 1, (1,), dtype=torch.long)) for _ in range(2)]
+        for M, quantized_op in [(ConvAdd, "quantized::conv2d_add("),
+                                (ConvInplaceAdd, "quantized::conv2d_add("),
+                                (ConvAddReLU, "quantized::conv2d_add_relu")]:
+            model = self._test_op_impl(M(), data, quantized_op)
+            FileCheck().check_not("aten::conv2d") \
+                       .check_not("aten::add") \
+                       .check_not("aten::relu") \
+                       .check_not("quantized::conv2d(") \
+                       .check_not("quantized::add") \
+                       .run(model.graph)
+
     @unittest.skipUnless('fbgemm' in torch.backends.quantized.supported_engines,
                          " Quantized operations require FBGEMM. FBGEMM is only optimized for CPUs"
                          " with instruction set support avx2 or newer.")
@@ -18,7 +18,7 @@ hu.assert_deadline_disabled()
 
 from torch.testing._internal.common_utils import TEST_WITH_ASAN, TEST_WITH_UBSAN, TestCase, IS_PPC, IS_MACOS
 from torch.testing._internal.common_quantized import _quantize, _dequantize, _calculate_dynamic_qparams, \
-    override_quantized_engine
+    override_quantized_engine, supported_qengines
 
 np_dtype = {
     torch.quint8 : np.uint8,
@@ -1838,6 +1838,27 @@ class TestDynamicQuantizedLinear(TestCase):
             self.assertEqual(Y_fp32, Y_fp32_ref,
                              message="torch.ops.quantized.linear_dynamic (fbgemm) results are off")
 
+    def test_qlinear_cached_range(self):
+        for qengine in supported_qengines:
+            with override_quantized_engine(qengine):
+                W_q = torch.quantize_per_tensor(
+                    torch.randn(8, 16), scale=0.05, zero_point=0, dtype=torch.qint8)
+                W_prepack = torch.ops.quantized.linear_prepack(W_q, torch.randn(8))
+                X = torch.rand(4, 16)
+                linear_dynamic = torch.ops.quantized.linear_dynamic
+                linear_cached_range = torch.ops.quantized.linear_dynamic_cached_range
+                # the range of the first input is used for the next two calls,
+                # which saturate the inputs outside of it
+                self.assertEqual(linear_cached_range(X, W_prepack, 3),
+                                 linear_dynamic(X, W_prepack))
+                for _ in range(2):
+                    self.assertNotEqual(linear_cached_range(2 * X, W_prepack, 3),
+                                        linear_dynamic(2 * X, W_prepack))
+                self.assertEqual(linear_cached_range(2 * X, W_prepack, 3),
+                                 linear_dynamic(2 * X, W_prepack))
+                with self.assertRaisesRegex(RuntimeError, "refresh_interval has to be positive"):
+                    linear_cached_range(X, W_prepack, 0)
+
     """Tests the correctness of the legacy dynamic quantized linear op."""
     @given(
         batch_size=st.integers(1, 4),
@@ -2092,6 +2113,89 @@ class TestQuantizedLinear(unittest.TestCase):
                 np.testing.assert_equal(
                     W_q.q_zero_point(), W_q_origin.q_zero_point())
 
+    """Tests the quantized linear ops on a weight pruned to 1x4 blocks, which
+    linear_prepack packs in the block-sparse format."""
+    def test_qlinear_block_sparse(self):
+        output_channels, input_channels = 16, 30
+        # A fifth of the blocks are kept, including the last, partial, block of
+        # some of the rows.
+        blocks = torch.arange(output_channels).view(-1, 1) + \
+            torch.arange((input_channels + 3) // 4)
+        mask = (blocks % 5 == 0).repeat_interleave(4, dim=1)[:, :input_channels]
+        W = torch.randn(output_channels, input_channels) * mask.float()
+        b = torch.randn(output_channels)
+        X = torch.rand(3, 2, input_channels)
+        X_q = torch.quantize_per_tensor(X, scale=0.01, zero_point=3, dtype=torch.quint8)
+        Y_scale, Y_zp = 0.05, 120
+
+        for qengine in supported_qengines:
+            with override_quantized_engine(qengine):
+                W_qs = [torch.quantize_per_tensor(W, scale=0.02, zero_point=2, dtype=torch.qint8)]
+                if qengine == 'fbgemm':
+                    W_qs.append(torch.quantize_per_channel(
+                        W, torch.rand(output_channels).double() * 0.02 + 0.01,
+                        torch.randint(-5, 5, (output_channels,)), 0, dtype=torch.qint8))
+                for W_q in W_qs:
+                    W_prepack = torch.ops.quantized.linear_prepack(W_q, b)
+                    W_q_origin = torch.ops.quantized.linear_unpack(W_prepack)[0]
+                    np.testing.assert_equal(W_q.int_repr().numpy(), W_q_origin.int_repr().numpy())
+
+                    Y_fp32_ref = F.linear(X_q.dequantize(), W_q.dequantize(), b)
+                    for qlinear, Y_ref in ((torch.ops.quantized.linear, Y_fp32_ref),
+                                           (torch.ops.quantized.linear_relu, F.relu(Y_fp32_ref))):
+                        Y_q = qlinear(X_q, W_prepack, Y_scale, Y_zp)
+                        Y_q_ref = torch.quantize_per_tensor(Y_ref, Y_scale, Y_zp, torch.quint8)
+                        self.assertEqual(Y_q.shape, Y_q_ref.shape)
+                        np.testing.assert_array_almost_equal(
+                            Y_q_ref.int_repr().numpy(), Y_q.int_repr().numpy(), decimal=0)
+
+                    X_scale, X_zp = _calculate_dynamic_qparams(X, torch.quint8)
+                    X_q_dynamic = torch.quantize_per_tensor(X, X_scale, X_zp, torch.quint8)
+                    Y_fp32 = torch.ops.quantized.linear_dynamic(X, W_prepack)
+                    np.testing.assert_array_almost_equal(
+                        F.linear(X_q_dynamic.dequantize(), W_q.dequantize(), b).numpy(),
+                        Y_fp32.numpy(), decimal=4)
+
+    """Tests the quantized linear and linear_relu ops on QuantizedCUDA
+    tensors against their dequantized float reference."""
+    @unittest.skipIf(not torch.cuda.is_available(), "CUDA unavailable")
+    @given(batch_size=st.integers(1, 4),
+           input_channels=st.integers(1, 32),
+           output_channels=st.integers(1, 8),
+           X_zero_point=st.integers(0, 255),
+           Y_zero_point=st.integers(0, 255),
+           use_bias=st.booleans(),
+           use_relu=st.booleans())
+    def test_qlinear_cuda(self, batch_size, input_channels, output_channels,
+                          X_zero_point, Y_zero_point, use_bias, use_relu):
+        X_scale = 0.02
+        W_scale = 0.004
+        Y_scale = 0.05
+        X = torch.rand(batch_size, input_channels, device='cuda') * 5 - 2.5
+        W = torch.rand(output_channels, input_channels, device='cuda') - 0.5
+        X_q = torch.quantize_per_tensor(
+            X, scale=X_scale, zero_point=X_zero_point, dtype=torch.quint8)
+        # The cuBLAS int8 GEMMs need symmetric weights
+        W_q = torch.quantize_per_tensor(
+            W, scale=W_scale, zero_point=0, dtype=torch.qint8)
+        b = torch.rand(output_channels, device='cuda') if use_bias else None
+
+        Y_ref = F.linear(X_q.dequantize(), W_q.dequantize(), b)
+        if use_relu:
+            Y_ref = F.relu(Y_ref)
+        Y_ref_q = torch.quantize_per_tensor(
+            Y_ref, scale=Y_scale, zero_point=Y_zero_point, dtype=torch.quint8)
+
+        W_prepack = torch.ops.quantized.linear_prepack(W_q, b)
+        qlinear = torch.ops.quantized.linear_relu if use_relu \
+            else torch.ops.quantized.linear
+        Y_q = qlinear(X_q, W_prepack, Y_scale, Y_zero_point)
+        self.assertEqual(Y_q.device, X_q.device)
+        # Off by one from the rounding of the float requantization
+        np.testing.assert_allclose(
+            Y_ref_q.int_repr().cpu().numpy().astype(np.int32),
+            Y_q.int_repr().cpu().numpy().astype(np.int32), atol=1, rtol=0)
+
 class TestQuantizedConv(unittest.TestCase):
     def _test_qconv_unpack_impl(
         self, qconv_prepack_fn, qconv_unpack_fn, inputs, strides, pads,
@@ -2346,6 +2450,176 @@ class TestQuantizedConv(unittest.TestCase):
                 dilations, X_scale, X_zero_point, W_scale, W_zero_point,
                 Y_scale, Y_zero_point, use_bias, use_relu, use_channelwise)
 
+    """Tests the correctness of the fused quantized conv + add (+ relu) ops."""
+    @given(batch_size=st.integers(1, 3),
+           input_channels_per_group=st.sampled_from([2, 4, 5, 8, 16]),
+           height=st.integers(7, 12),
+           width=st.integers(7, 12),
+           output_channels_per_group=st.sampled_from([2, 4, 5, 8, 16]),
+           groups=st.integers(1, 2),
+           kernel=st.sampled_from([1, 3]),
+           X_scale=st.floats(1.2, 1.6),
+           X_zero_point=st.integers(0, 4),
+           W_scale=st.lists(st.floats(0.2, 1.6), min_size=1, max_size=2),
+           W_zero_point=st.lists(st.integers(-5, 5), min_size=1, max_size=2),
+           accum_scale=st.floats(2.0, 4.2),
+           accum_zero_point=st.integers(100, 150),
+           Y_scale=st.floats(4.2, 5.6),
+           Y_zero_point=st.integers(0, 4),
+           use_bias=st.booleans(),
+           use_relu=st.booleans(),
+           use_channelwise=st.booleans(),
+           qengine=st.sampled_from(("qnnpack", "fbgemm")))
+    def test_qconv2d_add(
+            self,
+            batch_size,
+            input_channels_per_group,
+            height,
+            width,
+            output_channels_per_group,
+            groups,
+            kernel,
+            X_scale,
+            X_zero_point,
+            W_scale,
+            W_zero_point,
+            accum_scale,
+            accum_zero_point,
+            Y_scale,
+            Y_zero_point,
+            use_bias,
+            use_relu,
+            use_channelwise,
+            qengine
+    ):
+        if qengine not in torch.backends.quantized.supported_engines:
+            return
+        if qengine == 'qnnpack':
+            # QNNPACK qconv is flaky on MACOS. Issue #27326
+            if IS_PPC or TEST_WITH_UBSAN or IS_MACOS:
+                return
+            use_channelwise = False
+
+        kernels = (kernel, kernel)
+        strides = (1, 1)
+        pads = (kernel // 2, kernel // 2)
+        dilations = (1, 1)
+        (X, W), (X_q, W_q), bias_float = self._make_qconv_tensors(
+            batch_size, input_channels_per_group, (height, width),
+            output_channels_per_group, groups, kernels, strides, pads,
+            dilations, X_scale, X_zero_point, W_scale, W_zero_point,
+            use_bias, use_channelwise)
+        accum_q = torch.quantize_per_tensor(
+            torch.randn(batch_size, output_channels_per_group * groups,
+                        height, width) * 64,
+            scale=accum_scale, zero_point=accum_zero_point,
+            dtype=torch.quint8)
+
+        with override_quantized_engine(qengine):
+            result_ref = F.conv2d(
+                X, W, bias_float, strides, pads, dilations, groups) + \
+                accum_q.dequantize()
+            if use_relu:
+                result_ref = F.relu(result_ref)
+            result_ref_q = torch.quantize_per_tensor(
+                result_ref, scale=Y_scale, zero_point=Y_zero_point,
+                dtype=torch.quint8)
+
+            W_prepack = torch.ops.quantized.conv2d_prepack(
+                W_q, bias_float, strides, pads, dilations, groups)
+            qconv_add = torch.ops.quantized.conv2d_add_relu if use_relu \
+                else torch.ops.quantized.conv2d_add
+            Y_q = qconv_add(X_q, accum_q, W_prepack, Y_scale, Y_zero_point)
+
+        # The convolution is requantized with the scale Y_scale + accum_scale
+        # before the accumulator is added, which can be off by 1 on top of
+        # the off-by-1 differences of the rounding
+        np.testing.assert_allclose(
+            result_ref_q.int_repr().numpy().astype(np.int32),
+            Y_q.int_repr().numpy().astype(np.int32), atol=2, rtol=0)
+
+    """Tests the quantized conv2d, conv2d_relu and conv2d_add ops on
+    QuantizedCUDA tensors against their dequantized float reference."""
+    @unittest.skipIf(not torch.backends.cudnn.is_available(),
+                     "cuDNN unavailable")
+    @given(batch_size=st.integers(1, 3),
+           input_channels=st.integers(1, 8),
+           height=st.integers(6, 12),
+           width=st.integers(6, 12),
+           output_channels=st.integers(1, 8),
+           kernel=st.integers(1, 3),
+           stride=st.integers(1, 2),
+           pad=st.integers(0, 2),
+           dilation=st.integers(1, 2),
+           X_zero_point=st.integers(0, 255),
+           Y_zero_point=st.integers(0, 255),
+           use_bias=st.booleans(),
+           use_relu=st.booleans(),
+           use_add=st.booleans())
+    def test_qconv2d_cuda(
+            self,
+            batch_size,
+            input_channels,
+            height,
+            width,
+            output_channels,
+            kernel,
+            stride,
+            pad,
+            dilation,
+            X_zero_point,
+            Y_zero_point,
+            use_bias,
+            use_relu,
+            use_add
+    ):
+        X_scale = 0.02
+        W_scale = 0.004
+        Y_scale = 0.05
+        strides = (stride, stride)
+        pads = (pad, pad)
+        dilations = (dilation, dilation)
+        X = torch.rand(batch_size, input_channels, height, width,
+                       device='cuda') * 5 - 2.5
+        W = torch.rand(output_channels, input_channels, kernel, kernel,
+                       device='cuda') - 0.5
+        X_q = torch.quantize_per_tensor(
+            X, scale=X_scale, zero_point=X_zero_point, dtype=torch.quint8)
+        # The cuDNN int8 convolutions need symmetric weights
+        W_q = torch.quantize_per_tensor(
+            W, scale=W_scale, zero_point=0, dtype=torch.qint8)
+        b = torch.rand(output_channels, device='cuda') if use_bias else None
+
+        Y_ref = F.conv2d(X_q.dequantize(), W_q.dequantize(), b, strides, pads,
+                         dilations)
+        accum_q = torch.quantize_per_tensor(
+            torch.rand_like(Y_ref) * 4 - 2, scale=0.03, zero_point=128,
+            dtype=torch.quint8)
+        if use_add:
+            Y_ref = Y_ref + accum_q.dequantize()
+        if use_relu:
+            Y_ref = F.relu(Y_ref)
+        Y_ref_q = torch.quantize_per_tensor(
+            Y_ref, scale=Y_scale, zero_point=Y_zero_point, dtype=torch.quint8)
+
+        W_prepack = torch.ops.quantized.conv2d_prepack(
+            W_q, b, strides, pads, dilations, 1)
+        if use_add:
+            qconv = torch.ops.quantized.conv2d_add_relu if use_relu \
+                else torch.ops.quantized.conv2d_add
+            Y_q = qconv(X_q, accum_q, W_prepack, Y_scale, Y_zero_point)
+        else:
+            qconv = torch.ops.quantized.conv2d_relu if use_relu \
+                else torch.ops.quantized.conv2d
+            Y_q = qconv(X_q, W_prepack, Y_scale, Y_zero_point)
+        # Off by one from the rounding of the float requantization
+        np.testing.assert_allclose(
+            Y_ref_q.int_repr().cpu().numpy().astype(np.int32),
+            Y_q.int_repr().cpu().numpy().astype(np.int32), atol=1, rtol=0)
+
+        W_unpacked, b_unpacked = torch.ops.quantized.conv2d_unpack(W_prepack)
+        self.assertEqual(W_unpacked.int_repr(), W_q.int_repr())
+
     """Tests the correctness of the quantized::qconv_unpack op."""
     @given(
         inputs=hu.tensor_conv(
@@ -2624,6 +2898,100 @@ class TestPadding(TestCase):
         self.assertEqual(qy_ref, qy_hat)
 
 
+class TestQuantizedEmbeddingBag(TestCase):
+    def _test_embedding_bag(self, bit_rate, prepack_op, unpack_op, embedding_bag_op):
+        num_embeddings, embedding_dim = 80, 32
+        weights = torch.randn(num_embeddings, embedding_dim)
+        packed_weights = prepack_op(weights)
+        unpacked_weights = unpack_op(packed_weights)
+        # maximum quantization error of a rowwise affine quantization
+        row_range = (weights.max(1)[0] - weights.min(1)[0]).max().item()
+        atol = row_range / (2 ** bit_rate - 1)
+        self.assertEqual(unpacked_weights, weights, atol=atol, rtol=0)
+
+        indices = torch.randint(num_embeddings, (1000,), dtype=torch.long)
+        offsets = torch.randint(indices.numel(), (199,)).sort()[0]
+        offsets = torch.cat((torch.zeros(1, dtype=torch.long), offsets))
+        per_sample_weights = torch.randn(indices.numel())
+
+        for mode, psw, include_last_offset, index_dtype in itertools.product(
+                (0, 1), (None, per_sample_weights), (False, True), (torch.long, torch.int)):
+            if mode == 1 and psw is not None:
+                continue
+            mode_name = 'sum' if mode == 0 else 'mean'
+            bag_offsets = offsets
+            if include_last_offset:
+                bag_offsets = torch.cat((offsets, torch.tensor([indices.numel()])))
+            # the quantized ops compute with the dequantized weights
+            expected = F.embedding_bag(
+                indices, unpacked_weights, offsets, mode=mode_name,
+                per_sample_weights=psw)
+            result = embedding_bag_op(
+                packed_weights, indices.to(index_dtype), bag_offsets, mode=mode,
+                per_sample_weights=psw, include_last_offset=include_last_offset)
+            self.assertEqual(result, expected, atol=1e-4, rtol=1e-4)
+
+        # 2-dimensional indices are bags of equal size
+        indices_2d = indices.view(100, 10)
+        expected = F.embedding_bag(indices_2d, unpacked_weights)
+        result = embedding_bag_op(packed_weights, indices_2d)
+        self.assertEqual(result, expected, atol=1e-4, rtol=1e-4)
+
+        # usable from TorchScript
+        def fn(weight, indices, offsets):
+            return embedding_bag_op(weight, indices, offsets, mode=1)
+        scripted = torch.jit.script(fn)
+        self.assertEqual(scripted(packed_weights, indices, offsets),
+                         embedding_bag_op(packed_weights, indices, offsets, mode=1))
+
+    def test_embedding_bag_byte(self):
+        self._test_embedding_bag(
+            8,
+            torch.ops.quantized.embedding_bag_byte_prepack,
+            torch.ops.quantized.embedding_bag_byte_unpack,
+            torch.ops.quantized.embedding_bag_byte_rowwise_offsets)
+
+    def test_embedding_bag_4bit(self):
+        self._test_embedding_bag(
+            4,
+            torch.ops.quantized.embedding_bag_4bit_prepack,
+            torch.ops.quantized.embedding_bag_4bit_unpack,
+            torch.ops.quantized.embedding_bag_4bit_rowwise_offsets)
+
+    def test_embedding_bag_lengths(self):
+        for prepack_op, offsets_op, lengths_op in (
+                (torch.ops.quantized.embedding_bag_byte_prepack,
+                 torch.ops.quantized.embedding_bag_byte_rowwise_offsets,
+                 torch.ops.quantized.embedding_bag_byte_rowwise_lengths),
+                (torch.ops.quantized.embedding_bag_4bit_prepack,
+                 torch.ops.quantized.embedding_bag_4bit_rowwise_offsets,
+                 torch.ops.quantized.embedding_bag_4bit_rowwise_lengths)):
+            # 36 columns cover both the vectorized and the remaining columns
+            packed_weights = prepack_op(torch.randn(50, 36))
+            lengths = torch.tensor([3, 0, 5, 1, 7], dtype=torch.int)
+            indices = torch.randint(50, (int(lengths.sum()),))
+            offsets = torch.cat((torch.zeros(1, dtype=torch.long), lengths.long().cumsum(0)[:-1]))
+            per_sample_weights = torch.randn(indices.numel())
+            for mode, psw in ((0, None), (1, None), (0, per_sample_weights)):
+                self.assertEqual(
+                    lengths_op(packed_weights, indices, lengths, mode, psw),
+                    offsets_op(packed_weights, indices, offsets, mode=mode,
+                               per_sample_weights=psw))
+            with self.assertRaisesRegex(RuntimeError, "lengths have to sum up"):
+                lengths_op(packed_weights, indices, lengths[:-1])
+
+    def test_embedding_bag_errors(self):
+        packed_weights = torch.ops.quantized.embedding_bag_byte_prepack(torch.randn(10, 4))
+        indices = torch.tensor([1, 2, 10])
+        offsets = torch.tensor([0, 2])
+        with self.assertRaisesRegex(RuntimeError, "only supports mode='sum' and mode='mean'"):
+            torch.ops.quantized.embedding_bag_byte_rowwise_offsets(
+                packed_weights, indices, offsets, mode=2)
+        with self.assertRaisesRegex(RuntimeError, "out of bounds"):
+            torch.ops.quantized.embedding_bag_byte_rowwise_offsets(
+                packed_weights, indices, offsets)
+
+
 @unittest.skipUnless('qnnpack' in torch.backends.quantized.supported_engines,
                      "This Pytorch Build has not been built with QNNPACK")
 @unittest.skipIf(IS_PPC, "QNNPACK is not currently supported on ppc64le")
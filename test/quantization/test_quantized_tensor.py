@@ -230,6 +230,28 @@ class TestQuantizedTensor(TestCase):
         self.assertTrue(np.allclose(qr.int_repr(), quantize_c(r, scales, zero_points)))
         self.assertTrue(np.allclose(r.numpy(), rqr.numpy(), atol=2 / np.min(scales.numpy())))
 
+    def test_qtensor_quantize_per_channel_vectorized(self):
+        # 70 elements per channel cover the vectorized loops and their tails for
+        # every dtype, the innermost axis leaves one element per channel.
+        shape = (2, 3, 70)
+        quant_ranges = {torch.qint8: (-128, 127), torch.quint8: (0, 255), torch.qint32: (-2 ** 31, 2 ** 31 - 1)}
+        for dtype, (quant_min, quant_max) in quant_ranges.items():
+            for axis in range(len(shape)):
+                channels = shape[axis]
+                param_shape = [1] * len(shape)
+                param_shape[axis] = channels
+                scales = torch.rand(channels, dtype=torch.double) * 0.02 + 0.01
+                zero_points = torch.randint(-5, 5, (channels,), dtype=torch.long) + (quant_min + quant_max + 1) // 2
+                scale = scales.float().view(param_shape)
+                zero_point = zero_points.view(param_shape)
+                # keep away from rounding ties, and clamp the 8 bit types
+                q = zero_point + torch.randint(-150, 150, shape, dtype=torch.long)
+                r = ((q - zero_point).float() + torch.rand(shape) * 0.8 - 0.4) * scale
+                qr = torch.quantize_per_channel(r, scales, zero_points, axis, dtype)
+                expected = q.clamp(quant_min, quant_max)
+                self.assertEqual(qr.int_repr().long(), expected)
+                self.assertEqual(qr.dequantize(), (expected - zero_point).float() * scale)
+
     def test_qtensor_permute(self):
         scale = 0.02
         zero_point = 1
@@ -428,6 +428,22 @@ class TestRecordHistogramObserver(QuantizationTestCase):
         qparams = myobs.calculate_qparams()
         self.assertEqual(qparams[1].item(), 0)
 
+    def test_histogram_l2_range_search(self):
+        # the values in the first half of the range plus one outlier at the
+        # end, which is clipped by the search
+        histogram = torch.zeros(2048)
+        histogram[:1024] = 1000.
+        histogram[-1] = 1.
+        new_min, new_max = torch._histogram_l2_range_search(histogram, 0., 2048., 256)
+        self.assertGreaterEqual(new_min, 0.)
+        self.assertLess(new_min, new_max)
+        self.assertLessEqual(new_max, 1024.)
+
+        myobs = HistogramObserver(bins=2048)
+        myobs(torch.cat([torch.rand(100000), torch.tensor([100.])]))
+        new_min, new_max = myobs._non_linear_param_search()
+        self.assertLess(new_max.item(), 2.)
+
 class TestFakeQuantizePerTensor(TestCase):
     @given(device=st.sampled_from(['cpu', 'cuda'] if torch.cuda.is_available() else ['cpu']),
            X=hu.tensor(shapes=hu.array_shapes(1, 5,),
@@ -614,6 +630,29 @@ class TestFakeQuantizePerChannel(TestCase):
         Y_prime.backward(dout)
         np.testing.assert_allclose(dX.cpu().detach().numpy(), X.grad.cpu().detach().numpy(), rtol=tolerance, atol=tolerance)
 
+    def test_forward_backward_per_channel_vectorized(self):
+        r"""Tests the vectorized CPU loops, their tails and the strided loop.
+        """
+        quant_min, quant_max = 0, 255
+        # The 37 elements of a channel along an outer axis are 4 vectors and a
+        # tail. Along the innermost axis, the parameters change every element.
+        X = torch.randn(2, 3, 37) * 3
+        for axis in range(X.dim()):
+            channels = X.size(axis)
+            scale = torch.rand(channels) * 0.02 + 0.01
+            zero_point = torch.randint(100, 150, (channels,), dtype=torch.int64)
+            X = X.detach().requires_grad_()
+            Y = _fake_quantize_per_channel_affine_reference(X.detach(), scale, zero_point, axis, quant_min, quant_max)
+            Y_prime = torch.fake_quantize_per_channel_affine(
+                X, scale, zero_point, axis, quant_min, quant_max)
+            np.testing.assert_allclose(Y, Y_prime.detach(), rtol=tolerance, atol=tolerance)
+
+            dout = torch.rand(X.shape, dtype=torch.float)
+            dX = _fake_quantize_per_channel_affine_grad_reference(
+                dout, X.detach(), scale, zero_point, axis, quant_min, quant_max)
+            Y_prime.backward(dout)
+            np.testing.assert_allclose(dX.numpy(), X.grad.numpy(), rtol=tolerance, atol=tolerance)
+
     @given(device=st.sampled_from(['cpu', 'cuda'] if torch.cuda.is_available() else ['cpu']),
            X=hu.per_channel_tensor(shapes=hu.array_shapes(1, 5,),
            qparams=hu.qparams(dtypes=torch.quint8)))
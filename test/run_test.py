@@ -37,6 +37,7 @@ TESTS = [
     'test_distributions',
     'test_docs_coverage',
     'test_expecttest',
+    'test_foreach',
     'test_indexing',
     'test_jit',
     'test_logging',
@@ -562,6 +562,45 @@ class TestAutograd(TestCase):
         self.assertEqual(counter[0], 1, 'bw_hook not called')
         self.assertEqual(x.grad, torch.ones(5, 5) * 2, atol=1e-5)
 
+    def test_hooks_script(self):
+        @torch.jit.script
+        def double_grad(grad):
+            return grad * 2
+
+        @torch.jit.script
+        def keep_grad(grad):
+            # type: (Tensor) -> Optional[Tensor]
+            return None
+
+        x = torch.ones(5, 5, requires_grad=True)
+        y = x * 3
+        y.register_hook(keep_grad)
+        y.register_hook(double_grad)
+        y.sum().backward()
+        self.assertEqual(x.grad, torch.ones(5, 5) * 6)
+
+        with torch.no_grad():
+            x.grad.zero_()
+        y = x * 3
+        y.register_hook(double_grad).remove()
+        y.sum().backward()
+        self.assertEqual(x.grad, torch.ones(5, 5) * 3)
+
+        handle = x.register_hook(double_grad)
+        with torch.no_grad():
+            x.grad.zero_()
+        x.sum().backward()
+        self.assertEqual(x.grad, torch.ones(5, 5) * 2)
+        handle.remove()
+
+        @torch.jit.script
+        def bad_hook(grad, scale):
+            # type: (Tensor, float) -> Tensor
+            return grad * scale
+
+        with self.assertRaisesRegex(RuntimeError, "must take a Tensor"):
+            x.register_hook(bad_hook)
+
     def test_hook_none(self):
         # WARNING: this is a test for autograd internals.
         # You should never have to use such things in your code.
@@ -901,6 +940,38 @@ class TestAutograd(TestCase):
             w = adder(x, y)
             self.assertFalse(torch.is_grad_enabled())
 
+    def test_inference_mode(self):
+        x = torch.ones(5, 5, requires_grad=True)
+        y = torch.ones(5, 5) * 4
+        with torch.autograd.inference_mode():
+            self.assertFalse(torch.is_grad_enabled())
+            w = x + y
+            v = y.view(25)
+            y.add_(1)
+            v.mul_(2)
+
+        @torch.autograd.inference_mode()
+        def adder(x, y):
+            return x + y
+
+        z = adder(x, y)
+        self.assertTrue(torch.is_grad_enabled())
+        self.assertFalse(w.requires_grad)
+        self.assertIsNone(w.grad_fn)
+        self.assertFalse(z.requires_grad)
+        self.assertEqual(z, x + y)
+
+        # no view tracking and no version counter bump
+        self.assertIsNone(v._base)
+        self.assertEqual(y._version, 0)
+        self.assertEqual(y, torch.full((5, 5), 10.))
+
+        with torch.autograd.inference_mode():
+            with torch.enable_grad():
+                # the autograd kernels are still skipped
+                self.assertFalse((x * 2).requires_grad)
+        self.assertTrue((x * 2).requires_grad)
+
     def test_set_grad_generator_functions(self):
         @torch.no_grad()
         def gen_no_grad():
@@ -2782,6 +2853,111 @@ class TestAutograd(TestCase):
         self.assertTrue('cpu' in prof_str.lower())
         self.assertTrue('cuda' not in prof_str.lower())
 
+    def test_profiler_memory(self):
+        x = torch.randn(10, 10)
+        with profile(profile_memory=True) as prof:
+            y = torch.mm(x, x)
+            with record_function("scratch"):
+                z = torch.empty(25, 25)
+                del z
+        self.assertEqual(y.size(), (10, 10))
+
+        mm_events = [evt for evt in prof.function_events if evt.name == 'mm']
+        self.assertEqual(len(mm_events), 1)
+        mm = mm_events[0]
+        self.assertEqual(mm.cpu_memory_usage, 10 * 10 * 4)
+        self.assertEqual(mm.cpu_memory_peak, 10 * 10 * 4)
+        self.assertEqual(mm.cuda_memory_usage, 0)
+
+        scratch = [evt for evt in prof.function_events if evt.name == 'scratch'][0]
+        self.assertEqual(scratch.cpu_memory_usage, 0)
+        self.assertEqual(scratch.cpu_memory_peak, 25 * 25 * 4)
+
+        stats = prof.key_averages()
+        mm_avg = [evt for evt in stats if evt.key == 'mm'][0]
+        self.assertEqual(mm_avg.self_cpu_memory_usage, 10 * 10 * 4)
+        self.assertTrue('CPU Mem' in prof.table(sort_by='cpu_memory_usage'))
+
+        # nothing is recorded unless asked for
+        with profile() as prof:
+            torch.mm(x, x)
+        for evt in prof.function_events:
+            self.assertEqual(evt.cpu_memory_usage, 0)
+
+    @unittest.skipIf(not sys.platform.startswith('linux'), "perf counters are Linux only")
+    def test_profiler_perf_counters(self):
+        x = torch.randn(64, 64)
+        try:
+            with profile(perf_events=['cycles', 'instructions']) as prof:
+                torch.mm(x, x)
+        except RuntimeError as e:
+            if 'perf_event_open' not in str(e):
+                raise
+            raise unittest.SkipTest("perf counters are not available: " + str(e))
+
+        mm = [evt for evt in prof.function_events if evt.name == 'mm'][0]
+        self.assertEqual(set(mm.perf_counters.keys()), {'cycles', 'instructions'})
+        self.assertTrue(mm.perf_counters['instructions'] > 0)
+        table = prof.key_averages().table()
+        self.assertTrue('instructions' in table)
+        self.assertTrue('IPC' in table)
+
+        with self.assertRaisesRegex(RuntimeError, "Unknown perf event"):
+            with profile(perf_events=['not_a_counter']):
+                pass
+
+    def test_profiler_grad_accumulation(self):
+        a = torch.randn(5, requires_grad=True)
+        with profile() as prof:
+            # the two gradients of a are summed into one of them, which
+            # then becomes a.grad
+            (a * 2 + a * 3).sum().backward()
+        self.assertEqual(prof.grad_accumulation,
+                         {'stolen': 1, 'inplace': 1, 'copied': 0})
+        with profile() as prof:
+            (a * 2 + a * 3).sum().backward()
+        self.assertEqual(prof.grad_accumulation,
+                         {'stolen': 0, 'inplace': 2, 'copied': 0})
+        self.assertEqual(a.grad, torch.full((5,), 10.))
+
+    def test_grad_accumulation_respects_references(self):
+        a = torch.randn(3, requires_grad=True)
+        saved = []
+        a.register_hook(lambda grad: saved.append(grad))
+        with profile() as prof:
+            (a * 2 + a * 3).sum().backward()
+        # the hook holds on to the gradient so it can't be stolen
+        self.assertEqual(prof.grad_accumulation['copied'], 1)
+        (a * 2 + a * 3).sum().backward()
+        self.assertEqual(saved[0], torch.full((3,), 5.))
+        self.assertEqual(saved[1], torch.full((3,), 5.))
+        self.assertEqual(a.grad, torch.full((3,), 10.))
+
+        # gradients shared with other tensors or requiring grad themselves
+        # are never summed in place
+        b = torch.randn(3, requires_grad=True)
+        shared = torch.ones(3)
+
+        class Identity(Function):
+            @staticmethod
+            def forward(ctx, x):
+                return x.clone()
+
+            @staticmethod
+            def backward(ctx, grad):
+                return shared
+
+        (Identity.apply(b) + Identity.apply(b)).sum().backward()
+        self.assertEqual(shared, torch.ones(3))
+        self.assertEqual(b.grad, torch.full((3,), 2.))
+
+        c = torch.randn(3, requires_grad=True)
+        out = (c * c + c * c).sum()
+        grad_c, = torch.autograd.grad(out, c, create_graph=True)
+        self.assertEqual(grad_c, 4 * c)
+        grad_c.sum().backward()
+        self.assertEqual(c.grad, torch.full((3,), 4.))
+
     def test_profiler_aggregation_lstm(self):
         print("")
         rnn = torch.nn.LSTM(10, 20, 2)
@@ -44,6 +44,7 @@ TEST_MAGMA = TEST_CUDA
 TEST_LARGE_TENSOR = TEST_CUDA
 TEST_MEDIUM_TENSOR = TEST_CUDA
 TEST_CUDNN = TEST_CUDA
+TEST_CUDA_GRAPHS = TEST_CUDA and not TEST_WITH_ROCM and int(torch.version.cuda.split(".")[0]) >= 11
 if TEST_CUDA:
     torch.ones(1).cuda()  # has_magma shows up after cuda is initialized
     TEST_CUDNN = TEST_CUDA and (TEST_WITH_ROCM or
@@ -285,6 +286,22 @@ class TestCuda(TestCase):
         for _ in self._test_memory_stats_generator(self):
             self._check_memory_stat_consistency()
 
+    def test_memory_stats_free_blocks(self):
+        gc.collect()
+        torch.cuda.empty_cache()
+        a = torch.cuda.FloatTensor(3 * 1024 * 1024)
+        b = torch.cuda.FloatTensor(1024 * 1024)
+        del a
+        stats = torch.cuda.memory_stats()
+        counts = stats["free_blocks.count"]
+        sizes = stats["free_blocks.bytes"]
+        self.assertEqual(len(counts), len(sizes))
+        self.assertGreater(sum(counts), 0)
+        self.assertEqual(sum(sizes), stats["reserved_bytes.all.current"] - stats["active_bytes.all.current"])
+        self.assertLessEqual(stats["free_blocks.largest"], sum(sizes))
+        self.assertGreaterEqual(stats["free_blocks.largest"], 3 * 1024 * 1024 * 4)
+        del b
+
     def test_memory_allocation(self):
         gc.collect()
         torch.cuda.empty_cache()
@@ -643,6 +660,45 @@ class TestCuda(TestCase):
         ]
         self._test_broadcast_coalesced(self, tensors, 256)
 
+    @unittest.skipIf(not TEST_MULTIGPU, "only one GPU detected")
+    def test_coalesced_broadcast(self):
+        numel = 5
+        num_bytes = numel * 8
+        tensors = [
+            torch.randn(numel).long().cuda(),
+            torch.randn(numel).cuda(),
+            torch.tensor([]).byte().cuda(),
+            torch.randn(2, numel).cuda(),
+            torch.randn(numel * 2).int().cuda(),
+        ]
+        bc = comm.CoalescedBroadcast((0, 1), buffer_size=num_bytes * 5 // 2)
+        outputs = bc.broadcast(tensors)
+        bc.wait()
+        self.assertEqual(len(outputs), 2)
+        for inp_t, out_t in zip(tensors, outputs[0]):
+            self.assertIs(inp_t, out_t)
+        for t, bt in zip(tensors, outputs[1]):
+            self.assertEqual(bt.get_device(), 1)
+            self.assertEqual(bt, t)
+
+        # The buffers are reused, and overwritten by the next broadcast
+        data_ptrs = [t.data_ptr() for t in outputs[1]]
+        for t in tensors:
+            t.add_(1)
+        outputs = bc.broadcast(tensors)
+        bc.synchronize()
+        self.assertTrue(bc.query())
+        self.assertEqual([t.data_ptr() for t in outputs[1]], data_ptrs)
+        for t, bt in zip(tensors, outputs[1]):
+            self.assertEqual(bt, t)
+
+        # Other sizes get new buffers
+        outputs = bc.broadcast(tensors[:2])
+        bc.wait()
+        self.assertEqual(len(outputs[1]), 2)
+        for t, bt in zip(tensors, outputs[1]):
+            self.assertEqual(bt, t)
+
     @unittest.skipIf(not TEST_MULTIGPU, "only one GPU detected")
     def test_reduce_add(self):
         x = torch.randn(5, 5)
@@ -1513,6 +1569,48 @@ class TestCuda(TestCase):
         self.assertNotEqual(t.data_ptr(), ptr, 'allocation re-used too soon')
         self.assertEqual(list(gpu_tensor), [1])
 
+    def test_caching_pinned_memory_stats_and_limit(self):
+        torch.cuda.synchronize()
+        torch.cuda.reset_host_memory_stats()
+        before = torch.cuda.host_memory_stats()
+
+        # requests are rounded to size classes: a 1000 bytes tensor gets a
+        # 1024 bytes block, from a slab shared with other blocks of the class
+        t = torch.empty(1000, dtype=torch.uint8).pin_memory()
+        stats = torch.cuda.host_memory_stats()
+        self.assertEqual(stats["num_allocs"], before["num_allocs"] + 1)
+        self.assertEqual(stats["allocated_bytes"]["current"], before["allocated_bytes"]["current"] + 1024)
+        self.assertEqual(stats["requested_bytes"], before["requested_bytes"] + 1000)
+        self.assertGreaterEqual(stats["reserved_bytes"]["current"], stats["allocated_bytes"]["current"])
+        self.assertGreaterEqual(stats["size_classes"][1024]["allocated"], 1)
+
+        ptr = t.data_ptr()
+        del t
+        t = torch.empty(900, dtype=torch.uint8).pin_memory()
+        self.assertEqual(t.data_ptr(), ptr, 'allocation not reused')
+        self.assertEqual(torch.cuda.host_memory_stats()["num_cache_hits"], before["num_cache_hits"] + 1)
+        del t
+
+        try:
+            # under the limit, the unused slabs are released to make room
+            limit = torch.cuda.host_memory_stats()["reserved_bytes"]["current"] + 64 * 1024 * 1024
+            torch.cuda.set_host_memory_limit(limit)
+            self.assertEqual(torch.cuda.host_memory_stats()["limit_bytes"], limit)
+            for _ in range(4):
+                t = torch.empty(48 * 1024 * 1024, dtype=torch.uint8).pin_memory()
+                del t
+                t = torch.empty(40 * 1024 * 1024, dtype=torch.uint8).pin_memory()
+                del t
+            stats = torch.cuda.host_memory_stats()
+            self.assertLessEqual(stats["reserved_bytes"]["current"], limit)
+            self.assertGreater(stats["num_slab_evictions"], 0)
+
+            # beyond it, allocations fail
+            with self.assertRaisesRegex(RuntimeError, "host memory limit"):
+                torch.empty(128 * 1024 * 1024, dtype=torch.uint8).pin_memory()
+        finally:
+            torch.cuda.set_host_memory_limit(None)
+
     @unittest.skipIf(not TEST_MULTIGPU, "only one GPU detected")
     def test_caching_pinned_memory_multi_gpu(self):
         # checks that the events preventing pinned memory from being re-used
@@ -1538,6 +1636,26 @@ class TestCuda(TestCase):
         self.assertEqual(gpu_tensor1[0], 1)
         self.assertEqual(gpu_tensor0[0], 2)
 
+    def test_addmm_bias_epilogue(self):
+        # addmm of a bias row broadcast over a contiguous result (as in
+        # nn.Linear) adds the bias in the epilogue of the cuBLASLt GEMM; also
+        # check the algorithms picked in benchmark mode, and odd shapes.
+        for dtype in (torch.half, torch.float, torch.double):
+            atol = 1e-1 if dtype == torch.half else 1e-5
+            for benchmark in (False, True):
+                with torch.backends.cuda.cublas_flags(benchmark=benchmark):
+                    for m, n, k in ((37, 48, 64), (128, 96, 256), (5, 3, 7)):
+                        x = torch.randn(m, k, dtype=dtype, device='cuda')
+                        w = torch.randn(n, k, dtype=dtype, device='cuda')
+                        b = torch.randn(n, dtype=dtype, device='cuda')
+                        x64, w64, b64 = x.double().cpu(), w.double().cpu(), b.double().cpu()
+                        self.assertEqual(torch.nn.functional.linear(x, w, b).double().cpu(),
+                                         torch.addmm(b64, x64, w64.t()), atol=atol, rtol=0)
+                        self.assertEqual(torch.addmm(b, x, w.t(), alpha=0.5).double().cpu(),
+                                         torch.addmm(b64, x64, w64.t(), alpha=0.5), atol=atol, rtol=0)
+                        self.assertEqual(torch.mm(x, w.t()).double().cpu(), torch.mm(x64, w64.t()),
+                                         atol=atol, rtol=0)
+
     def test_caching_allocator_record_stream_oom(self):
         """allocations delayed by a record_stream call should still be freed on
         an out-of-memory in cuda_malloc_retry. see issue #19219"""
@@ -1558,6 +1676,85 @@ class TestCuda(TestCase):
         # cached blocks in case it affects future tests.
         torch.cuda.empty_cache()
 
+    @unittest.skipIf(not TEST_CUDA_GRAPHS, "CUDA >= 11.0 required for graphs")
+    def test_graph_capture_simple(self):
+        s = torch.cuda.Stream()
+
+        with torch.cuda.stream(s):
+            a = torch.full((1000,), 1, device="cuda")
+            g = torch.cuda.CUDAGraph()
+            g.capture_begin()
+            b = a
+            for _ in range(10):
+                b = b + 1
+            g.capture_end()
+        torch.cuda.current_stream().wait_stream(s)
+
+        # nothing ran during the capture
+        g.replay()
+        self.assertEqual(b.sum().item(), 11000.)
+
+        # replays see new values copied into the captured input
+        a.fill_(2)
+        g.replay()
+        self.assertEqual(b.sum().item(), 12000.)
+
+    @unittest.skipIf(not TEST_CUDA_GRAPHS, "CUDA >= 11.0 required for graphs")
+    def test_graph_rng_functional(self):
+        a = torch.randn(10000, device="cuda")
+
+        torch.cuda.manual_seed(5)
+        eager_outs = [torch.nn.functional.dropout(a, p=0.1) for _ in range(3)]
+
+        torch.cuda.manual_seed(5)
+        g = torch.cuda.CUDAGraph()
+        s = torch.cuda.Stream()
+        s.wait_stream(torch.cuda.current_stream())
+        with torch.cuda.stream(s):
+            g.capture_begin()
+            out = torch.nn.functional.dropout(a, p=0.1)
+            g.capture_end()
+        torch.cuda.current_stream().wait_stream(s)
+
+        # every replay draws the random numbers the next eager call would have
+        for expected in eager_outs:
+            g.replay()
+            self.assertEqual(out, expected)
+        self.assertNotEqual(eager_outs[0], eager_outs[1])
+
+    @unittest.skipIf(not TEST_CUDA_GRAPHS, "CUDA >= 11.0 required for graphs")
+    def test_graph_memory_is_kept(self):
+        s = torch.cuda.Stream()
+        a = torch.ones(1 << 20, device="cuda")
+        s.wait_stream(torch.cuda.current_stream())
+        with torch.cuda.stream(s):
+            g = torch.cuda.CUDAGraph()
+            g.capture_begin()
+            b = (a * 2).sum()
+            g.capture_end()
+        torch.cuda.current_stream().wait_stream(s)
+
+        # the temporary of the graph must survive empty_cache
+        torch.cuda.empty_cache()
+        reserved = torch.cuda.memory_reserved()
+        torch.cuda.empty_cache()
+        self.assertEqual(torch.cuda.memory_reserved(), reserved)
+        g.replay()
+        self.assertEqual(b.item(), 2. * (1 << 20))
+
+        del b
+        g.reset()
+        torch.cuda.empty_cache()
+        self.assertLess(torch.cuda.memory_reserved(), reserved)
+
+    @unittest.skipIf(not TEST_CUDA_GRAPHS, "CUDA >= 11.0 required for graphs")
+    def test_graph_errors(self):
+        g = torch.cuda.CUDAGraph()
+        with self.assertRaisesRegex(RuntimeError, "non-default stream"):
+            g.capture_begin()
+        with self.assertRaisesRegex(RuntimeError, "without a preceding successful capture"):
+            g.replay()
+
     # Tests for historic illegal memory access, see #17040.
     def test_reduction_gpu_memory_accessing(self):
         x = torch.ones(512, 8, dtype=torch.float32, device='cuda')
@@ -1665,6 +1862,39 @@ class TestCuda(TestCase):
                             self.assertEqual(torch.backends.cuda.cufft_plan_cache.max_size, 10)  # default is cuda:0
                         self.assertEqual(torch.backends.cuda.cufft_plan_cache.max_size, 11)  # default is cuda:1
 
+    @skipIfRocm
+    def test_fft_plan_cache_concurrent_streams(self):
+        # threads on their own streams share the cached plans, with a cache
+        # small enough for plans to be evicted while they are in use
+        inputs = [torch.randn(64, 2 ** (4 + i % 4), 2, device='cuda') for i in range(8)]
+        expected = [x.fft(1) for x in inputs]
+        original = torch.backends.cuda.cufft_plan_cache.max_size
+        torch.backends.cuda.cufft_plan_cache.max_size = 2
+        results = [[] for _ in range(4)]
+        errors = []
+
+        def worker(t):
+            try:
+                with torch.cuda.stream(torch.cuda.Stream()):
+                    for _ in range(20):
+                        results[t].append([x.fft(1) for x in inputs])
+                    torch.cuda.current_stream().synchronize()
+            except Exception as e:
+                errors.append(e)
+
+        try:
+            threads = [threading.Thread(target=worker, args=(t,)) for t in range(4)]
+            for thread in threads:
+                thread.start()
+            for thread in threads:
+                thread.join()
+        finally:
+            torch.backends.cuda.cufft_plan_cache.max_size = original
+        self.assertEqual(errors, [])
+        for thread_results in results:
+            for result in thread_results:
+                self.assertEqual(result, expected)
+
     def test_multinomial_ext(self):
         # Test two corner cases from older PyTorch (Issue #4858)
         freqs = torch.cuda.FloatTensor([
@@ -0,0 +1,216 @@
+import torch
+from torch.testing._internal.common_utils import TestCase, run_tests
+from torch.testing._internal.common_device_type import \
+    (instantiate_device_type_tests, dtypes, dtypesIfCUDA, onlyCUDA)
+
+
+class TestForeach(TestCase):
+    # Lists with more tensors than fit in one launch of the multi-tensor
+    # kernels, a tensor spanning several chunks, an empty tensor and, with
+    # contiguous=False, a non-contiguous tensor that takes the slow route.
+    def _get_test_data(self, device, dtype, contiguous=True):
+        tensors = [torch.randn(3, 5, device=device, dtype=dtype) for _ in range(150)]
+        tensors.append(torch.randn(3 * 65536 + 7, device=device, dtype=dtype))
+        tensors.append(torch.empty(0, device=device, dtype=dtype))
+        if not contiguous:
+            tensors.append(torch.randn(10, 6, device=device, dtype=dtype).t())
+        return tensors
+
+    def _like(self, tensors, positive=False):
+        others = [torch.randn_like(t) for t in tensors]
+        if positive:
+            others = [o.abs() + 0.5 for o in others]
+        return others
+
+    @dtypes(torch.float, torch.double)
+    @dtypesIfCUDA(torch.half, torch.float, torch.double)
+    def test_binary_op_scalar(self, device, dtype):
+        for contiguous in (True, False):
+            for foreach_op, op in ((torch._foreach_add, torch.add), (torch._foreach_mul, torch.mul)):
+                tensors = self._get_test_data(device, dtype, contiguous)
+                expected = [op(t, 2) for t in tensors]
+                result = foreach_op(tensors, 2)
+                self.assertEqual(result, expected)
+
+            tensors = self._get_test_data(device, dtype, contiguous)
+            expected = [t + 3 for t in tensors]
+            torch._foreach_add_(tensors, 3)
+            self.assertEqual(tensors, expected)
+            expected = [t * 0.5 for t in tensors]
+            torch._foreach_mul_(tensors, 0.5)
+            self.assertEqual(tensors, expected)
+
+    @dtypes(torch.float, torch.double)
+    @dtypesIfCUDA(torch.half, torch.float, torch.double)
+    def test_binary_op_list(self, device, dtype):
+        for contiguous in (True, False):
+            tensors1 = self._get_test_data(device, dtype, contiguous)
+            tensors2 = self._like(tensors1)
+            self.assertEqual(torch._foreach_add(tensors1, tensors2),
+                             [t1 + t2 for t1, t2 in zip(tensors1, tensors2)])
+            self.assertEqual(torch._foreach_add(tensors1, tensors2, alpha=-2),
+                             [t1 - 2 * t2 for t1, t2 in zip(tensors1, tensors2)])
+            self.assertEqual(torch._foreach_mul(tensors1, tensors2),
+                             [t1 * t2 for t1, t2 in zip(tensors1, tensors2)])
+
+            expected = [t1.add(t2, alpha=0.5) for t1, t2 in zip(tensors1, tensors2)]
+            torch._foreach_add_(tensors1, tensors2, alpha=0.5)
+            self.assertEqual(tensors1, expected)
+            expected = [t1 * t2 for t1, t2 in zip(tensors1, tensors2)]
+            torch._foreach_mul_(tensors1, tensors2)
+            self.assertEqual(tensors1, expected)
+
+    @dtypes(torch.float, torch.double)
+    @dtypesIfCUDA(torch.half, torch.float, torch.double)
+    def test_pointwise_op(self, device, dtype):
+        for contiguous in (True, False):
+            for foreach_op, op in ((torch._foreach_addcmul_, torch.addcmul), (torch._foreach_addcdiv_, torch.addcdiv)):
+                tensors = self._get_test_data(device, dtype, contiguous)
+                tensors1 = self._like(tensors)
+                tensors2 = self._like(tensors, positive=True)
+                expected = [op(t, t1, t2, value=-0.5) for t, t1, t2 in zip(tensors, tensors1, tensors2)]
+                foreach_op(tensors, tensors1, tensors2, value=-0.5)
+                self.assertEqual(tensors, expected)
+
+    def test_list_checks(self, device):
+        tensors = [torch.randn(2, 3, device=device) for _ in range(3)]
+        with self.assertRaisesRegex(RuntimeError, "at least one tensor"):
+            torch._foreach_add([], 1)
+        with self.assertRaisesRegex(RuntimeError, "same number of tensors"):
+            torch._foreach_add(tensors, tensors[:2])
+        with self.assertRaisesRegex(RuntimeError, "same size"):
+            torch._foreach_mul_(tensors, [torch.randn(3, 2, device=device) for _ in range(3)])
+
+    def _adam_reference(self, p, grad, exp_avg, exp_avg_sq, max_exp_avg_sq, step,
+                        lr, beta1, beta2, weight_decay, eps, amsgrad):
+        bias_correction1 = 1 - beta1 ** step
+        bias_correction2 = 1 - beta2 ** step
+        if weight_decay != 0:
+            grad = grad.add(p, alpha=weight_decay)
+        exp_avg.mul_(beta1).add_(grad, alpha=1 - beta1)
+        exp_avg_sq.mul_(beta2).addcmul_(grad, grad, value=1 - beta2)
+        if amsgrad:
+            torch.max(max_exp_avg_sq, exp_avg_sq, out=max_exp_avg_sq)
+            denom = (max_exp_avg_sq.sqrt() / bias_correction2 ** 0.5).add_(eps)
+        else:
+            denom = (exp_avg_sq.sqrt() / bias_correction2 ** 0.5).add_(eps)
+        p.addcdiv_(exp_avg, denom, value=-lr / bias_correction1)
+
+    @dtypes(torch.float, torch.double)
+    def test_fused_adam(self, device, dtype):
+        for amsgrad, weight_decay, contiguous in ((False, 0, True), (True, 0.1, True), (True, 0.1, False)):
+            params = self._get_test_data(device, dtype, contiguous)
+            grads = self._like(params)
+            state = [[torch.rand_like(p) for p in params] for _ in range(3)]
+            # the parameters are usually, but not necessarily, at the same step
+            steps = [3] * (len(params) - 2) + [1, 5]
+            kwargs = dict(lr=0.01, beta1=0.9, beta2=0.99, weight_decay=weight_decay, eps=1e-8, amsgrad=amsgrad)
+
+            expected = [t.clone() for t in params]
+            expected_state = [[t.clone() for t in s] for s in state]
+            for i in range(len(params)):
+                self._adam_reference(expected[i], grads[i], *[s[i] for s in expected_state], steps[i], **kwargs)
+
+            torch._fused_adam_(params, grads, state[0], state[1], state[2] if amsgrad else [], steps, **kwargs)
+            self.assertEqual(params, expected)
+            self.assertEqual(state[0], expected_state[0])
+            self.assertEqual(state[1], expected_state[1])
+            self.assertEqual(state[2], expected_state[2])
+
+    @dtypes(torch.float, torch.double)
+    def test_fused_sgd(self, device, dtype):
+        for momentum, weight_decay, nesterov, contiguous in ((0, 0, False, True), (0.9, 0.1, False, True),
+                                                             (0.9, 0, True, True), (0.9, 0.1, True, False)):
+            params = self._get_test_data(device, dtype, contiguous)
+            grads = self._like(params)
+            bufs = self._like(params) if momentum != 0 else []
+            lr, dampening = 0.1, 0.2
+
+            expected = [p.clone() for p in params]
+            expected_bufs = [b.clone() for b in bufs]
+            for i, (p, grad) in enumerate(zip(expected, grads)):
+                d_p = grad.add(p, alpha=weight_decay) if weight_decay != 0 else grad
+                if momentum != 0:
+                    buf = expected_bufs[i]
+                    buf.mul_(momentum).add_(d_p, alpha=1 - dampening)
+                    d_p = d_p.add(buf, alpha=momentum) if nesterov else buf
+                p.add_(d_p, alpha=-lr)
+
+            torch._fused_sgd_(params, grads, bufs, lr, momentum, dampening, weight_decay, nesterov)
+            self.assertEqual(params, expected)
+            self.assertEqual(bufs, expected_bufs)
+
+    @dtypes(torch.float, torch.double)
+    def test_fused_adagrad(self, device, dtype):
+        for weight_decay, contiguous in ((0, True), (0.1, True), (0.1, False)):
+            params = self._get_test_data(device, dtype, contiguous)
+            grads = self._like(params)
+            sums = [torch.rand_like(p) for p in params]
+            steps = [3] * (len(params) - 2) + [1, 5]
+            lr, lr_decay, eps = 0.1, 0.01, 1e-10
+
+            expected = [p.clone() for p in params]
+            expected_sums = [s.clone() for s in sums]
+            for p, grad, state_sum, step in zip(expected, grads, expected_sums, steps):
+                grad = grad.add(p, alpha=weight_decay) if weight_decay != 0 else grad
+                clr = lr / (1 + (step - 1) * lr_decay)
+                state_sum.addcmul_(grad, grad, value=1)
+                p.addcdiv_(grad, state_sum.sqrt().add_(eps), value=-clr)
+
+            torch._fused_adagrad_(params, grads, sums, steps, lr, lr_decay, weight_decay, eps)
+            self.assertEqual(params, expected)
+            self.assertEqual(sums, expected_sums)
+
+    @dtypes(torch.float, torch.double)
+    @dtypesIfCUDA(torch.half, torch.float, torch.double)
+    def test_total_norm(self, device, dtype):
+        # The other norms of the test data overflow half.
+        norm_types = (2, float('inf')) if dtype == torch.half else (0.5, 1, 2, 3.5, float('inf'))
+        rtol = 1e-2 if dtype == torch.half else 1e-4
+        for contiguous in (True, False):
+            tensors = self._get_test_data(device, dtype, contiguous)
+            flat = torch.cat([t.double().flatten() for t in tensors])
+            for norm_type in norm_types:
+                total_norm = torch._foreach_total_norm(tensors, norm_type)
+                self.assertEqual(total_norm.dtype, dtype)
+                self.assertEqual(total_norm.device, flat.device)
+                self.assertTrue(torch.allclose(total_norm.double(), flat.norm(norm_type), rtol=rtol))
+
+        self.assertEqual(torch._foreach_total_norm([torch.empty(0, device=device, dtype=dtype)]).item(), 0)
+
+    @dtypes(torch.float, torch.double)
+    @dtypesIfCUDA(torch.half, torch.float, torch.double)
+    def test_clip_by_total_norm(self, device, dtype):
+        for contiguous in (True, False):
+            for max_norm in (1., 1e6):
+                tensors = self._get_test_data(device, dtype, contiguous)
+                total_norm = torch._foreach_total_norm(tensors)
+                clip_coef = max_norm / (total_norm.item() + 1e-6)
+                expected = [t * clip_coef if clip_coef < 1 else t.clone() for t in tensors]
+                torch._foreach_clip_by_total_norm_(tensors, total_norm, max_norm)
+                self.assertEqual(tensors, expected)
+
+    @onlyCUDA
+    @dtypes(torch.half, torch.float)
+    def test_amp_foreach_non_finite_check_and_unscale(self, device, dtype):
+        inv_scale = torch.tensor([0.25], device=device)
+        for contiguous in (True, False):
+            grads = self._get_test_data(device, dtype, contiguous)
+            expected = [g.float() * 0.25 for g in grads]
+            found_inf = torch.zeros(1, device=device)
+            torch._amp_foreach_non_finite_check_and_unscale_(grads, found_inf, inv_scale)
+            self.assertEqual(found_inf.item(), 0.0)
+            self.assertEqual([g.float() for g in grads], expected)
+
+            for bad in (float('inf'), float('nan')):
+                grads = self._get_test_data(device, dtype, contiguous)
+                grads[150].fill_(bad)
+                found_inf = torch.zeros(1, device=device)
+                torch._amp_foreach_non_finite_check_and_unscale_(grads, found_inf, inv_scale)
+                self.assertEqual(found_inf.item(), 1.0)
+
+
+instantiate_device_type_tests(TestForeach, globals())
+
+if __name__ == '__main__':
+    run_tests()
@@ -1,5 +1,5 @@
 from torch.testing._internal.common_utils import TestCase, run_tests
-from torch.testing._internal.common_device_type import instantiate_device_type_tests, onlyCUDA, dtypes, dtypesIfCPU, dtypesIfCUDA
+from torch.testing._internal.common_device_type import instantiate_device_type_tests, onlyCUDA, onlyCPU, dtypes, dtypesIfCPU, dtypesIfCUDA
 import torch
 from torch import tensor
 import unittest
@@ -101,6 +101,53 @@ class TestIndexing(TestCase):
         self.assertEqual(a[-2], 13)
         self.assertEqual(a[-1], 14)
 
+    def _run_with_threads(self, num_threads, fn):
+        saved = torch.get_num_threads()
+        torch.set_num_threads(num_threads)
+        try:
+            return fn()
+        finally:
+            torch.set_num_threads(saved)
+
+    @onlyCPU
+    @dtypes(torch.float, torch.double, torch.long)
+    def test_index_put_accumulate_duplicates_deterministic(self, device, dtype):
+        # enough elements for the parallel kernels, with many duplicates
+        indices = torch.randint(100, (50000,), device=device)
+        values = torch.randn(50000, 3, device=device).mul_(100).to(dtype)
+
+        def index_put():
+            return torch.zeros(100, 3, dtype=dtype, device=device).index_put_(
+                (indices, ), values, accumulate=True)
+
+        def index_add():
+            return torch.zeros(100, 3, dtype=dtype, device=device).index_add_(
+                0, indices, values)
+
+        saved = torch.is_deterministic()
+        torch.set_deterministic(True)
+        try:
+            for fn in (index_put, index_add):
+                serial = self._run_with_threads(1, fn)
+                parallel = self._run_with_threads(4, fn)
+                self.assertEqual(serial, parallel, atol=0, rtol=0)
+                expected = torch.zeros(100, 3, dtype=torch.double).index_add_(
+                    0, indices, values.double())
+                self.assertEqual(serial.double(), expected, atol=1e-3, rtol=1e-5)
+        finally:
+            torch.set_deterministic(saved)
+
+    @onlyCPU
+    def test_index_add_1d_duplicates(self, device):
+        indices = torch.randint(100, (50000,), device=device)
+        values = torch.randn(50000, device=device)
+        expected = torch.zeros(100, dtype=torch.double).index_add_(0, indices, values.double())
+        result = self._run_with_threads(
+            4, lambda: torch.zeros(100, device=device).index_add_(0, indices, values))
+        self.assertEqual(result.double(), expected, atol=1e-3, rtol=1e-5)
+        with self.assertRaisesRegex(IndexError, "index out of range"):
+            torch.zeros(100, device=device).index_add_(0, indices + 1, values)
+
     def test_multiple_byte_mask(self, device):
         v = torch.randn(5, 7, 3, device=device)
         # note: these broadcast together and are transposed to the first dim
@@ -2270,6 +2270,42 @@ graph(%Ra, %Rb):
         f = io.BytesIO()
         torch.onnx._export(AddmmModel(), x, f, verbose=False)
 
+    def test_fuse_conv_linear_epilogue(self):
+        def conv2d_relu(x, w, b):
+            return F.relu(F.conv2d(x, w, b, padding=1))
+
+        def linear_relu_(x, w, b):
+            return F.linear(x, w, b).relu_()
+
+        def linear_relu_shared(x, w, b):
+            y = F.linear(x, w, b)
+            return F.relu(y), y
+
+        cases = [
+            (conv2d_relu, "aten::_conv2d_relu",
+             (torch.randn(2, 3, 8, 8), torch.randn(4, 3, 3, 3), torch.randn(4))),
+            (linear_relu_, "aten::_linear_relu",
+             (torch.randn(5, 6), torch.randn(7, 6), torch.randn(7))),
+        ]
+        for fn, fused, inputs in cases:
+            graph = torch.jit.script(fn).graph
+            self.run_pass('fuse_conv_linear_epilogue', graph)
+            FileCheck().check(fused).check_not("aten::relu").run(graph)
+            fused_fn = torch._C._create_function_from_graph("forward", graph)
+            with torch.no_grad():
+                self.assertEqual(fused_fn(*inputs), fn(*inputs))
+            grad_inputs = [t.clone().requires_grad_() for t in inputs]
+            fused_fn(*grad_inputs).sum().backward()
+            ref_inputs = [t.clone().requires_grad_() for t in inputs]
+            fn(*ref_inputs).sum().backward()
+            for t, ref in zip(grad_inputs, ref_inputs):
+                self.assertEqual(t.grad, ref.grad)
+
+        # the linear output has another use, so the relu can't be fused into it
+        graph = torch.jit.script(linear_relu_shared).graph
+        self.run_pass('fuse_conv_linear_epilogue', graph)
+        FileCheck().check_not("aten::_linear_relu").check("aten::relu").run(graph)
+
     def test_index_put(self):
         ten = torch.zeros(3, 3)
         mask = torch.tensor([[True, True, True],
@@ -3632,6 +3668,35 @@ class TestScript(JitTestCase):
 
         torch._C._jit_set_num_profiled_runs(old_num_runs)
 
+    @unittest.skipIf(GRAPH_EXECUTOR != ProfilingMode.PROFILING, "skip if profiling isn't enabled")
+    def test_profiling_specialized_plans(self):
+        @torch.jit.script
+        def test_not_const(x):
+            if x.size(0) == 1:
+                return 1
+            else:
+                return 2
+
+        with enable_profiling_mode():
+            old_num_runs = torch._C._jit_set_num_profiled_runs(1)
+            old_num_plans = torch._C._jit_set_num_specialized_plans(2)
+            try:
+                # every shape gets its own plan, profiled only with that shape
+                for shape in ([1, 2], [2, 2], [1, 2]):
+                    x = torch.rand(shape)
+                    self.assertEqual(test_not_const(x), 2 - (shape[0] == 1))
+                    self.assertEqual(test_not_const(x), 2 - (shape[0] == 1))
+                    graph_str = torch.jit.last_executed_optimized_graph()
+                    FileCheck().check("Double({}:2, 2:1) = ".format(shape[0])).run(graph_str)
+
+                # out of plans, so [3, 2] goes to the generic plan
+                self.assertEqual(test_not_const(torch.rand([3, 2])), 2)
+                self.assertEqual(test_not_const(torch.rand([3, 2])), 2)
+                self.assertEqual(test_not_const(torch.rand([4, 2])), 2)
+            finally:
+                torch._C._jit_set_num_profiled_runs(old_num_runs)
+                torch._C._jit_set_num_specialized_plans(old_num_plans)
+
     def test_nested_bailouts(self):
         @torch.jit.script
         def fct_loop(x):
@@ -16883,6 +16948,57 @@ a")
                     continue
                 self.assertEqual(value, getattr(loaded, "_" + name))
 
+    @unittest.skipIf(IS_WINDOWS or IS_SANDCASTLE, "NYI: TemporaryFileName support for Windows or Sandcastle")
+    def test_packed_list_serialization(self):
+        ints = list(range(-500, 500)) + [2 ** 40, -2 ** 62]
+        floats = [i / 7. for i in range(-100, 100)] + [float('inf')]
+        bools = [i % 3 == 0 for i in range(100)]
+
+        class M(torch.jit.ScriptModule):
+            def __init__(self):
+                super(M, self).__init__()
+                self.ints = torch.jit.Attribute(ints, List[int])
+                self.floats = torch.jit.Attribute(floats, List[float])
+                self.bools = torch.jit.Attribute(bools, List[bool])
+                self.short_ints = torch.jit.Attribute([1, 2, 3], List[int])
+
+            @torch.jit.script_method
+            def forward(self):
+                return self.ints, self.floats, self.bools, self.short_ints
+
+        m = M()
+        self.assertEqual(m(), self.getExportImportCopy(m)())
+
+        class Attributes(object):
+            pass
+
+        class PythonUnpickler(pickle.Unpickler):
+            def find_class(self, module, name):
+                if module.startswith('__torch__'):
+                    return Attributes
+                return super(PythonUnpickler, self).find_class(module, name)
+
+        with TemporaryFileName() as fname:
+            m.save(fname)
+            archive_name = os.path.basename(os.path.normpath(fname))
+            archive = zipfile.ZipFile(fname, 'r')
+            pickled_data = archive.read(os.path.join(archive_name, 'data.pkl'))
+
+        # Long lists are packed, short ones are not
+        out = StringIO()
+        pickletools.dis(pickled_data, out=out)
+        FileCheck().check_count("build_packed_intlist", 1, exactly=True) \
+            .check_count("build_packed_doublelist", 1, exactly=True) \
+            .check_count("build_packed_boollist", 1, exactly=True) \
+            .check_count("build_intlist", 1, exactly=True).run(out.getvalue())
+
+        # which Python's pickle decodes too
+        loaded = PythonUnpickler(io.BytesIO(pickled_data)).load()
+        self.assertEqual(loaded.ints, ints)
+        self.assertEqual(loaded.floats, floats)
+        self.assertEqual(loaded.bools, bools)
+        self.assertEqual(loaded.short_ints, [1, 2, 3])
+
     @unittest.skipIf(IS_WINDOWS or IS_SANDCASTLE, "NYI: TemporaryFileName support for Windows or Sandcastle")
     def test_old_models_bc(self):
         model = {
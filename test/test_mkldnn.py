@@ -40,6 +40,15 @@ class TestMkldnn(TestCase):
                                    "Cannot access data pointer of Tensor that doesn't have storage",
                                    lambda: mkldnn_tensor.data_ptr() != 0)
 
+    def test_conversion_bf16(self):
+        cpu_tensor = torch.randn(1, 2, 3, 4, dtype=torch.float).bfloat16()
+        mkldnn_tensor = cpu_tensor.to_mkldnn()
+        self.assertEqual(mkldnn_tensor.dtype, torch.bfloat16)
+        self.assertEqual(mkldnn_tensor.element_size(), cpu_tensor.element_size())
+        cpu_tensor_1 = mkldnn_tensor.to_dense()
+        self.assertEqual(cpu_tensor_1.dtype, torch.bfloat16)
+        self.assertEqual(cpu_tensor, cpu_tensor_1)
+
     def test_unsupported(self):
         # unsupported types and unsupported types with gpu
         for dtype in [torch.double, torch.half, torch.uint8, torch.int8,
@@ -380,6 +389,18 @@ class TestMkldnn(TestCase):
             self._test_serialization(mkldnn_linear, (x.to_mkldnn(),))
             self._test_tracing(mkldnn_linear, (x.to_mkldnn(),))
 
+    def test_linear_bf16(self):
+        # the long reductions are accumulated in float, so the outputs are
+        # within the rounding of bfloat16 of the float ones
+        x = torch.randn(3, 5, 1024)
+        linear = torch.nn.Linear(1024, 64)
+        with torch.no_grad():
+            y = linear.bfloat16()(x.bfloat16())
+            y_ref = torch.nn.functional.linear(
+                x.bfloat16().float(), linear.weight.float(), linear.bias.float())
+        self.assertEqual(y.dtype, torch.bfloat16)
+        self.assertEqual(y.float(), y_ref, atol=5e-2, rtol=1e-2)
+
     def test_softmax(self):
         x = torch.randn(3, 4, 5, dtype=torch.float32) * 10
         for dim in range(x.ndim):
@@ -63,6 +63,17 @@ def send_and_delete_tensors(queue, event, tp, count, size=5):
     event.wait()
 
 
+def send_batches(queue, ack_queue, event, count, batch_size):
+    for i in range(count):
+        batch = [torch.full([5], i * batch_size + j, device='cuda') for j in range(batch_size)]
+        queue.put(batch)
+        del batch
+        # Wait for the consumer to release the batch, so that the next one
+        # reuses its memory block and events
+        ack_queue.get()
+    event.wait()
+
+
 def receive_and_send_sum(queue, out_queue, event, tp, count, size=5):
     s = torch.full([size], 0).type(tp)
     for i in range(count):
@@ -155,9 +166,9 @@ def simple_autograd_function(a=1):
     return a ** 2
 
 @contextlib.contextmanager
-def fs_sharing():
+def fs_sharing(strategy='file_system'):
     prev_strategy = mp.get_sharing_strategy()
-    mp.set_sharing_strategy('file_system')
+    mp.set_sharing_strategy(strategy)
     try:
         yield
     finally:
@@ -333,6 +344,41 @@ class TestMultiprocessing(TestCase):
         with fs_sharing():
             self._test_pool(repeat=TEST_REPEATS)
 
+    @unittest.skipIf(IS_WINDOWS, "file system pool strategy is not supported on Windows")
+    @unittest.skipIf(TEST_WITH_ASAN,
+                     "seems to hang with ASAN, see https://github.com/pytorch/pytorch/issues/5326")
+    def test_fs_pool_sharing(self):
+        with fs_sharing('file_system_pool'):
+            self._test_sharing(repeat=TEST_REPEATS)
+
+    @unittest.skipIf(IS_WINDOWS, "file system pool strategy is not supported on Windows")
+    def test_fs_pool_preserve_sharing(self):
+        with fs_sharing('file_system_pool'):
+            self._test_preserve_sharing(repeat=TEST_REPEATS)
+
+    @unittest.skipIf(IS_WINDOWS, "file system pool strategy is not supported on Windows")
+    def test_fs_pool_blocks(self):
+        small = [torch.arange(i, dtype=torch.float).storage() for i in range(1, 100)]
+        large = torch.zeros(1 << 20).storage()
+        with fs_sharing('file_system_pool'):
+            handles = [s._share_pooled_() for s in small]
+            self.assertIsNone(large._share_pooled_())
+        # the small storages are blocks of at most two slabs
+        self.assertLessEqual(len({h[1] for h in handles}), 2)
+        self.assertEqual(len({h[1:3] for h in handles}), len(small))
+        for s in small:
+            self.assertTrue(s.is_shared())
+        self.assertFalse(large.is_shared())
+
+        q = mp.Queue()
+        with fs_sharing('file_system_pool'):
+            for s in small:
+                q.put(s)
+            received = [q.get() for _ in small]
+        for s, r in zip(small, received):
+            self.assertEqual(s.tolist(), r.tolist())
+            self.assertEqual(s.data_ptr(), r.data_ptr())
+
     @unittest.skipIf(not HAS_SHM_FILES, "don't not how to check if shm files exist")
     def test_fs(self):
         def queue_put():
@@ -394,6 +440,27 @@ class TestMultiprocessing(TestCase):
         e.set()
         p.join(1)
 
+    @unittest.skipIf(NO_MULTIPROCESSING_SPAWN, "Disabled for environments that \
+                     don't support multiprocessing with spawn start method")
+    @unittest.skipIf(not TEST_CUDA_IPC, 'CUDA IPC not available')
+    def test_cuda_send_batches(self):
+        ctx = mp.get_context('spawn')
+        q = ctx.Queue()
+        ack = ctx.Queue()
+        e = ctx.Event()
+        count, batch_size = 20, 8
+        p = ctx.Process(target=send_batches, args=(q, ack, e, count, batch_size))
+        p.start()
+        for i in range(count):
+            batch = q.get()
+            for j, t in enumerate(batch):
+                self.assertEqual(t, torch.full([5], i * batch_size + j, device='cuda'))
+            del batch, t
+            ack.put(True)
+        torch.cuda.ipc_collect()
+        e.set()
+        p.join(1)
+
     @slowTest
     @unittest.skipIf(NO_MULTIPROCESSING_SPAWN, "Disabled for environments that \
                      don't support multiprocessing with spawn start method")
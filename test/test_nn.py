@@ -1,7 +1,10 @@
 
 import math
+import os
 import random
 import string
+import subprocess
+import sys
 import unittest
 import io
 import unittest.mock as mock
@@ -44,7 +47,8 @@ from torch.testing._internal.common_nn import NNTestCase, NewModuleTest, NewCrit
     ctcloss_reference, new_module_tests
 from torch.testing._internal.common_device_type import instantiate_device_type_tests, dtypes, \
     dtypesIfCUDA, skipCUDAIfNoCudnn, skipCUDAIfCudnnVersionLessThan, onlyCUDA, \
-    skipCUDAIfRocm, skipCUDAIf, skipCUDAIfNotRocm, largeCUDATensorTest, onlyOnCPUAndCUDA
+    skipCUDAIfRocm, skipCUDAIf, skipCUDAIfNotRocm, largeCUDATensorTest, onlyOnCPUAndCUDA, \
+    onlyCPU
 
 from torch.nn import MultiheadAttention
 
@@ -609,6 +613,17 @@ class TestNN(NNTestCase):
         self.assertEqual(module.weight.grad.data, module.weight.data.clone().zero_())
         self.assertEqual(module.bias.grad.data, module.bias.data.clone().zero_())
 
+        # grads may be views, e.g. of the buckets of DistributedDataParallel
+        flat = torch.randn(30)
+        module.weight.grad = flat[:25].view(5, 5)
+        module.bias.grad = flat[25:]
+        module.zero_grad()
+        self.assertEqual(flat, torch.zeros(30))
+        optimizer = torch.optim.SGD(module.parameters(), lr=0.1)
+        flat.fill_(1)
+        optimizer.zero_grad()
+        self.assertEqual(flat, torch.zeros(30))
+
     def test_no_grad(self):
         for dtype in [torch.bfloat16, torch.float, torch.double]:
             module = nn.Conv2d(2, 5, kernel_size=3, padding=1).to(dtype)
@@ -3783,6 +3798,77 @@ class TestNN(NNTestCase):
         # but it should work with the same type
         nn.functional.conv2d(inputs.float(), weights.float())
 
+    def test_Conv2d_cpu_benchmark(self):
+        torch.backends.cpu.clear_benchmark_cache()
+        cases = [
+            (torch.randn(2, 4, 9, 9), torch.randn(6, 4, 3, 3), torch.randn(6), dict(padding=1)),
+            (torch.randn(1, 4, 8, 8), torch.randn(4, 2, 3, 3), None, dict(stride=2, groups=2)),
+            (torch.randn(3, 3, 10, 10, dtype=torch.double), torch.randn(5, 3, 3, 3, dtype=torch.double),
+             None, dict(dilation=2)),
+            (torch.randn(2, 3, 7, 7).contiguous(memory_format=torch.channels_last), torch.randn(4, 3, 1, 1),
+             torch.randn(4), dict()),
+        ]
+        expected = [F.conv2d(input, weight, bias, **kwargs) for input, weight, bias, kwargs in cases]
+        with torch.backends.cpu.flags(benchmark=True):
+            self.assertTrue(torch.backends.cpu.benchmark)
+            for (input, weight, bias, kwargs), ref in zip(cases, expected):
+                input = input.clone().requires_grad_()
+                ref_input = input.detach().clone().requires_grad_()
+                out = F.conv2d(input, weight, bias, **kwargs)
+                self.assertEqual(out, ref)
+                out.sum().backward()
+                with torch.backends.cpu.flags(benchmark=False):
+                    F.conv2d(ref_input, weight, bias, **kwargs).sum().backward()
+                self.assertEqual(input.grad, ref_input.grad)
+
+            with TemporaryFileName() as fname:
+                torch.backends.cpu.save_benchmark_cache(fname)
+                with open(fname) as f:
+                    lines = f.read().splitlines()
+                self.assertEqual(len(lines), len(cases))
+                for line in lines:
+                    key, backend = line.rsplit(' ', 1)
+                    self.assertNotIn(' ', key)
+                    self.assertIn(backend, ['slow2d', 'mkldnn', 'nnpack', 'xnnpack', 'winograd3x3_depthwise'])
+
+                torch.backends.cpu.clear_benchmark_cache()
+                torch.backends.cpu.load_benchmark_cache(fname)
+                for (input, weight, bias, kwargs), ref in zip(cases, expected):
+                    self.assertEqual(F.conv2d(input, weight, bias, **kwargs), ref)
+
+                # backends that do not exist are rejected, stale ones are timed again
+                with open(fname, 'w') as f:
+                    f.write(lines[0].rsplit(' ', 1)[0] + ' winograd5x5\n')
+                with self.assertRaisesRegex(RuntimeError, "unknown backend 'winograd5x5' on line 1"):
+                    torch.backends.cpu.load_benchmark_cache(fname)
+        self.assertFalse(torch.backends.cpu.benchmark)
+        torch.backends.cpu.clear_benchmark_cache()
+
+    @unittest.skipIf(not TEST_CUDNN, 'CUDNN not available')
+    def test_cudnn_benchmark_cache_file(self):
+        # the file is read once per process, so every run is a new process
+        script = """if True:
+            import torch
+            torch.backends.cudnn.benchmark = True
+            conv = torch.nn.Conv2d(3, 8, 3).cuda()
+            input = torch.randn(2, 3, 16, 16, device='cuda', requires_grad=True)
+            conv(input).sum().backward()
+            torch.cuda.synchronize()
+        """
+        with TemporaryFileName() as fname:
+            env = dict(os.environ, PYTORCH_CUDNN_BENCHMARK_CACHE=fname)
+            subprocess.check_call([sys.executable, '-c', script], env=env)
+            with open(fname) as f:
+                lines = f.read().splitlines()
+            self.assertEqual(sorted(line.split(' ', 1)[0] for line in lines), ['bwd_data', 'bwd_filter', 'fwd'])
+
+            # the results are loaded instead of searched for, and not written again
+            with open(fname, 'a') as f:
+                f.write('not a cache line\n')
+            subprocess.check_call([sys.executable, '-c', script], env=env)
+            with open(fname) as f:
+                self.assertEqual(f.read().splitlines(), lines + ['not a cache line'])
+
     @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
     def test_Conv2d_inconsistent_types_on_GPU_without_cudnn(self):
         inputs = torch.randn(4, 1, 7, 7, dtype=torch.float, device="cuda")
@@ -4276,6 +4362,33 @@ class TestNN(NNTestCase):
         with self.assertRaises(RuntimeError):
             torch.nn.functional.ctc_loss(log_probs, targets, input_lengths, target_lengths)
 
+    def test_CTCLoss_cpu_small_batch(self):
+        # few batch items with many states each split the states of a time step among the threads
+        input_length = 150
+        num_labels = 5
+        target_lengths = [130, 40, 3]
+        input_lengths = [150, 120, 60]
+        batch_size = len(target_lengths)
+        # without adjacent repeats every alignment fits into the inputs, so the losses are finite
+        steps = torch.randint(1, num_labels - 1, (sum(target_lengths),), dtype=torch.long)
+        targets = steps.cumsum(0) % (num_labels - 1) + 1
+        logits = torch.randn(input_length, batch_size, num_labels, dtype=torch.double, requires_grad=True)
+
+        res = torch.nn.functional.ctc_loss(logits.log_softmax(2), targets, input_lengths, target_lengths,
+                                           reduction='none')
+        expected = ctcloss_reference(logits.log_softmax(2), targets, input_lengths, target_lengths,
+                                     reduction='none')
+        self.assertTrue(torch.isfinite(res).all())
+        self.assertEqual(res, expected)
+
+        grad_out = torch.rand(batch_size, dtype=torch.double)
+        grad, = torch.autograd.grad(res, logits, grad_out)
+        expected_grad, = torch.autograd.grad(expected, logits, grad_out)
+        self.assertTrue(torch.isfinite(grad).all())
+        self.assertEqual(grad, expected_grad)
+        self.assertEqual(grad[input_lengths[2]:, 2], torch.zeros(input_length - input_lengths[2], num_labels,
+                                                                 dtype=torch.double))
+
     @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
     def test_CTCLoss_long_targets(self):
         input_length = 4000
@@ -4563,6 +4676,47 @@ class TestNN(NNTestCase):
 
             (hx + cx).sum().backward()
 
+    def test_fused_rnn_cells_cpu(self):
+        # the CPU cells go through _thnn_fused_lstm_cell / _thnn_fused_gru_cell;
+        # compare them and their fused backward with the cell equations
+        def lstm_reference(input, hx, cx, w_ih, w_hh, b_ih, b_hh):
+            gates = F.linear(input, w_ih, b_ih) + F.linear(hx, w_hh, b_hh)
+            i, f, c, o = gates.chunk(4, 1)
+            cy = f.sigmoid() * cx + i.sigmoid() * c.tanh()
+            return o.sigmoid() * cy.tanh(), cy
+
+        def gru_reference(input, hx, w_ih, w_hh, b_ih, b_hh):
+            ir, ii, in_ = F.linear(input, w_ih, b_ih).chunk(3, 1)
+            hr, hi, hn = F.linear(hx, w_hh, b_hh).chunk(3, 1)
+            r = (ir + hr).sigmoid()
+            z = (ii + hi).sigmoid()
+            n = (in_ + r * hn).tanh()
+            return n + z * (hx - n)
+
+        # a hidden size that is not a multiple of the vector width
+        for dtype, bias in product((torch.float, torch.double), (True, False)):
+            input = torch.randn(5, 7, dtype=dtype, requires_grad=True)
+            hx = torch.randn(5, 13, dtype=dtype, requires_grad=True)
+            cx = torch.randn(5, 13, dtype=dtype, requires_grad=True)
+            for module in (nn.LSTMCell, nn.GRUCell):
+                cell = module(7, 13, bias=bias).to(dtype)
+                weights = [cell.weight_ih, cell.weight_hh,
+                           cell.bias_ih if bias else None, cell.bias_hh if bias else None]
+                leaves = [input, hx, cx] + [w for w in weights if w is not None]
+                if module is nn.LSTMCell:
+                    out = cell(input, (hx, cx))
+                    expected = lstm_reference(input, hx, cx, *weights)
+                else:
+                    out = (cell(input, hx),)
+                    expected = (gru_reference(input, hx, *weights),)
+                grads = [torch.randn_like(o) for o in out]
+                actual_grads = torch.autograd.grad(out, leaves, grads, allow_unused=True)
+                expected_grads = torch.autograd.grad(expected, leaves, grads, allow_unused=True)
+                for a, e in zip(out, expected):
+                    self.assertEqual(a, e)
+                for a, e in zip(actual_grads, expected_grads):
+                    self.assertEqual(a, e)
+
     @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
     def test_pack_sequence_batch_sizes_throw(self):
         with self.assertRaisesRegex(ValueError, r"batch_sizes should always be on CPU"):
@@ -8136,6 +8290,53 @@ class TestNN(NNTestCase):
         self.assertEqual(input.grad.dtype, dtype)
         self.assertEqual(input.grad, inputf.grad, atol=1e-1)
 
+    def test_cross_entropy_loss_fused(self):
+        def reference(input, target, weight, reduction, ignore_index, label_smoothing):
+            n_classes = input.size(1)
+            log_probs = F.log_softmax(input, 1)
+            nll = F.nll_loss(log_probs, target, weight, ignore_index=ignore_index, reduction='none')
+            w = weight if weight is not None else torch.ones(n_classes, dtype=input.dtype, device=input.device)
+            w = w.view((1, n_classes) + (1,) * (input.dim() - 2))
+            valid = target != ignore_index
+            smooth = -(log_probs * w).sum(1) * valid
+            losses = nll * (1 - label_smoothing) + smooth * (label_smoothing / n_classes)
+            if reduction == 'none':
+                return losses
+            if reduction == 'sum':
+                return losses.sum()
+            total_weight = w.view(-1)[target.masked_fill(~valid, 0)].mul(valid).sum()
+            return losses.sum() / total_weight
+
+        devices = ['cpu'] + (['cuda'] if TEST_CUDA else [])
+        for device, shape, use_weight, reduction, label_smoothing in product(
+                devices, [(7, 5), (3, 5, 4), (2, 5, 3, 2)], [False, True],
+                ['none', 'mean', 'sum'], [0.0, 0.3]):
+            input = torch.randn(shape, dtype=torch.double, device=device, requires_grad=True)
+            target_shape = (shape[0],) + shape[2:]
+            target = torch.randint(shape[1], target_shape, dtype=torch.long, device=device)
+            target.view(-1)[0] = -100
+            weight = torch.rand(shape[1], dtype=torch.double, device=device) if use_weight else None
+
+            out = F.cross_entropy(input, target, weight, reduction=reduction, label_smoothing=label_smoothing)
+            expected = reference(input, target, weight, reduction, -100, label_smoothing)
+            self.assertEqual(out, expected)
+
+            grad = torch.randn_like(out)
+            grad_input, = torch.autograd.grad(out, input, grad)
+            expected_grad, = torch.autograd.grad(expected, input, grad)
+            self.assertEqual(grad_input, expected_grad)
+            self.assertEqual(grad_input.view(shape[0], shape[1], -1)[0, :, 0], torch.zeros(shape[1], dtype=torch.double, device=device))
+
+            fn = lambda x: F.cross_entropy(x, target, weight, reduction=reduction, label_smoothing=label_smoothing)
+            self.assertTrue(gradcheck(fn, (input,)))
+            self.assertTrue(gradgradcheck(fn, (input,)))
+
+    def test_cross_entropy_loss_label_smoothing_range(self):
+        input = torch.randn(3, 5)
+        target = torch.randint(5, (3,))
+        with self.assertRaisesRegex(RuntimeError, "label_smoothing must be between"):
+            F.cross_entropy(input, target, label_smoothing=1.5)
+
     @unittest.skipIf(not torch.cuda.is_available(), "CUDA not available")
     def test_convert_sync_batchnorm(self):
         module = torch.nn.Sequential(
@@ -9210,6 +9411,33 @@ class TestNNDeviceType(NNTestCase):
             input = input.bfloat16()
             self._test_dropout(nn.Dropout, device, input)
 
+    @dtypes(torch.float, torch.double)
+    def test_fused_dropout_packed(self, device, dtype):
+        p = 0.3
+        input = torch.randn(4, 1003, device=device, dtype=dtype, requires_grad=True)
+        output, mask = torch._fused_dropout_packed(input, 1 - p)
+        self.assertEqual(mask.dtype, torch.uint8)
+        self.assertEqual(mask.size(), ((input.numel() + 7) // 8,))
+
+        # Bit j of byte i is set iff element 8 * i + j was kept.
+        bits = torch.arange(8, device=device)
+        keep = ((mask.long().unsqueeze(1) >> bits) & 1).view(-1)[:input.numel()]
+        keep = keep.view_as(input).to(dtype)
+        self.assertEqual(output, input * keep / (1 - p))
+        self.assertLess(abs(keep.mean().item() - (1 - p)), 0.05)
+
+        grad = torch.randn_like(input)
+        output.backward(grad)
+        self.assertEqual(input.grad, grad * keep / (1 - p))
+
+        x = torch.randn(3, 5, device=device, dtype=torch.double, requires_grad=True)
+        _, mask = torch._fused_dropout_packed(x, 0.5)
+        gradcheck(lambda x: torch._masked_scale_packed(x, mask, 2.), (x,))
+        gradgradcheck(lambda x: torch._masked_scale_packed(x, mask, 2.), (x,))
+
+        with self.assertRaisesRegex(RuntimeError, "packed mask"):
+            torch._masked_scale_packed(x, torch.zeros(1, device=device, dtype=torch.uint8), 2.)
+
     def test_Dropout2d(self, device):
         b = random.randint(1, 5)
         w = random.randint(1, 5)
@@ -9278,6 +9506,35 @@ class TestNNDeviceType(NNTestCase):
         if self.device_type == 'cuda':
             self._test_LayerNorm_cuda_half(device)
 
+    @onlyCUDA
+    @dtypes(torch.half, torch.float)
+    def test_LayerNorm_rows(self, device, dtype):
+        # rows short enough to be kept in registers, with every vector width,
+        # and longer rows, against a double precision reference
+        for N in (1, 3, 6, 64, 768, 1023, 4096, 4097, 10000):
+            for elementwise_affine in (True, False):
+                x = torch.randn(5, N, device=device, dtype=dtype).mul_(3).add_(1).requires_grad_(True)
+                ln = nn.LayerNorm(N, elementwise_affine=elementwise_affine).to(device, dtype)
+                if elementwise_affine:
+                    ln.weight.data.uniform_(0.5, 1.5)
+                    ln.bias.data.uniform_(-1, 1)
+                ref_ln = nn.LayerNorm(N, elementwise_affine=elementwise_affine).to(device, torch.double)
+                ref_ln.load_state_dict(ln.state_dict())
+                ref_x = x.detach().double().requires_grad_(True)
+
+                out = ln(x)
+                ref_out = ref_ln(ref_x)
+                self.assertEqual(out, ref_out.to(dtype))
+
+                gO = torch.randn_like(out)
+                out.backward(gO)
+                ref_out.backward(gO.double())
+                atol = 5e-2 if dtype == torch.half else 1e-4
+                self.assertEqual(x.grad, ref_x.grad.to(dtype), atol=atol, rtol=0)
+                if elementwise_affine:
+                    self.assertEqual(ln.weight.grad, ref_ln.weight.grad.to(dtype), atol=atol, rtol=0)
+                    self.assertEqual(ln.bias.grad, ref_ln.bias.grad.to(dtype), atol=atol, rtol=0)
+
     def test_GroupNorm_general(self, device):
         self._test_GroupNorm_general(device)
 
@@ -9544,6 +9801,109 @@ class TestNNDeviceType(NNTestCase):
         helper(10, 512, 31, 31, 3, stride=2)
         helper(1, 129, 8, 8, 3, stride=2)
 
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_max_pool2d_nhwc_cpu(self, device, dtype):
+        def helper(n, c, h, w, kernel_size, stride=None, padding=0, dilation=1, ceil_mode=False):
+            input = torch.randn(n, c, h, w, dtype=dtype, device=device)
+            input[0, 0, 0, 0] = nan
+            input = input.contiguous(memory_format=torch.channels_last).requires_grad_()
+            ref_input = input.detach().clone().contiguous().requires_grad_()
+
+            out, indices = F.max_pool2d(input, kernel_size, stride, padding, dilation,
+                                        ceil_mode=ceil_mode, return_indices=True)
+            ref_out, ref_indices = F.max_pool2d(ref_input, kernel_size, stride, padding, dilation,
+                                                ceil_mode=ceil_mode, return_indices=True)
+            grad = torch.randn_like(ref_out)
+            out.backward(grad)
+            ref_out.backward(grad)
+
+            self.assertTrue(out.is_contiguous(memory_format=torch.channels_last))
+            self.assertTrue(indices.is_contiguous(memory_format=torch.channels_last))
+            self.assertEqual(out, ref_out)
+            self.assertEqual(indices, ref_indices)
+            self.assertEqual(input.grad, ref_input.grad)
+
+        helper(4, 8, 8, 8, 2)
+        helper(2, 3, 9, 7, 3, stride=2, padding=1)
+        helper(2, 17, 10, 10, 3, stride=1, padding=1, dilation=2)
+        helper(1, 33, 7, 7, 2, ceil_mode=True)
+
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_adaptive_avg_pool2d_nhwc_cpu(self, device, dtype):
+        def helper(n, c, h, w, output_size):
+            input = torch.randn(n, c, h, w, dtype=dtype, device=device)
+            input = input.contiguous(memory_format=torch.channels_last).requires_grad_()
+            ref_input = input.detach().clone().contiguous().requires_grad_()
+
+            out = F.adaptive_avg_pool2d(input, output_size)
+            ref_out = F.adaptive_avg_pool2d(ref_input, output_size)
+            grad = torch.randn_like(ref_out)
+            out.backward(grad)
+            ref_out.backward(grad)
+
+            self.assertTrue(out.is_contiguous(memory_format=torch.channels_last))
+            self.assertEqual(out, ref_out)
+            self.assertEqual(input.grad, ref_input.grad)
+
+        helper(4, 8, 8, 8, (7, 7))
+        helper(2, 3, 9, 7, (4, 5))
+        helper(2, 17, 10, 10, (1, 1))
+        helper(1, 33, 5, 5, (8, 8))
+
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_upsamplingBilinear2d_nhwc_cpu(self, device, dtype):
+        def helper(n, c, h, w, size, align_corners):
+            input = torch.randn(n, c, h, w, dtype=dtype, device=device)
+            input = input.contiguous(memory_format=torch.channels_last).requires_grad_()
+            ref_input = input.detach().clone().contiguous().requires_grad_()
+
+            out = F.interpolate(input, size=size, mode='bilinear', align_corners=align_corners)
+            ref_out = F.interpolate(ref_input, size=size, mode='bilinear', align_corners=align_corners)
+            grad = torch.randn_like(ref_out)
+            out.backward(grad)
+            ref_out.backward(grad)
+
+            self.assertTrue(out.is_contiguous(memory_format=torch.channels_last))
+            self.assertEqual(out, ref_out)
+            self.assertEqual(input.grad, ref_input.grad)
+
+        for align_corners in [True, False]:
+            helper(4, 8, 8, 8, (16, 16), align_corners)
+            helper(2, 3, 9, 7, (4, 5), align_corners)
+            helper(2, 17, 10, 10, (10, 10), align_corners)
+            helper(1, 33, 1, 1, (3, 2), align_corners)
+
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_batchnorm_nhwc_cpu(self, device, dtype):
+        def helper(n, c, h, w, train):
+            input = torch.randn(n, c, h, w, dtype=dtype, device=device)
+            input = input.contiguous(memory_format=torch.channels_last)
+            bn = nn.BatchNorm2d(c).to(device, dtype)
+            bn.weight.data.uniform_()
+            bn.bias.data.uniform_()
+            bn.running_mean.uniform_()
+            bn.running_var.uniform_(0.5, 1.5)
+            bn.train(train)
+            ref_bn = deepcopy(bn)
+
+            out = bn(input)
+            ref_out = ref_bn(input.contiguous())
+
+            self.assertTrue(out.is_contiguous(memory_format=torch.channels_last))
+            self.assertEqual(out, ref_out)
+            self.assertEqual(bn.running_mean, ref_bn.running_mean)
+            self.assertEqual(bn.running_var, ref_bn.running_var)
+
+        for train in [True, False]:
+            helper(4, 8, 8, 8, train)
+            helper(2, 3, 9, 7, train)
+            helper(2, 17, 10, 10, train)
+            helper(5, 1, 4, 4, train)
+
     def test_embedding_dense_grad(self, device):
         embd = nn.Embedding(20, 20).to(device)
         weight = embd.weight
@@ -9557,6 +9917,50 @@ class TestNNDeviceType(NNTestCase):
         fn = fn_wrapper(device)
         _assertGradAndGradgradChecks(self, fn, (weight, ))
 
+    @onlyCUDA
+    @dtypes(torch.half, torch.float, torch.double)
+    def test_embedding_dense_backward_strategies(self, device, dtype):
+        # small vocabularies and sparse lookups into large ones take the
+        # atomic path, the others, and deterministic mode, sort the indices
+        for num_weights, num_indices in ((10, 2000), (5000, 2000), (100000, 2000), (2000, 800)):
+            indices = torch.randint(num_weights, (num_indices // 20, 20), device=device)
+            grad = torch.randn(num_indices // 20, 20, 33, device=device, dtype=dtype)
+            for padding_idx in (-1, 3):
+                expected = torch.embedding_backward(grad.cpu().double(), indices.cpu(), num_weights,
+                                                    padding_idx, False, False)
+                for deterministic in (False, True):
+                    prev = torch.is_deterministic()
+                    torch.set_deterministic(deterministic)
+                    try:
+                        result = torch.embedding_backward(grad, indices, num_weights, padding_idx, False, False)
+                        if deterministic:
+                            self.assertEqual(
+                                result, torch.embedding_backward(grad, indices, num_weights, padding_idx, False, False),
+                                atol=0, rtol=0)
+                    finally:
+                        torch.set_deterministic(prev)
+                    self.assertEqual(result, expected.to(dtype), atol=1e-2 if dtype == torch.half else 1e-5, rtol=0)
+
+    @onlyCUDA
+    def test_embedding_and_embedding_bag_share_indices(self, device):
+        # the backwards of both ops share one sort of the indices
+        indices = torch.randint(20000, (4096,), device=device)
+        offsets = torch.arange(0, 4096, 16, device=device)
+        weight = torch.randn(20000, 8, device=device, requires_grad=True)
+        ref_weight = weight.detach().cpu().requires_grad_(True)
+        for w, idx, off in ((weight, indices, offsets), (ref_weight, indices.cpu(), offsets.cpu())):
+            out = F.embedding(idx.view(-1, 16), w).sum(1) + F.embedding_bag(idx, w, off, mode='mean')
+            out.sum().backward()
+        self.assertEqual(weight.grad, ref_weight.grad)
+
+        # modifying the indices in-place invalidates the sort
+        weight.grad = None
+        ref_weight.grad = None
+        indices.random_(20000)
+        for w, idx in ((weight, indices), (ref_weight, indices.cpu())):
+            F.embedding_bag(idx, w, offsets.to(idx.device)).sum().backward()
+        self.assertEqual(weight.grad, ref_weight.grad)
+
     @dtypesIfCUDA(torch.float16, torch.float64)
     @dtypes(torch.float64)
     def test_embedding_backward(self, device, dtype):
@@ -10058,6 +10462,50 @@ class TestNNDeviceType(NNTestCase):
         # should be bitwise equal
         self.assertEqual(input.grad, inputf.grad.to(dtype), atol=0)
 
+    @onlyCUDA
+    @dtypes(torch.half, torch.float)
+    def test_softmax_long_rows(self, device, dtype):
+        # rows of more than 1024 elements go through the multi-warp persistent kernels
+        for dim_size in (1025, 2048, 3000, 8192):
+            input = torch.randn(7, dim_size, device=device, dtype=dtype, requires_grad=True)
+            inputf = input.to(torch.float).detach().requires_grad_(True)
+            for fn in (F.softmax, F.log_softmax):
+                out = fn(input, dim=-1, dtype=torch.float)
+                outf = fn(inputf, dim=-1)
+                self.assertEqual(out, outf)
+                gO = torch.randn_like(outf)
+                grad, = torch.autograd.grad(out, input, gO)
+                gradf, = torch.autograd.grad(outf, inputf, gO)
+                self.assertEqual(grad, gradf.to(dtype), atol=1e-3, rtol=1e-3)
+
+    @dtypesIfCUDA(torch.half, torch.float, torch.double)
+    @dtypes(torch.float, torch.double)
+    def test_scaled_masked_softmax(self, device, dtype):
+        # (input size, mask size): a padding mask broadcast over heads and
+        # queries, a causal mask broadcast over the batch and the heads, a
+        # full mask and rows of more than 1024 elements
+        for size, mask_size in (((2, 3, 5, 7), (2, 1, 1, 7)), ((2, 3, 16, 16), (16, 16)),
+                                ((4, 33), (4, 33)), ((3, 2, 2048), (3, 1, 2048)), ((2, 4096), (4096,))):
+            input = torch.randn(size, device=device, dtype=dtype, requires_grad=True)
+            mask = torch.randn(mask_size, device=device, dtype=dtype)
+            mask[..., 0] = float('-inf')
+            scale = 0.125
+            out = torch._scaled_masked_softmax(input, mask, scale)
+            ref_input = input.detach().double().requires_grad_(True)
+            ref = F.softmax(ref_input * scale + mask.double(), dim=-1)
+            self.assertEqual(out, ref.to(dtype))
+
+            gO = torch.randn_like(out)
+            grad, = torch.autograd.grad(out, input, gO)
+            ref_grad, = torch.autograd.grad(ref, ref_input, gO.double())
+            self.assertEqual(grad, ref_grad.to(dtype))
+
+        if dtype == torch.double:
+            input = torch.randn(3, 4, 5, device=device, dtype=dtype, requires_grad=True)
+            mask = torch.randn(4, 5, device=device, dtype=dtype)
+            self.assertTrue(gradcheck(lambda x: torch._scaled_masked_softmax(x, mask, 0.5), (input,)))
+            self.assertTrue(gradgradcheck(lambda x: torch._scaled_masked_softmax(x, mask, 0.5), (input,)))
+
     @onlyCUDA
     def test_pool3d_size_one_feature_dim(self, device):
         # Tests crazy strides for feature dim of size 1
@@ -10480,6 +10928,38 @@ class TestNNDeviceType(NNTestCase):
         self._test_EmbeddingBag(device, 'sum', True, dtype=torch.bfloat16, test_backward=True)
         self._test_EmbeddingBag(device, 'mean', True, dtype=torch.bfloat16, test_backward=True)
 
+    @onlyCPU
+    @dtypes(torch.half, torch.bfloat16, torch.double)
+    def test_embedding_bag_forward_dtypes(self, device, dtype):
+        # enough bags for the forward to be split across threads, some empty
+        num_embeddings, embedding_dim, num_bags = 100, 37, 500
+        weight = torch.randn(num_embeddings, embedding_dim, device=device)
+        input = torch.randint(num_embeddings, (4000,), device=device, dtype=torch.long)
+        offsets = torch.randint(input.numel(), (num_bags - 1,), device=device).sort()[0]
+        offsets = torch.cat((torch.zeros(1, device=device, dtype=torch.long), offsets))
+        per_sample_weights = torch.randn(input.numel(), device=device)
+        weight_t = weight.to(dtype)
+        prec = 1e-5 if dtype == torch.double else 5e-2
+
+        for mode in ('sum', 'mean', 'max'):
+            psw = per_sample_weights if mode == 'sum' else None
+            # the reference is computed in float from the same rounded values
+            expected = F.embedding_bag(
+                input, weight_t.float(), offsets, mode=mode,
+                per_sample_weights=psw.to(dtype).float() if psw is not None else None)
+            result = F.embedding_bag(
+                input, weight_t, offsets, mode=mode,
+                per_sample_weights=psw.to(dtype) if psw is not None else None)
+            self.assertEqual(result.dtype, dtype)
+            self.assertEqual(result.float(), expected, atol=prec, rtol=prec)
+
+            # non-contiguous weights go through the portable kernels
+            weight_nc = weight_t.t().contiguous().t()
+            result_nc = F.embedding_bag(
+                input, weight_nc, offsets, mode=mode,
+                per_sample_weights=psw.to(dtype) if psw is not None else None)
+            self.assertEqual(result_nc, result, atol=prec, rtol=prec)
+
 
     @onlyCUDA
     @dtypes(torch.half, torch.float, torch.double)
@@ -199,6 +199,25 @@ class TestSparse(TestCase):
             t, _, _ = self._gen_sparse(len(sparse_size), nnz, sparse_size + dense_size)
             self.safeCoalesce(t)  # this tests correctness
 
+    def test_coalesce_large(self):
+        # Enough elements, and duplicates of them, for the parallel sort and
+        # reduction
+        for sparse_size, dense_size in [((300, 200), ()), ((70000,), (3,))]:
+            nnz = 100000
+            indices = torch.stack([torch.randint(size, (nnz,), device=self.device) for size in sparse_size])
+            values = torch.randn((nnz,) + dense_size, dtype=self.value_dtype, device=self.device)
+            x = self.sparse_tensor(indices, values, sparse_size + dense_size)
+
+            y = x.coalesce()
+            self.assertTrue(y.is_coalesced())
+            flat = y._indices()[0]
+            if len(sparse_size) > 1:
+                flat = flat * sparse_size[1] + y._indices()[1]
+            self.assertTrue((flat[1:] > flat[:-1]).all())
+            expected = torch.zeros(sparse_size + dense_size, dtype=self.value_dtype, device=self.device)
+            expected.index_put_(tuple(indices), values, accumulate=True)
+            self.assertEqual(y.to_dense(), expected)
+
     def test_ctor_size_checks(self):
         indices = self.index_tensor([
             [0, 0, 0],
@@ -1140,6 +1159,25 @@ class TestSparse(TestCase):
         test_shape(1000, 100, 0, 20)
 
     @skipIfRocm
+    def test_sparse_sparse_mm(self):
+        def test_shape(di, dj, dk, nnz1, nnz2):
+            x = self._gen_sparse(2, nnz1, [di, dj])[0]
+            y = self._gen_sparse(2, nnz2, [dj, dk])[0]
+
+            res = torch.mm(x, y)
+            self.assertTrue(res.is_sparse)
+            self.assertEqual(res.shape, torch.Size([di, dk]))
+            self.assertEqual(res.to_dense(), torch.mm(self.safeToDense(x), self.safeToDense(y)))
+            self.assertEqual(torch.sparse.mm(x, y).to_dense(), res.to_dense())
+
+        test_shape(7, 5, 3, 20, 10)
+        test_shape(300, 200, 100, 2000, 1500)
+        test_shape(1000, 10, 1000, 5000, 5000)
+        test_shape(0, 100, 100, 0, 20)
+        test_shape(100, 0, 100, 0, 0)
+        test_shape(100, 100, 0, 20, 0)
+        test_shape(100, 100, 100, 0, 20)
+
     def test_hsmm(self):
         def test_shape(di, dj, dk, nnz):
             x = self._gen_sparse(2, nnz, [di, dj])[0]
@@ -2434,5 +2472,83 @@ class TestSparseOneOff(TestCase):
             x + sparse_y
 
 
+class TestSparseCsr(TestCase):
+    def _random_dense(self, rows, cols, dtype=torch.double):
+        dense = torch.randn(rows, cols).to(dtype)
+        return dense * (torch.rand(rows, cols) < 0.3).to(dtype)
+
+    def test_csr_layout(self):
+        crow_indices = torch.tensor([0, 2, 2, 3])
+        col_indices = torch.tensor([0, 2, 1])
+        values = torch.tensor([1., 2., 3.])
+        x = torch.sparse_csr_tensor(crow_indices, col_indices, values, [3, 3])
+        self.assertEqual(x.layout, torch.sparse_csr)
+        self.assertEqual(x.shape, (3, 3))
+        self.assertEqual(x._nnz(), 3)
+        self.assertEqual(x.dtype, values.dtype)
+        self.assertEqual(x.crow_indices(), crow_indices)
+        self.assertEqual(x.col_indices(), col_indices)
+        self.assertEqual(x.values(), values)
+        self.assertEqual(x.to_dense(), torch.tensor([[1., 0., 2.], [0., 0., 0.], [0., 3., 0.]]))
+        self.assertIn('layout=torch.sparse_csr', str(x))
+
+    def test_csr_invalid_args(self):
+        values = torch.tensor([1., 2.])
+        with self.assertRaisesRegex(RuntimeError, "crow_indices\\[0\\] must be 0"):
+            torch.sparse_csr_tensor(torch.tensor([1, 2]), torch.tensor([0, 1]), values, [1, 2])
+        with self.assertRaisesRegex(RuntimeError, "must have size\\(0\\) \\+ 1"):
+            torch.sparse_csr_tensor(torch.tensor([0, 2]), torch.tensor([0, 1]), values, [2, 2])
+        with self.assertRaisesRegex(RuntimeError, "out of bounds"):
+            torch.sparse_csr_tensor(torch.tensor([0, 2]), torch.tensor([0, 2]), values, [1, 2])
+        with self.assertRaisesRegex(RuntimeError, "strictly increasing"):
+            torch.sparse_csr_tensor(torch.tensor([0, 2]), torch.tensor([1, 1]), values, [1, 2])
+
+    def test_csr_conversions(self):
+        for rows, cols in [(0, 0), (1, 5), (7, 3), (20, 30)]:
+            dense = self._random_dense(rows, cols)
+            self.assertEqual(dense.to_sparse_csr().to_dense(), dense)
+            self.assertEqual(dense.to_sparse().to_sparse_csr().to_dense(), dense)
+            self.assertEqual(dense.to_sparse_csr()._nnz(), dense.nonzero().size(0))
+        # duplicate COO elements are summed
+        coo = torch.sparse_coo_tensor(torch.tensor([[1, 0, 1], [2, 1, 2]]), torch.tensor([1., 2., 3.]), [2, 3])
+        self.assertEqual(coo.to_sparse_csr().to_dense(), coo.to_dense())
+
+    def test_csr_matmul(self):
+        for dtype in [torch.float, torch.double, torch.long]:
+            for rows, inner, cols in [(0, 4, 3), (5, 0, 3), (5, 7, 1), (50, 40, 30)]:
+                a = self._random_dense(rows, inner, dtype)
+                b = self._random_dense(inner, cols, dtype)
+                t = self._random_dense(rows, cols, dtype)
+                v = self._random_dense(inner, 1, dtype).squeeze(1)
+                csr = a.to_sparse_csr()
+                self.assertEqual(torch.mm(csr, b), torch.mm(a, b))
+                self.assertEqual(torch.mv(csr, v), torch.mv(a, v))
+                self.assertEqual(torch.addmm(t, csr, b, beta=2, alpha=3), torch.addmm(t, a, b, beta=2, alpha=3))
+                bias = torch.ones(cols, dtype=dtype)  # broadcasts over the rows
+                self.assertEqual(torch.addmm(bias, csr, b), torch.addmm(bias, a, b))
+                out = torch.empty(0, dtype=dtype)
+                torch.mm(csr, b.t().contiguous().t(), out=out)
+                self.assertEqual(out, torch.mm(a, b))
+                self.assertEqual(t.clone().addmm_(csr, b, beta=2), t.clone().addmm_(a, b, beta=2))
+
+    def test_csr_sparse_matmul(self):
+        for dtype in [torch.float, torch.double, torch.long]:
+            for rows, inner, cols in [(0, 4, 3), (5, 0, 3), (5, 7, 1), (50, 40, 30), (400, 300, 200)]:
+                a = self._random_dense(rows, inner, dtype)
+                b = self._random_dense(inner, cols, dtype)
+                res = torch.mm(a.to_sparse_csr(), b.to_sparse_csr())
+                self.assertEqual(res.layout, torch.sparse_csr)
+                self.assertEqual(res.to_dense(), torch.mm(a, b))
+                # The columns of every row are sorted
+                for i in range(rows):
+                    row = res.col_indices()[res.crow_indices()[i]:res.crow_indices()[i + 1]]
+                    self.assertTrue((row[1:] > row[:-1]).all())
+
+    def test_csr_only_first_operand(self):
+        a = self._random_dense(3, 3)
+        with self.assertRaisesRegex(RuntimeError, "only the first argument may be a sparse CSR tensor"):
+            torch.mm(a, a.to_sparse_csr())
+
+
 if __name__ == '__main__':
     run_tests()
@@ -999,6 +999,61 @@ class TestTensorExprFuser(BaseTestClass):
     def test_cat_cuda(self):
         self._test_cat('cuda')
 
+    def test_reductions(self):
+        def run_sum(x):
+            return torch.sum(x * 2, dim=1, keepdim=True) + 1
+
+        def run_mean(x):
+            return torch.mean(x + 1, dim=-1) * 2
+
+        def run_softmax(x):
+            return torch.softmax(x * 2, dim=1) + 1
+
+        def run_log_softmax(x):
+            return torch.log_softmax(x + 1, dim=-1) * 2
+
+        def run_layer_norm(x, w, b):
+            return F.layer_norm(x * 2, [64], w, b) + 1
+
+        device_options = ["cpu", "cuda"] if torch.cuda.is_available() else ['cpu']
+        for dev in device_options:
+            x = torch.rand(32, 64, device=dev)
+            w = torch.rand(64, device=dev)
+            b = torch.rand(64, device=dev)
+            for fn in [run_sum, run_mean, run_softmax, run_log_softmax]:
+                traced = torch.jit.trace(fn, (torch.zeros(32, 64, device=dev),))
+                for _ in range(3):
+                    res = traced(x)
+                np.testing.assert_allclose(
+                    fn(x).cpu().numpy(), res.cpu().numpy(), rtol=1e-5, atol=1e-5)
+            traced = torch.jit.trace(
+                run_layer_norm,
+                (torch.zeros(32, 64, device=dev), torch.ones(64, device=dev),
+                 torch.zeros(64, device=dev)))
+            for _ in range(3):
+                res = traced(x, w, b)
+            np.testing.assert_allclose(
+                run_layer_norm(x, w, b).cpu().numpy(), res.cpu().numpy(),
+                rtol=1e-4, atol=1e-4)
+
+    def test_softmax_fused(self):
+        llvm_executed = LLVMCodeGenExecuted()
+        simple_ir_eval_executed = SimpleIREvalExecuted()
+
+        def easy(x, y):
+            return torch.softmax(x + y, dim=1) * y
+
+        traced = torch.jit.trace(easy, (torch.zeros(16, 128), torch.zeros(16, 128)))
+        a = torch.rand(16, 128)
+        b = torch.rand(16, 128)
+        for _ in range(3):
+            x = traced(a, b)
+        np.testing.assert_allclose(easy(a, b).numpy(), x.numpy(), rtol=1e-5)
+        assert (
+            llvm_executed.elapsed_value() >= 1
+            or simple_ir_eval_executed.elapsed_value() >= 1
+        )
+
     def test_scalar(self):
         @torch.jit.script
         def test_float(x, y, z, a, b):
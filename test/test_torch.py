@@ -759,6 +759,60 @@ class _TestTorchMixin(object):
         self.assertEqual(y[:, 0], range(100))
         self.assertEqual(y[:, 40], range(4000, 4100))
 
+    def test_copy_permuted(self):
+        # Transposing copies of every element size, with sizes that are not
+        # multiples of the blocks they are transposed in.
+        for dtype in [torch.uint8, torch.bool, torch.half, torch.float, torch.int64, torch.complex64]:
+            x = torch.arange(3 * 37 * 70 * 9).reshape(3, 37, 70, 9).to(dtype)
+            for dims in [(0, 1, 3, 2), (0, 2, 3, 1), (0, 3, 1, 2), (3, 2, 1, 0)]:
+                permuted = x.permute(*dims)
+                expected = permuted.reshape(-1).tolist()
+                self.assertEqual(permuted.contiguous().view(-1).tolist(), expected)
+                y = torch.empty(permuted.shape, dtype=dtype)
+                y.copy_(permuted)
+                self.assertEqual(y.view(-1).tolist(), expected)
+
+            nhwc = x.contiguous(memory_format=torch.channels_last)
+            self.assertTrue(nhwc.is_contiguous(memory_format=torch.channels_last))
+            self.assertEqual(nhwc.tolist(), x.tolist())
+            self.assertEqual(nhwc.contiguous().tolist(), x.tolist())
+
+        x = torch.randn(1000, 300)
+        self.assertEqual(x.t().contiguous(), x.t(), 0)
+        self.assertEqual(x[:, ::2].t().contiguous(), x[:, ::2].t(), 0)
+
+    def test_copy_convert(self):
+        # The vectorized conversions, of sizes that are not multiples of the
+        # vector sizes, match the element-wise ones of strided copies.
+        # Values in the range of every dtype
+        x = torch.rand(1037) * 120
+        pairs = [(torch.float, torch.half), (torch.float, torch.bfloat16),
+                 (torch.float, torch.int8), (torch.float, torch.uint8),
+                 (torch.int32, torch.float), (torch.int64, torch.int32),
+                 (torch.int32, torch.int64)]
+        for src_dtype, dst_dtype in pairs:
+            for a, b in [(src_dtype, dst_dtype), (dst_dtype, src_dtype)]:
+                src = x.to(a)
+                converted = src.to(b)
+                strided = torch.empty(2 * x.numel(), dtype=b)[::2]
+                strided.copy_(src)
+                self.assertEqual(converted.tolist(), strided.tolist())
+
+        # Ties round to even, and NaN and infinities are kept
+        self.assertEqual(torch.tensor([1 + 2 ** -11, 1 + 3 * 2 ** -11] * 9).half().tolist(),
+                         [1, 1 + 2 ** -9] * 9)
+        self.assertEqual(torch.tensor([1 + 2 ** -8, 1 + 3 * 2 ** -8] * 9).bfloat16().tolist(),
+                         [1, 1 + 2 ** -6] * 9)
+        for dtype in [torch.half, torch.bfloat16]:
+            special = torch.tensor([float('inf'), float('-inf'), float('nan')] * 11)
+            converted = special.to(dtype).float()
+            self.assertEqual(converted[:2].tolist(), [float('inf'), float('-inf')])
+            self.assertTrue(converted[2::3].isnan().all())
+
+        # Narrowing keeps the low bits
+        big = torch.tensor([2 ** 32 + 5, -2 ** 40 - 3] * 9, dtype=torch.int64)
+        self.assertEqual(big.int().tolist(), [5, -3] * 9)
+
     def test_device(self):
         cpu = torch.device('cpu')
         self.assertEqual('cpu', str(cpu))
@@ -2234,14 +2288,28 @@ class _TestTorchMixin(object):
         self.assertEqual(b.nelement(), 3 * 100 * 100)
         self.assertEqual(b.numel(), 3 * 100 * 100)
 
-    # Note: the warning this tests for only appears once per program, so
-    # other instances of this warning should be addressed to avoid
-    # the tests depending on the order in which they're run.
     @unittest.skipIf(not TEST_NUMPY, "Numpy not found")
     def test_numpy_non_writeable(self):
-        arr = np.zeros(5)
+        arr = np.arange(5.)
         arr.flags['WRITEABLE'] = False
-        self.assertWarns(UserWarning, lambda: torch.from_numpy(arr))
+        x = torch.from_numpy(arr)
+        self.assertEqual(x.data_ptr(), arr.ctypes.data)
+        self.assertEqual(x * 2, torch.arange(5.) * 2)
+
+        with self.assertRaisesRegex(RuntimeError, "read-only tensor"):
+            x.add_(1)
+        with self.assertRaisesRegex(RuntimeError, "read-only tensor"):
+            x[1:].zero_()
+        with self.assertRaisesRegex(RuntimeError, "read-only tensor"):
+            x[0] = 1
+        with self.assertRaisesRegex(RuntimeError, "read-only tensor"):
+            torch.add(x, 1, out=x)
+        self.assertEqual(arr, np.arange(5.))
+        self.assertFalse(x.numpy().flags.writeable)
+
+        y = x.clone()
+        y.add_(1)
+        self.assertEqual(y, torch.arange(5.) + 1)
 
     @unittest.skipIf(not TEST_NUMPY, "Numpy not found")
     def test_empty_storage_view(self):
@@ -2743,6 +2811,37 @@ class _TestTorchMixin(object):
         self.assertEqual(tensor.var(dim=0), 0.03125)
         self.assertEqual(tensor.var(), 0.03125)
 
+        # Long rows go through the vectorized Welford reduction, which should
+        # be as stable as the scalar one for large means
+        tensor = torch.tensor([2281.5, 2281.25] * 1000)
+        self.assertEqual(tensor.var().item(), 0.015625 * 2000 / 1999, 1e-6)
+
+    def test_var_mean_vectorized(self):
+        # Rows whose lengths are not multiples of the vectors, reduced along
+        # contiguous and strided dims, and as a whole on several threads
+        for dtype in [torch.float, torch.double]:
+            x = torch.randn(7, 1037, dtype=dtype) * 10 + 100
+            for dim in [0, 1, None]:
+                expected_var = x.double().var() if dim is None else x.double().var(dim)
+                expected_mean = x.double().mean() if dim is None else x.double().mean(dim)
+                var, mean = torch.var_mean(x) if dim is None else torch.var_mean(x, dim)
+                self.assertEqual(var.double(), expected_var, 1e-4)
+                self.assertEqual(mean.double(), expected_mean, 1e-4)
+                std, mean = torch.std_mean(x) if dim is None else torch.std_mean(x, dim)
+                self.assertEqual(std.double(), expected_var.sqrt(), 1e-4)
+                self.assertEqual(mean.double(), expected_mean, 1e-4)
+
+            x = torch.randn(100003, dtype=dtype) + 1
+            self.assertEqual(x.var().item(), torch.tensor(x.tolist(), dtype=torch.double).var().item(), 1e-4)
+
+        x = torch.randn(3, 333) * 10
+        with torch.backends.cpu.flags(allow_float_accumulation=True):
+            self.assertTrue(torch.backends.cpu.allow_float_accumulation)
+            fast = x.var(1), x.std(1, unbiased=False)
+        self.assertFalse(torch.backends.cpu.allow_float_accumulation)
+        self.assertEqual(fast[0].double(), x.double().var(1), 1e-3)
+        self.assertEqual(fast[1].double(), x.double().std(1, unbiased=False), 1e-3)
+
     def test_view_empty(self):
         x = torch.randn(0, 6)
         self.assertEqual((1, 0, 6, 1, 1), x.view(1, 0, 6, 1, 1).shape)
@@ -2993,7 +3092,7 @@ class _TestTorchMixin(object):
 
             out = np.broadcast_to(np.random.random((1, 4)),
                                   initial_shape)
-            # Note: non-writeable NumPy arrays will warn if converted to tensors
+            # Note: tensors sharing non-writeable NumPy arrays are read-only
             out.setflags(write=True)
 
             assert not (out.flags.c_contiguous or out.flags.f_contiguous)
@@ -3590,6 +3689,23 @@ class _TestTorchMixin(object):
                                "missing 1 required positional arguments",
                                lambda: torch.tensor().new_zeros((5, 5), 0))
 
+    def test_parsing_overloads(self):
+        x = torch.randn(3, 4)
+        # the overload is picked the same way with and without keyword arguments
+        self.assertEqual(torch.sum(x, 1), torch.sum(x, dim=1))
+        self.assertEqual(torch.sum(x, 1, **{}), torch.sum(x, dim=1))
+        self.assertEqual(x.add(x, **{}), x + x)
+        self.assertEqual(x.add(2), x + 2)
+        self.assertEqual(torch.max(x, 1)[0], torch.max(x, dim=1)[0])
+        self.assertEqual(torch.max(x, x), x)
+        # no overload takes that many, or that few, positional arguments
+        self.assertRaisesRegex(TypeError,
+                               "received an invalid combination of arguments",
+                               lambda: torch.max(x, 1, True, 2))
+        self.assertRaisesRegex(TypeError,
+                               "received an invalid combination of arguments",
+                               lambda: x.add())
+
     def test_half_tensor(self):
         x = torch.randn(5, 5).float()
         y = torch.randn(5, 5).float()
@@ -6828,6 +6944,52 @@ class TestTorchDeviceType(TestCase):
         self.assertEqual(torch.matmul(matrices, matrices_inverse),
                          torch.eye(3, dtype=torch.float64).to(device).expand_as(matrices))
 
+    @onlyCUDA
+    @skipCUDAIfNoMagma
+    @precisionOverride({torch.float: 1e-3, torch.double: 1e-8})
+    @dtypes(torch.float, torch.double)
+    def test_linalg_small_matrices_many_batches(self, device, dtype):
+        from torch.testing._internal.common_utils import \
+            (random_fullrank_matrix_distinct_singular_value as fullrank, random_symmetric_pd_matrix)
+
+        # The sizes go through the register kernels, the batched routines of
+        # cuBLAS and MAGMA
+        for n, batch in product([1, 2, 3, 4, 5, 16, 33], [(1,), (3, 1000)]):
+            eye = torch.eye(n, dtype=dtype, device=device).expand(batch + (n, n))
+
+            A = fullrank(n, *batch, dtype=dtype, device=device)
+            self.assertEqual(torch.matmul(A, torch.inverse(A)), eye)
+
+            b = torch.randn(batch + (n, 2), dtype=dtype, device=device)
+            x, lu = torch.solve(b, A)
+            self.assertEqual(torch.matmul(A, x), b)
+
+            LU, pivots = torch.lu(A)
+            P, L, U = torch.lu_unpack(LU, pivots)
+            self.assertEqual(torch.matmul(P, torch.matmul(L, U)), A)
+
+            S = random_symmetric_pd_matrix(n, *batch, dtype=dtype, device=device)
+            for upper in [False, True]:
+                chol = torch.cholesky(S, upper=upper)
+                if upper:
+                    self.assertEqual(chol, chol.triu())
+                    self.assertEqual(torch.matmul(chol.transpose(-2, -1), chol), S)
+                else:
+                    self.assertEqual(chol, chol.tril())
+                    self.assertEqual(torch.matmul(chol, chol.transpose(-2, -1)), S)
+
+        # The errors name the first failing matrix of the batch, whatever the path
+        for n in [3, 16]:
+            A = torch.eye(n, dtype=dtype, device=device).repeat(4, 1, 1)
+            A[2, 1, 1] = 0
+            with self.assertRaisesRegex(RuntimeError, r'For batch 2: U\(2,2\) is zero'):
+                torch.inverse(A)
+            with self.assertRaisesRegex(RuntimeError, r'For batch 2: U\(2,2\) is zero'):
+                torch.solve(torch.ones(4, n, 1, dtype=dtype, device=device), A)
+            if n <= 4:
+                with self.assertRaisesRegex(RuntimeError, r'For batch 2: U\(2,2\) is zero'):
+                    torch.cholesky(A)
+
     @skipCUDAIfNoMagma
     @skipCPUIfNoLapack
     @dtypes(torch.double)
@@ -10493,6 +10655,31 @@ class TestTorchDeviceType(TestCase):
             expected = self._brute_cdist(x, y, p=2)
             self.assertTrue(torch.allclose(expected, actual))
 
+    def test_cdist_blocks(self, device):
+        # Sizes that are not multiples of the blocks the kernels work on.
+        for r1, r2, m in [(70, 300, 3), (5, 1025, 40), (300, 257, 1)]:
+            x = torch.randn(2, r1, m, device=device, dtype=torch.double)
+            y = torch.randn(2, r2, m, device=device, dtype=torch.double)
+            for p in [0, 1, 2, 1.5, 3, float('inf')]:
+                expected = self._brute_cdist(x, y, p=p)
+                actual = torch.cdist(x, y, p=p)
+                self.assertTrue(torch.allclose(expected, actual))
+                if p == 2:
+                    actual = torch.cdist(x, y, p=p, compute_mode='donot_use_mm_for_euclid_dist')
+                    self.assertTrue(torch.allclose(expected, actual))
+
+    def test_cdist_euclidean_cancellation(self, device):
+        # Points far from the origin and close to each other, where
+        # ||x||^2 + ||y||^2 - 2xy cancels almost completely.
+        x = torch.randn(100, 16, device=device) + 1000
+        y = torch.cat((x[:50] + 1e-3 * torch.randn(50, 16, device=device),
+                       torch.randn(50, 16, device=device) + 1000))
+        y[5] = x[5]
+        expected = self._brute_cdist(x.double(), y.double())
+        actual = torch.cdist(x, y, compute_mode='use_mm_for_euclid_dist')
+        self.assertTrue(torch.allclose(expected.float(), actual, rtol=1e-3, atol=1e-5))
+        self.assertEqual(actual[5, 5].item(), 0)
+
     @slowTest
     def test_cdist_large_batch(self, device):
         for cm in ['use_mm_for_euclid_dist_if_necessary', 'use_mm_for_euclid_dist', 'donot_use_mm_for_euclid_dist']:
@@ -10826,6 +11013,89 @@ class TestTorchDeviceType(TestCase):
         # Check that output maintained correct shape
         self.assertEqual(raw_tensor.shape, raw_tensor.grad.shape)
 
+    def test_cumsum_cumprod_scan_paths(self, device):
+        # Covers long slices, many short slices, scans over an outer dim and
+        # non-contiguous inputs and outputs.
+        def reference(x, dim, op):
+            x = x.double().transpose(dim, -1)
+            res = torch.empty_like(x)
+            acc = x.select(-1, 0).clone()
+            res.select(-1, 0).copy_(acc)
+            for i in range(1, x.size(-1)):
+                acc = op(acc, x.select(-1, i))
+                res.select(-1, i).copy_(acc)
+            return res.transpose(dim, -1).float()
+
+        for shape, dim in [((3, 500), 1), ((500, 7), 0), ((4, 300, 9), 1),
+                           ((300, 4, 9), 0), ((1000, 3), 1)]:
+            x = torch.rand(*shape, device=device) + 0.5
+            self.assertEqual(x.cumsum(dim), reference(x, dim, torch.add), 1e-3)
+            # Keeps the products away from overflow and underflow.
+            y = x / math.exp(x.log().mean().item())
+            self.assertEqual(y.cumprod(dim), reference(y, dim, torch.mul), 1e-3)
+
+            x_t = x.transpose(0, -1)
+            expected = x_t.contiguous().cumsum(dim)
+            self.assertEqual(x_t.cumsum(dim), expected)
+            out = torch.empty(*reversed(x_t.shape), device=device).transpose(0, -1)
+            torch.cumsum(x_t, dim, out=out)
+            self.assertEqual(out, expected)
+
+        for n in [100000, 1000003]:
+            x = torch.ones(n, dtype=torch.int64, device=device)
+            self.assertEqual(x.cumsum(0), torch.arange(1, n + 1, device=device))
+            x = torch.rand(2, n, device=device, dtype=torch.double)
+            res = x.cumsum(1)
+            self.assertEqual(res[:, 0], x[:, 0])
+            self.assertEqual(res[:, 1:] - res[:, :-1], x[:, 1:], 1e-6)
+            self.assertEqual(res[:, -1], x.sum(1), 1e-6)
+
+    def test_logcumsumexp(self, device):
+        def logcumsumexp(a, axis):
+            return torch.cumsum(a.exp(), dim=axis).log_()
+
+        axis = 1
+        a = torch.randn(100, 100, device=device)
+
+        actual = a.logcumsumexp(1)
+        expected = logcumsumexp(a, axis)
+        self.assertEqual(a.dtype, actual.dtype)
+        self.assertEqual(expected.shape, actual.shape)
+        self.assertEqual(expected, actual)
+
+        out = torch.empty(0, device=device)
+        torch.logcumsumexp(a, axis, out=out)
+        self.assertEqual(out, actual)
+
+        for dim in range(a.dim()):
+            self.assertEqual(a.logcumsumexp(dim), logcumsumexp(a, dim))
+
+        # Long slices take the blocked scan.
+        a = torch.randn(3, 40000, device=device, dtype=torch.double)
+        self.assertEqual(a.logcumsumexp(1), logcumsumexp(a, 1))
+
+        # Large values that overflow exp.
+        a = torch.tensor([1000., 1000., -1000.], device=device)
+        expected = torch.tensor([1000., 1000. + math.log(2), 1000. + math.log(2)], device=device)
+        self.assertEqual(a.logcumsumexp(0), expected)
+
+        # Small values that underflow exp next to larger ones.
+        a = torch.tensor([-1000., 0.], device=device)
+        self.assertEqual(a.logcumsumexp(0), torch.tensor([-1000., 0.], device=device))
+        a = torch.tensor([[-1000., 0., -1000.], [0., -1000., 5.]], device=device, dtype=torch.double)
+        expected = torch.tensor([[-1000., 0., 0.], [0., 0., 5. + math.log1p(math.exp(-5.))]],
+                                device=device, dtype=torch.double)
+        self.assertEqual(a.logcumsumexp(1), expected)
+
+        inf = float('inf')
+        nan = float('nan')
+        a = torch.tensor([-inf, -inf, 1., inf, 2., nan, 3.], device=device)
+        expected = torch.tensor([-inf, -inf, 1., inf, inf, nan, nan], device=device)
+        self.assertEqual(a.logcumsumexp(0), expected)
+
+        self.assertEqual(torch.tensor(3., device=device).logcumsumexp(0), torch.tensor(3., device=device))
+        self.assertEqual(torch.empty(2, 0, device=device).logcumsumexp(1).shape, (2, 0))
+
     def test_cummax_cummin(self, device):
         def test_ops(op, string_of_function_name, expected_output1, expected_output2):
             x = torch.rand(100, 100, device=device)
@@ -10932,6 +11202,39 @@ class TestTorchDeviceType(TestCase):
             self.assertEqual(var1, var2)
             self.assertEqual(mean1, mean2)
 
+    @dtypes(torch.int32, torch.float, torch.double)
+    @dtypesIfCUDA(torch.int32, torch.half, torch.float, torch.double)
+    def test_aminmax(self, device, dtype):
+        x = torch.randn(100, 50, 20, device=device).mul(10).to(dtype)
+        mn, mx = torch._aminmax(x)
+        self.assertEqual(mn, x.min())
+        self.assertEqual(mx, x.max())
+        for dim in range(x.dim()):
+            for keepdim in [False, True]:
+                mn, mx = torch._aminmax(x, dim, keepdim)
+                self.assertEqual(mn, x.min(dim, keepdim)[0])
+                self.assertEqual(mx, x.max(dim, keepdim)[0])
+        if dtype.is_floating_point:
+            x[3, 7, 4] = nan
+            mn, mx = torch._aminmax(x, 1)
+            self.assertTrue(torch.isnan(mn[3, 4]) and torch.isnan(mx[3, 4]))
+            self.assertFalse(torch.isnan(mn[2, 4]) or torch.isnan(mx[3, 5]))
+        with self.assertRaisesRegex(RuntimeError, "no elements"):
+            torch._aminmax(torch.empty(0, device=device, dtype=dtype))
+
+    @dtypes(torch.float, torch.double)
+    @dtypesIfCUDA(torch.half, torch.float, torch.double)
+    def test_sum_and_sumsq(self, device, dtype):
+        x = torch.randn(64, 30, 20, device=device).to(dtype)
+        for dim in [0, 2, (0, 2), (0, 1, 2)]:
+            for keepdim in [False, True]:
+                s, ss = torch._sum_and_sumsq(x, dim, keepdim)
+                self.assertEqual(s, x.double().sum(dim, keepdim).to(dtype), atol=1e-2, rtol=1e-3)
+                self.assertEqual(ss, x.double().pow(2).sum(dim, keepdim).to(dtype), atol=1e-2, rtol=1e-3)
+        s, ss = torch._sum_and_sumsq(torch.empty(0, 3, device=device, dtype=dtype), 0)
+        self.assertEqual(s, torch.zeros(3, device=device, dtype=dtype))
+        self.assertEqual(ss, torch.zeros(3, device=device, dtype=dtype))
+
     def test_std_mean_some_dims(self, device):
         sizes = (4, 6, 7, 5, 3)
         dims = len(sizes)
@@ -11677,6 +11980,88 @@ class TestTorchDeviceType(TestCase):
                                             [False, True, False, True, False],
                                             [True, False, True, False, True]], device=device))
 
+    def _scatter_reduce_reference(self, src, dim, index, op, output_size):
+        src = src.transpose(dim, 0)
+        index = index.transpose(dim, 0) if index.dim() > 1 else index
+        sizes = list(src.size())
+        sizes[0] = output_size
+        flat_src = src.reshape(src.size(0), -1)
+        flat_index = index.reshape(src.size(0), -1) if index.dim() > 1 else index.unsqueeze(1).expand_as(flat_src)
+        out = torch.zeros(output_size, flat_src.size(1), dtype=src.dtype)
+        for j in range(flat_src.size(1)):
+            for k in range(output_size):
+                values = flat_src[flat_index[:, j] == k, j]
+                if values.numel() == 0:
+                    out[k, j] = 1 if op == 'prod' else 0
+                elif op == 'sum':
+                    out[k, j] = values.sum()
+                elif op == 'prod':
+                    out[k, j] = values.prod()
+                elif op == 'mean':
+                    out[k, j] = values.sum() / values.numel() if values.is_floating_point() else values.sum() // values.numel()
+                elif op == 'max':
+                    out[k, j] = values.max()
+                else:
+                    out[k, j] = values.min()
+        return out.reshape(sizes).transpose(0, dim)
+
+    @dtypes(torch.float, torch.double, torch.long)
+    def test_scatter_reduce(self, device, dtype):
+        for op, dim, broadcast_index in product(['sum', 'prod', 'mean', 'max', 'min'], [0, 1, -1], [False, True]):
+            src = torch.randint(1, 5, (5, 6, 3), device=device).to(dtype)
+            if broadcast_index:
+                index = torch.randint(0, 4, (src.size(dim),), device=device)
+            else:
+                index = torch.randint(0, 4, src.size(), device=device)
+            result = torch.scatter_reduce(src, dim, index, op, output_size=5)
+            expected = self._scatter_reduce_reference(src.cpu(), dim % 3, index.cpu(), op, 5)
+            self.assertEqual(result, expected.to(device))
+            self.assertEqual(src.scatter_reduce(dim, index, op, output_size=5), result)
+
+        # the default output size is one more than the largest index
+        src = torch.tensor([[1, 2], [3, 4], [5, 6]], device=device).to(dtype)
+        result = torch.scatter_reduce(src, 0, torch.tensor([0, 1, 0], device=device), 'max')
+        self.assertEqual(result, torch.tensor([[5, 6], [3, 4]], device=device).to(dtype))
+        with self.assertRaisesRegex(RuntimeError, 'reduce must be one of'):
+            torch.scatter_reduce(src, 0, torch.tensor([0, 1, 0], device=device), 'median')
+        with self.assertRaisesRegex(RuntimeError, 'out of bounds'):
+            torch.scatter_reduce(src, 0, torch.tensor([0, 1, 2], device=device), 'sum', output_size=2)
+
+    @dtypes(torch.float, torch.double, torch.long)
+    def test_segment_reduce(self, device, dtype):
+        lengths = torch.tensor([2, 0, 3, 1], device=device)
+        for op, axis in product(['sum', 'prod', 'mean', 'max', 'min'], [0, 1]):
+            data = torch.randint(-4, 5, (6, 6), device=device).to(dtype)
+            index = torch.repeat_interleave(lengths)
+            self.assertEqual(
+                torch.segment_reduce(data, op, lengths=lengths, axis=axis),
+                torch.scatter_reduce(data, axis, index, op, output_size=lengths.numel()))
+        with self.assertRaisesRegex(RuntimeError, 'expected lengths to sum to'):
+            torch.segment_reduce(data, 'sum', lengths=torch.tensor([2, 2], device=device))
+
+    def test_scatter_reduce_backward(self, device):
+        src = torch.randn(6, 4, dtype=torch.double, device=device)
+        index = torch.tensor([0, 2, 0, 1, 2, 0], device=device)
+        lengths = torch.tensor([3, 0, 2, 1], device=device)
+        for op in ['sum', 'prod', 'mean', 'max', 'min']:
+            for dim in [0, 1]:
+                idx = index if dim == 0 else torch.randint(0, 3, src.size(), device=device)
+                self.assertTrue(torch.autograd.gradcheck(
+                    lambda x: torch.scatter_reduce(x, dim, idx, op, output_size=4),
+                    (src.clone().requires_grad_(),)))
+            self.assertTrue(torch.autograd.gradcheck(
+                lambda x: torch.segment_reduce(x, op, lengths=lengths),
+                (src.clone().requires_grad_(),)))
+
+        # the gradient of max goes to the first maximal value, and the one of
+        # prod to the zeros only if it is the only zero of its element
+        x = torch.tensor([1., 3., 3., 0., 2., 0., 5.], device=device, requires_grad=True)
+        torch.segment_reduce(x, 'max', lengths=torch.tensor([3, 4], device=device)).sum().backward()
+        self.assertEqual(x.grad, torch.tensor([0., 1., 0., 0., 0., 0., 1.], device=device))
+        x.grad = None
+        torch.scatter_reduce(x, 0, torch.tensor([0, 0, 0, 0, 1, 1, 1], device=device), 'prod').sum().backward()
+        self.assertEqual(x.grad, torch.tensor([0., 0., 0., 9., 0., 10., 0.], device=device))
+
     def test_masked_scatter_bool_tensor(self, device):
         src = torch.tensor([True, True, True], device=device)
         dst = torch.tensor([False, False, False], device=device)
@@ -13420,6 +13805,72 @@ class TestTorchDeviceType(TestCase):
             expected = x / x.norm(p, 0, keepdim=True).clamp(min=1)
             self.assertEqual(res.numpy(), expected.numpy(), "renorm failed for {}-norm".format(p))
 
+    @onlyCPU
+    @dtypes(torch.float, torch.double, torch.int64)
+    def test_sort_topk_large_slice(self, device, dtype):
+        # large slices are sorted and have their top k selected by all threads
+        # together, with the same result for any number of threads: ties are
+        # in index order
+        x = torch.randint(0, 1000, (2, 200000), dtype=dtype, device=device)
+        if dtype.is_floating_point:
+            x[0, 100] = float('nan')
+            x[1, 7] = float('nan')
+        num_threads = torch.get_num_threads()
+        try:
+            results = []
+            for threads in (1, 4):
+                torch.set_num_threads(threads)
+                results.append([x.sort(), x.sort(descending=True), x[0].sort(),
+                                x.topk(50), x.topk(50, largest=False), x[0].topk(50)])
+        finally:
+            torch.set_num_threads(num_threads)
+        for serial, parallel in zip(*results):
+            self.assertEqual(serial[0], parallel[0])
+            self.assertEqual(serial[1], parallel[1])
+
+        for descending in (False, True):
+            values, indices = x.sort(descending=descending)
+            self.assertEqual(values, x.gather(1, indices))
+            # NaN is last in ascending and first in descending order
+            first, second = (values[:, 1:], values[:, :-1]) if descending else (values[:, :-1], values[:, 1:])
+            self.assertTrue(((first <= second) | (second != second)).all())
+            same = values[:, 1:] == values[:, :-1]
+            self.assertTrue((indices[:, 1:] > indices[:, :-1])[same].all())
+
+            values, indices = x.topk(50, largest=descending)
+            expected_values, expected_indices = x.sort(descending=descending)
+            self.assertEqual(values, expected_values[:, :50])
+            self.assertEqual(indices, expected_indices[:, :50])
+
+    @onlyCUDA
+    @dtypes(torch.half, torch.float, torch.double, torch.int64)
+    def test_sort_topk_large_slice_gpu(self, device, dtype):
+        # few long slices are split across blocks by topk, and slices longer
+        # than the in-place sort limit are radix sorted, one at a time or all
+        # together; both keep ties in index order, like on CPU
+        for shape in ((2, 1000000), (300, 5000)):
+            x = torch.randint(0, 1000, shape).to(torch.double if dtype.is_floating_point else dtype)
+            if dtype.is_floating_point:
+                x[0, 100] = float('nan')
+                x[1, 7] = float('nan')
+            x_gpu = x.to(device, dtype)
+            for descending in (False, True):
+                values, indices = x_gpu.sort(descending=descending)
+                expected_values, expected_indices = x.sort(descending=descending)
+                expected_values = expected_values.to(dtype)
+                self.assertEqual(values, expected_values, allow_inf=True)
+                self.assertEqual(indices, expected_indices)
+
+                for k in (1, 50, 5000):
+                    values, indices = x_gpu.topk(k, largest=descending)
+                    self.assertEqual(values, expected_values[:, :k], allow_inf=True)
+                    self.assertEqual(indices, expected_indices[:, :k])
+
+            values, indices = x_gpu.t().topk(50, dim=0)
+            expected_values, expected_indices = x.t().topk(50, dim=0)
+            self.assertEqual(values, expected_values.to(dtype), allow_inf=True)
+            self.assertEqual(indices, expected_indices)
+
     @onlyCUDA
     def test_topk_noncontiguous_gpu(self, device):
         t = torch.randn(20, device=device)[::2]
@@ -13809,6 +14260,36 @@ class TestTorchDeviceType(TestCase):
                                     count += 1
                             self.assertEqual(j, count)
 
+    @dtypes(torch.float, torch.long)
+    def test_unique_large(self, device, dtype):
+        # Large enough to be split across threads on CPU.
+        x = torch.randint(-1000, 1000, (200000,), device=device).to(dtype)
+        x_list = x.tolist()
+        expected = sorted(set(x_list))
+        unique, inverse, counts = torch.unique(x, sorted=True, return_inverse=True, return_counts=True)
+        self.assertEqual(unique.tolist(), expected)
+        self.assertEqual(unique[inverse], x, 0)
+        self.assertEqual(counts, torch.bincount(inverse, minlength=unique.numel()))
+
+        unique, inverse, counts = torch.unique(x, sorted=False, return_inverse=True, return_counts=True)
+        self.assertEqual(sorted(unique.tolist()), expected)
+        self.assertEqual(unique[inverse], x, 0)
+        self.assertEqual(counts, torch.bincount(inverse, minlength=unique.numel()))
+
+        x = x.sort()[0].repeat_interleave(2)
+        unique, inverse, counts = torch.unique_consecutive(x, return_inverse=True, return_counts=True)
+        self.assertEqual(unique.tolist(), expected)
+        self.assertEqual(unique[inverse], x, 0)
+        self.assertEqual(counts.sum(), x.numel())
+        self.assertEqual(counts, torch.bincount(inverse, minlength=unique.numel()))
+
+    @onlyCPU
+    def test_unique_nan(self, device):
+        x = torch.tensor([nan, 1, nan, 1, 2], device=device)
+        unique = torch.unique(x, sorted=False)
+        self.assertEqual(unique.numel(), 4)
+        self.assertEqual(unique.isnan().sum(), 2)
+
     @dtypes(*set(torch.testing.get_all_dtypes()) - {torch.bfloat16, torch.complex64, torch.complex128})
     def test_unique_consecutive(self, device, dtype):
         if dtype is torch.half and self.device_type == 'cpu':
@@ -13887,6 +14368,24 @@ class TestTorchDeviceType(TestCase):
         z = from_dlpack(to_dlpack(x))
         self.assertEqual(z, x)
 
+    @onlyCUDA
+    def test_dlpack_conversion_on_stream(self, device):
+        producer = torch.cuda.Stream(device)
+        consumer = torch.cuda.Stream(device)
+        with torch.cuda.stream(producer):
+            x = torch.randn(100, 100, device=device).mm(torch.randn(100, 100, device=device))
+            # the consumer waits for the producer on export
+            exported = to_dlpack(x, stream=consumer)
+            # or on import
+            imported = to_dlpack(x)
+        with torch.cuda.stream(consumer):
+            y = from_dlpack(exported)
+            z = from_dlpack(imported, stream=producer)
+            self.assertEqual(y.data_ptr(), x.data_ptr())
+            result = y + z
+        consumer.synchronize()
+        self.assertEqual(result, x * 2)
+
     @onlyCUDA
     @unittest.skipIf(PYTORCH_CUDA_MEMCHECK, "is_pinned uses failure to detect pointer property")
     def test_pin_memory_from_constructor(self, device):
@@ -15628,6 +16127,49 @@ scipy_lobpcg  | {:10.2e}  | {:10.2e}  | {:6} | N/A
         res6 = torch.baddbmm(res2, b1, b2, beta=.1, alpha=.5)
         self.assertEqual(res6, res2 * .1 + res * .5)
 
+    @onlyCPU
+    @dtypes(torch.float, torch.double, torch.long)
+    def test_bmm_small_matrices(self, device, dtype):
+        # many small matrices go through the batched kernel, with fixed-size
+        # paths for some of the widths
+        def make(*shape):
+            if dtype.is_floating_point:
+                return torch.randn(*shape, dtype=dtype, device=device)
+            return torch.randint(-10, 10, shape, dtype=dtype, device=device)
+
+        for M, N, O in ((4, 4, 4), (8, 8, 8), (5, 7, 3), (16, 3, 16), (32, 32, 32), (2, 9, 2)):
+            for transpose1, transpose2 in product((False, True), repeat=2):
+                b1 = make(50, N, M).transpose(1, 2) if transpose1 else make(50, M, N)
+                b2 = make(50, O, N).transpose(1, 2) if transpose2 else make(50, N, O)
+                expected = torch.stack([torch.mm(b1[i], b2[i]) for i in range(50)])
+                self.assertEqual(torch.bmm(b1, b2), expected)
+                c = make(50, M, O)
+                self.assertEqual(torch.baddbmm(c, b1, b2, beta=2, alpha=3), c * 2 + expected * 3)
+
+    @skipCPUIfNoLapack
+    @onlyCPU
+    @dtypes(torch.double)
+    def test_linalg_small_matrices_batched(self, device, dtype):
+        # batches of small matrices are factorized in parallel; the errors must
+        # still name the first failing matrix
+        from torch.testing._internal.common_utils import random_fullrank_matrix_distinct_singular_value
+
+        A = random_fullrank_matrix_distinct_singular_value(4, 300).to(device, dtype)
+        b = torch.randn(300, 4, 2, dtype=dtype, device=device)
+        self.assertEqual(torch.matmul(torch.inverse(A), A), torch.eye(4, dtype=dtype, device=device).expand_as(A))
+        self.assertEqual(torch.matmul(A, torch.solve(b, A)[0]), b)
+        spd = torch.matmul(A, A.transpose(-2, -1)) + torch.eye(4, dtype=dtype, device=device)
+        L = torch.cholesky(spd)
+        self.assertEqual(torch.matmul(L, L.transpose(-2, -1)), spd)
+        self.assertEqual(torch.matmul(spd, torch.cholesky_solve(b, L)), b)
+
+        A[123].zero_()
+        A[250].zero_()
+        with self.assertRaisesRegex(RuntimeError, "For batch 123"):
+            torch.inverse(A)
+        with self.assertRaisesRegex(RuntimeError, "For batch 123"):
+            torch.solve(b, A)
+
     def _test_cop(self, torchfn, mathfn, dtype, device):
         def reference_implementation(res2):
             for i, j in iter_indices(sm1):
@@ -16050,6 +16592,32 @@ scipy_lobpcg  | {:10.2e}  | {:10.2e}  | {:6} | N/A
         self.assertRaises(RuntimeError, lambda: torch.cat([]))
         self.assertRaisesRegex(TypeError, 'got None', lambda: torch.cat([x, None]))
 
+    @onlyCPU
+    def test_cat_stack_mixed_strides_and_dtypes(self, device):
+        x = torch.randn(4, 5, 6, device=device)
+        y = torch.randn(6, 4, 5, device=device).permute(1, 2, 0)
+        z = torch.randn(4, 10, 6, device=device)[:, ::2]
+        w = torch.randint(-10, 10, (4, 5, 6), device=device, dtype=torch.int)
+        for dim in range(3):
+            res = torch.cat((x, y, z, w), dim)
+            self.assertEqual(res.dtype, torch.float)
+            self.assertEqual(res.narrow(dim, 0, x.size(dim)), x, 0)
+            self.assertEqual(res.narrow(dim, x.size(dim), y.size(dim)), y, 0)
+            self.assertEqual(res.narrow(dim, 2 * x.size(dim), z.size(dim)), z, 0)
+            self.assertEqual(res.narrow(dim, 3 * x.size(dim), w.size(dim)), w.float(), 0)
+
+        for dim in range(4):
+            expected = torch.cat([t.float().unsqueeze(dim) for t in (x, y, z, w)], dim)
+            self.assertEqual(torch.stack((x, y, z, w), dim), expected, 0)
+            out = torch.empty(0, device=device, dtype=torch.double)
+            torch.stack((x, y, z, w), dim, out=out)
+            self.assertEqual(out, expected.double(), 0)
+
+        # Enough work to be split across threads.
+        parts = [torch.randn(64, 37, device=device).t() for _ in range(100)]
+        self.assertEqual(torch.cat(parts, 1), torch.cat([p.contiguous() for p in parts], 1), 0)
+        self.assertEqual(torch.stack(parts), torch.stack([p.contiguous() for p in parts]), 0)
+
     @onlyCPU
     def test_cat_scalars(self, device):
         x = torch.tensor(0, device=device)
@@ -16388,6 +16956,23 @@ scipy_lobpcg  | {:10.2e}  | {:10.2e}  | {:6} | N/A
         expected_result = torch.tensor([2, 4, 3, 4], device=device)
         self.assertEqual(torch.searchsorted(boundaries, values_nan, right=True), expected_result)
 
+        # many more values than 1d boundaries, with repeated boundaries
+        if TEST_NUMPY:
+            for dtype, num_boundaries in product([torch.int32, torch.float64], [1, 7, 64, 1000]):
+                boundaries = torch.randint(-50, 50, (num_boundaries,), device=device).sort()[0].to(dtype)
+                values = torch.randint(-60, 60, (3, 2000), device=device).to(dtype)
+                if dtype.is_floating_point:
+                    values[0, ::7] = float('nan')
+                    values[1, ::11] = float('inf')
+                    values[2, ::13] = float('-inf')
+                for right in [False, True]:
+                    side = 'right' if right else 'left'
+                    expected_result = torch.from_numpy(np.searchsorted(
+                        boundaries.cpu().numpy(), values.cpu().numpy(), side=side)).to(device)
+                    self.assertEqual(torch.searchsorted(boundaries, values, right=right), expected_result)
+                    self.assertEqual(torch.bucketize(values, boundaries, right=right, out_int32=True),
+                                     expected_result.int())
+
         # type promotion and non contiguous tensors
         values_3d_permute = values_3d.permute(2, 1, 0).to(torch.int32)
         boundaries_permute = values_3d.permute(2, 1, 0).to(torch.float64)
@@ -18047,6 +18632,253 @@ class TestTensorDeviceOps(TestCase):
 class TestTorchMathOps(TestCase):
     exact_dtype = True
 
+class TestNestedTensor(TestCase):
+    def _entries(self, lengths, *inner):
+        return [torch.randn(length, *inner, dtype=torch.double) for length in lengths]
+
+    def test_nested_layout(self):
+        entries = self._entries([2, 0, 3], 4)
+        x = torch.nested_tensor(entries)
+        self.assertEqual(x.layout, torch.nested)
+        self.assertEqual(x.size(), (3, 3, 4))
+        self.assertEqual(x.nested_offsets(), torch.tensor([0, 2, 2, 5]))
+        self.assertEqual(x.values(), torch.cat(entries))
+        for entry, expected in zip(x.unbind(), entries):
+            self.assertEqual(entry, expected)
+        self.assertIn('layout=torch.nested', str(x))
+
+        with self.assertRaisesRegex(RuntimeError, "only differ in dim 0"):
+            torch.nested_tensor([torch.randn(2, 3), torch.randn(2, 4)])
+        with self.assertRaisesRegex(RuntimeError, "at least one dim"):
+            torch.nested_tensor([torch.tensor(1.)])
+
+    def test_padded_conversions(self):
+        entries = self._entries([3, 1, 0, 4], 2, 3)
+        x = torch.nested_tensor(entries)
+        padded = x.to_padded(-1.)
+        self.assertEqual(padded.size(), (4, 4, 2, 3))
+        for i, entry in enumerate(entries):
+            self.assertEqual(padded[i, :entry.size(0)], entry)
+            self.assertTrue((padded[i, entry.size(0):] == -1).all())
+
+        lengths = torch.tensor([e.size(0) for e in entries])
+        y = torch.nested_from_padded(padded, lengths)
+        self.assertEqual(y.nested_offsets(), x.nested_offsets())
+        self.assertEqual(y.values(), x.values())
+        self.assertEqual(torch.nested_from_padded(padded.transpose(2, 3).contiguous().transpose(2, 3),
+                                                  lengths).values(), x.values())
+
+        with self.assertRaisesRegex(RuntimeError, "expected lengths in"):
+            torch.nested_from_padded(padded, torch.tensor([1, 5, 0, 0]))
+
+    def test_nested_elementwise(self):
+        entries = self._entries([3, 1, 4], 5)
+        x = torch.nested_tensor(entries)
+        y = torch.nested_tensor(self._entries([3, 1, 4], 5))
+        bias = torch.randn(5, dtype=torch.double)
+
+        self.assertEqual((x + y).values(), x.values() + y.values())
+        self.assertEqual(torch.add(x, y, alpha=2).values(), x.values() + 2 * y.values())
+        self.assertEqual((x * y).values(), x.values() * y.values())
+        self.assertEqual((x + bias).values(), x.values() + bias)
+        self.assertEqual((bias * x).values(), bias * x.values())
+        self.assertEqual((x * 2).values(), x.values() * 2)
+        for fn in [torch.relu, torch.tanh, torch.sigmoid, torch.nn.functional.gelu]:
+            result = fn(x)
+            self.assertEqual(result.layout, torch.nested)
+            self.assertEqual(result.values(), fn(x.values()))
+
+        with self.assertRaisesRegex(RuntimeError, "entries of the same lengths"):
+            x + torch.nested_tensor(self._entries([2, 2, 4], 5))
+        with self.assertRaisesRegex(RuntimeError, "inner dims"):
+            x + torch.randn(4, 5, dtype=torch.double)
+
+    def test_nested_linear_layer_norm(self):
+        entries = self._entries([3, 0, 2], 6)
+        x = torch.nested_tensor(entries)
+        weight = torch.randn(4, 6, dtype=torch.double)
+        bias = torch.randn(4, dtype=torch.double)
+
+        result = torch.nn.functional.linear(x, weight, bias)
+        self.assertEqual(result.size(), (3, 3, 4))
+        for entry, expected in zip(result.unbind(), entries):
+            self.assertEqual(entry, torch.nn.functional.linear(expected, weight, bias))
+
+        result = torch.nn.functional.layer_norm(x, (6,))
+        for entry, expected in zip(result.unbind(), entries):
+            self.assertEqual(entry, torch.nn.functional.layer_norm(expected, (6,)))
+
+        with self.assertRaisesRegex(RuntimeError, "inner dims"):
+            torch.nn.functional.layer_norm(x, (3, 6))
+
+    def test_nested_softmax(self):
+        entries = self._entries([3, 1, 0, 5], 4)
+        x = torch.nested_tensor(entries)
+        # Over the ragged dim, the padding is left out of the normalization.
+        for entry, expected in zip(torch.softmax(x, 1).unbind(), entries):
+            self.assertEqual(entry, torch.softmax(expected, 0))
+        for entry, expected in zip(torch.softmax(x, -1).unbind(), entries):
+            self.assertEqual(entry, torch.softmax(expected, -1))
+
+        with self.assertRaisesRegex(RuntimeError, "dim 0"):
+            torch.softmax(x, 0)
+
+    def test_nested_attention(self):
+        def reference(q, k, v):
+            scores = torch.matmul(q.transpose(0, 1), k.permute(1, 2, 0)) / math.sqrt(q.size(-1))
+            return torch.matmul(torch.softmax(scores, -1), v.transpose(0, 1)).transpose(0, 1)
+
+        q_entries = self._entries([4, 1, 3], 2, 8)
+        k_entries = self._entries([2, 5, 3], 2, 8)
+        v_entries = self._entries([2, 5, 3], 2, 6)
+        q, k, v = (torch.nested_tensor(e) for e in (q_entries, k_entries, v_entries))
+        result = torch.nested_attention(q, k, v)
+        self.assertEqual(result.nested_offsets(), q.nested_offsets())
+        self.assertEqual(result.size(), (3, 4, 2, 6))
+        for i, entry in enumerate(result.unbind()):
+            self.assertEqual(entry, reference(q_entries[i], k_entries[i], v_entries[i]))
+
+        # A single head, and entries without keys.
+        q_entries = self._entries([2, 3], 8)
+        k_entries = self._entries([3, 0], 8)
+        q, k = torch.nested_tensor(q_entries), torch.nested_tensor(k_entries)
+        result = torch.nested_attention(q, k, k)
+        self.assertEqual(result.unbind()[0],
+                         reference(q_entries[0].unsqueeze(1), k_entries[0].unsqueeze(1),
+                                   k_entries[0].unsqueeze(1)).squeeze(1))
+        self.assertEqual(result.unbind()[1], torch.zeros(3, 8, dtype=torch.double))
+
+        with self.assertRaisesRegex(RuntimeError, "entries of the same lengths"):
+            torch.nested_attention(q, k, q)
+
+
+class TestCopyOnWrite(TestCase):
+    def setUp(self):
+        super(TestCopyOnWrite, self).setUp()
+        self.prev = torch.is_copy_on_write()
+        torch.set_copy_on_write(True)
+
+    def tearDown(self):
+        torch.set_copy_on_write(self.prev)
+        super(TestCopyOnWrite, self).tearDown()
+
+    def test_clone_writes_are_private(self):
+        a = torch.arange(100, dtype=torch.float)
+        b = a.clone()
+        c = b.to(torch.float, copy=True)
+        # Reads don't need a copy
+        self.assertEqual(b.sum(), a.sum())
+        self.assertEqual(b + 1, a + 1)
+
+        b.add_(1)
+        self.assertEqual(a, torch.arange(100, dtype=torch.float))
+        self.assertEqual(b, torch.arange(1, 101, dtype=torch.float))
+        a[0] = -1
+        self.assertEqual(c, torch.arange(100, dtype=torch.float))
+        self.assertEqual(b[0], 1)
+        torch.mul(c, 2, out=c)
+        self.assertEqual(a[:2], torch.tensor([-1., 1.]))
+
+        # Views share the copy-on-write state of their base
+        d = a.clone()
+        view = d[10:20]
+        view.zero_()
+        self.assertEqual(d[10:20], torch.zeros(10))
+        self.assertEqual(a[10:20], torch.arange(10, 20, dtype=torch.float))
+
+    def test_clone_copies_unshareable_data(self):
+        # A tensor that doesn't span its storage, and a permuted one
+        a = torch.randn(4, 6)
+        for src in (a[1:], a.t()):
+            b = src.clone()
+            b.zero_()
+            self.assertNotEqual(src.abs().sum(), 0)
+        c = torch.randn(8, 8).clone(memory_format=torch.contiguous_format)
+        c.fill_(2)
+        self.assertEqual(c, torch.full((8, 8), 2.))
+
+    def test_clone_autograd(self):
+        x = torch.randn(5, 5, requires_grad=True)
+        y = x.clone()
+        z = y * y
+        expected = 2 * x.detach()
+        version = y._version
+        # Writing to the source doesn't change the copy saved for backward
+        with torch.no_grad():
+            x.mul_(3)
+        self.assertEqual(y._version, version)
+        z.sum().backward()
+        self.assertEqual(x.grad, expected)
+
+        # Writing to the saved tensor itself is still detected
+        y = x.clone()
+        z = y.pow(2)
+        with torch.no_grad():
+            y.mul_(2)
+        self.assertEqual(y._version, version + 1)
+        with self.assertRaisesRegex(RuntimeError, "modified by an inplace operation"):
+            z.sum().backward()
+
+
+class TestAutocastCPU(TestCase):
+    def test_autocast_cpu_lower_precision(self):
+        a = torch.randn(8, 8)
+        b = torch.randn(8, 8)
+        x = torch.randn(2, 3, 8, 8)
+        conv = torch.nn.Conv2d(3, 4, 3)
+        with torch.cpu.amp.autocast():
+            self.assertTrue(torch.is_autocast_cpu_enabled())
+            self.assertFalse(torch.is_autocast_enabled())
+            self.assertEqual(torch.mm(a, b).dtype, torch.bfloat16)
+            self.assertEqual(torch.bmm(a.unsqueeze(0), b.unsqueeze(0)).dtype, torch.bfloat16)
+            self.assertEqual(conv(x).dtype, torch.bfloat16)
+            self.assertEqual(conv.weight.dtype, torch.float32)
+            # Doubles are not eligible.
+            self.assertEqual(torch.mm(a.double(), b.double()).dtype, torch.double)
+        self.assertFalse(torch.is_autocast_cpu_enabled())
+        self.assertEqual(torch.mm(a, b).dtype, torch.float32)
+
+    def test_autocast_cpu_fp32_and_promote(self):
+        a = torch.randn(8, 8)
+        a_bf16 = a.bfloat16()
+        with torch.cpu.amp.autocast():
+            self.assertEqual(torch.softmax(a_bf16, 0).dtype, torch.float32)
+            self.assertEqual(torch.log_softmax(a_bf16, 0).dtype, torch.float32)
+            self.assertEqual(torch.sum(a_bf16).dtype, torch.float32)
+            self.assertEqual(torch.cat((a, a_bf16)).dtype, torch.float32)
+            self.assertEqual(torch.stack((a_bf16, a_bf16)).dtype, torch.bfloat16)
+            # The promoted result matches the float32 one.
+            self.assertEqual(torch.cat((a, a_bf16)), torch.cat((a, a_bf16.float())))
+
+    def test_autocast_cpu_nesting_and_backward(self):
+        a = torch.randn(8, 8)
+        w = torch.randn(8, 8, requires_grad=True)
+        with torch.cpu.amp.autocast():
+            # The cast of the leaf w is cached and reused by the second mm.
+            out = torch.mm(a, w) + torch.mm(a, w)
+            self.assertEqual(out.dtype, torch.bfloat16)
+            with torch.cpu.amp.autocast(enabled=False):
+                self.assertFalse(torch.is_autocast_cpu_enabled())
+                self.assertEqual(torch.mm(a, w).dtype, torch.float32)
+            self.assertTrue(torch.is_autocast_cpu_enabled())
+        out.float().sum().backward()
+        self.assertEqual(w.grad.dtype, torch.float32)
+        self.assertEqual(w.grad, 2 * a.t().mm(torch.ones(8, 8)), atol=1e-1, rtol=1e-2)
+
+    def test_autocast_cpu_script(self):
+        @torch.jit.script
+        def fn(a, b):
+            return torch.cat((torch.mm(a, b), a))
+
+        a = torch.randn(8, 8)
+        b = torch.randn(8, 8)
+        with torch.cpu.amp.autocast():
+            # The mm runs in bfloat16, then cat promotes to float32.
+            self.assertEqual(fn(a, b).dtype, torch.float32)
+            self.assertEqual(fn(a, b)[:8], torch.mm(a, b).float())
+        self.assertEqual(fn(a, b)[:8], torch.mm(a, b))
+
+
 class TestTorch(TestCase, _TestTorchMixin):
     exact_dtype = True
 
@@ -251,6 +251,29 @@ class TestTypePromotion(TestCase):
                 self.assertEqual(result.dtype, expected.dtype, message='{} with {}, {}'.format(op.__name__, dt1, dt2))
                 self.assertEqual(result, expected, message='{} with {}, {}'.format(op.__name__, dt1, dt2))
 
+    # Mixed dtype operands with the layouts the CUDA elementwise kernels
+    # vectorize (outer and inner broadcasts, strided outer dimensions) and the
+    # ones they cannot (odd inner sizes, misaligned or strided inner dimensions).
+    def test_mixed_dtype_layouts(self, device):
+        low = torch.half if self.device_type == 'cuda' else torch.float
+        a = torch.randn(64, 36, device=device)
+        others = [torch.randn(36, device=device),
+                  torch.randn(64, 1, device=device),
+                  torch.randn(64, 72, device=device)[:, ::2],
+                  torch.randn(64, 40, device=device)[:, 4:],
+                  torch.randn(36, 64, device=device).t()]
+        for other in others:
+            for x, y in ((a.to(low), other), (a, other.to(low))):
+                expected = x.double() * y.double()
+                self.assertEqual(torch.mul(x, y), expected.to(torch.float), atol=1e-2, rtol=1e-2)
+                out = torch.empty(64, 36, dtype=low, device=device)
+                torch.add(x, y, out=out)
+                self.assertEqual(out, (x.double() + y.double()).to(low), atol=1e-2, rtol=1e-2)
+            # odd inner size and misaligned operands
+            x = a[1:, 1:].to(low)
+            y = other[1:, 1:] if other.dim() == 2 and other.size(1) > 1 else other[1:]
+            self.assertEqual(x + y, (x.double() + y.double()).to(torch.float), atol=1e-2, rtol=1e-2)
+
     @float_double_default_dtype
     def test_non_promoting_ops(self, device):
         x = torch.ones(4, dtype=torch.double, device=device)
@@ -94,6 +94,70 @@ class TestXNNPACKOps(TestCase):
         xnnpack_result = torch.ops.prepacked.conv2d_clamp_run(input_data, packed_weight_bias)
         torch.testing.assert_allclose(ref_result, xnnpack_result, rtol=1e-2, atol=1e-3)
 
+    @given(batch_size=st.integers(0, 3),
+           input_channels_per_group=st.integers(1, 32),
+           height=st.integers(5, 64),
+           width=st.integers(5, 64),
+           output_channels_per_group=st.integers(1, 32),
+           groups=st.integers(1, 16),
+           kernel_h=st.integers(1, 7),
+           kernel_w=st.integers(1, 7),
+           stride_h=st.integers(1, 2),
+           stride_w=st.integers(1, 2),
+           pad_h=st.integers(0, 2),
+           pad_w=st.integers(0, 2),
+           output_pad_h=st.integers(0, 1),
+           output_pad_w=st.integers(0, 1),
+           dilation=st.integers(1, 2),
+           use_bias=st.booleans(),
+           format=st.sampled_from([None, torch.preserve_format, torch.contiguous_format, torch.channels_last]))
+    def test_conv2d_transpose(self,
+                              batch_size,
+                              input_channels_per_group,
+                              height,
+                              width,
+                              output_channels_per_group,
+                              groups,
+                              kernel_h,
+                              kernel_w,
+                              stride_h,
+                              stride_w,
+                              pad_h,
+                              pad_w,
+                              output_pad_h,
+                              output_pad_w,
+                              dilation,
+                              use_bias,
+                              format):
+        input_channels = input_channels_per_group * groups
+        output_channels = output_channels_per_group * groups
+        kernels = (kernel_h, kernel_w)
+        strides = (stride_h, stride_w)
+        paddings = (pad_h, pad_w)
+        output_paddings = (output_pad_h, output_pad_w)
+        dilations = (dilation, dilation)
+        assume(output_pad_h < max(stride_h, dilation))
+        assume(output_pad_w < max(stride_w, dilation))
+        assume((height - 1) * strides[0] - 2 * paddings[0] +
+               dilations[0] * (kernels[0] - 1) + output_paddings[0] + 1 > 0)
+        assume((width - 1) * strides[1] - 2 * paddings[1] +
+               dilations[1] * (kernels[1] - 1) + output_paddings[1] + 1 > 0)
+
+        input_data = torch.rand((batch_size, input_channels, height, width))
+        if (format is not None):
+            input_data = input_data.contiguous(memory_format=format)
+        weight = torch.rand((input_channels, output_channels_per_group, kernel_h, kernel_w))
+        bias = None
+        if use_bias:
+            bias = torch.rand((output_channels))
+
+        ref_result = F.conv_transpose2d(input_data, weight, bias,
+                                        strides, paddings, output_paddings, groups, dilations)
+        packed_weight_bias = torch.ops.prepacked.conv2d_transpose_clamp_prepack(
+            weight, bias, strides, paddings, output_paddings, dilations, groups)
+        xnnpack_result = torch.ops.prepacked.conv2d_transpose_clamp_run(input_data, packed_weight_bias)
+        torch.testing.assert_allclose(ref_result, xnnpack_result, rtol=1e-2, atol=1e-3)
+
 
 @unittest.skipUnless(torch.backends.xnnpack.enabled,
                      " XNNPACK must be enabled for these tests."
@@ -487,6 +551,33 @@ class TestXNNPACKRewritePass(TestCase):
                              "prepacked::conv2d_clamp_run": 1}
         validate_transformed_module(Conv2D(), pattern_count_map, data_shape)
 
+        conv_transpose_weight_shape = (input_channels, output_channels_per_group, kernel_h, kernel_w)
+
+        class Conv2DTranspose(torch.nn.Module):
+            def __init__(self):
+                super(Conv2DTranspose, self).__init__()
+                self.weight = torch.nn.Parameter(torch.Tensor(torch.rand(conv_transpose_weight_shape)))
+                self.bias = torch.nn.Parameter(torch.Tensor(torch.rand(conv_bias_shape)))
+                self.strides = strides
+                self.paddings = paddings
+                self.output_paddings = (0, 0)
+                self.dilations = dilations
+                self.groups = groups
+
+            def forward(self, x):
+                x = F.conv_transpose2d(x, self.weight, self.bias, self.strides, self.paddings,
+                                       self.output_paddings, self.groups, self.dilations)
+                return F.relu(x)
+
+        pattern_count_map = {"Tensor = aten::conv_transpose2d": -1,
+                             "prepacked::conv2d_transpose_clamp_prepack": 1,
+                             "prepacked::conv2d_transpose_clamp_run": 1}
+        validate_transformed_module(Conv2DTranspose(), pattern_count_map, data_shape)
+        pattern_count_map["prepacked::conv2d_transpose_clamp_prepack"] = -1
+        pattern_count_map["aten::relu"] = -1
+        validate_transformed_module(Conv2DTranspose(), pattern_count_map, data_shape,
+                                    prepack_removal=True, fuse_clamping_ops=True)
+
         input_data = torch.rand((batch_size, input_channels, height, width))
         conv_weight = torch.rand((output_channels, input_channels_per_group, kernel_h, kernel_w))
         conv_bias = torch.rand((output_channels))
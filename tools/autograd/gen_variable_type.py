@@ -94,6 +94,24 @@ DONT_PROFILE = {
     'size', 'storage_offset', 'stride',
 }
 
+# These functions have kernels of their own in deferred mode (see
+# ATen/DeferredMode.cpp), or only look at or change the metadata of tensors,
+# so they don't flush the deferred ops.
+DONT_FLUSH_DEFERRED = {
+    'add', 'sub', 'mul', 'div', 'neg', 'exp', 'tanh', 'sigmoid',
+    'empty', 'empty_like', 'empty_strided', 'alias', 'as_strided', 'detach',
+    'expand', 'permute', 'select', 'slice', 'squeeze', 'transpose', 't',
+    'unsqueeze', 'view',
+}
+
+# These in-place functions only change the metadata of a tensor, not its
+# data, so they don't check that the tensor is writeable.
+DONT_CHECK_WRITEABLE = {
+    '_coalesced_', '_mkldnn_transpose_', 'as_strided_', 'set_', 'set_quantizer_',
+    'sparse_resize_', 'sparse_resize_and_clear_', 'squeeze_', 't_', 'transpose_',
+    'unsqueeze_',
+}
+
 # We don't set or modify grad_fn on these methods. Generally, they return
 # tensors that have requires_grad=False. In-place functions listed here will
 # not examine or modify requires_grad or grad_fn.
@@ -348,6 +366,14 @@ RECORD_FUNCTION("${name}", std::vector<c10::IValue>({${input_names}}), Node::pee
 return c10::Dispatcher::singleton().callUnboxedRedispatch<${ret_and_arg_types}>(${profiled_dispatch_args});
 """)
 
+# DeferredType templates
+DEFERRED_DISPATCH_UNBOXED = CodeTemplate("""\
+static auto op = c10::Dispatcher::singleton().findSchema({"aten::${operator_name}", "${overload_name}"});
+TORCH_INTERNAL_ASSERT(op);
+at::deferred::flush();
+return c10::Dispatcher::singleton().callUnboxedRedispatch<${ret_and_arg_types}>(${deferred_dispatch_args});
+""")
+
 FACTORY_FUNCTION_NAMES = None
 
 
@@ -556,12 +582,15 @@ def gen_variable_type_shard(out, aten_declarations, template_path, suffix, heade
     VARIABLE_TYPE_H = CodeTemplate.from_file(template_path + '/VariableType.h')
     VARIABLE_TYPE_CPP = CodeTemplate.from_file(template_path + '/VariableType.cpp')
     PROFILED_TYPE_CPP = CodeTemplate.from_file(template_path + '/ProfiledType.cpp')
+    DEFERRED_TYPE_CPP = CodeTemplate.from_file(template_path + '/DeferredType.cpp')
 
     type_declarations = []
     type_definitions = []
     wrapper_registrations = []
     profiled_method_definitions = []
     profiled_wrapper_registrations = []
+    deferred_method_definitions = []
+    deferred_wrapper_registrations = []
 
     for declaration in aten_declarations:
         formal_types = [arg['type'] for arg in declaration['arguments']]
@@ -590,12 +619,27 @@ def gen_variable_type_shard(out, aten_declarations, template_path, suffix, heade
             profiled_wrapper_registrations.append(UNBOXEDONLY_WRAPPER_REGISTRATION.substitute(
                 declaration, class_type='ProfiledType'))
 
+        # Emit DeferredType code, only for functions with kernels of their
+        # own; the others are implemented on top of these.
+        if should_flush_deferred(declaration):
+            deferred_body = emit_deferred_body(declaration)
+            deferred_method_definitions.append(METHOD_DEFINITION.substitute(
+                declaration, type_definition_body=deferred_body))
+            if declaration['use_c10_dispatcher'] == 'full':
+                deferred_wrapper_registrations.append(WRAPPER_REGISTRATION.substitute(
+                    declaration, class_type='DeferredType'))
+            else:
+                deferred_wrapper_registrations.append(UNBOXEDONLY_WRAPPER_REGISTRATION.substitute(
+                    declaration, class_type='DeferredType'))
+
     env = {
         'type_derived_method_declarations': type_declarations,
         'type_derived_method_definitions': type_definitions,
         'wrapper_registrations': wrapper_registrations,
         'profiled_method_definitions': profiled_method_definitions,
-        'profiled_wrapper_registrations': profiled_wrapper_registrations
+        'profiled_wrapper_registrations': profiled_wrapper_registrations,
+        'deferred_method_definitions': deferred_method_definitions,
+        'deferred_wrapper_registrations': deferred_wrapper_registrations,
     }
     if header:
         write(out, 'VariableType.h', VARIABLE_TYPE_H, env)
@@ -603,6 +647,7 @@ def gen_variable_type_shard(out, aten_declarations, template_path, suffix, heade
         write(out, 'VariableType%s.cpp' % suffix, VARIABLE_TYPE_CPP, env)
 
     write(out, 'ProfiledType%s.cpp' % suffix, PROFILED_TYPE_CPP, env)
+    write(out, 'DeferredType%s.cpp' % suffix, DEFERRED_TYPE_CPP, env)
 
 def emit_profiled_body(declaration):
     arguments = declaration['arguments']
@@ -640,6 +685,22 @@ def emit_profiled_body(declaration):
 
     return [call]
 
+def should_flush_deferred(declaration):
+    return (dispatch_strategy(declaration) == 'use_derived' and
+            declaration['name'] not in DONT_FLUSH_DEFERRED)
+
+def emit_deferred_body(declaration):
+    ret_and_arg_types = ', '.join([declaration['return_type']] + [a['type'] for a in declaration['arguments']])
+    deferred_dispatch_args = ['*op', 'c10::DispatchKey::Deferred'] + declaration['args']
+
+    call = DEFERRED_DISPATCH_UNBOXED.substitute(
+        declaration,
+        ret_and_arg_types=ret_and_arg_types,
+        deferred_dispatch_args=deferred_dispatch_args,
+    )
+
+    return [call]
+
 def emit_body(declaration):
     strategy = dispatch_strategy(declaration)
 
@@ -1044,6 +1105,11 @@ def emit_body(declaration):
             return []
         return ['check_inplace({});'.format(arg['name']) for arg in differentiable_outputs]
 
+    def emit_check_writeable():
+        if not modifies_arguments or strategy != 'use_derived' or name in DONT_CHECK_WRITEABLE:
+            return []
+        return ['check_writeable({});'.format(ret['name']) for ret in returns if ret['type'] == 'Tensor &']
+
     def emit_increment_version():
         if not modifies_arguments:
             return []
@@ -1055,6 +1121,7 @@ def emit_body(declaration):
     body = []
     if strategy != 'use_type':
         body.extend(unpack_args(env, declaration))
+    body.extend(emit_check_writeable())
     if requires_derivative:
         body.extend(emit_check_inplace())
         body.extend(setup_derivative(differentiable_inputs))
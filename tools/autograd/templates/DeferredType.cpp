@@ -0,0 +1,33 @@
+#include "torch/csrc/autograd/VariableTypeUtils.h"
+
+#include <ATen/DeferredMode.h>
+#include <ATen/TypeDefault.h>
+#include <torch/library.h>
+
+// ${generated_comment}
+
+// NOTE See [Sharded File] comment in VariableType
+
+// Kernels that evaluate the ops deferred by at::deferred before running an op
+// that may read their outputs.
+
+using namespace at;
+
+namespace torch {
+
+namespace DeferredType {
+
+namespace {
+${deferred_method_definitions}
+}  // namespace
+}  // namespace DeferredType
+
+namespace {
+
+TORCH_LIBRARY_IMPL(aten, Deferred, m) {
+  ${deferred_wrapper_registrations};
+}
+
+}  // namespace
+
+} // namespace torch
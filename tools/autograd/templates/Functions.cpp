@@ -20,6 +20,7 @@
 #include <algorithm>
 #include <numeric>
 #include <functional>
+#include <limits>
 
 // ${generated_comment}
 
@@ -477,6 +478,23 @@ Tensor logsumexp_backward(Tensor grad, const Tensor & self, Tensor result, IntAr
   return grad * (self - result).exp();
 }
 
+Tensor logcumsumexp_backward(const Tensor& grad, const Tensor& self, const Tensor& result, int64_t dim) {
+  if (grad.dim() == 0 || grad.numel() == 0) {
+    return grad;
+  }
+  // grad_self[j] = sum_{i >= j} grad[i] * exp(self[j] - result[i]). The sum is
+  // a reversed logcumsumexp of log(grad) - result, done separately for the
+  // positive and the negative grads so that nothing overflows.
+  auto reverse_logcumsumexp = [dim](const Tensor& x) {
+    return at::logcumsumexp(x.flip({dim}), dim).flip({dim});
+  };
+  auto grad_min = at::scalar_tensor(std::numeric_limits<double>::lowest(), grad.options());
+  auto log_grad_positive = at::where(grad > 0, grad.log(), grad_min);
+  auto log_grad_negative = at::where(grad < 0, (-grad).log(), grad_min);
+  return (reverse_logcumsumexp(log_grad_positive - result) + self).exp() -
+      (reverse_logcumsumexp(log_grad_negative - result) + self).exp();
+}
+
 Tensor unbind_backward(const variable_list& grads, int64_t dim) {
   IntArrayRef sizes;
   at::TensorOptions o;
@@ -772,6 +790,45 @@ Tensor masked_scatter_backward(const Tensor & grad, const Tensor & mask, IntArra
   return mask_selected.view(sizes);
 }
 
+Tensor scatter_reduce_backward(const Tensor & grad, const Tensor & self, int64_t dim, const Tensor & index, const std::string & reduce, const Tensor & result, const Tensor & arg) {
+  dim = at::maybe_wrap_dim(dim, self.dim());
+  if (reduce == "max" || reduce == "min") {
+    // the gradient goes to the position of the value taken; elements that
+    // nothing was scattered to have the position self.size(dim), which is
+    // dropped
+    auto sizes = self.sizes().vec();
+    sizes[dim] += 1;
+    return at::zeros(sizes, grad.options()).scatter_(dim, arg, grad).narrow(dim, 0, self.size(dim));
+  }
+  auto full_index = index;
+  if (index.dim() == 1 && self.dim() > 1) {
+    std::vector<int64_t> sizes(self.dim(), 1);
+    sizes[dim] = index.size(0);
+    full_index = index.view(sizes).expand(self.sizes());
+  }
+  if (reduce == "sum") {
+    return grad.gather(dim, full_index);
+  }
+  if (reduce == "mean") {
+    auto count = at::zeros(grad.sizes(), grad.options()).scatter_add_(dim, full_index, at::ones_like(self, grad.options()));
+    return grad.div(count.clamp_min(1)).gather(dim, full_index);
+  }
+  TORCH_INTERNAL_ASSERT(reduce == "prod");
+  // the gradient of a value is the product of the other values scattered to
+  // the same element, computed without dividing by zero
+  auto zero_mask = self == 0;
+  auto self_nonzero = self.masked_fill(zero_mask, 1);
+  auto num_zeros = at::zeros(grad.sizes(), grad.options().dtype(at::kLong))
+      .scatter_add_(dim, full_index, zero_mask.to(at::kLong))
+      .gather(dim, full_index);
+  auto prod_nonzero = at::scatter_reduce(self_nonzero, dim, index, "prod", grad.size(dim)).gather(dim, full_index);
+  auto prod_others = at::where(
+      zero_mask,
+      prod_nonzero.masked_fill(num_zeros != 1, 0),
+      result.gather(dim, full_index) / self_nonzero);
+  return grad.gather(dim, full_index) * prod_others;
+}
+
 Tensor cholesky_backward(Tensor grad, bool upper, Tensor L) {
   // cf. Iain Murray (2016); arXiv 1602.07527
   // This gradient is symmetric, and not triangular.
@@ -997,6 +1054,39 @@ Tensor binary_cross_entropy_double_backward_grad_output(const Tensor & grad, con
   return ggO;
 }
 
+Tensor cross_entropy_loss_double_backward(const Tensor & grad, const Tensor & grad_output, const Tensor & self, const Tensor & target, const Tensor & weight, int64_t reduction, int64_t ignore_index, double label_smoothing, const Tensor & logsumexp, const Tensor & total_weight) {
+  // The gradient of a row is scale * softmax + a constant, where scale is
+  // grad_output * ((1 - eps) * w[target] + eps / C * sum(w)) for rows that are
+  // not ignored.
+  auto valid = (target != ignore_index).to(logsumexp.scalar_type());
+  auto target_weight = weight.defined()
+      ? weight.index_select(0, target.masked_fill(target == ignore_index, 0)).to(logsumexp.scalar_type())
+      : at::ones_like(valid);
+  auto weight_sum = weight.defined() ? weight.to(logsumexp.scalar_type()).sum() : at::full({}, self.size(1), valid.options());
+  auto scale = (target_weight * (1 - label_smoothing) + weight_sum * (label_smoothing / self.size(1))) * valid;
+  if (reduction == at::Reduction::Mean) {
+    scale = scale * (grad_output / total_weight);
+  } else {
+    scale = scale * grad_output;
+  }
+  auto probs = (self.to(logsumexp.scalar_type()) - logsumexp.unsqueeze(1)).exp();
+  auto grad_ = grad.to(logsumexp.scalar_type());
+  auto gI = scale.unsqueeze(1) * probs * (grad_ - (grad_ * probs).sum(1, true));
+  return gI.to(self.scalar_type());
+}
+
+Tensor cross_entropy_loss_double_backward_grad_output(const Tensor & grad, const Tensor & self, const Tensor & target, const Tensor & weight, int64_t reduction, int64_t ignore_index, double label_smoothing, const Tensor & logsumexp, const Tensor & total_weight) {
+  // The gradient of the input is linear in grad_output
+  auto unit_output = reduction == at::Reduction::None
+      ? at::ones({self.size(0)}, self.options())
+      : at::ones({}, self.options());
+  auto ggO = grad * _cross_entropy_loss_backward(unit_output, self, target, weight, reduction, ignore_index, label_smoothing, logsumexp, total_weight);
+  if (reduction == at::Reduction::None) {
+    return ggO.sum(1);
+  }
+  return ggO.sum();
+}
+
 Tensor l1_loss_double_backward_grad_output(const Tensor & grad, const Tensor & input, const Tensor & target, int64_t reduction) {
   auto output = l1_loss_backward(grad, input, target, at::Reduction::None);
   if (reduction == at::Reduction::Mean) {
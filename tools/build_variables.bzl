@@ -15,6 +15,11 @@ GENERATED_CPP = [
     "autograd/generated/ProfiledType_2.cpp",
     "autograd/generated/ProfiledType_3.cpp",
     "autograd/generated/ProfiledType_4.cpp",
+    "autograd/generated/DeferredType_0.cpp",
+    "autograd/generated/DeferredType_1.cpp",
+    "autograd/generated/DeferredType_2.cpp",
+    "autograd/generated/DeferredType_3.cpp",
+    "autograd/generated/DeferredType_4.cpp",
     "autograd/generated/python_functions.cpp",
     "autograd/generated/python_nn_functions.cpp",
     "autograd/generated/python_torch_functions.cpp",
@@ -36,6 +41,11 @@ libtorch_generated_sources = [
     ":generate-code=autograd/generated/ProfiledType_2.cpp",
     ":generate-code=autograd/generated/ProfiledType_3.cpp",
     ":generate-code=autograd/generated/ProfiledType_4.cpp",
+    ":generate-code=autograd/generated/DeferredType_0.cpp",
+    ":generate-code=autograd/generated/DeferredType_1.cpp",
+    ":generate-code=autograd/generated/DeferredType_2.cpp",
+    ":generate-code=autograd/generated/DeferredType_3.cpp",
+    ":generate-code=autograd/generated/DeferredType_4.cpp",
     "torch/csrc/autograd/VariableTypeManual.cpp",
 ]
 
@@ -53,11 +63,15 @@ libtorch_core_sources = [
     "torch/csrc/autograd/functions/tensor.cpp",
     "torch/csrc/autograd/functions/utils.cpp",
     "torch/csrc/autograd/input_buffer.cpp",
+    "torch/csrc/autograd/perf_counters.cpp",
     "torch/csrc/autograd/profiler.cpp",
     "torch/csrc/autograd/record_function.cpp",
     "torch/csrc/autograd/record_function_ops.cpp",
+    "torch/csrc/autograd/sampling_profiler.cpp",
     "torch/csrc/autograd/saved_variable.cpp",
+    "torch/csrc/autograd/saved_variable_hooks.cpp",
     "torch/csrc/autograd/variable.cpp",
+    "torch/csrc/jit/api/dynamic_batcher.cpp",
     "torch/csrc/jit/api/function_impl.cpp",
     "torch/csrc/jit/api/module.cpp",
     "torch/csrc/jit/api/object.cpp",
@@ -107,7 +121,11 @@ libtorch_core_sources = [
     "torch/csrc/jit/passes/decompose_ops.cpp",
     "torch/csrc/jit/passes/erase_number_types.cpp",
     "torch/csrc/jit/passes/fixup_trace_scope_blocks.cpp",
+    "torch/csrc/jit/passes/fork_independent_subgraphs.cpp",
     "torch/csrc/jit/passes/freeze_module.cpp",
+    "torch/csrc/jit/passes/frozen_graph_optimizations.cpp",
+    "torch/csrc/jit/passes/frozen_ops_to_mkldnn.cpp",
+    "torch/csrc/jit/passes/fuse_epilogue.cpp",
     "torch/csrc/jit/passes/fuse_linear.cpp",
     "torch/csrc/jit/passes/graph_fuser.cpp",
     "torch/csrc/jit/passes/graph_rewrite_helper.cpp",
@@ -117,11 +135,14 @@ libtorch_core_sources = [
     "torch/csrc/jit/passes/inliner.cpp",
     "torch/csrc/jit/passes/inplace_check.cpp",
     "torch/csrc/jit/passes/insert_guards.cpp",
+    "torch/csrc/jit/passes/insert_inplace_ops.cpp",
     "torch/csrc/jit/passes/lift_closures.cpp",
     "torch/csrc/jit/passes/liveness.cpp",
     "torch/csrc/jit/passes/loop_unrolling.cpp",
     "torch/csrc/jit/passes/lower_grad_of.cpp",
     "torch/csrc/jit/passes/lower_tuples.cpp",
+    "torch/csrc/jit/passes/memory_planning.cpp",
+    "torch/csrc/jit/passes/packed_linear.cpp",
     "torch/csrc/jit/passes/pass_manager.cpp",
     "torch/csrc/jit/passes/peephole.cpp",
     "torch/csrc/jit/passes/create_functional_graphs.cpp",
@@ -145,10 +166,12 @@ libtorch_core_sources = [
     "torch/csrc/jit/runtime/jit_exception.cpp",
     "torch/csrc/jit/runtime/logging.cpp",
     "torch/csrc/jit/runtime/operator.cpp",
+    "torch/csrc/jit/runtime/planned_memory.cpp",
     "torch/csrc/jit/runtime/print_handler.cpp",
     "torch/csrc/jit/runtime/profiling_graph_executor_impl.cpp",
     "torch/csrc/jit/runtime/profiling_record.cpp",
     "torch/csrc/jit/runtime/register_ops_utils.cpp",
+    "torch/csrc/jit/runtime/static_runtime.cpp",
     "torch/csrc/jit/runtime/symbolic_script.cpp",
     "torch/csrc/jit/runtime/vararg_functions.cpp",
     "torch/csrc/jit/serialization/import.cpp",
@@ -199,6 +222,8 @@ libtorch_distributed_sources = [
     "torch/csrc/distributed/autograd/rpc_messages/cleanup_autograd_context_resp.cpp",
     "torch/csrc/distributed/autograd/rpc_messages/rpc_with_autograd.cpp",
     "torch/csrc/distributed/rpc/message.cpp",
+    "torch/csrc/distributed/rpc/metrics/RpcLatencyMetrics.cpp",
+    "torch/csrc/distributed/rpc/metrics/RpcMetricsHandler.cpp",
     "torch/csrc/distributed/rpc/python_call.cpp",
     "torch/csrc/distributed/rpc/python_remote_call.cpp",
     "torch/csrc/distributed/rpc/python_resp.cpp",
@@ -240,6 +265,7 @@ libtorch_extra_sources = libtorch_core_jit_sources + [
     "torch/csrc/jit/mobile/import.cpp",
     "torch/csrc/jit/mobile/interpreter.cpp",
     "torch/csrc/jit/mobile/module.cpp",
+    "torch/csrc/jit/mobile/observer.cpp",
     "torch/csrc/jit/mobile/register_mobile_autograd.cpp",
     "torch/csrc/jit/serialization/export.cpp",
     "torch/csrc/jit/serialization/export_module.cpp",
@@ -341,6 +367,7 @@ torch_cpp_srcs = [
 
 libtorch_python_cuda_sources = [
     "torch/csrc/cuda/Event.cpp",
+    "torch/csrc/cuda/Graph.cpp",
     "torch/csrc/cuda/Module.cpp",
     "torch/csrc/cuda/Storage.cpp",
     "torch/csrc/cuda/Stream.cpp",
@@ -432,8 +459,10 @@ libtorch_python_core_sources = [
 libtorch_python_distributed_sources = [
     "torch/csrc/distributed/autograd/init.cpp",
     "torch/csrc/distributed/c10d/comm.cpp",
+    "torch/csrc/distributed/c10d/comm_hooks.cpp",
     "torch/csrc/distributed/c10d/init.cpp",
     "torch/csrc/distributed/c10d/reducer.cpp",
+    "torch/csrc/distributed/c10d/sharded_parameters.cpp",
     "torch/csrc/distributed/rpc/init.cpp",
     "torch/csrc/distributed/rpc/process_group_agent.cpp",
     "torch/csrc/distributed/rpc/py_rref.cpp",
@@ -32,7 +32,8 @@ __all__ = [
     'ShortStorage', 'CharStorage', 'ByteStorage', 'BoolStorage',
     'DoubleTensor', 'FloatTensor', 'LongTensor', 'IntTensor',
     'ShortTensor', 'CharTensor', 'ByteTensor', 'BoolTensor', 'Tensor',
-    'lobpcg',
+    'lobpcg', 'set_deterministic', 'is_deterministic',
+    'set_copy_on_write', 'is_copy_on_write',
 ]
 
 ################################################################################
@@ -231,6 +232,69 @@ def set_default_dtype(d):
     """
     _C._set_default_dtype(d)
 
+
+def set_deterministic(d):
+    r"""Sets whether operations that have both a nondeterministic and a
+    deterministic implementation use the deterministic one.
+
+    Some CPU kernels, e.g. :meth:`~Tensor.index_put_` with
+    ``accumulate=True`` and :meth:`~Tensor.index_add_`, accumulate into the
+    same elements from several threads with atomic adds, so the order of the
+    additions, and with it the rounding of floating point results, can differ
+    between runs. With ``torch.set_deterministic(True)`` they partition the
+    work by destination instead, which gives the same results as a serial
+    run, at the cost of some extra memory and time. Likewise the backward of
+    :func:`torch.nn.functional.embedding` on CUDA sorts the indices with a
+    stable sort instead of accumulating the gradients with atomic adds.
+
+    This does not affect cuDNN, see :attr:`torch.backends.cudnn.deterministic`.
+
+    Args:
+        d (:class:`bool`): If True, use deterministic implementations.
+    """
+    _C._set_deterministic(d)
+
+
+def is_deterministic():
+    r"""Returns True if deterministic implementations are used, see
+    :func:`torch.set_deterministic`.
+    """
+    return _C._get_deterministic()
+
+
+def set_copy_on_write(d):
+    r"""Sets whether copies of CPU tensors share the data of their source
+    until one of them is written to.
+
+    With ``torch.set_copy_on_write(True)``, :meth:`~Tensor.clone` and the
+    :meth:`~Tensor.to` calls with ``copy=True`` that don't convert the tensor
+    don't copy the data of a dense CPU tensor that spans all of its storage.
+    The copy and the source share the data until one of them is written to,
+    e.g. by an in-place operation; that one then copies the data first.
+    Reading the data with elementwise ops and reductions doesn't trigger
+    the copy; other ops, like matrix multiplications, trigger it whether
+    they write the data or not.
+
+    This is opt-in because the data is only copied on writes that go through
+    the tensors: pointers to the data of the source taken before the copy,
+    e.g. by :meth:`~Tensor.numpy` or :meth:`~Tensor.data_ptr`, keep writing
+    to the shared data.
+
+    Args:
+        d (:class:`bool`): If True, share the data of copies until they are
+            written to.
+    """
+    _C._set_copy_on_write(d)
+
+
+def is_copy_on_write():
+    r"""Returns True if copies of CPU tensors share the data of their
+    source until one of them is written to, see
+    :func:`torch.set_copy_on_write`.
+    """
+    return _C._get_copy_on_write()
+
+
 # If you edit these imports, please update torch/__init__.py.in as well
 from .random import set_rng_state, get_rng_state, manual_seed, initial_seed, seed
 from .serialization import save, load
@@ -363,6 +427,7 @@ del ComplexFloatStorageBase
 ################################################################################
 
 import torch.cuda
+import torch.cpu
 import torch.autograd
 from torch.autograd import no_grad, enable_grad, set_grad_enabled
 import torch.nn
@@ -378,6 +443,7 @@ import torch.hub
 import torch.random
 import torch.distributions
 import torch.testing
+import torch.backends.cpu
 import torch.backends.cuda
 import torch.backends.mkl
 import torch.backends.mkldnn
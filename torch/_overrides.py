@@ -61,6 +61,10 @@ def get_ignored_functions():
         torch.parse_type_comment,
         torch.set_anomaly_enabled,
         torch.set_flush_denormal,
+        torch.set_deterministic,
+        torch.is_deterministic,
+        torch.set_copy_on_write,
+        torch.is_copy_on_write,
         torch.set_num_interop_threads,
         torch.set_num_threads,
         torch.wait,
@@ -111,6 +115,7 @@ def get_ignored_functions():
         torch.mkldnn_convolution,
         torch.mkldnn_convolution_backward_weights,
         torch.mkldnn_max_pool2d,
+        torch.nested_tensor,
         torch.ones,
         torch.promote_types,
         torch.rand,
@@ -119,6 +124,7 @@ def get_ignored_functions():
         torch.randperm,
         torch.range,
         torch.sparse_coo_tensor,
+        torch.sparse_csr_tensor,
         torch.vander,
         torch.zeros,
         torch.nn.functional.assert_int_or_pair,
@@ -134,6 +140,8 @@ def get_ignored_functions():
         torch.nn.functional.tanh,
         torch.set_autocast_enabled,
         torch.is_autocast_enabled,
+        torch.set_autocast_cpu_enabled,
+        torch.is_autocast_cpu_enabled,
         torch.clear_autocast_cache,
         torch.autocast_increment_nesting,
         torch.autocast_decrement_nesting,
@@ -353,6 +361,7 @@ def get_testing_overrides():
         torch.logical_not: lambda input, out=None: -1,
         torch.logical_or: lambda input, other, out=None: -1,
         torch.logical_xor: lambda input, other, out=None: -1,
+        torch.logcumsumexp: lambda input, dim, out=None: -1,
         torch.logsumexp: lambda input, names, keepdim, out=None: -1,
         torch.lstm: lambda data, batch_sizes, hx, params, has_biases, num_layers, dropout, train, bidirectional: -1,
         torch.lstm_cell: lambda input, hx, w_ih, w_hh, b_ih=None, b_hh=None: -1,
@@ -396,6 +405,8 @@ def get_testing_overrides():
         torch.native_batch_norm: lambda input, weight, bias, running_mean, running_var, training, momentum, eps: -1,
         torch.native_layer_norm: lambda input, weight, bias, M, N, eps: -1,
         torch.native_norm: lambda input, p=2: -1,
+        torch.nested_attention: lambda query, key, value: -1,
+        torch.nested_from_padded: lambda padded, lengths: -1,
         torch.ne: lambda input, other, out=None: -1,
         torch.neg: lambda input, out=None: -1,
         torch.nn.functional.adaptive_avg_pool2d: lambda input, output_size: -1,
@@ -423,7 +434,7 @@ def get_testing_overrides():
         torch.nn.functional.cosine_embedding_loss: (lambda input1, input2, target, margin=0, size_average=None,
                                                     reduce=None, reduction='mean': -1),
         torch.nn.functional.cross_entropy: (lambda input, target, weight=None, size_average=None, ignore_index=-100,
-                                            reduce=None, reduction="mean": -1),
+                                            reduce=None, reduction="mean", label_smoothing=0.0: -1),
         torch.nn.functional.ctc_loss: (lambda log_probs, targets, input_lengths, target_lengths, blank=0,
                                        reduction='mean', zero_infinity=False: -1),
         torch.nn.functional.dropout: lambda input, p=0.5, training=True, inplace=False: -1,
@@ -592,7 +603,9 @@ def get_testing_overrides():
         torch.scalar_tensor: lambda s, dtype=None, layour=None, device=None, pin_memory=None: -1,
         torch.scatter: lambda input, dim, index, src: -1,
         torch.scatter_add: lambda input, dim, index, src: -1,
+        torch.scatter_reduce: lambda input, dim, index, reduce, output_size=None: -1,
         torch.searchsorted: lambda sorted_sequence, input, out_int32=False, right=False, out=None: -1,
+        torch.segment_reduce: lambda data, reduce, lengths, axis=0: -1,
         torch.select: lambda input, dim, index: -1,
         torch.selu: lambda input, inplace=False: -1,
         torch.sigmoid: lambda input, out=None: -1,
@@ -1308,6 +1308,37 @@ See also :meth:`Tensor.values`.
   :meth:`Tensor.coalesce` for details.
 """)
 
+add_docstr_all('crow_indices',
+               r"""
+crow_indices() -> Tensor
+
+If :attr:`self` is a sparse CSR tensor (i.e., with ``torch.sparse_csr`` layout),
+this returns a view of the compressed row indices tensor, of size
+``self.size(0) + 1``. Otherwise, this throws an error.
+
+See also :meth:`Tensor.col_indices` and :meth:`Tensor.values`.
+""")
+
+add_docstr_all('col_indices',
+               r"""
+col_indices() -> Tensor
+
+If :attr:`self` is a sparse CSR tensor (i.e., with ``torch.sparse_csr`` layout),
+this returns a view of the column indices tensor. Otherwise, this throws an
+error.
+
+See also :meth:`Tensor.crow_indices` and :meth:`Tensor.values`.
+""")
+
+add_docstr_all('nested_offsets',
+               r"""
+nested_offsets() -> Tensor
+
+If :attr:`self` is a nested tensor (i.e., with ``torch.nested`` layout), this
+returns a view of the offsets of its entries in :meth:`Tensor.values`, a
+LongTensor of size ``self.size(0) + 1``. Otherwise, this throws an error.
+""")
+
 add_docstr_all('get_device',
                r"""
 get_device() -> Device ordinal (Integer)
@@ -1327,14 +1358,16 @@ add_docstr_all('values',
                r"""
 values() -> Tensor
 
-If :attr:`self` is a sparse COO tensor (i.e., with ``torch.sparse_coo`` layout),
-this returns a view of the contained values tensor. Otherwise, this throws an
+If :attr:`self` is a sparse COO or CSR tensor (i.e., with ``torch.sparse_coo``
+or ``torch.sparse_csr`` layout), this returns a view of the contained values
+tensor. If :attr:`self` is a nested tensor (i.e., with ``torch.nested``
+layout), this returns a view of the packed entries. Otherwise, this throws an
 error.
 
 See also :meth:`Tensor.indices`.
 
 .. note::
-  This method can only be called on a coalesced sparse tensor. See
+  For sparse COO tensors, this method can only be called on a coalesced tensor. See
   :meth:`Tensor.coalesce` for details.
 """)
 
@@ -1727,6 +1760,13 @@ returned distribution:
     f(x) = \dfrac{1}{x \sigma \sqrt{2\pi}}\ e^{-\frac{(\ln x - \mu)^2}{2\sigma^2}}
 """)
 
+add_docstr_all('logcumsumexp',
+               r"""
+logcumsumexp(dim) -> Tensor
+
+See :func:`torch.logcumsumexp`
+""")
+
 add_docstr_all('logsumexp',
                r"""
 logsumexp(dim, keepdim=False) -> Tensor
@@ -3110,6 +3150,31 @@ Example::
            size=(3, 3), nnz=1, layout=torch.sparse_coo)
 """)
 
+add_docstr_all('to_sparse_csr',
+               r"""
+to_sparse_csr() -> Tensor
+Returns a copy of a 2-D dense or sparse COO tensor in compressed sparse row
+format. See :func:`torch.sparse_csr_tensor`.
+
+Example::
+
+    >>> d = torch.tensor([[0, 0, 0], [9, 0, 10], [0, 0, 0]])
+    >>> d.to_sparse_csr()
+    tensor(crow_indices=tensor([0, 0, 2, 2]),
+           col_indices=tensor([0, 2]),
+           values=tensor([ 9, 10]), size=(3, 3), nnz=2,
+           layout=torch.sparse_csr)
+""")
+
+add_docstr_all('to_padded',
+               r"""
+to_padded(padding=0) -> Tensor
+
+Returns the padded form of a nested tensor, a dense tensor of size
+``self.size()`` where the rows after the end of every entry are filled with
+:attr:`padding`. See :func:`torch.nested_tensor`.
+""")
+
 add_docstr_all('to_mkldnn',
                r"""
 to_mkldnn() -> Tensor
@@ -3590,6 +3655,13 @@ scatter_add(dim, index, src) -> Tensor
 Out-of-place version of :meth:`torch.Tensor.scatter_add_`
 """)
 
+add_docstr_all('scatter_reduce',
+               r"""
+scatter_reduce(dim, index, reduce, *, output_size=None) -> Tensor
+
+See :func:`torch.scatter_reduce`
+""")
+
 add_docstr_all('masked_scatter',
                r"""
 masked_scatter(mask, tensor) -> Tensor
@@ -2212,7 +2212,8 @@ Creates a :class:`Tensor` from a :class:`numpy.ndarray`.
 
 The returned tensor and :attr:`ndarray` share the same memory. Modifications to
 the tensor will be reflected in the :attr:`ndarray` and vice versa. The returned
-tensor is not resizable.
+tensor is not resizable. If the :attr:`ndarray` is not writeable, the returned
+tensor is read-only: in-place and ``out=`` operations on it raise an error.
 
 It currently accepts :attr:`ndarray` with dtypes of ``numpy.float64``,
 ``numpy.float32``, ``numpy.float16``, ``numpy.complex64``, ``numpy.complex128``,
@@ -3092,6 +3093,31 @@ Example::
     tensor([4.0])
 """.format(**factory_common_args))
 
+add_docstr(torch.logcumsumexp,
+           r"""
+logcumsumexp(input, dim, out=None) -> Tensor
+Returns the logarithm of the cumulative summation of the exponentiation of
+elements of :attr:`input` in the dimension :attr:`dim`. The computation is
+numerically stabilized.
+
+For summation index :math:`j` given by `dim` and other indices :math:`i`, the result is
+
+    .. math::
+        \text{{logcumsumexp}}(x)_{{ij}} = \log \sum\limits_{{j=0}}^{{i}} \exp(x_{{ij}})
+
+Args:
+    {input}
+    dim  (int): the dimension to do the operation over
+    {out}
+
+Example::
+
+    >>> a = torch.randn(10)
+    >>> torch.logcumsumexp(a, dim=0)
+    tensor([-0.4271, -0.0959,  0.4909,  0.6406,  0.7074,  0.8153,  1.0802,  1.2728,
+             1.5505,  1.6335])
+""".format(**reduceops_common_args))
+
 add_docstr(torch.logsumexp,
            r"""
 logsumexp(input, dim, keepdim=False, out=None)
@@ -5056,6 +5082,78 @@ Example::
     tensor([    nan,  1.8351,  0.8053,     nan])
 """.format(**common_args))
 
+add_docstr(torch.scatter_reduce,
+           r"""
+scatter_reduce(input, dim, index, reduce, *, output_size=None) -> Tensor
+
+Reduces all the values of :attr:`input` that are scattered to the same index
+along :attr:`dim`, with the reduction :attr:`reduce`: ``"sum"``, ``"prod"``,
+``"mean"``, ``"max"`` or ``"min"``.
+
+For a 3-D tensor with :obj:`reduce="sum"` the output is given by::
+
+    out[index[i][j][k]][j][k] += input[i][j][k]  # if dim == 0
+    out[i][index[i][j][k]][k] += input[i][j][k]  # if dim == 1
+    out[i][j][index[i][j][k]] += input[i][j][k]  # if dim == 2
+
+:attr:`index` has either the size of :attr:`input`, or is 1-dimensional with
+``input.size(dim)`` elements and applies to all the slices of :attr:`input`
+along :attr:`dim`, as in a graph aggregation of the features of the edges into
+their target nodes. The output has the size of :attr:`input` except at
+:attr:`dim`, where it has the size :attr:`output_size`, by default one more
+than the largest index. The elements of the output that no value is scattered
+to are 0 for all reductions except ``"prod"``, for which they are 1.
+
+The gradient of ``"max"`` and ``"min"`` only goes to the first of the values
+that are equal to the maximum or minimum.
+
+Args:
+    input (Tensor): the source tensor
+    dim (int): the axis along which to index
+    index (LongTensor): the indices of the output elements to scatter to
+    reduce (str): the reduction to apply
+    output_size (int, optional): the size of the output at :attr:`dim`
+
+Example::
+
+    >>> src = torch.tensor([[1., 2.], [3., 4.], [5., 6.]])
+    >>> torch.scatter_reduce(src, 0, torch.tensor([0, 1, 0]), "max")
+    tensor([[5., 6.],
+            [3., 4.]])
+    >>> torch.scatter_reduce(src, 0, torch.tensor([0, 1, 0]), "mean", output_size=3)
+    tensor([[3., 4.],
+            [3., 4.],
+            [0., 0.]])
+""")
+
+add_docstr(torch.segment_reduce,
+           r"""
+segment_reduce(data, reduce, *, lengths, axis=0) -> Tensor
+
+Reduces the consecutive segments of :attr:`data` along :attr:`axis` with the
+reduction :attr:`reduce`: ``"sum"``, ``"prod"``, ``"mean"``, ``"max"`` or
+``"min"``. Segment ``s`` has ``lengths[s]`` elements and the lengths sum to
+``data.size(axis)``.
+
+The result is the same as :func:`torch.scatter_reduce` with the sorted index
+``torch.repeat_interleave(lengths)``, without computing the index. The output
+has the size of :attr:`data` except at :attr:`axis`, where it has the size
+``lengths.numel()``. Empty segments are 0 for all reductions except
+``"prod"``, for which they are 1.
+
+Args:
+    data (Tensor): the source tensor
+    reduce (str): the reduction to apply
+    lengths (LongTensor): the lengths of the segments
+    axis (int, optional): the axis along which to reduce
+
+Example::
+
+    >>> data = torch.tensor([1., 5., 2., 3., 4.])
+    >>> torch.segment_reduce(data, "max", lengths=torch.tensor([2, 0, 3]))
+    tensor([5., 0., 4.])
+""")
+
 add_docstr(torch.set_flush_denormal,
            r"""
 set_flush_denormal(mode) -> bool
@@ -5347,6 +5445,128 @@ Example::
 .. _torch.sparse: https://pytorch.org/docs/stable/sparse.html
 """.format(**factory_common_args))
 
+add_docstr(torch.sparse_csr_tensor,
+           r"""
+sparse_csr_tensor(crow_indices, col_indices, values, size) -> Tensor
+
+Constructs a 2-D sparse tensor in compressed sparse row (CSR) format. The column
+indices and values of row ``i`` are ``col_indices[crow_indices[i]:crow_indices[i + 1]]``
+and ``values[crow_indices[i]:crow_indices[i + 1]]``. The column indices of a row must be
+strictly increasing, so unlike COO tensors, CSR tensors are always coalesced.
+
+The returned tensor has the dtype and device of :attr:`values`; only CPU tensors
+are supported. CSR tensors support :meth:`Tensor.to_dense`, :func:`torch.mm`,
+:func:`torch.addmm` and :func:`torch.mv` with a dense second operand. They are
+not differentiable.
+
+Args:
+    crow_indices (LongTensor): 1-D tensor of size ``size[0] + 1``, starting
+        with 0 and ending with the number of specified elements.
+    col_indices (LongTensor): 1-D tensor with the column of each value.
+    values (Tensor): 1-D tensor of the specified elements.
+    size (list, tuple, or :class:`torch.Size`): size of the matrix.
+
+Example::
+
+    >>> crow_indices = torch.tensor([0, 2, 2, 3])
+    >>> col_indices = torch.tensor([0, 2, 1])
+    >>> values = torch.tensor([1., 2., 3.])
+    >>> torch.sparse_csr_tensor(crow_indices, col_indices, values, [3, 3])
+    tensor(crow_indices=tensor([0, 2, 2, 3]),
+           col_indices=tensor([0, 2, 1]),
+           values=tensor([1., 2., 3.]), size=(3, 3), nnz=3,
+           layout=torch.sparse_csr)
+""")
+
+add_docstr(torch.nested_tensor,
+           r"""
+nested_tensor(tensors) -> Tensor
+
+Constructs a nested tensor (i.e., with ``torch.nested`` layout) from a list of
+tensors that only differ in the size of their first dim, e.g. the hidden states
+of sentences of different lengths. The entries are packed one after the other
+into a values tensor of size ``(sum of lengths, *inner sizes)`` without padding,
+and entry ``i`` is ``values()[offsets[i]:offsets[i + 1]]`` where ``offsets`` is
+:meth:`Tensor.nested_offsets`.
+
+The size of the nested tensor is that of its padded form,
+``(len(tensors), max length, *inner sizes)``. Elementwise ops
+(:func:`torch.add`, :func:`torch.mul`, :func:`torch.relu`, :func:`torch.tanh`,
+:func:`torch.sigmoid`, :func:`torch.nn.functional.gelu`),
+:func:`torch.nn.functional.linear`, :func:`torch.nn.functional.layer_norm`
+over the inner dims, :func:`torch.softmax` and :func:`torch.nested_attention`
+only compute on the entries and never on the padding. Dense operands of binary
+ops are broadcast over the inner dims. :meth:`Tensor.to_padded` and
+:meth:`Tensor.unbind` convert back to dense tensors.
+
+Only CPU tensors are supported, and nested tensors are not differentiable.
+
+Args:
+    tensors (sequence of Tensors): tensors of the same dtype and with the same
+        sizes except in dim 0.
+
+Example::
+
+    >>> n = torch.nested_tensor([torch.ones(2, 3), torch.zeros(1, 3)])
+    >>> n.size()
+    torch.Size([2, 2, 3])
+    >>> n.nested_offsets()
+    tensor([0, 2, 3])
+    >>> n.to_padded(-1)
+    tensor([[[ 1.,  1.,  1.],
+             [ 1.,  1.,  1.]],
+
+            [[ 0.,  0.,  0.],
+             [-1., -1., -1.]]])
+""")
+
+add_docstr(torch.nested_from_padded,
+           r"""
+nested_from_padded(padded, lengths) -> Tensor
+
+Constructs a nested tensor from the first ``lengths[i]`` rows of every
+``padded[i]``; this is the inverse of :meth:`Tensor.to_padded`. See
+:func:`torch.nested_tensor`.
+
+Args:
+    padded (Tensor): CPU tensor of size ``(B, L, *)``.
+    lengths (LongTensor): 1-D tensor of size ``B`` with values in ``[0, L]``.
+
+Example::
+
+    >>> padded = torch.arange(6.).view(2, 3)
+    >>> n = torch.nested_from_padded(padded, torch.tensor([1, 3]))
+    >>> n.values()
+    tensor([0., 3., 4., 5.])
+""")
+
+add_docstr(torch.nested_attention,
+           r"""
+nested_attention(query, key, value) -> Tensor
+
+Computes scaled dot product attention
+:math:`\text{softmax}(\frac{QK^T}{\sqrt{d}})V` within every entry of nested
+tensors, so that the rows of an entry only attend to the rows of the matching
+entry of :attr:`key`, and no work is spent on padding. The entries have size
+``(length, d)``, or ``(length, heads, d)`` for one attention per head. See
+:func:`torch.nested_tensor`.
+
+Args:
+    query (Tensor): nested tensor with entries of size ``(L_i, d)`` or ``(L_i, heads, d)``.
+    key (Tensor): nested tensor with as many entries, of size ``(S_i, d)`` or ``(S_i, heads, d)``.
+    value (Tensor): nested tensor with entries of size ``(S_i, d_v)`` or ``(S_i, heads, d_v)``.
+
+Returns:
+    A nested tensor with the entry lengths of :attr:`query`, and entries of size
+    ``(L_i, d_v)`` or ``(L_i, heads, d_v)``.
+
+Example::
+
+    >>> x = torch.nested_tensor([torch.randn(5, 2, 8), torch.randn(3, 2, 8)])
+    >>> torch.nested_attention(x, x, x).size()
+    torch.Size([2, 5, 2, 8])
+""")
+
 add_docstr(torch.sqrt,
            r"""
 sqrt(input, out=None) -> Tensor
@@ -111,6 +111,43 @@ class enable_grad(_DecoratorContextManager):
         return False
 
 
+class inference_mode(_DecoratorContextManager):
+    r"""Context-manager that disables all the autograd work, for code which
+    only runs inference.
+
+    Like :class:`~no_grad`, it disables gradient calculation. Additionally, the
+    autograd layer of every operation is skipped: version counters of tensors
+    modified in-place are not bumped and views are not tracked, so that no
+    autograd metadata is created or checked. Tensors created or modified in
+    this mode must not be used in computations recording gradients outside
+    of it. Operations are not recorded by the JIT tracer either.
+
+    This context manager is thread local; it will not affect computation
+    in other threads.
+
+    Also functions as a decorator. (Make sure to instantiate with parenthesis.)
+
+
+    Example::
+
+        >>> x = torch.ones(2, 3, requires_grad=True)
+        >>> with torch.autograd.inference_mode():
+        ...   y = x * 2
+        >>> y.requires_grad
+        False
+    """
+    def __enter__(self):
+        self.prev = torch.is_grad_enabled()
+        self.prev_inference = torch._C._is_inference_mode_enabled()
+        torch._C.set_grad_enabled(False)
+        torch._C._set_inference_mode_enabled(True)
+
+    def __exit__(self, *args):
+        torch._C._set_inference_mode_enabled(self.prev_inference)
+        torch.set_grad_enabled(self.prev)
+        return False
+
+
 class set_grad_enabled(object):
     r"""Context-manager that sets gradient calculation to on or off.
 
@@ -15,6 +15,11 @@ class enable_grad:
     def __exit__(self, *args: Any) -> bool: ...
     def __call__(self, func: T) -> T: ...
 
+class inference_mode:
+    def __enter__(self) -> None: ...
+    def __exit__(self, *args: Any) -> bool: ...
+    def __call__(self, func: T) -> T: ...
+
 class set_grad_enabled:
     def __init__(self, mode: bool) -> None: ...
     def __enter__(self) -> None: ...
@@ -24,9 +24,11 @@ class EventList(list):
     """A list of Events (for pretty printing)"""
     def __init__(self, *args, **kwargs):
         use_cuda = kwargs.pop('use_cuda', True)
+        profile_memory = kwargs.pop('profile_memory', False)
         super(EventList, self).__init__(*args, **kwargs)
         self._cpu_children_populated = False
         self._use_cuda = use_cuda
+        self._profile_memory = profile_memory
 
     def __str__(self):
         return self.table()
@@ -100,13 +102,16 @@ class EventList(list):
             sort_by (str, optional): Attribute used to sort entries. By default
                 they are printed in the same order as they were registered.
                 Valid keys include: ``cpu_time``, ``cuda_time``, ``cpu_time_total``,
-                ``cuda_time_total``, ``count``.
+                ``cuda_time_total``, ``cpu_memory_usage``, ``cuda_memory_usage``,
+                ``self_cpu_memory_usage``, ``self_cuda_memory_usage``,
+                ``cpu_memory_peak``, ``cuda_memory_peak``, ``count``.
 
         Returns:
             A string containing the table.
         """
         return build_table(
-            self, sort_by=sort_by, row_limit=row_limit, header=header, use_cuda=self._use_cuda)
+            self, sort_by=sort_by, row_limit=row_limit, header=header,
+            use_cuda=self._use_cuda, profile_memory=self._profile_memory)
 
     def export_chrome_trace(self, path):
         """Exports an EventList as a Chrome tracing tools file.
@@ -189,7 +194,8 @@ class EventList(list):
         for evt in self:
             stats[get_key(evt, group_by_input_shapes)].add(
                 evt, group_by_input_shapes)
-        return EventList(stats.values(), use_cuda=self._use_cuda)
+        return EventList(
+            stats.values(), use_cuda=self._use_cuda, profile_memory=self._profile_memory)
 
     def total_average(self):
         """Averages all events.
@@ -230,6 +236,30 @@ class profile(object):
             self cpu time might be artificially increased because of the shape
             collection.
 
+        profile_memory (bool, optional): Records every allocation and free of the
+            CPU and CUDA allocators and attributes it to the functions running on
+            the thread that made it. Every event then reports the net number of
+            bytes it (``cpu_memory_usage``, ``cuda_memory_usage``) and its body
+            alone (``self_cpu_memory_usage``, ``self_cuda_memory_usage``) left
+            allocated, and the peak it reached (``cpu_memory_peak``,
+            ``cuda_memory_peak``). Default: ``False``
+
+        perf_events (list of str, optional): Linux only. Hardware counters to read at the
+            start and end of every function, on the thread that runs it. Supported names
+            are ``cycles``, ``instructions``, ``cache_references``, ``cache_misses``
+            (last level cache), ``branches`` and ``branch_misses``. Every event then
+            reports the counts inside it in ``perf_counters``, and the table shows them
+            along with the instructions per cycle and the misses per thousand
+            instructions when the needed counters are recorded. Reading the counters
+            adds a few microseconds to each function. Default: ``None``
+
+    Attributes:
+        grad_accumulation (dict): How often the autograd engine, while profiling,
+            took over an incoming gradient without a copy (``'stolen'``), summed
+            two gradients into one of their buffers or into an existing ``.grad``
+            (``'inplace'``), and allocated a new buffer for a gradient
+            (``'copied'``). ``None`` until the profiler exits.
+
     .. warning:
         This context managers should not be called recursively, i.e. at most one
         instance should be enabled at any given time.
@@ -259,14 +289,18 @@ class profile(object):
         -----------------------------------  ---------------  ---------------  ---------------
 
     """
-    def __init__(self, enabled=True, use_cuda=False, record_shapes=False):
+    def __init__(self, enabled=True, use_cuda=False, record_shapes=False, profile_memory=False,
+                 perf_events=None):
         self.enabled = enabled
         self.use_cuda = use_cuda
         self.function_events = None
+        self.grad_accumulation = None
         if not self.enabled:
             return
         self.entered = False
         self.record_shapes = record_shapes
+        self.profile_memory = profile_memory
+        self.perf_events = list(perf_events) if perf_events else []
 
     def __enter__(self):
         if not self.enabled:
@@ -277,14 +311,18 @@ class profile(object):
         profiler_kind = torch.autograd.ProfilerState.CUDA if self.use_cuda \
             else torch.autograd.ProfilerState.CPU
         torch.autograd._enable_profiler(
-            torch.autograd.ProfilerConfig(profiler_kind, self.record_shapes))
+            torch.autograd.ProfilerConfig(
+                profiler_kind, self.record_shapes, self.profile_memory, self.perf_events))
         return self
 
     def __exit__(self, exc_type, exc_val, exc_tb):
         if not self.enabled:
             return
         records = torch.autograd._disable_profiler()
-        self.function_events = EventList(parse_cpu_trace(records), use_cuda=self.use_cuda)
+        self.function_events = EventList(
+            parse_cpu_trace(records, self.perf_events), use_cuda=self.use_cuda,
+            profile_memory=self.profile_memory)
+        self.grad_accumulation = count_grad_accumulation(records)
         return False
 
     def __repr__(self):
@@ -540,6 +578,28 @@ def format_time(time_us):
     return '{:.3f}us'.format(time_us)
 
 
+def format_memory(nbytes):
+    """Returns a formatted memory size string"""
+    KB = 1024
+    MB = 1024 * KB
+    GB = 1024 * MB
+    if abs(nbytes) >= GB:
+        return '{:.2f} Gb'.format(nbytes * 1.0 / GB)
+    elif abs(nbytes) >= MB:
+        return '{:.2f} Mb'.format(nbytes * 1.0 / MB)
+    elif abs(nbytes) >= KB:
+        return '{:.2f} Kb'.format(nbytes * 1.0 / KB)
+    else:
+        return str(nbytes) + ' b'
+
+
+def format_ratio(numerator, denominator):
+    """Formats a ratio of hardware counters"""
+    if numerator is None or not denominator:
+        return ''
+    return '{:.2f}'.format(numerator * 1.0 / denominator)
+
+
 def format_time_share(time_us, total_time_us):
     """Defines how to format time in FunctionEvent"""
     if total_time_us == 0:
@@ -584,10 +644,26 @@ class Interval(object):
 Kernel = namedtuple('Kernel', ['name', 'device', 'interval'])
 
 
+class MemoryUsage(object):
+    """Net number of bytes allocated inside a range and the peak it reached."""
+    def __init__(self):
+        self.cpu_usage = 0
+        self.cpu_peak = 0
+        self.cuda_usage = 0
+        self.cuda_peak = 0
+
+    def add(self, cpu_bytes, cuda_bytes):
+        self.cpu_usage += cpu_bytes
+        self.cpu_peak = max(self.cpu_peak, self.cpu_usage)
+        self.cuda_usage += cuda_bytes
+        self.cuda_peak = max(self.cuda_peak, self.cuda_usage)
+
+
 # TODO: record TID too
 class FunctionEvent(FormattedTimesMixin):
     """Profiling information about a single function."""
-    def __init__(self, id, name, thread, cpu_start, cpu_end, input_shapes=None):
+    def __init__(self, id, name, thread, cpu_start, cpu_end, input_shapes=None,
+                 memory_usage=None, perf_counters=None):
         self.id = id
         self.name = name
         self.cpu_interval = Interval(cpu_start, cpu_end)
@@ -596,6 +672,14 @@ class FunctionEvent(FormattedTimesMixin):
         self.count = 1
         self.cpu_children = []
         self.input_shapes = input_shapes
+        if memory_usage is None:
+            memory_usage = MemoryUsage()
+        self.cpu_memory_usage = memory_usage.cpu_usage
+        self.cpu_memory_peak = memory_usage.cpu_peak
+        self.cuda_memory_usage = memory_usage.cuda_usage
+        self.cuda_memory_peak = memory_usage.cuda_peak
+        # name -> count of the hardware counters recorded inside this event
+        self.perf_counters = perf_counters if perf_counters is not None else {}
 
     def append_kernel(self, name, device, start, end):
         self.kernels.append(Kernel(name, device, Interval(start, end)))
@@ -615,6 +699,18 @@ class FunctionEvent(FormattedTimesMixin):
             [child.cpu_time_total for child in self.cpu_children]
         )
 
+    @property
+    def self_cpu_memory_usage(self):
+        return self.cpu_memory_usage - sum(
+            [child.cpu_memory_usage for child in self.cpu_children]
+        )
+
+    @property
+    def self_cuda_memory_usage(self):
+        return self.cuda_memory_usage - sum(
+            [child.cuda_memory_usage for child in self.cpu_children]
+        )
+
     @property
     def cuda_time_total(self):
         return sum(kinfo.interval.elapsed_us() for kinfo in self.kernels)
@@ -652,6 +748,13 @@ class FunctionEventAvg(FormattedTimesMixin):
         self.cpu_time_total = 0
         self.cuda_time_total = 0
         self.self_cpu_time_total = 0
+        self.cpu_memory_usage = 0
+        self.cuda_memory_usage = 0
+        self.self_cpu_memory_usage = 0
+        self.self_cuda_memory_usage = 0
+        self.cpu_memory_peak = 0
+        self.cuda_memory_peak = 0
+        self.perf_counters = {}
         self.input_shapes = None
 
     def add(self, other, group_by_input_shapes=False):
@@ -669,6 +772,14 @@ class FunctionEventAvg(FormattedTimesMixin):
         self.cpu_time_total += other.cpu_time_total
         self.cuda_time_total += other.cuda_time_total
         self.self_cpu_time_total += other.self_cpu_time_total
+        self.cpu_memory_usage += other.cpu_memory_usage
+        self.cuda_memory_usage += other.cuda_memory_usage
+        self.self_cpu_memory_usage += other.self_cpu_memory_usage
+        self.self_cuda_memory_usage += other.self_cuda_memory_usage
+        self.cpu_memory_peak = max(self.cpu_memory_peak, other.cpu_memory_peak)
+        self.cuda_memory_peak = max(self.cuda_memory_peak, other.cuda_memory_peak)
+        for name, count in other.perf_counters.items():
+            self.perf_counters[name] = self.perf_counters.get(name, 0) + count
         self.count += other.count
         return self
 
@@ -700,7 +811,28 @@ class StringTable(defaultdict):
 ################################################################################
 # CPU checkpoints
 
-def parse_cpu_trace(thread_records):
+def perf_counter_deltas(perf_events, start, end):
+    start_counters = start.perf_counters()
+    end_counters = end.perf_counters()
+    # missing if the counters couldn't be read, or the range ended on
+    # another thread
+    if len(start_counters) != len(perf_events) or len(end_counters) != len(perf_events):
+        return {}
+    return {name: end_count - start_count for name, start_count, end_count
+            in zip(perf_events, start_counters, end_counters)}
+
+
+def count_grad_accumulation(thread_records):
+    # see torch::autograd::profiler::recordGradAccumulation
+    prefix = 'grad_accumulation::'
+    counts = {'stolen': 0, 'inplace': 0, 'copied': 0}
+    for record in itertools.chain(*thread_records):
+        if record.kind() == 'mark' and record.name().startswith(prefix):
+            counts[record.name()[len(prefix):]] += 1
+    return counts
+
+
+def parse_cpu_trace(thread_records, perf_events=()):
     next_id = 0
     start_record = None
     cuda_records = {}
@@ -731,17 +863,19 @@ def parse_cpu_trace(thread_records):
         if record.kind() == 'mark':
             continue
         elif record.kind() == 'push':
-            record_stack.append((next_id, record))
+            record_stack.append((next_id, record, MemoryUsage()))
             next_id += 1
         elif record.kind() == 'pop':
-            function_id, start = record_stack.pop()
+            function_id, start, memory_usage = record_stack.pop()
             fe = FunctionEvent(
                 id=function_id,
                 name=string_table[start.name()],
                 thread=start.thread_id(),
                 cpu_start=start_record.cpu_elapsed_us(start),
                 cpu_end=start_record.cpu_elapsed_us(record),
-                input_shapes=start.shapes())
+                input_shapes=start.shapes(),
+                memory_usage=memory_usage,
+                perf_counters=perf_counter_deltas(perf_events, start, record))
             if start.has_cuda():
                 cuda_start = adjusted_time(start)
                 cuda_end = adjusted_time(record)
@@ -750,6 +884,11 @@ def parse_cpu_trace(thread_records):
                                  cuda_start,
                                  cuda_end)
             functions.append(fe)
+        elif record.kind() == 'memory_alloc':
+            # memory events are recorded on the list of the allocating thread,
+            # every range open on it is charged for them
+            for _, _, memory_usage in record_stack:
+                memory_usage.add(record.cpu_memory_usage(), record.cuda_memory_usage())
 
     # Sort functions by start time then by end time ascending.
     # This ensures that--in the case of nested events which
@@ -842,7 +981,7 @@ def parse_nvprof_trace(path):
 # Pretty printer
 
 
-def build_table(events, sort_by=None, header=None, row_limit=100, use_cuda=True):
+def build_table(events, sort_by=None, header=None, row_limit=100, use_cuda=True, profile_memory=False):
     """Prints a summary of events (which can be a list of FunctionEvent or FunctionEventAvg)."""
     if len(events) == 0:
         return ""
@@ -850,10 +989,15 @@ def build_table(events, sort_by=None, header=None, row_limit=100, use_cuda=True)
     if sort_by is not None:
         events = EventList(sorted(
             events, key=lambda evt: getattr(evt, sort_by), reverse=True
-        ), use_cuda=use_cuda)
+        ), use_cuda=use_cuda, profile_memory=profile_memory)
 
     has_input_shapes = any(
         [event.input_shapes is not None for event in events])
+    perf_events = sorted(set(itertools.chain(*[event.perf_counters.keys() for event in events])))
+    has_ipc = 'cycles' in perf_events and 'instructions' in perf_events
+    miss_counters = [(name, header) for name, header in
+                     [('cache_misses', 'LLC MPKI'), ('branch_misses', 'Branch MPKI')]
+                     if name in perf_events and 'instructions' in perf_events]
     name_column_width = max([len(evt.key) for evt in events]) + 4
     DEFAULT_COLUMN_WIDTH = 15
     SHAPES_COLUMN_WIDTH = 35
@@ -872,6 +1016,22 @@ def build_table(events, sort_by=None, header=None, row_limit=100, use_cuda=True)
             'CUDA total',
             'CUDA time avg',
         ])
+    if profile_memory:
+        headers.extend([
+            'CPU Mem',
+            'Self CPU Mem',
+            'CPU Mem Peak',
+        ])
+        if use_cuda:
+            headers.extend([
+                'CUDA Mem',
+                'Self CUDA Mem',
+                'CUDA Mem Peak',
+            ])
+    headers.extend(perf_events)
+    if has_ipc:
+        headers.append('IPC')
+    headers.extend([header for _, header in miss_counters])
     headers.append(
         'Number of Calls'
     )
@@ -936,6 +1096,28 @@ def build_table(events, sort_by=None, header=None, row_limit=100, use_cuda=True)
                 evt.cuda_time_total_str,
                 evt.cuda_time_str,  # Cuda time avg
             ])
+        if profile_memory:
+            row_values.extend([
+                format_memory(evt.cpu_memory_usage),
+                format_memory(evt.self_cpu_memory_usage),
+                format_memory(evt.cpu_memory_peak),
+            ])
+            if use_cuda:
+                row_values.extend([
+                    format_memory(evt.cuda_memory_usage),
+                    format_memory(evt.self_cuda_memory_usage),
+                    format_memory(evt.cuda_memory_peak),
+                ])
+        for name in perf_events:
+            row_values.append(evt.perf_counters.get(name, ''))
+        if has_ipc:
+            row_values.append(format_ratio(
+                evt.perf_counters.get('instructions'), evt.perf_counters.get('cycles')))
+        for name, _ in miss_counters:
+            # misses per thousand instructions
+            misses = evt.perf_counters.get(name)
+            row_values.append(format_ratio(
+                None if misses is None else 1000 * misses, evt.perf_counters.get('instructions')))
         row_values.append(
             evt.count,  # Number of calls
         )
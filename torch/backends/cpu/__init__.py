@@ -0,0 +1,48 @@
+import sys
+import torch
+from contextlib import contextmanager
+from torch.backends import ContextProp, PropModule, __allow_nonbracketed_mutation
+
+def set_flags(_benchmark, _allow_float_accumulation=False):
+    orig_flags = (torch._C._get_cpu_conv_benchmark(),
+                  torch._C._get_cpu_allow_float_accumulation())
+    torch._C._set_cpu_conv_benchmark(_benchmark)
+    torch._C._set_cpu_allow_float_accumulation(_allow_float_accumulation)
+    return orig_flags
+
+@contextmanager
+def flags(benchmark=False, allow_float_accumulation=False):
+    with __allow_nonbracketed_mutation():
+        orig_flags = set_flags(benchmark, allow_float_accumulation)
+    try:
+        yield
+    finally:
+        with __allow_nonbracketed_mutation():
+            set_flags(*orig_flags)
+
+def save_benchmark_cache(path):
+    r"""Writes the CPU convolution backends chosen by the benchmark mode to
+    the file at ``path``, one line per convolution shape."""
+    torch._C._cpu_conv_benchmark_cache_save(path)
+
+def load_benchmark_cache(path):
+    r"""Adds the entries of a file written by :func:`save_benchmark_cache` to
+    the benchmark cache, so that those shapes are not timed again."""
+    torch._C._cpu_conv_benchmark_cache_load(path)
+
+def clear_benchmark_cache():
+    r"""Forgets all the CPU convolution backends chosen so far."""
+    torch._C._cpu_conv_benchmark_cache_clear()
+
+class CPUModule(PropModule):
+    def __init__(self, m, name):
+        super(CPUModule, self).__init__(m, name)
+
+    benchmark = ContextProp(torch._C._get_cpu_conv_benchmark, torch._C._set_cpu_conv_benchmark)
+    # Whether std and var of float tensors accumulate in float instead of double
+    allow_float_accumulation = ContextProp(torch._C._get_cpu_allow_float_accumulation,
+                                           torch._C._set_cpu_allow_float_accumulation)
+
+# Cool stuff from torch/backends/cudnn/__init__.py and
+# https://stackoverflow.com/questions/2447353/getattr-on-a-module/7668273#7668273
+sys.modules[__name__] = CPUModule(sys.modules[__name__], __name__)
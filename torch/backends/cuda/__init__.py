@@ -1,5 +1,7 @@
 import sys
 import torch
+from contextlib import contextmanager
+from torch.backends import ContextProp, __allow_nonbracketed_mutation
 
 
 def is_built():
@@ -83,6 +85,27 @@ class cuFFTPlanCacheManager(object):
             return super(cuFFTPlanCacheManager, self).__setattr__(name, value)
 
 
+def set_cublas_flags(_benchmark):
+    orig_flags = (torch._C._get_cublas_benchmark(),)
+    torch._C._set_cublas_benchmark(_benchmark)
+    return orig_flags
+
+
+@contextmanager
+def cublas_flags(benchmark=False):
+    r"""Context manager setting ``cublas_benchmark`` for its duration. In
+    benchmark mode, the first matrix multiplication of each shape made with
+    cuBLASLt times the algorithms suggested by its heuristic and keeps the
+    fastest one for the next calls."""
+    with __allow_nonbracketed_mutation():
+        orig_flags = set_cublas_flags(benchmark)
+    try:
+        yield
+    finally:
+        with __allow_nonbracketed_mutation():
+            set_cublas_flags(orig_flags[0])
+
+
 class CUDAModule(object):
     def __init__(self, m):
         self.__dict__ = m.__dict__
@@ -92,6 +115,7 @@ class CUDAModule(object):
         self.__old_mod = m
 
     cufft_plan_cache = cuFFTPlanCacheManager()
+    cublas_benchmark = ContextProp(torch._C._get_cublas_benchmark, torch._C._set_cublas_benchmark)
 
 # This is the sys.modules replacement trick, see
 # https://stackoverflow.com/questions/2447353/getattr-on-a-module/7668273#7668273
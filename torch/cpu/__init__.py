@@ -0,0 +1,6 @@
+r"""
+This package holds CPU-specific utilities; currently the CPU counterpart of
+:mod:`torch.cuda.amp`, see :mod:`torch.cpu.amp`.
+"""
+
+from . import amp  # noqa: F401
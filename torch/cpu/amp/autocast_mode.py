@@ -0,0 +1,67 @@
+import torch
+import functools
+
+
+class autocast(object):
+    r"""
+    Instances of :class:`autocast` serve as context managers or decorators that
+    allow regions of your script to run in mixed precision on the CPU.
+
+    In these regions, CPU ops run in an op-specific dtype chosen by autocast: matmuls,
+    linear layers and convolutions run in ``torch.bfloat16``, while reductions, softmax,
+    normalization layers and losses run in ``torch.float32``.
+    See the :ref:`CPU Autocast Op Reference<cpu-autocast-op-reference>` for details.
+
+    :class:`torch.cpu.amp.autocast` is the CPU counterpart of :class:`torch.cuda.amp.autocast`
+    and obeys the same rules: it should wrap only the forward pass(es) of your network,
+    ``autocast(enabled=False)`` subregions can be nested in autocast-enabled regions, and the
+    autocast state is thread-local.  The two are independent, so enabling one doesn't affect
+    ops on the other's device.  ``bfloat16`` has the exponent range of ``float32``, so
+    gradient scaling is not needed.
+
+    Example::
+
+        # Creates model and optimizer in default precision
+        model = Net()
+        optimizer = optim.SGD(model.parameters(), ...)
+
+        for input, target in data:
+            optimizer.zero_grad()
+
+            with torch.cpu.amp.autocast():
+                output = model(input)
+                loss = loss_fn(output, target)
+
+            loss.backward()
+            optimizer.step()
+
+    Tensors produced in an autocast-enabled region may be ``bfloat16``; cast them back to
+    ``float32`` before using them with ops that don't support ``bfloat16`` outside the region.
+
+    Functions compiled with :func:`torch.jit.script` are autocast too when they are called
+    in an autocast-enabled region.
+
+    Arguments:
+        enabled(bool, optional, default=True):  Whether autocasting should be enabled in the region.
+    """
+    def __init__(self, enabled=True):
+        self._enabled = enabled
+
+    def __enter__(self):
+        self.prev = torch.is_autocast_cpu_enabled()
+        torch.set_autocast_cpu_enabled(self._enabled)
+        torch.autocast_increment_nesting()
+
+    def __exit__(self, *args):
+        # The cast cache and the nesting level are shared with torch.cuda.amp.autocast.
+        if torch.autocast_decrement_nesting() == 0:
+            torch.clear_autocast_cache()
+        torch.set_autocast_cpu_enabled(self.prev)
+        return False
+
+    def __call__(self, func):
+        @functools.wraps(func)
+        def decorate_autocast(*args, **kwargs):
+            with self:
+                return func(*args, **kwargs)
+        return decorate_autocast
@@ -1,6 +1,7 @@
 #ifdef USE_CUDA
 #include <torch/csrc/CudaIPCTypes.h>
 #include <TH/THAllocator.h>
+#include <list>
 #include <map>
 #include <mutex>
 #include <random>
@@ -28,6 +29,10 @@ void warnProducerTerminatedBeforeSharedTensorsReleased() {
 struct CudaIPCGlobalEntities {
   std::mutex ref_counters_mutex_;
   std::atomic<int64_t> sync_events_used_;
+  // Interprocess events of the data blocks freed by the consumers, by device.
+  // They are not destroyed on exit, consumers may still have them open.
+  std::mutex free_events_mutex_;
+  std::map<c10::DeviceIndex, std::vector<cudaEvent_t>> free_events_;
   std::map<std::string, std::shared_ptr<CudaIPCRefCountersFile>>
       ref_counters_files_;
   std::shared_ptr<CudaIPCRefCountersFile> next_available_ref_counters_file_;
@@ -40,6 +45,20 @@ struct CudaIPCGlobalEntities {
       warnProducerTerminatedBeforeSharedTensorsReleased();
     }
   }
+  cudaEvent_t take_free_event(c10::DeviceIndex device) {
+    std::lock_guard<std::mutex> lock(free_events_mutex_);
+    auto& events = free_events_[device];
+    if (events.empty()) {
+      return nullptr;
+    }
+    cudaEvent_t event = events.back();
+    events.pop_back();
+    return event;
+  }
+  void return_free_event(c10::DeviceIndex device, cudaEvent_t event) {
+    std::lock_guard<std::mutex> lock(free_events_mutex_);
+    free_events_[device].push_back(event);
+  }
   void safe_clean_current_file() {
     std::lock_guard<std::mutex> lock(ref_counters_mutex_);
     if (next_available_ref_counters_file_ &&
@@ -134,16 +153,23 @@ CudaIPCSentData::CudaIPCSentData(
   //  [i.record() for i in a]
   //  ```
   //
-  if (cuda_ipc_global_entities.sync_events_used_.load() < CUDA_IPC_MAXIMUM_EVENTS_TO_USE) {
-    // TODO: More efficient would be to create event inside of main thread (at
-    // the moment of the queue.put). The reason this is more efficient is
-    // because the main thread may have queued extra work on the stream, which
-    // this event will consequently wait for (uselessly).
+  // Creating an interprocess event costs much more than recording it, so the
+  // events of the data blocks freed by the consumers are recorded again.
+  // They count towards the limit for as long as the process lives.
+  event_ = cuda_ipc_global_entities.take_free_event(device.index());
+  if (event_ == nullptr &&
+      cuda_ipc_global_entities.sync_events_used_.load() < CUDA_IPC_MAXIMUM_EVENTS_TO_USE) {
     cuda_ipc_global_entities.sync_events_used_ ++;
     C10_CUDA_CHECK(cudaEventCreateWithFlags(
         &event_,
         cudaEventDisableTiming | cudaEventInterprocess |
             cudaEventBlockingSync));
+  }
+  if (event_ != nullptr) {
+    // TODO: More efficient would be to create event inside of main thread (at
+    // the moment of the queue.put). The reason this is more efficient is
+    // because the main thread may have queued extra work on the stream, which
+    // this event will consequently wait for (uselessly).
     C10_CUDA_CHECK(cudaEventRecord(
         event_, c10::cuda::getCurrentCUDAStream(device.index())));
     event_sync_required_ = true;
@@ -166,9 +192,8 @@ CudaIPCSentData::~CudaIPCSentData() {
 #ifndef __HIP_PLATFORM_HCC__
   try {
     if (event_sync_required_) {
-      at::cuda::CUDAGuard device_guard(device_.index());
-      cudaEventDestroy(event_);
-      cuda_ipc_global_entities.sync_events_used_ --;
+      // The consumers released the data, so they already waited on the event
+      cuda_ipc_global_entities.return_free_event(device_.index(), event_);
     }
   } catch (...) { /* No throw */
   }
@@ -221,11 +246,40 @@ at::DataPtr GetNewRefCountedSentData(void* data, at::Device device) {
   return at::DataPtr(data, sent_data, CudaIPCSentDataDelete, device);
 }
 
+#ifndef __HIP_PLATFORM_HCC__
+cudaEvent_t GetReceivedEvent(const std::string& handle) {
+  // Opened events, most recently used first. Leaked, as destroying them while
+  // the process exits could fail once the CUDA runtime is unloaded.
+  static auto& received_events =
+      *new std::list<std::pair<std::string, cudaEvent_t>>();
+  static std::mutex received_events_mutex;
+
+  std::lock_guard<std::mutex> lock(received_events_mutex);
+  for (auto it = received_events.begin(); it != received_events.end(); ++it) {
+    if (it->first == handle) {
+      received_events.splice(received_events.begin(), received_events, it);
+      return it->second;
+    }
+  }
+  cudaEvent_t event;
+  C10_CUDA_CHECK(cudaIpcOpenEventHandle(
+      &event, *reinterpret_cast<const cudaIpcEventHandle_t*>(handle.c_str())));
+  received_events.emplace_front(handle, event);
+  // The producers don't use more events than that
+  if (received_events.size() > static_cast<size_t>(CUDA_IPC_MAXIMUM_EVENTS_TO_USE)) {
+    cudaEventDestroy(received_events.back().second);
+    received_events.pop_back();
+  }
+  return event;
+}
+#endif
+
 bool CudaIPCCollect() {
   bool freed_memory = cuda_ipc_global_entities.CudaIPCSentDataLimbo_.collect();
   if (cuda_ipc_global_entities.CudaIPCSentDataLimbo_.size() == 0) {
     cuda_ipc_global_entities.safe_clean_current_file();
   }
+  c10::cuda::CUDACachingAllocator::emptyIpcDevPtrCache();
   return freed_memory;
 }
 
@@ -49,6 +49,13 @@ struct CudaIPCSentData final {
 
 at::DataPtr GetNewRefCountedSentData(void* data, at::Device device);
 
+#ifndef __HIP_PLATFORM_HCC__
+// Opens the interprocess event of a received storage. As producers record
+// their events again for other data blocks, the opened events are kept for
+// the next storages guarded by them.
+cudaEvent_t GetReceivedEvent(const std::string& handle);
+#endif
+
 namespace {
 
 constexpr int64_t CUDA_IPC_REF_COUNTER_FILE_SIZE = 10000;
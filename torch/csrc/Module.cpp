@@ -16,6 +16,7 @@
 #include <ATen/DLConvertor.h>
 #include <ATen/Parallel.h>
 #include <ATen/Utils.h>
+#include <ATen/native/ConvBenchmarkCache.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
@@ -376,10 +377,23 @@ PyObject *THPModule_toDLPack(PyObject *_unused, PyObject *data)
   END_HANDLE_TH_ERRORS
 }
 
-PyObject *THPModule_fromDLPack(PyObject *_unused, PyObject *data)
+PyObject *THPModule_toDLPackOnStream(PyObject *_unused, PyObject *args)
 {
-  using namespace torch::autograd;
   HANDLE_TH_ERRORS
+  PyObject *data = nullptr;
+  unsigned long long stream_bits = 0;
+  if (!PyArg_ParseTuple(args, "OK", &data, &stream_bits)) {
+    return nullptr;
+  }
+  THPUtils_assert(THPVariable_Check(data), "data must be a Tensor");
+  DLManagedTensor* dlMTensor = at::toDLPack(
+      THPVariable_Unpack(data), c10::Stream::unpack(stream_bits));
+  return PyCapsule_New(dlMTensor, "dltensor", DLPack_Capsule_Destructor);
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject *fromDLPackCapsule(PyObject *data, c10::optional<c10::Stream> producer_stream)
+{
   DLManagedTensor * dlMTensor = (DLManagedTensor *)PyCapsule_GetPointer(data, "dltensor");
   THPUtils_assert(dlMTensor, "from_dlpack received an invalid capsule. "
     "Note that DLTensor capsules can be consumed only once, "
@@ -387,7 +401,8 @@ PyObject *THPModule_fromDLPack(PyObject *_unused, PyObject *data)
   // atensor steals the ownership of the underlying storage. It also passes a
   // destructor function that will be called when the underlying storage goes
   // out of scope. When the destructor is called, the dlMTensor is destructed too.
-  auto atensor = at::fromDLPack(dlMTensor);
+  auto atensor = producer_stream ? at::fromDLPack(dlMTensor, *producer_stream)
+                                 : at::fromDLPack(dlMTensor);
 
   // It is possible that the call to at::fromDLPack is the very first
   // call to create a Tensor in PyTorch. If so, then _lazy_init has
@@ -401,6 +416,24 @@ PyObject *THPModule_fromDLPack(PyObject *_unused, PyObject *data)
   // Make sure this capsule will never be used again.
   PyCapsule_SetName(data, "used_dltensor");
   return THPVariable_Wrap(std::move(atensor));
+}
+
+PyObject *THPModule_fromDLPack(PyObject *_unused, PyObject *data)
+{
+  HANDLE_TH_ERRORS
+  return fromDLPackCapsule(data, c10::nullopt);
+  END_HANDLE_TH_ERRORS
+}
+
+PyObject *THPModule_fromDLPackOnStream(PyObject *_unused, PyObject *args)
+{
+  HANDLE_TH_ERRORS
+  PyObject *data = nullptr;
+  unsigned long long stream_bits = 0;
+  if (!PyArg_ParseTuple(args, "OK", &data, &stream_bits)) {
+    return nullptr;
+  }
+  return fromDLPackCapsule(data, c10::Stream::unpack(stream_bits));
   END_HANDLE_TH_ERRORS
 }
 
@@ -446,6 +479,34 @@ PyObject *THPModule_deterministicCuDNN(PyObject *_unused, PyObject *noargs)
   else Py_RETURN_FALSE;
 }
 
+PyObject *THPModule_setDeterministic(PyObject *_unused, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_deterministic expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  at::globalContext().setDeterministic(arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_deterministic(PyObject *_unused, PyObject *noargs)
+{
+  if (at::globalContext().deterministic()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
+PyObject *THPModule_setCopyOnWrite(PyObject *_unused, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_copy_on_write expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  at::globalContext().setCopyOnWrite(arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_copyOnWrite(PyObject *_unused, PyObject *noargs)
+{
+  if (at::globalContext().copyOnWrite()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
 PyObject *THPModule_setBenchmarkCuDNN(PyObject *_unused, PyObject *arg)
 {
   THPUtils_assert(PyBool_Check(arg), "set_benchmark_cudnn expects a bool, "
@@ -466,6 +527,48 @@ PyObject *THPModule_benchmarkCuDNN(PyObject *_unused, PyObject *noargs)
   else Py_RETURN_FALSE;
 }
 
+PyObject *THPModule_setBenchmarkCPUConv(PyObject *_unused, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_cpu_conv_benchmark expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  at::globalContext().setBenchmarkCPUConv(arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_benchmarkCPUConv(PyObject *_unused, PyObject *noargs)
+{
+  if (at::globalContext().benchmarkCPUConv()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
+PyObject *THPModule_setAllowFloatAccumulationCPU(PyObject *_unused, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_cpu_allow_float_accumulation expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  at::globalContext().setAllowFloatAccumulationCPU(arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_allowFloatAccumulationCPU(PyObject *_unused, PyObject *noargs)
+{
+  if (at::globalContext().allowFloatAccumulationCPU()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
+PyObject *THPModule_setBenchmarkCuBLAS(PyObject *_unused, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_cublas_benchmark expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  at::globalContext().setBenchmarkCuBLAS(arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_benchmarkCuBLAS(PyObject *_unused, PyObject *noargs)
+{
+  if (at::globalContext().benchmarkCuBLAS()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
 PyObject *THPModule_setFlushDenormal(PyObject *_unused, PyObject *arg) {
   THPUtils_assert(PyBool_Check(arg), "flush_denormal expects a bool, "
           "but got %s", THPUtils_typename(arg));
@@ -556,10 +659,22 @@ static PyMethodDef TorchMethods[] = {
   {"_set_mkldnn_enabled", (PyCFunction)THPModule_setUserEnabledMkldnn, METH_O,  nullptr},
   {"_get_cudnn_benchmark", (PyCFunction)THPModule_benchmarkCuDNN, METH_NOARGS,     nullptr},
   {"_set_cudnn_benchmark", (PyCFunction)THPModule_setBenchmarkCuDNN, METH_O,  nullptr},
+  {"_get_cpu_conv_benchmark", (PyCFunction)THPModule_benchmarkCPUConv, METH_NOARGS,     nullptr},
+  {"_set_cpu_conv_benchmark", (PyCFunction)THPModule_setBenchmarkCPUConv, METH_O,  nullptr},
+  {"_get_cpu_allow_float_accumulation", (PyCFunction)THPModule_allowFloatAccumulationCPU, METH_NOARGS,     nullptr},
+  {"_set_cpu_allow_float_accumulation", (PyCFunction)THPModule_setAllowFloatAccumulationCPU, METH_O,  nullptr},
+  {"_get_cublas_benchmark", (PyCFunction)THPModule_benchmarkCuBLAS, METH_NOARGS,     nullptr},
+  {"_set_cublas_benchmark", (PyCFunction)THPModule_setBenchmarkCuBLAS, METH_O,  nullptr},
   {"_get_cudnn_deterministic", (PyCFunction)THPModule_deterministicCuDNN, METH_NOARGS,     nullptr},
   {"_set_cudnn_deterministic", (PyCFunction)THPModule_setDeterministicCuDNN, METH_O,  nullptr},
+  {"_get_deterministic", (PyCFunction)THPModule_deterministic, METH_NOARGS,     nullptr},
+  {"_set_deterministic", (PyCFunction)THPModule_setDeterministic, METH_O,  nullptr},
+  {"_get_copy_on_write", (PyCFunction)THPModule_copyOnWrite, METH_NOARGS,     nullptr},
+  {"_set_copy_on_write", (PyCFunction)THPModule_setCopyOnWrite, METH_O,  nullptr},
   {"_to_dlpack",      (PyCFunction)THPModule_toDLPack,          METH_O,       nullptr},
   {"_from_dlpack",    (PyCFunction)THPModule_fromDLPack,        METH_O,       nullptr},
+  {"_to_dlpack_on_stream", (PyCFunction)THPModule_toDLPackOnStream, METH_VARARGS, nullptr},
+  {"_from_dlpack_on_stream", (PyCFunction)THPModule_fromDLPackOnStream, METH_VARARGS, nullptr},
   {"set_flush_denormal", (PyCFunction)THPModule_setFlushDenormal, METH_O,     nullptr},
   {"get_default_dtype", (PyCFunction)THPModule_getDefaultDtype, METH_NOARGS,  nullptr},
   {"_get_default_device", (PyCFunction)THPModule_getDefaultDevice, METH_NOARGS,   nullptr},
@@ -758,6 +873,9 @@ PyObject* initModule() {
   auto py_module = py::reinterpret_borrow<py::module>(module);
   py_module.def("_demangle", &c10::demangle);
   py_module.def("_log_api_usage_once", &LogAPIUsageOnceFromPython);
+  py_module.def("_cpu_conv_benchmark_cache_save", &at::native::conv_benchmark_cache_save);
+  py_module.def("_cpu_conv_benchmark_cache_load", &at::native::conv_benchmark_cache_load);
+  py_module.def("_cpu_conv_benchmark_cache_clear", &at::native::conv_benchmark_cache_clear);
 
   ASSERT_TRUE(set_module_attr("has_openmp", at::hasOpenMP() ? Py_True : Py_False));
   ASSERT_TRUE(set_module_attr("has_mkl", at::hasMKL() ? Py_True : Py_False));
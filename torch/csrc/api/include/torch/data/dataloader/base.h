@@ -2,6 +2,7 @@
 
 #include <torch/data/dataloader_options.h>
 #include <torch/data/detail/data_shuttle.h>
+#include <torch/data/detail/device_copy.h>
 #include <torch/data/detail/sequencers.h>
 #include <torch/data/iterator.h>
 #include <torch/data/samplers/random.h>
@@ -37,6 +38,9 @@ class DataLoaderBase {
       std::unique_ptr<Dataset> main_thread_dataset = nullptr)
       : options_(std::move(options)),
         main_thread_dataset_(std::move(main_thread_dataset)),
+        // Besides the jobs in flight, `join()` queues one `QuitWorker` job per
+        // worker.
+        shuttle_(options_.max_jobs + options_.workers),
         sequencer_(new_sequencer()) {}
 
   virtual ~DataLoaderBase() {
@@ -120,12 +124,14 @@ class DataLoaderBase {
   /// The finished result of a job.
   struct Result : Sequenced {
     Result() = default;
-    Result(optional<Batch>&& b, size_t sqn)
-        : Sequenced(sqn), batch(std::move(b)) {}
+    Result(optional<Batch>&& b, size_t sqn, at::BatchedCopy c = {})
+        : Sequenced(sqn), batch(std::move(b)), copy(std::move(c)) {}
     Result(std::exception_ptr exception, size_t sqn)
         : Sequenced(sqn), exception(std::move(exception)) {}
     optional<Batch> batch;
     std::exception_ptr exception;
+    /// The copy of the batch to the `device` option, if one is configured.
+    at::BatchedCopy copy;
   };
 
   /// Subclass hook for getting the next batch request. The stateless case will
@@ -137,6 +143,7 @@ class DataLoaderBase {
   /// new jobs.
   virtual void reset() {
     shuttle_.drain();
+    prefetched_ = nullopt;
     sequence_number_ = 0;
     sequencer_ = new_sequencer();
     prefetch();
@@ -169,15 +176,50 @@ class DataLoaderBase {
           throw WorkerException(result->exception);
         } else if (result->batch) {
           prefetch(1);
+          result->copy.wait();
           return std::move(result->batch);
         }
       }
+    } else if (options_.device) {
+      optional<Result> result =
+          prefetched_ ? std::move(prefetched_) : load_to_device();
+      prefetched_ = nullopt;
+      if (!result) {
+        return nullopt;
+      }
+      if (result->exception) {
+        std::rethrow_exception(result->exception);
+      }
+      if (result->batch) {
+        // Start copying the next batch before this one is handed out, so that
+        // the copy overlaps the work on this batch.
+        prefetched_ = load_to_device();
+        result->copy.wait();
+      }
+      return std::move(result->batch);
     } else if (auto batch_request = get_batch_request()) {
       return this->main_thread_dataset_->get_batch(std::move(*batch_request));
     }
     return nullopt;
   }
 
+  /// Loads the next batch on the main thread and starts copying it to the
+  /// `device` option. Returns an empty `optional` if the DataLoader is
+  /// exhausted, and the exception as the result if loading fails.
+  optional<Result> load_to_device() {
+    try {
+      if (auto batch_request = get_batch_request()) {
+        optional<BatchType> batch =
+            this->main_thread_dataset_->get_batch(std::move(*batch_request));
+        at::BatchedCopy copy = detail::copy_batch_to(batch, *options_.device);
+        return Result(std::move(batch), 0, std::move(copy));
+      }
+    } catch (...) {
+      return Result(std::current_exception(), 0);
+    }
+    return nullopt;
+  }
+
   /// The function that worker threads run.
   void worker_thread(Dataset& dataset) {
     while (true) {
@@ -186,8 +228,14 @@ class DataLoaderBase {
         break;
       }
       try {
-        auto batch = dataset.get_batch(std::move(*job.batch_request));
-        shuttle_.push_result({std::move(batch), job.sequence_number});
+        optional<Batch> batch =
+            dataset.get_batch(std::move(*job.batch_request));
+        at::BatchedCopy copy;
+        if (options_.device) {
+          copy = detail::copy_batch_to(batch, *options_.device);
+        }
+        shuttle_.push_result(
+            {std::move(batch), job.sequence_number, std::move(copy)});
       } catch (...) {
         shuttle_.push_result({std::current_exception(), job.sequence_number});
       }
@@ -233,12 +281,17 @@ class DataLoaderBase {
   /// The worker threads, running the `worker_thread()` method.
   std::vector<std::thread> workers_;
 
-  /// The `DataShuttle` which takes care of the life cycle of a job.
+  /// The `DataShuttle` which takes care of the life cycle of a job. Its queues
+  /// are bounded by the most jobs that can be in flight.
   detail::DataShuttle<Job, Result> shuttle_;
 
   /// The `Sequencer`, which handles optional ordering of batches.
   std::unique_ptr<detail::sequencers::Sequencer<Result>> sequencer_;
 
+  /// Without worker threads, the batch after the one last returned, already
+  /// being copied to the `device` option.
+  optional<Result> prefetched_;
+
   /// True if the DataLoader has joined its worker threads.
   bool joined_ = false;
 };
@@ -37,6 +37,16 @@ struct DataLoaderOptions {
   /// Whether to omit the last batch if it contains less than `batch_size`
   /// examples.
   TORCH_ARG(bool, drop_last) = false;
+
+  /// An optional (CUDA) device to copy the tensors of the batches to. The
+  /// tensors of a batch are copied with a single transfer on a copy stream
+  /// by the thread that loads it (see `at::copy_batch`), so that the copies of
+  /// the next batches overlap the work on the current one. Without worker
+  /// threads, the main thread loads the next batch and starts its copy before
+  /// handing out the current one. The current stream of the thread iterating
+  /// over the DataLoader waits for the copy of a batch before it is handed
+  /// out. The tensors of the batches must be dense CPU tensors.
+  TORCH_ARG(optional<Device>, device);
 };
 
 /// Like `DataLoaderOptions`, but without any unconfigured state.
@@ -52,7 +62,8 @@ struct FullDataLoaderOptions {
         max_jobs(options.max_jobs().value_or(2 * workers)),
         timeout(options.timeout()),
         enforce_ordering(options.enforce_ordering()),
-        drop_last(options.drop_last()) {}
+        drop_last(options.drop_last()),
+        device(options.device()) {}
 
   size_t batch_size;
   size_t workers;
@@ -60,6 +71,7 @@ struct FullDataLoaderOptions {
   optional<std::chrono::milliseconds> timeout;
   bool enforce_ordering;
   bool drop_last;
+  optional<Device> device;
 };
 } // namespace data
 } // namespace torch
@@ -4,6 +4,8 @@
 #include <torch/csrc/utils/memory.h>
 #include <torch/data/datasets/stateful.h>
 #include <torch/data/samplers.h>
+#include <deque>
+#include <future>
 #include <queue>
 #include <thread>
 
@@ -30,6 +32,18 @@ class ChunkDataReader {
   /// Read an entire chunk.
   virtual ChunkType read_chunk(size_t chunk_index) = 0;
 
+  /// Starts reading an entire chunk and returns a future of it. Each
+  /// preloader of a `ChunkDataset` keeps up to `io_depth` of these reads in
+  /// flight while it splits the chunks already read into batches, so readers of
+  /// remote storage can override this to issue non-blocking reads instead of
+  /// needing a thread for every read in flight. By default, the chunk is read
+  /// with `read_chunk` when the future is waited on.
+  virtual std::future<ChunkType> read_chunk_async(size_t chunk_index) {
+    return std::async(std::launch::deferred, [this, chunk_index] {
+      return this->read_chunk(chunk_index);
+    });
+  }
+
   /// Returns the number of chunks available in this reader.
   virtual size_t chunk_count() = 0;
 
@@ -90,6 +104,13 @@ class BatchDataBuffer {
     return batch.batch_data;
   }
 
+  /// Whether the queue has room for more examples, i.e. whether more chunks
+  /// should be read. Called from the ChunkDataset worker threads.
+  bool has_capacity() {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    return total_example_count_in_queue_ < queue_capacity_ || stop_;
+  }
+
   /// Push preloaded chunks to batch queue. Called from the ChunkDataset worker
   /// threads.
   void add_chunk_data(UnwrappedBatchType data) {
@@ -292,6 +313,12 @@ struct ChunkDatasetOptions {
   // penalty when this value is greater than 1, as we need to do extra merge
   // between multiple chunks before performing example sampling.
   TORCH_ARG(size_t, cross_chunk_shuffle_count) = 1;
+
+  /// The number of chunk reads (`ChunkDataReader::read_chunk_async`) each
+  /// preloader keeps in flight. The reads beyond the first one are only issued
+  /// while the batch cache has room for more examples, so that `cache_size`
+  /// also bounds the memory of chunks read ahead of time.
+  TORCH_ARG(size_t, io_depth) = 1;
 };
 
 /// A stateful dataset that support hierarchical sampling and prefetching of
@@ -332,7 +359,11 @@ class ChunkDataset final
         preprocessing_policy_(preprocessing_policy),
         quit_worker_(false),
         running_preloaders_(0),
-        load_checkpoint_(false) {}
+        load_checkpoint_(false) {
+    TORCH_CHECK(
+        options_.io_depth() > 0,
+        "io_depth is 0. At least one chunk read needs to be in flight.");
+  }
 
   virtual ~ChunkDataset() {
     // stop batch buffer first.
@@ -422,22 +453,51 @@ class ChunkDataset final
   }
 
  private:
-  /// running on worker thread to preload chunk data.
+  /// The reads of the chunks of one `cross_chunk_shuffle_count` group.
+  using ChunkReads = std::vector<std::future<typename ChunkReader::ChunkType>>;
+
+  /// Samples the next chunks to read and starts reading them. Returns false if
+  /// the chunk sampler is exhausted.
+  bool read_next_chunks(std::deque<ChunkReads>& reads) {
+    std::vector<size_t> chunk_idx;
+    {
+      std::lock_guard<std::mutex> lock(chunk_index_guard_);
+      if (auto chunk_sampler_result = chunk_sampler_.next(
+              this->options_.cross_chunk_shuffle_count())) {
+        chunk_idx = chunk_sampler_result.value();
+      } else {
+        return false;
+      }
+    }
+    ChunkReads chunk_reads;
+    chunk_reads.reserve(chunk_idx.size());
+    for (size_t index : chunk_idx) {
+      chunk_reads.push_back(chunk_reader_.read_chunk_async(index));
+    }
+    reads.push_back(std::move(chunk_reads));
+    return true;
+  }
+
+  /// running on worker thread to preload chunk data. The worker keeps up to
+  /// `io_depth` groups of chunk reads in flight, and splits the chunks of the
+  /// oldest one into batches once they are read.
   void preloader(size_t id) {
+    std::deque<ChunkReads> reads;
+    bool exhausted = false;
     while (!quit_worker_.load()) {
       try {
-        std::vector<size_t> chunk_idx;
-        {
-          std::lock_guard<std::mutex> lock(chunk_index_guard_);
-          if (auto chunk_sampler_result = chunk_sampler_.next(this->options_.cross_chunk_shuffle_count())) {
-            chunk_idx = chunk_sampler_result.value();
-          } else {
-            break;
-          }
+        while (!exhausted && reads.size() < options_.io_depth() &&
+               (reads.empty() || batch_buffer_->has_capacity())) {
+          exhausted = !read_next_chunks(reads);
+        }
+        if (reads.empty()) {
+          break;
         }
-        UnwrappedBatchType data = chunk_reader_.read_chunk(chunk_idx[0]);
-        for (size_t i = 1; i < chunk_idx.size(); ++i) {
-          auto chunk_data = chunk_reader_.read_chunk(chunk_idx[i]);
+        ChunkReads chunk_reads = std::move(reads.front());
+        reads.pop_front();
+        UnwrappedBatchType data = chunk_reads[0].get();
+        for (size_t i = 1; i < chunk_reads.size(); ++i) {
+          auto chunk_data = chunk_reads[i].get();
           std::move(
               chunk_data.begin(), chunk_data.end(), std::back_inserter(data));
         }
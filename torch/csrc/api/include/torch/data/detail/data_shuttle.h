@@ -25,6 +25,11 @@ namespace detail {
 template <typename Job, typename Result>
 class DataShuttle {
  public:
+  /// Constructs a `DataShuttle` for at most `capacity` jobs in flight at a
+  /// time, which bounds both its queues.
+  explicit DataShuttle(size_t capacity = 1024)
+      : new_jobs_(capacity), results_(capacity) {}
+
   /// Pushes a new job. Called by the main thread.
   void push_job(Job job) {
     new_jobs_.push(std::move(job));
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <torch/data/example.h>
+#include <torch/types.h>
+
+#include <ATen/BatchedCopy.h>
+
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace detail {
+
+/// Appends pointers to the tensors of a batch to `tensors`. Batches are
+/// tensors, `Example`s and vectors or optionals of batches; anything else has
+/// no tensors to copy.
+inline void collect_tensors(Tensor& tensor, std::vector<Tensor*>& tensors);
+template <typename Data, typename Target>
+void collect_tensors(Example<Data, Target>& example, std::vector<Tensor*>& tensors);
+template <typename Data>
+void collect_tensors(
+    Example<Data, example::NoTarget>& example,
+    std::vector<Tensor*>& tensors);
+template <typename T>
+void collect_tensors(std::vector<T>& batch, std::vector<Tensor*>& tensors);
+template <typename T>
+void collect_tensors(optional<T>& batch, std::vector<Tensor*>& tensors);
+template <typename T>
+void collect_tensors(T& /*batch*/, std::vector<Tensor*>& /*tensors*/) {}
+
+inline void collect_tensors(Tensor& tensor, std::vector<Tensor*>& tensors) {
+  if (tensor.defined()) {
+    tensors.push_back(&tensor);
+  }
+}
+
+template <typename Data, typename Target>
+void collect_tensors(Example<Data, Target>& example, std::vector<Tensor*>& tensors) {
+  collect_tensors(example.data, tensors);
+  collect_tensors(example.target, tensors);
+}
+
+template <typename Data>
+void collect_tensors(
+    Example<Data, example::NoTarget>& example,
+    std::vector<Tensor*>& tensors) {
+  collect_tensors(example.data, tensors);
+}
+
+template <typename T>
+void collect_tensors(std::vector<T>& batch, std::vector<Tensor*>& tensors) {
+  for (auto& element : batch) {
+    collect_tensors(element, tensors);
+  }
+}
+
+template <typename T>
+void collect_tensors(optional<T>& batch, std::vector<Tensor*>& tensors) {
+  if (batch) {
+    collect_tensors(*batch, tensors);
+  }
+}
+
+/// Replaces the tensors of `batch` with copies on `device`, made with a single
+/// transfer by `at::copy_batch`. The returned `BatchedCopy` must be waited on
+/// before the tensors are used.
+template <typename Batch>
+at::BatchedCopy copy_batch_to(Batch& batch, Device device) {
+  std::vector<Tensor*> tensors;
+  collect_tensors(batch, tensors);
+  std::vector<Tensor> inputs;
+  inputs.reserve(tensors.size());
+  for (Tensor* tensor : tensors) {
+    inputs.push_back(*tensor);
+  }
+  at::BatchedCopy copy = at::copy_batch(inputs, device);
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    *tensors[i] = std::move(copy.tensors[i]);
+  }
+  copy.tensors.clear();
+  return copy;
+}
+} // namespace detail
+} // namespace data
+} // namespace torch
@@ -4,21 +4,32 @@
 
 #include <c10/util/Exception.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <cstddef>
+#include <memory>
 #include <mutex>
-#include <queue>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
 
 namespace torch {
 namespace data {
 namespace detail {
 
-/// A basic locked, blocking MPMC queue.
+/// A bounded, blocking MPMC queue, lock-free unless it has to block.
 ///
-/// Every `push` and `pop` is guarded by a mutex. A condition variable is used
-/// to communicate insertion of new elements, such that waiting threads will be
-/// woken up if they are currently waiting inside a call to `pop()`.
+/// The elements live in a ring buffer of `capacity` (rounded up to a power of
+/// two) cells, each with a sequence number that tells producers and consumers
+/// whether it is free to write or ready to read, so that `push` and `pop` only
+/// contend on a compare-and-swap of the position they claim (see Dmitry
+/// Vyukov's bounded MPMC queue). A `pop` from an empty queue spins briefly and
+/// then waits on a condition variable; a `push` only takes the mutex to wake up
+/// a waiting thread when there is one. A `push` to a full queue yields until a
+/// cell is free.
 ///
 /// Note that this data structure is written specifically for use with the
 /// `DataLoader`. Its behavior is tailored to this use case and may not be
@@ -26,14 +37,35 @@ namespace detail {
 template <typename T>
 class Queue {
  public:
+  /// Constructs a `Queue` that holds at most `capacity` elements at a time.
+  explicit Queue(size_t capacity = 1024)
+      : mask_(round_up_to_power_of_two(std::max<size_t>(capacity, 1)) - 1),
+        cells_(new Cell[mask_ + 1]) {
+    for (size_t i = 0; i <= mask_; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  Queue(const Queue&) = delete;
+  Queue& operator=(const Queue&) = delete;
+
+  ~Queue() {
+    clear();
+  }
+
   /// Pushes a new value to the back of the `Queue` and notifies one thread on
   /// the waiting side about this event.
   void push(T value) {
-    {
+    while (!try_push(value)) {
+      std::this_thread::yield();
+    }
+    // Pairs with the fence in `pop()`: either the waiter sees the new element,
+    // or the push sees the waiter.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_relaxed) > 0) {
       std::lock_guard<std::mutex> lock(mutex_);
-      queue_.push(std::move(value));
+      cv_.notify_one();
     }
-    cv_.notify_one();
   }
 
   /// Blocks until at least one element is ready to be popped from the front of
@@ -41,24 +73,32 @@ class Queue {
   /// spent waiting for an element. If the wait times out, an exception is
   /// raised.
   T pop(optional<std::chrono::milliseconds> timeout = nullopt) {
+    optional<T> value;
+    for (int spin = 0; spin < kSpins; ++spin) {
+      if (try_pop(value)) {
+        return std::move(*value);
+      }
+    }
     std::unique_lock<std::mutex> lock(mutex_);
+    waiters_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto ready = [this, &value] { return this->try_pop(value); };
+    bool popped = true;
     if (timeout) {
-      if (!cv_.wait_for(
-              lock, *timeout, [this] { return !this->queue_.empty(); })) {
-        // clang-format off
-        AT_ERROR(
-            "Timeout in DataLoader queue while waiting for next batch"
-            " (timeout was ", timeout->count(), " ms)");
-        // clang-format on
-      }
+      popped = cv_.wait_for(lock, *timeout, ready);
     } else {
-      cv_.wait(lock, [this] { return !this->queue_.empty(); });
+      cv_.wait(lock, ready);
     }
-    AT_ASSERT(!queue_.empty());
-    T value = queue_.front();
-    queue_.pop();
-    lock.unlock();
-    return value;
+    waiters_.fetch_sub(1, std::memory_order_relaxed);
+    if (!popped) {
+      // clang-format off
+      AT_ERROR(
+          "Timeout in DataLoader queue while waiting for next batch"
+          " (timeout was ", timeout->count(), " ms)");
+      // clang-format on
+    }
+    AT_ASSERT(value.has_value());
+    return std::move(*value);
   }
 
   /// Empties the queue and returns the number of elements that were present at
@@ -66,19 +106,103 @@ class Queue {
   /// is assumed to be used to drain the queue during shutdown of a
   /// `DataLoader`.
   size_t clear() {
-    std::lock_guard<std::mutex> lock(this->mutex_);
-    const auto size = queue_.size();
-    while (!queue_.empty()) {
-      queue_.pop();
+    size_t size = 0;
+    optional<T> value;
+    while (try_pop(value)) {
+      ++size;
     }
     return size;
   }
 
  private:
-  std::queue<T> queue_;
+  /// The number of attempts of a `pop()` on an empty queue before it waits.
+  static constexpr int kSpins = 64;
+  static constexpr size_t kCacheLineSize = 64;
+
+  struct Cell {
+    std::atomic<size_t> sequence;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+    T* value() {
+      return reinterpret_cast<T*>(&storage);
+    }
+  };
+
+  static size_t round_up_to_power_of_two(size_t n) {
+    size_t power = 1;
+    while (power < n) {
+      power <<= 1;
+    }
+    return power;
+  }
+
+  /// Moves `value` into the cell at the back of the queue, or returns false
+  /// if the queue is full.
+  bool try_push(T& value) {
+    size_t position = push_position_.load(std::memory_order_relaxed);
+    while (true) {
+      Cell& cell = cells_[position & mask_];
+      const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(sequence) -
+          static_cast<std::ptrdiff_t>(position);
+      if (diff == 0) {
+        if (push_position_.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          new (cell.value()) T(std::move(value));
+          cell.sequence.store(position + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        position = push_position_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// Moves the element at the front of the queue into `value`, or returns
+  /// false if the queue is empty.
+  bool try_pop(optional<T>& value) {
+    size_t position = pop_position_.load(std::memory_order_relaxed);
+    while (true) {
+      Cell& cell = cells_[position & mask_];
+      const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(sequence) -
+          static_cast<std::ptrdiff_t>(position + 1);
+      if (diff == 0) {
+        if (pop_position_.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          value = std::move(*cell.value());
+          cell.value()->~T();
+          cell.sequence.store(position + mask_ + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        position = pop_position_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  const size_t mask_;
+  std::unique_ptr<Cell[]> cells_;
+  /// The positions are padded to separate cache lines, so that producers and
+  /// consumers do not invalidate each other's.
+  std::atomic<size_t> push_position_{0};
+  char push_padding_[kCacheLineSize - sizeof(std::atomic<size_t>)];
+  std::atomic<size_t> pop_position_{0};
+  char pop_padding_[kCacheLineSize - sizeof(std::atomic<size_t>)];
+  /// The number of threads waiting in `pop()`.
+  std::atomic<size_t> waiters_{0};
   std::mutex mutex_;
   std::condition_variable cv_;
 };
+
+template <typename T>
+constexpr int Queue<T>::kSpins;
+template <typename T>
+constexpr size_t Queue<T>::kCacheLineSize;
 } // namespace detail
 } // namespace data
 } // namespace torch
@@ -4,6 +4,10 @@
 #include <torch/data/transforms/collate.h>
 #include <torch/types.h>
 
+#include <ATen/Context.h>
+
+#include <memory>
+#include <mutex>
 #include <utility>
 #include <vector>
 
@@ -11,13 +15,95 @@ namespace torch {
 namespace data {
 namespace transforms {
 
+/// A pool of the buffers a `Stack` collates batches into, so that every example
+/// is copied once, into its slot of the batch, and batches reuse the memory of
+/// the ones before them instead of allocating their own. A buffer is recycled
+/// once the batch in it, and every view of it, has been destroyed. The pool is
+/// shared by the copies of the `Stack` of every DataLoader worker.
+///
+/// If `pin_memory` is true and CUDA is available, the buffers are allocated in
+/// pinned memory, so that the batches can be copied to a CUDA device
+/// asynchronously (with `non_blocking`) without first being copied to pinned
+/// memory. The copies must be completed before a batch is destroyed, since its
+/// buffer may then be written with the next batch right away.
+class BatchBufferPool {
+ public:
+  explicit BatchBufferPool(bool pin_memory = true)
+      : pin_memory_(pin_memory && at::globalContext().hasCUDA()) {}
+
+  /// Returns a contiguous tensor of `sizes` and `dtype`, in the smallest free
+  /// buffer of the pool that is large enough, or a new buffer if there is none.
+  Tensor acquire(IntArrayRef sizes, ScalarType dtype) {
+    int64_t numel = 1;
+    for (int64_t size : sizes) {
+      numel *= size;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Tensor* best = nullptr;
+    for (auto& buffer : buffers_) {
+      if (buffer.scalar_type() == dtype && buffer.numel() >= numel &&
+          is_free(buffer) && (!best || buffer.numel() < best->numel())) {
+        best = &buffer;
+      }
+    }
+    if (!best) {
+      buffers_.push_back(torch::empty(
+          {numel}, TensorOptions(dtype).pinned_memory(pin_memory_)));
+      best = &buffers_.back();
+    }
+    return best->narrow(0, 0, numel).view(sizes);
+  }
+
+  /// The number of buffers allocated by the pool.
+  size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return buffers_.size();
+  }
+
+  bool pin_memory() const noexcept {
+    return pin_memory_;
+  }
+
+ private:
+  /// A buffer is free when the pool holds the only reference to its storage.
+  static bool is_free(const Tensor& buffer) {
+    return buffer.use_count() == 1 && buffer.storage().use_count() == 1;
+  }
+
+  mutable std::mutex mutex_;
+  std::vector<Tensor> buffers_;
+  const bool pin_memory_;
+};
+
+namespace detail {
+/// Stacks `tensors` into a buffer from `pool`, or into a new tensor without a
+/// pool.
+inline Tensor stack_into(
+    const std::vector<Tensor>& tensors,
+    BatchBufferPool* pool) {
+  if (!pool || tensors.empty() || !tensors[0].device().is_cpu()) {
+    return torch::stack(tensors);
+  }
+  std::vector<int64_t> sizes = tensors[0].sizes().vec();
+  sizes.insert(sizes.begin(), static_cast<int64_t>(tensors.size()));
+  Tensor batch = pool->acquire(sizes, tensors[0].scalar_type());
+  return torch::stack_out(batch, tensors);
+}
+} // namespace detail
+
 template <typename T = Example<>>
 struct Stack;
 
 /// A `Collation` for `Example<Tensor, Tensor>` types that stacks all data
 /// tensors into one tensor, and all target (label) tensors into one tensor.
+/// With a `BatchBufferPool`, the tensors are stacked into buffers from the
+/// pool.
 template <>
 struct Stack<Example<>> : public Collation<Example<>> {
+  Stack() = default;
+  explicit Stack(std::shared_ptr<BatchBufferPool> pool)
+      : pool_(std::move(pool)) {}
+
   Example<> apply_batch(std::vector<Example<>> examples) override {
     std::vector<torch::Tensor> data, targets;
     data.reserve(examples.size());
@@ -26,23 +112,35 @@ struct Stack<Example<>> : public Collation<Example<>> {
       data.push_back(std::move(example.data));
       targets.push_back(std::move(example.target));
     }
-    return {torch::stack(data), torch::stack(targets)};
+    return {detail::stack_into(data, pool_.get()),
+            detail::stack_into(targets, pool_.get())};
   }
+
+ private:
+  std::shared_ptr<BatchBufferPool> pool_;
 };
 
 /// A `Collation` for `Example<Tensor, NoTarget>` types that stacks all data
-/// tensors into one tensor.
+/// tensors into one tensor. With a `BatchBufferPool`, the tensors are stacked
+/// into buffers from the pool.
 template <>
 struct Stack<TensorExample>
     : public Collation<Example<Tensor, example::NoTarget>> {
+  Stack() = default;
+  explicit Stack(std::shared_ptr<BatchBufferPool> pool)
+      : pool_(std::move(pool)) {}
+
   TensorExample apply_batch(std::vector<TensorExample> examples) override {
     std::vector<torch::Tensor> data;
     data.reserve(examples.size());
     for (auto& example : examples) {
       data.push_back(std::move(example.data));
     }
-    return torch::stack(data);
+    return detail::stack_into(data, pool_.get());
   }
+
+ private:
+  std::shared_ptr<BatchBufferPool> pool_;
 };
 } // namespace transforms
 } // namespace data
@@ -30,7 +30,8 @@ class Cloneable : public virtual Module {
 
   /// Performs a recursive "deep copy" of the `Module`, such that all parameters
   /// and submodules in the cloned module are different from those in the
-  /// original module.
+  /// original module. Within `clone_sharing_parameters()`, the parameters of
+  /// the copy share the storage of the original ones instead.
   std::shared_ptr<Module> clone(
       const optional<Device>& device = nullopt) const override {
     NoGradGuard no_grad;
@@ -51,10 +52,12 @@ class Cloneable : public virtual Module {
         "parameters as the original module after calling reset(). "
         "Are you sure you called register_parameter() inside reset() "
         "and not the constructor?");
+    const bool share_parameters = detail::clone_shares_parameters();
     for (const auto& parameter : named_parameters(/*recurse=*/false)) {
       auto& tensor = *parameter;
-      auto data = device && tensor.device() != *device ?
-          tensor.to(*device) : autograd::Variable(tensor).clone();
+      auto data = device && tensor.device() != *device ? tensor.to(*device)
+          : share_parameters ? tensor
+                             : autograd::Variable(tensor).clone();
       copy->parameters_[parameter.key()].set_data(data);
     }
     // Don't remove 'this' pointer. See [[this pointer note]]
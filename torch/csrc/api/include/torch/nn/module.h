@@ -15,10 +15,30 @@
 #include <memory>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 namespace torch {
 namespace nn {
 
+/// The parameters of a `Module` of one dtype and device, relocated to one
+/// contiguous buffer by `Module::coalesce_parameters()`.
+struct TORCH_API FlatParameterBuffer {
+  /// The values of the parameters, as one 1-D tensor.
+  Tensor data;
+  /// The gradients of the parameters, as one 1-D tensor of the size of `data`.
+  /// The parts of the parameters that do not require grad are zero.
+  Tensor grad;
+  /// The parameters whose values are views of `data` (and whose gradients are
+  /// views of `grad`), in the order of their elements in the buffers.
+  std::vector<Tensor> parameters;
+};
+
+namespace detail {
+/// Whether the `clone()`s running on this thread share the parameters of the
+/// modules they copy, see `Module::clone_sharing_parameters()`.
+TORCH_API bool& clone_shares_parameters();
+} // namespace detail
+
 /// The base class for all modules in PyTorch.
 ///
 /// \rst
@@ -114,6 +134,21 @@ class TORCH_API Module : public std::enable_shared_from_this<Module> {
   virtual std::shared_ptr<Module> clone(
       const optional<Device>& device = nullopt) const;
 
+  /// Like `clone()`, but the parameters of the copy share their storage with
+  /// the parameters of this module instead of being copied, unless they have
+  /// to be moved to another `device`. Buffers and submodules are still
+  /// copied.
+  ///
+  /// This is meant for multi-threaded inference: every thread can run
+  /// `forward()` on its own copy, with its own buffers (such as the running
+  /// statistics of a batch norm in training mode), without a lock and without
+  /// one copy of the weights per thread. Each copy still has its own parameter
+  /// variables and thus its own gradients, but an in-place update of the
+  /// weights of one of them, by an optimizer or with `NoGradGuard`, changes
+  /// the weights of all of them.
+  std::shared_ptr<Module> clone_sharing_parameters(
+      const optional<Device>& device = nullopt) const;
+
   /// Applies the `function` to the `Module` and recursively to every submodule.
   /// The function must accept a `Module&`.
   ///
@@ -304,6 +339,22 @@ class TORCH_API Module : public std::enable_shared_from_this<Module> {
   /// Recursively zeros out the `grad` value of each registered parameter.
   virtual void zero_grad();
 
+  /// Relocates all parameters, recursively, into one contiguous buffer per
+  /// dtype and device, and their gradients into another buffer of the same
+  /// size, and returns the buffers. The parameters keep their identity, but
+  /// their values and gradients become contiguous views of the buffers, so
+  /// that optimizer steps, gradient norms or all-reduces can work on a buffer
+  /// at once instead of parameter by parameter.
+  ///
+  /// The gradients of the parameters that require grad are defined from then
+  /// on: they keep their current values, or are zero if they were undefined.
+  /// Since gradients are accumulated in place (without `create_graph`) and
+  /// `zero_grad()` zeros them in place, they stay in the buffer across
+  /// iterations. Anything that replaces the values or gradients of the
+  /// parameters, such as `to()`, or setting `grad()` to a new tensor, moves
+  /// them out of the buffers again.
+  std::vector<FlatParameterBuffer> coalesce_parameters();
+
   /// Attempts to cast this `Module` to the given `ModuleType`.
   ///
   /// This method is useful when calling `apply()`.
@@ -10,41 +10,28 @@ namespace utils {
 // See
 // https://pytorch.org/docs/stable/nn.html?highlight=clip_grad_norm#torch.nn.utils.clip_grad_norm_
 // for more details about this module.
+//
+// The total norm and the scaling of the gradients take a few multi-tensor
+// kernel launches for all the gradients (see _foreach_total_norm), and only
+// returning the norm waits for them.
 inline double clip_grad_norm_(
     std::vector<Tensor> parameters,
     double max_norm,
     double norm_type = 2.0) {
-  std::vector<Tensor> params_with_grad;
+  std::vector<Tensor> grads;
 
   for (const auto& param : parameters) {
     auto& grad = param.grad();
     if (grad.defined()) {
-      params_with_grad.push_back(param);
+      grads.push_back(grad.data());
     }
   }
-  double total_norm = 0.0;
-  if (norm_type == std::numeric_limits<double>::infinity()) {
-    for (const auto& param : params_with_grad) {
-      auto param_max = param.grad().data().abs().max().item().toDouble();
-      if (param_max > total_norm) {
-        total_norm = param_max;
-      }
-    }
-  } else {
-    for (const auto& param : params_with_grad) {
-      auto param_norm = param.grad().data().norm(norm_type);
-      total_norm += std::pow(param_norm.item().toDouble(), norm_type);
-    }
-    total_norm = std::pow(total_norm, 1.0 / norm_type);
-  }
-
-  auto clip_coef = max_norm / (total_norm + 1e-6);
-  if (clip_coef < 1) {
-    for (auto& param : params_with_grad) {
-      param.grad().data().mul_(clip_coef);
-    }
+  if (grads.empty()) {
+    return 0.0;
   }
-  return total_norm;
+  const auto total_norm = torch::_foreach_total_norm(grads, norm_type);
+  torch::_foreach_clip_by_total_norm_(grads, total_norm, max_norm);
+  return total_norm.item<double>();
 }
 
 // A wrapper around clip_grad_norm_ that allows us to call the function with a
@@ -167,6 +167,14 @@ b) For c10::nullopt value: in param state, c10::nullopt value in C++ impl is equ
    missing key in Python impl. Since we don't serialize missing keys in Python API,
    we skip c10::nullopt values when serializing the param state. */
 
+namespace detail {
+/// Whether a sparse gradient of `param` can be applied with the fused row
+/// update ops (`at::_fused_sparse_adagrad_`, `at::_fused_sparse_sgd_`): a
+/// contiguous 2-dimensional CPU parameter whose gradient only has a sparse
+/// row dimension, like the gradient of an embedding table.
+TORCH_API bool is_fused_sparse_row_update(const Tensor& param, const Tensor& grad);
+} // namespace detail
+
 /// Serializes an `Optimizer` into an `OutputArchive`.
 TORCH_API serialize::OutputArchive& operator<<(
     serialize::OutputArchive& archive,
@@ -12,6 +12,7 @@
 #include <ostream>
 #include <string>
 #include <typeinfo>
+#include <unordered_set>
 
 namespace torch {
 namespace nn {
@@ -34,6 +35,13 @@ std::string join_name(const std::string& name_prefix, const std::string& name) {
 }
 } // namespace
 
+namespace detail {
+bool& clone_shares_parameters() {
+  thread_local bool shares_parameters = false;
+  return shares_parameters;
+}
+} // namespace detail
+
 Module::Module()
     : parameters_("Parameter"), buffers_("Buffer"), children_("Submodule") {}
 
@@ -75,6 +83,22 @@ std::shared_ptr<Module> Module::clone(const optional<Device>& device) const {
       "> instead of torch::nn::Module to inherit the ability to clone.");
 }
 
+std::shared_ptr<Module> Module::clone_sharing_parameters(
+    const optional<Device>& device) const {
+  // The flag reaches the clone() of every submodule, including those cloned
+  // by the clone() of a container.
+  struct SharingGuard {
+    SharingGuard() : previous(detail::clone_shares_parameters()) {
+      detail::clone_shares_parameters() = true;
+    }
+    ~SharingGuard() {
+      detail::clone_shares_parameters() = previous;
+    }
+    bool previous;
+  } guard;
+  return clone(device);
+}
+
 void Module::apply(const ModuleApplyFunction& function) {
   function(*this);
   apply_to_submodules(
@@ -263,6 +287,62 @@ void Module::zero_grad() {
   }
 }
 
+std::vector<FlatParameterBuffer> Module::coalesce_parameters() {
+  NoGradGuard no_grad;
+  std::vector<FlatParameterBuffer> flat_buffers;
+  std::vector<int64_t> numels;
+  std::unordered_set<TensorImpl*> seen;
+  for (auto& parameter : parameters()) {
+    // Parameters shared between submodules are relocated once.
+    if (!seen.insert(parameter.unsafeGetTensorImpl()).second) {
+      continue;
+    }
+    TORCH_CHECK(
+        parameter.layout() == torch::kStrided,
+        "coalesce_parameters() expects dense parameters, but got one with ",
+        "layout ", parameter.layout());
+    auto buffer = std::find_if(
+        flat_buffers.begin(),
+        flat_buffers.end(),
+        [&](const FlatParameterBuffer& flat) {
+          const auto& first = flat.parameters.front();
+          return first.device() == parameter.device() &&
+              first.scalar_type() == parameter.scalar_type();
+        });
+    if (buffer == flat_buffers.end()) {
+      flat_buffers.emplace_back();
+      numels.push_back(0);
+      buffer = std::prev(flat_buffers.end());
+    }
+    buffer->parameters.push_back(parameter);
+    numels[buffer - flat_buffers.begin()] += parameter.numel();
+  }
+
+  for (size_t i = 0; i < flat_buffers.size(); ++i) {
+    auto& flat = flat_buffers[i];
+    const auto options = flat.parameters.front().options();
+    flat.data = torch::empty({numels[i]}, options);
+    flat.grad = torch::zeros({numels[i]}, options);
+    int64_t offset = 0;
+    for (auto& parameter : flat.parameters) {
+      const int64_t numel = parameter.numel();
+      auto data = flat.data.narrow(0, offset, numel).view(parameter.sizes());
+      data.copy_(parameter);
+      parameter.set_data(data);
+      if (parameter.requires_grad()) {
+        auto grad = flat.grad.narrow(0, offset, numel).view(parameter.sizes());
+        if (parameter.grad().defined()) {
+          // Unlike copy_, add_ also takes sparse gradients.
+          grad.add_(parameter.grad());
+        }
+        parameter.grad() = grad;
+      }
+      offset += numel;
+    }
+  }
+  return flat_buffers;
+}
+
 void Module::save(serialize::OutputArchive& archive) const {
   for (const auto& parameter : named_parameters(/*recurse=*/false)) {
     archive.write(parameter.key(), parameter.value());
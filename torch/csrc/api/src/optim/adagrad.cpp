@@ -8,6 +8,7 @@
 #include <ATen/ATen.h>
 
 #include <functional>
+#include <vector>
 
 namespace torch {
 namespace optim {
@@ -63,6 +64,12 @@ Tensor Adagrad::step(LossClosure closure) {
     loss = closure();
   }
   for (auto& group : param_groups_) {
+    auto& options = static_cast<AdagradOptions&>(group.options());
+    // The parameters with dense gradients, updated by one fused step
+    std::vector<Tensor> params;
+    std::vector<Tensor> grads;
+    std::vector<Tensor> state_sums;
+    std::vector<int64_t> steps;
     for (auto& p : group.params()) {
       if (!p.grad().defined()) {
         continue;
@@ -70,18 +77,27 @@ Tensor Adagrad::step(LossClosure closure) {
       auto grad = p.grad();
       TORCH_INTERNAL_ASSERT(state_[c10::guts::to_string(p.unsafeGetTensorImpl())] != nullptr, "state found NULL for the Tensor ", p);
       auto& state = static_cast<AdagradParamState&>(*state_[c10::guts::to_string(p.unsafeGetTensorImpl())]);
-      auto& options = static_cast<AdagradOptions&>(group.options());
 
       state.step(state.step() + 1);
 
-      if (options.weight_decay() != 0) {
-        TORCH_CHECK(!p.grad().is_sparse(), "weight_decay option is not compatible with sparse gradients");
-        grad = grad.add(p, options.weight_decay());
+      if (!grad.is_sparse()) {
+        params.push_back(p);
+        grads.push_back(grad);
+        state_sums.push_back(state.sum());
+        steps.push_back(state.step());
+        continue;
       }
+
+      TORCH_CHECK(options.weight_decay() == 0, "weight_decay option is not compatible with sparse gradients");
       const auto clr = options.lr() /
           (1 + static_cast<double>(state.step() - 1) * options.lr_decay());
 
-      if (grad.is_sparse()) {
+      if (detail::is_fused_sparse_row_update(p, grad) &&
+          state.sum().is_contiguous()) {
+        // updates the rows in the gradient in place, without coalescing it
+        at::_fused_sparse_adagrad_(
+            p, state.sum(), grad._indices()[0], grad._values(), clr, options.eps());
+      } else {
         grad = grad.coalesce();
         auto grad_indices = grad._indices();
         auto grad_values = grad._values();
@@ -99,10 +115,21 @@ Tensor Adagrad::step(LossClosure closure) {
 
         p.add_(make_sparse(grad_values / std_values), -clr);
       }
-      else {
-        state.sum(state.sum().addcmul_(grad, grad, 1.0));
-        const auto std = state.sum().sqrt().add_(options.eps());
-        p.addcdiv_(grad, std, -clr);
+    }
+    if (!params.empty()) {
+      at::_fused_adagrad_(
+          params,
+          grads,
+          state_sums,
+          steps,
+          options.lr(),
+          options.lr_decay(),
+          options.weight_decay(),
+          options.eps());
+      // Unlike the in-place ops it replaces, the fused op does not bump the
+      // version counters of the parameters it updates.
+      for (auto& p : params) {
+        torch::autograd::impl::bump_version(p);
       }
     }
   }
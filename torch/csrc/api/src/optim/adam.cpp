@@ -9,6 +9,7 @@
 
 #include <cmath>
 #include <functional>
+#include <vector>
 
 namespace torch {
 namespace optim {
@@ -69,6 +70,13 @@ Tensor Adam::step(LossClosure closure)  {
     loss = closure();
   }
   for (auto& group : param_groups_) {
+    auto& options = static_cast<AdamOptions&>(group.options());
+    std::vector<Tensor> params;
+    std::vector<Tensor> grads;
+    std::vector<Tensor> exp_avgs;
+    std::vector<Tensor> exp_avg_sqs;
+    std::vector<Tensor> max_exp_avg_sqs;
+    std::vector<int64_t> steps;
     for (auto& p : group.params()) {
       if (!p.grad().defined()) {
         continue;
@@ -76,7 +84,6 @@ Tensor Adam::step(LossClosure closure)  {
       auto grad = p.grad();
       TORCH_CHECK(!grad.is_sparse(), "Adam does not support sparse gradients"/*, please consider SparseAdam instead*/);
       auto param_state = state_.find(c10::guts::to_string(p.unsafeGetTensorImpl()));
-      auto& options = static_cast<AdamOptions&>(group.options());
 
       // State initialization
       if(param_state == state_.end()) {
@@ -94,37 +101,40 @@ Tensor Adam::step(LossClosure closure)  {
       }
 
       auto& state = static_cast<AdamParamState&>(*state_[c10::guts::to_string(p.unsafeGetTensorImpl())]);
-      auto& exp_avg = state.exp_avg();
-      auto& exp_avg_sq = state.exp_avg_sq();
-      auto& max_exp_avg_sq = state.max_exp_avg_sq();
-
       state.step(state.step()+1);
-      auto beta1 = std::get<0>(options.betas());
-      auto beta2 = std::get<1>(options.betas());
-
-      auto bias_correction1 = 1 - std::pow(beta1, state.step());
-      auto bias_correction2 = 1 - std::pow(beta2, state.step());
-
-      if(options.weight_decay() != 0) {
-        grad = grad.add(p, options.weight_decay());
-      }
 
-      // Decay the first and second moment running average coefficient
-      exp_avg.mul_(beta1).add_(grad, 1 - beta1);
-      exp_avg_sq.mul_(beta2).addcmul_(grad, grad, 1 - beta2);
-
-      Tensor denom;
+      params.push_back(p);
+      grads.push_back(grad);
+      exp_avgs.push_back(state.exp_avg());
+      exp_avg_sqs.push_back(state.exp_avg_sq());
       if(options.amsgrad()) {
-        // Maintains the maximum of all 2nd moment running avg. till now
-        torch::max_out(max_exp_avg_sq, exp_avg_sq, max_exp_avg_sq);
-        // Use the max. for normalizing running avg. of gradient
-        denom = (max_exp_avg_sq.sqrt() / sqrt(bias_correction2)).add_(options.eps());
-      } else {
-        denom = (exp_avg_sq.sqrt() / sqrt(bias_correction2)).add_(options.eps());
+        max_exp_avg_sqs.push_back(state.max_exp_avg_sq());
       }
+      steps.push_back(state.step());
+    }
+    if (params.empty()) {
+      continue;
+    }
 
-      auto step_size = options.lr() / bias_correction1;
-      p.addcdiv_(exp_avg, denom, -step_size);
+    // The update of all the parameters of the group, with the moving averages
+    // (and their maximum with amsgrad) updated in place.
+    at::_fused_adam_(
+        params,
+        grads,
+        exp_avgs,
+        exp_avg_sqs,
+        max_exp_avg_sqs,
+        steps,
+        options.lr(),
+        std::get<0>(options.betas()),
+        std::get<1>(options.betas()),
+        options.weight_decay(),
+        options.eps(),
+        options.amsgrad());
+    // Unlike the in-place ops it replaces, the fused op does not bump the
+    // version counters of the parameters it updates.
+    for (auto& p : params) {
+      torch::autograd::impl::bump_version(p);
     }
   }
   return loss;
@@ -156,6 +156,14 @@ const ska::flat_hash_map<std::string, std::unique_ptr<OptimizerParamState>>& Opt
 void Optimizer::save(serialize::OutputArchive& archive) const {}
 void Optimizer::load(serialize::InputArchive& archive) {}
 
+namespace detail {
+bool is_fused_sparse_row_update(const Tensor& param, const Tensor& grad) {
+  return grad.is_sparse() && grad.device().is_cpu() && param.dim() == 2 &&
+      param.is_contiguous() && grad.sparse_dim() == 1 &&
+      grad.dense_dim() == 1 && grad.scalar_type() == param.scalar_type();
+}
+} // namespace detail
+
 /// Serializes an `Optimizer` into an `OutputArchive`.
 serialize::OutputArchive& operator<<(
     serialize::OutputArchive& archive,
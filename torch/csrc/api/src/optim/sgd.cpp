@@ -10,6 +10,7 @@
 #include <ATen/ATen.h>
 
 #include <functional>
+#include <vector>
 
 namespace torch {
 namespace optim {
@@ -66,17 +67,38 @@ Tensor SGD::step(LossClosure closure)  {
     auto dampening = options.dampening();
     auto nesterov = options.nesterov();
 
+    // Dense gradients of parameters whose momentum buffer (if any) exists are
+    // applied by a single fused step for the group.
+    std::vector<Tensor> params;
+    std::vector<Tensor> grads;
+    std::vector<Tensor> momentum_buffers;
     for (auto& p : group.params()) {
       if (!p.grad().defined()) {
         continue;
       }
       auto d_p = p.grad().data();
+      if (weight_decay == 0 && momentum == 0 &&
+          detail::is_fused_sparse_row_update(p, d_p)) {
+        // updates the rows in the gradient in place, without coalescing it
+        at::_fused_sparse_sgd_(
+            p, d_p._indices()[0], d_p._values(), options.lr());
+        continue;
+      }
+      auto param_state = state_.find(c10::guts::to_string(p.unsafeGetTensorImpl()));
+      if (!d_p.is_sparse() && (momentum == 0 || param_state != state_.end())) {
+        params.push_back(p);
+        grads.push_back(d_p);
+        if (momentum != 0) {
+          momentum_buffers.push_back(
+              static_cast<SGDParamState&>(*param_state->second).momentum_buffer());
+        }
+        continue;
+      }
       if (weight_decay != 0) {
         d_p = d_p.add(p.data(), weight_decay);
       }
       if (momentum != 0) {
         Tensor buf;
-        auto param_state = state_.find(c10::guts::to_string(p.unsafeGetTensorImpl()));
         if(param_state == state_.end()) {
           buf = torch::clone(d_p).detach();
           auto state = std::make_unique<SGDParamState>();
@@ -94,6 +116,22 @@ Tensor SGD::step(LossClosure closure)  {
       }
       p.data().add_(d_p, -1 * options.lr());
     }
+    if (!params.empty()) {
+      at::_fused_sgd_(
+          params,
+          grads,
+          momentum_buffers,
+          options.lr(),
+          momentum,
+          dampening,
+          weight_decay,
+          nesterov);
+      // Unlike the in-place ops it replaces, the fused op does not bump the
+      // version counters of the parameters it updates.
+      for (auto& p : params) {
+        torch::autograd::impl::bump_version(p);
+      }
+    }
   }
   return loss;
 }
@@ -211,6 +211,7 @@ Tensor & copy_(Tensor & self, const Tensor & src, bool non_blocking) {
   // it automatically
   auto& self_ = unpack(self, "self", 0);
   auto& src_ = unpack(src, "src", 1);
+  check_writeable(self);
   check_inplace(self);
   std::shared_ptr<CopyBackwards> grad_fn;
   auto requires_grad = compute_requires_grad(self, src);
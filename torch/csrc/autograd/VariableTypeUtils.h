@@ -55,6 +55,15 @@ inline void check_inplace(const Tensor& tensor) {
   }
 }
 
+inline void check_writeable(const Tensor& tensor) {
+  if (tensor.defined() && tensor.has_storage() && tensor.storage().read_only()) {
+    AT_ERROR(
+      "a read-only tensor, e.g. one sharing the memory of a non-writeable NumPy "
+      "array, is being written to by an in-place or out= operation. Use "
+      "tensor.clone() to get a writeable copy.");
+  }
+}
+
 inline void throw_error_out_requires_grad(const char* name) {
   AT_ERROR(
       name, "(): functions with out=... arguments don't support automatic differentiation, "
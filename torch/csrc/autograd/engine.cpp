@@ -155,6 +155,26 @@ static thread_local std::shared_ptr<ReadyQueue> local_ready_queue = nullptr;
 // the leaf streams with the default streams is sufficient to implement
 // the historic behavior.
 
+// Note [Multithreaded CPU backward]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// By default, the thread that calls backward() runs all the CPU nodes of the
+// graph itself. With Engine::set_num_cpu_threads(n), n > 1, a backward call
+// started on a thread that is not an autograd thread also hands its GraphTask
+// to n - 1 threads of the reentrant thread pool, see Note [Reentrant
+// backwards]. Like the calling thread, they all pop tasks from the
+// GraphTask's cpu_ready_queue_ until its outstanding_tasks_ drops to zero,
+// so independent branches of the graph run in parallel. Dependencies are
+// still tracked through dependencies_ and not_ready_ under the GraphTask's
+// mutex_, so nodes run once all their inputs are ready, exactly as before;
+// nodes must therefore be safe to run concurrently with other nodes, as they
+// already are with respect to the device threads.
+//
+// The thread that runs the last task wakes up the other ones, which may be
+// sleeping in ReadyQueue::pop(), by pushing an empty task for each of them.
+// A reentrant backward called from one of these threads gets a CPU ready
+// queue of its own, so that the other threads never see its tasks and it is
+// run as usual by the thread that called it.
+
 int NodeTask::getReentrantDepth() const {
   std::shared_ptr<GraphTask> graph_task = base_.lock();
   if (graph_task) {
@@ -168,11 +188,14 @@ int NodeTask::getReentrantDepth() const {
 }
 
 auto ReadyQueue::push(NodeTask item, bool incrementOutstandingTasks) -> void {
+  std::shared_ptr<GraphTask> graph_task = item.base_.lock();
+  if (graph_task && graph_task->priority_fn_ && item.fn_) {
+    item.priority_ = (*graph_task->priority_fn_)(*item.fn_);
+  }
   {
     // Lock mutex for writing to heap_
     std::lock_guard<std::mutex> lock(mutex_);
     if (incrementOutstandingTasks) {
-      std::shared_ptr<GraphTask> graph_task = item.base_.lock();
       TORCH_INTERNAL_ASSERT(graph_task, "GraphTask is no longer valid!");
       ++graph_task->outstanding_tasks_;
     }
@@ -242,6 +265,30 @@ void Engine::release_workers() {
   non_reentrant_device_thread_finish_.notify_one();
 }
 
+void Engine::set_node_task_priority_fn(NodeTaskPriorityFn fn) {
+  std::lock_guard<std::mutex> lock(node_task_priority_fn_lock_);
+  if (fn) {
+    node_task_priority_fn_ =
+        std::make_shared<const NodeTaskPriorityFn>(std::move(fn));
+  } else {
+    node_task_priority_fn_ = nullptr;
+  }
+}
+
+std::shared_ptr<const NodeTaskPriorityFn> Engine::node_task_priority_fn() {
+  std::lock_guard<std::mutex> lock(node_task_priority_fn_lock_);
+  return node_task_priority_fn_;
+}
+
+void Engine::set_num_cpu_threads(int num_threads) {
+  TORCH_CHECK(num_threads > 0, "Expected a positive number of threads");
+  num_cpu_threads_.store(num_threads);
+}
+
+int Engine::num_cpu_threads() const {
+  return num_cpu_threads_.load();
+}
+
 auto Engine::thread_init(int device, const std::shared_ptr<ReadyQueue>& ready_queue) -> void {
   at::init_num_threads();
   // thread_init should only be called by device threads other than CPU_DEVICE
@@ -280,6 +327,23 @@ auto Engine::thread_init(int device, const std::shared_ptr<ReadyQueue>& ready_qu
   }
 }
 
+// The guard that replaces local_ready_queue and restores it on exit.
+struct LocalReadyQueueGuard {
+  void replace(std::shared_ptr<ReadyQueue> ready_queue) {
+    last_ready_queue_ = std::move(local_ready_queue);
+    local_ready_queue = std::move(ready_queue);
+    replaced_ = true;
+  }
+  ~LocalReadyQueueGuard() {
+    if (replaced_) {
+      local_ready_queue = std::move(last_ready_queue_);
+    }
+  }
+
+  std::shared_ptr<ReadyQueue> last_ready_queue_;
+  bool replaced_ = false;
+};
+
 // The guard that sets and restores current_graph_task.
 struct GraphTaskGuard {
   GraphTaskGuard(std::shared_ptr<GraphTask> graph_task) {
@@ -387,6 +451,14 @@ auto Engine::thread_main(
       // that we're done, we need to break out of the worker loop so we can
       // continue executing the rest of the calling code!
       if (worker_device == CPU_DEVICE) {
+        // Other threads running the CPU tasks of the graph_task may be
+        // sleeping on pop(); wake them up so they see it is done.
+        // See Note [Multithreaded CPU backward]
+        for (int i = 0; i < local_graph_task->num_cpu_workers_; ++i) {
+          local_graph_task->cpu_ready_queue_->push(
+              NodeTask({}, nullptr, InputBuffer(0)),
+              /* incrementOutstandingTasks */ false);
+        }
         break;
       }
 
@@ -857,11 +929,21 @@ auto Engine::execute(const edge_list& roots,
   init_local_ready_queue();
   bool not_reentrant_backward_call = worker_device == NO_DEVICE;
 
+  // A reentrant backward called from one of the threads running a
+  // multithreaded CPU backward gets a CPU ready queue of its own.
+  // See Note [Multithreaded CPU backward]
+  LocalReadyQueueGuard queue_guard;
+  if (worker_device == CPU_DEVICE && current_graph_task &&
+      current_graph_task->num_cpu_workers_ > 0) {
+    queue_guard.replace(std::make_shared<ReadyQueue>());
+  }
+
   auto graph_task = std::make_shared<GraphTask>(
       /* keep_graph */ keep_graph,
       /* create_graph */ create_graph,
       /* depth */ not_reentrant_backward_call ? 0 : total_depth + 1,
       /* cpu_ready_queue */ local_ready_queue);
+  graph_task->priority_fn_ = node_task_priority_fn();
 
   // Now compute the dependencies for all executable functions and queue the root
   auto graph_root = std::make_shared<GraphRoot>(roots, inputs);
@@ -903,10 +985,24 @@ std::shared_ptr<FutureVariableList> Engine::execute_with_graph_task(
     // set the graph_task owner to the current device
     graph_task->owner_ = worker_device;
 
-    // The owning thread start to drive the engine execution with the GraphTask
-    // that has already been pushed to the current CPU thread's ready_queue
-    lock.unlock();
-    thread_main(nullptr, false);
+    const int num_cpu_workers = num_cpu_threads_.load() - 1;
+    if (num_cpu_workers > 0) {
+      // Let threads of the pool help with the CPU tasks of this graph_task.
+      // See Note [Multithreaded CPU backward]
+      graph_task->num_cpu_workers_ = num_cpu_workers;
+      lock.unlock();
+      for (int i = 0; i < num_cpu_workers; ++i) {
+        add_thread_pool_task(graph_task);
+      }
+      thread_main(graph_task, /* reentrant_thread */ true);
+      // The thread that ran the last task may still be post processing.
+      graph_task->mark_as_completed_and_run_post_processing();
+    } else {
+      // The owning thread start to drive the engine execution with the GraphTask
+      // that has already been pushed to the current CPU thread's ready_queue
+      lock.unlock();
+      thread_main(nullptr, false);
+    }
     TORCH_INTERNAL_ASSERT(graph_task->future_result_->completed());
     // reset the worker_device after the completion of the graph_task, this is so
     // that the initial state of the engine remains the same across every backward()
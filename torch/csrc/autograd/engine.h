@@ -30,6 +30,12 @@ namespace torch { namespace autograd {
 
 using FutureVariableList = torch::utils::Future<variable_list>;
 
+// Returns the scheduling priority of a backward node that is ready to run.
+// Among the ready nodes of a queue, the ones with the highest priority run
+// first; nodes of equal priority run in decreasing sequence number order.
+// See Engine::set_node_task_priority_fn.
+using NodeTaskPriorityFn = std::function<int64_t(const Node&)>;
+
 static constexpr int NO_DEVICE = -2;
 static constexpr int CPU_DEVICE = -1;
 
@@ -161,6 +167,15 @@ struct GraphTask: std::enable_shared_from_this<GraphTask> {
   // mutex_ as the two are protecting different data structures.
   std::mutex final_callbacks_lock_;
 
+  // The engine's priority function when this GraphTask was created, or
+  // nullptr for the default order. Safe to read without synchronization.
+  std::shared_ptr<const NodeTaskPriorityFn> priority_fn_;
+
+  // The number of threads, besides the owning thread, that run the tasks in
+  // cpu_ready_queue_. See Note [Multithreaded CPU backward]. Safe to read
+  // without synchronization.
+  int num_cpu_workers_ = 0;
+
   GraphTask(
       bool keep_graph,
       bool grad_mode,
@@ -189,6 +204,8 @@ struct NodeTask {
   // When worker receives a task with isShutdownTask = true, it will immediately
   // exit. The engine sends a shutdown task to every queue upon its destruction.
   bool isShutdownTask_;
+  // Computed by ReadyQueue::push() from the GraphTask's priority_fn_.
+  int64_t priority_ = 0;
 
   int getReentrantDepth() const;
 
@@ -207,7 +224,8 @@ struct NodeTask {
 struct ReadyQueue {
  private:
   // Returns true when t2 should be (weakly) BEFORE t1 in the queue.
-  // Shutdown tasks are first and then empty NodeTask are next.
+  // Shutdown tasks are first and then empty NodeTask are next. The others are
+  // ordered by reentrant depth, then priority, then sequence number.
   struct CompareNodeTaskTime {
     bool operator()(NodeTask const & t1, NodeTask const & t2) {
       if (t2.isShutdownTask_) {
@@ -217,6 +235,9 @@ struct ReadyQueue {
       } else if (!t2.fn_) {
         return true;
       } else if (t1.getReentrantDepth() == t2.getReentrantDepth()) {
+        if (t1.priority_ != t2.priority_) {
+          return t1.priority_ < t2.priority_;
+        }
         return t1.fn_->sequence_nr() < t2.fn_->sequence_nr();
       } else {
         return t1.getReentrantDepth() < t2.getReentrantDepth();
@@ -300,6 +321,19 @@ struct TORCH_API Engine {
   // Should be called after fork to notify that worker threads are gone
   void release_workers();
 
+  // Sets the function that orders the ready nodes of GraphTasks created
+  // from now on, e.g. to run the nodes whose gradients unblock communication
+  // first. Passing nullptr restores the default order. The function may be
+  // called concurrently from several threads and must not throw.
+  void set_node_task_priority_fn(NodeTaskPriorityFn fn);
+  std::shared_ptr<const NodeTaskPriorityFn> node_task_priority_fn();
+
+  // Sets the number of threads, including the calling thread, that run the
+  // CPU nodes of backward calls started from now on. The default of 1 runs
+  // them all on the calling thread. See Note [Multithreaded CPU backward].
+  void set_num_cpu_threads(int num_threads);
+  int num_cpu_threads() const;
+
  protected:
   Engine();
   void compute_dependencies(Node* root, GraphTask& task);
@@ -337,6 +371,12 @@ struct TORCH_API Engine {
   // How many nested reentrant calls are allowed until a new thread is used
   int max_recursion_depth_;
 
+  std::shared_ptr<const NodeTaskPriorityFn> node_task_priority_fn_;
+  // To protect reads and writes to node_task_priority_fn_
+  std::mutex node_task_priority_fn_lock_;
+
+  std::atomic<int> num_cpu_threads_{1};
+
   struct ThreadPoolShared {
     // Data structures used by the threads for executing reentrant backwards
     // tasks. See Note [Reentrant backwards]
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <torch/csrc/autograd/function.h>
+#include <torch/csrc/autograd/profiler.h>
 #include <torch/csrc/autograd/variable.h>
 #include <torch/csrc/WindowsTorchApiMacro.h>
 
@@ -36,6 +37,9 @@ struct TORCH_API AccumulateGrad : public Node {
   // update_grad: Function that is used to update grad for the variable.
   //              The argument to the function is a Tensor which
   //              is used to set a new value for the grad.
+  //
+  // Whether new_grad was stolen, summed in place or copied is reported to the
+  // profiler, see profiler::recordGradAccumulation.
   template <typename T>
   static void accumulateGrad(
       const Variable& variable,
@@ -43,20 +47,23 @@ struct TORCH_API AccumulateGrad : public Node {
       const at::Tensor& new_grad,
       size_t num_expected_refs,
       const T& update_grad) {
+    using profiler::GradAccumulation;
+    using profiler::recordGradAccumulation;
     if (!variable_grad.defined()) {
       // under following condition, we can avoid clone()
       if (!GradMode::is_enabled() && !new_grad.is_sparse() &&
-          new_grad.is_contiguous() &&
+          hasStealableLayout(variable, new_grad) &&
           new_grad.use_count() <= num_expected_refs) {
         // first check it is in first-order grad only mode
-        // then check not sparse before is_contiguous
-        // then check contiguous, otherwise later in place accumulation may fail
+        // then check not sparse before checking the layout
+        // then check the layout, otherwise later in place accumulation may fail
         // and lastly, check if the use_count is less than or equal to the
         // number of references we expect before grabbing it. The number of
         // references we expect is basically internal structures that are
         // holding references to the Tensor and that is fine since these are not
         // exposed to the user.
         update_grad(new_grad.detach());
+        recordGradAccumulation(GradAccumulation::Stolen);
       } else if (
           !GradMode::is_enabled() && new_grad.is_sparse() &&
           new_grad._indices().is_contiguous() &&
@@ -80,12 +87,14 @@ struct TORCH_API AccumulateGrad : public Node {
             new_grad._values(),
             new_grad.sizes(),
             new_grad.options()));
+        recordGradAccumulation(GradAccumulation::Stolen);
       } else {
         if (new_grad.is_sparse()) {
           update_grad(new_grad.clone());
         } else {
           update_grad(new_grad.clone(at::MemoryFormat::Contiguous));
         }
+        recordGradAccumulation(GradAccumulation::Copied);
       }
     } else if (!GradMode::is_enabled()) {
       // This case is not strictly necessary, but it makes the first-order only
@@ -97,6 +106,7 @@ struct TORCH_API AccumulateGrad : public Node {
         // TensorImpl type of a tensor requires changing the tensor itself, and
         // thus in this case we have to change the grad tensor.
         update_grad(new_grad + variable_grad);
+        recordGradAccumulation(GradAccumulation::Copied);
       } else {
         // In this case we can avoid changing the grad tensor. There are three
         // scenarios when we'll hit this case:
@@ -109,11 +119,32 @@ struct TORCH_API AccumulateGrad : public Node {
         // valid operation which adds `new_grad` to `variable_grad` in
         // place. `variable_grad` is thus still referring to the same tensor
         // after the operation.
+        //
+        // This includes a `variable_grad` that is a view of a DDP bucket
+        // (see `gradient_as_bucket_view` of the reducer), in which case the
+        // sum is written straight into the bucket.
         variable_grad += new_grad;
+        recordGradAccumulation(GradAccumulation::InPlace);
       }
     } else {
       update_grad(variable_grad + new_grad);
+      recordGradAccumulation(GradAccumulation::Copied);
+    }
+  }
+
+  // A dense gradient can become the grad of `variable` as is if it is
+  // contiguous, or if it is laid out in memory exactly like the variable
+  // (e.g. both are channels last). Anything else is cloned, so that `.grad`
+  // never overlaps and never has gaps.
+  static bool hasStealableLayout(
+      const Variable& variable,
+      const at::Tensor& new_grad) {
+    if (new_grad.is_contiguous()) {
+      return true;
     }
+    return new_grad.is_non_overlapping_and_dense() &&
+        variable.is_non_overlapping_and_dense() &&
+        new_grad.strides() == variable.strides();
   }
 
   Variable variable;
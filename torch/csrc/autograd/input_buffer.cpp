@@ -1,5 +1,8 @@
 #include <torch/csrc/autograd/input_buffer.h>
 
+#include <torch/csrc/autograd/grad_mode.h>
+#include <torch/csrc/autograd/profiler.h>
+
 #include <c10/core/DeviceGuard.h>
 #include <c10/core/StreamGuard.h>
 #include <c10/core/Event.h>
@@ -11,25 +14,46 @@
 
 namespace torch { namespace autograd {
 
+  // Whether the sum of two gradients can be written into the dense gradient
+  // `var`. Nothing but the buffer may refer to it or to its memory, and its
+  // elements must not overlap.
+  static bool can_accumulate_inplace(const Variable& var) {
+    return !var.is_sparse() && var.has_storage() &&
+        var.is_non_overlapping_and_dense() && var.use_count() == 1 &&
+        //storage use_count is a big hammer, but for anything lighter there's an adversarial example with unexpected inplace modification
+        var.storage().use_count() == 1 &&
+        // an in-place op would be recorded in the graph of a higher order grad
+        !(GradMode::is_enabled() && var.requires_grad());
+  }
+
   static void accumulate(std::vector<Variable>& buffer,
                          const size_t pos,
                          Variable&& var) {
+    using profiler::GradAccumulation;
     TORCH_INTERNAL_ASSERT(pos < buffer.size());
     auto& old_var = buffer[pos];
     // ATen doesn't route sparse additions correctly...
     // do dense + sparse in-place if possible
     if (old_var.is_sparse()) {
-      //storage use_count is a big hammer, but for anything lighter there's an adversarial example with unexpected inplace modification
-      if (!var.is_sparse() && var.is_contiguous() && var.storage().use_count() == 1) {
+      if (can_accumulate_inplace(var)) {
           buffer[pos] = var.add_(old_var);
+          profiler::recordGradAccumulation(GradAccumulation::InPlace);
       } else {
           buffer[pos] = var + old_var;
+          profiler::recordGradAccumulation(GradAccumulation::Copied);
       }
     } else {
-      if (var.is_sparse() && !old_var.is_sparse() && old_var.is_contiguous() && old_var.storage().use_count() == 1) {
-          buffer[pos] = old_var.add_(var);
+      // Gradients of tensors used several times are summed here; reuse
+      // either of the two buffers when it is exclusively owned.
+      if (can_accumulate_inplace(old_var)) {
+          old_var.add_(var);
+          profiler::recordGradAccumulation(GradAccumulation::InPlace);
+      } else if (can_accumulate_inplace(var)) {
+          buffer[pos] = var.add_(old_var);
+          profiler::recordGradAccumulation(GradAccumulation::InPlace);
       } else {
           buffer[pos] = old_var + var;
+          profiler::recordGradAccumulation(GradAccumulation::Copied);
       }
     }
   }
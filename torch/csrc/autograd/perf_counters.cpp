@@ -0,0 +1,133 @@
+#include <torch/csrc/autograd/perf_counters.h>
+
+#include <c10/util/Exception.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace torch { namespace autograd { namespace profiler {
+
+#if defined(__linux__)
+
+namespace {
+
+struct PerfEventDesc {
+  const char* name;
+  uint64_t config;
+};
+
+constexpr PerfEventDesc kPerfEvents[] = {
+    {"cycles", PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_COUNT_HW_INSTRUCTIONS},
+    {"cache_references", PERF_COUNT_HW_CACHE_REFERENCES},
+    {"cache_misses", PERF_COUNT_HW_CACHE_MISSES},
+    {"branches", PERF_COUNT_HW_BRANCH_INSTRUCTIONS},
+    {"branch_misses", PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+uint64_t eventConfig(const std::string& name) {
+  for (const auto& desc : kPerfEvents) {
+    if (name == desc.name) {
+      return desc.config;
+    }
+  }
+  TORCH_CHECK(false, "Unknown perf event: ", name);
+}
+
+int perfEventOpen(perf_event_attr* attr, int group_fd) {
+  // pid 0 and cpu -1: the calling thread, on any cpu
+  return static_cast<int>(
+      syscall(__NR_perf_event_open, attr, 0, -1, group_fd, 0));
+}
+
+} // namespace
+
+void PerfCounterGroup::open(const std::vector<std::string>& events) {
+  TORCH_CHECK(!isOpen(), "Perf counters are already open");
+  for (const auto& name : events) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = eventConfig(name);
+    attr.disabled = fds_.empty() ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    const int fd = perfEventOpen(&attr, fds_.empty() ? -1 : fds_.front());
+    if (fd < 0) {
+      const int err = errno;
+      close();
+      TORCH_CHECK(
+          false,
+          "perf_event_open failed for ",
+          name,
+          ": ",
+          std::strerror(err),
+          " (check /proc/sys/kernel/perf_event_paranoid)");
+    }
+    fds_.push_back(fd);
+  }
+  if (isOpen()) {
+    ioctl(fds_.front(), PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(fds_.front(), PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+}
+
+void PerfCounterGroup::close() {
+  for (int fd : fds_) {
+    ::close(fd);
+  }
+  fds_.clear();
+}
+
+std::vector<uint64_t> PerfCounterGroup::read() const {
+  if (!isOpen()) {
+    return {};
+  }
+  // PERF_FORMAT_GROUP layout: the number of counters, then their values
+  std::vector<uint64_t> buf(fds_.size() + 1);
+  const auto size = static_cast<ssize_t>(buf.size() * sizeof(uint64_t));
+  if (::read(fds_.front(), buf.data(), size) != size ||
+      buf[0] != fds_.size()) {
+    return {};
+  }
+  buf.erase(buf.begin());
+  return buf;
+}
+
+bool perfCountersSupported() {
+  return true;
+}
+
+#else
+
+void PerfCounterGroup::open(const std::vector<std::string>& events) {
+  TORCH_CHECK(
+      events.empty(), "Perf counters are only supported on Linux");
+}
+
+void PerfCounterGroup::close() {}
+
+std::vector<uint64_t> PerfCounterGroup::read() const {
+  return {};
+}
+
+bool perfCountersSupported() {
+  return false;
+}
+
+#endif
+
+PerfCounterGroup::~PerfCounterGroup() {
+  close();
+}
+
+}}} // namespace torch::autograd::profiler
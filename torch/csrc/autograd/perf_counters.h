@@ -0,0 +1,48 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace torch { namespace autograd { namespace profiler {
+
+// A group of hardware performance counters of the calling thread, read
+// through Linux perf_event_open. Supported event names are:
+//
+//   cycles, instructions, cache_references, cache_misses (last level cache),
+//   branches, branch_misses
+//
+// The counters only count user space and are scheduled onto the PMU as a
+// group, so they are always read consistently with each other.
+class TORCH_API PerfCounterGroup {
+ public:
+  PerfCounterGroup() = default;
+  ~PerfCounterGroup();
+
+  PerfCounterGroup(const PerfCounterGroup&) = delete;
+  PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+  // Opens and starts the counters. Throws if an event name is unknown or if
+  // the kernel refuses to open a counter (e.g. because of
+  // /proc/sys/kernel/perf_event_paranoid).
+  void open(const std::vector<std::string>& events);
+  void close();
+
+  bool isOpen() const {
+    return !fds_.empty();
+  }
+
+  // Current values of the counters, in the order they were opened. Returns
+  // an empty vector if the group isn't open or can't be read.
+  std::vector<uint64_t> read() const;
+
+ private:
+  std::vector<int> fds_;
+};
+
+// Whether perf_event_open is available on this platform.
+TORCH_API bool perfCountersSupported();
+
+}}} // namespace torch::autograd::profiler
@@ -1,5 +1,6 @@
 #include <torch/csrc/autograd/profiler.h>
 #include <torch/csrc/autograd/function.h>
+#include <torch/csrc/autograd/perf_counters.h>
 #include <torch/csrc/jit/frontend/code_template.h>
 
 #include <torch/csrc/jit/runtime/operator.h>
@@ -36,6 +37,44 @@ thread_local uint16_t thread_id;
 // enable/disableProfiler are tied to the code range
 thread_local std::vector<std::shared_ptr<RecordFunctionGuard>> g_;
 
+// ProfilerConfig::perf_events of the current session
+std::vector<std::string> perf_events;
+// bumped on every enable, to reopen the counters of the previous session
+uint64_t perf_session = 0;
+
+struct ThreadPerfCounters {
+  uint64_t session = 0;
+  PerfCounterGroup group;
+};
+
+// Counters are opened lazily on every thread that records a range. A thread
+// that can't open them records its ranges without counters.
+PerfCounterGroup& threadPerfCounters(bool throw_on_error = false) {
+  static thread_local ThreadPerfCounters counters;
+  if (counters.session != perf_session) {
+    counters.group.close();
+    counters.session = perf_session;
+    try {
+      counters.group.open(perf_events);
+    } catch (const c10::Error& e) {
+      if (throw_on_error) {
+        throw;
+      }
+      LOG(WARNING) << "Not recording perf counters on thread "
+                   << RecordFunction::currentThreadId() << ": "
+                   << e.what_without_backtrace();
+    }
+  }
+  return counters.group;
+}
+
+std::vector<uint64_t> readPerfCounters() {
+  if (perf_events.empty()) {
+    return {};
+  }
+  return threadPerfCounters().read();
+}
+
 } // namespace
 
 void registerCUDAMethods(CUDAStubs* stubs) {
@@ -69,6 +108,65 @@ void mark(std::string name, bool include_cuda /* = true */) {
   }
 }
 
+void recordGradAccumulation(GradAccumulation kind) {
+  if (state == ProfilerState::Disabled) {
+    return;
+  }
+  switch (kind) {
+    case GradAccumulation::Stolen:
+      mark("grad_accumulation::stolen", false);
+      break;
+    case GradAccumulation::InPlace:
+      mark("grad_accumulation::inplace", false);
+      break;
+    case GradAccumulation::Copied:
+      mark("grad_accumulation::copied", false);
+      break;
+  }
+}
+
+namespace {
+
+// Memory events are recorded on the list of the thread doing the allocation,
+// so they can be attributed to the ranges open on that thread.
+void recordMemoryUsage(int64_t alloc_size, c10::Device device) {
+  if (state == ProfilerState::Disabled || state == ProfilerState::NVTX) {
+    return;
+  }
+  int64_t cpu_memory_usage = 0;
+  int64_t cuda_memory_usage = 0;
+  if (device.is_cuda()) {
+    cuda_memory_usage = alloc_size;
+  } else if (device.is_cpu()) {
+    cpu_memory_usage = alloc_size;
+  } else {
+    return;
+  }
+  auto& event_list = getEventList();
+  event_list.record(
+      EventKind::MemoryAlloc,
+      StringView(""),
+      thread_id,
+      false,
+      std::vector<std::vector<int64_t>>(),
+      cpu_memory_usage,
+      cuda_memory_usage);
+}
+
+// Installed as the c10 memory reporter while memory profiling is enabled.
+struct ProfilerMemoryReporter final : public c10::MemoryReportingInfoBase {
+  void reportMemoryUsage(
+      void* /* unused */,
+      int64_t alloc_size,
+      c10::Device device) override {
+    recordMemoryUsage(alloc_size, device);
+  }
+};
+
+ProfilerMemoryReporter memory_reporter;
+
+} // namespace
+
 bool profilerEnabled() {
   return state != ProfilerState::Disabled;
 }
@@ -115,7 +213,10 @@ void pushRange(
         name,
         thread_id,
         state == ProfilerState::CUDA,
-        std::move(shapes));
+        std::move(shapes),
+        0,
+        0,
+        readPerfCounters());
   }
 }
 
@@ -126,11 +227,16 @@ void popRange() {
   if (state == ProfilerState::NVTX) {
     cuda_stubs->nvtxRangePop();
   } else {
+    auto perf_counters = readPerfCounters();
     getEventList().record(
         EventKind::PopRange,
         StringView(""),
         thread_id,
-        state == ProfilerState::CUDA);
+        state == ProfilerState::CUDA,
+        std::vector<std::vector<int64_t>>(),
+        0,
+        0,
+        std::move(perf_counters));
   }
 }
 
@@ -142,6 +248,20 @@ void enableProfiler(ProfilerConfig config) {
   if (state != ProfilerState::Disabled && new_state != state) {
     throw std::runtime_error("can't change kind of profiling (e.g. NVTX to CPU) while profiler is running");
   }
+  TORCH_CHECK(
+      config.perf_events.empty() || new_state != ProfilerState::NVTX,
+      "perf counters can't be recorded with the NVTX profiler");
+  perf_events = config.perf_events;
+  ++perf_session;
+  if (!perf_events.empty()) {
+    // fail early if the counters can't be opened at all
+    try {
+      threadPerfCounters(/* throw_on_error */ true);
+    } catch (...) {
+      perf_events.clear();
+      throw;
+    }
+  }
 
   pushCallback(
       [config](const RecordFunction& fn) {
@@ -202,6 +322,9 @@ void enableProfiler(ProfilerConfig config) {
       /* scopes */ {RecordScope::FUNCTION, RecordScope::USER_SCOPE});
   state = new_state;
   g_.emplace_back(std::make_shared<RecordFunctionGuard>());
+  if (config.profile_memory && state != ProfilerState::NVTX) {
+    c10::SetMemoryReporter(&memory_reporter);
+  }
 
   if(state == ProfilerState::CUDA) {
     // event recording appears to have some startup overhead, so we need to
@@ -231,7 +354,12 @@ thread_event_lists disableProfiler() {
   mark("__stop_profile");
 
   popCallback();
+  c10::SetMemoryReporter(nullptr);
   state = ProfilerState::Disabled;
+  if (!perf_events.empty()) {
+    threadPerfCounters().close();
+    perf_events.clear();
+  }
   TORCH_INTERNAL_ASSERT(!g_.empty());
   g_.pop_back();
 
@@ -101,17 +101,31 @@ enum class TORCH_API ProfilerState {
 };
 
 struct TORCH_API ProfilerConfig {
-  ProfilerConfig(ProfilerState state, bool report_input_shapes)
-      : state(state), report_input_shapes(report_input_shapes) {}
+  ProfilerConfig(
+      ProfilerState state,
+      bool report_input_shapes,
+      bool profile_memory = false,
+      std::vector<std::string> perf_events = {})
+      : state(state),
+        report_input_shapes(report_input_shapes),
+        profile_memory(profile_memory),
+        perf_events(std::move(perf_events)) {}
   ~ProfilerConfig();
   ProfilerState state;
   bool report_input_shapes;
+  // record an event for every allocation and free of the CPU and CUDA
+  // allocators (see c10::reportMemoryUsageToProfiler)
+  bool profile_memory;
+  // hardware counters to read at the start and end of every range, see
+  // PerfCounterGroup for the supported names
+  std::vector<std::string> perf_events;
 };
 
 enum class TORCH_API EventKind : uint16_t {
   Mark,
   PushRange,
-  PopRange
+  PopRange,
+  MemoryAlloc,
 };
 #ifndef _MSC_VER
 #  pragma GCC diagnostic pop
@@ -123,11 +137,17 @@ struct TORCH_API Event final {
       StringView name,
       uint16_t thread_id,
       bool record_cuda,
-      std::vector<std::vector<int64_t>>&& shapes = {})
+      std::vector<std::vector<int64_t>>&& shapes = {},
+      int64_t cpu_memory_usage = 0,
+      int64_t cuda_memory_usage = 0,
+      std::vector<uint64_t>&& perf_counters = {})
       : name_(std::move(name)),
         kind_(kind),
         thread_id_(thread_id),
-        shapes_(shapes) {
+        shapes_(shapes),
+        cpu_memory_usage_(cpu_memory_usage),
+        cuda_memory_usage_(cuda_memory_usage),
+        perf_counters_(std::move(perf_counters)) {
     record(record_cuda);
   }
 
@@ -137,6 +157,7 @@ struct TORCH_API Event final {
       case EventKind::Mark: return "mark";
       case EventKind::PushRange: return "push";
       case EventKind::PopRange: return "pop";
+      case EventKind::MemoryAlloc: return "memory_alloc";
     }
     throw std::runtime_error("unknown EventKind");
   }
@@ -159,6 +180,19 @@ struct TORCH_API Event final {
   int device() const {
     return device_;
   }
+  // For memory_alloc events, the number of bytes allocated (positive) or
+  // freed (negative).
+  int64_t cpu_memory_usage() const {
+    return cpu_memory_usage_;
+  }
+  int64_t cuda_memory_usage() const {
+    return cuda_memory_usage_;
+  }
+  // For push and pop events, the values of ProfilerConfig::perf_events when
+  // the event was recorded; empty if they couldn't be read on its thread.
+  const std::vector<uint64_t>& perf_counters() const {
+    return perf_counters_;
+  }
 private:
   // signed to allow for negative intervals, initialized for safety.
   int64_t cpu_ns_ = 0;
@@ -166,6 +200,9 @@ private:
   EventKind kind_;
   uint16_t thread_id_;
   std::vector<std::vector<int64_t>> shapes_;
+  int64_t cpu_memory_usage_ = 0;
+  int64_t cuda_memory_usage_ = 0;
+  std::vector<uint64_t> perf_counters_;
   int device_ = -1;
   struct CUevent_st* event = nullptr;
 };
@@ -229,6 +266,21 @@ struct RangeEventList {
 TORCH_API RangeEventList& getEventList();
 TORCH_API void mark(std::string name, bool include_cuda = true);
 
+// How the autograd engine produced the sum of two gradients, or the first
+// gradient of a leaf.
+enum class GradAccumulation : uint8_t {
+  // The incoming gradient was taken over without a copy.
+  Stolen,
+  // The sum was written into one of the existing buffers.
+  InPlace,
+  // A new buffer was allocated for the result.
+  Copied,
+};
+
+// Records a "grad_accumulation::<kind>" mark, which
+// torch.autograd.profiler.profile counts; a no-op when profiling is off.
+TORCH_API void recordGradAccumulation(GradAccumulation kind);
+
 using thread_event_lists = std::vector<std::vector<Event>>;
 // NOTE: changing profiler modes is **NOT THREAD SAFE**. You should ensure that
 // there no autograd functions are being executed when these function are used.
@@ -113,6 +113,7 @@ class CallbackManager {
 
  private:
   void recomputeFlags() {
+    detail::has_callbacks = !callbacks_.empty();
     has_callbacks_with_inputs_ = false;
     for (const auto& cb : callbacks_) {
       has_callbacks_with_inputs_ |= cb.needs_inputs_;
@@ -191,9 +192,9 @@ inline CallbackManager& manager() {
 
 } // namespace
 
-bool hasCallbacks() {
-  return manager().hasCallbacks();
-}
+namespace detail {
+bool has_callbacks = false;
+} // namespace detail
 
 void pushCallback(
     std::function<bool(const RecordFunction&)> start,
@@ -220,8 +220,16 @@ struct TORCH_API RecordFunction {
   uint64_t callbacks_version_ = 0;
 };
 
+namespace detail {
+// Whether there are callbacks registered with pushCallback, read inline so
+// that the RECORD_* macros cost a single branch when there are none
+TORCH_API extern bool has_callbacks;
+} // namespace detail
+
 // Returns whether there're callbacks registered with pushCallback
-TORCH_API bool hasCallbacks();
+inline bool hasCallbacks() {
+  return detail::has_callbacks;
+}
 
 // Internal only, do not use:
 // use C++ RECORD_* or python context manager record_function() instead;
@@ -236,15 +244,19 @@ TORCH_API void TEST_setGlobalSamplingProbability(double sampling_prob);
 TORCH_API void TEST_unsetGlobalSamplingProbability();
 
 // Using macro to minimize inputs copies,
-// optional argument - function's seq_no
+// optional argument - function's seq_no;
+// the RecordFunction is only constructed when there are callbacks
 #define RECORD_FUNCTION_WITH_SCOPE(scope, fn, inputs, ...) \
-  torch::autograd::profiler::RecordFunction guard(scope); \
-  if (guard._active()) { \
-    guard._setCurrent(); \
-    if (torch::autograd::profiler::RecordFunction::_needsInputs()) { \
-      guard._before(fn, inputs, ##__VA_ARGS__); \
-    } else { \
-      guard._before(fn, ##__VA_ARGS__); \
+  c10::optional<torch::autograd::profiler::RecordFunction> guard; \
+  if (C10_UNLIKELY(torch::autograd::profiler::hasCallbacks())) { \
+    guard.emplace(scope); \
+    if (guard->_active()) { \
+      guard->_setCurrent(); \
+      if (torch::autograd::profiler::RecordFunction::_needsInputs()) { \
+        guard->_before(fn, inputs, ##__VA_ARGS__); \
+      } else { \
+        guard->_before(fn, ##__VA_ARGS__); \
+      } \
     } \
   }
 
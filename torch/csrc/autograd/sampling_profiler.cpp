@@ -0,0 +1,350 @@
+#include <torch/csrc/autograd/sampling_profiler.h>
+
+#include <c10/util/Exception.h>
+#include <c10/util/Logging.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define TORCH_SAMPLING_PROFILER_RDTSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define TORCH_SAMPLING_PROFILER_RDTSC
+#endif
+
+namespace torch { namespace autograd { namespace profiler {
+
+namespace {
+
+// Longer names are truncated; keeps an event at one cache line.
+constexpr size_t kMaxNameLength = 47;
+// Deeper nesting of sampled scopes on one thread is not recorded.
+constexpr size_t kMaxOpenScopes = 64;
+
+inline uint64_t readTicks() {
+#ifdef TORCH_SAMPLING_PROFILER_RDTSC
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+inline uint64_t readNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+struct SampledEvent {
+  uint64_t start_ticks;
+  uint64_t end_ticks;
+  RecordScope scope;
+  char name[kMaxNameLength];
+};
+
+// Single producer (the thread the buffer belongs to), single consumer (the
+// exporter) queue of events.
+class EventRingBuffer {
+ public:
+  EventRingBuffer(size_t capacity, uint16_t thread_id)
+      : thread_id_(thread_id) {
+    size_t size = 1;
+    while (size < capacity) {
+      size <<= 1;
+    }
+    events_.resize(size);
+    mask_ = size - 1;
+  }
+
+  // Called by the owning thread only.
+  bool tryPush(const SampledEvent& event) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) > mask_) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    events_[head & mask_] = event;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Called by the exporter only.
+  template <typename F>
+  void drain(F&& f) {
+    const size_t head = head_.load(std::memory_order_acquire);
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    for (; tail != head; ++tail) {
+      f(events_[tail & mask_]);
+    }
+    tail_.store(tail, std::memory_order_release);
+  }
+
+  uint16_t threadId() const {
+    return thread_id_;
+  }
+
+  uint64_t dropped() const {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::vector<SampledEvent> events_;
+  size_t mask_;
+  const uint16_t thread_id_;
+  // next slot to write
+  std::atomic<size_t> head_{0};
+  // next slot to read
+  std::atomic<size_t> tail_{0};
+  std::atomic<uint64_t> dropped_{0};
+};
+
+class SamplingProfiler {
+ public:
+  explicit SamplingProfiler(const SamplingProfilerConfig& config)
+      : config_(config),
+        out_(config.trace_path),
+        start_ticks_(readTicks()),
+        start_nanos_(readNanos()) {
+    TORCH_CHECK(
+        out_, "Could not open ", config.trace_path, " for the sampling profiler");
+    out_ << "{\"traceEvents\": [";
+    exporter_ = std::thread([this] { exportLoop(); });
+  }
+
+  ~SamplingProfiler() {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    exporter_.join();
+    // the producers are done, so this picks up everything they recorded
+    flush();
+    out_ << "\n]}\n";
+  }
+
+  EventRingBuffer& registerThread() {
+    std::lock_guard<std::mutex> guard(buffers_mutex_);
+    buffers_.push_back(std::make_shared<EventRingBuffer>(
+        config_.buffer_size, RecordFunction::currentThreadId()));
+    return *buffers_.back();
+  }
+
+  uint64_t dropped() {
+    std::lock_guard<std::mutex> guard(buffers_mutex_);
+    uint64_t dropped = 0;
+    for (const auto& buffer : buffers_) {
+      dropped += buffer->dropped();
+    }
+    return dropped;
+  }
+
+ private:
+  void exportLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+      cv_.wait_for(lock, config_.flush_interval);
+      flush();
+    }
+  }
+
+  // Only called by one thread at a time: the exporter, or the destructor
+  // after the exporter has stopped.
+  void flush() {
+    std::vector<std::shared_ptr<EventRingBuffer>> buffers;
+    {
+      std::lock_guard<std::mutex> guard(buffers_mutex_);
+      buffers = buffers_;
+    }
+    const double ticks_per_us = ticksPerMicrosecond();
+    for (const auto& buffer : buffers) {
+      const auto tid = buffer->threadId();
+      buffer->drain([&](const SampledEvent& event) {
+        const double ts =
+            static_cast<double>(event.start_ticks - start_ticks_) /
+            ticks_per_us;
+        const double dur =
+            static_cast<double>(event.end_ticks - event.start_ticks) /
+            ticks_per_us;
+        out_ << (first_event_ ? "\n" : ",\n") << "{\"name\": \"";
+        writeEscaped(event.name);
+        out_ << "\", \"cat\": \"" << scopeName(event.scope)
+             << "\", \"ph\": \"X\", \"ts\": " << ts << ", \"dur\": " << dur
+             << ", \"pid\": 0, \"tid\": " << tid << "}";
+        first_event_ = false;
+      });
+    }
+    out_.flush();
+  }
+
+  double ticksPerMicrosecond() const {
+#ifdef TORCH_SAMPLING_PROFILER_RDTSC
+    // calibrated over the whole profiling session so far
+    const uint64_t nanos = readNanos() - start_nanos_;
+    const uint64_t ticks = readTicks() - start_ticks_;
+    if (nanos == 0 || ticks == 0) {
+      return 1000.0;
+    }
+    return static_cast<double>(ticks) * 1000.0 / static_cast<double>(nanos);
+#else
+    return 1000.0;
+#endif
+  }
+
+  void writeEscaped(const char* str) {
+    for (; *str; ++str) {
+      if (*str == '"' || *str == '\\') {
+        out_ << '\\';
+      }
+      if (static_cast<unsigned char>(*str) < 0x20) {
+        continue;
+      }
+      out_ << *str;
+    }
+  }
+
+  static const char* scopeName(RecordScope scope) {
+    switch (scope) {
+      case RecordScope::FUNCTION:
+        return "function";
+      case RecordScope::TORCHSCRIPT_FUNCTION:
+        return "torchscript";
+      case RecordScope::USER_SCOPE:
+        return "user_scope";
+      default:
+        return "unknown";
+    }
+  }
+
+  const SamplingProfilerConfig config_;
+  std::ofstream out_;
+  bool first_event_ = true;
+  const uint64_t start_ticks_;
+  const uint64_t start_nanos_;
+
+  std::mutex buffers_mutex_;
+  std::vector<std::shared_ptr<EventRingBuffer>> buffers_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_ = false;
+  std::thread exporter_;
+};
+
+std::unique_ptr<SamplingProfiler> profiler;
+// bumped on every enable, to invalidate the thread local state of the
+// previous profiling session
+std::atomic<uint64_t> session{0};
+
+struct ThreadState {
+  uint64_t session = 0;
+  EventRingBuffer* buffer = nullptr;
+  std::vector<std::pair<const RecordFunction*, uint64_t>> open;
+};
+
+ThreadState& threadState() {
+  static thread_local ThreadState state;
+  const auto current = session.load(std::memory_order_acquire);
+  if (state.session != current) {
+    state.session = current;
+    state.buffer = &profiler->registerThread();
+    state.open.clear();
+    state.open.reserve(kMaxOpenScopes);
+  }
+  return state;
+}
+
+// use RecordFunctionGuard to keep track of observers,
+// enable/disableSamplingProfiler are tied to the code range
+thread_local std::unique_ptr<RecordFunctionGuard> observers_guard;
+
+} // namespace
+
+void enableSamplingProfiler(const SamplingProfilerConfig& config) {
+  TORCH_CHECK(!profiler, "The sampling profiler is already enabled");
+  TORCH_CHECK(
+      config.sampling_prob > 0 && config.sampling_prob <= 1,
+      "Sampling probability must be in (0, 1]");
+  TORCH_CHECK(config.buffer_size > 0, "Ring buffer size must be positive");
+  profiler = std::make_unique<SamplingProfiler>(config);
+  session.fetch_add(1, std::memory_order_release);
+
+  auto scopes = config.scopes;
+  if (scopes.empty()) {
+    scopes = {RecordScope::FUNCTION, RecordScope::USER_SCOPE};
+  }
+  pushCallback(
+      [](const RecordFunction& fn) {
+        auto& state = threadState();
+        if (state.open.size() >= kMaxOpenScopes) {
+          return false;
+        }
+        state.open.emplace_back(&fn, readTicks());
+        return true;
+      },
+      [](const RecordFunction& fn) {
+        const uint64_t end_ticks = readTicks();
+        if (fn.getStartCallbacksThreadId() !=
+            RecordFunction::currentThreadId()) {
+          return;
+        }
+        auto& state = threadState();
+        // Scopes that ended on other threads leave stale entries above this
+        // one; drop them along with it.
+        auto it = std::find_if(
+            state.open.rbegin(), state.open.rend(), [&](const auto& entry) {
+              return entry.first == &fn;
+            });
+        if (it == state.open.rend()) {
+          return;
+        }
+        SampledEvent event;
+        event.start_ticks = it->second;
+        event.end_ticks = end_ticks;
+        event.scope = fn.scope();
+        const char* name = fn.name().str();
+        const size_t len =
+            name ? std::min(std::strlen(name), kMaxNameLength - 1) : 0;
+        if (len > 0) {
+          std::memcpy(event.name, name, len);
+        }
+        event.name[len] = '\0';
+        state.open.erase(std::next(it).base(), state.open.end());
+        state.buffer->tryPush(event);
+      },
+      /* needs_inputs */ false,
+      config.sampling_prob,
+      std::move(scopes));
+  observers_guard = std::make_unique<RecordFunctionGuard>();
+}
+
+uint64_t disableSamplingProfiler() {
+  TORCH_CHECK(profiler, "The sampling profiler is not enabled");
+  popCallback();
+  observers_guard.reset();
+  const uint64_t dropped = profiler->dropped();
+  profiler.reset();
+  if (dropped > 0) {
+    LOG(WARNING) << "Sampling profiler dropped " << dropped
+                 << " events because a ring buffer was full";
+  }
+  return dropped;
+}
+
+bool samplingProfilerEnabled() {
+  return profiler != nullptr;
+}
+
+}}} // namespace torch::autograd::profiler
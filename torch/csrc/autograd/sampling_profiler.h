@@ -0,0 +1,50 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/autograd/record_function.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+
+namespace torch { namespace autograd { namespace profiler {
+
+// A low overhead profiler intended to be left on in production.
+//
+// Every RecordFunction scope is sampled with probability `sampling_prob`.
+// The start and end of a sampled scope are timestamped with the CPU's time
+// stamp counter where available and the resulting event is appended to a
+// fixed-size ring buffer of the thread that ran it, without taking any
+// locks. A background thread drains the ring buffers every `flush_interval`
+// and appends the events to `trace_path` in the Chrome trace event format
+// (chrome://tracing). Events that don't fit in a full ring buffer are
+// dropped and counted.
+//
+// As for the regular profiler, observers must be enabled on the threads to
+// be profiled (see RecordFunctionGuard); enableSamplingProfiler enables them
+// on the calling thread. Scopes that end on a different thread than they
+// started on are not recorded.
+struct TORCH_API SamplingProfilerConfig {
+  std::string trace_path;
+  double sampling_prob = 0.01;
+  // number of events per thread; rounded up to a power of two
+  size_t buffer_size = 4096;
+  std::chrono::milliseconds flush_interval{100};
+  // scopes to sample; empty means function and user scopes
+  std::unordered_set<RecordScope, std::hash<RecordScope>> scopes;
+};
+
+// WARNING: like pushCallback, not thread safe, must not overlap with other
+// PyTorch code execution
+TORCH_API void enableSamplingProfiler(const SamplingProfilerConfig& config);
+
+// Flushes the remaining events, finishes the trace file and returns the
+// number of events that were dropped because a ring buffer was full.
+// WARNING: like popCallback, not thread safe, must not overlap with other
+// PyTorch code execution
+TORCH_API uint64_t disableSamplingProfiler();
+
+TORCH_API bool samplingProfilerEnabled();
+
+}}} // namespace torch::autograd::profiler
@@ -14,6 +14,25 @@
 
 namespace torch { namespace autograd {
 
+namespace {
+thread_local std::shared_ptr<SavedVariableHooks> saved_variable_hooks;
+} // namespace
+
+SavedVariableHooksGuard::SavedVariableHooksGuard(
+    std::shared_ptr<SavedVariableHooks> hooks)
+    : prev_hooks_(std::move(saved_variable_hooks)) {
+  saved_variable_hooks = std::move(hooks);
+}
+
+SavedVariableHooksGuard::~SavedVariableHooksGuard() {
+  saved_variable_hooks = std::move(prev_hooks_);
+}
+
+const std::shared_ptr<SavedVariableHooks>& SavedVariableHooksGuard::
+    current_hooks() {
+  return saved_variable_hooks;
+}
+
 SavedVariable::SavedVariable(const Variable& variable, bool is_output, bool is_inplace_view) {
   if (variable.defined()) {
     was_default_constructed_ = false;
@@ -33,11 +52,30 @@ SavedVariable::SavedVariable(const Variable& variable, bool is_output, bool is_i
     }
     version_counter_ = impl::version_counter(variable);
     saved_version_ = version_counter_.current_version();
+
+    if (auto hooks = saved_variable_hooks) {
+      // Unset the hooks while they run so that they do not see what they
+      // save themselves.
+      SavedVariableHooksGuard guard(nullptr);
+      packed_ = hooks->pack(data_);
+      if (packed_) {
+        data_.reset();
+      }
+    }
   }
 }
 
 Variable SavedVariable::unpack(std::shared_ptr<Node> saved_for) const {
-  if (!data_.defined()) {
+  if (packed_) {
+    return unpack_data(packed_->unpack(), std::move(saved_for));
+  }
+  return unpack_data(data_, std::move(saved_for));
+}
+
+Variable SavedVariable::unpack_data(
+    const at::Tensor& data,
+    std::shared_ptr<Node> saved_for) const {
+  if (!data.defined()) {
     if (!was_default_constructed_) {
       throw std::runtime_error(ERR_BACKWARD_TWICE);
     }
@@ -57,8 +95,8 @@ Variable SavedVariable::unpack(std::shared_ptr<Node> saved_for) const {
   if (saved_version_ != version_counter_.current_version()) {
     std::stringstream message;
     message << "one of the variables needed for gradient computation has been "
-        "modified by an inplace operation: [" << data_.toString() << " "
-        << data_.sizes() << "]";
+        "modified by an inplace operation: [" << data.toString() << " "
+        << data.sizes() << "]";
     if (grad_fn) {
         message << ", which is output " << output_nr_
             << " of " << grad_fn->name() << ",";
@@ -83,9 +121,9 @@ Variable SavedVariable::unpack(std::shared_ptr<Node> saved_for) const {
   // in-place functions on unpacked variables.
   Variable var;
   if (grad_fn) {
-    var = make_variable(data_, Edge(std::move(grad_fn), output_nr_));
+    var = make_variable(data, Edge(std::move(grad_fn), output_nr_));
   } else {
-    var = make_variable(data_, requires_grad_);
+    var = make_variable(data, requires_grad_);
   }
   impl::set_version_counter(var, saved_version_);
 
@@ -14,6 +14,39 @@ struct Node;
 
 TORCH_API extern const char* ERR_BACKWARD_TWICE;
 
+/// The data of a saved variable in the form chosen by `SavedVariableHooks`.
+struct TORCH_API PackedSavedTensor {
+  virtual ~PackedSavedTensor() = default;
+
+  /// Returns the data that was packed. Called every time the saved variable
+  /// is unpacked, so more than once if the graph is retained.
+  virtual at::Tensor unpack() = 0;
+};
+
+/// A policy for keeping the data of saved variables until backward, e.g.
+/// offloaded to host memory, compressed, or dropped and recomputed. See
+/// saved_variable_hooks.h for the policies that come with autograd.
+struct TORCH_API SavedVariableHooks {
+  virtual ~SavedVariableHooks() = default;
+
+  /// Called with the data of every variable that is saved for backward on a
+  /// thread while the hooks are set on it. Returns nullptr to keep the data
+  /// as is. Variables saved by `pack` itself are kept as is.
+  virtual std::unique_ptr<PackedSavedTensor> pack(const at::Tensor& data) = 0;
+};
+
+/// Sets the `SavedVariableHooks` of the current thread for the lifetime of
+/// the guard; nullptr unsets them.
+struct TORCH_API SavedVariableHooksGuard {
+  explicit SavedVariableHooksGuard(std::shared_ptr<SavedVariableHooks> hooks);
+  ~SavedVariableHooksGuard();
+
+  static const std::shared_ptr<SavedVariableHooks>& current_hooks();
+
+ private:
+  std::shared_ptr<SavedVariableHooks> prev_hooks_;
+};
+
 /// A snapshot of a variable at a certain version. A `SavedVariable` stores
 /// enough information to reconstruct a variable from a certain point in time.
 class TORCH_API SavedVariable {
@@ -29,6 +62,7 @@ class TORCH_API SavedVariable {
   Variable unpack(std::shared_ptr<Node> saved_for = nullptr) const;
 
   void reset_data() {
+    packed_.reset();
     return data_.reset();
   }
 
@@ -37,7 +71,12 @@ class TORCH_API SavedVariable {
   }
 
  private:
+  Variable unpack_data(const at::Tensor& data, std::shared_ptr<Node> saved_for)
+      const;
+
   at::Tensor data_;
+  // Set instead of data_ if the SavedVariableHooks packed it.
+  std::unique_ptr<PackedSavedTensor> packed_;
 
   // The gradient function associated with this node. If has_grad_fn
   // is false, then this is a leaf node. Note that the grad_fn is not saved if
@@ -0,0 +1,104 @@
+#include <torch/csrc/autograd/saved_variable_hooks.h>
+
+#include <c10/util/Exception.h>
+
+#include <utility>
+
+namespace torch { namespace autograd {
+
+namespace {
+
+struct OffloadedTensor : public PackedSavedTensor {
+  OffloadedTensor(at::Tensor host_data, at::Device device)
+      : host_data_(std::move(host_data)), device_(device) {}
+
+  at::Tensor unpack() override {
+    return host_data_.to(device_, /*non_blocking=*/true);
+  }
+
+  at::Tensor host_data_;
+  at::Device device_;
+};
+
+struct CastTensor : public PackedSavedTensor {
+  CastTensor(at::Tensor data, at::ScalarType dtype)
+      : data_(std::move(data)), dtype_(dtype) {}
+
+  at::Tensor unpack() override {
+    return data_.to(dtype_);
+  }
+
+  at::Tensor data_;
+  at::ScalarType dtype_;
+};
+
+// Bit i of byte j of bits_ is element 8 * j + i of the flattened mask.
+struct BitmaskTensor : public PackedSavedTensor {
+  explicit BitmaskTensor(const at::Tensor& mask)
+      : sizes_(mask.sizes().vec()), numel_(mask.numel()) {
+    const int64_t padding = (8 - numel_ % 8) % 8;
+    auto bytes = at::constant_pad_nd(
+        mask.reshape({-1}).to(at::kByte), {0, padding});
+    bits_ = bytes.view({-1, 8}).mul(weights(mask.device())).sum({1}, /*keepdim=*/false, at::kByte);
+  }
+
+  at::Tensor unpack() override {
+    return bits_.unsqueeze(1)
+        .bitwise_and(weights(bits_.device()))
+        .ne(0)
+        .view({-1})
+        .narrow(0, 0, numel_)
+        .view(sizes_);
+  }
+
+  static at::Tensor weights(at::Device device) {
+    return at::tensor(
+        {1, 2, 4, 8, 16, 32, 64, 128},
+        at::TensorOptions().dtype(at::kByte).device(device));
+  }
+
+  std::vector<int64_t> sizes_;
+  int64_t numel_;
+  at::Tensor bits_;
+};
+
+} // namespace
+
+std::unique_ptr<PackedSavedTensor> OffloadSavedVariableHooks::pack(
+    const at::Tensor& data) {
+  if (!data.is_cuda() || data.nbytes() < min_bytes_) {
+    return nullptr;
+  }
+  auto host_data = at::empty_like(
+      data,
+      data.options().device(at::kCPU).pinned_memory(true),
+      at::MemoryFormat::Preserve);
+  host_data.copy_(data, /*non_blocking=*/true);
+  return std::make_unique<OffloadedTensor>(
+      std::move(host_data), data.device());
+}
+
+CompressSavedVariableHooks::CompressSavedVariableHooks(at::ScalarType dtype)
+    : dtype_(dtype) {
+  TORCH_CHECK(
+      at::isFloatingType(dtype),
+      "Expected a floating point type to compress saved variables to, but got ",
+      dtype);
+}
+
+std::unique_ptr<PackedSavedTensor> CompressSavedVariableHooks::pack(
+    const at::Tensor& data) {
+  if (data.is_sparse()) {
+    return nullptr;
+  }
+  if (data.scalar_type() == at::kBool) {
+    return std::make_unique<BitmaskTensor>(data);
+  }
+  if (at::isFloatingType(data.scalar_type()) &&
+      data.element_size() > c10::elementSize(dtype_)) {
+    return std::make_unique<CastTensor>(data.to(dtype_), data.scalar_type());
+  }
+  return nullptr;
+}
+
+}} // namespace torch::autograd
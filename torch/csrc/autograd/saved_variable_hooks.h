@@ -0,0 +1,38 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/autograd/saved_variable.h>
+
+#include <ATen/ATen.h>
+
+#include <cstddef>
+#include <memory>
+
+namespace torch { namespace autograd {
+
+/// Copies saved CUDA tensors of at least `min_bytes` bytes to pinned host
+/// memory, without blocking the forward pass, and back to their device when
+/// backward needs them.
+struct TORCH_API OffloadSavedVariableHooks : public SavedVariableHooks {
+  explicit OffloadSavedVariableHooks(size_t min_bytes = 1 << 20)
+      : min_bytes_(min_bytes) {}
+
+  std::unique_ptr<PackedSavedTensor> pack(const at::Tensor& data) override;
+
+ private:
+  size_t min_bytes_;
+};
+
+/// Stores saved floating point tensors of a wider type as `dtype`, which is
+/// lossy, and saved bool tensors as bitmasks of 8 elements per byte. The
+/// unpacked tensors are contiguous.
+struct TORCH_API CompressSavedVariableHooks : public SavedVariableHooks {
+  explicit CompressSavedVariableHooks(at::ScalarType dtype = at::kHalf);
+
+  std::unique_ptr<PackedSavedTensor> pack(const at::Tensor& data) override;
+
+ private:
+  at::ScalarType dtype_;
+};
+
+}} // namespace torch::autograd
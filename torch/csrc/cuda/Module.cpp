@@ -329,6 +329,12 @@ PyObject * THCPModule_memoryStats(PyObject *_unused, PyObject *arg)
   result["active_bytes"] = statArrayToDict(stats.active_bytes);
   result["inactive_split_bytes"] = statArrayToDict(stats.inactive_split_bytes);
 
+  py::dict freeBlocks;
+  freeBlocks["count"] = py::cast(std::vector<int64_t>(stats.free_block_count.begin(), stats.free_block_count.end()));
+  freeBlocks["bytes"] = py::cast(std::vector<int64_t>(stats.free_block_bytes.begin(), stats.free_block_bytes.end()));
+  freeBlocks["largest"] = stats.largest_free_block;
+  result["free_blocks"] = freeBlocks;
+
   return result.release().ptr();
   END_HANDLE_TH_ERRORS
 }
@@ -368,6 +374,7 @@ PyObject * THCPModule_memorySnapshot(PyObject *_unused, PyObject *noargs)
     segmentDict["allocated_size"] = segmentInfo.allocated_size;
     segmentDict["active_size"] = segmentInfo.active_size;
     segmentDict["segment_type"] = (segmentInfo.is_large ? "large" : "small");
+    segmentDict["is_expandable"] = segmentInfo.is_expandable;
 
     py::list blocks;
     for (const auto& blockInfo : segmentInfo.blocks) {
@@ -392,6 +399,59 @@ PyObject * THCPModule_memorySnapshot(PyObject *_unused, PyObject *noargs)
   END_HANDLE_TH_ERRORS
 }
 
+PyObject * THCPModule_hostMemoryStats(PyObject *_unused, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  const THCCachingHostAllocatorStats stats = THCCachingHostAllocator_getStats();
+
+  py::dict allocatedBytes;
+  allocatedBytes["current"] = stats.allocated_bytes;
+  allocatedBytes["peak"] = stats.peak_allocated_bytes;
+  py::dict reservedBytes;
+  reservedBytes["current"] = stats.reserved_bytes;
+  reservedBytes["peak"] = stats.peak_reserved_bytes;
+
+  py::dict sizeClasses;
+  for (const auto& sizeClass : stats.size_classes) {
+    py::dict sizeClassDict;
+    sizeClassDict["allocated"] = sizeClass.allocated;
+    sizeClassDict["cached"] = sizeClass.cached;
+    sizeClasses[py::int_(sizeClass.size)] = sizeClassDict;
+  }
+
+  py::dict result;
+  result["allocated_bytes"] = allocatedBytes;
+  result["requested_bytes"] = stats.requested_bytes;
+  result["reserved_bytes"] = reservedBytes;
+  result["limit_bytes"] = stats.limit_bytes;
+  result["num_allocs"] = stats.num_allocs;
+  result["num_cache_hits"] = stats.num_cache_hits;
+  result["num_slab_allocs"] = stats.num_slab_allocs;
+  result["num_slab_evictions"] = stats.num_slab_evictions;
+  result["size_classes"] = sizeClasses;
+  return result.release().ptr();
+  END_HANDLE_TH_ERRORS
+}
+
+PyObject * THCPModule_resetHostMemoryStats(PyObject *_unused, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  THCCachingHostAllocator_resetStats();
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
+PyObject * THCPModule_setHostMemoryLimit(PyObject *_unused, PyObject *arg)
+{
+  HANDLE_TH_ERRORS
+  THPUtils_assert(THPUtils_checkLong(arg), "invalid argument to set_host_memory_limit");
+  const int64_t limit = THPUtils_unpackLong(arg);
+  THPUtils_assert(limit >= 0, "set_host_memory_limit: the limit must be non-negative");
+  THCCachingHostAllocator_setMemoryLimit(limit);
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Cuda module initialization
 ////////////////////////////////////////////////////////////////////////////////
@@ -505,6 +565,9 @@ static struct PyMethodDef _THCPModule_methods[] = {
   {"_cuda_resetAccumulatedMemoryStats", (PyCFunction) THCPModule_resetAccumulatedMemoryStats, METH_O, nullptr},
   {"_cuda_resetPeakMemoryStats", (PyCFunction) THCPModule_resetPeakMemoryStats, METH_O,  nullptr},
   {"_cuda_memorySnapshot", (PyCFunction) THCPModule_memorySnapshot, METH_NOARGS, nullptr},
+  {"_cuda_hostMemoryStats", (PyCFunction) THCPModule_hostMemoryStats, METH_NOARGS, nullptr},
+  {"_cuda_resetHostMemoryStats", (PyCFunction) THCPModule_resetHostMemoryStats, METH_NOARGS, nullptr},
+  {"_cuda_setHostMemoryLimit", (PyCFunction) THCPModule_setHostMemoryLimit, METH_O, nullptr},
   {"_cuda_cudaHostAllocator", (PyCFunction)THCPModule_cudaHostAllocator, METH_NOARGS, nullptr},
   {"_cuda_cudaCachingAllocator_raw_alloc", (PyCFunction)THCPModule_cudaCachingAllocator_raw_alloc, METH_VARARGS, nullptr},
   {"_cuda_cudaCachingAllocator_raw_delete", (PyCFunction)THCPModule_cudaCachingAllocator_raw_delete, METH_O, nullptr},
@@ -542,8 +605,11 @@ void initCudnnBindings(PyObject* module);
 
 } // namespace shared
 
+void initGraphBindings(PyObject* module);
+
 void initModule(PyObject *module) {
   python::initCommMethods(module);
+  initGraphBindings(module);
   // As weird as it seems, this file is also compiled for ROCm,
   // so this condition might not always be true...
   shared::initCudartBindings(module);
@@ -9,11 +9,13 @@
 
 #include <ATen/ATen.h>
 #include <ATen/cuda/CUDAContext.h>
+#include <c10/cuda/CUDACachingAllocator.h>
 #include <c10/cuda/CUDAGuard.h>
 #include <c10/util/Optional.h>
 #include <torch/csrc/autograd/variable.h>
 
 #include <cstddef>
+#include <unordered_map>
 #include <vector>
 
 namespace torch { namespace cuda {
@@ -159,6 +161,140 @@ tensor_list2d broadcast_coalesced(TensorList tensors, IntArrayRef devices, size_
   return outputs;
 }
 
+CoalescedBroadcast::CoalescedBroadcast(std::vector<int64_t> devices, size_t buffer_size)
+    : devices_(std::move(devices)), buffer_size_(buffer_size), outputs_(devices_.size()) {
+  TORCH_CHECK(!devices_.empty(), "CoalescedBroadcast expects at least one device");
+#ifdef USE_NCCL
+  buffer_size_ = std::min(torch::cuda::nccl::get_max_count(), buffer_size_);
+#endif
+  streams_.reserve(devices_.size());
+  events_.reserve(devices_.size());
+  for (auto device : devices_) {
+    streams_.push_back(at::cuda::getStreamFromPool(/*isHighPriority=*/false, device));
+    events_.emplace_back();
+  }
+}
+
+bool CoalescedBroadcast::same_layout(TensorList tensors) const {
+  if (tensors.size() != sizes_.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    if (tensors[i].scalar_type() != types_[i] || tensors[i].sizes() != IntArrayRef(sizes_[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Buckets the tensors by type, in order, like take_tensors
+void CoalescedBroadcast::allocate(TensorList tensors) {
+  buckets_.clear();
+  sizes_.clear();
+  types_.clear();
+  std::unordered_map<int, size_t> open_buckets;
+  std::vector<size_t> bucket_bytes;
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    const auto& tensor = tensors[i];
+    sizes_.push_back(tensor.sizes().vec());
+    types_.push_back(tensor.scalar_type());
+    const size_t nbytes = tensor.numel() * tensor.element_size();
+    auto it = open_buckets.find(static_cast<int>(tensor.scalar_type()));
+    if (it == open_buckets.end() ||
+        (bucket_bytes[it->second] > 0 && bucket_bytes[it->second] + nbytes > buffer_size_)) {
+      open_buckets[static_cast<int>(tensor.scalar_type())] = buckets_.size();
+      buckets_.emplace_back();
+      bucket_bytes.push_back(0);
+      it = open_buckets.find(static_cast<int>(tensor.scalar_type()));
+    }
+    buckets_[it->second].indices.push_back(i);
+    bucket_bytes[it->second] += nbytes;
+  }
+
+  outputs_.assign(devices_.size(), std::vector<Tensor>(tensors.size()));
+  at::cuda::OptionalCUDAGuard device_guard;
+  for (auto& bucket : buckets_) {
+    int64_t numel = 0;
+    for (auto i : bucket.indices) {
+      numel += tensors[i].numel();
+    }
+    const auto& first = tensors[bucket.indices.front()];
+    for (size_t d = 0; d < devices_.size(); ++d) {
+      device_guard.set_index(devices_[d]);
+      // Allocated on the current stream, and also used on the side stream
+      Tensor flat = at::empty({numel}, first.options().device(at::Device(kCUDA, devices_[d])));
+      c10::cuda::CUDACachingAllocator::recordStream(flat.storage().data_ptr(), streams_[d]);
+      bucket.flat.push_back(flat);
+      if (d == 0) {
+        continue;
+      }
+      int64_t offset = 0;
+      for (auto i : bucket.indices) {
+        // See NOTE [ Version Counter in comm.*_coalesced ]
+        Variable var = flat.narrow(0, offset, tensors[i].numel()).view(tensors[i].sizes());
+        outputs_[d][i] = make_variable(var.tensor_data(), false);
+        offset += tensors[i].numel();
+      }
+    }
+  }
+}
+
+const tensor_list2d& CoalescedBroadcast::broadcast(TensorList tensors) {
+  for (const auto& t : tensors) {
+    TORCH_CHECK(
+        t.is_cuda() && t.get_device() == devices_[0],
+        "all tensors must be on devices[0]");
+    TORCH_CHECK(!t.is_sparse(), "CoalescedBroadcast doesn't support sparse tensors");
+  }
+  if (!same_layout(tensors)) {
+    allocate(tensors);
+  }
+  outputs_[0] = tensors.vec();
+
+  // The side streams wait for the inputs, and for the previous uses of the
+  // outputs they are about to overwrite
+  at::cuda::OptionalCUDAGuard device_guard;
+  for (size_t d = 0; d < devices_.size(); ++d) {
+    device_guard.set_index(devices_[d]);
+    at::cuda::CUDAEvent ready;
+    ready.record(at::cuda::getCurrentCUDAStream(devices_[d]));
+    ready.block(streams_[d]);
+  }
+
+  for (auto& bucket : buckets_) {
+    at::cuda::CUDAStreamGuard src_stream_guard(streams_[0]);
+    std::vector<Tensor> inputs;
+    inputs.reserve(bucket.indices.size());
+    for (auto i : bucket.indices) {
+      inputs.push_back(tensors[i].reshape({-1}));
+    }
+    at::cat_out(bucket.flat[0], inputs, 0);
+#ifdef USE_NCCL
+    if (nccl::is_available(bucket.flat)) {
+      nccl::broadcast(bucket.flat, nccl::stream_list(streams_.begin(), streams_.end()));
+      continue;
+    }
+#endif
+    // Copies between devices run on the current streams of both
+    for (size_t d = 1; d < devices_.size(); ++d) {
+      at::cuda::CUDAStreamGuard dst_stream_guard(streams_[d]);
+      bucket.flat[d].copy_(bucket.flat[0], /*non_blocking=*/true);
+    }
+  }
+
+  for (size_t d = 0; d < devices_.size(); ++d) {
+    device_guard.set_index(devices_[d]);
+    events_[d].record(streams_[d]);
+  }
+  return outputs_;
+}
+
+void CoalescedBroadcast::wait() {
+  for (size_t d = 0; d < devices_.size(); ++d) {
+    events_[d].block(at::cuda::getCurrentCUDAStream(devices_[d]));
+  }
+}
+
 std::vector<at::Tensor> scatter(
     const at::Tensor& tensor,
     at::IntArrayRef devices,
@@ -4,6 +4,7 @@
 #include <torch/csrc/WindowsTorchApiMacro.h>
 #include <ATen/cuda/ATenCUDAGeneral.h>
 #include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAEvent.h>
 #include <c10/util/Optional.h>
 
 #include <cstddef>
@@ -17,6 +18,53 @@ TORCH_CUDA_API std::vector<at::Tensor> broadcast(const at::Tensor& tensor, at::I
 TORCH_CUDA_API tensor_list2d broadcast_coalesced(at::TensorList tensors, at::IntArrayRef devices,
                                   size_t buffer_size);
 
+// Broadcasts the same tensors to the same devices again and again, like the
+// parameters of a module replicated at every iteration.
+//
+// The first broadcast allocates flattened buckets of up to buffer_size bytes
+// on every device, which the next broadcasts reuse as long as the tensors
+// keep their sizes and types. The outputs are views of these buckets, so
+// they are the same tensors from one broadcast to the next, their values
+// being overwritten. For devices[0], the inputs are returned as-is.
+//
+// The copies run on a side stream of every device, once the work queued
+// on their current streams when broadcast() is called is done, and they
+// don't block these streams: wait() makes them wait for the outputs, and
+// events() tells when they are ready on every device.
+struct TORCH_CUDA_API CoalescedBroadcast {
+  CoalescedBroadcast(std::vector<int64_t> devices, size_t buffer_size);
+
+  const tensor_list2d& broadcast(at::TensorList tensors);
+
+  // Makes the current streams of all the devices wait for the last broadcast
+  void wait();
+
+  const std::vector<at::cuda::CUDAEvent>& events() const {
+    return events_;
+  }
+
+ private:
+  struct Bucket {
+    // Of the tensors in the bucket
+    std::vector<size_t> indices;
+    // By device
+    std::vector<at::Tensor> flat;
+  };
+
+  bool same_layout(at::TensorList tensors) const;
+  void allocate(at::TensorList tensors);
+
+  std::vector<int64_t> devices_;
+  size_t buffer_size_;
+  std::vector<at::cuda::CUDAStream> streams_;
+  std::vector<at::cuda::CUDAEvent> events_;
+  std::vector<Bucket> buckets_;
+  // Of the broadcast tensors
+  std::vector<std::vector<int64_t>> sizes_;
+  std::vector<at::ScalarType> types_;
+  tensor_list2d outputs_;
+};
+
 TORCH_CUDA_API std::vector<at::Tensor> scatter(
     const at::Tensor& tensor,
     at::IntArrayRef devices,
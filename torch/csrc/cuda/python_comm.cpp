@@ -9,6 +9,7 @@
 
 #include <THC/THC.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <vector>
 
@@ -64,5 +65,39 @@ void initCommMethods(PyObject *module) {
           py::arg("dim"),
           py::arg("destination_index"),
           py::call_guard<py::gil_scoped_release>());
+
+  py::class_<CoalescedBroadcast>(m, "_CoalescedBroadcast")
+      .def(
+          py::init<std::vector<int64_t>, size_t>(),
+          py::arg("devices"),
+          py::arg("buffer_size"))
+      .def(
+          "broadcast",
+          [](CoalescedBroadcast& self, std::vector<at::Tensor>& tensors) {
+            return self.broadcast(tensors);
+          },
+          py::arg("tensors"),
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "wait",
+          &CoalescedBroadcast::wait,
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "query",
+          [](CoalescedBroadcast& self) {
+            const auto& events = self.events();
+            return std::all_of(
+                events.begin(), events.end(),
+                [](const at::cuda::CUDAEvent& event) { return event.query(); });
+          },
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "synchronize",
+          [](CoalescedBroadcast& self) {
+            for (const auto& event : self.events()) {
+              event.synchronize();
+            }
+          },
+          py::call_guard<py::gil_scoped_release>());
 }
 }}}
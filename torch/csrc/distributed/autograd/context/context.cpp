@@ -3,6 +3,7 @@
 #include <c10/util/Exception.h>
 #include <torch/csrc/autograd/functions/accumulate_grad.h>
 #include <torch/csrc/distributed/autograd/context/context.h>
+#include <torch/csrc/distributed/autograd/rpc_messages/propagate_gradients_req.h>
 
 namespace torch {
 namespace distributed {
@@ -10,6 +11,12 @@ namespace autograd {
 
 using torch::autograd::AccumulateGrad;
 
+// Gradients queued for a worker are sent right away once they reach this
+// size, so that batching only delays small messages.
+static constexpr size_t kMaxPendingGradientBytes = 1024 * 1024;
+
+constexpr size_t DistAutogradContext::kNumGradLocks;
+
 DistAutogradContext::DistAutogradContext(int64_t contextId)
     : contextId_(contextId) {}
 
@@ -71,12 +78,20 @@ void DistAutogradContext::accumulateGrad(
   TORCH_INTERNAL_ASSERT(grad.defined());
   TORCH_INTERNAL_ASSERT(variable.requires_grad());
 
-  std::lock_guard<std::mutex> guard(lock_);
-  auto it = accumulatedGrads_.find(variable);
+  // Only 'lock_' protects 'accumulatedGrads_', but the hooks and the sum below
+  // run under the lock of the variable only, so that independent backward
+  // paths accumulating into different variables don't wait for each other.
+  std::lock_guard<std::mutex> gradGuard(gradLocks_
+      [std::hash<c10::TensorImpl*>()(variable.unsafeGetTensorImpl()) %
+       kNumGradLocks]);
   at::Tensor old_grad;
-  if (it != accumulatedGrads_.end()) {
-    // Accumulate multiple grads on the same variable.
-    old_grad = it->value();
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    auto it = accumulatedGrads_.find(variable);
+    if (it != accumulatedGrads_.end()) {
+      // Accumulate multiple grads on the same variable.
+      old_grad = it->value();
+    }
   }
 
   // No higher order gradients supported in distributed autograd.
@@ -96,10 +111,64 @@ void DistAutogradContext::accumulateGrad(
       // refcount bump for the new_grad.
       num_expected_refs + 1,
       [this, &variable](at::Tensor&& grad_update) {
-        accumulatedGrads_.insert(variable, std::move(grad_update));
+        std::lock_guard<std::mutex> guard(lock_);
+        accumulatedGrads_.insert_or_assign(variable, std::move(grad_update));
       });
 }
 
+void DistAutogradContext::addPendingGradients(
+    rpc::worker_id_t workerId,
+    const AutogradMetadata& autogradMetadata,
+    std::vector<torch::autograd::Variable> grads) {
+  TORCH_INTERNAL_ASSERT(autogradMetadata.autogradContextId == contextId_);
+  size_t numBytes = 0;
+  for (const auto& grad : grads) {
+    numBytes += grad.numel() * grad.element_size();
+  }
+
+  std::unique_lock<std::mutex> lock(lock_);
+  auto& pending = pendingGradients_[workerId];
+  pending.autogradMessageIds.push_back(autogradMetadata.autogradMessageId);
+  pending.grads.push_back(std::move(grads));
+  pending.numBytes += numBytes;
+  if (pending.numBytes < kMaxPendingGradientBytes) {
+    return;
+  }
+  auto full = std::move(pending);
+  pendingGradients_.erase(workerId);
+  lock.unlock();
+  sendGradients(workerId, std::move(full));
+}
+
+void DistAutogradContext::sendPendingGradients() {
+  std::unique_lock<std::mutex> lock(lock_);
+  auto pendingGradients = std::move(pendingGradients_);
+  pendingGradients_.clear();
+  lock.unlock();
+
+  for (auto& entry : pendingGradients) {
+    sendGradients(entry.first, std::move(entry.second));
+  }
+}
+
+void DistAutogradContext::sendGradients(
+    rpc::worker_id_t workerId,
+    PendingGradients pending) {
+  PropagateGradientsReq gradCall(
+      contextId_,
+      std::move(pending.autogradMessageIds),
+      std::move(pending.grads),
+      retrieveGraphTask()->keep_graph_);
+
+  // Send the gradients over to the appropriate node.
+  auto rpcAgent = rpc::RpcAgent::getCurrentRpcAgent();
+  auto futureMessage = rpcAgent->send(
+      rpcAgent->getWorkerInfo(workerId), std::move(gradCall).toMessage());
+
+  // Record the future in the context.
+  addOutstandingRpc(futureMessage);
+}
+
 std::shared_ptr<torch::autograd::GraphTask> DistAutogradContext::
     retrieveGraphTask() {
   std::lock_guard<std::mutex> guard(lock_);
@@ -147,6 +216,8 @@ void DistAutogradContext::addOutstandingRpc(
 void DistAutogradContext::clearOutstandingRpcs() {
   std::unique_lock<std::mutex> lock(lock_);
   outStandingRpcs_.clear();
+  // Gradients left behind by a backward pass that ran into an error.
+  pendingGradients_.clear();
 }
 
 std::shared_ptr<rpc::FutureMessage> DistAutogradContext::
@@ -4,7 +4,9 @@
 #include <torch/csrc/autograd/engine.h>
 #include <torch/csrc/distributed/autograd/functions/recvrpc_backward.h>
 #include <torch/csrc/distributed/autograd/functions/sendrpc_backward.h>
+#include <torch/csrc/distributed/autograd/rpc_messages/autograd_metadata.h>
 #include <torch/csrc/distributed/rpc/rpc_agent.h>
+#include <array>
 #include <cstdint>
 
 namespace torch {
@@ -74,12 +76,34 @@ class TORCH_API DistAutogradContext {
   friend class DistAccumulateGradCaptureHook;
 
   // Record that we would like to accumulate the provided gradient on the given
-  // variable.
+  // variable. Gradients for different variables are accumulated concurrently.
   void accumulateGrad(
       const torch::autograd::Variable& variable,
       const torch::Tensor& grad,
       size_t num_expected_refs);
 
+  // Queues the gradients of a 'recv' function to be sent to the worker it
+  // received its RPC from. The gradients queued for the same worker are sent
+  // in a single RPC by 'sendPendingGradients', or as soon as they exceed
+  // kMaxPendingGradientBytes (see context.cpp).
+  void addPendingGradients(
+      rpc::worker_id_t workerId,
+      const AutogradMetadata& autogradMetadata,
+      std::vector<torch::autograd::Variable> grads);
+
+  // Sends all queued gradients and records the RPCs as outstanding.
+  void sendPendingGradients();
+
+  // The gradients to send to a worker, for one or more 'recv' functions.
+  struct PendingGradients {
+    std::vector<int64_t> autogradMessageIds;
+    std::vector<std::vector<torch::autograd::Variable>> grads;
+    size_t numBytes = 0;
+  };
+
+  // Sends the gradients to the worker and records the RPC as outstanding.
+  void sendGradients(rpc::worker_id_t workerId, PendingGradients pending);
+
   // Retrieve the GraphTask.
   std::shared_ptr<torch::autograd::GraphTask> retrieveGraphTask();
 
@@ -125,8 +149,17 @@ class TORCH_API DistAutogradContext {
   // successfully only if all these futures are done and are successful.
   std::vector<std::shared_ptr<rpc::FutureMessage>> outStandingRpcs_;
 
+  // Gradients that have not been sent yet, by the worker to send them to.
+  std::unordered_map<rpc::worker_id_t, PendingGradients> pendingGradients_;
+
   // Lock to protect concurrent modification of the context.
   mutable std::mutex lock_;
+
+  // Serialize the accumulation of gradients on the same variable, which runs
+  // hooks and tensor math without holding 'lock_'. A variable uses the lock
+  // at the hash of its TensorImpl.
+  static constexpr size_t kNumGradLocks = 16;
+  std::array<std::mutex, kNumGradLocks> gradLocks_;
 };
 
 using ContextPtr = std::shared_ptr<DistAutogradContext>;
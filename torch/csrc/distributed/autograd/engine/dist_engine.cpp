@@ -131,6 +131,7 @@ void DistEngine::computeDependencies(
       /* depth */ 0,
       /* cpu_ready_queue */ nullptr,
       /* exit_on_error */ true);
+  graphTask->priority_fn_ = engine_.node_task_priority_fn();
 
   // Run BFS to traverse the graph locally. The roots of the graph are
   // GraphRoot and all send functions for this autograd context.
@@ -250,6 +251,7 @@ void DistEngine::computeDependencies(
 }
 
 void DistEngine::execute_graph_task_until_ready_queue_empty(
+    const ContextPtr& autogradContext,
     const std::shared_ptr<GraphTask>& graph_task,
     std::shared_ptr<Node> root_to_execute,
     bool incrementOutstandingTasks) {
@@ -277,6 +279,14 @@ void DistEngine::execute_graph_task_until_ready_queue_empty(
         AutoGradMode grad_mode(local_graph_task->grad_mode_);
         try {
           engine_.evaluate_function(local_graph_task, task.fn_.get(), task.inputs_, cpu_ready_queue);
+          if (cpu_ready_queue->empty()) {
+            // Send the gradients that 'recv' functions queued on this
+            // traversal, batched with those of concurrent traversals of the
+            // same context. This has to happen before the outstanding task is
+            // decremented below, so that the RPCs are recorded by the time
+            // the GraphTask completes.
+            autogradContext->sendPendingGradients();
+          }
         } catch (std::exception& e) {
           engine_.thread_on_exception(local_graph_task, task.fn_, e);
           // break the loop in error so that we immediately stop the execution
@@ -308,8 +318,9 @@ std::shared_ptr<rpc::FutureMessage> DistEngine::runEngineAndAccumulateGradients(
   // passes ran into errors.
   autogradContext->clearOutstandingRpcs();
   auto graphTask = autogradContext->retrieveGraphTask();
-  at::launch([this, graphTask, graphRoot, incrementOutstandingTasks](){
+  at::launch([this, autogradContext, graphTask, graphRoot, incrementOutstandingTasks](){
     execute_graph_task_until_ready_queue_empty(
+          /*autogradContext*/ autogradContext,
           /*graph_task*/ graphTask,
           /*root_to_execute*/ graphRoot,
           /*incrementOutstandingTasks*/ incrementOutstandingTasks);
@@ -424,8 +435,9 @@ std::shared_ptr<rpc::FutureMessage> DistEngine::executeSendFunctionAsync(
   } else {
     lock.unlock();
     auto graphTask = autogradContext->retrieveGraphTask();
-    at::launch([this, graphTask, sendFunction](){
+    at::launch([this, autogradContext, graphTask, sendFunction](){
       execute_graph_task_until_ready_queue_empty(
+            /*autogradContext*/ autogradContext,
             /*graph_task*/ graphTask,
             /*root_to_execute*/ sendFunction,
             /*incrementOutstandingTasks*/ false);
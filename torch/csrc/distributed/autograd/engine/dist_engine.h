@@ -89,7 +89,9 @@ class TORCH_API DistEngine {
       bool retainGraph);
 
   // Given a pre-populated GraphTask and a root node, compute the backward pass
-  // for the autograd graph until the graph task ready queue is empty.
+  // for the autograd graph until the graph task ready queue is empty. The
+  // gradients of the 'recv' functions executed along the way are sent to
+  // other workers in batches, whenever the ready queue runs empty.
   //
   // This method assumes that the appropriate GraphTask has already been initialized
   // appropriately. It will construct a local ready queue to traverse the GraphTask
@@ -115,6 +117,7 @@ class TORCH_API DistEngine {
   // TODO: 1. Add assert in the dist engine to ensure no GPU NodeTasks during backward
   //       2. properly setup the thread local ready queue to enable reentrant backwards
  void execute_graph_task_until_ready_queue_empty(
+     const ContextPtr& autogradContext,
      const std::shared_ptr<torch::autograd::GraphTask>& graph_task,
      std::shared_ptr<torch::autograd::Node> root_to_execute,
      bool incrementOutstandingTasks=true);
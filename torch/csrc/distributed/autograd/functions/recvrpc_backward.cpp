@@ -1,7 +1,5 @@
 #include <torch/csrc/distributed/autograd/functions/recvrpc_backward.h>
 #include <ATen/core/functional.h>
-#include <torch/csrc/distributed/autograd/rpc_messages/propagate_gradients_req.h>
-#include <torch/csrc/distributed/rpc/rpc_agent.h>
 
 namespace torch {
 namespace distributed {
@@ -38,20 +36,11 @@ variable_list RecvRpcBackward::apply(variable_list&& grads) {
           "means the autograd context was cleaned up by a different thread due ",
           "to an error before RecvRcpBackward had a chance to run"));
 
-  // Send the gradients over the wire and record the future in the autograd
-  // context.
-  PropagateGradientsReq gradCall(
-      autogradMetadata_,
-      outputGrads,
-      sharedContext->retrieveGraphTask()->keep_graph_);
-
-  // Send the gradients over to the appropriate node.
-  auto rpcAgent = rpc::RpcAgent::getCurrentRpcAgent();
-  auto futureMessage = rpcAgent->send(
-      rpcAgent->getWorkerInfo(fromWorkerId_), std::move(gradCall).toMessage());
-
-  // Record the future in the context.
-  sharedContext->addOutstandingRpc(futureMessage);
+  // Queue the gradients to be sent to the appropriate node. The engine sends
+  // them, batched with those of the other 'recv' functions for the same node,
+  // before it finishes the current node task.
+  sharedContext->addPendingGradients(
+      fromWorkerId_, autogradMetadata_, std::move(outputGrads));
 
   // 'recv' function sends the gradients over the wire using RPC, it doesn't
   // need to return anything for any downstream autograd function.
@@ -14,20 +14,41 @@ PropagateGradientsReq::PropagateGradientsReq(
     const AutogradMetadata& autogradMetadata,
     std::vector<Variable> grads,
     bool retainGraph)
-    : autogradMetadata_(autogradMetadata),
+    : autogradContextId_(autogradMetadata.autogradContextId),
+      autogradMessageIds_({autogradMetadata.autogradMessageId}),
+      retainGraph_(retainGraph) {
+  grads_.push_back(std::move(grads));
+}
+
+PropagateGradientsReq::PropagateGradientsReq(
+    int64_t autogradContextId,
+    std::vector<int64_t> autogradMessageIds,
+    std::vector<std::vector<Variable>> grads,
+    bool retainGraph)
+    : autogradContextId_(autogradContextId),
+      autogradMessageIds_(std::move(autogradMessageIds)),
       grads_(std::move(grads)),
-      retainGraph_(retainGraph) {}
+      retainGraph_(retainGraph) {
+  TORCH_INTERNAL_ASSERT(autogradMessageIds_.size() == grads_.size());
+}
 
 Message PropagateGradientsReq::toMessageImpl() && {
   std::vector<at::IValue> ivalues;
-  // Add all the grad tensors.
-  for (const auto& grad : grads_) {
-    ivalues.emplace_back(grad);
+  // Add all the grad tensors, followed by the number of grads of every
+  // message id.
+  std::vector<int64_t> numGrads;
+  numGrads.reserve(grads_.size());
+  for (const auto& grads : grads_) {
+    for (const auto& grad : grads) {
+      ivalues.emplace_back(grad);
+    }
+    numGrads.push_back(grads.size());
   }
+  ivalues.emplace_back(std::move(numGrads));
 
   // Now add autograd metadata.
-  ivalues.emplace_back(autogradMetadata_.autogradContextId);
-  ivalues.emplace_back(autogradMetadata_.autogradMessageId);
+  ivalues.emplace_back(autogradContextId_);
+  ivalues.emplace_back(std::move(autogradMessageIds_));
 
   // Add retain graph.
   ivalues.emplace_back(retainGraph_);
@@ -56,37 +77,53 @@ std::unique_ptr<PropagateGradientsReq> PropagateGradientsReq::fromMessage(
   std::vector<at::IValue> tupleElements = tuple.toTuple()->elements();
 
   // Build PropagateGradientsReq.
-  TORCH_INTERNAL_ASSERT(tupleElements.size() >= 3);
+  TORCH_INTERNAL_ASSERT(tupleElements.size() >= 4);
 
   // Retrieve retainGraph.
   bool retainGraph = tupleElements.back().toBool();
   tupleElements.pop_back();
 
-  // Build AutogradMetadata.
-  int64_t autogradContextId, autogradMessageId;
-  autogradMessageId = tupleElements.back().toInt();
+  // Retrieve the autograd metadata.
+  auto autogradMessageIds = tupleElements.back().toIntVector();
   tupleElements.pop_back();
-  autogradContextId = tupleElements.back().toInt();
+  int64_t autogradContextId = tupleElements.back().toInt();
   tupleElements.pop_back();
-
-  AutogradMetadata autogradMetadata(autogradContextId, autogradMessageId);
+  auto numGrads = tupleElements.back().toIntVector();
+  tupleElements.pop_back();
+  TORCH_INTERNAL_ASSERT(numGrads.size() == autogradMessageIds.size());
 
   // Retrieve the gradient tensors.
-  std::vector<Variable> grads(tupleElements.size());
-  for (size_t i = 0; i < tupleElements.size(); i++) {
-    grads[i] = tupleElements[i].toTensor();
+  std::vector<std::vector<Variable>> grads;
+  grads.reserve(numGrads.size());
+  size_t next = 0;
+  for (const auto num : numGrads) {
+    TORCH_INTERNAL_ASSERT(next + num <= tupleElements.size());
+    std::vector<Variable> messageGrads(num);
+    for (int64_t i = 0; i < num; i++) {
+      messageGrads[i] = tupleElements[next++].toTensor();
+    }
+    grads.push_back(std::move(messageGrads));
   }
+  TORCH_INTERNAL_ASSERT(next == tupleElements.size());
+
+  return std::unique_ptr<PropagateGradientsReq>(new PropagateGradientsReq(
+      autogradContextId,
+      std::move(autogradMessageIds),
+      std::move(grads),
+      retainGraph));
+}
 
-  return std::unique_ptr<PropagateGradientsReq>(
-      new PropagateGradientsReq(autogradMetadata, grads, retainGraph));
+int64_t PropagateGradientsReq::getAutogradContextId() const {
+  return autogradContextId_;
 }
 
-const AutogradMetadata& PropagateGradientsReq::getAutogradMetadata() {
-  return autogradMetadata_;
+const std::vector<int64_t>& PropagateGradientsReq::getAutogradMessageIds()
+    const {
+  return autogradMessageIds_;
 }
 
-const std::vector<torch::autograd::Variable>& PropagateGradientsReq::
-    getGrads() {
+const std::vector<std::vector<Variable>>& PropagateGradientsReq::getGrads()
+    const {
   return grads_;
 }
 
@@ -11,7 +11,9 @@ namespace autograd {
 
 // Used to propagate gradients from one node to another during a distributed
 // backwards pass. This RPC call is invoked when we hit a `recv` autograd
-// function during backward pass execution.
+// function during backward pass execution. The gradients of several `recv`
+// functions of the same autograd context that are ready together are batched
+// into a single request, with one autograd message id for each.
 class TORCH_API PropagateGradientsReq : public rpc::RpcCommandBase {
  public:
   PropagateGradientsReq(
@@ -19,9 +21,19 @@ class TORCH_API PropagateGradientsReq : public rpc::RpcCommandBase {
       std::vector<torch::autograd::Variable> grads,
       bool retainGraph = false);
 
-  const AutogradMetadata& getAutogradMetadata();
+  PropagateGradientsReq(
+      int64_t autogradContextId,
+      std::vector<int64_t> autogradMessageIds,
+      std::vector<std::vector<torch::autograd::Variable>> grads,
+      bool retainGraph = false);
+
+  int64_t getAutogradContextId() const;
+
+  // The autograd message ids of the `send` functions to run on the receiver,
+  // one for each entry of getGrads().
+  const std::vector<int64_t>& getAutogradMessageIds() const;
 
-  const std::vector<torch::autograd::Variable>& getGrads();
+  const std::vector<std::vector<torch::autograd::Variable>>& getGrads() const;
 
   // Serialization and deserialization methods.
   rpc::Message toMessageImpl() && override;
@@ -32,8 +44,9 @@ class TORCH_API PropagateGradientsReq : public rpc::RpcCommandBase {
   bool retainGraph();
 
  private:
-  AutogradMetadata autogradMetadata_;
-  std::vector<torch::autograd::Variable> grads_;
+  int64_t autogradContextId_;
+  std::vector<int64_t> autogradMessageIds_;
+  std::vector<std::vector<torch::autograd::Variable>> grads_;
   bool retainGraph_;
 };
 
@@ -0,0 +1,209 @@
+#include <torch/csrc/distributed/c10d/comm_hooks.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <ATen/CPUGeneratorImpl.h>
+#include <c10/util/Exception.h>
+
+namespace c10d {
+namespace {
+
+// Returns a future that waits for `work` and then yields `result`.
+std::future<std::vector<at::Tensor>> wait_and_return(
+    std::shared_ptr<ProcessGroup::Work> work,
+    std::vector<at::Tensor> result) {
+  return std::async(
+      std::launch::deferred,
+      [work = std::move(work), result = std::move(result)]() {
+        work->wait();
+        return result;
+      });
+}
+
+// Orthonormalizes the columns of a matrix in place (Gram-Schmidt).
+void orthogonalize(at::Tensor& matrix) {
+  constexpr double kEpsilon = 1e-8;
+  const auto num_cols = matrix.size(1);
+  for (int64_t i = 0; i < num_cols; i++) {
+    auto col = matrix.narrow(1, i, 1);
+    col.div_(col.norm().add_(kEpsilon));
+    for (int64_t j = i + 1; j < num_cols; j++) {
+      auto other = matrix.narrow(1, j, 1);
+      other.sub_(col.mul(other).sum().mul(col));
+    }
+  }
+}
+
+} // namespace
+
+std::future<std::vector<at::Tensor>> AllReduceCommHook::runHook(
+    GradBucket& bucket) {
+  auto work = process_group_->allreduce(bucket.tensors);
+  return wait_and_return(std::move(work), bucket.tensors);
+}
+
+std::future<std::vector<at::Tensor>> FP16CompressCommHook::runHook(
+    GradBucket& bucket) {
+  std::vector<at::Tensor> compressed;
+  compressed.reserve(bucket.tensors.size());
+  for (const auto& tensor : bucket.tensors) {
+    compressed.push_back(tensor.to(at::kHalf));
+  }
+  auto work = process_group_->allreduce(compressed);
+  return std::async(
+      std::launch::deferred,
+      [work = std::move(work),
+       compressed = std::move(compressed),
+       result = bucket.tensors]() {
+        work->wait();
+        for (size_t i = 0; i < result.size(); i++) {
+          result[i].copy_(compressed[i]);
+        }
+        return result;
+      });
+}
+
+PowerSGDCommHook::PowerSGDCommHook(
+    std::shared_ptr<ProcessGroup> process_group,
+    int64_t matrix_approximation_rank,
+    int64_t min_compression_numel,
+    uint64_t seed)
+    : process_group_(std::move(process_group)),
+      rank_(matrix_approximation_rank),
+      min_compression_numel_(min_compression_numel),
+      seed_(seed) {
+  TORCH_CHECK(
+      rank_ >= 1, "PowerSGD matrix approximation rank must be positive.");
+}
+
+std::future<std::vector<at::Tensor>> PowerSGDCommHook::runHook(
+    GradBucket& bucket) {
+  TORCH_CHECK(
+      bucket.tensors.size() == 1,
+      "PowerSGD communication hook only supports a single model replica.");
+  const auto& contents = bucket.tensors[0];
+  const int64_t numel = contents.numel();
+
+  const int64_t num_cols =
+      static_cast<int64_t>(std::ceil(std::sqrt(static_cast<double>(numel))));
+  const int64_t num_rows = (numel + num_cols - 1) / num_cols;
+  const int64_t rank = std::min({rank_, num_rows, num_cols});
+
+  // Compression doesn't pay off unless (rows + cols) * rank is well below
+  // rows * cols.
+  if (numel < min_compression_numel_ || 2 * (num_rows + num_cols) * rank >=
+          num_rows * num_cols) {
+    auto work = process_group_->allreduce(bucket.tensors);
+    return wait_and_return(std::move(work), bucket.tensors);
+  }
+
+  auto& state = state_[bucket.index];
+  if (!state.error.defined() || state.error.numel() != numel ||
+      !state.error.options().type_equal(contents.options())) {
+    state.error = at::zeros_like(contents);
+    // Every process must start from the same Q.
+    auto generator = at::detail::createCPUGenerator(seed_ + bucket.index);
+    state.q = at::randn(
+                  {num_cols, rank},
+                  generator,
+                  contents.options().device(at::kCPU))
+                  .to(contents.device());
+  }
+
+  // Error feedback: compress the gradient plus what was lost last time.
+  state.error.add_(contents);
+  auto matrix = at::constant_pad_nd(state.error, {0, num_rows * num_cols - numel})
+                    .view({num_rows, num_cols});
+
+  std::vector<at::Tensor> p = {matrix.mm(state.q)};
+  auto p_work = process_group_->allreduce(p);
+
+  return std::async(
+      std::launch::deferred,
+      [this, &state, numel, matrix, p = std::move(p), result = bucket.tensors,
+       p_work = std::move(p_work)]() mutable {
+        p_work->wait();
+        orthogonalize(p[0]);
+
+        std::vector<at::Tensor> q = {matrix.t().mm(p[0])};
+        auto q_work = process_group_->allreduce(q);
+        // The allreduce writes Q in place, so it can't be read until the
+        // work has completed.
+        q_work->wait();
+
+        // What the local contribution loses to the decompressed average is
+        // carried over to the next iteration.
+        const auto approximation =
+            p[0].mm(q[0].t()).view({-1}).narrow(0, 0, numel);
+        state.error.copy_(
+            matrix.view({-1}).narrow(0, 0, numel).sub(approximation));
+        result[0].copy_(approximation);
+        state.q = q[0];
+        return result;
+      });
+}
+
+TopKCommHook::TopKCommHook(
+    std::shared_ptr<ProcessGroup> process_group,
+    double ratio)
+    : process_group_(std::move(process_group)), ratio_(ratio) {
+  TORCH_CHECK(
+      ratio_ > 0 && ratio_ <= 1, "Top-k compression ratio must be in (0, 1].");
+}
+
+std::future<std::vector<at::Tensor>> TopKCommHook::runHook(
+    GradBucket& bucket) {
+  TORCH_CHECK(
+      bucket.tensors.size() == 1,
+      "Top-k communication hook only supports a single model replica.");
+  const auto& contents = bucket.tensors[0];
+  const int64_t numel = contents.numel();
+  const int64_t k = std::max<int64_t>(
+      1,
+      std::min<int64_t>(
+          numel, static_cast<int64_t>(std::ceil(numel * ratio_))));
+
+  auto& error = error_[bucket.index];
+  if (!error.defined() || error.numel() != numel ||
+      !error.options().type_equal(contents.options())) {
+    error = at::zeros_like(contents);
+  }
+
+  // Error feedback: select from the gradient plus what was dropped last
+  // time, and keep whatever isn't selected this time.
+  error.add_(contents);
+  auto indices = std::get<1>(error.abs().topk(k));
+  auto values = error.index_select(0, indices);
+  error.index_fill_(0, indices, 0);
+
+  const auto world_size = process_group_->getSize();
+  std::vector<at::Tensor> values_in = {values};
+  std::vector<at::Tensor> indices_in = {indices};
+  std::vector<std::vector<at::Tensor>> values_out(1);
+  std::vector<std::vector<at::Tensor>> indices_out(1);
+  for (int i = 0; i < world_size; i++) {
+    values_out[0].push_back(at::empty_like(values));
+    indices_out[0].push_back(at::empty_like(indices));
+  }
+  auto values_work = process_group_->allgather(values_out, values_in);
+  auto indices_work = process_group_->allgather(indices_out, indices_in);
+
+  return std::async(
+      std::launch::deferred,
+      [values_work = std::move(values_work),
+       indices_work = std::move(indices_work),
+       values_out = std::move(values_out),
+       indices_out = std::move(indices_out),
+       result = bucket.tensors]() {
+        values_work->wait();
+        indices_work->wait();
+        result[0].zero_();
+        for (size_t i = 0; i < values_out[0].size(); i++) {
+          result[0].index_add_(0, indices_out[0][i], values_out[0][i]);
+        }
+        return result;
+      });
+}
+
+} // namespace c10d
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <future>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <ATen/ATen.h>
+#include <c10d/ProcessGroup.hpp>
+
+namespace c10d {
+
+// A bucket of gradients handed to a communication hook. There is one
+// flattened (1 dimensional) contents tensor per model replica. The contents
+// are already divided by the process group size, so the sum across processes
+// is the average gradient.
+struct GradBucket {
+  // Index of the bucket in the reducer. Stable across iterations until the
+  // bucket assignment is reinitialized.
+  size_t index;
+  std::vector<at::Tensor> tensors;
+};
+
+// A communication hook replaces the allreduce that the reducer runs for a
+// dense bucket once all of its gradients are ready.
+//
+// `runHook` is called from the autograd thread. It should launch its
+// communication right away, so that it overlaps with the rest of the backward
+// pass, and return a future for the reduced tensors (one per replica, with the
+// same size and options as the inputs). The future is waited on when
+// backward finalizes; returning a `std::launch::deferred` future is the
+// typical way to defer the wait and any post-processing until then.
+//
+// The result must be (an approximation of) the sum of the bucket contents
+// across all processes. The result may alias the input tensors.
+class CommHookInterface {
+ public:
+  virtual ~CommHookInterface() = default;
+
+  virtual std::future<std::vector<at::Tensor>> runHook(GradBucket& bucket) = 0;
+};
+
+// Plain allreduce. Equivalent to not registering a hook.
+class AllReduceCommHook : public CommHookInterface {
+ public:
+  explicit AllReduceCommHook(std::shared_ptr<ProcessGroup> process_group)
+      : process_group_(std::move(process_group)) {}
+
+  std::future<std::vector<at::Tensor>> runHook(GradBucket& bucket) override;
+
+ protected:
+  std::shared_ptr<ProcessGroup> process_group_;
+};
+
+// Casts the bucket to half precision before the allreduce and back to the
+// bucket dtype afterwards, halving the bytes on the wire.
+class FP16CompressCommHook : public CommHookInterface {
+ public:
+  explicit FP16CompressCommHook(std::shared_ptr<ProcessGroup> process_group)
+      : process_group_(std::move(process_group)) {}
+
+  std::future<std::vector<at::Tensor>> runHook(GradBucket& bucket) override;
+
+ protected:
+  std::shared_ptr<ProcessGroup> process_group_;
+};
+
+// PowerSGD low-rank compression (Vogels et al., 2019).
+//
+// The flat bucket is viewed as an m x n matrix M, with n ~= sqrt(numel) and
+// zero padding at the end. Given a matrix Q (n x rank) shared by all
+// processes, the hook allreduces P = M Q, orthogonalizes P, and allreduces
+// Q = M^T P. The result is P Q^T. Instead of m * n elements, only
+// (m + n) * rank elements are communicated.
+//
+// The compression error of every bucket is kept and added to the bucket on
+// the next iteration (error feedback), and Q is reused as the starting point
+// of the next iteration (warm start). Q is initialized from a generator
+// seeded identically on all processes.
+//
+// Only a single model replica is supported. Buckets smaller than
+// `min_compression_numel` are allreduced uncompressed.
+class PowerSGDCommHook : public CommHookInterface {
+ public:
+  explicit PowerSGDCommHook(
+      std::shared_ptr<ProcessGroup> process_group,
+      int64_t matrix_approximation_rank = 1,
+      int64_t min_compression_numel = 1024,
+      uint64_t seed = 0);
+
+  std::future<std::vector<at::Tensor>> runHook(GradBucket& bucket) override;
+
+ protected:
+  struct State {
+    at::Tensor error;
+    at::Tensor q;
+  };
+
+  std::shared_ptr<ProcessGroup> process_group_;
+  const int64_t rank_;
+  const int64_t min_compression_numel_;
+  const uint64_t seed_;
+  // Per bucket index; reset if the bucket size changes.
+  std::unordered_map<size_t, State> state_;
+};
+
+// Top-k sparsification. Every process keeps only the `ratio` fraction of
+// bucket elements with the largest magnitude, and the selected values and
+// their indices are allgathered and summed into a dense result. The elements
+// that were dropped are kept and added to the bucket on the next iteration
+// (error feedback).
+//
+// Only a single model replica is supported.
+class TopKCommHook : public CommHookInterface {
+ public:
+  explicit TopKCommHook(
+      std::shared_ptr<ProcessGroup> process_group,
+      double ratio = 0.01);
+
+  std::future<std::vector<at::Tensor>> runHook(GradBucket& bucket) override;
+
+ protected:
+  std::shared_ptr<ProcessGroup> process_group_;
+  const double ratio_;
+  // Per bucket index; reset if the bucket size changes.
+  std::unordered_map<size_t, at::Tensor> error_;
+};
+
+} // namespace c10d
@@ -17,14 +17,18 @@
 #endif
 
 #include <c10d/PrefixStore.hpp>
+#include <c10d/ProcessGroupHierarchical.hpp>
 #include <c10d/ProcessGroupRoundRobin.hpp>
 #include <c10d/TCPStore.hpp>
 #include <pybind11/chrono.h>
 
 #include <torch/csrc/Exceptions.h>
 #include <torch/csrc/distributed/c10d/comm.h>
+#include <torch/csrc/distributed/c10d/comm_hooks.h>
 #include <torch/csrc/distributed/c10d/ddp.h>
 #include <torch/csrc/distributed/c10d/reducer.h>
+#include <torch/csrc/distributed/c10d/sharded_parameters.h>
+#include <torch/csrc/utils/memory.h>
 #include <torch/csrc/utils/object_ptr.h>
 #include <torch/csrc/utils/pybind.h>
 
@@ -122,11 +126,17 @@ PyObject* c10d_init(PyObject* _unused) {
               std::vector<std::vector<torch::autograd::Variable>>,
               std::vector<std::vector<size_t>>,
               std::shared_ptr<::c10d::ProcessGroup>,
-              std::vector<std::vector<bool>>>(),
+              std::vector<std::vector<bool>>,
+              int64_t,
+              bool,
+              bool>(),
           py::arg("replicas"),
           py::arg("bucket_indices"),
           py::arg("process_group"),
-          py::arg("expect_sparse_gradients") = std::vector<std::vector<bool>>())
+          py::arg("expect_sparse_gradients") = std::vector<std::vector<bool>>(),
+          py::arg("bucket_bytes_cap") = ::c10d::kDefaultBucketBytesCap,
+          py::arg("gradient_as_bucket_view") = false,
+          py::arg("find_unused_parameters_by_hooks") = false)
       .def(
           "initialize_buckets",
           &::c10d::Reducer::initialize_buckets,
@@ -140,7 +150,78 @@ PyObject* c10d_init(PyObject* _unused) {
           [](::c10d::Reducer& reducer, const torch::autograd::Variable& output)
               -> void { reducer.prepare_for_backward({output}); },
           py::call_guard<py::gil_scoped_release>())
-      .def("get_backward_stats", &::c10d::Reducer::get_backward_stats);
+      .def("get_backward_stats", &::c10d::Reducer::get_backward_stats)
+      .def("get_bucket_indices", &::c10d::Reducer::get_bucket_indices)
+      .def(
+          "_register_fp16_compress_hook",
+          [](::c10d::Reducer& reducer,
+             std::shared_ptr<::c10d::ProcessGroup> process_group) {
+            reducer.register_comm_hook(
+                torch::make_unique<::c10d::FP16CompressCommHook>(
+                    std::move(process_group)));
+          },
+          py::arg("process_group"),
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "_register_powersgd_hook",
+          [](::c10d::Reducer& reducer,
+             std::shared_ptr<::c10d::ProcessGroup> process_group,
+             int64_t matrix_approximation_rank,
+             int64_t min_compression_numel,
+             uint64_t seed) {
+            reducer.register_comm_hook(
+                torch::make_unique<::c10d::PowerSGDCommHook>(
+                    std::move(process_group),
+                    matrix_approximation_rank,
+                    min_compression_numel,
+                    seed));
+          },
+          py::arg("process_group"),
+          py::arg("matrix_approximation_rank") = 1,
+          py::arg("min_compression_numel") = 1024,
+          py::arg("seed") = 0,
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "_register_topk_hook",
+          [](::c10d::Reducer& reducer,
+             std::shared_ptr<::c10d::ProcessGroup> process_group,
+             double ratio) {
+            reducer.register_comm_hook(
+                torch::make_unique<::c10d::TopKCommHook>(
+                    std::move(process_group), ratio));
+          },
+          py::arg("process_group"),
+          py::arg("ratio") = 0.01,
+          py::call_guard<py::gil_scoped_release>());
+
+  shared_ptr_class_<::c10d::ShardedParameters>(module, "_ShardedParameters")
+      .def(
+          py::init<
+              std::vector<at::Tensor>,
+              std::shared_ptr<::c10d::ProcessGroup>,
+              int64_t>(),
+          py::arg("parameters"),
+          py::arg("process_group"),
+          py::arg("bucket_bytes_cap") = ::c10d::kDefaultBucketBytesCap)
+      .def("shards", &::c10d::ShardedParameters::shards)
+      .def("bucket_index", &::c10d::ShardedParameters::bucket_index)
+      .def("num_buckets", &::c10d::ShardedParameters::num_buckets)
+      .def(
+          "reduce_scatter_gradients",
+          &::c10d::ShardedParameters::reduce_scatter_gradients,
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "all_gather_parameters",
+          &::c10d::ShardedParameters::all_gather_parameters,
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "wait_for_bucket",
+          &::c10d::ShardedParameters::wait_for_bucket,
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "wait_for_all",
+          &::c10d::ShardedParameters::wait_for_all,
+          py::call_guard<py::gil_scoped_release>());
 
   py::enum_<::c10d::ReduceOp>(module, "ReduceOp", R"(
 An enum-like class for available reduction operations: ``SUM``, ``PRODUCT``,
@@ -166,7 +247,8 @@ They are used in specifying strategies for reduction collectives, e.g.,
   py::class_<::c10d::AllreduceOptions>(module, "AllreduceOptions")
       .def(py::init<>())
       .def_readwrite("reduceOp", &::c10d::AllreduceOptions::reduceOp)
-      .def_readwrite("timeout", &::c10d::AllreduceOptions::timeout);
+      .def_readwrite("timeout", &::c10d::AllreduceOptions::timeout)
+      .def_readwrite("channel", &::c10d::AllreduceOptions::channel);
 
   py::class_<::c10d::AllreduceCoalescedOptions>(
       module, "AllreduceCoalescedOptions")
@@ -233,6 +315,35 @@ They are used in specifying strategies for reduction collectives, e.g.,
                     reinterpret_cast<char*>(value.data()), value.size());
               },
               py::call_guard<py::gil_scoped_release>())
+          .def(
+              "multi_set",
+              [](::c10d::Store& store,
+                 const std::vector<std::string>& keys,
+                 const std::vector<std::string>& values) {
+                std::vector<std::vector<uint8_t>> values_;
+                values_.reserve(values.size());
+                for (const auto& value : values) {
+                  values_.emplace_back(value.begin(), value.end());
+                }
+                store.multiSet(keys, values_);
+              },
+              py::call_guard<py::gil_scoped_release>())
+          .def(
+              "multi_get",
+              [](::c10d::Store& store, const std::vector<std::string>& keys) {
+                std::vector<std::vector<uint8_t>> values;
+                {
+                  py::gil_scoped_release release;
+                  values = store.multiGet(keys);
+                }
+                py::list result;
+                for (const auto& value : values) {
+                  result.append(py::bytes(
+                      reinterpret_cast<const char*>(value.data()),
+                      value.size()));
+                }
+                return result;
+              })
           .def(
               "add",
               &::c10d::Store::add,
@@ -557,18 +668,75 @@ They are used in specifying strategies for reduction collectives, e.g.,
       py::arg("process_groups"),
       py::call_guard<py::gil_scoped_release>());
 
+  module.def(
+      "_hierarchical_process_group",
+      [](const std::shared_ptr<::c10d::Store>& store,
+         int rank,
+         int size,
+         py::function factory,
+         int localSize,
+         bool useReduceScatter) -> std::shared_ptr<::c10d::ProcessGroup> {
+        ::c10d::ProcessGroupHierarchical::Options options;
+        options.localSize = localSize;
+        options.useReduceScatter = useReduceScatter;
+        auto createProcessGroup =
+            [&factory](const std::shared_ptr<::c10d::Store>& store,
+                       int rank,
+                       int size) {
+              py::gil_scoped_acquire acquire;
+              return factory(store, rank, size)
+                  .cast<std::shared_ptr<::c10d::ProcessGroup>>();
+            };
+        return std::make_shared<::c10d::ProcessGroupHierarchical>(
+            store, rank, size, createProcessGroup, options);
+      },
+      py::arg("store"),
+      py::arg("rank"),
+      py::arg("size"),
+      py::arg("factory"),
+      py::arg("local_size") = 0,
+      py::arg("use_reduce_scatter") = true,
+      py::call_guard<py::gil_scoped_release>(),
+      R"(
+Creates a process group that runs allreduce in two levels: within each node,
+and across nodes. ``factory(store, rank, size)`` is called to create the
+intra-node, inter-node, and global process groups. If ``local_size`` is 0,
+processes are grouped into nodes by hostname. Pass ``use_reduce_scatter=False``
+if the process groups created by ``factory`` don't support reduce_scatter.
+)");
+
 #ifdef USE_C10D_GLOO
   auto processGroupGloo = shared_ptr_class_<::c10d::ProcessGroupGloo>(
       module, "ProcessGroupGloo", processGroup);
 
   shared_ptr_class_<::gloo::transport::Device>(processGroupGloo, "Device");
 
+  py::enum_<::c10d::ProcessGroupGloo::CudaAllreduceAlgorithm>(
+      processGroupGloo, "CudaAllreduceAlgorithm")
+      .value("AUTO", ::c10d::ProcessGroupGloo::CudaAllreduceAlgorithm::AUTO)
+      .value("HOST", ::c10d::ProcessGroupGloo::CudaAllreduceAlgorithm::HOST)
+      .value(
+          "RING_CHUNKED",
+          ::c10d::ProcessGroupGloo::CudaAllreduceAlgorithm::RING_CHUNKED)
+      .value(
+          "HALVING_DOUBLING",
+          ::c10d::ProcessGroupGloo::CudaAllreduceAlgorithm::HALVING_DOUBLING);
+
   shared_ptr_class_<::c10d::ProcessGroupGloo::Options>(
       processGroupGloo, "Options")
       .def(py::init<>())
       .def_readwrite("devices", &::c10d::ProcessGroupGloo::Options::devices)
       .def_readwrite("timeout", &::c10d::ProcessGroupGloo::Options::timeout)
-      .def_readwrite("threads", &::c10d::ProcessGroupGloo::Options::threads);
+      .def_readwrite("threads", &::c10d::ProcessGroupGloo::Options::threads)
+      .def_readwrite(
+          "cuda_allreduce_algorithm",
+          &::c10d::ProcessGroupGloo::Options::cudaAllreduceAlgorithm)
+      .def_readwrite(
+          "cuda_allreduce_ring_threshold",
+          &::c10d::ProcessGroupGloo::Options::cudaAllreduceRingThreshold)
+      .def_readwrite(
+          "cuda_allreduce_pipelined",
+          &::c10d::ProcessGroupGloo::Options::cudaAllreducePipelined);
 
   processGroupGloo.def_static(
       "create_device",
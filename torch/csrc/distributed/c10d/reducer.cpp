@@ -1,5 +1,6 @@
 #include <torch/csrc/distributed/c10d/reducer.h>
 
+#include <algorithm>
 #include <functional>
 
 #include <c10/core/DeviceGuard.h>
@@ -25,7 +26,10 @@ Reducer::Reducer(
     std::vector<std::vector<torch::autograd::Variable>> replicas,
     std::vector<std::vector<size_t>> bucket_indices,
     std::shared_ptr<c10d::ProcessGroup> process_group,
-    std::vector<std::vector<bool>> expect_sparse_gradients)
+    std::vector<std::vector<bool>> expect_sparse_gradients,
+    int64_t bucket_bytes_cap,
+    bool gradient_as_bucket_view,
+    bool find_unused_parameters_by_hooks)
     : replicas_(std::move(replicas)),
       process_group_(std::move(process_group)),
       expect_sparse_gradients_(std::move(expect_sparse_gradients)),
@@ -33,7 +37,12 @@ Reducer::Reducer(
       require_finalize_(false),
       next_bucket_(0),
       has_marked_unused_parameters_(false),
+      find_unused_parameters_by_hooks_(find_unused_parameters_by_hooks),
       local_used_maps_reduced_(false),
+      bucket_bytes_cap_(bucket_bytes_cap),
+      has_rebuilt_bucket_(false),
+      num_iterations_(0),
+      gradient_as_bucket_view_(gradient_as_bucket_view),
       backward_stats_base_(0) {
   C10_LOG_API_USAGE_ONCE("torch.distributed.ddp.reducer");
 
@@ -149,6 +158,8 @@ Reducer::Reducer(
         backward_stats_.begin(),
         backward_stats_.end(),
         [=](std::vector<int64_t>& v) { v.resize(variable_count); });
+    marked_ready_.assign(
+        replica_count, std::vector<bool>(variable_count, false));
   }
 
   // Initialize locally used parameter maps
@@ -209,7 +220,8 @@ void Reducer::mark_variable_ready_dense(VariableIndex index) {
   // If the gradient is not set, we assume it wasn't computed
   // as part of the current backwards pass, and zero the part
   // of the bucket it would otherwise hold.
-  auto bucket_view = replica.contents.narrow(0, offset, length);
+  auto bucket_view =
+      replica.contents.narrow(0, offset, length).view(variable.sizes());
   auto& grad = variable.grad();
   if (grad.defined()) {
     // Ensure that the gradient type matches the bucket type.
@@ -219,14 +231,18 @@ void Reducer::mark_variable_ready_dense(VariableIndex index) {
         bucket_view.toString(),
         ", got ",
         grad.toString());
-    // Assert that the grad tensor and the bucket don't share storage.
-    // If they did, we could avoid the copy altogether.
-    // The reason for not doing this is that existing code calls
-    // `detach_` from `zero_grad`, which is incompatible with views.
-    TORCH_INTERNAL_ASSERT(!grad.is_alias_of(bucket_view));
     TORCH_INTERNAL_ASSERT(grad.device() == bucket_view.device());
     TORCH_INTERNAL_ASSERT(grad.numel() == bucket_view.numel());
-    bucket_view.copy_(grad.view({-1}), /* non_blocking */ true);
+    // With `gradient_as_bucket_view_` the grad already is the bucket view,
+    // and was accumulated into in place, except in the first iteration, after
+    // the buckets were rebuilt, or if the grad was reset to None. Copy it
+    // into the bucket in those cases only, and keep the view from then on.
+    if (!grad.is_alias_of(bucket_view)) {
+      bucket_view.copy_(grad, /* non_blocking */ true);
+      if (gradient_as_bucket_view_) {
+        grad = bucket_view;
+      }
+    }
   } else {
     bucket_view.zero_();
   }
@@ -271,11 +287,29 @@ void Reducer::autograd_hook(VariableIndex index) {
     return;
   }
 
+  // Record the order in which gradients become ready until the buckets are
+  // rebuilt to follow it. All replicas run the same graph, so the first
+  // replica is representative.
+  if (!has_rebuilt_bucket_ && index.replica_index == 0) {
+    rebuilt_params_order_.push_back(index.variable_index);
+  }
+
   // If there are model parameters that went unused when computing the model
   // output, they won't be part of the autograd graph, and won't receive
   // gradients. These parameters are discovered in the `prepare_for_backward`
   // function and their indexes stored in the `unused_parameters_` vector.
-  if (!has_marked_unused_parameters_ && !unused_parameters_.empty()) {
+  // When they are found by hooks instead, the variables whose hooks haven't
+  // fired by the end of the backward pass are marked ready by a callback.
+  // It is queued before the finalizer, which runs after it.
+  if (find_unused_parameters_by_hooks_) {
+    if (!has_marked_unused_parameters_) {
+      has_marked_unused_parameters_ = true;
+      torch::autograd::Engine::get_default_engine().queue_callback([=] {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        this->mark_unused_variables_ready();
+      });
+    }
+  } else if (!has_marked_unused_parameters_ && !unused_parameters_.empty()) {
     has_marked_unused_parameters_ = true;
     for (const auto& unused_index : unused_parameters_) {
       mark_variable_ready(unused_index);
@@ -295,6 +329,7 @@ void Reducer::mark_variable_ready(VariableIndex index) {
       "Out of range variable index.");
   backward_stats_[replica_index][variable_index] =
       current_time_in_nanos() - backward_stats_base_;
+  marked_ready_[replica_index][variable_index] = true;
 
   // Any time we mark a variable ready (be it in line due to unused parameters,
   // or via an autograd hook), we require a call to the finalize function. If
@@ -379,6 +414,24 @@ void Reducer::mark_variable_ready(VariableIndex index) {
   }
 }
 
+void Reducer::mark_unused_variables_ready() {
+  // The backward pass may have been cut short by an exception, after which
+  // the next iteration reset the accounting.
+  if (!expect_autograd_hooks_) {
+    return;
+  }
+  for (size_t replica_index = 0; replica_index < marked_ready_.size();
+       replica_index++) {
+    const auto& marked_ready = marked_ready_[replica_index];
+    for (size_t variable_index = 0; variable_index < marked_ready.size();
+         variable_index++) {
+      if (!marked_ready[variable_index]) {
+        mark_variable_ready(VariableIndex{replica_index, variable_index});
+      }
+    }
+  }
+}
+
 // Called when the bucket at the specified index is ready to be reduced.
 void Reducer::mark_bucket_ready(size_t bucket_index) {
   TORCH_INTERNAL_ASSERT(bucket_index >= next_bucket_);
@@ -409,14 +462,40 @@ void Reducer::mark_bucket_ready(size_t bucket_index) {
       //
       tensors.push_back(replica.contents);
     }
-    bucket.work = process_group_->allreduce(tensors);
+    // Sparse buckets are always allreduced; hooks operate on flat contents.
+    if (comm_hook_ && !bucket.expect_sparse_gradient) {
+      GradBucket grad_bucket{next_bucket_, std::move(tensors)};
+      bucket.future_result = comm_hook_->runHook(grad_bucket);
+    } else {
+      // The buckets are spread round-robin over the channels of the process
+      // group, so that a large bucket does not hold up the ones after it on
+      // process groups that can run them concurrently.
+      AllreduceOptions opts;
+      opts.channel = next_bucket_;
+      bucket.work = process_group_->allreduce(tensors, opts);
+    }
   }
 }
 
+void Reducer::register_comm_hook(std::unique_ptr<CommHookInterface> comm_hook) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  TORCH_CHECK(comm_hook, "Expected a communication hook.");
+  TORCH_CHECK(
+      !comm_hook_, "register_comm_hook can only be called once per reducer.");
+  TORCH_CHECK(
+      !require_finalize_,
+      "register_comm_hook cannot be called during a backward pass.");
+  comm_hook_ = std::move(comm_hook);
+}
+
 void Reducer::initialize_buckets(
     std::vector<std::vector<size_t>> bucket_indices) {
   std::lock_guard<std::mutex> lock(mutex_);
+  initialize_buckets_locked(std::move(bucket_indices));
+}
 
+void Reducer::initialize_buckets_locked(
+    std::vector<std::vector<size_t>> bucket_indices) {
   // This shouldn't be called if we're expecting autograd hooks to fire.
   TORCH_CHECK(
       !expect_autograd_hooks_,
@@ -560,6 +639,15 @@ void Reducer::prepare_for_backward(
         "list, dict, iterable).");
   }
 
+  // The first iteration recorded the order in which gradients became ready.
+  // Rebuild the buckets to follow it before starting the second one. The
+  // rebuild broadcasts, so it must be triggered by the iteration count, which
+  // is the same on every process, and not by what a process has recorded.
+  if (!has_rebuilt_bucket_ && num_iterations_ > 0) {
+    rebuild_buckets();
+  }
+  num_iterations_++;
+
   // Reset accounting.
   expect_autograd_hooks_ = true;
   next_bucket_ = 0;
@@ -574,11 +662,15 @@ void Reducer::prepare_for_backward(
   // Reset unused parameter accounting.
   has_marked_unused_parameters_ = false;
   unused_parameters_.clear();
+  for (auto& marked_ready : marked_ready_) {
+    std::fill(marked_ready.begin(), marked_ready.end(), false);
+  }
 
   // If no outputs are specified, we assume that autograd hooks for ALL
   // variables will be called, and we don't have to search the autograd graph
-  // for presence of these hooks.
-  if (outputs.empty()) {
+  // for presence of these hooks. With `find_unused_parameters_by_hooks_`,
+  // the variables whose hooks don't fire are found at the end of backward.
+  if (outputs.empty() || find_unused_parameters_by_hooks_) {
     return;
   }
 
@@ -616,6 +708,63 @@ void Reducer::prepare_for_backward(
   }
 }
 
+void Reducer::rebuild_buckets() {
+  TORCH_INTERNAL_ASSERT(!expect_autograd_hooks_);
+  const auto variable_count = replicas_[0].size();
+
+  // Variables whose hooks didn't fire (e.g. unused parameters) go last, in
+  // reverse order of registration like the initial assignment.
+  std::vector<int64_t> order;
+  order.reserve(variable_count);
+  std::vector<bool> seen(variable_count, false);
+  for (const auto variable_index : rebuilt_params_order_) {
+    if (!seen[variable_index]) {
+      seen[variable_index] = true;
+      order.push_back(variable_index);
+    }
+  }
+  for (size_t i = variable_count; i-- > 0;) {
+    if (!seen[i]) {
+      order.push_back(i);
+    }
+  }
+  rebuilt_params_order_.clear();
+  has_rebuilt_bucket_ = true;
+
+  // Autograd may run hooks in a different order on different processes, but
+  // the bucket assignment must be identical everywhere; use that of rank 0.
+  std::vector<at::Tensor> order_tensor = {
+      at::tensor(order, at::kLong).to(replicas_[0][0].device())};
+  process_group_->broadcast(order_tensor)->wait();
+  const auto synced_order = order_tensor[0].cpu();
+  const auto synced_order_data = synced_order.data_ptr<int64_t>();
+
+  std::vector<at::Tensor> tensors;
+  std::vector<bool> expect_sparse_gradient;
+  tensors.reserve(variable_count);
+  expect_sparse_gradient.reserve(variable_count);
+  for (size_t i = 0; i < variable_count; i++) {
+    const auto variable_index = synced_order_data[i];
+    tensors.push_back(replicas_[0][variable_index]);
+    expect_sparse_gradient.push_back(
+        expect_sparse_gradients_[0][variable_index]);
+  }
+
+  // Buckets come back ordered by the position of their first tensor, i.e.
+  // in the order they become ready. Map positions back to variable indices.
+  auto bucket_indices = compute_bucket_assignment_by_size(
+      tensors,
+      {static_cast<size_t>(kDefaultFirstBucketBytes),
+       static_cast<size_t>(bucket_bytes_cap_)},
+      expect_sparse_gradient);
+  for (auto& bucket : bucket_indices) {
+    for (auto& index : bucket) {
+      index = synced_order_data[index];
+    }
+  }
+  initialize_buckets_locked(std::move(bucket_indices));
+}
+
 // A bucket with one or more dense tensors needs to be unflattened.
 void Reducer::finalize_bucket_dense(Bucket& bucket) {
   for (size_t replica_index = 0; replica_index < bucket.replicas.size();
@@ -669,9 +818,14 @@ void Reducer::finalize_bucket_dense(Bucket& bucket) {
       // If a parameter is globally unused, we keep its grad untouched.
       if (!global_unused) {
         if (!grad.defined()) {
-          grad = at::empty(bucket_view.sizes(), bucket_view.options());
+          grad = gradient_as_bucket_view_
+              ? bucket_view
+              : at::empty(bucket_view.sizes(), bucket_view.options());
+        }
+        // A grad that is a view of the bucket holds the result already.
+        if (!grad.is_alias_of(bucket_view)) {
+          grad.copy_(bucket_view);
         }
-        grad.copy_(bucket_view);
       }
     }
   }
@@ -704,8 +858,19 @@ void Reducer::finalize_backward() {
 
   // Wait for asynchronous reduction to complete and unflatten contents.
   for (auto& bucket : buckets_) {
-    TORCH_INTERNAL_ASSERT(bucket.work);
-    bucket.work->wait();
+    if (bucket.future_result.valid()) {
+      const auto result = bucket.future_result.get();
+      TORCH_INTERNAL_ASSERT(result.size() == bucket.replicas.size());
+      for (size_t i = 0; i < result.size(); i++) {
+        auto& contents = bucket.replicas[i].contents;
+        if (!result[i].is_same(contents)) {
+          contents.copy_(result[i]);
+        }
+      }
+    } else {
+      TORCH_INTERNAL_ASSERT(bucket.work);
+      bucket.work->wait();
+    }
     if (bucket.expect_sparse_gradient) {
       finalize_bucket_sparse(bucket);
     } else {
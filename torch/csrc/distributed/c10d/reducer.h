@@ -1,6 +1,7 @@
 #pragma once
 
 #include <atomic>
+#include <future>
 #include <memory>
 #include <mutex>
 #include <tuple>
@@ -9,21 +10,53 @@
 
 #include <c10d/ProcessGroup.hpp>
 #include <torch/csrc/autograd/function.h>
+#include <torch/csrc/distributed/c10d/comm_hooks.h>
 #include <torch/csrc/autograd/variable.h>
 
 namespace c10d {
 
+// Size limits for the buckets assigned by the reducer itself when it rebuilds
+// buckets. The first bucket is kept small so that its reduction can start as
+// early as possible. These match the defaults of DistributedDataParallel.
+constexpr int64_t kDefaultFirstBucketBytes = int64_t(1024 * 1024);
+constexpr int64_t kDefaultBucketBytesCap = int64_t(25 * 1024 * 1024);
+
 class Reducer {
  public:
   // The constructor takes a list of variables for every model replica.
   // The bucket assignment for this reducer is specified as a list of
   // buckets, each of which is specified as a list of indices into the
   // variables list for **a single replica** (i.e. `variables[0]`).
+  //
+  // The initial assignment only approximates the order in which gradients
+  // become ready. During the first iteration the reducer records the actual
+  // order and, at the start of the second iteration, rebuilds the buckets
+  // once to follow it, capping buckets at `bucket_bytes_cap` bytes.
+  //
+  // With `gradient_as_bucket_view`, the dense gradients become views of the
+  // bucket contents the first time they are copied into a bucket. From then
+  // on, gradient accumulation writes directly into bucket memory and neither
+  // the copy into the bucket nor the copy back out of it is needed. The
+  // gradients must then not be detached in place, which `zero_grad` of
+  // modules and optimizers takes care of.
+  //
+  // With `find_unused_parameters_by_hooks`, unused parameters are not found
+  // by traversing the autograd graph from the outputs passed to
+  // `prepare_for_backward`. Instead, the parameters whose hooks haven't fired
+  // by the end of the backward pass are marked ready then, from a callback of
+  // the autograd engine queued by the first hook. This saves the traversal of
+  // the graph every iteration, at the cost of reducing the buckets of unused
+  // parameters only at the end of the backward pass. It doesn't support
+  // reentrant backward passes, whose callbacks run at the end of the inner
+  // pass.
   explicit Reducer(
       std::vector<std::vector<torch::autograd::Variable>> replicas,
       std::vector<std::vector<size_t>> bucket_indices,
       std::shared_ptr<c10d::ProcessGroup> process_group,
-      std::vector<std::vector<bool>> expect_sparse_gradients);
+      std::vector<std::vector<bool>> expect_sparse_gradients,
+      int64_t bucket_bytes_cap = kDefaultBucketBytesCap,
+      bool gradient_as_bucket_view = false,
+      bool find_unused_parameters_by_hooks = false);
 
   ~Reducer() noexcept(false);
 
@@ -37,6 +70,7 @@ class Reducer {
   // and the user wishes to reduce gradients in the backwards pass.
   // If they don't, and wish to accumulate gradients before reducing them,
   // a call to this function can simply be omitted.
+  // The outputs are ignored with `find_unused_parameters_by_hooks`.
   void prepare_for_backward(
       const std::vector<torch::autograd::Variable>& outputs);
 
@@ -47,6 +81,22 @@ class Reducer {
     return backward_stats_;
   }
 
+  // Returns the indices of the variables in every bucket, in the order the
+  // buckets are reduced.
+  std::vector<std::vector<size_t>> get_bucket_indices() const {
+    std::vector<std::vector<size_t>> bucket_indices;
+    bucket_indices.reserve(buckets_.size());
+    for (const auto& bucket : buckets_) {
+      bucket_indices.push_back(bucket.variable_indices);
+    }
+    return bucket_indices;
+  }
+
+  // Registers a hook that replaces the allreduce of dense buckets, e.g. to
+  // compress gradients before communicating them. See comm_hooks.h.
+  // Can only be called once.
+  void register_comm_hook(std::unique_ptr<CommHookInterface> comm_hook);
+
  protected:
   // Forward declaration.
   struct Bucket;
@@ -74,6 +124,11 @@ class Reducer {
 
   bool has_marked_unused_parameters_;
   std::vector<VariableIndex> unused_parameters_;
+  // Whether the variables of every replica were marked ready in the current
+  // iteration, to find those whose hooks didn't fire with
+  // `find_unused_parameters_by_hooks`.
+  const bool find_unused_parameters_by_hooks_;
+  std::vector<std::vector<bool>> marked_ready_;
   // Locally used parameter maps indicating if parameters are used locally
   // during the current iteration or no_sync session if no_sync is on. One
   // tensor for each model replica and each tensor is one-dim int32 tensor of
@@ -92,6 +147,23 @@ class Reducer {
   // Work handle for allreduce on local_used_maps_
   std::shared_ptr<c10d::ProcessGroup::Work> local_used_work_;
 
+  // Byte cap for buckets assigned by rebuild_buckets().
+  const int64_t bucket_bytes_cap_;
+  // Whether the buckets have been rebuilt by gradient ready order. This
+  // happens only once, after the first iteration.
+  bool has_rebuilt_bucket_;
+  // Number of calls to prepare_for_backward, which triggers the rebuild.
+  int64_t num_iterations_;
+  // Indices of the variables of the first replica, in the order their
+  // autograd hooks fired, until the buckets are rebuilt.
+  std::vector<size_t> rebuilt_params_order_;
+
+  // Whether dense gradients are kept as views of the bucket contents.
+  const bool gradient_as_bucket_view_;
+
+  // Communication hook for dense buckets, if registered.
+  std::unique_ptr<CommHookInterface> comm_hook_;
+
   void mark_variable_ready_dense(VariableIndex index);
 
   void mark_variable_ready_sparse(VariableIndex index);
@@ -100,6 +172,10 @@ class Reducer {
 
   void autograd_hook(VariableIndex index);
 
+  // Marks ready the variables whose hooks didn't fire in this backward pass.
+  // Must be called with mutex_ held.
+  void mark_unused_variables_ready();
+
   void mark_bucket_ready(size_t bucket_index);
 
   void finalize_bucket_dense(Bucket& replica);
@@ -108,6 +184,17 @@ class Reducer {
 
   void finalize_backward();
 
+  // Must be called with mutex_ held.
+  void initialize_buckets_locked(
+      std::vector<std::vector<size_t>> bucket_indices);
+
+  // Reassigns buckets by the order recorded in `rebuilt_params_order_`. The
+  // order of rank 0 is broadcast so that all processes agree on the new
+  // assignment. Every process calls it at the start of the second iteration,
+  // whether or not it recorded any order. Must be called with mutex_ held,
+  // between iterations.
+  void rebuild_buckets();
+
   // A bucket replica represents [1..N] gradients to be reduced,
   // with the same dtype, on the same device.
   //
@@ -160,6 +247,9 @@ class Reducer {
     // Keep work handle around when this set of buckets is being reduced.
     std::shared_ptr<c10d::ProcessGroup::Work> work;
 
+    // Reduced contents, per replica, if a communication hook is registered.
+    std::future<std::vector<at::Tensor>> future_result;
+
     // If this bucket should expect a single sparse gradient.
     // Implies: replicas[i].variables.size() == 1.
     bool expect_sparse_gradient = false;
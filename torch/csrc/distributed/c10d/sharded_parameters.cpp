@@ -0,0 +1,188 @@
+#include <torch/csrc/distributed/c10d/sharded_parameters.h>
+
+#include <c10/util/Exception.h>
+
+namespace c10d {
+
+ShardedParameters::ShardedParameters(
+    std::vector<at::Tensor> parameters,
+    std::shared_ptr<ProcessGroup> process_group,
+    int64_t bucket_bytes_cap)
+    : parameters_(std::move(parameters)),
+      process_group_(std::move(process_group)) {
+  TORCH_CHECK(
+      bucket_bytes_cap > 0,
+      "Expected a positive bucket_bytes_cap, got ",
+      bucket_bytes_cap);
+  for (const auto& parameter : parameters_) {
+    TORCH_CHECK(parameter.defined(), "Expected defined parameters.");
+    TORCH_CHECK(
+        !parameter.is_sparse(), "ShardedParameters requires dense parameters.");
+    TORCH_CHECK(
+        parameter.device() == parameters_[0].device(),
+        "ShardedParameters requires all parameters on the same device, "
+        "got ",
+        parameter.device(),
+        " and ",
+        parameters_[0].device());
+  }
+
+  const int64_t world_size = process_group_->getSize();
+  const int64_t rank = process_group_->getRank();
+  const auto bucket_indices = compute_bucket_assignment_by_size(
+      parameters_, {static_cast<size_t>(bucket_bytes_cap)});
+  parameter_bucket_.resize(parameters_.size());
+  buckets_.reserve(bucket_indices.size());
+  shards_.reserve(bucket_indices.size());
+  for (const auto& indices : bucket_indices) {
+    Bucket bucket;
+    bucket.parameter_indices = indices;
+    for (const auto index : indices) {
+      parameter_bucket_[index] = buckets_.size();
+      bucket.numel += parameters_[index].numel();
+    }
+    bucket.shard_numel = (bucket.numel + world_size - 1) / world_size;
+
+    std::vector<at::Tensor> data;
+    data.reserve(indices.size());
+    for (const auto index : indices) {
+      data.push_back(parameters_[index].detach());
+    }
+    auto shard = flatten_padded(bucket, data)
+                     .narrow(0, rank * bucket.shard_numel, bucket.shard_numel)
+                     .clone();
+    shards_.push_back(shard.requires_grad_(true));
+    buckets_.push_back(std::move(bucket));
+  }
+}
+
+size_t ShardedParameters::bucket_index(size_t parameter_index) const {
+  TORCH_CHECK(
+      parameter_index < parameter_bucket_.size(),
+      "Parameter index ",
+      parameter_index,
+      " is out of range for ",
+      parameter_bucket_.size(),
+      " parameters.");
+  return parameter_bucket_[parameter_index];
+}
+
+void ShardedParameters::reduce_scatter_gradients() {
+  // The pending all-gathers read the shards that the optimizer step after
+  // this writes to.
+  wait_for_all();
+
+  const int64_t world_size = process_group_->getSize();
+  std::vector<std::vector<std::vector<at::Tensor>>> inputs(buckets_.size());
+  std::vector<std::shared_ptr<ProcessGroup::Work>> works;
+  works.reserve(buckets_.size());
+  for (size_t i = 0; i < buckets_.size(); i++) {
+    const auto& bucket = buckets_[i];
+    std::vector<at::Tensor> grads;
+    grads.reserve(bucket.parameter_indices.size());
+    for (const auto index : bucket.parameter_indices) {
+      const auto& grad = parameters_[index].grad();
+      if (!grad.defined()) {
+        // Parameters that were not used contribute nothing to the sum.
+        grads.push_back(at::zeros_like(parameters_[index].detach()));
+        continue;
+      }
+      TORCH_CHECK(
+          !grad.is_sparse(), "ShardedParameters requires dense gradients.");
+      grads.push_back(grad);
+    }
+    // Like the Reducer, divide before the sum to get the average.
+    auto flat = flatten_padded(bucket, grads);
+    flat.div_(world_size);
+    inputs[i] = {split_shards(bucket, flat)};
+
+    auto& shard_grad = shards_[i].grad();
+    if (!shard_grad.defined()) {
+      shard_grad = at::empty_like(shards_[i].detach());
+    }
+    std::vector<at::Tensor> outputs = {shard_grad};
+    works.push_back(process_group_->reduce_scatter(outputs, inputs[i]));
+  }
+  for (auto& work : works) {
+    work->wait();
+  }
+}
+
+void ShardedParameters::all_gather_parameters() {
+  wait_for_all();
+
+  const int64_t world_size = process_group_->getSize();
+  for (size_t i = 0; i < buckets_.size(); i++) {
+    auto& bucket = buckets_[i];
+    auto shard = shards_[i].detach();
+    bucket.gathered =
+        at::empty({world_size * bucket.shard_numel}, shard.options());
+    std::vector<std::vector<at::Tensor>> outputs = {
+        split_shards(bucket, bucket.gathered)};
+    std::vector<at::Tensor> inputs = {shard};
+    bucket.work = process_group_->allgather(outputs, inputs);
+  }
+}
+
+void ShardedParameters::wait_for_bucket(size_t bucket_index) {
+  TORCH_CHECK(
+      bucket_index < buckets_.size(),
+      "Bucket index ",
+      bucket_index,
+      " is out of range for ",
+      buckets_.size(),
+      " buckets.");
+  auto& bucket = buckets_[bucket_index];
+  if (!bucket.work) {
+    return;
+  }
+  bucket.work->wait();
+  bucket.work.reset();
+
+  int64_t offset = 0;
+  for (const auto index : bucket.parameter_indices) {
+    auto parameter = parameters_[index].detach();
+    const auto numel = parameter.numel();
+    parameter.copy_(
+        bucket.gathered.narrow(0, offset, numel).view_as(parameter));
+    offset += numel;
+  }
+  bucket.gathered = at::Tensor();
+}
+
+void ShardedParameters::wait_for_all() {
+  for (size_t i = 0; i < buckets_.size(); i++) {
+    wait_for_bucket(i);
+  }
+}
+
+at::Tensor ShardedParameters::flatten_padded(
+    const Bucket& bucket,
+    const std::vector<at::Tensor>& tensors) const {
+  const auto padded_numel = process_group_->getSize() * bucket.shard_numel;
+  std::vector<at::Tensor> pieces;
+  pieces.reserve(tensors.size() + 1);
+  for (const auto& tensor : tensors) {
+    pieces.push_back(tensor.reshape(-1));
+  }
+  if (padded_numel > bucket.numel) {
+    pieces.push_back(
+        at::zeros({padded_numel - bucket.numel}, tensors[0].options()));
+  }
+  return at::cat(pieces);
+}
+
+std::vector<at::Tensor> ShardedParameters::split_shards(
+    const Bucket& bucket,
+    at::Tensor& flat) const {
+  std::vector<at::Tensor> shards;
+  const auto world_size = process_group_->getSize();
+  shards.reserve(world_size);
+  for (int64_t i = 0; i < world_size; i++) {
+    shards.push_back(
+        flat.narrow(0, i * bucket.shard_numel, bucket.shard_numel));
+  }
+  return shards;
+}
+
+} // namespace c10d
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <ATen/ATen.h>
+#include <c10d/ProcessGroup.hpp>
+#include <torch/csrc/distributed/c10d/reducer.h>
+
+namespace c10d {
+
+// Partitions the parameters of a data parallel model and the state of their
+// optimizer across the processes of a process group (ZeRO stage 1, Rajbhandari
+// et al., 2019).
+//
+// The parameters are grouped into buckets of at most `bucket_bytes_cap`
+// bytes, like the buckets of the Reducer. Every bucket is viewed as a flat
+// tensor that is split into one contiguous shard per process. This process
+// owns the shards returned by `shards()`: a local optimizer constructed over
+// them keeps state for 1 / world_size of the model only.
+//
+// One training iteration is:
+//
+//   1. `reduce_scatter_gradients()` after the backward pass, which sets the
+//      gradients of the shards to the average of the gradients of the
+//      parameters they hold across processes. It replaces the allreduce of
+//      DistributedDataParallel, so the model must not be wrapped in it.
+//   2. A step of the local optimizer, which updates the shards.
+//   3. `all_gather_parameters()`, which starts gathering the updated shards
+//      of all processes into the parameters, bucket by bucket.
+//   4. `wait_for_bucket(bucket_index(i))` before parameter i is used by the
+//      next forward pass, or `wait_for_all()`. The buckets are in the order of
+//      the parameters, so waiting for them as the forward pass reaches them
+//      overlaps the rest of the all-gathers with the computation.
+//
+// All processes must pass the same parameters in the same order. The
+// parameters should start out identical (e.g. broadcast from one process);
+// after the first all-gather they are in any case.
+//
+// Only dense parameters on a single device per process are supported, and
+// the process group must implement reduce_scatter and allgather (e.g. NCCL).
+class ShardedParameters {
+ public:
+  explicit ShardedParameters(
+      std::vector<at::Tensor> parameters,
+      std::shared_ptr<ProcessGroup> process_group,
+      int64_t bucket_bytes_cap = kDefaultBucketBytesCap);
+
+  // The shards owned by this process, one per bucket. They are leaf tensors
+  // that require gradients, to be passed to the local optimizer.
+  const std::vector<at::Tensor>& shards() const {
+    return shards_;
+  }
+
+  // The index of the bucket that holds the parameter at `parameter_index`.
+  size_t bucket_index(size_t parameter_index) const;
+
+  size_t num_buckets() const {
+    return buckets_.size();
+  }
+
+  void reduce_scatter_gradients();
+
+  void all_gather_parameters();
+
+  // Waits for the all-gather of the bucket, if one is pending, and copies its
+  // result into the parameters of the bucket. For process groups that run
+  // their collectives on separate CUDA streams the wait only makes the
+  // current stream wait for them, without blocking the caller.
+  void wait_for_bucket(size_t bucket_index);
+
+  void wait_for_all();
+
+ protected:
+  struct Bucket {
+    // Indices of the parameters in the bucket, in order.
+    std::vector<size_t> parameter_indices;
+    // The number of elements of the parameters in the bucket.
+    int64_t numel = 0;
+    // The number of elements of every shard. The flat bucket is padded with
+    // zeros to world_size * shard_numel elements.
+    int64_t shard_numel = 0;
+    // The flat bucket that the pending all-gather writes to, if any.
+    at::Tensor gathered;
+    std::shared_ptr<ProcessGroup::Work> work;
+  };
+
+  // The flat concatenation of `tensors` (one per parameter of the bucket),
+  // padded with zeros to world_size * shard_numel elements.
+  at::Tensor flatten_padded(
+      const Bucket& bucket,
+      const std::vector<at::Tensor>& tensors) const;
+
+  // The world_size shards of a flat padded bucket, as views.
+  std::vector<at::Tensor> split_shards(const Bucket& bucket, at::Tensor& flat)
+      const;
+
+  std::vector<at::Tensor> parameters_;
+  std::shared_ptr<ProcessGroup> process_group_;
+  std::vector<Bucket> buckets_;
+  std::vector<at::Tensor> shards_;
+  // Bucket index for every parameter.
+  std::vector<size_t> parameter_bucket_;
+};
+
+} // namespace c10d
@@ -371,6 +371,11 @@ If the future completes with an error, an exception is thrown.
                   :meth:`~torch.distributed.rpc.rpc_async` if necessary.
               init_method (str, optional): The URL to initialize
                   ``ProcessGroupGloo`` (default: ``env://``).
+              coalesce_latency_budget_us (int, optional): How long, in
+                  microseconds, a small message may wait for more messages
+                  to the same destination so that they are sent together in
+                  one frame (default: 0, which only coalesces messages that
+                  are already queued).
 
 
           Example::
@@ -392,15 +397,23 @@ If the future completes with an error, an exception is thrown.
               >>> # omitting init_rpc invocation on worker2
       )")
       .def(
-          py::init<int, float, std::string>(),
+          py::init<int, float, std::string, int64_t>(),
           py::arg("num_send_recv_threads") = kDefaultNumSendRecvThreads,
           py::arg("rpc_timeout") = kDefaultRpcTimeoutSeconds,
-          py::arg("init_method") = kDefaultInitMethod)
+          py::arg("init_method") = kDefaultInitMethod,
+          py::arg("coalesce_latency_budget_us") = 0)
       .def_readwrite(
           "num_send_recv_threads",
           &ProcessGroupRpcBackendOptions::numSendRecvThreads,
           R"(
               The number of threads in the thread-pool used by ProcessGroupAgent.
+          )")
+      .def_readwrite(
+          "coalesce_latency_budget_us",
+          &ProcessGroupRpcBackendOptions::coalesceLatencyBudgetUs,
+          R"(
+              How long, in microseconds, a small message may wait to be sent
+              in one frame with later messages to the same destination.
           )");
 
   module.attr("_DEFAULT_NUM_SEND_RECV_THREADS") =
@@ -412,11 +425,13 @@ If the future completes with an error, an exception is thrown.
               std::string,
               std::shared_ptr<::c10d::ProcessGroup>,
               int,
-              std::chrono::milliseconds>(),
+              std::chrono::milliseconds,
+              std::chrono::microseconds>(),
           py::arg("name"),
           py::arg("process_group"),
           py::arg("num_send_recv_threads"),
-          py::arg("rpc_timeout"))
+          py::arg("rpc_timeout"),
+          py::arg("coalesce_latency_budget") = std::chrono::microseconds(0))
       .def(
           "get_worker_info",
           (const WorkerInfo& (ProcessGroupAgent::*)(void)const) &
@@ -450,7 +465,16 @@ If the future completes with an error, an exception is thrown.
       module, "TensorPipeRpcBackendOptions", rpcBackendOptions)
       .def(py::init<>())
       .def_readwrite(
-          "worker_name_to_id", &TensorPipeRpcBackendOptions::workerNameToId);
+          "worker_name_to_id", &TensorPipeRpcBackendOptions::workerNameToId)
+      .def_readwrite(
+          "device_maps",
+          &TensorPipeRpcBackendOptions::deviceMaps,
+          R"(For every destination worker name, a dict that maps the CUDA
+              device indices of this worker to those of the destination.
+              CUDA tensors sent to the destination are received on the
+              mapped devices, and CUDA tensors in its responses on the
+              devices that map to theirs. Unmapped devices keep their
+              index.)");
 
   shared_ptr_class_<TensorPipeAgent>(module, "TensorPipeAgent", rpcAgent)
       .def(
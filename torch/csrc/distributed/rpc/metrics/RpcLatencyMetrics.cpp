@@ -0,0 +1,203 @@
+#include <torch/csrc/distributed/rpc/metrics/RpcLatencyMetrics.h>
+
+#include <c10/util/Exception.h>
+#include <c10/util/StringUtil.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+namespace {
+
+const char* stageName(RpcStage stage) {
+  switch (stage) {
+    case RpcStage::SERIALIZATION:
+      return "serialization";
+    case RpcStage::DESERIALIZATION:
+      return "deserialization";
+    case RpcStage::SEND_QUEUEING:
+      return "send_queueing";
+    case RpcStage::RECV_QUEUEING:
+      return "recv_queueing";
+    case RpcStage::EXECUTION:
+      return "execution";
+    case RpcStage::ROUND_TRIP:
+      return "round_trip";
+    default:
+      break;
+  }
+  TORCH_INTERNAL_ASSERT(false, "Unknown RPC stage");
+  return "";
+}
+
+std::string messageTypeName(MessageType type) {
+  switch (type) {
+    case MessageType::SCRIPT_CALL:
+      return "script_call";
+    case MessageType::SCRIPT_RET:
+      return "script_ret";
+    case MessageType::PYTHON_CALL:
+      return "python_call";
+    case MessageType::PYTHON_RET:
+      return "python_ret";
+    case MessageType::SCRIPT_REMOTE_CALL:
+      return "script_remote_call";
+    case MessageType::PYTHON_REMOTE_CALL:
+      return "python_remote_call";
+    case MessageType::REMOTE_RET:
+      return "remote_ret";
+    case MessageType::SCRIPT_RREF_FETCH_CALL:
+      return "script_rref_fetch_call";
+    case MessageType::PYTHON_RREF_FETCH_CALL:
+      return "python_rref_fetch_call";
+    case MessageType::SCRIPT_RREF_FETCH_RET:
+      return "script_rref_fetch_ret";
+    case MessageType::PYTHON_RREF_FETCH_RET:
+      return "python_rref_fetch_ret";
+    case MessageType::RREF_USER_DELETE:
+      return "rref_user_delete";
+    case MessageType::RREF_FORK_REQUEST:
+      return "rref_fork_request";
+    case MessageType::RREF_CHILD_ACCEPT:
+      return "rref_child_accept";
+    case MessageType::RREF_ACK:
+      return "rref_ack";
+    case MessageType::FORWARD_AUTOGRAD_REQ:
+      return "forward_autograd_req";
+    case MessageType::FORWARD_AUTOGRAD_RESP:
+      return "forward_autograd_resp";
+    case MessageType::BACKWARD_AUTOGRAD_REQ:
+      return "backward_autograd_req";
+    case MessageType::BACKWARD_AUTOGRAD_RESP:
+      return "backward_autograd_resp";
+    case MessageType::CLEANUP_AUTOGRAD_CONTEXT_REQ:
+      return "cleanup_autograd_context_req";
+    case MessageType::CLEANUP_AUTOGRAD_CONTEXT_RESP:
+      return "cleanup_autograd_context_resp";
+    case MessageType::EXCEPTION:
+      return "exception";
+    default:
+      return c10::str("type_", static_cast<int>(type));
+  }
+}
+
+// The upper edge of bucket i, in microseconds.
+int64_t bucketUpperBound(size_t bucket) {
+  return int64_t(1) << bucket;
+}
+
+} // namespace
+
+constexpr size_t LatencyHistogram::kNumBuckets;
+constexpr size_t RpcLatencyMetrics::kNumMessageTypes;
+
+void LatencyHistogram::record(std::chrono::microseconds latency) {
+  const int64_t micros = std::max<int64_t>(latency.count(), 0);
+  size_t bucket = 0;
+  while (bucket + 1 < kNumBuckets && micros >= bucketUpperBound(bucket)) {
+    ++bucket;
+  }
+  buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sumMicros_.fetch_add(micros, std::memory_order_relaxed);
+}
+
+int64_t LatencyHistogram::count() const {
+  return count_.load(std::memory_order_relaxed);
+}
+
+int64_t LatencyHistogram::sumMicros() const {
+  return sumMicros_.load(std::memory_order_relaxed);
+}
+
+int64_t LatencyHistogram::percentileMicros(double percentile) const {
+  TORCH_CHECK(
+      percentile >= 0 && percentile <= 100,
+      "Percentile must be in [0, 100], got ",
+      percentile);
+  // The buckets may be updated concurrently, so sum them up instead of using
+  // count_.
+  std::array<int64_t, kNumBuckets> counts;
+  int64_t total = 0;
+  for (size_t i = 0; i < kNumBuckets; i++) {
+    counts[i] = buckets_[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+  if (total == 0) {
+    return 0;
+  }
+  const auto rank = std::max<int64_t>(
+      1, static_cast<int64_t>(std::ceil(percentile / 100 * total)));
+  int64_t seen = 0;
+  for (size_t i = 0; i < kNumBuckets; i++) {
+    seen += counts[i];
+    if (seen >= rank) {
+      return bucketUpperBound(i);
+    }
+  }
+  return bucketUpperBound(kNumBuckets - 1);
+}
+
+void RpcLatencyMetrics::record(
+    MessageType type,
+    RpcStage stage,
+    std::chrono::microseconds latency) {
+  histograms_[index(type, stage)].record(latency);
+  if (handler_) {
+    handler_->accumulateMetric(
+        c10::str(
+            kRpcMetricsKeyPrefix,
+            "agent.latency.",
+            stageName(stage),
+            "_us.",
+            messageTypeName(type)),
+        latency.count());
+  }
+}
+
+void RpcLatencyMetrics::addToMetrics(
+    std::unordered_map<std::string, std::string>& metrics) const {
+  for (size_t type = 0; type < kNumMessageTypes; type++) {
+    for (size_t stage = 0; stage < static_cast<size_t>(RpcStage::N_STAGES);
+         stage++) {
+      const auto& h = histogram(
+          static_cast<MessageType>(type), static_cast<RpcStage>(stage));
+      const auto count = h.count();
+      if (count == 0) {
+        continue;
+      }
+      const auto prefix = c10::str(
+          "agent.latency.",
+          stageName(static_cast<RpcStage>(stage)),
+          "_us.",
+          messageTypeName(static_cast<MessageType>(type)),
+          ".");
+      metrics[prefix + "count"] = c10::to_string(count);
+      metrics[prefix + "avg"] =
+          c10::to_string(static_cast<double>(h.sumMicros()) / count);
+      metrics[prefix + "p50"] = c10::to_string(h.percentileMicros(50));
+      metrics[prefix + "p99"] = c10::to_string(h.percentileMicros(99));
+    }
+  }
+}
+
+const LatencyHistogram& RpcLatencyMetrics::histogram(
+    MessageType type,
+    RpcStage stage) const {
+  return histograms_[index(type, stage)];
+}
+
+size_t RpcLatencyMetrics::index(MessageType type, RpcStage stage) {
+  const auto typeIndex = static_cast<size_t>(type);
+  TORCH_INTERNAL_ASSERT(
+      typeIndex < kNumMessageTypes, "Unexpected message type ", type);
+  return typeIndex * static_cast<size_t>(RpcStage::N_STAGES) +
+      static_cast<size_t>(stage);
+}
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
@@ -0,0 +1,93 @@
+#pragma once
+#include <torch/csrc/distributed/rpc/message.h>
+#include <torch/csrc/distributed/rpc/metrics/RpcMetricsHandler.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <unordered_map>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+// A histogram of latencies with logarithmic buckets: bucket 0 counts
+// latencies below 1us, and bucket i > 0 those in [2^(i-1), 2^i) us. Recording
+// is lock-free, so it can be done on the hot path of an agent.
+class TORCH_API LatencyHistogram {
+ public:
+  static constexpr size_t kNumBuckets = 40;
+
+  void record(std::chrono::microseconds latency);
+
+  int64_t count() const;
+  int64_t sumMicros() const;
+  // An upper bound of the latency at the given percentile in [0, 100], i.e.
+  // the upper edge of the bucket it falls into. Returns 0 if empty.
+  int64_t percentileMicros(double percentile) const;
+
+ private:
+  std::array<std::atomic<int64_t>, kNumBuckets> buckets_{};
+  std::atomic<int64_t> count_{0};
+  std::atomic<int64_t> sumMicros_{0};
+};
+
+// The stages an RPC goes through. Together they show where the time of an
+// RPC goes: the network time of a request is its round trip minus the
+// (de)serialization, queueing and execution time on both ends.
+enum class RpcStage {
+  // Turning a message into bytes on the sender.
+  SERIALIZATION = 0,
+  // Turning bytes into a message on the receiver.
+  DESERIALIZATION,
+  // From handing a message to the agent until it starts being sent.
+  SEND_QUEUEING,
+  // From receiving a message until a thread starts processing it, which
+  // grows when the thread pool of the agent is saturated.
+  RECV_QUEUEING,
+  // From starting to process a request until its response is ready.
+  EXECUTION,
+  // From sending a request until its response is processed on the caller.
+  ROUND_TRIP,
+
+  N_STAGES,
+};
+
+// Latency histograms of every stage per message type, for an RpcAgent.
+// Every latency is also passed to the RpcMetricsHandler, if there is one, as
+// kRpcMetricsKeyPrefix + "agent.latency.<stage>_us.<message type>", so that
+// it can be exported to a time-series system.
+class TORCH_API RpcLatencyMetrics {
+ public:
+  // The handler is not owned, and may be null.
+  explicit RpcLatencyMetrics(RpcMetricsHandler* handler = nullptr)
+      : handler_(handler) {}
+
+  void record(
+      MessageType type,
+      RpcStage stage,
+      std::chrono::microseconds latency);
+
+  // Adds "agent.latency.<stage>_us.<message type>.{count,avg,p50,p99}" for
+  // every histogram that has data.
+  void addToMetrics(std::unordered_map<std::string, std::string>& metrics) const;
+
+  const LatencyHistogram& histogram(MessageType type, RpcStage stage) const;
+
+  // Enough for all MessageType values.
+  static constexpr size_t kNumMessageTypes = 64;
+
+ private:
+  static size_t index(MessageType type, RpcStage stage);
+
+  std::array<
+      LatencyHistogram,
+      kNumMessageTypes * static_cast<size_t>(RpcStage::N_STAGES)>
+      histograms_;
+  RpcMetricsHandler* const handler_;
+};
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
@@ -0,0 +1,11 @@
+#include <torch/csrc/distributed/rpc/metrics/RpcMetricsHandler.h>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+C10_DEFINE_REGISTRY(RpcMetricsHandlerRegistry, RpcMetricsHandler);
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
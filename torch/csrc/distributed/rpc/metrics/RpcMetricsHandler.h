@@ -1,4 +1,5 @@
 #pragma once
+#include <c10/util/Registry.h>
 #include <string>
 
 namespace torch {
@@ -20,6 +21,12 @@ class RpcMetricsHandler {
   virtual ~RpcMetricsHandler() {}
 };
 
+// RPC agents log their metrics to the handler registered under this key, if
+// there is one.
+constexpr char kRpcMetricsHandlerKey[] = "default";
+
+C10_DECLARE_REGISTRY(RpcMetricsHandlerRegistry, RpcMetricsHandler);
+
 } // namespace rpc
 } // namespace distributed
 } // namespace torch
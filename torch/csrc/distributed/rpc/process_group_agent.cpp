@@ -13,8 +13,49 @@ namespace rpc {
 
 namespace {
 constexpr auto kSecToMsConversion = 1000;
+
+// Messages up to this size, counting the payload and the tensor storages, are
+// serialized into the frame itself and may share it with other messages.
+// Larger messages are sent in a frame of their own, with their tensor data in
+// separate buffers.
+constexpr size_t kMaxCoalescedMessageBytes = 64 * 1024;
+// Once a frame reaches either limit, no more messages are added to it.
+constexpr size_t kMaxFrameBytes = 1024 * 1024;
+constexpr size_t kMaxMessagesPerFrame = 128;
+
+// Every message in a frame is prefixed by its type, id, whether it is
+// serialized inline, and the size of its serialized section.
+constexpr size_t kFrameEntryHeaderItems = 4;
+
+size_t messageBytes(const Message& message) {
+  size_t bytes = message.payload().size();
+  for (const auto& tensor : message.tensors()) {
+    bytes += tensor.storage().nbytes();
+  }
+  return bytes;
+}
+
+void appendFrameEntry(
+    std::string& frame,
+    const Message& message,
+    bool inlined,
+    const std::string& section) {
+  const int64_t header[kFrameEntryHeaderItems] = {
+      (int64_t)message.type(),
+      message.id(),
+      (int64_t)inlined,
+      (int64_t)section.size()};
+  frame.append(reinterpret_cast<const char*>(header), sizeof(header));
+  frame.append(section);
 }
 
+std::chrono::microseconds microsecondsSince(
+    const steady_clock_time_point& start) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+}
+} // namespace
+
 //////////////////////////  MessageCounter  /////////////////////////////////
 
 ProcessGroupAgent::MessageCounter::MessageCounter(int worldSize)
@@ -61,6 +102,12 @@ const std::string kGilAverageWaitTime = "agent.gil_average_wait_time_us";
 const std::string kClientActiveCalls = "agent.client_active_calls";
 const std::string kServerActiveCalls = "agent.server_active_calls";
 const std::string kServerActiveAsyncCalls = "agent.server_active_async_calls";
+const std::string kNumSentMessages = "agent.num_sent_messages";
+const std::string kNumSentFrames = "agent.num_sent_frames";
+const std::string kNumCoalescedMessages = "agent.num_coalesced_messages";
+const std::string kNumSentBytes = "agent.num_sent_bytes";
+const std::string kSendQueueDepth = "agent.send_queue_depth";
+const std::string kMaxSendQueueDepth = "agent.max_send_queue_depth";
 
 void ProcessGroupAgent::collectNames() {
   const std::string& workerName = workerInfo_.name_;
@@ -97,7 +144,8 @@ ProcessGroupAgent::ProcessGroupAgent(
     std::string workerName,
     std::shared_ptr<c10d::ProcessGroup> pg,
     int numSendRecvThreads,
-    std::chrono::milliseconds rpcTimeout)
+    std::chrono::milliseconds rpcTimeout,
+    std::chrono::microseconds coalesceLatencyBudget)
     : RpcAgent(
           WorkerInfo(std::move(workerName), (int64_t)pg->getRank()),
           std::make_unique<RequestCallbackImpl>(),
@@ -107,8 +155,19 @@ ProcessGroupAgent::ProcessGroupAgent(
       recvCounts_(pg_->getSize()),
       nextId_(0),
       sendMutexes_(pg_->getSize()),
+      sendQueues_(pg_->getSize()),
+      coalesceLatencyBudget_(coalesceLatencyBudget),
       threadPool_(numSendRecvThreads),
       timeoutThreadEnabled_{false} {
+  TORCH_CHECK(
+      coalesceLatencyBudget_.count() >= 0,
+      "The coalescing latency budget must not be negative, got ",
+      coalesceLatencyBudget_.count(),
+      " microseconds.");
+  if (RpcMetricsHandlerRegistry()->Has(kRpcMetricsHandlerKey)) {
+    metricsHandler_ = RpcMetricsHandlerRegistry()->Create(kRpcMetricsHandlerKey);
+  }
+  latencyMetrics_ = std::make_unique<RpcLatencyMetrics>(metricsHandler_.get());
   // initialize metric info counters
   metrics_.resize(ProcessGroupAgentMetrics::N_METRICS);
   metrics_[ProcessGroupAgentMetrics::GIL_WAIT_TIME] =
@@ -344,7 +403,13 @@ std::shared_ptr<FutureMessage> ProcessGroupAgent::send(
       futures_.emplace(
           std::piecewise_construct,
           std::forward_as_tuple(requestId),
-          std::forward_as_tuple(FutureInfo(future, endTime, to.id_, timeout)));
+          std::forward_as_tuple(FutureInfo(
+              future,
+              endTime,
+              to.id_,
+              timeout,
+              futureStartTime,
+              message.type())));
       // insert future into timeouts map to keep track of its timeout
       auto& requestIds = futureTimeouts_[endTime];
       requestIds.insert(requestId);
@@ -371,14 +436,24 @@ std::shared_ptr<FutureMessage> ProcessGroupAgent::send(
   // to our receiving queue.
   if (to.id_ == (worker_id_t)pg_->getRank()) {
     threadPool_.run(std::bind(
-        [this, future](const Message& message) {
-          // Unlike the other cases, need to add a tensor deleter, since the
-          // data outlives the scope of this function. It's shared_ptr<> due
-          // to c++11 lambda capture limitations with unique_ptr<>.
-          std::unique_ptr<std::string> payload;
+        [this](const Message& message) {
+          // The receiver must not see later changes to the sender's tensors,
+          // so copy every storage once, the way a remote receiver would
+          // receive it.
+          std::vector<char> payload;
+          std::vector<torch::Tensor> tensors;
           try {
-            payload = std::make_unique<std::string>(
-                wireSerialize(message.payload(), message.tensors()));
+            auto serialized =
+                wireSerializeOutOfBand(message.payload(), message.tensors());
+            auto deserialized = wireDeserializeOutOfBand(
+                serialized.first.data(), serialized.first.size());
+            auto& buffers = std::get<2>(deserialized);
+            TORCH_INTERNAL_ASSERT(buffers.size() == serialized.second.size());
+            for (size_t i = 0; i < buffers.size(); i++) {
+              buffers[i].copy_(serialized.second[i]);
+            }
+            payload = std::move(std::get<0>(deserialized));
+            tensors = std::move(std::get<1>(deserialized));
             // only increment sendCounts when the message is indeed added into
             // local recv.
             sendCounts_.increment(pg_->getRank());
@@ -386,18 +461,13 @@ std::shared_ptr<FutureMessage> ProcessGroupAgent::send(
             markFutureWithError(message.id(), e.what());
             return;
           }
-          const char* data = payload->data();
-          size_t len = payload->length();
-          std::string* delete_when_done = payload.release();
           enqueueRecv(RecvWork(
               getWorkerInfo(pg_->getRank()),
-              message.type(),
-              message.id(),
-              torch::from_blob(
-                  (void*)data,
-                  len,
-                  [delete_when_done](void*) { delete delete_when_done; },
-                  {torch::kChar})));
+              Message(
+                  std::move(payload),
+                  std::move(tensors),
+                  message.type(),
+                  message.id())));
         },
         std::move(message)));
     return future;
@@ -416,39 +486,112 @@ std::shared_ptr<FutureMessage> ProcessGroupAgent::send(
   return future;
 }
 
-void ProcessGroupAgent::handleSend(const SendWork& work) {
-  auto serializedPayload = std::make_unique<std::string>(std::move(
-      wireSerialize(work.message_.payload(), work.message_.tensors())));
+void ProcessGroupAgent::handleSend(std::vector<SendWork>& works) {
+  TORCH_INTERNAL_ASSERT(!works.empty());
+  const auto dst = works.front().to_.id_;
+
+  // Small messages are serialized into the frame. For large ones, the frame
+  // only holds the header that describes the message; the data of every
+  // tensor storage follows the frame as a separate buffer that aliases the
+  // storage itself.
+  auto frame = std::make_unique<std::string>();
+  std::vector<torch::Tensor> buffers;
+  std::vector<SendWork> framedWorks;
+  framedWorks.reserve(works.size());
+  for (auto& work : works) {
+    const auto& message = work.message_;
+    const bool inlined = messageBytes(message) <= kMaxCoalescedMessageBytes;
+    latencyMetrics_->record(
+        message.type(),
+        RpcStage::SEND_QUEUEING,
+        microsecondsSince(work.enqueueTime_));
+    std::string section;
+    std::vector<torch::Tensor> sectionBuffers;
+    const auto serializationStart = std::chrono::steady_clock::now();
+    try {
+      if (inlined) {
+        section = wireSerialize(message.payload(), message.tensors());
+      } else {
+        auto serialized =
+            wireSerializeOutOfBand(message.payload(), message.tensors());
+        section = std::move(serialized.first);
+        sectionBuffers = std::move(serialized.second);
+      }
+    } catch (std::exception& e) {
+      handleSendError(work, e);
+      continue;
+    }
+    latencyMetrics_->record(
+        message.type(),
+        RpcStage::SERIALIZATION,
+        microsecondsSince(serializationStart));
+    appendFrameEntry(*frame, message, inlined, section);
+    for (auto& buffer : sectionBuffers) {
+      // The receiver knows the size of every buffer from the header and
+      // doesn't expect empty ones.
+      if (buffer.numel() > 0) {
+        buffers.push_back(std::move(buffer));
+      }
+    }
+    framedWorks.push_back(std::move(work));
+  }
+  works = std::move(framedWorks);
+  if (works.empty()) {
+    return;
+  }
 
   std::vector<torch::Tensor> preamble = {torch::tensor(
       {(int64_t)pg_->getRank(),
-       (int64_t)serializedPayload->length(),
-       (int64_t)work.message_.type(),
-       (int64_t)work.message_.id()},
+       (int64_t)frame->length(),
+       (int64_t)works.size()},
       {torch::kInt64})};
 
   // ProcessGroup is not thread-safe when sending with the same tag,
   // hence the lock
   std::vector<std::shared_ptr<c10d::ProcessGroup::Work>> pendingSends;
-  const auto dst = work.to_.id_;
 
+  int64_t sentBytes = frame->size();
+  for (const auto& buffer : buffers) {
+    sentBytes += buffer.nbytes();
+  }
   // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
-  auto serializedPayloadData = const_cast<char*>(serializedPayload->data());
-  auto serializedPayloadSize = serializedPayload->size();
-  std::string* deleteWhenDone = serializedPayload.release();
-  std::vector<torch::Tensor> payload = {torch::from_blob(
-      reinterpret_cast<void*>(serializedPayloadData),
-      serializedPayloadSize,
+  auto frameData = const_cast<char*>(frame->data());
+  auto frameSize = frame->size();
+  std::string* deleteWhenDone = frame.release();
+  std::vector<torch::Tensor> frameTensor = {torch::from_blob(
+      reinterpret_cast<void*>(frameData),
+      frameSize,
       [deleteWhenDone](void*) { delete deleteWhenDone; },
       {torch::kChar})};
-  pendingSends.reserve(2);
+  pendingSends.reserve(2 + buffers.size());
 
-  sendCounts_.increment(dst);
+  for (size_t i = 0; i < works.size(); ++i) {
+    sendCounts_.increment(dst);
+  }
+  numSentMessages_ += works.size();
+  ++numSentFrames_;
+  if (works.size() > 1) {
+    numCoalescedMessages_ += works.size();
+  }
+  numSentBytes_ += sentBytes;
+  if (metricsHandler_) {
+    metricsHandler_->incrementMetric(
+        c10::str(kRpcMetricsKeyPrefix, kNumSentFrames));
+    metricsHandler_->accumulateMetric(
+        c10::str(kRpcMetricsKeyPrefix, kNumSentMessages), works.size());
+    metricsHandler_->accumulateMetric(
+        c10::str(kRpcMetricsKeyPrefix, kNumSentBytes), sentBytes);
+  }
 
   {
     std::lock_guard<std::mutex> guard(sendMutexes_[dst]);
     pendingSends.emplace_back(pg_->send(preamble, dst, dst /* channelTag */));
-    pendingSends.emplace_back(pg_->send(payload, dst, dst /* channelTag */));
+    pendingSends.emplace_back(
+        pg_->send(frameTensor, dst, dst /* channelTag */));
+    for (auto& buffer : buffers) {
+      std::vector<torch::Tensor> data = {buffer};
+      pendingSends.emplace_back(pg_->send(data, dst, dst /* channelTag */));
+    }
   }
   // Write pendingSends to a global map so that they can be interrupted by
   // ::shutdown().
@@ -478,39 +621,109 @@ void ProcessGroupAgent::handleSend(const SendWork& work) {
   }
 }
 
+void ProcessGroupAgent::handleSendError(
+    const SendWork& work,
+    const std::exception& e) {
+  auto errorStr = c10::str(
+      "Encountered exception in ProcessGroupAgent::enqueueSend: ",
+      e.what(),
+      " on node: ",
+      RpcAgent::getWorkerInfo().id_);
+  auto exceptionMsg = rpc::createExceptionResponse(errorStr, work.message_.id());
+  if (work.message_.isRequest()) {
+    // Mark the future with corresponding to this request with an error.
+    markFutureWithError(exceptionMsg);
+  } else if (work.message_.isResponse()) {
+    // Try sending the error along. This bypasses any override of enqueueSend,
+    // as the response it replaces already went through it.
+    ProcessGroupAgent::enqueueSend(SendWork(work.to_, std::move(exceptionMsg)));
+  }
+}
+
+void ProcessGroupAgent::drainSendQueue(worker_id_t dst) {
+  auto& queue = sendQueues_[dst];
+  std::unique_lock<std::mutex> lock(queue.mutex);
+  while (!queue.works.empty()) {
+    // Give a small message at the head of the queue a chance to be joined by
+    // others before its frame is sent.
+    if (coalesceLatencyBudget_.count() > 0 &&
+        messageBytes(queue.works.front().message_) <=
+            kMaxCoalescedMessageBytes) {
+      queue.cv.wait_for(lock, coalesceLatencyBudget_, [&] {
+        return queue.works.size() >= kMaxMessagesPerFrame ||
+            !rpcAgentRunning_.load();
+      });
+    }
+
+    // Take messages in order until the frame is full. A large message is
+    // always sent in a frame of its own.
+    std::vector<SendWork> works;
+    size_t frameBytes = 0;
+    while (!queue.works.empty() && works.size() < kMaxMessagesPerFrame) {
+      const auto bytes = messageBytes(queue.works.front().message_);
+      const bool small = bytes <= kMaxCoalescedMessageBytes;
+      if (!works.empty() && (!small || frameBytes + bytes > kMaxFrameBytes)) {
+        break;
+      }
+      works.push_back(std::move(queue.works.front()));
+      queue.works.pop_front();
+      frameBytes += bytes;
+      if (!small) {
+        break;
+      }
+    }
+    sendQueueDepth_ -= works.size();
+    lock.unlock();
+
+    try {
+      handleSend(works);
+    } catch (std::exception& e) {
+      for (const auto& work : works) {
+        handleSendError(work, e);
+      }
+    }
+    lock.lock();
+  }
+  queue.draining = false;
+}
+
 void ProcessGroupAgent::enqueueSend(SendWork work) {
-  // NB: this can be changed to use a native move capture when moved to C++14
-  threadPool_.run(std::bind(
-      [this](const SendWork& work) {
-        try {
-          handleSend(work);
-        } catch (std::exception& e) {
-          auto errorStr = c10::str(
-              "Encountered exception in ProcessGroupAgent::enqueueSend: ",
-              e.what(),
-              " on node: ",
-              RpcAgent::getWorkerInfo().id_);
-          auto exceptionMsg =
-              rpc::createExceptionResponse(errorStr, work.message_.id());
-          if (work.message_.isRequest()) {
-            // Mark the future with corresponding to this request with an error.
-            markFutureWithError(exceptionMsg);
-          } else if (work.message_.isResponse()) {
-            // Try sending the error along.
-            handleSend(SendWork(work.to_, std::move(exceptionMsg)));
-          }
-        }
-      },
-      std::move(work)));
+  const auto dst = work.to_.id_;
+  auto& queue = sendQueues_[dst];
+  bool scheduleDrain = false;
+  int64_t depth;
+  {
+    std::lock_guard<std::mutex> guard(queue.mutex);
+    // Counted under the lock, so the drain task can't uncount it first.
+    depth = ++sendQueueDepth_;
+    queue.works.push_back(std::move(work));
+    if (!queue.draining) {
+      queue.draining = true;
+      scheduleDrain = true;
+    }
+  }
+  queue.cv.notify_one();
+
+  auto maxDepth = maxSendQueueDepth_.load();
+  while (depth > maxDepth &&
+         !maxSendQueueDepth_.compare_exchange_weak(maxDepth, depth)) {
+  }
+  if (metricsHandler_) {
+    metricsHandler_->accumulateMetric(
+        c10::str(kRpcMetricsKeyPrefix, kSendQueueDepth), depth);
+  }
+
+  if (scheduleDrain) {
+    threadPool_.run([this, dst]() { drainSendQueue(dst); });
+  }
 }
 
 bool ProcessGroupAgent::handleRecv(RecvWork& work) {
-  torch::Tensor& payload = work.payload_;
-  auto data = wireDeserialize(payload.storage().data(), payload.numel());
-  Message message(
-      std::move(data.first), std::move(data.second), work.type_, work.id_);
+  Message& message = work.message_;
   if (message.isRequest()) {
     ++serverActiveCalls_;
+    const auto executionStart = std::chrono::steady_clock::now();
+    const auto requestType = message.type();
     std::shared_ptr<FutureMessage> futureResponse;
     try {
       futureResponse = cb_->operator()(message);
@@ -520,6 +733,10 @@ bool ProcessGroupAgent::handleRecv(RecvWork& work) {
     }
     if (futureResponse->completed()) {
       --serverActiveCalls_;
+      latencyMetrics_->record(
+          requestType,
+          RpcStage::EXECUTION,
+          microsecondsSince(executionStart));
       if (!futureResponse->hasError()) {
         send(work.from_, std::move(*futureResponse).moveValue());
       } else {
@@ -534,16 +751,22 @@ bool ProcessGroupAgent::handleRecv(RecvWork& work) {
       // response as a callback which fires when the future completes.
       // Use a weak_ptr, so we can std::move the future's value.
       auto fromId = work.from_.id_;
-      auto requestId = work.id_;
+      auto requestId = message.id();
       futureResponse->addCallback([this,
                                    fromId,
                                    requestId,
+                                   requestType,
+                                   executionStart,
                                    weak = std::weak_ptr<FutureMessage>(
                                        futureResponse)]() {
         auto futureResponse = weak.lock();
         TORCH_INTERNAL_ASSERT(futureResponse);
         --serverActiveCalls_;
         --serverActiveAsyncCalls_;
+        latencyMetrics_->record(
+            requestType,
+            RpcStage::EXECUTION,
+            microsecondsSince(executionStart));
         if (!futureResponse->hasError()) {
           send(getWorkerInfo(fromId), std::move(*futureResponse).moveValue());
         } else {
@@ -570,6 +793,10 @@ bool ProcessGroupAgent::handleRecv(RecvWork& work) {
       // Use futureInfo before destructing it.
       fm = futureInfo->second.future_;
       auto endTime = futureInfo->second.endTime_;
+      latencyMetrics_->record(
+          futureInfo->second.messageType_,
+          RpcStage::ROUND_TRIP,
+          microsecondsSince(futureInfo->second.startTime_));
       futures_.erase(id);
       // look up the corresponding future by its time out and request
       // ID, and remove it from the timeouts map
@@ -600,8 +827,13 @@ bool ProcessGroupAgent::handleRecv(RecvWork& work) {
 }
 
 void ProcessGroupAgent::enqueueRecv(RecvWork work) {
+  const auto enqueueTime = std::chrono::steady_clock::now();
   threadPool_.run(std::bind(
-      [&](RecvWork& work) {
+      [this, enqueueTime](RecvWork& work) {
+        latencyMetrics_->record(
+            work.message_.type(),
+            RpcStage::RECV_QUEUEING,
+            microsecondsSince(enqueueTime));
         try {
           // Only increment recvCounts if handleRecv() tells us to. We may not,
           // i.e. if we process work corresponding to a future that has already
@@ -615,7 +847,7 @@ void ProcessGroupAgent::enqueueRecv(RecvWork work) {
           auto fromId = work.from_.id_;
           auto err = c10::str(
               "Internal error while processing request of type ",
-              work.type_,
+              work.message_.type(),
               " on node ",
               RpcAgent::getWorkerInfo().id_,
               ", from node ",
@@ -709,8 +941,8 @@ void ProcessGroupAgent::listenLoop() {
 
 void ProcessGroupAgent::listenLoopInternal() {
   while (rpcAgentRunning_.load()) {
-    // rank, tensor size, message type
-    std::vector<torch::Tensor> preamble = {torch::empty({4}, {torch::kInt64})};
+    // rank, frame size, number of messages
+    std::vector<torch::Tensor> preamble = {torch::empty({3}, {torch::kInt64})};
     auto work = pg_->recvAnysource(preamble, pg_->getRank());
     {
       // Write class variable so it can be aborted by shutdown()
@@ -726,23 +958,86 @@ void ProcessGroupAgent::listenLoopInternal() {
 
     auto srcRank = preamble_items[0];
     auto size = preamble_items[1];
-    MessageType type = MessageType(preamble_items[2]);
-    int64_t id = preamble_items[3];
+    auto numMessages = preamble_items[2];
+
+    // Receives into `tensors`. Returns false if the agent is shutting down.
+    auto recvFrom = [&](std::vector<torch::Tensor>& tensors) {
+      auto work = pg_->recv(tensors, srcRank, pg_->getRank());
+      {
+        // Write class variable so it can be aborted by shutdown()
+        std::lock_guard<std::mutex> guard(recvWorkMutex_);
+        recvWork_ = work;
+      }
+      return rpcAgentRunning_.load() && work->wait() /* not aborted */;
+    };
 
-    std::vector<torch::Tensor> tensors = {torch::empty({size}, {torch::kChar})};
-    work = pg_->recv(tensors, srcRank, pg_->getRank());
-    {
-      // Write class variable so it can be aborted by shutdown()
-      std::lock_guard<std::mutex> guard(recvWorkMutex_);
-      recvWork_ = work;
+    std::vector<torch::Tensor> frame = {torch::empty({size}, {torch::kChar})};
+    if (!recvFrom(frame)) {
+      return;
     }
 
-    if (!rpcAgentRunning_.load() || !work->wait() /* aborted */) {
-      return;
+    std::vector<Message> messages;
+    messages.reserve(numMessages);
+    const char* cursor = frame.front().storage().data<char>();
+    const char* const frameEnd = cursor + size;
+    for (int64_t i = 0; i < numMessages; ++i) {
+      int64_t entryHeader[kFrameEntryHeaderItems];
+      TORCH_CHECK(
+          cursor + sizeof(entryHeader) <= frameEnd,
+          "Truncated RPC frame from worker ",
+          srcRank);
+      memcpy(entryHeader, cursor, sizeof(entryHeader));
+      cursor += sizeof(entryHeader);
+      MessageType type = MessageType(entryHeader[0]);
+      int64_t id = entryHeader[1];
+      bool inlined = entryHeader[2] != 0;
+      auto sectionSize = entryHeader[3];
+      TORCH_CHECK(
+          sectionSize >= 0 && cursor + sectionSize <= frameEnd,
+          "Truncated RPC frame from worker ",
+          srcRank);
+
+      const auto deserializationStart = std::chrono::steady_clock::now();
+      if (inlined) {
+        auto deserialized = wireDeserialize(cursor, sectionSize);
+        latencyMetrics_->record(
+            type,
+            RpcStage::DESERIALIZATION,
+            microsecondsSince(deserializationStart));
+        messages.emplace_back(
+            std::move(deserialized.first),
+            std::move(deserialized.second),
+            type,
+            id);
+      } else {
+        // The header allocates the storage of every tensor in the message,
+        // and the tensor data is received into it directly.
+        auto deserialized = wireDeserializeOutOfBand(cursor, sectionSize);
+        latencyMetrics_->record(
+            type,
+            RpcStage::DESERIALIZATION,
+            microsecondsSince(deserializationStart));
+        for (auto& buffer : std::get<2>(deserialized)) {
+          if (buffer.numel() == 0) {
+            continue;
+          }
+          std::vector<torch::Tensor> data = {buffer};
+          if (!recvFrom(data)) {
+            return;
+          }
+        }
+        messages.emplace_back(
+            std::move(std::get<0>(deserialized)),
+            std::move(std::get<1>(deserialized)),
+            type,
+            id);
+      }
+      cursor += sectionSize;
     }
 
-    enqueueRecv(
-        RecvWork(allWorkerInfo_[srcRank], type, id, std::move(tensors[0])));
+    for (auto& message : messages) {
+      enqueueRecv(RecvWork(allWorkerInfo_[srcRank], std::move(message)));
+    }
   }
 }
 
@@ -853,6 +1148,13 @@ std::unordered_map<std::string, std::string> ProcessGroupAgent::getMetrics() {
   metrics[kServerActiveCalls] = c10::to_string(serverActiveCalls_.load());
   metrics[kServerActiveAsyncCalls] =
       c10::to_string(serverActiveAsyncCalls_.load());
+  metrics[kNumSentMessages] = c10::to_string(numSentMessages_.load());
+  metrics[kNumSentFrames] = c10::to_string(numSentFrames_.load());
+  metrics[kNumCoalescedMessages] = c10::to_string(numCoalescedMessages_.load());
+  metrics[kNumSentBytes] = c10::to_string(numSentBytes_.load());
+  metrics[kSendQueueDepth] = c10::to_string(sendQueueDepth_.load());
+  metrics[kMaxSendQueueDepth] = c10::to_string(maxSendQueueDepth_.load());
+  latencyMetrics_->addToMetrics(metrics);
   if (isGILProfilingEnabled()) {
     // Add time-series based metrics, just GIL wait times for now.
     {
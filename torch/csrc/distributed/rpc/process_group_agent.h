@@ -2,9 +2,13 @@
 
 #include <c10/core/thread_pool.h>
 #include <c10d/ProcessGroup.hpp>
+#include <torch/csrc/distributed/rpc/metrics/RpcLatencyMetrics.h>
+#include <torch/csrc/distributed/rpc/metrics/RpcMetricsHandler.h>
 #include <torch/csrc/distributed/rpc/rpc_agent.h>
 
 #include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <thread>
 
 namespace torch {
@@ -17,43 +21,51 @@ struct ProcessGroupRpcBackendOptions : public RpcBackendOptions {
   ProcessGroupRpcBackendOptions(
       int num_send_recv_threads,
       float rpc_timeout,
-      std::string init_method)
+      std::string init_method,
+      int64_t coalesce_latency_budget_us = 0)
       : RpcBackendOptions(rpc_timeout, init_method),
-        numSendRecvThreads(num_send_recv_threads) {
+        numSendRecvThreads(num_send_recv_threads),
+        coalesceLatencyBudgetUs(coalesce_latency_budget_us) {
     TORCH_CHECK(
         num_send_recv_threads > 0,
         "Cannot create ProcessGroup RPC backend with ",
         num_send_recv_threads,
         " threads in the thread-pool.");
+    TORCH_CHECK(
+        coalesce_latency_budget_us >= 0,
+        "Cannot create ProcessGroup RPC backend with a negative coalescing ",
+        "latency budget of ",
+        coalesce_latency_budget_us,
+        " microseconds.");
   }
 
   int numSendRecvThreads;
+  int64_t coalesceLatencyBudgetUs;
 };
 
 // SendWork and RecvWork will be put into a task queue, and later picked up by
 // worker threads from the same ThreadPool.
 struct SendWork {
   SendWork(const WorkerInfo& to, Message&& message)
-      : to_(to), message_(message) {}
+      : to_(to),
+        message_(message),
+        enqueueTime_(std::chrono::steady_clock::now()) {}
 
   const WorkerInfo& to_;
   Message message_;
+  // When the message was handed to the agent, for the send queueing latency.
+  steady_clock_time_point enqueueTime_;
 };
 
-// SendWork wraps a Message and RecvWork wraps a Tensor. The difference here is
-// to allow us to run serialization/deserialization in the worker threads.
+// Tensors are sent and received as separate buffers straight from and into
+// their storages, so RecvWork wraps a fully received Message. Only the small
+// header that describes the message is deserialized by the listener thread.
 struct RecvWork {
-  RecvWork(
-      const WorkerInfo& from,
-      MessageType type,
-      int64_t id,
-      torch::Tensor&& payload)
-      : from_(from), type_(type), id_(id), payload_(payload) {}
+  RecvWork(const WorkerInfo& from, Message&& message)
+      : from_(from), message_(std::move(message)) {}
 
   const WorkerInfo& from_;
-  const MessageType type_;
-  const int64_t id_;
-  torch::Tensor payload_;
+  Message message_;
 };
 
 class ProcessGroupAgent : public RpcAgent {
@@ -62,7 +74,9 @@ class ProcessGroupAgent : public RpcAgent {
       std::string workerName,
       std::shared_ptr<c10d::ProcessGroup> pg,
       int numSendRecvThreads,
-      std::chrono::milliseconds rpcTimeout);
+      std::chrono::milliseconds rpcTimeout,
+      std::chrono::microseconds coalesceLatencyBudget =
+          std::chrono::microseconds(0));
 
   const WorkerInfo& getWorkerInfo(const std::string& workerName) const override;
 
@@ -91,7 +105,8 @@ class ProcessGroupAgent : public RpcAgent {
       Message&& message,
       const float rpcTimeoutSeconds = kUnsetRpcTimeout) override;
 
-  // put SendWork into a queue and notify the worker thread
+  // Put SendWork into the queue of its destination, and schedule a task on
+  // the thread pool to drain that queue if there isn't one already.
   virtual void enqueueSend(SendWork work);
 
  private:
@@ -135,23 +150,47 @@ class ProcessGroupAgent : public RpcAgent {
     steady_clock_time_point endTime_;
     int dstRank_;
     std::chrono::milliseconds timeout_;
+    // When and with which type the request was sent, for its round trip
+    // latency.
+    steady_clock_time_point startTime_;
+    MessageType messageType_;
     FutureInfo(
         const std::shared_ptr<FutureMessage>& future,
         const steady_clock_time_point& endTime,
         int dstRank,
-        const std::chrono::milliseconds timeout)
+        const std::chrono::milliseconds timeout,
+        const steady_clock_time_point& startTime,
+        MessageType messageType)
         : future_(future),
           endTime_(endTime),
           dstRank_(dstRank),
-          timeout_(timeout) {}
+          timeout_(timeout),
+          startTime_(startTime),
+          messageType_(messageType) {}
     FutureInfo() = delete;
   };
 
+  // Outbound messages to one destination. At most one thread pool task drains
+  // a queue at a time, which keeps messages to the same destination in order
+  // and lets small messages that queue up behind each other share a frame.
+  struct SendQueue {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<SendWork> works;
+    bool draining = false;
+  };
+
   void collectNames();
-  // handle a SendWork request. This serializes the payload inside the work
-  // object, and sends the message to the receiver using the underlying
-  // ProcessGroup.
-  void handleSend(const SendWork& work);
+  // Sends the messages in the queue of `dst` in frames until it is empty.
+  void drainSendQueue(worker_id_t dst);
+  // handle a batch of SendWork requests to the same destination. This
+  // serializes the messages into a single frame, and sends the frame to the
+  // receiver using the underlying ProcessGroup. Works whose message fails to
+  // serialize are reported through handleSendError and removed from `works`.
+  void handleSend(std::vector<SendWork>& works);
+  // Reports a failure to send `work`: requests have their future marked with
+  // the error, responses are replaced by an exception response.
+  void handleSendError(const SendWork& work, const std::exception& e);
   // put RecvWork into a queue and notify the worker thread
   void enqueueRecv(RecvWork work);
   // handle a RecvWork request. Return true if we should increment recvCounts,
@@ -225,6 +264,12 @@ class ProcessGroupAgent : public RpcAgent {
   // one mutex per ProcessGroup rank, as ProcessGroup::send is not thread-safe
   // when using the same tag.
   std::vector<std::mutex> sendMutexes_;
+  // one send queue per ProcessGroup rank.
+  std::vector<SendQueue> sendQueues_;
+  // How long a drain task waits for more small messages before sending a
+  // frame that isn't full yet. Zero only coalesces messages that are already
+  // queued.
+  const std::chrono::microseconds coalesceLatencyBudget_;
   std::thread listenerThread_;
   // A thread to poll existing futures and check for timed out ones.
   std::thread futureTimeoutThread_;
@@ -278,6 +323,19 @@ class ProcessGroupAgent : public RpcAgent {
   std::vector<std::unique_ptr<AverageMetricsTracker>> metrics_;
   void addGilWaitTime(const std::chrono::microseconds gilWaitTime) override;
 
+  // Send throughput and queue depth, over all destinations.
+  std::atomic<int64_t> numSentMessages_{0};
+  std::atomic<int64_t> numSentFrames_{0};
+  std::atomic<int64_t> numCoalescedMessages_{0};
+  std::atomic<int64_t> numSentBytes_{0};
+  std::atomic<int64_t> sendQueueDepth_{0};
+  std::atomic<int64_t> maxSendQueueDepth_{0};
+  // Handler registered in RpcMetricsHandlerRegistry, if any.
+  std::unique_ptr<RpcMetricsHandler> metricsHandler_;
+  // Latency histograms of the stages of RPCs, reported by getMetrics() and
+  // passed to metricsHandler_.
+  std::unique_ptr<RpcLatencyMetrics> latencyMetrics_;
+
   std::atomic<int32_t> clientActiveCalls_{0};
   std::atomic<int32_t> serverActiveCalls_{0};
   std::atomic<int32_t> serverActiveAsyncCalls_{0};
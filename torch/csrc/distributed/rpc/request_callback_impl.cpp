@@ -38,6 +38,16 @@ py::object toPyObj(IValue value) {
   return torch::jit::toPyObject(std::move(value));
 }
 
+// Leaves out the value if the user already has the current version cached.
+ScriptRRefFetchRet fetchRet(const OwnerRRef& rref, int64_t cachedVersion) {
+  const auto& value = rref.getValue();
+  auto version = rref.valueVersion();
+  if (version != ScriptRRefFetchCall::kNoVersion && version == cachedVersion) {
+    return ScriptRRefFetchRet({}, version);
+  }
+  return ScriptRRefFetchRet({value}, version);
+}
+
 std::unique_ptr<RpcCommandBase> deserializePythonRpcCommandReference(
     RpcCommandBase& rpc,
     const MessageType& messageType) {
@@ -75,6 +85,28 @@ std::unique_ptr<RpcCommandBase> deserializePythonRpcCommand(
   return pythonRpc ? std::move(pythonRpc) : std::move(rpc);
 }
 
+// Runs the TorchScript function `qualifiedName` on `stack` through the
+// interpreter's async path. The function starts in the calling thread, and
+// suspends instead of blocking it whenever it waits on a future that isn't
+// completed yet (e.g. a nested rpc_async or a fork); the rest of it then runs
+// as a continuation on an at::launch() thread. Errors raised before the first
+// suspension are reported through the returned future as well.
+c10::intrusive_ptr<c10::ivalue::Future> runJitFunction(
+    const c10::QualifiedName& qualifiedName,
+    std::vector<at::IValue>& stack) {
+  c10::intrusive_ptr<c10::ivalue::Future> jitFuture;
+  try {
+    jitFuture = PythonRpcHandler::getInstance()
+                    .jitCompilationUnit()
+                    ->get_function(qualifiedName)
+                    .runAsync(stack);
+  } catch (const std::exception& e) {
+    jitFuture = c10::make_intrusive<c10::ivalue::Future>(AnyType::get());
+    jitFuture->setError(e.what());
+  }
+  return jitFuture;
+}
+
 // When request message has autograd info, processMessage() will set up valid
 // current context id properly. This struct is used to clean up current context
 // id after processMessage() is done.
@@ -143,29 +175,22 @@ void RequestCallbackImpl::processRpc(
         return;
       }
 
-      // runAsync() starts in the calling thread, but may return an uncompleted
-      // future (though for non-async code, it will typically be completed).
-      // If it was async, our callback will typically be invoked by the
-      // continuation on an at::launch() thread.
-      auto jitFuture = PythonRpcHandler::getInstance()
-                           .jitCompilationUnit()
-                           ->get_function(scriptCall.qualifiedName())
-                           .runAsync(stack);
-
-      if (jitFuture->completed()) {
-        markComplete(
-            std::move(ScriptResp(std::move(jitFuture->value()))).toMessage());
-        return;
-      }
-      jitFuture->addCallback([responseFuture, messageId, jitFuture]() {
-        try {
-          Message m = ScriptResp(std::move(jitFuture->value())).toMessage();
-          m.setId(messageId);
-          responseFuture->markCompleted(std::move(m));
-        } catch (const std::exception& e) {
-          responseFuture->setError(e.what());
-        }
-      });
+      // The future returned by runJitFunction() is typically completed for
+      // non-async code, in which case the callback runs right here. Otherwise,
+      // this thread goes back to the pool right away, and the callback will
+      // typically be invoked by the continuation on an at::launch() thread.
+      auto jitFuture = runJitFunction(scriptCall.qualifiedName(), stack);
+      jitFuture->addCallback(
+          [this, responseFuture, messageId, messageType, jitFuture]() {
+            Message m;
+            try {
+              m = ScriptResp(jitFuture->value()).toMessage();
+            } catch (const std::exception& e) {
+              m = handleError(e, messageType, messageId);
+            }
+            m.setId(messageId);
+            responseFuture->markCompleted(std::move(m));
+          });
       return;
     }
     case MessageType::PYTHON_CALL: {
@@ -245,27 +270,13 @@ void RequestCallbackImpl::processRpc(
         return;
       }
 
-      c10::intrusive_ptr<c10::ivalue::Future> jitFuture;
-      try {
-        jitFuture = PythonRpcHandler::getInstance()
-                        .jitCompilationUnit()
-                        ->get_function(scriptRemoteCall.qualifiedName())
-                        .runAsync(stack);
-        if (jitFuture->completed()) { // short-cut.
-          ownerRRef->setValue(jitFuture->value());
-          postProcessing();
-          return;
-        }
-      } catch (const std::exception& e) {
-        ownerRRef->setError(e.what());
-        postProcessing();
-        return;
-      }
+      auto jitFuture =
+          runJitFunction(scriptRemoteCall.qualifiedName(), stack);
       jitFuture->addCallback([ownerRRef, postProcessing, jitFuture]() {
-        try {
+        if (jitFuture->hasError()) {
+          ownerRRef->setError(jitFuture->error()->what());
+        } else {
           ownerRRef->setValue(jitFuture->value());
-        } catch (const std::exception& e) {
-          ownerRRef->setError(e.what());
         }
         postProcessing();
       });
@@ -324,25 +335,31 @@ void RequestCallbackImpl::processRpc(
         // the OwnerRRef has been created
         const auto& rref = futureOwner->constValue();
         if (rref->hasValue()) {
-          markComplete(ScriptRRefFetchRet({rref->getValue()}).toMessage());
+          markComplete(fetchRet(*rref, srf.cachedVersion()).toMessage());
           return;
         }
       }
 
-      futureOwner->addCallback([responseFuture, messageId, futureOwner]() {
+      futureOwner->addCallback([responseFuture,
+                                messageId,
+                                futureOwner,
+                                cachedVersion = srf.cachedVersion()]() {
         const auto& rref = futureOwner->constValue();
         auto whenValueSet = rref->getFuture();
 
         // Our response is satisfied when the rpc.remote() request
         // finishes executing on the owner.
-        whenValueSet->addCallback([responseFuture, messageId, rref](
+        whenValueSet->addCallback([responseFuture,
+                                   messageId,
+                                   rref,
+                                   cachedVersion](
                                       const FutureIValue& whenValueSet) {
           if (whenValueSet.hasError()) {
             responseFuture->setError(*whenValueSet.error());
             return;
           }
           try {
-            Message m = ScriptRRefFetchRet({rref->getValue()}).toMessage();
+            Message m = fetchRet(*rref, cachedVersion).toMessage();
             m.setId(messageId);
             responseFuture->markCompleted(std::move(m));
           } catch (const std::exception& e) {
@@ -401,10 +418,12 @@ void RequestCallbackImpl::processRpc(
     case MessageType::RREF_USER_DELETE: {
       auto& rud = static_cast<RRefUserDelete&>(rpc);
       auto& ctx = RRefContext::getInstance();
-      auto deletedRRef = ctx.delForkOfOwner(rud.rrefId(), rud.forkId());
-      if (deletedRRef && deletedRRef->isPyObj()) {
-        pybind11::gil_scoped_acquire ag;
-        deletedRRef.reset();
+      for (const auto& fork : rud.forks()) {
+        auto deletedRRef = ctx.delForkOfOwner(fork.first, fork.second);
+        if (deletedRRef && deletedRRef->isPyObj()) {
+          pybind11::gil_scoped_acquire ag;
+          deletedRRef.reset();
+        }
       }
       markComplete(std::move(RRefAck()).toMessage());
       return;
@@ -482,36 +501,47 @@ void RequestCallbackImpl::processRpc(
     }
     case MessageType::BACKWARD_AUTOGRAD_REQ: {
       auto& gradientsCall = static_cast<PropagateGradientsReq&>(rpc);
-      const auto& autogradMetadata = gradientsCall.getAutogradMetadata();
 
       // Retrieve the appropriate autograd context.
       auto autogradContext =
           DistAutogradContainer::getInstance().retrieveContext(
-              autogradMetadata.autogradContextId);
-
-      // Lookup the appropriate 'send' function to enqueue.
-      std::shared_ptr<SendRpcBackward> sendFunction =
-          autogradContext->retrieveSendFunction(
-              autogradMetadata.autogradMessageId);
-
-      // Attach the gradients to the send function.
-      sendFunction->setGrads(gradientsCall.getGrads());
-
-      // Now execute the autograd graph using the "distributed engine."
-      auto execFuture = DistEngine::getInstance().executeSendFunctionAsync(
-          autogradContext, sendFunction, gradientsCall.retainGraph());
-
-      // Our response is satisfied when the rpcs come back.
-      execFuture->addCallback(
-          [responseFuture, messageId](const FutureMessage& execFuture) {
-            if (!execFuture.hasError()) {
-              Message m = std::move(PropagateGradientsResp()).toMessage();
-              m.setId(messageId);
-              responseFuture->markCompleted(std::move(m));
-            } else {
-              responseFuture->setError(*(execFuture.error()));
-            }
-          });
+              gradientsCall.getAutogradContextId());
+
+      const auto& autogradMessageIds = gradientsCall.getAutogradMessageIds();
+      const auto& grads = gradientsCall.getGrads();
+      std::vector<std::shared_ptr<FutureMessage>> execFutures;
+      execFutures.reserve(autogradMessageIds.size());
+      for (size_t i = 0; i < autogradMessageIds.size(); i++) {
+        // Lookup the appropriate 'send' function to enqueue.
+        std::shared_ptr<SendRpcBackward> sendFunction =
+            autogradContext->retrieveSendFunction(autogradMessageIds[i]);
+
+        // Attach the gradients to the send function.
+        sendFunction->setGrads(grads[i]);
+
+        // Now execute the autograd graph using the "distributed engine." The
+        // send functions of a batch run concurrently.
+        execFutures.push_back(
+            DistEngine::getInstance().executeSendFunctionAsync(
+                autogradContext, sendFunction, gradientsCall.retainGraph()));
+      }
+
+      // Our response is satisfied when the rpcs of all send functions come
+      // back.
+      auto remaining =
+          std::make_shared<std::atomic<size_t>>(execFutures.size());
+      for (auto& execFuture : execFutures) {
+        execFuture->addCallback([responseFuture, messageId, remaining](
+                                    const FutureMessage& execFuture) {
+          if (execFuture.hasError()) {
+            responseFuture->setErrorIfNeeded(execFuture.error()->what());
+          } else if (--*remaining == 0) {
+            Message m = std::move(PropagateGradientsResp()).toMessage();
+            m.setId(messageId);
+            responseFuture->markCompleted(std::move(m));
+          }
+        });
+      }
       return;
     };
     case MessageType::CLEANUP_AUTOGRAD_CONTEXT_REQ: {
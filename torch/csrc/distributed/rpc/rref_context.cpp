@@ -169,22 +169,64 @@ void RRefContext::delUser(
     const worker_id_t owner,
     const RRefId& rrefId,
     const ForkId& forkId) {
+  bool sendNow = false;
+  {
+    std::lock_guard<std::mutex> lock(userDeletesMutex_);
+    if (userDeletesInFlight_.insert(owner).second) {
+      sendNow = true;
+    } else {
+      pendingUserDeletes_[owner].emplace_back(rrefId, forkId);
+    }
+  }
+  if (sendNow) {
+    sendUserDeletes(owner, {{rrefId, forkId}});
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  confirmedUsers_.erase(forkId);
+}
+
+void RRefContext::sendUserDeletes(
+    worker_id_t owner,
+    std::vector<std::pair<RRefId, ForkId>> forks) {
+  std::shared_ptr<FutureMessage> fm;
   {
     std::lock_guard<std::mutex> lock(destroyedMutex_);
     if (!destroyed_) {
       // Sending an RRefUserDelete causes the receiver to run delForkOfOwner,
       // which is now idempotent. See the comment at RRefContext::delForkOfOwner
       // for more details.
-      auto fm = agent_->sendWithRetries(
+      fm = agent_->sendWithRetries(
           agent_->getWorkerInfo(owner),
-          RRefUserDelete(rrefId, forkId).toMessage());
-
-      fm->addCallback([](const FutureMessage& fm) { handleException(fm); });
+          RRefUserDelete(std::move(forks)).toMessage());
     }
   }
+  if (!fm) {
+    std::lock_guard<std::mutex> lock(userDeletesMutex_);
+    userDeletesInFlight_.erase(owner);
+    pendingUserDeletes_.erase(owner);
+    return;
+  }
 
-  std::lock_guard<std::mutex> lock(mutex_);
-  confirmedUsers_.erase(forkId);
+  // The callback runs inline if the message has already been acknowledged, so
+  // no lock may be held when adding it.
+  fm->addCallback([this, owner](const FutureMessage& fm) {
+    std::vector<std::pair<RRefId, ForkId>> next;
+    {
+      std::lock_guard<std::mutex> lock(userDeletesMutex_);
+      auto it = pendingUserDeletes_.find(owner);
+      if (it == pendingUserDeletes_.end()) {
+        userDeletesInFlight_.erase(owner);
+      } else {
+        next = std::move(it->second);
+        pendingUserDeletes_.erase(it);
+      }
+    }
+    if (!next.empty()) {
+      sendUserDeletes(owner, std::move(next));
+    }
+    handleException(fm);
+  });
 }
 
 void RRefContext::delAllUsers(std::chrono::milliseconds timeoutMillis) {
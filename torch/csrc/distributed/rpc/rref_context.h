@@ -228,6 +228,14 @@ class TORCH_API RRefContext {
   // If there is any leak on any RRef, this method will throw an error.
   void checkRRefLeaks(bool ignoreRRefLeak);
 
+  // Sends one RREF_USER_DELETE message for the given UserRRefs of the owner.
+  // When it is acknowledged, the deletes that were queued for the owner in the
+  // meantime are sent in the next message. The owner must be in
+  // userDeletesInFlight_.
+  void sendUserDeletes(
+      worker_id_t owner,
+      std::vector<std::pair<RRefId, ForkId>> forks);
+
   static std::atomic<local_id_t> nextLocalId_;
 
   const std::shared_ptr<RpcAgent> agent_;
@@ -288,6 +296,15 @@ class TORCH_API RRefContext {
   std::mutex destroyedMutex_;
   bool destroyed_;
 
+  // Deleting UserRRefs in a loop would send one RREF_USER_DELETE per UserRRef.
+  // Instead, there is at most one delete message in flight to every owner,
+  // and the deletes of the UserRRefs that are destructed while it is in
+  // flight are queued here and sent together once it is acknowledged.
+  std::mutex userDeletesMutex_;
+  std::unordered_map<worker_id_t, std::vector<std::pair<RRefId, ForkId>>>
+      pendingUserDeletes_;
+  std::unordered_set<worker_id_t> userDeletesInFlight_;
+
   // Thread local states to keep UserRRefs deserialized from user function
   // arguments.
   static thread_local std::vector<std::shared_ptr<PendingUserState>> userTable_;
@@ -1,5 +1,6 @@
 #include <torch/csrc/distributed/rpc/rref_impl.h>
 
+#include <torch/csrc/distributed/autograd/context/container.h>
 #include <torch/csrc/distributed/autograd/rpc_messages/rpc_with_autograd.h>
 #include <torch/csrc/distributed/autograd/utils.h>
 #include <torch/csrc/distributed/rpc/rref_context.h>
@@ -23,6 +24,67 @@ std::string getTypeStr(const c10::TypePtr& type) {
       return type->str();
   }
 }
+
+// Adds the version counters of the tensors in value to version. Returns false
+// if the value may change without bumping a version counter.
+bool addTensorVersions(const c10::IValue& value, int64_t& version) {
+  if (value.isTensor()) {
+    const auto& tensor = value.toTensor();
+    if (tensor.defined()) {
+      version +=
+          tensor.unsafeGetTensorImpl()->version_counter().current_version();
+    }
+    return true;
+  }
+  if (value.isTuple()) {
+    for (const auto& element : value.toTuple()->elements()) {
+      if (!addTensorVersions(element, version)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return value.isInt() || value.isDouble() || value.isBool() ||
+      value.isString() || value.isNone() || value.isDevice();
+}
+
+bool hasTensors(const c10::IValue& value) {
+  if (value.isTensor()) {
+    return true;
+  }
+  if (value.isTuple()) {
+    for (const auto& element : value.toTuple()->elements()) {
+      if (hasTensors(element)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// Copies the tensors of a cached value, so that modifying the result of
+// toHere() in place does not modify the cache. Unlike IValue::deepcopy, the
+// copies do not record the clone in autograd.
+c10::IValue copyCachedValue(const c10::IValue& value) {
+  if (value.isTensor()) {
+    const auto& tensor = value.toTensor();
+    if (!tensor.defined()) {
+      return value;
+    }
+    return tensor.detach().clone().requires_grad_(tensor.requires_grad());
+  }
+  if (value.isTuple()) {
+    const auto& elements = value.toTuple()->elements();
+    std::vector<c10::IValue> copies;
+    copies.reserve(elements.size());
+    for (const auto& element : elements) {
+      copies.push_back(copyCachedValue(element));
+    }
+    return c10::ivalue::Tuple::create(std::move(copies));
+  }
+  return value;
+}
+
 } // namespace
 
 namespace torch {
@@ -131,6 +193,19 @@ IValue UserRRef::toHere() {
 
   auto agent = RpcAgent::getCurrentRpcAgent();
 
+  const bool useCache = !isPyObj() &&
+      !autograd::DistAutogradContainer::getInstance().hasValidContext();
+  int64_t cachedVersion = ScriptRRefFetchCall::kNoVersion;
+  if (useCache) {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    if (cachedValue_) {
+      if (!cacheNeedsRevalidation_) {
+        return copyCachedValue(*cachedValue_);
+      }
+      cachedVersion = cachedVersion_;
+    }
+  }
+
   // ScriptRRefFetchCall message always carries autograd context id even if
   // the message itself does not contain any tensor, because the response would
   // potentially contain tensors.
@@ -139,7 +214,8 @@ IValue UserRRef::toHere() {
   if (isPyObj()) {
     msgToSend = PythonRRefFetchCall(ownerId_, rrefId()).toMessage();
   } else {
-    msgToSend = ScriptRRefFetchCall(ownerId_, rrefId()).toMessage();
+    msgToSend =
+        ScriptRRefFetchCall(ownerId_, rrefId(), cachedVersion).toMessage();
   }
 
   auto futureResponse = autograd::sendMessageWithAutograd(
@@ -162,9 +238,30 @@ IValue UserRRef::toHere() {
     // wrap python serialized vector of ivalues into tuple, this
     // made the C++ toHere interface to return single IValue
     return ivalue::Tuple::create(rrefFetchRet.values());
-  } else {
-    return rrefFetchRet.values().front();
   }
+
+  auto& scriptFetchRet = static_cast<ScriptRRefFetchRet&>(rpc);
+  if (!useCache) {
+    return scriptFetchRet.values().front();
+  }
+  std::lock_guard<std::mutex> lock(cacheMutex_);
+  if (scriptFetchRet.values().empty()) {
+    // Not modified since the version we sent.
+    TORCH_INTERNAL_ASSERT(
+        cachedValue_ && scriptFetchRet.version() == cachedVersion_,
+        "Owner replied to an RRef fetch without a value, but the cached ",
+        "version does not match.");
+    return copyCachedValue(*cachedValue_);
+  }
+  const auto& value = scriptFetchRet.values().front();
+  if (scriptFetchRet.version() == ScriptRRefFetchCall::kNoVersion) {
+    cachedValue_.reset();
+    return value;
+  }
+  cachedValue_ = value;
+  cachedVersion_ = scriptFetchRet.version();
+  cacheNeedsRevalidation_ = hasTensors(value);
+  return copyCachedValue(value);
 }
 
 RRefForkData UserRRef::fork() const {
@@ -212,6 +309,14 @@ const IValue& OwnerRRef::getValue() const {
   return value_.value();
 }
 
+int64_t OwnerRRef::valueVersion() const {
+  int64_t version = 0;
+  if (!addTensorVersions(getValue(), version)) {
+    return ScriptRRefFetchCall::kNoVersion;
+  }
+  return version;
+}
+
 bool OwnerRRef::hasValue() const {
   std::lock_guard<std::mutex> lock(mutex_);
   return value_.has_value() || error_.has_value();
@@ -287,6 +287,13 @@ class TORCH_API UserRRef final : public RRef {
 
   // Get of copy of the value from the ``OwnerRRef``. If the value is not ready
   // yet, this call will block.
+  //
+  // Values of script RRefs are cached together with their version on the
+  // owner (see OwnerRRef::valueVersion). Later calls return a copy of the
+  // cached value if it has no tensors, and otherwise only ask the owner to
+  // send the value again if its version changed. The cache is bypassed while
+  // there is a valid distributed autograd context, as the fetch needs to be
+  // recorded for the backward pass.
   IValue toHere();
 
   void tryDel() override;
@@ -319,6 +326,13 @@ class TORCH_API UserRRef final : public RRef {
   bool deletedOnOwner_{false};
   // Indicating whether this UserRRef has been confirmed by its owner.
   std::atomic<bool> confirmedByOwner_;
+
+  // The value returned by the last toHere() and its version on the owner.
+  std::mutex cacheMutex_;
+  c10::optional<IValue> cachedValue_;
+  int64_t cachedVersion_{-1};
+  // Whether the cached value has tensors and must be checked with the owner.
+  bool cacheNeedsRevalidation_{true};
 };
 
 // Keep the template only on the derived class because ``RRefContext`` needs to
@@ -365,6 +379,15 @@ class TORCH_API OwnerRRef final : public RRef {
 
   // Has a value or error been set?
   bool hasValue() const;
+
+  // A version of the value, which changes whenever one of its tensors is
+  // modified in place, so that users can cache the value they fetched. It is
+  // the sum of the version counters of the tensors. Returns -1 if the value
+  // cannot be cached because it contains anything else than tensors, tuples
+  // and immutable scalars. Only call this after the value has been set.
+  // NB: in-place modifications through ``Tensor.data`` do not bump the
+  // version counter of the tensor and are not detected.
+  int64_t valueVersion() const;
   // Gets a future that is satisfied when the value or error is set.
   std::shared_ptr<FutureIValue> getFuture();
 
@@ -81,11 +81,14 @@ std::pair<RRefId, ForkId> ForkMessageBase::fromMessage(
 
 /////////////////////////// RRef Protocol //////////////////////////////////
 
+constexpr int64_t ScriptRRefFetchCall::kNoVersion;
+
 Message ScriptRRefFetchCall::toMessageImpl() && {
   std::vector<at::IValue> ivalues;
-  ivalues.reserve(2);
+  ivalues.reserve(3);
   ivalues.emplace_back(rrefId_.toIValue());
   ivalues.emplace_back(fromWorkerId_);
+  ivalues.emplace_back(cachedVersion_);
   return fromIValues(std::move(ivalues), MessageType::SCRIPT_RREF_FETCH_CALL);
 }
 
@@ -93,14 +96,14 @@ std::unique_ptr<ScriptRRefFetchCall> ScriptRRefFetchCall::fromMessage(
     const Message& message) {
   auto values = toIValues(message, MessageType::SCRIPT_RREF_FETCH_CALL);
   TORCH_INTERNAL_ASSERT(
-      values.size() == 2, "ScriptRRefFetchCall expects 2 IValues from message");
+      values.size() == 3, "ScriptRRefFetchCall expects 3 IValues from message");
   auto id = values[1].toInt();
   TORCH_INTERNAL_ASSERT(
       id >= std::numeric_limits<worker_id_t>::min() &&
           id <= std::numeric_limits<worker_id_t>::max(),
       "ScriptRRefFetchCall fromWorkerId exceeds worker_id_t limit.")
   return std::make_unique<ScriptRRefFetchCall>(
-      worker_id_t(id), RRefId::fromIValue(values[0]));
+      worker_id_t(id), RRefId::fromIValue(values[0]), values[2].toInt());
 }
 
 Message PythonRRefFetchCall::toMessageImpl() && {
@@ -137,14 +140,22 @@ Message RRefFetchRet::toMessageImpl() && {
   return Message(std::move(payload), std::move(tensor_table), type_);
 }
 
+Message ScriptRRefFetchRet::toMessageImpl() && {
+  std::vector<at::IValue> ivalues = values();
+  ivalues.emplace_back(version_);
+  return fromIValues(std::move(ivalues), MessageType::SCRIPT_RREF_FETCH_RET);
+}
+
 std::unique_ptr<ScriptRRefFetchRet> ScriptRRefFetchRet::fromMessage(
     const Message& message) {
   auto values = toIValues(message, MessageType::SCRIPT_RREF_FETCH_RET);
   TORCH_INTERNAL_ASSERT(
-      values.size() == 1,
-      "RRef of IValue should contain a single IValue, but got ",
-      values.size());
-  return std::make_unique<ScriptRRefFetchRet>(std::move(values));
+      values.size() == 1 || values.size() == 2,
+      "RRef of IValue should contain at most a single IValue, but got ",
+      values.size() - 1);
+  auto version = values.back().toInt();
+  values.pop_back();
+  return std::make_unique<ScriptRRefFetchRet>(std::move(values), version);
 }
 
 std::unique_ptr<PythonRRefFetchRet> PythonRRefFetchRet::fromMessage(
@@ -153,12 +164,33 @@ std::unique_ptr<PythonRRefFetchRet> PythonRRefFetchRet::fromMessage(
       toIValues(message, MessageType::PYTHON_RREF_FETCH_RET));
 }
 
+const std::vector<std::pair<RRefId, ForkId>>& RRefUserDelete::forks() const {
+  return forks_;
+}
+
+Message RRefUserDelete::toMessageImpl() && {
+  std::vector<at::IValue> ivalues;
+  ivalues.reserve(2 * forks_.size());
+  for (const auto& fork : forks_) {
+    ivalues.emplace_back(fork.first.toIValue());
+    ivalues.emplace_back(fork.second.toIValue());
+  }
+  return fromIValues(std::move(ivalues), MessageType::RREF_USER_DELETE);
+}
+
 std::unique_ptr<RRefUserDelete> RRefUserDelete::fromMessage(
     const Message& message) {
-  auto pair =
-      ForkMessageBase::fromMessage(message, MessageType::RREF_USER_DELETE);
-  return std::make_unique<RRefUserDelete>(
-      RRefUserDelete(pair.first, pair.second));
+  auto values = toIValues(message, MessageType::RREF_USER_DELETE);
+  TORCH_INTERNAL_ASSERT(
+      !values.empty() && values.size() % 2 == 0,
+      "RRefUserDelete expects pairs of IValues from message.");
+  std::vector<std::pair<RRefId, ForkId>> forks;
+  forks.reserve(values.size() / 2);
+  for (size_t i = 0; i < values.size(); i += 2) {
+    forks.emplace_back(
+        RRefId::fromIValue(values[i]), ForkId::fromIValue(values[i + 1]));
+  }
+  return std::make_unique<RRefUserDelete>(std::move(forks));
 }
 
 std::unique_ptr<RemoteRet> RemoteRet::fromMessage(const Message& message) {
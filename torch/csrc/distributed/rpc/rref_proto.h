@@ -49,22 +49,37 @@ class TORCH_API ForkMessageBase : public RRefMessageBase {
 };
 
 // UserRRef uses this message to fetch the remote RRef value from the owner.
+// If the user has a cached copy of the value, it sends along the version the
+// owner returned with it, and the owner leaves out the value if it still has
+// that version (see OwnerRRef::valueVersion).
 class TORCH_API ScriptRRefFetchCall final : public RRefMessageBase {
  public:
-  ScriptRRefFetchCall(worker_id_t fromWorkerId, const RRefId& rrefId)
+  ScriptRRefFetchCall(
+      worker_id_t fromWorkerId,
+      const RRefId& rrefId,
+      int64_t cachedVersion = kNoVersion)
       : RRefMessageBase(rrefId, MessageType::SCRIPT_RREF_FETCH_CALL),
-        fromWorkerId_(fromWorkerId) {}
+        fromWorkerId_(fromWorkerId),
+        cachedVersion_(cachedVersion) {}
 
   inline worker_id_t fromWorkerId() const {
     return fromWorkerId_;
   }
 
+  inline int64_t cachedVersion() const {
+    return cachedVersion_;
+  }
+
   Message toMessageImpl() && override;
   static std::unique_ptr<ScriptRRefFetchCall> fromMessage(
       const Message& message);
 
+  // The version of values that can't be cached.
+  static constexpr int64_t kNoVersion = -1;
+
  private:
   const worker_id_t fromWorkerId_;
+  const int64_t cachedVersion_;
 };
 
 class TORCH_API PythonRRefFetchCall final : public RRefMessageBase {
@@ -95,13 +110,27 @@ class TORCH_API RRefFetchRet : public RpcCommandBase {
   const MessageType type_;
 };
 
+// The values are empty if the version is the cached version of the fetch
+// call.
 class TORCH_API ScriptRRefFetchRet final : public RRefFetchRet {
  public:
-  explicit ScriptRRefFetchRet(std::vector<at::IValue> values)
-      : RRefFetchRet(std::move(values), MessageType::SCRIPT_RREF_FETCH_RET) {}
+  explicit ScriptRRefFetchRet(
+      std::vector<at::IValue> values,
+      int64_t version = ScriptRRefFetchCall::kNoVersion)
+      : RRefFetchRet(std::move(values), MessageType::SCRIPT_RREF_FETCH_RET),
+        version_(version) {}
+
+  inline int64_t version() const {
+    return version_;
+  }
+
+  Message toMessageImpl() && override;
 
   static std::unique_ptr<ScriptRRefFetchRet> fromMessage(
       const Message& message);
+
+ private:
+  const int64_t version_;
 };
 
 class TORCH_API PythonRRefFetchRet final : public RRefFetchRet {
@@ -114,13 +143,23 @@ class TORCH_API PythonRRefFetchRet final : public RRefFetchRet {
 };
 
 // UserRRef (regardless it's the creator or not) uses this message to notiify
-// OwnerRRef on delete.
-class TORCH_API RRefUserDelete final : public ForkMessageBase {
+// OwnerRRef on delete. The deletes of several UserRRefs of the same owner are
+// batched into one message.
+class TORCH_API RRefUserDelete final : public RpcCommandBase {
  public:
   RRefUserDelete(const RRefId& rrefId, const ForkId& forkId)
-      : ForkMessageBase(rrefId, forkId, MessageType::RREF_USER_DELETE) {}
+      : forks_({{rrefId, forkId}}) {}
+
+  explicit RRefUserDelete(std::vector<std::pair<RRefId, ForkId>> forks)
+      : forks_(std::move(forks)) {}
+
+  const std::vector<std::pair<RRefId, ForkId>>& forks() const;
 
+  Message toMessageImpl() && override;
   static std::unique_ptr<RRefUserDelete> fromMessage(const Message& message);
+
+ private:
+  const std::vector<std::pair<RRefId, ForkId>> forks_;
 };
 
 class TORCH_API RemoteRet final : public ForkMessageBase {
@@ -19,6 +19,18 @@ namespace rpc {
 
 constexpr long kToMilliseconds = 1000;
 
+namespace {
+
+const DeviceMap& findDeviceMap(
+    const std::unordered_map<worker_id_t, DeviceMap>& deviceMaps,
+    worker_id_t workerId) {
+  static const DeviceMap kEmptyDeviceMap;
+  const auto it = deviceMaps.find(workerId);
+  return it == deviceMaps.end() ? kEmptyDeviceMap : it->second;
+}
+
+} // namespace
+
 TensorPipeAgent::TensorPipeAgent(
     worker_id_t selfId,
     std::string selfName,
@@ -39,6 +51,33 @@ TensorPipeAgent::TensorPipeAgent(
     workerIdToInfo_.emplace(workerId, WorkerInfo(workerName, workerId));
     workerNameToInfo_.emplace(workerName, WorkerInfo(workerName, workerId));
   }
+
+  for (const auto& kv : opts_.deviceMaps) {
+    const auto it = workerNameToInfo_.find(kv.first);
+    TORCH_CHECK(
+        it != workerNameToInfo_.end(),
+        "Device map given for unknown worker ",
+        kv.first);
+    const worker_id_t workerId = it->second.id_;
+    auto& reverseDeviceMap = reverseDeviceMaps_[workerId];
+    for (const auto& devices : kv.second) {
+      TORCH_CHECK(
+          devices.first >= 0 && devices.second >= 0,
+          "Device map to worker ",
+          kv.first,
+          " must map CUDA device indices, got ",
+          devices.first,
+          " -> ",
+          devices.second);
+      TORCH_CHECK(
+          reverseDeviceMap.emplace(devices.second, devices.first).second,
+          "Device map to worker ",
+          kv.first,
+          " maps several devices to device ",
+          devices.second);
+    }
+    deviceMaps_[workerId] = kv.second;
+  }
 }
 
 TensorPipeAgent::~TensorPipeAgent() {
@@ -111,8 +150,9 @@ void TensorPipeAgent::onListenerAccepted(
 
 void TensorPipeAgent::pipeRead(
     const std::shared_ptr<tensorpipe::Pipe>& pipe,
-    std::function<void(const tensorpipe::Error&, Message&&)> fn) {
-  pipe->readDescriptor([fn{std::move(fn)}, pipe](
+    std::function<void(const tensorpipe::Error&, Message&&)> fn,
+    const DeviceMap& deviceMap) {
+  pipe->readDescriptor([fn{std::move(fn)}, pipe, deviceMap](
                            const tensorpipe::Error& error,
                            tensorpipe::Message&& tpMessage) mutable {
     if (error) {
@@ -132,11 +172,24 @@ void TensorPipeAgent::pipeRead(
       tpTensor.data = (uint8_t*)(rpcTensor.data_ptr());
     }
 
+    std::string metadata = tpMessage.metadata;
     pipe->read(
         std::move(tpMessage),
-        [fn{std::move(fn)}, rpcMessage{std::move(rpcMessage)}](
+        [fn{std::move(fn)},
+         rpcMessage{std::move(rpcMessage)},
+         metadata{std::move(metadata)},
+         deviceMap{std::move(deviceMap)}](
             const tensorpipe::Error& error,
             tensorpipe::Message&& /* unused */) mutable {
+          if (!error) {
+            try {
+              tensorpipeMoveTensorsToDevices(metadata, rpcMessage, deviceMap);
+            } catch (const std::exception& e) {
+              // E.g. the device does not exist on this worker. The handlers
+              // of requests and responses report this to the caller.
+              rpcMessage = createExceptionResponse(e.what(), rpcMessage.id());
+            }
+          }
           fn(error, std::move(rpcMessage));
         });
   });
@@ -145,8 +198,9 @@ void TensorPipeAgent::pipeRead(
 void TensorPipeAgent::pipeWrite(
     const std::shared_ptr<tensorpipe::Pipe>& pipe,
     Message&& rpcMessage,
-    std::function<void(const tensorpipe::Error&)> fn) {
-  TensorPipeEntry tpEntry = tensorpipeSerialize(rpcMessage);
+    std::function<void(const tensorpipe::Error&)> fn,
+    const DeviceMap& deviceMap) {
+  TensorPipeEntry tpEntry = tensorpipeSerialize(rpcMessage, deviceMap);
   tensorpipe::Message tpMessage = std::move(tpEntry.message);
   pipe->write(
       std::move(tpMessage),
@@ -209,6 +263,20 @@ void TensorPipeAgent::respond(std::shared_ptr<tensorpipe::Pipe>& pipe) {
 
         uint64_t messageId = requestMessage.id();
 
+        if (requestMessage.type() == MessageType::EXCEPTION) {
+          // The tensors of the request could not be received.
+          pipeWrite(
+              pipe,
+              std::move(requestMessage),
+              [](const tensorpipe::Error& error) {
+                if (error) {
+                  LOG(WARNING)
+                      << "sending error response failed: " << error.what();
+                }
+              });
+          return;
+        }
+
         // Defer user RPC UDF run to thread pool
         threadPool_.run([this,
                          pipe,
@@ -258,6 +326,9 @@ std::shared_ptr<FutureMessage> TensorPipeAgent::send(
   }
 
   const auto& url = findWorkerURL(toWorkerInfo);
+  const DeviceMap& deviceMap = findDeviceMap(deviceMaps_, toWorkerInfo.id_);
+  const DeviceMap& reverseDeviceMap =
+      findDeviceMap(reverseDeviceMaps_, toWorkerInfo.id_);
 
   std::unique_lock<std::mutex> lock(mutex_);
 
@@ -281,7 +352,7 @@ std::shared_ptr<FutureMessage> TensorPipeAgent::send(
   pipeWrite(
       clientPipe.pipe_,
       std::move(requestMessage),
-      [this, &clientPipe, futureResponseMessage](
+      [this, &clientPipe, &reverseDeviceMap, futureResponseMessage](
           const tensorpipe::Error& error) {
         if (error) {
           LOG(WARNING) << "client write error: " << error.what();
@@ -339,8 +410,10 @@ std::shared_ptr<FutureMessage> TensorPipeAgent::send(
                           std::move(responseMessage));
                     }
                   });
-            });
-      });
+            },
+            reverseDeviceMap);
+      },
+      deviceMap);
 
   return futureResponseMessage;
 }
@@ -6,6 +6,7 @@
 #include <tensorpipe/core/listener.h>
 #include <tensorpipe/core/pipe.h>
 #include <torch/csrc/distributed/rpc/rpc_agent.h>
+#include <torch/csrc/distributed/rpc/utils.h>
 
 #include <atomic>
 #include <thread>
@@ -16,12 +17,20 @@ namespace rpc {
 
 struct TensorPipeRpcBackendOptions : public RpcBackendOptions {
   std::map<std::string, worker_id_t> workerNameToId;
+  // For every destination worker, maps the CUDA devices of this worker to
+  // those of the destination. CUDA tensors in requests to the worker are
+  // received on the mapped device, and CUDA tensors in its responses on the
+  // device that maps to theirs. Tensors on devices that are not in the map
+  // are received on the device with the same index.
+  std::map<std::string, DeviceMap> deviceMaps;
 };
 
 // TensorPipeAgent leverages tensorpipe (https://github.com/pytorch/tensorpipe)
 // to move tensors and payload through fatested transport and channel
 // transparently. We can see it as a hybrid RPC transport, providing
-// shared memory (linux) and tcp (linux & mac). CUDA will be supported next.
+// shared memory (linux) and tcp (linux & mac). CUDA tensors are sent through
+// the host, and received on the device given by the device maps of the
+// options.
 class TensorPipeAgent : public RpcAgent {
  public:
   TensorPipeAgent(
@@ -67,16 +76,20 @@ class TensorPipeAgent : public RpcAgent {
 
   // TensorPipe read function that could be used to read response messages
   // by client, and read request messages by server.
+  // The devices the sender recorded for CUDA tensors are mapped through
+  // deviceMap.
   void pipeRead(
       const std::shared_ptr<tensorpipe::Pipe>&,
-      std::function<void(const tensorpipe::Error&, Message&&)>);
+      std::function<void(const tensorpipe::Error&, Message&&)>,
+      const DeviceMap& deviceMap = {});
 
   // TensorPipe write function that could be used to write response
   // messages by server, and write request messages by client.
   void pipeWrite(
       const std::shared_ptr<tensorpipe::Pipe>&,
       Message&& message,
-      std::function<void(const tensorpipe::Error&)>);
+      std::function<void(const tensorpipe::Error&)>,
+      const DeviceMap& deviceMap = {});
 
   // Callback of listener accept()
   void onListenerAccepted(
@@ -115,6 +128,10 @@ class TensorPipeAgent : public RpcAgent {
   std::unordered_map<std::string, WorkerInfo> workerNameToInfo_;
   std::unordered_map<std::string, std::string> workerNameToURL_;
 
+  // opts_.deviceMaps keyed on id, and their inverses to receive responses.
+  std::unordered_map<worker_id_t, DeviceMap> deviceMaps_;
+  std::unordered_map<worker_id_t, DeviceMap> reverseDeviceMaps_;
+
   const std::shared_ptr<::c10d::Store> addressStore_;
   const TensorPipeRpcBackendOptions opts_;
 
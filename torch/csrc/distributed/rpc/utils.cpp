@@ -212,6 +212,45 @@ parseWireSections(const void* data, size_t data_size) {
 
 static const char* kMeta = "meta";
 static const char* kPayload = "payload";
+static const char* kDataSizes = "data_sizes";
+
+struct WireSection {
+  std::string name;
+  const char* data;
+  size_t size;
+};
+
+std::string writeWireSections(const std::vector<WireSection>& sections) {
+  std::string header;
+  size_t tot = 0;
+  for (const auto& e : sections) {
+    tot += e.size;
+    header.append(e.name)
+        .append(" ")
+        .append(c10::to_string(e.size))
+        .append("\n");
+  }
+  header.push_back('\n');
+
+  std::string out;
+  out.reserve(header.size() + tot);
+  out.append(header);
+  for (const auto& e : sections) {
+    out.append(e.data, e.size);
+  }
+  return out;
+}
+
+void checkCPUTensors(const std::vector<at::Tensor>& tensors) {
+  for (const auto& tensor : tensors) {
+    TORCH_CHECK(
+        tensor.device().is_cpu(),
+        "ProcessGroup RPC backend only supports",
+        " CPU tensors, please move your tensors to CPU before sending ",
+        "them over RPC. Found tensor on device: ",
+        tensor.device());
+  }
+}
 }; // namespace
 
 c10::List<at::Tensor> cloneSparseTensors(
@@ -241,21 +280,9 @@ c10::List<at::Tensor> cloneSparseTensors(
 std::string wireSerialize(
     const std::vector<char>& payload,
     const std::vector<at::Tensor>& tensors) {
-  for (const auto& tensor : tensors) {
-    TORCH_CHECK(
-        tensor.device().is_cpu(),
-        "ProcessGroup RPC backend only supports",
-        " CPU tensors, please move your tensors to CPU before sending ",
-        "them over RPC. Found tensor on device: ",
-        tensor.device());
-  }
+  checkCPUTensors(tensors);
 
-  struct Ent {
-    std::string name;
-    const char* data;
-    size_t size;
-  };
-  std::vector<Ent> entries;
+  std::vector<WireSection> entries;
   std::string metaEntry;
   std::vector<jit::WriteableTensorData> tensorData;
 
@@ -281,24 +308,7 @@ std::string wireSerialize(
     }
   }
 
-  std::string header;
-  size_t tot = 0;
-  for (const auto& e : entries) {
-    tot += e.size;
-    header.append(e.name)
-        .append(" ")
-        .append(c10::to_string(e.size))
-        .append("\n");
-  }
-  header.push_back('\n');
-
-  std::string out;
-  out.reserve(header.size() + tot);
-  out.append(header);
-  for (const auto& e : entries) {
-    out.append(e.data, e.size);
-  }
-  return out;
+  return writeWireSections(entries);
 }
 
 std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserialize(
@@ -353,7 +363,129 @@ std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserialize(
   return {std::move(payload), std::move(tensors)};
 }
 
-TensorPipeEntry tensorpipeSerialize(const Message& rpcMessage) {
+std::pair<std::string, std::vector<at::Tensor>> wireSerializeOutOfBand(
+    const std::vector<char>& payload,
+    const std::vector<at::Tensor>& tensors) {
+  checkCPUTensors(tensors);
+
+  std::vector<WireSection> entries;
+  std::string metaEntry;
+  std::vector<int64_t> dataSizes;
+  std::vector<at::Tensor> buffers;
+
+  if (!payload.empty()) {
+    entries.push_back({kPayload, payload.data(), payload.size()});
+  }
+
+  if (!tensors.empty()) {
+    torch::jit::Pickler pickler([&](const void* buf, size_t sz) -> size_t {
+      metaEntry.append(static_cast<const char*>(buf), sz);
+      return sz;
+    });
+    pickler.protocol();
+    pickler.pushIValue(cloneSparseTensors(tensors));
+    pickler.stop();
+    entries.push_back({kMeta, metaEntry.data(), metaEntry.size()});
+
+    // The data sections stay where they are; the header only records their
+    // sizes. Every buffer holds on to the storage it views.
+    for (const auto& data : pickler.tensorData()) {
+      const auto size = data.sizeInBytes();
+      dataSizes.push_back(size);
+      buffers.push_back(at::from_blob(
+          // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+          const_cast<char*>(data.data()),
+          {static_cast<int64_t>(size)},
+          [data](void*) {},
+          at::kByte));
+    }
+    entries.push_back({kDataSizes,
+                       reinterpret_cast<const char*>(dataSizes.data()),
+                       dataSizes.size() * sizeof(int64_t)});
+  }
+
+  return {writeWireSections(entries), std::move(buffers)};
+}
+
+std::tuple<std::vector<char>, std::vector<at::Tensor>, std::vector<at::Tensor>>
+wireDeserializeOutOfBand(const void* data, size_t data_size) {
+  auto sections = parseWireSections(data, data_size);
+
+  std::vector<char> payload;
+  auto payloadIt = sections.find(kPayload);
+  if (payloadIt != sections.end() && payloadIt->second.second != 0) {
+    payload.assign(
+        payloadIt->second.first,
+        payloadIt->second.first + payloadIt->second.second);
+  }
+
+  std::vector<at::Tensor> tensors;
+  std::vector<at::Tensor> buffers;
+  auto metaIt = sections.find(kMeta);
+  if (metaIt != sections.end()) {
+    auto sizesIt = sections.find(kDataSizes);
+    TORCH_CHECK(
+        sizesIt != sections.end() &&
+            sizesIt->second.second % sizeof(int64_t) == 0,
+        "Missing tensor data sizes in out-of-band RPC header");
+    std::vector<int64_t> dataSizes(sizesIt->second.second / sizeof(int64_t));
+    memcpy(dataSizes.data(), sizesIt->second.first, sizesIt->second.second);
+    buffers.resize(dataSizes.size());
+
+    const auto& metaData = metaIt->second;
+    size_t metaDataPos = 0;
+    auto metaDataReadFunc = [&](char* buf, size_t n) -> size_t {
+      if (metaDataPos >= metaData.second || n == 0) {
+        return 0;
+      }
+      size_t toCopy = std::min(metaDataPos + n, metaData.second) - metaDataPos;
+      memcpy(buf, metaData.first + metaDataPos, toCopy);
+      metaDataPos += toCopy;
+      return toCopy;
+    };
+    // Allocate the destination of every data section up front; the caller
+    // receives straight into it.
+    auto sectionReadFunc = [&](const std::string& ename) -> at::DataPtr {
+      const auto index = c10::stoll(ename);
+      TORCH_CHECK(
+          index >= 0 && static_cast<size_t>(index) < dataSizes.size(),
+          "Couldn't find entity " + ename);
+      const auto size = dataSizes[index];
+      auto dptr = at::getCPUAllocator()->allocate(size);
+      buffers[index] =
+          at::from_blob(dptr.get(), {size}, at::TensorOptions(at::kByte));
+      return dptr;
+    };
+
+    // No need to pass typeResolver here, as it always processes string and
+    // tensors only
+    torch::jit::Unpickler unpickler(
+        metaDataReadFunc, nullptr, nullptr, sectionReadFunc, {});
+    auto ival = unpickler.parse_ivalue();
+    for (auto&& t : ival.toTensorList()) {
+      tensors.emplace_back(std::move(t));
+    }
+    for (const auto& buffer : buffers) {
+      TORCH_CHECK(
+          buffer.defined(), "Unreferenced tensor data in out-of-band header");
+    }
+  }
+  return std::make_tuple(
+      std::move(payload), std::move(tensors), std::move(buffers));
+}
+
+namespace {
+
+// The message metadata holds the message type and id in 8 bytes each,
+// followed by the target device of every tensor, or -1 for the host.
+constexpr size_t kTpMetadataHeaderSize = 2 * sizeof(int64_t);
+constexpr c10::DeviceIndex kTpHostDevice = -1;
+
+} // namespace
+
+TensorPipeEntry tensorpipeSerialize(
+    const Message& rpcMessage,
+    const DeviceMap& deviceMap) {
   tensorpipe::Message tpMessage;
   std::vector<torch::Tensor> reservedTensors;
   std::vector<std::vector<uint8_t>> copiedTensors;
@@ -366,8 +498,9 @@ TensorPipeEntry tensorpipeSerialize(const Message& rpcMessage) {
   tpMessage.length = payload.size();
 
   // Metadata - encode rpc message type and message id into
-  // 8 bytes respectively
-  tpMessage.metadata.resize(2 * sizeof(int64_t));
+  // 8 bytes respectively, followed by the target devices.
+  tpMessage.metadata.resize(
+      kTpMetadataHeaderSize + tensors.size() * sizeof(c10::DeviceIndex));
   int64_t mType = static_cast<int>(rpcMessage.type());
   int64_t mId = rpcMessage.id();
   memcpy((void*)tpMessage.metadata.data(), &mType, sizeof(int64_t));
@@ -378,7 +511,22 @@ TensorPipeEntry tensorpipeSerialize(const Message& rpcMessage) {
 
   // Tensors
   tpMessage.tensors.reserve(tensors.size());
-  for (at::Tensor tensor : tensors) {
+  for (size_t i = 0; i < tensors.size(); i++) {
+    at::Tensor tensor = tensors[i];
+    c10::DeviceIndex targetDevice = kTpHostDevice;
+    if (tensor.is_cuda()) {
+      auto it = deviceMap.find(tensor.device().index());
+      targetDevice =
+          it == deviceMap.end() ? tensor.device().index() : it->second;
+      // The pickled tensor data of a CUDA tensor is a temporary host copy,
+      // so make the copy here to keep it alive.
+      tensor = tensor.cpu();
+    }
+    memcpy(
+        (void*)(tpMessage.metadata.data() + kTpMetadataHeaderSize +
+                i * sizeof(c10::DeviceIndex)),
+        &targetDevice,
+        sizeof(c10::DeviceIndex));
     // Keep original user tensors and cloned sparse tensors
     reservedTensors.push_back(tensor);
     tensorpipe::Message::Tensor tpTensor;
@@ -415,10 +563,12 @@ TensorPipeEntry tensorpipeSerialize(const Message& rpcMessage) {
 Message tensorpipeAllocateMessage(const tensorpipe::Message& tpMessage) {
   // Payload, message type and message id
   std::vector<char> payload(tpMessage.length);
+  const size_t metadataSize = kTpMetadataHeaderSize +
+      tpMessage.tensors.size() * sizeof(c10::DeviceIndex);
   TORCH_INTERNAL_ASSERT(
-      tpMessage.metadata.size() == 2 * sizeof(int64_t),
+      tpMessage.metadata.size() == metadataSize,
       "message metadata must be ",
-      2 * sizeof(int64_t),
+      metadataSize,
       " bytes, whereas it is ",
       tpMessage.metadata.size(),
       " bytes");
@@ -445,12 +595,17 @@ Message tensorpipeAllocateMessage(const tensorpipe::Message& tpMessage) {
 
     auto sectionReadFunc = [&](const std::string& ename) -> at::DataPtr {
       TORCH_INTERNAL_ASSERT(ename == "0", "single tensor ename must be \"0\"");
-      // TODO: CUDA memory allocation
       return at::getCPUAllocator()->allocate(tpTensor.length);
     };
 
+    // The data is not received yet, so keep the tensors on the host until
+    // tensorpipeMoveTensorsToDevices.
     torch::jit::Unpickler unpickler(
-        metaDataReadFunc, nullptr, nullptr, sectionReadFunc, {});
+        metaDataReadFunc,
+        nullptr,
+        nullptr,
+        sectionReadFunc,
+        at::Device(at::DeviceType::CPU));
     auto ival = unpickler.parse_ivalue();
     auto&& t = ival.toTensor();
     tensors.emplace_back(std::move(t));
@@ -459,6 +614,33 @@ Message tensorpipeAllocateMessage(const tensorpipe::Message& tpMessage) {
   return Message(std::move(payload), std::move(tensors), mType, mId);
 }
 
+void tensorpipeMoveTensorsToDevices(
+    const std::string& metadata,
+    Message& rpcMessage,
+    const DeviceMap& deviceMap) {
+  auto& tensors = rpcMessage.tensors();
+  TORCH_INTERNAL_ASSERT(
+      metadata.size() ==
+          kTpMetadataHeaderSize + tensors.size() * sizeof(c10::DeviceIndex),
+      "message metadata does not match the number of tensors");
+  for (size_t i = 0; i < tensors.size(); i++) {
+    c10::DeviceIndex targetDevice;
+    memcpy(
+        &targetDevice,
+        metadata.data() + kTpMetadataHeaderSize + i * sizeof(c10::DeviceIndex),
+        sizeof(c10::DeviceIndex));
+    if (targetDevice == kTpHostDevice) {
+      continue;
+    }
+    auto it = deviceMap.find(targetDevice);
+    if (it != deviceMap.end()) {
+      targetDevice = it->second;
+    }
+    tensors[i] =
+        tensors[i].to(at::Device(at::DeviceType::CUDA, targetDevice));
+  }
+}
+
 } // namespace rpc
 } // namespace distributed
 } // namespace torch
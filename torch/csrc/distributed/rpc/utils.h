@@ -1,5 +1,6 @@
 #pragma once
 
+#include <c10/core/Device.h>
 #include <tensorpipe/core/message.h>
 #include <torch/csrc/distributed/rpc/rpc_command_base.h>
 
@@ -40,6 +41,26 @@ TORCH_API std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserialize(
     const void* data,
     size_t data_size);
 
+// Out-of-band variant of wireSerialize. The returned header holds the payload,
+// the tensor metadata, and the size of every tensor data section, but not the
+// data itself. The data sections are returned as 1-D byte tensors that alias
+// the storages of `tensors` (or of the clones made by cloneSparseTensors), so
+// they can be sent as separate buffers without copying.
+TORCH_API std::pair<std::string, std::vector<at::Tensor>>
+wireSerializeOutOfBand(
+    const std::vector<char>& payload,
+    const std::vector<at::Tensor>& tensors);
+
+// Parses a header produced by wireSerializeOutOfBand into the payload and the
+// tensors, whose storages are allocated but not yet filled. Also returns one
+// byte tensor per data section that aliases the storage it belongs to. The
+// caller receives the data sections into these buffers, in order, after
+// which the tensors are valid. The buffers don't own their memory; they are
+// only valid while the tensors are alive.
+TORCH_API std::
+    tuple<std::vector<char>, std::vector<at::Tensor>, std::vector<at::Tensor>>
+    wireDeserializeOutOfBand(const void* data, size_t data_size);
+
 // TensorPipeEntry represents serialized tensorpipe message,
 // plus reserved tensor datas to keep memory lifetime.
 struct TensorPipeEntry {
@@ -51,18 +72,35 @@ struct TensorPipeEntry {
   std::vector<std::vector<uint8_t>> copiedTensors;
 };
 
+// Maps CUDA device indices of one worker to those of another worker.
+using DeviceMap = std::unordered_map<c10::DeviceIndex, c10::DeviceIndex>;
+
 // TensorPipe doesn't own any underlying memory. Users are required to
 // keep rpcMessage alive for the returned TensorPipeEntry to be valid,
 // since TensorPipe message just keeps raw pointers to the memory.
-TORCH_API TensorPipeEntry tensorpipeSerialize(const Message& rpcMessage);
+//
+// CUDA tensors are copied to the host. The message metadata records the
+// device the receiver should move every CUDA tensor to, which is given by
+// deviceMap, or the device of the tensor if it is not in deviceMap.
+TORCH_API TensorPipeEntry
+tensorpipeSerialize(const Message& rpcMessage, const DeviceMap& deviceMap = {});
 
 // The passed-in tensorpipe message is partial, which just contains
 // necessary information for memory allocation, like payload length
 // and tensor metadata. The returned RPC message doesn't have any
 // data, but would be valid after tensorpipe finishs data transfer.
+// All its tensors are allocated on the host.
 TORCH_API Message
 tensorpipeAllocateMessage(const tensorpipe::Message& tpMessage);
 
+// Moves the tensors of a message returned by tensorpipeAllocateMessage that
+// tensorpipe finished receiving to the CUDA devices recorded by the sender in
+// metadata, after mapping them through deviceMap.
+TORCH_API void tensorpipeMoveTensorsToDevices(
+    const std::string& metadata,
+    Message& rpcMessage,
+    const DeviceMap& deviceMap = {});
+
 // Some Tensors are effectively views of larger Tensors, where only a small
 // subset of the Storage data is referenced. This normally is good and avoids
 // copies when kept locally, but if we naively push the whole Storage over the
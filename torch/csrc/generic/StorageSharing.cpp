@@ -15,6 +15,12 @@ static PyObject * THPStorage_(sharedDecref)(THPStorage *self, PyObject *noargs)
   if (ctx) {
     ctx->decref();
   }
+#ifndef _WIN32
+  THManagedMapBlock *block = THManagedMapPool::fromDataPtr(storage->data_ptr());
+  if (block) {
+    block->decref();
+  }
+#endif
 #endif
   Py_INCREF(self);
   return (PyObject *)self;
@@ -30,6 +36,12 @@ static PyObject * THPStorage_(sharedIncref)(THPStorage *self, PyObject *noargs)
   if (ctx) {
     ctx->incref();
   }
+#ifndef _WIN32
+  THManagedMapBlock *block = THManagedMapPool::fromDataPtr(storage->data_ptr());
+  if (block) {
+    block->incref();
+  }
+#endif
 #endif
   Py_RETURN_NONE;
   END_HANDLE_TH_ERRORS
@@ -129,6 +141,84 @@ static PyObject * THPStorage_(newSharedFilename)(PyObject *_unused, PyObject *ar
   END_HANDLE_TH_ERRORS
 }
 
+#ifndef _WIN32
+// Small storages are shared as blocks of a few large shared memory segments
+// (slabs), so that sending many of them neither creates a file nor keeps a
+// file descriptor open per storage. Returns None for storages that are too
+// large for a block or already shared otherwise.
+static PyObject * THPStorage_(sharePooled)(THPStorage *self, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  THWStorage *storage = self->cdata;
+  THManagedMapBlock *block;
+  // Storage is already in the pool, just return its block
+  if ((block = THManagedMapPool::fromDataPtr(storage->data_ptr()))) {
+    // done
+  } else if (THManagedMapAllocator::fromDataPtr(storage->data_ptr()) ||
+             THMapAllocator::fromDataPtr(storage->data_ptr())) {
+    Py_RETURN_NONE;
+  } else {
+    at::DataPtr data_ptr = THManagedMapPool::allocate(storage->nbytes());
+    if (!data_ptr) {
+      Py_RETURN_NONE;
+    }
+    THWStoragePtr new_storage(THWStorage_(newWithDataAndAllocator)(
+        std::move(data_ptr), storage->nbytes() / sizeof(scalar_t), /* allocator */ nullptr));
+    THWStorage_(copy)(new_storage, storage);
+    THWStorage_(swap)(storage, new_storage);
+    block = THManagedMapPool::fromDataPtr(storage->data_ptr());
+    AT_ASSERT(block);
+  }
+
+  THPObjectPtr manager_handle(PyBytes_FromString(block->manager_handle()));
+  if (!manager_handle) return nullptr;
+  THPObjectPtr slab_handle(PyBytes_FromString(block->filename()));
+  if (!slab_handle) return nullptr;
+  THPObjectPtr offset(PyLong_FromSize_t(block->offset()));
+  if (!offset) return nullptr;
+  THPObjectPtr size(PyLong_FromLong(storage->nbytes() / sizeof(scalar_t)));
+  if (!size) return nullptr;
+
+  THPObjectPtr tuple(PyTuple_New(4));
+  if (!tuple) return nullptr;
+  PyTuple_SET_ITEM(tuple.get(), 0, manager_handle.release());
+  PyTuple_SET_ITEM(tuple.get(), 1, slab_handle.release());
+  PyTuple_SET_ITEM(tuple.get(), 2, offset.release());
+  PyTuple_SET_ITEM(tuple.get(), 3, size.release());
+  return tuple.release();
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * THPStorage_(newSharedPooled)(PyObject *_unused, PyObject *args)
+{
+  HANDLE_TH_ERRORS
+  THPUtils_assert(PyTuple_GET_SIZE(args) == 4, "tuple of 4 items expected");
+  PyObject *_manager_handle = PyTuple_GET_ITEM(args, 0);
+  PyObject *_slab_handle = PyTuple_GET_ITEM(args, 1);
+  PyObject *_offset = PyTuple_GET_ITEM(args, 2);
+  PyObject *_size = PyTuple_GET_ITEM(args, 3);
+  if (!PyBytes_Check(_manager_handle) || !PyBytes_Check(_slab_handle) ||
+      !THPUtils_checkLong(_offset) || !THPUtils_checkLong(_size)) {
+    THPUtils_invalidArguments(args, nullptr, "_new_shared in file system pool mode", 1,
+        "a handle (string/bytes), a block offset (int) and storage size (int)");
+    return nullptr;
+  }
+  const char *manager_handle = PyBytes_AS_STRING(_manager_handle);
+  const char *slab_handle = PyBytes_AS_STRING(_slab_handle);
+  size_t offset = (size_t)THPUtils_unpackLong(_offset);
+  int64_t size = THPUtils_unpackLong(_size);
+  THPUtils_assert(
+      size >= 0 && offset + size * sizeof(scalar_t) <= THManagedMapPool::kSlabSize,
+      "invalid size of a shared memory pool block");
+  return THPStorage_(New)(
+          THWStorage_(newWithDataAndAllocator)(
+            THManagedMapPool::fromBlock(manager_handle, slab_handle, offset),
+            size,
+            /* allocator */ nullptr));
+  END_HANDLE_TH_ERRORS
+}
+#endif
+
 static THWStorage* THPStorage_(newFdStorage)(ptrdiff_t size)
 {
   int flags = TH_ALLOCATOR_MAPPED_SHAREDMEM |
@@ -380,10 +470,7 @@ static PyObject * THPStorage_(newSharedCuda)(PyObject *_unused, PyObject *args)
     // Ensure that producer prepared all tensor's data
     std::string s_ipc_event_handle =
         THPStorage_(bytesAsHandleString)(_event_handle);
-    auto ipc_event_handle = reinterpret_cast<const cudaIpcEventHandle_t*>(
-        s_ipc_event_handle.c_str());
-    cudaEvent_t event;
-    cudaIpcOpenEventHandle(&event, *ipc_event_handle);
+    cudaEvent_t event = torch::GetReceivedEvent(s_ipc_event_handle);
     AT_CUDA_CHECK(
         cudaStreamWaitEvent(c10::cuda::getCurrentCUDAStream(device), event, 0));
   }
@@ -518,7 +605,11 @@ PyObject * THPStorage_(isShared)(THPStorage *self, PyObject *noargs)
   Py_RETURN_TRUE;
 #else
   if (THMapAllocator::fromDataPtr(self->cdata->data_ptr()) ||
-      THManagedMapAllocator::fromDataPtr(self->cdata->data_ptr())) {
+      THManagedMapAllocator::fromDataPtr(self->cdata->data_ptr())
+#ifndef _WIN32
+      || THManagedMapPool::fromDataPtr(self->cdata->data_ptr())
+#endif
+      ) {
     Py_RETURN_TRUE;
   } else {
     Py_RETURN_FALSE;
@@ -539,6 +630,10 @@ static PyMethodDef THPStorage_(sharingMethods)[] = {
   {"_share_filename_", (PyCFunction)THPStorage_(shareFilename), METH_NOARGS, nullptr},
   {"_new_shared_filename", (PyCFunction)(void(*)(void))THPStorage_(newSharedFilename), METH_VARARGS | METH_STATIC, nullptr},
   {"_new_using_filename", (PyCFunction)(void(*)(void))THPStorage_(pyNewFilenameStorage), METH_VARARGS | METH_STATIC, nullptr},
+#ifndef _WIN32
+  {"_share_pooled_", (PyCFunction)THPStorage_(sharePooled), METH_NOARGS, nullptr},
+  {"_new_shared_pooled", (PyCFunction)(void(*)(void))THPStorage_(newSharedPooled), METH_VARARGS | METH_STATIC, nullptr},
+#endif
 #endif
   {"_weak_ref", (PyCFunction)THPStorage_(weakRef), METH_NOARGS, nullptr},
   {"_free_weak_ref", (PyCFunction)(void(*)(void))THPStorage_(freeWeakRef), METH_O | METH_STATIC, nullptr},
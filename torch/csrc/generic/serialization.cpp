@@ -30,27 +30,27 @@ void THPStorage_(writeFileRaw)(THWStorage *self, io fd, bool save_size)
       size_bytes,
       cudaMemcpyDeviceToHost));
 #endif
+  // fast track for bytes and little endian
+  bool write_raw = sizeof(scalar_t) == 1 ||
+      torch::utils::THP_nativeByteOrder() == torch::utils::THPByteOrder::THP_LITTLE_ENDIAN;
   if (save_size) {
-    if (torch::utils::THP_nativeByteOrder() ==
-        torch::utils::THPByteOrder::THP_LITTLE_ENDIAN)
-      doWrite(fd, &numel, sizeof(int64_t));
-    else {
-      int64_t nsize; // convert big endian cpu to little endian storage
-      torch::utils::THP_encodeInt64Buffer(
-          (uint8_t*)&nsize,
-          (const int64_t*)&numel,
-          torch::utils::THPByteOrder::THP_LITTLE_ENDIAN,
-          1);
-      doWrite(fd, &nsize, sizeof(int64_t));
+    int64_t nsize; // convert big endian cpu to little endian storage
+    torch::utils::THP_encodeInt64Buffer(
+        (uint8_t*)&nsize,
+        (const int64_t*)&numel,
+        torch::utils::THPByteOrder::THP_LITTLE_ENDIAN,
+        1);
+    if (write_raw) {
+      doWriteSized(fd, &nsize, sizeof(int64_t), data, size_bytes);
+      return;
     }
+    doWrite(fd, &nsize, sizeof(int64_t));
   }
-  // fast track for bytes and little endian
-  if (sizeof(scalar_t) == 1 ||
-      torch::utils::THP_nativeByteOrder() ==
-          torch::utils::THPByteOrder::THP_LITTLE_ENDIAN) {
+  if (write_raw) {
     doWrite(fd, data, size_bytes);
   } else {
-    int64_t buffer_size = std::min(numel, (int64_t)5000);
+    // 1MB per write
+    int64_t buffer_size = std::min(numel, (int64_t)((1 << 20) / sizeof(scalar_t)));
     std::unique_ptr<uint8_t[]> le_buffer(new uint8_t[buffer_size * sizeof(scalar_t)]);
     for (int64_t i = 0; i < numel; i += buffer_size) {
       size_t to_convert = std::min(numel - i, buffer_size);
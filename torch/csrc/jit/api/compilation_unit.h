@@ -94,7 +94,10 @@ struct TORCH_API CompilationUnit {
       // if non-null, the first argument to each def, is bound to this value
       const Self* self,
       // see [name mangling]
-      bool shouldMangle = false);
+      bool shouldMangle = false,
+      // if true, the functions (but `__init__`) are compiled on first use
+      // instead of here, see GraphFunction::defer_definition
+      bool lazy = false);
 
   // same as above but parse the definitions from source
   // Returns the list of Function's just defined.
@@ -0,0 +1,196 @@
+#include <torch/csrc/jit/api/dynamic_batcher.h>
+
+#include <ATen/ATen.h>
+#include <ATen/core/grad_mode.h>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+bool batchable(
+    const std::vector<at::Tensor>& a,
+    const std::vector<at::Tensor>& b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (a[i].scalar_type() != b[i].scalar_type() ||
+        a[i].device() != b[i].device() ||
+        a[i].sizes().slice(1) != b[i].sizes().slice(1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Splits one output of a batch into the rows of each request.
+std::vector<at::Tensor> splitRows(
+    const c10::IValue& output,
+    const std::vector<int64_t>& rows,
+    int64_t total_rows) {
+  TORCH_CHECK(
+      output.isTensor(),
+      "DynamicBatcher expects the method to return tensors, got ",
+      output.tagKind());
+  auto tensor = output.toTensor();
+  TORCH_CHECK(
+      tensor.dim() > 0 && tensor.size(0) == total_rows,
+      "DynamicBatcher expects an output with one row per input row (",
+      total_rows,
+      "), got a tensor of sizes ",
+      tensor.sizes());
+  return tensor.split_with_sizes(rows, 0);
+}
+
+} // namespace
+
+DynamicBatcher::DynamicBatcher(
+    Module module,
+    DynamicBatcherOptions options,
+    std::string method_name)
+    : module_(std::move(module)),
+      method_(module_.get_method(method_name)),
+      options_(options),
+      return_type_(method_.function().getSchema().returns().at(0).type()) {
+  TORCH_CHECK(
+      options_.max_batch_size > 0, "DynamicBatcher needs max_batch_size > 0");
+  worker_ = std::thread([this] { workerLoop(); });
+}
+
+DynamicBatcher::~DynamicBatcher() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  worker_.join();
+}
+
+c10::intrusive_ptr<c10::ivalue::Future> DynamicBatcher::forwardAsync(
+    std::vector<c10::IValue> inputs) {
+  TORCH_CHECK(!inputs.empty(), "DynamicBatcher requests need inputs");
+  Request request;
+  request.rows = -1;
+  for (auto& input : inputs) {
+    TORCH_CHECK(
+        input.isTensor(),
+        "DynamicBatcher can only batch tensor arguments, got ",
+        input.tagKind());
+    auto tensor = std::move(input).toTensor();
+    TORCH_CHECK(
+        tensor.dim() > 0,
+        "DynamicBatcher can't batch a zero-dimensional tensor");
+    TORCH_CHECK(
+        request.rows == -1 || tensor.size(0) == request.rows,
+        "DynamicBatcher expects all inputs of a request to have the same "
+        "size in dim 0, got ",
+        request.rows,
+        " and ",
+        tensor.size(0));
+    request.rows = tensor.size(0);
+    request.inputs.push_back(std::move(tensor));
+  }
+  request.future = c10::make_intrusive<c10::ivalue::Future>(return_type_);
+  auto future = request.future;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    TORCH_CHECK(!stop_, "DynamicBatcher is shutting down");
+    request.enqueued = std::chrono::steady_clock::now();
+    queued_rows_ += request.rows;
+    queue_.push_back(std::move(request));
+  }
+  cv_.notify_one();
+  return future;
+}
+
+void DynamicBatcher::workerLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return;
+    }
+    // Wait for the batch to fill up, but not past the deadline of the oldest
+    // request. Once stopping, run what is queued right away.
+    const auto deadline = queue_.front().enqueued + options_.max_delay;
+    while (!stop_ && queued_rows_ < options_.max_batch_size &&
+           cv_.wait_until(lock, deadline) != std::cv_status::timeout) {
+    }
+
+    std::vector<Request> batch;
+    int64_t rows = 0;
+    while (!queue_.empty()) {
+      Request& next = queue_.front();
+      if (!batch.empty() &&
+          (rows + next.rows > options_.max_batch_size ||
+           !batchable(batch.front().inputs, next.inputs))) {
+        break;
+      }
+      rows += next.rows;
+      queued_rows_ -= next.rows;
+      batch.push_back(std::move(next));
+      queue_.pop_front();
+    }
+    lock.unlock();
+    runBatch(std::move(batch));
+    lock.lock();
+  }
+}
+
+void DynamicBatcher::runBatch(std::vector<Request> batch) {
+  std::vector<int64_t> rows;
+  int64_t total_rows = 0;
+  for (const auto& request : batch) {
+    rows.push_back(request.rows);
+    total_rows += request.rows;
+  }
+  std::vector<c10::IValue> results(batch.size());
+  try {
+    at::AutoGradMode no_grad(false);
+    const size_t num_inputs = batch.front().inputs.size();
+    std::vector<c10::IValue> inputs;
+    for (size_t i = 0; i < num_inputs; ++i) {
+      if (batch.size() == 1) {
+        inputs.emplace_back(batch.front().inputs[i]);
+        continue;
+      }
+      std::vector<at::Tensor> parts;
+      for (const auto& request : batch) {
+        parts.push_back(request.inputs[i]);
+      }
+      inputs.emplace_back(at::cat(parts, 0));
+    }
+    auto output = method_(std::move(inputs));
+
+    if (output.isTuple()) {
+      const auto& elements = output.toTuple()->elements();
+      std::vector<std::vector<c10::IValue>> fields(batch.size());
+      for (const auto& element : elements) {
+        auto parts = splitRows(element, rows, total_rows);
+        for (size_t r = 0; r < batch.size(); ++r) {
+          fields[r].emplace_back(std::move(parts[r]));
+        }
+      }
+      for (size_t r = 0; r < batch.size(); ++r) {
+        results[r] = c10::ivalue::Tuple::create(std::move(fields[r]));
+      }
+    } else {
+      auto parts = splitRows(output, rows, total_rows);
+      for (size_t r = 0; r < batch.size(); ++r) {
+        results[r] = std::move(parts[r]);
+      }
+    }
+  } catch (const std::exception& e) {
+    for (auto& request : batch) {
+      request.future->setError(e.what());
+    }
+    return;
+  }
+  for (size_t r = 0; r < batch.size(); ++r) {
+    batch[r].future->markCompleted(std::move(results[r]));
+  }
+}
+
+} // namespace jit
+} // namespace torch
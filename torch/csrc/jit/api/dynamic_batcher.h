@@ -0,0 +1,83 @@
+#pragma once
+
+#include <ATen/core/ivalue.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/api/module.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+struct TORCH_API DynamicBatcherOptions {
+  // the largest number of rows (sum of the dim 0 sizes of the batched
+  // requests) run in one call
+  int64_t max_batch_size = 32;
+  // how long the oldest queued request may wait for the batch to fill up
+  std::chrono::microseconds max_delay{1000};
+};
+
+// Batches concurrent calls of a method of a module.
+//
+// Each request is a list of tensors whose sizes agree in dim 0. Requests
+// queued within max_delay of each other are concatenated along dim 0, up to
+// max_batch_size rows, and run by a single call of the method on a
+// background thread. The method must return a tensor or a tuple of tensors
+// with one row per input row; the rows of each request are handed back
+// through the future returned when it was queued.
+//
+// Only requests whose tensors agree in dtype, device and all sizes but the
+// first are batched together. The method runs with grad mode disabled.
+class TORCH_API DynamicBatcher {
+ public:
+  explicit DynamicBatcher(
+      Module module,
+      DynamicBatcherOptions options = {},
+      std::string method_name = "forward");
+  // Runs the queued requests, then stops the background thread.
+  ~DynamicBatcher();
+
+  DynamicBatcher(const DynamicBatcher&) = delete;
+  DynamicBatcher& operator=(const DynamicBatcher&) = delete;
+
+  c10::intrusive_ptr<c10::ivalue::Future> forwardAsync(
+      std::vector<c10::IValue> inputs);
+
+  c10::IValue forward(std::vector<c10::IValue> inputs) {
+    auto future = forwardAsync(std::move(inputs));
+    future->wait();
+    return future->value();
+  }
+
+ private:
+  struct Request {
+    std::vector<at::Tensor> inputs;
+    int64_t rows;
+    c10::intrusive_ptr<c10::ivalue::Future> future;
+    std::chrono::steady_clock::time_point enqueued;
+  };
+
+  void workerLoop();
+  void runBatch(std::vector<Request> batch);
+
+  Module module_;
+  Method method_;
+  const DynamicBatcherOptions options_;
+  c10::TypePtr return_type_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Request> queue_;
+  int64_t queued_rows_ = 0;
+  bool stop_ = false;
+  std::thread worker_;
+};
+
+} // namespace jit
+} // namespace torch
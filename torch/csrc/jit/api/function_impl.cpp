@@ -6,6 +6,9 @@
 #include <torch/csrc/jit/passes/constant_propagation.h>
 #include <torch/csrc/jit/passes/peephole.h>
 
+#include <mutex>
+#include <unordered_set>
+
 namespace torch {
 namespace jit {
 namespace {
@@ -25,6 +28,45 @@ c10::FunctionSchema defaultSchemaFor(const Function& function) {
   }
   return {function.name(), "", std::move(args), std::move(returns)};
 }
+
+// Deferred definitions run the compiler, which updates the compilation unit
+// and the resolvers they share with other functions, so they are run one at a
+// time.
+std::recursive_mutex& lazyDefinitionMutex() {
+  static std::recursive_mutex mutex;
+  return mutex;
+}
+
+// The number of functions whose deferred definition has not run yet, so that
+// the callees of a function are only looked at while there are some.
+std::atomic<size_t> numLazyFunctions{0};
+
+void defineLazyCallees(
+    const Block* block,
+    std::unordered_set<const Function*>& visited) {
+  for (const Node* node : block->nodes()) {
+    Function* callee = nullptr;
+    if (node->kind() == prim::CallFunction) {
+      if (auto fun_type = node->input(0)->type()->cast<FunctionType>()) {
+        callee = fun_type->function();
+      }
+    } else if (node->kind() == prim::CallMethod) {
+      if (auto class_type = node->input(0)->type()->cast<ClassType>()) {
+        callee = class_type->getMethod(node->s(attr::name));
+      }
+    }
+    // graph() runs the deferred definition of the callee.
+    if (callee && callee->isGraphFunction() && visited.insert(callee).second) {
+      defineLazyCallees(callee->graph()->block(), visited);
+    }
+    for (const Block* sub_block : node->blocks()) {
+      defineLazyCallees(sub_block, visited);
+    }
+    if (node->hasAttribute(attr::Subgraph)) {
+      defineLazyCallees(node->g(attr::Subgraph)->block(), visited);
+    }
+  }
+}
 } // namespace
 
 void placeholderCreator(GraphFunction&) {
@@ -51,7 +93,69 @@ IValue GraphFunction::operator()(
   return stack.front();
 }
 
+GraphFunction::~GraphFunction() {
+  if (lazy_) {
+    --numLazyFunctions;
+  }
+}
+
+void GraphFunction::defer_definition() {
+  if (function_creator_ && !lazy_) {
+    lazy_ = true;
+    ++numLazyFunctions;
+  }
+}
+
+void GraphFunction::after_definition(
+    std::function<void(GraphFunction&)> callback) {
+  std::lock_guard<std::recursive_mutex> guard(lazyDefinitionMutex());
+  if (!lazy_ || defining_) {
+    callback(*this);
+    return;
+  }
+  auto creator = std::move(function_creator_);
+  function_creator_ = [creator, callback](GraphFunction& function) {
+    creator(function);
+    callback(function);
+  };
+}
+
+void GraphFunction::define_lazily() const {
+  if (!lazy_) {
+    return;
+  }
+  std::lock_guard<std::recursive_mutex> guard(lazyDefinitionMutex());
+  if (!lazy_ || defining_) {
+    return;
+  }
+  auto& self = const_cast<GraphFunction&>(*this);
+  auto creator = std::move(self.function_creator_);
+  self.function_creator_ = placeholderCreator;
+  defining_ = true;
+  try {
+    creator(self);
+  } catch (...) {
+    // The error is reported again by the next use.
+    self.function_creator_ = std::move(creator);
+    defining_ = false;
+    throw;
+  }
+  self.function_creator_ = nullptr;
+  defining_ = false;
+  lazy_ = false;
+  --numLazyFunctions;
+}
+
+void GraphFunction::define_lazy_callees() const {
+  if (numLazyFunctions == 0) {
+    return;
+  }
+  std::unordered_set<const Function*> visited{this};
+  defineLazyCallees(graph()->block(), visited);
+}
+
 void GraphFunction::ensure_defined() {
+  define_lazily();
   if (function_creator_) {
     auto creator = function_creator_;
     function_creator_ = placeholderCreator;
@@ -62,6 +166,7 @@ void GraphFunction::ensure_defined() {
 }
 
 const c10::FunctionSchema& GraphFunction::getSchema() const {
+  define_lazily();
   if (schema_ == nullptr) {
     schema_ = std::make_unique<c10::FunctionSchema>(defaultSchemaFor(*this));
   }
@@ -5,6 +5,8 @@
 #include <torch/csrc/jit/runtime/graph_executor.h>
 #include <torch/csrc/utils/memory.h>
 
+#include <atomic>
+
 namespace torch {
 namespace jit {
 
@@ -17,6 +19,8 @@ struct TORCH_API GraphFunction : public Function {
         graph_(std::move(graph)),
         function_creator_(std::move(function_creator)) {}
 
+  ~GraphFunction() override;
+
   bool isGraphFunction() const override {
     return true;
   }
@@ -31,10 +35,13 @@ struct TORCH_API GraphFunction : public Function {
       override;
 
   std::shared_ptr<Graph> graph() const override {
+    define_lazily();
     return graph_;
   }
 
   std::shared_ptr<Graph> optimized_graph() const override {
+    define_lazily();
+    define_lazy_callees();
     std::lock_guard<std::recursive_mutex> lock(compile_mutex);
     if (optimized_graph_) {
       return *optimized_graph_;
@@ -65,6 +72,15 @@ struct TORCH_API GraphFunction : public Function {
   // if this isn't yet defined, run its method_creator function
   void ensure_defined() override;
 
+  // Defers the definition of a function that is not defined yet to its first
+  // use: the first call to ensure_defined(), graph() or getSchema(), on any
+  // thread, runs its method_creator function (see CompilationUnit::define).
+  void defer_definition();
+
+  // Runs `callback` on the function once it is defined: right away if it is
+  // defined already, or right after its deferred definition otherwise.
+  void after_definition(std::function<void(GraphFunction&)> callback);
+
   size_t num_inputs() const override {
     return graph()->inputs().size();
   }
@@ -77,6 +93,7 @@ struct TORCH_API GraphFunction : public Function {
   const FunctionSchema& getSchema() const override;
 
   std::string pretty_print_schema() const override {
+    define_lazily();
     AT_ASSERT(schema_);
     std::stringstream ss;
     ss << *schema_;
@@ -102,6 +119,7 @@ struct TORCH_API GraphFunction : public Function {
 
   GraphExecutor& get_executor() override {
     ensure_defined();
+    define_lazy_callees();
     std::lock_guard<std::recursive_mutex> lock(compile_mutex);
     if (executor_) {
       return executor_;
@@ -112,6 +130,16 @@ struct TORCH_API GraphFunction : public Function {
   }
 
  private:
+  // Runs the method_creator function of a function whose definition was
+  // deferred, unless this thread is running it already.
+  void define_lazily() const;
+
+  // Defines the functions whose definition was deferred that this function
+  // calls, directly or not. Defining a function takes a lock that must not be
+  // waited for while holding a compile_mutex, since the thread that holds it
+  // may need that compile_mutex to inline the function into another one.
+  void define_lazy_callees() const;
+
   c10::QualifiedName name_;
   // The original, non-optimized graph
   std::shared_ptr<Graph> graph_; // for debugging and for inlining
@@ -135,6 +163,12 @@ struct TORCH_API GraphFunction : public Function {
   // that it can construct methods out of order
   std::function<void(GraphFunction&)> function_creator_;
 
+  // Whether the definition was deferred and has not been run yet, and
+  // whether it is running. defining_ is guarded by the lock of the deferred
+  // definitions.
+  mutable std::atomic<bool> lazy_{false};
+  mutable bool defining_ = false;
+
   // if absent, then we generate a default schema based on the graph
   // mutable because getSchema caches the default schema if one is requested
   // before a call to setSchema
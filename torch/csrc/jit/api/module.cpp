@@ -1,4 +1,6 @@
 #include <torch/csrc/jit/api/module.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/grad_mode.h>
 #include <c10/util/Exception.h>
 #include <torch/csrc/autograd/generated/variable_factories.h>
 #include <torch/csrc/autograd/record_function.h>
@@ -10,6 +12,9 @@
 #include <torch/csrc/jit/passes/inliner.h>
 #include <torch/csrc/jit/runtime/operator.h>
 
+#include <condition_variable>
+#include <exception>
+
 namespace torch {
 namespace jit {
 
@@ -163,6 +168,94 @@ void Module::clone_method(const Module& orig, const std::string& name) {
   return clone_method(orig, orig.get_method(name).function(), type_remap);
 }
 
+void Module::warmup(
+    const std::unordered_map<std::string, Stack>& example_inputs) const {
+  struct Task {
+    Method method;
+    c10::optional<Stack> inputs;
+  };
+  std::vector<Task> tasks;
+  for (const auto& method : get_methods()) {
+    // function creators are not safe to run concurrently
+    method.function().ensure_defined();
+    tasks.push_back({method, c10::nullopt});
+  }
+  for (const auto& entry : example_inputs) {
+    auto it = std::find_if(tasks.begin(), tasks.end(), [&](const Task& task) {
+      return task.method.name() == entry.first;
+    });
+    TORCH_CHECK(
+        it != tasks.end(),
+        "Module::warmup: module has no method named '",
+        entry.first,
+        "'");
+    Stack inputs = entry.second;
+    inputs.insert(inputs.begin(), _ivalue());
+    it->method.function().getSchema().checkAndNormalizeInputs(
+        inputs, Kwargs());
+    it->inputs = std::move(inputs);
+  }
+
+  // Tasks are pulled by the pool threads and by this thread alike, so this
+  // finishes even if the pool is busy (or this runs on it).
+  struct State {
+    explicit State(std::vector<Task> tasks)
+        : tasks(std::move(tasks)), remaining(this->tasks.size()) {}
+    std::vector<Task> tasks;
+    const bool grad_enabled = at::GradMode::is_enabled();
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t next = 0;
+    size_t remaining;
+    std::exception_ptr error;
+  };
+  auto state = std::make_shared<State>(std::move(tasks));
+  auto work = [state]() {
+    at::AutoGradMode grad_mode(state->grad_enabled);
+    while (true) {
+      Task* task;
+      {
+        std::lock_guard<std::mutex> guard(state->mutex);
+        if (state->next == state->tasks.size()) {
+          return;
+        }
+        task = &state->tasks[state->next++];
+      }
+      std::exception_ptr error;
+      try {
+        GraphExecutor& executor = task->method.get_executor();
+        if (task->inputs) {
+          executor.getPlanFor(
+              *task->inputs, GraphExecutor::getDefaultNumBailOuts());
+        }
+      } catch (...) {
+        error = std::current_exception();
+      }
+      {
+        std::lock_guard<std::mutex> guard(state->mutex);
+        if (error && !state->error) {
+          state->error = error;
+        }
+        --state->remaining;
+      }
+      state->cv.notify_all();
+    }
+  };
+  const size_t num_helpers = std::min<size_t>(
+      state->tasks.empty() ? 0 : state->tasks.size() - 1,
+      at::get_num_interop_threads());
+  for (size_t i = 0; i < num_helpers; ++i) {
+    at::launch(work);
+  }
+  work();
+
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->cv.wait(lock, [&] { return state->remaining == 0; });
+  if (state->error) {
+    std::rethrow_exception(state->error);
+  }
+}
+
 Module Module::deepcopy() const {
   return Module(_ivalue()->deepcopy());
 }
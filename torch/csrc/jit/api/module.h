@@ -213,13 +213,29 @@ struct TORCH_API Module : public Object {
       const std::string& filename,
       const ExtraFilesMap& extra_files = ExtraFilesMap()) const;
 
+  /// With `flat_bytecode`, the bytecode is saved in a flat format that is
+  /// used in place on load instead of being unpickled, see ExportModule.
   void _save_for_mobile(
       std::ostream& out,
-      const ExtraFilesMap& extra_files = ExtraFilesMap()) const;
+      const ExtraFilesMap& extra_files = ExtraFilesMap(),
+      bool flat_bytecode = false) const;
 
   void _save_for_mobile(
       const std::string& filename,
-      const ExtraFilesMap& extra_files = ExtraFilesMap()) const;
+      const ExtraFilesMap& extra_files = ExtraFilesMap(),
+      bool flat_bytecode = false) const;
+
+  /// Optimizes the methods of the module ahead of their first call, so that
+  /// the first call doesn't pay for it. The methods are optimized concurrently
+  /// on the inter-op thread pool and on the calling thread, and this returns
+  /// once all of them are done.
+  ///
+  /// For every method in `example_inputs` (inputs without `self`), the
+  /// execution plan for those inputs is compiled as if the method was called
+  /// with them, under the current grad mode. The other methods only get the
+  /// input-independent optimizations.
+  void warmup(
+      const std::unordered_map<std::string, Stack>& example_inputs = {}) const;
 
   Module deepcopy() const;
 
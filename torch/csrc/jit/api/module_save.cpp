@@ -15,14 +15,16 @@ void Module::save(const std::string& filename, const ExtraFilesMap& extra_files)
 
 void Module::_save_for_mobile(
     std::ostream& out,
-    const ExtraFilesMap& extra_files) const {
-  ExportModule(*this, out, extra_files, true);
+    const ExtraFilesMap& extra_files,
+    bool flat_bytecode) const {
+  ExportModule(*this, out, extra_files, true, flat_bytecode);
 }
 
 void Module::_save_for_mobile(
     const std::string& filename,
-    const ExtraFilesMap& extra_files) const {
-  ExportModule(*this, filename, extra_files, true);
+    const ExtraFilesMap& extra_files,
+    bool flat_bytecode) const {
+  ExportModule(*this, filename, extra_files, true, flat_bytecode);
 }
 
 } // namespace jit
@@ -2,6 +2,8 @@
 #include <c10/util/Exception.h>
 #include <torch/csrc/jit/codegen/cuda/ir_internal_nodes.h>
 
+#include <set>
+
 namespace torch {
 namespace jit {
 namespace fuser {
@@ -123,6 +125,96 @@ TORCH_CUDA_API Val* andOp(Val* v1, Val* v2) {
   return binaryOp(BinaryOpType::And, v1, v2);
 }
 
+namespace {
+// Will return a new tensor with the domain of tv, where the axes in "axes" are
+// marked as reduction IterDomains.
+TensorView* newForReduction(
+    TensorView* tv,
+    const std::vector<unsigned int>& axes) {
+  std::set<unsigned int> axes_set(axes.begin(), axes.end());
+
+  std::vector<IterDomain*> new_domain;
+  for (decltype(tv->nDims()) i = 0; i < tv->nDims(); i++) {
+    IterDomain* id = tv->axis(i);
+    new_domain.push_back(new IterDomain(
+        id->start(),
+        id->extent(),
+        ParallelType::Serial,
+        axes_set.find(i) != axes_set.end()));
+  }
+
+  TensorDomain* td = new TensorDomain(new_domain);
+  return new TensorView(td, tv->getDataType().value());
+}
+} // namespace
+
+TORCH_CUDA_API TensorView* reductionOp(
+    BinaryOpType reduction_op_type,
+    const std::vector<int>& axes,
+    Val* init,
+    TensorView* v1) {
+  TORCH_CHECK(
+      init->isConstScalar(),
+      "Cannot create a reduction operation where the initial value is not a const scalar.");
+  TORCH_CHECK(
+      init->getDataType() == v1->getDataType(),
+      "Reduction initial value must be of the same data type as the reduced tensor.");
+  TORCH_CHECK(
+      inline_op_str(reduction_op_type).has_value(),
+      "Reductions of ",
+      reduction_op_type,
+      " are not supported.");
+  TORCH_CHECK(
+      v1->getRootDomain() == v1->domain(),
+      "Reducing a tensor once it has been transformed is not permitted at this time. ",
+      "Please set reductions before calling split/merge/reorder/computeAt.");
+  TORCH_CHECK(!axes.empty(), "Reduction requested over no axes.");
+
+  for (decltype(v1->nDims()) i = 0; i < v1->nDims(); i++)
+    TORCH_CHECK(
+        !v1->axis(i)->isReduction(),
+        "Cannot reduce a tensor that is itself the output of a reduction.");
+
+  std::vector<unsigned int> uint_axes;
+  for (int axis : axes) {
+    if (axis < 0)
+      axis += int(v1->nDims());
+
+    TORCH_CHECK(
+        axis >= 0 && (unsigned int)axis < v1->nDims(),
+        "Reduction on invalid axis, recieved: ",
+        axis,
+        " however tensor view only has ",
+        v1->nDims(),
+        " dims.");
+
+    uint_axes.push_back((unsigned int)axis);
+  }
+
+  TensorView* out = newForReduction(v1, uint_axes);
+  Statement* expr = new ReductionOp(reduction_op_type, init, out, v1);
+  return out;
+}
+
+TORCH_CUDA_API TensorView* sum(TensorView* v1, const std::vector<int>& axes) {
+  Val* init;
+  switch (v1->getDataType().value()) {
+    case (DataType::Float):
+      init = new Float(0.0);
+      break;
+    case (DataType::Int):
+      init = new Int(0);
+      break;
+    default:
+      TORCH_CHECK(
+          false,
+          "Could not generate a sum op for tensor with type: ",
+          v1->getDataType().value());
+  }
+
+  return reductionOp(BinaryOpType::Add, axes, init, v1);
+}
+
 } // namespace fuser
 } // namespace jit
 } // namespace torch
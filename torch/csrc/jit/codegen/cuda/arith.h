@@ -41,6 +41,18 @@ TORCH_CUDA_API Val* lt(Val* v1, Val* v2);
 TORCH_CUDA_API Val* ceilDiv(Val* v1, Val* v2);
 TORCH_CUDA_API Val* andOp(Val* v1, Val* v2);
 
+// Reduce tensor v1 over the given axes of its root domain with the binary op
+// type, starting from init. The reduced axes become reduction IterDomains of
+// the returned tensor. Only ops with an inline symbol (i.e. Add, Mul) can be
+// reduced for now.
+TORCH_CUDA_API TensorView* reductionOp(
+    BinaryOpType reduction_op_type,
+    const std::vector<int>& axes,
+    Val* init,
+    TensorView* v1);
+
+TORCH_CUDA_API TensorView* sum(TensorView* v1, const std::vector<int>& axes);
+
 } // namespace fuser
 } // namespace jit
 } // namespace torch
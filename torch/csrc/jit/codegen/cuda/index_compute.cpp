@@ -91,7 +91,7 @@ IndexCompute::IndexCompute(const TensorView* tv, std::vector<Val*> _indices) {
   // Remove indices associated with reduction axes, we had them just for
   // bookkeeping.
   if (exclude_reduction) {
-    for (auto i = root->nDims() - 1; i >= 0; i--)
+    for (int i = root->nDims() - 1; i >= 0; i--)
       if (root->axis(i)->isReduction())
         indices.erase(indices.begin() + i);
   }
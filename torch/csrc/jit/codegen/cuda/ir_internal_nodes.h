@@ -98,6 +98,46 @@ struct TORCH_CUDA_API BinaryOp : public Expr {
   Val* const rhs_;
 };
 
+/*
+ * Reduction operation. Out is first initialized to _init. Then
+ * _reduction_op_type is used to update out as out = reductionOp(out, in).
+ * Output's axes marked as reduction will be reduced to produce an output
+ * tensor. The output tensor's size will be the size of all non-reduction
+ * dimensions.
+ */
+struct TORCH_CUDA_API ReductionOp : public Expr {
+  ~ReductionOp() = default;
+  ReductionOp(BinaryOpType _reduction_op_type, Val* _init, Val* _out, Val* _in);
+
+  ReductionOp(const ReductionOp& other) = delete;
+  ReductionOp& operator=(const ReductionOp& other) = delete;
+
+  ReductionOp(ReductionOp&& other) = delete;
+  ReductionOp& operator=(ReductionOp&& other) = delete;
+
+  Val* out() const noexcept {
+    return out_;
+  }
+  Val* in() const noexcept {
+    return in_;
+  }
+  Val* init() const noexcept {
+    return init_;
+  }
+
+  BinaryOpType getReductionOpType() const noexcept {
+    return reduction_op_type_;
+  }
+
+  bool sameAs(const ReductionOp* const other) const;
+
+ private:
+  const BinaryOpType reduction_op_type_;
+  Val* const init_;
+  Val* const out_;
+  Val* const in_;
+};
+
 /*
  * Simply a representation of an annotated 1D iterable from start to extent.
  * TensorDomains which represent how to iterate over a tensor is made up of
@@ -152,10 +192,6 @@ struct TORCH_CUDA_API IterDomain : public Val {
       TORCH_CHECK(
           !isReduction(),
           "Cannot parallelize reductions across a block dimension.");
-      if (isThreadDim())
-        TORCH_CHECK(
-            !isReduction(),
-            "Thread parallelized reductions not yet supported.");
       TORCH_CHECK(
           t != ParallelType::Vectorize, "Vectorization not yet supported.");
       if (t == ParallelType::Unroll)
@@ -40,11 +40,18 @@ void IRPrinter::printHeader(Fusion* fusion, const std::string& kernel_name_) {
 
   for (Val* val : vals) {
     switch (val->getValType().value()) {
-      case (ValType::TensorView):
-        os << "Tensor<" << val->getDataType().value() << ", "
-           << static_cast<TensorView*>(val)->getRootDomain()->nDims() << "> T"
-           << val->name();
+      case (ValType::TensorView): {
+        // Reduction axes are not part of the tensor passed to the kernel
+        const TensorDomain* root =
+            static_cast<TensorView*>(val)->getRootDomain();
+        decltype(root->nDims()) nDims = 0;
+        for (decltype(root->nDims()) i = 0; i < root->nDims(); i++)
+          if (!root->axis(i)->isReduction())
+            nDims++;
+        os << "Tensor<" << val->getDataType().value() << ", " << nDims
+           << "> T" << val->name();
         break;
+      }
       case (ValType::Scalar):
         os << val->getDataType().value() << " " << val;
         break;
@@ -261,6 +268,60 @@ void IRPrinter::handle(const BinaryOp* const bop) {
     os << ";\n";
 }
 
+void IRPrinter::handle(const ReductionOp* const rop) {
+  // A lowered reduction combines the partial results of the threads that
+  // participated in it, see GPULower::mutate(ReductionOp*).
+  if (rop->out()->getValType().value() == ValType::TensorIndex) {
+    const TensorView* out_tv =
+        static_cast<const TensorIndex*>(rop->out())->view();
+
+    bool tidx = false, tidy = false, tidz = false;
+    for (decltype(out_tv->nDims()) i = 0; i < out_tv->nDims(); i++) {
+      const IterDomain* id = out_tv->axis(i);
+      if (!id->isReduction())
+        continue;
+      tidx = tidx || id->parallel_method() == ParallelType::TIDx;
+      tidy = tidy || id->parallel_method() == ParallelType::TIDy;
+      tidz = tidz || id->parallel_method() == ParallelType::TIDz;
+    }
+
+    indent();
+    // If no reduction axis is bound to threads, every thread holds a complete
+    // result.
+    if (!(tidx || tidy || tidz)) {
+      handle(rop->out());
+      os << " = ";
+      handle(rop->in());
+      os << ";\n";
+      return;
+    }
+
+    auto op_str = inline_op_str(rop->getReductionOpType());
+    TORCH_INTERNAL_ASSERT(
+        op_str.has_value(),
+        "Cannot print a block reduction of ",
+        rop->getReductionOpType(),
+        " .");
+    const DataType dtype = out_tv->getDataType().value();
+
+    os << "blockReduce< " << (tidx ? "true" : "false") << ", "
+       << (tidy ? "true" : "false") << ", " << (tidz ? "true" : "false")
+       << " > ( ";
+    handle(rop->out());
+    os << ", ";
+    handle(rop->in());
+    os << ", [](" << dtype << " a, " << dtype << " b) { return a "
+       << op_str.value() << " b; }, threadIdx, blockDim, shared_mem);\n";
+    return;
+  }
+
+  indent();
+  os << rop->out() << " = reduction( " << rop->in()
+     << ", op = " << rop->getReductionOpType() << ", initial value = ";
+  print_inline(rop->init());
+  os << " );\n";
+}
+
 void IRPrinter::handle(const ForLoop* const fl) {
   if (fl->iter_domain()->isThread()) {
     for (auto& expr : fl->constBody().exprs())
@@ -353,6 +414,17 @@ void IRPrinter::printKernel(
   Fusion* fusion = FusionGuard::getCurFusion();
 
   printHeader(fusion, kernel_name);
+
+  // Scratch space for block reductions, sized for the largest block we launch.
+  for (const Expr* expr : fusion->unordered_exprs()) {
+    if (expr->getExprType().value() == ExprType::ReductionOp) {
+      indent();
+      os << "__shared__ " << expr->output(0)->getDataType().value()
+         << " shared_mem[1024];\n";
+      break;
+    }
+  }
+
   for (auto* expr : exprs) {
     handle(expr);
   }
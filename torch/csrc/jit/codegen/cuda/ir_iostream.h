@@ -19,6 +19,7 @@ struct Expr;
 
 struct UnaryOp;
 struct BinaryOp;
+struct ReductionOp;
 
 struct ForLoop;
 struct IfThenElse;
@@ -103,6 +104,7 @@ struct TORCH_CUDA_API IRPrinter : public OptInConstDispatch {
 
   virtual void handle(const UnaryOp* const);
   virtual void handle(const BinaryOp* const);
+  virtual void handle(const ReductionOp* const);
 
   virtual void handle(const ForLoop* const);
   virtual void handle(const IfThenElse* const);
@@ -97,6 +97,32 @@ bool BinaryOp::sameAs(const BinaryOp* other) const {
   return true;
 }
 
+ReductionOp::ReductionOp(
+    BinaryOpType _reduction_op_type,
+    Val* _init,
+    Val* _out,
+    Val* _in)
+    : Expr(ExprType::ReductionOp),
+      reduction_op_type_(_reduction_op_type),
+      init_(_init),
+      out_(_out),
+      in_(_in) {
+  TORCH_INTERNAL_ASSERT(
+      _init->isConstScalar(),
+      "Reduction initial values must be constant scalars, but received ",
+      _init,
+      " .");
+  addOutput(_out);
+  addInput(_in);
+  this->name_ = FusionGuard::getCurFusion()->registerExpr(this);
+}
+
+bool ReductionOp::sameAs(const ReductionOp* other) const {
+  return (
+      getReductionOpType() == other->getReductionOpType() &&
+      init()->sameAs(other->init()) && in()->sameAs(other->in()));
+}
+
 IterDomain::IterDomain(
     Val* _start,
     Val* _extent,
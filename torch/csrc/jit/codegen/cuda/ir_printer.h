@@ -50,6 +50,11 @@ class TORCH_CUDA_API IRTransformPrinter : public IRPrinter {
       IRPrinter::handle(bop);
   }
 
+  void handle(const ReductionOp* const rop) override {
+    if (print_inline_)
+      IRPrinter::handle(rop);
+  }
+
   void handle(Fusion* f) override {
     IRPrinter::handle(f);
   }
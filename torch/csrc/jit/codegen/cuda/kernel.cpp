@@ -133,10 +133,23 @@ struct KernelArgumentHolder {
   }
 };
 
+// Inputs to a kernel are broadcast to its iteration space. That's the shape of
+// the output, unless the output is a reduction of larger inputs.
+at::IntArrayRef iterationSizes(
+    const std::vector<at::IntArrayRef>& input_sizes,
+    const at::IntArrayRef output_sizes) {
+  at::IntArrayRef sizes = output_sizes;
+  for (const auto& input_size : input_sizes)
+    if (input_size.size() > sizes.size())
+      sizes = input_size;
+  return sizes;
+}
+
 std::pair<std::string, std::string> codeGeneration(Fusion& fusion) {
   std::stringstream str_stream;
   str_stream << "namespace " << CG_NAMESPACE << " {\n"
-             << code_template_tensor_struct << "\n";
+             << code_template_tensor_struct << "\n"
+             << code_template_block_reduction << "\n";
   std::stringstream cdg;
   GPULower gpulw(&fusion);
   gpulw.printKernel(str_stream, KERNEL_NAME);
@@ -242,13 +255,28 @@ void runKernel(
   at::cuda::set_device(entry->device_);
   auto stream = at::cuda::getCurrentCUDAStream();
 
-  // TODO: Proper API to establish reasonable launch configurations;
-  // Naive launch config;
-  size_t numel = outputs[0].numel();
+  dim3 grid_dim;
+  dim3 block_dim;
+  if (entry->reduction_kernel_) {
+    grid_dim = entry->grid_;
+    block_dim = entry->block_;
+  } else {
+    // TODO: Proper API to establish reasonable launch configurations;
+    // Naive launch config;
+    size_t numel = outputs[0].numel();
+
+    // TODO: we can't randomly clap down this until we got striding.
+    // const auto nBlocks = std::min(entry->max_blocks_, ceilDiv(numel, 128));
+    grid_dim = dim3(ceilDiv(numel, 128));
+    block_dim = dim3(128);
+  }
 
-  // TODO: we can't randomly clap down this until we got striding.
-  // const auto nBlocks = std::min(entry->max_blocks_, ceilDiv(numel, 128));
-  const auto nBlocks = ceilDiv(numel, 128);
+  std::vector<at::IntArrayRef> input_sizes;
+  for (auto& input : inputs)
+    if (input.isTensor())
+      input_sizes.push_back(input.toTensor().sizes());
+  const auto broadcast_sizes =
+      iterationSizes(input_sizes, outputs[0].sizes());
 
   KernelArgumentHolder kernel_args;
 
@@ -257,7 +285,7 @@ void runKernel(
   // from I/O expected by the generated CUDA kernel.
   for (auto& input : inputs) {
     if (input.isTensor()) {
-      kernel_args.push(input.toTensor(), outputs[0].sizes());
+      kernel_args.push(input.toTensor(), broadcast_sizes);
     } else {
       kernel_args.push(input);
     }
@@ -270,12 +298,12 @@ void runKernel(
   // launch kernel;
   AT_CUDA_DRIVER_CHECK(nvrtc().cuLaunchKernel(
       entry->function_,
-      nBlocks,
-      1,
-      1,
-      128,
-      1,
-      1,
+      grid_dim.x,
+      grid_dim.y,
+      grid_dim.z,
+      block_dim.x,
+      block_dim.y,
+      block_dim.z,
       0,
       stream,
       kernel_args.getBuffer(),
@@ -295,13 +323,19 @@ void runTestKernel(
   at::cuda::set_device(entry.device_);
   auto stream = at::cuda::getCurrentCUDAStream();
 
+  std::vector<at::IntArrayRef> input_sizes;
+  for (auto& input : inputs)
+    input_sizes.push_back(input.sizes());
+  const auto broadcast_sizes =
+      iterationSizes(input_sizes, outputs[0].sizes());
+
   KernelArgumentHolder kernel_args;
 
   // Naive I/O setup, I'm ignoring all the potential transformation (i.e. I/O
   // allocated here from the subgraph could be, and very likely are, different
   // from I/O expected by the generated CUDA kernel.
   for (auto& input : inputs) {
-    kernel_args.push(input, outputs[0].sizes());
+    kernel_args.push(input, broadcast_sizes);
   }
 
   for (auto& output : outputs) {
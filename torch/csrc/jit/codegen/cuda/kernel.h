@@ -29,6 +29,8 @@ namespace cuda {
 struct KernelArgsReq {
   // We are checking accumulated output shape for now, this is a restricting
   // aproach, we should check applicability on input tensor shapes instead.
+  // Reductions are checked on the shape of the tensors they reduce, as that is
+  // what their schedule and launch configuration are derived from.
   bool matchKernelSize(const c10::IntArrayRef inputs);
   std::vector<size_t> low_;
   std::vector<size_t> hi_;
@@ -51,10 +53,15 @@ class CudaKernel {
   CUfunction function_;
   int max_blocks_;
 
+  // Reduction kernels are launched with the block and grid dimensions picked
+  // by their schedule (see parser.cpp), instead of the naive configuration
+  // runKernel() derives from the output size.
+  bool reduction_kernel_ = false;
+
   // WARNING:
-  // Block and Grid dimension setting is here for testing purposes only
-  // These are not here for general use and only for use with
-  // the runTestKernel() function.
+  // Block and Grid dimension setting is here for testing purposes and for the
+  // reduction scheduler only. These are not here for general use, elsewhere they
+  // are only for use with the runTestKernel() function.
   void block(unsigned int x = 1, unsigned int y = 1, unsigned int z = 1) {
     block_ = dim3(x, y, z);
   }
@@ -22,6 +22,63 @@ struct Tensor {
 };
 )";
 
+// Block reduction, combines inp_val of the threads along the dimensions flagged
+// by [X,Y,Z]_REDUCE. The result is written to out by the first thread of each
+// reduction. shared_mem must hold one element per thread of the block.
+static auto code_template_block_reduction = R"(
+template<bool X_REDUCE, bool Y_REDUCE, bool Z_REDUCE, typename T, typename Func>
+__device__ void blockReduce(
+    T& out,
+    const T inp_val,
+    Func reduction_op,
+    const uint3& thread_idx,
+    const dim3& block_dim,
+    T* shared_mem) {
+  unsigned int reduction_size =
+      (X_REDUCE ? block_dim.x : 1) *
+      (Y_REDUCE ? block_dim.y : 1) *
+      (Z_REDUCE ? block_dim.z : 1);
+
+  // Linearize the reduced and the non-reduced thread dimensions separately so
+  // each reduction is contiguous in shared memory
+  unsigned int reduction_tid = 0;
+  unsigned int group_id = 0;
+  if (Z_REDUCE)
+    reduction_tid = thread_idx.z;
+  else
+    group_id = thread_idx.z;
+  if (Y_REDUCE)
+    reduction_tid = reduction_tid * block_dim.y + thread_idx.y;
+  else
+    group_id = group_id * block_dim.y + thread_idx.y;
+  if (X_REDUCE)
+    reduction_tid = reduction_tid * block_dim.x + thread_idx.x;
+  else
+    group_id = group_id * block_dim.x + thread_idx.x;
+
+  unsigned int smem_offset = group_id * reduction_size + reduction_tid;
+  shared_mem[smem_offset] = inp_val;
+  __syncthreads();
+
+  // Fold the values beyond the largest power of 2 into the front
+  unsigned int np2 = 1 << (31 - __clz((int)reduction_size));
+  if (reduction_tid + np2 < reduction_size)
+    shared_mem[smem_offset] = reduction_op(
+        shared_mem[smem_offset], shared_mem[smem_offset + np2]);
+  __syncthreads();
+
+  for (unsigned int factor = np2 / 2; factor > 0; factor >>= 1) {
+    if (reduction_tid < factor)
+      shared_mem[smem_offset] = reduction_op(
+          shared_mem[smem_offset], shared_mem[smem_offset + factor]);
+    __syncthreads();
+  }
+
+  if (reduction_tid == 0)
+    out = shared_mem[smem_offset];
+}
+)";
+
 } // namespace cuda
 } // namespace fuser
 } // namespace jit
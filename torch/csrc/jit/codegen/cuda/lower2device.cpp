@@ -110,16 +110,32 @@ TensorIndex* GPULower::getProducerIndex(
   return getLocalProducerIndex(producer, consumer);
 }
 
+namespace {
+// Number of axes not marked as reduction in td
+std::vector<IterDomain*>::size_type nNonReductionDims(
+    const TensorDomain* const td) {
+  std::vector<IterDomain*>::size_type n = 0;
+  for (decltype(td->nDims()) i{0}; i < td->nDims(); i++)
+    if (!td->axis(i)->isReduction())
+      n++;
+  return n;
+}
+} // namespace
+
 TensorIndex* GPULower::getGlobalConsumerIndex(TensorView* consumer) {
+  // The output of a reduction is written outside of the loops over its
+  // reduction axes
+  const auto n_loops = scope_utils::getLoopIndices(active_scope).size();
   TORCH_INTERNAL_ASSERT(
-      scope_utils::getLoopIndices(active_scope).size() == consumer->nDims(),
+      n_loops == consumer->nDims() ||
+          n_loops == nNonReductionDims(consumer->domain()),
       "Dimensionality error in code generator while computing indexing.");
 
   const std::vector<Val*> computed_inds = IndexCompute::computeIndices(
       consumer, scope_utils::getLoopIndices(active_scope));
 
   TORCH_INTERNAL_ASSERT(
-      computed_inds.size() == consumer->getRootDomain()->nDims(),
+      computed_inds.size() == nNonReductionDims(consumer->getRootDomain()),
       "Dimensionality error in code generator while computing indexing.");
 
   std::vector<Val*> strided_inds;
@@ -296,6 +312,45 @@ Statement* GPULower::mutate(BinaryOp* bop) {
   return new_op;
 }
 
+Statement* GPULower::mutate(ReductionOp* rop) {
+  TORCH_INTERNAL_ASSERT(
+      rop->out()->getValType().value() == ValType::TensorIndex ||
+          ir_utils::isTVOp(rop),
+      "Unexpected reduction found during lowering: ",
+      rop);
+
+  // Combination of the partial results, see LoopNestGenerator::finishReduction
+  if (!ir_utils::isTV(rop->out())) {
+    TensorView* out_tv = const_cast<TensorView*>(
+        static_cast<TensorIndex*>(rop->out())->view());
+    return new ReductionOp(
+        rop->getReductionOpType(),
+        rop->init(),
+        getConsumerIndex(out_tv),
+        rop->in());
+  }
+
+  // Accumulate into the register buffer of this thread
+  TensorView* out_tv = ir_utils::asTV(rop->out());
+  TORCH_INTERNAL_ASSERT(
+      reduction_buffers.find(out_tv) != reduction_buffers.end(),
+      "Could not find the buffer of reduction ",
+      rop);
+  TensorView* buffer = reduction_buffers[out_tv];
+
+  Val* in = rop->in();
+  if (ir_utils::isTV(in))
+    in = getProducerIndex(ir_utils::asTV(in), out_tv);
+
+  Expr* new_op = new BinaryOp(
+      rop->getReductionOpType(),
+      new TensorIndex(buffer, {new Int(0)}),
+      new TensorIndex(buffer, {new Int(0)}),
+      in);
+
+  return new_op;
+}
+
 // TensorViews are all based on symbolic sizes. When we first initialize them we
 // don't know if they're inputs or outputs which would mean that they have
 // runtime shapes. Intermediate tensors (those not going to global memory) do
@@ -341,10 +396,14 @@ void GPULower::replaceSizes() {
     // Replace the domain with one based on Ti.size[j]
     std::vector<IterDomain*> new_domain_iters;
     TensorDomain* root_td = tv->getRootDomain();
+    // Reduction axes are not part of the runtime tensor
+    decltype(root_td->nDims()) dim{0};
     for (decltype(root_td->nDims()) i{0}; i < root_td->nDims(); i++) {
+      if (root_td->axis(i)->isReduction())
+        continue;
       Val* orig_size = root_td->axis(i)->extent();
       std::stringstream ss;
-      ss << "T" << tv->name() << ".size[" << i << "]";
+      ss << "T" << tv->name() << ".size[" << dim++ << "]";
       Val* new_size =
           new NamedScalar(ss.str(), orig_size->getDataType().value());
       if (!orig_size->sameAs(new_size) ||
@@ -373,7 +432,7 @@ void GPULower::replaceSizes() {
     }
 
     TensorDomain* old_domain = tv->domain();
-    TensorDomain* new_domain = TransformReplay::fullReplay(
+    TensorDomain* new_domain = TransformReplay::fullSelfReplay(
         old_domain, new TensorDomain(new_domain_iters));
 
     TORCH_INTERNAL_ASSERT(
@@ -400,10 +459,10 @@ void validate(Fusion* fusion) {
       for (decltype(tv->nDims()) i{0}; i < tv->nDims(); i++) {
         IterDomain* id = tv->getComputeAtAxis(i);
 
-        if (id->isThread())
+        if (id->isBlockDim())
           TORCH_CHECK(
               !id->isReduction(),
-              "Parallelization on reduction axes not support at the moment found on, ",
+              "Parallelization of reduction axes across blocks is not supported at the moment, found on, ",
               tv,
               ".");
       }
@@ -425,7 +484,8 @@ std::vector<Expr*> GPULower::getLoweredExprs() {
 
   replaceSizes();
 
-  auto loop_nests = LoopNestGenerator::getLoopNest(fusion_);
+  auto loop_nests =
+      LoopNestGenerator::getLoopNest(fusion_, reduction_buffers);
   auto unrolled_loops = UnrollPass::runPass(fusion_, loop_nests);
   // Run through loop nests and further lower the expressions
   for (auto* expr : unrolled_loops) {
@@ -27,6 +27,9 @@ struct TORCH_CUDA_API GPULower : public OptOutMutator {
   const TensorView* active_view;
   unsigned int active_view_axis;
 
+  // Reduction output -> register buffer accumulating it, see LoopNestGenerator
+  std::unordered_map<const TensorView*, TensorView*> reduction_buffers;
+
   // Clear out the last recorded computeAtView
   void clearActiveView();
   // Set active views from computeAtView
@@ -71,6 +74,7 @@ struct TORCH_CUDA_API GPULower : public OptOutMutator {
   // Remake operations with TensorIndex
   Statement* mutate(UnaryOp*) final;
   Statement* mutate(BinaryOp*) final;
+  Statement* mutate(ReductionOp*) final;
 
   // TensorViews are all based on symbolic sizes. When we first initialize them
   // we don't know if they're inputs or outputs which would mean that they have
@@ -153,7 +153,9 @@ void UnrollPass::handle(ForLoop* fl) {
 
   } else { //  if(!within_unroll)
 
-    for (auto expr : fl->body().exprs()) {
+    // Copy the body, as we replace its exprs while going through it
+    const std::vector<Expr*> body_exprs = fl->body().exprs();
+    for (auto expr : body_exprs) {
       if (!ir_utils::isTVOp(expr))
         continue;
 
@@ -272,7 +274,54 @@ void LoopNestGenerator::setActiveView(const TensorView* const tv) {
   active_view = tv->getComputeAtView();
 }
 
+void LoopNestGenerator::initReduction(ReductionOp* rop) {
+  TensorView* out = ir_utils::asTV(rop->out());
+  TensorView* buffer =
+      new TensorView(new TensorDomain({}), out->getDataType().value());
+  pushBack(new Allocate(buffer, new Int(1)));
+  pushBack(new UnaryOp(
+      UnaryOpType::Set, new TensorIndex(buffer, {new Int(0)}), rop->init()));
+  reduction_buffers[out] = buffer;
+}
+
+void LoopNestGenerator::finishReduction(ReductionOp* rop) {
+  TensorView* out = ir_utils::asTV(rop->out());
+  TensorView* buffer = reduction_buffers.at(out);
+
+  decltype(out->nDims()) red_pos = 0;
+  while (!out->axis(red_pos)->isReduction())
+    red_pos++;
+
+  // The output is indexed by the loops outside of the reduction, GPULower
+  // fills in its indices.
+  std::vector<Val*> indices;
+  for (decltype(red_pos) i{0}; i < red_pos; i++)
+    indices.push_back(for_loops[i]->index());
+
+  Expr* scope = red_pos == 0 ? nullptr : for_loops[red_pos - 1];
+
+  Expr* write_out = new ReductionOp(
+      rop->getReductionOpType(),
+      rop->init(),
+      new TensorIndex(out, {}),
+      new TensorIndex(buffer, {new Int(0)}));
+
+  Int* pred = getPredicate(out, indices);
+  if (!pred->isOneInt())
+    write_out = new IfThenElse(pred, {write_out}, {}, scope);
+
+  while (for_loops.size() > red_pos)
+    for_loops.pop_back();
+  pushBack(write_out);
+}
+
 void LoopNestGenerator::openFor(IterDomain* id) {
+  auto it = reduction_axes.find(id);
+  if (it != reduction_axes.end() &&
+      reduction_buffers.find(ir_utils::asTV(it->second->out())) ==
+          reduction_buffers.end())
+    initReduction(it->second);
+
   if (for_loops.size() > 0) {
     ForLoop* new_scope = scope_utils::openFor(for_loops.back(), id);
     for_loops.push_back(new_scope);
@@ -345,9 +394,9 @@ void LoopNestGenerator::updateLoopNest(TensorView* tv) {
       !FusionGuard::getCurFusion()->hasOutput(tv)) {
     pushAlloc(tv);
   }
-  // TODO:
-  //  5) If this is a reduction, initialize the output (open for loops to inner
-  //  most, predicate, initialize, close predicate, close to computeAt)
+  //  5) If this is a reduction, initialize the output. This is done in openFor,
+  //  as loops over the reduction axes may be opened by the producers of the
+  //  reduction.
 
   //  6) Open to inner most loop
   for (decltype(tv->nDims()) i = for_loops.size(); i < tv->nDims(); i++)
@@ -363,6 +412,9 @@ void LoopNestGenerator::handle(Expr* expr) {
   updateLoopNest(out);
 
   pushBack(expr);
+
+  if (expr->getExprType().value() == ExprType::ReductionOp)
+    finishReduction(static_cast<ReductionOp*>(expr));
 }
 
 // Generate the loop nest structure and place it in lowered_exprs
@@ -375,6 +427,34 @@ void LoopNestGenerator::generate() {
   active_view_axis = 0;
 
   std::vector<Expr*> exprs = fusion_->exprs(true);
+
+  for (auto* expr : exprs) {
+    if (expr->getExprType().value() != ExprType::ReductionOp)
+      continue;
+    TensorView* out = ir_utils::asTV(expr->output(0));
+
+    TORCH_CHECK(
+        fusion_->hasOutput(out) && !out->hasComputeAt(),
+        "Reductions are only supported as outputs of a fusion, but found ",
+        out,
+        ".");
+
+    decltype(out->nDims()) red_pos = 0;
+    while (red_pos < out->nDims() && !out->axis(red_pos)->isReduction())
+      red_pos++;
+    TORCH_INTERNAL_ASSERT(
+        red_pos < out->nDims(), "Reduction without reduction axes: ", out);
+
+    for (auto i = red_pos; i < out->nDims(); i++)
+      TORCH_CHECK(
+          out->axis(i)->isReduction(),
+          "Reduction axes must be inner most to be lowered, but found ",
+          out,
+          ".");
+
+    reduction_axes[out->axis(red_pos)] = static_cast<ReductionOp*>(expr);
+  }
+
   for (auto* expr : exprs)
     handle(expr);
 }
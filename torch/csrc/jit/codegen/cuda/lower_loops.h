@@ -53,9 +53,23 @@ struct TORCH_CUDA_API LoopNestGenerator : public OptOutDispatch {
   // Keep all for loops conveniently to make unrolling easier
   std::vector<ForLoop*> for_loops;
 
+  // Reductions keyed by the outer most reduction axis of their output. Each
+  // thread accumulates its partial result in a register buffer that is
+  // initialized right before the loop of that axis is opened.
+  std::unordered_map<const IterDomain*, ReductionOp*> reduction_axes;
+  // Reduction output -> register buffer for its partial results
+  std::unordered_map<const TensorView*, TensorView*> reduction_buffers;
+
   // Get Register allocation statement for tensorview
   void pushAlloc(TensorView*);
 
+  // Allocate and initialize the buffer of a reduction
+  void initReduction(ReductionOp*);
+
+  // Combine the partial results of a reduction once its loops are done, and
+  // close them
+  void finishReduction(ReductionOp*);
+
   // Clear out the last recorded computeAtView
   void clearActiveView();
   // Set active views from computeAtView
@@ -80,10 +94,15 @@ struct TORCH_CUDA_API LoopNestGenerator : public OptOutDispatch {
   LoopNestGenerator(Fusion* _fusion) : fusion_(_fusion) {}
 
  public:
-  static std::vector<Expr*> getLoopNest(Fusion* fusion) {
+  // reduction_buffers maps the output of each reduction to the register buffer
+  // that accumulates it.
+  static std::vector<Expr*> getLoopNest(
+      Fusion* fusion,
+      std::unordered_map<const TensorView*, TensorView*>& reduction_buffers) {
     FusionGuard fg(fusion);
     LoopNestGenerator lng(fusion);
     lng.generate();
+    reduction_buffers = lng.reduction_buffers;
     return lng.lowered_exprs;
   }
 };
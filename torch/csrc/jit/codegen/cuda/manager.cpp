@@ -79,16 +79,22 @@ class CudaFusionManager {
     TORCH_CHECK(
         kernel_cache_.count(kernel_id) != 0, "kernel id not recognized");
 
+    // Reductions are cached on the shape of the tensors they reduce, which
+    // have a higher rank than the output.
+    at::IntArrayRef sizes = outputs[0].sizes();
+    for (auto& input : inputs)
+      if (input.isTensor() && (size_t)input.toTensor().dim() > sizes.size())
+        sizes = input.toTensor().sizes();
+
     // TODO: temporary hack
-    auto cuda_kernel =
-        kernel_cache_[kernel_id].getKernelPtr(outputs[0].sizes());
+    auto cuda_kernel = kernel_cache_[kernel_id].getKernelPtr(sizes);
     if (cuda_kernel) {
       // TODO: update launch config for specific sizes;
       //       maybe we should store it in CudaKernel and compute it later
       runKernel(*cuda_kernel, inputs, outputs);
     } else {
       // major HACK!
-      auto kernel_arg_req = expandSizeSupport(outputs[0].sizes());
+      auto kernel_arg_req = expandSizeSupport(sizes);
       cuda_kernel =
           kernel_cache_[kernel_id].allocateKernelInCache(kernel_arg_req);
 
@@ -98,8 +104,8 @@ class CudaFusionManager {
       //       transform to computation
       // we should propagate more information back:
       //   1. device;
-      //   2. launch config;
-      parseJitIR(graph, fusion);
+      //   2. launch config; (done for reductions)
+      parseJitIR(graph, fusion, cuda_kernel.value());
       cuda_kernel.value()->device_ = 0;
 
       // NVRTC compile kernel
@@ -3,10 +3,12 @@
 #include <torch/csrc/jit/codegen/cuda/arith.h>
 #include <torch/csrc/jit/codegen/cuda/ir_all_nodes.h>
 #include <torch/csrc/jit/codegen/cuda/ir_iostream.h>
+#include <torch/csrc/jit/codegen/cuda/kernel.h>
 
 #include <torch/csrc/jit/frontend/function_schema_parser.h>
 #include <torch/csrc/jit/ir/constants.h>
 
+#include <algorithm>
 #include <unordered_map>
 
 namespace torch {
@@ -31,17 +33,21 @@ class IrParser {
  private:
   static const int nthreads = 128;
   static const int unroll_factor = 4;
+  // Bounds on the threads cooperating on a reduction within a block
+  static const int min_reduction_threads = 32;
+  static const int max_reduction_threads = 512;
 
  public:
-  IrParser(std::shared_ptr<Graph> graph, Fusion& fusion)
-      : graph_(std::move(graph)), fusion_(&fusion) {
+  IrParser(std::shared_ptr<Graph> graph, Fusion& fusion, CudaKernel* entry)
+      : graph_(std::move(graph)), fusion_(&fusion), entry_(entry) {
     if (init_registry_) {
       registerJitOperator();
       init_registry_ = false;
     }
   }
 
-  // Fuses pointwise ops with loop unrolling (factor = 4).
+  // Fuses pointwise ops with loop unrolling (factor = 4), or pointwise ops
+  // into the reduction consuming them.
   void parse() {
     FusionGuard fg(fusion_);
     auto block = graph_->block();
@@ -50,8 +56,15 @@ class IrParser {
     // convert/expand all inputs tensors to comply to the broadcasted size.
     // This supports very limited case, which we try to accomodate in graph
     // partition, that we only merge nodes with identical output shapes.
-    int broadcast_dim =
-        block->outputs()[0]->type()->cast<TensorType>()->dim().value();
+    // The output of a reduction has a lower rank than its inputs, so we expand
+    // to the highest rank found.
+    int broadcast_dim = 0;
+    for (auto val : block->outputs())
+      broadcast_dim = std::max(
+          broadcast_dim, (int)val->type()->cast<TensorType>()->dim().value());
+    for (auto val : block->inputs())
+      if (auto tensor_type = val->type()->cast<TensorType>())
+        broadcast_dim = std::max(broadcast_dim, (int)tensor_type->dim().value());
 
     // register all inputs;
     // shape propagation during parsing is effctively done in parsing rules, as
@@ -62,8 +75,33 @@ class IrParser {
     }
 
     // compose nodes in topo order;
+    const JitOp* reduction_node = nullptr;
     for (const JitOp* node : block->nodes()) {
       processJitNode(node);
+      if (isReductionNode(node)) {
+        TORCH_CHECK(
+            reduction_node == nullptr,
+            "CudaFusionGroup Parser only handles a single reduction.");
+        reduction_node = node;
+      }
+    }
+
+    if (reduction_node != nullptr) {
+      TORCH_CHECK(
+          block->outputs().size() == 1 &&
+              block->outputs()[0] == reduction_node->output(),
+          "CudaFusionGroup Parser only handles reductions as the single output.");
+      TensorView* out =
+          static_cast<TensorView*>(value_maps_[reduction_node->output()->unique()]);
+      fusion_->addOutput(out);
+      scheduleReduction(
+          out,
+          *reduction_node->input(0)
+               ->type()
+               ->cast<TensorType>()
+               ->sizes()
+               .concrete_sizes());
+      return;
     }
 
     // mark output;
@@ -110,6 +148,84 @@ class IrParser {
     }
   }
 
+  // Schedules a reduction over the tensor of the given sizes. Reduction axes are
+  // moved inner most and merged, as are the iteration axes:
+  //   - If the inner most axis is reduced, the threads of a block cooperate on
+  //     the reduction of an output element, reading contiguous memory;
+  //   - Otherwise each thread reduces an output element serially, consecutive
+  //     threads reading consecutive elements.
+  // Producers of the reduction are computed inline.
+  void scheduleReduction(TensorView* out, const std::vector<int64_t>& sizes) {
+    TORCH_INTERNAL_ASSERT(
+        sizes.size() == out->nDims(),
+        "Reduced tensor does not match the reduction domain.");
+
+    const int n_dims = out->nDims();
+    const bool inner_reduction = out->axis(n_dims - 1)->isReduction();
+
+    std::unordered_map<int, int> axis2pos;
+    int n_iter = 0;
+    int64_t iter_size = 1;
+    for (int i = 0; i < n_dims; i++) {
+      if (!out->axis(i)->isReduction()) {
+        axis2pos[i] = n_iter++;
+        iter_size *= sizes[i];
+      }
+    }
+    int n_red = 0;
+    int64_t red_size = 1;
+    for (int i = 0; i < n_dims; i++) {
+      if (out->axis(i)->isReduction()) {
+        axis2pos[i] = n_iter + n_red++;
+        red_size *= sizes[i];
+      }
+    }
+
+    bool needs_reorder = false;
+    for (auto entry : axis2pos)
+      needs_reorder = needs_reorder || entry.first != entry.second;
+    if (needs_reorder)
+      out->reorder(axis2pos);
+
+    // Merge iteration axes, then reduction axes
+    for (int i = 1; i < n_iter; i++)
+      out->merge(0);
+    const int red_axis = n_iter > 0 ? 1 : 0;
+    for (int i = 1; i < n_red; i++)
+      out->merge(red_axis);
+
+    unsigned int grid = 1;
+    unsigned int threads;
+    if (inner_reduction) {
+      threads = min_reduction_threads;
+      while (threads < red_size && threads < max_reduction_threads)
+        threads *= 2;
+
+      out->split(red_axis, threads);
+      if (n_iter > 0) {
+        out->axis(0)->parallelize(ParallelType::BIDx);
+        grid = iter_size;
+      }
+      out->axis(-1)->parallelize(ParallelType::TIDx);
+    } else {
+      threads = nthreads;
+      out->split(0, threads);
+      out->axis(0)->parallelize(ParallelType::BIDx);
+      out->axis(1)->parallelize(ParallelType::TIDx);
+      grid = (iter_size + threads - 1) / threads;
+    }
+
+    for (TensorView* inp : fusion_->inputsOf(out)) {
+      inp->computeAt(out, -1);
+    }
+
+    if (entry_ != nullptr) {
+      entry_->reduction_kernel_ = true;
+      entry_->grid(grid);
+      entry_->block(threads);
+    }
+  }
+
   static bool canParseNode(const Node* const node) {
     if (init_registry_) {
       // TODO: mutex this guy;
@@ -124,12 +240,16 @@ class IrParser {
     }
     for (auto& pair_op_func : iter->second) {
       if (node->matches(pair_op_func.first->schema())) {
-        return true;
+        return !isReductionNode(node) || canParseReduction(node);
       }
     }
     return false;
   }
 
+  static bool isReductionNode(const Node* const node) {
+    return node->kind() == aten::sum;
+  }
+
   static void registerParseRule(
       std::shared_ptr<Operator>& op,
       ParseFuncPtr fn) {
@@ -166,6 +286,33 @@ class IrParser {
     value_maps.emplace(node->output()->unique(), out);
   }
 
+  // Reductions are parsed with constant axes, without keepdim or dtype.
+  static bool canParseReduction(const Node* const node) {
+    auto dims = constant_as<c10::List<int64_t>>(node->input(1));
+    auto keepdim = constant_as<bool>(node->input(2));
+    return dims.has_value() && !dims->empty() && keepdim.has_value() &&
+        !keepdim.value() && node->input(3)->type()->isSubtypeOf(NoneType::get());
+  }
+
+  static void parseReduction(
+      const Node* const node,
+      std::unordered_map<size_t, CgValue>& value_maps) {
+    auto self = value_maps[node->input(0)->unique()];
+    TORCH_INTERNAL_ASSERT(
+        self->getValType().value() == ValType::TensorView,
+        "CudaFusionGroup Parser only handles reductions of tensors.");
+    auto dims = constant_as<c10::List<int64_t>>(node->input(1));
+    TORCH_INTERNAL_ASSERT(
+        dims.has_value(), "CudaFusionGroup Parser requires constant dims.");
+
+    std::vector<int> axes;
+    for (int64_t dim : dims->vec())
+      axes.push_back((int)dim);
+
+    auto out = sum(static_cast<TensorView*>(self), axes);
+    value_maps.emplace(node->output()->unique(), out);
+  }
+
   static void registerJitOperator() {
     // Register parse-function for each JIT operator;
     // This is a one-time look up, our hash registry indexes on the pointer in
@@ -190,6 +337,10 @@ class IrParser {
       auto ptr_op = getOperatorForLiteral(signature);
       registerParseRule(ptr_op, &parseBinaryOp);
     }
+
+    auto ptr_op = getOperatorForLiteral(
+        "aten::sum(Tensor self, int[] dim, bool keepdim, *, int? dtype) -> Tensor");
+    registerParseRule(ptr_op, &parseReduction);
   }
 
   void processJitNode(const JitOp* node) {
@@ -265,6 +416,7 @@ class IrParser {
 
   std::shared_ptr<Graph> graph_;
   Fusion* fusion_;
+  CudaKernel* entry_;
 
   // maps from JitValue::unique() to fusion Val;
   std::unordered_map<size_t, CgValue> value_maps_;
@@ -288,8 +440,15 @@ bool isNodeParsible(const Node* const node) {
   return IrParser::canParseNode(node);
 }
 
-void parseJitIR(std::shared_ptr<Graph>& graph, Fusion& fusion) {
-  IrParser parser(graph, fusion);
+bool isReductionNode(const Node* const node) {
+  return IrParser::isReductionNode(node);
+}
+
+void parseJitIR(
+    std::shared_ptr<Graph>& graph,
+    Fusion& fusion,
+    CudaKernel* entry) {
+  IrParser parser(graph, fusion, entry);
   parser.parse();
 }
 
@@ -25,11 +25,21 @@ namespace jit {
 namespace fuser {
 namespace cuda {
 
+class CudaKernel;
+
 // returns whether or not a parsing function exists for the given node type.
 TORCH_CUDA_API bool isNodeParsible(const Node* const node);
 
+// returns whether or not the node is parsed as a reduction.
+TORCH_CUDA_API bool isReductionNode(const Node* const node);
+
 // lowers PyTorch jit graph to `Fusion`.
-TORCH_CUDA_API void parseJitIR(std::shared_ptr<Graph>& graph, Fusion& fusion);
+// The launch configuration picked when scheduling a reduction is recorded in
+// `entry`, if given.
+TORCH_CUDA_API void parseJitIR(
+    std::shared_ptr<Graph>& graph,
+    Fusion& fusion,
+    CudaKernel* entry = nullptr);
 
 } // namespace cuda
 } // namespace fuser
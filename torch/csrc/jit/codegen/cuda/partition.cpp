@@ -62,6 +62,9 @@ static bool compatible_broadcast_shape(
   if (e.isComplete() && a.isComplete()) {
     auto e_size = e.concrete_sizes().value();
     auto a_size = a.concrete_sizes().value();
+    if (e_size.size() != a_size.size()) {
+      return false;
+    }
     for (size_t i = 0; i < e_size.size(); i++) {
       if (e_size[i] != a_size[i]) {
         return false;
@@ -72,6 +75,19 @@ static bool compatible_broadcast_shape(
   return false;
 }
 
+// Check if node is, or is a fusion group containing, a reduction.
+static bool hasReduction(const Node* const node) {
+  if (node->kind() == prim::CudaFusionGroup) {
+    for (auto n : node->g(attr::Subgraph)->nodes()) {
+      if (isReductionNode(n)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  return isReductionNode(node);
+}
+
 } // namespace
 
 bool isFusableCudaFusionGroup(const Node* const node) {
@@ -85,6 +101,22 @@ bool isFusableCudaFusionGroup(
     const Node* const fusion,
     const Node* const node) {
   if (isFusableNode(node)) {
+    // Codegen only handles a reduction as the single output of a fusion, so we
+    // neither fuse a reduction into its consumers, nor fuse producers that are
+    // needed outside of the fusion into a reduction.
+    if (hasReduction(node)) {
+      return false;
+    }
+    if (hasReduction(fusion)) {
+      for (auto output : node->outputs()) {
+        for (auto use : output->uses()) {
+          if (use.user != fusion) {
+            return false;
+          }
+        }
+      }
+    }
+
     auto device = getDevice(fusion);
 
     auto tensor_type = fusion->outputs()[0]->type()->cast<TensorType>();
@@ -23,11 +23,19 @@ std::vector<Int*> PredicateCompute::computePredicates(const TensorIndex* ti) {
   const TensorView* tv = ti->view();
 
   TensorDomain* root = tv->getRootDomain();
-  TORCH_CHECK(root->nDims() == ti->nDims());
+
+  // Indexing a tensor outside of its reduction loops (i.e. writing out the
+  // result of a reduction) doesn't produce indices for its reduction axes.
+  std::vector<IterDomain*> root_axes;
+  for (decltype(root->nDims()) i{0}; i < root->nDims(); i++)
+    if (root->nDims() == ti->nDims() || !root->axis(i)->isReduction())
+      root_axes.push_back(root->axis(i));
+
+  TORCH_CHECK(root_axes.size() == ti->nDims());
   for (decltype(ti->nDims()) i{0}; i < ti->nDims(); i++)
 
     if (FusionGuard::getCurFusion()->origin(ti->index(i)) != nullptr) {
-      Val* pred = lt(ti->index(i), root->axis(i)->extent());
+      Val* pred = lt(ti->index(i), root_axes[i]->extent());
       TORCH_CHECK(
           pred->getValType().value() == ValType::Scalar &&
           pred->getDataType().value() == DataType::Int);
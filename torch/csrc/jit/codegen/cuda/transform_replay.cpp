@@ -268,7 +268,7 @@ TensorDomain* TransformReplay::runReplay(
   // isReduction is only impactful when its on a consumer
   auto init_size = replay_target->nDims();
   for (decltype(init_size) i = 0; i < init_size; i++)
-    if (!replay_target->axis(i)->isReduction())
+    if (replay_reductions || !replay_target->axis(i)->isReduction())
       axis_map.push_back(i);
 
   // Domain sizes must match at root for replay.
@@ -307,7 +307,7 @@ TensorDomain* TransformReplay::runReplay(
   TensorDomain* replayed = TransformIter::runReplay(replay_target);
 
   for (decltype(replayed->nDims()) i{0}; i < compute_at_axis; i++)
-    if (replayed->axis(i)->isReduction())
+    if (!replay_reductions && replayed->axis(i)->isReduction())
       TORCH_CHECK(
           false,
           "Generated a compute_at dependency where a reduction would be used before computed.");
@@ -348,6 +348,14 @@ TensorDomain* TransformReplay::fullReplay(
   return tr.runReplay(replay_ref, replay_target, -1);
 }
 
+TensorDomain* TransformReplay::fullSelfReplay(
+    TensorDomain* replay_ref,
+    TensorDomain* replay_target) {
+  TransformReplay tr;
+  tr.replay_reductions = true;
+  return tr.runReplay(replay_ref, replay_target, -1);
+}
+
 } // namespace fuser
 } // namespace jit
 } // namespace torch
@@ -175,6 +175,10 @@ struct TORCH_CUDA_API TransformReplay : public TransformIter {
   // axis_map[fake_pos] = real_pos
   std::vector<int> axis_map;
 
+  // Map reduction axes of the target as well. Only valid when the target is a
+  // copy of the reference's root, not one of its producers.
+  bool replay_reductions = false;
+
  public:
   static TensorView* replay(
       TensorView* replay_ref,
@@ -188,6 +192,12 @@ struct TORCH_CUDA_API TransformReplay : public TransformIter {
   static TensorDomain* fullReplay(
       TensorDomain* replay_ref,
       TensorDomain* replay_target);
+
+  // Replay all transformations of replay_ref on replay_target, whose axes
+  // (reduction axes included) must match the root of replay_ref one to one.
+  static TensorDomain* fullSelfReplay(
+      TensorDomain* replay_ref,
+      TensorDomain* replay_target);
 };
 
 } // namespace fuser
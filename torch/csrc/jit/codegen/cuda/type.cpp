@@ -61,6 +61,7 @@ static _enum_unordered_map<ValType, std::string> val_type_string_map{
 static _enum_unordered_map<ExprType, std::string> expr_type_string_map{
     {ExprType::UnaryOp, "UnaryOp"},
     {ExprType::BinaryOp, "BinaryOp"},
+    {ExprType::ReductionOp, "ReductionOp"},
     {ExprType::ForLoop, "ForLoop"},
     {ExprType::IfThenElse, "IfThenElse"},
     {ExprType::Allocate, "Allocate"},
@@ -69,9 +70,11 @@ static _enum_unordered_map<ExprType, std::string> expr_type_string_map{
     {ExprType::Reorder, "Reorder"}};
 static _enum_unordered_map<UnaryOpType, std::string> unary_op_type_string_map{
     {UnaryOpType::Neg, "Neg"},
-    {UnaryOpType::Cast, "Cast"}};
+    {UnaryOpType::Cast, "Cast"},
+    {UnaryOpType::Set, "Set"}};
 static _enum_unordered_map<UnaryOpType, std::string>
-    unary_op_type_inline_op_string_map{{UnaryOpType::Neg, "~"}};
+    unary_op_type_inline_op_string_map{{UnaryOpType::Neg, "~"},
+                                       {UnaryOpType::Set, ""}};
 static _enum_unordered_map<BinaryOpType, std::string> binary_op_type_string_map{
     {BinaryOpType::Add, "Add"},
     {BinaryOpType::Sub, "Sub"},
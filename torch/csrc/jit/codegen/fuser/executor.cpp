@@ -160,6 +160,7 @@ static std::vector<int64_t> computeMapSize(
 
 // Tries to compress sizes and strides according to cont. Emits the result t
 // c_sizes, c_strides and throws an error on failure (if can't compress)
+// Note: dimensions are merged the same way as in TensorDesc::findContiguous
 static void compressContiguous(
     const at::IntArrayRef& sizes,
     const at::IntArrayRef& strides,
@@ -170,20 +171,23 @@ static void compressContiguous(
   size_t cur = 0;
   size_t ndim = sizes.size();
   while (cur < ndim) {
-    size_t total_size = sizes[cur];
+    int64_t total_size = sizes[cur];
+    int64_t total_stride = strides[cur];
     cur++;
     while (cont[cur - 1] && cur < ndim) {
-      AT_ASSERT(strides[cur - 1] == sizes[cur] * strides[cur]);
-      total_size *= sizes[cur];
+      AT_ASSERT(TensorDesc::mergeDims(
+          total_size, total_stride, sizes[cur], strides[cur]));
       cur++;
     }
+    // The last dimension is indexed without its stride if it is contiguous
+    if (cur == ndim && cont.back()) {
+      AT_ASSERT(total_stride == 1 || total_size == 1);
+      total_stride = 1;
+    }
     c_sizes[compressed_dims] = total_size;
-    c_strides[compressed_dims] = strides[cur - 1];
+    c_strides[compressed_dims] = total_stride;
     compressed_dims++;
   }
-
-  if (ndim > 0)
-    AT_ASSERT(!cont.back() || strides.back() == 1);
 }
 
 // Launches the requested fusion on the given device with the given inputs.
@@ -378,13 +382,14 @@ bool runFusion(const int64_t key, Stack& stack, std::string* code_out) {
 
   // Retrieves the kernel, compiling (and caching) if necessary
   ArgSpec arg_spec{inputs, device.index()};
+  // Note: kernels only depend on the sizes of the inputs through their
+  // contiguity, the sizes themselves are passed in the TensorInfo arguments.
   auto maybe_kernel = spec.findKernel(arg_spec);
   if (!maybe_kernel) {
     const auto kernel = compileKernel(spec, arg_spec, *maybe_map_size, device);
     spec.cacheKernel(arg_spec, kernel);
+    maybe_kernel = kernel;
   }
-  maybe_kernel = spec.findKernel(arg_spec);
-  AT_ASSERT(maybe_kernel);
 
   if (code_out) {
     *code_out = maybe_kernel.value()->code();
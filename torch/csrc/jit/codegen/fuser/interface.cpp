@@ -5,6 +5,7 @@
 #include <torch/csrc/jit/codegen/fuser/fallback.h>
 #include <torch/csrc/jit/codegen/fuser/kernel_cache.h>
 
+#include <atomic>
 #include <stdexcept>
 
 namespace torch {
@@ -17,6 +18,8 @@ bool cpu_fuser_enabled = false;
 
 bool gpu_fuser_enabled = true;
 
+std::atomic<size_t> max_cached_kernels_per_fusion{32};
+
 } // namespace detail
 
 int64_t registerFusion(const Node* fusion_group) {
@@ -47,6 +50,14 @@ void overrideCanFuseOnGPU(bool value) {
   detail::gpu_fuser_enabled = value;
 }
 
+void overrideMaxCachedKernelsPerFusion(size_t value) {
+  detail::max_cached_kernels_per_fusion = value;
+}
+
+size_t maxCachedKernelsPerFusion() {
+  return detail::max_cached_kernels_per_fusion;
+}
+
 // Uses the above interface by stuffing the graph into a node and treating that
 // node as a fusion group.
 std::vector<at::Tensor> debugLaunchGraph(
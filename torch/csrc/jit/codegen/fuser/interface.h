@@ -35,6 +35,12 @@ TORCH_API void overrideCanFuseOnCPU(bool value);
 // Sets whether fusion on the GPU is allowed (enabled by default)
 TORCH_API void overrideCanFuseOnGPU(bool value);
 
+// Sets how many kernels are kept for each fusion group (32 by default). A
+// kernel is compiled per device, rank, dtypes and contiguity of the inputs;
+// when there are more, the least recently used one is discarded.
+TORCH_API void overrideMaxCachedKernelsPerFusion(size_t value);
+TORCH_API size_t maxCachedKernelsPerFusion();
+
 // Treats the given graph as a fusion group and launches it on the
 // specified device with the given inputs.
 // Returns the outputs.
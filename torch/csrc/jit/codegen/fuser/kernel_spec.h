@@ -10,7 +10,9 @@
 #include <torch/csrc/jit/ir/ir.h>
 #include <torch/csrc/jit/runtime/interpreter.h>
 
+#include <algorithm>
 #include <cstdint>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -48,8 +50,9 @@ struct TORCH_API PartitionInfo {
 // devices (cpu vs gpu, different gpus) and different inputs (int vs float,
 // contiguous vs discontiguous).
 // Note: uses a mutex to control access to its kernel store
-// Note: unordered containers do not invalidate references/pointers on
-//   rehashing, which is critical for thread-safety.
+// Note: the kernel store keeps at most maxCachedKernelsPerFusion() kernels,
+//   evicting the least recently used one. Kernels are handed out as
+//   shared pointers, so evicted kernels stay alive while they are in use.
 // TODO: allow abstract kernels to use multiple generated kernels
 // TODO: allow abstract kernels to reuse generated kernels from common pool
 struct TORCH_API KernelSpec {
@@ -65,6 +68,7 @@ struct TORCH_API KernelSpec {
         inputBroadcastGroups_{},
         inputChunks_{},
         has_random_{false},
+        lru_{},
         kernels_{} {
     for (const auto& n : graph_->nodes()) {
       if (n->kind() == aten::rand_like) {
@@ -120,12 +124,26 @@ struct TORCH_API KernelSpec {
     const auto it = kernels_.find(arg_spec);
     if (it == kernels_.end())
       return c10::nullopt;
-    return it->second;
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->second;
   }
   void cacheKernel(const ArgSpec& arg_spec, std::shared_ptr<FusedKernel> kernel)
       const {
     std::lock_guard<std::mutex> guard{mutex_};
-    kernels_.emplace(arg_spec, kernel);
+    if (kernels_.count(arg_spec)) {
+      return;
+    }
+    lru_.emplace_front(arg_spec, std::move(kernel));
+    kernels_.emplace(arg_spec, lru_.begin());
+    const size_t max_kernels = std::max<size_t>(maxCachedKernelsPerFusion(), 1);
+    while (lru_.size() > max_kernels) {
+      kernels_.erase(lru_.back().first);
+      lru_.pop_back();
+    }
+  }
+  size_t nCachedKernels() const {
+    std::lock_guard<std::mutex> guard{mutex_};
+    return lru_.size();
   }
 
  private:
@@ -138,8 +156,12 @@ struct TORCH_API KernelSpec {
   std::vector<PartitionInfo> inputChunks_;
   bool has_random_;
   mutable std::mutex mutex_;
+  // Kernels, most recently used first
+  using KernelList =
+      std::list<std::pair<ArgSpec, std::shared_ptr<FusedKernel>>>;
+  mutable KernelList lru_;
   mutable std::
-      unordered_map<ArgSpec, std::shared_ptr<FusedKernel>, torch::hash<ArgSpec>>
+      unordered_map<ArgSpec, KernelList::iterator, torch::hash<ArgSpec>>
           kernels_;
 };
 
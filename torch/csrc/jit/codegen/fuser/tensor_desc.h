@@ -57,16 +57,51 @@ struct TORCH_API TensorDesc {
     return (contiguity.size() == 0 || contiguity.back());
   }
 
+  // Tries to merge the next dimension into a group of dimensions with the
+  // given total size and stride, so that they can be indexed as one dimension.
+  // The stride of a dimension of size 1 doesn't matter, so such dimensions are
+  // always merged. That way, the contiguity (and so the compiled kernel) of a
+  // tensor doesn't change when some of its sizes change from or to 1, e.g. for
+  // variable sequence lengths or batch sizes.
+  static bool mergeDims(
+      int64_t& size,
+      int64_t& stride,
+      const int64_t next_size,
+      const int64_t next_stride) {
+    if (next_size == 1) {
+      return true;
+    }
+    if (size == 1) {
+      size = next_size;
+      stride = next_stride;
+      return true;
+    }
+    if (stride != next_size * next_stride) {
+      return false;
+    }
+    size *= next_size;
+    stride = next_stride;
+    return true;
+  }
+
   static std::vector<bool> findContiguous(
       const at::IntArrayRef& sizes,
       const at::IntArrayRef& strides) {
     AT_ASSERT(sizes.size() == strides.size());
+    if (sizes.size() == 0) {
+      return {};
+    }
     std::vector<bool> cont(sizes.size());
-    for (size_t i = 0; i < sizes.size(); ++i) {
-      const auto expected_stride =
-          (i + 1 < sizes.size()) ? sizes[i + 1] * strides[i + 1] : 1;
-      cont[i] = (strides[i] == expected_stride);
+    int64_t size = sizes[0];
+    int64_t stride = strides[0];
+    for (size_t i = 0; i + 1 < sizes.size(); ++i) {
+      cont[i] = mergeDims(size, stride, sizes[i + 1], strides[i + 1]);
+      if (!cont[i]) {
+        size = sizes[i + 1];
+        stride = strides[i + 1];
+      }
     }
+    cont.back() = (stride == 1 || size == 1);
     return cont;
   }
 
@@ -3525,7 +3525,8 @@ std::vector<Function*> CompilationUnit::define(
     const std::vector<Def>& definitions,
     const std::vector<ResolverPtr>& resolvers,
     const Self* self,
-    bool shouldMangle) {
+    bool shouldMangle,
+    bool lazy) {
   TORCH_INTERNAL_ASSERT(definitions.size() == resolvers.size());
   std::vector<Function*> functions;
   std::unordered_map<std::string, Function*> function_table;
@@ -3554,7 +3555,12 @@ std::vector<Function*> CompilationUnit::define(
   }
 
   for (Function* function : functions) {
-    function->ensure_defined();
+    if (lazy) {
+      // The functions defined here are all GraphFunctions.
+      static_cast<GraphFunction*>(function)->defer_definition();
+    } else {
+      function->ensure_defined();
+    }
   }
   return functions;
 }
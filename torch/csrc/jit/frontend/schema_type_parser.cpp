@@ -161,13 +161,34 @@ TypePtr SchemaTypeParser::parseRefinedTensor() {
         dtype, at::DeviceType::CPU, num_dims, c10::nullopt);
   } else {
     std::vector<int64_t> dims;
+    // Symbolic dims are written SS(-n)
+    std::vector<c10::ShapeSymbol> symbolic_dims;
+    bool seen_symbols = false;
     bool seen_strides = false;
     std::vector<int64_t> strides;
     parseList(TK_NOTHING, ',', ')', [&] {
+      if (L.cur().kind == TK_IDENT && L.cur().text() == "SS") {
+        L.next();
+        L.expect('(');
+        L.expect('-');
+        const std::string& num = L.expect(TK_NUMBER).text();
+        std::string::size_type num_len;
+        int64_t id = c10::stoi(num, &num_len);
+        L.expect(')');
+        auto it = symbols_.find(id);
+        if (it == symbols_.end()) {
+          it = symbols_.emplace(id, c10::ShapeSymbol::newSymbol()).first;
+        }
+        symbolic_dims.push_back(it->second);
+        dims.push_back(-1);
+        seen_symbols = true;
+        return;
+      }
       const std::string& num = L.expect(TK_NUMBER).text();
       std::string::size_type num_len;
       size_t dim = c10::stoi(num, &num_len);
       dims.push_back(dim);
+      symbolic_dims.push_back(c10::ShapeSymbol::fromStaticSize(dim));
       if (seen_strides || L.cur().kind == ':') {
         L.expect(':');
         seen_strides = true;
@@ -178,7 +199,18 @@ TypePtr SchemaTypeParser::parseRefinedTensor() {
       }
     });
     at::IntArrayRef dims_ref(dims);
-    if (seen_strides) {
+    if (seen_symbols) {
+      if (seen_strides) {
+        throw ErrorReport(L.cur())
+            << "Strides info can't be specified for symbolic dimensions";
+      }
+      ptr = at::TensorType::create(
+          dtype,
+          at::DeviceType::CPU,
+          c10::VaryingShape<c10::ShapeSymbol>(symbolic_dims),
+          c10::VaryingShape<c10::Stride>(dims.size()),
+          c10::nullopt);
+    } else if (seen_strides) {
       at::IntArrayRef strides_ref(strides);
       if (strides.size() != dims.size()) {
         throw ErrorReport(L.cur())
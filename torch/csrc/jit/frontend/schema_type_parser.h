@@ -5,6 +5,8 @@
 #include <ATen/core/jit_type.h>
 #include <torch/csrc/jit/frontend/lexer.h>
 
+#include <unordered_map>
+
 namespace torch {
 namespace jit {
 
@@ -31,6 +33,9 @@ struct CAFFE2_API SchemaTypeParser {
   bool complete_tensor_types;
   Lexer& L;
   size_t next_id = 0;
+  // The symbols of the symbolic dims SS(-n) seen so far, by n; the same n
+  // gives the same symbol within the types parsed by this parser.
+  std::unordered_map<int64_t, c10::ShapeSymbol> symbols_;
 };
 } // namespace jit
 } // namespace torch
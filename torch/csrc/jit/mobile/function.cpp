@@ -20,6 +20,22 @@ void Function::append_instruction(OpCode op, int X, int N) {
       toString(op),
       " is not supported in mobile module.");
   code_->instructions_.emplace_back(op, X, N);
+  code_->instructions_data_ = code_->instructions_.data();
+}
+
+void Function::set_instructions(
+    std::shared_ptr<at::DataPtr> owner,
+    const Instruction* instructions,
+    size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    TORCH_CHECK(
+        isOpSupportedInMobile(instructions[i].op),
+        toString(instructions[i].op),
+        " is not supported in mobile module.");
+  }
+  code_->instructions_.clear();
+  code_->instructions_data_ = instructions;
+  code_->flat_bytecode_ = std::move(owner);
 }
 
 bool Function::append_operator(
@@ -30,21 +46,25 @@ bool Function::append_operator(
   auto opname = code_->op_names_.back();
 
   auto opname_c10 = opname;
-  std::function<void(Stack&)> fn;
+  Operation fn;
 
   auto jit_op = findOperatorFor(opname);
   if (jit_op) {
-    fn = [jit_op](Stack& stack) { jit_op->getOperation()(stack); };
+    // Bind the operation now instead of looking it up on every call
+    fn = jit_op->getOperation();
   } else {
     auto op = c10::Dispatcher::singleton().findSchema(opname_c10);
     if (op.has_value()) {
-      fn = [op](Stack& stack) { op->callBoxed(&stack); };
+      fn = [op](Stack& stack) {
+        op->callBoxed(&stack);
+        return 0;
+      };
     } else {
       return false;
     }
   }
 
-  code_->operators_.emplace_back(fn);
+  code_->operators_.emplace_back(std::move(fn));
   return true;
 }
 
@@ -7,6 +7,7 @@ namespace torch {
 namespace jit {
 using Stack = std::vector<c10::IValue>;
 enum OpCode : uint8_t;
+struct Instruction;
 
 namespace mobile {
 struct Code;
@@ -18,6 +19,12 @@ class Function {
   const std::string& name() const;
   const c10::QualifiedName& qualname() const;
   void append_instruction(OpCode op, int X, int N);
+  // Runs the `size` instructions at `instructions` in place instead of
+  // appended ones. They are kept alive by `owner`.
+  void set_instructions(
+      std::shared_ptr<at::DataPtr> owner,
+      const Instruction* instructions,
+      size_t size);
   bool append_operator(
       const std::string& name,
       const std::string& overload_name);
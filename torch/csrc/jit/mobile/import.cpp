@@ -1,6 +1,7 @@
 #include <torch/csrc/jit/mobile/import.h>
 #include <ATen/core/ivalue.h>
 #include <caffe2/serialize/inline_container.h>
+#include <caffe2/serialize/mmap_adapter.h>
 #include <torch/csrc/jit/api/compilation_unit.h>
 #include <torch/csrc/jit/mobile/type_parser.h>
 #include <torch/csrc/jit/runtime/instruction.h>
@@ -8,8 +9,11 @@
 #include <torch/csrc/jit/serialization/unpickler.h>
 #include <torch/custom_class.h>
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 // The import process to serialize the bytecode package.
@@ -42,10 +46,12 @@ TypePtr parseType(const std::string& pythonStr);
 namespace torch {
 namespace jit {
 using caffe2::serialize::IStreamAdapter;
+using caffe2::serialize::MmapAdapter;
 using caffe2::serialize::PyTorchStreamReader;
 using caffe2::serialize::ReadAdapterInterface;
 
 OpCode parseOpCode(const char* str);
+char const* toString(OpCode op);
 
 IValue expect_field(
     IValue tup,
@@ -152,6 +158,153 @@ void parseMethods(
   }
 }
 
+// Reads the parts of a flat bytecode record, see import_export_constants.h,
+// checking that they lie within the record.
+class FlatBytecodeReader {
+ public:
+  FlatBytecodeReader(const char* data, size_t size)
+      : data_(data), size_(size), pos_(0) {}
+
+  const char* take(size_t n) {
+    TORCH_CHECK(
+        n <= size_ - pos_, "Malformed flat bytecode: the record is truncated");
+    const char* result = data_ + pos_;
+    pos_ += n;
+    return result;
+  }
+
+  uint32_t readUInt() {
+    uint32_t value;
+    std::memcpy(&value, take(sizeof(value)), sizeof(value));
+    return value;
+  }
+
+  std::string readString() {
+    const size_t size = readUInt();
+    const char* str = take(size);
+    align(sizeof(uint32_t));
+    return std::string(str, size);
+  }
+
+  void align(size_t alignment) {
+    pos_ = std::min(size_, (pos_ + alignment - 1) / alignment * alignment);
+  }
+
+ private:
+  const char* data_;
+  size_t size_;
+  size_t pos_;
+};
+
+// Registers the functions of a flat bytecode record. Their instructions are
+// run in place from the record, unless the opcodes it was written with differ
+// from ours. Operators, types and constants are looked up as for
+// `bytecode.pkl`, without unpickling the tables that name them.
+void parseFlatMethods(
+    at::DataPtr data,
+    size_t size,
+    const std::vector<IValue>& constants,
+    mobile::CompilationUnit& mcu) {
+  auto owner = std::make_shared<at::DataPtr>(std::move(data));
+  FlatBytecodeReader in(static_cast<const char*>(owner->get()), size);
+
+  TORCH_CHECK(
+      std::memcmp(
+          in.take(sizeof(FLAT_BYTECODE_MAGIC)),
+          FLAT_BYTECODE_MAGIC,
+          sizeof(FLAT_BYTECODE_MAGIC)) == 0,
+      "Malformed flat bytecode: bad magic number");
+  const auto version = in.readUInt();
+  TORCH_CHECK(
+      version == FLAT_BYTECODE_VERSION,
+      "Unsupported flat bytecode version ",
+      version,
+      ", expected ",
+      FLAT_BYTECODE_VERSION);
+  TORCH_CHECK(
+      in.readUInt() == FLAT_BYTECODE_BYTE_ORDER_MARK,
+      "Flat bytecode was written with a different byte order");
+
+  const auto opcode_count = in.readUInt();
+  std::vector<c10::optional<OpCode>> opcodes;
+  opcodes.reserve(opcode_count);
+  bool in_place = true;
+  for (uint32_t i = 0; i < opcode_count; ++i) {
+    const auto name = in.readString();
+    const OpCode op = parseOpCode(name.c_str());
+    if (name == toString(op)) {
+      opcodes.emplace_back(op);
+      in_place = in_place && op == static_cast<OpCode>(i);
+    } else {
+      opcodes.emplace_back(c10::nullopt);
+      in_place = false;
+    }
+  }
+
+  const auto function_count = in.readUInt();
+  for (uint32_t f = 0; f < function_count; ++f) {
+    auto function = std::unique_ptr<mobile::Function>(
+        new mobile::Function(c10::QualifiedName(in.readString())));
+    function->set_register_size(in.readUInt());
+
+    const size_t constants_begin = in.readUInt();
+    const size_t constants_count = in.readUInt();
+    TORCH_CHECK(
+        constants_begin + constants_count <= constants.size(),
+        "Malformed flat bytecode: constants out of range");
+
+    const size_t instruction_count = in.readUInt();
+    in.align(8);
+    const char* instructions =
+        in.take(instruction_count * sizeof(Instruction));
+    if (in_place &&
+        reinterpret_cast<uintptr_t>(instructions) % alignof(Instruction) ==
+            0) {
+      function->set_instructions(
+          owner,
+          reinterpret_cast<const Instruction*>(instructions),
+          instruction_count);
+    } else {
+      for (size_t i = 0; i < instruction_count; ++i) {
+        std::aligned_storage<sizeof(Instruction), alignof(Instruction)>::type
+            storage;
+        std::memcpy(
+            &storage, instructions + i * sizeof(Instruction), sizeof(storage));
+        const auto& ins = *reinterpret_cast<const Instruction*>(&storage);
+        TORCH_CHECK(
+            ins.op < opcodes.size() && opcodes[ins.op].has_value(),
+            "Flat bytecode uses an unknown opcode ",
+            static_cast<int>(ins.op));
+        function->append_instruction(*opcodes[ins.op], ins.X, ins.N);
+      }
+    }
+
+    std::unordered_set<std::string> unsupported_op_names;
+    const auto operator_count = in.readUInt();
+    for (uint32_t i = 0; i < operator_count; ++i) {
+      auto name = in.readString();
+      auto overload_name = in.readString();
+      if (!function->append_operator(name, overload_name)) {
+        unsupported_op_names.emplace(operator_str(name, overload_name));
+      }
+    }
+    if (!unsupported_op_names.empty()) {
+      print_unsupported_ops_and_throw(unsupported_op_names);
+    }
+
+    for (size_t i = 0; i < constants_count; ++i) {
+      function->append_constant(constants[constants_begin + i]);
+    }
+
+    const auto type_count = in.readUInt();
+    for (uint32_t i = 0; i < type_count; ++i) {
+      function->append_type(c10::parseType(in.readString()));
+    }
+
+    mcu.register_function(std::move(function));
+  }
+}
+
 // The deserializer class which loads the bytecode package from bc files.
 class BytecodeDeserializer final {
  public:
@@ -177,8 +330,17 @@ mobile::Module BytecodeDeserializer::deserialize(
     c10::optional<at::Device> device) {
   device_ = device;
   auto mcu = std::make_shared<mobile::CompilationUnit>();
-  auto bvals = readArchive("bytecode", mcu).toTuple()->elements();
-  parseMethods(bvals, *mcu);
+  if (reader_->hasRecord("bytecode.flat")) {
+    const auto constants =
+        readArchive("bytecode_constants", mcu).toTuple()->elements();
+    at::DataPtr flat_ptr;
+    size_t flat_size;
+    std::tie(flat_ptr, flat_size) = reader_->getRecord("bytecode.flat");
+    parseFlatMethods(std::move(flat_ptr), flat_size, constants, *mcu);
+  } else {
+    auto bvals = readArchive("bytecode", mcu).toTuple()->elements();
+    parseMethods(bvals, *mcu);
+  }
 
   return mobile::Module(readArchive("data", mcu).toObject(), mcu);
 }
@@ -294,6 +456,14 @@ mobile::Module _load_for_mobile(
   return module;
 }
 
+mobile::Module _load_for_mobile_mmap(
+    const std::string& filename,
+    c10::optional<at::Device> device) {
+  std::unique_ptr<MmapAdapter> rai = std::make_unique<MmapAdapter>(filename);
+  auto module = _load_for_mobile(std::move(rai), device);
+  return module;
+}
+
 mobile::Module _load_for_mobile(
     std::unique_ptr<ReadAdapterInterface> rai,
     c10::optional<c10::Device> device) {
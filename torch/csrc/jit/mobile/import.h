@@ -20,6 +20,13 @@ TORCH_API mobile::Module _load_for_mobile(
     const std::string& filename,
     c10::optional<at::Device> device = c10::nullopt);
 
+// Loads a mobile module by mapping the file into memory instead of reading
+// it. The instructions of modules saved with flat bytecode are run from the
+// mapping, and the storages of CPU tensors alias it, see torch::jit::load_mmap.
+TORCH_API mobile::Module _load_for_mobile_mmap(
+    const std::string& filename,
+    c10::optional<at::Device> device = c10::nullopt);
+
 TORCH_API mobile::Module _load_for_mobile(
     std::unique_ptr<ReadAdapterInterface> rai,
     c10::optional<c10::Device> device = c10::nullopt);
@@ -3,11 +3,14 @@
 #include <ATen/core/jit_type.h>
 #include <ATen/core/operator_name.h>
 #include <torch/csrc/jit/mobile/function.h>
+#include <torch/csrc/jit/mobile/observer.h>
 #include <torch/csrc/jit/runtime/vararg_functions.h>
 
+#include <chrono>
+#include <limits>
+
 #if defined(PYTORCH_MOBILE_OPERATOR_OBSERVER)
 #include <torch/csrc/autograd/record_function.h>
-#include <torch/csrc/jit/mobile/observer.h>
 #endif
 
 namespace torch {
@@ -20,10 +23,48 @@ InterpreterState::InterpreterState(std::shared_ptr<Code> code)
   registers_.resize(code_->register_size_);
 }
 
+namespace {
+constexpr int32_t kUnresolvedSlot = std::numeric_limits<int32_t>::min();
+} // namespace
+
+void InterpreterState::runTimedOperator(
+    size_t index,
+    Stack& stack,
+    MobileOpLatencyStats& stats) {
+  std::call_once(code_->op_latency_slots_once_, [&] {
+    const auto size = code_->operators_.size();
+    code_->op_latency_slots_.reset(new std::atomic<int32_t>[size]);
+    for (size_t i = 0; i < size; ++i) {
+      code_->op_latency_slots_[i].store(kUnresolvedSlot);
+    }
+  });
+  auto& cached_slot = code_->op_latency_slots_[index];
+  auto slot = cached_slot.load(std::memory_order_relaxed);
+  if (slot == kUnresolvedSlot) {
+    const auto& opname = code_->op_names_[index];
+    slot = stats.slot(
+        opname.overload_name.empty()
+            ? opname.name
+            : opname.name + "." + opname.overload_name);
+    cached_slot.store(slot, std::memory_order_relaxed);
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  code_->operators_[index](stack);
+  const auto end = std::chrono::steady_clock::now();
+  stats.record(
+      slot,
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+          .count());
+}
+
 bool InterpreterState::run(Stack& stack) {
+  // Checked once per call, so that running untimed operators costs nothing
+  MobileOpLatencyStats* op_latency_stats =
+      torch::observerConfig().getOpLatencyStats();
   size_t pc = 0;
   while (true) {
-    Instruction inst = code_->instructions_[pc];
+    Instruction inst = code_->instructions_data_[pc];
 
     //    std::cout << "RUNNING " << pc << " " << code_->instructions_[pc];
     //    if (inst.op == OP) {
@@ -45,12 +86,20 @@ bool InterpreterState::run(Stack& stack) {
         }
         RECORD_FUNCTION(code_->op_names_[inst.X].name, stack);
 #endif
-        code_->operators_[inst.X](stack);
+        if (C10_UNLIKELY(op_latency_stats != nullptr)) {
+          runTimedOperator(inst.X, stack, *op_latency_stats);
+        } else {
+          code_->operators_[inst.X](stack);
+        }
         ++pc;
       } break;
       case OPN: {
         stack.push_back(inst.N);
-        code_->operators_[inst.X](stack);
+        if (C10_UNLIKELY(op_latency_stats != nullptr)) {
+          runTimedOperator(inst.X, stack, *op_latency_stats);
+        } else {
+          code_->operators_[inst.X](stack);
+        }
         ++pc;
       } break;
       case INTERFACE_CALL: {
@@ -2,19 +2,35 @@
 #include <ATen/core/dispatch/Dispatcher.h>
 #include <ATen/core/ivalue.h>
 #include <ATen/core/operator_name.h>
+#include <ATen/core/stack.h>
 #include <torch/csrc/jit/runtime/instruction.h>
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+
 namespace torch {
+class MobileOpLatencyStats;
 namespace jit {
 namespace mobile {
 using Stack = std::vector<c10::IValue>;
 struct Code {
   std::vector<Instruction> instructions_;
+  // The instructions that are run: those of `instructions_`, or those of a
+  // flat bytecode record used in place, which `flat_bytecode_` keeps alive.
+  const Instruction* instructions_data_ = nullptr;
+  std::shared_ptr<at::DataPtr> flat_bytecode_;
   std::vector<c10::OperatorName> op_names_;
-  std::vector<std::function<void(Stack&)>> operators_;
+  // Resolved once when the function is loaded, so running an OP instruction
+  // is a single indirect call into the (unboxed wrapper of the) kernel.
+  std::vector<Operation> operators_;
   std::vector<c10::IValue> constants_;
   std::vector<c10::TypePtr> types_;
   size_t register_size_; // Aggregated output size.
+  // Slots of the operators in MobileOpLatencyStats, resolved on their first
+  // timed run, see observer.h.
+  std::once_flag op_latency_slots_once_;
+  std::unique_ptr<std::atomic<int32_t>[]> op_latency_slots_;
 };
 
 struct InterpreterState {
@@ -24,6 +40,7 @@ struct InterpreterState {
  private:
   std::shared_ptr<Code> code_;
   c10::IValue& reg(size_t reg);
+  void runTimedOperator(size_t index, Stack& stack, MobileOpLatencyStats& stats);
   std::vector<c10::IValue> registers_;
 };
 
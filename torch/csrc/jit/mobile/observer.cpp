@@ -1,7 +1,129 @@
 #include <torch/csrc/jit/mobile/observer.h>
 
+#include <c10/util/llvmMathExtras.h>
+
+#include <algorithm>
+
 namespace torch {
 
+namespace {
+// Latencies below 2^kMinLog2Ns ns share the first bucket
+constexpr size_t kMinLog2Ns = 10;
+constexpr size_t kSubBuckets = 4;
+} // namespace
+
+constexpr size_t MobileOpLatencyStats::kMaxOps;
+constexpr size_t MobileOpLatencyStats::kBuckets;
+
+size_t MobileOpLatencyStats::bucket(uint64_t latency_ns) {
+  if (latency_ns < (uint64_t(1) << kMinLog2Ns)) {
+    return 0;
+  }
+  const size_t log2 = c10::llvm::Log2_64(latency_ns);
+  const size_t sub = (latency_ns >> (log2 - 2)) & (kSubBuckets - 1);
+  return std::min(1 + (log2 - kMinLog2Ns) * kSubBuckets + sub, kBuckets - 1);
+}
+
+uint64_t MobileOpLatencyStats::bucketBound(size_t bucket) {
+  if (bucket == 0) {
+    return uint64_t(1) << kMinLog2Ns;
+  }
+  const size_t log2 = kMinLog2Ns + (bucket - 1) / kSubBuckets;
+  const size_t sub = (bucket - 1) % kSubBuckets;
+  return (kSubBuckets + sub + 1) << (log2 - 2);
+}
+
+int32_t MobileOpLatencyStats::slot(const std::string& op_name) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = slot_of_op_.find(op_name);
+  if (it != slot_of_op_.end()) {
+    return it->second;
+  }
+  if (op_names_.size() == kMaxOps) {
+    return -1;
+  }
+  const auto slot = static_cast<int32_t>(op_names_.size());
+  op_names_.push_back(op_name);
+  slot_of_op_.emplace(op_name, slot);
+  return slot;
+}
+
+void MobileOpLatencyStats::record(int32_t slot, uint64_t latency_ns) {
+  if (slot < 0) {
+    return;
+  }
+  auto& s = slots_[slot];
+  s.count.fetch_add(1, std::memory_order_relaxed);
+  s.total_ns.fetch_add(latency_ns, std::memory_order_relaxed);
+  auto max_ns = s.max_ns.load(std::memory_order_relaxed);
+  while (latency_ns > max_ns &&
+         !s.max_ns.compare_exchange_weak(
+             max_ns, latency_ns, std::memory_order_relaxed)) {
+  }
+  s.buckets[bucket(latency_ns)].fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<MobileOpLatencyStats::OpLatency> MobileOpLatencyStats::summary()
+    const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  std::vector<OpLatency> result;
+  for (size_t i = 0; i < op_names_.size(); ++i) {
+    const auto& s = slots_[i];
+    std::array<uint32_t, kBuckets> buckets;
+    uint64_t count = 0;
+    for (size_t b = 0; b < kBuckets; ++b) {
+      buckets[b] = s.buckets[b].load(std::memory_order_relaxed);
+      count += buckets[b];
+    }
+    if (count == 0) {
+      continue;
+    }
+    const auto max_ns = s.max_ns.load(std::memory_order_relaxed);
+    auto percentile = [&](uint64_t percent) {
+      // The bucket holding the latency of rank ceil(count * percent / 100)
+      const uint64_t rank = (count * percent + 99) / 100;
+      uint64_t seen = 0;
+      for (size_t b = 0; b < kBuckets; ++b) {
+        seen += buckets[b];
+        if (seen >= rank) {
+          return std::min(bucketBound(b), max_ns);
+        }
+      }
+      return max_ns;
+    };
+    result.push_back(OpLatency{op_names_[i],
+                               count,
+                               s.total_ns.load(std::memory_order_relaxed),
+                               max_ns,
+                               percentile(50),
+                               percentile(90),
+                               percentile(99)});
+  }
+  return result;
+}
+
+void MobileOpLatencyStats::reset() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (auto& s : slots_) {
+    s.count.store(0, std::memory_order_relaxed);
+    s.total_ns.store(0, std::memory_order_relaxed);
+    s.max_ns.store(0, std::memory_order_relaxed);
+    for (auto& b : s.buckets) {
+      b.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+void MobileObserverConfig::setOpLatencyCollection(bool enabled) {
+  std::lock_guard<std::mutex> guard(op_latency_mutex_);
+  if (enabled && !op_latency_stats_) {
+    op_latency_stats_ = std::make_unique<MobileOpLatencyStats>();
+  }
+  // The stats outlive collection, as interpreters may still be recording
+  active_op_latency_stats_.store(
+      enabled ? op_latency_stats_.get() : nullptr, std::memory_order_release);
+}
+
 MobileObserverConfig& observerConfig() {
   static MobileObserverConfig instance;
   return instance;
@@ -1,7 +1,15 @@
 #pragma once
 
 #include <ATen/ThreadLocalDebugInfo.h>
+#include <c10/macros/Export.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace torch {
 
@@ -49,6 +57,61 @@ class MobileModuleObserver {
   virtual void onExit() {}
 };
 
+// Latencies of the operators run by mobile modules, aggregated in a buffer of
+// fixed size so that it can be uploaded as is.
+//
+// Every operator, named with its overload, gets one of kMaxOps slots the first
+// time it runs; operators beyond that are not recorded. A slot counts its
+// latencies in a histogram of kBuckets buckets: the first one counts those
+// below 1us, and the others split every power of two from 1us up to about 1s
+// in four, the last one also counting all latencies above. Percentiles are
+// the upper bounds of the buckets they fall in, within 25% of the actual
+// latency. Recording is lock free, and may race with summary() and reset().
+class TORCH_API MobileOpLatencyStats {
+ public:
+  static constexpr size_t kMaxOps = 256;
+  static constexpr size_t kBuckets = 81;
+
+  struct OpLatency {
+    std::string op_name;
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t p50_ns;
+    uint64_t p90_ns;
+    uint64_t p99_ns;
+  };
+
+  // Returns the slot of the operator, -1 if all slots are taken.
+  int32_t slot(const std::string& op_name);
+
+  void record(int32_t slot, uint64_t latency_ns);
+
+  // The latencies of every operator that ran since the last reset().
+  std::vector<OpLatency> summary() const;
+
+  // Clears the latencies. Operators keep their slots.
+  void reset();
+
+  // The upper bound of the latencies counted by a bucket.
+  static uint64_t bucketBound(size_t bucket);
+
+ private:
+  struct Slot {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> total_ns{0};
+    std::atomic<uint64_t> max_ns{0};
+    std::array<std::atomic<uint32_t>, kBuckets> buckets{};
+  };
+
+  static size_t bucket(uint64_t latency_ns);
+
+  std::array<Slot, kMaxOps> slots_;
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, int32_t> slot_of_op_;
+  std::vector<std::string> op_names_;
+};
+
 class MobileObserverConfig {
  public:
   void setModuleObserver(std::unique_ptr<MobileModuleObserver> reporter) {
@@ -58,10 +121,23 @@ class MobileObserverConfig {
     return module_observer_.get();
   }
 
+  // Enables timing every operator run by mobile modules into
+  // getOpLatencyStats(). It is off by default, which costs the interpreter a
+  // single check per method call.
+  void setOpLatencyCollection(bool enabled);
+
+  // The operator latencies collected, nullptr while collection is off.
+  MobileOpLatencyStats* getOpLatencyStats() {
+    return active_op_latency_stats_.load(std::memory_order_acquire);
+  }
+
  private:
   std::unique_ptr<MobileModuleObserver> module_observer_;
+  std::mutex op_latency_mutex_;
+  std::unique_ptr<MobileOpLatencyStats> op_latency_stats_;
+  std::atomic<MobileOpLatencyStats*> active_op_latency_stats_{nullptr};
 };
 
-MobileObserverConfig& observerConfig();
+TORCH_API MobileObserverConfig& observerConfig();
 
 } // namespace torch
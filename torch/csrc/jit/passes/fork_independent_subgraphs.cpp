@@ -0,0 +1,263 @@
+#include <torch/csrc/jit/passes/fork_independent_subgraphs.h>
+
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+bool canForkFrom(Block* block) {
+  for (Node* node : block->nodes()) {
+    if (node->kind() == prim::fork || node->kind() == prim::forkClosure ||
+        node->hasSideEffects() || node->isNondeterministic() ||
+        (node->maybeSchema() && node->schema().is_mutable())) {
+      GRAPH_DEBUG("Not forking subgraphs of a graph with ", *node);
+      return false;
+    }
+    for (Block* sub_block : node->blocks()) {
+      if (!canForkFrom(sub_block)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Values every group can use: they are either graph inputs or cheap to
+// recompute in a forked subgraph.
+bool isFree(const Value* v) {
+  const Node* node = v->node();
+  switch (node->kind()) {
+    case prim::Param:
+    case prim::Constant:
+      return true;
+    case prim::GetAttr:
+      return isFree(node->input());
+    default:
+      return false;
+  }
+}
+
+size_t nodeCost(Node* node) {
+  switch (node->kind()) {
+    case prim::Constant:
+    case prim::GetAttr:
+    case prim::TupleConstruct:
+    case prim::TupleUnpack:
+    case prim::ListConstruct:
+    case prim::ListUnpack:
+    case aten::size:
+    case aten::dim:
+      return 0;
+    default:
+      break;
+  }
+  if (node->hasAttribute(attr::Subgraph)) {
+    size_t cost = 0;
+    for (Node* sub_node : node->g(attr::Subgraph)->nodes()) {
+      cost += nodeCost(sub_node);
+    }
+    return cost;
+  }
+  return 1;
+}
+
+Node* topLevelNode(Node* node, Block* top) {
+  while (node->owningBlock() != top) {
+    node = node->owningBlock()->owningNode();
+  }
+  return node;
+}
+
+struct GroupForker {
+  explicit GroupForker(std::shared_ptr<Graph> graph)
+      : graph_(std::move(graph)) {}
+
+  // Groups the top-level nodes; a node joins the group of its inputs if they
+  // all come from the same group, otherwise it is left out.
+  void buildGroups() {
+    for (Node* node : graph_->nodes()) {
+      if (node->outputs().size() > 0 && isFree(node->outputs()[0])) {
+        continue;
+      }
+      if (!node->blocks().empty() ||
+          node->kind() == prim::DifferentiableGraph) {
+        continue;
+      }
+      c10::optional<size_t> group;
+      bool joinable = true;
+      for (Value* input : node->inputs()) {
+        if (isFree(input)) {
+          continue;
+        }
+        auto it = group_of_.find(input->node());
+        if (it == group_of_.end() || (group && *group != it->second)) {
+          joinable = false;
+          break;
+        }
+        group = it->second;
+      }
+      if (!joinable) {
+        continue;
+      }
+      if (!group) {
+        group = groups_.size();
+        groups_.emplace_back();
+      }
+      groups_[*group].push_back(node);
+      group_of_[node] = *group;
+    }
+  }
+
+  bool run(size_t min_cost) {
+    buildGroups();
+    std::vector<size_t> forkable;
+    for (size_t i = 0; i < groups_.size(); ++i) {
+      size_t cost = 0;
+      for (Node* node : groups_[i]) {
+        cost += nodeCost(node);
+      }
+      if (cost >= min_cost) {
+        forkable.push_back(i);
+      }
+    }
+    if (forkable.size() < 2) {
+      return false;
+    }
+    // the last group runs inline while the others run on the inter-op pool
+    forkable.pop_back();
+    bool changed = false;
+    for (size_t group : forkable) {
+      changed |= forkGroup(group);
+    }
+    return changed;
+  }
+
+ private:
+  bool inGroup(Node* node, size_t group) const {
+    auto it = group_of_.find(node);
+    return it != group_of_.end() && it->second == group;
+  }
+
+  bool forkGroup(size_t group) {
+    const auto& nodes = groups_[group];
+    Block* top = graph_->block();
+
+    // the values of the group used outside of it, and the first such use
+    std::vector<Value*> outputs;
+    Node* first_use = nullptr;
+    for (Node* node : nodes) {
+      for (Value* output : node->outputs()) {
+        bool used_outside = false;
+        for (const Use& use : output->uses()) {
+          Node* user = topLevelNode(use.user, top);
+          if (inGroup(user, group)) {
+            continue;
+          }
+          used_outside = true;
+          if (user != graph_->return_node() &&
+              (!first_use || user->isBefore(first_use))) {
+            first_use = user;
+          }
+        }
+        if (used_outside) {
+          outputs.push_back(output);
+        }
+      }
+    }
+    if (outputs.empty()) {
+      return false;
+    }
+    if (!first_use) {
+      first_use = graph_->return_node();
+    }
+
+    Node* fork_node = graph_->create(prim::fork, 1)->insertBefore(nodes[0]);
+    auto subgraph = std::make_shared<Graph>();
+    std::unordered_map<Value*, Value*> env;
+    std::function<Value*(Value*)> value_map = [&](Value* v) -> Value* {
+      auto it = env.find(v);
+      if (it != env.end()) {
+        return it->second;
+      }
+      TORCH_INTERNAL_ASSERT(isFree(v));
+      if (v->node()->kind() == prim::Param) {
+        fork_node->addInput(v);
+        env[v] = subgraph->addInput()->copyMetadata(v);
+      } else {
+        Node* clone = subgraph->insertNode(
+            subgraph->createClone(v->node(), value_map));
+        env[v] = clone->output();
+      }
+      return env.at(v);
+    };
+    for (Node* node : nodes) {
+      Node* clone =
+          subgraph->insertNode(subgraph->createClone(node, value_map));
+      for (size_t i = 0; i < node->outputs().size(); ++i) {
+        env[node->outputs()[i]] = clone->outputs()[i];
+      }
+    }
+    if (outputs.size() == 1) {
+      subgraph->registerOutput(env.at(outputs[0]));
+    } else {
+      std::vector<Value*> sub_outputs;
+      for (Value* output : outputs) {
+        sub_outputs.push_back(env.at(output));
+      }
+      subgraph->registerOutput(
+          subgraph->insertNode(subgraph->createTuple(sub_outputs))->output());
+    }
+    const TypePtr& result_type = subgraph->outputs()[0]->type();
+    fork_node->g_(attr::Subgraph, subgraph);
+    fork_node->output()->setType(FutureType::create(result_type));
+
+    Node* wait_node = graph_->create(aten::wait, {fork_node->output()}, 1)
+                          ->insertBefore(first_use);
+    wait_node->output()->setType(result_type);
+    if (outputs.size() == 1) {
+      outputs[0]->replaceAllUsesWith(wait_node->output());
+    } else {
+      Node* unpack = graph_->createTupleUnpack(wait_node->output())
+                         ->insertAfter(wait_node);
+      for (size_t i = 0; i < outputs.size(); ++i) {
+        outputs[i]->replaceAllUsesWith(unpack->outputs()[i]);
+      }
+    }
+    for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+      (*it)->destroy();
+    }
+    GRAPH_DEBUG("Forked a group of ", nodes.size(), " nodes: ", *fork_node);
+    return true;
+  }
+
+  std::shared_ptr<Graph> graph_;
+  std::vector<std::vector<Node*>> groups_;
+  std::unordered_map<Node*, size_t> group_of_;
+};
+
+} // namespace
+
+std::atomic<bool>& getAutoForkMode() {
+  static std::atomic<bool> auto_fork_mode{false};
+  return auto_fork_mode;
+}
+
+bool ForkIndependentSubgraphs(
+    std::shared_ptr<Graph>& graph,
+    size_t min_cost) {
+  if (!canForkFrom(graph->block())) {
+    return false;
+  }
+  if (!GroupForker(graph).run(min_cost)) {
+    return false;
+  }
+  EliminateDeadCode(graph);
+  GRAPH_DUMP("After ForkIndependentSubgraphs: ", graph);
+  return true;
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+#include <atomic>
+
+namespace torch {
+namespace jit {
+
+// When set, the graph executors run ForkIndependentSubgraphs on optimized
+// graphs, so that independent parts of a graph run concurrently on the
+// inter-op thread pool.
+TORCH_API std::atomic<bool>& getAutoForkMode();
+
+// Splits the top-level block of `graph` into groups of nodes that only depend
+// on each other and on graph inputs or constants, such as the per-feature
+// towers of a recommendation model, and moves all but one of the groups into
+// prim::fork subgraphs, waited on right before their results are first used.
+// The last group runs inline, overlapping with the forked ones.
+//
+// Nodes with blocks, and nodes depending on more than one group, stay in the
+// graph. The cost of a group is its number of nodes, not counting cheap
+// bookkeeping ops and counting the nodes of fusion groups; groups cheaper
+// than `min_cost` are not worth the scheduling overhead and are left alone.
+//
+// Graphs with side effects, mutation, nondeterministic ops or explicit forks
+// are not changed. Returns true if the graph was changed.
+TORCH_API bool ForkIndependentSubgraphs(
+    std::shared_ptr<Graph>& graph,
+    size_t min_cost = 8);
+
+} // namespace jit
+} // namespace torch
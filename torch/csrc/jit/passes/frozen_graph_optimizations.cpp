@@ -0,0 +1,172 @@
+#include <torch/csrc/jit/passes/frozen_graph_optimizations.h>
+
+#include <ATen/ATen.h>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/passes/constant_pooling.h>
+#include <torch/csrc/jit/passes/constant_propagation.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/packed_linear.h>
+#include <torch/csrc/jit/passes/quantization.h>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+const char* const conv1d_schema =
+    "aten::conv1d(Tensor input, Tensor weight, Tensor? bias=None, int[1] stride=1, int[1] padding=0, int[1] dilation=1, int groups=1) -> Tensor";
+const char* const conv2d_schema =
+    "aten::conv2d(Tensor input, Tensor weight, Tensor? bias=None, int[2] stride=1, int[2] padding=0, int[2] dilation=1, int groups=1) -> Tensor";
+const char* const conv3d_schema =
+    "aten::conv3d(Tensor input, Tensor weight, Tensor? bias=None, int[3] stride=1, int[3] padding=0, int[3] dilation=1, int groups=1) -> Tensor";
+const char* const linear_schema =
+    "aten::linear(Tensor input, Tensor weight, Tensor? bias=None) -> Tensor";
+const char* const batch_norm_schema =
+    "aten::batch_norm(Tensor input, Tensor? weight, Tensor? bias, Tensor? running_mean, Tensor? running_var, bool training, float momentum, float eps, bool cudnn_enabled) -> Tensor";
+
+c10::optional<at::Tensor> constantFloatingTensor(Value* v) {
+  auto ival = toIValue(v);
+  if (!ival || !ival->isTensor()) {
+    return c10::nullopt;
+  }
+  auto t = ival->toTensor();
+  if (!t.defined() || t.layout() != at::kStrided || !t.is_floating_point() ||
+      t.requires_grad()) {
+    return c10::nullopt;
+  }
+  return t;
+}
+
+bool isConstantNone(Value* v) {
+  auto ival = toIValue(v);
+  return ival && ival->isNone();
+}
+
+// The constant tensor v with the options of like, or a tensor of like's
+// shape filled with fill_value if v is None.
+c10::optional<at::Tensor> constantTensorOrFill(
+    Value* v,
+    const at::Tensor& like,
+    double fill_value) {
+  if (isConstantNone(v)) {
+    return at::full_like(like, fill_value);
+  }
+  auto t = constantFloatingTensor(v);
+  if (!t || !t->sizes().equals(like.sizes())) {
+    return c10::nullopt;
+  }
+  return t->to(like.options());
+}
+
+bool isConstantInt(Value* v, int64_t value) {
+  auto ival = toIValue(v);
+  return ival && ival->isInt() && ival->toInt() == value;
+}
+
+bool isKnown2D(Value* v) {
+  auto type = v->type()->cast<TensorType>();
+  if (type && type->dim() && *type->dim() == 2) {
+    return true;
+  }
+  // torch.flatten(x, 1) in front of a classifier
+  Node* n = v->node();
+  return n->kind() == aten::flatten && n->inputs().size() == 3 &&
+      isConstantInt(n->input(1), 1) && isConstantInt(n->input(2), -1);
+}
+
+bool isFoldableProducer(Node* n) {
+  if (n->matches(conv1d_schema) || n->matches(conv2d_schema) ||
+      n->matches(conv3d_schema)) {
+    return true;
+  }
+  return n->matches(linear_schema) && isKnown2D(n->input(0));
+}
+
+// Folds batch_norm(producer(x, W, b)) into producer(x, W * scale, b * scale +
+// shift), with y = x * scale + shift the batch norm in eval mode for every
+// channel. Returns false if the parameters of either node are not constants.
+bool foldBatchNorm(Graph* graph, Node* producer, Node* bn) {
+  auto training = toIValue(bn->namedInput(attr::training));
+  auto eps = toIValue(bn->namedInput(attr::eps));
+  if (!training || !training->isBool() || training->toBool() || !eps ||
+      !eps->isDouble()) {
+    return false;
+  }
+  auto weight = constantFloatingTensor(producer->namedInput(attr::weight));
+  if (!weight || weight->dim() < 2) {
+    return false;
+  }
+  const int64_t channels = weight->size(0);
+  auto running_mean = constantFloatingTensor(bn->input(3));
+  auto running_var = constantFloatingTensor(bn->input(4));
+  // Without running stats the batch norm normalizes with the statistics of
+  // its input even in eval mode.
+  if (!running_mean || !running_var || running_mean->dim() != 1 ||
+      running_mean->size(0) != channels ||
+      !running_var->sizes().equals(running_mean->sizes())) {
+    return false;
+  }
+  auto options = weight->options();
+  auto mean = running_mean->to(options);
+  auto var = running_var->to(options);
+  auto gamma = constantTensorOrFill(bn->input(1), mean, 1);
+  auto beta = constantTensorOrFill(bn->input(2), mean, 0);
+  auto bias = constantTensorOrFill(producer->input(2), mean, 0);
+  if (!gamma || !beta || !bias) {
+    return false;
+  }
+
+  auto scale = *gamma / at::sqrt(var + eps->toDouble());
+  auto shift = *beta - mean * scale;
+  std::vector<int64_t> scale_shape(weight->dim(), 1);
+  scale_shape[0] = channels;
+  WithInsertPoint guard(producer);
+  producer->replaceInput(
+      1, graph->insertConstant(*weight * scale.reshape(scale_shape)));
+  producer->replaceInput(2, graph->insertConstant(*bias * scale + shift));
+  bn->output()->replaceAllUsesWith(producer->output());
+  return true;
+}
+
+void FoldFrozenBatchNorm(Graph* graph, Block* block) {
+  for (auto it = block->nodes().begin(); it != block->nodes().end();) {
+    Node* n = *it++;
+    for (Block* sub : n->blocks()) {
+      FoldFrozenBatchNorm(graph, sub);
+    }
+    if (!n->matches(batch_norm_schema)) {
+      continue;
+    }
+    Value* input = n->input(0);
+    if (input->uses().size() != 1 || !isFoldableProducer(input->node())) {
+      continue;
+    }
+    if (foldBatchNorm(graph, input->node(), n)) {
+      n->destroy();
+    }
+  }
+}
+
+} // namespace
+
+void FoldFrozenBatchNorm(std::shared_ptr<Graph>& graph) {
+  FoldFrozenBatchNorm(graph.get(), graph->block());
+  EliminateDeadCode(graph);
+}
+
+void OptimizeFrozenGraph(std::shared_ptr<Graph>& graph) {
+  FoldFrozenBatchNorm(graph);
+  ConstantPropagation(graph);
+  ConstantPooling(graph);
+  EliminateDeadCode(graph);
+}
+
+void OptimizeFrozenModule(script::Module& module) {
+  auto graph = module.get_method("forward").graph();
+  OptimizeFrozenGraph(graph);
+  FoldQuantizedPrepackingOps(module);
+  PackLinearWeights(module);
+}
+
+} // namespace jit
+} // namespace torch
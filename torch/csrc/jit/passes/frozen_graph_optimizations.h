@@ -0,0 +1,31 @@
+#pragma once
+
+#include <torch/csrc/jit/api/module.h>
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Folds the aten::batch_norm nodes in eval mode whose parameters are
+// constants into the constant weight and bias of the aten::conv1d,
+// aten::conv2d, aten::conv3d or aten::linear node that produces their input,
+// when the batch norm is the only use of its output. A linear layer is only
+// folded when its input is known to be 2D, so that the channels of the batch
+// norm are the output features of the layer.
+TORCH_API void FoldFrozenBatchNorm(std::shared_ptr<Graph>& graph);
+
+// Runs FoldFrozenBatchNorm and precomputes the subexpressions of a frozen
+// graph that only depend on its constants, e.g. the transposes of weights.
+TORCH_API void OptimizeFrozenGraph(std::shared_ptr<Graph>& graph);
+
+// Runs OptimizeFrozenGraph on the forward method of a frozen module and
+// prepacks its weights once for the active backend: the quantized prepacks
+// for the engine of at::globalContext().qEngine() (FBGEMM or QNNPACK) and the
+// float linear layers with PackLinearWeights are folded into attributes of
+// the module. The module can still be serialized afterwards; the conversion
+// to the MKLDNN layout, whose constants cannot, is left to
+// ConvertFrozenOpsToMKLDNN.
+TORCH_API void OptimizeFrozenModule(script::Module& module);
+
+} // namespace jit
+} // namespace torch
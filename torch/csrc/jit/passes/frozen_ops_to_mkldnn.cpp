@@ -0,0 +1,348 @@
+#include <torch/csrc/jit/passes/frozen_ops_to_mkldnn.h>
+
+#include <ATen/ATen.h>
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+
+#include <algorithm>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+c10::optional<at::Tensor> constantFloatTensor(Value* v, int64_t dim) {
+  auto ival = toIValue(v);
+  if (!ival || !ival->isTensor()) {
+    return c10::nullopt;
+  }
+  auto t = ival->toTensor();
+  if (!t.defined() || !t.device().is_cpu() || t.layout() != at::kStrided ||
+      t.scalar_type() != at::kFloat || t.dim() != dim || t.requires_grad()) {
+    return c10::nullopt;
+  }
+  return t;
+}
+
+bool isConstantNone(Value* v) {
+  auto ival = toIValue(v);
+  return ival && ival->isNone();
+}
+
+bool isConstantNoneOrFloatTensor(Value* v, int64_t dim) {
+  return isConstantNone(v) || constantFloatTensor(v, dim);
+}
+
+c10::optional<std::vector<int64_t>> constantIntList(Value* v) {
+  auto ival = toIValue(v);
+  if (!ival || !ival->isIntList()) {
+    return c10::nullopt;
+  }
+  return ival->toIntVector();
+}
+
+const char* const conv2d_schema =
+    "aten::conv2d(Tensor input, Tensor weight, Tensor? bias=None, int[2] stride=1, int[2] padding=0, int[2] dilation=1, int groups=1) -> Tensor";
+const char* const linear_schema =
+    "aten::linear(Tensor input, Tensor weight, Tensor? bias=None) -> Tensor";
+const char* const batch_norm_schema =
+    "aten::batch_norm(Tensor input, Tensor? weight, Tensor? bias, Tensor? running_mean, Tensor? running_var, bool training, float momentum, float eps, bool cudnn_enabled) -> Tensor";
+const char* const max_pool2d_schema =
+    "aten::max_pool2d(Tensor self, int[2] kernel_size, int[2] stride=[], int[2] padding=0, int[2] dilation=1, bool ceil_mode=False) -> Tensor";
+const char* const avg_pool2d_schema =
+    "aten::avg_pool2d(Tensor self, int[2] kernel_size, int[2] stride=[], int[2] padding=0, bool ceil_mode=False, bool count_include_pad=True, int? divisor_override=None) -> Tensor";
+const char* const adaptive_avg_pool2d_schema =
+    "aten::adaptive_avg_pool2d(Tensor self, int[2] output_size) -> Tensor";
+const char* const relu_schema = "aten::relu(Tensor self) -> Tensor";
+const char* const relu__schema = "aten::relu_(Tensor(a!) self) -> Tensor(a!)";
+
+class MKLDNNLayoutPropagation {
+ public:
+  explicit MKLDNNLayoutPropagation(std::shared_ptr<Graph> graph)
+      : graph_(std::move(graph)), alias_db_(graph_) {}
+
+  void run() {
+    collectNodes(graph_->block());
+    selectBlock(graph_->block());
+    if (selected_.empty()) {
+      return;
+    }
+    for (Node* n : order_) {
+      convertNode(n);
+    }
+    insertDenseConversions();
+    EliminateDeadCode(graph_);
+  }
+
+ private:
+  void collectNodes(Block* block) {
+    for (Node* n : block->nodes()) {
+      all_nodes_.push_back(n);
+      for (Block* sub_block : n->blocks()) {
+        collectNodes(sub_block);
+      }
+    }
+  }
+
+  // The rank of an activation if it is known, from the outputs of the
+  // selected nodes or the type of the value.
+  c10::optional<int64_t> rankOf(Value* v) const {
+    auto it = rank_.find(v);
+    if (it != rank_.end()) {
+      return it->second;
+    }
+    auto type = v->type()->cast<TensorType>();
+    if (!type || !type->dim()) {
+      return c10::nullopt;
+    }
+    return static_cast<int64_t>(*type->dim());
+  }
+
+  bool isMKLDNN(Value* v) const {
+    return rank_.count(v);
+  }
+
+  // The rank of the output of n if n can run on MKLDNN tensors. The nodes
+  // with constant parameters start a chain, the others only extend one.
+  c10::optional<int64_t> outputRank(Node* n) const {
+    if (n->matches(conv2d_schema)) {
+      auto groups = toIValue(n->namedInput(attr::groups));
+      if (!constantFloatTensor(n->namedInput(attr::weight), 4) ||
+          !isConstantNoneOrFloatTensor(n->namedInput(attr::bias), 1) ||
+          !constantIntList(n->namedInput(attr::stride)) ||
+          !constantIntList(n->namedInput(attr::padding)) ||
+          !constantIntList(n->namedInput(attr::dilation)) || !groups ||
+          !groups->isInt()) {
+        return c10::nullopt;
+      }
+      return 4;
+    }
+    if (n->matches(linear_schema)) {
+      auto rank = rankOf(n->namedInput(attr::input));
+      if (!rank || *rank < 2 ||
+          !constantFloatTensor(n->namedInput(attr::weight), 2) ||
+          !isConstantNoneOrFloatTensor(n->namedInput(attr::bias), 1)) {
+        return c10::nullopt;
+      }
+      return rank;
+    }
+    if (n->matches(batch_norm_schema)) {
+      auto rank = rankOf(n->namedInput(attr::input));
+      auto training = toIValue(n->namedInput(attr::training));
+      if (!rank || (*rank != 4 && *rank != 5) || !training ||
+          !training->isBool() || training->toBool() ||
+          !isConstantNoneOrFloatTensor(n->namedInput(attr::weight), 1) ||
+          !isConstantNoneOrFloatTensor(n->namedInput(attr::bias), 1) ||
+          !constantFloatTensor(n->namedInput(attr::running_mean), 1) ||
+          !constantFloatTensor(n->namedInput(attr::running_var), 1)) {
+        return c10::nullopt;
+      }
+      return rank;
+    }
+    if (!isMKLDNN(n->input(0))) {
+      return c10::nullopt;
+    }
+    const int64_t rank = rank_.at(n->input(0));
+    if (n->matches(relu_schema) || n->matches(relu__schema)) {
+      return rank;
+    }
+    if (rank != 4) {
+      return c10::nullopt;
+    }
+    if (n->matches(max_pool2d_schema)) {
+      return rank;
+    }
+    if (n->matches(avg_pool2d_schema)) {
+      if (!isConstantNone(n->namedInput(attr::divisor_override))) {
+        return c10::nullopt;
+      }
+      return rank;
+    }
+    if (n->matches(adaptive_avg_pool2d_schema)) {
+      // MKLDNN pools to output sizes that divide the input sizes only, the
+      // global pooling to 1x1 is always supported.
+      auto output_size = toIValue(n->namedInput(attr::output_size));
+      if (!output_size) {
+        return c10::nullopt;
+      }
+      if (output_size->isInt()) {
+        return output_size->toInt() == 1 ? c10::make_optional(rank)
+                                         : c10::nullopt;
+      }
+      const auto sizes = constantIntList(n->namedInput(attr::output_size));
+      if (!sizes ||
+          !std::all_of(sizes->begin(), sizes->end(), [](int64_t size) {
+            return size == 1;
+          })) {
+        return c10::nullopt;
+      }
+      return rank;
+    }
+    return c10::nullopt;
+  }
+
+  // The output of n is converted to a dense tensor before its uses outside
+  // of the chain, which would lose the writes to it through the aliases the
+  // dense copy does not have. Only the in-place relus of the chain may
+  // write to the output.
+  bool outputIsSafe(Node* n) const {
+    Value* output = n->output();
+    if (!alias_db_.hasWriters(output)) {
+      return true;
+    }
+    std::vector<Value*> aliases{output};
+    std::unordered_set<Node*> relus;
+    if (n->matches(relu__schema)) {
+      relus.insert(n);
+    }
+    for (size_t i = 0; i < aliases.size(); ++i) {
+      for (const Use& use : aliases[i]->uses()) {
+        if (use.user->matches(relu__schema)) {
+          relus.insert(use.user);
+          aliases.push_back(use.user->output());
+        }
+      }
+    }
+    for (Node* m : all_nodes_) {
+      if (!relus.count(m) && alias_db_.writesToAlias(m, {output})) {
+        return false;
+      }
+    }
+    for (Value* alias : aliases) {
+      for (const Use& use : alias->uses()) {
+        if (relus.count(use.user)) {
+          continue;
+        }
+        for (Value* user_output : use.user->outputs()) {
+          if (alias_db_.mayContainAlias(user_output, output)) {
+            return false;
+          }
+        }
+      }
+    }
+    return true;
+  }
+
+  void selectBlock(Block* block) {
+    for (Node* n : block->nodes()) {
+      for (Block* sub_block : n->blocks()) {
+        selectBlock(sub_block);
+      }
+      auto rank = outputRank(n);
+      if (rank && outputIsSafe(n)) {
+        selected_.insert(n);
+        order_.push_back(n);
+        rank_[n->output()] = *rank;
+      }
+    }
+  }
+
+  Value* insertMKLDNNConstant(const at::Tensor& t) {
+    return graph_->insertConstant(t.to_mkldnn());
+  }
+
+  void replaceWithMKLDNNConstant(Node* n, size_t index) {
+    n->replaceInput(
+        index, insertMKLDNNConstant(toIValue(n->input(index))->toTensor()));
+  }
+
+  void convertNode(Node* n) {
+    WithInsertPoint guard(n);
+    Value* input = n->input(0);
+    if (!isMKLDNN(input)) {
+      Node* to_mkldnn = graph_->create(Symbol::aten("to_mkldnn"), {input});
+      to_mkldnn->insertBefore(n);
+      to_mkldnn->output()->setType(TensorType::get());
+      n->replaceInput(0, to_mkldnn->output());
+    }
+    if (n->matches(conv2d_schema)) {
+      // The weight is reordered once for the blocked format the convolution
+      // expects, instead of on every call.
+      auto weight = toIValue(n->namedInput(attr::weight))->toTensor();
+      auto stride = constantIntList(n->namedInput(attr::stride)).value();
+      auto padding = constantIntList(n->namedInput(attr::padding)).value();
+      auto dilation = constantIntList(n->namedInput(attr::dilation)).value();
+      auto groups = toIValue(n->namedInput(attr::groups))->toInt();
+      n->replaceInput(
+          1,
+          graph_->insertConstant(at::mkldnn_reorder_conv2d_weight(
+              weight.to_mkldnn(), padding, stride, dilation, groups)));
+      if (!isConstantNone(n->input(2))) {
+        replaceWithMKLDNNConstant(n, 2);
+      }
+    } else if (n->matches(linear_schema)) {
+      // mkldnn_linear expects a bias in the MKLDNN layout.
+      auto weight = toIValue(n->namedInput(attr::weight))->toTensor();
+      replaceWithMKLDNNConstant(n, 1);
+      if (isConstantNone(n->input(2))) {
+        n->replaceInput(
+            2,
+            insertMKLDNNConstant(
+                at::zeros({weight.size(0)}, weight.options())));
+      } else {
+        replaceWithMKLDNNConstant(n, 2);
+      }
+    } else if (n->matches(batch_norm_schema)) {
+      // mkldnn_batch_norm expects all of the parameters in the MKLDNN layout.
+      auto running_mean =
+          toIValue(n->namedInput(attr::running_mean))->toTensor();
+      if (isConstantNone(n->input(1))) {
+        n->replaceInput(1, insertMKLDNNConstant(at::ones_like(running_mean)));
+      } else {
+        replaceWithMKLDNNConstant(n, 1);
+      }
+      if (isConstantNone(n->input(2))) {
+        n->replaceInput(2, insertMKLDNNConstant(at::zeros_like(running_mean)));
+      } else {
+        replaceWithMKLDNNConstant(n, 2);
+      }
+      replaceWithMKLDNNConstant(n, 3);
+      replaceWithMKLDNNConstant(n, 4);
+    }
+    // The MKLDNN tensors have no strides
+    dense_types_[n->output()] = n->output()->type();
+    n->output()->setType(TensorType::get());
+  }
+
+  void insertDenseConversions() {
+    for (Node* n : order_) {
+      Value* output = n->output();
+      const auto uses = output->uses();
+      for (const Use& use : uses) {
+        if (selected_.count(use.user)) {
+          continue;
+        }
+        Node* to_dense = graph_->create(aten::to_dense, {output});
+        to_dense->insertBefore(use.user);
+        to_dense->output()->setType(dense_types_.at(output));
+        use.user->replaceInput(use.offset, to_dense->output());
+      }
+    }
+  }
+
+  std::shared_ptr<Graph> graph_;
+  AliasDb alias_db_;
+  std::vector<Node*> all_nodes_;
+  std::vector<Node*> order_;
+  std::unordered_set<Node*> selected_;
+  std::unordered_map<Value*, int64_t> rank_;
+  std::unordered_map<Value*, TypePtr> dense_types_;
+};
+
+} // namespace
+
+void ConvertFrozenOpsToMKLDNN(std::shared_ptr<Graph>& graph) {
+  if (!at::hasMKLDNN() || !at::globalContext().userEnabledMkldnn()) {
+    return;
+  }
+  MKLDNNLayoutPropagation(graph).run();
+}
+
+void ConvertFrozenOpsToMKLDNN(script::Module& module) {
+  auto graph = module.get_method("forward").graph();
+  ConvertFrozenOpsToMKLDNN(graph);
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <torch/csrc/jit/api/module.h>
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Runs the convolutions, linear layers, batch norms, pools and relus of a
+// frozen graph on MKLDNN tensors. The aten::conv2d, aten::linear and
+// aten::batch_norm nodes whose parameters are constant float CPU tensors have
+// them replaced with constants in the MKLDNN layout (the convolution weights
+// reordered to the blocked format of the convolution), and the maximal chains
+// of such nodes, extended with the pools and relus that consume their
+// outputs, keep their activations as MKLDNN tensors. The activations are
+// converted with aten::to_mkldnn where they enter a chain and with
+// aten::to_dense before every use outside of it.
+//
+// The MKLDNN constants cannot be serialized, so the pass is meant to be run
+// on a frozen module right before it is used for inference. It does nothing
+// when ATen is built without MKLDNN or MKLDNN is disabled.
+TORCH_API void ConvertFrozenOpsToMKLDNN(std::shared_ptr<Graph>& graph);
+
+// Runs ConvertFrozenOpsToMKLDNN on the forward method of a frozen module.
+TORCH_API void ConvertFrozenOpsToMKLDNN(script::Module& module);
+
+} // namespace jit
+} // namespace torch
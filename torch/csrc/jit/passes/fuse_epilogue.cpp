@@ -0,0 +1,48 @@
+#include <torch/csrc/jit/passes/fuse_epilogue.h>
+#include <torch/csrc/jit/passes/subgraph_rewrite.h>
+
+namespace torch {
+namespace jit {
+
+void FuseConvLinearEpilogue(std::shared_ptr<Graph>& graph) {
+  std::string conv2d_relu_pattern = R"IR(
+    graph(%input, %weight, %bias, %stride, %padding, %dilation, %groups):
+        %output = aten::conv2d(%input, %weight, %bias, %stride, %padding, %dilation, %groups)
+        %res = aten::relu(%output)
+        return (%res))IR";
+  std::string conv2d_relu_inplace_pattern = R"IR(
+    graph(%input, %weight, %bias, %stride, %padding, %dilation, %groups):
+        %output = aten::conv2d(%input, %weight, %bias, %stride, %padding, %dilation, %groups)
+        %res = aten::relu_(%output)
+        return (%res))IR";
+  std::string fused_conv2d_relu = R"IR(
+    graph(%input, %weight, %bias, %stride, %padding, %dilation, %groups):
+        %res = aten::_conv2d_relu(%input, %weight, %bias, %stride, %padding, %dilation, %groups)
+        return (%res))IR";
+
+  std::string linear_relu_pattern = R"IR(
+    graph(%input, %weight, %bias):
+        %output = aten::linear(%input, %weight, %bias)
+        %res = aten::relu(%output)
+        return (%res))IR";
+  std::string linear_relu_inplace_pattern = R"IR(
+    graph(%input, %weight, %bias):
+        %output = aten::linear(%input, %weight, %bias)
+        %res = aten::relu_(%output)
+        return (%res))IR";
+  std::string fused_linear_relu = R"IR(
+    graph(%input, %weight, %bias):
+        %res = aten::_linear_relu(%input, %weight, %bias)
+        return (%res))IR";
+
+  SubgraphRewriter rewriter;
+  rewriter.RegisterRewritePattern(conv2d_relu_pattern, fused_conv2d_relu);
+  rewriter.RegisterRewritePattern(
+      conv2d_relu_inplace_pattern, fused_conv2d_relu);
+  rewriter.RegisterRewritePattern(linear_relu_pattern, fused_linear_relu);
+  rewriter.RegisterRewritePattern(
+      linear_relu_inplace_pattern, fused_linear_relu);
+  rewriter.runOnGraph(graph);
+}
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,22 @@
+/** \brief Fusing elementwise epilogues into the convolution or linear op that
+ * produces their input
+ */
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+/** \brief Replace aten::conv2d and aten::linear followed by aten::relu (or
+ * aten::relu_) with aten::_conv2d_relu and aten::_linear_relu.
+ *
+ * The fused ops apply the relu inside the backend kernel where one supports
+ * it (mkldnn post-ops, xnnpack output clamps) and fall back to an in-place
+ * relu on the output otherwise, so the rewrite never needs device information.
+ * The rewrite only applies when the relu is the only use of the conv/linear
+ * output.
+ */
+TORCH_API void FuseConvLinearEpilogue(std::shared_ptr<Graph>& graph);
+} // namespace jit
+} // namespace torch
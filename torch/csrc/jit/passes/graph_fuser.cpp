@@ -14,6 +14,7 @@
 
 #include <queue>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace torch {
 namespace jit {
@@ -1124,6 +1125,102 @@ struct GraphFuser {
     }
   }
 
+  // A fusion group computes all of its outputs in one loop over the "map
+  // size", the size the inputs are broadcast to. Sibling groups can only be
+  // packed into one kernel if they have the same map size, which we can prove
+  // if
+  // - all of their outputs have the same complete sizes, or
+  // - they read the same tensors, none of which are chunked (each group passes
+  //   the fuser's runtime check only if all of its outputs have the size of
+  //   its inputs broadcast together).
+  bool haveSameMapSize(Node* a, Node* b) {
+    for (Node* group : {a, b}) {
+      for (Node* n : getSubgraph(group).nodes()) {
+        if (n->kind() == prim::FusedConcat) {
+          return false;
+        }
+      }
+    }
+
+    auto first = a->outputs().at(0)->type()->cast<TensorType>();
+    bool same_sizes =
+        first && first->device() && first->sizes().concrete_sizes();
+    for (Node* group : {a, b}) {
+      for (Value* output : group->outputs()) {
+        auto type = output->type()->cast<TensorType>();
+        same_sizes = same_sizes && type && type->device() == first->device() &&
+            type->sizes().concrete_sizes() == first->sizes().concrete_sizes();
+      }
+    }
+    if (same_sizes) {
+      return true;
+    }
+
+    for (Node* group : {a, b}) {
+      for (Node* n : getSubgraph(group).nodes()) {
+        if (n->kind() == prim::ConstantChunk) {
+          return false;
+        }
+      }
+    }
+    auto a_inputs = tensorInputs(a);
+    auto b_inputs = tensorInputs(b);
+    std::unordered_set<Value*> a_set(a_inputs.begin(), a_inputs.end());
+    std::unordered_set<Value*> b_set(b_inputs.begin(), b_inputs.end());
+    return !a_set.empty() && a_set == b_set;
+  }
+
+  // Tries to merge two independent fusion groups (a before b) into one group
+  // with the outputs of both, so that they run as a single kernel.
+  bool tryFuseHorizontally(Node* a, Node* b) {
+    for (Value* input : b->inputs()) {
+      if (input->node() == a) {
+        return false;
+      }
+    }
+    std::unordered_set<Value*> inputs(a->inputs().begin(), a->inputs().end());
+    inputs.insert(b->inputs().begin(), b->inputs().end());
+    if (inputs.size() + a->outputs().size() + b->outputs().size() >
+        subgraph_arg_limit_) {
+      return false;
+    }
+    if (!haveSameMapSize(a, b)) {
+      return false;
+    }
+
+    // mergeFusionGroups expects nothing to use a's outputs before b
+    if (a->next() != b && aliasDb_->couldMoveBeforeTopologically(a, b)) {
+      aliasDb_->moveBeforeTopologicallyValid(a, b);
+    }
+    if (a->next() != b && aliasDb_->couldMoveAfterTopologically(b, a)) {
+      aliasDb_->moveAfterTopologicallyValid(b, a);
+    }
+    if (a->next() != b) {
+      return false;
+    }
+    mergeFusionGroups(b, a);
+    return true;
+  }
+
+  // Packs sibling fusion groups, e.g. the identical elementwise chains of
+  // the heads of a multi-head model, into fewer kernels. Every group is
+  // merged into the first compatible group after it.
+  void fuseHorizontally() {
+    std::vector<Node*> groups;
+    for (Node* n : block_->nodes()) {
+      if (n->kind() == prim::FusionGroup) {
+        groups.push_back(n);
+      }
+    }
+    for (size_t i = 0; i < groups.size(); ++i) {
+      for (size_t j = i + 1; j < groups.size(); ++j) {
+        if (tryFuseHorizontally(groups[i], groups[j])) {
+          break;
+        }
+      }
+    }
+  }
+
   void optimizeFusedGraphs() {
     for (Node* node : block_->nodes()) {
       if (node->kind() != prim::FusionGroup) {
@@ -1165,6 +1262,10 @@ struct GraphFuser {
 
     fuseConcats();
 
+    if (kind_ == prim::FusionGroup) {
+      fuseHorizontally();
+    }
+
     optimizeFusedGraphs();
 
     // The graph fuser can add intermediate prim::BroadcastingChunk nodes.
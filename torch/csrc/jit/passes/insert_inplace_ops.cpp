@@ -0,0 +1,177 @@
+#include <torch/csrc/jit/passes/insert_inplace_ops.h>
+
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/ir/constants.h>
+
+#include <algorithm>
+
+namespace torch {
+namespace jit {
+namespace {
+
+// The ops whose result always has the shape and dtype of their input.
+const std::vector<const char*> unary_ops = {
+    "aten::relu(Tensor self) -> Tensor",
+    "aten::sigmoid(Tensor self) -> Tensor",
+    "aten::tanh(Tensor self) -> Tensor",
+    "aten::hardtanh(Tensor self, Scalar min_val=-1, Scalar max_val=1) -> Tensor",
+    "aten::leaky_relu(Tensor self, Scalar negative_slope=0.01) -> Tensor"};
+
+// The ops whose result broadcasts and type promotes their operands. They are
+// only rewritten if the types of the graph show that the result has the
+// shape and dtype of the operand that is overwritten.
+const std::vector<const char*> binary_tensor_ops = {
+    "aten::add.Tensor(Tensor self, Tensor other, *, Scalar alpha=1) -> Tensor",
+    "aten::sub.Tensor(Tensor self, Tensor other, *, Scalar alpha=1) -> Tensor",
+    "aten::mul.Tensor(Tensor self, Tensor other) -> Tensor",
+    "aten::div.Tensor(Tensor self, Tensor other) -> Tensor"};
+const std::vector<const char*> binary_scalar_ops = {
+    "aten::add.Scalar(Tensor self, Scalar other, Scalar alpha=1) -> Tensor",
+    "aten::sub.Scalar(Tensor self, Scalar other, Scalar alpha=1) -> Tensor",
+    "aten::mul.Scalar(Tensor self, Scalar other) -> Tensor",
+    "aten::div.Scalar(Tensor self, Scalar other) -> Tensor"};
+
+bool matchesAny(const Node* n, const std::vector<const char*>& schemas) {
+  return std::any_of(schemas.begin(), schemas.end(), [n](const char* schema) {
+    return n->matches(schema);
+  });
+}
+
+bool hasSameShapeAndDtype(const Value* a, const Value* b) {
+  auto a_type = a->type()->cast<TensorType>();
+  auto b_type = b->type()->cast<TensorType>();
+  if (!a_type || !b_type || !a_type->scalarType() ||
+      a_type->scalarType() != b_type->scalarType()) {
+    return false;
+  }
+  auto a_sizes = a_type->sizes().concrete_sizes();
+  return a_sizes && a_sizes == b_type->sizes().concrete_sizes();
+}
+
+bool hasFloatingDtype(const Value* v) {
+  auto type = v->type()->cast<TensorType>();
+  return type && type->scalarType() && isFloatingType(*type->scalarType());
+}
+
+class InplaceOpsInserter {
+ public:
+  explicit InplaceOpsInserter(std::shared_ptr<Graph> graph)
+      : graph_(std::move(graph)), alias_db_(graph_) {}
+
+  // The output of a rewritten node keeps the aliasing of the out-of-place
+  // output in the AliasDb, although it now aliases the input of the node. The
+  // input has no uses after the node, so the later checks that could involve
+  // it are still answered correctly by the aliasing of the original graph.
+  void run() {
+    run(graph_->block());
+  }
+
+ private:
+  void run(Block* block) {
+    for (auto it = block->nodes().begin(); it != block->nodes().end();) {
+      Node* n = *it++;
+      for (Block* sub : n->blocks()) {
+        run(sub);
+      }
+      if (matchesAny(n, unary_ops)) {
+        if (isDeadAfter(n->input(0), n)) {
+          replaceWithInplace(n, /*swap_operands=*/false);
+        }
+      } else if (matchesAny(n, binary_tensor_ops)) {
+        if (hasSameShapeAndDtype(n->input(0), n->output()) &&
+            isDeadAfter(n->input(0), n)) {
+          replaceWithInplace(n, /*swap_operands=*/false);
+        } else if (
+            isCommutative(n) &&
+            hasSameShapeAndDtype(n->input(1), n->output()) &&
+            isDeadAfter(n->input(1), n)) {
+          replaceWithInplace(n, /*swap_operands=*/true);
+        }
+      } else if (matchesAny(n, binary_scalar_ops)) {
+        // A floating point tensor is not promoted by a scalar operand.
+        if (hasFloatingDtype(n->input(0)) && isDeadAfter(n->input(0), n)) {
+          replaceWithInplace(n, /*swap_operands=*/false);
+        }
+      }
+    }
+  }
+
+  static bool isCommutative(Node* n) {
+    if (n->kind() == aten::mul) {
+      return true;
+    }
+    if (n->kind() != aten::add) {
+      return false;
+    }
+    auto alpha = toIValue(n->namedInput(attr::alpha));
+    return alpha && alpha->isInt() && alpha->toInt() == 1;
+  }
+
+  // Whether the memory of v can be overwritten by n: v and every value that
+  // may alias it is an intermediate of the block of n whose uses are all at
+  // or before n.
+  bool isDeadAfter(Value* v, Node* n) {
+    Block* block = n->owningBlock();
+    if (v->node()->owningBlock() != block ||
+        v->node()->kind() == prim::Constant ||
+        v->node()->kind() == prim::GetAttr ||
+        alias_db_.escapesScope({v})) {
+      return false;
+    }
+    for (Value* input : block->inputs()) {
+      if (alias_db_.mayContainAlias(input, v)) {
+        return false;
+      }
+    }
+    for (Node* m : block->nodes()) {
+      if (m == n) {
+        break;
+      }
+      for (Value* output : m->outputs()) {
+        if (!alias_db_.mayContainAlias(output, v)) {
+          continue;
+        }
+        if (m->kind() == prim::Constant || m->kind() == prim::GetAttr) {
+          return false;
+        }
+        for (const Use& use : output->uses()) {
+          if (use.user != n && !use.user->isBefore(n)) {
+            return false;
+          }
+        }
+      }
+    }
+    return true;
+  }
+
+  void replaceWithInplace(Node* n, bool swap_operands) {
+    auto inplace_kind =
+        Symbol::fromQualString(std::string(n->kind().toQualString()) + "_");
+    Node* inplace = graph_->create(inplace_kind, 0);
+    inplace->insertBefore(n);
+    inplace->setScope(n->scope());
+    for (Value* input : n->inputs()) {
+      inplace->addInput(input);
+    }
+    if (swap_operands) {
+      inplace->replaceInput(0, n->input(1));
+      inplace->replaceInput(1, n->input(0));
+    }
+    inplace->addOutput()->copyMetadata(n->output());
+    n->output()->replaceAllUsesWith(inplace->output());
+    alias_db_.replaceWithNewValue(n->output(), inplace->output());
+    n->destroy();
+  }
+
+  std::shared_ptr<Graph> graph_;
+  AliasDb alias_db_;
+};
+
+} // namespace
+
+void InsertInplaceOps(const std::shared_ptr<Graph>& graph) {
+  InplaceOpsInserter(graph).run();
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+#include <memory>
+
+namespace torch {
+namespace jit {
+
+// Rewrites out-of-place elementwise ops such as aten::relu, aten::add and
+// aten::mul to their in-place variants when the tensor they would overwrite
+// is an intermediate of the graph that is dead after the op, i.e. it neither
+// aliases a graph input, output or constant nor has aliases that are used
+// later. The opposite of RemoveInplaceOps; see .cpp for the exact conditions.
+//
+// The in-place ops save an allocation per op, but they do not record what
+// autograd needs, so the pass is only meant for graphs that run without
+// gradients, such as frozen modules used for inference.
+TORCH_API void InsertInplaceOps(const std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,180 @@
+#include <torch/csrc/jit/passes/memory_planning.h>
+
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/jit_log.h>
+
+#include <algorithm>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// same as the alignment of the default CPU allocator
+constexpr size_t kSlabAlignment = 64;
+
+size_t alignUp(size_t nbytes) {
+  return (nbytes + kSlabAlignment - 1) / kSlabAlignment * kSlabAlignment;
+}
+
+// The number of bytes the allocator is asked for when a tensor of this type
+// is created, if it is statically known.
+c10::optional<size_t> staticStorageBytes(const TypePtr& type) {
+  auto tensor_type = type->cast<TensorType>();
+  if (!tensor_type) {
+    return c10::nullopt;
+  }
+  auto sizes = tensor_type->sizes().concrete_sizes();
+  auto scalar_type = tensor_type->scalarType();
+  auto device = tensor_type->device();
+  if (!sizes || !scalar_type || !device || !device->is_cpu()) {
+    return c10::nullopt;
+  }
+  auto strides = tensor_type->strides().concrete_sizes();
+  int64_t elements = 1;
+  for (size_t i = 0; i < sizes->size(); ++i) {
+    const int64_t size = (*sizes)[i];
+    if (size == 0) {
+      // empty tensors do not allocate
+      return c10::nullopt;
+    }
+    elements = strides ? elements + (size - 1) * (*strides)[i]
+                       : elements * size;
+  }
+  return elements * c10::elementSize(*scalar_type);
+}
+
+struct PlannedValue {
+  Value* value;
+  size_t size; // exact bytes
+  size_t begin; // index of the producing node
+  size_t end; // index of the last node using the value or an alias of it
+  size_t offset = 0;
+};
+
+bool overlaps(const PlannedValue& a, const PlannedValue& b) {
+  return a.begin <= b.end && b.begin <= a.end;
+}
+
+} // namespace
+
+c10::optional<MemoryPlan> PlanStaticMemory(
+    const std::shared_ptr<Graph>& graph) {
+  std::unordered_map<const Node*, size_t> node_index;
+  for (Node* node : graph->nodes()) {
+    if (!node->blocks().empty() || node->kind() == prim::fork ||
+        node->kind() == aten::wait) {
+      GRAPH_DEBUG("Not planning memory of a graph with ", *node);
+      return c10::nullopt;
+    }
+    node_index[node] = node_index.size();
+  }
+  node_index[graph->return_node()] = node_index.size();
+
+  AliasDb alias_db(graph);
+  std::vector<Value*> all_values;
+  for (Node* node : graph->nodes()) {
+    for (Value* output : node->outputs()) {
+      all_values.push_back(output);
+    }
+  }
+
+  std::vector<PlannedValue> planned;
+  for (Node* node : graph->nodes()) {
+    if (node->kind() == prim::Constant) {
+      continue;
+    }
+    const size_t first = planned.size();
+    bool plan_node = true;
+    for (Value* output : node->outputs()) {
+      if (!AliasDb::isMutableType(output)) {
+        continue;
+      }
+      auto size = staticStorageBytes(output->type());
+      if (!size || alias_db.mayContainAlias(output, graph->outputs()) ||
+          alias_db.mayContainAlias(output, graph->inputs()) ||
+          alias_db.mayContainAlias(output, node->inputs())) {
+        // The allocator only sees sizes, so an output left to the regular
+        // allocator could take the slab of a planned sibling of the same
+        // size and be overwritten by the next run while it is still used.
+        plan_node = false;
+        break;
+      }
+      size_t end = node_index.at(node);
+      for (Value* other : all_values) {
+        if (other != output && !alias_db.mayContainAlias(output, other)) {
+          continue;
+        }
+        for (const Use& use : other->uses()) {
+          end = std::max(end, node_index.at(use.user));
+        }
+      }
+      planned.push_back({output, *size, node_index.at(node), end});
+    }
+    if (!plan_node) {
+      planned.resize(first);
+      continue;
+    }
+    // A node may allocate its outputs in any order, so they all live as
+    // long as the longest-lived one.
+    size_t end = 0;
+    for (size_t i = first; i < planned.size(); ++i) {
+      end = std::max(end, planned[i].end);
+    }
+    for (size_t i = first; i < planned.size(); ++i) {
+      planned[i].end = end;
+    }
+  }
+  if (planned.empty()) {
+    return c10::nullopt;
+  }
+
+  std::vector<PlannedValue*> order;
+  for (auto& p : planned) {
+    order.push_back(&p);
+  }
+  std::stable_sort(
+      order.begin(), order.end(), [](PlannedValue* a, PlannedValue* b) {
+        return a->size > b->size;
+      });
+
+  MemoryPlan plan;
+  std::vector<PlannedValue*> placed;
+  for (PlannedValue* p : order) {
+    std::vector<PlannedValue*> conflicts;
+    for (PlannedValue* q : placed) {
+      if (overlaps(*p, *q)) {
+        conflicts.push_back(q);
+      }
+    }
+    std::sort(
+        conflicts.begin(),
+        conflicts.end(),
+        [](PlannedValue* a, PlannedValue* b) { return a->offset < b->offset; });
+    // lowest offset at which p fits between the slabs it must not overlap
+    size_t offset = 0;
+    for (PlannedValue* q : conflicts) {
+      if (offset + alignUp(p->size) <= q->offset) {
+        break;
+      }
+      offset = std::max(offset, q->offset + alignUp(q->size));
+    }
+    p->offset = offset;
+    plan.arena_size = std::max(plan.arena_size, offset + alignUp(p->size));
+    placed.push_back(p);
+  }
+
+  for (const auto& p : planned) {
+    plan.node_slabs[p.value->node()].push_back({p.offset, p.size});
+  }
+  GRAPH_DEBUG(
+      "Planned ",
+      planned.size(),
+      " tensors in an arena of ",
+      plan.arena_size,
+      " bytes");
+  return plan;
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+// A static memory plan for a straight-line graph, such as a frozen and
+// inlined inference graph whose intermediate tensors have complete types.
+// Every planned tensor gets a slab of a single arena; tensors whose live
+// ranges overlap never share memory, so the arena is usually much smaller
+// than the sum of the tensors.
+struct MemoryPlan {
+  struct Slab {
+    size_t offset; // from the start of the arena, a multiple of 64
+    size_t size;   // exact storage size in bytes of the planned tensor
+  };
+  // planned outputs of each node
+  std::unordered_map<const Node*, std::vector<Slab>> node_slabs;
+  size_t arena_size = 0;
+};
+
+// Plans the CPU tensors produced by the nodes of `graph`. A tensor is planned
+// if its type gives its size, dtype and device, and it neither aliases a graph
+// input or output nor an input of the node producing it. A node is only
+// planned if all of its outputs that may hold tensors are. The live range of
+// a planned tensor runs from its producer to the last use of anything that
+// may alias it; slabs are then assigned by first-fit interval coloring,
+// largest tensors first.
+//
+// Returns nullopt if the graph has control flow or forks, or nothing to plan.
+TORCH_API c10::optional<MemoryPlan> PlanStaticMemory(
+    const std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,59 @@
+#include <torch/csrc/jit/passes/packed_linear.h>
+
+#include <torch/csrc/jit/ir/subgraph_matcher.h>
+#include <torch/csrc/jit/passes/graph_rewrite_helper.h>
+#include <torch/csrc/jit/passes/prepack_folding.h>
+#include <torch/csrc/jit/passes/subgraph_rewrite.h>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+bool isPackableLinear(
+    const Match& match,
+    const std::unordered_map<std::string, Value*>& vmap) {
+  const auto& match_vmap = match.values_map;
+  auto weight = graph_rewrite_helper::getIValue("weight", match_vmap, vmap);
+  auto bias = graph_rewrite_helper::getIValue("bias", match_vmap, vmap);
+  if (!weight || !weight->isTensor() || !bias) {
+    return false;
+  }
+  const auto& w = weight->toTensor();
+  if (!w.defined() || !w.device().is_cpu() || w.scalar_type() != at::kFloat ||
+      w.dim() != 2 || w.requires_grad()) {
+    return false;
+  }
+  return bias->isNone() ||
+      (bias->isTensor() && bias->toTensor().scalar_type() == at::kFloat);
+}
+
+} // namespace
+
+void insertPackedLinearOps(std::shared_ptr<Graph>& graph) {
+  std::string linear_pattern = R"(
+    graph(%input, %weight, %bias):
+        %r = aten::linear(%input, %weight, %bias)
+        return (%r))";
+  std::string packed_linear_pattern = R"(
+    graph(%input, %weight, %bias):
+        %packed_weight_bias = packed::linear_prepack(%weight, %bias)
+        %r = packed::linear_run(%input, %packed_weight_bias)
+        return (%r))";
+
+  SubgraphRewriter rewriter;
+  rewriter.RegisterRewritePattern(linear_pattern, packed_linear_pattern);
+  rewriter.runOnGraph(graph, isPackableLinear);
+}
+
+void PackLinearWeights(script::Module& module) {
+  auto graph = module.get_method("forward").graph();
+  insertPackedLinearOps(graph);
+  PrePackingOpsFilterFn filter_fn = [](const Node* n) -> bool {
+    return n->kind() == Symbol::fromQualString("packed::linear_prepack");
+  };
+  PrePackingOpsFolder(module, filter_fn, "packed_linear");
+}
+
+} // namespace jit
+} // namespace torch
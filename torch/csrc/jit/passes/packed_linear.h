@@ -0,0 +1,19 @@
+#pragma once
+
+#include <torch/csrc/jit/api/module.h>
+#include <torch/csrc/jit/ir/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Rewrites aten::linear calls whose weight is a constant float CPU tensor to
+// packed::linear_prepack + packed::linear_run, so that the weight is packed
+// for the GEMM once instead of on every call.
+TORCH_API void insertPackedLinearOps(std::shared_ptr<Graph>& graph);
+
+// Runs insertPackedLinearOps on the forward method of a frozen module and
+// folds the prepacking into attributes of the module.
+TORCH_API void PackLinearWeights(script::Module& module);
+
+} // namespace jit
+} // namespace torch
@@ -705,6 +705,8 @@ class InsertObserversHelper {
   // the output value of conv in the conv - relu pattern
   // the key is the intermediate output, e.g. output of conv
   // the value is the value we want to observe, e.g. output of relu
+  // The values can chain, e.g. conv - add - relu, output of conv -> output of
+  // add -> output of relu
   std::unordered_map<Value*, Value*> delay_observation_map_;
   std::unordered_set<Graph*> visited_graph_of_observer_map_;
   std::unordered_map<Value*, Module> observer_for_value_;
@@ -752,6 +754,20 @@ graph(%self, %input):
     %second_module = match::module[name="ReLU"](%self)
     %second_output = prim::CallMethod[name="forward"](%second_module, %first_output)
     return (%second_output) )");
+  const PatternInfo conv2d_add = PatternInfo::parse_from_str(R"(
+graph(%self, %input, %accum):
+    %one = prim::Constant[value=1]()
+    %first_module = match::module[name="Conv2d"](%self)
+    %first_output = prim::CallMethod[name="forward"](%first_module, %input)
+    %second_output = aten::add(%first_output, %accum, %one)
+    return (%second_output) )");
+  const PatternInfo conv2d_inplace_add = PatternInfo::parse_from_str(R"(
+graph(%self, %input, %accum):
+    %one = prim::Constant[value=1]()
+    %first_module = match::module[name="Conv2d"](%self)
+    %first_output = prim::CallMethod[name="forward"](%first_module, %input)
+    %second_output = aten::add_(%first_output, %accum, %one)
+    return (%second_output) )");
   const PatternInfo conv3d_functional_relu = PatternInfo::parse_from_str(R"(
 graph(%self, %input, %inplace):
     %relu = prim::Constant[name="relu"]()
@@ -838,6 +854,8 @@ graph(%self, %a, %b, %inplace):
       {
           conv2d_functional_relu,
           conv2d_relu,
+          conv2d_add,
+          conv2d_inplace_add,
           conv3d_functional_relu,
           conv3d_relu,
           matmul_add,
@@ -1285,8 +1303,8 @@ void InsertObserversHelper::recordObserved(
     std::unordered_map<Value*, Module>& values_to_observe,
     std::unordered_set<Value*>& block_observed_values) {
   Value* to_observe = v;
-  if (delay_observation_map_.count(v)) {
-    to_observe = delay_observation_map_.at(v);
+  while (delay_observation_map_.count(to_observe)) {
+    to_observe = delay_observation_map_.at(to_observe);
   }
   values_to_observe[to_observe] = observer_module;
   block_observed_values.insert(to_observe);
@@ -66,6 +66,68 @@ graph(%a_quant, %packed_params, %r_scale, %r_zero_point, %r_dtype, %stride, %pad
         %r_quant = quantized::conv2d_relu(%a_quant, %packed_params, %r_scale, %r_zero_point)
         return (%r_quant) )";
 
+  // aten::conv2d - aten::add
+  std::string conv2d_add = R"(
+graph(%a_quant, %packed_params, %accum_quant, %alpha, %r_scale, %r_zero_point, %r_dtype, %stride, %padding, %dilation, %groups):
+        %a_dequant = aten::dequantize(%a_quant)
+        %w_quant : Tensor, %b : Tensor? = quantized::conv2d_unpack(%packed_params)
+        %w_dequant = aten::dequantize(%w_quant)
+        %conv_out = aten::conv2d(%a_dequant, %w_dequant, %b, %stride, %padding, %dilation, %groups)
+        %accum_dequant = aten::dequantize(%accum_quant)
+        %r = aten::add(%conv_out, %accum_dequant, %alpha)
+        %r_quant = aten::quantize_per_tensor(%r, %r_scale, %r_zero_point, %r_dtype)
+        return (%r_quant) )";
+
+  // aten::conv2d - aten::add_
+  std::string conv2d_inplace_add = R"(
+graph(%a_quant, %packed_params, %accum_quant, %alpha, %r_scale, %r_zero_point, %r_dtype, %stride, %padding, %dilation, %groups):
+        %a_dequant = aten::dequantize(%a_quant)
+        %w_quant : Tensor, %b : Tensor? = quantized::conv2d_unpack(%packed_params)
+        %w_dequant = aten::dequantize(%w_quant)
+        %conv_out = aten::conv2d(%a_dequant, %w_dequant, %b, %stride, %padding, %dilation, %groups)
+        %accum_dequant = aten::dequantize(%accum_quant)
+        %r = aten::add_(%conv_out, %accum_dequant, %alpha)
+        %r_quant = aten::quantize_per_tensor(%r, %r_scale, %r_zero_point, %r_dtype)
+        return (%r_quant) )";
+
+  // quantized::conv2d_add
+  std::string quantized_conv2d_add = R"(
+graph(%a_quant, %packed_params, %accum_quant, %alpha, %r_scale, %r_zero_point, %r_dtype, %stride, %padding, %dilation, %groups):
+        %r_quant = quantized::conv2d_add(%a_quant, %accum_quant, %packed_params, %r_scale, %r_zero_point)
+        return (%r_quant) )";
+
+  // aten::conv2d - aten::add_ - aten::relu
+  std::string conv2d_add_relu = R"(
+graph(%a_quant, %packed_params, %accum_quant, %alpha, %r_scale, %r_zero_point, %r_dtype, %stride, %padding, %dilation, %groups):
+        %a_dequant = aten::dequantize(%a_quant)
+        %w_quant : Tensor, %b : Tensor? = quantized::conv2d_unpack(%packed_params)
+        %w_dequant = aten::dequantize(%w_quant)
+        %conv_out = aten::conv2d(%a_dequant, %w_dequant, %b, %stride, %padding, %dilation, %groups)
+        %accum_dequant = aten::dequantize(%accum_quant)
+        %r_add = aten::add_(%conv_out, %accum_dequant, %alpha)
+        %r = aten::relu(%r_add)
+        %r_quant = aten::quantize_per_tensor(%r, %r_scale, %r_zero_point, %r_dtype)
+        return (%r_quant) )";
+
+  // aten::conv2d - aten::add_ - aten::relu_
+  std::string conv2d_add_inplace_relu = R"(
+graph(%a_quant, %packed_params, %accum_quant, %alpha, %r_scale, %r_zero_point, %r_dtype, %stride, %padding, %dilation, %groups):
+        %a_dequant = aten::dequantize(%a_quant)
+        %w_quant : Tensor, %b : Tensor? = quantized::conv2d_unpack(%packed_params)
+        %w_dequant = aten::dequantize(%w_quant)
+        %conv_out = aten::conv2d(%a_dequant, %w_dequant, %b, %stride, %padding, %dilation, %groups)
+        %accum_dequant = aten::dequantize(%accum_quant)
+        %r_add = aten::add_(%conv_out, %accum_dequant, %alpha)
+        %r = aten::relu_(%r_add)
+        %r_quant = aten::quantize_per_tensor(%r, %r_scale, %r_zero_point, %r_dtype)
+        return (%r_quant) )";
+
+  // quantized::conv2d_add_relu
+  std::string quantized_conv2d_add_relu = R"(
+graph(%a_quant, %packed_params, %accum_quant, %alpha, %r_scale, %r_zero_point, %r_dtype, %stride, %padding, %dilation, %groups):
+        %r_quant = quantized::conv2d_add_relu(%a_quant, %accum_quant, %packed_params, %r_scale, %r_zero_point)
+        return (%r_quant) )";
+
   // aten::conv3d
   std::string conv3d = R"(
 graph(%a_quant, %packed_params, %r_scale, %r_zero_point, %r_dtype, %stride, %padding, %dilation, %groups):
@@ -440,6 +502,19 @@ graph(%a_quant, %normalized_shape, %weight, %bias, %eps, %cudnn_enabled, %output
          return (%r) )";
 
   return {
+      {"quantized::conv2d_add_relu",
+       conv2d_add_relu,
+       quantized_conv2d_add_relu,
+       add_filter},
+      {"quantized::conv2d_add_relu",
+       conv2d_add_inplace_relu,
+       quantized_conv2d_add_relu,
+       add_filter},
+      {"quantized::conv2d_add", conv2d_add, quantized_conv2d_add, add_filter},
+      {"quantized::conv2d_add",
+       conv2d_inplace_add,
+       quantized_conv2d_add,
+       add_filter},
       {"quantized::conv2d", conv2d, quantized_conv2d},
       {"quantized::conv2d_relu", conv2d_relu, quantized_conv2d_relu},
       {"quantized::conv2d_relu", conv2d_inplace_relu, quantized_conv2d_relu},
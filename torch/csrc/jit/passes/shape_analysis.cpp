@@ -15,7 +15,10 @@
 
 #include <exception>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -65,6 +68,705 @@ bool containsTensorType(const TypePtr& t) {
   return false;
 }
 
+// Symbolic sizes
+//
+// The formulas of ShapePropagator::PropagateTensorShapeOnNode only compute the
+// ranks of tensors whose sizes aren't all static. The inputs of a graph may
+// still have static dims, or symbolic dims (see c10::ShapeSymbol) that are
+// the same symbol for the dims known to be of the same size, e.g. the batch
+// size of all the inputs of a model. The rules below compute the symbolic dims
+// of the outputs of common ops from the ones of their inputs, so that the dims
+// an output shares with an input keep their static size or symbol throughout
+// the graph. A nullopt dim is a dim nothing is known about.
+
+using SymbolicDim = c10::optional<c10::ShapeSymbol>;
+using SymbolicDims = std::vector<SymbolicDim>;
+
+std::unordered_set<Symbol> symbolSet(std::initializer_list<const char*> names) {
+  std::unordered_set<Symbol> result;
+  for (const char* name : names) {
+    result.insert(Symbol::fromQualString(name));
+  }
+  return result;
+}
+
+c10::optional<SymbolicDims> symbolicDimsOf(Value* v) {
+  auto type = v->type()->cast<TensorType>();
+  if (!type) {
+    return c10::nullopt;
+  }
+  return type->symbolic_sizes().sizes();
+}
+
+SymbolicDim staticDim(int64_t size) {
+  return c10::ShapeSymbol::fromStaticSize(size);
+}
+
+bool isStaticDim(const SymbolicDim& dim) {
+  return dim && dim->is_static();
+}
+
+bool isStaticDim(const SymbolicDim& dim, int64_t size) {
+  return isStaticDim(dim) && dim->static_size() == size;
+}
+
+c10::optional<int64_t> wrapSymbolicDim(int64_t dim, size_t ndim) {
+  if (dim < 0) {
+    dim += ndim;
+  }
+  if (dim < 0 || dim >= static_cast<int64_t>(ndim)) {
+    return c10::nullopt;
+  }
+  return dim;
+}
+
+// The dim of the result of an op that requires two dims to be of the same
+// size, e.g. the inner dims of mm.
+SymbolicDim unifyDims(const SymbolicDim& a, const SymbolicDim& b) {
+  if (isStaticDim(a) || (a && !isStaticDim(b))) {
+    return a;
+  }
+  return b;
+}
+
+// The dim a broadcast of dims a and b results in.
+SymbolicDim broadcastDims(const SymbolicDim& a, const SymbolicDim& b) {
+  if (isStaticDim(a, 1)) {
+    return b;
+  }
+  if (isStaticDim(b, 1)) {
+    return a;
+  }
+  if (a && b && *a == *b) {
+    return a;
+  }
+  // A static size other than 1 is the size of the result, the other dim can
+  // only be of size 1 or of the same size.
+  if (isStaticDim(a)) {
+    return a;
+  }
+  if (isStaticDim(b)) {
+    return b;
+  }
+  return c10::nullopt;
+}
+
+SymbolicDims broadcastShapes(const SymbolicDims& a, const SymbolicDims& b) {
+  const size_t ndim = std::max(a.size(), b.size());
+  SymbolicDims result(ndim);
+  // dims are aligned on the right, missing dims are of size 1
+  for (size_t i = 0; i < ndim; ++i) {
+    SymbolicDim dim_a =
+        i + a.size() < ndim ? staticDim(1) : a[i + a.size() - ndim];
+    SymbolicDim dim_b =
+        i + b.size() < ndim ? staticDim(1) : b[i + b.size() - ndim];
+    result[i] = broadcastDims(dim_a, dim_b);
+  }
+  return result;
+}
+
+// The number of elements of a tensor of the given dims.
+SymbolicDim productOfDims(const SymbolicDims& dims) {
+  SymbolicDims factors;
+  for (const auto& dim : dims) {
+    if (!isStaticDim(dim, 1)) {
+      factors.push_back(dim);
+    }
+  }
+  if (factors.size() == 1) {
+    return factors[0];
+  }
+  int64_t numel = 1;
+  for (const auto& dim : factors) {
+    if (!isStaticDim(dim)) {
+      return c10::nullopt;
+    }
+    numel *= dim->static_size();
+  }
+  return staticDim(numel);
+}
+
+// The size an int stands for: a constant, or the size of a dim of a tensor,
+// as in x.view(x.size(0), -1).
+SymbolicDim symbolicDimOfInt(Value* v) {
+  if (auto size = constant_as<int64_t>(v)) {
+    return *size >= 0 ? staticDim(*size) : c10::nullopt;
+  }
+  Node* n = v->node();
+  if (n->matches(
+          "aten::size(Tensor self, int dim) -> int",
+          /*const_inputs=*/attr::dim)) {
+    if (auto dims = symbolicDimsOf(n->input(0))) {
+      if (auto dim = wrapSymbolicDim(
+              n->get<int64_t>(attr::dim).value(), dims->size())) {
+        return (*dims)[*dim];
+      }
+    }
+  } else if (
+      n->kind() == aten::__getitem__ && n->inputs().size() == 2 &&
+      n->input(0)->node()->matches("aten::size(Tensor self) -> int[]")) {
+    auto dims = symbolicDimsOf(n->input(0)->node()->input(0));
+    auto index = constant_as<int64_t>(n->input(1));
+    if (dims && index) {
+      if (auto dim = wrapSymbolicDim(*index, dims->size())) {
+        return (*dims)[*dim];
+      }
+    }
+  }
+  return c10::nullopt;
+}
+
+// The dims an int[] stands for, see symbolicDimOfInt. The indices of the
+// elements equal to -1 are returned in `inferred`, their dims are nullopt.
+c10::optional<SymbolicDims> symbolicDimsOfIntList(
+    Value* list,
+    std::vector<size_t>* inferred = nullptr) {
+  SymbolicDims dims;
+  const auto add = [&](c10::optional<int64_t> constant, Value* v) {
+    if (constant && *constant == -1 && inferred) {
+      inferred->push_back(dims.size());
+    }
+    if (constant) {
+      dims.push_back(*constant >= 0 ? staticDim(*constant) : c10::nullopt);
+    } else {
+      dims.push_back(symbolicDimOfInt(v));
+    }
+  };
+  if (auto sizes = constant_as<c10::List<int64_t>>(list)) {
+    for (int64_t size : sizes->vec()) {
+      add(size, nullptr);
+    }
+    return dims;
+  }
+  if (list->node()->kind() == prim::ListConstruct) {
+    for (Value* v : list->node()->inputs()) {
+      add(constant_as<int64_t>(v), v);
+    }
+    return dims;
+  }
+  return c10::nullopt;
+}
+
+// Element i of a constant int[] argument of a conv or pool op; lists of a
+// single element apply to all the spatial dims.
+c10::optional<int64_t> spatialArg(Node* node, Symbol name, size_t i) {
+  auto arg = constant_as<c10::List<int64_t>>(node->namedInput(name));
+  if (!arg || arg->empty()) {
+    return c10::nullopt;
+  }
+  if (arg->size() == 1) {
+    return arg->get(0);
+  }
+  if (i >= arg->size()) {
+    return c10::nullopt;
+  }
+  return arg->get(i);
+}
+
+// The size of spatial dim i of the output of a conv or pool op whose kernel
+// is of size k; pool ops pass nullopt to use their kernel_size argument.
+SymbolicDim slidingWindowDim(
+    Node* node,
+    const SymbolicDim& input,
+    SymbolicDim k,
+    size_t i,
+    bool has_dilation) {
+  if (!k) {
+    if (auto kernel_size = spatialArg(node, attr::kernel_size, i)) {
+      k = staticDim(*kernel_size);
+    }
+  }
+  auto stride = spatialArg(node, attr::stride, i);
+  if (!stride) {
+    // the stride of pool ops defaults to their kernel size
+    stride = isStaticDim(k) ? c10::optional<int64_t>(k->static_size())
+                            : c10::nullopt;
+  }
+  auto padding = spatialArg(node, attr::padding, i);
+  auto dilation = has_dilation ? spatialArg(node, attr::dilation, i)
+                               : c10::optional<int64_t>(1);
+  if (!isStaticDim(input) || !isStaticDim(k) || !stride || *stride <= 0 ||
+      !padding || !dilation) {
+    return c10::nullopt;
+  }
+  int64_t numerator = input->static_size() + 2 * *padding -
+      *dilation * (k->static_size() - 1) - 1;
+  if (numerator < 0) {
+    return c10::nullopt;
+  }
+  return staticDim(numerator / *stride + 1);
+}
+
+// The symbolic dims of the output of a cat of `tensors`.
+c10::optional<SymbolicDims> symbolicDimsOfCat(
+    Node* cat_node,
+    at::ArrayRef<Value*> tensors) {
+  if (!cat_node->is_constant(attr::dim)) {
+    return c10::nullopt;
+  }
+  c10::optional<SymbolicDims> result;
+  c10::optional<int64_t> dim;
+  for (Value* v : tensors) {
+    auto dims = symbolicDimsOf(v);
+    if (!dims) {
+      return c10::nullopt;
+    }
+    if (!result) {
+      dim = wrapSymbolicDim(
+          cat_node->get<int64_t>(attr::dim).value(), dims->size());
+      if (!dim) {
+        return c10::nullopt;
+      }
+      result = *dims;
+      continue;
+    }
+    if (dims->size() != result->size()) {
+      return c10::nullopt;
+    }
+    for (size_t i = 0; i < dims->size(); ++i) {
+      if (static_cast<int64_t>(i) == *dim) {
+        SymbolicDim& size = (*result)[i];
+        size = isStaticDim(size) && isStaticDim((*dims)[i])
+            ? staticDim(size->static_size() + (*dims)[i]->static_size())
+            : c10::nullopt;
+      } else {
+        (*result)[i] = unifyDims((*result)[i], (*dims)[i]);
+      }
+    }
+  }
+  return result;
+}
+
+// The symbolic dims of the tensor outputs of `node`, for the ops with known
+// rules. All its tensor outputs get the same dims.
+c10::optional<SymbolicDims> symbolicDimsOfOutputs(Node* node) {
+  // ops whose outputs have the sizes of their first input
+  static const auto size_preserving_ops = symbolSet({
+      "aten::abs",         "aten::batch_norm",  "aten::bernoulli",
+      "aten::ceil",        "aten::celu",        "aten::clamp",
+      "aten::clamp_max",   "aten::clamp_min",   "aten::clone",
+      "aten::contiguous",  "aten::cos",         "aten::detach",
+      "aten::dropout",     "aten::elu",         "aten::empty_like",
+      "aten::erf",         "aten::exp",         "aten::feature_dropout",
+      "aten::floor",       "aten::frac",        "aten::full_like",
+      "aten::gelu",        "aten::hardtanh",    "aten::layer_norm",
+      "aten::leaky_relu",  "aten::log",         "aten::log_sigmoid",
+      "aten::log_softmax", "aten::neg",         "aten::ones_like",
+      "aten::rand_like",   "aten::randn_like",  "aten::reciprocal",
+      "aten::relu",        "aten::round",       "aten::rsqrt",
+      "aten::selu",        "aten::sigmoid",     "aten::sign",
+      "aten::sin",         "aten::softmax",     "aten::softplus",
+      "aten::sqrt",        "aten::tanh",        "aten::threshold",
+      "aten::to",          "aten::tril",        "aten::triu",
+      "aten::trunc",       "aten::type_as",     "aten::zeros_like",
+  });
+  // ops whose outputs have the sizes of the broadcast of their tensor inputs
+  static const auto broadcasting_ops = symbolSet({
+      "aten::__and__",  "aten::__or__",    "aten::__xor__",   "aten::add",
+      "aten::addcdiv",  "aten::addcmul",   "aten::atan2",     "aten::div",
+      "aten::eq",       "aten::fmod",      "aten::ge",        "aten::gt",
+      "aten::le",       "aten::lerp",      "aten::lt",        "aten::masked_fill",
+      "aten::mul",      "aten::ne",        "aten::pow",       "aten::remainder",
+      "aten::rsub",     "aten::sub",       "aten::where",
+  });
+  // ops that reduce the dims given by their `dim` argument
+  static const auto reduction_ops = symbolSet({
+      "aten::all",    "aten::any",    "aten::argmax",    "aten::argmin",
+      "aten::logsumexp", "aten::max", "aten::mean",      "aten::median",
+      "aten::min",    "aten::mode",   "aten::norm",      "aten::prod",
+      "aten::std",    "aten::sum",    "aten::var",
+  });
+  // the number of spatial dims of pool ops
+  static const std::unordered_map<Symbol, size_t> pool_ops = {
+      {Symbol::fromQualString("aten::adaptive_avg_pool1d"), 1},
+      {Symbol::fromQualString("aten::adaptive_avg_pool2d"), 2},
+      {Symbol::fromQualString("aten::adaptive_avg_pool3d"), 3},
+      {Symbol::fromQualString("aten::adaptive_max_pool1d"), 1},
+      {Symbol::fromQualString("aten::adaptive_max_pool2d"), 2},
+      {Symbol::fromQualString("aten::adaptive_max_pool3d"), 3},
+      {Symbol::fromQualString("aten::avg_pool1d"), 1},
+      {Symbol::fromQualString("aten::avg_pool2d"), 2},
+      {Symbol::fromQualString("aten::avg_pool3d"), 3},
+      {Symbol::fromQualString("aten::max_pool1d"), 1},
+      {Symbol::fromQualString("aten::max_pool2d"), 2},
+      {Symbol::fromQualString("aten::max_pool3d"), 3},
+  };
+
+  if (node->inputs().empty()) {
+    return c10::nullopt;
+  }
+  const auto input_dims = [node](size_t index) {
+    return symbolicDimsOf(node->input(index));
+  };
+  auto self = input_dims(0);
+
+  if (size_preserving_ops.count(node->kind())) {
+    return self;
+  }
+
+  if (broadcasting_ops.count(node->kind()) ||
+      node->matches("aten::max(Tensor self, Tensor other) -> Tensor") ||
+      node->matches("aten::min(Tensor self, Tensor other) -> Tensor")) {
+    c10::optional<SymbolicDims> result;
+    for (Value* input : node->inputs()) {
+      if (!input->type()->cast<TensorType>()) {
+        continue;
+      }
+      auto dims = symbolicDimsOf(input);
+      if (!dims) {
+        return c10::nullopt;
+      }
+      result = result ? broadcastShapes(*result, *dims) : *dims;
+    }
+    return result;
+  }
+
+  if (reduction_ops.count(node->kind())) {
+    auto schema = node->maybeSchema();
+    if (!self || !schema) {
+      return c10::nullopt;
+    }
+    auto dim_index = schema->argumentIndexWithName("dim");
+    auto keepdim_index = schema->argumentIndexWithName("keepdim");
+    if (!dim_index || !keepdim_index) {
+      return c10::nullopt;
+    }
+    auto dim = toIValue(node->input(*dim_index));
+    auto keepdim = constant_as<bool>(node->input(*keepdim_index));
+    if (!dim || !keepdim) {
+      return c10::nullopt;
+    }
+    std::vector<int64_t> reduced_dims;
+    if (dim->isInt()) {
+      reduced_dims.push_back(dim->toInt());
+    } else if (dim->isIntList()) {
+      reduced_dims = dim->toIntVector();
+    } else if (!dim->isNone()) {
+      return c10::nullopt;
+    }
+    // no dims (dim=None or dim=[]) reduce all the dims
+    std::vector<bool> is_reduced(self->size(), reduced_dims.empty());
+    for (int64_t d : reduced_dims) {
+      auto wrapped = wrapSymbolicDim(d, self->size());
+      if (!wrapped) {
+        return c10::nullopt;
+      }
+      is_reduced[*wrapped] = true;
+    }
+    SymbolicDims result;
+    for (size_t i = 0; i < self->size(); ++i) {
+      if (!is_reduced[i]) {
+        result.push_back((*self)[i]);
+      } else if (*keepdim) {
+        result.push_back(staticDim(1));
+      }
+    }
+    return result;
+  }
+
+  if (node->matches("aten::mm(Tensor self, Tensor mat2) -> Tensor")) {
+    auto mat2 = input_dims(1);
+    if (self && mat2 && self->size() == 2 && mat2->size() == 2) {
+      return SymbolicDims{(*self)[0], (*mat2)[1]};
+    }
+  } else if (
+      node->matches(
+          "aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta, Scalar alpha) -> Tensor")) {
+    auto mat1 = input_dims(1);
+    auto mat2 = input_dims(2);
+    if (mat1 && mat2 && mat1->size() == 2 && mat2->size() == 2) {
+      return SymbolicDims{(*mat1)[0], (*mat2)[1]};
+    }
+  } else if (node->matches("aten::bmm(Tensor self, Tensor mat2) -> Tensor")) {
+    auto mat2 = input_dims(1);
+    if (self && mat2 && self->size() == 3 && mat2->size() == 3) {
+      return SymbolicDims{unifyDims((*self)[0], (*mat2)[0]),
+                          (*self)[1],
+                          (*mat2)[2]};
+    }
+  } else if (
+      node->matches(
+          "aten::baddbmm(Tensor self, Tensor batch1, Tensor batch2, *, Scalar beta, Scalar alpha) -> Tensor")) {
+    auto batch1 = input_dims(1);
+    auto batch2 = input_dims(2);
+    if (batch1 && batch2 && batch1->size() == 3 && batch2->size() == 3) {
+      return SymbolicDims{unifyDims((*batch1)[0], (*batch2)[0]),
+                          (*batch1)[1],
+                          (*batch2)[2]};
+    }
+  } else if (node->matches(
+                 "aten::matmul(Tensor self, Tensor other) -> Tensor")) {
+    auto other = input_dims(1);
+    if (!self || !other || self->empty() || other->empty()) {
+      return c10::nullopt;
+    }
+    // 1-D arguments don't have the dim of a matrix multiply, the other dims
+    // are broadcast batch dims
+    const auto batch_dims = [](const SymbolicDims& dims) {
+      return SymbolicDims(
+          dims.begin(), dims.end() - std::min<size_t>(dims.size(), 2));
+    };
+    SymbolicDims result =
+        broadcastShapes(batch_dims(*self), batch_dims(*other));
+    if (self->size() >= 2) {
+      result.push_back((*self)[self->size() - 2]);
+    }
+    if (other->size() >= 2) {
+      result.push_back(other->back());
+    }
+    return result;
+  } else if (
+      node->matches(
+          "aten::linear(Tensor input, Tensor weight, Tensor? bias) -> Tensor")) {
+    auto weight = input_dims(1);
+    if (self && weight && !self->empty() && weight->size() == 2) {
+      SymbolicDims result(self->begin(), self->end() - 1);
+      result.push_back((*weight)[0]);
+      return result;
+    }
+  } else if (
+      node->matches(
+          "aten::embedding(Tensor weight, Tensor indices, int padding_idx, bool scale_grad_by_freq, bool sparse) -> Tensor")) {
+    auto indices = input_dims(1);
+    if (self && indices && self->size() == 2) {
+      SymbolicDims result = *indices;
+      result.push_back((*self)[1]);
+      return result;
+    }
+  } else if (
+      node->matches(
+          "aten::conv1d(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, int groups) -> Tensor") ||
+      node->matches(
+          "aten::conv2d(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, int groups) -> Tensor") ||
+      node->matches(
+          "aten::conv3d(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, int groups) -> Tensor")) {
+    auto weight = input_dims(1);
+    if (!self || !weight || self->size() < 3 ||
+        self->size() != weight->size()) {
+      return c10::nullopt;
+    }
+    SymbolicDims result{(*self)[0], (*weight)[0]};
+    for (size_t i = 2; i < self->size(); ++i) {
+      result.push_back(slidingWindowDim(
+          node, (*self)[i], (*weight)[i], i - 2, /*has_dilation=*/true));
+    }
+    return result;
+  } else if (pool_ops.count(node->kind())) {
+    const size_t spatial_dims = pool_ops.at(node->kind());
+    auto schema = node->maybeSchema();
+    if (!self || !schema || self->size() < spatial_dims) {
+      return c10::nullopt;
+    }
+    const auto has_arg = [&](const char* name) {
+      return schema->argumentIndexWithName(name).has_value();
+    };
+    const size_t leading_dims = self->size() - spatial_dims;
+    SymbolicDims result(self->begin(), self->begin() + leading_dims);
+    auto output_size = has_arg("output_size")
+        ? symbolicDimsOfIntList(node->namedInput(attr::output_size))
+        : c10::nullopt;
+    auto ceil_mode = has_arg("ceil_mode")
+        ? constant_as<bool>(node->namedInput(attr::ceil_mode))
+        : c10::nullopt;
+    for (size_t i = 0; i < spatial_dims; ++i) {
+      if (output_size) {
+        result.push_back(
+            output_size->size() == spatial_dims ? (*output_size)[i]
+                                                : c10::nullopt);
+      } else if (ceil_mode && !*ceil_mode) {
+        result.push_back(slidingWindowDim(
+            node,
+            (*self)[leading_dims + i],
+            c10::nullopt,
+            i,
+            /*has_dilation=*/has_arg("dilation")));
+      } else {
+        result.push_back(c10::nullopt);
+      }
+    }
+    return result;
+  } else if (node->matches("aten::t(Tensor self) -> Tensor")) {
+    if (self && self->size() == 2) {
+      return SymbolicDims{(*self)[1], (*self)[0]};
+    }
+    return self;
+  } else if (
+      node->matches(
+          "aten::transpose(Tensor self, int dim0, int dim1) -> Tensor",
+          /*const_inputs=*/{attr::dim0, attr::dim1})) {
+    if (!self) {
+      return c10::nullopt;
+    }
+    auto dim0 =
+        wrapSymbolicDim(node->get<int64_t>(attr::dim0).value(), self->size());
+    auto dim1 =
+        wrapSymbolicDim(node->get<int64_t>(attr::dim1).value(), self->size());
+    if (dim0 && dim1) {
+      std::swap((*self)[*dim0], (*self)[*dim1]);
+      return self;
+    }
+  } else if (
+      node->matches(
+          "aten::permute(Tensor self, int[] dims) -> Tensor",
+          /*const_inputs=*/attr::dims)) {
+    auto dims = node->get<c10::List<int64_t>>(attr::dims).value();
+    if (!self || dims.size() != self->size()) {
+      return c10::nullopt;
+    }
+    SymbolicDims result;
+    for (int64_t d : dims.vec()) {
+      auto wrapped = wrapSymbolicDim(d, self->size());
+      if (!wrapped) {
+        return c10::nullopt;
+      }
+      result.push_back((*self)[*wrapped]);
+    }
+    return result;
+  } else if (
+      node->matches(
+          "aten::unsqueeze(Tensor self, int dim) -> Tensor",
+          /*const_inputs=*/attr::dim)) {
+    if (!self) {
+      return c10::nullopt;
+    }
+    if (auto dim = wrapSymbolicDim(
+            node->get<int64_t>(attr::dim).value(), self->size() + 1)) {
+      self->insert(self->begin() + *dim, staticDim(1));
+      return self;
+    }
+  } else if (
+      node->matches(
+          "aten::select(Tensor self, int dim, int index) -> Tensor",
+          /*const_inputs=*/attr::dim)) {
+    if (!self) {
+      return c10::nullopt;
+    }
+    if (auto dim = wrapSymbolicDim(
+            node->get<int64_t>(attr::dim).value(), self->size())) {
+      self->erase(self->begin() + *dim);
+      return self;
+    }
+  } else if (
+      node->matches(
+          "aten::narrow(Tensor self, int dim, int start, int length) -> Tensor",
+          /*const_inputs=*/attr::dim)) {
+    if (!self) {
+      return c10::nullopt;
+    }
+    if (auto dim = wrapSymbolicDim(
+            node->get<int64_t>(attr::dim).value(), self->size())) {
+      (*self)[*dim] = symbolicDimOfInt(node->namedInput(attr::length));
+      return self;
+    }
+  } else if (
+      node->matches(
+          "aten::slice(Tensor self, int dim, int start, int end, int step) -> Tensor",
+          /*const_inputs=*/attr::dim)) {
+    if (!self) {
+      return c10::nullopt;
+    }
+    auto dim =
+        wrapSymbolicDim(node->get<int64_t>(attr::dim).value(), self->size());
+    if (!dim) {
+      return c10::nullopt;
+    }
+    SymbolicDim& size = (*self)[*dim];
+    auto start = constant_as<int64_t>(node->namedInput(attr::start));
+    auto end = constant_as<int64_t>(node->namedInput(attr::end));
+    auto step = constant_as<int64_t>(node->namedInput(attr::step));
+    if (start && end && step && *start == 0 && *step == 1 &&
+        *end == std::numeric_limits<int64_t>::max()) {
+      // x[:] keeps the size of the dim
+      return self;
+    }
+    if (!start || !end || !step || *step <= 0 || !isStaticDim(size)) {
+      size = c10::nullopt;
+      return self;
+    }
+    const int64_t n = size->static_size();
+    const auto clip = [n](int64_t i) {
+      return std::min(std::max(i < 0 ? i + n : i, int64_t(0)), n);
+    };
+    const int64_t length = clip(*end) - clip(*start);
+    size = staticDim(length > 0 ? (length + *step - 1) / *step : 0);
+    return self;
+  } else if (
+      node->matches(
+          "aten::flatten(Tensor self, int start_dim, int end_dim) -> Tensor",
+          /*const_inputs=*/{attr::start_dim, attr::end_dim})) {
+    if (!self || self->empty()) {
+      return c10::nullopt;
+    }
+    auto start_dim = wrapSymbolicDim(
+        node->get<int64_t>(attr::start_dim).value(), self->size());
+    auto end_dim = wrapSymbolicDim(
+        node->get<int64_t>(attr::end_dim).value(), self->size());
+    if (!start_dim || !end_dim || *start_dim > *end_dim) {
+      return c10::nullopt;
+    }
+    SymbolicDims result(self->begin(), self->begin() + *start_dim);
+    result.push_back(productOfDims(SymbolicDims(
+        self->begin() + *start_dim, self->begin() + *end_dim + 1)));
+    result.insert(result.end(), self->begin() + *end_dim + 1, self->end());
+    return result;
+  } else if (
+      node->matches("aten::view(Tensor self, int[] size) -> Tensor") ||
+      node->matches("aten::reshape(Tensor self, int[] shape) -> Tensor")) {
+    std::vector<size_t> inferred;
+    auto result = symbolicDimsOfIntList(node->input(1), &inferred);
+    if (!result || !self || inferred.size() != 1) {
+      return result;
+    }
+    // The inferred dim is the product of the dims of self that the other
+    // dims of the result don't account for.
+    SymbolicDims remaining = *self;
+    int64_t unmatched = 1;
+    for (size_t i = 0; i < result->size(); ++i) {
+      const SymbolicDim& dim = (*result)[i];
+      if (i == inferred[0] || isStaticDim(dim, 1)) {
+        continue;
+      }
+      auto it = dim ? std::find(remaining.begin(), remaining.end(), dim)
+                    : remaining.end();
+      if (it != remaining.end()) {
+        remaining.erase(it);
+      } else if (isStaticDim(dim) && dim->static_size() > 0) {
+        unmatched *= dim->static_size();
+      } else {
+        return result;
+      }
+    }
+    SymbolicDim numel = productOfDims(remaining);
+    if (unmatched == 1) {
+      (*result)[inferred[0]] = numel;
+    } else if (
+        isStaticDim(numel) && numel->static_size() % unmatched == 0) {
+      (*result)[inferred[0]] = staticDim(numel->static_size() / unmatched);
+    }
+    return result;
+  } else if (node->matches(
+                 "aten::expand(Tensor self, int[] size, *, bool implicit) -> Tensor")) {
+    std::vector<size_t> inferred;
+    auto result = symbolicDimsOfIntList(node->input(1), &inferred);
+    if (!result || !self || result->size() < self->size()) {
+      return result;
+    }
+    // -1 keeps the size of the dim of self, aligned on the right
+    for (size_t i : inferred) {
+      if (i + self->size() >= result->size()) {
+        (*result)[i] = (*self)[i + self->size() - result->size()];
+      }
+    }
+    return result;
+  } else if (
+      node->matches("aten::view_as(Tensor self, Tensor other) -> Tensor") ||
+      node->matches("aten::expand_as(Tensor self, Tensor other) -> Tensor") ||
+      node->matches("aten::reshape_as(Tensor self, Tensor other) -> Tensor")) {
+    return input_dims(1);
+  }
+  return c10::nullopt;
+}
+
 class ShapePropagator {
  public:
   explicit ShapePropagator(std::shared_ptr<Graph> graph) : aliasDb_(graph) {
@@ -485,6 +1187,10 @@ class ShapePropagator {
         if (propagate_complete(cat_node, tensors)) {
           return;
         } else if (propagate(cat_node, tensors)) {
+          if (cat_node->kind() == aten::cat) {
+            PropagateSymbolicSizesOnNode(
+                cat_node, symbolicDimsOfCat(cat_node, tensors));
+          }
           return;
         }
       }
@@ -492,6 +1198,23 @@ class ShapePropagator {
     setUnshapedType(cat_node);
   }
 
+  // Refines the sizes of the tensor outputs of a node whose ranks are known
+  // with their symbolic dims, see symbolicDimsOfOutputs.
+  void PropagateSymbolicSizesOnNode(
+      Node* node,
+      const c10::optional<SymbolicDims>& dims) {
+    if (!dims) {
+      return;
+    }
+    for (Value* output : node->outputs()) {
+      auto type = output->type()->cast<TensorType>();
+      if (type && type->dim() == dims->size()) {
+        output->setType(type->withSymbolicShapes(
+            c10::VaryingShape<c10::ShapeSymbol>(*dims)));
+      }
+    }
+  }
+
   void propagateTorchTensorShape(Node* node) {
     auto input_type = node->inputs().at(0)->type();
 
@@ -707,6 +1430,7 @@ class ShapePropagator {
     }
 
     if (PropagateTensorShapeOnNode(node, insert_expands)) {
+      PropagateSymbolicSizesOnNode(node, symbolicDimsOfOutputs(node));
       return;
     }
 
@@ -1667,6 +2391,34 @@ class ShapePropagator {
         node->output()->setType(weight_type->withDim(*indices_type->dim() + 1));
         return true;
       }
+    } else if (
+        node->matches(
+            "aten::linear(Tensor input, Tensor weight, Tensor? bias) -> Tensor")) {
+      if (auto type = input_type(0)) {
+        node->output()->setType(type);
+        return true;
+      }
+    } else if (
+        node->matches(
+            "aten::flatten(Tensor self, int start_dim, int end_dim) -> Tensor",
+            /*const_inputs=*/{attr::start_dim, attr::end_dim})) {
+      auto type = input_type(0);
+      if (type && type->dim()) {
+        int64_t ndim = *type->dim();
+        int64_t start_dim = node->get<int64_t>(attr::start_dim).value();
+        int64_t end_dim = node->get<int64_t>(attr::end_dim).value();
+        if (ndim == 0) {
+          node->output()->setType(type->withDim(1));
+          return true;
+        }
+        start_dim = start_dim < 0 ? start_dim + ndim : start_dim;
+        end_dim = end_dim < 0 ? end_dim + ndim : end_dim;
+        if (0 <= start_dim && start_dim <= end_dim && end_dim < ndim) {
+          node->output()->setType(
+              type->withDim(ndim - (end_dim - start_dim)));
+          return true;
+        }
+      }
     } else if (
         node->matches(
             "aten::bilinear(Tensor input1, Tensor input2, Tensor weight, Tensor? bias) -> Tensor")) {
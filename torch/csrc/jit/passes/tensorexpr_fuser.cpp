@@ -75,9 +75,30 @@ bool allShapesAreKnown(Node* node) {
   return true;
 }
 
+// Reductions are lowered over dimensions known at compile time, so all of
+// their non-tensor arguments have to be constants.
+bool hasConstantReductionArgs(Node* node) {
+  for (size_t i = 1; i < node->inputs().size(); i++) {
+    Value* input = node->inputs()[i];
+    if (input->type()->cast<TensorType>()) {
+      continue;
+    }
+    if (input->node()->kind() != prim::Constant) {
+      return false;
+    }
+  }
+  return true;
+}
+
 bool isSupported(Node* node) {
   // TODO:
   switch (node->kind()) {
+    case aten::sum:
+    case aten::mean:
+    case aten::softmax:
+    case aten::log_softmax:
+    case aten::layer_norm:
+      return hasConstantReductionArgs(node);
     case aten::add:
     case aten::_cast_Float:
     case aten::type_as:
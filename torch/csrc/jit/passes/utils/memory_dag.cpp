@@ -68,19 +68,41 @@ bool MemoryDAG::mayContainAlias(Element* a, Element* b) const {
 void MemoryDAG::collectAllContainedMemoryLocations(
     const Element* elem,
     MemoryLocations& cont) const {
-  // we have already recursed on this element
-  unsigned compIdx = elem->index;
-  if (cont.test(compIdx)) {
-    return;
+  if (!elem->cachedAllContainedMemoryLocations_) {
+    MemoryLocations all;
+    collectAllContainedMemoryLocationsImpl(elem, all);
+    elem->cachedAllContainedMemoryLocations_ = std::move(all);
   }
-  cont.set(compIdx);
+  cont |= *elem->cachedAllContainedMemoryLocations_;
+}
 
-  for (const auto& mem_loc : getMemoryLocations(elem)) {
-    collectAllContainedMemoryLocations(fromIndex(mem_loc), cont);
-  }
+// Walks the elements with an explicit stack, as the chains of aliases of large
+// graphs would overflow the call stack. Elements whose result is already
+// memoized are added at once, as it includes everything they reach.
+void MemoryDAG::collectAllContainedMemoryLocationsImpl(
+    const Element* elem,
+    MemoryLocations& cont) const {
+  std::vector<const Element*> stack = {elem};
+  while (!stack.empty()) {
+    const Element* e = stack.back();
+    stack.pop_back();
+    // we have already visited this element
+    if (cont.test(e->index)) {
+      continue;
+    }
+    if (e->cachedAllContainedMemoryLocations_) {
+      cont |= *e->cachedAllContainedMemoryLocations_;
+      continue;
+    }
+    cont.set(e->index);
 
-  for (const auto& contained : elem->containedElements) {
-    collectAllContainedMemoryLocations(fromIndex(contained), cont);
+    for (const auto& mem_loc : getMemoryLocations(e)) {
+      stack.push_back(fromIndex(mem_loc));
+    }
+
+    for (const auto& contained : e->containedElements) {
+      stack.push_back(fromIndex(contained));
+    }
   }
 }
 
@@ -140,18 +162,42 @@ const MemoryLocations& MemoryDAG::getMemoryLocations(const Element* e) const {
     return *e->cachedMemoryLocations_;
   }
 
-  MemoryLocations ret;
-  if (e->pointsTo.empty()) {
-    // Base case: if we don't point to anything, this element is a memory
-    // location. Return itself.
-    ret.set(e->index);
-  } else {
-    for (auto el : e->pointsTo) {
-      ret |= getMemoryLocations(fromIndex(el));
+  // The locations of an element are those of the elements it points to, which
+  // are computed first. This goes through an explicit stack rather than
+  // recursion to handle long chains of aliases.
+  std::vector<const Element*> stack = {e};
+  while (!stack.empty()) {
+    const Element* top = stack.back();
+    if (top->cachedMemoryLocations_) {
+      stack.pop_back();
+      continue;
+    }
+
+    bool pointeesReady = true;
+    for (auto el : top->pointsTo) {
+      const Element* pointee = fromIndex(el);
+      if (!pointee->cachedMemoryLocations_) {
+        stack.push_back(pointee);
+        pointeesReady = false;
+      }
+    }
+    if (!pointeesReady) {
+      continue;
     }
-  }
 
-  e->cachedMemoryLocations_ = std::move(ret);
+    MemoryLocations ret;
+    if (top->pointsTo.empty()) {
+      // Base case: if we don't point to anything, this element is a memory
+      // location. Return itself.
+      ret.set(top->index);
+    } else {
+      for (auto el : top->pointsTo) {
+        ret |= *fromIndex(el)->cachedMemoryLocations_;
+      }
+    }
+    top->cachedMemoryLocations_ = std::move(ret);
+    stack.pop_back();
+  }
   return *e->cachedMemoryLocations_;
 }
 
@@ -187,6 +233,8 @@ void MemoryDAG::setWildcards(
   // For every element, if the cache contains `MemoryLocationFoo`, then we must
   // add `WildcardBar` to it.
   for (const std::unique_ptr<Element>& e : this->indexToElementMap_) {
+    // The wildcards are reached from the edited memory locations now
+    e->cachedAllContainedMemoryLocations_ = c10::nullopt;
     if (e->values.empty()) {
       // This element is a wildcard element, we can skip it.
       TORCH_INTERNAL_ASSERT(e->pointsTo.empty());
@@ -91,6 +91,9 @@ class TORCH_API MemoryDAG {
   // Converts from the compressed index representation
   const Element* fromIndex(unsigned x) const;
   Element* fromIndex(unsigned x);
+
+  // Add to `cont` all the elements `elem` may point to or contain,
+  // transitively. The result is memoized for `elem`.
   void collectAllContainedMemoryLocations(
       const Element* elem,
       MemoryLocations& cont) const;
@@ -114,6 +117,9 @@ class TORCH_API MemoryDAG {
   bool mayAliasImpl(const Element* a, const Element* b) const;
   bool mayContainAliasImpl(const Element* contained, const Element* container)
       const;
+  void collectAllContainedMemoryLocationsImpl(
+      const Element* elem,
+      MemoryLocations& cont) const;
   std::vector<std::unique_ptr<Element>> indexToElementMap_;
 };
 
@@ -151,6 +157,9 @@ struct Element {
   // A nullopt means that this cache is not yet populated. Since `MemoryDAG` is
   // immutable, this cache should never need to be invalidated.
   mutable c10::optional<MemoryLocations> cachedMemoryLocations_;
+  // Same for `collectAllContainedMemoryLocations`, which is only populated
+  // once the wildcards are set.
+  mutable c10::optional<MemoryLocations> cachedAllContainedMemoryLocations_;
 };
 
 } // namespace jit
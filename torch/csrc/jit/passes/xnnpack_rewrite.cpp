@@ -87,6 +87,30 @@ void insertPrePackedConv2dOp(std::shared_ptr<Graph>& graph) {
   rewriter.runOnGraph(graph);
 }
 
+void insertPrePackedConvTranspose2dOp(std::shared_ptr<Graph>& graph) {
+  std::string conv_transpose_2d_pattern = R"(
+    graph(%input, %weight, %bias, %stride:int[], %padding:int[],
+          %output_padding:int[], %groups:int, %dilation:int[]):
+        %r = aten::conv_transpose2d(%input, %weight, %bias, %stride, %padding,
+            %output_padding, %groups, %dilation)
+        return (%r) )";
+
+  std::string prepacked_ops_conv_transpose_2d_pattern = R"(
+    graph(%input, %weight, %bias, %stride:int[], %padding:int[],
+          %output_padding:int[], %groups:int, %dilation:int[]):
+        %output_min_max : None = prim::Constant()
+        %packed_weight_bias = prepacked::conv2d_transpose_clamp_prepack(
+            %weight, %bias, %stride, %padding, %output_padding, %dilation,
+            %groups, %output_min_max, %output_min_max)
+        %r = prepacked::conv2d_transpose_clamp_run(%input, %packed_weight_bias)
+        return (%r) )";
+
+  SubgraphRewriter rewriter;
+  rewriter.RegisterRewritePattern(
+      conv_transpose_2d_pattern, prepacked_ops_conv_transpose_2d_pattern);
+  rewriter.runOnGraph(graph);
+}
+
 bool isClampFusable(
     const Match& match,
     const std::unordered_map<std::string, Value*>& vmap) {
@@ -188,6 +212,45 @@ void fuseHardtanhWithPackedOps(std::shared_ptr<Graph>& graph) {
   rewriter.RegisterRewritePattern(
       conv2d_prepack_run_hardtanh_inplace, conv2d_prepack_run_hardtanh_fused);
 
+  std::string conv2d_transpose_prepack_run_hardtanh_fused = R"(
+    graph(%input, %weight, %bias, %stride:int[], %padding:int[],
+          %output_padding:int[], %dilation:int[], %groups:int,
+          %output_min, %output_max, %dummy_min_max):
+        %packed_weight_bias : __torch__.torch.classes.xnnpack.TransposeConv2dOpContext = prepacked::conv2d_transpose_clamp_prepack(
+            %weight, %bias, %stride, %padding, %output_padding, %dilation,
+            %groups, %output_min, %output_max)
+        %r = prepacked::conv2d_transpose_clamp_run(%input, %packed_weight_bias)
+        return (%r) )";
+
+  std::string conv2d_transpose_prepack_run_hardtanh = R"(
+    graph(%input, %weight, %bias, %stride:int[], %padding:int[],
+          %output_padding:int[], %dilation:int[], %groups:int,
+          %output_min, %output_max, %dummy_min_max):
+        %packed_weight_bias = prepacked::conv2d_transpose_clamp_prepack(
+            %weight, %bias, %stride, %padding, %output_padding, %dilation,
+            %groups, %dummy_min_max, %dummy_min_max)
+        %conv2d_res = prepacked::conv2d_transpose_clamp_run(%input, %packed_weight_bias)
+        %r = aten::hardtanh(%conv2d_res, %output_min, %output_max)
+        return (%r) )";
+
+  std::string conv2d_transpose_prepack_run_hardtanh_inplace = R"(
+    graph(%input, %weight, %bias, %stride:int[], %padding:int[],
+          %output_padding:int[], %dilation:int[], %groups:int,
+          %output_min, %output_max, %dummy_min_max):
+        %packed_weight_bias = prepacked::conv2d_transpose_clamp_prepack(
+            %weight, %bias, %stride, %padding, %output_padding, %dilation,
+            %groups, %dummy_min_max, %dummy_min_max)
+        %conv2d_res = prepacked::conv2d_transpose_clamp_run(%input, %packed_weight_bias)
+        %r = aten::hardtanh_(%conv2d_res, %output_min, %output_max)
+        return (%r) )";
+
+  rewriter.RegisterRewritePattern(
+      conv2d_transpose_prepack_run_hardtanh,
+      conv2d_transpose_prepack_run_hardtanh_fused);
+  rewriter.RegisterRewritePattern(
+      conv2d_transpose_prepack_run_hardtanh_inplace,
+      conv2d_transpose_prepack_run_hardtanh_fused);
+
   rewriter.runOnGraph(graph, isClampFusable);
 }
 
@@ -260,6 +323,44 @@ void fuseReluWithPackedOps(std::shared_ptr<Graph>& graph) {
       linear_prepack_run_relu_inplace, linear_prepack_run_relu_fused);
   rewriter.RegisterRewritePattern(
       conv2d_prepack_run_relu_inplace, conv2d_prepack_run_relu_fused);
+
+  std::string conv2d_transpose_prepack_run_relu_fused = R"(
+    graph(%input, %weight, %bias, %stride:int[], %padding:int[],
+          %output_padding:int[], %dilation:int[], %groups:int, %dummy_min_max):
+        %output_min: float = prim::Constant[value=0.0]()
+        %output_max: None = prim::Constant()
+        %packed_weight_bias : __torch__.torch.classes.xnnpack.TransposeConv2dOpContext = prepacked::conv2d_transpose_clamp_prepack(
+            %weight, %bias, %stride, %padding, %output_padding, %dilation,
+            %groups, %output_min, %output_max)
+        %r = prepacked::conv2d_transpose_clamp_run(%input, %packed_weight_bias)
+        return (%r) )";
+
+  std::string conv2d_transpose_prepack_run_relu = R"(
+    graph(%input, %weight, %bias, %stride:int[], %padding:int[],
+          %output_padding:int[], %dilation:int[], %groups:int, %dummy_min_max):
+        %packed_weight_bias = prepacked::conv2d_transpose_clamp_prepack(
+            %weight, %bias, %stride, %padding, %output_padding, %dilation,
+            %groups, %dummy_min_max, %dummy_min_max)
+        %conv2d_res = prepacked::conv2d_transpose_clamp_run(%input, %packed_weight_bias)
+        %r = aten::relu(%conv2d_res)
+        return (%r) )";
+
+  std::string conv2d_transpose_prepack_run_relu_inplace = R"(
+    graph(%input, %weight, %bias, %stride:int[], %padding:int[],
+          %output_padding:int[], %dilation:int[], %groups:int, %dummy_min_max):
+        %packed_weight_bias = prepacked::conv2d_transpose_clamp_prepack(
+            %weight, %bias, %stride, %padding, %output_padding, %dilation,
+            %groups, %dummy_min_max, %dummy_min_max)
+        %conv2d_res = prepacked::conv2d_transpose_clamp_run(%input, %packed_weight_bias)
+        %r = aten::relu_(%conv2d_res)
+        return (%r) )";
+
+  rewriter.RegisterRewritePattern(
+      conv2d_transpose_prepack_run_relu,
+      conv2d_transpose_prepack_run_relu_fused);
+  rewriter.RegisterRewritePattern(
+      conv2d_transpose_prepack_run_relu_inplace,
+      conv2d_transpose_prepack_run_relu_fused);
   rewriter.runOnGraph(graph, isClampFusable);
 }
 
@@ -268,6 +369,7 @@ void fuseReluWithPackedOps(std::shared_ptr<Graph>& graph) {
 void insertPrePackedOps(std::shared_ptr<Graph>& graph) {
   insertPrePackedLinearOp(graph);
   insertPrePackedConv2dOp(graph);
+  insertPrePackedConvTranspose2dOp(graph);
 }
 
 void insertPrePackedOps(script::Module& module) {
@@ -291,7 +393,9 @@ void FoldPrePackingOps(script::Module& m) {
     return (
         (n->kind() ==
          Symbol::fromQualString("prepacked::linear_clamp_prepack")) ||
-        n->kind() == Symbol::fromQualString("prepacked::conv2d_clamp_prepack"));
+        n->kind() == Symbol::fromQualString("prepacked::conv2d_clamp_prepack") ||
+        n->kind() ==
+            Symbol::fromQualString("prepacked::conv2d_transpose_clamp_prepack"));
   };
   PrePackingOpsFolder(m, filter_fn, "prepack_folding");
 }
@@ -302,6 +406,10 @@ c10::optional<script::Module> optimizeForMobile(const script::Module& m) {
   cloned_module = FoldConvBatchNorm2d(cloned_module);
   insertPrePackedOps(cloned_module);
   cloned_module = freeze_module(cloned_module);
+  // After freezing, forward has every call inlined and the clamp bounds are
+  // constants, so the relu/hardtanh epilogues can be folded into the
+  // prepacked ops before the packing itself is folded.
+  fusePrePackedLinearConvWithClamp(cloned_module);
   FoldPrePackingOps(cloned_module);
   return cloned_module;
 }
@@ -17,11 +17,16 @@
 #include <torch/csrc/jit/passes/dead_code_elimination.h>
 #include <torch/csrc/jit/passes/decompose_ops.h>
 #include <torch/csrc/jit/passes/erase_number_types.h>
+#include <torch/csrc/jit/passes/fork_independent_subgraphs.h>
 #include <torch/csrc/jit/passes/freeze_module.h>
+#include <torch/csrc/jit/passes/frozen_graph_optimizations.h>
+#include <torch/csrc/jit/passes/frozen_ops_to_mkldnn.h>
+#include <torch/csrc/jit/passes/fuse_epilogue.h>
 #include <torch/csrc/jit/passes/fuse_linear.h>
 #include <torch/csrc/jit/passes/graph_fuser.h>
 #include <torch/csrc/jit/passes/inline_fork_wait.h>
 #include <torch/csrc/jit/passes/inliner.h>
+#include <torch/csrc/jit/passes/insert_inplace_ops.h>
 #include <torch/csrc/jit/passes/loop_unrolling.h>
 #include <torch/csrc/jit/passes/lower_graph.h>
 #include <torch/csrc/jit/passes/lower_tuples.h>
@@ -36,6 +41,7 @@
 #include <torch/csrc/jit/passes/onnx/prepare_inplace_ops_for_onnx.h>
 #include <torch/csrc/jit/passes/onnx/scalar_type_analysis.h>
 #include <torch/csrc/jit/passes/onnx/unpack_quantized_weights.h>
+#include <torch/csrc/jit/passes/packed_linear.h>
 #include <torch/csrc/jit/passes/peephole.h>
 #include <torch/csrc/jit/passes/quantization.h>
 #include <torch/csrc/jit/passes/remove_expands.h>
@@ -58,6 +64,7 @@
 #include <torch/csrc/jit/runtime/graph_executor.h>
 #include <torch/csrc/jit/runtime/jit_exception.h>
 #include <torch/csrc/jit/runtime/operator.h>
+#include <torch/csrc/jit/runtime/planned_memory.h>
 #include <torch/csrc/jit/runtime/print_handler.h>
 #include <torch/csrc/jit/serialization/export.h>
 #include <torch/csrc/jit/serialization/import.h>
@@ -215,7 +222,18 @@ void initJITBindings(PyObject* module) {
           "_freeze_module",
           [](Module& module) { return freeze_module(module); },
           py::arg("module"))
+      .def("_jit_pass_pack_linear_weights", &PackLinearWeights)
+      .def(
+          "_jit_pass_optimize_frozen_graph",
+          [](std::shared_ptr<Graph>& g) { OptimizeFrozenGraph(g); })
+      .def(
+          "_jit_pass_optimize_frozen_module",
+          [](Module& module) { OptimizeFrozenModule(module); })
+      .def(
+          "_jit_pass_convert_frozen_ops_to_mkldnn",
+          [](Module& module) { ConvertFrozenOpsToMKLDNN(module); })
       .def("_jit_pass_fuse_linear", &FuseLinear)
+      .def("_jit_pass_fuse_conv_linear_epilogue", &FuseConvLinearEpilogue)
       .def(
           "_jit_pass_fold_quantize",
           [](Module& module, const std::string& method_name) {
@@ -267,6 +285,9 @@ void initJITBindings(PyObject* module) {
       .def(
           "_jit_pass_remove_inplace_ops",
           [](std::shared_ptr<Graph> g) { return RemoveInplaceOps(g); })
+      .def(
+          "_jit_pass_insert_inplace_ops",
+          [](std::shared_ptr<Graph>& g) { return InsertInplaceOps(g); })
       .def("_jit_pass_constant_pooling", ConstantPooling)
       .def(
           "_jit_pass_create_functional_graphs",
@@ -385,6 +406,9 @@ void initJITBindings(PyObject* module) {
       .def("_jit_pass_specialize_autogradzero", specializeAutogradZero)
       .def("_jit_override_can_fuse_on_cpu", &overrideCanFuseOnCPU)
       .def("_jit_override_can_fuse_on_gpu", &overrideCanFuseOnGPU)
+      .def(
+          "_jit_override_max_cached_kernels_per_fusion",
+          &overrideMaxCachedKernelsPerFusion)
       .def("_jit_can_fuse_on_cpu", &canFuseOnCPU)
       .def("_jit_can_fuse_on_gpu", &canFuseOnGPU)
       .def(
@@ -413,6 +437,20 @@ void initJITBindings(PyObject* module) {
             getProfilingMode() = profiling_flag;
             return oldState;
           })
+      .def(
+          "_jit_set_static_memory_planning",
+          [](bool planning_flag) {
+            bool oldState = getStaticMemoryPlanningMode();
+            getStaticMemoryPlanningMode() = planning_flag;
+            return oldState;
+          })
+      .def(
+          "_jit_set_auto_fork",
+          [](bool fork_flag) {
+            bool oldState = getAutoForkMode();
+            getAutoForkMode() = fork_flag;
+            return oldState;
+          })
       .def(
           "_jit_set_profiling_executor",
           [](bool profiling_flag) {
@@ -434,6 +472,13 @@ void initJITBindings(PyObject* module) {
             getBailoutDepth() = depth;
             return old_depth;
           })
+      .def(
+          "_jit_set_num_specialized_plans",
+          [](size_t num) {
+            size_t old_num = getNumSpecializedPlans();
+            getNumSpecializedPlans() = num;
+            return old_num;
+          })
       .def(
           "_jit_set_inline_everything_mode",
           [](bool enabled) { getInlineEverythingMode() = enabled; })
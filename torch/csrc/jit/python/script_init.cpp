@@ -821,11 +821,13 @@ void initJitScriptBindings(PyObject* module) {
           "_save_for_mobile",
           [](Module& m,
              const std::string& filename,
-             const ExtraFilesMap& _extra_files = ExtraFilesMap()) {
-            m._save_for_mobile(filename, _extra_files);
+             const ExtraFilesMap& _extra_files = ExtraFilesMap(),
+             bool _flat_bytecode = false) {
+            m._save_for_mobile(filename, _extra_files, _flat_bytecode);
           },
           py::arg("filename"),
-          py::arg("_extra_files") = ExtraFilesMap())
+          py::arg("_extra_files") = ExtraFilesMap(),
+          py::arg("_flat_bytecode") = false)
       .def("_set_optimized", &Module::set_optimized)
       .def(
           "dump",
@@ -1049,6 +1051,34 @@ void initJitScriptBindings(PyObject* module) {
             return self.function_->qualname().qualifiedName();
           });
 
+  // Tensor.register_hook of a ScriptFunction: the hook is registered as a C++
+  // hook of the tensor, which the autograd engine runs in the interpreter
+  // without taking the GIL, unlike the Python hooks.
+  m.def(
+      "_register_script_hook",
+      [](const at::Tensor& self, const StrongFunctionPtr& hook) {
+        const auto& schema = hook.function_->getSchema();
+        TORCH_CHECK(
+            schema.arguments().size() == 1 &&
+                schema.arguments()[0].type()->isSubtypeOf(TensorType::get()) &&
+                schema.returns().size() == 1 &&
+                schema.returns()[0].type()->isSubtypeOf(
+                    OptionalType::ofTensor()),
+            "A scripted tensor hook must take a Tensor and return a Tensor "
+            "or None, but ",
+            hook.function_->name(),
+            " has the schema ",
+            schema);
+        return self._register_hook(
+            [hook](const at::Tensor& grad) -> at::Tensor {
+              auto result = (*hook.function_)({grad});
+              return result.isNone() ? at::Tensor() : result.toTensor();
+            });
+      });
+  m.def("_remove_cpp_hook", [](const at::Tensor& self, unsigned pos) {
+    self.remove_hook(pos);
+  });
+
   py::class_<Method>(m, "ScriptMethod", py::dynamic_attr())
       .def(
           "__call__",
@@ -1324,6 +1354,12 @@ void initJitScriptBindings(PyObject* module) {
 
   m.def("_get_graph_executor_optimize", &torch::jit::getGraphExecutorOptimize);
 
+  m.def("_jit_set_lazy_compilation_on_load", &setLazyCompilationOnLoad);
+  m.def("_jit_get_lazy_compilation_on_load", &getLazyCompilationOnLoad);
+  m.def(
+      "_jit_compile_lazily_loaded_functions_async",
+      &compileLazilyLoadedFunctionsAsync);
+
   m.def("_create_module_with_type", [](const ClassTypePtr& type) {
     return Module(get_python_cu(), type);
   });
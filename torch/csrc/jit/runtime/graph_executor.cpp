@@ -15,6 +15,7 @@
 #include <torch/csrc/jit/passes/create_functional_graphs.h>
 #include <torch/csrc/jit/passes/dead_code_elimination.h>
 #include <torch/csrc/jit/passes/decompose_ops.h>
+#include <torch/csrc/jit/passes/fork_independent_subgraphs.h>
 #include <torch/csrc/jit/passes/graph_fuser.h>
 #include <torch/csrc/jit/passes/inline_autodiff_subgraphs.h>
 #include <torch/csrc/jit/passes/inliner.h>
@@ -787,6 +788,11 @@ void runNondiffOptimization(
   for (const auto& passPair : getCustomPostPasses()) {
     passPair.first(graph);
   }
+
+  // Run the independent parts of the graph concurrently
+  if (getAutoForkMode()) {
+    ForkIndependentSubgraphs(graph);
+  }
 }
 
 void runOptimization(std::shared_ptr<Graph>& graph, bool unroll) {
@@ -87,6 +87,10 @@ TORCH_API std::atomic<bool>& getProfilingMode();
 TORCH_API std::atomic<bool>& getExecutorMode();
 TORCH_API std::atomic<size_t>& getNumProfiledRuns();
 TORCH_API std::atomic<size_t>& getBailoutDepth();
+// Number of distinct sets of input shapes that the profiling executor keeps
+// a separately profiled and optimized plan for; inputs of any other shape
+// share one generic plan. Zero disables specialization.
+TORCH_API std::atomic<size_t>& getNumSpecializedPlans();
 TORCH_API bool IsNewExecutorEnabled();
 
 struct TORCH_API GraphOptimizerEnabledGuard {
@@ -19,6 +19,7 @@
 #include <torch/csrc/jit/runtime/instruction.h>
 #include <torch/csrc/jit/runtime/jit_exception.h>
 #include <torch/csrc/jit/runtime/operator.h>
+#include <torch/csrc/jit/runtime/planned_memory.h>
 #include <torch/csrc/jit/runtime/vararg_functions.h>
 
 #ifdef USE_DISTRIBUTED
@@ -377,6 +378,10 @@ struct CodeImpl {
       profile_function_table_;
 
   int register_size_ = 0;
+  // high-water marks of the stack (above the inputs) and of the registers of
+  // the previous runs of this code, used to size them ahead in the next runs
+  std::atomic<size_t> stack_size_hint_{0};
+  std::atomic<size_t> register_size_hint_{0};
   size_t n_outputs;
   size_t n_inputs;
   TypePtr return_type_;
@@ -390,6 +395,8 @@ struct CodeImpl {
   std::shared_ptr<Graph> graph_;
   c10::optional<std::vector<GraphExecutor*>> grad_executors_;
   PreprocessGraph preprocess_;
+  // set if the memory of graph_ was planned, see getStaticMemoryPlanningMode
+  std::shared_ptr<PlannedMemory> planned_memory_;
 
   // map from unique of nodes to register in register table
   std::unordered_map<Value*, int> value_to_reg_;
@@ -425,6 +432,11 @@ struct CodeImpl {
           fmap(graph->outputs(), [](const Value* v) { return v->type(); }));
     }
     n_inputs = graph_->inputs().size();
+    if (getStaticMemoryPlanningMode()) {
+      if (auto plan = PlanStaticMemory(graph_)) {
+        planned_memory_ = std::make_shared<PlannedMemory>(std::move(*plan));
+      }
+    }
     // std::cout << *graph_ << "\n";
     emitCodeForBlock(graph_->block());
     insertInstruction(RET);
@@ -556,7 +568,11 @@ struct CodeImpl {
     } else {
       insertInstruction(OP, operator_table_.size());
     }
-    operator_table_.emplace_back(op.getOperation(node));
+    Operation operation = op.getOperation(node);
+    if (planned_memory_) {
+      operation = planned_memory_->wrap(node, std::move(operation));
+    }
+    operator_table_.emplace_back(std::move(operation));
   }
 
   void emitWait(Node* node) {
@@ -902,6 +918,8 @@ struct CodeImpl {
 // InterpreterState state that and used to compute a Code
 struct InterpreterStateImpl : c10::intrusive_ptr_target {
   InterpreterStateImpl(const Code& code) {
+    registers.reserve(
+        code.pImpl->register_size_hint_.load(std::memory_order_relaxed));
     enterFrame(code, 0);
   }
 
@@ -1405,14 +1423,45 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
     return future_;
   }
 
+  // The stack is sized ahead from the previous runs, so that function calls
+  // and container construction do not reallocate it while running.  Returns
+  // where the stack of this code starts.
+  size_t reserveStack(Stack& stack) {
+    const CodeImpl& code = *frames.front().function;
+    const size_t stack_base =
+        stack.size() >= code.n_inputs ? stack.size() - code.n_inputs : 0;
+    stack.reserve(
+        stack_base + code.stack_size_hint_.load(std::memory_order_relaxed));
+    return stack_base;
+  }
+
+  void updateSizeHints(const Stack& stack, size_t stack_base) {
+    // the capacities overestimate the high-water marks by at most a factor
+    // of two, and stay put once the vectors are reserved from them
+    auto update = [](std::atomic<size_t>& hint, size_t size) {
+      size = std::min<size_t>(size, 4096);
+      if (size > hint.load(std::memory_order_relaxed)) {
+        hint.store(size, std::memory_order_relaxed);
+      }
+    };
+    CodeImpl& code = *frames.front().function;
+    update(code.stack_size_hint_, stack.capacity() - stack_base);
+    update(code.register_size_hint_, registers.capacity());
+  }
+
   c10::intrusive_ptr<Future> runAsync(Stack& stack) {
     getOrCreateFuture();
+    const size_t stack_base = reserveStack(stack);
     runImpl(stack);
+    updateSizeHints(stack, stack_base);
     return future_;
   }
 
   void run(Stack& stack) {
-    if (runImpl(stack)) {
+    const size_t stack_base = reserveStack(stack);
+    const bool suspended = runImpl(stack);
+    updateSizeHints(stack, stack_base);
+    if (suspended) {
       future_->wait();
 
       auto num_outputs = frames.front().function->n_outputs;
@@ -0,0 +1,145 @@
+#include <torch/csrc/jit/runtime/planned_memory.h>
+
+#include <ATen/core/grad_mode.h>
+#include <c10/core/CPUAllocator.h>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+void releaseSlab(void* in_use) {
+  static_cast<std::atomic<bool>*>(in_use)->store(
+      false, std::memory_order_release);
+}
+
+// Installed on the thread running a planned node, on top of the CPU
+// allocator it would otherwise use.
+struct PlannedCPUAllocator final : public at::Allocator {
+  PlannedCPUAllocator(
+      PlannedMemory::Arena* arena,
+      const std::vector<PlannedMemory::SlabInfo>& slabs,
+      const std::vector<size_t>& node_slabs)
+      : wrapped_(c10::GetCPUAllocator()),
+        arena_(arena),
+        slabs_(slabs),
+        node_slabs_(node_slabs) {}
+
+  at::DataPtr allocate(size_t nbytes) const override {
+    for (size_t i : node_slabs_) {
+      const auto& info = slabs_[i];
+      if (info.slab.size != nbytes || !isFree(i)) {
+        continue;
+      }
+      bool overlapping_free = true;
+      for (size_t j : info.overlapping) {
+        overlapping_free = overlapping_free && isFree(j);
+      }
+      if (!overlapping_free) {
+        continue;
+      }
+      // Only this thread hands out the slabs of its arena, so nothing can
+      // claim the slab between the checks and here.
+      arena_->in_use[i].store(true, std::memory_order_relaxed);
+      // Released by the deleter. The context is not the data, which also
+      // makes raw_allocate reject the slab.
+      return {static_cast<uint8_t*>(arena_->memory.get()) + info.slab.offset,
+              &arena_->in_use[i],
+              &releaseSlab,
+              at::Device(at::DeviceType::CPU)};
+    }
+    return wrapped_->allocate(nbytes);
+  }
+
+  at::DeleterFnPtr raw_deleter() const override {
+    return wrapped_->raw_deleter();
+  }
+
+ private:
+  bool isFree(size_t i) const {
+    return !arena_->in_use[i].load(std::memory_order_acquire);
+  }
+
+  at::Allocator* wrapped_;
+  PlannedMemory::Arena* arena_;
+  const std::vector<PlannedMemory::SlabInfo>& slabs_;
+  const std::vector<size_t>& node_slabs_;
+};
+
+std::atomic<uint64_t> next_plan_id{1};
+
+// single entry cache in front of PlannedMemory::arenas_
+struct ArenaCacheEntry {
+  uint64_t id = 0;
+  PlannedMemory::Arena* arena = nullptr;
+};
+
+thread_local ArenaCacheEntry arena_cache;
+
+} // namespace
+
+std::atomic<bool>& getStaticMemoryPlanningMode() {
+  static std::atomic<bool> static_memory_planning_mode{false};
+  return static_memory_planning_mode;
+}
+
+PlannedMemory::PlannedMemory(MemoryPlan plan)
+    : plan_(std::move(plan)), id_(next_plan_id++) {
+  for (const auto& node_slabs : plan_.node_slabs) {
+    auto& ids = node_slabs_[node_slabs.first];
+    for (const auto& slab : node_slabs.second) {
+      ids.push_back(slabs_.size());
+      slabs_.push_back({slab, {}});
+    }
+  }
+  for (size_t i = 0; i < slabs_.size(); ++i) {
+    for (size_t j = i + 1; j < slabs_.size(); ++j) {
+      const auto& a = slabs_[i].slab;
+      const auto& b = slabs_[j].slab;
+      if (a.offset < b.offset + b.size && b.offset < a.offset + a.size) {
+        slabs_[i].overlapping.push_back(j);
+        slabs_[j].overlapping.push_back(i);
+      }
+    }
+  }
+}
+
+PlannedMemory::Arena* PlannedMemory::arenaForCurrentThread() {
+  if (arena_cache.id == id_) {
+    return arena_cache.arena;
+  }
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto& arena = arenas_[std::this_thread::get_id()];
+  if (!arena) {
+    arena = std::make_unique<Arena>();
+    arena->memory = c10::GetCPUAllocator()->allocate(plan_.arena_size);
+    arena->in_use.reset(new std::atomic<bool>[slabs_.size()]);
+    for (size_t i = 0; i < slabs_.size(); ++i) {
+      arena->in_use[i].store(false, std::memory_order_relaxed);
+    }
+  }
+  arena_cache.id = id_;
+  arena_cache.arena = arena.get();
+  return arena_cache.arena;
+}
+
+Operation PlannedMemory::wrap(const Node* node, Operation op) {
+  auto it = node_slabs_.find(node);
+  if (it == node_slabs_.end()) {
+    return op;
+  }
+  const std::vector<size_t>* node_slabs = &it->second;
+  auto self = shared_from_this();
+  return [self, node_slabs, op](Stack& stack) {
+    if (at::GradMode::is_enabled()) {
+      return op(stack);
+    }
+    PlannedCPUAllocator allocator(
+        self->arenaForCurrentThread(), self->slabs_, *node_slabs);
+    c10::ThreadLocalCPUAllocatorGuard guard(&allocator);
+    return op(stack);
+  };
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <ATen/core/stack.h>
+#include <c10/core/Allocator.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/passes/memory_planning.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace torch {
+namespace jit {
+
+// When set, the interpreter plans the memory of straight-line graphs with
+// PlanStaticMemory and serves their intermediate tensors from one arena.
+TORCH_API std::atomic<bool>& getStaticMemoryPlanningMode();
+
+// Executes a MemoryPlan. Each thread running the planned code gets its own
+// arena of plan.arena_size bytes, allocated on first use and reused by all
+// later runs on that thread.
+//
+// Operators allocate their own outputs, so the plan is applied by a CPU
+// allocator that is only installed on the running thread, for the duration of
+// each planned node (see c10::ThreadLocalCPUAllocatorGuard): an allocation
+// whose size is exactly that of one of the node's planned outputs is placed in
+// that output's slab. A slab is only handed out while no tensor holds it or
+// any part of the arena it overlaps, so memory that is still in use, e.g. by a
+// tensor that took a slab it was not planned for, is never reused. Other
+// allocations, and all allocations made while grad mode is enabled (autograd
+// may save an intermediate past the end of the run), go to the regular CPU
+// allocator.
+struct TORCH_API PlannedMemory
+    : public std::enable_shared_from_this<PlannedMemory> {
+  explicit PlannedMemory(MemoryPlan plan);
+
+  // Returns `op` made to allocate the planned outputs of `node` in the arena.
+  Operation wrap(const Node* node, Operation op);
+
+  const MemoryPlan& plan() const {
+    return plan_;
+  }
+
+  // The arena of a thread, and whether each slab is held by a tensor
+  struct Arena {
+    at::DataPtr memory;
+    std::unique_ptr<std::atomic<bool>[]> in_use;
+  };
+
+  // A slab of the plan, with the slabs sharing part of the arena with it
+  struct SlabInfo {
+    MemoryPlan::Slab slab;
+    std::vector<size_t> overlapping;
+  };
+
+ private:
+  Arena* arenaForCurrentThread();
+
+  MemoryPlan plan_;
+  std::vector<SlabInfo> slabs_;
+  // indices in slabs_ of the planned outputs of each node
+  std::unordered_map<const Node*, std::vector<size_t>> node_slabs_;
+  // distinguishes this plan in the per-thread arena cache
+  const uint64_t id_;
+  std::mutex mutex_;
+  std::unordered_map<std::thread::id, std::unique_ptr<Arena>> arenas_;
+};
+
+} // namespace jit
+} // namespace torch
@@ -1,5 +1,6 @@
 #include <torch/csrc/jit/runtime/profiling_graph_executor_impl.h>
 #include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/runtime/interpreter.h>
 #include <torch/csrc/jit/passes/bailout_graph.h>
 #include <torch/csrc/jit/passes/canonicalize_ops.h>
 #include <torch/csrc/jit/passes/clear_profiling.h>
@@ -44,6 +45,7 @@ static std::atomic<bool> profiling_mode{false};
 
 static std::atomic<size_t> num_profiled_runs{1};
 static std::atomic<size_t> bailout_depth{1};
+static std::atomic<size_t> num_specialized_plans{0};
 
 std::atomic<bool>& getProfilingMode() {
   return profiling_mode;
@@ -60,6 +62,10 @@ std::atomic<size_t>& getBailoutDepth() {
   return bailout_depth;
 }
 
+std::atomic<size_t>& getNumSpecializedPlans() {
+  return num_specialized_plans;
+}
+
 static bool needsGradientInProfilingMode(Block* b) {
   for (auto n : b->nodes()) {
     if (n->kind() == prim::BailOut) {
@@ -152,54 +158,113 @@ ProfilingGraphExecutorImpl::ProfilingGraphExecutorImpl(
     std::string function_name)
     : GraphExecutorImplBase(graph, std::move(function_name)) {}
 
-ExecutionPlan ProfilingGraphExecutorImpl::getPlanFor(
-    Stack& stack,
+ExecutionPlan ProfilingGraphExecutorImpl::getProfiledPlanFor(
+    ProfiledPlan& plan,
     size_t remaining_bailout_depth) {
-  std::lock_guard<std::mutex> lock(compile_mutex);
-  GRAPH_DEBUG("Running ProfilingGraphExecutorImpl ", this);
-
-  if (optimized_plan_) {
-    return *optimized_plan_;
-  }
-
-  // simple executor
-  if (remaining_bailout_depth == 0) {
-    auto copy = graph->copy();
-    runProfilingInsensitiveOptimizations(copy);
-    GRAPH_DUMP("Optimized SimpleExecutor Graph : ", copy);
-    optimized_plan_ = ExecutionPlan(copy, function_name_);
-    return *optimized_plan_;
+  if (plan.optimized_plan) {
+    return *plan.optimized_plan;
   }
 
   // if a profiling graph hasn't been created yet
-  if (!pr_) {
+  if (!plan.pr) {
     auto copy = graph->copy();
     runProfilingInsensitiveOptimizations(copy);
-    pr_ = ProfilingRecord::instrumentGraph(copy);
-    auto pr_copy = pr_->graph()->copy();
+    plan.pr = ProfilingRecord::instrumentGraph(copy);
+    auto pr_copy = plan.pr->graph()->copy();
     GRAPH_DUMP("Profiled Graph: ", pr_copy);
-    profiling_plan_ = ExecutionPlan(pr_copy, function_name_);
+    plan.profiling_plan = ExecutionPlan(pr_copy, function_name_);
     // fall-through
   }
 
   // profile until a graph is ready
-  if (!pr_->ready()) {
-    return *profiling_plan_;
+  if (!plan.pr->ready()) {
+    return *plan.profiling_plan;
   }
 
-  auto copy = pr_->graph()->copy();
+  auto copy = plan.pr->graph()->copy();
   runProfilingOptimizations(copy);
   // cache
-  optimized_plan_ =
+  plan.optimized_plan =
       ExecutionPlan(copy, function_name_, remaining_bailout_depth);
-  return *optimized_plan_;
+  return *plan.optimized_plan;
+}
+
+ProfilingGraphExecutorImpl::SpecializedPlan* ProfilingGraphExecutorImpl::
+    getSpecializedPlanFor(const Stack& stack) {
+  auto inputs = last(stack, graph->inputs().size());
+  for (auto& specialized : specialized_plans_) {
+    bool matches = true;
+    for (size_t i = 0; i < inputs.size() && matches; i++) {
+      const auto& expected = specialized.input_types[i];
+      if (!expected) {
+        continue;
+      }
+      // the same check a prim::Guard does
+      matches = inputs[i].isTensor() &&
+          tensorTypeInCurrentExecutionContext(inputs[i].toTensor())
+              ->isSubtypeOf(expected);
+    }
+    if (matches) {
+      return &specialized;
+    }
+  }
+
+  if (specialized_plans_.size() >= getNumSpecializedPlans()) {
+    return nullptr;
+  }
+  SpecializedPlan specialized;
+  specialized.input_types.reserve(inputs.size());
+  for (const auto& input : inputs) {
+    specialized.input_types.push_back(
+        input.isTensor()
+            ? tensorTypeInCurrentExecutionContext(input.toTensor())
+            : nullptr);
+  }
+  GRAPH_DEBUG(
+      "Adding specialized plan ",
+      specialized_plans_.size(),
+      " for ",
+      this);
+  specialized_plans_.push_back(std::move(specialized));
+  return &specialized_plans_.back();
+}
+
+ExecutionPlan ProfilingGraphExecutorImpl::getPlanFor(
+    Stack& stack,
+    size_t remaining_bailout_depth) {
+  std::lock_guard<std::mutex> lock(compile_mutex);
+  GRAPH_DEBUG("Running ProfilingGraphExecutorImpl ", this);
+
+  if (generic_plan_.optimized_plan && specialized_plans_.empty() &&
+      getNumSpecializedPlans() == 0) {
+    return *generic_plan_.optimized_plan;
+  }
+
+  // simple executor
+  if (remaining_bailout_depth == 0) {
+    if (!generic_plan_.optimized_plan) {
+      auto copy = graph->copy();
+      runProfilingInsensitiveOptimizations(copy);
+      GRAPH_DUMP("Optimized SimpleExecutor Graph : ", copy);
+      generic_plan_.optimized_plan = ExecutionPlan(copy, function_name_);
+    }
+    return *generic_plan_.optimized_plan;
+  }
+
+  if (auto specialized = getSpecializedPlanFor(stack)) {
+    return getProfiledPlanFor(specialized->plan, remaining_bailout_depth);
+  }
+  return getProfiledPlanFor(generic_plan_, remaining_bailout_depth);
 }
 
 GraphExecutorState ProfilingGraphExecutorImpl::getDebugState() {
   GraphExecutorState state;
-  TORCH_INTERNAL_ASSERT(optimized_plan_);
-  auto opt_plan = *optimized_plan_;
-  state.execution_plans.emplace(ArgumentSpec{0, 0}, opt_plan);
+  const c10::optional<ExecutionPlan>* opt_plan = &generic_plan_.optimized_plan;
+  if (!*opt_plan && !specialized_plans_.empty()) {
+    opt_plan = &specialized_plans_.front().plan.optimized_plan;
+  }
+  TORCH_INTERNAL_ASSERT(*opt_plan);
+  state.execution_plans.emplace(ArgumentSpec{0, 0}, **opt_plan);
   return state;
 }
 
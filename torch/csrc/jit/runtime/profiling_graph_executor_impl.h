@@ -15,12 +15,35 @@ struct ProfilingGraphExecutorImpl : public GraphExecutorImplBase {
   ~ProfilingGraphExecutorImpl() override = default;
 
  private:
+  // A plan that is profiled for a number of runs before it is optimized.
+  struct ProfiledPlan {
+    std::unique_ptr<ProfilingRecord> pr;
+    c10::optional<ExecutionPlan>
+        profiling_plan; // plan to run in order to profiling the code
+    c10::optional<ExecutionPlan> optimized_plan;
+  };
+
+  // A plan that is only used for inputs of one exact set of tensor types
+  // (sizes, strides, dtype, device, requires_grad), so it is profiled and
+  // optimized for nothing else.
+  struct SpecializedPlan {
+    // one entry per graph input, nullptr for non-tensor inputs
+    std::vector<TensorTypePtr> input_types;
+    ProfiledPlan plan;
+  };
+
   void runProfilingInsensitiveOptimizations(std::shared_ptr<Graph>& graph);
   void runProfilingOptimizations(std::shared_ptr<Graph>& graph);
-  std::unique_ptr<ProfilingRecord> pr_;
-  c10::optional<ExecutionPlan>
-      profiling_plan_; // plan to run in order to profiling the code
-  c10::optional<ExecutionPlan> optimized_plan_;
+  ExecutionPlan getProfiledPlanFor(
+      ProfiledPlan& plan,
+      size_t remaining_bailout_depth);
+  // Returns the specialized plan matching the inputs on the stack, creating
+  // a new one while fewer than getNumSpecializedPlans() exist.
+  SpecializedPlan* getSpecializedPlanFor(const Stack& stack);
+
+  // used for every input that doesn't get a specialized plan
+  ProfiledPlan generic_plan_;
+  std::vector<SpecializedPlan> specialized_plans_;
 };
 
 } // namespace jit
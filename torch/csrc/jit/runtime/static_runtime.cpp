@@ -0,0 +1,407 @@
+#include <torch/csrc/jit/runtime/static_runtime.h>
+
+#include <ATen/ATen.h>
+#include <ATen/core/grad_mode.h>
+#include <torch/csrc/jit/ir/alias_analysis.h>
+#include <torch/csrc/jit/ir/constants.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/freeze_module.h>
+#include <torch/csrc/jit/passes/inliner.h>
+#include <torch/csrc/jit/runtime/operator.h>
+#include <torch/csrc/jit/runtime/vararg_functions.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+using ProcessedNode = StaticRuntime::ProcessedNode;
+
+at::Tensor input(const ProcessedNode& p, c10::IValue* slots, size_t i) {
+  return slots[p.inputs[i]].toTensor();
+}
+
+// Writes the result of a node with an out= variant: into the tensor left in
+// its output slot by the previous run if there is one and the node may reuse
+// it, otherwise into a fresh tensor from the functional variant.
+template <typename Functional, typename Out>
+void runWithOut(
+    const ProcessedNode& p,
+    c10::IValue* slots,
+    const Functional& functional,
+    const Out& out_variant) {
+  c10::IValue& out = slots[p.outputs[0]];
+  if (p.reuse_output && out.isTensor()) {
+    at::Tensor t = out.toTensor();
+    out_variant(t);
+  } else {
+    out = functional();
+  }
+}
+
+void add_kernel(const ProcessedNode& p, c10::IValue* s) {
+  auto self = input(p, s, 0);
+  auto other = input(p, s, 1);
+  auto alpha = s[p.inputs[2]].toScalar();
+  runWithOut(
+      p,
+      s,
+      [&] { return at::add(self, other, alpha); },
+      [&](at::Tensor& out) { at::add_out(out, self, other, alpha); });
+}
+
+void sub_kernel(const ProcessedNode& p, c10::IValue* s) {
+  auto self = input(p, s, 0);
+  auto other = input(p, s, 1);
+  auto alpha = s[p.inputs[2]].toScalar();
+  runWithOut(
+      p,
+      s,
+      [&] { return at::sub(self, other, alpha); },
+      [&](at::Tensor& out) { at::sub_out(out, self, other, alpha); });
+}
+
+void mul_kernel(const ProcessedNode& p, c10::IValue* s) {
+  auto self = input(p, s, 0);
+  auto other = input(p, s, 1);
+  runWithOut(
+      p,
+      s,
+      [&] { return at::mul(self, other); },
+      [&](at::Tensor& out) { at::mul_out(out, self, other); });
+}
+
+void div_kernel(const ProcessedNode& p, c10::IValue* s) {
+  auto self = input(p, s, 0);
+  auto other = input(p, s, 1);
+  runWithOut(
+      p,
+      s,
+      [&] { return at::div(self, other); },
+      [&](at::Tensor& out) { at::div_out(out, self, other); });
+}
+
+void mm_kernel(const ProcessedNode& p, c10::IValue* s) {
+  auto self = input(p, s, 0);
+  auto mat2 = input(p, s, 1);
+  runWithOut(
+      p,
+      s,
+      [&] { return at::mm(self, mat2); },
+      [&](at::Tensor& out) { at::mm_out(out, self, mat2); });
+}
+
+void bmm_kernel(const ProcessedNode& p, c10::IValue* s) {
+  auto self = input(p, s, 0);
+  auto mat2 = input(p, s, 1);
+  runWithOut(
+      p,
+      s,
+      [&] { return at::bmm(self, mat2); },
+      [&](at::Tensor& out) { at::bmm_out(out, self, mat2); });
+}
+
+void addmm_kernel(const ProcessedNode& p, c10::IValue* s) {
+  auto self = input(p, s, 0);
+  auto mat1 = input(p, s, 1);
+  auto mat2 = input(p, s, 2);
+  auto beta = s[p.inputs[3]].toScalar();
+  auto alpha = s[p.inputs[4]].toScalar();
+  runWithOut(
+      p,
+      s,
+      [&] { return at::addmm(self, mat1, mat2, beta, alpha); },
+      [&](at::Tensor& out) {
+        at::addmm_out(out, self, mat1, mat2, beta, alpha);
+      });
+}
+
+void relu_kernel(const ProcessedNode& p, c10::IValue* s) {
+  auto self = input(p, s, 0);
+  runWithOut(
+      p,
+      s,
+      [&] { return at::relu(self); },
+      [&](at::Tensor& out) { at::threshold_out(out, self, 0, 0); });
+}
+
+void sigmoid_kernel(const ProcessedNode& p, c10::IValue* s) {
+  auto self = input(p, s, 0);
+  runWithOut(
+      p,
+      s,
+      [&] { return at::sigmoid(self); },
+      [&](at::Tensor& out) { at::sigmoid_out(out, self); });
+}
+
+void tanh_kernel(const ProcessedNode& p, c10::IValue* s) {
+  auto self = input(p, s, 0);
+  runWithOut(
+      p,
+      s,
+      [&] { return at::tanh(self); },
+      [&](at::Tensor& out) { at::tanh_out(out, self); });
+}
+
+void linear_kernel(const ProcessedNode& p, c10::IValue* s) {
+  auto self = input(p, s, 0);
+  auto weight = input(p, s, 1);
+  const auto& bias = s[p.inputs[2]];
+  s[p.outputs[0]] =
+      at::linear(self, weight, bias.isNone() ? at::Tensor() : bias.toTensor());
+}
+
+void matmul_kernel(const ProcessedNode& p, c10::IValue* s) {
+  s[p.outputs[0]] = at::matmul(input(p, s, 0), input(p, s, 1));
+}
+
+struct KernelEntry {
+  const char* schema;
+  StaticRuntime::Kernel kernel;
+  bool has_out_variant;
+};
+
+const std::vector<KernelEntry>& unboxedKernels() {
+  static const std::vector<KernelEntry> kernels = {
+      {"aten::add(Tensor self, Tensor other, *, Scalar alpha) -> Tensor",
+       add_kernel,
+       true},
+      {"aten::sub(Tensor self, Tensor other, *, Scalar alpha) -> Tensor",
+       sub_kernel,
+       true},
+      {"aten::mul(Tensor self, Tensor other) -> Tensor", mul_kernel, true},
+      {"aten::div(Tensor self, Tensor other) -> Tensor", div_kernel, true},
+      {"aten::mm(Tensor self, Tensor mat2) -> Tensor", mm_kernel, true},
+      {"aten::bmm(Tensor self, Tensor mat2) -> Tensor", bmm_kernel, true},
+      {"aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta, Scalar alpha) -> Tensor",
+       addmm_kernel,
+       true},
+      {"aten::relu(Tensor self) -> Tensor", relu_kernel, true},
+      {"aten::sigmoid(Tensor self) -> Tensor", sigmoid_kernel, true},
+      {"aten::tanh(Tensor self) -> Tensor", tanh_kernel, true},
+      {"aten::linear(Tensor input, Tensor weight, Tensor? bias) -> Tensor",
+       linear_kernel,
+       false},
+      {"aten::matmul(Tensor self, Tensor other) -> Tensor",
+       matmul_kernel,
+       false},
+  };
+  return kernels;
+}
+
+// The boxed implementation of a node, for the node kinds the interpreter
+// implements with dedicated instructions as well as for operators.
+Operation boxedOperation(Node* node) {
+  const size_t num_inputs = node->inputs().size();
+  const size_t num_outputs = node->outputs().size();
+  switch (node->kind()) {
+    case prim::TupleConstruct:
+      return [num_inputs](Stack& stack) {
+        tupleConstruct(stack, num_inputs);
+        return 0;
+      };
+    case prim::ListConstruct: {
+      auto type = node->output()->type()->expect<ListType>();
+      return [type, num_inputs](Stack& stack) {
+        listConstruct(stack, type, num_inputs);
+        return 0;
+      };
+    }
+    case prim::DictConstruct: {
+      auto type = node->output()->type()->expect<DictType>();
+      return [type, num_inputs](Stack& stack) {
+        dictConstruct(stack, type, num_inputs);
+        return 0;
+      };
+    }
+    case prim::ListUnpack:
+      return [num_outputs](Stack& stack) {
+        listUnpack(stack, num_outputs);
+        return 0;
+      };
+    case prim::GetAttr: {
+      const auto type = node->input()->type()->expect<ClassType>();
+      const auto slot = type->getAttributeSlot(node->s(attr::name));
+      return [slot](Stack& stack) {
+        auto obj = pop(stack).toObject();
+        push(stack, obj->getSlot(slot));
+        return 0;
+      };
+    }
+    default:
+      break;
+  }
+  TORCH_CHECK(
+      node->maybeOperator(),
+      "StaticRuntime does not support ",
+      node->kind().toQualString(),
+      " nodes");
+  const Operator& op = node->getOperator();
+  Operation operation = op.getOperation(node);
+  if (op.schema().is_vararg()) {
+    // vararg operators expect the number of inputs on top of the stack
+    return [operation, num_inputs](Stack& stack) {
+      push(stack, static_cast<int64_t>(num_inputs));
+      return operation(stack);
+    };
+  }
+  return operation;
+}
+
+} // namespace
+
+StaticRuntime::StaticRuntime(std::shared_ptr<Graph> graph)
+    : graph_(graph->copy()) {
+  Inline(*graph_);
+  init();
+}
+
+StaticRuntime::StaticRuntime(const Module& module) {
+  Module frozen = freeze_module(module);
+  graph_ = frozen.get_method("forward").graph()->copy();
+  Inline(*graph_);
+  EliminateDeadCode(graph_);
+  // Attributes that were not folded by freezing are still read from self.
+  if (graph_->inputs().at(0)->hasUses()) {
+    self_ = frozen._ivalue();
+  } else {
+    graph_->eraseInput(0);
+  }
+  init();
+}
+
+void StaticRuntime::init() {
+  std::unordered_map<const Value*, size_t> value_to_slot;
+  auto slotOf = [&](const Value* v) {
+    auto it = value_to_slot.find(v);
+    TORCH_INTERNAL_ASSERT(it != value_to_slot.end());
+    return it->second;
+  };
+  auto newSlot = [&](const Value* v) {
+    const size_t slot = slots_.size();
+    slots_.emplace_back();
+    value_to_slot[v] = slot;
+    return slot;
+  };
+
+  for (const Value* v : graph_->inputs()) {
+    input_slots_.push_back(newSlot(v));
+  }
+
+  AliasDb alias_db(graph_);
+  for (Node* node : graph_->nodes()) {
+    TORCH_CHECK(
+        node->blocks().empty(),
+        "StaticRuntime does not support control flow, found ",
+        node->kind().toQualString());
+    TORCH_CHECK(
+        node->kind() != prim::fork && node->kind() != aten::wait &&
+            node->kind() != prim::CallFunction &&
+            node->kind() != prim::CallMethod,
+        "StaticRuntime does not support ",
+        node->kind().toQualString(),
+        " nodes");
+    if (node->kind() == prim::Constant) {
+      slots_.at(newSlot(node->output())) = toIValue(node->output()).value();
+      continue;
+    }
+
+    ProcessedNode p;
+    p.node = node;
+    for (const Value* v : node->inputs()) {
+      p.inputs.push_back(slotOf(v));
+    }
+    for (const Value* v : node->outputs()) {
+      p.outputs.push_back(newSlot(v));
+    }
+    for (const auto& entry : unboxedKernels()) {
+      if (node->matches(entry.schema)) {
+        p.kernel = entry.kernel;
+        // A tensor that escapes through a graph output or aliases an input
+        // cannot be overwritten by the next run.
+        p.reuse_output = entry.has_out_variant &&
+            !alias_db.mayContainAlias(node->output(), graph_->outputs()) &&
+            !alias_db.mayContainAlias(node->output(), graph_->inputs());
+        break;
+      }
+    }
+    if (!p.kernel) {
+      p.op = boxedOperation(node);
+    }
+    if (!p.reuse_output) {
+      for (size_t slot : p.outputs) {
+        transient_slots_.push_back(slot);
+      }
+    }
+    nodes_.push_back(std::move(p));
+  }
+
+  for (const Value* v : graph_->outputs()) {
+    output_slots_.push_back(slotOf(v));
+  }
+}
+
+size_t StaticRuntime::num_unboxed_nodes() const {
+  return std::count_if(nodes_.begin(), nodes_.end(), [](const ProcessedNode& p) {
+    return p.kernel != nullptr;
+  });
+}
+
+c10::IValue StaticRuntime::run(std::vector<c10::IValue> inputs) {
+  if (self_) {
+    inputs.insert(inputs.begin(), *self_);
+  }
+  TORCH_CHECK(
+      inputs.size() == input_slots_.size(),
+      "StaticRuntime expected ",
+      input_slots_.size(),
+      " inputs but got ",
+      inputs.size());
+  at::AutoGradMode no_grad(false);
+
+  // left over if a boxed operation threw in the previous run
+  stack_.clear();
+  c10::IValue* slots = slots_.data();
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    slots[input_slots_[i]] = std::move(inputs[i]);
+  }
+  for (const ProcessedNode& p : nodes_) {
+    if (p.kernel) {
+      p.kernel(p, slots);
+      continue;
+    }
+    for (size_t slot : p.inputs) {
+      stack_.push_back(slots[slot]);
+    }
+    p.op(stack_);
+    TORCH_INTERNAL_ASSERT(stack_.size() == p.outputs.size());
+    for (size_t i = 0; i < p.outputs.size(); ++i) {
+      slots[p.outputs[i]] = std::move(stack_[i]);
+    }
+    stack_.clear();
+  }
+
+  std::vector<c10::IValue> outputs;
+  outputs.reserve(output_slots_.size());
+  for (size_t slot : output_slots_) {
+    outputs.push_back(slots[slot]);
+  }
+  // Do not keep the inputs and the values that were not preallocated alive
+  // until the next run.
+  for (size_t slot : input_slots_) {
+    slots[slot] = c10::IValue();
+  }
+  for (size_t slot : transient_slots_) {
+    slots[slot] = c10::IValue();
+  }
+  if (outputs.size() == 1) {
+    return std::move(outputs[0]);
+  }
+  return c10::ivalue::Tuple::create(std::move(outputs));
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <ATen/core/ivalue.h>
+#include <ATen/core/stack.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/api/module.h>
+#include <torch/csrc/jit/ir/ir.h>
+
+#include <memory>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+// An executor for frozen, fully inlined inference graphs.
+//
+// Where the interpreter decodes instructions and moves every value through
+// its stack, StaticRuntime resolves the graph once into a flat list of nodes
+// whose inputs and outputs are indices into a preallocated array of value
+// slots, and runs them back to back. Common operators are executed by
+// unboxed kernels that read their arguments straight from the slots; for
+// those that have an out= variant, the output tensor of an intermediate is
+// kept across runs and written in place on the next run. All other operators
+// go through their boxed Operation.
+//
+// The graph must not have control flow, forks or calls, and runs with grad
+// mode disabled. Reusing outputs assumes every run sees inputs of the same
+// dtypes and devices. A StaticRuntime is not thread-safe; create one per
+// thread.
+class TORCH_API StaticRuntime {
+ public:
+  explicit StaticRuntime(std::shared_ptr<Graph> graph);
+
+  // Freezes `module`, which must be in eval mode, and runs its forward.
+  explicit StaticRuntime(const Module& module);
+
+  // Returns the single output of the graph, or a tuple of all its outputs.
+  c10::IValue run(std::vector<c10::IValue> inputs);
+
+  const std::shared_ptr<Graph>& graph() const {
+    return graph_;
+  }
+
+  // the number of nodes executed by an unboxed kernel
+  size_t num_unboxed_nodes() const;
+
+  struct ProcessedNode;
+  using Kernel = void (*)(const ProcessedNode&, c10::IValue* slots);
+
+  struct ProcessedNode {
+    Node* node;
+    std::vector<size_t> inputs; // slot indices
+    std::vector<size_t> outputs; // slot indices
+    Kernel kernel = nullptr; // unboxed implementation, if any
+    Operation op; // boxed implementation, used if there is no kernel
+    // the output tensor of the previous run may be written again
+    bool reuse_output = false;
+  };
+
+ private:
+  void init();
+
+  std::shared_ptr<Graph> graph_;
+  // prepended to the inputs of each run when running a module's forward
+  c10::optional<c10::IValue> self_;
+  std::vector<c10::IValue> slots_;
+  std::vector<ProcessedNode> nodes_;
+  std::vector<size_t> input_slots_;
+  std::vector<size_t> output_slots_;
+  // slots released at the end of every run
+  std::vector<size_t> transient_slots_;
+  Stack stack_;
+};
+
+} // namespace jit
+} // namespace torch
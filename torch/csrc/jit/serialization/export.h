@@ -53,23 +53,29 @@ TORCH_API std::string pretty_print_onnx(
     const std::map<std::string, int>& custom_opsets = {},
     bool add_node_names = true);
 
+// With `flat_bytecode`, the bytecode is written as a flat record that mobile
+// modules run in place instead of `bytecode.pkl`, see
+// import_export_constants.h. Loaders predating it can't read such modules.
 TORCH_API void ExportModule(
     const Module& module,
     std::ostream& out,
     const ExtraFilesMap& metadata = ExtraFilesMap(),
-    bool bytecode_format = false);
+    bool bytecode_format = false,
+    bool flat_bytecode = false);
 
 TORCH_API void ExportModule(
     const Module& module,
     const std::string& filename,
     const ExtraFilesMap& metadata = ExtraFilesMap(),
-    bool bytecode_format = false);
+    bool bytecode_format = false,
+    bool flat_bytecode = false);
 
 TORCH_API void ExportModule(
     const Module& module,
     const std::function<size_t(const void*, size_t)>& writer_func,
     const ExtraFilesMap& metadata = ExtraFilesMap(),
-    bool bytecode_format = false);
+    bool bytecode_format = false,
+    bool flat_bytecode = false);
 
 // Write the bytes of a pickle archive and the tensors referenced inside that
 // archive
@@ -18,6 +18,7 @@
 
 #include <ATen/core/jit_type.h>
 #include <ATen/core/qualified_name.h>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -25,6 +26,7 @@ namespace torch {
 namespace jit {
 
 char const* toString(OpCode op);
+OpCode parseOpCode(const char* str);
 
 namespace {
 ExportModuleExtraFilesHook& GetExtraFilesHook() {
@@ -127,6 +129,114 @@ c10::IValue getFunctionTuple(const Function& func) {
   return Tup({func.qualname().qualifiedName(), table});
 }
 
+// The bytes of a flat bytecode record, see import_export_constants.h.
+class FlatBytecodeBuffer {
+ public:
+  void writeUInt(size_t value) {
+    TORCH_CHECK(
+        value <= std::numeric_limits<uint32_t>::max(),
+        "Flat bytecode can't hold ",
+        value,
+        ", which doesn't fit 32 bits");
+    const auto value32 = static_cast<uint32_t>(value);
+    write(&value32, sizeof(value32));
+  }
+
+  void writeString(const std::string& str) {
+    writeUInt(str.size());
+    write(str.data(), str.size());
+    align(sizeof(uint32_t));
+  }
+
+  void write(const void* data, size_t size) {
+    const auto bytes = static_cast<const char*>(data);
+    data_.insert(data_.end(), bytes, bytes + size);
+  }
+
+  void align(size_t alignment) {
+    data_.resize((data_.size() + alignment - 1) / alignment * alignment, 0);
+  }
+
+  const std::vector<char>& data() const {
+    return data_;
+  }
+
+ private:
+  std::vector<char> data_;
+};
+
+// Writes the functions of `moduleMethodsTuple` as a flat bytecode record, and
+// appends their constants to `constants`.
+std::vector<char> flatBytecode(
+    const std::vector<c10::IValue>& functions,
+    std::vector<c10::IValue>& constants) {
+  static_assert(
+      sizeof(Instruction) == 8 && alignof(Instruction) <= 8,
+      "Flat bytecode stores instructions as 8 byte structs");
+  FlatBytecodeBuffer out;
+  out.write(FLAT_BYTECODE_MAGIC, sizeof(FLAT_BYTECODE_MAGIC));
+  out.writeUInt(FLAT_BYTECODE_VERSION);
+  out.writeUInt(FLAT_BYTECODE_BYTE_ORDER_MARK);
+
+  // The names of the opcodes let a reader whose OpCode enum differs remap
+  // the instructions instead of running them in place.
+  std::vector<const char*> opcode_names;
+#define OPCODE_NAME(x, _) opcode_names.push_back(#x);
+  FORALL_OPCODES(OPCODE_NAME)
+#undef OPCODE_NAME
+  out.writeUInt(opcode_names.size());
+  for (const char* name : opcode_names) {
+    out.writeString(name);
+  }
+
+  out.writeUInt(functions.size());
+  for (const auto& function : functions) {
+    const auto& function_tuple = function.toTuple()->elements();
+    const auto& table = function_tuple[1].toTuple()->elements();
+    auto field = [&](size_t index) -> const IValue& {
+      return table.at(index).toTuple()->elements().at(1);
+    };
+    const auto& instructions =
+        field(BYTECODE_INDEX_INSTRUCTION).toTuple()->elements();
+    const auto& operators = field(BYTECODE_INDEX_OPERATOR).toTuple()->elements();
+    const auto& function_constants =
+        field(BYTECODE_INDEX_CONSTANT).toTuple()->elements();
+    const auto& types = field(BYTECODE_INDEX_TYPE).toTuple()->elements();
+
+    out.writeString(function_tuple[0].toStringRef());
+    out.writeUInt(field(BYTECODE_INDEX_TYPE + 1).toInt());
+
+    out.writeUInt(constants.size());
+    out.writeUInt(function_constants.size());
+    constants.insert(
+        constants.end(), function_constants.begin(), function_constants.end());
+
+    out.writeUInt(instructions.size());
+    out.align(8);
+    for (const auto& ins : instructions) {
+      const auto& ins_item = ins.toTuple()->elements();
+      Instruction instruction(
+          parseOpCode(ins_item[0].toStringRef().c_str()),
+          ins_item[1].toInt(),
+          ins_item[2].toInt());
+      out.write(&instruction, sizeof(instruction));
+    }
+
+    out.writeUInt(operators.size());
+    for (const auto& op : operators) {
+      const auto& op_item = op.toTuple()->elements();
+      out.writeString(op_item[0].toStringRef());
+      out.writeString(op_item[1].toStringRef());
+    }
+
+    out.writeUInt(types.size());
+    for (const auto& type : types) {
+      out.writeString(type.toStringRef());
+    }
+  }
+  return out.data();
+}
+
 void setstateTuple(const IValue& ivalue, std::vector<c10::IValue>& elements) {
   if (!ivalue.isObject())
     return;
@@ -174,7 +284,8 @@ class ScriptModuleSerializer {
   void serialize(
       const Module& module,
       const ExtraFilesMap& extra_files,
-      bool bytecode_format) {
+      bool bytecode_format,
+      bool flat_bytecode) {
     C10_LOG_API_USAGE_ONCE("torch.script.save");
     writeExtraFiles(module, extra_files);
     // Serialize the model object
@@ -187,7 +298,7 @@ class ScriptModuleSerializer {
         constant_table_.begin(), constant_table_.end());
     writeArchive("constants", c10::ivalue::Tuple::create(ivalue_constants));
     if (bytecode_format) {
-      writeByteCode(module);
+      writeByteCode(module, flat_bytecode);
     }
   }
 
@@ -277,9 +388,16 @@ class ScriptModuleSerializer {
     }
   }
 
-  void writeByteCode(const Module& module) {
+  void writeByteCode(const Module& module, bool flat_bytecode) {
     std::vector<c10::IValue> elements;
     moduleMethodsTuple(module, elements);
+    if (flat_bytecode) {
+      std::vector<c10::IValue> constants;
+      const auto data = flatBytecode(elements, constants);
+      writer_.writeRecord("bytecode.flat", data.data(), data.size());
+      writeArchive("bytecode_constants", Tup(std::move(constants)));
+      return;
+    }
     auto telements = Tup(std::move(elements));
     writeArchive("bytecode", telements);
   }
@@ -328,31 +446,34 @@ void ExportModule(
     const Module& module,
     std::ostream& out,
     const ExtraFilesMap& extra_files,
-    bool bytecode_format) {
+    bool bytecode_format,
+    bool flat_bytecode) {
   ScriptModuleSerializer serializer(
       [&](const void* buf, size_t nbytes) -> size_t {
         out.write(static_cast<const char*>(buf), nbytes);
         return !out ? 0 : nbytes;
       });
-  serializer.serialize(module, extra_files, bytecode_format);
+  serializer.serialize(module, extra_files, bytecode_format, flat_bytecode);
 }
 
 void ExportModule(
     const Module& module,
     const std::string& filename,
     const ExtraFilesMap& extra_files,
-    bool bytecode_format) {
+    bool bytecode_format,
+    bool flat_bytecode) {
   ScriptModuleSerializer serializer(filename);
-  serializer.serialize(module, extra_files, bytecode_format);
+  serializer.serialize(module, extra_files, bytecode_format, flat_bytecode);
 }
 
 void ExportModule(
     const Module& module,
     const std::function<size_t(const void*, size_t)>& writer_func,
     const ExtraFilesMap& extra_files,
-    bool bytecode_format) {
+    bool bytecode_format,
+    bool flat_bytecode) {
   ScriptModuleSerializer serializer(writer_func);
-  serializer.serialize(module, extra_files, bytecode_format);
+  serializer.serialize(module, extra_files, bytecode_format, flat_bytecode);
 }
 
 namespace {
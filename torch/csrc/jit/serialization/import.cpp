@@ -16,11 +16,18 @@
 #include <caffe2/serialize/file_adapter.h>
 #include <caffe2/serialize/inline_container.h>
 #include <caffe2/serialize/istream_adapter.h>
+#include <caffe2/serialize/mmap_adapter.h>
 
 #include <ATen/ATen.h>
+#include <ATen/Parallel.h>
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
 #include <fstream>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -30,9 +37,35 @@ namespace jit {
 
 using caffe2::serialize::FileAdapter;
 using caffe2::serialize::IStreamAdapter;
+using caffe2::serialize::MmapAdapter;
 using caffe2::serialize::PyTorchStreamReader;
 using caffe2::serialize::ReadAdapterInterface;
 
+namespace {
+std::atomic<bool> lazyCompilationOnLoad{false};
+} // namespace
+
+void setLazyCompilationOnLoad(bool lazy) {
+  lazyCompilationOnLoad = lazy;
+}
+
+bool getLazyCompilationOnLoad() {
+  return lazyCompilationOnLoad;
+}
+
+void compileLazilyLoadedFunctionsAsync(const Module& module) {
+  auto cu = module._ivalue()->compilation_unit();
+  at::launch([cu]() {
+    for (Function* function : cu->get_functions()) {
+      try {
+        function->ensure_defined();
+      } catch (const std::exception&) {
+        // Reported by the first call of the function.
+      }
+    }
+  });
+}
+
 void postSetStateValidate(const IValue& v) {
   auto obj = v.toObject();
   const auto& objType = obj->type();
@@ -55,6 +88,144 @@ void postSetStateValidate(const IValue& v) {
   }
 }
 
+namespace {
+
+// Reads the records of tensor storages ahead of the unpickler, on the
+// intra-op thread pool. The unpickler asks for storages in the order they
+// were written, so records are read in that order, at most `window` ahead of
+// the last one consumed. Unpickling a tensor, including its copy to the
+// target device, thus overlaps with reading the next ones, without holding
+// all of them in memory at once.
+class StorageRecordPrefetcher {
+ public:
+  StorageRecordPrefetcher(
+      PyTorchStreamReader& reader,
+      std::vector<std::string> names,
+      size_t window)
+      : reader_(reader), names_(std::move(names)), slots_(names_.size()) {
+    for (size_t i = 0; i < names_.size(); ++i) {
+      index_[names_[i]] = i;
+    }
+    launch(window);
+  }
+
+  ~StorageRecordPrefetcher() {
+    // the reads in flight refer to this and to the reader
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return in_flight_ == 0; });
+  }
+
+  at::DataPtr get(const std::string& name) {
+    auto it = index_.find(name);
+    if (it == index_.end()) {
+      return std::get<0>(reader_.getRecord(name));
+    }
+    const size_t i = it->second;
+    // keep `window` records ahead of the consumer
+    launch(1);
+    std::unique_lock<std::mutex> lock(mutex_);
+    Slot& slot = slots_[i];
+    if (slot.state == kPending || slot.state == kTaken) {
+      // asked for out of order, or more than once
+      slot.state = kTaken;
+      lock.unlock();
+      return std::get<0>(reader_.getRecord(name));
+    }
+    cv_.wait(lock, [&] { return slot.state == kDone; });
+    slot.state = kTaken;
+    if (slot.error) {
+      std::rethrow_exception(slot.error);
+    }
+    return std::move(slot.data);
+  }
+
+ private:
+  enum State { kPending, kLaunched, kDone, kTaken };
+
+  struct Slot {
+    State state = kPending;
+    at::DataPtr data;
+    std::exception_ptr error;
+  };
+
+  void launch(size_t count) {
+    for (size_t k = 0; k < count; ++k) {
+      size_t i;
+      {
+        std::lock_guard<std::mutex> guard(mutex_);
+        while (next_ < slots_.size() && slots_[next_].state != kPending) {
+          ++next_;
+        }
+        if (next_ == slots_.size()) {
+          return;
+        }
+        i = next_++;
+        slots_[i].state = kLaunched;
+        ++in_flight_;
+      }
+      // NB: runs inline when there is no pool to run on, so the lock must not
+      // be held here.
+      at::intraop_launch([this, i] {
+        at::DataPtr data;
+        std::exception_ptr error;
+        try {
+          data = std::get<0>(reader_.getRecord(names_[i]));
+        } catch (...) {
+          error = std::current_exception();
+        }
+        {
+          std::lock_guard<std::mutex> guard(mutex_);
+          slots_[i].data = std::move(data);
+          slots_[i].error = error;
+          slots_[i].state = kDone;
+          --in_flight_;
+        }
+        cv_.notify_all();
+      });
+    }
+  }
+
+  PyTorchStreamReader& reader_;
+  const std::vector<std::string> names_;
+  std::unordered_map<std::string, size_t> index_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<Slot> slots_;
+  size_t next_ = 0;
+  size_t in_flight_ = 0;
+};
+
+// The storage records of an archive, e.g. data/0, data/1, ..., in the order
+// they were written.
+std::vector<std::string> storageRecords(
+    PyTorchStreamReader& stream_reader,
+    const std::string& archive_name) {
+  const std::string prefix = archive_name + "/";
+  std::vector<std::string> names;
+  for (const auto& record : stream_reader.getAllRecords()) {
+    // drop the name of the top-level directory of the archive
+    auto slash = record.find('/');
+    if (slash == std::string::npos) {
+      continue;
+    }
+    auto name = record.substr(slash + 1);
+    if (name.compare(0, prefix.size(), prefix) == 0 &&
+        name.size() > prefix.size() &&
+        std::all_of(name.begin() + prefix.size(), name.end(), ::isdigit)) {
+      names.push_back(std::move(name));
+    }
+  }
+  std::sort(
+      names.begin(),
+      names.end(),
+      [](const std::string& a, const std::string& b) {
+        return a.size() != b.size() ? a.size() < b.size() : a < b;
+      });
+  return names;
+}
+
+} // namespace
+
 IValue readArchiveAndTensors(
     const std::string& archive_name,
     c10::optional<TypeResolver> type_resolver,
@@ -81,9 +252,13 @@ IValue readArchiveAndTensors(
   };
 
   std::string archive_name_plus_slash = archive_name + "/";
+  StorageRecordPrefetcher prefetcher(
+      stream_reader,
+      storageRecords(stream_reader, archive_name),
+      /*window=*/2 * at::get_num_threads());
   auto read_record = [&](const std::string& name) {
     std::string ss = archive_name_plus_slash + name;
-    return std::get<0>(stream_reader.getRecord(ss));
+    return prefetcher.get(ss);
   };
 
   Unpickler unpickler(
@@ -221,7 +396,6 @@ graph(%x, %packed_params, %stride, %padding, %dilation, %groups, %r_scale, %r_ze
          %r = quantized::conv3d_relu(%x, %packed_params, %r_scale, %r_zero_point)
          return (%r) )";
 
-  SubgraphRewriter rewriter;
   static const std::vector<std::pair<std::string, std::string>>
       patterns_and_replacements = {
           {old_quantized_conv2d, new_quantized_conv2d},
@@ -229,10 +403,19 @@ graph(%x, %packed_params, %stride, %padding, %dilation, %groups, %r_scale, %r_ze
           {old_quantized_conv3d, new_quantized_conv3d},
           {old_quantized_conv3d_relu, new_quantized_conv3d_relu},
       };
-  for (const auto& item : patterns_and_replacements) {
-    rewriter.RegisterRewritePattern(item.first, item.second);
+  // The methods of a lazily loaded module are rewritten once they are
+  // compiled.
+  for (const auto& method : module.get_methods()) {
+    static_cast<GraphFunction&>(method.function())
+        .after_definition([](GraphFunction& function) {
+          SubgraphRewriter rewriter;
+          for (const auto& item : patterns_and_replacements) {
+            rewriter.RegisterRewritePattern(item.first, item.second);
+          }
+          auto graph = function.graph();
+          rewriter.runOnGraph(graph);
+        });
   }
-  rewriter.runOnModule(module);
 
   for (const Module& child : module.children()) {
     rewriteQuantizedConvForBC(child);
@@ -322,6 +505,15 @@ Module load(
   return module;
 }
 
+Module load_mmap(
+    const std::string& filename,
+    c10::optional<at::Device> device,
+    ExtraFilesMap& extra_files) {
+  std::unique_ptr<MmapAdapter> rai = std::make_unique<MmapAdapter>(filename);
+  auto module = load(std::move(rai), device, extra_files);
+  return module;
+}
+
 Module load(
     std::unique_ptr<ReadAdapterInterface> rai,
     c10::optional<c10::Device> device,
@@ -65,6 +65,34 @@ TORCH_API Module load(
     c10::optional<c10::Device> device = c10::nullopt,
     ExtraFilesMap& extra_files = default_extra_files);
 
+/// Loads a serialized `Module` from the given `filename` by mapping the file
+/// into memory instead of reading it.
+///
+/// The storages of CPU tensors alias the mapped pages, which are read from
+/// disk on first access and are shared by all modules loaded from the same
+/// file. Writes to those tensors are private to the module (copy-on-write);
+/// the file itself is never modified. The mapping lives as long as any
+/// tensor still uses it.
+TORCH_API Module load_mmap(
+    const std::string& filename,
+    c10::optional<c10::Device> device = c10::nullopt,
+    ExtraFilesMap& extra_files = default_extra_files);
+
+/// Sets whether `load` and `import_ir_module` compile the methods and
+/// functions of the code they load (except `__init__`) on their first use,
+/// instead of all of them before returning. A lazily loaded module is
+/// callable sooner and does not pay for the methods it never calls, but the
+/// errors of a method are only reported on its first use. Defaults to
+/// false.
+TORCH_API void setLazyCompilationOnLoad(bool lazy);
+TORCH_API bool getLazyCompilationOnLoad();
+
+/// Compiles the methods and functions of a lazily loaded `module` that are
+/// not compiled yet on the inter-op thread pool, one at a time, so that their
+/// first calls do not have to. Calls made in the meantime compile what they
+/// need themselves, or wait for the compilation in progress.
+TORCH_API void compileLazilyLoadedFunctionsAsync(const Module& module);
+
 TORCH_API IValue readArchiveAndTensors(
     const std::string& archive_name,
     c10::optional<TypeResolver> type_resolver,
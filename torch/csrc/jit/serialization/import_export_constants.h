@@ -1,10 +1,32 @@
 #pragma once
 
+#include <cstdint>
+
 namespace torch {
 namespace jit {
 constexpr size_t BYTECODE_INDEX_INSTRUCTION = 0;
 constexpr size_t BYTECODE_INDEX_OPERATOR = 1;
 constexpr size_t BYTECODE_INDEX_CONSTANT = 2;
 constexpr size_t BYTECODE_INDEX_TYPE = 3;
+
+// The flat bytecode record, `bytecode.flat`, holds the same functions as
+// `bytecode.pkl` in a layout that is read in place instead of unpickled. All
+// integers are uint32_t in the byte order of the writer; a string is its size
+// followed by its bytes, padded to 4 bytes:
+//
+//   magic "PTFB", version, byte order mark 0x01020304
+//   number of opcodes, their names in the order of the OpCode enum
+//   number of functions, then for every function:
+//     qualified name, register size
+//     index of its first constant and number of constants
+//     number of instructions, padding to 8 bytes, the Instruction structs
+//     number of operators, then the name and overload name of each
+//     number of types, their python_str()
+//
+// The constants of all functions are a tuple in the `bytecode_constants`
+// archive, whose tensors alias the file when it is mapped into memory.
+constexpr char FLAT_BYTECODE_MAGIC[4] = {'P', 'T', 'F', 'B'};
+constexpr uint32_t FLAT_BYTECODE_VERSION = 1;
+constexpr uint32_t FLAT_BYTECODE_BYTE_ORDER_MARK = 0x01020304;
 } // namespace jit
 } // namespace torch
@@ -5,6 +5,7 @@
 #include <torch/csrc/jit/frontend/resolver.h>
 #include <torch/csrc/jit/frontend/script_type_parser.h>
 #include <torch/csrc/jit/serialization/export.h>
+#include <torch/csrc/jit/serialization/import.h>
 #include <torch/custom_class.h>
 
 #include <regex>
@@ -195,7 +196,13 @@ struct SourceImporterImpl : public Resolver,
       definitions.emplace_back(def);
       resolvers.emplace_back(shared_from_this());
     }
-    cu_->define(prefix, definitions, resolvers, &self);
+    cu_->define(
+        prefix,
+        definitions,
+        resolvers,
+        &self,
+        /*shouldMangle=*/false,
+        /*lazy=*/getLazyCompilationOnLoad());
   }
 
   std::shared_ptr<SugaredValue> resolveValue(
@@ -231,7 +238,13 @@ struct SourceImporterImpl : public Resolver,
   void importFunction(const std::string& qualifier, const Def& def) {
     std::vector<Def> definitions{def};
     std::vector<ResolverPtr> resolvers{shared_from_this()};
-    cu_->define(qualifier, definitions, resolvers, nullptr);
+    cu_->define(
+        qualifier,
+        definitions,
+        resolvers,
+        nullptr,
+        /*shouldMangle=*/false,
+        /*lazy=*/getLazyCompilationOnLoad());
   }
 
   void importNamedType(
@@ -434,7 +447,13 @@ struct SourceImporterImpl : public Resolver,
 
     cu_->register_type(class_type);
     const auto self = SimpleSelf(class_type);
-    cu_->define(qualified_classname, methods, resolvers, &self);
+    cu_->define(
+        qualified_classname,
+        methods,
+        resolvers,
+        &self,
+        /*shouldMangle=*/false,
+        /*lazy=*/getLazyCompilationOnLoad());
   }
 
   void importNamedTuple(
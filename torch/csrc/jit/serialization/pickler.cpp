@@ -17,6 +17,15 @@ using ::c10::IValue;
 // See https://docs.python.org/3/library/pickle.html#data-stream-format
 constexpr static uint8_t PROTOCOL_VERSION = 2;
 
+// Lists of ints, floats and bools with at least this many elements are written
+// as the raw bytes of their elements, see pushPackedList
+constexpr static size_t kPackedListMinSize = 64;
+
+static bool shouldPackList(size_t size, size_t element_size) {
+  return size >= kPackedListMinSize &&
+      size * element_size <= std::numeric_limits<uint32_t>::max();
+}
+
 Pickler::~Pickler() {
   flush();
 }
@@ -60,11 +69,24 @@ void Pickler::pushIValueImpl(const IValue& ivalue) {
   } else if (ivalue.isNone()) {
     push<PickleOpCode>(PickleOpCode::NONE);
   } else if (ivalue.isIntList()) {
-    pushSpecializedList(ivalue, "build_intlist", [=](const IValue& ivalue) {
-      for (const int64_t item : ivalue.toIntVector()) {
-        pushInt(item);
-      }
-    });
+    const size_t size = ivalue.toIntList().size();
+    if (shouldPackList(size, sizeof(int64_t))) {
+      pushPackedList(
+          ivalue,
+          "build_packed_intlist",
+          size * sizeof(int64_t),
+          [=](const IValue& ivalue) {
+            for (const int64_t item : ivalue.toIntList()) {
+              push<int64_t>(item);
+            }
+          });
+    } else {
+      pushSpecializedList(ivalue, "build_intlist", [=](const IValue& ivalue) {
+        for (const int64_t item : ivalue.toIntVector()) {
+          pushInt(item);
+        }
+      });
+    }
   } else if (ivalue.isTensorList()) {
     pushSpecializedList(ivalue, "build_tensorlist", [=](const IValue& ivalue) {
       for (const at::Tensor& item : ivalue.toTensorVector()) {
@@ -72,17 +94,41 @@ void Pickler::pushIValueImpl(const IValue& ivalue) {
       }
     });
   } else if (ivalue.isDoubleList()) {
-    pushSpecializedList(ivalue, "build_doublelist", [=](const IValue& ivalue) {
-      for (double item : ivalue.toDoubleVector()) {
-        pushDouble(item);
-      }
-    });
+    const size_t size = ivalue.toDoubleList().size();
+    if (shouldPackList(size, sizeof(double))) {
+      pushPackedList(
+          ivalue,
+          "build_packed_doublelist",
+          size * sizeof(double),
+          [=](const IValue& ivalue) {
+            for (const double item : ivalue.toDoubleList()) {
+              push<double>(item);
+            }
+          });
+    } else {
+      pushSpecializedList(
+          ivalue, "build_doublelist", [=](const IValue& ivalue) {
+            for (double item : ivalue.toDoubleVector()) {
+              pushDouble(item);
+            }
+          });
+    }
   } else if (ivalue.isBoolList()) {
-    pushSpecializedList(ivalue, "build_boollist", [=](const IValue& ivalue) {
-      for (bool item : ivalue.toBoolList()) {
-        pushBool(item);
-      }
-    });
+    const size_t size = ivalue.toBoolList().size();
+    if (shouldPackList(size, sizeof(uint8_t))) {
+      pushPackedList(
+          ivalue, "build_packed_boollist", size, [=](const IValue& ivalue) {
+            for (bool item : ivalue.toBoolList()) {
+              push<uint8_t>(item);
+            }
+          });
+    } else {
+      pushSpecializedList(ivalue, "build_boollist", [=](const IValue& ivalue) {
+        for (bool item : ivalue.toBoolList()) {
+          pushBool(item);
+        }
+      });
+    }
     // note: isList must be after isIntList and friends because
     // isList is true for all lists.
   } else if (ivalue.isList()) {
@@ -443,6 +489,29 @@ void Pickler::pushSpecializedList(
   push<PickleOpCode>(PickleOpCode::REDUCE);
 }
 
+// A packed list is a call to one of the torch.jit._pickle.build_packed_*
+// functions with the little endian bytes of its elements, which the Unpickler
+// decodes in one go instead of building an IValue on the stack for every
+// element. Python's pickle decodes it with the functions of torch/jit/_pickle.py.
+void Pickler::pushPackedList(
+    const IValue& ivalue,
+    const char* list_name,
+    size_t num_bytes,
+    const std::function<void(const IValue&)>& item_pusher) {
+  pushGlobal("torch.jit._pickle", list_name);
+
+  // Wrap the bytes in a tuple, as in pushSpecializedList
+  push<PickleOpCode>(PickleOpCode::MARK);
+
+  push<PickleOpCode>(PickleOpCode::BINBYTES);
+  push<uint32_t>(num_bytes);
+  item_pusher(ivalue);
+
+  push<PickleOpCode>(PickleOpCode::TUPLE);
+
+  push<PickleOpCode>(PickleOpCode::REDUCE);
+}
+
 static inline double swapDouble(double value) {
   const char* bytes = reinterpret_cast<const char*>(&value);
   double flipped;
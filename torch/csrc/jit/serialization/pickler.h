@@ -178,6 +178,11 @@ class Pickler {
       const IValue& ivalue,
       const char* list_name,
       const std::function<void(const IValue&)>& item_pusher);
+  void pushPackedList(
+      const IValue& ivalue,
+      const char* list_name,
+      size_t num_bytes,
+      const std::function<void(const IValue&)>& item_pusher);
   void pushGlobal(
       const std::string& module_name,
       const std::string& class_name);
@@ -245,6 +245,27 @@ static std::vector<T> convertList(const IValue& v) {
   return fmap(v.toListRef(), [](const IValue& elem) { return elem.to<T>(); });
 }
 
+// Decodes the little endian elements of a list written by
+// Pickler::pushPackedList, each stored as a stored_t
+template <typename T, typename stored_t = T>
+static c10::List<T> unpackList(const std::string& data) {
+  TORCH_CHECK(
+      data.size() % sizeof(stored_t) == 0,
+      "Expected the bytes of a packed list to be a multiple of ",
+      sizeof(stored_t),
+      " in size, found ",
+      data.size());
+  const size_t size = data.size() / sizeof(stored_t);
+  c10::List<T> list;
+  list.reserve(size);
+  for (size_t i = 0; i < size; ++i) {
+    stored_t item;
+    memcpy(&item, data.data() + i * sizeof(stored_t), sizeof(stored_t));
+    list.push_back(static_cast<T>(item));
+  }
+  return list;
+}
+
 PickleOpCode Unpickler::readInstruction() {
   auto opcode = readOpCode();
   switch (opcode) {
@@ -309,6 +330,11 @@ PickleOpCode Unpickler::readInstruction() {
     case PickleOpCode::BINFLOAT:
       stack_.emplace_back(readFloat());
       break;
+    case PickleOpCode::BINBYTES: {
+      // bytes are only used for packed lists, and are kept as strings
+      uint32_t length = read<uint32_t>();
+      stack_.emplace_back(readBytes(length));
+    } break;
     case PickleOpCode::TUPLE: {
       size_t start = marks_.back();
       marks_.pop_back();
@@ -397,7 +423,8 @@ PickleOpCode Unpickler::readInstruction() {
       globals_.at(idx)();
     } break;
     case PickleOpCode::BINPERSID: {
-      auto args = pop(stack_).toTuple()->elements();
+      auto args_tuple = pop(stack_).toTuple();
+      const auto& args = args_tuple->elements();
       AT_ASSERT(
           args.at(0).toStringRef() == "storage",
           "unknown PERSID key ",
@@ -506,6 +533,24 @@ void Unpickler::readGlobal(
         restoreContainerTypeTags(data.at(0), type);
         stack_.emplace_back(data.at(0));
       });
+    } else if (class_name == "build_packed_intlist") {
+      globals_.emplace_back([this] {
+        auto data = stack_.back().toTuple()->elements().at(0);
+        stack_.pop_back();
+        stack_.emplace_back(unpackList<int64_t>(data.toStringRef()));
+      });
+    } else if (class_name == "build_packed_doublelist") {
+      globals_.emplace_back([this] {
+        auto data = stack_.back().toTuple()->elements().at(0);
+        stack_.pop_back();
+        stack_.emplace_back(unpackList<double>(data.toStringRef()));
+      });
+    } else if (class_name == "build_packed_boollist") {
+      globals_.emplace_back([this] {
+        auto data = stack_.back().toTuple()->elements().at(0);
+        stack_.pop_back();
+        stack_.emplace_back(unpackList<bool, uint8_t>(data.toStringRef()));
+      });
     } else {
       TypePtr elem_type = nullptr;
       if (class_name == "build_intlist") {
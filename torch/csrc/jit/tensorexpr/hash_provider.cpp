@@ -222,6 +222,9 @@ void HashProvider::visit(const For* v) {
 
   SimplifierHashType hash = hash_combine(
       "for", hashOf(v->var()), hashOf(v->start()), hashOf(v->stop()));
+  if (!v->loop_options().isDefault()) {
+    hash = hash_combine(hash, v->loop_options().ToString());
+  }
   if (v->body()) {
     v->body()->accept(this);
     hash = hash_combine(hash, hashOf(v->body()));
@@ -1,5 +1,7 @@
 #include <torch/csrc/jit/tensorexpr/kernel.h>
 
+#include <ATen/Parallel.h>
+#include <ATen/native/DispatchStub.h>
 #include <c10/util/string_utils.h>
 #include <torch/csrc/jit/jit_log.h>
 #include <torch/csrc/jit/tensorexpr/analysis.h>
@@ -393,6 +395,278 @@ Tensor* TensorExprKernel::computeFourOperand(
       });
 }
 
+static IValue constantValue(const torch::jit::Value* v) {
+  auto val = toIValue(v);
+  if (!val) {
+    throw malformed_input("expected a constant argument");
+  }
+  return *val;
+}
+
+// Normalizes the (possibly negative) dimensions in `v`, an int or int list
+// constant, against `rank`. An empty list stands for all dimensions.
+static std::vector<size_t> reductionDims(
+    const torch::jit::Value* v,
+    size_t rank) {
+  auto val = constantValue(v);
+  std::vector<int64_t> dims =
+      val.isInt() ? std::vector<int64_t>{val.toInt()} : val.toIntVector();
+  std::vector<size_t> result;
+  if (dims.empty()) {
+    for (size_t i = 0; i < rank; i++) {
+      result.push_back(i);
+    }
+    return result;
+  }
+  for (int64_t dim : dims) {
+    if (dim < 0) {
+      dim += rank;
+    }
+    if (dim < 0 || dim >= static_cast<int64_t>(rank)) {
+      throw malformed_input("reduction dimension out of range");
+    }
+    result.push_back(dim);
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+static bool isReduction(Tensor* t) {
+  return dynamic_cast<const ReduceOp*>(t->body()) != nullptr;
+}
+
+static int64_t numReducedElements(
+    const std::vector<ExprHandle>& shape,
+    const std::vector<size_t>& reduceDims) {
+  int64_t count = 1;
+  for (size_t dim : reduceDims) {
+    auto const& size = shape[dim].AsNode<IntImm>();
+    if (!size) {
+      throw malformed_input("reduction over a dynamic dimension");
+    }
+    count *= size->value();
+  }
+  return count;
+}
+
+// Replaces the reduced dimensions of `indices` by 0, to index the result of
+// a reduction computed with keepdim.
+static std::vector<ExprHandle> keptIndices(
+    const std::vector<ExprHandle>& indices,
+    const std::vector<size_t>& reduceDims) {
+  std::vector<ExprHandle> result(indices);
+  for (size_t dim : reduceDims) {
+    result[dim] = IntImm::make(0);
+  }
+  return result;
+}
+
+Tensor* TensorExprKernel::computeReduction(
+    const std::string& name,
+    const std::vector<ExprHandle>& shape,
+    const std::vector<size_t>& reduceDims,
+    bool keepdim,
+    const Reducer& reducer,
+    const std::function<ExprHandle(const std::vector<ExprHandle>&)>& body) {
+  auto isReduced = [&](size_t dim) {
+    return std::find(reduceDims.begin(), reduceDims.end(), dim) !=
+        reduceDims.end();
+  };
+
+  std::vector<DimArg> outputArgs;
+  std::vector<DimArg> reduceArgs;
+  for (size_t i = 0; i < shape.size(); i++) {
+    if (isReduced(i)) {
+      reduceArgs.emplace_back(DimArg(shape[i], "r" + c10::to_string(i)));
+      if (keepdim) {
+        outputArgs.emplace_back(DimArg(IntImm::make(1), "i" + c10::to_string(i)));
+      }
+    } else {
+      outputArgs.emplace_back(DimArg(shape[i], "i" + c10::to_string(i)));
+    }
+  }
+
+  // The reduce body gets the output variables followed by the reduction
+  // variables; put them back in the order of the input dimensions.
+  size_t numOutputArgs = outputArgs.size();
+  std::function<ExprHandle(ParameterList&)> bodyFunc =
+      [&, numOutputArgs](ParameterList& vars) {
+        std::vector<ExprHandle> indices;
+        size_t outputIdx = 0;
+        size_t reduceIdx = numOutputArgs;
+        for (size_t i = 0; i < shape.size(); i++) {
+          if (isReduced(i)) {
+            indices.push_back(vars[reduceIdx++]);
+            if (keepdim) {
+              outputIdx++;
+            }
+          } else {
+            indices.push_back(vars[outputIdx++]);
+          }
+        }
+        return body(indices);
+      };
+  Tensor* t = Reduce(name, outputArgs, reducer, bodyFunc, reduceArgs);
+  reductionTensors_.push_back(t);
+  return t;
+}
+
+Tensor* TensorExprKernel::computeSumOrMean(
+    const torch::jit::Value* v,
+    bool mean) {
+  auto const& n = v->node();
+  auto const& shape = valueShape(n->inputs()[0]);
+  std::vector<size_t> reduceDims;
+  bool keepdim = false;
+  if (n->inputs().size() == 2) {
+    // aten::sum(Tensor self, *, ScalarType? dtype)
+    for (size_t i = 0; i < shape.size(); i++) {
+      reduceDims.push_back(i);
+    }
+  } else {
+    // aten::sum(Tensor self, int[] dim, bool keepdim, *, ScalarType? dtype)
+    reduceDims = reductionDims(n->inputs()[1], shape.size());
+    keepdim = constantValue(n->inputs()[2]).toBool();
+  }
+
+  // Accumulate in the output type.
+  Tensor* sum = computeReduction(
+      mean ? "aten_mean_sum" : "aten_sum",
+      shape,
+      reduceDims,
+      keepdim,
+      Sum(),
+      [this, v](const std::vector<ExprHandle>& indices) {
+        return demoteOutput(
+            tensorOrConstant(v->node()->inputs()[0], indices), v->node()->output());
+      });
+  if (!mean) {
+    return sum;
+  }
+
+  int64_t count = numReducedElements(shape, reduceDims);
+  return Compute(
+      "aten_mean",
+      c10::fmap<DimArg>(ExprVectorToExprHandleVector(sum->dims())),
+      [sum, count](const std::vector<VarHandle>& axes) {
+        ExprHandle s = sum->call(axes);
+        return s / Cast::make(s.dtype(), IntImm::make(count));
+      });
+}
+
+Tensor* TensorExprKernel::computeSoftmax(
+    const torch::jit::Value* v,
+    bool logSoftmax) {
+  // aten::softmax(Tensor self, int dim, ScalarType? dtype)
+  //
+  // Computed as exp(x - max) / sum(exp(x - max)), with the max and the sum
+  // kept as reductions over rows.
+  auto const& n = v->node();
+  auto const& shape = valueShape(n->inputs()[0]);
+  auto const& reduceDims = reductionDims(n->inputs()[1], shape.size());
+  auto input = [this, v](const std::vector<ExprHandle>& indices) {
+    return demoteOutput(
+        tensorOrConstant(v->node()->inputs()[0], indices), v->node()->output());
+  };
+
+  Tensor* max = computeReduction(
+      "aten_softmax_max",
+      shape,
+      reduceDims,
+      true,
+      Maximum(ExprHandle(-std::numeric_limits<float>::infinity())),
+      input);
+  Tensor* sum = computeReduction(
+      "aten_softmax_sum",
+      shape,
+      reduceDims,
+      true,
+      Sum(),
+      [input, max, reduceDims](const std::vector<ExprHandle>& indices) {
+        return exp(input(indices) - max->call(keptIndices(indices, reduceDims)));
+      });
+  return Compute(
+      logSoftmax ? "aten_log_softmax" : "aten_softmax",
+      c10::fmap<DimArg>(shape),
+      [input, max, sum, reduceDims, logSoftmax](
+          const std::vector<VarHandle>& axes) {
+        std::vector<ExprHandle> indices(axes.begin(), axes.end());
+        auto const& kept = keptIndices(indices, reduceDims);
+        ExprHandle shifted = input(indices) - max->call(kept);
+        if (logSoftmax) {
+          return shifted - log(sum->call(kept));
+        }
+        return exp(shifted) / sum->call(kept);
+      });
+}
+
+Tensor* TensorExprKernel::computeLayerNorm(const torch::jit::Value* v) {
+  // aten::layer_norm(Tensor input, int[] normalized_shape, Tensor? weight,
+  //                  Tensor? bias, float eps, bool cudnn_enable)
+  //
+  // The mean and the variance are computed in two passes over the
+  // normalized dimensions.
+  auto const& n = v->node();
+  auto const& shape = valueShape(n->inputs()[0]);
+  size_t numNormalized = constantValue(n->inputs()[1]).toIntVector().size();
+  if (numNormalized == 0 || numNormalized > shape.size()) {
+    throw malformed_input("invalid normalized_shape for layer_norm");
+  }
+  std::vector<size_t> reduceDims;
+  for (size_t i = shape.size() - numNormalized; i < shape.size(); i++) {
+    reduceDims.push_back(i);
+  }
+  int64_t count = numReducedElements(shape, reduceDims);
+  double eps = constantValue(n->inputs()[4]).toDouble();
+
+  auto input = [this, v](const std::vector<ExprHandle>& indices) {
+    return demoteOutput(
+        tensorOrConstant(v->node()->inputs()[0], indices), v->node()->output());
+  };
+  Tensor* sum = computeReduction(
+      "aten_layer_norm_sum", shape, reduceDims, true, Sum(), input);
+  auto centered = [input, sum, reduceDims, count](
+                      const std::vector<ExprHandle>& indices) {
+    ExprHandle s = sum->call(keptIndices(indices, reduceDims));
+    return input(indices) - s / Cast::make(s.dtype(), IntImm::make(count));
+  };
+  Tensor* sqsum = computeReduction(
+      "aten_layer_norm_sqsum",
+      shape,
+      reduceDims,
+      true,
+      Sum(),
+      [centered](const std::vector<ExprHandle>& indices) {
+        ExprHandle c = centered(indices);
+        return c * c;
+      });
+
+  return Compute(
+      "aten_layer_norm",
+      c10::fmap<DimArg>(shape),
+      [this, v, centered, sqsum, reduceDims, count, eps](
+          const std::vector<VarHandle>& axes) {
+        auto const& n = v->node();
+        std::vector<ExprHandle> indices(axes.begin(), axes.end());
+        ExprHandle var = sqsum->call(keptIndices(indices, reduceDims));
+        Dtype dtype = var.dtype();
+        ExprHandle result = centered(indices) *
+            rsqrt(var / Cast::make(dtype, IntImm::make(count)) +
+                  Cast::make(dtype, FloatImm::make(eps)));
+        // The weight and the bias have the normalized shape, so they
+        // broadcast against the trailing indices.
+        if (n->inputs()[2]->type()->cast<TensorType>()) {
+          result = result *
+              demoteOutput(tensorOrConstant(n->inputs()[2], indices), n->output());
+        }
+        if (n->inputs()[3]->type()->cast<TensorType>()) {
+          result = result +
+              demoteOutput(tensorOrConstant(n->inputs()[3], indices), n->output());
+        }
+        return result;
+      });
+}
+
 Tensor* TensorExprKernel::computeValue(const torch::jit::Value* v) {
   switch (v->node()->kind()) {
     case aten::add: {
@@ -944,16 +1218,102 @@ Tensor* TensorExprKernel::computeValue(const torch::jit::Value* v) {
           });
     }
 
+    case aten::sum: {
+      return computeSumOrMean(v, false);
+    }
+
+    case aten::mean: {
+      return computeSumOrMean(v, true);
+    }
+
+    case aten::softmax: {
+      return computeSoftmax(v, false);
+    }
+
+    case aten::log_softmax: {
+      return computeSoftmax(v, true);
+    }
+
+    case aten::layer_norm: {
+      return computeLayerNorm(v);
+    }
+
     default: {
       throw std::runtime_error("Unhandled node kind");
     }
   }
 }
 
+// The narrowest vectors the LLVM backend generates.
+static constexpr int kMinVectorWidth = 4;
+
+// Size of the vector registers to fill. The LLVM backend only has vectorized
+// math functions up to 256 bits, so AVX512 is treated like AVX2.
+static int vectorRegisterBytes() {
+  switch (at::native::get_cpu_capability()) {
+    case at::native::CPUCapability::AVX:
+    case at::native::CPUCapability::AVX2:
+    case at::native::CPUCapability::AVX512:
+      return 32;
+    default:
+      return 16;
+  }
+}
+
+// Finds the size of the widest element stored by a statement.
+class MaxStoredElementSize : public IRVisitor {
+ public:
+  explicit MaxStoredElementSize(Stmt* s) {
+    s->accept(this);
+  }
+
+  int bytes() const {
+    return bytes_;
+  }
+
+ private:
+  void visit(const Store* v) override {
+    bytes_ = std::max(bytes_, v->value()->dtype().byte_size());
+    IRVisitor::visit(v);
+  }
+
+  int bytes_ = 1;
+};
+
+// Returns the number of iterations of a loop, or -1 if its bounds aren't
+// constant.
+static int64_t constantTripCount(const For* f) {
+  const IntImm* start = dynamic_cast<const IntImm*>(f->start());
+  const IntImm* stop = dynamic_cast<const IntImm*>(f->stop());
+  if (!start || !stop) {
+    return -1;
+  }
+  return std::max(stop->value() - start->value(), 0);
+}
+
+// Estimates the number of elements a statement computes.
+static int64_t estimateWork(const Stmt* s) {
+  if (const For* f = dynamic_cast<const For*>(s)) {
+    return std::max<int64_t>(constantTripCount(f), 1) * estimateWork(f->body());
+  }
+  if (auto b = dynamic_cast<const tensorexpr::Block*>(s)) {
+    int64_t work = 0;
+    for (const Stmt* s2 : *b) {
+      work += estimateWork(s2);
+    }
+    return std::max<int64_t>(work, 1);
+  }
+  if (const Store* store = dynamic_cast<const Store*>(s)) {
+    return store->value()->dtype().lanes();
+  }
+  return 1;
+}
+
 void TensorExprKernel::flattenTensors(BackendType backendType) {
-  if (backendType != BackendType::kCudaCodeGen) {
+  if (backendType != BackendType::kCudaCodeGen ||
+      !reductionTensors_.empty()) {
     // We only need to flatten for GPU, for other backends just use the same
-    // tensors.
+    // tensors. Kernels with reductions are scheduled by rows instead.
     flatTensorOutputs_ = tensorOutputs_;
     return;
   }
@@ -998,11 +1358,14 @@ void TensorExprKernel::flattenTensors(BackendType backendType) {
 Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
   flattenTensors(backendType);
 
-  torch::jit::tensorexpr::LoopNest l(flatTensorOutputs_);
+  std::vector<Tensor*> loopNestOutputs(flatTensorOutputs_);
+  loopNestOutputs.insert(
+      loopNestOutputs.end(), scratchTensors_.begin(), scratchTensors_.end());
+  torch::jit::tensorexpr::LoopNest l(loopNestOutputs);
 
   // Compute non-output tensors_ inline
   for (auto& p : tensors_) {
-    if (!l.hasLoopBodyFor(p.second)) {
+    if (!l.hasLoopBodyFor(p.second) || isReduction(p.second)) {
       continue;
     }
     Stmt* loop = l.getLoopBodyFor(p.second);
@@ -1012,7 +1375,11 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
       l.computeInline(loop);
     }
   }
-  if (backendType == kCudaCodeGen) {
+  if (!reductionTensors_.empty()) {
+    // Fuse the reductions with their producers and consumers into one loop
+    // over rows.
+    l.fuseOuterLoops();
+  } else if (backendType == kCudaCodeGen) {
     for (size_t i = 0; i < flatTensorOutputs_.size(); i++) {
       Tensor* tensor = flatTensorOutputs_[i];
 
@@ -1061,6 +1428,27 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
 
   l.prepareForCodegen();
 
+  if (!reductionTensors_.empty() && backendType == kCudaCodeGen) {
+    // Every thread computes a whole row, so the rows have to end up in a
+    // single loop.
+    Block* root = dynamic_cast<Block*>(l.root_stmt());
+    For* rows = root && root->nstmts() == 1
+        ? dynamic_cast<For*>(root->front())
+        : nullptr;
+    if (!rows) {
+      throw std::runtime_error(
+          "Cannot schedule the reductions as a single CUDA kernel");
+    }
+    const int kDefaultBlockSize = 512;
+    int blockSize = getTECudaPointwiseBlockSize();
+    blockSize = (blockSize > 0) ? blockSize : kDefaultBlockSize;
+    For* outer;
+    For* inner;
+    l.splitWithMask(rows, blockSize, &outer, &inner);
+    l.setGPUBlockIndex(outer, 0);
+    l.setGPUThreadIndex(inner, 0);
+  }
+
   if (backendType == kLLVMCodeGen) {
     std::vector<For*> innerLoops;
     std::vector<For*> worklist;
@@ -1105,23 +1493,75 @@ Stmt* TensorExprKernel::generateStmt(BackendType backendType) {
       }
     }
 
+    std::unordered_set<const Var*> reduceVars;
+    for (Tensor* t : reductionTensors_) {
+      auto const& args = dynamic_cast<const ReduceOp*>(t->body())->reduce_args();
+      reduceVars.insert(args.begin(), args.end());
+    }
+
     // vectorize inner loops.
+    const int registerBytes = vectorRegisterBytes();
     for (For* loop : innerLoops) {
+      if (reduceVars.count(loop->var())) {
+        // Each iteration of a reduction loop depends on the previous one.
+        continue;
+      }
+      // Fill a vector register with the widest elements the loop stores,
+      // then vectorize the tail at half the width.
+      int width = std::max(
+          registerBytes / MaxStoredElementSize(loop).bytes(), kMinVectorWidth);
+      int64_t tripCount = constantTripCount(loop);
+      while (tripCount >= 0 && width > kMinVectorWidth && tripCount < width) {
+        width /= 2;
+      }
+
       For* outer1;
       For* split1;
       For* tail1;
 
-      l.splitWithTail(loop, 8, &outer1, &split1, &tail1);
+      l.splitWithTail(loop, width, &outer1, &split1, &tail1);
       l.vectorize(split1);
 
-      if (tail1) {
+      if (tail1 && width / 2 >= kMinVectorWidth) {
         For* outer2;
         For* split2;
         For* tail2;
-        l.splitWithTail(tail1, 4, &outer2, &split2, &tail2);
+        l.splitWithTail(tail1, width / 2, &outer2, &split2, &tail2);
         l.vectorize(split2);
       }
     }
+
+    // Parallelize the outermost loops that do enough work, in tiles of
+    // roughly GRAIN_SIZE elements.
+    Block* root = dynamic_cast<Block*>(l.root_stmt());
+    if (root && at::get_num_threads() > 1) {
+      std::vector<For*> outerLoops;
+      for (Stmt* s : *root) {
+        if (For* f = dynamic_cast<For*>(s)) {
+          outerLoops.push_back(f);
+        }
+      }
+      for (For* loop : outerLoops) {
+        int64_t tripCount = constantTripCount(loop);
+        int64_t work = estimateWork(loop);
+        if (reduceVars.count(loop->var()) || tripCount < 2 ||
+            work < 2 * at::internal::GRAIN_SIZE) {
+          continue;
+        }
+        int64_t workPerIteration = std::max<int64_t>(work / tripCount, 1);
+        int64_t tile = (at::internal::GRAIN_SIZE + workPerIteration - 1) /
+            workPerIteration;
+        if (tile > 1 && tile < tripCount) {
+          For* tiles;
+          For* inner;
+          For* tail;
+          l.splitWithTail(loop, tile, &tiles, &inner, &tail);
+          l.setParallel(tiles);
+        } else {
+          l.setParallel(loop);
+        }
+      }
+    }
   }
 
   Stmt* stmt = l.root_stmt();
@@ -1159,6 +1599,9 @@ std::vector<CodeGen::BufferArg> TensorExprKernel::prepareBufferArgs() {
   for (auto& o : flatTensorOutputs_) {
     params.emplace_back(o);
   }
+  for (auto& t : scratchTensors_) {
+    params.emplace_back(t);
+  }
   return params;
 }
 
@@ -1356,6 +1799,13 @@ void TensorExprKernel::compile() {
     tensorOutputs_.emplace_back(tensors_.at(output->unique()));
     tensors_.erase(output->unique());
   }
+
+  for (Tensor* t : reductionTensors_) {
+    if (std::find(tensorOutputs_.begin(), tensorOutputs_.end(), t) ==
+        tensorOutputs_.end()) {
+      scratchTensors_.push_back(t);
+    }
+  }
 }
 
 TensorExprKernel::TensorExprKernel(const std::shared_ptr<Graph>& subgraph)
@@ -1408,7 +1858,11 @@ std::vector<CodeGen::CallArg> TensorExprKernel::prepareRunArgs(
     }
   }
 
-  for (auto& o : tensorOutputs_) {
+  // Scratch buffers are appended to the outputs, to be kept alive until the
+  // kernel is done.
+  std::vector<Tensor*> buffers(tensorOutputs_);
+  buffers.insert(buffers.end(), scratchTensors_.begin(), scratchTensors_.end());
+  for (auto& o : buffers) {
     std::vector<int64_t> tensorSize;
     for (const Expr* dim : o->dims()) {
       auto it = varToSize.find(dim);
@@ -1478,7 +1932,7 @@ void TensorExprKernel::runKernel(Stack& stack) {
 
   // Update the stack.
   drop(stack, nInputs_);
-  for (auto& o : outputs) {
-    push_one(stack, std::move(o));
+  for (size_t i = 0; i < tensorOutputs_.size(); i++) {
+    push_one(stack, std::move(outputs[i]));
   }
 }
@@ -154,6 +154,23 @@ class TORCH_API TensorExprKernel {
           const ExprHandle&,
           const ExprHandle&)>& innerExpr);
 
+  // Reduces `body`, evaluated at the indices of a tensor of the given shape,
+  // over the dimensions in `reduceDims`. The result keeps the reduced
+  // dimensions with size 1 if `keepdim` is set.
+  Tensor* computeReduction(
+      const std::string& name,
+      const std::vector<ExprHandle>& shape,
+      const std::vector<size_t>& reduceDims,
+      bool keepdim,
+      const Reducer& reducer,
+      const std::function<ExprHandle(const std::vector<ExprHandle>&)>& body);
+
+  Tensor* computeSumOrMean(const torch::jit::Value* v, bool mean);
+
+  Tensor* computeSoftmax(const torch::jit::Value* v, bool logSoftmax);
+
+  Tensor* computeLayerNorm(const torch::jit::Value* v);
+
   Tensor* computeValue(const torch::jit::Value* v);
 
   void flattenTensors(BackendType backendType);
@@ -213,6 +230,11 @@ class TORCH_API TensorExprKernel {
   std::vector<KernelArg> kernelArgs_;
   std::vector<Tensor*> tensorOutputs_;
   std::vector<Tensor*> flatTensorOutputs_;
+  // Reductions are never inlined. The ones that aren't outputs of the graph
+  // are computed into scratch buffers that are passed to the kernel after the
+  // outputs.
+  std::vector<Tensor*> reductionTensors_;
+  std::vector<Tensor*> scratchTensors_;
   std::unordered_map<int64_t, Tensor*> tensors_;
   std::unordered_map<int64_t, VarHandle> scalars_;
   std::unordered_map<size_t, std::unique_ptr<CodeGen>> codegenCache_;
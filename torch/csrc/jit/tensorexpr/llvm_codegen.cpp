@@ -3,9 +3,14 @@
 #include <torch/csrc/jit/tensorexpr/llvm_codegen.h>
 #include <torch/csrc/jit/tensorexpr/llvm_jit.h>
 
+#include <cstdlib>
+#include <iomanip>
 #include <memory>
+#include <mutex>
+#include <sstream>
 
 #include <llvm/Analysis/TargetTransformInfo.h>
+#include <llvm/Config/llvm-config.h>
 #include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
 #include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
 #include <llvm/IR/IRBuilder.h>
@@ -17,6 +22,7 @@
 
 #include <torch/csrc/jit/tensorexpr/buffer.h>
 #include <torch/csrc/jit/tensorexpr/execution_counter.h>
+#include <torch/csrc/jit/tensorexpr/hash_provider.h>
 #include <torch/csrc/jit/tensorexpr/ir.h>
 #include <torch/csrc/jit/tensorexpr/ir_printer.h>
 #include <torch/csrc/jit/tensorexpr/types.h>
@@ -27,6 +33,7 @@ using namespace torch::jit::tensorexpr;
 
 DEFINE_TRIGGER(llvm_codegen_created);
 DEFINE_TRIGGER(llvm_codegen_executed);
+DEFINE_TRIGGER(llvm_codegen_cache_hit);
 
 namespace torch {
 namespace jit {
@@ -57,6 +64,7 @@ class LLVMCodeGenImpl : public IRVisitor {
   llvm::Type* dtypeToLLVMPtr(Dtype dtype);
   void emitWrapper(const std::vector<llvm::Type*>& params);
   void emitKernel(Stmt* stmt, const std::vector<llvm::Type*>& params);
+  void emitParallelFor(const For* v);
 
  public:
   LLVMCodeGenImpl(
@@ -150,6 +158,65 @@ static llvm::orc::JITTargetMachineBuilder makeTargetMachineBuilder() {
 #endif
 }
 
+static std::mutex& cacheDirMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+static std::string& cacheDir() {
+  static std::string dir = []() -> std::string {
+    const char* env = std::getenv("PYTORCH_TENSOREXPR_CACHE_DIR");
+    return env ? env : "";
+  }();
+  return dir;
+}
+
+void torch::jit::tensorexpr::setLLVMCacheDir(const std::string& dir) {
+  std::lock_guard<std::mutex> guard(cacheDirMutex());
+  cacheDir() = dir;
+}
+
+std::string torch::jit::tensorexpr::getLLVMCacheDir() {
+  std::lock_guard<std::mutex> guard(cacheDirMutex());
+  return cacheDir();
+}
+
+// Returns the identifier of the machine code generated for a kernel. It is
+// made of the structural hash of the kernel, a hash of its printed form as a
+// guard against collisions, and a hash of the kernel signature, the host
+// target and the LLVM version.
+static std::string cacheKey(
+    Stmt* stmt,
+    const std::vector<CodeGen::BufferArg>& args,
+    Dtype dtype,
+    llvm::orc::JITTargetMachineBuilder& JTMB) {
+  HashProvider hasher;
+  SimplifierHashType stmtHash = hasher.hash(stmt);
+
+  std::ostringstream oss;
+  oss << *stmt;
+  size_t textHash = std::hash<std::string>()(oss.str());
+
+  SimplifierHashType configHash = hasher.hash_combine(
+      dtype,
+      JTMB.getTargetTriple().str(),
+      llvm::sys::getHostCPUName().str(),
+      JTMB.getFeatures().getString(),
+      std::string(LLVM_VERSION_STRING));
+  for (auto const& arg : args) {
+    configHash = hasher.hash_combine(
+        configHash,
+        hasher.hash(arg.var()),
+        arg.dtype(),
+        static_cast<int32_t>(arg.isVar()));
+  }
+
+  std::ostringstream key;
+  key << std::hex << std::setfill('0') << std::setw(16) << stmtHash._h << "-"
+      << std::setw(16) << textHash << "-" << std::setw(16) << configHash._h;
+  return key.str();
+}
+
 LLVMCodeGen::~LLVMCodeGen() = default;
 
 LLVMCodeGen::LLVMCodeGen(Stmt* stmt)
@@ -236,10 +303,8 @@ LLVMCodeGenImpl::LLVMCodeGenImpl(
   auto JTMB = makeTargetMachineBuilder();
   TM_ = llvm::cantFail(JTMB.createTargetMachine());
 
-  jit_ = std::make_unique<llvm::orc::PytorchLLVMJIT>();
-  module_ = std::make_unique<llvm::Module>("pytorch", getContext());
-  module_->setDataLayout(cantFail(JTMB.getDefaultDataLayoutForTarget()));
-  module_->setTargetTriple(JTMB.getTargetTriple().str());
+  std::string dir = getLLVMCacheDir();
+  jit_ = std::make_unique<llvm::orc::PytorchLLVMJIT>(dir);
 
   // Emit prototype and bind argument Vars to parameter indices.
   llvm::Type* retTy = dtypeToLLVM(dtype);
@@ -253,20 +318,32 @@ LLVMCodeGenImpl::LLVMCodeGenImpl(
     }
     varToArg_[arg.var()] = i;
   }
-  llvm::FunctionType* fntype = llvm::FunctionType::get(retTy, params, false);
-  fn_ = llvm::Function::Create(
-      fntype, llvm::Function::PrivateLinkage, "pytorch", module_.get());
-  for (size_t i = 0; i < args.size(); i++) {
-    if (!args[i].isVar()) {
-      fn_->addParamAttr(i, llvm::Attribute::NoAlias);
+
+  // Kernels found in the cache don't need to be emitted at all.
+  std::string key = dir.empty() ? "" : cacheKey(stmt, args, dtype, JTMB);
+  if (!key.empty() && jit_->addCachedModule(key)) {
+    USE_TRIGGER(llvm_codegen_cache_hit);
+  } else {
+    module_ = std::make_unique<llvm::Module>(
+        key.empty() ? "pytorch" : key, getContext());
+    module_->setDataLayout(cantFail(JTMB.getDefaultDataLayoutForTarget()));
+    module_->setTargetTriple(JTMB.getTargetTriple().str());
+
+    llvm::FunctionType* fntype = llvm::FunctionType::get(retTy, params, false);
+    fn_ = llvm::Function::Create(
+        fntype, llvm::Function::PrivateLinkage, "pytorch", module_.get());
+    for (size_t i = 0; i < args.size(); i++) {
+      if (!args[i].isVar()) {
+        fn_->addParamAttr(i, llvm::Attribute::NoAlias);
+      }
     }
-  }
 
-  emitWrapper(params);
-  emitKernel(stmt, params);
+    emitWrapper(params);
+    emitKernel(stmt, params);
 
-  cantFail(jit_->addModule(
-      llvm::orc::ThreadSafeModule(std::move(module_), context_)));
+    cantFail(jit_->addModule(
+        llvm::orc::ThreadSafeModule(std::move(module_), context_)));
+  }
   auto sym = jit_->findSymbol("wrapper");
   kernelAddress_ = cantFail(sym.getAddress());
   argv_ = std::make_unique<void*[]>(params.size());
@@ -913,6 +990,11 @@ void LLVMCodeGenImpl::visit(const Load* v) {
 }
 
 void LLVMCodeGenImpl::visit(const For* v) {
+  if (v->loop_options().is_parallel()) {
+    emitParallelFor(v);
+    return;
+  }
+
   // Create "start" and "stop" values.
   v->start()->accept(this);
   auto start = this->value_;
@@ -962,6 +1044,97 @@ void LLVMCodeGenImpl::visit(const For* v) {
   value_ = llvm::ConstantInt::get(IntTy_, 0);
 }
 
+// Outlines the body of a parallel loop into a function of the loop index and
+// a closure, and hands it to nnc_parallel_for (see llvm_jit.cpp). The closure
+// is an array of pointers to the values of all variables in scope.
+void LLVMCodeGenImpl::emitParallelFor(const For* v) {
+  v->start()->accept(this);
+  auto start = this->value_;
+  v->stop()->accept(this);
+  auto stop = this->value_;
+
+  auto voidPtrTy = llvm::Type::getInt8PtrTy(getContext());
+  auto voidPtrPtrTy = voidPtrTy->getPointerTo();
+
+  std::vector<const Var*> captured;
+  for (auto const& p : varToArg_) {
+    captured.push_back(p.first);
+  }
+  for (auto const& p : varToVal_) {
+    captured.push_back(p.first);
+  }
+
+  // Spill the captured values to the stack of the enclosing function.
+  llvm::IRBuilder<> entryIrb(
+      &fn_->getEntryBlock(), fn_->getEntryBlock().begin());
+  auto closure = entryIrb.CreateAlloca(
+      voidPtrTy, llvm::ConstantInt::getSigned(IntTy_, captured.size()));
+  std::vector<llvm::Type*> capturedTypes;
+  for (size_t i = 0; i < captured.size(); i++) {
+    captured[i]->accept(this);
+    auto slot = entryIrb.CreateAlloca(value_->getType());
+    irb_.CreateStore(value_, slot);
+    irb_.CreateStore(
+        irb_.CreatePointerCast(slot, voidPtrTy),
+        irb_.CreateGEP(closure, llvm::ConstantInt::getSigned(IntTy_, i)));
+    capturedTypes.push_back(value_->getType());
+  }
+
+  auto bodyFn = llvm::Function::Create(
+      llvm::FunctionType::get(
+          llvm::Type::getVoidTy(getContext()), {IntTy_, voidPtrPtrTy}, false),
+      llvm::Function::PrivateLinkage,
+      "parallel_body",
+      module_.get());
+
+  // Emit the body with all variables bound to values loaded from the
+  // closure.
+  auto savedFn = fn_;
+  auto savedIP = irb_.saveIP();
+  auto savedVarToArg = std::move(varToArg_);
+  auto savedVarToVal = std::move(varToVal_);
+  varToArg_.clear();
+  varToVal_.clear();
+
+  fn_ = bodyFn;
+  irb_.SetInsertPoint(llvm::BasicBlock::Create(getContext(), "entry", fn_));
+  auto index = fn_->arg_begin();
+  auto closureArg = fn_->arg_begin() + 1;
+  for (size_t i = 0; i < captured.size(); i++) {
+    auto slot = irb_.CreateLoad(
+        irb_.CreateGEP(closureArg, llvm::ConstantInt::getSigned(IntTy_, i)));
+    varToVal_.emplace(
+        captured[i],
+        irb_.CreateLoad(
+            irb_.CreatePointerCast(slot, capturedTypes[i]->getPointerTo())));
+  }
+  varToVal_.emplace(v->var(), index);
+  if (v->body()) {
+    v->body()->accept(this);
+  }
+  irb_.CreateRetVoid();
+  if (llvm::verifyFunction(*fn_, &llvm::outs())) {
+    throw std::runtime_error("Function verification failed");
+  }
+
+  fn_ = savedFn;
+  irb_.restoreIP(savedIP);
+  varToArg_ = std::move(savedVarToArg);
+  varToVal_ = std::move(savedVarToVal);
+
+  auto parallelFor = module_->getOrInsertFunction(
+      "nnc_parallel_for",
+      llvm::FunctionType::get(
+          llvm::Type::getVoidTy(getContext()),
+          {voidPtrTy, IntTy_, IntTy_, voidPtrPtrTy},
+          false),
+      {});
+  irb_.CreateCall(
+      parallelFor,
+      {irb_.CreatePointerCast(bodyFn, voidPtrTy), start, stop, closure});
+  value_ = llvm::ConstantInt::get(IntTy_, 0);
+}
+
 void LLVMCodeGenImpl::visit(const Block* v) {
   for (Stmt* s : *v) {
     s->accept(this);
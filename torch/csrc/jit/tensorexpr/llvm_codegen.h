@@ -7,6 +7,7 @@
 #include <torch/csrc/jit/tensorexpr/ir.h>
 #include <torch/csrc/jit/tensorexpr/ir_visitor.h>
 
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -53,6 +54,13 @@ class TORCH_API LLVMCodeGen : public CodeGen {
   std::unique_ptr<LLVMCodeGenImpl> impl_;
 };
 
+// Directory in which LLVMCodeGen caches the machine code of compiled kernels,
+// so that later processes can load it instead of compiling the kernels again.
+// Caching is disabled if it is empty, which is the default unless
+// PYTORCH_TENSOREXPR_CACHE_DIR is set.
+TORCH_API void setLLVMCacheDir(const std::string& dir);
+TORCH_API std::string getLLVMCacheDir();
+
 } // namespace tensorexpr
 } // namespace jit
 } // namespace torch
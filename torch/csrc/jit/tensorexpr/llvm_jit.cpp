@@ -2,24 +2,125 @@
 
 #include <torch/csrc/jit/tensorexpr/llvm_jit.h>
 
+#include <ATen/Parallel.h>
+#include <llvm/ExecutionEngine/ObjectCache.h>
+#include <llvm/ExecutionEngine/Orc/CompileUtils.h>
 #include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/raw_ostream.h>
 #include <sleef.h>
 #include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
 
+// Runs the outlined body of a parallel loop (see
+// LLVMCodeGenImpl::emitParallelFor) for all indices in [start, stop).
+static void nnc_parallel_for(
+    void (*body)(int32_t, void**),
+    int32_t start,
+    int32_t stop,
+    void** closure) {
+  at::parallel_for(start, stop, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      body(i, closure);
+    }
+  });
+}
+
 namespace llvm {
 namespace orc {
 
+// Stores object code in a directory, one file per module named after the
+// module identifier. Identifiers are expected to be derived from everything
+// that determines the generated code (see LLVMCodeGenImpl), so files are
+// never invalidated, and processes sharing the directory share the files.
+class PytorchLLVMObjectCache : public ObjectCache {
+ public:
+  explicit PytorchLLVMObjectCache(std::string dir) : dir_(std::move(dir)) {}
+
+  void notifyObjectCompiled(const Module* M, MemoryBufferRef Obj) override {
+    std::string path = pathFor(M->getModuleIdentifier());
+
+    // Write to a temporary file first, so that other processes never load a
+    // partially written object.
+    int fd;
+    SmallString<128> tmpPath;
+    if (sys::fs::createUniqueFile(path + ".tmp%%%%%%", fd, tmpPath)) {
+      return;
+    }
+    raw_fd_ostream os(fd, /*shouldClose=*/true);
+    os << Obj.getBuffer();
+    os.close();
+    if (os.has_error()) {
+      os.clear_error();
+      sys::fs::remove(tmpPath);
+      return;
+    }
+    if (sys::fs::rename(tmpPath, path)) {
+      sys::fs::remove(tmpPath);
+    }
+  }
+
+  std::unique_ptr<MemoryBuffer> getObject(const Module* M) override {
+    return load(M->getModuleIdentifier());
+  }
+
+  std::unique_ptr<MemoryBuffer> load(const std::string& key) {
+    auto buffer = MemoryBuffer::getFile(pathFor(key));
+    if (!buffer) {
+      return nullptr;
+    }
+    return std::move(*buffer);
+  }
+
+ private:
+  std::string pathFor(const std::string& key) const {
+    SmallString<128> path(dir_);
+    sys::path::append(path, key + ".o");
+    return path.str().str();
+  }
+
+  std::string dir_;
+};
+
+// Returns a cache for `dir`, or nullptr if caching is disabled or the
+// directory can't be created.
+static std::unique_ptr<PytorchLLVMObjectCache> makeObjectCache(
+    const std::string& dir) {
+  if (dir.empty() || sys::fs::create_directories(dir)) {
+    return nullptr;
+  }
+  return std::make_unique<PytorchLLVMObjectCache>(dir);
+}
+
+static LLJITBuilder makeLLJITBuilder(ObjectCache* cache) {
+  LLJITBuilder builder;
+  if (cache) {
+    builder.setCompileFunctionCreator(
+        [cache](JITTargetMachineBuilder JTMB)
+            -> Expected<IRCompileLayer::CompileFunction> {
+          return IRCompileLayer::CompileFunction(
+              ConcurrentIRCompiler(std::move(JTMB), cache));
+        });
+  }
+  return builder;
+}
+
 // Lightly modified implementation from LLVM's Kaleidoscope JIT tutorial:
 // https://llvm.org/docs/tutorial/BuildingAJIT1.html
 class TORCH_API PytorchLLVMJITImpl {
  private:
+  // Declared before LLJ, which refers to it, so that it outlives LLJ.
+  std::unique_ptr<PytorchLLVMObjectCache> Cache;
   std::unique_ptr<LLJIT> LLJ;
 
  public:
-  PytorchLLVMJITImpl() : LLJ(cantFail(LLJITBuilder().create())) {
+  explicit PytorchLLVMJITImpl(const std::string& cacheDir)
+      : Cache(makeObjectCache(cacheDir)),
+        LLJ(cantFail(makeLLJITBuilder(Cache.get()).create())) {
     auto ProcSymbolsGenerator =
         cantFail(DynamicLibrarySearchGenerator::GetForCurrentProcess(
             LLJ->getDataLayout().getGlobalPrefix()));
@@ -28,6 +129,11 @@ class TORCH_API PytorchLLVMJITImpl {
     // Handle platform-specific symbol mangling
     MangleAndInterner Mangle(LLJ->getExecutionSession(), LLJ->getDataLayout());
 
+    // Register the runtime support for parallel loops
+    cantFail(LLJ->defineAbsolute(
+        *Mangle("nnc_parallel_for"),
+        {llvm::pointerToJITTargetAddress(&nnc_parallel_for), {}}));
+
     // Register implementations of intrinsics
     cantFail(LLJ->defineAbsolute(
         *Mangle("log10f"), {llvm::pointerToJITTargetAddress(&log10f), {}}));
@@ -425,6 +531,18 @@ class TORCH_API PytorchLLVMJITImpl {
     return Error::success();
   }
 
+  bool addCachedModule(const std::string& key) {
+    if (!Cache) {
+      return false;
+    }
+    auto Obj = Cache->load(key);
+    if (!Obj) {
+      return false;
+    }
+    cantFail(LLJ->addObjectFile(std::move(Obj)));
+    return true;
+  }
+
   JITSymbol findSymbol(const std::string Name) {
     return cantFail(LLJ->lookup(Name));
   }
@@ -434,8 +552,8 @@ class TORCH_API PytorchLLVMJITImpl {
   }
 };
 
-PytorchLLVMJIT::PytorchLLVMJIT()
-    : impl_(std::make_unique<PytorchLLVMJITImpl>()) {}
+PytorchLLVMJIT::PytorchLLVMJIT(const std::string& cacheDir)
+    : impl_(std::make_unique<PytorchLLVMJITImpl>(cacheDir)) {}
 
 PytorchLLVMJIT::~PytorchLLVMJIT() = default;
 
@@ -443,6 +561,10 @@ Error PytorchLLVMJIT::addModule(ThreadSafeModule M) {
   return impl_->addModule(std::move(M));
 }
 
+bool PytorchLLVMJIT::addCachedModule(const std::string& key) {
+  return impl_->addCachedModule(key);
+}
+
 JITSymbol PytorchLLVMJIT::findSymbol(const std::string Name) {
   return impl_->findSymbol(std::move(Name));
 }
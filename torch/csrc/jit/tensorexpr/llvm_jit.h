@@ -18,11 +18,18 @@ class PytorchLLVMJITImpl;
 
 class TORCH_API PytorchLLVMJIT {
  public:
-  PytorchLLVMJIT();
+  // If `cacheDir` is not empty, the object code of every module added is
+  // stored in that directory under the module identifier, and can be added
+  // back by later instances with addCachedModule.
+  explicit PytorchLLVMJIT(const std::string& cacheDir = "");
   ~PytorchLLVMJIT();
 
   Error addModule(ThreadSafeModule M);
 
+  // Adds the cached object code of the module with identifier `key`.
+  // Returns false if there is none.
+  bool addCachedModule(const std::string& key);
+
   JITSymbol findSymbol(const std::string Name);
 
   TargetMachine& getTargetMachine();
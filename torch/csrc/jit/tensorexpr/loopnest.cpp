@@ -449,6 +449,146 @@ class Flattener : public IRMutator {
   }
 };
 
+// Collects the variables of all reduction axes in a statement.
+class ReduceVarFinder : public IRVisitor {
+ public:
+  std::unordered_set<const Var*> find(Stmt* s) {
+    s->accept(this);
+    return std::move(vars_);
+  }
+
+ private:
+  void visit(const ReduceOp* v) override {
+    vars_.insert(v->reduce_args().begin(), v->reduce_args().end());
+    IRVisitor::visit(v);
+  }
+
+  std::unordered_set<const Var*> vars_;
+};
+
+// Collects the buffers a statement stores to and the loads it performs.
+class BufAccessFinder : public IRVisitor {
+ public:
+  explicit BufAccessFinder(Stmt* s) {
+    s->accept(this);
+  }
+
+  const std::unordered_set<const Buf*>& stores() const {
+    return stores_;
+  }
+
+  const std::vector<const Load*>& loads() const {
+    return loads_;
+  }
+
+ private:
+  void visit(const Store* v) override {
+    stores_.insert(v->buf());
+    IRVisitor::visit(v);
+  }
+
+  void visit(const Load* v) override {
+    loads_.push_back(v);
+    IRVisitor::visit(v);
+  }
+
+  std::unordered_set<const Buf*> stores_;
+  std::vector<const Load*> loads_;
+};
+
+// Fuses adjacent outermost loops of a root block. A loop is fused into the
+// loops preceding it if they all have the same constant bounds, none of them
+// runs over a reduction axis, it doesn't write what the preceding loops read,
+// and every element it reads of a buffer written by the preceding loops is
+// indexed by its own loop variable in the first dimension, i.e. was produced
+// in the same iteration. This must run on unflattened indices.
+class OuterLoopFuser {
+ public:
+  explicit OuterLoopFuser(std::unordered_set<const Var*> reduce_vars)
+      : reduce_vars_(std::move(reduce_vars)) {}
+
+  Stmt* fuse(Stmt* s) {
+    Block* root = dynamic_cast<Block*>(s);
+    if (!root) {
+      return s;
+    }
+
+    std::vector<Stmt*> stmts;
+    for (Stmt* stmt : *root) {
+      For* f = dynamic_cast<For*>(stmt);
+      if (!f || !canFuse(f)) {
+        flush(stmts);
+      }
+      if (!f || reduce_vars_.count(f->var())) {
+        stmts.push_back(Stmt::clone(stmt));
+        continue;
+      }
+
+      if (!group_) {
+        group_ = f;
+      }
+      BufAccessFinder accesses(f);
+      group_stores_.insert(accesses.stores().begin(), accesses.stores().end());
+      for (const Load* load : accesses.loads()) {
+        group_loads_.insert(load->buf());
+      }
+      group_bodies_.push_back(
+          Substitute(Stmt::clone(f->body()), {{f->var(), group_->var()}}));
+    }
+    flush(stmts);
+    return new Block(stmts);
+  }
+
+ private:
+  bool canFuse(const For* f) const {
+    if (!group_ || reduce_vars_.count(f->var())) {
+      return false;
+    }
+    if (!sameConstant(f->start(), group_->start()) ||
+        !sameConstant(f->stop(), group_->stop())) {
+      return false;
+    }
+    BufAccessFinder accesses(const_cast<For*>(f));
+    for (const Buf* buf : accesses.stores()) {
+      if (group_loads_.count(buf)) {
+        return false;
+      }
+    }
+    for (const Load* load : accesses.loads()) {
+      if (!group_stores_.count(load->buf())) {
+        continue;
+      }
+      if (load->indices().empty() || load->indices()[0] != f->var()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static bool sameConstant(const Expr* a, const Expr* b) {
+    const IntImm* a_imm = dynamic_cast<const IntImm*>(a);
+    const IntImm* b_imm = dynamic_cast<const IntImm*>(b);
+    return a_imm && b_imm && a_imm->value() == b_imm->value();
+  }
+
+  void flush(std::vector<Stmt*>& stmts) {
+    if (!group_) {
+      return;
+    }
+    stmts.push_back(group_->cloneWithNewBody(new Block(group_bodies_)));
+    group_ = nullptr;
+    group_stores_.clear();
+    group_loads_.clear();
+    group_bodies_.clear();
+  }
+
+  std::unordered_set<const Var*> reduce_vars_;
+  For* group_ = nullptr;
+  std::unordered_set<const Buf*> group_stores_;
+  std::unordered_set<const Buf*> group_loads_;
+  std::vector<Stmt*> group_bodies_;
+};
+
 class FunctionInliner : public IRMutator {
  public:
   FunctionInliner(const std::vector<Function*>& funcs) : funcs_(funcs) {
@@ -948,6 +1088,11 @@ void LoopNest::prepareForCodegen() {
   root_stmt_ = InjectInlines(root_stmt_, inlined_functions_vec);
   root_stmt_ = InlineRandom(root_stmt_, inlined_randoms_vec);
 
+  std::unordered_set<const Var*> reduce_vars;
+  if (fuse_outer_loops_) {
+    reduce_vars = ReduceVarFinder().find(root_stmt_);
+  }
+
   // Expand reduction ops.
   ReductionExpander reduceExpander;
   root_stmt_ = reduceExpander.expand(root_stmt_);
@@ -956,12 +1101,20 @@ void LoopNest::prepareForCodegen() {
   Flattener flattener;
   root_stmt_ = root_stmt_->accept_mutator(&flattener);
 
+  if (fuse_outer_loops_) {
+    root_stmt_ = OuterLoopFuser(std::move(reduce_vars)).fuse(root_stmt_);
+  }
+
   root_stmt_ = FlattenIndexes(root_stmt_);
 
   // Add allocs and frees for intermediate buffers at the global level.
   root_stmt_ = insertAllocFree(root_stmt_);
 }
 
+void LoopNest::fuseOuterLoops() {
+  fuse_outer_loops_ = true;
+}
+
 void LoopNest::splitWithTail(
     For* f,
     int factor,
@@ -1221,6 +1374,10 @@ void LoopNest::setGPUThreadIndex(For* f, int thread_index) {
   f->set_gpu_thread_index(thread_index);
 }
 
+void LoopNest::setParallel(For* f) {
+  f->set_parallel();
+}
+
 Stmt* LoopNest::getLoopBodyFor(Tensor* t) const {
   return tensor_to_stmt_.at(t);
 }
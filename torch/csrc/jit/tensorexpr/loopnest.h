@@ -36,12 +36,22 @@ class TORCH_API LoopNest {
   void computeInline(Stmt* s);
   void computeInlineWithRandom(Stmt* s);
   void prepareForCodegen();
+
+  // Make prepareForCodegen fuse adjacent outermost loops with the same
+  // constant bounds, as long as every iteration of the fused loop only reads
+  // what it produced itself. On a nest of row-wise reductions and their
+  // elementwise producers and consumers this results in a single loop over
+  // rows.
+  void fuseOuterLoops();
   void splitWithTail(For* f, int factor, For** outer, For** inner, For** tail);
   void splitWithMask(For* f, int factor, For** outer, For** inner);
   void reorderAxis(Tensor* t, For* a, For* b);
 
   void setGPUBlockIndex(For* f, int idx);
   void setGPUThreadIndex(For* f, int idx);
+  // Run the iterations of `f` on the intra-op thread pool. Only the LLVM
+  // backend honors this; the iterations must be independent.
+  void setParallel(For* f);
 
   // Insert a temporary computation of statement S in the scope of loop AT.
   // S is assumed to be a Store or a Block containing a Store. Along with the
@@ -61,6 +71,7 @@ class TORCH_API LoopNest {
 
   std::unordered_set<Function*> inlined_functions_;
   std::unordered_set<Function*> inlined_random_functions_;
+  bool fuse_outer_loops_ = false;
   std::unordered_map<Tensor*, Stmt*> tensor_to_stmt_;
   std::unordered_map<Stmt*, Tensor*> stmt_to_tensor_;
   Stmt* root_stmt_;
@@ -413,6 +413,10 @@ class TORCH_API LoopOptions {
   }
 
   void set_gpu_block_index(int index) {
+    if (is_parallel()) {
+      throw std::runtime_error(
+          "Cannot set a gpu block index on a parallel loop");
+    }
     if (is_gpu_thread_index()) {
       throw std::runtime_error("Cannot set both gpu block and thread index");
     }
@@ -447,6 +451,10 @@ class TORCH_API LoopOptions {
   }
 
   void set_gpu_thread_index(int index) {
+    if (is_parallel()) {
+      throw std::runtime_error(
+          "Cannot set a gpu thread index on a parallel loop");
+    }
     if (is_gpu_block_index()) {
       throw std::runtime_error("Cannot set both gpu thread and block index");
     }
@@ -456,23 +464,39 @@ class TORCH_API LoopOptions {
     gpu_thread_index_ = index;
   }
 
+  // CPU parallelism: the iterations of the loop are spread over the intra-op
+  // thread pool.
+  bool is_parallel() const {
+    return is_parallel_;
+  }
+
+  void set_parallel() {
+    if (is_gpu_block_index() || is_gpu_thread_index()) {
+      throw std::runtime_error("Cannot parallelize a loop bound to the gpu");
+    }
+    is_parallel_ = true;
+  }
+
   std::string ToString() const {
     std::ostringstream oss;
     if (is_gpu_block_index()) {
       oss << gpu_block_index_str();
     } else if (is_gpu_thread_index()) {
       oss << gpu_thread_index_str();
+    } else if (is_parallel()) {
+      oss << "parallel";
     }
     return oss.str();
   }
 
   bool isDefault() const {
-    return gpu_block_index_ == -1 && gpu_thread_index_ == -1;
+    return gpu_block_index_ == -1 && gpu_thread_index_ == -1 && !is_parallel_;
   }
 
  private:
   int gpu_block_index_ = -1;
   int gpu_thread_index_ = -1;
+  bool is_parallel_ = false;
 };
 
 class TORCH_API For : public StmtNode<For> {
@@ -566,6 +590,10 @@ class TORCH_API For : public StmtNode<For> {
     loop_options_.set_gpu_thread_index(thread_index);
   }
 
+  void set_parallel() {
+    loop_options_.set_parallel();
+  }
+
   For* cloneWithNewBody(Stmt* body) const {
     return new For(var_, start_, stop_, body, loop_options_);
   }
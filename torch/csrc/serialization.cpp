@@ -1,5 +1,8 @@
 #include <torch/csrc/python_headers.h>
 #include <system_error>
+#ifndef _WIN32
+#include <sys/uio.h>
+#endif
 
 #include <torch/csrc/THP.h>
 #include <torch/csrc/serialization.h>
@@ -177,6 +180,42 @@ void doWrite(io fildes, void* raw_buf, size_t nbytes) {
   }
 }
 
+template <>
+void doWriteSized<PyObject*>(PyObject* fildes, void* header, size_t header_nbytes, void* buf, size_t nbytes) {
+  doWrite(fildes, header, header_nbytes);
+  doWrite(fildes, buf, nbytes);
+}
+
+// Writes the header and the data with a single writev() for files, which
+// saves a syscall (and a seek of the disk) per storage for many storages.
+template <>
+void doWriteSized<int>(int fildes, void* header, size_t header_nbytes, void* buf, size_t nbytes) {
+#ifndef _WIN32
+  struct iovec iov[2];
+  iov[0].iov_base = header;
+  iov[0].iov_len = header_nbytes;
+  iov[1].iov_base = buf;
+  iov[1].iov_len = std::min<size_t>(nbytes, 1073741824);
+  ssize_t r;
+  do {
+    r = writev(fildes, iov, 2);
+  } while (r < 0 && errno == EINTR);
+  if (r < 0) {
+    AT_ERROR("writev(): fd ", fildes, " failed with ", strerror(errno));
+  }
+  // finish whatever was not written with the loop of doWrite
+  size_t written = static_cast<size_t>(r);
+  if (written < header_nbytes) {
+    doWrite(fildes, static_cast<char*>(header) + written, header_nbytes - written);
+    written = header_nbytes;
+  }
+  doWrite(fildes, static_cast<char*>(buf) + (written - header_nbytes), nbytes - (written - header_nbytes));
+#else
+  doWrite(fildes, header, header_nbytes);
+  doWrite(fildes, buf, nbytes);
+#endif
+}
+
 #include <torch/csrc/generic/serialization.cpp>
 #include <TH/THGenerateAllTypes.h>
 
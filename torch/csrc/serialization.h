@@ -25,4 +25,8 @@ void doRead(io fildes, void* buf, size_t nbytes);
 template <class io>
 void doWrite(io fildes, void* buf, size_t nbytes);
 
+// Writes a header of header_nbytes followed by nbytes of buf
+template <class io>
+void doWriteSized(io fildes, void* header, size_t header_nbytes, void* buf, size_t nbytes);
+
 #endif
@@ -1,7 +1,6 @@
 #include <torch/csrc/utils/byte_order.h>
 #include <c10/util/BFloat16.h>
 #include <cstring>
-#include <vector>
 
 #if defined(_MSC_VER)
 #include <stdlib.h>
@@ -66,40 +65,37 @@ static inline void swapBytes64(void *ptr)
   memcpy(ptr, &output, sizeof(uint64_t));
 }
 
-static inline uint16_t decodeUInt16LE(const uint8_t *data) {
-  uint16_t output;
-  memcpy(&output, data, sizeof(uint16_t));
-  return output;
-}
-
-static inline uint16_t decodeUInt16BE(const uint8_t *data) {
-  uint16_t output = decodeUInt16LE(data);
-  swapBytes16(&output);
-  return output;
-}
-
-static inline uint32_t decodeUInt32LE(const uint8_t *data) {
-  uint32_t output;
-  memcpy(&output, data, sizeof(uint32_t));
-  return output;
+static inline uint16_t byteSwapped(uint16_t x) {
+  swapBytes16(&x);
+  return x;
 }
 
-static inline uint32_t decodeUInt32BE(const uint8_t *data) {
-  uint32_t output = decodeUInt32LE(data);
-  swapBytes32(&output);
-  return output;
+static inline uint32_t byteSwapped(uint32_t x) {
+  swapBytes32(&x);
+  return x;
 }
 
-static inline uint64_t decodeUInt64LE(const uint8_t *data) {
-  uint64_t output;
-  memcpy(&output, data, sizeof(uint64_t));
-  return output;
+static inline uint64_t byteSwapped(uint64_t x) {
+  swapBytes64(&x);
+  return x;
 }
 
-static inline uint64_t decodeUInt64BE(const uint8_t *data) {
-  uint64_t output = decodeUInt64LE(data);
-  swapBytes64(&output);
-  return output;
+// Copies len words of type T (uint16_t, uint32_t or uint64_t), swapping their
+// bytes if requested. The loop has no branches, so it gets vectorized.
+template <typename T>
+static inline void copyWords(void* dst, const void* src, size_t len, bool swap) {
+  if (!swap) {
+    memcpy(dst, src, sizeof(T) * len);
+    return;
+  }
+  uint8_t* out = static_cast<uint8_t*>(dst);
+  const uint8_t* in = static_cast<const uint8_t*>(src);
+  for (size_t i = 0; i < len; i++) {
+    T x;
+    memcpy(&x, in + i * sizeof(T), sizeof(T));
+    x = byteSwapped(x);
+    memcpy(out + i * sizeof(T), &x, sizeof(T));
+  }
 }
 
 } // anonymous namespace
@@ -113,52 +109,32 @@ THPByteOrder THP_nativeByteOrder()
   return *(uint8_t*)&x ? THP_LITTLE_ENDIAN : THP_BIG_ENDIAN;
 }
 
+// The decoders swap the bytes of big endian buffers, the encoders the bytes
+// of buffers whose order is not the native one.
+
 void THP_decodeInt16Buffer(int16_t* dst, const uint8_t* src, THPByteOrder order, size_t len)
 {
-  for (size_t i = 0; i < len; i++) {
-    dst[i] = (int16_t)(
-        order == THP_BIG_ENDIAN ? decodeUInt16BE(src) : decodeUInt16LE(src));
-    src += sizeof(int16_t);
-  }
+  copyWords<uint16_t>(dst, src, len, order == THP_BIG_ENDIAN);
 }
 
 void THP_decodeInt32Buffer(int32_t* dst, const uint8_t* src, THPByteOrder order, size_t len)
 {
-  for (size_t i = 0; i < len; i++) {
-    dst[i] = (int32_t)(
-        order == THP_BIG_ENDIAN ? decodeUInt32BE(src) : decodeUInt32LE(src));
-    src += sizeof(int32_t);
-  }
+  copyWords<uint32_t>(dst, src, len, order == THP_BIG_ENDIAN);
 }
 
 void THP_decodeInt64Buffer(int64_t* dst, const uint8_t* src, THPByteOrder order, size_t len)
 {
-  for (size_t i = 0; i < len; i++) {
-    dst[i] = (int64_t)(
-        order == THP_BIG_ENDIAN ? decodeUInt64BE(src) : decodeUInt64LE(src));
-    src += sizeof(int64_t);
-  }
+  copyWords<uint64_t>(dst, src, len, order == THP_BIG_ENDIAN);
 }
 
 void THP_decodeHalfBuffer(THHalf* dst, const uint8_t* src, THPByteOrder order, size_t len)
 {
-  for (size_t i = 0; i < len; i++) {
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
-    union { uint16_t x; THHalf f; };
-    x = (order == THP_BIG_ENDIAN ? decodeUInt16BE(src) : decodeUInt16LE(src));
-    dst[i] = f;
-    src += sizeof(uint16_t);
-  }
+  copyWords<uint16_t>(dst, src, len, order == THP_BIG_ENDIAN);
 }
 
 void THP_decodeBFloat16Buffer(at::BFloat16* dst, const uint8_t* src, THPByteOrder order, size_t len)
 {
-  for (size_t i = 0; i < len; i++) {
-    uint16_t x =
-        (order == THP_BIG_ENDIAN ? decodeUInt16BE(src) : decodeUInt16LE(src));
-    std::memcpy(&dst[i], &x, sizeof(dst[i]));
-    src += sizeof(uint16_t);
-  }
+  copyWords<uint16_t>(dst, src, len, order == THP_BIG_ENDIAN);
 }
 
 void THP_decodeBoolBuffer(bool* dst, const uint8_t* src, THPByteOrder order, size_t len)
@@ -170,149 +146,58 @@ void THP_decodeBoolBuffer(bool* dst, const uint8_t* src, THPByteOrder order, siz
 
 void THP_decodeFloatBuffer(float* dst, const uint8_t* src, THPByteOrder order, size_t len)
 {
-  for (size_t i = 0; i < len; i++) {
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
-    union { uint32_t x; float f; };
-    x = (order == THP_BIG_ENDIAN ? decodeUInt32BE(src) : decodeUInt32LE(src));
-    dst[i] = f;
-    src += sizeof(float);
-  }
+  copyWords<uint32_t>(dst, src, len, order == THP_BIG_ENDIAN);
 }
 
 void THP_decodeDoubleBuffer(double* dst, const uint8_t* src, THPByteOrder order, size_t len)
 {
-  for (size_t i = 0; i < len; i++) {
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
-    union { uint64_t x; double d; };
-    x = (order == THP_BIG_ENDIAN ? decodeUInt64BE(src) : decodeUInt64LE(src));
-    dst[i] = d;
-    src += sizeof(double);
-  }
+  copyWords<uint64_t>(dst, src, len, order == THP_BIG_ENDIAN);
 }
 
+// complex numbers are stored as their real and imaginary parts
 void THP_decodeComplexFloatBuffer(c10::complex<float>* dst, const uint8_t* src, THPByteOrder order, size_t len)
 {
-  for (size_t i = 0; i < len; i++) {
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
-    union { uint32_t x; float re; };
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
-    union { uint32_t y; float im; };
-
-    x = (order == THP_BIG_ENDIAN ? decodeUInt32BE(src) : decodeUInt32LE(src));
-    src += sizeof(float);
-    y = (order == THP_BIG_ENDIAN ? decodeUInt32BE(src) : decodeUInt32LE(src));
-    src += sizeof(float);
-
-    dst[i] = c10::complex<float>(re, im);
-  }
+  copyWords<uint32_t>(dst, src, 2 * len, order == THP_BIG_ENDIAN);
 }
 
 void THP_decodeComplexDoubleBuffer(c10::complex<double>* dst, const uint8_t* src, THPByteOrder order, size_t len)
 {
-  for (size_t i = 0; i < len; i++) {
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
-    union { uint32_t x; double re; };
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
-    union { uint32_t y; double im; };
-
-    x = (order == THP_BIG_ENDIAN ? decodeUInt64BE(src) : decodeUInt64LE(src));
-    src += sizeof(double);
-    y = (order == THP_BIG_ENDIAN ? decodeUInt64BE(src) : decodeUInt64LE(src));
-    src += sizeof(double);
-
-    dst[i] = c10::complex<double>(re, im);
-  }
+  copyWords<uint64_t>(dst, src, 2 * len, order == THP_BIG_ENDIAN);
 }
 
 void THP_encodeInt16Buffer(uint8_t* dst, const int16_t* src, THPByteOrder order, size_t len)
 {
-  memcpy(dst, src, sizeof(int16_t) * len);
-  if (order != THP_nativeByteOrder()) {
-    for (size_t i = 0; i < len; i++) {
-      swapBytes16(dst);
-      dst += sizeof(int16_t);
-    }
-  }
+  copyWords<uint16_t>(dst, src, len, order != THP_nativeByteOrder());
 }
 
 void THP_encodeInt32Buffer(uint8_t* dst, const int32_t* src, THPByteOrder order, size_t len)
 {
-  memcpy(dst, src, sizeof(int32_t) * len);
-  if (order != THP_nativeByteOrder()) {
-    for (size_t i = 0; i < len; i++) {
-      swapBytes32(dst);
-      dst += sizeof(int32_t);
-    }
-  }
+  copyWords<uint32_t>(dst, src, len, order != THP_nativeByteOrder());
 }
 
 void THP_encodeInt64Buffer(uint8_t* dst, const int64_t* src, THPByteOrder order, size_t len)
 {
-  memcpy(dst, src, sizeof(int64_t) * len);
-  if (order != THP_nativeByteOrder()) {
-    for (size_t i = 0; i < len; i++) {
-      swapBytes64(dst);
-      dst += sizeof(int64_t);
-    }
-  }
+  copyWords<uint64_t>(dst, src, len, order != THP_nativeByteOrder());
 }
 
 void THP_encodeFloatBuffer(uint8_t* dst, const float* src, THPByteOrder order, size_t len)
 {
-  memcpy(dst, src, sizeof(float) * len);
-  if (order != THP_nativeByteOrder()) {
-    for (size_t i = 0; i < len; i++) {
-      swapBytes32(dst);
-      dst += sizeof(float);
-    }
-  }
+  copyWords<uint32_t>(dst, src, len, order != THP_nativeByteOrder());
 }
 
 void THP_encodeDoubleBuffer(uint8_t* dst, const double* src, THPByteOrder order, size_t len)
 {
-  memcpy(dst, src, sizeof(double) * len);
-  if (order != THP_nativeByteOrder()) {
-    for (size_t i = 0; i < len; i++) {
-      swapBytes64(dst);
-      dst += sizeof(double);
-    }
-  }
-}
-
-template <typename T>
-std::vector<T> complex_to_float(const c10::complex<T>* src, size_t len) {
-  std::vector<T> new_src;
-  new_src.reserve(2 * len);
-  for (size_t i = 0; i < len; i++) {
-    auto elem = src[i];
-    new_src.emplace_back(elem.real());
-    new_src.emplace_back(elem.imag());
-  }
-  return new_src;
+  copyWords<uint64_t>(dst, src, len, order != THP_nativeByteOrder());
 }
 
 void THP_encodeComplexFloatBuffer(uint8_t* dst, const c10::complex<float>* src, THPByteOrder order, size_t len)
 {
-  auto new_src = complex_to_float(src, len);
-  memcpy(dst, static_cast<void*>(&new_src), 2 * sizeof(float) * len);
-  if (order != THP_nativeByteOrder()) {
-    for (size_t i = 0; i < (2 * len); i++) {
-      swapBytes32(dst);
-      dst += sizeof(float);
-    }
-  }
+  copyWords<uint32_t>(dst, src, 2 * len, order != THP_nativeByteOrder());
 }
 
-void THP_encodeCompelxDoubleBuffer(uint8_t* dst, const c10::complex<double>* src, THPByteOrder order, size_t len)
+void THP_encodeComplexDoubleBuffer(uint8_t* dst, const c10::complex<double>* src, THPByteOrder order, size_t len)
 {
-  auto new_src = complex_to_float(src, len);
-  memcpy(dst, static_cast<void*>(&new_src), 2 * sizeof(double) * len);
-  if (order != THP_nativeByteOrder()) {
-    for (size_t i = 0; i < (2 * len); i++) {
-      swapBytes64(dst);
-      dst += sizeof(double);
-    }
-  }
+  copyWords<uint64_t>(dst, src, 2 * len, order != THP_nativeByteOrder());
 }
 
 } // namespace utils
@@ -8,6 +8,7 @@
 
 #include <ATen/ATen.h>
 
+#include <algorithm>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -451,7 +452,10 @@ FunctionSignature::FunctionSignature(const std::string& fmt, int index)
   : min_args(0)
   , max_args(0)
   , max_pos_args(0)
+  , min_pos_args(0)
   , index(index)
+  , allow_varargs_intlist(false)
+  , has_required_kwargs(false)
   , hidden(false)
   , deprecated(false)
 {
@@ -507,11 +511,27 @@ FunctionSignature::FunctionSignature(const std::string& fmt, int index)
   for (auto& param : params) {
     if (!param.optional) {
       min_args++;
+      if (param.keyword_only) {
+        has_required_kwargs = true;
+      } else {
+        min_pos_args = max_pos_args + 1;
+      }
     }
     if (!param.keyword_only) {
       max_pos_args++;
     }
   }
+
+  // if there is a single positional IntArrayRef argument, i.e. expand(..), view(...),
+  // allow a var-args style IntArrayRef, so expand(5,3) behaves as expand((5,3))
+  if (max_pos_args == 1 && params[0].type_ == ParameterType::INT_LIST) {
+    allow_varargs_intlist = true;
+  }
+}
+
+bool FunctionSignature::can_take_positional(ssize_t nargs) const {
+  return !has_required_kwargs && nargs >= min_pos_args &&
+      (nargs <= max_pos_args || allow_varargs_intlist);
 }
 
 std::string FunctionSignature::toString() const {
@@ -618,12 +638,9 @@ bool FunctionSignature::parse(PyObject* args, PyObject* kwargs, PyObject* dst[],
   auto nargs = PyTuple_GET_SIZE(args);
   ssize_t remaining_kwargs = kwargs ? PyDict_Size(kwargs) : 0;
   ssize_t arg_pos = 0;
-  bool allow_varargs_intlist = false;
-
-  // if there is a single positional IntArrayRef argument, i.e. expand(..), view(...),
-  // allow a var-args style IntArrayRef, so expand(5,3) behaves as expand((5,3))
-  if (max_pos_args == 1 && params[0].type_ == ParameterType::INT_LIST) {
-    allow_varargs_intlist = true;
+  if (remaining_kwargs == 0) {
+    // f(x, **{}) is parsed like f(x), without looking up every parameter
+    kwargs = nullptr;
   }
 
   if (nargs > max_pos_args && !allow_varargs_intlist) {
@@ -741,6 +758,20 @@ PythonArgParser::PythonArgParser(std::vector<std::string> fmts, bool traceable)
     [](const FunctionSignature & sig) {
       return !sig.deprecated;
     });
+
+  // The signatures keep their order, as the first matching one wins
+  ssize_t max_pos_args = 0;
+  for (auto& signature : signatures_) {
+    max_pos_args = std::max(max_pos_args, signature.max_pos_args);
+  }
+  positional_signatures_.resize(max_pos_args + 1);
+  for (ssize_t nargs = 0; nargs <= max_pos_args; ++nargs) {
+    for (size_t i = 0; i < signatures_.size(); ++i) {
+      if (signatures_[i].can_take_positional(nargs)) {
+        positional_signatures_[nargs].push_back(i);
+      }
+    }
+  }
 }
 
 void PythonArgParser::check_deprecated(const FunctionSignature & signature) {
@@ -769,6 +800,19 @@ PythonArgs PythonArgParser::raw_parse(PyObject* args, PyObject* kwargs, PyObject
     return PythonArgs(traceable, signature, parsed_args);
   }
 
+  const auto nargs = PyTuple_GET_SIZE(args);
+  if ((!kwargs || PyDict_Size(kwargs) == 0) &&
+      nargs < static_cast<ssize_t>(positional_signatures_.size())) {
+    for (size_t i : positional_signatures_[nargs]) {
+      auto& signature = signatures_[i];
+      if (signature.parse(args, nullptr, parsed_args, false)) {
+        check_deprecated(signature);
+        return PythonArgs(traceable, signature, parsed_args);
+      }
+    }
+    print_error(args, kwargs, parsed_args);
+  }
+
   for (auto& signature : signatures_) {
     if (signature.parse(args, kwargs, parsed_args, false)) {
       check_deprecated(signature);
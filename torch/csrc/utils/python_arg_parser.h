@@ -109,6 +109,10 @@ private:
   PythonArgs raw_parse(PyObject* args, PyObject* kwargs, PyObject* parsed_args[]);
 
   std::vector<FunctionSignature> signatures_;
+  // For calls without keyword arguments, the signatures that can take that
+  // many positional arguments, indexed by the number of arguments. Most
+  // calls only try a few of the overloads this way.
+  std::vector<std::vector<size_t>> positional_signatures_;
   std::string function_name;
   ssize_t max_args;
   bool traceable;
@@ -119,6 +123,10 @@ struct PYBIND11_EXPORT FunctionSignature {
 
   bool parse(PyObject* args, PyObject* kwargs, PyObject* dst[], bool raise_exception);
 
+  // Whether a call with `nargs` positional and no keyword arguments passes
+  // all the required arguments, without too many of them
+  bool can_take_positional(ssize_t nargs) const;
+
   std::string toString() const;
 
   std::string name;
@@ -127,7 +135,10 @@ struct PYBIND11_EXPORT FunctionSignature {
   ssize_t min_args;
   ssize_t max_args;
   ssize_t max_pos_args;
+  ssize_t min_pos_args; // the position of the last required argument, plus 1
   int index;
+  bool allow_varargs_intlist;
+  bool has_required_kwargs;
   bool hidden;
   bool deprecated;
 };
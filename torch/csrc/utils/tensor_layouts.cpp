@@ -33,6 +33,20 @@ void initializeLayouts() {
     throw python_error();
   }
   registerLayoutObject((THPLayout*)mkldnn_layout, at::Layout::Mkldnn);
+
+  PyObject *sparse_csr_layout = THPLayout_New(at::Layout::SparseCsr, "torch.sparse_csr");
+  Py_INCREF(sparse_csr_layout);
+  if (PyModule_AddObject(torch_module, "sparse_csr", sparse_csr_layout) != 0) {
+    throw python_error();
+  }
+  registerLayoutObject((THPLayout*)sparse_csr_layout, at::Layout::SparseCsr);
+
+  PyObject *nested_layout = THPLayout_New(at::Layout::Nested, "torch.nested");
+  Py_INCREF(nested_layout);
+  if (PyModule_AddObject(torch_module, "nested", nested_layout) != 0) {
+    throw python_error();
+  }
+  registerLayoutObject((THPLayout*)nested_layout, at::Layout::Nested);
 }
 
 }} // namespace torch::utils
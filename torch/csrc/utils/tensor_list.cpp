@@ -1,5 +1,6 @@
 #include <torch/csrc/utils/tensor_list.h>
 
+#include <ATen/DeferredMode.h>
 #include <pybind11/pybind11.h>
 #include <torch/csrc/Exceptions.h>
 #include <torch/csrc/utils/python_scalars.h>
@@ -34,6 +35,7 @@ PyObject* tensor_to_list(const Tensor& tensor) {
     pybind11::gil_scoped_release no_gil;
     data = data.toBackend(Backend::CPU);
   }
+  at::deferred::flush();
   return recursive_to_list(
       (char*)data.data_ptr(), data.sizes(), data.strides(), 0,
       data.scalar_type(), data.dtype().itemsize());
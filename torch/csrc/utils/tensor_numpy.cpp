@@ -2,6 +2,8 @@
 #include <torch/csrc/utils/tensor_numpy.h>
 #include <torch/csrc/utils/numpy_stub.h>
 
+#include <ATen/DeferredMode.h>
+
 #ifndef USE_NUMPY
 namespace torch { namespace utils {
 PyObject* tensor_to_numpy(const at::Tensor& tensor) {
@@ -89,6 +91,8 @@ PyObject* tensor_to_numpy(const at::Tensor& tensor) {
         "Can't call numpy() on Variable that requires grad. "
         "Use var.detach().numpy() instead.");
   }
+  // the array shares the data, which has to be computed by now
+  at::deferred::flush();
   auto dtype = aten_to_numpy_dtype(tensor.scalar_type());
   auto sizes = to_numpy_shape(tensor.sizes());
   auto strides = to_numpy_shape(tensor.strides());
@@ -98,6 +102,10 @@ PyObject* tensor_to_numpy(const at::Tensor& tensor) {
     stride *= element_size_in_bytes;
   }
 
+  int flags = NPY_ARRAY_ALIGNED;
+  if (!tensor.storage().read_only()) {
+    flags |= NPY_ARRAY_WRITEABLE;
+  }
   auto array = THPObjectPtr(PyArray_New(
       &PyArray_Type,
       tensor.dim(),
@@ -106,7 +114,7 @@ PyObject* tensor_to_numpy(const at::Tensor& tensor) {
       strides.data(),
       tensor.data_ptr(),
       0,
-      NPY_ARRAY_ALIGNED | NPY_ARRAY_WRITEABLE,
+      flags,
       nullptr));
   if (!array) return nullptr;
 
@@ -131,17 +139,6 @@ at::Tensor tensor_from_numpy(PyObject* obj) {
   }
   auto array = (PyArrayObject*)obj;
 
-  if (!PyArray_ISWRITEABLE(array)) {
-    TORCH_WARN_ONCE(
-      "The given NumPy array is not writeable, and PyTorch does "
-      "not support non-writeable tensors. This means you can write to the "
-      "underlying (supposedly non-writeable) NumPy array using the tensor. "
-      "You may want to copy the array to protect its data or make it writeable "
-      "before converting it to a tensor. This type of warning will be "
-      "suppressed for the rest of this program.");
-
-  }
-
   int ndim = PyArray_NDIM(array);
   auto sizes = to_aten_shape(ndim, PyArray_DIMS(array));
   auto strides = to_aten_shape(ndim, PyArray_STRIDES(array));
@@ -176,7 +173,7 @@ at::Tensor tensor_from_numpy(PyObject* obj) {
         "Conversion between byte orders is currently not supported.");
   }
   Py_INCREF(obj);
-  return at::from_blob(
+  auto tensor = at::from_blob(
       data_ptr,
       sizes,
       strides,
@@ -186,6 +183,12 @@ at::Tensor tensor_from_numpy(PyObject* obj) {
       },
       at::device(kCPU).dtype(numpy_dtype_to_aten(PyArray_TYPE(array)))
   );
+  // The tensor shares the memory of a non-writeable array instead of copying
+  // it, and refuses to be written to
+  if (!PyArray_ISWRITEABLE(array)) {
+    tensor.storage().unsafeGetStorageImpl()->set_read_only(true);
+  }
+  return tensor;
 }
 
 int aten_to_numpy_dtype(const ScalarType scalar_type) {
@@ -287,6 +290,7 @@ at::Tensor tensor_from_cuda_array_interface(PyObject* obj) {
 
   // Extract the `obj.__cuda_array_interface__['data']` attribute
   void *data_ptr;
+  int read_only;
   {
     PyObject *py_data = PyDict_GetItemString(cuda_dict, "data");
     if (py_data == nullptr) {
@@ -299,13 +303,10 @@ at::Tensor tensor_from_cuda_array_interface(PyObject* obj) {
     if (data_ptr == nullptr && PyErr_Occurred()) {
       throw python_error();
     }
-    int read_only = PyObject_IsTrue(PyTuple_GET_ITEM(py_data, 1));
+    read_only = PyObject_IsTrue(PyTuple_GET_ITEM(py_data, 1));
     if (read_only == -1) {
       throw python_error();
     }
-    if (read_only) {
-      throw TypeError("the read only flag is not supported, should always be False");
-    }
   }
 
   // Extract the `obj.__cuda_array_interface__['strides']` attribute
@@ -333,7 +334,7 @@ at::Tensor tensor_from_cuda_array_interface(PyObject* obj) {
   }
 
   Py_INCREF(obj);
-  return at::from_blob(
+  auto tensor = at::from_blob(
       data_ptr,
       sizes,
       strides,
@@ -343,6 +344,10 @@ at::Tensor tensor_from_cuda_array_interface(PyObject* obj) {
       },
       at::device(kCUDA).dtype(dtype)
   );
+  if (read_only) {
+    tensor.storage().unsafeGetStorageImpl()->set_read_only(true);
+  }
+  return tensor;
 }
 }} // namespace torch::utils
 
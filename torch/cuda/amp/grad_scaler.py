@@ -170,15 +170,20 @@ class GradScaler(object):
         per_device_inv_scale = _MultiDeviceReplicator(inv_scale)
         per_device_found_inf = _MultiDeviceReplicator(found_inf)
 
+        # The gradients are unscaled by (device, dtype) lists, with a few multi-tensor kernel launches per list.
+        per_device_and_dtype_grads = defaultdict(list)
         for group in optimizer.param_groups:
             for param in group["params"]:
                 if param.grad is not None:
                     if (not allow_fp16) and param.grad.dtype == torch.float16:
                         raise ValueError("Attempting to unscale FP16 gradients.")
                     else:
-                        torch._amp_non_finite_check_and_unscale_(param.grad,
-                                                                 per_device_found_inf.get(param.grad.device),
-                                                                 per_device_inv_scale.get(param.grad.device))
+                        per_device_and_dtype_grads[(param.grad.device, param.grad.dtype)].append(param.grad)
+
+        for (device, _), grads in per_device_and_dtype_grads.items():
+            torch._amp_foreach_non_finite_check_and_unscale_(grads,
+                                                             per_device_found_inf.get(device),
+                                                             per_device_inv_scale.get(device))
 
         return per_device_found_inf._per_device_tensors
 
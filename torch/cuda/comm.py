@@ -1,5 +1,6 @@
 import torch
 from . import nccl
+from ._utils import _get_device_index
 from torch._utils import _take_tensors, _flatten_dense_tensors, \
     _unflatten_dense_tensors, _reorder_tensors_as
 
@@ -39,6 +40,57 @@ def broadcast_coalesced(tensors, devices, buffer_size=10485760):
     return torch._C._broadcast_coalesced(tensors, devices, buffer_size)
 
 
+class CoalescedBroadcast(object):
+    """Broadcasts the same sequence of tensors to the specified GPUs
+    repeatedly, e.g. the parameters of a module at every iteration.
+
+    Unlike :func:`broadcast_coalesced`, the buffers the tensors are coalesced
+    into are allocated once and reused, as long as the tensors keep their
+    sizes and types, and the copies run on side streams.
+    :meth:`broadcast` only queues them after the work queued so far on the
+    current streams of the devices, which may thus overlap with the
+    preceding iteration.
+
+    Arguments:
+        devices (Iterable): an iterable of devices among which to broadcast.
+          Note that it should be like (src, dst1, dst2, ...), the first element
+          of which is the source device to broadcast from.
+        buffer_size (int): maximum size of the buffer used for coalescing
+
+    .. warning::
+        The outputs are the same tensors from one broadcast to the next, which
+        overwrites their values.
+    """
+
+    def __init__(self, devices, buffer_size=10485760):
+        self._broadcast = torch._C._CoalescedBroadcast(
+            [_get_device_index(d) for d in devices], buffer_size)
+
+    def broadcast(self, tensors):
+        """Starts broadcasting ``tensors``, which should be on the first
+        device.
+
+        Returns:
+            A tuple containing the copies of ``tensors`` on every device,
+            which are ready once :meth:`wait` or :meth:`synchronize` returns.
+            For the first device, the inputs are returned as-is.
+        """
+        return self._broadcast.broadcast(list(tensors))
+
+    def wait(self):
+        """Makes the current streams of all the devices wait for the last
+        broadcast."""
+        self._broadcast.wait()
+
+    def query(self):
+        """Returns whether the last broadcast is done."""
+        return self._broadcast.query()
+
+    def synchronize(self):
+        """Waits for the last broadcast to be done."""
+        self._broadcast.synchronize()
+
+
 def reduce_add(inputs, destination=None):
     """Sums tensors from multiple GPUs.
 
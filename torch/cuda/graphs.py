@@ -0,0 +1,45 @@
+import torch
+
+
+class CUDAGraph(torch._C._CudaGraphBase):
+    r"""Wrapper around a CUDA graph.
+
+    Work queued on a side stream between :meth:`capture_begin` and
+    :meth:`capture_end` is captured in a graph instead of being run, and
+    :meth:`replay` launches the whole graph again with a single call, which
+    removes the CPU overhead of launching its kernels one by one.
+
+    Replays work on the same memory as the captured work: copy new inputs in
+    place into the tensors used during the capture before replaying, and read
+    the results from the tensors created during the capture. That memory is
+    kept by the caching allocator until :meth:`reset` is called or the graph
+    is destroyed. Random ops draw new random numbers on every replay.
+
+    .. warning::
+        This API is experimental and requires CUDA 11.0 or later. The work
+        captured must have static shapes and must not synchronize with the
+        CPU.
+    """
+
+    def capture_begin(self):
+        r"""Begins capturing the work queued on the current stream.
+
+        The current stream must not be the default stream. Typically used in
+        a ``with torch.cuda.stream(s):`` block.
+        """
+        super(CUDAGraph, self).capture_begin()
+
+    def capture_end(self):
+        r"""Ends the capture and instantiates the graph.
+
+        Must be called on the stream the capture began on.
+        """
+        super(CUDAGraph, self).capture_end()
+
+    def replay(self):
+        r"""Launches the captured work on the current stream."""
+        super(CUDAGraph, self).replay()
+
+    def reset(self):
+        r"""Destroys the graph and releases the memory it holds."""
+        super(CUDAGraph, self).reset()
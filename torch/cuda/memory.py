@@ -3,7 +3,7 @@ import contextlib
 import warnings
 
 import torch
-from . import is_initialized, _get_device_index
+from . import is_initialized, _get_device_index, _lazy_init
 
 
 def _host_allocator():
@@ -136,6 +136,21 @@ def memory_stats(device=None):
       result in a cache flush and retry.
     - ``"num_ooms"``: number of out-of-memory errors thrown.
 
+    The fragmentation of the cached free memory is described by:
+
+    - ``"free_blocks.count"``: list with the number of cached free blocks by
+      size. Entry ``i`` counts blocks of at least ``512 * 2**i`` and less than
+      ``512 * 2**(i+1)`` bytes; the last entry also counts all larger blocks.
+    - ``"free_blocks.bytes"``: list with the total size of those blocks.
+    - ``"free_blocks.largest"``: size of the largest cached free block, which
+      bounds the largest allocation that can be served without new memory.
+
+    Setting the environment variable ``PYTORCH_CUDA_EXPANDABLE_SEGMENTS=1``
+    makes the allocator grow a single segment per stream with the CUDA
+    virtual memory API instead of allocating a new segment for every large
+    request, which reduces this fragmentation. Memory in expandable segments
+    cannot be shared with other processes.
+
     Arguments:
         device (torch.device or int, optional): selected device. Returns
             statistics for the current device, given by :func:`~torch.cuda.current_device`,
@@ -466,3 +481,56 @@ def memory_summary(device=None, abbreviated=False):
     for k, v in stats.items():
         fmt_dict[k.replace(".", "-")] = v
     return "|" + "|\n|".join(lines).format(**fmt_dict) + "|\n"
+
+
+def host_memory_stats():
+    r"""Returns a dictionary of statistics of the caching allocator of pinned
+    (page-locked) host memory, used by :meth:`~torch.Tensor.pin_memory` and
+    the asynchronous copies between host and device.
+
+    - ``"allocated_bytes.{current,peak}"``: bytes of the blocks in use.
+    - ``"requested_bytes"``: bytes requested for the blocks in use; the
+      difference with ``"allocated_bytes.current"`` is lost to the rounding of
+      the requests to size classes.
+    - ``"reserved_bytes.{current,peak}"``: bytes of pinned memory held by the
+      allocator, including the free blocks kept for re-use.
+    - ``"limit_bytes"``: bound of ``"reserved_bytes.current"``, or 0 if
+      unlimited (see :func:`~torch.cuda.set_host_memory_limit`).
+    - ``"num_allocs"``: number of allocation requests.
+    - ``"num_cache_hits"``: number of requests served by a cached block.
+    - ``"num_slab_allocs"``, ``"num_slab_evictions"``: number of slabs of
+      pinned memory registered, and released to stay below the limit or by
+      an empty cache.
+    - ``"size_classes"``: for every block size, the number of ``"allocated"``
+      and ``"cached"`` blocks.
+
+    The peak and ``num_*`` statistics can be reset with
+    :func:`~torch.cuda.reset_host_memory_stats`.
+    """
+    if not is_initialized():
+        return {}
+    return torch._C._cuda_hostMemoryStats()
+
+
+def reset_host_memory_stats():
+    r"""Resets the peak and accumulated statistics of the pinned host memory
+    allocator. See :func:`~torch.cuda.host_memory_stats` for details.
+    """
+    if is_initialized():
+        torch._C._cuda_resetHostMemoryStats()
+
+
+def set_host_memory_limit(limit):
+    r"""Bounds the pinned host memory held by the caching allocator.
+
+    When an allocation would exceed the limit, the cached pinned memory that
+    is not in use is released first; if that is not enough, the allocation
+    fails with a ``RuntimeError``. Cached memory above a new limit is released
+    right away. The limit can also be set in MiB with the
+    ``PYTORCH_CUDA_HOST_MEMORY_LIMIT_MB`` environment variable.
+
+    Arguments:
+        limit (int or None): limit in bytes, ``None`` or 0 for no limit.
+    """
+    _lazy_init()
+    torch._C._cuda_setHostMemoryLimit(0 if limit is None else int(limit))
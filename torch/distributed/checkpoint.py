@@ -0,0 +1,236 @@
+"""
+Sharded checkpoints of distributed state.
+
+Rather than gathering the state on a single rank, every rank of the group
+writes the shards it holds to a file of its own, all of them at the same
+time, and the first rank then writes an index of where every shard went::
+
+    path/
+        metadata.pkl        the global index, for every entry of the state
+        rank_0.pt           the shards written by rank 0
+        rank_1.pt           ...
+
+The rank files are ``PyTorchStreamWriter`` containers, the format
+``torch.save`` uses, with a record per shard, which holds its elements
+contiguously. Loading goes through the index: every rank only reads the
+records that overlap the parts of the state it holds, from whichever files
+they are in, so that a checkpoint can be loaded by a different number of
+ranks, or sharded differently, than it was saved with.
+"""
+
+from __future__ import absolute_import, division, print_function, unicode_literals
+
+import io
+import os
+import pickle
+import struct
+
+import torch
+
+from .distributed_c10d import barrier, get_rank, get_world_size, group
+
+
+_METADATA_FILE = 'metadata.pkl'
+_SHARDS_RECORD = 'shards.pkl'
+
+
+class Shard(object):
+    r"""
+    A part of a tensor that is sharded over the ranks.
+
+    The shard holds the elements of the global tensor, of size
+    ``global_size``, starting at ``offsets`` in every dimension and spanning
+    the size of ``tensor``. The shards of the ranks do not need to overlap,
+    nor to cover the whole tensor.
+
+    Arguments:
+        tensor (Tensor): The elements of the shard
+        offsets (sequence of ints): Where the shard starts, in every
+            dimension of the global tensor
+        global_size (sequence of ints): The size of the global tensor
+    """
+
+    def __init__(self, tensor, offsets, global_size):
+        offsets = tuple(offsets)
+        global_size = tuple(global_size)
+        if len(offsets) != tensor.dim() or len(global_size) != tensor.dim():
+            raise ValueError("Expected offsets and global_size of {} dimensions, "
+                             "but got {} and {}".format(tensor.dim(), len(offsets), len(global_size)))
+        for offset, size, global_ in zip(offsets, tensor.size(), global_size):
+            if offset < 0 or offset + size > global_:
+                raise ValueError("Shard of size {} at offsets {} is out of the global size {}"
+                                 .format(tuple(tensor.size()), offsets, global_size))
+        self.tensor = tensor
+        self.offsets = offsets
+        self.global_size = global_size
+
+
+def _sharded_parts(state_dict, rank, world_size):
+    r"""
+    The tensors of ``state_dict`` this rank writes, as (key, tensor, offsets,
+    global size): all of its shards, and the replicated tensors it is
+    assigned. These go to the rank that has been assigned the least bytes so
+    far, the largest first, which every rank finds the same as the replicated
+    tensors are the same on all of them.
+    """
+    parts = []
+    replicated = []
+    for key, value in state_dict.items():
+        if isinstance(value, Shard):
+            parts.append((key, value.tensor, value.offsets, value.global_size))
+        elif isinstance(value, torch.Tensor):
+            replicated.append((key, value))
+
+    replicated.sort(key=lambda item: (-item[1].numel() * item[1].element_size(), item[0]))
+    assigned = [0] * world_size
+    for key, tensor in replicated:
+        owner = min(range(world_size), key=lambda r: assigned[r])
+        assigned[owner] += tensor.numel() * tensor.element_size()
+        if owner == rank:
+            parts.append((key, tensor, (0,) * tensor.dim(), tuple(tensor.size())))
+    return parts
+
+
+def _rank_file(rank):
+    return 'rank_{}.pt'.format(rank)
+
+
+def save_sharded(state_dict, path, group=group.WORLD):
+    r"""
+    Saves the state of all the ranks of the group as a sharded checkpoint.
+
+    This is a collective: every rank writes the shards it holds to a file of
+    its own under the directory ``path``, which all of them must see, and
+    the first rank then writes the global index of the checkpoint.
+
+    The values of ``state_dict`` can be:
+
+    - :class:`Shard`, for the part of a sharded tensor held by this rank.
+      All the shards of the ranks under the same key make up the tensor.
+    - A tensor, which is taken to be the same on all the ranks. It is only
+      written once, by one of the ranks, spreading the replicated tensors
+      over all of them.
+    - Any other picklable object, which is saved as the first rank has it.
+
+    Arguments:
+        state_dict (dict): The state of this rank
+        path (str): The directory to save the checkpoint to
+        group (ProcessGroup, optional): The process group to work on
+    """
+    rank = get_rank(group)
+    world_size = get_world_size(group)
+    if rank < 0:
+        return
+    if rank == 0 and not os.path.isdir(path):
+        os.makedirs(path)
+    barrier(group)
+
+    shards = []
+    writer = torch._C.PyTorchFileWriter(os.path.join(path, _rank_file(rank)))
+    for index, (key, tensor, offsets, global_size) in enumerate(
+            _sharded_parts(state_dict, rank, world_size)):
+        record = 'data/{}'.format(index)
+        data = tensor.detach().cpu().contiguous()
+        writer.write_record(record, data.data_ptr(), data.numel() * data.element_size())
+        shards.append((key, tensor.dtype, tuple(global_size), offsets, tuple(data.size()), record))
+    shards_value = pickle.dumps(shards)
+    writer.write_record(_SHARDS_RECORD, shards_value, len(shards_value))
+    writer.write_end_of_file()
+    del writer
+    barrier(group)
+
+    if rank == 0:
+        # The index is only made of the small records of the shards, which
+        # keeps the data of the other ranks off the first one.
+        tensors = {}
+        for r in range(world_size):
+            reader = torch._C.PyTorchFileReader(os.path.join(path, _rank_file(r)))
+            for key, dtype, global_size, offsets, size, record in pickle.loads(
+                    reader.get_record(_SHARDS_RECORD)):
+                entry = tensors.setdefault(key, {'dtype': dtype, 'size': global_size, 'shards': []})
+                if entry['dtype'] != dtype or entry['size'] != global_size:
+                    raise RuntimeError("The shards of '{}' do not agree on the dtype and size of "
+                                       "the tensor: got {} of size {} and {} of size {}".format(
+                                           key, entry['dtype'], entry['size'], dtype, global_size))
+                entry['shards'].append((offsets, size, _rank_file(r), record))
+        objects = {key: value for key, value in state_dict.items()
+                   if not isinstance(value, (Shard, torch.Tensor))}
+        with open(os.path.join(path, _METADATA_FILE), 'wb') as f:
+            pickle.dump({'world_size': world_size, 'tensors': tensors, 'objects': objects}, f)
+    barrier(group)
+
+
+def _overlap(offsets_a, size_a, offsets_b, size_b):
+    r"""
+    The region two boxes of the global tensor have in common, as its offsets
+    and size, or None when they do not overlap.
+    """
+    offsets = []
+    size = []
+    for a, la, b, lb in zip(offsets_a, size_a, offsets_b, size_b):
+        begin = max(a, b)
+        end = min(a + la, b + lb)
+        if begin >= end:
+            return None
+        offsets.append(begin)
+        size.append(end - begin)
+    return offsets, size
+
+
+def _narrow(tensor, tensor_offsets, offsets, size):
+    for dim, (begin, length) in enumerate(zip(offsets, size)):
+        tensor = tensor.narrow(dim, begin - tensor_offsets[dim], length)
+    return tensor
+
+
+def load_sharded(state_dict, path):
+    r"""
+    Loads a sharded checkpoint saved by :func:`save_sharded` into
+    ``state_dict``, in place.
+
+    Every rank loads the parts of the state it holds, whatever the number of
+    ranks or the sharding the checkpoint was saved with: the tensors and
+    shards of ``state_dict`` get the elements of the saved tensor of the
+    same key that they span, which are only read from the files of the
+    checkpoint they are in. This needs no communication between the ranks.
+
+    The other entries of ``state_dict`` are replaced by their saved value.
+
+    Arguments:
+        state_dict (dict): The state of this rank, made of tensors and
+            :class:`Shard` of the size to load
+        path (str): The directory the checkpoint was saved to
+    """
+    with open(os.path.join(path, _METADATA_FILE), 'rb') as f:
+        metadata = pickle.load(f)
+
+    readers = {}
+    for key, value in state_dict.items():
+        if not isinstance(value, (Shard, torch.Tensor)):
+            if key in metadata['objects']:
+                state_dict[key] = metadata['objects'][key]
+            continue
+        if key not in metadata['tensors']:
+            raise RuntimeError("Missing key '{}' in the checkpoint".format(key))
+        entry = metadata['tensors'][key]
+
+        if isinstance(value, Shard):
+            target, target_offsets, global_size = value.tensor, value.offsets, value.global_size
+        else:
+            target, target_offsets, global_size = value, (0,) * value.dim(), tuple(value.size())
+        if tuple(global_size) != entry['size']:
+            raise RuntimeError("Size mismatch for '{}': the checkpoint has a tensor of size {}, "
+                               "but got one of size {}".format(key, entry['size'], tuple(global_size)))
+
+        for offsets, size, rank_file, record in entry['shards']:
+            overlap = _overlap(offsets, size, target_offsets, target.size())
+            if overlap is None:
+                continue
+            if rank_file not in readers:
+                readers[rank_file] = torch._C.PyTorchFileReader(os.path.join(path, rank_file))
+            saved = torch.empty(size, dtype=entry['dtype'])
+            numel = struct.pack("<Q", saved.numel())
+            saved.storage()._set_from_file(
+                io.BytesIO(numel + readers[rank_file].get_record(record)), None, False)
+            with torch.no_grad():
+                _narrow(target, target_offsets, *overlap).copy_(_narrow(saved, offsets, *overlap))
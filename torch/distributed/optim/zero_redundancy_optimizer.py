@@ -0,0 +1,114 @@
+import torch.distributed as dist
+from torch.distributed.distributed_c10d import _get_default_group
+
+
+class ZeroRedundancyOptimizer(object):
+    r"""
+    Wraps a local optimizer so that every process of a data parallel job only
+    keeps the optimizer state of ``1 / world_size`` of the parameters.
+
+    The parameters are grouped into buckets, and every bucket is split into one
+    shard per process. :meth:`step` reduce-scatters the gradients, so that every
+    process receives the averaged gradients of its own shards, runs the local
+    optimizer on those shards, and all-gathers the updated shards back into the
+    parameters of every process. The model must therefore not be wrapped in
+    :class:`~torch.nn.parallel.DistributedDataParallel`, which would allreduce
+    the gradients as well.
+
+    If ``module`` is given, :meth:`step` returns as soon as the all-gathers are
+    started, and forward pre-hooks on ``module`` wait for the bucket of each
+    parameter only when its submodule runs, which overlaps the all-gathers with
+    the next forward pass. Use :meth:`wait_for_parameters` to access the
+    parameters before that.
+
+    The process group must support ``reduce_scatter`` and ``all_gather``
+    (e.g. the NCCL backend), and all parameters must be dense and on the same
+    device.
+
+    Arguments:
+        params (iterable): the parameters of the model, in the same order on
+            all processes.
+        optimizer_class (type): the local optimizer class, e.g.
+            :class:`torch.optim.Adam`. It is constructed with the shards of
+            this process and ``defaults``.
+        process_group (ProcessGroup, optional): the process group to shard
+            across (default: the default group).
+        bucket_cap_mb (float): the maximum size of a bucket in megabytes.
+        module (torch.nn.Module, optional): the module that owns ``params``,
+            to overlap the all-gathers with its forward pass.
+        defaults: the keyword arguments of ``optimizer_class``.
+
+    Example::
+        >>> model = torch.nn.Linear(10, 10).cuda(rank)
+        >>> opt = ZeroRedundancyOptimizer(
+        >>>     model.parameters(), torch.optim.Adam, module=model, lr=0.01)
+        >>> model(input).sum().backward()
+        >>> opt.step()
+    """
+
+    def __init__(self, params, optimizer_class, process_group=None,
+                 bucket_cap_mb=25, module=None, **defaults):
+        self.params = list(params)
+        self.process_group = (
+            process_group if process_group is not None else _get_default_group())
+        self._sharded = dist._ShardedParameters(
+            self.params,
+            self.process_group,
+            int(bucket_cap_mb * 1024 * 1024))
+        self.optim = optimizer_class(self._sharded.shards(), **defaults)
+        self._hook_handles = []
+        if module is not None:
+            self._register_forward_pre_hooks(module)
+
+    def _register_forward_pre_hooks(self, module):
+        bucket_of = {
+            id(param): self._sharded.bucket_index(i)
+            for i, param in enumerate(self.params)
+        }
+        for submodule in module.modules():
+            buckets = sorted(set(
+                bucket_of[id(param)]
+                for param in submodule.parameters(recurse=False)
+                if id(param) in bucket_of
+            ))
+            if not buckets:
+                continue
+
+            def wait(submodule, inputs, buckets=buckets):
+                for bucket in buckets:
+                    self._sharded.wait_for_bucket(bucket)
+
+            self._hook_handles.append(submodule.register_forward_pre_hook(wait))
+
+    def zero_grad(self):
+        r"""Clears the gradients of the parameters."""
+        for param in self.params:
+            if param.grad is not None:
+                param.grad.detach_()
+                param.grad.zero_()
+
+    def step(self, closure=None):
+        r"""
+        Performs a single optimization step on the shards of this process and
+        gathers the updated parameters. ``closure`` is not supported, since
+        it would have to run on all processes with the full parameters.
+        """
+        if closure is not None:
+            raise ValueError(
+                "ZeroRedundancyOptimizer does not support a closure")
+        self._sharded.reduce_scatter_gradients()
+        self.optim.step()
+        self._sharded.all_gather_parameters()
+        if not self._hook_handles:
+            self._sharded.wait_for_all()
+
+    def wait_for_parameters(self):
+        r"""Waits for the pending all-gathers of :meth:`step`."""
+        self._sharded.wait_for_all()
+
+    def state_dict(self):
+        r"""The state of the local optimizer, for the shards of this process."""
+        return self.optim.state_dict()
+
+    def load_state_dict(self, state_dict):
+        self.optim.load_state_dict(state_dict)
@@ -89,6 +89,7 @@ def _process_group_construct_rpc_backend_options_handler(
     rpc_timeout,
     init_method,
     num_send_recv_threads=rpc_constants.DEFAULT_NUM_SEND_RECV_THREADS,
+    coalesce_latency_budget_us=0,
     **kwargs
 ):
     from . import ProcessGroupRpcBackendOptions
@@ -96,7 +97,8 @@ def _process_group_construct_rpc_backend_options_handler(
     return ProcessGroupRpcBackendOptions(
         rpc_timeout=rpc_timeout,
         init_method=init_method,
-        num_send_recv_threads=num_send_recv_threads
+        num_send_recv_threads=num_send_recv_threads,
+        coalesce_latency_budget_us=coalesce_latency_budget_us,
     )
 
 
@@ -141,6 +143,9 @@ def _process_group_init_backend_handler(
             group,
             rpc_backend_options.num_send_recv_threads,
             timedelta(seconds=rpc_backend_options.rpc_timeout),
+            timedelta(
+                microseconds=rpc_backend_options.coalesce_latency_budget_us
+            ),
         )
     except Exception as ex:
         dist.destroy_process_group()
@@ -157,6 +162,7 @@ def _tensorpipe_construct_rpc_backend_options_handler(
     rpc_timeout,
     init_method,
     worker_name_to_id=None,
+    device_maps=None,
     **kwargs
 ):
     from . import TensorPipeRpcBackendOptions
@@ -168,6 +174,8 @@ def _tensorpipe_construct_rpc_backend_options_handler(
     rpc_backend_options.rpc_timeout = rpc_timeout
     rpc_backend_options.init_method = init_method
     rpc_backend_options.worker_name_to_id = worker_name_to_id
+    if device_maps is not None:
+        rpc_backend_options.device_maps = device_maps
     return rpc_backend_options
 
 
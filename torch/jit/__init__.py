@@ -1726,6 +1726,9 @@ if _enabled:
             Arguments:
                 f: a string containing a file name.
                 _extra_files: Map from filename to contents which will be stored as part of 'f'.
+                _flat_bytecode: Save the bytecode in a flat format that the lite interpreter
+                    uses in place, without unpickling it, which makes loading faster. Such
+                    models can't be loaded by lite interpreters predating the format.
 
             """
             return self._c._save_for_mobile(*args, **kwargs)
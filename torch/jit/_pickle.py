@@ -1,6 +1,8 @@
 # These functions are referenced from the pickle archives produced by
 # ScriptModule.save()
 
+import struct
+
 
 # These (`build_*`) functions used to be used by `pickler.cpp` to specify
 # the type of the list for certain special types, but now all lists get
@@ -23,6 +25,20 @@ def build_boollist(data):
     return data
 
 
+# Long int, float and bool lists are written by `pickler.cpp` as the little
+# endian bytes of their elements
+def build_packed_intlist(data):
+    return list(struct.unpack('<{}q'.format(len(data) // 8), data))
+
+
+def build_packed_doublelist(data):
+    return list(struct.unpack('<{}d'.format(len(data) // 8), data))
+
+
+def build_packed_boollist(data):
+    return [byte != 0 for byte in bytearray(data)]
+
+
 def build_tensor_from_id(data):
     if isinstance(data, int):
         # just the id, can't really do anything
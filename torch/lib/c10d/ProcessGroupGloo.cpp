@@ -7,6 +7,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <limits>
 #include <type_traits>
 
 #include <gloo/allgather.h>
@@ -33,6 +34,11 @@
 #include <gloo/rendezvous/context.h>
 #include <gloo/rendezvous/prefix_store.h>
 
+#if defined(USE_CUDA) && GLOO_USE_CUDA
+#include <gloo/cuda_allreduce_halving_doubling.h>
+#include <gloo/cuda_allreduce_ring_chunked.h>
+#endif
+
 #define GENERATE_ALL_TYPES(type, func, args...)        \
   switch (type) {                                      \
     case ::at::ScalarType::Float:                      \
@@ -390,7 +396,11 @@ void ProcessGroupGloo::RecvWork::abort() {
 }
 
 ProcessGroupGloo::Options::Options()
-    : timeout(std::chrono::milliseconds(10 * 1000)), threads(2) {}
+    : timeout(std::chrono::milliseconds(10 * 1000)),
+      threads(2),
+      cudaAllreduceAlgorithm(CudaAllreduceAlgorithm::AUTO),
+      cudaAllreduceRingThreshold(256 * 1024),
+      cudaAllreducePipelined(false) {}
 
 namespace {
 
@@ -508,6 +518,9 @@ ProcessGroupGloo::ProcessGroupGloo(
     : ProcessGroup(rank, size),
       store_(new GlooStore(store)),
       stop_(false),
+      cudaAllreduceAlgorithm_(options.cudaAllreduceAlgorithm),
+      cudaAllreduceRingThreshold_(options.cudaAllreduceRingThreshold),
+      cudaAllreducePipelined_(options.cudaAllreducePipelined),
       collectiveCounter_(0) {
   auto& devices = options.devices;
   if (devices.empty()) {
@@ -1171,6 +1184,109 @@ class AsyncAllreduceCUDAWork : public AsyncAllreduceWork {
   std::vector<at::cuda::CUDAEvent> events;
 };
 
+#if defined(USE_CUDA) && GLOO_USE_CUDA
+
+// Runs the CUDA aware allreduce algorithms of Gloo on the device memory of
+// the tensors. The algorithm is created along with the work, in the order
+// of the collectives, as it takes the next slot of the context.
+class AsyncAllreduceCUDADeviceWork : public ProcessGroupGloo::AsyncWork {
+ public:
+  AsyncAllreduceCUDADeviceWork(
+      const std::shared_ptr<gloo::Context>& context,
+      std::vector<at::Tensor>& inputs,
+      ProcessGroupGloo::CudaAllreduceAlgorithm algorithm,
+      bool pipelined)
+      : inputs(inputs) {
+    initializeStreamsEvents(inputs, streams, events);
+
+    // The algorithms work on flat buffers
+    tmp.reserve(inputs.size());
+    at::cuda::OptionalCUDAStreamGuard guard;
+    for (size_t i = 0; i < inputs.size(); i++) {
+      guard.reset_stream(streams[i]);
+      tmp.push_back(inputs[i].contiguous());
+    }
+
+    switch (inputs[0].scalar_type()) {
+      case at::ScalarType::Float:
+        initializeAlgorithm<float>(context, algorithm, pipelined);
+        break;
+      case at::ScalarType::Double:
+        initializeAlgorithm<double>(context, algorithm, pipelined);
+        break;
+      case at::ScalarType::Half:
+        initializeAlgorithm<gloo::float16>(context, algorithm, pipelined);
+        break;
+      default:
+        throw std::runtime_error("Invalid scalar type");
+    }
+  }
+
+  void run() override {
+    // The algorithm runs on the streams, and waits for them
+    gloo_algorithm->run();
+
+    at::cuda::OptionalCUDAStreamGuard stream_guard;
+    for (size_t i = 0; i < inputs.size(); i++) {
+      stream_guard.reset_stream(streams[i]);
+      if (!tmp[i].is_same(inputs[i])) {
+        inputs[i].copy_(tmp[i], /* non_blocking */ true);
+      }
+      events[i].record(streams[i]);
+    }
+  }
+
+  void synchronize() override {
+    // Synchronize with the copy back to CUDA tensors.
+    at::cuda::OptionalCUDAGuard guard;
+    for (size_t i = 0; i < inputs.size(); i++) {
+      guard.set_index(inputs[i].device().index());
+      events[i].block(at::cuda::getCurrentCUDAStream());
+    }
+  }
+
+  std::vector<at::Tensor> inputs;
+  std::vector<at::Tensor> tmp;
+  std::vector<at::cuda::CUDAStream> streams;
+  std::vector<at::cuda::CUDAEvent> events;
+  std::unique_ptr<gloo::Algorithm> gloo_algorithm;
+
+ private:
+  template <template <typename, typename> class A, typename T, typename... Args>
+  void makeAlgorithm(
+      const std::shared_ptr<gloo::Context>& context,
+      Args... args) {
+    std::vector<T*> ptrs;
+    std::vector<cudaStream_t> cuda_streams;
+    for (size_t i = 0; i < tmp.size(); i++) {
+      ptrs.push_back(static_cast<T*>(tmp[i].data_ptr()));
+      cuda_streams.push_back(streams[i].stream());
+    }
+    const int count = static_cast<int>(tmp[0].numel());
+    if (context->getDevice()->hasGPUDirect()) {
+      gloo_algorithm.reset(new A<T, gloo::CudaDeviceWorkspace<T>>(
+          context, ptrs, count, cuda_streams, args...));
+    } else {
+      gloo_algorithm.reset(new A<T, gloo::CudaHostWorkspace<T>>(
+          context, ptrs, count, cuda_streams, args...));
+    }
+  }
+
+  template <typename T>
+  void initializeAlgorithm(
+      const std::shared_ptr<gloo::Context>& context,
+      ProcessGroupGloo::CudaAllreduceAlgorithm algorithm,
+      bool pipelined) {
+    if (algorithm == ProcessGroupGloo::CudaAllreduceAlgorithm::RING_CHUNKED) {
+      makeAlgorithm<gloo::CudaAllreduceRingChunked, T>(context);
+    } else {
+      makeAlgorithm<gloo::CudaAllreduceHalvingDoubling, T>(context, pipelined);
+    }
+  }
+};
+
+#endif
+
 class AsyncSparseAllreduceCUDAWork : public AsyncSparseAllreduceWork {
  public:
   AsyncSparseAllreduceCUDAWork(
@@ -1236,6 +1352,33 @@ class AsyncSparseAllreduceCUDAWork : public AsyncSparseAllreduceWork {
 
 } // namespace
 
+// The choice must only depend on what is the same in all the processes, so
+// that they run the same algorithm.
+ProcessGroupGloo::CudaAllreduceAlgorithm
+ProcessGroupGloo::selectCudaAllreduceAlgorithm(
+    const std::vector<at::Tensor>& inputs,
+    ReduceOp reduceOp) const {
+#if defined(USE_CUDA) && GLOO_USE_CUDA
+  const auto& tensor = inputs[0];
+  const auto scalarType = tensor.scalar_type();
+  const bool supported = reduceOp == ReduceOp::SUM &&
+      (scalarType == at::kFloat || scalarType == at::kDouble ||
+       scalarType == at::kHalf) &&
+      tensor.numel() <= std::numeric_limits<int>::max();
+  if (!supported || cudaAllreduceAlgorithm_ != CudaAllreduceAlgorithm::AUTO) {
+    return supported ? cudaAllreduceAlgorithm_ : CudaAllreduceAlgorithm::HOST;
+  }
+  const size_t bytes = tensor.numel() * tensor.element_size();
+  const bool powerOfTwo = (size_ & (size_ - 1)) == 0;
+  if (bytes >= cudaAllreduceRingThreshold_ && !powerOfTwo) {
+    return CudaAllreduceAlgorithm::RING_CHUNKED;
+  }
+  return CudaAllreduceAlgorithm::HALVING_DOUBLING;
+#else
+  return CudaAllreduceAlgorithm::HOST;
+#endif
+}
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce(
     std::vector<at::Tensor>& inputs,
     const AllreduceOptions& opts) {
@@ -1280,7 +1423,15 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce(
     }
 #ifdef USE_CUDA
   } else if (device.type() == at::kCUDA) {
-    if (layout == c10::kStrided) {
+    const auto algorithm = layout == c10::kStrided
+        ? selectCudaAllreduceAlgorithm(inputs, opts.reduceOp)
+        : CudaAllreduceAlgorithm::HOST;
+    if (layout == c10::kStrided && algorithm != CudaAllreduceAlgorithm::HOST) {
+#if defined(USE_CUDA) && GLOO_USE_CUDA
+      work = std::make_shared<AsyncAllreduceCUDADeviceWork>(
+          std::move(context), inputs, algorithm, cudaAllreducePipelined_);
+#endif
+    } else if (layout == c10::kStrided) {
       work = std::make_shared<AsyncAllreduceCUDAWork>(
           std::move(context), inputs, opts.reduceOp, tag);
     } else if (layout == c10::kSparse) {
@@ -123,12 +123,38 @@ class ProcessGroupGloo : public ProcessGroup {
     int srcRank_;
   };
 
+  // Algorithms of the allreduce of dense CUDA tensors.
+  //
+  // HOST copies the tensors to pinned host memory and reduces them there.
+  // RING_CHUNKED and HALVING_DOUBLING run the CUDA aware algorithms of Gloo,
+  // which reduce the tensors of the process on the device, and only go
+  // through host memory for the exchanges across processes when the
+  // transport doesn't support GPUDirect. They only implement ReduceOp.SUM
+  // of float, double and half tensors, HOST being used otherwise.
+  //
+  // AUTO picks HALVING_DOUBLING, whose latency grows with the logarithm of
+  // the world size, unless the message reaches cudaAllreduceRingThreshold
+  // bytes with a world size that isn't a power of two, for which the
+  // bandwidth optimal RING_CHUNKED is better.
+  enum class CudaAllreduceAlgorithm {
+    AUTO,
+    HOST,
+    RING_CHUNKED,
+    HALVING_DOUBLING,
+  };
+
   struct Options {
     explicit Options();
 
     std::vector<std::shared_ptr<::gloo::transport::Device>> devices;
     std::chrono::milliseconds timeout;
     int threads;
+
+    CudaAllreduceAlgorithm cudaAllreduceAlgorithm;
+    size_t cudaAllreduceRingThreshold;
+    // Whether HALVING_DOUBLING pipelines the reduction and broadcast on the
+    // devices with the exchanges across processes, chunk by chunk
+    bool cudaAllreducePipelined;
   };
 
   // Helper functions to create a new device object.
@@ -231,6 +257,10 @@ class ProcessGroupGloo : public ProcessGroup {
   std::vector<std::thread> threads_;
   bool stop_;
 
+  const CudaAllreduceAlgorithm cudaAllreduceAlgorithm_;
+  const size_t cudaAllreduceRingThreshold_;
+  const bool cudaAllreducePipelined_;
+
   // Incremented for every collective we kick off.
   // The value is used as tag for collective operations. Collectives are kicked
   // off in identical order across processes. Therefore the tag can be used
@@ -245,6 +275,11 @@ class ProcessGroupGloo : public ProcessGroup {
   // to contexts being used in a round-robin fashion.
   std::shared_ptr<::gloo::Context> getContext(uint32_t tag);
 
+  // Returns the algorithm of the allreduce of dense CUDA tensors.
+  CudaAllreduceAlgorithm selectCudaAllreduceAlgorithm(
+      const std::vector<at::Tensor>& inputs,
+      ReduceOp reduceOp) const;
+
   // Entrypoint for worker threads.
   void runLoop(int workerIndex);
 
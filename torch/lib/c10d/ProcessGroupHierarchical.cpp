@@ -0,0 +1,366 @@
+#include <c10d/ProcessGroupHierarchical.hpp>
+
+#include <unistd.h>
+
+#include <algorithm>
+
+#include <c10/core/DeviceGuard.h>
+#include <c10d/PrefixStore.hpp>
+#include <c10d/Utils.hpp>
+
+namespace c10d {
+
+namespace {
+
+std::vector<uint8_t> toBytes(const std::string& str) {
+  return std::vector<uint8_t>(str.begin(), str.end());
+}
+
+std::string fromBytes(const std::vector<uint8_t>& bytes) {
+  return std::string(bytes.begin(), bytes.end());
+}
+
+std::string getHostname() {
+  char hostname[256];
+  SYSCHECK_ERR_RETURN_NEG1(gethostname(hostname, sizeof(hostname)));
+  hostname[sizeof(hostname) - 1] = '\0';
+  return std::string(hostname);
+}
+
+void checkTensorsForAllreduce(const std::vector<at::Tensor>& tensors) {
+  TORCH_CHECK(!tensors.empty(), "ProcessGroupHierarchical: empty tensor list");
+  const auto& first = tensors.front();
+  for (const auto& tensor : tensors) {
+    TORCH_CHECK(
+        tensor.layout() == at::kStrided,
+        "ProcessGroupHierarchical only supports dense tensors");
+    TORCH_CHECK(
+        tensor.options().type_equal(first.options()),
+        "ProcessGroupHierarchical requires tensors of the same type");
+    TORCH_CHECK(
+        tensor.device() == first.device(),
+        "ProcessGroupHierarchical requires tensors on the same device");
+  }
+}
+
+} // namespace
+
+ProcessGroupHierarchical::Options::Options()
+    : localSize(0), useReduceScatter(true) {}
+
+ProcessGroupHierarchical::ProcessGroupHierarchical(
+    const std::shared_ptr<Store>& store,
+    int rank,
+    int size,
+    const ProcessGroupFactory& factory,
+    Options options)
+    : ProcessGroup(rank, size), options_(options), stop_(false) {
+  assignNodes(store);
+
+  globalGroup_ =
+      factory(std::make_shared<PrefixStore>("global", store), rank_, size_);
+  intraGroup_ = factory(
+      std::make_shared<PrefixStore>(
+          "intra/" + std::to_string(nodeRank_), store),
+      localRank_,
+      localSize_);
+  interGroup_ = factory(
+      std::make_shared<PrefixStore>(
+          "inter/" + std::to_string(localRank_), store),
+      nodeRank_,
+      numNodes_);
+
+  workerThread_ = std::thread(&ProcessGroupHierarchical::runLoop, this);
+}
+
+ProcessGroupHierarchical::~ProcessGroupHierarchical() {
+  {
+    std::unique_lock<std::mutex> lock(workMutex_);
+    stop_ = true;
+  }
+  workProduceCV_.notify_one();
+  workerThread_.join();
+}
+
+void ProcessGroupHierarchical::assignNodes(
+    const std::shared_ptr<Store>& store) {
+  if (options_.localSize > 0) {
+    localSize_ = options_.localSize;
+    TORCH_CHECK(
+        size_ % localSize_ == 0,
+        "ProcessGroupHierarchical: world size ",
+        size_,
+        " is not a multiple of the local size ",
+        localSize_);
+    localRank_ = rank_ % localSize_;
+    nodeRank_ = rank_ / localSize_;
+    numNodes_ = size_ / localSize_;
+    return;
+  }
+
+  // Exchange hostnames. Nodes are numbered in order of their lowest rank.
+  auto hostnameStore = std::make_shared<PrefixStore>("hostname", store);
+  hostnameStore->set(std::to_string(rank_), toBytes(getHostname()));
+  std::vector<std::string> keys(size_);
+  for (int i = 0; i < size_; i++) {
+    keys[i] = std::to_string(i);
+  }
+  std::vector<std::string> hostnames(size_);
+  const auto values = hostnameStore->multiGet(keys);
+  for (int i = 0; i < size_; i++) {
+    hostnames[i] = fromBytes(values[i]);
+  }
+
+  std::vector<std::string> nodes;
+  std::vector<int> nodeSizes;
+  localRank_ = -1;
+  nodeRank_ = -1;
+  for (int i = 0; i < size_; i++) {
+    const auto it = std::find(nodes.begin(), nodes.end(), hostnames[i]);
+    const auto node = it - nodes.begin();
+    if (it == nodes.end()) {
+      nodes.push_back(hostnames[i]);
+      nodeSizes.push_back(0);
+    }
+    if (i == rank_) {
+      nodeRank_ = node;
+      localRank_ = nodeSizes[node];
+    }
+    nodeSizes[node]++;
+  }
+  numNodes_ = nodes.size();
+  localSize_ = nodeSizes[nodeRank_];
+  for (const auto nodeSize : nodeSizes) {
+    TORCH_CHECK(
+        nodeSize == localSize_,
+        "ProcessGroupHierarchical requires the same number of processes on "
+        "every node");
+  }
+}
+
+void ProcessGroupHierarchical::runLoop() {
+  std::unique_lock<std::mutex> lock(workMutex_);
+  while (true) {
+    workProduceCV_.wait(lock, [&] { return stop_ || !workQueue_.empty(); });
+    if (workQueue_.empty()) {
+      // stop_ is set and all work has run.
+      break;
+    }
+    auto fn = std::move(workQueue_.front());
+    workQueue_.pop_front();
+    lock.unlock();
+    fn();
+    lock.lock();
+  }
+}
+
+void ProcessGroupHierarchical::runAllreduce(
+    at::Tensor& flat,
+    ReduceOp reduceOp) {
+  c10::DeviceGuard guard(flat.device());
+  const auto numel = flat.numel();
+  const auto shardSize = (numel + localSize_ - 1) / localSize_;
+
+  // Pad so that the buffer splits into localSize_ equal shards.
+  auto padded = flat;
+  if (shardSize * localSize_ != numel) {
+    padded = at::zeros({shardSize * localSize_}, flat.options());
+    padded.narrow(0, 0, numel).copy_(flat);
+  }
+  std::vector<at::Tensor> shards;
+  shards.reserve(localSize_);
+  for (int i = 0; i < localSize_; i++) {
+    shards.push_back(padded.narrow(0, i * shardSize, shardSize));
+  }
+
+  // 1. Reduce within the node, leaving every process with its own shard.
+  std::vector<at::Tensor> shard;
+  if (options_.useReduceScatter) {
+    std::vector<std::vector<at::Tensor>> inputs = {shards};
+    shard = {at::empty({shardSize}, flat.options())};
+    ReduceScatterOptions opts;
+    opts.reduceOp = reduceOp;
+    intraGroup_->reduce_scatter(shard, inputs, opts)->wait();
+  } else {
+    std::vector<at::Tensor> inputs = {padded};
+    AllreduceOptions opts;
+    opts.reduceOp = reduceOp;
+    intraGroup_->allreduce(inputs, opts)->wait();
+    shard = {shards[localRank_]};
+  }
+
+  // 2. Reduce the shard across nodes.
+  {
+    AllreduceOptions opts;
+    opts.reduceOp = reduceOp;
+    interGroup_->allreduce(shard, opts)->wait();
+  }
+
+  // 3. Gather the shards within the node.
+  {
+    std::vector<std::vector<at::Tensor>> outputs = {shards};
+    intraGroup_->allgather(outputs, shard)->wait();
+  }
+
+  if (!padded.is_same(flat)) {
+    flat.copy_(padded.narrow(0, 0, numel));
+  }
+}
+
+void ProcessGroupHierarchical::enqueue(std::function<void()> fn) {
+  {
+    std::unique_lock<std::mutex> lock(workMutex_);
+    workQueue_.push_back(std::move(fn));
+  }
+  workProduceCV_.notify_one();
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::enqueueAllreduce(
+    std::vector<at::Tensor> tensors,
+    at::Tensor flat,
+    ReduceOp reduceOp) {
+  auto work = std::make_shared<WorkHierarchical>();
+  enqueue([this, work, tensors, flat, reduceOp]() mutable {
+    try {
+      runAllreduce(flat, reduceOp);
+      if (tensors.size() != 1 || !flat.is_alias_of(tensors[0])) {
+        int64_t offset = 0;
+        for (auto& tensor : tensors) {
+          const auto numel = tensor.numel();
+          tensor.copy_(flat.narrow(0, offset, numel).view(tensor.sizes()));
+          offset += numel;
+        }
+      }
+      work->finish();
+    } catch (...) {
+      work->finish(std::current_exception());
+    }
+  });
+  return work;
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::allreduce(
+    std::vector<at::Tensor>& tensors,
+    const AllreduceOptions& opts) {
+  TORCH_CHECK(
+      tensors.size() == 1,
+      "ProcessGroupHierarchical::allreduce takes a single tensor");
+  checkTensorsForAllreduce(tensors);
+  if (localSize_ == 1 || numNodes_ == 1) {
+    return globalGroup_->allreduce(tensors, opts);
+  }
+  auto& tensor = tensors[0];
+  auto flat = tensor.is_contiguous() ? tensor.view({-1})
+                                     : tensor.contiguous().view({-1});
+  return enqueueAllreduce(tensors, flat, opts.reduceOp);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::
+    allreduce_coalesced(
+        std::vector<at::Tensor>& tensors,
+        const AllreduceCoalescedOptions& opts) {
+  checkTensorsForAllreduce(tensors);
+  if (localSize_ == 1 || numNodes_ == 1) {
+    return globalGroup_->allreduce_coalesced(tensors, opts);
+  }
+  std::vector<at::Tensor> flatTensors;
+  flatTensors.reserve(tensors.size());
+  for (const auto& tensor : tensors) {
+    flatTensors.push_back(tensor.reshape({-1}));
+  }
+  return enqueueAllreduce(tensors, at::cat(flatTensors), opts.reduceOp);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::broadcast(
+    std::vector<at::Tensor>& tensors,
+    const BroadcastOptions& opts) {
+  return globalGroup_->broadcast(tensors, opts);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::reduce(
+    std::vector<at::Tensor>& tensors,
+    const ReduceOptions& opts) {
+  return globalGroup_->reduce(tensors, opts);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::allgather(
+    std::vector<std::vector<at::Tensor>>& outputs,
+    std::vector<at::Tensor>& inputs,
+    const AllgatherOptions& opts) {
+  return globalGroup_->allgather(outputs, inputs, opts);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::allgather_base(
+    at::Tensor& outputBuffer,
+    at::Tensor& inputBuffer,
+    const AllgatherOptions& opts) {
+  return globalGroup_->allgather_base(outputBuffer, inputBuffer, opts);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::
+    allgather_coalesced(
+        std::vector<std::vector<at::Tensor>>& outputTensorLists,
+        std::vector<at::Tensor>& inputTensors,
+        const AllgatherOptions& opts) {
+  return globalGroup_->allgather_coalesced(
+      outputTensorLists, inputTensors, opts);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::gather(
+    std::vector<std::vector<at::Tensor>>& outputs,
+    std::vector<at::Tensor>& inputs,
+    const GatherOptions& opts) {
+  return globalGroup_->gather(outputs, inputs, opts);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::scatter(
+    std::vector<at::Tensor>& outputs,
+    std::vector<std::vector<at::Tensor>>& inputs,
+    const ScatterOptions& opts) {
+  return globalGroup_->scatter(outputs, inputs, opts);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::reduce_scatter(
+    std::vector<at::Tensor>& outputs,
+    std::vector<std::vector<at::Tensor>>& inputs,
+    const ReduceScatterOptions& opts) {
+  return globalGroup_->reduce_scatter(outputs, inputs, opts);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::send(
+    std::vector<at::Tensor>& tensors,
+    int dstRank,
+    int tag) {
+  return globalGroup_->send(tensors, dstRank, tag);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::recv(
+    std::vector<at::Tensor>& tensors,
+    int srcRank,
+    int tag) {
+  return globalGroup_->recv(tensors, srcRank, tag);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::recvAnysource(
+    std::vector<at::Tensor>& tensors,
+    int tag) {
+  return globalGroup_->recvAnysource(tensors, tag);
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::barrier(
+    const BarrierOptions& opts) {
+  // Run on the worker thread, so that the barrier also waits for all
+  // hierarchical allreduces that were issued before it.
+  auto work = std::make_shared<WorkHierarchical>();
+  enqueue([this, work, opts]() {
+    try {
+      globalGroup_->barrier(opts)->wait();
+      work->finish();
+    } catch (...) {
+      work->finish(std::current_exception());
+    }
+  });
+  return work;
+}
+
+} // namespace c10d
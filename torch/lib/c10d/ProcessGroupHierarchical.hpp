@@ -0,0 +1,194 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <c10d/ProcessGroup.hpp>
+#include <c10d/Store.hpp>
+
+namespace c10d {
+
+// ProcessGroupHierarchical implements two-level allreduce for clusters of
+// multi-GPU nodes.
+//
+// Processes are grouped into nodes, either by hostname or in blocks of
+// consecutive ranks of `Options::localSize`. All nodes must hold the same
+// number of processes. The constructor creates three process groups through
+// the factory it is given, using prefixed views of the store:
+//
+//   - an intra-node group of the processes on the same node,
+//   - an inter-node group of the processes with the same local rank on
+//     every node, and
+//   - a global group of all processes.
+//
+// `allreduce` and `allreduce_coalesced` reduce-scatter the flattened input
+// within the node, allreduce the resulting shard across nodes, and allgather
+// the shards within the node. Every process only sends 1/localSize of the
+// data across nodes, and these transfers run in parallel for all local ranks.
+// All other collectives are forwarded to the global group. `barrier` also
+// waits for all previously issued hierarchical allreduces.
+//
+// The three stages of a hierarchical allreduce run in order on a worker
+// thread, so `allreduce` returns without waiting for them. CUDA inputs are
+// expected to be produced and consumed on the default stream, which is the
+// stream the worker thread issues its operations on.
+//
+// All functions of the class are expected to be called in the same order
+// across all processes in the process group. This is the only way that we
+// can guarantee to match up the same calls among all processes.
+//
+class ProcessGroupHierarchical final : public ProcessGroup {
+ public:
+  // Creates a process group of the given rank and size over a store.
+  using ProcessGroupFactory = std::function<std::shared_ptr<ProcessGroup>(
+      const std::shared_ptr<Store>&,
+      int,
+      int)>;
+
+  struct Options {
+    explicit Options();
+
+    // Number of processes per node. If zero, processes are grouped into
+    // nodes by hostname.
+    int localSize;
+
+    // Whether the intra-node group supports reduce_scatter. If it doesn't
+    // (e.g. ProcessGroupGloo), the intra-node stage is an allreduce instead.
+    bool useReduceScatter;
+  };
+
+  class WorkHierarchical : public ProcessGroup::Work {
+   protected:
+    friend class ProcessGroupHierarchical;
+  };
+
+  explicit ProcessGroupHierarchical(
+      const std::shared_ptr<Store>& store,
+      int rank,
+      int size,
+      const ProcessGroupFactory& factory,
+      Options options = Options());
+
+  ~ProcessGroupHierarchical() override;
+
+  int getLocalRank() const {
+    return localRank_;
+  }
+
+  int getLocalSize() const {
+    return localSize_;
+  }
+
+  int getNodeRank() const {
+    return nodeRank_;
+  }
+
+  int getNumNodes() const {
+    return numNodes_;
+  }
+
+  std::shared_ptr<ProcessGroup::Work> broadcast(
+      std::vector<at::Tensor>& tensors,
+      const BroadcastOptions& opts = BroadcastOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> allreduce(
+      std::vector<at::Tensor>& tensors,
+      const AllreduceOptions& opts = AllreduceOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> allreduce_coalesced(
+      std::vector<at::Tensor>& tensors,
+      const AllreduceCoalescedOptions& opts =
+          AllreduceCoalescedOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> reduce(
+      std::vector<at::Tensor>& tensors,
+      const ReduceOptions& opts = ReduceOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> allgather(
+      std::vector<std::vector<at::Tensor>>& outputs,
+      std::vector<at::Tensor>& inputs,
+      const AllgatherOptions& opts = AllgatherOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> allgather_base(
+      at::Tensor& outputBuffer,
+      at::Tensor& inputBuffer,
+      const AllgatherOptions& opts = AllgatherOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> allgather_coalesced(
+      std::vector<std::vector<at::Tensor>>& outputTensorLists,
+      std::vector<at::Tensor>& inputTensors,
+      const AllgatherOptions& opts = AllgatherOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> gather(
+      std::vector<std::vector<at::Tensor>>& outputs,
+      std::vector<at::Tensor>& inputs,
+      const GatherOptions& opts = GatherOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> scatter(
+      std::vector<at::Tensor>& outputs,
+      std::vector<std::vector<at::Tensor>>& inputs,
+      const ScatterOptions& opts = ScatterOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> reduce_scatter(
+      std::vector<at::Tensor>& outputs,
+      std::vector<std::vector<at::Tensor>>& inputs,
+      const ReduceScatterOptions& opts = ReduceScatterOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> send(
+      std::vector<at::Tensor>& tensors,
+      int dstRank,
+      int tag) override;
+
+  std::shared_ptr<ProcessGroup::Work> recv(
+      std::vector<at::Tensor>& tensors,
+      int srcRank,
+      int tag) override;
+
+  std::shared_ptr<ProcessGroup::Work> recvAnysource(
+      std::vector<at::Tensor>& tensors,
+      int tag) override;
+
+  std::shared_ptr<ProcessGroup::Work> barrier(
+      const BarrierOptions& opts = BarrierOptions()) override;
+
+ private:
+  // Derives localRank_, localSize_, nodeRank_ and numNodes_.
+  void assignNodes(const std::shared_ptr<Store>& store);
+
+  // Runs the three stages of a hierarchical allreduce of `tensors` into
+  // `flat`, a contiguous 1-dimensional buffer for their contents, and copies
+  // the result back into `tensors` if `flat` doesn't alias them.
+  std::shared_ptr<ProcessGroup::Work> enqueueAllreduce(
+      std::vector<at::Tensor> tensors,
+      at::Tensor flat,
+      ReduceOp reduceOp);
+
+  void runAllreduce(at::Tensor& flat, ReduceOp reduceOp);
+
+  // Queues a function to run on the worker thread.
+  void enqueue(std::function<void()> fn);
+
+  void runLoop();
+
+  const Options options_;
+  int localRank_;
+  int localSize_;
+  int nodeRank_;
+  int numNodes_;
+
+  std::shared_ptr<ProcessGroup> intraGroup_;
+  std::shared_ptr<ProcessGroup> interGroup_;
+  std::shared_ptr<ProcessGroup> globalGroup_;
+
+  bool stop_;
+  std::mutex workMutex_;
+  std::condition_variable workProduceCV_;
+  std::deque<std::function<void()>> workQueue_;
+  std::thread workerThread_;
+};
+
+} // namespace c10d
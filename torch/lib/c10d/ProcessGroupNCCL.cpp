@@ -10,6 +10,7 @@
 #include <c10/cuda/CUDAGuard.h>
 
 #include <c10d/Utils.hpp>
+#include <torch/csrc/autograd/record_function.h>
 
 namespace c10d {
 
@@ -76,6 +77,14 @@ std::string getKeyFromDevices(const std::vector<at::Device>& devices) {
   return deviceList;
 }
 
+// Get the key of the communicators of a channel for a set of devices
+std::string getKeyForChannel(const std::string& devicesKey, int64_t channel) {
+  if (channel == 0) {
+    return devicesKey;
+  }
+  return devicesKey + ";" + std::to_string(channel);
+}
+
 // Get the list of devices from list of tensors
 std::vector<at::Device> getDeviceList(const std::vector<at::Tensor>& tensors) {
   std::vector<at::Device> res;
@@ -286,6 +295,20 @@ ProcessGroupNCCL::ProcessGroupNCCL(
         std::string(NCCL_BLOCKING_WAIT));
   }
 
+  char* streamsPerDevice = getenv(NCCL_STREAMS_PER_DEVICE);
+  if (streamsPerDevice != nullptr) {
+    try {
+      streamsPerDevice_ = std::stoi(streamsPerDevice);
+    } catch (std::exception& e) {
+      streamsPerDevice_ = 0;
+    }
+    if (streamsPerDevice_ < 1) {
+      throw std::runtime_error(
+          "Invalid value for environment variable: " +
+          std::string(NCCL_STREAMS_PER_DEVICE));
+    }
+  }
+
 #ifdef ENABLE_NCCL_ERROR_CHECKING
   ncclCommWatchdogThread_ =
       std::thread(&ProcessGroupNCCL::ncclCommWatchdog, this);
@@ -629,9 +652,13 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::collective(
     std::vector<at::Tensor>& outputs,
     Fn fn,
     PreProcess pre,
-    PostProcess post) {
+    PostProcess post,
+    const char* profilingTitle,
+    int64_t channel) {
+  TORCH_CHECK(channel >= 0, "Expected a nonnegative channel, got ", channel);
   const auto devices = getDeviceList(inputs);
-  const auto key = getKeyFromDevices(devices);
+  const auto key = getKeyForChannel(
+      getKeyFromDevices(devices), channel % streamsPerDevice_);
   auto& ncclComms = getNCCLComm(key, devices);
 
   // First let NCCL streams wait for input tensors allocation streams
@@ -661,6 +688,15 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::collective(
   }
 
   {
+    // The profiler records the CUDA events of the range on the current
+    // stream of the current device. Making them the NCCL stream of the first
+    // device at the start and end of the range makes its CUDA time the time
+    // of the NCCL kernels, which are launched by ncclGroupEnd() on exit of the
+    // group guard, before the end of the range.
+    at::cuda::CUDAStreamGuard profilingStreamGuard(ncclStreams_[key][0]);
+    RECORD_FUNCTION(
+        profilingTitle,
+        std::vector<c10::IValue>(inputs.begin(), inputs.end()));
     AutoNcclGroup nccl_group_guard;
     for (size_t i = 0; i < inputs.size(); ++i) {
       gpuGuard.set_index(devices[i].index());
@@ -668,6 +704,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::collective(
       C10D_NCCL_CHECK(
           fn(inputs[i], outputs[i], ncclComms[i]->getNcclComm(), ncclStream));
     }
+    gpuGuard.set_index(devices[0].index());
   }
 
   post(ncclStreams_[key]);
@@ -689,13 +726,17 @@ template <typename Fn>
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::collective(
     std::vector<at::Tensor>& inputs,
     std::vector<at::Tensor>& outputs,
-    Fn fn) {
+    Fn fn,
+    const char* profilingTitle,
+    int64_t channel) {
   return collective(
       inputs,
       outputs,
       fn,
       [](std::vector<at::cuda::CUDAStream>&) {},
-      [](std::vector<at::cuda::CUDAStream>&) {});
+      [](std::vector<at::cuda::CUDAStream>&) {},
+      profilingTitle,
+      channel);
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allreduce(
@@ -718,7 +759,9 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allreduce(
             ncclOp[opts.reduceOp],
             comm,
             stream.stream());
-      });
+      },
+      "nccl:all_reduce",
+      opts.channel);
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allreduce_coalesced(
@@ -748,7 +791,8 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::broadcast(
             root,
             comm,
             stream.stream());
-      });
+      },
+      "nccl:broadcast");
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::reduce(
@@ -773,7 +817,8 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::reduce(
             root,
             comm,
             stream.stream());
-      });
+      },
+      "nccl:reduce");
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allgather(
@@ -816,7 +861,8 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allgather(
             outputTensors[i][j].copy_(outputFlattened[i][j], true);
           }
         }
-      });
+      },
+      "nccl:all_gather");
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allgather_coalesced(
@@ -868,7 +914,8 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::reduce_scatter(
           }
         }
       },
-      [&](std::vector<at::cuda::CUDAStream>& ncclStreams) {});
+      [&](std::vector<at::cuda::CUDAStream>& ncclStreams) {},
+      "nccl:reduce_scatter");
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::barrier(
@@ -17,6 +17,12 @@ namespace c10d {
 // non-blocking.
 constexpr const char* NCCL_BLOCKING_WAIT = "NCCL_BLOCKING_WAIT";
 
+// Environment variable which sets the number of NCCL communicators, each with
+// its own stream, that the process group creates per set of devices. The
+// allreduces are assigned to them by the channel of their options, so that
+// allreduces on different channels can run concurrently. Defaults to 1.
+constexpr const char* NCCL_STREAMS_PER_DEVICE = "NCCL_STREAMS_PER_DEVICE";
+
 // ProcessGroupNCCL implements NCCL bindings for c10d.
 //
 // All functions of the class are expected to be called in the same order
@@ -252,18 +258,26 @@ class ProcessGroupNCCL : public ProcessGroup {
   //    ncclResult_t fn(at::Tensor& input, at::Tensor& output,
   //                    ncclComm_t, at::cuda::CUDAStream&);
   //    void {pre,post}(std::vector<at::cuda::CUDAStream&>);
+  //
+  // The collective runs on the communicators and streams of the given channel,
+  // modulo the number of streams per device, and is recorded for the profiler
+  // as profilingTitle.
   template <typename Fn>
   std::shared_ptr<ProcessGroup::Work> collective(
       std::vector<at::Tensor>& input,
       std::vector<at::Tensor>& output,
-      Fn fn);
+      Fn fn,
+      const char* profilingTitle,
+      int64_t channel = 0);
   template <typename Fn, typename PreProcess, typename PostProcess>
   std::shared_ptr<ProcessGroup::Work> collective(
       std::vector<at::Tensor>& input,
       std::vector<at::Tensor>& output,
       Fn fn,
       PreProcess pre,
-      PostProcess post);
+      PostProcess post,
+      const char* profilingTitle,
+      int64_t channel = 0);
 
   // Checks for NCCL errors on each of the communicators and returns an
   // appropriate exception_ptr (nullptr if no errors).
@@ -313,6 +327,9 @@ class ProcessGroupNCCL : public ProcessGroup {
   //      "0,4,5,6,7,1,2,3"
   //
   //      Note that the order of the device for the tensor list matters.
+  //
+  //      The communicators of the channels other than 0 have the channel
+  //      appended to the key, e.g. "0,1;2" for channel 2 of devices 0 and 1.
   std::unordered_map<std::string, std::vector<std::shared_ptr<NCCLComm>>>
       devNCCLCommMap_;
 
@@ -372,6 +389,10 @@ class ProcessGroupNCCL : public ProcessGroup {
   // Timeout for operations. This is only used when blockingWait_ is enabled.
   std::chrono::milliseconds opTimeout_;
 
+  // The number of communicators and streams per set of devices, see
+  // NCCL_STREAMS_PER_DEVICE.
+  int64_t streamsPerDevice_ = 1;
+
   // Set of communicators that this process group has aborted and their
   // ncclUniqueId has been written to the store. We don't need a lock
   // for this map since only the watchdog thread accesses this set. The
@@ -28,6 +28,18 @@ class Store {
 
   virtual std::vector<uint8_t> get(const std::string& key) = 0;
 
+  // Sets all of the keys to their values. Stores that can do so send them
+  // in a single request; the default implementation calls set for each key.
+  virtual void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values);
+
+  // Waits for all of the keys and returns their values. Stores that can do
+  // so fetch them in a single round trip; the default implementation calls
+  // get for each key.
+  virtual std::vector<std::vector<uint8_t>> multiGet(
+      const std::vector<std::string>& keys);
+
   virtual int64_t add(const std::string& key, int64_t value) = 0;
 
   virtual bool check(const std::vector<std::string>& keys) = 0;
@@ -1,6 +1,10 @@
 #include <c10d/TCPStore.hpp>
 
+#ifdef __linux__
+#include <sys/epoll.h>
+#else
 #include <poll.h>
+#endif
 
 #include <unistd.h>
 #include <algorithm>
@@ -10,12 +14,93 @@ namespace c10d {
 
 namespace {
 
-enum class QueryType : uint8_t { SET, GET, ADD, CHECK, WAIT };
+enum class QueryType : uint8_t {
+  SET,
+  GET,
+  ADD,
+  CHECK,
+  WAIT,
+  MULTI_SET,
+  MULTI_GET
+};
 
 enum class CheckResponseType : uint8_t { READY, NOT_READY };
 
 enum class WaitResponseType : uint8_t { STOP_WAITING };
 
+// Waits for events on the file descriptors of the daemon. On Linux this uses
+// epoll, so that the cost of every wakeup does not grow with the number of
+// connected workers.
+class SocketPoller {
+ public:
+  SocketPoller() {
+#ifdef __linux__
+    SYSCHECK_ERR_RETURN_NEG1(epollFd_ = ::epoll_create1(EPOLL_CLOEXEC));
+#endif
+  }
+
+  ~SocketPoller() {
+#ifdef __linux__
+    ::close(epollFd_);
+#endif
+  }
+
+  void add(int fd) {
+#ifdef __linux__
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    SYSCHECK_ERR_RETURN_NEG1(::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event));
+#else
+    fds_.push_back({.fd = fd, .events = POLLIN});
+#endif
+  }
+
+  void remove(int fd) {
+#ifdef __linux__
+    SYSCHECK_ERR_RETURN_NEG1(
+        ::epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr));
+#else
+    fds_.erase(std::find_if(
+        fds_.begin(), fds_.end(), [fd](const struct pollfd& pfd) {
+          return pfd.fd == fd;
+        }));
+#endif
+  }
+
+  // Blocks until at least one of the file descriptors has an event, and
+  // returns the ones that have.
+  std::vector<int> wait() {
+    std::vector<int> ready;
+#ifdef __linux__
+    struct epoll_event events[kMaxEvents];
+    int numEvents;
+    SYSCHECK_ERR_RETURN_NEG1(
+        numEvents = ::epoll_wait(epollFd_, events, kMaxEvents, -1));
+    for (int i = 0; i < numEvents; i++) {
+      ready.push_back(events[i].data.fd);
+    }
+#else
+    SYSCHECK_ERR_RETURN_NEG1(::poll(fds_.data(), fds_.size(), -1));
+    for (auto& pfd : fds_) {
+      if (pfd.revents != 0) {
+        ready.push_back(pfd.fd);
+        pfd.revents = 0;
+      }
+    }
+#endif
+    return ready;
+  }
+
+ private:
+#ifdef __linux__
+  static constexpr int kMaxEvents = 64;
+  int epollFd_ = -1;
+#else
+  std::vector<struct pollfd> fds_;
+#endif
+};
+
 } // anonymous namespace
 
 // TCPStoreDaemon class methods
@@ -38,9 +123,7 @@ TCPStoreDaemon::~TCPStoreDaemon() {
   join();
   // Close unclosed sockets
   for (auto socket : sockets_) {
-    if (socket != -1) {
-      ::close(socket);
-    }
+    ::close(socket);
   }
   // Now close the rest control pipe
   for (auto fd : controlPipeFd_) {
@@ -55,58 +138,37 @@ void TCPStoreDaemon::join() {
 }
 
 void TCPStoreDaemon::run() {
-  std::vector<struct pollfd> fds;
-  fds.push_back({.fd = storeListenSocket_, .events = POLLIN});
-  // Push the read end of the pipe to signal the stopping of the daemon run
-  fds.push_back({.fd = controlPipeFd_[0], .events = POLLHUP});
+  SocketPoller poller;
+  poller.add(storeListenSocket_);
+  // The read end of the pipe has an event once the write end is closed, which
+  // signals the stopping of the daemon run
+  poller.add(controlPipeFd_[0]);
 
   // receive the queries
-  bool finished = false;
-  while (!finished) {
-    for (size_t i = 0; i < sockets_.size(); i++) {
-      fds[i].revents = 0;
-    }
-
-    SYSCHECK_ERR_RETURN_NEG1(::poll(fds.data(), fds.size(), -1));
-
-    // TCPStore's listening socket has an event and it should now be able to
-    // accept new connections.
-    if (fds[0].revents != 0) {
-      if (fds[0].revents ^ POLLIN) {
-        throw std::system_error(
-            ECONNABORTED,
-            std::system_category(),
-            "Unexpected poll revent on the master's listening socket: " +
-                std::to_string(fds[0].revents));
+  while (true) {
+    // The sockets closed while handling the current events. Their numbers
+    // may have been reused by the connections accepted since.
+    std::unordered_set<int> closedSockets;
+    for (int fd : poller.wait()) {
+      // The pipe receives an event which tells us to shutdown the daemon
+      if (fd == controlPipeFd_[0]) {
+        return;
       }
-      int sockFd = std::get<0>(tcputil::accept(storeListenSocket_));
-      sockets_.push_back(sockFd);
-      fds.push_back({.fd = sockFd, .events = POLLIN});
-    }
-    // The pipe receives an event which tells us to shutdown the daemon
-    if (fds[1].revents != 0) {
-      // Will be POLLUP when the pipe is closed
-      if (fds[1].revents ^ POLLHUP) {
-        throw std::system_error(
-            ECONNABORTED,
-            std::system_category(),
-            "Unexpected poll revent on the control pipe's reading fd: " +
-                std::to_string(fds[1].revents));
+      // TCPStore's listening socket has an event and it should now be able
+      // to accept new connections.
+      if (fd == storeListenSocket_) {
+        int sockFd = std::get<0>(tcputil::accept(storeListenSocket_));
+        sockets_.insert(sockFd);
+        poller.add(sockFd);
+        continue;
       }
-      finished = true;
-      break;
-    }
-    // Skipping the fds[0] and fds[1],
-    // fds[0] is master's listening socket
-    // fds[1] is control pipe's reading fd
-    for (size_t fdIdx = 2; fdIdx < fds.size(); ++fdIdx) {
-      if (fds[fdIdx].revents == 0) {
+      if (closedSockets.count(fd) != 0) {
         continue;
       }
 
       // Now query the socket that has the event
       try {
-        query(fds[fdIdx].fd);
+        query(fd);
       } catch (...) {
         // There was an error when processing query. Probably an exception
         // occurred in recv/send what would indicate that socket on the other
@@ -115,39 +177,32 @@ void TCPStoreDaemon::run() {
         // exception, other connections will get an exception once they try to
         // use the store. We will go ahead and close this connection whenever
         // we hit an exception here.
-        ::close(fds[fdIdx].fd);
-
+        poller.remove(fd);
+        ::close(fd);
+        sockets_.erase(fd);
+        closedSockets.insert(fd);
         // Remove all the tracking state of the close FD
-        for (auto it = waitingSockets_.begin(); it != waitingSockets_.end();) {
-          for (auto vecIt = it->second.begin(); vecIt != it->second.end();) {
-            if (*vecIt == fds[fdIdx].fd) {
-              vecIt = it->second.erase(vecIt);
-            } else {
-              ++vecIt;
-            }
-          }
-          if (it->second.size() == 0) {
-            it = waitingSockets_.erase(it);
-          } else {
-            ++it;
-          }
-        }
-        for (auto it = keysAwaited_.begin(); it != keysAwaited_.end();) {
-          if (it->first == fds[fdIdx].fd) {
-            it = keysAwaited_.erase(it);
-          } else {
-            ++it;
-          }
-        }
-        fds.erase(fds.begin() + fdIdx);
-        sockets_.erase(sockets_.begin() + fdIdx - 2);
-        --fdIdx;
-        continue;
+        removeWaitingSocket(fd);
       }
     }
   }
 }
 
+void TCPStoreDaemon::removeWaitingSocket(int socket) {
+  for (auto it = waitingSockets_.begin(); it != waitingSockets_.end();) {
+    auto& sockets = it->second;
+    sockets.erase(
+        std::remove(sockets.begin(), sockets.end(), socket), sockets.end());
+    if (sockets.empty()) {
+      it = waitingSockets_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  keysAwaited_.erase(socket);
+  pendingGets_.erase(socket);
+}
+
 void TCPStoreDaemon::stop() {
   if (controlPipeFd_[1] != -1) {
     // close the write end of the pipe
@@ -159,8 +214,11 @@ void TCPStoreDaemon::stop() {
 // query communicates with the worker. The format
 // of the query is as follows:
 // type of query | size of arg1 | arg1 | size of arg2 | arg2 | ...
-// or, in the case of wait
+// or, in the case of wait and multi get
 // type of query | number of args | size of arg1 | arg1 | ...
+// or, in the case of multi set
+// type of query | number of keys | size of key1 | key1 | size of value1 |
+// value1 | ...
 void TCPStoreDaemon::query(int socket) {
   QueryType qt;
   tcputil::recvBytes<QueryType>(socket, &qt, 1);
@@ -180,6 +238,12 @@ void TCPStoreDaemon::query(int socket) {
   } else if (qt == QueryType::WAIT) {
     waitHandler(socket);
 
+  } else if (qt == QueryType::MULTI_SET) {
+    multiSetHandler(socket);
+
+  } else if (qt == QueryType::MULTI_GET) {
+    multiGetHandler(socket);
+
   } else {
     throw std::runtime_error("Unexpected query type");
   }
@@ -189,7 +253,15 @@ void TCPStoreDaemon::wakeupWaitingClients(const std::string& key) {
   auto socketsToWait = waitingSockets_.find(key);
   if (socketsToWait != waitingSockets_.end()) {
     for (int socket : socketsToWait->second) {
-      if (--keysAwaited_[socket] == 0) {
+      if (--keysAwaited_[socket] != 0) {
+        continue;
+      }
+      keysAwaited_.erase(socket);
+      auto pendingGet = pendingGets_.find(socket);
+      if (pendingGet != pendingGets_.end()) {
+        sendValues(socket, pendingGet->second);
+        pendingGets_.erase(pendingGet);
+      } else {
         tcputil::sendValue<WaitResponseType>(
             socket, WaitResponseType::STOP_WAITING);
       }
@@ -253,11 +325,56 @@ void TCPStoreDaemon::waitHandler(int socket) {
   if (checkKeys(keys)) {
     tcputil::sendValue<WaitResponseType>(
         socket, WaitResponseType::STOP_WAITING);
+  } else {
+    // Only the keys that are not set yet are awaited, the others would not
+    // wake up the socket unless they are set again.
+    for (auto& key : keys) {
+      if (tcpStore_.count(key) == 0) {
+        waitingSockets_[key].push_back(socket);
+        ++keysAwaited_[socket];
+      }
+    }
+  }
+}
+
+void TCPStoreDaemon::multiSetHandler(int socket) {
+  SizeType nargs;
+  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
+  for (size_t i = 0; i < nargs; i++) {
+    std::string key = tcputil::recvString(socket);
+    tcpStore_[key] = tcputil::recvVector<uint8_t>(socket);
+    wakeupWaitingClients(key);
+  }
+}
+
+// The values are sent once all of the keys are set, instead of the
+// STOP_WAITING response of a wait, so that a get takes a single round trip.
+void TCPStoreDaemon::multiGetHandler(int socket) {
+  SizeType nargs;
+  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
+  std::vector<std::string> keys(nargs);
+  for (size_t i = 0; i < nargs; i++) {
+    keys[i] = tcputil::recvString(socket);
+  }
+  if (checkKeys(keys)) {
+    sendValues(socket, keys);
   } else {
     for (auto& key : keys) {
-      waitingSockets_[key].push_back(socket);
+      if (tcpStore_.count(key) == 0) {
+        waitingSockets_[key].push_back(socket);
+        ++keysAwaited_[socket];
+      }
     }
-    keysAwaited_[socket] = keys.size();
+    pendingGets_[socket] = std::move(keys);
+  }
+}
+
+void TCPStoreDaemon::sendValues(
+    int socket,
+    const std::vector<std::string>& keys) const {
+  for (size_t i = 0; i < keys.size(); i++) {
+    tcputil::sendVector<uint8_t>(
+        socket, tcpStore_.at(keys[i]), (i != (keys.size() - 1)));
   }
 }
 
@@ -346,10 +463,58 @@ std::vector<uint8_t> TCPStore::get(const std::string& key) {
 }
 
 std::vector<uint8_t> TCPStore::getHelper_(const std::string& key) {
-  waitHelper_({key}, timeout_);
-  tcputil::sendValue<QueryType>(storeSocket_, QueryType::GET);
-  tcputil::sendString(storeSocket_, key);
-  return tcputil::recvVector<uint8_t>(storeSocket_);
+  return multiGetHelper_({key})[0];
+}
+
+void TCPStore::multiSet(
+    const std::vector<std::string>& keys,
+    const std::vector<std::vector<uint8_t>>& values) {
+  if (keys.size() != values.size()) {
+    throw std::invalid_argument(
+        "multiSet expects as many values as keys, got " +
+        std::to_string(keys.size()) + " keys and " +
+        std::to_string(values.size()) + " values");
+  }
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::MULTI_SET, true);
+  SizeType nkeys = keys.size();
+  tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
+  for (size_t i = 0; i < nkeys; i++) {
+    std::string regKey = regularPrefix_ + keys[i];
+    tcputil::sendString(storeSocket_, regKey, true);
+    tcputil::sendVector<uint8_t>(storeSocket_, values[i], (i != (nkeys - 1)));
+  }
+}
+
+std::vector<std::vector<uint8_t>> TCPStore::multiGet(
+    const std::vector<std::string>& keys) {
+  std::vector<std::string> regKeys;
+  regKeys.reserve(keys.size());
+  for (const auto& key : keys) {
+    regKeys.push_back(regularPrefix_ + key);
+  }
+  return multiGetHelper_(regKeys);
+}
+
+// The daemon answers once all of the keys are set, so that waiting for the
+// keys and getting their values takes a single round trip.
+std::vector<std::vector<uint8_t>> TCPStore::multiGetHelper_(
+    const std::vector<std::string>& keys) {
+  std::vector<std::vector<uint8_t>> values;
+  if (keys.empty()) {
+    return values;
+  }
+  setReceiveTimeout_(timeout_);
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::MULTI_GET, true);
+  SizeType nkeys = keys.size();
+  tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, true);
+  for (size_t i = 0; i < nkeys; i++) {
+    tcputil::sendString(storeSocket_, keys[i], (i != (nkeys - 1)));
+  }
+  values.reserve(nkeys);
+  for (size_t i = 0; i < nkeys; i++) {
+    values.push_back(tcputil::recvVector<uint8_t>(storeSocket_));
+  }
+  return values;
 }
 
 int64_t TCPStore::add(const std::string& key, int64_t value) {
@@ -397,9 +562,7 @@ void TCPStore::wait(
   waitHelper_(regKeys, timeout);
 }
 
-void TCPStore::waitHelper_(
-    const std::vector<std::string>& keys,
-    const std::chrono::milliseconds& timeout) {
+void TCPStore::setReceiveTimeout_(const std::chrono::milliseconds& timeout) {
   // Set the socket timeout if there is a wait timeout
   if (timeout != kNoTimeout) {
     struct timeval timeoutTV = {.tv_sec = timeout.count() / 1000,
@@ -411,6 +574,12 @@ void TCPStore::waitHelper_(
         reinterpret_cast<char*>(&timeoutTV),
         sizeof(timeoutTV)));
   }
+}
+
+void TCPStore::waitHelper_(
+    const std::vector<std::string>& keys,
+    const std::chrono::milliseconds& timeout) {
+  setReceiveTimeout_(timeout);
   tcputil::sendValue<QueryType>(storeSocket_, QueryType::WAIT);
   SizeType nkeys = keys.size();
   tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
@@ -27,6 +27,11 @@ struct BroadcastOptions {
 struct AllreduceOptions {
   ReduceOp reduceOp = ReduceOp::SUM;
   std::chrono::milliseconds timeout = kUnsetTimeout;
+  // Process groups with multiple communicators per device (see
+  // NCCL_STREAMS_PER_DEVICE in ProcessGroupNCCL) run the allreduce on
+  // communicator `channel` modulo their number, so that allreduces on
+  // different channels may run concurrently. Must be the same on all ranks.
+  int64_t channel = 0;
 };
 
 struct AllreduceCoalescedOptions : AllreduceOptions {};
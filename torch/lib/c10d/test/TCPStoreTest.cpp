@@ -116,3 +116,39 @@ TEST(TCPStoreTest, testHelper) {
 TEST(TCPStoreTest, testHelperPrefix) {
   testHelper("testPrefix");
 }
+
+TEST(TCPStoreTest, testMultiGetWaitsForKeys) {
+  auto serverStore = std::make_shared<c10d::TCPStore>(
+      "127.0.0.1",
+      0,
+      2,
+      true,
+      std::chrono::seconds(30),
+      /* wait */ false);
+  auto clientStore = std::make_shared<c10d::TCPStore>(
+      "127.0.0.1", serverStore->getPort(), 2, false);
+  serverStore->waitForWorkers();
+
+  c10d::test::set(*serverStore, "key0", "value0");
+  auto clientThread = std::thread([&clientStore] {
+    // key0 is already set, the others are set by the server after the
+    // requests are sent
+    clientStore->wait({"key0", "key1"});
+    auto values = clientStore->multiGet({"key1", "key0", "key2"});
+    EXPECT_EQ(values.size(), 3);
+    EXPECT_EQ(std::string(values[0].begin(), values[0].end()), "value1");
+    EXPECT_EQ(std::string(values[1].begin(), values[1].end()), "value0");
+    EXPECT_EQ(std::string(values[2].begin(), values[2].end()), "value2");
+  });
+  /* sleep override */
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  c10d::test::set(*serverStore, "key1", "value1");
+  /* sleep override */
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  serverStore->multiSet(
+      {"key2", "key3"},
+      {std::vector<uint8_t>{'v', 'a', 'l', 'u', 'e', '2'},
+       std::vector<uint8_t>{}});
+  clientThread.join();
+  c10d::test::check(*clientStore, "key3", "");
+}
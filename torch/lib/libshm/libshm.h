@@ -30,4 +30,44 @@ public:
   const char* manager_handle() const { return manager_handle_.c_str(); }
 };
 
+struct THManagedMapSlab;
+
+// A storage handed out by THManagedMapPool: the block at `offset` of a slab.
+// Every process using the block holds a reference to it; the slab can be
+// reused by the process which created it once all of its blocks are released.
+class THManagedMapBlock {
+public:
+  THManagedMapBlock(std::shared_ptr<THManagedMapSlab> slab, size_t offset);
+
+  const char* manager_handle() const;
+  const char* filename() const;
+  size_t offset() const { return offset_; }
+
+  // The references of the block outside of this process, see
+  // THRefcountedMapAllocator::incref()/decref()
+  void incref();
+  void decref();
+
+private:
+  std::shared_ptr<THManagedMapSlab> slab_;
+  size_t offset_;
+};
+
+// Pool of THManagedMapAllocator segments (slabs) which hands out small shared
+// storages by offset, so that sharing many small tensors costs neither a
+// shared memory segment and file descriptor nor a shm_open/mmap per tensor.
+class THManagedMapPool {
+public:
+  static constexpr size_t kSlabSize = 16 * 1024 * 1024;
+  // Larger storages get a segment of their own
+  static constexpr size_t kMaxBlockSize = kSlabSize / 16;
+
+  // Allocates size bytes, or returns an empty DataPtr if the storage is
+  // too large for the pool
+  static at::DataPtr allocate(size_t size);
+  // Maps the block of a slab which was allocated by another process
+  static at::DataPtr fromBlock(const char* manager_handle, const char* filename, size_t offset);
+  static THManagedMapBlock* fromDataPtr(const at::DataPtr&);
+};
+
 #endif
@@ -0,0 +1,182 @@
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <unistd.h>
+
+#include <TH/TH.h>
+#include <libshm/libshm.h>
+
+constexpr size_t THManagedMapPool::kSlabSize;
+constexpr size_t THManagedMapPool::kMaxBlockSize;
+
+namespace {
+
+constexpr size_t kAlignment = 64;
+
+// At the start of every slab: the number of its blocks which are referenced
+// by any process.
+struct SlabHeader {
+  std::atomic<int64_t> live_blocks;
+};
+
+// Before the data of every block
+struct BlockHeader {
+  std::atomic<int> refcount;
+};
+
+static_assert(sizeof(SlabHeader) <= kAlignment, "SlabHeader too large");
+static_assert(sizeof(BlockHeader) <= kAlignment, "BlockHeader too large");
+
+size_t roundUp(size_t size) {
+  return (size + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+std::string newSlabHandle() {
+  static std::random_device rd;
+  std::string handle = "/torch_slab_";
+  handle += std::to_string(getpid());
+  handle += "_";
+  handle += std::to_string(rd());
+  return handle;
+}
+
+} // namespace
+
+struct THManagedMapSlab {
+  THManagedMapSlab(const char* manager_handle, const std::string& filename, int flags)
+    : mapping(manager_handle, filename.c_str(), flags, THManagedMapPool::kSlabSize) {}
+
+  char* base() const {
+    return static_cast<char*>(mapping.data());
+  }
+  SlabHeader* header() const {
+    return reinterpret_cast<SlabHeader*>(base());
+  }
+  BlockHeader* block(size_t offset) const {
+    return reinterpret_cast<BlockHeader*>(base() + offset - kAlignment);
+  }
+
+  THManagedMapAllocator mapping;
+  // Offset of the next block, only used in the process which created the slab
+  size_t used = kAlignment;
+};
+
+namespace {
+
+struct Pool {
+  std::mutex mutex;
+  // The slabs created by this process, which live as long as it does
+  std::vector<std::shared_ptr<THManagedMapSlab>> own_slabs;
+  std::shared_ptr<THManagedMapSlab> current;
+  // All the slabs mapped by this process, by filename
+  std::unordered_map<std::string, std::weak_ptr<THManagedMapSlab>> slabs;
+};
+
+// Leaked, blocks may be freed during the destruction of static objects
+Pool& pool() {
+  static Pool* pool = new Pool();
+  return *pool;
+}
+
+void deleteBlock(void* ptr) {
+  auto* block = static_cast<THManagedMapBlock*>(ptr);
+  block->decref();
+  delete block;
+}
+
+// Takes a slab of this process without live blocks, or creates one.
+std::shared_ptr<THManagedMapSlab> freeSlab(Pool& p) {
+  for (const auto& slab : p.own_slabs) {
+    if (slab->header()->live_blocks.load() == 0) {
+      slab->used = kAlignment;
+      return slab;
+    }
+  }
+  const std::string filename = newSlabHandle();
+  auto slab = std::make_shared<THManagedMapSlab>(
+      "", filename, TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_EXCLUSIVE);
+  new (slab->header()) SlabHeader();
+  slab->header()->live_blocks = 0;
+  p.own_slabs.push_back(slab);
+  p.slabs.emplace(filename, slab);
+  return slab;
+}
+
+} // namespace
+
+THManagedMapBlock::THManagedMapBlock(std::shared_ptr<THManagedMapSlab> slab, size_t offset)
+  : slab_(std::move(slab)), offset_(offset) {}
+
+const char* THManagedMapBlock::manager_handle() const {
+  return slab_->mapping.manager_handle();
+}
+
+const char* THManagedMapBlock::filename() const {
+  return slab_->mapping.filename();
+}
+
+void THManagedMapBlock::incref() {
+  ++slab_->block(offset_)->refcount;
+}
+
+void THManagedMapBlock::decref() {
+  if (--slab_->block(offset_)->refcount == 0) {
+    --slab_->header()->live_blocks;
+  }
+}
+
+at::DataPtr THManagedMapPool::allocate(size_t size) {
+  const size_t block_size = kAlignment + roundUp(size);
+  if (block_size > kMaxBlockSize) {
+    return {};
+  }
+  Pool& p = pool();
+  std::lock_guard<std::mutex> lock(p.mutex);
+  if (!p.current || p.current->used + block_size > kSlabSize) {
+    p.current = freeSlab(p);
+  }
+  const size_t offset = p.current->used + kAlignment;
+  p.current->used += block_size;
+  new (p.current->block(offset)) BlockHeader();
+  p.current->block(offset)->refcount = 1;
+  ++p.current->header()->live_blocks;
+  auto* block = new THManagedMapBlock(p.current, offset);
+  return {p.current->base() + offset, block, &deleteBlock, at::DeviceType::CPU};
+}
+
+at::DataPtr THManagedMapPool::fromBlock(const char* manager_handle, const char* filename, size_t offset) {
+  if (offset < 2 * kAlignment || offset % kAlignment != 0 || offset >= kSlabSize) {
+    THError("invalid offset %zu of a shared memory pool block", offset);
+  }
+  Pool& p = pool();
+  std::shared_ptr<THManagedMapSlab> slab;
+  {
+    std::lock_guard<std::mutex> lock(p.mutex);
+    auto it = p.slabs.find(filename);
+    if (it != p.slabs.end()) {
+      slab = it->second.lock();
+    }
+    if (!slab) {
+      for (auto entry = p.slabs.begin(); entry != p.slabs.end();) {
+        entry = entry->second.expired() ? p.slabs.erase(entry) : std::next(entry);
+      }
+      slab = std::make_shared<THManagedMapSlab>(
+          manager_handle, filename, TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_NOCREATE);
+      p.slabs[filename] = slab;
+    }
+  }
+  // the sender holds a reference until this one is taken
+  char* data = slab->base() + offset;
+  auto* block = new THManagedMapBlock(std::move(slab), offset);
+  block->incref();
+  return {data, block, &deleteBlock, at::DeviceType::CPU};
+}
+
+THManagedMapBlock* THManagedMapPool::fromDataPtr(const at::DataPtr& dptr) {
+  return dptr.cast_context<THManagedMapBlock>(&deleteBlock);
+}
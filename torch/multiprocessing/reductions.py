@@ -300,6 +300,15 @@ def rebuild_storage_filename(cls, manager, handle, size):
     return storage._shared_decref()
 
 
+def rebuild_storage_pooled(cls, manager, handle, offset, size):
+    storage = storage_from_cache(cls, (handle, offset))
+    if storage is not None:
+        return storage._shared_decref()
+    storage = cls._new_shared_pooled(manager, handle, offset, size)
+    shared_cache[(handle, offset)] = StorageWeakRef(storage)
+    return storage._shared_decref()
+
+
 def rebuild_storage_empty(cls):
     return cls()
 
@@ -308,7 +317,15 @@ def reduce_storage(storage):
     from . import get_sharing_strategy
     if storage.is_cuda:
         raise RuntimeError("Cannot pickle CUDA storage; try pickling a CUDA tensor instead")
-    elif get_sharing_strategy() == 'file_system':
+    strategy = get_sharing_strategy()
+    # Storages too large for a block of the pool use a file of their own
+    pooled = storage._share_pooled_() if strategy == 'file_system_pool' else None
+    if pooled is not None:
+        metadata = pooled
+        cache_key = metadata[1:3]
+        rebuild = rebuild_storage_pooled
+        storage._shared_incref()
+    elif strategy in ('file_system', 'file_system_pool'):
         metadata = storage._share_filename_()
         cache_key = metadata[1]
         rebuild = rebuild_storage_filename
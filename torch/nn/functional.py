@@ -1650,6 +1650,9 @@ def linear(input, weight, bias=None):
     if not torch.jit.is_scripting():
         if any([type(t) is not Tensor for t in tens_ops]) and has_torch_function(tens_ops):
             return handle_torch_function(linear, tens_ops, input, weight, bias=bias)
+        if input.layout == torch.nested:
+            # Only multiplies the entries, see torch.nested_tensor
+            return torch._C._nn.linear(input, weight, bias)
     if input.dim() == 2 and bias is not None:
         # fused op is marginally faster
         ret = torch.addmm(bias, input, weight.t())
@@ -2349,8 +2352,8 @@ def kl_div(input, target, size_average=None, reduce=None, reduction='mean', log_
 
 
 def cross_entropy(input, target, weight=None, size_average=None, ignore_index=-100,
-                  reduce=None, reduction='mean'):
-    # type: (Tensor, Tensor, Optional[Tensor], Optional[bool], int, Optional[bool], str) -> Tensor
+                  reduce=None, reduction='mean', label_smoothing=0.0):
+    # type: (Tensor, Tensor, Optional[Tensor], Optional[bool], int, Optional[bool], str, float) -> Tensor
     r"""This criterion combines `log_softmax` and `nll_loss` in a single
     function.
 
@@ -2383,6 +2386,11 @@ def cross_entropy(input, target, weight=None, size_average=None, ignore_index=-1
             elements in the output, ``'sum'``: the output will be summed. Note: :attr:`size_average`
             and :attr:`reduce` are in the process of being deprecated, and in the meantime,
             specifying either of those two args will override :attr:`reduction`. Default: ``'mean'``
+        label_smoothing (float, optional): A float in [0.0, 1.0]. Specifies the amount
+            of smoothing when computing the loss, where 0.0 means no smoothing. The targets
+            become a mixture of the original ground truth and a uniform distribution as
+            described in `Rethinking the Inception Architecture for Computer Vision
+            <https://arxiv.org/abs/1512.00567>`__. Default: :math:`0.0`.
 
     Examples::
 
@@ -2397,10 +2405,17 @@ def cross_entropy(input, target, weight=None, size_average=None, ignore_index=-1
             return handle_torch_function(
                 cross_entropy, tens_ops, input, target, weight=weight,
                 size_average=size_average, ignore_index=ignore_index, reduce=reduce,
-                reduction=reduction)
+                reduction=reduction, label_smoothing=label_smoothing)
     if size_average is not None or reduce is not None:
         reduction = _Reduction.legacy_get_string(size_average, reduce)
-    return nll_loss(log_softmax(input, 1), target, weight, None, ignore_index, None, reduction)
+    dim = input.dim()
+    if dim < 2:
+        raise ValueError('Expected 2 or more dimensions (got {})'.format(dim))
+    if input.size(0) != target.size(0):
+        raise ValueError('Expected input batch_size ({}) to match target batch_size ({}).'
+                         .format(input.size(0), target.size(0)))
+    return torch._C._nn.cross_entropy_loss(input, target, weight, _Reduction.get_enum(reduction),
+                                           ignore_index, label_smoothing)
 
 
 def binary_cross_entropy(input, target, weight=None, size_average=None,
@@ -873,7 +873,16 @@ class CrossEntropyLoss(_WeightedLoss):
     .. math::
         \text{loss}(x, class) = weight[class] \left(-x[class] + \log\left(\sum_j \exp(x[j])\right)\right)
 
-    The losses are averaged across observations for each minibatch.
+    With label smoothing :math:`\epsilon`, the loss of every class :math:`j` is
+    added with a weight of :math:`\epsilon / C`, and the loss of the target class
+    is scaled by :math:`1 - \epsilon`.
+
+    The losses are averaged across observations for each minibatch. With the
+    :attr:`weight` argument, they are averaged by the total weight of the
+    targets.
+
+    The log probabilities are not kept for the backward, which recomputes the
+    softmax from the inputs.
 
     Can also be used for higher dimension inputs, such as 2D images, by providing
     an input of size :math:`(minibatch, C, d_1, d_2, ..., d_K)` with :math:`K \geq 1`,
@@ -902,6 +911,11 @@ class CrossEntropyLoss(_WeightedLoss):
             elements in the output, ``'sum'``: the output will be summed. Note: :attr:`size_average`
             and :attr:`reduce` are in the process of being deprecated, and in the meantime,
             specifying either of those two args will override :attr:`reduction`. Default: ``'mean'``
+        label_smoothing (float, optional): A float in [0.0, 1.0]. Specifies the amount
+            of smoothing when computing the loss, where 0.0 means no smoothing. The targets
+            become a mixture of the original ground truth and a uniform distribution as
+            described in `Rethinking the Inception Architecture for Computer Vision
+            <https://arxiv.org/abs/1512.00567>`__. Default: :math:`0.0`.
 
     Shape:
         - Input: :math:`(N, C)` where `C = number of classes`, or
@@ -924,16 +938,23 @@ class CrossEntropyLoss(_WeightedLoss):
         >>> output = loss(input, target)
         >>> output.backward()
     """
-    __constants__ = ['ignore_index', 'reduction']
+    __constants__ = ['ignore_index', 'reduction', 'label_smoothing']
 
     def __init__(self, weight=None, size_average=None, ignore_index=-100,
-                 reduce=None, reduction='mean'):
+                 reduce=None, reduction='mean', label_smoothing=0.0):
         super(CrossEntropyLoss, self).__init__(weight, size_average, reduce, reduction)
         self.ignore_index = ignore_index
+        self.label_smoothing = label_smoothing
+
+    def __setstate__(self, state):
+        super(CrossEntropyLoss, self).__setstate__(state)
+        if not hasattr(self, 'label_smoothing'):
+            self.label_smoothing = 0.0
 
     def forward(self, input, target):
         return F.cross_entropy(input, target, weight=self.weight,
-                               ignore_index=self.ignore_index, reduction=self.reduction)
+                               ignore_index=self.ignore_index, reduction=self.reduction,
+                               label_smoothing=self.label_smoothing)
 
 
 class MultiLabelSoftMarginLoss(_WeightedLoss):
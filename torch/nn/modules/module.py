@@ -1131,7 +1131,11 @@ class Module(object):
 
         for p in self.parameters():
             if p.grad is not None:
-                p.grad.detach_()
+                if p.grad.grad_fn is not None:
+                    p.grad.detach_()
+                else:
+                    # may be a view, e.g. of a DistributedDataParallel bucket
+                    p.grad.requires_grad_(False)
                 p.grad.zero_()
 
     def share_memory(self):
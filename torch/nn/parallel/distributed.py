@@ -190,6 +190,23 @@ class DistributedDataParallel(Module):
                                        module parameters that are otherwise unused can
                                        be detached from the autograd graph using
                                        ``torch.Tensor.detach``. (default: ``False``)
+        find_unused_parameters_by_hooks (bool): Find the unused parameters
+                                       without traversing the autograd graph:
+                                       parameters that haven't received
+                                       gradients by the end of the backward pass
+                                       are marked ready to be reduced then. This
+                                       saves traversing the graph every
+                                       iteration, which is costly for large
+                                       graphs, but delays the reduction of the
+                                       buckets holding unused parameters to the
+                                       end of the backward pass. The outputs of
+                                       ``forward`` needn't be found nor all
+                                       participate in the loss. Reentrant
+                                       backward passes, e.g. from
+                                       ``torch.utils.checkpoint``, are not
+                                       supported. Implies
+                                       ``find_unused_parameters``.
+                                       (default: ``False``)
         check_reduction: when setting to ``True``, it enables DistributedDataParallel
                          to automatically check if the previous iteration's
                          backward reductions were successfully issued at the
@@ -199,6 +216,16 @@ class DistributedDataParallel(Module):
                          are getting different gradients, which should not
                          happen if DistributedDataParallel is correctly used.
                          (default: ``False``)
+        gradient_as_bucket_view (bool): when set to ``True``, the gradients of
+                                 dense parameters become views of the buckets
+                                 used for the allreduce after the first
+                                 iteration. Gradients are then accumulated
+                                 directly into bucket memory, which saves the
+                                 copies into and out of the buckets and the
+                                 memory of one copy of the gradients. Such
+                                 gradients must not be detached in place with
+                                 ``detach_()``; ``zero_grad()`` of modules and
+                                 optimizers supports them. (default: ``False``)
 
     Attributes:
         module (Module): the module to be parallelized
@@ -212,7 +239,9 @@ class DistributedDataParallel(Module):
                  output_device=None, dim=0, broadcast_buffers=True,
                  process_group=None, bucket_cap_mb=25,
                  find_unused_parameters=False,
-                 check_reduction=False):
+                 check_reduction=False,
+                 gradient_as_bucket_view=False,
+                 find_unused_parameters_by_hooks=False):
 
         super(DistributedDataParallel, self).__init__()
 
@@ -260,6 +289,8 @@ class DistributedDataParallel(Module):
         self.module = module
         self.broadcast_buffers = broadcast_buffers
         self.find_unused_parameters = find_unused_parameters
+        self.find_unused_parameters_by_hooks = find_unused_parameters_by_hooks
+        self.gradient_as_bucket_view = gradient_as_bucket_view
         self.require_backward_grad_sync = True
         self.require_forward_param_sync = True
 
@@ -386,11 +417,16 @@ class DistributedDataParallel(Module):
         # Note: reverse list of buckets because we want to approximate the
         # order in which their gradients are produced, and assume they
         # are used in the forward pass in the order they are defined.
+        # The reducer records the actual order during the first iteration
+        # and rebuilds the buckets once to follow it.
         self.reducer = dist.Reducer(
             parameters,
             list(reversed(bucket_indices)),
             self.process_group,
-            expect_sparse_gradient)
+            expect_sparse_gradient,
+            self.bucket_bytes_cap,
+            self.gradient_as_bucket_view,
+            self.find_unused_parameters_by_hooks)
 
         # passing a handle to torch.nn.SyncBatchNorm layer
         self._passing_sync_batchnorm_handle(self._module_copies)
@@ -408,6 +444,8 @@ class DistributedDataParallel(Module):
         super(DistributedDataParallel, self).__setstate__(state)
         self.__dict__.setdefault('require_forward_param_sync', True)
         self.__dict__.setdefault('require_backward_grad_sync', True)
+        self.__dict__.setdefault('gradient_as_bucket_view', False)
+        self.__dict__.setdefault('find_unused_parameters_by_hooks', False)
         self._ddp_init_helper()
 
     def _check_default_group(self):
@@ -468,8 +506,9 @@ class DistributedDataParallel(Module):
             # object. We need to find any tensors in this object, though,
             # because we need to figure out which parameters were used during
             # this forward pass, to ensure we short circuit reduction for any
-            # unused parameters. Only if `find_unused_parameters` is set.
-            if self.find_unused_parameters:
+            # unused parameters. Only if `find_unused_parameters` is set,
+            # the reducer finding them itself by hooks otherwise.
+            if self.find_unused_parameters and not self.find_unused_parameters_by_hooks:
                 self.reducer.prepare_for_backward(list(_find_tensors(output)))
             else:
                 self.reducer.prepare_for_backward([])
@@ -18,6 +18,10 @@ class Linear(nnq.Linear):
                          shape :math:`(\text{out\_features}, \text{in\_features})`.
         bias (Tensor): the non-learnable bias of the module of shape :math:`(\text{out\_features})`.
                 If :attr:`bias` is ``True``, the values are initialized to zero.
+        range_refresh_interval (int): when positive, the range the inputs are
+                quantized with is computed on every ``range_refresh_interval``-th
+                call only and reused by the calls in between, which saturate the
+                inputs outside of it. Defaults to 0, computing the range on every call.
 
     Examples::
 
@@ -34,12 +38,17 @@ class Linear(nnq.Linear):
         # to keep the module simple. *everything* is simply a Python attribute.
         # Serialization logic is explicitly handled in the below serialization and
         # deserialization modules
+        self.range_refresh_interval = 0
 
     def forward(self, x):
         # Note that we can handle self.bias == None case.
         if self._packed_params.dtype == torch.qint8:
-            Y = torch.ops.quantized.linear_dynamic(
-                x, self._packed_params._packed_params)
+            if self.range_refresh_interval > 0:
+                Y = torch.ops.quantized.linear_dynamic_cached_range(
+                    x, self._packed_params._packed_params, self.range_refresh_interval)
+            else:
+                Y = torch.ops.quantized.linear_dynamic(
+                    x, self._packed_params._packed_params)
         elif self._packed_params.dtype == torch.float16:
             Y = torch.ops.quantized.linear_dynamic_fp16(
                 x, self._packed_params._packed_params)
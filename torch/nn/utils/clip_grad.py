@@ -1,6 +1,5 @@
 import warnings
 import torch
-from torch._six import inf
 
 
 def clip_grad_norm_(parameters, max_norm, norm_type=2):
@@ -18,20 +17,21 @@ def clip_grad_norm_(parameters, max_norm, norm_type=2):
 
     Returns:
         Total norm of the parameters (viewed as a single vector).
+
+    .. note::
+        On CUDA, the norm and the scaling take a few kernel launches for all
+        the gradients and the norm is not read back to the host, so the
+        function does not synchronize with the device.
     """
     if isinstance(parameters, torch.Tensor):
         parameters = [parameters]
-    parameters = list(filter(lambda p: p.grad is not None, parameters))
+    grads = [p.grad.detach() for p in parameters if p.grad is not None]
+    if len(grads) == 0:
+        return torch.tensor(0.)
     max_norm = float(max_norm)
     norm_type = float(norm_type)
-    if norm_type == inf:
-        total_norm = max(p.grad.detach().abs().max() for p in parameters)
-    else:
-        total_norm = torch.norm(torch.stack([torch.norm(p.grad.detach(), norm_type) for p in parameters]), norm_type)
-    clip_coef = max_norm / (total_norm + 1e-6)
-    if clip_coef < 1:
-        for p in parameters:
-            p.grad.detach().mul_(clip_coef)
+    total_norm = torch._foreach_total_norm(grads, norm_type)
+    torch._foreach_clip_by_total_norm_(grads, total_norm, max_norm)
     return total_norm
 
 
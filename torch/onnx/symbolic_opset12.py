@@ -57,3 +57,22 @@ def nll_loss(g, self, target, weight, reduction, ignore_index):
 
 def nll_loss2d(g, self, target, weight, reduction, ignore_index):
     return nll_loss(g, self, target, weight, reduction, ignore_index)
+
+
+def cross_entropy_loss(g, self, target, weight, reduction, ignore_index, label_smoothing):
+    # none reduction : onnx::Constant[value={0}]
+    # mean reduction : onnx::Constant[value={1}]
+    # sum reduction : onnx::Constant[value={2}]
+    reduction = sym_help._maybe_get_const(reduction, 'i')
+    reduction_vals = ['none', 'mean', 'sum']
+    reduction = reduction_vals[reduction]
+
+    label_smoothing = sym_help._maybe_get_const(label_smoothing, 'f')
+    if label_smoothing != 0.0:
+        return sym_help._unimplemented("cross_entropy_loss", "label_smoothing")
+
+    ignore_index = sym_help._maybe_get_const(ignore_index, 'i')
+    if weight.node().mustBeNone():
+        return g.op("SoftmaxCrossEntropyLoss", self, target, reduction_s=reduction, ignore_index_i=ignore_index)
+    else:
+        return g.op("SoftmaxCrossEntropyLoss", self, target, weight, reduction_s=reduction, ignore_index_i=ignore_index)
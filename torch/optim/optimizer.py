@@ -161,7 +161,11 @@ class Optimizer(object):
         for group in self.param_groups:
             for p in group['params']:
                 if p.grad is not None:
-                    p.grad.detach_()
+                    if p.grad.grad_fn is not None:
+                        p.grad.detach_()
+                    else:
+                        # may be a view, e.g. of a DistributedDataParallel bucket
+                        p.grad.requires_grad_(False)
                     p.grad.zero_()
 
     def step(self, closure):
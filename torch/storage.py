@@ -122,6 +122,9 @@ class _StorageBase(object):
         from torch.multiprocessing import get_sharing_strategy
         if self.is_cuda:
             pass  # CUDA doesn't use POSIX shared memory
+        elif get_sharing_strategy() == 'file_system_pool':
+            if self._share_pooled_() is None:
+                self._share_filename_()
         elif get_sharing_strategy() == 'file_system':
             self._share_filename_()
         else:
@@ -134,7 +137,7 @@ class _StorageBase(object):
         from torch.multiprocessing import get_sharing_strategy
         if cls.is_cuda:
             return cls(size)
-        elif get_sharing_strategy() == 'file_system':
+        elif get_sharing_strategy() in ('file_system', 'file_system_pool'):
             return cls._new_using_filename(size)
         else:
             return cls._new_using_fd(size)
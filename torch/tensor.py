@@ -211,10 +211,16 @@ class Tensor(torch._C._TensorBase):
             [torch.FloatTensor of size (3,)]
 
             >>> h.remove()  # removes the hook
+
+        The hook can also be a :class:`torch.jit.ScriptFunction`. It then runs
+        in the TorchScript interpreter as a C++ hook, without taking the GIL,
+        so that it does not contend for it with the other threads of backward.
         """
         if not self.requires_grad:
             raise RuntimeError("cannot register a hook on a tensor that "
                                "doesn't require gradient")
+        if isinstance(hook, torch.jit.ScriptFunction):
+            return hooks.RemovableCppHandle(self, torch._C._register_script_hook(self, hook))
         if self._backward_hooks is None:
             self._backward_hooks = OrderedDict()
             if self.grad_fn is not None:
@@ -1085,6 +1085,27 @@ class DistAutogradTest(RpcAgentTestFixture):
                 )
                 local_grads = ret if ret else local_grads
 
+    @dist_init
+    def test_backward_many_rpcs_same_worker(self):
+        # The gradients of all the 'recv' functions for the same worker are
+        # ready together and are sent in a single batched RPC, on both sides.
+        local_grads = None
+        t1 = torch.rand((3, 3), requires_grad=True)
+        t2 = torch.rand((3, 3), requires_grad=True)
+        dst = self._next_rank()
+        for exec_mode in [ExecMode.LOCAL, ExecMode.RPC_SYNC, ExecMode.REMOTE]:
+            with dist_autograd.context() as context_id:
+                vals = [
+                    self._exec_func_with_dst(dst, exec_mode, torch.mul, t1, t2 + i)
+                    for i in range(10)
+                ]
+                loss = torch.stack(vals).sum()
+
+                ret = self._verify_backwards(
+                    exec_mode, [loss], context_id, local_grads, t1, t2
+                )
+                local_grads = ret if ret else local_grads
+
     @dist_init
     def test_backward_different_tensor_dims(self):
         local_grads = None
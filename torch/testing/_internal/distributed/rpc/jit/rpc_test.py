@@ -103,6 +103,11 @@ def script_fork_wait_throw(invalue):
     value = torch.jit._wait(fut)
     return value
 
+@torch.jit.script
+def script_nested_rpc_async(dst_worker_name: str, value: Tensor) -> Tensor:
+    fut = rpc.rpc_async(dst_worker_name, one_arg, (value,))
+    return fut.wait()
+
 @torch.jit.script
 def call_rpc_with_profiling(handle: Tensor, dst_worker_name: str) -> Tensor:
     # Call rpc_async from within ScriptFunction and ensure that we can attach
@@ -911,6 +916,23 @@ class JitRpcTest(RRefAPITest, LocalRRefTest, JitRpcAsyncOpTest, RpcAgentTestFixt
         with self.assertRaisesRegex(Exception, ".*Expected error.*"):
             future.wait()
 
+    @dist_init
+    def test_async_script_nested_rpcs(self):
+        # Every call suspends on a nested RPC to another worker. Many more
+        # calls than there are server threads are in flight at the same time,
+        # which only works if waiting doesn't hold on to a server thread.
+        num_calls = 50
+        dst = worker_name((self.rank + 1) % self.world_size)
+        nested_dst = worker_name((self.rank + 2) % self.world_size)
+        futs = [
+            rpc.rpc_async(
+                dst, script_nested_rpc_async, args=(nested_dst, torch.ones(2) * i)
+            )
+            for i in range(num_calls)
+        ]
+        for i, fut in enumerate(futs):
+            self.assertEqual(fut.wait(), torch.ones(2) * i + 1)
+
     @dist_init
     def test_call_rpc_with_profiling(self):
         # Ensures that we can call torch.ops.profiler._call_end_callbacks_on_jit_fut on a jit
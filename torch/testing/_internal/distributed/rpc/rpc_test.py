@@ -146,6 +146,10 @@ def add_rref_to_value(rref, value):
     return rref.to_here() + value
 
 
+def add_to_rref_local_value(rref, value):
+    rref.local_value().add_(value)
+
+
 def run_nested_pickle(pickle_cls_instance, tensor):
     return pickle_cls_instance.t + tensor
 
@@ -1176,6 +1180,27 @@ class RpcTest(RpcAgentTestFixture):
         )
         self.assertEqual(rref.local_value(), torch.ones(2, 2) * 2)
 
+    @dist_init
+    def test_builtin_remote_ret_to_here_cached(self):
+        n = self.rank + 1
+        dst_rank = n % self.world_size
+        rref = rpc.remote(
+            worker_name(dst_rank),
+            torch.add,
+            args=(torch.ones(n, n), torch.ones(n, n)),
+        )
+        first = rref.to_here()
+        self.assertEqual(first, torch.ones(n, n) * 2)
+        # Modifying the result must not modify the cached value.
+        first.add_(1)
+        self.assertEqual(rref.to_here(), torch.ones(n, n) * 2)
+
+        # Modifying the value on the owner must invalidate the cached value.
+        rpc.rpc_sync(
+            worker_name(dst_rank), add_to_rref_local_value, args=(rref, 3))
+        self.assertEqual(rref.to_here(), torch.ones(n, n) * 5)
+        self.assertEqual(rref.to_here(), torch.ones(n, n) * 5)
+
     def _test_multi_remote_call(self, fn, args_fn=lambda x: (), kwargs_fn=lambda x: {}):
         m = 10
         n = self.rank + 1
@@ -1888,6 +1913,53 @@ class RpcTest(RpcAgentTestFixture):
         # add a barrier to make sure SHUTDOWN message is not sent
         dist.barrier()
 
+    @dist_init
+    @requires_process_group_agent("PROCESS_GROUP rpc backend specific test, skip")
+    def test_process_group_latency_metrics(self):
+        dst_rank = (self.rank + 1) % self.world_size
+        for _ in range(3):
+            rpc.rpc_sync(
+                worker_name(dst_rank), torch.add, args=(torch.ones(2), 1))
+
+        info = rpc.api._get_current_rpc_agent().get_debug_info()
+        prefix = "agent.latency.round_trip_us.script_call."
+        self.assertEqual(int(info[prefix + "count"]), 3)
+        self.assertGreaterEqual(float(info[prefix + "avg"]), 0)
+        self.assertLessEqual(int(info[prefix + "p50"]), int(info[prefix + "p99"]))
+        self.assertGreaterEqual(
+            int(info["agent.latency.serialization_us.script_call.count"]), 3)
+        self.assertGreaterEqual(
+            int(info["agent.latency.send_queueing_us.script_call.count"]), 3)
+
+    @dist_init
+    @requires_process_group_agent("PROCESS_GROUP rpc backend specific test, skip")
+    def test_process_group_send_metrics(self):
+        dst_rank = (self.rank + 1) % self.world_size
+        num_rpcs = 20
+        futs = [
+            rpc.rpc_async(
+                worker_name(dst_rank), torch.add, args=(torch.ones(2), i)
+            )
+            for i in range(num_rpcs)
+        ]
+        for i, fut in enumerate(futs):
+            self.assertEqual(fut.wait(), torch.ones(2) + i)
+
+        info = rpc.api._get_current_rpc_agent().get_debug_info()
+        num_sent_messages = int(info["agent.num_sent_messages"])
+        num_sent_frames = int(info["agent.num_sent_frames"])
+        # Every frame holds at least one message, and messages are only
+        # counted as coalesced if they share a frame.
+        self.assertGreaterEqual(num_sent_messages, num_rpcs)
+        self.assertGreaterEqual(num_sent_frames, 1)
+        self.assertLessEqual(num_sent_frames, num_sent_messages)
+        self.assertLessEqual(
+            int(info["agent.num_coalesced_messages"]), num_sent_messages
+        )
+        self.assertGreater(int(info["agent.num_sent_bytes"]), 0)
+        self.assertGreaterEqual(int(info["agent.send_queue_depth"]), 0)
+        self.assertGreaterEqual(int(info["agent.max_send_queue_depth"]), 1)
+
     @dist_init(setup_rpc=False)
     @requires_process_group_agent("PROCESS_GROUP rpc backend specific test, skip")
     def test_local_shutdown(self):
@@ -1,28 +1,43 @@
 from __future__ import absolute_import, division, print_function, unicode_literals
 import torch
 
-from torch._C import _from_dlpack as from_dlpack
-from torch._C import _to_dlpack as to_dlpack
 
-torch._C._add_docstr(from_dlpack, r"""from_dlpack(dlpack) -> Tensor
-
-Decodes a DLPack to a tensor.
-
-Args:
-    dlpack: a PyCapsule object with the dltensor
-
-The tensor will share the memory with the object represented
-in the dlpack.
-Note that each dlpack can only be consumed once.
-""")
-
-torch._C._add_docstr(to_dlpack, r"""to_dlpack(tensor) -> PyCapsule
-
-Returns a DLPack representing the tensor.
-
-Args:
-    tensor: a tensor to be exported
-
-The dlpack shares the tensors memory.
-Note that each dlpack can only be consumed once.
-""")
+def from_dlpack(dlpack, stream=None):
+    r"""from_dlpack(dlpack, stream=None) -> Tensor
+
+    Decodes a DLPack to a tensor.
+
+    Args:
+        dlpack: a PyCapsule object with the dltensor
+        stream (torch.cuda.Stream, optional): the stream the producer of a CUDA
+            dlpack wrote it on. If given, the current stream waits for the work
+            queued on it instead of requiring the producer to synchronize the
+            device.
+
+    The tensor will share the memory with the object represented
+    in the dlpack.
+    Note that each dlpack can only be consumed once.
+    """
+    if stream is None:
+        return torch._C._from_dlpack(dlpack)
+    return torch._C._from_dlpack_on_stream(dlpack, stream._cdata)
+
+
+def to_dlpack(tensor, stream=None):
+    r"""to_dlpack(tensor, stream=None) -> PyCapsule
+
+    Returns a DLPack representing the tensor.
+
+    Args:
+        tensor: a tensor to be exported
+        stream (torch.cuda.Stream, optional): the stream the consumer of a CUDA
+            tensor will use it on. If given, it waits for the work queued so far
+            on the current stream instead of requiring the consumer to
+            synchronize the device.
+
+    The dlpack shares the tensors memory.
+    Note that each dlpack can only be consumed once.
+    """
+    if stream is None:
+        return torch._C._to_dlpack(tensor)
+    return torch._C._to_dlpack_on_stream(tensor, stream._cdata)
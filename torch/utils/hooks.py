@@ -1,5 +1,6 @@
 from __future__ import absolute_import, division, print_function, unicode_literals
 from collections import OrderedDict
+import torch
 import weakref
 import warnings
 
@@ -38,6 +39,28 @@ class RemovableHandle(object):
         self.remove()
 
 
+class RemovableCppHandle(object):
+    """A handle which provides the capability to remove a hook registered as
+    a C++ hook of a tensor, such as a scripted hook (see
+    :meth:`torch.Tensor.register_hook`)."""
+
+    def __init__(self, tensor, index):
+        self.tensor_ref = weakref.ref(tensor)
+        self.index = index
+
+    def remove(self):
+        tensor = self.tensor_ref()
+        if tensor is not None and self.index is not None:
+            torch._C._remove_cpp_hook(tensor, self.index)
+            self.index = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, type, value, tb):
+        self.remove()
+
+
 def unserializable_hook(f):
     """
     Decorator which marks a function as an unserializable hook.